@@ -0,0 +1,60 @@
+#pragma once
+
+// One step's controls, packed into the int every action already travels as (ReplayAction,
+// LanderAction, the input timeline, replays, the env API), so analog input takes the same path
+// the keys always have without a copy or a conversion anywhere along it:
+//
+//   bits 0-2    LEFT, RIGHT and BOOST, the bits ReplayAction and LanderAction share
+//   bit  3      ACTION_ANALOG: the fields below are set, and say how far
+//   bits 8-15   steer, a signed byte: -127 is full left, 127 full right
+//   bits 16-23  throttle, 0-255 of the booster's full push
+//
+// An analog action still has its bits set, from the signs of steer and throttle, so anything that
+// only reads the bits (BatchedLanderSim, the GPU sim, the network protocol) gets the nearest
+// digital action. Without ACTION_ANALOG, the bits are full deflection, as they always were, and
+// only make_action's output at exactly full or no deflection comes out that way, so keyboard play
+// records and steps just as before.
+#include <cmath>
+
+const int ACTION_LEFT   = 1,
+          ACTION_RIGHT  = 2,
+          ACTION_BOOST  = 4,
+          ACTION_ANALOG = 8,
+          ACTION_DIGITAL_MASK = ACTION_LEFT | ACTION_RIGHT | ACTION_BOOST,
+          ACTION_RECORD_MASK  = 0x00ffff0f;  // every bit an action record uses
+
+const int ACTION_STEER_SHIFT    = 8,
+          ACTION_THROTTLE_SHIFT = 16,
+          ACTION_STEER_MAX      = 127,
+          ACTION_THROTTLE_MAX   = 255;
+
+// Quantised to the record's steps; steer is clamped to -1..1 and throttle to 0..1
+inline int make_action(float steer, float throttle)
+{
+    int steer_steps    = (int)std::lround(std::fmin(std::fmax(steer, -1.0f), 1.0f) * ACTION_STEER_MAX),
+        throttle_steps = (int)std::lround(std::fmin(std::fmax(throttle, 0.0f), 1.0f) * ACTION_THROTTLE_MAX);
+
+    int action = (steer_steps < 0 ? ACTION_LEFT : 0) | (steer_steps > 0 ? ACTION_RIGHT : 0) | (throttle_steps > 0 ? ACTION_BOOST : 0);
+    bool digital = (steer_steps == 0 || steer_steps == ACTION_STEER_MAX || steer_steps == -ACTION_STEER_MAX) &&
+                   (throttle_steps == 0 || throttle_steps == ACTION_THROTTLE_MAX);
+    if (digital) return action;
+
+    return action | ACTION_ANALOG | ((steer_steps & 0xff) << ACTION_STEER_SHIFT) | (throttle_steps << ACTION_THROTTLE_SHIFT);
+}
+
+// -1 to 1; left and right bits together cancel out
+inline float get_action_steer(int action)
+{
+    if (action & ACTION_ANALOG) return (float)(signed char)((action >> ACTION_STEER_SHIFT) & 0xff) / (float)ACTION_STEER_MAX;
+    return ((action & ACTION_RIGHT) ? 1.0f : 0.0f) - ((action & ACTION_LEFT) ? 1.0f : 0.0f);
+}
+
+// How much of the booster's full push it fires at while BOOST is held: 1 for a digital action
+inline float get_action_throttle(int action)
+{
+    if (action & ACTION_ANALOG) return (float)((action >> ACTION_THROTTLE_SHIFT) & 0xff) / (float)ACTION_THROTTLE_MAX;
+    return 1.0f;
+}
+
+// The bits alone, for whatever can't take anything finer
+inline int get_digital_action(int action) { return action & ACTION_DIGITAL_MASK; }
@@ -0,0 +1,118 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.h"
+#include "MemoryAccounting.h"
+
+// Loading and decode threads allocate too, so the counters are atomic; relaxed is enough, since
+// the totals are only ever read for a report and never order anything
+static std::atomic<long long>          g_allocations(0);
+static std::atomic<unsigned long long> g_allocated_bytes(0);
+
+AllocationCounts get_allocation_counts()
+{
+    return { g_allocations.load(std::memory_order_relaxed), g_allocated_bytes.load(std::memory_order_relaxed) };
+}
+
+// Ahead of every block, so the free knows what to give back and to which tag. Padded out to
+// malloc's own alignment, so the block handed out keeps it.
+struct alignas(std::max_align_t) AllocationHeader
+{
+    std::size_t size;
+    MemoryTag   tag;
+};
+
+static void release(void* memory)
+{
+    if (memory == NULL) return;
+
+    AllocationHeader* header = (AllocationHeader*)memory - 1;
+    add_cpu_memory(header->tag, -(long long)header->size);
+    std::free(header);
+}
+
+void* counted_malloc(std::size_t size)
+{
+    AllocationHeader* header = (AllocationHeader*)std::malloc(sizeof(AllocationHeader) + size);
+    if (header == NULL) return NULL;
+
+    header->size = size;
+    header->tag = get_memory_tag();
+    add_cpu_memory(header->tag, (long long)size);
+    return header + 1;
+}
+
+void* counted_realloc(void* memory, std::size_t size)
+{
+    if (memory == NULL) return counted_malloc(size);
+
+    // The block stays with the tag it was first allocated under
+    AllocationHeader* header = (AllocationHeader*)memory - 1;
+    std::size_t old_size = header->size;
+    header = (AllocationHeader*)std::realloc(header, sizeof(AllocationHeader) + size);
+    if (header == NULL) return NULL;
+
+    header->size = size;
+    add_cpu_memory(header->tag, (long long)size - (long long)old_size);
+    return header + 1;
+}
+
+void counted_free(void* memory)
+{
+    release(memory);
+}
+
+// ————— REPLACEMENT ALLOCATION FUNCTIONS ————— //
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    // Same contract as the library's: retry through the new-handler, throw once there is none
+    if (size == 0) size = 1;
+    while (true)
+    {
+        void* memory = counted_malloc(size);
+        if (memory != NULL) return memory;
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == NULL) throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); }
+    catch (...) { return NULL; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return operator new(size); }
+    catch (...) { return NULL; }
+}
+
+void operator delete(void* memory) noexcept                                { release(memory); }
+void operator delete[](void* memory) noexcept                              { release(memory); }
+void operator delete(void* memory, std::size_t) noexcept                   { release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept                 { release(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept         { release(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept       { release(memory); }
@@ -0,0 +1,27 @@
+#pragma once
+
+// Every heap allocation made through operator new, counted by replacing the global allocation
+// functions. Linking AllocationCounter.cpp is all it takes: nothing needs to call into it for the
+// counting to happen. Aligned (over-aligned type) allocations keep the library's own functions and
+// aren't counted; none of the game's types need them.
+//
+// Each block also carries a small header with its size and MemoryAccounting's tag, so the bytes
+// still live can be charged to whoever allocated them.
+#include <cstddef>
+
+struct AllocationCounts
+{
+    long long          allocations;
+    unsigned long long bytes;
+};
+
+// Running totals since startup, from every thread; subtract two readings to get what happened
+// in between
+AllocationCounts get_allocation_counts();
+
+// malloc, realloc and free with the same header, for C code that takes its own allocator (the
+// main one being stb_image, through STBI_MALLOC) so its blocks are charged to a tag too. They
+// aren't in the allocation counts.
+void* counted_malloc(std::size_t size);
+void* counted_realloc(void* memory, std::size_t size);
+void  counted_free(void* memory);
@@ -0,0 +1,77 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cmath>
+#include "AnimationLibrary.h"
+
+int AnimationLibrary::add_clip(const int* frames, const float* durations, int frame_count, AnimationLoop loop)
+{
+    Clip clip = { (int)m_frames.size(), frame_count, 0.0f, loop };
+    for (int i = 0; i < frame_count; i++)
+    {
+        clip.length += durations[i];
+        m_frames.push_back(frames[i]);
+        m_frame_ends.push_back(clip.length);
+    }
+
+    m_clips.push_back(clip);
+    return (int)m_clips.size() - 1;
+}
+
+int AnimationLibrary::add_clip(const int* frames, int frame_count, float seconds_per_frame, AnimationLoop loop)
+{
+    std::vector<float> durations(frame_count, seconds_per_frame);
+    return add_clip(frames, durations.data(), frame_count, loop);
+}
+
+int const AnimationLibrary::get_frame(int clip_id, float time) const
+{
+    const Clip& clip = m_clips[clip_id];
+    if (clip.frame_count <= 1 || !(clip.length > 0.0f)) return clip.frame_count > 0 ? m_frames[clip.first_frame] : 0;
+
+    // STEP 1: Into [0, length), or the last frame for a finished one-shot
+    switch (clip.loop)
+    {
+    case ANIMATION_LOOP:
+        time = std::fmod(time, clip.length);
+        break;
+    case ANIMATION_ONCE:
+        if (time >= clip.length) return m_frames[clip.first_frame + clip.frame_count - 1];
+        break;
+    case ANIMATION_PING_PONG:
+        time = std::fmod(time, 2.0f * clip.length);
+        if (time >= clip.length) time = 2.0f * clip.length - time;
+        break;
+    }
+
+    // STEP 2: The frame showing then; clips are a handful of frames, so a straight scan
+    const float* ends = &m_frame_ends[clip.first_frame];
+    int frame = 0;
+    while (frame < clip.frame_count - 1 && time >= ends[frame]) frame++;
+    return m_frames[clip.first_frame + frame];
+}
+
+void AnimationLibrary::advance(Animator* animators, int count, float delta_time, size_t stride) const
+{
+    unsigned char* bytes = (unsigned char*)animators;
+    for (int i = 0; i < count; i++, bytes += stride)
+    {
+        Animator& animator = *(Animator*)bytes;
+        if (animator.clip == NO_CLIP) continue;
+
+        // Kept within a lap or two of the clip, so a long-running loop doesn't lose precision
+        const Clip& clip = m_clips[animator.clip];
+        animator.time += delta_time;
+        if (clip.loop != ANIMATION_ONCE && clip.length > 0.0f) animator.time = std::fmod(animator.time, 2.0f * clip.length);
+        else if (clip.loop == ANIMATION_ONCE && animator.time > clip.length) animator.time = clip.length;
+
+        animator.frame = get_frame(animator.clip, animator.time);
+    }
+}
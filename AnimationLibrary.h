@@ -0,0 +1,69 @@
+#pragma once
+
+// Sprite animation as shared data plus a little state per animated thing. Every clip (its frames,
+// how long each shows, what happens at the end) lives once in an AnimationLibrary, built at
+// startup and only read after; an animated entity keeps an Animator, which is just the clip
+// it's playing, how far into it it is, and the sheet frame that comes to. advance() moves any
+// number of animators on by the frame's time in one pass, and the frame it leaves in each is the
+// sheet index the sprite batch draws, with nothing else to look up at draw time.
+//
+// No GL and no allocation after the clips are added, so anything can hold an Animator and the
+// library can be read from any thread.
+#include <cstddef>
+#include <vector>
+
+enum AnimationLoop
+{
+    ANIMATION_LOOP,       // back to the first frame after the last
+    ANIMATION_ONCE,       // holds the last frame
+    ANIMATION_PING_PONG,  // forwards, then backwards, and round again
+};
+
+struct Animator
+{
+    int   clip  = -1;    // AnimationLibrary::NO_CLIP for none
+    float time  = 0.0f;  // seconds into the clip
+    int   frame = 0;     // the sheet frame, as of the last advance()
+
+    // From its start if it's a different clip; carrying on if it's this one
+    void play(int new_clip)
+    {
+        if (new_clip == clip) return;
+        clip = new_clip;
+        time = 0.0f;
+    }
+};
+
+class AnimationLibrary
+{
+private:
+    struct Clip
+    {
+        int           first_frame,  // into m_frames and m_frame_ends
+                      frame_count;
+        float         length;       // seconds, every frame's duration summed
+        AnimationLoop loop;
+    };
+
+    std::vector<Clip>  m_clips;
+    std::vector<int>   m_frames;      // every clip's sheet frames, one after another
+    std::vector<float> m_frame_ends;  // when each of them ends, from its clip's start
+
+public:
+    static const int NO_CLIP = -1;
+
+    // Returns the clip's id, for Animator::play. `durations` are seconds, one per frame.
+    int add_clip(const int* frames, const float* durations, int frame_count, AnimationLoop loop);
+    int add_clip(const int* frames, int frame_count, float seconds_per_frame, AnimationLoop loop);
+
+    // Every animator moved on by delta_time, and its frame brought up to date. `stride` is the
+    // distance between one and the next in bytes, so they can be read in place from inside
+    // an array of bigger things (Entity::m_animator across an array of entities, say).
+    void advance(Animator* animators, int count, float delta_time, size_t stride = sizeof(Animator)) const;
+
+    // The sheet frame `time` seconds into `clip`, after its loop mode has wrapped or clamped it
+    int const get_frame(int clip, float time) const;
+
+    int   const get_clip_count()        const { return (int)m_clips.size(); };
+    float const get_length(int clip)    const { return m_clips[clip].length; };
+};
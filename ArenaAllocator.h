@@ -0,0 +1,51 @@
+#pragma once
+
+// Standard-library allocator over a LevelArena, for containers whose contents are gone by the
+// arena's next reset(). deallocate() does nothing: the memory only comes back with the reset,
+// so a container that grows step by step leaves its old buffers behind until then; reserve()
+// up front where the size is known.
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "LevelArena.h"
+
+// The same bump allocator, reset at the top of every render() for everything that lives one frame
+typedef LevelArena FrameArena;
+
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+
+    // Assigning a fresh arena-backed container over an old one has to take its arena along
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    // NULL falls back to the heap, so arena-backed members can be constructed before the arena
+    LevelArena* m_arena;
+
+    ArenaAllocator(LevelArena* arena = NULL) : m_arena(arena) {}
+    template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+    T* allocate(size_t count)
+    {
+        if (m_arena == NULL) return (T*)::operator new(count * sizeof(T));
+        return (T*)m_arena->allocate(count * sizeof(T), alignof(T));
+    }
+
+    void deallocate(T* pointer, size_t count)
+    {
+        if (m_arena == NULL) ::operator delete(pointer);
+    }
+
+    template <typename U> bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.m_arena; }
+    template <typename U> bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.m_arena; }
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> FrameString;
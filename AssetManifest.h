@@ -0,0 +1,27 @@
+#pragma once
+
+// Generated by AssetPacker (pack_assets.cpp) with assets.pak. Do not edit by hand; repack
+// instead, and rebuild with the new pack.
+#include "AssetPack.h"
+
+enum AssetId : uint32_t
+{
+    ASSET_FONT_SDF,
+    ASSET_PLATFORM,
+    ASSET_ROCK,
+    ASSET_SHIP,
+    ASSET_STONE,
+    ASSET_COUNT
+};
+
+namespace AssetManifest
+{
+    constexpr AssetManifestEntry ENTRIES[ASSET_COUNT] =
+    {
+        { "assets/font_sdf.tga", hash_asset_path("assets/font_sdf.tga"), 128, 196, 448 },
+        { "assets/platform.png", hash_asset_path("assets/platform.png"), 16, 16, 134208 },
+        { "assets/rock.png", hash_asset_path("assets/rock.png"), 16, 16, 135616 },
+        { "assets/ship.png", hash_asset_path("assets/ship.png"), 61, 22, 137024 },
+        { "assets/stone.png", hash_asset_path("assets/stone.png"), 16, 16, 144128 },
+    };
+}
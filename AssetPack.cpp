@@ -0,0 +1,344 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include "AssetManifest.h"
+#include "AssetPack.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/fetch.h>
+#endif
+
+const char AssetPack::MAGIC[4] = { 'L', 'P', 'A', 'K' };
+
+bool AssetPack::open(const char* filepath)
+{
+    close();
+
+    // STEP 1: Map the file
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (size_t)size.QuadPart;
+#else
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    m_file = file;
+    m_data = data == MAP_FAILED ? NULL : (const unsigned char*)data;
+    m_size = (size_t)status.st_size;
+#endif
+
+    if (m_data == NULL)
+    {
+        close();
+        return false;
+    }
+
+    // STEP 2: Validate the header and every entry up front, so find() can trust the index
+    if (!read_index(m_data, m_size))
+    {
+        close();
+        return false;
+    }
+
+    m_received = m_size;
+    return true;
+}
+
+bool AssetPack::read_index(const unsigned char* data, size_t size)
+{
+    const AssetPackHeader* header = (const AssetPackHeader*)data;
+    if (size < sizeof(AssetPackHeader) || std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->entry_count > (size - sizeof(AssetPackHeader)) / sizeof(AssetPackEntry))
+    {
+        return false;
+    }
+
+    const AssetPackEntry* entries = (const AssetPackEntry*)(data + sizeof(AssetPackHeader));
+    for (uint32_t i = 0; i < header->entry_count; i++)
+    {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.name[sizeof(entry.name) - 1] != '\0' || entry.mip_levels < 1 || entry.mip_levels > count_mip_levels(entry.width, entry.height)) return false;
+
+        uint64_t byte_count = get_chain_bytes(entry);
+        if (entry.offset > size || byte_count > size - entry.offset) return false;
+    }
+
+    // The manifest was written with the pack, so each asset is normally the entry at its own
+    // index; the search is for a pack that was repacked since
+    std::vector<const AssetPackEntry*> assets(ASSET_COUNT, NULL);
+    for (uint32_t asset = 0; asset < ASSET_COUNT; asset++)
+    {
+        uint32_t id = AssetManifest::ENTRIES[asset].id;
+        if (asset < header->entry_count && entries[asset].id == id)
+        {
+            assets[asset] = &entries[asset];
+            continue;
+        }
+        for (uint32_t i = 0; i < header->entry_count && assets[asset] == NULL; i++)
+        {
+            if (entries[i].id == id) assets[asset] = &entries[i];
+        }
+    }
+
+    m_entries = entries;
+    m_count = header->entry_count;
+    m_assets = std::move(assets);
+    return true;
+}
+
+bool const AssetPack::has_arrived(const AssetPackEntry& entry) const
+{
+    return entry.offset + get_chain_bytes(entry) <= m_received.load(std::memory_order_acquire);
+}
+
+// ————— MIP CHAINS ————— //
+uint64_t AssetPack::get_mip_bytes(const AssetPackEntry& entry, int level)
+{
+    return (uint64_t)get_mip_extent(entry.width, level) * get_mip_extent(entry.height, level) * 4;
+}
+
+uint64_t AssetPack::get_mip_offset(const AssetPackEntry& entry, int level)
+{
+    uint64_t offset = entry.offset;
+    for (int i = 0; i < level; i++) offset += get_mip_bytes(entry, i);
+    return offset;
+}
+
+uint64_t AssetPack::get_chain_bytes(const AssetPackEntry& entry, int level)
+{
+    // Capped at a full chain, for an index that hasn't been checked yet
+    int levels = (int)std::min(entry.mip_levels, count_mip_levels(entry.width, entry.height));
+    uint64_t bytes = 0;
+    for (int i = level; i < levels; i++) bytes += get_mip_bytes(entry, i);
+    return bytes;
+}
+
+uint32_t AssetPack::count_mip_levels(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1;
+    for (uint32_t extent = std::max(width, height); extent > 1; extent >>= 1) levels++;
+    return levels;
+}
+
+// ————— STREAMING ————— //
+void AssetPack::begin_stream()
+{
+    close();
+    m_streaming = true;
+}
+
+bool AssetPack::append(const void* bytes, size_t offset, size_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_streaming || m_stream_done) return false;
+    auto fail = [this]()
+        {
+            m_stream_done = true;
+            m_arrived.notify_all();
+            return false;
+        };
+
+    // STEP 1: Only what's new, at the end of what's in
+    size_t received = m_received.load(std::memory_order_relaxed);
+    if (offset > received) return fail();  // a gap can't be filled in later
+    if (offset + count <= received) return true;
+    const unsigned char* source = (const unsigned char*)bytes + (received - offset);
+    count -= received - offset;
+
+    // STEP 2: Until the index is in, the buffer grows with the bytes. Once it is, the buffer takes
+    //         the size of the whole pack in one go, before anyone can hold a pointer into it.
+    if (m_data == NULL)
+    {
+        m_buffer.insert(m_buffer.end(), source, source + count);
+        received += count;
+
+        const AssetPackHeader* header = (const AssetPackHeader*)m_buffer.data();
+        if (received >= sizeof(AssetPackHeader))
+        {
+            size_t index_size = sizeof(AssetPackHeader) + (size_t)header->entry_count * sizeof(AssetPackEntry);
+            if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) return fail();
+
+            if (received >= index_size)
+            {
+                // The pack ends with its furthest image; anything after that is never read
+                size_t size = index_size;
+                const AssetPackEntry* entries = (const AssetPackEntry*)(m_buffer.data() + sizeof(AssetPackHeader));
+                for (uint32_t i = 0; i < header->entry_count; i++)
+                {
+                    size = std::max(size, (size_t)(entries[i].offset + get_chain_bytes(entries[i])));
+                }
+                m_buffer.resize(std::max(size, received));
+
+                if (!read_index(m_buffer.data(), m_buffer.size())) return fail();
+                m_data = m_buffer.data();
+                m_size = m_buffer.size();
+            }
+        }
+    }
+    else
+    {
+        count = std::min(count, m_size - received);
+        std::memcpy(m_buffer.data() + received, source, count);
+        received += count;
+    }
+
+    m_received.store(received, std::memory_order_release);
+    m_arrived.notify_all();
+    return true;
+}
+
+void AssetPack::end_stream()
+{
+    // Cut short, whatever had already arrived stays findable
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fetch = NULL;
+    m_stream_done = true;
+    m_arrived.notify_all();
+}
+
+#ifdef __EMSCRIPTEN__
+static void on_fetch_progress(emscripten_fetch_t* fetch)
+{
+    AssetPack* pack = (AssetPack*)fetch->userData;
+    if (fetch->data != NULL && fetch->numBytes > 0) pack->append(fetch->data, (size_t)fetch->dataOffset, (size_t)fetch->numBytes);
+}
+
+static void on_fetch_success(emscripten_fetch_t* fetch)
+{
+    // A browser that can't stream the body hands it all over here instead, at once
+    on_fetch_progress(fetch);
+    ((AssetPack*)fetch->userData)->end_stream();
+    emscripten_fetch_close(fetch);
+}
+
+static void on_fetch_error(emscripten_fetch_t* fetch)
+{
+    ((AssetPack*)fetch->userData)->end_stream();
+    emscripten_fetch_close(fetch);
+}
+
+bool AssetPack::fetch(const char* url)
+{
+    begin_stream();
+
+    emscripten_fetch_attr_t attributes;
+    emscripten_fetch_attr_init(&attributes);
+    std::strcpy(attributes.requestMethod, "GET");
+    attributes.attributes = EMSCRIPTEN_FETCH_LOAD_TO_MEMORY | EMSCRIPTEN_FETCH_STREAM_DATA;
+    attributes.userData   = this;
+    attributes.onprogress = on_fetch_progress;
+    attributes.onsuccess  = on_fetch_success;
+    attributes.onerror    = on_fetch_error;
+
+    m_fetch = emscripten_fetch(&attributes, url);
+    if (m_fetch == NULL) end_stream();
+    return m_fetch != NULL;
+}
+#endif
+
+void AssetPack::close()
+{
+#ifdef __EMSCRIPTEN__
+    // Closing an unfinished download aborts it, and none of its callbacks come after
+    if (m_fetch != NULL) emscripten_fetch_close((emscripten_fetch_t*)m_fetch);
+#endif
+    m_fetch = NULL;
+
+    // A streamed pack's data is the buffer, not a mapping
+#ifdef _WIN32
+    if (m_mapping != NULL && m_data != NULL) UnmapViewOfFile(m_data);
+    if (m_mapping != NULL) CloseHandle(m_mapping);
+    if (m_file != NULL) CloseHandle(m_file);
+    m_file = m_mapping = NULL;
+#else
+    if (m_file >= 0 && m_data != NULL) munmap((void*)m_data, m_size);
+    if (m_file >= 0) ::close(m_file);
+    m_file = -1;
+#endif
+
+    m_data = NULL;
+    m_size = 0;
+    m_entries = NULL;
+    m_count = 0;
+    m_assets.clear();
+    m_buffer = std::vector<unsigned char>();
+    m_received = 0;
+    m_streaming = m_stream_done = false;
+}
+
+const AssetPackEntry* AssetPack::find(AssetId asset) const
+{
+    if (m_assets.empty()) return NULL;
+
+    const AssetPackEntry* entry = m_assets[asset];
+    return entry != NULL && has_arrived(*entry) ? entry : NULL;
+}
+
+const AssetPackEntry* AssetPack::find(const char* name) const
+{
+    // A handful of entries, so a linear scan beats building a map at startup; the name is only
+    // compared once the id matches
+    uint32_t id = hash_asset_path(name);
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        if (m_entries[i].id == id && std::strncmp(m_entries[i].name, name, sizeof(m_entries[i].name)) == 0) return has_arrived(m_entries[i]) ? &m_entries[i] : NULL;
+    }
+    return NULL;
+}
+
+const AssetPackEntry* AssetPack::wait_for(AssetId asset) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // STEP 1: The index, so there is something to look the asset up in...
+    m_arrived.wait(lock, [this]() { return m_entries != NULL || !is_streaming(); });
+    if (m_assets.empty() || m_assets[asset] == NULL) return NULL;
+
+    // STEP 2: ...then the image's own bytes
+    const AssetPackEntry& entry = *m_assets[asset];
+    m_arrived.wait(lock, [this, &entry]() { return has_arrived(entry) || !is_streaming(); });
+    return has_arrived(entry) ? &entry : NULL;
+}
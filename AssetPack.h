@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// assets.pak: every texture already decoded to RGBA8, written offline by pack_assets so that
+// startup maps one file instead of inflating a PNG per texture.
+//
+//   AssetPackHeader | AssetPackEntry[entry_count] | pixels, each image PIXEL_ALIGNMENT-aligned
+//
+// Each image is followed by its box-filtered mip chain, level after level down to 1x1, so a
+// streamer (TextureStreamer.h) can upload any level straight from the mapped pages. get_pixels()
+// is level 0, as it always was.
+//
+// All fields are little-endian; offsets count from the start of the file.
+//
+// The packer also writes AssetManifest.h: an AssetId for every image it packed, in pack order,
+// with each one's path, id and offset as constants. open() matches the index against it once,
+// by id, so from then on the game finds an image by indexing an array with its AssetId, and
+// never hashes or compares a path. A pack that doesn't match the manifest (repacked without
+// rebuilding, say) still opens: the images it doesn't have come back NULL, as if missing.
+//
+// The web build can't map anything, so it streams the file instead (fetch()): the bytes land in
+// one buffer in order, sized once the index is in, and each image can be found as soon as all of
+// its own bytes have arrived. Images arrive in the order they were given to AssetPacker, so the
+// ones the loading screen needs go first and are usable while the rest are still downloading.
+struct AssetPackHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+};
+
+struct AssetPackEntry
+{
+    char     name[56];  // the source path, e.g. "assets/ship.png", NUL-padded
+    uint32_t width, height;
+    uint64_t offset;
+    uint32_t id;        // hash_asset_path(name)
+    uint32_t mip_levels;  // level 0 included, down to 1x1
+};
+
+// FNV-1a of the path, as the pack's index and the manifest both hold it
+constexpr uint32_t hash_asset_path(const char* path)
+{
+    uint32_t hash = 2166136261u;
+    for (; *path != '\0'; path++) hash = (hash ^ (uint8_t)*path) * 16777619u;
+    return hash;
+}
+
+// One packed image as AssetManifest.h records it
+struct AssetManifestEntry
+{
+    const char* path;
+    uint32_t    id;
+    uint32_t    width, height;
+    uint64_t    offset;
+};
+
+// AssetManifest.h's
+enum AssetId : uint32_t;
+
+class AssetPack
+{
+private:
+    const unsigned char*  m_data    = NULL;
+    size_t                m_size    = 0;
+    const AssetPackEntry* m_entries = NULL;
+    uint32_t              m_count   = 0;
+    std::vector<const AssetPackEntry*> m_assets;  // by AssetId; NULL where the pack lacks it
+
+#ifdef _WIN32
+    void* m_file    = NULL,
+        * m_mapping = NULL;
+#else
+    int m_file = -1;
+#endif
+
+    // Streaming: everything the main thread writes, under the mutex, and what waiters wake on
+    std::vector<unsigned char> m_buffer;
+    std::atomic<size_t>        m_received{ 0 };
+    bool                       m_streaming   = false,
+                               m_stream_done = false;
+    void*                      m_fetch = NULL;  // the emscripten_fetch_t still downloading
+    mutable std::mutex              m_mutex;
+    mutable std::condition_variable m_arrived;
+
+    // Checks the header and every entry against `size` bytes of file, so find() can trust the
+    // index, and matches it against the manifest
+    bool read_index(const unsigned char* data, size_t size);
+    bool const has_arrived(const AssetPackEntry& entry) const;
+
+public:
+    static const uint32_t VERSION         = 3;
+    static const size_t   PIXEL_ALIGNMENT = 64;
+    static const char     MAGIC[4];
+
+    AssetPack() = default;
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+    ~AssetPack() { close(); }
+
+    // Maps the whole file read-only; false if it is missing, truncated or from another version
+    bool open(const char* filepath);
+    void close();
+
+    // Streaming, main thread only: bytes in file order from `offset`, any overlap with what has
+    // already arrived skipped. append() is false once the stream has turned out not to be a pack;
+    // after that, or end_stream(), waiters stop waiting for what hasn't arrived.
+    void begin_stream();
+    bool append(const void* bytes, size_t offset, size_t count);
+    void end_stream();
+
+#ifdef __EMSCRIPTEN__
+    // Starts downloading the pack into begin_stream/append/end_stream and returns; the callbacks
+    // run on the main thread between frames. False if the request couldn't be made at all.
+    bool fetch(const char* url);
+#endif
+
+    // NULL for an image not in the pack, or one still downloading. The pixels stay valid,
+    // straight out of the mapped pages or the stream's buffer, until close().
+    const AssetPackEntry* find(AssetId asset) const;
+    // Anything not in the manifest, e.g. whatever TextureCache is asked for, by its path's id
+    const AssetPackEntry* find(const char* name) const;
+
+    // As find(), but blocks until the image has arrived, or the stream has ended without it. Only
+    // off the main thread, since the main thread is the one appending.
+    const AssetPackEntry* wait_for(AssetId asset) const;
+    const unsigned char*  get_pixels(const AssetPackEntry& entry) const { return m_data + entry.offset; };
+    const unsigned char*  get_mip_pixels(const AssetPackEntry& entry, int level) const { return m_data + get_mip_offset(entry, level); };
+
+    // A level's size halves each way, and stops at 1; its pixels follow the level before's
+    static uint32_t get_mip_extent(uint32_t extent, int level) { return extent >> level > 0 ? extent >> level : 1; };
+    static uint64_t get_mip_bytes(const AssetPackEntry& entry, int level);
+    static uint64_t get_mip_offset(const AssetPackEntry& entry, int level);
+    // From `level` to the end of the chain
+    static uint64_t get_chain_bytes(const AssetPackEntry& entry, int level = 0);
+    // The levels a full chain of this size has
+    static uint32_t count_mip_levels(uint32_t width, uint32_t height);
+
+    bool   const is_open()         const { return m_data != NULL || m_streaming; };
+    bool   const is_streaming()    const { return m_streaming && !m_stream_done; };
+    int    const get_entry_count() const { return (int)m_count; };
+    size_t const get_size()        const { return m_size; };
+};
@@ -0,0 +1,194 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "stb_image.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "AsyncTextureLoader.h"
+#include "Trace.h"
+
+const unsigned char AsyncTextureLoader::PLACEHOLDER_TEXEL[4] = { 128, 128, 128, 255 };  // flat grey until the art arrives
+
+// Filters are set once on the placeholder and survive the respecify, so whatever preset the owner
+// applied in the meantime still holds for the real image
+static void specify_texture(GLuint texture_id, int width, int height, const unsigned char* pixels, bool generate_mipmaps)
+{
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    track_gpu_texture(texture_id, estimate_texture_bytes(width, height, generate_mipmaps));
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    prepare_mip_chain(texture_id, generate_mipmaps);
+}
+
+void AsyncTextureLoader::initialise(int thread_count)
+{
+    if (!m_threads.empty()) return;
+
+    m_stopping = false;
+    for (int i = 0; i < std::max(1, thread_count); i++) m_threads.emplace_back(&AsyncTextureLoader::worker_loop, this);
+}
+
+void AsyncTextureLoader::cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+    m_threads.clear();
+
+    for (const DecodedImage& image : m_decoded) stbi_image_free(image.pixels);
+    m_decoded.clear();
+    m_in_flight.clear();
+}
+
+void AsyncTextureLoader::worker_loop()
+{
+    // Decoded images belong to the assets until they're uploaded and freed
+    MemoryScope memory(MEMORY_ASSETS);
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        // The expensive part, and the only one that runs without the lock. stb_image keeps no
+        // global state between calls, so any number of these can run at once.
+        DecodedImage image = { job.ticket, std::move(job.filepath), 0, 0, NULL };
+        {
+            TRACE_ZONE("decode texture");
+            int number_of_components;
+            image.pixels = stbi_load(image.filepath.c_str(), &image.width, &image.height, &number_of_components, STBI_rgb_alpha);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decoded.push_back(std::move(image));
+    }
+}
+
+GLuint AsyncTextureLoader::request(const char* filepath)
+{
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    apply_sampler_preset(texture_id, SAMPLER_PIXEL_ART);
+
+    reload(texture_id, filepath);
+    return texture_id;
+}
+
+void AsyncTextureLoader::reload(GLuint texture_id, const char* filepath)
+{
+    // A decode still out for this texture is superseded rather than landing on top of this one
+    cancel(texture_id);
+    specify_texture(texture_id, 1, 1, PLACEHOLDER_TEXEL, false);
+
+    Ticket ticket = { texture_id, m_next_serial++ };
+    m_in_flight.push_back(ticket);
+
+    // Without workers there is nobody to hand the job to, so decode here instead of never
+    if (m_threads.empty())
+    {
+        TRACE_ZONE("decode texture");
+        int width, height, number_of_components;
+        unsigned char* pixels = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decoded.push_back({ ticket, filepath, width, height, pixels });
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({ ticket, filepath });
+    }
+    m_wake.notify_one();
+}
+
+void AsyncTextureLoader::cancel(GLuint texture_id)
+{
+    // A decode already under way still finishes; upload() just finds nobody waiting for it
+    m_in_flight.erase(std::remove_if(m_in_flight.begin(), m_in_flight.end(), [texture_id](const Ticket& ticket) { return ticket.texture_id == texture_id; }),
+                      m_in_flight.end());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(), [texture_id](const Job& job) { return job.ticket.texture_id == texture_id; }), m_jobs.end());
+}
+
+bool const AsyncTextureLoader::is_pending(GLuint texture_id) const
+{
+    for (const Ticket& ticket : m_in_flight)
+    {
+        if (ticket.texture_id == texture_id) return true;
+    }
+    return false;
+}
+
+void AsyncTextureLoader::upload(float budget_seconds)
+{
+    TRACE_ZONE("AsyncTextureLoader::upload");
+    auto start = std::chrono::steady_clock::now();
+    bool uploaded_any = false;
+
+    while (true)
+    {
+        // STEP 1: Stop once the budget is spent, but never before the first upload of the frame
+        float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        if (uploaded_any && elapsed >= budget_seconds) break;
+
+        // STEP 2: Take one finished decode, holding the lock only for the pop
+        DecodedImage image;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_decoded.empty()) break;
+
+            image = std::move(m_decoded.front());
+            m_decoded.pop_front();
+        }
+
+        // STEP 3: Respecify the placeholder, unless the texture was released in the meantime
+        auto waiting = std::find_if(m_in_flight.begin(), m_in_flight.end(), [&image](const Ticket& ticket)
+            {
+                return ticket.texture_id == image.ticket.texture_id && ticket.serial == image.ticket.serial;
+            });
+        if (waiting != m_in_flight.end())
+        {
+            m_in_flight.erase(waiting);
+
+            if (image.pixels == NULL) std::cout << "Unable to load image " << image.filepath << ". Make sure the path is correct." << std::endl;
+            else
+            {
+                specify_texture(image.ticket.texture_id, image.width, image.height, image.pixels, m_generate_mipmaps);
+                uploaded_any = true;
+            }
+        }
+
+        stbi_image_free(image.pixels);
+    }
+}
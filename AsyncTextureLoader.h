@@ -0,0 +1,94 @@
+#pragma once
+
+// Decodes images on worker threads so that startup never waits on stb_image. Every request gets
+// its GL texture name straight away, holding a 1x1 placeholder texel; once the decode finishes,
+// upload() respecifies that same texture with the real image on the GL thread. Whoever holds the
+// id therefore switches over on its own, with no second lookup.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TextureSampling.h"
+
+class AsyncTextureLoader
+{
+private:
+    // GL recycles deleted texture names, so a ticket is what ties a decode to its request
+    struct Ticket
+    {
+        GLuint       texture_id;
+        unsigned int serial;
+    };
+
+    struct Job
+    {
+        Ticket      ticket;
+        std::string filepath;
+    };
+
+    struct DecodedImage
+    {
+        Ticket         ticket;
+        std::string    filepath;
+        int            width, height;
+        unsigned char* pixels;  // RGBA from stb_image, NULL if the decode failed
+    };
+
+    std::vector<std::thread> m_threads;
+
+    // ————— SHARED WITH THE WORKERS ————— //
+    std::mutex               m_mutex;
+    std::condition_variable  m_wake;
+    std::deque<Job>          m_jobs;
+    std::deque<DecodedImage> m_decoded;
+    bool                     m_stopping = false;
+
+    // ————— GL THREAD ONLY ————— //
+    std::vector<Ticket> m_in_flight;  // requested and neither uploaded nor cancelled yet
+    unsigned int        m_next_serial = 0;
+    bool                m_generate_mipmaps = false;
+
+    void worker_loop();
+
+public:
+    static const int DEFAULT_THREAD_COUNT = 2;  // decoding is memory-bound well before it is core-bound
+    static const unsigned char PLACEHOLDER_TEXEL[4];
+
+    AsyncTextureLoader() = default;
+    AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+    AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+    ~AsyncTextureLoader() { cleanup(); }
+
+    void initialise(int thread_count = DEFAULT_THREAD_COUNT);
+
+    // Joins the workers and drops whatever has not been uploaded; the textures themselves stay
+    // with whoever requested them
+    void cleanup();
+
+    // GL thread. Returns a placeholder texture that becomes the image once upload() gets to it
+    GLuint request(const char* filepath);
+
+    // GL thread. As request(), into a texture that already exists: it goes back to the placeholder
+    // until the decode lands, keeping its filters
+    void reload(GLuint texture_id, const char* filepath);
+
+    // GL thread. The texture is about to be deleted, so its decode must never be uploaded
+    void cancel(GLuint texture_id);
+
+    // GL thread, once a frame. Uploads finished decodes until budget_seconds have gone by, and
+    // always at least one so a tight budget still makes progress
+    void upload(float budget_seconds);
+
+    // Mip chains are built after each real image lands; the placeholder never gets one
+    void set_generate_mipmaps(bool generate_mipmaps) { m_generate_mipmaps = generate_mipmaps; };
+
+    int  const get_pending_count() const { return (int)m_in_flight.size(); };
+    bool const is_pending(GLuint texture_id) const;
+};
@@ -0,0 +1,169 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cstring>
+#include "AudioMixer.h"
+#include "SimdDispatch.h"
+#include "Trace.h"
+
+#ifdef LANDER_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef LANDER_SIMD_SSE2
+static bool use_sse2()
+{
+    static const bool sse2 = get_simd_isa() != SIMD_SCALAR;
+    return sse2;
+}
+#endif
+
+// out += samples * gain, with the gain rising by gain_step every sample
+static void mix_span(float* out, const float* samples, int count, float gain, float gain_step)
+{
+    int i = 0;
+#ifdef LANDER_SIMD_SSE2
+    if (use_sse2())
+    {
+        __m128 gains = _mm_setr_ps(gain, gain + gain_step, gain + 2.0f * gain_step, gain + 3.0f * gain_step);
+        const __m128 gains_step = _mm_set1_ps(4.0f * gain_step);
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(samples + i), gains)));
+            gains = _mm_add_ps(gains, gains_step);
+        }
+    }
+#endif
+    for (; i < count; i++) out[i] += samples[i] * (gain + (float)i * gain_step);
+}
+
+// out = clamp(out * gain, -1, 1)
+static void finish_span(float* out, int count, float gain)
+{
+    int i = 0;
+#ifdef LANDER_SIMD_SSE2
+    if (use_sse2())
+    {
+        const __m128 gains = _mm_set1_ps(gain),
+                     low   = _mm_set1_ps(-1.0f),
+                     high  = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4) _mm_storeu_ps(out + i, _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(out + i), gains), low), high));
+    }
+#endif
+    for (; i < count; i++) out[i] = std::min(std::max(out[i] * gain, -1.0f), 1.0f);
+}
+
+int AudioMixer::add_bank(std::vector<float> samples)
+{
+    m_banks.push_back(std::move(samples));
+    return (int)m_banks.size() - 1;
+}
+
+// ————— GAME THREAD ————— //
+bool AudioMixer::play(int voice, int bank, float gain, bool loop)
+{
+    return m_commands.try_push(AudioCommand{ AUDIO_PLAY, voice, bank, gain, loop });
+}
+
+bool AudioMixer::stop(int voice)
+{
+    return m_commands.try_push(AudioCommand{ AUDIO_STOP, voice, -1, 0.0f, false });
+}
+
+bool AudioMixer::set_gain(int voice, float gain)
+{
+    return m_commands.try_push(AudioCommand{ AUDIO_SET_GAIN, voice, -1, gain, false });
+}
+
+// ————— AUDIO THREAD ————— //
+void AudioMixer::apply(const AudioCommand& command)
+{
+    if (command.voice < 0 || command.voice >= MAX_VOICES) return;
+    Voice& voice = m_voices[command.voice];
+
+    switch (command.type)
+    {
+    case AUDIO_PLAY:
+        if (command.bank < 0 || command.bank >= (int)m_banks.size() || m_banks[command.bank].empty()) return;
+        voice.bank = command.bank;
+        voice.position = 0;
+        voice.gain = voice.target_gain = command.gain;
+        voice.loop = command.loop;
+        voice.stopping = false;
+        break;
+
+    case AUDIO_STOP:
+        voice.target_gain = 0.0f;
+        voice.stopping = true;
+        break;
+
+    case AUDIO_SET_GAIN:
+        voice.target_gain = command.gain;
+        break;
+    }
+}
+
+void AudioMixer::mix(float* out, int frame_count)
+{
+    TRACE_ZONE("audio mix");
+
+    // STEP 1: Whatever the game sent since the last buffer
+    AudioCommand commands[32];
+    size_t count;
+    while ((count = m_commands.try_pop(commands, 32)) > 0)
+    {
+        for (size_t i = 0; i < count; i++) apply(commands[i]);
+    }
+
+    // STEP 2: Every voice that's playing, each ramping to its new gain over the buffer
+    std::memset(out, 0, sizeof(float) * frame_count);
+
+    for (Voice& voice : m_voices)
+    {
+        if (voice.bank < 0) continue;
+
+        const std::vector<float>& samples = m_banks[voice.bank];
+
+        // A loop turned all the way down, like the thruster between burns, just keeps its place
+        if (voice.gain == 0.0f && voice.target_gain == 0.0f && voice.loop && !voice.stopping)
+        {
+            voice.position = (voice.position + frame_count) % samples.size();
+            continue;
+        }
+
+        const float gain_step = (voice.target_gain - voice.gain) / (float)frame_count;
+
+        int mixed = 0;
+        while (mixed < frame_count)
+        {
+            int span = (int)std::min((size_t)(frame_count - mixed), samples.size() - voice.position);
+            mix_span(out + mixed, samples.data() + voice.position, span, voice.gain + (float)mixed * gain_step, gain_step);
+
+            mixed += span;
+            voice.position += span;
+            if (voice.position < samples.size()) continue;
+
+            // Off the end of the bank: round again, or done
+            voice.position = 0;
+            if (!voice.loop)
+            {
+                voice.bank = -1;
+                break;
+            }
+        }
+
+        voice.gain = voice.target_gain;
+        if (voice.stopping && voice.gain == 0.0f) voice.bank = -1;
+    }
+
+    // STEP 3: Master gain, clipped into range rather than wrapping
+    finish_span(out, frame_count, m_master_gain);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// The game's sound, mixed on the audio device's own thread (SDL's audio callback) from sample
+// banks decoded up front. The game thread never touches a voice: it sends play, stop and gain
+// commands through an SpscRing, and the mixer applies them at the top of its next buffer.
+// Nothing on the audio thread locks, allocates or waits, so a slow frame can't glitch the
+// sound and a busy mixer can't hold up a frame.
+//
+// Voices are slots the caller picks, e.g. one for the thruster and one per kind of effect:
+// playing into a busy slot restarts it. Gain changes ramp across one buffer instead of jumping,
+// so they never click.
+#include <vector>
+#include "SpscRing.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LANDER_SIMD_SSE2 1
+#endif
+
+enum AudioCommandType { AUDIO_PLAY, AUDIO_STOP, AUDIO_SET_GAIN };
+
+struct AudioCommand
+{
+    AudioCommandType type;
+    int   voice,
+          bank;   // AUDIO_PLAY only
+    float gain;   // AUDIO_PLAY and AUDIO_SET_GAIN
+    bool  loop;   // AUDIO_PLAY only
+};
+
+class AudioMixer
+{
+public:
+    static const int MAX_VOICES = 8;
+
+private:
+    static const int COMMAND_CAPACITY = 256;
+
+    struct Voice
+    {
+        int    bank = -1;  // -1 when silent
+        size_t position = 0;
+        float  gain = 0.0f,
+               target_gain = 0.0f;
+        bool   loop = false,
+               stopping = false;  // fading out, then silent
+    };
+
+    // Filled before the device starts and only read after, so they need no synchronisation
+    std::vector<std::vector<float>> m_banks;
+    int   m_sample_rate = 0;
+    float m_master_gain = 1.0f;
+
+    SpscRing<AudioCommand> m_commands;
+
+    // ————— AUDIO THREAD ————— //
+    Voice m_voices[MAX_VOICES];
+
+    void apply(const AudioCommand& command);
+
+public:
+    AudioMixer() : m_commands(COMMAND_CAPACITY) {};
+
+    // Not thread-safe: before the device starts calling mix()
+    void set_sample_rate(int sample_rate) { m_sample_rate = sample_rate; };
+    void set_master_gain(float gain)      { m_master_gain = gain; };
+    // Mono samples at the mixer's rate, from -1 to 1; returns the bank's index
+    int  add_bank(std::vector<float> samples);
+
+    // ————— GAME THREAD ————— //
+    // False when the mixer has fallen a whole command ring behind, and the command is dropped
+    bool play(int voice, int bank, float gain = 1.0f, bool loop = false);
+    bool stop(int voice);
+    bool set_gain(int voice, float gain);
+
+    // ————— AUDIO THREAD ————— //
+    // Fills `out` with frame_count mono samples
+    void mix(float* out, int frame_count);
+
+    int const get_sample_rate() const { return m_sample_rate; };
+    int const get_bank_count()  const { return (int)m_banks.size(); };
+};
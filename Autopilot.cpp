@@ -0,0 +1,262 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cmath>
+#include "Autopilot.h"
+#include "LandingSiteMap.h"
+#include "Trace.h"
+
+// The plan's actions, two bits a segment; keyboard input never boosts and steers at once
+static const int SEGMENT_ACTIONS[4] = { AUTOPILOT_NONE, AUTOPILOT_BOOST, AUTOPILOT_LEFT, AUTOPILOT_RIGHT };
+
+// Any landing beats any flight, and any flight beats any crash. Among landings the softest and
+// then the soonest wins; among crashes the latest, which leaves the most time to find better.
+const float LAND_SCORE             = 1000.0f,
+            CRASH_SCORE            = -1000.0f,
+            TOUCHDOWN_SPEED_WEIGHT = 10.0f,
+            STEP_WEIGHT            = 0.01f,
+            // A flight that ends undecided is scored on how far it is left from the target
+            DISTANCE_WEIGHT        = 2.0f,
+            BELOW_TARGET_WEIGHT    = 5.0f,  // under the platform's top it has to climb first
+            SPEED_WEIGHT           = 0.5f;
+
+// Any odd number walks every plan code exactly once modulo a power of two
+const uint32_t PLAN_STRIDE = 2654435761u;
+
+void apply_autopilot_action(Entity* player, int action)
+{
+    float movement_x = 0.0f;
+    if (action & AUTOPILOT_LEFT)  movement_x -= 1.0f;
+    if (action & AUTOPILOT_RIGHT) movement_x += 1.0f;
+
+    player->set_movement(glm::vec3(movement_x, 0.0f, 0.0f));
+    player->m_booster_active = (action & AUTOPILOT_BOOST) != 0;
+    player->m_throttle = 1.0f;
+}
+
+Autopilot::Autopilot(const AutopilotConfig& config) : m_config(config)
+{
+    m_config.segment_count = std::min(std::max(m_config.segment_count, 1), (int)MAX_SEGMENTS);
+    m_config.segment_steps = std::max(m_config.segment_steps, 1);
+    if (m_config.thread_count <= 0) m_config.thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+
+    m_plan_count = 1u << (2 * m_config.segment_count);
+
+    for (int i = 0; i < m_config.thread_count; i++)
+    {
+        m_workers.emplace_back(new Worker());
+        setup_player(&m_workers.back()->scratch);
+    }
+    for (int i = 1; i < m_config.thread_count; i++) m_threads.emplace_back(&Autopilot::worker_loop, this, i);
+}
+
+Autopilot::~Autopilot()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void Autopilot::clone_nearby(const GameState& state)
+{
+    glm::vec2 centre = glm::vec2(state.player->get_position());
+    float     range  = m_config.plan_range;
+
+    // STEP 1: The platforms within range, through the broadphase when the level has one
+    int count = state.platform_count;
+    if (state.platform_broadphase != NULL)
+    {
+        state.platform_broadphase->query(centre - glm::vec2(range, 100.0f), centre + glm::vec2(range, 100.0f), m_candidates, m_cursor);
+        count = (int)m_candidates.size();
+    }
+
+    m_nearby.clear();
+    m_has_target = false;
+    float best_distance = 0.0f;
+
+    // STEP 2: Aim for the best pad in range when the level has them scored, where it is now...
+    bool scored = state.landing_sites != NULL && !state.landing_sites->is_empty();
+    int  site   = scored ? state.landing_sites->find_best(centre.x, range) : -1;
+    if (site >= 0)
+    {
+        const Entity& pad = state.platforms[state.landing_sites->get_site(site).platform];
+        m_target = glm::vec2(pad.get_position().x, pad.get_position().y + pad.get_height() / 2.0f);
+        m_has_target = true;
+    }
+
+    for (int n = 0; n < count; n++)
+    {
+        const Entity& platform = state.platforms[state.platform_broadphase != NULL ? m_candidates[n] : n];
+        glm::vec3 position = platform.get_position();
+        if (fabs(position.x - centre.x) > range) continue;
+
+        m_nearby.push_back(platform);
+
+        // STEP 3: ...or else for the WIN platform nearest along x
+        float distance = fabs(position.x - centre.x);
+        if (!scored && platform.is_active() && platform.get_entity_type() == WIN_PLATFORM && (!m_has_target || distance < best_distance))
+        {
+            best_distance = distance;
+            m_target = glm::vec2(position.x, position.y + platform.get_height() / 2.0f);
+            m_has_target = true;
+        }
+    }
+
+    // STEP 4: Packed once here, then only read by the rollouts
+    m_colliders.build(m_nearby.data(), (int)m_nearby.size());
+}
+
+float Autopilot::rollout(Worker& worker, uint32_t plan, bool& lands)
+{
+    Entity& lander = worker.scratch;
+    lander.restore_state(m_start);
+    lands = false;
+
+    int step = 0;
+
+    for (int segment = 0; segment < m_config.segment_count; segment++)
+    {
+        apply_autopilot_action(&lander, SEGMENT_ACTIONS[(plan >> (2 * segment)) & 3]);
+
+        for (int i = 0; i < m_config.segment_steps; i++, step++)
+        {
+            float touchdown_speed = fabs(lander.get_velocity().y);
+            worker.events.clear();
+            lander.update(m_timestep, m_nearby.data(), (int)m_nearby.size(), &worker.events, NULL, &m_colliders);
+
+            if (worker.events.has_event(EVENT_LANDED))
+            {
+                lands = true;
+                return LAND_SCORE - TOUCHDOWN_SPEED_WEIGHT * touchdown_speed - STEP_WEIGHT * step;
+            }
+            if (worker.events.has_event(EVENT_CRASHED)) return CRASH_SCORE + STEP_WEIGHT * step;
+        }
+    }
+
+    glm::vec2 velocity = glm::vec2(lander.get_velocity());
+    if (!m_has_target) return -SPEED_WEIGHT * glm::length(velocity);
+
+    glm::vec2 offset = glm::vec2(lander.get_position()) - m_target;
+    float below = std::max(-offset.y, 0.0f);
+
+    return -DISTANCE_WEIGHT * glm::length(offset) - BELOW_TARGET_WEIGHT * below - SPEED_WEIGHT * glm::length(velocity);
+}
+
+void Autopilot::work(Worker& worker, bool first)
+{
+    worker.best_score = -INFINITY;
+    worker.best_plan  = m_previous_plan;
+    worker.best_lands = false;
+    worker.rollouts   = 0;
+
+    // The caller's first chunk runs whatever the clock says, so every decision tries at least
+    // last decision's plan
+    while (first || std::chrono::steady_clock::now() < m_deadline)
+    {
+        first = false;
+
+        uint32_t begin = m_next_plan.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+        if (begin >= m_plan_count) break;
+
+        uint32_t end = std::min(begin + (uint32_t)CHUNK_SIZE, m_plan_count);
+        for (uint32_t k = begin; k < end; k++)
+        {
+            // Plan 0 is last decision's best; the rest come in a different order every decision
+            uint32_t plan = k == 0 ? m_previous_plan : (k * PLAN_STRIDE + m_plan_offset) & (m_plan_count - 1);
+
+            bool  lands;
+            float score = rollout(worker, plan, lands);
+            worker.rollouts++;
+
+            if (score > worker.best_score)
+            {
+                worker.best_score = score;
+                worker.best_plan  = plan;
+                worker.best_lands = lands;
+            }
+        }
+    }
+}
+
+int Autopilot::decide(const GameState& state)
+{
+    TRACE_ZONE("Autopilot::decide");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // STEP 1: Clone what the rollouts need, so the real state is left alone
+    state.player->save_state(m_start);
+    m_timestep = state.fixed_timestep;
+    clone_nearby(state);
+
+    m_deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(m_config.time_budget));
+    m_next_plan.store(0, std::memory_order_relaxed);
+
+    // STEP 2: Wake the workers, take a share ourselves, and wait for the rest to run out
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active_workers = (int)m_threads.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    work(*m_workers[0], true);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this]() { return m_active_workers == 0; });
+    }
+
+    // STEP 3: Best of the bests; ties go to the lower thread so results don't flicker
+    const Worker* best = m_workers[0].get();
+    m_stats.rollouts = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+    {
+        m_stats.rollouts += worker->rollouts;
+        if (worker->best_score > best->best_score) best = worker.get();
+    }
+
+    m_previous_plan = best->best_plan;
+    m_plan_offset  += PLAN_STRIDE;
+
+    m_stats.plan_count = (int)m_plan_count;
+    m_stats.best_score = best->best_score;
+    m_stats.lands      = best->best_lands;
+    m_stats.seconds    = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return SEGMENT_ACTIONS[m_previous_plan & 3];
+}
+
+void Autopilot::worker_loop(int worker)
+{
+    int seen_generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stopping || m_generation != seen_generation; });
+            if (m_stopping) return;
+            seen_generation = m_generation;
+        }
+
+        work(*m_workers[worker], false);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active_workers == 0) m_finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+// Model-predictive autopilot. Every decision clones the lander's body and the platforms around
+// it, plays thousands of candidate control sequences forward with the real physics, and returns
+// the first action of the best one. A plan is segment_count segments of segment_steps steps,
+// each holding one of the four keyboard actions, so there are 4^segment_count plans in all.
+//
+// The rollouts are shared out between worker threads and the caller, a few at a time, until
+// either every plan has been tried or the time budget runs out. Last decision's best plan is
+// always tried first, so a short budget still keeps a good plan rather than starting over.
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Simulation.h"
+
+// The same bits as LanderAction, so an autopilot can stand in for an env policy
+enum AutopilotAction
+{
+    AUTOPILOT_NONE  = 0,
+    AUTOPILOT_LEFT  = 1,
+    AUTOPILOT_RIGHT = 2,
+    AUTOPILOT_BOOST = 4
+};
+
+struct AutopilotConfig
+{
+    int   segment_count = 6,       // at most MAX_SEGMENTS
+          segment_steps = 10;      // 6 x 10 steps is a second of look-ahead
+    int   thread_count  = 0;       // counting the caller; 0 for one per hardware thread
+    float time_budget   = 0.002f;  // seconds per decision
+    float plan_range    = 6.0f;    // how far either side of the lander platforms are cloned
+};
+
+// The outcome of the last decision, for the profiler overlay and tuning
+struct AutopilotStats
+{
+    int    rollouts = 0,
+           plan_count = 0;  // rollouts out of this many plans
+    float  best_score = 0.0f;
+    bool   lands = false;   // the chosen plan touches down on a WIN platform
+    double seconds = 0.0;
+};
+
+// Moves the player the way the keys for `action` would
+void apply_autopilot_action(Entity* player, int action);
+
+class Autopilot
+{
+private:
+    static const int MAX_SEGMENTS = 12,  // 4^12 plans still fit the 32-bit plan codes
+                     CHUNK_SIZE   = 8;   // rollouts claimed at a time, between deadline checks
+
+    // One per thread; padded so the threads' bests don't share a cache line
+    struct alignas(64) Worker
+    {
+        Entity          scratch;  // the lander being rolled out; restored before every plan
+        GameEventBuffer events;   // what it reported; cleared every step
+        float    best_score;
+        uint32_t best_plan;
+        bool     best_lands;
+        int      rollouts;
+    };
+
+    AutopilotConfig m_config;
+    uint32_t        m_plan_count;
+    uint32_t        m_previous_plan = 0;
+    uint32_t        m_plan_offset   = 0;  // varies the order later plans are tried in
+
+    // ————— CURRENT DECISION ————— //
+    BodyState            m_start;
+    float                m_timestep = FIXED_TIMESTEP;
+    std::vector<Entity>  m_nearby;      // clones of the platforms within plan_range
+    PlatformColliders    m_colliders;   // packed from m_nearby; read by every thread at once
+    bool                 m_has_target = false;
+    glm::vec2            m_target;      // top centre of the WIN platform aimed for: the best-scored in range, else the nearest
+    std::vector<int>     m_candidates;  // broadphase scratch
+    int                  m_cursor = -1;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::atomic<uint32_t> m_next_plan{ 0 };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;  // [0] is the caller's
+    std::vector<std::thread>             m_threads;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake,
+                            m_finished;
+    int  m_generation     = 0,
+         m_active_workers = 0;
+    bool m_stopping       = false;
+
+    AutopilotStats m_stats;
+
+    void  clone_nearby(const GameState& state);
+    void  work(Worker& worker, bool first);
+    float rollout(Worker& worker, uint32_t plan, bool& lands);
+    void  worker_loop(int worker);
+
+public:
+    explicit Autopilot(const AutopilotConfig& config = AutopilotConfig());
+    ~Autopilot();
+
+    Autopilot(const Autopilot&) = delete;
+    Autopilot& operator=(const Autopilot&) = delete;
+
+    // Plans from the state as it is now and returns the AutopilotAction to hold this step.
+    // Blocks for up to about time_budget; the state is only read.
+    int decide(const GameState& state);
+
+    const AutopilotStats& get_stats() const { return m_stats; };
+};
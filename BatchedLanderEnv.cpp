@@ -0,0 +1,161 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "BatchedLanderEnv.h"
+#include "Simulation.h"
+
+// Where reset_episode puts the player
+const glm::vec3 SPAWN_POSITION = glm::vec3(0.0f, 3.0f, 0.0f);
+
+void BatchedLanderEnv::initialise(int env_count, const SceneConfig& scene, int max_steps)
+{
+    m_env_count = env_count;
+    m_scene = scene;
+    m_max_steps = std::max(max_steps, 0);
+
+    Entity prototype;
+    setup_player(&prototype);
+    m_sim.initialise(prototype, env_count);
+
+    m_platforms.assign(scene.platform_count, Entity());
+    m_win_platforms.reserve(scene.platform_count);
+
+    m_observations.assign(env_count * OBSERVATION_SIZE, 0.0f);
+    m_rewards.assign(m_sim.get_padded_count(), 0.0f);
+    m_step_rewards.assign(m_sim.get_padded_count(), 0.0f);
+    m_target_x.assign(m_sim.get_padded_count(), 0.0f);
+    m_target_y.assign(m_sim.get_padded_count(), 0.0f);
+    m_previous_distance.assign(m_sim.get_padded_count(), 0.0f);
+    m_dones.assign(env_count, LANDER_DONE_NONE);
+    m_actions.assign(env_count, LANDER_ACTION_NONE);
+    m_step_counts.assign(env_count, 0);
+
+    reset(0);
+}
+
+void BatchedLanderEnv::reset(unsigned int seed)
+{
+    generate_scene(m_platforms.data(), m_scene, seed);
+    m_sim.set_platforms(m_platforms.data(), (int)m_platforms.size());
+
+    m_win_platforms.clear();
+    for (const Entity& platform : m_platforms)
+    {
+        if (platform.get_entity_type() == WIN_PLATFORM) m_win_platforms.push_back(glm::vec2(platform.get_position()));
+    }
+    std::sort(m_win_platforms.begin(), m_win_platforms.end(), [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+
+    for (int env = 0; env < m_env_count; env++)
+    {
+        reset_env(env);
+        m_rewards[env] = 0.0f;
+        m_dones[env] = LANDER_DONE_NONE;
+    }
+}
+
+void BatchedLanderEnv::reset_env(int env)
+{
+    m_sim.reset(env, SPAWN_POSITION, ACC_OF_GRAVITY);
+    m_step_counts[env] = 0;
+    observe(env);
+
+    // Shaping starts counting from the spawn point
+    m_previous_distance[env] = glm::length(glm::vec2(m_target_x[env], m_target_y[env]) - glm::vec2(SPAWN_POSITION));
+}
+
+void BatchedLanderEnv::observe(int env)
+{
+    glm::vec3 position = m_sim.get_position(env),
+              velocity = m_sim.get_velocity(env);
+
+    // With nothing to aim for, the target follows the lander and distance shaping stays at zero
+    glm::vec2 win_offset = glm::vec2(0.0f);
+    if (!m_win_platforms.empty())
+    {
+        auto after = std::lower_bound(m_win_platforms.begin(), m_win_platforms.end(), position.x,
+                                      [](const glm::vec2& platform, float x) { return platform.x < x; });
+
+        glm::vec2 nearest;
+        if      (after == m_win_platforms.begin()) nearest = *after;
+        else if (after == m_win_platforms.end())   nearest = *(after - 1);
+        else    nearest = (position.x - (after - 1)->x <= after->x - position.x) ? *(after - 1) : *after;
+
+        win_offset = nearest - glm::vec2(position);
+    }
+    m_target_x[env] = position.x + win_offset.x;
+    m_target_y[env] = position.y + win_offset.y;
+
+    float* observation = &m_observations[env * OBSERVATION_SIZE];
+    observation[LANDER_OBS_POSITION_X]   = position.x;
+    observation[LANDER_OBS_POSITION_Y]   = position.y;
+    observation[LANDER_OBS_VELOCITY_X]   = velocity.x;
+    observation[LANDER_OBS_VELOCITY_Y]   = velocity.y;
+    observation[LANDER_OBS_WIN_OFFSET_X] = win_offset.x;
+    observation[LANDER_OBS_WIN_OFFSET_Y] = win_offset.y;
+}
+
+void BatchedLanderEnv::step_batch(const int* actions, int repeat)
+{
+    if (actions == NULL) actions = m_actions.data();
+    repeat = std::max(repeat, 1);
+
+    // STEP 1: Restart whatever finished last step, and apply every env's controls for all the sub-steps
+    for (int env = 0; env < m_env_count; env++)
+    {
+        if (m_dones[env] != LANDER_DONE_NONE) reset_env(env);
+        m_dones[env] = LANDER_DONE_NONE;
+        m_rewards[env] = 0.0f;
+
+        float movement_x = 0.0f;
+        if (actions[env] & LANDER_ACTION_LEFT)  movement_x -= 1.0f;
+        if (actions[env] & LANDER_ACTION_RIGHT) movement_x += 1.0f;
+        m_sim.set_controls(env, movement_x, (actions[env] & LANDER_ACTION_BOOST) != 0);
+    }
+
+    // Distance shaping needs every sub-step's target; without it, only the last observation is kept
+    bool observe_every_step = m_reward_config.distance_weight != 0.0f;
+    int flying = m_env_count;
+
+    for (int sub_step = 0; sub_step < repeat && flying > 0; sub_step++)
+    {
+        bool last = sub_step == repeat - 1;
+
+        // STEP 2: One step for all of them at once
+        m_sim.step(FIXED_TIMESTEP);
+
+        // STEP 3: Observations, which also pick each env's target for the distance shaping. Envs
+        //         done earlier in this call keep the observation they finished on.
+        for (int env = 0; env < m_env_count; env++)
+        {
+            if (m_dones[env] == LANDER_DONE_NONE && (last || observe_every_step || m_sim.is_done(env))) observe(env);
+        }
+
+        // STEP 4: Rewards for the whole batch in one pass, summed over the sub-steps, then done
+        //         codes the way LanderEnv hands them out
+        m_sim.compute_rewards(m_reward_config, m_target_x.data(), m_target_y.data(), m_previous_distance.data(), m_step_rewards.data());
+
+        for (int env = 0; env < m_env_count; env++)
+        {
+            if (m_dones[env] != LANDER_DONE_NONE) continue;
+
+            m_rewards[env] += m_step_rewards[env];
+            m_step_counts[env]++;
+
+            if (m_sim.is_done(env)) m_dones[env] = LANDER_DONE_TERMINAL;
+            else                    m_dones[env] = (m_max_steps > 0 && m_step_counts[env] >= m_max_steps) ? LANDER_DONE_TRUNCATED : LANDER_DONE_NONE;
+
+            if (m_dones[env] == LANDER_DONE_NONE) continue;
+            flying--;
+            if (!last && !observe_every_step && !m_sim.is_done(env)) observe(env);  // truncated between observations
+        }
+    }
+}
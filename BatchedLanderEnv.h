@@ -0,0 +1,73 @@
+#pragma once
+
+// Many copies of the LanderEnv episode stepped together on BatchedLanderSim, for vectorised
+// training. Observations, rewards and done codes live in flat buffers owned here that are
+// rewritten in place every step, so a caller (the Python module in particular) can wrap them
+// once and read them forever after without copying.
+//
+// Rewards are LanderEnv's sparse ones unless set_reward_config() adds shaping; either way they
+// come out of one pass over the whole batch after the step (BatchedLanderSim::compute_rewards).
+//
+// Every env flies over the same scene. An env that finished on the previous step is put back
+// at the spawn point at the start of the next one, so the step that reports done still shows
+// the final state.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "BatchedLanderSim.h"
+#include "LanderEnv.h"
+#include "SceneGenerator.h"
+
+class BatchedLanderEnv
+{
+public:
+    // LanderEnv's layout minus the contact flags, which the batched sim doesn't track
+    static const int OBSERVATION_SIZE = LANDER_OBS_WIN_OFFSET_Y + 1;
+
+private:
+    BatchedLanderSim m_sim;
+    SceneConfig      m_scene;
+    int              m_env_count = 0,
+                     m_max_steps = 0;
+
+    std::vector<Entity>    m_platforms;
+    std::vector<glm::vec2> m_win_platforms;  // centres, sorted by x
+
+    std::vector<float> m_observations;  // env_count rows of OBSERVATION_SIZE
+    std::vector<float> m_rewards;       // these and the target arrays are padded to the sim's lanes
+    std::vector<int>   m_dones;         // LanderDone codes
+    std::vector<int>   m_actions;       // LanderAction bits, for callers who fill them in place
+    std::vector<int>   m_step_counts;
+
+    // ————— REWARDS ————— //
+    RewardConfig       m_reward_config;
+    std::vector<float> m_target_x, m_target_y,  // the nearest WIN platform's centre, as observed
+                       m_previous_distance,
+                       m_step_rewards;         // one sub-step's, summed into m_rewards
+
+    void reset_env(int env);
+    void observe(int env);
+
+public:
+    // max_steps 0 means episodes never truncate
+    void initialise(int env_count, const SceneConfig& scene, int max_steps);
+
+    // Takes effect from the next step
+    void set_reward_config(const RewardConfig& config) { m_reward_config = config; };
+    // Envs that leave the box end as crashed, with config.out_of_bounds_reward
+    void set_bounds(glm::vec2 min, glm::vec2 max) { m_sim.set_bounds(min, max); };
+
+    // A new scene for `seed`, with every env back at the spawn point
+    void reset(unsigned int seed);
+
+    // `repeat` fixed steps of every env under actions[env] (or get_actions() when actions is NULL),
+    // with rewards summed over them. An env that finishes part way through stops there and keeps
+    // that observation; the others are only observed after the last sub-step.
+    void step_batch(const int* actions = NULL, int repeat = 1);
+
+    // ————— GETTERS ————— //
+    int    const get_env_count()    const { return m_env_count; };
+    float*       get_observations()       { return m_observations.data(); };
+    float*       get_rewards()            { return m_rewards.data(); };
+    int*         get_dones()              { return m_dones.data(); };
+    int*         get_actions()            { return m_actions.data(); };
+};
@@ -0,0 +1,484 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cmath>
+#include "BatchedLanderSim.h"
+#include "CollisionResponse.h"
+#include "SimdDispatch.h"
+#include "StateHash.h"
+
+#ifdef LANDER_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+void BatchedLanderSim::initialise(const Entity& prototype, int lander_count)
+{
+    m_lander_count = lander_count;
+    m_padded_count = (lander_count + LANE_WIDTH - 1) / LANE_WIDTH * LANE_WIDTH;
+
+    std::vector<float>* float_fields[] = { &m_position_x, &m_position_y, &m_velocity_x, &m_velocity_y,
+                                           &m_acceleration_x, &m_acceleration_y, &m_movement_x };
+    for (std::vector<float>* field : float_fields) field->assign(m_padded_count, 0.0f);
+
+    std::vector<int>* int_fields[] = { &m_booster_active, &m_win, &m_loss, &m_active,
+                                       &m_stepped, &m_touched_win, &m_touched_death, &m_out_of_bounds };
+    for (std::vector<int>* field : int_fields) field->assign(m_padded_count, 0);
+    m_touchdown_speed.assign(m_padded_count, 0.0f);
+
+    for (int i = 0; i < m_lander_count; i++) m_active[i] = 1;
+
+    m_speed          = prototype.get_speed();
+    m_drag           = (float)prototype.m_drag;
+    m_boosting_power = (float)prototype.m_boosting_power;
+    m_width          = prototype.get_width();
+    m_height         = prototype.get_height();
+}
+
+void BatchedLanderSim::set_platforms(const Entity* platforms, int platform_count)
+{
+    m_platform_x.clear();
+    m_platform_y.clear();
+    m_platform_width.clear();
+    m_platform_height.clear();
+    m_platform_win.clear();
+    m_platform_death.clear();
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        if (!platforms[i].is_active()) continue;
+
+        m_platform_x.push_back(platforms[i].get_position().x);
+        m_platform_y.push_back(platforms[i].get_position().y);
+        m_platform_width.push_back(platforms[i].get_width());
+        m_platform_height.push_back(platforms[i].get_height());
+        m_platform_win.push_back(platforms[i].get_entity_type() == WIN_PLATFORM ? 1 : 0);
+        m_platform_death.push_back(platforms[i].get_entity_type() == DEATH_PLATFORM ? 1 : 0);
+    }
+}
+
+void BatchedLanderSim::reset(int lander, glm::vec3 position, float gravity)
+{
+    m_position_x[lander]     = position.x;
+    m_position_y[lander]     = position.y;
+    m_velocity_x[lander]     = 0.0f;
+    m_velocity_y[lander]     = 0.0f;
+    m_acceleration_x[lander] = 0.0f;
+    m_acceleration_y[lander] = gravity;
+    m_movement_x[lander]     = 0.0f;
+    m_booster_active[lander] = 0;
+    m_win[lander]            = 0;
+    m_loss[lander]           = 0;
+    m_out_of_bounds[lander]  = 0;
+}
+
+void BatchedLanderSim::reset_all(glm::vec3 position, float gravity)
+{
+    for (int i = 0; i < m_lander_count; i++) reset(i, position, gravity);
+}
+
+void BatchedLanderSim::set_controls(int lander, float movement_x, bool booster_active)
+{
+    m_movement_x[lander] = movement_x;
+    m_booster_active[lander] = booster_active ? 1 : 0;
+}
+
+void BatchedLanderSim::set_bounds(glm::vec2 min, glm::vec2 max)
+{
+    m_use_bounds = true;
+    m_bounds_min = min;
+    m_bounds_max = max;
+}
+
+int const BatchedLanderSim::get_done_count() const
+{
+    int count = 0;
+    for (int i = 0; i < m_lander_count; i++) count += is_done(i) ? 1 : 0;
+    return count;
+}
+
+uint64_t const BatchedLanderSim::hash_state(uint64_t previous) const
+{
+    // Padding lanes left out, so the hash doesn't depend on LANE_WIDTH
+    uint64_t hash = previous;
+    hash = StateHash::hash_xxh64(m_position_x.data(), m_lander_count * sizeof(float), hash);
+    hash = StateHash::hash_xxh64(m_position_y.data(), m_lander_count * sizeof(float), hash);
+    hash = StateHash::hash_xxh64(m_velocity_x.data(), m_lander_count * sizeof(float), hash);
+    hash = StateHash::hash_xxh64(m_velocity_y.data(), m_lander_count * sizeof(float), hash);
+    hash = StateHash::hash_xxh64(m_win.data(), m_lander_count * sizeof(int), hash);
+    return StateHash::hash_xxh64(m_loss.data(), m_lander_count * sizeof(int), hash);
+}
+
+// SSE2 for every wider set too: the lanes are four landers, and there's no more to be had per step
+static bool use_sse2()
+{
+#ifdef LANDER_SIMD_SSE2
+    static const bool sse2 = get_simd_isa() != SIMD_SCALAR;
+    return sse2;
+#else
+    return false;
+#endif
+}
+
+void BatchedLanderSim::step(float delta_time)
+{
+#ifdef LANDER_SIMD_SSE2
+    if (use_sse2())
+    {
+        step_lanes_sse2(0, m_padded_count, delta_time);
+        evaluate_lanes_sse2(0, m_padded_count);
+        return;
+    }
+#endif
+    step_lanes_scalar(0, m_padded_count, delta_time);
+    evaluate_lanes_scalar(0, m_padded_count);
+}
+
+void BatchedLanderSim::step_scalar(float delta_time)
+{
+    step_lanes_scalar(0, m_padded_count, delta_time);
+    evaluate_lanes_scalar(0, m_padded_count);
+}
+
+void BatchedLanderSim::compute_rewards(const RewardConfig& config, const float* target_x, const float* target_y, float* previous_distance, float* rewards) const
+{
+#ifdef LANDER_SIMD_SSE2
+    if (use_sse2())
+    {
+        reward_lanes_sse2(0, m_padded_count, config, target_x, target_y, previous_distance, rewards);
+        return;
+    }
+#endif
+    reward_lanes_scalar(0, m_padded_count, config, target_x, target_y, previous_distance, rewards);
+}
+
+// ————— SCALAR ————— //
+// Written out line for line like Entity::update and check_collision_x/y, which is what keeps
+// the two paths bit-identical
+void BatchedLanderSim::step_lanes_scalar(int first, int last, float delta_time)
+{
+    const int platform_count = (int)m_platform_x.size();
+
+    for (int i = first; i < last; i++)
+    {
+        m_touched_win[i] = 0;
+        m_touched_death[i] = 0;
+        m_touchdown_speed[i] = 0.0f;
+
+        m_stepped[i] = m_active[i] && !m_win[i] && !m_loss[i];
+        if (!m_stepped[i]) continue;
+
+        float position_x = m_position_x[i],
+              position_y = m_position_y[i],
+              velocity_x = m_velocity_x[i],
+              velocity_y = m_velocity_y[i];
+
+        // ––––– PHYSICS ––––– //
+        float acceleration_x = m_movement_x[i] * m_speed;
+        if (velocity_x > 0)      acceleration_x -= m_drag;
+        else if (velocity_x < 0) acceleration_x += m_drag;
+
+        velocity_x += acceleration_x * delta_time;
+        velocity_y += m_acceleration_y[i] * delta_time;
+
+        position_y += velocity_y * delta_time;
+        for (int p = 0; p < platform_count; p++)
+        {
+            float x_distance = fabs(position_x - m_platform_x[p]) - ((m_width + m_platform_width[p]) / 2.0f);
+            float y_distance = fabs(position_y - m_platform_y[p]) - ((m_height + m_platform_height[p]) / 2.0f);
+            if (!(x_distance < 0.0f && y_distance < 0.0f)) continue;
+
+            float y_overlap = fabs(fabs(position_y - m_platform_y[p]) - (m_height / 2.0f) - (m_platform_height[p] / 2.0f));
+            float speed = -velocity_y;
+            AxisResponse response = resolve_axis(position_y, velocity_y, y_overlap);
+
+            int landed = response.negative ? 1 : 0;
+            m_touchdown_speed[i] = landed ? speed : m_touchdown_speed[i];
+            m_touched_win[i]   |= landed & m_platform_win[p];
+            m_touched_death[i] |= landed & m_platform_death[p];
+        }
+
+        position_x += velocity_x * delta_time;
+        for (int p = 0; p < platform_count; p++)
+        {
+            float x_distance = fabs(position_x - m_platform_x[p]) - ((m_width + m_platform_width[p]) / 2.0f);
+            float y_distance = fabs(position_y - m_platform_y[p]) - ((m_height + m_platform_height[p]) / 2.0f);
+            if (!(x_distance < 0.0f && y_distance < 0.0f)) continue;
+
+            float x_overlap = fabs(fabs(position_x - m_platform_x[p]) - (m_width / 2.0f) - (m_platform_width[p] / 2.0f));
+            resolve_axis(position_x, velocity_x, x_overlap);
+        }
+
+        // ––––– BOOSTING ––––– //
+        if (m_booster_active[i]) velocity_y += m_boosting_power;
+
+        m_position_x[i]     = position_x;
+        m_position_y[i]     = position_y;
+        m_velocity_x[i]     = velocity_x;
+        m_velocity_y[i]     = velocity_y;
+        m_acceleration_x[i] = acceleration_x;
+    }
+}
+
+// Outcomes from what the step touched, apart from the collision passes, so they can be read
+// (and changed) without going near the physics
+void BatchedLanderSim::evaluate_lanes_scalar(int first, int last)
+{
+    for (int i = first; i < last; i++)
+    {
+        if (!m_stepped[i]) continue;
+
+        bool outside = m_use_bounds && (m_position_x[i] < m_bounds_min.x || m_position_x[i] > m_bounds_max.x ||
+                                        m_position_y[i] < m_bounds_min.y || m_position_y[i] > m_bounds_max.y);
+
+        m_win[i]           |= m_touched_win[i];
+        m_loss[i]          |= m_touched_death[i] | (outside ? 1 : 0);
+        m_out_of_bounds[i]  = outside ? 1 : 0;
+    }
+}
+
+void BatchedLanderSim::reward_lanes_scalar(int first, int last, const RewardConfig& config, const float* target_x, const float* target_y,
+                                           float* previous_distance, float* rewards) const
+{
+    for (int i = first; i < last; i++)
+    {
+        if (!m_stepped[i])
+        {
+            rewards[i] = 0.0f;
+            continue;
+        }
+
+        float dx = target_x[i] - m_position_x[i],
+              dy = target_y[i] - m_position_y[i],
+              distance = sqrtf(dx * dx + dy * dy);
+
+        // A touchdown on both kinds at once counts as the landing, as it always has
+        float reward = 0.0f;
+        if      (m_touched_win[i])   reward = config.win_reward;
+        else if (m_out_of_bounds[i]) reward = config.out_of_bounds_reward;
+        else if (m_touched_death[i]) reward = config.loss_reward;
+
+        reward -= config.touchdown_speed_weight * m_touchdown_speed[i];
+        if (m_booster_active[i]) reward -= config.fuel_weight;
+        reward += config.distance_weight * (previous_distance[i] - distance);
+
+        rewards[i] = reward;
+        previous_distance[i] = distance;
+    }
+}
+
+// ————— SSE2 ————— //
+// Four landers per register. Every branch of the scalar path becomes a mask and a select, so
+// each lane still sees exactly the scalar sequence of float operations.
+#ifdef LANDER_SIMD_SSE2
+static inline __m128 select(__m128 mask, __m128 if_true, __m128 if_false)
+{
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+static inline __m128 absolute(__m128 value)
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), value);
+}
+
+// All ones in the lanes where the flag is set
+static inline __m128 flag_mask(const int* flags)
+{
+    __m128i clear = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)flags), _mm_setzero_si128());
+    return _mm_castsi128_ps(_mm_xor_si128(clear, _mm_set1_epi32(-1)));
+}
+
+void BatchedLanderSim::step_lanes_sse2(int first, int last, float delta_time)
+{
+    const int platform_count = (int)m_platform_x.size();
+
+    const __m128  zero       = _mm_setzero_ps();
+    const __m128i zero_i     = _mm_setzero_si128(),
+                  one_i      = _mm_set1_epi32(1);
+    const __m128  dt         = _mm_set1_ps(delta_time),
+                  speed      = _mm_set1_ps(m_speed),
+                  drag       = _mm_set1_ps(m_drag),
+                  boost      = _mm_set1_ps(m_boosting_power),
+                  half_width = _mm_set1_ps(m_width / 2.0f),
+                  half_height = _mm_set1_ps(m_height / 2.0f);
+
+    for (int i = first; i < last; i += LANE_WIDTH)
+    {
+        __m128i active_i  = _mm_loadu_si128((const __m128i*)&m_active[i]),
+                win_i     = _mm_loadu_si128((const __m128i*)&m_win[i]),
+                loss_i    = _mm_loadu_si128((const __m128i*)&m_loss[i]),
+                booster_i = _mm_loadu_si128((const __m128i*)&m_booster_active[i]);
+
+        __m128i running_i = _mm_andnot_si128(_mm_cmpeq_epi32(active_i, zero_i),
+                                             _mm_and_si128(_mm_cmpeq_epi32(win_i, zero_i), _mm_cmpeq_epi32(loss_i, zero_i)));
+        __m128 running = _mm_castsi128_ps(running_i);
+
+        __m128i touched_win_i   = zero_i,
+                touched_death_i = zero_i;
+        __m128  touchdown_speed = zero;
+
+        _mm_storeu_si128((__m128i*)&m_stepped[i], _mm_and_si128(running_i, one_i));
+        if (_mm_movemask_ps(running) == 0)
+        {
+            _mm_storeu_si128((__m128i*)&m_touched_win[i], zero_i);
+            _mm_storeu_si128((__m128i*)&m_touched_death[i], zero_i);
+            _mm_storeu_ps(&m_touchdown_speed[i], zero);
+            continue;
+        }
+
+        __m128 old_position_x = _mm_loadu_ps(&m_position_x[i]),
+               old_position_y = _mm_loadu_ps(&m_position_y[i]),
+               old_velocity_x = _mm_loadu_ps(&m_velocity_x[i]),
+               old_velocity_y = _mm_loadu_ps(&m_velocity_y[i]),
+               old_acceleration_x = _mm_loadu_ps(&m_acceleration_x[i]);
+
+        // ––––– PHYSICS ––––– //
+        __m128 acceleration_x = _mm_mul_ps(_mm_loadu_ps(&m_movement_x[i]), speed);
+        acceleration_x = select(_mm_cmpgt_ps(old_velocity_x, zero), _mm_sub_ps(acceleration_x, drag),
+                         select(_mm_cmplt_ps(old_velocity_x, zero), _mm_add_ps(acceleration_x, drag), acceleration_x));
+
+        __m128 velocity_x = _mm_add_ps(old_velocity_x, _mm_mul_ps(acceleration_x, dt)),
+               velocity_y = _mm_add_ps(old_velocity_y, _mm_mul_ps(_mm_loadu_ps(&m_acceleration_y[i]), dt));
+
+        __m128 position_x = old_position_x,
+               position_y = _mm_add_ps(old_position_y, _mm_mul_ps(velocity_y, dt));
+
+        for (int p = 0; p < platform_count; p++)
+        {
+            __m128 platform_x = _mm_set1_ps(m_platform_x[p]),
+                   platform_y = _mm_set1_ps(m_platform_y[p]);
+
+            __m128 x_distance = _mm_sub_ps(absolute(_mm_sub_ps(position_x, platform_x)), _mm_set1_ps((m_width + m_platform_width[p]) / 2.0f)),
+                   y_distance = _mm_sub_ps(absolute(_mm_sub_ps(position_y, platform_y)), _mm_set1_ps((m_height + m_platform_height[p]) / 2.0f));
+            __m128 hit = _mm_and_ps(running, _mm_and_ps(_mm_cmplt_ps(x_distance, zero), _mm_cmplt_ps(y_distance, zero)));
+            if (_mm_movemask_ps(hit) == 0) continue;
+
+            __m128 y_overlap = absolute(_mm_sub_ps(_mm_sub_ps(absolute(_mm_sub_ps(position_y, platform_y)), half_height),
+                                                   _mm_set1_ps(m_platform_height[p] / 2.0f)));
+
+            __m128 up, down, speed_y = _mm_sub_ps(zero, velocity_y);
+            resolve_axis_sse2(position_y, velocity_y, y_overlap, hit, up, down);
+            touchdown_speed = select(down, speed_y, touchdown_speed);
+
+            __m128i landed_i = _mm_and_si128(_mm_castps_si128(down), one_i);
+            touched_win_i   = _mm_or_si128(touched_win_i,   _mm_and_si128(landed_i, _mm_set1_epi32(m_platform_win[p])));
+            touched_death_i = _mm_or_si128(touched_death_i, _mm_and_si128(landed_i, _mm_set1_epi32(m_platform_death[p])));
+        }
+
+        position_x = _mm_add_ps(position_x, _mm_mul_ps(velocity_x, dt));
+
+        for (int p = 0; p < platform_count; p++)
+        {
+            __m128 platform_x = _mm_set1_ps(m_platform_x[p]),
+                   platform_y = _mm_set1_ps(m_platform_y[p]);
+
+            __m128 x_distance = _mm_sub_ps(absolute(_mm_sub_ps(position_x, platform_x)), _mm_set1_ps((m_width + m_platform_width[p]) / 2.0f)),
+                   y_distance = _mm_sub_ps(absolute(_mm_sub_ps(position_y, platform_y)), _mm_set1_ps((m_height + m_platform_height[p]) / 2.0f));
+            __m128 hit = _mm_and_ps(running, _mm_and_ps(_mm_cmplt_ps(x_distance, zero), _mm_cmplt_ps(y_distance, zero)));
+            if (_mm_movemask_ps(hit) == 0) continue;
+
+            __m128 x_overlap = absolute(_mm_sub_ps(_mm_sub_ps(absolute(_mm_sub_ps(position_x, platform_x)), half_width),
+                                                   _mm_set1_ps(m_platform_width[p] / 2.0f)));
+
+            __m128 right, left;
+            resolve_axis_sse2(position_x, velocity_x, x_overlap, hit, right, left);
+        }
+
+        // ––––– BOOSTING ––––– //
+        __m128 boosting = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmpeq_epi32(booster_i, zero_i), running_i));
+        velocity_y = select(boosting, _mm_add_ps(velocity_y, boost), velocity_y);
+
+        // Lanes that weren't running keep their old state untouched
+        _mm_storeu_ps(&m_position_x[i],     select(running, position_x, old_position_x));
+        _mm_storeu_ps(&m_position_y[i],     select(running, position_y, old_position_y));
+        _mm_storeu_ps(&m_velocity_x[i],     select(running, velocity_x, old_velocity_x));
+        _mm_storeu_ps(&m_velocity_y[i],     select(running, velocity_y, old_velocity_y));
+        _mm_storeu_ps(&m_acceleration_x[i], select(running, acceleration_x, old_acceleration_x));
+        _mm_storeu_si128((__m128i*)&m_touched_win[i],   touched_win_i);
+        _mm_storeu_si128((__m128i*)&m_touched_death[i], touched_death_i);
+        _mm_storeu_ps(&m_touchdown_speed[i], touchdown_speed);
+    }
+}
+
+void BatchedLanderSim::evaluate_lanes_sse2(int first, int last)
+{
+    const __m128i zero_i = _mm_setzero_si128(),
+                  one_i  = _mm_set1_epi32(1);
+    const __m128  min_x  = _mm_set1_ps(m_bounds_min.x), max_x = _mm_set1_ps(m_bounds_max.x),
+                  min_y  = _mm_set1_ps(m_bounds_min.y), max_y = _mm_set1_ps(m_bounds_max.y);
+
+    for (int i = first; i < last; i += LANE_WIDTH)
+    {
+        __m128i stepped_i = _mm_loadu_si128((const __m128i*)&m_stepped[i]);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(stepped_i, zero_i)) == 0xffff) continue;
+
+        __m128i outside_i = zero_i;
+        if (m_use_bounds)
+        {
+            __m128 position_x = _mm_loadu_ps(&m_position_x[i]),
+                   position_y = _mm_loadu_ps(&m_position_y[i]);
+            __m128 outside = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(position_x, min_x), _mm_cmpgt_ps(position_x, max_x)),
+                                       _mm_or_ps(_mm_cmplt_ps(position_y, min_y), _mm_cmpgt_ps(position_y, max_y)));
+            outside_i = _mm_and_si128(_mm_and_si128(_mm_castps_si128(outside), one_i), stepped_i);
+        }
+
+        // touched_* are only ever set on lanes that stepped, so they need no mask of their own
+        __m128i win_i  = _mm_or_si128(_mm_loadu_si128((const __m128i*)&m_win[i]), _mm_loadu_si128((const __m128i*)&m_touched_win[i])),
+                loss_i = _mm_or_si128(_mm_loadu_si128((const __m128i*)&m_loss[i]),
+                                      _mm_or_si128(_mm_loadu_si128((const __m128i*)&m_touched_death[i]), outside_i));
+        __m128i old_outside_i = _mm_loadu_si128((const __m128i*)&m_out_of_bounds[i]);
+
+        _mm_storeu_si128((__m128i*)&m_win[i],  win_i);
+        _mm_storeu_si128((__m128i*)&m_loss[i], loss_i);
+        _mm_storeu_si128((__m128i*)&m_out_of_bounds[i], _mm_or_si128(_mm_andnot_si128(stepped_i, old_outside_i), outside_i));
+    }
+}
+
+void BatchedLanderSim::reward_lanes_sse2(int first, int last, const RewardConfig& config, const float* target_x, const float* target_y,
+                                         float* previous_distance, float* rewards) const
+{
+    const __m128  zero             = _mm_setzero_ps(),
+                  win_reward       = _mm_set1_ps(config.win_reward),
+                  loss_reward      = _mm_set1_ps(config.loss_reward),
+                  outside_reward   = _mm_set1_ps(config.out_of_bounds_reward),
+                  touchdown_weight = _mm_set1_ps(config.touchdown_speed_weight),
+                  fuel_weight      = _mm_set1_ps(config.fuel_weight),
+                  distance_weight  = _mm_set1_ps(config.distance_weight);
+
+    for (int i = first; i < last; i += LANE_WIDTH)
+    {
+        __m128 stepped = flag_mask(&m_stepped[i]);
+        if (_mm_movemask_ps(stepped) == 0)
+        {
+            _mm_storeu_ps(&rewards[i], zero);
+            continue;
+        }
+
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&target_x[i]), _mm_loadu_ps(&m_position_x[i])),
+               dy = _mm_sub_ps(_mm_loadu_ps(&target_y[i]), _mm_loadu_ps(&m_position_y[i]));
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+
+        // The same precedence as the scalar pass: a landing, then leaving the bounds, then a crash
+        __m128 won     = flag_mask(&m_touched_win[i]),
+               outside = flag_mask(&m_out_of_bounds[i]),
+               crashed = flag_mask(&m_touched_death[i]),
+               boosted = flag_mask(&m_booster_active[i]);
+
+        __m128 reward = select(won, win_reward, select(outside, outside_reward, select(crashed, loss_reward, zero)));
+        reward = _mm_sub_ps(reward, _mm_mul_ps(touchdown_weight, _mm_loadu_ps(&m_touchdown_speed[i])));
+        reward = select(boosted, _mm_sub_ps(reward, fuel_weight), reward);
+
+        __m128 old_distance = _mm_loadu_ps(&previous_distance[i]);
+        reward = _mm_add_ps(reward, _mm_mul_ps(distance_weight, _mm_sub_ps(old_distance, distance)));
+
+        _mm_storeu_ps(&rewards[i], select(stepped, reward, zero));
+        _mm_storeu_ps(&previous_distance[i], select(stepped, distance, old_distance));
+    }
+}
+#endif
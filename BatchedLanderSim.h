@@ -0,0 +1,131 @@
+#pragma once
+
+// Steps many landers at once against one shared platform set. Every lander field lives in its
+// own float array (structure of arrays) so that a single SIMD register holds the same field
+// for several landers. Always float, so in LANDER_FIXED_POINT builds it no longer tracks
+// Entity::update bit for bit.
+#include <cstdint>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+
+// Shaped rewards for compute_rewards(). The defaults are LanderEnv's sparse rewards; the weights
+// are all off until set.
+struct RewardConfig
+{
+    float win_reward           = 1.0f,
+          loss_reward          = -1.0f,
+          out_of_bounds_reward = -1.0f;
+    float touchdown_speed_weight = 0.0f,  // taken off per unit of downward speed on touching down
+          fuel_weight            = 0.0f,  // taken off every step the booster is on
+          distance_weight        = 0.0f;  // per unit closer to the target than last step
+};
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LANDER_SIMD_SSE2 1
+#endif
+
+class BatchedLanderSim
+{
+private:
+#ifdef LANDER_SIMD_SSE2
+    static const int LANE_WIDTH = 4;
+#else
+    static const int LANE_WIDTH = 1;
+#endif
+
+    int m_lander_count = 0,
+        m_padded_count = 0;  // rounded up to LANE_WIDTH; the padding lanes never run
+
+    // ————— LANDERS ————— //
+    std::vector<float> m_position_x, m_position_y,
+                       m_velocity_x, m_velocity_y,
+                       m_acceleration_x, m_acceleration_y,
+                       m_movement_x;
+    std::vector<int>   m_booster_active,
+                       m_win, m_loss,
+                       m_active;
+
+    // What the last step's collision passes touched; evaluate_lanes turns these into outcomes
+    std::vector<int>   m_stepped,        // the lander was still flying when the step began
+                       m_touched_win,    // came down onto a WIN_PLATFORM
+                       m_touched_death,  // ...or onto a DEATH_PLATFORM
+                       m_out_of_bounds;
+    std::vector<float> m_touchdown_speed;  // downward speed just before touching down, else 0
+
+    // Off until set_bounds()
+    bool      m_use_bounds = false;
+    glm::vec2 m_bounds_min = glm::vec2(0.0f),
+              m_bounds_max = glm::vec2(0.0f);
+
+    // Shared by every lander, copied from the prototype Entity
+    float m_speed = 0.0f,
+          m_drag = 0.0f,
+          m_boosting_power = 0.0f,
+          m_width = 1.0f,
+          m_height = 1.0f;
+
+    // ————— PLATFORMS ————— //
+    std::vector<float> m_platform_x, m_platform_y,
+                       m_platform_width, m_platform_height;
+    std::vector<int>   m_platform_win, m_platform_death;  // 1 where landing on it wins (loses), else 0
+
+    void step_lanes_scalar(int first, int last, float delta_time);
+    void evaluate_lanes_scalar(int first, int last);
+    void reward_lanes_scalar(int first, int last, const RewardConfig& config, const float* target_x, const float* target_y,
+                             float* previous_distance, float* rewards) const;
+#ifdef LANDER_SIMD_SSE2
+    void step_lanes_sse2(int first, int last, float delta_time);
+    void evaluate_lanes_sse2(int first, int last);
+    void reward_lanes_sse2(int first, int last, const RewardConfig& config, const float* target_x, const float* target_y,
+                           float* previous_distance, float* rewards) const;
+#endif
+
+public:
+    // Physical constants (speed, drag, boosting power, size) come from the prototype
+    void initialise(const Entity& prototype, int lander_count);
+
+    // Inactive platforms are dropped here, since Entity::check_collision would ignore them anyway
+    void set_platforms(const Entity* platforms, int platform_count);
+
+    // Same starting state as reset_episode(): at rest, gravity on, outcome cleared
+    void reset(int lander, glm::vec3 position, float gravity);
+    void reset_all(glm::vec3 position, float gravity);
+
+    // The equivalent of Entity::set_movement / m_booster_active for one lander
+    void set_controls(int lander, float movement_x, bool booster_active);
+
+    // Landers whose centre leaves the box are lost, as if they had crashed
+    void set_bounds(glm::vec2 min, glm::vec2 max);
+
+    // One Entity::update worth of integration and collision for every lander still flying, then
+    // a separate pass over the whole batch that decides win, loss and out of bounds from what
+    // the collisions touched. step_scalar() is the reference path and matches Entity::update bit
+    // for bit; step() uses SSE2 unless get_simd_isa() is scalar, and performs the same IEEE
+    // operations in the same order.
+    void step(float delta_time);
+    void step_scalar(float delta_time);
+
+    // Another pass over the batch, after a step: every lander that flew in it gets its terminal
+    // reward plus the shaping terms in `config`. The arrays hold get_padded_count() entries;
+    // target_* is where each lander is headed and previous_distance its distance from there
+    // after the step before, which this updates. Landers that didn't fly get 0.
+    void compute_rewards(const RewardConfig& config, const float* target_x, const float* target_y, float* previous_distance, float* rewards) const;
+
+    // ————— GETTERS ————— //
+    int       const get_lander_count() const { return m_lander_count; };
+    int       const get_padded_count() const { return m_padded_count; };
+    glm::vec3 const get_position(int lander) const { return glm::vec3(m_position_x[lander], m_position_y[lander], 0.0f); };
+    glm::vec3 const get_velocity(int lander) const { return glm::vec3(m_velocity_x[lander], m_velocity_y[lander], 0.0f); };
+    bool      const has_won(int lander)   const { return m_win[lander] != 0; };
+    bool      const has_lost(int lander)  const { return m_loss[lander] != 0; };
+    bool      const is_done(int lander)   const { return m_win[lander] != 0 || m_loss[lander] != 0; };
+    bool      const is_out_of_bounds(int lander) const { return m_out_of_bounds[lander] != 0; };
+    float     const get_touchdown_speed(int lander) const { return m_touchdown_speed[lander]; };
+    int       const get_done_count() const;
+
+    // xxHash64 (StateHash.h) straight over the position, velocity and outcome arrays, chained onto
+    // `previous`: chain it after every step to find the first one two batches (or step() and
+    // step_scalar()) disagree on. A sixth or so of what step() takes.
+    uint64_t  const hash_state(uint64_t previous = 0) const;
+};
@@ -0,0 +1,91 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cstring>
+#include "BitStream.h"
+
+// write_signed's size classes after the leading 1: a prefix of 0, 10, 110 or 111, then the
+// zigzagged value in that many bits
+static const int SIGNED_PREFIX_BITS[] = { 1, 2, 3, 3 },
+                 SIGNED_VALUE_BITS[]  = { 4, 8, 14, 32 };
+
+// 0, -1, 1, -2, 2... to 0, 1, 2, 3, 4..., so small values of either sign have few bits set
+static uint32_t zigzag(int32_t value)   { return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31); }
+static int32_t  unzigzag(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+// ————— WRITER ————— //
+BitWriter::BitWriter(uint8_t* buffer, size_t capacity) : m_buffer(buffer), m_capacity(capacity)
+{
+    std::memset(m_buffer, 0, m_capacity);
+}
+
+void BitWriter::write_bits(uint32_t value, int bits)
+{
+    if (m_overflowed) return;
+    if (m_bit_count + bits > m_capacity * 8)
+    {
+        m_overflowed = true;
+        return;
+    }
+
+    // The buffer starts zeroed, so each bit only needs setting
+    for (int i = 0; i < bits; i++, m_bit_count++)
+    {
+        if ((value >> i) & 1) m_buffer[m_bit_count >> 3] |= (uint8_t)(1u << (m_bit_count & 7));
+    }
+}
+
+void BitWriter::write_signed(int32_t value)
+{
+    if (value == 0)
+    {
+        write_bits(0, 1);
+        return;
+    }
+    write_bits(1, 1);
+
+    uint32_t zigzagged = zigzag(value) - 1;  // 0 is taken care of above
+    int size_class = 0;
+    while (size_class < 3 && (zigzagged >> SIGNED_VALUE_BITS[size_class]) != 0) size_class++;
+
+    // Prefixes 0, 01, 011, 111 written low bit first, read back as 0, 10, 110, 111
+    const uint32_t prefixes[] = { 0u, 1u, 3u, 7u };
+    write_bits(prefixes[size_class], SIGNED_PREFIX_BITS[size_class]);
+    write_bits(zigzagged, SIGNED_VALUE_BITS[size_class]);
+}
+
+// ————— READER ————— //
+BitReader::BitReader(const uint8_t* buffer, size_t size) : m_buffer(buffer), m_bit_capacity(size * 8) {}
+
+uint32_t BitReader::read_bits(int bits)
+{
+    if (m_overflowed || m_bit_count + bits > m_bit_capacity)
+    {
+        m_overflowed = true;
+        return 0;
+    }
+
+    uint32_t value = 0;
+    for (int i = 0; i < bits; i++, m_bit_count++)
+    {
+        value |= (uint32_t)((m_buffer[m_bit_count >> 3] >> (m_bit_count & 7)) & 1) << i;
+    }
+    return value;
+}
+
+int32_t BitReader::read_signed()
+{
+    if (!read_bool()) return 0;
+
+    int size_class = 0;
+    while (size_class < 3 && read_bool()) size_class++;
+
+    return unzigzag(read_bits(SIGNED_VALUE_BITS[size_class]) + 1);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Bit-level packing for network packets: fields take exactly as many bits as they need rather
+// than whole bytes. Bits fill each byte from the least significant end, so a packet reads the
+// same on every machine whatever its byte order.
+//
+// Neither side allocates or throws. Writing past the end of the buffer, or reading past the end
+// of the packet, sets a flag and does nothing else; check it once at the end.
+#include <cstddef>
+#include <cstdint>
+
+class BitWriter
+{
+private:
+    uint8_t* m_buffer;
+    size_t   m_capacity;      // in bytes
+    size_t   m_bit_count = 0;
+    bool     m_overflowed = false;
+
+public:
+    BitWriter(uint8_t* buffer, size_t capacity);
+
+    // The low `bits` bits of value, 1 to 32
+    void write_bits(uint32_t value, int bits);
+    void write_bool(bool value) { write_bits(value ? 1u : 0u, 1); };
+
+    // Small magnitudes cheaply: 1 bit for 0, then 6, 11, 18 or 36 bits as the value grows.
+    // Deltas that are usually zero or tiny are what it is for.
+    void write_signed(int32_t value);
+
+    size_t const get_bit_count()  const { return m_bit_count; };
+    size_t const get_byte_count() const { return (m_bit_count + 7) / 8; };
+    bool   const has_overflowed() const { return m_overflowed; };
+};
+
+class BitReader
+{
+private:
+    const uint8_t* m_buffer;
+    size_t         m_bit_capacity;
+    size_t         m_bit_count = 0;
+    bool           m_overflowed = false;
+
+public:
+    BitReader(const uint8_t* buffer, size_t size);
+
+    // 0 once past the end of the packet
+    uint32_t read_bits(int bits);
+    bool     read_bool() { return read_bits(1) != 0; };
+    int32_t  read_signed();
+
+    size_t const get_bit_count()  const { return m_bit_count; };
+    bool   const has_overflowed() const { return m_overflowed; };
+};
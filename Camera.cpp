@@ -0,0 +1,56 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/matrix.hpp"
+#include "Camera.h"
+
+void Camera::follow(glm::vec2 target, float delta_time)
+{
+    // STEP 1: Where the view has to be for the target to sit on the dead zone's edge
+    float offset = target.x - m_position.x,
+          goal_x = m_position.x;
+    if      (offset >  m_dead_zone) goal_x = target.x - m_dead_zone;
+    else if (offset < -m_dead_zone) goal_x = target.x + m_dead_zone;
+    if (goal_x == m_position.x) return;
+
+    // STEP 2: Ease towards it, never overshooting however long the frame was
+    m_position.x += (goal_x - m_position.x) * std::min(m_follow_rate * delta_time, 1.0f);
+    m_view_dirty = true;
+}
+
+void Camera::snap_to(glm::vec2 position)
+{
+    m_position = position;
+    m_view_dirty = true;
+}
+
+const glm::mat4& Camera::get_view_matrix() const
+{
+    if (m_view_dirty)
+    {
+        m_view_matrix = glm::translate(glm::mat4(1.0f), glm::vec3(-m_position, 0.0f));
+        m_view_dirty = false;
+    }
+    return m_view_matrix;
+}
+
+void get_view_bounds(const glm::mat4& projection, const glm::mat4& view, glm::vec2& view_min, glm::vec2& view_max)
+{
+    // Two opposite corners of clip space are enough, since an orthographic view has no perspective
+    glm::mat4 clip_to_world = glm::inverse(projection * view);
+    glm::vec2 corner_a = glm::vec2(clip_to_world * glm::vec4(-1.0f, -1.0f, 0.0f, 1.0f)),
+              corner_b = glm::vec2(clip_to_world * glm::vec4( 1.0f,  1.0f, 0.0f, 1.0f));
+
+    view_min = glm::min(corner_a, corner_b);
+    view_max = glm::max(corner_a, corner_b);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+// Follows a target around a level wider than the screen by moving the view matrix. The target
+// can wander inside a dead zone around the centre without the view moving at all, so a level
+// that already fits on screen stays put; past it, the camera eases after the target rather than
+// snapping to it. Only x is followed: the lander's levels are a strip along the ground.
+#include "glm/mat4x4.hpp"
+
+class Camera
+{
+private:
+    glm::vec2 m_position = glm::vec2(0.0f);
+
+    float m_dead_zone     = 3.0f,   // half width, around the view's centre
+          m_follow_rate   = 4.0f;   // per second; the fraction of the remaining gap closed is rate * dt
+
+    mutable glm::mat4 m_view_matrix = glm::mat4(1.0f);
+    mutable bool      m_view_dirty  = false;
+
+public:
+    void follow(glm::vec2 target, float delta_time);
+    // Straight there, e.g. on a new level
+    void snap_to(glm::vec2 position);
+    // With whatever it's following, when the origin moves
+    void translate(glm::vec2 offset) { snap_to(m_position + offset); };
+
+    void set_dead_zone(float half_width) { m_dead_zone = half_width; };
+    void set_follow_rate(float rate)     { m_follow_rate = rate; };
+
+    // ————— GETTERS ————— //
+    glm::vec2 const get_position() const { return m_position; };
+    const glm::mat4& get_view_matrix() const;
+};
+
+// The world-space box an orthographic projection * view shows, for culling against
+void get_view_bounds(const glm::mat4& projection, const glm::mat4& view, glm::vec2& view_min, glm::vec2& view_max);
@@ -0,0 +1,48 @@
+#pragma once
+
+// What a body that overlaps a platform does about it along one axis: it is pushed back out,
+// against the way it was moving, by the overlap, and stops there. A body moving neither way is
+// left alone. Shared by Entity's resolution and both of BatchedLanderSim's paths.
+//
+// Written as selects on the sign of the velocity rather than branches on it, so a step where
+// many landers touch down at once doesn't pay a mispredict for each. The float operations are
+// the ones the branching version did, in the same order, so nothing moves by a bit.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+struct AxisResponse
+{
+    bool positive;  // we were moving up (or right), so hit a ceiling (or a wall on our right)
+    bool negative;  // we were moving down (or left): a landing (or a wall on our left)
+};
+
+template <typename Scalar>
+inline AxisResponse resolve_axis(Scalar& position, Scalar& velocity, Scalar overlap)
+{
+    bool positive = velocity > Scalar(0.0f),
+         negative = velocity < Scalar(0.0f),
+         moving   = positive | negative;
+
+    Scalar pushed = positive ? position - overlap : position + overlap;
+    position = moving ? pushed : position;
+    velocity = moving ? Scalar(0.0f) : velocity;
+    return { positive, negative };
+}
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+// Four lanes at once, of which only those set in `hit` respond; which way each was moving comes
+// back as lane masks
+inline void resolve_axis_sse2(__m128& position, __m128& velocity, __m128 overlap, __m128 hit, __m128& positive, __m128& negative)
+{
+    const __m128 zero = _mm_setzero_ps();
+    positive = _mm_and_ps(hit, _mm_cmpgt_ps(velocity, zero));
+    negative = _mm_and_ps(hit, _mm_cmplt_ps(velocity, zero));
+
+    __m128 moving = _mm_or_ps(positive, negative),
+           pushed = _mm_or_ps(_mm_and_ps(positive, _mm_sub_ps(position, overlap)), _mm_andnot_ps(positive, _mm_add_ps(position, overlap)));
+
+    position = _mm_or_ps(_mm_and_ps(moving, pushed), _mm_andnot_ps(moving, position));
+    velocity = _mm_andnot_ps(moving, velocity);
+}
+#endif
@@ -0,0 +1,150 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "CompressedTexture.h"
+#include "TextureSampling.h"
+
+namespace
+{
+    const unsigned char KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    // The fixed part of a KTX2 file: identifier, header and index, then levelCount level entries
+    struct Ktx2Header
+    {
+        unsigned char identifier[12];
+        uint32_t vk_format, type_size,
+                 pixel_width, pixel_height, pixel_depth,
+                 layer_count, face_count, level_count,
+                 supercompression_scheme;
+        uint32_t dfd_byte_offset, dfd_byte_length,
+                 kvd_byte_offset, kvd_byte_length;
+        uint64_t sgd_byte_offset, sgd_byte_length;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80, "the level index starts right after the 80-byte KTX2 header");
+
+    struct Ktx2Level
+    {
+        uint64_t byte_offset, byte_length, uncompressed_byte_length;
+    };
+
+    struct FormatInfo
+    {
+        uint32_t vk_format;
+        GLenum   internal_format;
+        int      block_bytes;  // every format here uses 4x4 blocks
+    };
+
+    const FormatInfo FORMATS[] =
+    {
+        { 131, COMPRESSED_RGB_S3TC_DXT1,                 8 },  // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        { 133, COMPRESSED_RGBA_S3TC_DXT1,                8 },  // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        { 135, COMPRESSED_RGBA_S3TC_DXT3,               16 },  // VK_FORMAT_BC2_UNORM_BLOCK
+        { 137, COMPRESSED_RGBA_S3TC_DXT5,               16 },  // VK_FORMAT_BC3_UNORM_BLOCK
+        { 145, COMPRESSED_RGBA_BPTC_UNORM,              16 },  // VK_FORMAT_BC7_UNORM_BLOCK
+        { 147, COMPRESSED_RGB8_ETC2,                     8 },  // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        { 149, COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 8 },  // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+        { 151, COMPRESSED_RGBA8_ETC2_EAC,               16 },  // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+    };
+}
+
+bool load_ktx2(const char* filepath, CompressedTexture& texture)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    // STEP 1: Read the whole file; the level data is uploaded straight out of this buffer
+    std::streamoff file_size = file.tellg();
+    if (file_size < (std::streamoff)sizeof(Ktx2Header)) return false;
+
+    texture.data.resize((size_t)file_size);
+    file.seekg(0);
+    if (!file.read((char*)texture.data.data(), file_size)) return false;
+
+    Ktx2Header header;
+    std::memcpy(&header, texture.data.data(), sizeof(header));
+
+    // STEP 2: Only what glCompressedTexImage2D can take as it is
+    if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) return false;
+    if (header.supercompression_scheme != 0 || header.pixel_depth > 1 || header.layer_count > 1 || header.face_count != 1) return false;
+    if (header.pixel_width == 0 || header.pixel_height == 0) return false;
+
+    const FormatInfo* format = NULL;
+    for (const FormatInfo& candidate : FORMATS)
+    {
+        if (candidate.vk_format == header.vk_format) format = &candidate;
+    }
+    if (format == NULL) return false;
+
+    // levelCount 0 means "generate them yourself"; there is still exactly one level in the file
+    uint32_t level_count = header.level_count == 0 ? 1 : header.level_count;
+    if (level_count > 32 || sizeof(Ktx2Header) + level_count * sizeof(Ktx2Level) > texture.data.size()) return false;
+
+    // STEP 3: Check every level against the file size and the size its block count implies
+    texture.internal_format = format->internal_format;
+    texture.width = (int)header.pixel_width;
+    texture.height = (int)header.pixel_height;
+    texture.levels.clear();
+
+    for (uint32_t i = 0; i < level_count; i++)
+    {
+        Ktx2Level level;
+        std::memcpy(&level, texture.data.data() + sizeof(Ktx2Header) + i * sizeof(Ktx2Level), sizeof(level));
+
+        int level_width  = std::max(1, texture.width >> i),
+            level_height = std::max(1, texture.height >> i);
+        uint64_t expected = (uint64_t)((level_width + 3) / 4) * ((level_height + 3) / 4) * format->block_bytes;
+
+        if (level.byte_length != expected || level.byte_offset > texture.data.size() || level.byte_length > texture.data.size() - level.byte_offset) return false;
+
+        texture.levels.push_back({ (size_t)level.byte_offset, (size_t)level.byte_length, level_width, level_height });
+    }
+
+    return true;
+}
+
+GLuint upload_compressed_texture(const CompressedTexture& texture, GLuint texture_id)
+{
+    count_gl_call(GL_CALL_BIND);
+    if (texture_id == 0) glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+
+    long long bytes = 0;
+    for (size_t i = 0; i < texture.levels.size(); i++)
+    {
+        const CompressedTexture::Level& level = texture.levels[i];
+        count_gl_call(GL_CALL_UPLOAD);
+        glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, texture.internal_format, level.width, level.height, 0,
+                               (GLsizei)level.size, texture.data.data() + level.offset);
+        bytes += (long long)level.size;
+    }
+    track_gpu_texture(texture_id, bytes);
+
+    // Same sampling as the PNG path, but only as many levels as the file actually brought;
+    // block formats can't be fed to glGenerateMipmap, so the file's chain is all there is
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)texture.levels.size() - 1);
+    apply_sampler_preset(texture_id, SAMPLER_PIXEL_ART);
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    return texture_id;
+}
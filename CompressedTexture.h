@@ -0,0 +1,44 @@
+#pragma once
+
+// Block-compressed textures from KTX2 files, uploaded as-is with glCompressedTexImage2D so they
+// are never expanded to RGBA8 on the CPU or in VRAM. Only uncompressed-container files are read
+// (supercompressionScheme 0, i.e. no Basis/zstd), one layer, one face, 2D.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+
+// Spelled out here because not every platform's GL headers carry all three extensions
+const GLenum COMPRESSED_RGB_S3TC_DXT1                = 0x83F0,  // BC1
+             COMPRESSED_RGBA_S3TC_DXT1               = 0x83F1,
+             COMPRESSED_RGBA_S3TC_DXT3               = 0x83F2,  // BC2
+             COMPRESSED_RGBA_S3TC_DXT5               = 0x83F3,  // BC3
+             COMPRESSED_RGBA_BPTC_UNORM              = 0x8E8C,  // BC7
+             COMPRESSED_RGB8_ETC2                    = 0x9274,
+             COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 = 0x9276,
+             COMPRESSED_RGBA8_ETC2_EAC               = 0x9278;
+
+struct CompressedTexture
+{
+    struct Level
+    {
+        size_t offset, size;  // into data
+        int    width, height;
+    };
+
+    GLenum                     internal_format = 0;
+    int                        width           = 0,
+                               height          = 0;
+    std::vector<Level>         levels;  // level 0 first
+    std::vector<unsigned char> data;
+};
+
+// False if the file is missing, isn't KTX2, is supercompressed, or its vkFormat has no GL
+// equivalent in the table above
+bool load_ktx2(const char* filepath, CompressedTexture& texture);
+
+// Needs a current context; check supports_compressed_format() first. With a texture_id, respecifies
+// that texture instead of making a new one.
+GLuint upload_compressed_texture(const CompressedTexture& texture, GLuint texture_id = 0);
@@ -0,0 +1,165 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+#include "CpuTopology.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// ————— PLATFORM ————— //
+#ifdef __linux__
+// A sysfs list such as "0-15,32-47"; empty if the file isn't there
+static std::vector<int> read_cpu_list(const std::string& path)
+{
+    std::vector<int> values;
+    std::ifstream input(path);
+    std::string list;
+    if (!std::getline(input, list)) return values;
+
+    size_t start = 0;
+    while (start < list.size())
+    {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+
+        std::string range = list.substr(start, end - start);
+        size_t dash = range.find('-');
+        if (!range.empty())
+        {
+            int first = std::stoi(range.substr(0, dash)),
+                last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int value = first; value <= last; value++) values.push_back(value);
+        }
+        start = end + 1;
+    }
+    return values;
+}
+
+// Per node, the CPUs in it this process is allowed on
+static std::vector<std::vector<int>> find_node_cpus()
+{
+    std::vector<std::vector<int>> nodes;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return nodes;
+
+    std::vector<int> node_ids = read_cpu_list("/sys/devices/system/node/online");
+    for (int node : node_ids)
+    {
+        std::vector<int> cpus;
+        for (int cpu : read_cpu_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+        {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+
+    // No sysfs nodes (an old kernel, some containers): one node of whatever we're allowed
+    if (nodes.empty())
+    {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+            if (CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+    return nodes;
+}
+#elif defined(_WIN32)
+static std::vector<std::vector<int>> find_node_cpus()
+{
+    std::vector<std::vector<int>> nodes;
+
+    DWORD_PTR allowed = 0, system = 0;
+    ULONG highest = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &allowed, &system) || !GetNumaHighestNodeNumber(&highest)) return nodes;
+
+    for (ULONG node = 0; node <= highest; node++)
+    {
+        ULONGLONG mask = 0;
+        if (!GetNumaNodeProcessorMask((UCHAR)node, &mask)) continue;
+
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < (int)(sizeof(DWORD_PTR) * 8); cpu++)
+        {
+            if ((mask & allowed) >> cpu & 1) cpus.push_back(cpu);
+        }
+        if (!cpus.empty()) nodes.push_back(cpus);
+    }
+    return nodes;
+}
+#else
+static std::vector<std::vector<int>> find_node_cpus()
+{
+    return std::vector<std::vector<int>>();
+}
+#endif
+
+void CpuTopology::detect()
+{
+    std::vector<std::vector<int>> nodes = find_node_cpus();
+    if (nodes.empty())
+    {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < std::max(1, (int)std::thread::hardware_concurrency()); cpu++) cpus.push_back(cpu);
+        nodes.push_back(cpus);
+    }
+
+    // Dealt out a CPU from each node in turn, so get_cpu's consecutive slots alternate sockets
+    m_cpus.clear();
+    m_nodes.clear();
+    m_node_count = (int)nodes.size();
+
+    size_t largest = 0;
+    for (const std::vector<int>& cpus : nodes) largest = std::max(largest, cpus.size());
+
+    for (size_t round = 0; round < largest; round++)
+    {
+        for (int node = 0; node < m_node_count; node++)
+        {
+            if (round >= nodes[node].size()) continue;
+            m_cpus.push_back(nodes[node][round]);
+            m_nodes.push_back(node);
+        }
+    }
+}
+
+bool pin_current_thread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (cpu < 0 || cpu >= (int)(sizeof(DWORD_PTR) * 8)) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#else
+    // macOS only takes affinity hints, and nothing else here has NUMA to speak of
+    (void)cpu;
+    return false;
+#endif
+}
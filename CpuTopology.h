@@ -0,0 +1,35 @@
+#pragma once
+
+// Which CPUs this process may run on and which NUMA node (socket, usually) each belongs to, for
+// pinning worker threads. Memory is placed on the node of the thread that first touches it, so a
+// pinned worker that allocates and fills its own data keeps it local, where one thread setting
+// everything up for everyone leaves half the workers of a two-socket machine reading across the
+// interconnect.
+//
+// Nodes come from /sys/devices/system/node on Linux and from GetNumaNodeProcessorMask on Windows
+// (the first processor group only); elsewhere, and on single-node machines, every CPU is on node
+// 0 and pinning only keeps threads from migrating.
+#include <vector>
+
+class CpuTopology
+{
+private:
+    std::vector<int> m_cpus,   // the CPUs we may use, dealt out one node at a time (see get_cpu)
+                     m_nodes;  // the node of each, alongside
+    int              m_node_count = 1;
+
+public:
+    // Always finds at least one CPU
+    void detect();
+
+    // The CPU for worker `slot`. Consecutive slots go to different nodes in turn, so a handful
+    // of workers still spreads over every socket's memory bandwidth; slots past the CPU count wrap.
+    int const get_cpu(int slot)  const { return m_cpus[slot % m_cpus.size()]; };
+    int const get_node(int slot) const { return m_nodes[slot % m_nodes.size()]; };
+
+    int const get_cpu_count()  const { return (int)m_cpus.size(); };
+    int const get_node_count() const { return m_node_count; };
+};
+
+// Keeps the calling thread on `cpu` from now on; false where the platform has no way to
+bool pin_current_thread(int cpu);
@@ -0,0 +1,125 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "DebugDraw.h"
+
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+
+DebugDraw& get_debug_draw()
+{
+    static DebugDraw debug_draw;
+    return debug_draw;
+}
+
+void DebugDraw::initialise()
+{
+    if (m_vertex_buffer == 0) glGenBuffers(1, &m_vertex_buffer);
+    if (m_vertex_array == 0 && supports_vertex_arrays()) glGenVertexArrays(1, &m_vertex_array);
+}
+
+void DebugDraw::cleanup()
+{
+    if (m_vertex_array != 0)  glDeleteVertexArrays(1, &m_vertex_array);
+    if (m_vertex_buffer != 0) untrack_gpu_buffers(1, &m_vertex_buffer);
+    if (m_vertex_buffer != 0) glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_array = m_vertex_buffer = 0;
+    m_vertices.clear();
+    m_vertices.shrink_to_fit();
+}
+
+void DebugDraw::line(glm::vec2 start, glm::vec2 end, glm::vec4 colour)
+{
+    DebugVertex vertex;
+    for (int i = 0; i < 4; i++) vertex.colour[i] = (unsigned char)(std::clamp(colour[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+    vertex.position = start;
+    m_vertices.push_back(vertex);
+    vertex.position = end;
+    m_vertices.push_back(vertex);
+}
+
+void DebugDraw::box(glm::vec2 min, glm::vec2 max, glm::vec4 colour)
+{
+    line(min, glm::vec2(max.x, min.y), colour);
+    line(glm::vec2(max.x, min.y), max, colour);
+    line(max, glm::vec2(min.x, max.y), colour);
+    line(glm::vec2(min.x, max.y), min, colour);
+}
+
+void DebugDraw::circle(glm::vec2 centre, float radius, glm::vec4 colour, int segments)
+{
+    segments = std::max(segments, 3);
+
+    // Each corner is the last one turned by the same small rotation
+    float angle = 6.28318531f / (float)segments,
+          cos_step = std::cos(angle),
+          sin_step = std::sin(angle);
+    glm::vec2 offset = glm::vec2(radius, 0.0f);
+    for (int i = 0; i < segments; i++)
+    {
+        glm::vec2 next = glm::vec2(offset.x * cos_step - offset.y * sin_step, offset.x * sin_step + offset.y * cos_step);
+        line(centre + offset, centre + next, colour);
+        offset = next;
+    }
+}
+
+void DebugDraw::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    m_drawn_lines = 0;
+    GLint colour_attribute = program->get_vertex_colour_attribute();
+    if (m_vertices.empty() || m_vertex_buffer == 0 || colour_attribute < 0)
+    {
+        clear();
+        return;
+    }
+
+    program->use();
+    program->set_model_transform(ModelTransform());
+
+    count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+    if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+
+    // STEP 1: A fresh store every frame, so the driver never waits on last frame's draw
+    count_gl_call(GL_CALL_UPLOAD);
+    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(DebugVertex), m_vertices.data(), GL_STREAM_DRAW);
+    track_gpu_buffer(m_vertex_buffer, (long long)(m_vertices.size() * sizeof(DebugVertex)));
+
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, sizeof(DebugVertex), (void*)offsetof(DebugVertex, position));
+    glEnableVertexAttribArray(program->get_position_attribute());
+    glVertexAttribPointer(colour_attribute, 4, GL_UNSIGNED_BYTE, true, sizeof(DebugVertex), (void*)offsetof(DebugVertex, colour));
+    glEnableVertexAttribArray(colour_attribute);
+
+    // STEP 2: Every shape of the frame in one call
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_LINES, 0, (GLsizei)m_vertices.size());
+    m_draw_calls++;
+    m_drawn_lines = get_line_count();
+
+    count_gl_call(GL_CALL_BIND);
+    glDisableVertexAttribArray(colour_attribute);
+    glDisableVertexAttribArray(program->get_position_attribute());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0) glBindVertexArray(0);
+
+    clear();
+}
+
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+// Lines, boxes and circles for seeing what collision is doing: bounding boxes, the broadphase's
+// answer, contacts. Anything can add shapes at any point in the frame; they pile up as coloured
+// line vertices in one array, and draw() sends the lot up in one upload and draws it in one
+// GL_LINES call with the flat variant that takes its colour per vertex (SHADER_VERTEX_COLOUR),
+// then empties the array for the next frame. Main thread only, like the rest of the drawing.
+//
+// Only debug builds have it. It's there when the build defines one of:
+//
+//     _DEBUG             MSVC's Debug configurations
+//     LANDER_DEBUG_DRAW  anywhere else it's wanted, a release build included
+//
+// Everywhere else the DEBUG_DRAW_* macros expand to nothing, arguments and all, and this header
+// declares nothing else, so calls to them cost nothing and the shapes' maths is never done.
+
+#if defined(_DEBUG) || defined(LANDER_DEBUG_DRAW)
+
+#define LANDER_DEBUG_DRAW_ENABLED 1
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+struct DebugVertex
+{
+    glm::vec2     position;
+    unsigned char colour[4];  // normalised to 0-1 in the shader
+};
+
+class DebugDraw
+{
+private:
+    static const int CIRCLE_SEGMENTS = 24;
+
+    std::vector<DebugVertex> m_vertices;  // pairs, one per line
+
+    GLuint m_vertex_buffer = 0,
+           m_vertex_array  = 0;
+    int    m_draw_calls = 0,
+           m_drawn_lines = 0;
+
+public:
+    void initialise();
+    void cleanup();
+
+    void line(glm::vec2 start, glm::vec2 end, glm::vec4 colour);
+    void box(glm::vec2 min, glm::vec2 max, glm::vec4 colour);
+    void circle(glm::vec2 centre, float radius, glm::vec4 colour, int segments = CIRCLE_SEGMENTS);
+
+    // Everything added since the last one, in one draw; `program` needs SHADER_VERTEX_COLOUR
+    void draw(ShaderProgram* program);
+    void clear() { m_vertices.clear(); };
+
+    bool const is_empty()         const { return m_vertices.empty(); };
+    int  const get_line_count()   const { return (int)m_vertices.size() / 2; };
+    int  const get_drawn_lines()  const { return m_drawn_lines; };  // by the last draw
+    int  const get_draw_calls()   const { return m_draw_calls; };   // by the last draw
+};
+
+// The one every DEBUG_DRAW_* adds to
+DebugDraw& get_debug_draw();
+
+#define DEBUG_DRAW_LINE(start, end, colour)      get_debug_draw().line(start, end, colour)
+#define DEBUG_DRAW_BOX(min, max, colour)         get_debug_draw().box(min, max, colour)
+#define DEBUG_DRAW_CIRCLE(centre, radius, colour) get_debug_draw().circle(centre, radius, colour)
+
+#else
+
+#define DEBUG_DRAW_LINE(start, end, colour)      ((void)0)
+#define DEBUG_DRAW_BOX(min, max, colour)         ((void)0)
+#define DEBUG_DRAW_CIRCLE(centre, radius, colour) ((void)0)
+
+#endif
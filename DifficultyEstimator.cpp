@@ -0,0 +1,134 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "DifficultyEstimator.h"
+#include "Rng.h"
+
+// How far past the platforms in reach a start can stray before it's out of bounds
+const float BOUNDS_MARGIN = 10.0f;
+
+// The reference pilot's thresholds, headless.cpp's control()
+const float PILOT_MAX_FALL_SPEED = 1.0f,
+            PILOT_DEADBAND       = 0.1f;
+
+DifficultyEstimate DifficultyEstimator::estimate(const Entity& prototype, const Entity* platforms, int platform_count,
+                                                 glm::vec3 spawn, float gravity, unsigned int seed)
+{
+    DifficultyEstimate result;
+    result.starts = m_config.start_count;
+
+    // STEP 1: Only what the starts can get to. A scene of a hundred thousand platforms would
+    //         otherwise be tested against every lander every step.
+    m_nearby.clear();
+    m_win_x.clear();
+    for (int i = 0; i < platform_count; i++)
+    {
+        if (!platforms[i].is_active() || std::fabs(platforms[i].get_position().x - spawn.x) > m_config.reach) continue;
+
+        m_nearby.push_back(platforms[i]);
+        if (platforms[i].get_entity_type() == WIN_PLATFORM) m_win_x.push_back(platforms[i].get_position().x);
+    }
+    if (m_win_x.empty()) return result;  // nothing to land on: no need to fly it
+    std::sort(m_win_x.begin(), m_win_x.end());
+
+    glm::vec2 min = glm::vec2(spawn) - glm::vec2(m_config.spawn_spread, m_config.height_spread),
+              max = glm::vec2(spawn) + glm::vec2(m_config.spawn_spread, m_config.height_spread);
+    for (const Entity& platform : m_nearby)
+    {
+        min = glm::min(min, glm::vec2(platform.get_position()));
+        max = glm::max(max, glm::vec2(platform.get_position()));
+    }
+
+    // STEP 2: Every start at once
+    m_sim.initialise(prototype, m_config.start_count);
+    m_sim.set_platforms(m_nearby.data(), (int)m_nearby.size());
+    m_sim.set_bounds(min - glm::vec2(BOUNDS_MARGIN), max + glm::vec2(BOUNDS_MARGIN));
+
+    Rng rng(seed, 0xd1ff);
+    for (int lander = 0; lander < m_config.start_count; lander++)
+    {
+        glm::vec3 offset = glm::vec3((rng.next_float() * 2.0f - 1.0f) * m_config.spawn_spread,
+                                     (rng.next_float() * 2.0f - 1.0f) * m_config.height_spread, 0.0f);
+        m_sim.reset(lander, spawn + offset, gravity);
+    }
+
+    // STEP 3: Flown by the reference pilot until they're all down or out of time
+    for (int step = 0; step < m_config.max_steps && m_sim.get_done_count() < m_config.start_count; step++)
+    {
+        for (int lander = 0; lander < m_config.start_count; lander++)
+        {
+            if (m_sim.is_done(lander)) continue;
+
+            glm::vec3 position = m_sim.get_position(lander);
+            bool booster = m_sim.get_velocity(lander).y < -PILOT_MAX_FALL_SPEED;
+
+            float movement_x = 0.0f;
+            if (!booster)
+            {
+                auto after = std::lower_bound(m_win_x.begin(), m_win_x.end(), position.x);
+                float target_x;
+                if      (after == m_win_x.begin()) target_x = *after;
+                else if (after == m_win_x.end())   target_x = *(after - 1);
+                else    target_x = (position.x - *(after - 1) <= *after - position.x) ? *(after - 1) : *after;
+
+                if      (target_x < position.x - PILOT_DEADBAND) movement_x = -1.0f;
+                else if (target_x > position.x + PILOT_DEADBAND) movement_x = 1.0f;
+            }
+            m_sim.set_controls(lander, movement_x, booster);
+        }
+        m_sim.step(FIXED_TIMESTEP);
+    }
+
+    for (int lander = 0; lander < m_config.start_count; lander++)
+    {
+        if (m_sim.has_won(lander)) result.wins++;
+    }
+    return result;
+}
+
+unsigned int generate_winnable_scene(DifficultyEstimator& estimator, Entity* platforms, const SceneConfig& scene, unsigned int seed,
+                                     const Entity& prototype, glm::vec3 spawn, float gravity, const LevelCheck& check,
+                                     SceneGenerateFunction generate, DifficultyEstimate* estimate)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    unsigned int candidate_seed = seed,
+                 best_seed      = seed;
+    DifficultyEstimate best;
+
+    // Candidates after the first come from the first, so one seed always settles on one level
+    Rng rerolls(seed, 0x5eed);
+    for (int candidate = 0; candidate < std::max(check.max_candidates, 1); candidate++)
+    {
+        if (candidate > 0)
+        {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (elapsed >= check.budget_seconds) break;
+            candidate_seed = rerolls.next_u32();
+        }
+
+        generate(platforms, scene, candidate_seed);
+        DifficultyEstimate current = estimator.estimate(prototype, platforms, scene.platform_count, spawn, gravity, candidate_seed);
+        if (candidate == 0 || current.get_win_probability() > best.get_win_probability())
+        {
+            best = current;
+            best_seed = candidate_seed;
+        }
+        if (current.get_win_probability() >= check.min_win_probability) break;
+    }
+
+    // Out of time on a worse candidate than one before it: put the best one back
+    if (best_seed != candidate_seed) generate(platforms, scene, best_seed);
+    if (estimate != NULL) *estimate = best;
+    return best_seed;
+}
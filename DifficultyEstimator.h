@@ -0,0 +1,70 @@
+#pragma once
+
+// Monte Carlo estimate of how winnable a level is: a reference pilot (headless.cpp's scripted
+// controller: brake while falling fast, otherwise drift toward the nearest WIN platform) flies
+// many randomised starts around the spawn point at once in a BatchedLanderSim, and the share that
+// land is the level's win probability.
+//
+// generate_winnable_scene() puts it in front of the generator. Every platform's type is an
+// independent coin flip, so now and then a level comes out all DEATH_PLATFORMs under the spawn
+// point, or with its only WIN platforms somewhere no one can reach; those are re-rolled onto a
+// seed derived from the first until one clears the bar, within a time budget.
+#include <vector>
+#include "glm/vec3.hpp"
+#include "BatchedLanderSim.h"
+#include "Entity.h"
+#include "SceneGenerator.h"
+
+struct DifficultyConfig
+{
+    int   start_count   = 128;    // randomised starts per estimate, all flown at once
+    int   max_steps     = 900;    // fifteen seconds of game time; a start still flying then failed
+    float spawn_spread  = 2.0f,   // starts along x either side of the spawn point
+          height_spread = 0.5f;   // ...and above or below it
+    float reach         = 32.0f;  // platforms further along x from the spawn point are left out
+};
+
+struct DifficultyEstimate
+{
+    int starts = 0,
+        wins   = 0;
+
+    float const get_win_probability() const { return starts > 0 ? (float)wins / starts : 0.0f; };
+};
+
+// What generate_winnable_scene() lets through, and how long it may look
+struct LevelCheck
+{
+    float  min_win_probability = 0.25f;
+    double budget_seconds      = 0.05;  // re-rolls stop here, keeping the best seen so far
+    int    max_candidates      = 32;
+};
+
+typedef void (*SceneGenerateFunction)(Entity* platforms, const SceneConfig& config, unsigned int seed);
+
+class DifficultyEstimator
+{
+private:
+    DifficultyConfig    m_config;
+    BatchedLanderSim    m_sim;
+    std::vector<Entity> m_nearby;  // the platforms within reach of the spawn point
+    std::vector<float>  m_win_x;   // the centres of the WIN ones along x, sorted
+
+public:
+    DifficultyEstimator(const DifficultyConfig& config = DifficultyConfig()) : m_config(config) {}
+
+    // The lander's physical constants (speed, drag, boosting power, size) are the prototype's.
+    // The same seed always gives the same starts, so the same level always gets the same estimate.
+    DifficultyEstimate estimate(const Entity& prototype, const Entity* platforms, int platform_count,
+                                glm::vec3 spawn, float gravity, unsigned int seed);
+
+    const DifficultyConfig& get_config() const { return m_config; };
+};
+
+// Generates `seed`'s scene into `platforms` and, if the estimator finds it too hard, re-rolls it
+// until a candidate clears check.min_win_probability or the budget runs out, in which case the
+// best candidate is the one left in `platforms`. Returns that level's seed, which replays and
+// restarts then use; the first candidate is always estimated in full.
+unsigned int generate_winnable_scene(DifficultyEstimator& estimator, Entity* platforms, const SceneConfig& scene, unsigned int seed,
+                                     const Entity& prototype, glm::vec3 spawn, float gravity, const LevelCheck& check,
+                                     SceneGenerateFunction generate = generate_scene, DifficultyEstimate* estimate = NULL);
@@ -0,0 +1,299 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "DistanceField.h"
+#include "Terrain.h"
+
+// Stands in for "no rock anywhere" in the transform; big enough to lose to any real site, small
+// enough that differences of it stay finite
+const double NO_SITE = 1.0e20;
+// What open space reads as off the grid, or in a field with no rock at all
+const float FAR_DISTANCE = 1.0e6f;
+
+// The squared distance from each of n samples to the nearest site, where f is 0 at a site and
+// NO_SITE elsewhere, as the lower envelope of parabolas rooted at the sites (Felzenszwalb &
+// Huttenlocher). nearest gets which sample that site was; v and z are scratch of n and n + 1.
+static void distance_transform_1d(const double* f, int n, double* d, int* nearest, int* v, double* z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -std::numeric_limits<double>::infinity();
+    z[1] = std::numeric_limits<double>::infinity();
+
+    // STEP 1: The envelope, left to right
+    for (int q = 1; q < n; q++)
+    {
+        double s = ((f[q] + (double)q * q) - (f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        while (s <= z[k])
+        {
+            k--;
+            s = ((f[q] + (double)q * q) - (f[v[k]] + (double)v[k] * v[k])) / (2.0 * q - 2.0 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    // STEP 2: Read each sample's distance off it
+    k = 0;
+    for (int q = 0; q < n; q++)
+    {
+        while (z[k + 1] < q) k++;
+        d[q] = (double)(q - v[k]) * (q - v[k]) + f[v[k]];
+        nearest[q] = v[k];
+    }
+}
+
+// The squared distance, in cells, from every node to the nearest node whose solidity is `sites`,
+// and which node that is: down the columns first, then along the rows
+static void distance_transform(const std::vector<unsigned char>& solid, int columns, int rows, bool sites,
+                               std::vector<double>& squared, std::vector<int>& nearest)
+{
+    int longest = std::max(columns, rows);
+    std::vector<double> f(longest), d(longest), z(longest + 1);
+    std::vector<int>    v(longest), hit(longest);
+    std::vector<int>    nearest_row(solid.size());
+
+    squared.resize(solid.size());
+    nearest.resize(solid.size());
+
+    for (int column = 0; column < columns; column++)
+    {
+        for (int row = 0; row < rows; row++) f[row] = ((solid[row * columns + column] != 0) == sites) ? 0.0 : NO_SITE;
+        distance_transform_1d(f.data(), rows, d.data(), hit.data(), v.data(), z.data());
+        for (int row = 0; row < rows; row++)
+        {
+            squared[row * columns + column] = d[row];
+            nearest_row[row * columns + column] = hit[row];
+        }
+    }
+
+    for (int row = 0; row < rows; row++)
+    {
+        double* line = &squared[row * columns];
+        std::copy(line, line + columns, f.begin());
+        distance_transform_1d(f.data(), columns, line, hit.data(), v.data(), z.data());
+        for (int column = 0; column < columns; column++)
+        {
+            nearest[row * columns + column] = nearest_row[row * columns + hit[column]] * columns + hit[column];
+        }
+    }
+}
+
+void DistanceField::begin(glm::vec2 min, glm::vec2 max, float cell_size)
+{
+    m_origin = min;
+    m_cell_size = cell_size;
+    m_inverse_cell_size = 1.0f / cell_size;
+    m_columns = std::max((int)std::ceil((max.x - min.x) * m_inverse_cell_size) + 1, 2);
+    m_rows    = std::max((int)std::ceil((max.y - min.y) * m_inverse_cell_size) + 1, 2);
+
+    m_solid.assign((size_t)m_columns * m_rows, 0);
+    m_distances.clear();
+    m_rock_types.clear();
+}
+
+// Rock from the bottom of the column up to the terrain's surface, of the type under it
+static void fill_terrain_column(const Terrain& terrain, float x, unsigned char* column_nodes, int stride, int rows,
+                                float origin_y, float inverse_cell_size)
+{
+    int segments = terrain.get_sample_count() - 1;
+    float height = terrain.get_height(x);
+    if (!std::isfinite(height)) return;
+
+    int segment = std::min(std::max((int)((x - terrain.get_origin_x()) / terrain.get_spacing()), 0), segments - 1);
+    unsigned char rock = 1 + (terrain.is_pad(segment) ? WIN_PLATFORM : DEATH_PLATFORM);
+
+    int top = std::min((int)std::floor((height - origin_y) * inverse_cell_size), rows - 1);
+    for (int row = 0; row <= top; row++) column_nodes[(size_t)row * stride] = rock;
+}
+
+void DistanceField::fill_terrain(const Terrain& terrain)
+{
+    if (terrain.get_sample_count() < 2) return;
+
+    for (int column = 0; column < m_columns; column++)
+    {
+        fill_terrain_column(terrain, m_origin.x + column * m_cell_size, &m_solid[column], m_columns, m_rows, m_origin.y, m_inverse_cell_size);
+    }
+}
+
+void DistanceField::repaint_terrain(const Terrain& terrain, float min_x, float max_x)
+{
+    if (terrain.get_sample_count() < 2 || m_solid.empty()) return;
+
+    int first = std::max((int)std::floor((min_x - m_origin.x) * m_inverse_cell_size), 0),
+        last  = std::min((int)std::ceil((max_x - m_origin.x) * m_inverse_cell_size), m_columns - 1);
+    for (int column = first; column <= last; column++)
+    {
+        for (int row = 0; row < m_rows; row++) m_solid[get_node(column, row)] = 0;
+        fill_terrain_column(terrain, m_origin.x + column * m_cell_size, &m_solid[column], m_columns, m_rows, m_origin.y, m_inverse_cell_size);
+    }
+}
+
+void DistanceField::fill_box(glm::vec2 centre, glm::vec2 size, EntityType type)
+{
+    glm::vec2 first = (centre - size / 2.0f - m_origin) * m_inverse_cell_size,
+              last  = (centre + size / 2.0f - m_origin) * m_inverse_cell_size;
+
+    int min_column = std::max((int)std::ceil(first.x), 0),  max_column = std::min((int)std::floor(last.x), m_columns - 1),
+        min_row    = std::max((int)std::ceil(first.y), 0),  max_row    = std::min((int)std::floor(last.y), m_rows - 1);
+
+    for (int row = min_row; row <= max_row; row++)
+    {
+        for (int column = min_column; column <= max_column; column++) m_solid[get_node(column, row)] = (unsigned char)(1 + type);
+    }
+}
+
+void DistanceField::carve_circle(glm::vec2 centre, float radius)
+{
+    glm::vec2 node = (centre - m_origin) * m_inverse_cell_size;
+    float     reach = radius * m_inverse_cell_size;
+
+    int min_column = std::max((int)std::ceil(node.x - reach), 0),  max_column = std::min((int)std::floor(node.x + reach), m_columns - 1),
+        min_row    = std::max((int)std::ceil(node.y - reach), 0),  max_row    = std::min((int)std::floor(node.y + reach), m_rows - 1);
+
+    for (int row = min_row; row <= max_row; row++)
+    {
+        for (int column = min_column; column <= max_column; column++)
+        {
+            float dx = column - node.x,
+                  dy = row - node.y;
+            if (dx * dx + dy * dy <= reach * reach) m_solid[get_node(column, row)] = 0;
+        }
+    }
+}
+
+void DistanceField::bake_window(const std::vector<unsigned char>& solid, int columns, int rows, float cell_size,
+                                std::vector<float>& distances, std::vector<unsigned char>& rock_types)
+{
+    // STEP 1: How far every node is from the nearest rock, and from the nearest open space
+    std::vector<double> to_rock, to_open;
+    std::vector<int>    nearest_rock, nearest_open;
+    distance_transform(solid, columns, rows, true, to_rock, nearest_rock);
+    distance_transform(solid, columns, rows, false, to_open, nearest_open);
+
+    // STEP 2: Signed, with the surface put halfway between a rock node and an open one
+    int node_count = columns * rows;
+    distances.resize(node_count);
+    rock_types.resize(node_count);
+
+    for (int i = 0; i < node_count; i++)
+    {
+        bool   is_solid = solid[i] != 0;
+        double squared  = is_solid ? to_open[i] : to_rock[i];
+
+        float distance = (squared >= NO_SITE / 2.0) ? FAR_DISTANCE : ((float)std::sqrt(squared) - 0.5f) * cell_size;
+        distances[i] = is_solid ? -distance : distance;
+
+        unsigned char rock = is_solid ? solid[i] : ((to_rock[i] >= NO_SITE / 2.0) ? 0 : solid[nearest_rock[i]]);
+        rock_types[i] = (rock == 0) ? (unsigned char)DEATH_PLATFORM : (unsigned char)(rock - 1);
+    }
+}
+
+void DistanceField::bake(bool keep_solid)
+{
+    if (m_solid.empty()) return;
+
+    bake_window(m_solid, m_columns, m_rows, m_cell_size, m_distances, m_rock_types);
+
+    // Otherwise only needed to paint with
+    if (keep_solid) return;
+    m_solid.clear();
+    m_solid.shrink_to_fit();
+}
+
+void DistanceField::copy_solid(int& column, int& row, int& columns, int& rows, std::vector<unsigned char>& solid) const
+{
+    int last_column = std::min(column + columns, m_columns),
+        last_row    = std::min(row + rows, m_rows);
+    column = std::max(column, 0);
+    row = std::max(row, 0);
+    columns = std::max(last_column - column, 0);
+    rows = std::max(last_row - row, 0);
+
+    solid.resize((size_t)columns * rows);
+    for (int r = 0; r < rows; r++) std::copy_n(&m_solid[get_node(column, row + r)], columns, &solid[(size_t)r * columns]);
+}
+
+void DistanceField::write_region(int column, int row, int columns, int rows, const float* distances, const unsigned char* rock_types,
+                                 int stride, float exact_distance)
+{
+    for (int r = 0; r < rows; r++)
+    {
+        for (int c = 0; c < columns; c++)
+        {
+            int   node     = get_node(column + c, row + r);
+            float distance = distances[r * stride + c];
+
+            // Past the window's reach only a bound is known. Rock only ever goes away, so open
+            // space is at least as far from it as it was, and rock no deeper than it was.
+            if (distance > exact_distance)       distance = std::max(m_distances[node], exact_distance);
+            else if (distance < -exact_distance) distance = -exact_distance;
+
+            m_distances[node] = distance;
+            m_rock_types[node] = rock_types[r * stride + c];
+        }
+    }
+}
+
+float DistanceField::get_distance(glm::vec2 position) const
+{
+    glm::vec2 node = (position - m_origin) * m_inverse_cell_size;
+    if (!is_baked() || !(node.x >= 0.0f && node.y >= 0.0f && node.x <= m_columns - 1 && node.y <= m_rows - 1)) return FAR_DISTANCE;
+
+    int   column = std::min((int)node.x, m_columns - 2),
+          row    = std::min((int)node.y, m_rows - 2);
+    float fx = node.x - column,
+          fy = node.y - row;
+
+    const float* bottom = &m_distances[get_node(column, row)];
+    const float* top    = bottom + m_columns;
+
+    float lower = bottom[0] + (bottom[1] - bottom[0]) * fx,
+          upper = top[0]    + (top[1]    - top[0])    * fx;
+    return lower + (upper - lower) * fy;
+}
+
+glm::vec2 DistanceField::get_normal(glm::vec2 position) const
+{
+    if (!is_baked()) return glm::vec2(0.0f, 1.0f);
+
+    // The bilinear patch's own gradient, from the cell the position is in (or nearest to)
+    glm::vec2 node = (position - m_origin) * m_inverse_cell_size;
+    int   column = std::min(std::max((int)std::floor(node.x), 0), m_columns - 2),
+          row    = std::min(std::max((int)std::floor(node.y), 0), m_rows - 2);
+    float fx = std::min(std::max(node.x - column, 0.0f), 1.0f),
+          fy = std::min(std::max(node.y - row, 0.0f), 1.0f);
+
+    const float* bottom = &m_distances[get_node(column, row)];
+    const float* top    = bottom + m_columns;
+
+    glm::vec2 gradient((bottom[1] - bottom[0]) * (1.0f - fy) + (top[1] - top[0]) * fy,
+                       (top[0] - bottom[0]) * (1.0f - fx) + (top[1] - bottom[1]) * fx);
+
+    float length = std::sqrt(gradient.x * gradient.x + gradient.y * gradient.y);
+    return (length > 1.0e-6f) ? gradient / length : glm::vec2(0.0f, 1.0f);
+}
+
+EntityType DistanceField::get_rock_type(glm::vec2 position) const
+{
+    if (!is_baked()) return DEATH_PLATFORM;
+
+    glm::vec2 node = (position - m_origin) * m_inverse_cell_size;
+    int column = std::min(std::max((int)std::lround(node.x), 0), m_columns - 1),
+        row    = std::min(std::max((int)std::lround(node.y), 0), m_rows - 1);
+    return (EntityType)m_rock_types[get_node(column, row)];
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// Level geometry of any shape, caves and overhangs included, baked at load into a grid of signed
+// distances: negative inside rock, positive in open space, zero on the surface. A body asks it
+// only at the points of its hull (see Entity::resolve_field), so collision costs the same few
+// bilinear samples however complicated the ground is, and the gradient there is the way out.
+//
+// Building one goes: begin() over the region to cover, then any number of fill_terrain(),
+// fill_box() and carve_circle() calls to paint rock in or out, then bake(). Each node also keeps
+// the type of the rock nearest to it, which is how a landing is scored: on WIN_PLATFORM rock
+// (a terrain pad, a winning box) it's a win, on anything else a loss.
+//
+// A field baked with keep_solid can still be painted afterwards, a region at a time: copy_solid
+// hands out a window of the painting, bake_window turns it into distances anywhere (a worker
+// thread, say), and write_region puts them back. See TerrainEditor.
+//
+// The surface is only as sharp as the grid: expect it to be up to about half a cell off. The
+// distances themselves are plain floats in row-major order, one per node, so they can go
+// straight into a texture for an outline or glow shader.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+
+class Terrain;
+
+class DistanceField
+{
+private:
+    glm::vec2 m_origin = glm::vec2(0.0f);  // world position of node (0, 0)
+    float     m_cell_size = 1.0f,
+              m_inverse_cell_size = 1.0f;
+    int       m_columns = 0,
+              m_rows    = 0;
+
+    std::vector<unsigned char> m_solid;       // per node while painting: 0 open, else 1 + EntityType
+    std::vector<float>         m_distances;   // per node once baked
+    std::vector<unsigned char> m_rock_types;  // per node: the EntityType of the nearest rock
+
+    int const get_node(int column, int row) const { return row * m_columns + column; };
+
+public:
+    // Contact::index for a contact with the field rather than a platform or the terrain
+    static const int CONTACT_INDEX = -2;
+
+    // Starts a field covering [min, max] with nodes cell_size apart, all of it open space
+    void begin(glm::vec2 min, glm::vec2 max, float cell_size);
+
+    // Fills in everything below the terrain's surface, pads as WIN_PLATFORM and the rest as DEATH_PLATFORM
+    void fill_terrain(const Terrain& terrain);
+    // Clears the columns over [min_x, max_x] and fills them in from the terrain again
+    void repaint_terrain(const Terrain& terrain, float min_x, float max_x);
+    // Fills in an axis-aligned box, e.g. a platform
+    void fill_box(glm::vec2 centre, glm::vec2 size, EntityType type);
+    // Opens up a disc of rock, for tunnels and caverns
+    void carve_circle(glm::vec2 centre, float radius);
+
+    // Turns what was painted into distances; the field answers nothing before this. keep_solid
+    // keeps the painting, so it can be edited and regions baked again.
+    void bake(bool keep_solid = false);
+
+    // The same for a window of painted nodes: `solid` is columns x rows of them, row-major
+    static void bake_window(const std::vector<unsigned char>& solid, int columns, int rows, float cell_size,
+                            std::vector<float>& distances, std::vector<unsigned char>& rock_types);
+
+    // The painting over nodes [column, column + columns) x [row, row + rows), clipped to the grid;
+    // returns the clipped window through the arguments
+    void copy_solid(int& column, int& row, int& columns, int& rows, std::vector<unsigned char>& solid) const;
+
+    // A window's interior, `stride` nodes to a row, into nodes [column, column + columns) x
+    // [row, row + rows). A window only sees so far: past exact_distance its distances are only
+    // bounds, so open space keeps what it had if that was further and rock is held to exact_distance.
+    void write_region(int column, int row, int columns, int rows, const float* distances, const unsigned char* rock_types,
+                      int stride, float exact_distance);
+
+    // The signed distance at `position`, between nodes; open space (a large positive distance)
+    // anywhere off the grid
+    float get_distance(glm::vec2 position) const;
+    // The direction out of the rock at `position`: the field's normalised gradient
+    glm::vec2 get_normal(glm::vec2 position) const;
+    // What the nearest rock to `position` is
+    EntityType get_rock_type(glm::vec2 position) const;
+
+    // ————— GETTERS ————— //
+    bool         const is_baked()          const { return !m_distances.empty(); };
+    bool         const is_editable()       const { return is_baked() && !m_solid.empty(); };
+    int          const get_columns()       const { return m_columns; };
+    int          const get_rows()          const { return m_rows; };
+    float        const get_cell_size()     const { return m_cell_size; };
+    glm::vec2    const get_origin()        const { return m_origin; };
+    const float*       get_distances()     const { return m_distances.data(); };
+};
@@ -0,0 +1,247 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "glm/common.hpp"
+#include "DynamicAabbTree.h"
+
+static float perimeter(glm::vec2 min, glm::vec2 max)
+{
+    return 2.0f * ((max.x - min.x) + (max.y - min.y));
+}
+
+// ————— NODES ————— //
+int DynamicAabbTree::allocate_node()
+{
+    int node = m_free;
+    if (node != NULL_NODE) m_free = m_nodes[node].parent;
+    else
+    {
+        node = (int)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+
+    m_nodes[node] = { glm::vec2(0.0f), glm::vec2(0.0f), NULL_NODE, NULL_NODE, NULL_NODE, -1, 0 };
+    return node;
+}
+
+void DynamicAabbTree::free_node(int node)
+{
+    m_nodes[node].parent = m_free;
+    m_nodes[node].height = -1;
+    m_free = node;
+}
+
+void DynamicAabbTree::fit(int node)
+{
+    Node& parent = m_nodes[node];
+    const Node& left  = m_nodes[parent.left];
+    const Node& right = m_nodes[parent.right];
+    parent.min = glm::min(left.min, right.min);
+    parent.max = glm::max(left.max, right.max);
+    parent.height = 1 + std::max(left.height, right.height);
+}
+
+// ————— STRUCTURE ————— //
+void DynamicAabbTree::insert_leaf(int leaf)
+{
+    if (m_root == NULL_NODE)
+    {
+        m_root = leaf;
+        m_nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // STEP 1: Down to the cheapest sibling. Pairing with a node costs the new parent's perimeter,
+    //         and every ancestor above it grows by however much the leaf widens it.
+    glm::vec2 leaf_min = m_nodes[leaf].min,
+              leaf_max = m_nodes[leaf].max;
+    int sibling = m_root;
+    while (!is_leaf(sibling))
+    {
+        const Node& node = m_nodes[sibling];
+        float combined    = perimeter(glm::min(node.min, leaf_min), glm::max(node.max, leaf_max)),
+              here        = 2.0f * combined,
+              inheritance = 2.0f * (combined - perimeter(node.min, node.max));
+
+        float costs[2];
+        int   children[2] = { node.left, node.right };
+        for (int i = 0; i < 2; i++)
+        {
+            const Node& child = m_nodes[children[i]];
+            float grown = perimeter(glm::min(child.min, leaf_min), glm::max(child.max, leaf_max));
+            costs[i] = inheritance + (is_leaf(children[i]) ? grown : grown - perimeter(child.min, child.max));
+        }
+
+        if (here < costs[0] && here < costs[1]) break;
+        sibling = costs[0] <= costs[1] ? children[0] : children[1];
+    }
+
+    // STEP 2: A new parent over the two, where the sibling was
+    int old_parent = m_nodes[sibling].parent,
+        new_parent = allocate_node();
+    m_nodes[new_parent].parent = old_parent;
+    m_nodes[new_parent].left = sibling;
+    m_nodes[new_parent].right = leaf;
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent = new_parent;
+
+    if (old_parent == NULL_NODE) m_root = new_parent;
+    else if (m_nodes[old_parent].left == sibling) m_nodes[old_parent].left = new_parent;
+    else m_nodes[old_parent].right = new_parent;
+
+    // STEP 3: Everything above it grows to fit
+    refit_from(new_parent);
+}
+
+void DynamicAabbTree::remove_leaf(int leaf)
+{
+    if (leaf == m_root)
+    {
+        m_root = NULL_NODE;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    int parent      = m_nodes[leaf].parent,
+        grandparent = m_nodes[parent].parent,
+        sibling     = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+    m_nodes[sibling].parent = grandparent;
+    free_node(parent);
+
+    if (grandparent == NULL_NODE)
+    {
+        m_root = sibling;
+        return;
+    }
+    if (m_nodes[grandparent].left == parent) m_nodes[grandparent].left = sibling;
+    else m_nodes[grandparent].right = sibling;
+    refit_from(grandparent);
+}
+
+void DynamicAabbTree::refit_from(int node)
+{
+    while (node != NULL_NODE)
+    {
+        node = balance(node);
+        fit(node);
+        node = m_nodes[node].parent;
+    }
+}
+
+// Lifts the taller child into the node's place when the sides differ by more than a level. Of
+// the lifted child's own children, the taller stays with it and the shorter moves down under
+// the old node, into the slot the lifted child left. Returns whichever node is now on top.
+int DynamicAabbTree::balance(int node)
+{
+    if (is_leaf(node) || m_nodes[node].height < 2) return node;
+
+    int left = m_nodes[node].left, right = m_nodes[node].right;
+    int difference = m_nodes[right].height - m_nodes[left].height;
+    if (difference >= -1 && difference <= 1) return node;
+
+    int lifted = difference > 1 ? right : left,
+        first  = m_nodes[lifted].left,
+        second = m_nodes[lifted].right;
+    int kept   = m_nodes[first].height > m_nodes[second].height ? first : second,
+        given  = kept == first ? second : first;
+
+    // STEP 1: The lifted child takes the node's place under its parent
+    int parent = m_nodes[node].parent;
+    m_nodes[lifted].parent = parent;
+    if (parent == NULL_NODE) m_root = lifted;
+    else if (m_nodes[parent].left == node) m_nodes[parent].left = lifted;
+    else m_nodes[parent].right = lifted;
+
+    // STEP 2: The node goes under it, and takes its shorter child
+    m_nodes[lifted].left = node;
+    m_nodes[lifted].right = kept;
+    m_nodes[node].parent = lifted;
+
+    if (m_nodes[node].left == lifted) m_nodes[node].left = given;
+    else m_nodes[node].right = given;
+    m_nodes[given].parent = node;
+
+    fit(node);
+    fit(lifted);
+    return lifted;
+}
+
+// ————— PROXIES ————— //
+int DynamicAabbTree::insert(int item, glm::vec2 min, glm::vec2 max)
+{
+    int leaf = allocate_node();
+    m_nodes[leaf].min = min - FAT_MARGIN;
+    m_nodes[leaf].max = max + FAT_MARGIN;
+    m_nodes[leaf].item = item;
+    m_nodes[leaf].height = 0;
+
+    insert_leaf(leaf);
+    m_leaf_count++;
+    return leaf;
+}
+
+void DynamicAabbTree::remove(int proxy)
+{
+    remove_leaf(proxy);
+    free_node(proxy);
+    m_leaf_count--;
+}
+
+bool DynamicAabbTree::move(int proxy, glm::vec2 min, glm::vec2 max, glm::vec2 displacement)
+{
+    const Node& leaf = m_nodes[proxy];
+    if (min.x >= leaf.min.x && min.y >= leaf.min.y && max.x <= leaf.max.x && max.y <= leaf.max.y) return false;
+
+    remove_leaf(proxy);
+
+    // Stretched the way it's heading, so a steady mover stays inside for a few steps
+    glm::vec2 fat_min = min - FAT_MARGIN,
+              fat_max = max + FAT_MARGIN,
+              ahead   = displacement * DISPLACEMENT_SCALE;
+    if (ahead.x < 0.0f) fat_min.x += ahead.x; else fat_max.x += ahead.x;
+    if (ahead.y < 0.0f) fat_min.y += ahead.y; else fat_max.y += ahead.y;
+
+    m_nodes[proxy].min = fat_min;
+    m_nodes[proxy].max = fat_max;
+    insert_leaf(proxy);
+    m_reinsertions++;
+    return true;
+}
+
+void DynamicAabbTree::clear()
+{
+    m_nodes.clear();
+    m_root = m_free = NULL_NODE;
+    m_leaf_count = 0;
+}
+
+void DynamicAabbTree::query(glm::vec2 min, glm::vec2 max, std::vector<int>& items) const
+{
+    if (m_root == NULL_NODE) return;
+
+    int stack[STACK_DEPTH];
+    int count = 0;
+    stack[count++] = m_root;
+
+    while (count > 0)
+    {
+        const Node& node = m_nodes[stack[--count]];
+        if (node.max.x < min.x || node.min.x > max.x || node.max.y < min.y || node.min.y > max.y) continue;
+
+        if (node.left == NULL_NODE) items.push_back(node.item);
+        else
+        {
+            stack[count++] = node.left;
+            stack[count++] = node.right;
+        }
+    }
+}
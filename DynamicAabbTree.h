@@ -0,0 +1,67 @@
+#pragma once
+
+// A bounding-volume hierarchy for boxes that move every step, where rebuilding a static index
+// would cost more than it saves. Each leaf holds a fattened copy of its box: FAT_MARGIN all round,
+// stretched ahead by how far it last moved. A box that stays inside its fat box costs nothing
+// to move; only one that leaves it is taken out and put back, and just its ancestors are refit.
+// Insertion picks the sibling that grows the tree's perimeter least, and rotations keep the two
+// sides of every node within one level of each other, as AVL trees do.
+//
+// Queries only read, so any number of threads can run them between moves.
+#include <vector>
+#include "glm/vec2.hpp"
+
+class DynamicAabbTree
+{
+public:
+    static constexpr float FAT_MARGIN         = 0.1f,  // world units, all round
+                           DISPLACEMENT_SCALE = 2.0f;  // steps of the last move a fat box reaches ahead
+
+private:
+    static const int NULL_NODE   = -1,
+                     STACK_DEPTH = 64;  // a balanced tree of 2^32 leaves is under 50 deep
+
+    struct Node
+    {
+        glm::vec2 min, max;  // fattened, for a leaf
+        int       parent,    // or the next free node
+                  left, right,
+                  item,      // the caller's, for a leaf
+                  height;    // 0 for a leaf, -1 for a free node
+    };
+
+    std::vector<Node> m_nodes;
+    int m_root       = NULL_NODE,
+        m_free       = NULL_NODE,
+        m_leaf_count = 0;
+    long long m_reinsertions = 0;
+
+    bool const is_leaf(int node) const { return m_nodes[node].left == NULL_NODE; };
+
+    int  allocate_node();
+    void free_node(int node);
+    void insert_leaf(int leaf);
+    void remove_leaf(int leaf);
+    // Refits and rebalances from `node` up to the root
+    void refit_from(int node);
+    int  balance(int node);
+    void fit(int node);
+
+public:
+    // Returns the leaf's proxy, which move() and remove() take
+    int  insert(int item, glm::vec2 min, glm::vec2 max);
+    void remove(int proxy);
+    // Once a step with the box's new bounds and how far it moved since the last call. True if it
+    // left its fat box and was reinserted.
+    bool move(int proxy, glm::vec2 min, glm::vec2 max, glm::vec2 displacement);
+    void clear();
+
+    // Appends the item of every leaf whose fat box overlaps [min, max], in no particular order
+    void query(glm::vec2 min, glm::vec2 max, std::vector<int>& items) const;
+
+    glm::vec2 const get_fat_min(int proxy)  const { return m_nodes[proxy].min; };
+    glm::vec2 const get_fat_max(int proxy)  const { return m_nodes[proxy].max; };
+    int       const get_leaf_count()        const { return m_leaf_count; };
+    int       const get_height()            const { return m_root != NULL_NODE ? m_nodes[m_root].height : 0; };
+    long long const get_reinsertions()      const { return m_reinsertions; };
+};
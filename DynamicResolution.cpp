@@ -0,0 +1,86 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include "DynamicResolution.h"
+
+bool DynamicResolution::initialise(int width, int height, float budget_ms)
+{
+    m_width = width;
+    m_height = height;
+    m_budget_ms = budget_ms;
+    m_scale = MAX_SCALE;
+    m_max_scale = MAX_SCALE;
+    m_smoothed_ms = 0.0f;
+    m_frames_since_change = 0;
+
+    // Allocated once at full size: a new scale is only a smaller viewport into it
+    return m_target.initialise(width, height);
+}
+
+void DynamicResolution::cleanup()
+{
+    m_target.cleanup();
+    m_scale = MAX_SCALE;
+}
+
+void DynamicResolution::update(float gpu_ms)
+{
+    if (!is_enabled() || gpu_ms <= 0.0f) return;
+
+    m_smoothed_ms = m_smoothed_ms == 0.0f ? gpu_ms : m_smoothed_ms + (gpu_ms - m_smoothed_ms) * SMOOTHING;
+    if (++m_frames_since_change < SETTLE_FRAMES) return;
+
+    // The GPU's time goes roughly with the pixel count, i.e. with the square of the scale
+    float ideal = m_scale * std::sqrt(m_budget_ms * HEADROOM / m_smoothed_ms),
+          scale = m_scale;
+
+    if (m_smoothed_ms > m_budget_ms)                    scale = ideal;
+    else if (m_smoothed_ms < m_budget_ms * RAISE_BELOW) scale = std::min(ideal, m_scale + MAX_RAISE);
+
+    scale = std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP;
+    scale = std::min(std::max(scale, MIN_SCALE), m_max_scale);
+    if (scale == m_scale) return;
+
+    // Start measuring afresh: everything so far was drawn at the old scale
+    m_scale = scale;
+    m_smoothed_ms = 0.0f;
+    m_frames_since_change = 0;
+}
+
+void DynamicResolution::set_max_scale(float scale)
+{
+    m_max_scale = std::min(std::max(std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP, MIN_SCALE), MAX_SCALE);
+    if (m_scale == m_max_scale) return;
+
+    m_scale = m_max_scale;
+    m_smoothed_ms = 0.0f;
+    m_frames_since_change = 0;
+}
+
+void DynamicResolution::begin_scene()
+{
+    m_scene_bound = is_enabled() && m_scale < MAX_SCALE;
+    if (!m_scene_bound) return;
+
+    m_target.bind();
+    glViewport(0, 0, get_scene_width(), get_scene_height());
+}
+
+void DynamicResolution::end_scene()
+{
+    if (!m_scene_bound) return;
+    m_scene_bound = false;
+
+    m_target.blit_to_window(get_scene_width(), get_scene_height(), m_width, m_height);
+    glViewport(0, 0, m_width, m_height);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// Renders the world below the window's resolution when the GPU can't keep up, rather than drop
+// frames. The scene goes into the corner of an OffscreenTarget the size of the window, scaled by
+// however much the measured GPU frame time is over budget, and is then stretched over the window
+// with a linear blit. Whatever is drawn after end_scene (the HUD) stays at native resolution.
+//
+// The scale only ever moves after SETTLE_FRAMES: the GPU times arrive GpuProfiler::FRAME_LATENCY
+// frames late, and reacting to numbers from before the last change would only make it hunt.
+#include "OffscreenTarget.h"
+
+class DynamicResolution
+{
+public:
+    static constexpr float MIN_SCALE = 0.5f,
+                           MAX_SCALE = 1.0f;
+
+private:
+    static constexpr float SCALE_STEP    = 0.05f,  // scales are kept to multiples of this
+                           MAX_RAISE     = 0.1f,   // per change: coming back up is done gently
+                           HEADROOM      = 0.9f,   // of the budget, aimed at when changing
+                           RAISE_BELOW   = 0.7f,   // of the budget, before trying a higher scale
+                           SMOOTHING     = 0.1f;
+    static const int       SETTLE_FRAMES = 30;
+
+    OffscreenTarget m_target;
+    int   m_width  = 0,
+          m_height = 0;
+    float m_budget_ms = 0.0f,
+          m_scale     = MAX_SCALE,
+          m_max_scale = MAX_SCALE,  // QualityGovernor's ceiling
+          m_smoothed_ms = 0.0f;  // 0 until the first measurement at the current scale
+    int   m_frames_since_change = 0;
+    bool  m_scene_bound = false;
+
+public:
+    // GL thread. False, leaving everything at native resolution, without framebuffer objects.
+    // width and height are the window's viewport, from its corner.
+    bool initialise(int width, int height, float budget_ms);
+    void cleanup();
+
+    // Once a frame, with the GPU's time for a whole recent frame; 0 (nothing measured) is ignored
+    void update(float gpu_ms);
+
+    // Caps the scale below MAX_SCALE. The scale goes straight to the new ceiling, either way, and
+    // update then steers under it.
+    void set_max_scale(float scale);
+
+    // Around the scene's draws. Both do nothing at full scale, where the scene goes straight to
+    // the window. end_scene leaves the window bound with its full viewport.
+    void begin_scene();
+    void end_scene();
+
+    bool  const is_enabled()       const { return m_target.is_ready(); };
+    float const get_scale()        const { return m_scale; };
+    float const get_max_scale()    const { return m_max_scale; };
+    float const get_smoothed_ms()  const { return m_smoothed_ms; };
+    // The scene's size in pixels this frame
+    int   const get_scene_width()  const { return (int)(m_width * m_scale + 0.5f); };
+    int   const get_scene_height() const { return (int)(m_height * m_scale + 0.5f); };
+};
@@ -0,0 +1,819 @@
+#pragma once
+
+// Generated by ShaderEmbedder (embed_shaders.cpp) from shaders/*.glsl. Do not edit by hand;
+// edit the .glsl and rebuild instead.
+#include <string_view>
+
+struct EmbeddedShader
+{
+    std::string_view path;    // where the source lives in the tree, for the filesystem override
+    std::string_view source;
+};
+
+namespace EmbeddedShaders
+{
+    constexpr EmbeddedShader FRAGMENT =
+    {
+        "shaders/fragment.glsl",
+        "uniform vec4 color;\n"
+        "\n"
+        "void main() {\n"
+        "    gl_FragColor = color;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader FRAGMENT_TEXTURED =
+    {
+        "shaders/fragment_textured.glsl",
+        "\n"
+        "uniform sampler2D diffuse;\n"
+        "varying vec2 texCoordVar;\n"
+        "\n"
+        "void main() {\n"
+        "    gl_FragColor = texture2D(diffuse, texCoordVar);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader GLYPH_FRAGMENT =
+    {
+        "shaders/glyph_fragment.glsl",
+        "// The SDF font sheet, read as sprite_fragment.glsl's SDF variant does, in the glyph's own colour\n"
+        "uniform sampler2D diffuse;\n"
+        "\n"
+        "varying vec2 texCoordVar;\n"
+        "varying vec3 colourVar;\n"
+        "\n"
+        "void main() {\n"
+        "    vec4 colour = texture2D(diffuse, texCoordVar);\n"
+        "\n"
+        "    vec2 distances = vec2(colour.r, colour.a);\n"
+        "    vec2 ramp = max(fwidth(distances) * 0.5, vec2(0.001));\n"
+        "    vec2 coverage = smoothstep(vec2(0.5) - ramp, vec2(0.5) + ramp, distances);\n"
+        "\n"
+        "    gl_FragColor = vec4(colourVar * coverage.x, coverage.y);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader GLYPH_VERTEX =
+    {
+        "shaders/glyph_vertex.glsl",
+        "// One glyph per instance (InstancedText): the unit quad is stretched over the glyph's box from its\n"
+        "// pen position, and its UVs over the glyph's rect, both looked up in the font's table by index.\n"
+        "// Needs GLSL 3.30 for the uniform blocks.\n"
+        "attribute vec2 position;  // a corner of the unit quad, 0 to 1 with y down\n"
+        "\n"
+        "attribute vec2 instancePen;\n"
+        "attribute float instanceSize;\n"
+        "attribute float instanceGlyph;\n"
+        "attribute vec3 instanceColour;\n"
+        "\n"
+        "// InstancedText::GLYPH_TABLE_BINDING; the FontMetrics of every glyph, written once\n"
+        "layout(std140) uniform GlyphTable\n"
+        "{\n"
+        "    vec4 glyphRects[256];  // u, v, width, height\n"
+        "    vec4 glyphBoxes[256];  // bearing x and y, then width and height, in ems\n"
+        "};\n"
+        "\n"
+        "layout(std140) uniform Camera\n"
+        "{\n"
+        "    mat4 viewMatrix;\n"
+        "    mat4 projectionMatrix;\n"
+        "};\n"
+        "\n"
+        "varying vec2 texCoordVar;\n"
+        "varying vec3 colourVar;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    int glyph = int(instanceGlyph);\n"
+        "    vec4 box = glyphBoxes[glyph] * instanceSize;\n"
+        "\n"
+        "    vec2 corner = instancePen + box.xy + vec2(position.x * box.z, -position.y * box.w);\n"
+        "    texCoordVar = glyphRects[glyph].xy + position * glyphRects[glyph].zw;\n"
+        "    colourVar = instanceColour;\n"
+        "\n"
+        "    gl_Position = projectionMatrix * viewMatrix * vec4(corner, 0.0, 1.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader LANDER_COLLECT_GEOMETRY =
+    {
+        "shaders/lander_collect_geometry.glsl",
+        "#version 330 core\n"
+        "// Emits only the landers that have finished, so what transform feedback captures is a packed\n"
+        "// list of episodes rather than the whole batch, and that list is all GpuLanderSim reads back.\n"
+        "layout(points) in;\n"
+        "layout(points, max_vertices = 1) out;\n"
+        "\n"
+        "flat in int collectLander[];\n"
+        "in vec2 collectPosition[];\n"
+        "in vec2 collectVelocity[];\n"
+        "in vec4 collectOutcome[];\n"
+        "\n"
+        "flat out int outLander;\n"
+        "out vec2 outPosition;\n"
+        "out vec2 outVelocity;\n"
+        "out vec4 outOutcome;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    if (collectOutcome[0].x == 0.0) return;  // still flying\n"
+        "\n"
+        "    outLander = collectLander[0];\n"
+        "    outPosition = collectPosition[0];\n"
+        "    outVelocity = collectVelocity[0];\n"
+        "    outOutcome = collectOutcome[0];\n"
+        "    EmitVertex();\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader LANDER_COLLECT_VERTEX =
+    {
+        "shaders/lander_collect_vertex.glsl",
+        "// Hands every lander to lander_collect_geometry.glsl with its index, which the geometry shader\n"
+        "// can't see for itself. Needs GLSL 3.30.\n"
+        "attribute vec2 landerPosition;\n"
+        "attribute vec2 landerVelocity;\n"
+        "attribute vec4 landerOutcome;\n"
+        "\n"
+        "flat varying int collectLander;\n"
+        "varying vec2 collectPosition;\n"
+        "varying vec2 collectVelocity;\n"
+        "varying vec4 collectOutcome;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    collectLander = gl_VertexID;\n"
+        "    collectPosition = landerPosition;\n"
+        "    collectVelocity = landerVelocity;\n"
+        "    collectOutcome = landerOutcome;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader LANDER_STEP_VERTEX =
+    {
+        "shaders/lander_step_vertex.glsl",
+        "// One lander per vertex, stepped once and captured by transform feedback into the other buffer\n"
+        "// (see GpuLanderSim). Nothing is drawn. The arithmetic is BatchedLanderSim::step_lanes_scalar's,\n"
+        "// operation for operation, against platforms fetched from a buffer texture, and the outcome is\n"
+        "// decided in the same pass. A lander that has finished stays as it ended until it's collected.\n"
+        "// Needs GLSL 3.30.\n"
+        "attribute vec2 landerPosition;\n"
+        "attribute vec2 landerVelocity;\n"
+        "attribute vec4 landerOutcome;  // outcome, steps, touchdown speed, episode\n"
+        "attribute vec4 launch;         // spawn position, launch velocity\n"
+        "attribute vec4 controls;       // gravity, movement, booster (0 or 1)\n"
+        "\n"
+        "const float FLYING = 0.0, WON = 1.0, CRASHED = 2.0, OUT_OF_BOUNDS = 3.0, TIMED_OUT = 4.0;  // GpuLanderOutcome\n"
+        "\n"
+        "uniform samplerBuffer platforms;  // two texels each: centre and size, then the win and death flags\n"
+        "uniform int platformCount;\n"
+        "uniform float deltaTime;\n"
+        "uniform vec3 physics;  // speed, drag, boosting power\n"
+        "uniform vec2 landerSize;\n"
+        "uniform vec4 bounds;   // min, max; a min past its max turns them off\n"
+        "uniform int maxSteps;  // 0 for no limit\n"
+        "uniform int relaunch;  // finished landers start their next episode this step\n"
+        "\n"
+        "varying vec2 outPosition;\n"
+        "varying vec2 outVelocity;\n"
+        "varying vec4 outOutcome;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 p = landerPosition, v = landerVelocity;\n"
+        "    vec4 outcome = landerOutcome;\n"
+        "\n"
+        "    if (relaunch != 0 && outcome.x != FLYING)\n"
+        "    {\n"
+        "        p = launch.xy;\n"
+        "        v = launch.zw;\n"
+        "        outcome = vec4(FLYING, 0.0, 0.0, outcome.w + 1.0);\n"
+        "    }\n"
+        "\n"
+        "    if (outcome.x == FLYING)\n"
+        "    {\n"
+        "        bool touchedWin = false, touchedDeath = false;\n"
+        "        float touchdownSpeed = 0.0;\n"
+        "\n"
+        "        // ––––– PHYSICS ––––– //\n"
+        "        float acceleration = controls.y * physics.x;\n"
+        "        if (v.x > 0.0)      acceleration -= physics.y;\n"
+        "        else if (v.x < 0.0) acceleration += physics.y;\n"
+        "\n"
+        "        v.x += acceleration * deltaTime;\n"
+        "        v.y += controls.x * deltaTime;\n"
+        "\n"
+        "        p.y += v.y * deltaTime;\n"
+        "        for (int i = 0; i < platformCount; i++)\n"
+        "        {\n"
+        "            vec4 box = texelFetch(platforms, 2 * i);\n"
+        "            vec2 gap = abs(p - box.xy) - (landerSize + box.zw) / 2.0;\n"
+        "            if (!(gap.x < 0.0 && gap.y < 0.0) || v.y == 0.0) continue;\n"
+        "\n"
+        "            float overlap = abs(abs(p.y - box.y) - (landerSize.y / 2.0) - (box.w / 2.0));\n"
+        "            if (v.y < 0.0)\n"
+        "            {\n"
+        "                vec4 kind = texelFetch(platforms, 2 * i + 1);\n"
+        "                touchdownSpeed = -v.y;\n"
+        "                touchedWin   = touchedWin   || kind.x != 0.0;\n"
+        "                touchedDeath = touchedDeath || kind.y != 0.0;\n"
+        "            }\n"
+        "            p.y = v.y > 0.0 ? p.y - overlap : p.y + overlap;\n"
+        "            v.y = 0.0;\n"
+        "        }\n"
+        "\n"
+        "        p.x += v.x * deltaTime;\n"
+        "        for (int i = 0; i < platformCount; i++)\n"
+        "        {\n"
+        "            vec4 box = texelFetch(platforms, 2 * i);\n"
+        "            vec2 gap = abs(p - box.xy) - (landerSize + box.zw) / 2.0;\n"
+        "            if (!(gap.x < 0.0 && gap.y < 0.0) || v.x == 0.0) continue;\n"
+        "\n"
+        "            float overlap = abs(abs(p.x - box.x) - (landerSize.x / 2.0) - (box.z / 2.0));\n"
+        "            p.x = v.x > 0.0 ? p.x - overlap : p.x + overlap;\n"
+        "            v.x = 0.0;\n"
+        "        }\n"
+        "\n"
+        "        // ––––– BOOSTING ––––– //\n"
+        "        if (controls.z != 0.0) v.y += physics.z;\n"
+        "\n"
+        "        // ––––– OUTCOME ––––– //\n"
+        "        // A touchdown on both kinds at once counts as the landing, as BatchedLanderSim has it\n"
+        "        bool outside = bounds.x <= bounds.z && (p.x < bounds.x || p.x > bounds.z || p.y < bounds.y || p.y > bounds.w);\n"
+        "        outcome.y += 1.0;\n"
+        "        outcome.z = touchdownSpeed;\n"
+        "        if (touchedWin)                                          outcome.x = WON;\n"
+        "        else if (touchedDeath)                                   outcome.x = CRASHED;\n"
+        "        else if (outside)                                        outcome.x = OUT_OF_BOUNDS;\n"
+        "        else if (maxSteps > 0 && outcome.y >= float(maxSteps))   outcome.x = TIMED_OUT;\n"
+        "    }\n"
+        "\n"
+        "    outPosition = p;\n"
+        "    outVelocity = v;\n"
+        "    outOutcome = outcome;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader LIGHTING_FRAGMENT =
+    {
+        "shaders/lighting_fragment.glsl",
+        "// Every light at once, multiplied into what's already drawn (see LightingPass). Light i reads row\n"
+        "// i of the shadow map, in the direction this fragment lies from it: anything further away than\n"
+        "// the distance found there is behind an occluder.\n"
+        "uniform sampler2D shadowMap;\n"
+        "uniform vec4  lights[MAX_LIGHTS];        // xy the position, z the radius\n"
+        "uniform vec3  lightColours[MAX_LIGHTS];\n"
+        "uniform int   lightCount;\n"
+        "uniform float shadowScale;  // how much of each row is in use, across\n"
+        "uniform float ambient;\n"
+        "\n"
+        "varying vec2 worldPosition;\n"
+        "\n"
+        "const float SHADOW_BIAS     = 0.15;  // world units past an occluder's edge that are still lit, so its lit face shows\n"
+        "const float SHADOW_SOFTNESS = 0.1;   // world units a shadow's edge fades over\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 light = vec3(ambient);\n"
+        "    for (int i = 0; i < MAX_LIGHTS; i++)\n"
+        "    {\n"
+        "        if (i >= lightCount) break;\n"
+        "\n"
+        "        vec2  offset = worldPosition - lights[i].xy;\n"
+        "        float radius = lights[i].z;\n"
+        "        float reach  = length(offset) / radius;\n"
+        "        if (reach >= 1.0) continue;\n"
+        "\n"
+        "        vec2  uv = vec2((atan(offset.y, offset.x) / 6.28318531 + 0.5) * shadowScale, (float(i) + 0.5) / float(MAX_LIGHTS));\n"
+        "        float occluder = texture2D(shadowMap, uv).r;\n"
+        "        float lit = clamp(((occluder - reach) * radius + SHADOW_BIAS) / SHADOW_SOFTNESS, 0.0, 1.0);\n"
+        "\n"
+        "        float falloff = 1.0 - reach;\n"
+        "        light += lightColours[i] * (falloff * falloff * lit);\n"
+        "    }\n"
+        "\n"
+        "    // Blended as source * destination * 2, so 0.5 leaves the scene as it was drawn\n"
+        "    gl_FragColor = vec4(light * 0.5, 0.5);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader LIGHTING_VERTEX =
+    {
+        "shaders/lighting_vertex.glsl",
+        "// One triangle over the scene, straight in clip space, as the starfield's. Each fragment gets the\n"
+        "// world position it covers, from the corners of the view.\n"
+        "attribute vec4 position;\n"
+        "\n"
+        "uniform vec2 viewMin;\n"
+        "uniform vec2 viewMax;\n"
+        "\n"
+        "varying vec2 worldPosition;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    worldPosition = mix(viewMin, viewMax, position.xy * 0.5 + 0.5);\n"
+        "    gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader PARTICLE_UPDATE_FRAGMENT =
+    {
+        "shaders/particle_update_fragment.glsl",
+        "// Never runs: the transform feedback passes (GpuParticleSystem, GpuLanderSim) draw with the\n"
+        "// rasterizer off. Only here to make a whole program.\n"
+        "void main()\n"
+        "{\n"
+        "    gl_FragColor = vec4(0.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader PARTICLE_UPDATE_VERTEX =
+    {
+        "shaders/particle_update_vertex.glsl",
+        "// One particle per vertex, aged a frame and captured by transform feedback into the other\n"
+        "// buffer (see GpuParticleSystem). Nothing is drawn. The slots an emit command covers this frame\n"
+        "// are launched afresh instead, their scatter hashed from the slot and the command's seed, so an\n"
+        "// emit costs the CPU a few uniforms however many particles it makes. Needs GLSL 3.30.\n"
+        "attribute vec2 offset;\n"
+        "attribute vec2 velocity;\n"
+        "attribute float age;\n"
+        "\n"
+        "const int MAX_EMITS = 16;  // GpuParticleSystem::MAX_EMITS\n"
+        "\n"
+        "uniform float deltaTime;\n"
+        "uniform float lifetime;\n"
+        "uniform float gravity;\n"
+        "uniform vec2 sizes;  // at birth, at the end of the lifetime\n"
+        "uniform int capacity;\n"
+        "uniform int emitCount;\n"
+        "uniform vec4 emitMotion[MAX_EMITS];  // position, velocity\n"
+        "uniform vec4 emitSlots[MAX_EMITS];   // first slot, slot count, spread, seed\n"
+        "\n"
+        "varying vec2 outOffset;\n"
+        "varying vec2 outScale;\n"
+        "varying vec2 outVelocity;\n"
+        "varying float outAge;\n"
+        "\n"
+        "// -1 to 1\n"
+        "float scatter(uint value)\n"
+        "{\n"
+        "    value = value * 747796405u + 2891336453u;\n"
+        "    value = ((value >> ((value >> 28u) + 4u)) ^ value) * 277803737u;\n"
+        "    value = (value >> 22u) ^ value;\n"
+        "    return float(value) / 2147483647.5 - 1.0;\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 p = offset, v = velocity;\n"
+        "    float a = age;\n"
+        "\n"
+        "    // Later commands win where they overlap, just as a full pool overwrites its oldest\n"
+        "    for (int i = 0; i < emitCount; i++)\n"
+        "    {\n"
+        "        int k = gl_VertexID - int(emitSlots[i].x);\n"
+        "        if (k < 0) k += capacity;\n"
+        "        if (k >= int(emitSlots[i].y)) continue;\n"
+        "\n"
+        "        uint key = uint(gl_VertexID) * 2u + uint(emitSlots[i].w) * 0x9E3779B9u;\n"
+        "        p = emitMotion[i].xy;\n"
+        "        v = emitMotion[i].zw + vec2(scatter(key), scatter(key + 1u)) * emitSlots[i].z;\n"
+        "        a = 0.0;\n"
+        "    }\n"
+        "\n"
+        "    // Constant acceleration, so this is exact at any frame rate\n"
+        "    if (a < lifetime)\n"
+        "    {\n"
+        "        p += v * deltaTime + vec2(0.0, 0.5 * gravity * deltaTime * deltaTime);\n"
+        "        v.y += gravity * deltaTime;\n"
+        "        a += deltaTime;\n"
+        "    }\n"
+        "\n"
+        "    // A dead particle keeps its slot at no size, so the draw covers no pixels for it\n"
+        "    outOffset = p;\n"
+        "    outVelocity = v;\n"
+        "    outAge = a;\n"
+        "    outScale = a < lifetime ? vec2(mix(sizes.x, sizes.y, a / lifetime)) : vec2(0.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader POST_FRAGMENT =
+    {
+        "shaders/post_fragment.glsl",
+        "// Every post-processing pass, picked by PostProcess's #defines. BRIGHT and BLUR are the bloom's\n"
+        "// own passes at a fraction of the size; anything else is the per-pixel passes named, run one after\n"
+        "// another in a single draw: each is a function of the one before it, so no target sits in between.\n"
+        "uniform sampler2D source;  // the scene, or the last pass's output\n"
+        "uniform sampler2D bloom;   // BLOOM: the blurred highlights\n"
+        "uniform vec2 uvScale;      // how much of `source` holds the picture; under 1 when drawn below full size\n"
+        "uniform vec2 texelSize;    // of `source`\n"
+        "\n"
+        "uniform vec2  direction;      // BLUR: one texel along the axis blurred\n"
+        "uniform float threshold;      // BRIGHT: the brightness bloom starts at\n"
+        "uniform float bloomStrength;  // BLOOM\n"
+        "uniform vec2  outputSize;     // CRT: in pixels, for one scanline per pair of them\n"
+        "\n"
+        "varying vec2 texCoordVar;\n"
+        "\n"
+        "vec3 read_source(vec2 uv)\n"
+        "{\n"
+        "    return texture2D(source, uv * uvScale).rgb;\n"
+        "}\n"
+        "\n"
+        "#if defined(BRIGHT)\n"
+        "void main()\n"
+        "{\n"
+        "    // Four bilinear taps average a 4x4 block, so a quarter-size target misses nothing in between\n"
+        "    vec2 uv = texCoordVar;\n"
+        "    vec2 step = texelSize / uvScale;\n"
+        "    vec3 colour = (read_source(uv + vec2(-step.x, -step.y)) + read_source(uv + vec2(step.x, -step.y)) +\n"
+        "                   read_source(uv + vec2(-step.x,  step.y)) + read_source(uv + vec2(step.x,  step.y))) * 0.25;\n"
+        "\n"
+        "    float luma = dot(colour, vec3(0.2126, 0.7152, 0.0722));\n"
+        "    gl_FragColor = vec4(colour * (max(luma - threshold, 0.0) / max(luma, 0.0001)), 1.0);\n"
+        "}\n"
+        "#elif defined(BLUR)\n"
+        "void main()\n"
+        "{\n"
+        "    // A 9-tap Gaussian in five reads: the outer pairs land between texels and let the filtering\n"
+        "    // weigh them\n"
+        "    vec3 colour = read_source(texCoordVar) * 0.2270270270;\n"
+        "    colour += (read_source(texCoordVar + direction * 1.3846153846) + read_source(texCoordVar - direction * 1.3846153846)) * 0.3162162162;\n"
+        "    colour += (read_source(texCoordVar + direction * 3.2307692308) + read_source(texCoordVar - direction * 3.2307692308)) * 0.0702702703;\n"
+        "    gl_FragColor = vec4(colour, 1.0);\n"
+        "}\n"
+        "#else\n"
+        "vec3 colour_at(vec2 uv)\n"
+        "{\n"
+        "    vec3 colour = read_source(uv);\n"
+        "#ifdef BLOOM\n"
+        "    colour += texture2D(bloom, uv).rgb * bloomStrength;\n"
+        "#endif\n"
+        "#ifdef VIGNETTE\n"
+        "    vec2 centred = uv - 0.5;\n"
+        "    colour *= 1.0 - dot(centred, centred) * 0.9;\n"
+        "#endif\n"
+        "    return colour;\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "#ifdef CRT\n"
+        "    // The beam's colours a little apart towards the edges, dark lines between the scanlines and a\n"
+        "    // faint shadow mask across them\n"
+        "    vec2 spread = (texCoordVar - 0.5) * 0.004;\n"
+        "    vec3 colour = vec3(colour_at(texCoordVar + spread).r, colour_at(texCoordVar).g, colour_at(texCoordVar - spread).b);\n"
+        "    colour *= 0.75 + 0.25 * sin(texCoordVar.y * outputSize.y * 3.14159265);\n"
+        "    float column = mod(floor(texCoordVar.x * outputSize.x), 3.0);\n"
+        "    colour *= 0.9 + 0.1 * vec3(equal(vec3(column), vec3(0.0, 1.0, 2.0)));\n"
+        "    colour *= 1.15;\n"
+        "#else\n"
+        "    vec3 colour = colour_at(texCoordVar);\n"
+        "#endif\n"
+        "    gl_FragColor = vec4(colour, 1.0);\n"
+        "}\n"
+        "#endif\n"
+    };
+
+    constexpr EmbeddedShader POST_VERTEX =
+    {
+        "shaders/post_vertex.glsl",
+        "// One triangle over the whole target, straight in clip space (see PostProcess). Every pass reads\n"
+        "// its inputs at texCoordVar, 0-1 over the picture.\n"
+        "attribute vec4 position;\n"
+        "\n"
+        "varying vec2 texCoordVar;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    texCoordVar = position.xy * 0.5 + 0.5;\n"
+        "    gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader SHADOW_MAP_FRAGMENT =
+    {
+        "shaders/shadow_map_fragment.glsl",
+        "// How far the ray through this texel runs from the light before it meets the edge, as a\n"
+        "// fraction of the light's radius. Drawn with GL_MIN blending over a clear of 1.0, so each texel\n"
+        "// ends up holding the nearest edge in its direction, or 1.0 if nothing is in reach.\n"
+        "uniform float angleScale;  // radians per texel: two pi over the texels in use\n"
+        "\n"
+        "varying vec4 edge;\n"
+        "\n"
+        "float cross2(vec2 a, vec2 b)\n"
+        "{\n"
+        "    return a.x * b.y - a.y * b.x;\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    float angle = gl_FragCoord.x * angleScale - 3.14159265;\n"
+        "    vec2 ray = vec2(cos(angle), sin(angle));\n"
+        "    vec2 start = edge.xy;\n"
+        "    vec2 along = edge.zw - edge.xy;\n"
+        "\n"
+        "    // Where the ray crosses the edge, held to its ends: the quad reaches half a texel past them,\n"
+        "    // and a ray that only just misses takes the nearer end\n"
+        "    float facing = cross2(ray, along);\n"
+        "    float s = abs(facing) > 0.00001 ? clamp(cross2(start, ray) / facing, 0.0, 1.0) : 0.0;\n"
+        "    gl_FragColor = vec4(min(length(start + along * s), 1.0));\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader SHADOW_MAP_VERTEX =
+    {
+        "shaders/shadow_map_vertex.glsl",
+        "// One quad per occluder edge and light, already in the shadow map's clip space (see\n"
+        "// LightingPass): across is the angle the edge covers around the light, up is the light's row.\n"
+        "// The edge itself comes along, so each texel can find where its own ray meets it.\n"
+        "attribute vec4 position;\n"
+        "attribute vec4 texCoord;  // the edge's two ends, from the light, in units of its radius\n"
+        "\n"
+        "varying vec4 edge;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    edge = texCoord;\n"
+        "    gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader SPRITE_FRAGMENT =
+    {
+        "shaders/sprite_fragment.glsl",
+        "// Untextured variants draw flat `color`, or each vertex's own under VERTEX_COLOUR; TINTED multiplies the texture by it instead. SDF reads\n"
+        "// the texel as two distance fields (see make_sdf_font.cpp) instead of as a colour, and GLYPHS does\n"
+        "// so only for the quads the vertices mark as glyphs. LAYERED samples one layer of a texture array,\n"
+        "// and only compiles under GLSL 3.30. MATERIAL reads the texel's red as a grey level between the\n"
+        "// instance's shadow and highlight colours, so one greyscale frame serves every look.\n"
+        "#ifdef LAYERED\n"
+        "uniform sampler2DArray diffuse;\n"
+        "flat varying float layerVar;\n"
+        "#elif defined(TEXTURED)\n"
+        "uniform sampler2D diffuse;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef TEXTURED\n"
+        "varying vec2 texCoordVar;\n"
+        "#endif\n"
+        "\n"
+        "#if defined(GLYPHS) && !defined(LAYERED)\n"
+        "varying float glyphVar;\n"
+        "#endif\n"
+        "\n"
+        "#if defined(TINTED) || !defined(TEXTURED)\n"
+        "uniform vec4 color;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef VERTEX_COLOUR\n"
+        "varying vec4 colourVar;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef MATERIAL\n"
+        "varying vec4 shadowVar;\n"
+        "varying vec4 highlightVar;\n"
+        "#endif\n"
+        "\n"
+        "void main() {\n"
+        "#if defined(LAYERED)\n"
+        "    vec4 colour = texture(diffuse, vec3(texCoordVar, layerVar));\n"
+        "#elif defined(TEXTURED)\n"
+        "    vec4 colour = texture2D(diffuse, texCoordVar);\n"
+        "#endif\n"
+        "#ifdef TEXTURED\n"
+        "#if defined(SDF) || (defined(GLYPHS) && !defined(LAYERED))\n"
+        "    // Alpha is the distance to the glyph's outer edge and red the distance to its fill, both 0.5 on\n"
+        "    // the edge. A ramp as wide as one pixel's worth of distance keeps both edges sharp at any size.\n"
+        "    vec2 distances = vec2(colour.r, colour.a);\n"
+        "    vec2 ramp = max(fwidth(distances) * 0.5, vec2(0.001));\n"
+        "    vec2 coverage = smoothstep(vec2(0.5) - ramp, vec2(0.5) + ramp, distances);\n"
+        "#ifdef SDF\n"
+        "    colour = vec4(vec3(coverage.x), coverage.y);\n"
+        "#else\n"
+        "    // Picked rather than branched on, so the derivatives above stay defined for the whole quad\n"
+        "    colour = mix(colour, vec4(vec3(coverage.x), coverage.y), glyphVar);\n"
+        "#endif\n"
+        "#endif\n"
+        "#ifdef MATERIAL\n"
+        "    colour = vec4(mix(shadowVar.rgb, highlightVar.rgb, colour.r), colour.a * shadowVar.a);\n"
+        "#endif\n"
+        "#ifdef TINTED\n"
+        "    colour *= color;\n"
+        "#endif\n"
+        "#elif defined(VERTEX_COLOUR)\n"
+        "    vec4 colour = colourVar;\n"
+        "#else\n"
+        "    vec4 colour = color;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef ALPHA_TEST\n"
+        "    // Cut-out sprites: no blending needed, and the hidden texels never reach the framebuffer\n"
+        "    if (colour.a < 0.5) discard;\n"
+        "#endif\n"
+        "\n"
+        "    gl_FragColor = colour;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader SPRITE_VERTEX =
+    {
+        "shaders/sprite_vertex.glsl",
+        "// One source for every sprite shader. ShaderVariants puts a #define in front for each feature\n"
+        "// bit, so each permutation only carries the attributes and maths it needs.\n"
+        "attribute vec4 position;\n"
+        "\n"
+        "#ifdef TEXTURED\n"
+        "attribute vec2 texCoord;\n"
+        "varying vec2 texCoordVar;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef LAYERED\n"
+        "// Which layer of the texture array the quad samples; the same at every corner\n"
+        "attribute float layer;\n"
+        "flat varying float layerVar;\n"
+        "#elif defined(GLYPHS)\n"
+        "// The same attribute marks a quad as a distance-field glyph (1) rather than a sprite (0)\n"
+        "attribute float layer;\n"
+        "varying float glyphVar;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef VERTEX_COLOUR\n"
+        "attribute vec4 vertexColour;\n"
+        "varying vec4 colourVar;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef INSTANCED\n"
+        "attribute vec2 instanceOffset;\n"
+        "attribute vec2 instanceScale;\n"
+        "attribute vec4 instanceUvRect;\n"
+        "#else\n"
+        "uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)\n"
+        "#endif\n"
+        "\n"
+        "#ifdef MATERIAL\n"
+        "// InstanceMaterials: a tint, and which ramp the grey texel is read along and how the frame is\n"
+        "// mirrored. The ramp is looked up here, since ES 2.0 fragment shaders can't index uniforms freely.\n"
+        "#define PALETTE_SIZE 8  // InstanceMaterials::MAX_PALETTES\n"
+        "attribute vec4 instanceTint;\n"
+        "attribute vec2 instanceMaterial;  // palette, variation\n"
+        "uniform vec3 palette[PALETTE_SIZE * 2];  // shadow, highlight\n"
+        "varying vec4 shadowVar;\n"
+        "varying vec4 highlightVar;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef GLSL_330\n"
+        "// Shared by every variant, and uploaded once when the camera moves (see ShaderVariants)\n"
+        "layout(std140) uniform Camera\n"
+        "{\n"
+        "    mat4 viewMatrix;\n"
+        "    mat4 projectionMatrix;\n"
+        "};\n"
+        "#else\n"
+        "uniform mat4 viewMatrix;\n"
+        "uniform mat4 projectionMatrix;\n"
+        "#endif\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "#ifdef INSTANCED\n"
+        "\tvec4 p = viewMatrix * vec4(position.xy * instanceScale + instanceOffset, 0.0, 1.0);\n"
+        "#else\n"
+        "\tvec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);\n"
+        "#endif\n"
+        "\n"
+        "#if defined(TEXTURED) && defined(INSTANCED) && defined(MATERIAL)\n"
+        "    // Bit 0 of the variation mirrors the frame across u, bit 1 across v\n"
+        "    vec2 mirror = vec2(mod(instanceMaterial.y, 2.0), floor(instanceMaterial.y / 2.0));\n"
+        "    texCoordVar = instanceUvRect.xy + mix(texCoord, vec2(1.0) - texCoord, mirror) * instanceUvRect.zw;\n"
+        "#elif defined(TEXTURED) && defined(INSTANCED)\n"
+        "    texCoordVar = instanceUvRect.xy + texCoord * instanceUvRect.zw;\n"
+        "#elif defined(TEXTURED)\n"
+        "    texCoordVar = texCoord;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef LAYERED\n"
+        "    layerVar = layer;\n"
+        "#elif defined(GLYPHS)\n"
+        "    glyphVar = layer;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef VERTEX_COLOUR\n"
+        "    colourVar = vertexColour;\n"
+        "#endif\n"
+        "\n"
+        "#ifdef MATERIAL\n"
+        "    int ramp = int(instanceMaterial.x) * 2;\n"
+        "    shadowVar = vec4(palette[ramp] * instanceTint.rgb, instanceTint.a);\n"
+        "    highlightVar = vec4(palette[ramp + 1] * instanceTint.rgb, instanceTint.a);\n"
+        "#endif\n"
+        "\n"
+        "\tgl_Position = projectionMatrix * p;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader STARFIELD_FRAGMENT =
+    {
+        "shaders/starfield_fragment.glsl",
+        "// Stars made up on the spot, in LAYERS grids of cells that each hold at most one star at a\n"
+        "// hashed spot. A layer only follows `depth` of the camera's motion, so the far ones (small\n"
+        "// depth, fine and dim) drift behind the near ones. Blended over the clear colour.\n"
+        "uniform vec2 viewMin;\n"
+        "uniform vec2 viewMax;\n"
+        "\n"
+        "varying vec2 worldPosition;\n"
+        "\n"
+        "const int   LAYERS      = 3;\n"
+        "const float STAR_CHANCE = 0.25;  // of a cell holding a star\n"
+        "const vec3  STAR_COLOUR = vec3(0.85, 0.9, 1.0);\n"
+        "\n"
+        "float hash(vec2 cell)\n"
+        "{\n"
+        "    return fract(sin(dot(cell, vec2(127.1, 311.7))) * 43758.5453);\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec2 camera = (viewMin + viewMax) * 0.5;\n"
+        "    float brightness = 0.0;\n"
+        "\n"
+        "    for (int i = 0; i < LAYERS; i++)\n"
+        "    {\n"
+        "        float layer    = float(i);\n"
+        "        float depth    = 0.1 + 0.25 * layer;\n"
+        "        float cellSize = 0.5 + 0.35 * layer;\n"
+        "\n"
+        "        // The layer's own seed keeps its stars from lining up with the others'\n"
+        "        vec2 p    = (worldPosition - camera * (1.0 - depth)) / cellSize + layer * 37.0;\n"
+        "        vec2 cell = floor(p);\n"
+        "        vec2 spot = vec2(hash(cell + 3.1), hash(cell + 7.7)) * 0.8 + 0.1;\n"
+        "\n"
+        "        // Round, and no smaller than a pixel, whatever the zoom\n"
+        "        float pixel  = fwidth(p.x);\n"
+        "        float radius = max((0.015 + 0.01 * layer) / cellSize, pixel);\n"
+        "        float star   = 1.0 - smoothstep(radius - pixel, radius + pixel, length(p - cell - spot));\n"
+        "\n"
+        "        float present = step(1.0 - STAR_CHANCE, hash(cell));\n"
+        "        brightness += star * present * (0.35 + 0.25 * layer) * (0.5 + 0.5 * hash(cell + 11.3));\n"
+        "    }\n"
+        "\n"
+        "    gl_FragColor = vec4(STAR_COLOUR, clamp(brightness, 0.0, 1.0));\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader STARFIELD_VERTEX =
+    {
+        "shaders/starfield_vertex.glsl",
+        "// One triangle over the whole screen, straight in clip space. Each fragment gets the world\n"
+        "// position it covers, from the corners of the view.\n"
+        "attribute vec4 position;\n"
+        "\n"
+        "uniform vec2 viewMin;\n"
+        "uniform vec2 viewMax;\n"
+        "\n"
+        "varying vec2 worldPosition;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    worldPosition = mix(viewMin, viewMax, position.xy * 0.5 + 0.5);\n"
+        "    gl_Position = vec4(position.xy, 0.0, 1.0);\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader VERTEX =
+    {
+        "shaders/vertex.glsl",
+        "attribute vec4 position;\n"
+        "\n"
+        "uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)\n"
+        "uniform mat4 viewMatrix;\n"
+        "uniform mat4 projectionMatrix;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "\tvec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);\n"
+        "\tgl_Position = projectionMatrix * p;\n"
+        "}\n"
+    };
+
+    constexpr EmbeddedShader VERTEX_TEXTURED =
+    {
+        "shaders/vertex_textured.glsl",
+        "attribute vec4 position;\n"
+        "attribute vec2 texCoord;\n"
+        "\n"
+        "uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)\n"
+        "uniform mat4 viewMatrix;\n"
+        "uniform mat4 projectionMatrix;\n"
+        "\n"
+        "varying vec2 texCoordVar;\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "\tvec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);\n"
+        "    texCoordVar = texCoord;\n"
+        "\tgl_Position = projectionMatrix * p;\n"
+        "}"
+    };
+}
@@ -8,225 +8,788 @@
 * Academic Misconduct.
 **/
 
-#define GL_SILENCE_DEPRECATION
-#define STB_IMAGE_IMPLEMENTATION
-
-#ifdef _WINDOWS
-#include <GL/glew.h>
-#endif
-
-#define GL_GLEXT_PROTOTYPES 1
-#include <SDL.h>
-#include <SDL_opengl.h>
+// Physics only: no SDL or GL in here, so this builds into the headless simulator too.
+// Drawing lives in EntityRender.cpp.
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
 #include "glm/mat4x4.hpp"
-#include "glm/gtc/matrix_transform.hpp"
-#include "ShaderProgram.h"
+#include "CollisionResponse.h"
+#include "FuelModel.h"
+#include "DistanceField.h"
+#include "GameEvents.h"
+#include "PlatformBroadphase.h"
+#include "PlatformColliders.h"
+#include "Terrain.h"
+#include "Trace.h"
 #include "Entity.h"
 
+// Where resolve_field samples the field, in half-extents from our centre: the corners first,
+// then the middle of each side, so a spike narrower than we are can't slip between two corners
+const glm::vec2 HULL_POINTS[] = { glm::vec2(-1.0f, -1.0f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f, 1.0f), glm::vec2(-1.0f, 1.0f),
+                                  glm::vec2(0.0f, -1.0f),  glm::vec2(1.0f, 0.0f),  glm::vec2(0.0f, 1.0f), glm::vec2(-1.0f, 0.0f) };
+const int   FIELD_ITERATIONS = 3;     // pushes per step, enough to settle into a corner
+const float FLOOR_NORMAL_Y   = 0.7f;  // a contact this close to straight up is ground we stand on
+
+// The Entity array seen through PlatformColliders' accessors, for callers without a packed copy
+struct EntityBoxes
+{
+    const Entity* entities;
+    int           count;
+
+    int           const get_count()                const { return count; };
+    PhysicsScalar const get_x(int index)           const { return entities[index].get_physics_position().x; };
+    PhysicsScalar const get_y(int index)           const { return entities[index].get_physics_position().y; };
+    PhysicsScalar const get_width(int index)       const { return entities[index].get_physics_width(); };
+    PhysicsScalar const get_height(int index)      const { return entities[index].get_physics_height(); };
+    EntityType    const get_entity_type(int index) const { return entities[index].get_entity_type(); };
+    bool          const is_active(int index)       const { return entities[index].is_active(); };
+};
+
 Entity::Entity()
 {
     // ––––– PHYSICS ––––– //
-    m_position = glm::vec3(0.0f);
-    m_velocity = glm::vec3(0.0f);
-    m_acceleration = glm::vec3(0.0f);
+    m_position = PhysicsVec3(glm::vec3(0.0f));
+    m_velocity = PhysicsVec3(glm::vec3(0.0f));
+    m_acceleration = PhysicsVec3(glm::vec3(0.0f));
+    m_field_acceleration = PhysicsVec3(glm::vec3(0.0f));
 
     // ––––– TRANSLATION ––––– //
     m_movement = glm::vec3(0.0f);
-    m_speed = 0;
-    m_model_matrix = glm::mat4(1.0f);
+    m_speed = 0.0f;
 }
 
-Entity::~Entity()
+void Entity::update(float delta_time, Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events, const PlatformBroadphase* broadphase,
+                    const PlatformColliders* colliders, double* collision_seconds, const Terrain* terrain, const DistanceField* field)
 {
-    delete[] m_animation_up;
-    delete[] m_animation_down;
-    delete[] m_animation_left;
-    delete[] m_animation_right;
-    delete[] m_walking;
-}
-
-void Entity::draw_sprite_from_texture_atlas(ShaderProgram* program, GLuint texture_id, int index)
-{
-    // Step 1: Calculate the UV location of the indexed frame
-    float u_coord = (float)(index % m_animation_cols) / (float)m_animation_cols;
-    float v_coord = (float)(index / m_animation_cols) / (float)m_animation_rows;
-
-    // Step 2: Calculate its UV size
-    float width = 1.0f / (float)m_animation_cols;
-    float height = 1.0f / (float)m_animation_rows;
-
-    // Step 3: Just as we have done before, match the texture coordinates to the vertices
-    float tex_coords[] =
-    {
-        u_coord, v_coord + height, u_coord + width, v_coord + height, u_coord + width, v_coord,
-        u_coord, v_coord + height, u_coord + width, v_coord, u_coord, v_coord
-    };
-
-    float vertices[] =
+    if (m_body_type == DYNAMIC_BODY)
     {
-        -0.5, -0.5, 0.5, -0.5,  0.5, 0.5,
-        -0.5, -0.5, 0.5,  0.5, -0.5, 0.5
-    };
-
-    // Step 4: And render
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+        switch (m_integrator)
+        {
+        case EXPLICIT_EULER:
+            update_dynamic<EXPLICIT_EULER>(delta_time, collidable_entities, collidable_entity_count, events, broadphase, colliders, collision_seconds, terrain, field);
+            break;
+        case SEMI_IMPLICIT_EULER:
+            update_dynamic<SEMI_IMPLICIT_EULER>(delta_time, collidable_entities, collidable_entity_count, events, broadphase, colliders, collision_seconds, terrain, field);
+            break;
+        case VELOCITY_VERLET:
+            update_dynamic<VELOCITY_VERLET>(delta_time, collidable_entities, collidable_entity_count, events, broadphase, colliders, collision_seconds, terrain, field);
+            break;
+        }
+        return;
+    }
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    // Static bodies never move, and kinematic ones only coast
+    if (!m_is_active || m_body_type == STATIC_BODY) return;
 
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    m_previous_position = glm::vec3(m_position);
+    m_position += m_velocity * PhysicsScalar(delta_time);
 }
 
-void Entity::update(float delta_time, Entity* collidable_entities, int collidable_entity_count, bool &win, bool &loss)
+template <Integrator INTEGRATOR>
+void Entity::update_dynamic(float delta_time, Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events, const PlatformBroadphase* broadphase,
+                            const PlatformColliders* colliders, double* collision_seconds, const Terrain* terrain, const DistanceField* field)
 {
     if (!m_is_active) return;
+    TRACE_ZONE("Entity::update");
 
+    // A scrape is only news on the step it starts
+    bool was_against_side = m_collided_left || m_collided_right;
     m_collided_top = false;
     m_collided_bottom = false;
     m_collided_left = false;
     m_collided_right = false;
+    m_contact_count = 0;
 
     // ––––– ANIMATION ––––– //
-    if (m_animation_indices != NULL)
+    if (m_booster_clip != NO_CLIP)
     {
         if (m_velocity.y > 1)
         {
-            m_animation_indices = m_booster[HIGH];
+            m_animator.play(m_booster_clip + HIGH);
         }
         else if (m_velocity.y > 0)
         {
-            m_animation_indices = m_booster[LOW];
+            m_animator.play(m_booster_clip + LOW);
         }
         else
         {
-            m_animation_indices = m_booster[IDLE];
+            m_animator.play(m_booster_clip + IDLE);
         }
     }
 
     // ––––– PHYSICS ––––– //
-    m_acceleration.x = m_movement.x * m_speed;
+    // Converted once here, so everything below stays in PhysicsScalar
+    PhysicsScalar step = delta_time;
+
+    // Summed in a local and stored once, so the velocity change below reads it from a register
+    // rather than half-forwarded from this store
+    PhysicsScalar acceleration_x = PhysicsScalar(m_movement.x) * m_speed;
     if (m_velocity.x > 0)
     {
-        m_acceleration.x -= m_drag;
+        acceleration_x -= m_drag;
     }
     else if (m_velocity.x < 0)
     {
-        m_acceleration.x += m_drag;
+        acceleration_x += m_drag;
     }
+    m_acceleration.x = acceleration_x;
+
+    // A fuelled booster burns the step's fuel up front; when its kick lands is up to the integrator
+    bool had_fuel = m_fuel > 0.0f;
+    PhysicsScalar engine_kick = m_booster_active && m_thrust > 0.0f ? burn_fuel(step) : PhysicsScalar(0.0f);
 
-    m_velocity += m_acceleration * delta_time;
+    // The rate integrators fold the booster and drag into one kick; Euler keeps its own order
+    PhysicsVec3 kick = INTEGRATOR == EXPLICIT_EULER ? (m_acceleration + m_field_acceleration) * step : get_rate_kick(step, INTEGRATOR, engine_kick);
+    m_velocity += kick;
+
+    m_previous_position = glm::vec3(m_position);
+    glm::vec2 velocity_in = glm::vec2(glm::vec3(m_velocity));
+    bool win  = false,
+         loss = false;
+
+    {
+        TRACE_ZONE("collision");
+        std::chrono::steady_clock::time_point collision_start;
+        if (collision_seconds != NULL) collision_start = std::chrono::steady_clock::now();
 
-    m_position.y += m_velocity.y * delta_time;
-    check_collision_y(collidable_entities, collidable_entity_count, win, loss);
+        if (colliders != NULL) move_and_collide<INTEGRATOR>(*colliders, step, win, loss, broadphase, terrain, field);
+        else                   move_and_collide<INTEGRATOR>(EntityBoxes{ collidable_entities, collidable_entity_count }, step, win, loss, broadphase, terrain, field);
 
-    m_position.x += m_velocity.x * delta_time;
-    check_collision_x(collidable_entities, collidable_entity_count);
+        if (collision_seconds != NULL) *collision_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - collision_start).count();
+    }
 
     // ––––– BOOSTING ––––– //
-    if (m_booster_active)
+    if (INTEGRATOR == EXPLICIT_EULER && m_booster_active)
+    {
+        m_velocity.y += m_thrust > 0.0f ? engine_kick : m_boosting_power * m_throttle;
+    }
+
+    // Verlet's second half-kick, on any axis a collision didn't just bring to a stop
+    if (INTEGRATOR == VELOCITY_VERLET)
+    {
+        if (!m_collided_left && !m_collided_right) m_velocity.x += kick.x;
+        if (!m_collided_top && !m_collided_bottom) m_velocity.y += kick.y;
+    }
+
+    // ––––– EVENTS ––––– //
+    if (events != NULL)
+    {
+        if (win)  push_touchdown(*events, true, velocity_in);
+        if (loss) push_touchdown(*events, false, velocity_in);
+        if ((m_collided_left || m_collided_right) && !was_against_side) push_scrape(*events, velocity_in);
+        if (had_fuel && m_burn_rate > 0.0f && !(m_fuel > 0.0f))
+        {
+            events->push(EVENT_FUEL_EMPTY, m_entity_type, -1, glm::length(glm::vec2(glm::vec3(m_velocity))), glm::vec2(glm::vec3(m_position)));
+        }
+    }
+}
+
+void Entity::push_touchdown(GameEventBuffer& events, bool win, glm::vec2 velocity) const
+{
+    // The floor contact that decided it: a pad and a hazard touched in one step get one each
+    int platform = -1;
+    for (int i = 0; i < m_contact_count && platform < 0; i++)
+    {
+        if (m_contacts[i].normal.y > 0.0f && (m_contacts[i].platform_type == WIN_PLATFORM) == win) platform = m_contacts[i].index;
+    }
+    events.push(win ? EVENT_LANDED : EVENT_CRASHED, win ? WIN_PLATFORM : DEATH_PLATFORM, platform, std::max(-velocity.y, 0.0f),
+                glm::vec2(glm::vec3(m_position)));
+}
+
+void Entity::push_scrape(GameEventBuffer& events, glm::vec2 velocity) const
+{
+    for (int i = 0; i < m_contact_count; i++)
     {
-        m_velocity.y += m_boosting_power;
+        if (m_contacts[i].normal.x == 0.0f) continue;
+        events.push(EVENT_SCRAPE, m_contacts[i].platform_type, m_contacts[i].index, fabs(velocity.x), glm::vec2(glm::vec3(m_position)));
+        return;
     }
+}
+
+template void Entity::update_dynamic<EXPLICIT_EULER>(float, Entity*, int, GameEventBuffer*, const PlatformBroadphase*, const PlatformColliders*, double*, const Terrain*, const DistanceField*);
+template void Entity::update_dynamic<SEMI_IMPLICIT_EULER>(float, Entity*, int, GameEventBuffer*, const PlatformBroadphase*, const PlatformColliders*, double*, const Terrain*, const DistanceField*);
+template void Entity::update_dynamic<VELOCITY_VERLET>(float, Entity*, int, GameEventBuffer*, const PlatformBroadphase*, const PlatformColliders*, double*, const Terrain*, const DistanceField*);
 
-    // ––––– TRANSFORMATIONS ––––– //
-    m_model_matrix = glm::mat4(1.0f);
-    m_model_matrix = glm::translate(m_model_matrix, m_position);
+PhysicsVec3 Entity::get_rate_kick(PhysicsScalar step, Integrator integrator, PhysicsScalar engine_kick) const
+{
+    PhysicsVec3 acceleration = m_acceleration + m_field_acceleration;
+    if (m_booster_active) acceleration.y += m_thrust > 0.0f ? engine_kick / step : m_boosting_power * m_throttle / PhysicsScalar(BOOST_REFERENCE_TIMESTEP);
+
+    // Coasting, drag only slows: where it would carry us through zero this step, it stops us
+    // there instead, which keeps long steps from flipping our direction every step
+    PhysicsScalar coasted_x = m_velocity.x + acceleration.x * step;
+    if (m_movement.x == 0.0f && ((m_velocity.x > 0 && coasted_x < 0) || (m_velocity.x < 0 && coasted_x > 0)))
+    {
+        acceleration.x = -m_velocity.x / step;
+    }
+
+    // Verlet moves at the step's average velocity: half the kick before the move, half after
+    PhysicsVec3 kick = acceleration * step;
+    if (integrator == VELOCITY_VERLET) kick /= PhysicsScalar(2.0f);
+    return kick;
+}
+
+PhysicsScalar Entity::burn_fuel(PhysicsScalar step)
+{
+    // Throttled back, the rocket pushes and burns in the same proportion
+    PhysicsScalar mass      = m_dry_mass + m_fuel,
+                  thrust    = m_thrust * m_throttle,
+                  burn_rate = m_burn_rate * m_throttle;
+    if (!(m_burn_rate > 0.0f)) return burn_velocity_change(thrust, burn_rate, mass, step);
+    if (!(m_fuel > 0.0f))      return 0.0f;
+
+    PhysicsScalar burn_time = std::min(step, m_fuel / burn_rate);
+    PhysicsScalar kick = burn_velocity_change(thrust, burn_rate, mass, burn_time);
+    m_fuel = std::max(m_fuel - burn_rate * burn_time, PhysicsScalar(0.0f));
+    return kick;
 }
 
-void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count, bool &win, bool& loss)
+float const Entity::get_engine_acceleration(float boosting_timestep) const
 {
-    for (int i = 0; i < collidable_entity_count; i++)
+    if (!(m_thrust > 0.0f)) return (float)(m_boosting_power * m_throttle) / boosting_timestep;
+    if (m_burn_rate > 0.0f && !(m_fuel > 0.0f)) return 0.0f;
+    return (float)(m_thrust * m_throttle) / (float)(m_dry_mass + m_fuel);
+}
+
+void Entity::save_state(BodyState& state) const
+{
+    state.position = m_position;
+    state.velocity = m_velocity;
+    state.acceleration = m_acceleration;
+    state.field_acceleration = m_field_acceleration;
+    state.previous_position = m_previous_position;
+    state.movement = m_movement;
+
+    state.speed = m_speed;
+    state.width = m_width;
+    state.height = m_height;
+    state.boosting_power = m_boosting_power;
+    state.drag = m_drag;
+    state.throttle = m_throttle;
+    state.thrust = m_thrust;
+    state.burn_rate = m_burn_rate;
+    state.dry_mass = m_dry_mass;
+    state.fuel = m_fuel;
+
+    state.animation_clip = m_animator.clip;
+    state.animation_frame = m_animator.frame;
+    state.animation_time = m_animator.time;
+    state.entity_type = (unsigned char)m_entity_type;
+    state.body_type = (unsigned char)m_body_type;
+    state.integrator = (unsigned char)m_integrator;
+
+    state.active = m_is_active;
+    state.booster_active = m_booster_active;
+    state.continuous_collision = m_continuous_collision;
+    state.collided_top = m_collided_top;
+    state.collided_bottom = m_collided_bottom;
+    state.collided_left = m_collided_left;
+    state.collided_right = m_collided_right;
+}
+
+void Entity::restore_state(const BodyState& state)
+{
+    m_position = state.position;
+    m_velocity = state.velocity;
+    m_acceleration = state.acceleration;
+    m_field_acceleration = state.field_acceleration;
+    m_previous_position = state.previous_position;
+    m_movement = state.movement;
+
+    m_speed = state.speed;
+    m_width = state.width;
+    m_height = state.height;
+    m_boosting_power = state.boosting_power;
+    m_drag = state.drag;
+    m_throttle = state.throttle;
+    m_thrust = state.thrust;
+    m_burn_rate = state.burn_rate;
+    m_dry_mass = state.dry_mass;
+    m_fuel = state.fuel;
+
+    m_animator.clip = state.animation_clip;
+    m_animator.frame = state.animation_frame;
+    m_animator.time = state.animation_time;
+    m_entity_type = (EntityType)state.entity_type;
+    m_body_type = (BodyType)state.body_type;
+    m_integrator = (Integrator)state.integrator;
+
+    m_is_active = state.active;
+    m_booster_active = state.booster_active;
+    m_continuous_collision = state.continuous_collision;
+    m_collided_top = state.collided_top;
+    m_collided_bottom = state.collided_bottom;
+    m_collided_left = state.collided_left;
+    m_collided_right = state.collided_right;
+}
+
+glm::vec4 const Entity::get_frame_uv_rect(int index) const
+{
+    // Precomputed by the sheet's table, so nothing left to work out
+    if (m_frame_uv_rects != NULL) return m_frame_uv_rects[index];
+
+    // Step 1: Calculate the UV location of the indexed frame
+    float u_coord = (float)(index % m_animation_cols) / (float)m_animation_cols;
+    float v_coord = (float)(index / m_animation_cols) / (float)m_animation_rows;
+
+    // Step 2: Calculate its UV size
+    float width = 1.0f / (float)m_animation_cols;
+    float height = 1.0f / (float)m_animation_rows;
+
+    // Step 3: Map the frame into the sheet's sub-rect, in case it shares its texture with other sheets
+    return glm::vec4(m_uv_rect.x + u_coord * m_uv_rect.z, m_uv_rect.y + v_coord * m_uv_rect.w,
+                     width * m_uv_rect.z, height * m_uv_rect.w);
+}
+
+void Entity::collect_candidates(const PlatformBroadphase* broadphase)
+{
+    // Padded slightly so that rounding in the broadphase's own box maths can never drop a
+    // platform that check_collision would count as touching
+    glm::vec2 half_size = glm::vec2((float)m_width, (float)m_height) / 2.0f + BROADPHASE_MARGIN;
+    broadphase->query(glm::vec2(m_position) - half_size, glm::vec2(m_position) + half_size, m_candidates, m_broadphase_cursor);
+}
+
+void Entity::add_contact(int index, glm::vec2 normal, PhysicsScalar depth, EntityType platform_type)
+{
+    if (m_contact_count == MAX_CONTACTS) return;
+    m_contacts[m_contact_count++] = { index, normal, (float)depth, platform_type };
+}
+
+void Entity::record_contact(bool resolved, int index, glm::vec2 normal, PhysicsScalar depth, EntityType platform_type)
+{
+    // The slot past the last contact is always free to scribble on, the spare one included
+    m_contacts[m_contact_count] = { index, normal, (float)depth, platform_type };
+    m_contact_count += (int)(resolved & (m_contact_count < MAX_CONTACTS));
+}
+
+template <typename Boxes>
+int Entity::gather_candidates(const Boxes& boxes, const PlatformBroadphase* broadphase, const int*& indices)
+{
+    if (broadphase != NULL)
     {
-        // STEP 1: For every entity that our player can collide with...
-        Entity* collidable_entity = &collidable_entities[i];
+        collect_candidates(broadphase);
+        indices = m_candidates.data();
+        return (int)m_candidates.size();
+    }
+
+    indices = NULL;
+    return boxes.get_count();
+}
+
+int Entity::gather_candidates(const PlatformColliders& colliders, const PlatformBroadphase* broadphase, const int*& indices)
+{
+    if (broadphase != NULL) return gather_candidates<PlatformColliders>(colliders, broadphase, indices);
+
+    glm::vec2 position  = glm::vec2(m_position),
+              half_size = glm::vec2((float)m_width, (float)m_height) / 2.0f + BROADPHASE_MARGIN;
+    glm::vec2 min = position - half_size,
+              max = position + half_size;
+
+    bool inside = min.x >= m_cache_min.x && min.y >= m_cache_min.y && max.x <= m_cache_max.x && max.y <= m_cache_max.y;
 
-        if (check_collision(collidable_entity))
+    // A pass resolves at most one overlap and then has zero velocity along its axis, so nothing
+    // outside the box we start from can matter; the cache only has to cover that box
+    if (!inside || m_cache_source != &colliders || m_cache_version != colliders.get_version() || m_cache_edits != colliders.get_edits())
+    {
+        m_cache_source = &colliders;
+        m_cache_version = colliders.get_version();
+        m_cache_edits = colliders.get_edits();
+        m_cache_min = min - CONTACT_CACHE_MARGIN;
+        m_cache_max = max + CONTACT_CACHE_MARGIN;
+
+        // In ascending order, so cached passes resolve in the same order as full ones. Movers
+        // are always kept, since they can come to us.
+        const std::vector<int>& movers = colliders.get_movers();
+        size_t next_mover = 0;
+
+        m_cached_candidates.clear();
+        for (int i = 0; i < colliders.get_count(); i++)
         {
-            // STEP 2: Calculate the distance between its centre and our centre
-            //         and use that to calculate the amount of overlap between
-            //         both bodies.
-            float y_distance = fabs(m_position.y - collidable_entity->m_position.y);
-            float y_overlap = fabs(y_distance - (m_height / 2.0f) - (collidable_entity->m_height / 2.0f));
-
-            // STEP 3: "Unclip" ourselves from the other entity, and zero our
-            //         vertical velocity.
-            if (m_velocity.y > 0) {
-                m_position.y -= y_overlap;
-                m_velocity.y = 0;
-                m_collided_top = true;
-            }
-            else if (m_velocity.y < 0) {
-                m_position.y += y_overlap;
-                m_velocity.y = 0;
-                m_collided_bottom = true;
-                
-                if (collidable_entity->get_entity_type() == WIN_PLATFORM)
-                {
-                    win = true;
-                }
-                else if (collidable_entity->get_entity_type() == DEATH_PLATFORM)
-                {
-                    loss = true;
-                }
+            if (next_mover < movers.size() && movers[next_mover] == i)
+            {
+                m_cached_candidates.push_back(i);
+                next_mover++;
+                continue;
             }
+
+            float half_width  = (float)colliders.get_width(i) / 2.0f,
+                  half_height = (float)colliders.get_height(i) / 2.0f;
+            float x = (float)colliders.get_x(i),
+                  y = (float)colliders.get_y(i);
+
+            if (x + half_width < m_cache_min.x || x - half_width > m_cache_max.x) continue;
+            if (y + half_height < m_cache_min.y || y - half_height > m_cache_max.y) continue;
+
+            m_cached_candidates.push_back(i);
         }
     }
+
+    indices = m_cached_candidates.data();
+    return (int)m_cached_candidates.size();
 }
 
-void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count)
+#ifndef LANDER_FIXED_POINT
+int Entity::find_overlap_batched(const PlatformColliders& colliders, const int* indices, int start, int count) const
+{
+    static const OverlapKernel kernel = get_overlap_kernel();
+    OverlapBoxes boxes = colliders.get_overlap_boxes();
+
+    for (int k = start; k < count; k += OVERLAP_KERNEL_BATCH)
+    {
+        uint32_t mask = kernel(boxes, indices + k, std::min(OVERLAP_KERNEL_BATCH, count - k), m_position.x, m_position.y, m_width, m_height);
+        if (mask != 0) return k + lowest_set_bit(mask);
+    }
+    return count;
+}
+#endif
+
+template <typename Boxes>
+int Entity::skip_to_overlap(const Boxes& boxes, const int* indices, int start, int count, bool batched) const
 {
-    for (int i = 0; i < collidable_entity_count; i++)
+    if constexpr (std::is_same_v<Boxes, PlatformColliders>)
     {
-        Entity* collidable_entity = &collidable_entities[i];
+#ifndef LANDER_FIXED_POINT
+        // Fixed point compares in its own arithmetic, which the float kernels can't reproduce
+        if (batched) return find_overlap_batched(boxes, indices, start, count);
+#else
+        (void)boxes; (void)indices; (void)count; (void)batched;
+#endif
+    }
+    else
+    {
+        // Only PlatformColliders packs its boxes the way the kernels read them
+        assert(!batched);
+    }
+    return start;
+}
+
+template <Integrator INTEGRATOR, typename Boxes>
+void Entity::move_and_collide(const Boxes& boxes, PhysicsScalar step, bool& win, bool& loss, const PlatformBroadphase* broadphase,
+                              const Terrain* terrain, const DistanceField* field)
+{
+    // With continuous collision on, a platform crossed between the old and new position is
+    // caught by the sweep; the discrete check still handles anything we already overlap.
+    // Everything under the terrain is solid, so it needs no sweep. The rate integrators' longer
+    // steps sweep on their own, but only along an axis moving over half our size this step.
+    const bool rate_integrator = INTEGRATOR != EXPLICIT_EULER;
+    bool sweep_y = m_continuous_collision || (rate_integrator && fabs(m_velocity.y * step) > m_height / 2.0f),
+         sweep_x = m_continuous_collision || (rate_integrator && fabs(m_velocity.x * step) > m_width / 2.0f);
+
+    PhysicsScalar start_y = m_position.y;
+    m_position.y += m_velocity.y * step;
+    if (!sweep_y || !sweep_collision(1, start_y, boxes, win, loss, broadphase))
+    {
+        resolve_y(boxes, win, loss, broadphase);
+    }
+    if (terrain != NULL) resolve_terrain_y(*terrain, win, loss);
+
+    PhysicsScalar start_x = m_position.x;
+    m_position.x += m_velocity.x * step;
+    if (!sweep_x || !sweep_collision(0, start_x, boxes, win, loss, broadphase))
+    {
+        resolve_x(boxes, broadphase);
+    }
+    if (terrain != NULL) resolve_terrain_x(*terrain, start_x);
 
-        if (check_collision(collidable_entity))
+    // The field's normals already point the way out, diagonals included, so it takes both axes at once
+    if (field != NULL) resolve_field(*field, win, loss);
+}
+
+void Entity::resolve_terrain_y(const Terrain& terrain, bool& win, bool& loss)
+{
+    if (!m_is_active) return;
+
+    // STEP 1: The highest ground under our width, from just the samples beneath us
+    float half_width = (float)m_width / 2.0f,
+          x = (float)m_position.x;
+    EntityType ground_type;
+    float ground = terrain.get_max_height(x - half_width, x + half_width, ground_type);
+
+    // Compared in float first: off the terrain, ground is -infinity, which fixed point can't hold
+    PhysicsScalar bottom = m_position.y - m_height / 2.0f;
+    if (!(ground > (float)bottom)) return;
+    PhysicsScalar overlap = PhysicsScalar(ground) - bottom;
+
+    // STEP 2: "Unclip" ourselves upward and zero any fall, then score it like a platform
+    m_position.y += overlap;
+    if (m_velocity.y < 0) m_velocity.y = 0;
+    m_collided_bottom = true;
+    add_contact(Terrain::CONTACT_INDEX, glm::vec2(0.0f, 1.0f), overlap, ground_type);
+
+    if (ground_type == WIN_PLATFORM) win = true;
+    else                             loss = true;
+}
+
+void Entity::resolve_terrain_x(const Terrain& terrain, PhysicsScalar start_x)
+{
+    if (!m_is_active || m_position.x == start_x) return;
+
+    float half_width = (float)m_width / 2.0f,
+          x = (float)m_position.x;
+    EntityType ground_type;
+    float ground = terrain.get_max_height(x - half_width, x + half_width, ground_type);
+    if (!(ground > (float)(m_position.y - m_height / 2.0f))) return;
+
+    // The slope is too steep to have been stepped onto: stop where we were, as against a wall
+    PhysicsScalar depth = fabs(m_position.x - start_x);
+    bool moving_right = m_position.x > start_x;
+
+    m_position.x = start_x;
+    m_velocity.x = 0;
+    if (moving_right) m_collided_right = true;
+    else              m_collided_left = true;
+    add_contact(Terrain::CONTACT_INDEX, glm::vec2(moving_right ? -1.0f : 1.0f, 0.0f), depth, ground_type);
+}
+
+void Entity::resolve_field(const DistanceField& field, bool& win, bool& loss)
+{
+    if (!m_is_active) return;
+
+    glm::vec2 half_extents((float)m_width / 2.0f, (float)m_height / 2.0f);
+    bool landed = false;
+
+    for (int iteration = 0; iteration < FIELD_ITERATIONS; iteration++)
+    {
+        // STEP 1: The hull point deepest in rock, if any is
+        glm::vec2 centre((float)m_position.x, (float)m_position.y),
+                  deepest_point;
+        float     deepest = 0.0f;
+        for (const glm::vec2& offset : HULL_POINTS)
         {
-            float x_distance = fabs(m_position.x - collidable_entity->m_position.x);
-            float x_overlap = fabs(x_distance - (m_width / 2.0f) - (collidable_entity->m_width / 2.0f));
-            if (m_velocity.x > 0) {
-                m_position.x -= x_overlap;
-                m_velocity.x = 0;
-                m_collided_right = true;
-            }
-            else if (m_velocity.x < 0) {
-                m_position.x += x_overlap;
-                m_velocity.x = 0;
-                m_collided_left = true;
+            glm::vec2 point = centre + offset * half_extents;
+            float distance = field.get_distance(point);
+            if (distance < deepest)
+            {
+                deepest = distance;
+                deepest_point = point;
             }
         }
+        if (deepest >= 0.0f) break;
+
+        // STEP 2: "Unclip" ourselves along the way out, and drop whatever velocity heads back in
+        glm::vec2 normal = field.get_normal(deepest_point);
+        float depth = -deepest;
+        m_position.x += PhysicsScalar(normal.x * depth);
+        m_position.y += PhysicsScalar(normal.y * depth);
+
+        float into = (float)m_velocity.x * normal.x + (float)m_velocity.y * normal.y;
+        if (into < 0.0f)
+        {
+            m_velocity.x -= PhysicsScalar(normal.x * into);
+            m_velocity.y -= PhysicsScalar(normal.y * into);
+        }
+
+        if      (normal.y >=  FLOOR_NORMAL_Y) { m_collided_bottom = true; landed = true; }
+        else if (normal.y <= -FLOOR_NORMAL_Y) m_collided_top = true;
+        else if (normal.x > 0.0f)             m_collided_left = true;
+        else                                  m_collided_right = true;
+        add_contact(DistanceField::CONTACT_INDEX, normal, PhysicsScalar(depth), field.get_rock_type(deepest_point));
     }
+
+    // STEP 3: Like a platform, a landing only wins with the whole of our base over winning rock
+    if (!landed) return;
+
+    glm::vec2 centre((float)m_position.x, (float)m_position.y);
+    bool on_pad = true;
+    for (const glm::vec2& offset : HULL_POINTS)
+    {
+        if (offset.y < 0.0f && field.get_rock_type(centre + offset * half_extents) != WIN_PLATFORM) on_pad = false;
+    }
+
+    if (on_pad) win = true;
+    else        loss = true;
 }
 
-void Entity::render(ShaderProgram* program)
+template <typename Boxes>
+bool Entity::sweep_collision(int axis, PhysicsScalar start, const Boxes& boxes, bool& win, bool& loss, const PlatformBroadphase* broadphase)
 {
-    program->set_model_matrix(m_model_matrix);
+    PhysicsScalar velocity = m_velocity[axis];
+    if (!m_is_active || velocity == 0.0f) return false;
+
+    int   cross_axis = 1 - axis;
+    PhysicsScalar direction = (velocity > 0) ? 1.0f : -1.0f;
+    PhysicsVec2   size      = PhysicsVec2(m_width, m_height);
 
-    if (m_animation_indices != NULL)
+    // The leading face of our box at the start and the end of the move
+    PhysicsScalar leading_start = start + direction * size[axis] / 2.0f,
+                  leading_end   = m_position[axis] + direction * size[axis] / 2.0f;
+
+    // STEP 1: Gather the platforms anywhere along the swept box
+    int candidate_count = boxes.get_count();
+    if (broadphase != NULL)
     {
-        draw_sprite_from_texture_atlas(program, m_texture_id, m_animation_indices[m_animation_index]);
-        return;
+        // The broadphases work in float; the margin covers the conversion
+        glm::vec2 position  = glm::vec2(m_position),
+                  half_size = glm::vec2(size) / 2.0f + BROADPHASE_MARGIN;
+        glm::vec2 min = position - half_size,
+                  max = position + half_size;
+        min[axis] = std::min((float)start, position[axis]) - half_size[axis];
+        max[axis] = std::max((float)start, position[axis]) + half_size[axis];
+
+        broadphase->query(min, max, m_candidates, m_broadphase_cursor);
+        candidate_count = (int)m_candidates.size();
+    }
+
+    // STEP 2: Of the near faces we pass through, the first one reached is the time of impact.
+    //         The move is along one axis, so the other axis has to overlap for all of it.
+    int           first_hit  = -1;
+    PhysicsScalar first_face = 0.0f;
+
+    for (int k = 0; k < candidate_count; k++)
+    {
+        int other = (broadphase != NULL) ? m_candidates[k] : k;
+        if (!boxes.is_active(other)) continue;
+
+        PhysicsVec2 other_position = PhysicsVec2(boxes.get_x(other), boxes.get_y(other)),
+                    other_size     = PhysicsVec2(boxes.get_width(other), boxes.get_height(other));
+
+        PhysicsScalar cross_distance = fabs(m_position[cross_axis] - other_position[cross_axis]) - ((size[cross_axis] + other_size[cross_axis]) / 2.0f);
+        if (cross_distance >= 0.0f) continue;
+
+        PhysicsScalar face = other_position[axis] - direction * other_size[axis] / 2.0f;
+        bool crosses = (direction > 0) ? (leading_start <= face && leading_end > face)
+                                       : (leading_start >= face && leading_end < face);
+        if (!crosses) continue;
+
+        if (first_hit < 0 || (direction > 0 ? face < first_face : face > first_face))
+        {
+            first_hit = other;
+            first_face = face;
+        }
+    }
+
+    if (first_hit < 0) return false;
+
+    // STEP 3: Stop flush against it and zero the velocity, as the discrete unclip would
+    PhysicsScalar depth = (leading_end - first_face) * direction;
+    m_position[axis] = first_face - direction * size[axis] / 2.0f;
+    m_velocity[axis] = 0;
+
+    glm::vec2 normal = glm::vec2(0.0f);
+    normal[axis] = -(float)direction;
+    add_contact(first_hit, normal, depth, boxes.get_entity_type(first_hit));
+
+    if (axis == 0)
+    {
+        if (direction > 0) m_collided_right = true;
+        else               m_collided_left = true;
+    }
+    else if (direction > 0)
+    {
+        m_collided_top = true;
+    }
+    else
+    {
+        m_collided_bottom = true;
+
+        if (boxes.get_entity_type(first_hit) == WIN_PLATFORM)        win = true;
+        else if (boxes.get_entity_type(first_hit) == DEATH_PLATFORM) loss = true;
+    }
+
+    return true;
+}
+
+template <typename Boxes>
+void Entity::resolve_y(const Boxes& boxes, bool& win, bool& loss, const PlatformBroadphase* broadphase)
+{
+    // Only the first overlap gets resolved (it zeroes our velocity), and our position doesn't move
+    // before it, so the platforms overlapping our box right now are the only ones that matter
+    const int* indices;
+    int candidate_count = gather_candidates(boxes, broadphase, indices);
+
+    if (!m_is_active) return;
+
+    // A handful of candidates, the usual case, is quicker tested one by one than handed to a
+    // kernel; wide lists jump straight from one overlap to the next (skip_to_overlap)
+    bool batched = std::is_same_v<Boxes, PlatformColliders> && indices != NULL && candidate_count >= OVERLAP_KERNEL_MIN_CANDIDATES;
+    for (int k = skip_to_overlap(boxes, indices, 0, candidate_count, batched); k < candidate_count; k = skip_to_overlap(boxes, indices, k + 1, candidate_count, batched))
+    {
+        // STEP 1: For every platform that our player can collide with...
+        int other = (indices != NULL) ? indices[k] : k;
+        if (!boxes.is_active(other)) continue;
+
+        PhysicsScalar other_x = boxes.get_x(other),
+                      other_y = boxes.get_y(other),
+                      other_width  = boxes.get_width(other),
+                      other_height = boxes.get_height(other);
+
+        PhysicsScalar x_gap = fabs(m_position.x - other_x) - ((m_width + other_width) / 2.0f);
+        PhysicsScalar y_gap = fabs(m_position.y - other_y) - ((m_height + other_height) / 2.0f);
+        if (!(x_gap < 0.0f && y_gap < 0.0f)) continue;
+
+        // STEP 2: Calculate the distance between its centre and our centre
+        //         and use that to calculate the amount of overlap between
+        //         both bodies.
+        PhysicsScalar y_distance = fabs(m_position.y - other_y);
+        PhysicsScalar y_overlap = fabs(y_distance - (m_height / 2.0f) - (other_height / 2.0f));
+
+        // STEP 3: "Unclip" ourselves from the other entity, and zero our
+        //         vertical velocity. Selects rather than branches on which way we
+        //         were going (CollisionResponse.h), down to the flags.
+        EntityType platform_type = boxes.get_entity_type(other);
+        AxisResponse response = resolve_axis(m_position.y, m_velocity.y, y_overlap);
+
+        m_collided_top    |= response.positive;
+        m_collided_bottom |= response.negative;
+        win  |= response.negative & (platform_type == WIN_PLATFORM);
+        loss |= response.negative & (platform_type == DEATH_PLATFORM);
+        record_contact(response.positive | response.negative, other, glm::vec2(0.0f, response.positive ? -1.0f : 1.0f), y_overlap, platform_type);
     }
+}
 
-    float vertices[] = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
-    float tex_coords[] = { 0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
+template <typename Boxes>
+void Entity::resolve_x(const Boxes& boxes, const PlatformBroadphase* broadphase)
+{
+    const int* indices;
+    int candidate_count = gather_candidates(boxes, broadphase, indices);
+
+    if (!m_is_active) return;
+
+    bool batched = std::is_same_v<Boxes, PlatformColliders> && indices != NULL && candidate_count >= OVERLAP_KERNEL_MIN_CANDIDATES;
+    for (int k = skip_to_overlap(boxes, indices, 0, candidate_count, batched); k < candidate_count; k = skip_to_overlap(boxes, indices, k + 1, candidate_count, batched))
+    {
+        int other = (indices != NULL) ? indices[k] : k;
+        if (!boxes.is_active(other)) continue;
+
+        PhysicsScalar other_x = boxes.get_x(other),
+                      other_y = boxes.get_y(other),
+                      other_width  = boxes.get_width(other),
+                      other_height = boxes.get_height(other);
 
-    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        PhysicsScalar x_gap = fabs(m_position.x - other_x) - ((m_width + other_width) / 2.0f);
+        PhysicsScalar y_gap = fabs(m_position.y - other_y) - ((m_height + other_height) / 2.0f);
+        if (!(x_gap < 0.0f && y_gap < 0.0f)) continue;
 
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->get_position_attribute());
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+        PhysicsScalar x_distance = fabs(m_position.x - other_x);
+        PhysicsScalar x_overlap = fabs(x_distance - (m_width / 2.0f) - (other_width / 2.0f));
+        AxisResponse response = resolve_axis(m_position.x, m_velocity.x, x_overlap);
 
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+        m_collided_right |= response.positive;
+        m_collided_left  |= response.negative;
+        record_contact(response.positive | response.negative, other, glm::vec2(response.positive ? -1.0f : 1.0f, 0.0f), x_overlap, boxes.get_entity_type(other));
+    }
+}
+
+void const Entity::check_collision_y(Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events, const PlatformBroadphase* broadphase)
+{
+    TRACE_ZONE("check_collision_y");
+    glm::vec2 velocity = glm::vec2(glm::vec3(m_velocity));
+    bool win  = false,
+         loss = false;
+    resolve_y(EntityBoxes{ collidable_entities, collidable_entity_count }, win, loss, broadphase);
+
+    if (events == NULL) return;
+    if (win)  push_touchdown(*events, true, velocity);
+    if (loss) push_touchdown(*events, false, velocity);
+}
 
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+void const Entity::check_collision_x(Entity* collidable_entities, int collidable_entity_count, const PlatformBroadphase* broadphase)
+{
+    TRACE_ZONE("check_collision_x");
+    resolve_x(EntityBoxes{ collidable_entities, collidable_entity_count }, broadphase);
 }
 
 bool const Entity::check_collision(Entity* other) const
@@ -234,8 +797,8 @@ bool const Entity::check_collision(Entity* other) const
     // If either entity is inactive, there shouldn't be any collision
     if (!m_is_active || !other->m_is_active) return false;
 
-    float x_distance = fabs(m_position.x - other->m_position.x) - ((m_width + other->m_width) / 2.0f);
-    float y_distance = fabs(m_position.y - other->m_position.y) - ((m_height + other->m_height) / 2.0f);
+    PhysicsScalar x_distance = fabs(m_position.x - other->m_position.x) - ((m_width + other->m_width) / 2.0f);
+    PhysicsScalar y_distance = fabs(m_position.y - other->m_position.y) - ((m_height + other->m_height) / 2.0f);
 
     return x_distance < 0.0f && y_distance < 0.0f;
 }
@@ -1,77 +1,207 @@
+#pragma once
+
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "glm/common.hpp"
+#include "PhysicsScalar.h"
+#include "RenderMaterial.h"
+#include "ModelTransform.h"
+#include "AnimationLibrary.h"
+
+class RenderCommandBuffer;
+struct SpriteQuad;
+class PlatformBroadphase;
+class PlatformColliders;
+class Terrain;
+class DistanceField;
+class GameEventBuffer;
+
 enum EntityType { DEATH_PLATFORM, WIN_PLATFORM, PLAYER};
 
+// STATIC bodies never move and are skipped by update(); KINEMATIC bodies move at their set
+// velocity but feel no forces or collisions; DYNAMIC bodies get the full physics
+enum BodyType { STATIC_BODY, KINEMATIC_BODY, DYNAMIC_BODY };
+
+// How update() moves a DYNAMIC body through one step:
+//   EXPLICIT_EULER       velocity, then position, then the booster as a kick of m_boosting_power,
+//                        so the same input over more, shorter steps thrusts harder. What every
+//                        recorded replay and checksum was made with, hence the default.
+//   SEMI_IMPLICIT_EULER  velocity, then position, with the booster an acceleration (see
+//                        BOOST_REFERENCE_TIMESTEP) and drag that stops at rest instead of overshooting
+//   VELOCITY_VERLET      the same forces, moving by the step's average velocity: exact while the
+//                        acceleration holds still, so a longer step traces the same path
+enum Integrator { EXPLICIT_EULER, SEMI_IMPLICIT_EULER, VELOCITY_VERLET };
+
+// The step m_boosting_power was tuned as a kick for (FIXED_TIMESTEP). The rate integrators push
+// with m_boosting_power / BOOST_REFERENCE_TIMESTEP per second, the same thrust at 60 Hz.
+const float BOOST_REFERENCE_TIMESTEP = 0.0166666f;
+
+// One resolved overlap from the last update(). The normal points from the platform towards
+// us, so a landing has normal (0, 1).
+struct Contact
+{
+    int        index;  // into the collidables passed to update(), or Terrain/DistanceField::CONTACT_INDEX
+    glm::vec2  normal;
+    float      depth;  // how far we were pushed back out
+    EntityType platform_type;
+};
+
+// Everything about a body that update() reads or writes, as plain data, so that it can be
+// memcpy'd into a snapshot and back (see save_snapshot in Simulation.h)
+struct BodyState
+{
+    PhysicsVec3   position, velocity, acceleration, field_acceleration;
+    glm::vec3     previous_position, movement;
+    PhysicsScalar speed, width, height,
+                  boosting_power, drag, throttle,
+                  thrust, burn_rate, dry_mass, fuel;
+    int           animation_clip, animation_frame;
+    float         animation_time;
+    unsigned char entity_type, body_type, integrator;
+    bool          active, booster_active, continuous_collision,
+                  collided_top, collided_bottom, collided_left, collided_right;
+};
+
 class Entity
 {
 private:
     bool m_is_active = true;
 
-    // ––––– ANIMATION ––––– //
-    int*  m_animation_right = NULL, // move to the right
-        * m_animation_left  = NULL, // move to the left
-        * m_animation_up    = NULL, // move upwards
-        * m_animation_down  = NULL; // move downwards
-
-    int* m_idle = NULL,
-        * m_low = NULL,
-        * m_high = NULL;
-
     // ––––– PHYSICS (GRAVITY) ––––– //
-    glm::vec3 m_position;
-    glm::vec3 m_velocity;
-    glm::vec3 m_acceleration;
+    // PhysicsScalar is float unless LANDER_FIXED_POINT is defined; the getters and setters
+    // below always speak float, so only the physics itself changes
+    PhysicsVec3 m_position;
+    PhysicsVec3 m_velocity;
+    PhysicsVec3 m_acceleration;
+    PhysicsVec3 m_field_acceleration;  // from ForceFields, set before each step; zero without any
+
+    // Where the last update() started from, for drawing between physics steps
+    glm::vec3 m_previous_position = glm::vec3(0.0f);
 
     // ————— TRANSFORMATIONS ————— //
-    float     m_speed;
-    glm::vec3 m_movement;
-    glm::mat4 m_model_matrix;
+    PhysicsScalar m_speed;
+    glm::vec3     m_movement;
 
-    float m_width = 1;
-    float m_height = 1;
+    PhysicsScalar m_width = 1.0f;
+    PhysicsScalar m_height = 1.0f;
 
     EntityType m_entity_type;
+    BodyType   m_body_type = DYNAMIC_BODY;
+
+    // Scratch list for broadphase queries, kept so steady-state steps don't allocate
+    std::vector<int> m_candidates;
+    int              m_broadphase_cursor = -1;
+
+    void collect_candidates(const PlatformBroadphase* broadphase);
+
+    // ————— CONTACTS ————— //
+    static const int MAX_CONTACTS = 8;
+
+    Contact m_contacts[MAX_CONTACTS + 1];  // the last is a spare, for record_contact to write to when full
+    int     m_contact_count = 0;
+
+    // The platforms near our last full search, kept while we stay well inside the box it
+    // covered. A lander resting on a platform re-tests these few instead of the whole level.
+    std::vector<int>         m_cached_candidates;
+    glm::vec2                m_cache_min = glm::vec2(0.0f),
+                             m_cache_max = glm::vec2(-1.0f);
+    const PlatformColliders* m_cache_source  = NULL;
+    int                      m_cache_version = -1,
+                             m_cache_edits   = -1;
+
+    void add_contact(int index, glm::vec2 normal, PhysicsScalar depth, EntityType platform_type);
+    // add_contact() without a branch, for the platform passes: always written, counted only if `resolved`
+    void record_contact(bool resolved, int index, glm::vec2 normal, PhysicsScalar depth, EntityType platform_type);
+
+    // update() for a DYNAMIC_BODY, with the integrator fixed at compile time rather than tested:
+    // one tight kernel per integrator, picked once per call. Static bodies never get this far.
+    template <Integrator INTEGRATOR>
+    void update_dynamic(float delta_time, Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events, const PlatformBroadphase* broadphase,
+                        const PlatformColliders* colliders, double* collision_seconds, const Terrain* terrain, const DistanceField* field);
+
+    // The step's events, from what the collision passes flagged and the contacts they left;
+    // `velocity` is ours going into the move. Only called with something to say.
+    void push_touchdown(GameEventBuffer& events, bool win, glm::vec2 velocity) const;
+    void push_scrape(GameEventBuffer& events, glm::vec2 velocity) const;
+
+    // The SEMI_IMPLICIT_EULER and VELOCITY_VERLET velocity change before the move, with the
+    // booster and drag as accelerations; Verlet applies it again after
+    PhysicsVec3 get_rate_kick(PhysicsScalar step, Integrator integrator, PhysicsScalar engine_kick) const;
+
+    // The velocity a fuelled booster adds over `step`, with the fuel it burns taken out of the
+    // tank; less if the tank runs dry partway, and nothing once it is empty
+    PhysicsScalar burn_fuel(PhysicsScalar step);
+
+    // Which boxes the discrete passes test: the broadphase's answer, the contact cache (for a
+    // PlatformColliders with no broadphase), or every box. `indices` is NULL for every box.
+    template <typename Boxes> int gather_candidates(const Boxes& boxes, const PlatformBroadphase* broadphase, const int*& indices);
+    int gather_candidates(const PlatformColliders& colliders, const PlatformBroadphase* broadphase, const int*& indices);
+
+    // Where the collision passes' walk over candidates [start, count) may resume: at the first box
+    // overlapping ours (or `count`) when `batched`, the boxes tested a batch at a time by
+    // OverlapKernels, and otherwise at `start` itself, leaving every box to the passes. Only a
+    // PlatformColliders can be batched; asking for it with anything else asserts.
+    template <typename Boxes> int skip_to_overlap(const Boxes& boxes, const int* indices, int start, int count, bool batched) const;
+    int find_overlap_batched(const PlatformColliders& colliders, const int* indices, int start, int count) const;
+
+    // The collision passes run over either source of platform boxes: the Entity array itself or
+    // a PlatformColliders packed from it. Both are read through the same accessors (Entity.cpp).
+    template <Integrator INTEGRATOR, typename Boxes>
+    void move_and_collide(const Boxes& boxes, PhysicsScalar step, bool& win, bool& loss, const PlatformBroadphase* broadphase,
+                          const Terrain* terrain, const DistanceField* field);
+    template <typename Boxes> void resolve_y(const Boxes& boxes, bool& win, bool& loss, const PlatformBroadphase* broadphase);
+    template <typename Boxes> void resolve_x(const Boxes& boxes, const PlatformBroadphase* broadphase);
+
+    // Moves along one axis (0 = x, 1 = y) from `start` to the current position; returns whether a
+    // platform face was crossed on the way, in which case we have already been stopped against it
+    template <typename Boxes> bool sweep_collision(int axis, PhysicsScalar start, const Boxes& boxes, bool& win, bool& loss, const PlatformBroadphase* broadphase);
+
+    // Against the heightfield, which only ever pushes up: landing on it is a win or a loss by the
+    // same rules as a platform, and running into a slope sideways stops us back at `start_x`
+    void resolve_terrain_y(const Terrain& terrain, bool& win, bool& loss);
+    void resolve_terrain_x(const Terrain& terrain, PhysicsScalar start_x);
+
+    // Against baked level geometry of any shape: sampled at the points of our hull, and pushed out
+    // of the deepest one along the field's normal, a few times over. A floor contact scores a
+    // landing by the rock under our feet, as on the terrain.
+    void resolve_field(const DistanceField& field, bool& win, bool& loss);
 
 
 public:
     // ————— STATIC VARIABLES ————— //
-    static const int SECONDS_PER_FRAME = 4;
-    static const int LEFT  = 0,
-                     RIGHT = 1,
-                     UP    = 2,
-                     DOWN  = 3,
-                     IDLE  = 0,
+    static constexpr float BROADPHASE_MARGIN = 0.0001f;
+    static constexpr float CONTACT_CACHE_MARGIN = 0.5f;  // how far past our box the cache reaches
+    static const int IDLE  = 0,
                      LOW   = 1,
-                     HIGH  = 2;
+                     HIGH  = 2,
+                     NO_CLIP = -1;
 
     // ————— ANIMATION ————— //
-    int** m_walking = new int* [4]
-        {
-            m_animation_left,
-            m_animation_right,
-            m_animation_up,
-            m_animation_down
-        };
-
-    int** m_booster = new int* [3]
-        {
-            m_idle,
-            m_low,
-            m_high
-        };
-
-    int m_animation_frames = 0,
-        m_animation_index  = 0,
-        m_animation_cols   = 0,
-        m_animation_rows   = 0;
-
-    int* m_animation_indices = NULL;
-    float m_animation_time   = 0.0f;
+    // The clips themselves are shared, in an AnimationLibrary; update() only picks which one
+    // plays, and whoever owns the library advances m_animator before drawing
+    int m_booster_clip   = NO_CLIP;  // the library's IDLE clip; LOW and HIGH follow it
+    int m_animation_cols = 0,
+        m_animation_rows = 0;
+
+    Animator m_animator;
 
     // ––––– PHYSICS (JUMPING/BOOSTING) ––––– //
     bool  m_is_jumping     = false,
           m_booster_active = false;
-    float m_jumping_power  = 0,
-          m_boosting_power = 0,
-          m_drag           = 0;
+    float m_jumping_power  = 0;
+    PhysicsScalar m_boosting_power = 0.0f,
+                  m_drag           = 0.0f,
+                  m_throttle       = 1.0f;  // how much of the booster's push it fires at; below 1 only from an analog action
+
+    // ––––– PHYSICS (FUEL) ––––– //
+    // With m_thrust above 0 the booster is a rocket instead of m_boosting_power's fixed push:
+    // m_thrust burning m_burn_rate of fuel a second, against m_dry_mass and whatever fuel is left,
+    // so it pushes harder as the tank empties and cuts out when it's dry (FuelModel.h). A burn
+    // rate of 0 never runs out.
+    PhysicsScalar m_thrust    = 0.0f,
+                  m_burn_rate = 0.0f,
+                  m_dry_mass  = 1.0f,
+                  m_fuel      = 0.0f;
 
     // ––––– PHYSICS (COLLISIONS) ––––– //
     bool m_collided_top    = false;
@@ -79,45 +209,111 @@ public:
     bool m_collided_left   = false;
     bool m_collided_right  = false;
 
-    GLuint    m_texture_id;
+    // Sweep each move for platforms crossed along the way, so large timesteps can't tunnel
+    bool m_continuous_collision = false;
+
+    Integrator m_integrator = EXPLICIT_EULER;
+
+    unsigned int m_texture_id; // a GLuint, spelled out so the physics core needs no GL headers
+    glm::vec4 m_uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f); // where the sheet sits inside m_texture_id
+    RenderMaterial m_material = TRANSLUCENT_MATERIAL;          // the sheet's, e.g. AtlasRegion::material
+
+    // Every frame's rect in m_texture_id, from map_sheet() (SpriteSheet.h); owned by the caller.
+    // Without one, frames are worked out from m_animation_cols/rows on every draw.
+    const glm::vec4* m_frame_uv_rects = NULL;
+
+    // The same sheet as a texture array with one frame per layer (TextureArray.h), drawn in place
+    // of m_texture_id when set; 0 keeps to the UV rects
+    unsigned int m_frame_array_id = 0;
 
     // ————— METHODS ————— //
     Entity();
-    ~Entity();
 
-    void draw_sprite_from_texture_atlas(ShaderProgram* program, GLuint texture_id, int index);
+    void draw_sprite_from_texture_atlas(RenderCommandBuffer* queue, unsigned int texture_id, int index, glm::vec2 position);
+    // Where sheet frame `index` sits in m_texture_id: a table lookup with m_frame_uv_rects, worked
+    // out from m_animation_cols/rows and m_uv_rect without
+    glm::vec4 const get_frame_uv_rect(int index) const;
     bool const check_collision(Entity* other) const;
-    void const check_collision_y(Entity* collidable_entities, int collidable_entity_count, bool& win, bool& loss);
-    void const check_collision_x(Entity* collidable_entities, int collidable_entity_count);
+    // With a broadphase, only the platforms it hands back are tested; without one, all of them
+    // A touchdown goes into `events`, if there are any
+    void const check_collision_y(Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events = NULL, const PlatformBroadphase* broadphase = NULL);
+    void const check_collision_x(Entity* collidable_entities, int collidable_entity_count, const PlatformBroadphase* broadphase = NULL);
 
-    void update(float delta_time, Entity* collidable_entities, int collidable_entity_count, bool &win, bool &loss);
-    void render(ShaderProgram* program);
+    // With `colliders` (built from the same platforms), collision reads the packed copy and
+    // leaves collidable_entities alone. With `collision_seconds`, the time spent in collision
+    // is added to it. With `terrain`, we also collide with the ground it describes, and with
+    // `field`, with the geometry baked into it. What happens on the way (GameEvents.h) goes into
+    // `events`, stamped with its current lander; with none, nothing is recorded.
+    void update(float delta_time, Entity* collidable_entities, int collidable_entity_count, GameEventBuffer* events, const PlatformBroadphase* broadphase = NULL,
+                const PlatformColliders* colliders = NULL, double* collision_seconds = NULL, const Terrain* terrain = NULL,
+                const DistanceField* field = NULL);
+    // alpha runs from 0 (the previous physics step) to 1 (the latest one); offset is drawn on top,
+    // for corrections the physics doesn't know about. Only records, so any thread can draw into
+    // its own command buffer.
+    void render(RenderCommandBuffer* queue, float alpha = 1.0f, glm::vec2 offset = glm::vec2(0.0f));
+    // render() for many entities in one pass, e.g. a frame's visible platforms: the quad of entity
+    // indices[first + i] (first + i, with no indices) goes to quads[i], and the worst of their
+    // materials comes back, for RenderCommandBuffer::submit_sprite_run. No player or animated
+    // entities. Writes nothing but `quads`, so threads can fill slices of one array side by side.
+    static RenderMaterial write_sprite_quads(const Entity* entities, const int* indices, int first, int count, float alpha, SpriteQuad* quads);
     
     void move_left()  { m_movement.x = -1.0f; };
     void move_right() { m_movement.x = 1.0f;  };
     void move_up()    { m_movement.y = 1.0f;  };
     void move_down()  { m_movement.y = -1.0f; };
 
+    void save_state(BodyState& state) const;
+    void restore_state(const BodyState& state);
+
     void activate()   { m_is_active = true; };
     void deactivate() { m_is_active = false; };
 
     // ————— GETTERS ————— //
     EntityType const get_entity_type()    const { return m_entity_type; };
-    glm::vec3 const get_position()     const { return m_position; };
-    glm::vec3 const get_velocity()     const { return m_velocity; };
-    glm::vec3 const get_acceleration() const { return m_acceleration; };
+    BodyType   const get_body_type()      const { return m_body_type; };
+    glm::vec3 const get_position()     const { return glm::vec3(m_position); };
+    glm::vec3 const get_velocity()     const { return glm::vec3(m_velocity); };
+    glm::vec3 const get_acceleration() const { return glm::vec3(m_acceleration); };
+    glm::vec2 const get_field_acceleration() const { return glm::vec2(glm::vec3(m_field_acceleration)); };
     glm::vec3 const get_movement()     const { return m_movement; };
-    float     const get_speed()        const { return m_speed; };
-    int       const get_width()        const { return m_width; };
-    int       const get_height()       const { return m_height; };
+    float     const get_speed()        const { return (float)m_speed; };
+    float     const get_width()        const { return (float)m_width; };
+    float     const get_height()       const { return (float)m_height; };
+
+    // Exact physics state, for checksums; converting fixed point to float can drop bits
+    const PhysicsVec3& get_physics_position() const { return m_position; };
+    const PhysicsVec3& get_physics_velocity() const { return m_velocity; };
+    PhysicsScalar const get_physics_width()   const { return m_width; };
+    PhysicsScalar const get_physics_height()  const { return m_height; };
+    bool      const is_active()        const { return m_is_active; };
+
+    // Whether the booster is actually pushing: held, and with fuel in the tank if it burns any
+    bool  const is_engine_firing() const { return m_booster_active && (!(m_thrust > 0.0f) || !(m_burn_rate > 0.0f) || m_fuel > 0.0f); };
+    // What it would push with if fired now, per second; boosting_timestep is the step
+    // m_boosting_power kicks once in
+    float const get_engine_acceleration(float boosting_timestep) const;
+
+    // What the last update() resolved, in order; beyond MAX_CONTACTS the rest are dropped
+    int            const get_contact_count()      const { return m_contact_count; };
+    const Contact& get_contact(int index)         const { return m_contacts[index]; };
+    // Made from the position on demand rather than stored; the renderers read m_position directly
+    ModelTransform const get_model_transform() const { return ModelTransform::make(glm::vec2(glm::vec3(m_position))); };
+    glm::vec3 const get_interpolated_position(float alpha) const { return glm::mix(m_previous_position, glm::vec3(m_position), alpha); };
 
     // ————— SETTERS ————— //
     void const set_entity_type(EntityType new_entity_type) { m_entity_type = new_entity_type; };
-    void const set_position(glm::vec3 new_position)         { m_position = new_position; };
-    void const set_velocity(glm::vec3 new_velocity)         { m_velocity = new_velocity; };
-    void const set_acceleration(glm::vec3 new_position)     { m_acceleration = new_position; };
+    void const set_body_type(BodyType new_body_type)       { m_body_type = new_body_type; };
+    void const set_position(glm::vec3 new_position)         { m_position = PhysicsVec3(new_position); m_previous_position = new_position; };
+    void const set_velocity(glm::vec3 new_velocity)         { m_velocity = PhysicsVec3(new_velocity); };
+    void const set_acceleration(glm::vec3 new_position)     { m_acceleration = PhysicsVec3(new_position); };
+    void const set_field_acceleration(glm::vec2 new_field_acceleration) { m_field_acceleration = PhysicsVec3(glm::vec3(new_field_acceleration, 0.0f)); };
     void const set_movement(glm::vec3 new_movement)         { m_movement = new_movement; };
     void const set_speed(float new_speed)                   { m_speed = new_speed; };
+    // Exact, for restoring snapshots; the float setters can round in fixed-point builds
+    void const set_physics_position(const PhysicsVec3& new_position)  { m_position = new_position; m_previous_position = glm::vec3(new_position); };
+    // Both the position and the last step's, so interpolation sees no jump; for moving the origin
+    void const translate(glm::vec3 offset)                  { m_position += PhysicsVec3(offset); m_previous_position += offset; };
+    void const set_physics_size(PhysicsScalar new_width, PhysicsScalar new_height) { m_width = new_width; m_height = new_height; };
     void const set_width(float new_width)                   { m_width = new_width; };
     void const set_height(float new_height)                 { m_height = new_height; };
 };
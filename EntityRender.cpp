@@ -0,0 +1,62 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <algorithm>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include "RenderQueue.h"
+#include "Entity.h"
+
+void Entity::draw_sprite_from_texture_atlas(RenderCommandBuffer* queue, unsigned int texture_id, int index, glm::vec2 position)
+{
+    RenderLayer layer = (m_entity_type == PLAYER) ? ACTOR_LAYER : WORLD_LAYER;
+
+    // Queue the frame; the render queue batches it with everything else at flush time
+    if (m_frame_array_id != 0) queue->submit_layered_sprite(layer, position, glm::vec2(1.0f), index, m_frame_array_id, m_material);
+    else                       queue->submit_sprite(layer, position, glm::vec2(1.0f), get_frame_uv_rect(index), texture_id, m_material);
+}
+
+void Entity::render(RenderCommandBuffer* queue, float alpha, glm::vec2 offset)
+{
+    glm::vec2 position = glm::vec2(get_interpolated_position(alpha)) + offset;
+
+    if (m_animator.clip != NO_CLIP)
+    {
+        draw_sprite_from_texture_atlas(queue, m_texture_id, m_animator.frame, position);
+        return;
+    }
+
+    RenderLayer layer = (m_entity_type == PLAYER) ? ACTOR_LAYER : WORLD_LAYER;
+    queue->submit_sprite(layer, position, glm::vec2(get_width(), get_height()), m_uv_rect, m_texture_id, m_material);
+}
+
+RenderMaterial Entity::write_sprite_quads(const Entity* entities, const int* indices, int first, int count, float alpha, SpriteQuad* quads)
+{
+    // One straight pass over the entities, with no queue, cull test or sort key per quad: those
+    // are paid once for the whole run when it is submitted
+    RenderMaterial material = OPAQUE_MATERIAL;
+    for (int i = 0; i < count; i++)
+    {
+        const Entity& entity = entities[indices != NULL ? indices[first + i] : first + i];
+
+        quads[i] = { glm::vec2(entity.get_interpolated_position(alpha)), glm::vec2(entity.get_width(), entity.get_height()), entity.m_uv_rect, entity.m_texture_id };
+        material = std::max(material, entity.m_material);
+    }
+    return material;
+}
@@ -0,0 +1,453 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include "EnvServer.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENV_CPU_RELAX() _mm_pause()
+#else
+#define ENV_CPU_RELAX() ((void)0)
+#endif
+
+using namespace env_shared;
+
+// A sleeper re-checks the shutdown flag this often, so a stop that races a sleep is never missed
+const long SLEEP_TIMEOUT_NS = 100 * 1000 * 1000;
+
+// ————— PLATFORM ————— //
+static size_t round_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+// Maps the segment called `name`: a new, zeroed one of `size` bytes when `create` is set, else the
+// existing one, with `size` set to how big it is
+static void* map_segment(const char* name, size_t& size, bool create, void*& mapping)
+{
+#ifdef _WIN32
+    HANDLE handle = create ? CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((unsigned long long)size >> 32), (DWORD)size, name)
+                           : OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+    if (handle == NULL) return NULL;
+
+    void* data = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, create ? size : 0);
+    if (data == NULL)
+    {
+        CloseHandle(handle);
+        return NULL;
+    }
+
+    if (!create)
+    {
+        MEMORY_BASIC_INFORMATION info;
+        VirtualQuery(data, &info, sizeof(info));
+        size = info.RegionSize;
+    }
+    mapping = handle;
+    return data;
+#else
+    if (create) shm_unlink(name);
+
+    int file = shm_open(name, create ? (O_CREAT | O_EXCL | O_RDWR) : O_RDWR, 0600);
+    if (file < 0) return NULL;
+
+    struct stat status;
+    if (create ? ftruncate(file, (off_t)size) != 0 : (fstat(file, &status) != 0 || status.st_size <= 0))
+    {
+        ::close(file);
+        if (create) shm_unlink(name);
+        return NULL;
+    }
+    if (!create) size = (size_t)status.st_size;
+
+    void* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    ::close(file);  // the mapping keeps the segment alive on its own
+    mapping = NULL;
+    return data == MAP_FAILED ? NULL : data;
+#endif
+}
+
+static void unmap_segment(void* data, size_t size, void* mapping)
+{
+#ifdef _WIN32
+    if (data != NULL) UnmapViewOfFile(data);
+    if (mapping != NULL) CloseHandle(mapping);
+#else
+    (void)mapping;
+    if (data != NULL) munmap(data, size);
+#endif
+}
+
+// Sleeps while `word` still holds `expected`, for SLEEP_TIMEOUT_NS at most. Without a futex, the
+// caller's loop just turns into a yielding poll.
+static void wait_on(std::atomic<uint32_t>& word, uint32_t expected)
+{
+#ifdef __linux__
+    timespec timeout = { 0, SLEEP_TIMEOUT_NS };
+    syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAIT, expected, &timeout, NULL, 0);
+#else
+    (void)word;
+    (void)expected;
+    std::this_thread::yield();
+#endif
+}
+
+static void wake_all(std::atomic<uint32_t>& word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t*)&word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+// The channel's arrays, in the order the layout puts them after the Channel struct
+struct ChannelArrays
+{
+    int32_t* actions;
+    float*   observations,
+         *   rewards;
+    int32_t* dones;
+};
+
+static ChannelArrays get_arrays(Channel* channel, int env_count)
+{
+    unsigned char* bytes = (unsigned char*)channel + sizeof(Channel);
+
+    ChannelArrays arrays;
+    arrays.actions      = (int32_t*)bytes;
+    arrays.observations = (float*)(arrays.actions + env_count);
+    arrays.rewards      = arrays.observations + env_count * LANDER_OBSERVATION_SIZE;
+    arrays.dones        = (int32_t*)(arrays.rewards + env_count);
+    return arrays;
+}
+
+// ————— SERVER ————— //
+EnvServer::~EnvServer()
+{
+    stop();
+}
+
+Doorbell* EnvServer::get_doorbell(int worker) const
+{
+    return (Doorbell*)((unsigned char*)m_segment + round_up(sizeof(Header), CACHE_LINE)) + worker;
+}
+
+Channel* EnvServer::get_channel(int client) const
+{
+    const Header* header = get_header();
+    return (Channel*)((unsigned char*)m_segment + header->channels_offset + client * header->channel_stride);
+}
+
+bool EnvServer::start(const char* name, const EnvServerConfig& config)
+{
+    stop();
+
+    m_config = config;
+    m_config.client_count    = std::max(1, m_config.client_count);
+    m_config.envs_per_client = std::max(1, m_config.envs_per_client);
+    if (m_config.worker_count <= 0) m_config.worker_count = std::max(1, (int)std::thread::hardware_concurrency());
+    m_config.worker_count = std::min(m_config.worker_count, m_config.client_count);
+
+    // STEP 1: Lay out the segment: header, doorbells, then the channels, each on its own lines
+    int env_count = m_config.envs_per_client;
+    size_t arrays_size    = env_count * (sizeof(int32_t) + LANDER_OBSERVATION_SIZE * sizeof(float) + sizeof(float) + sizeof(int32_t)),
+           channel_stride = round_up(sizeof(Channel) + arrays_size, CACHE_LINE),
+           channels_offset = round_up(sizeof(Header), CACHE_LINE) + m_config.worker_count * sizeof(Doorbell);
+
+    m_size = channels_offset + m_config.client_count * channel_stride;
+    m_segment = map_segment(name, m_size, true, m_mapping);
+    if (m_segment == NULL) return false;
+    m_name = name;
+
+    // STEP 2: Construct the atomics in place; the magic goes in last, so a client attaching this
+    //         early sees a segment that isn't ready yet rather than a half-built one
+    Header* header = new (m_segment) Header();
+    header->version          = VERSION;
+    header->client_count     = m_config.client_count;
+    header->envs_per_client  = env_count;
+    header->observation_size = LANDER_OBSERVATION_SIZE;
+    header->worker_count     = m_config.worker_count;
+    header->channel_stride   = channel_stride;
+    header->channels_offset  = channels_offset;
+    header->next_client.store(0);
+    header->shutting_down.store(0);
+
+    for (int w = 0; w < m_config.worker_count; w++) new (get_doorbell(w)) Doorbell();
+
+    // STEP 3: The envs behind every channel
+    m_channels.assign(m_config.client_count, ChannelState());
+    for (int c = 0; c < m_config.client_count; c++)
+    {
+        Channel* channel = new (get_channel(c)) Channel();
+        ChannelArrays arrays = get_arrays(channel, env_count);
+        ChannelState& state = m_channels[c];
+
+        for (int e = 0; e < env_count; e++)
+        {
+            LanderEnv* env = lander_env_create(m_config.platform_count, m_config.layout, m_config.max_steps);
+            lander_env_observe(env, &arrays.observations[e * LANDER_OBSERVATION_SIZE]);
+            state.envs.push_back(env);
+        }
+        state.seeds.assign(env_count, 0);
+    }
+
+    header->magic.store(MAGIC, std::memory_order_release);
+
+    // STEP 4: Open for business
+    m_running.store(true);
+    for (int w = 0; w < m_config.worker_count; w++) m_workers.emplace_back(&EnvServer::worker_loop, this, w);
+    return true;
+}
+
+void EnvServer::stop()
+{
+    if (m_segment == NULL) return;
+
+    // STEP 1: Tell the clients, then get the threads out of any sleep and join them
+    Header* header = get_header();
+    header->shutting_down.store(1);
+    m_running.store(false);
+
+    for (int w = 0; w < (int)m_workers.size(); w++)
+    {
+        Doorbell* doorbell = get_doorbell(w);
+        doorbell->rings.fetch_add(1);
+        wake_all(doorbell->rings);
+    }
+    for (std::thread& worker : m_workers) worker.join();
+    m_workers.clear();
+
+    for (int c = 0; c < m_config.client_count; c++) wake_all(get_channel(c)->response);
+
+    // STEP 2: Attached clients keep their own mapping, so removing the name only stops new ones
+    for (ChannelState& state : m_channels)
+    {
+        for (LanderEnv* env : state.envs) lander_env_destroy(env);
+    }
+    m_channels.clear();
+
+    unmap_segment(m_segment, m_size, m_mapping);
+#ifndef _WIN32
+    shm_unlink(m_name.c_str());
+#endif
+    m_segment = NULL;
+    m_mapping = NULL;
+}
+
+void EnvServer::worker_loop(int worker_index)
+{
+    Doorbell& doorbell = *get_doorbell(worker_index);
+    const int worker_count = m_config.worker_count;
+
+    auto has_request = [&](int client) { return get_channel(client)->request.load(std::memory_order_acquire) != m_channels[client].served; };
+
+    int idle = 0;
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        // STEP 1: Answer every channel of this thread that has a request waiting
+        bool served = false;
+        for (int c = worker_index; c < m_config.client_count; c += worker_count)
+        {
+            if (!has_request(c)) continue;
+            serve(c);
+            served = true;
+        }
+
+        if (served)
+        {
+            idle = 0;
+            continue;
+        }
+
+        // STEP 2: Nothing to do: spin a while, since a busy client answers within microseconds
+        if (++idle < m_config.spin_count)
+        {
+            ENV_CPU_RELAX();
+            continue;
+        }
+
+        // STEP 3: Then sleep on the doorbell. Raising `sleeping` before the last look means a
+        //         client either sees it and wakes us, or posted early enough for that look to
+        //         find its request; and a ring between the two changes the word, so the wait
+        //         returns at once.
+        uint32_t rings = doorbell.rings.load();
+        doorbell.sleeping.store(1);
+
+        bool pending = false;
+        for (int c = worker_index; c < m_config.client_count && !pending; c += worker_count) pending = has_request(c);
+
+        if (!pending && m_running.load()) wait_on(doorbell.rings, rings);
+        doorbell.sleeping.store(0);
+    }
+}
+
+void EnvServer::serve(int client)
+{
+    Channel* channel = get_channel(client);
+    ChannelArrays arrays = get_arrays(channel, m_config.envs_per_client);
+    ChannelState& state = m_channels[client];
+
+    uint32_t sequence = channel->request.load(std::memory_order_acquire);
+    int env_count = m_config.envs_per_client;
+
+    if (channel->command == COMMAND_RESET)
+    {
+        for (int e = 0; e < env_count; e++)
+        {
+            state.seeds[e] = channel->seed + e;
+            lander_env_reset(state.envs[e], state.seeds[e], &arrays.observations[e * LANDER_OBSERVATION_SIZE]);
+            arrays.rewards[e] = 0.0f;
+            arrays.dones[e] = LANDER_DONE_NONE;
+        }
+    }
+    else
+    {
+        for (int e = 0; e < env_count; e++)
+        {
+            float* observation = &arrays.observations[e * LANDER_OBSERVATION_SIZE];
+
+            // Seeds step by the channel's env count, so no two envs of a channel share an episode
+            if (arrays.dones[e] != LANDER_DONE_NONE)
+            {
+                state.seeds[e] += env_count;
+                lander_env_reset(state.envs[e], state.seeds[e], observation);
+            }
+            lander_env_step(state.envs[e], arrays.actions[e], observation, &arrays.rewards[e], &arrays.dones[e]);
+        }
+    }
+
+    // Publish, then only pay for the syscall if the client has actually gone to sleep
+    state.served = sequence;
+    channel->response.store(sequence);
+    if (channel->client_sleeping.load()) wake_all(channel->response);
+}
+
+// ————— CLIENT ————— //
+EnvClient::~EnvClient()
+{
+    detach();
+}
+
+bool EnvClient::attach(const char* name, int spin_count)
+{
+    detach();
+
+    // STEP 1: Map the segment and check it's one we understand and that it's ready
+    m_segment = map_segment(name, m_size, false, m_mapping);
+    if (m_segment == NULL) return false;
+
+    Header* header = (Header*)m_segment;
+    bool valid = m_size >= sizeof(Header)
+              && header->magic.load(std::memory_order_acquire) == MAGIC
+              && header->version == VERSION && header->observation_size == LANDER_OBSERVATION_SIZE
+              && header->channels_offset + header->client_count * header->channel_stride <= m_size
+              && header->shutting_down.load() == 0;
+
+    // STEP 2: Claim a channel
+    uint32_t client = valid ? header->next_client.fetch_add(1) : 0;
+    if (!valid || client >= header->client_count)
+    {
+        detach();
+        return false;
+    }
+
+    m_header     = header;
+    m_doorbell   = (Doorbell*)((unsigned char*)m_segment + round_up(sizeof(Header), CACHE_LINE)) + client % header->worker_count;
+    m_channel    = (Channel*)((unsigned char*)m_segment + header->channels_offset + client * header->channel_stride);
+    m_sequence   = m_channel->request.load();
+    m_spin_count = spin_count;
+
+    ChannelArrays arrays = get_arrays(m_channel, header->envs_per_client);
+    m_actions      = arrays.actions;
+    m_observations = arrays.observations;
+    m_rewards      = arrays.rewards;
+    m_dones        = arrays.dones;
+    return true;
+}
+
+void EnvClient::detach()
+{
+    // The channel isn't handed back: a server runs as many clients as it was started for
+    unmap_segment(m_segment, m_size, m_mapping);
+    m_segment = NULL;
+    m_mapping = NULL;
+    m_header = NULL;
+    m_doorbell = NULL;
+    m_channel = NULL;
+    m_actions = NULL;
+    m_observations = m_rewards = NULL;
+    m_dones = NULL;
+}
+
+bool EnvClient::request(uint32_t command, uint32_t seed)
+{
+    if (m_channel == NULL || m_header->shutting_down.load(std::memory_order_relaxed)) return false;
+
+    // STEP 1: Post the request, and ring the doorbell only if its thread is asleep
+    m_channel->command = command;
+    m_channel->seed = seed;
+    m_channel->request.store(++m_sequence);
+
+    m_doorbell->rings.fetch_add(1);
+    if (m_doorbell->sleeping.load()) wake_all(m_doorbell->rings);
+
+    // STEP 2: Spin for the answer...
+    for (int i = 0; i < m_spin_count; i++)
+    {
+        if (m_channel->response.load(std::memory_order_acquire) == m_sequence) return true;
+        ENV_CPU_RELAX();
+    }
+
+    // STEP 3: ...then sleep for it, with the same raise-then-look order as the server threads
+    bool answered = false;
+    while (!answered)
+    {
+        m_channel->client_sleeping.store(1);
+        uint32_t response = m_channel->response.load();
+        answered = response == m_sequence;
+
+        if (!answered && m_header->shutting_down.load()) break;
+        if (!answered) wait_on(m_channel->response, response);
+    }
+    m_channel->client_sleeping.store(0);
+    return answered;
+}
+
+bool EnvClient::reset(unsigned int seed)
+{
+    return request(COMMAND_RESET, seed);
+}
+
+bool EnvClient::step()
+{
+    return request(COMMAND_STEP, 0);
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+// Hosts LanderEnvs for learners running in other processes. The server creates one named
+// shared-memory segment with a channel per client; a client attaches to it by name, writes its
+// actions straight into its channel and reads observations, rewards and done codes straight back
+// out, so nothing is serialised and no socket is touched per step.
+//
+//     EnvServer server;                               // in the host process
+//     server.start("/lander_envs", config);
+//
+//     EnvClient client;                               // in each learner process
+//     client.attach("/lander_envs");
+//     client.reset(seed);
+//     while (training)
+//     {
+//         fill_actions(client.get_actions(), client.get_observations());
+//         client.step();                              // every env in the channel, one fixed step
+//     }
+//
+// A channel is a one-deep ring: a request sequence the client bumps and a response sequence the
+// server bumps back, since a client's next actions always depend on the last observations.
+// Both sides spin for a while before sleeping, then sleep on a futex in the shared segment
+// (Linux) or yield (elsewhere), and each only makes the wake call when the other side is
+// actually asleep, so a busy client and server never enter the kernel at all.
+//
+// Server threads each own every worker_count-th channel, and a thread sleeps on one doorbell
+// shared by its channels rather than polling them, so 64+ client processes need no more than
+// one thread per core on the server.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LanderEnv.h"
+
+struct EnvServerConfig
+{
+    int          client_count    = 64,
+                 envs_per_client = 16,
+                 worker_count    = 0;     // 0 for one per hardware thread, never more than client_count
+    int          platform_count  = 0;     // as lander_env_create takes them
+    int          layout          = LANDER_LAYOUT_CLASSIC;
+    int          max_steps       = 3600;
+    int          spin_count      = 4096;  // polls before either side goes to sleep
+};
+
+// ————— SHARED LAYOUT ————— //
+// Everything below lives in the segment, so it must be plain data with address-free atomics.
+// Every field either side writes sits on its own cache line.
+namespace env_shared
+{
+    static const size_t   CACHE_LINE = 64;
+    static const uint32_t MAGIC      = 0x4C454E56;  // "LENV"
+    static const uint32_t VERSION    = 1;
+
+    enum Command : uint32_t
+    {
+        COMMAND_STEP,
+        COMMAND_RESET  // env e of the channel starts over on seed + e
+    };
+
+    struct Header
+    {
+        std::atomic<uint32_t> magic;  // written last, once the rest is ready
+        uint32_t version,
+                 client_count,
+                 envs_per_client,
+                 observation_size,
+                 worker_count;
+        uint64_t channel_stride,  // bytes from one channel to the next
+                 channels_offset;
+
+        alignas(CACHE_LINE) std::atomic<uint32_t> next_client;    // attach() claims channels from here
+        alignas(CACHE_LINE) std::atomic<uint32_t> shutting_down;
+    };
+
+    // One per server thread, right after the header
+    struct Doorbell
+    {
+        alignas(CACHE_LINE) std::atomic<uint32_t> rings;     // bumped by any of the thread's clients; the futex word
+                            std::atomic<uint32_t> sleeping;
+    };
+
+    // Followed by the channel's arrays: int32 actions, float observations, float rewards, int32 dones
+    struct Channel
+    {
+        alignas(CACHE_LINE) std::atomic<uint32_t> request;   // written by the client; the sequence number
+                            uint32_t              command,
+                                                  seed;
+        alignas(CACHE_LINE) std::atomic<uint32_t> response;  // written by the server; a futex word
+                            std::atomic<uint32_t> client_sleeping;
+    };
+}
+
+class EnvServer
+{
+private:
+    struct ChannelState
+    {
+        std::vector<LanderEnv*>   envs;
+        std::vector<unsigned int> seeds;     // what each env's next episode is played on
+        uint32_t                  served = 0;  // the last request answered
+    };
+
+    EnvServerConfig           m_config;
+    std::string               m_name;
+    void*                     m_segment = NULL,
+        *                     m_mapping = NULL;  // the file mapping handle, on Windows
+    size_t                    m_size    = 0;
+    std::vector<ChannelState> m_channels;
+    std::vector<std::thread>  m_workers;
+    std::atomic<bool>         m_running{ false };
+
+    env_shared::Header*   get_header() const { return (env_shared::Header*)m_segment; };
+    env_shared::Doorbell* get_doorbell(int worker) const;
+    env_shared::Channel*  get_channel(int client) const;
+
+    void worker_loop(int worker_index);
+    void serve(int client);
+
+public:
+    EnvServer() = default;
+    ~EnvServer();
+
+    EnvServer(const EnvServer&) = delete;
+    EnvServer& operator=(const EnvServer&) = delete;
+
+    // Creates the segment (replacing any stale one of the same name), the envs and the server
+    // threads. False if the segment can't be created.
+    bool start(const char* name, const EnvServerConfig& config);
+    // Wakes every client with attach() failing from then on and step() returning false, joins the
+    // threads and removes the segment
+    void stop();
+
+    int const get_worker_count() const { return (int)m_workers.size(); };
+};
+
+class EnvClient
+{
+private:
+    void*                     m_segment = NULL,
+        *                     m_mapping = NULL;
+    size_t                    m_size    = 0;
+    env_shared::Header*       m_header  = NULL;
+    env_shared::Doorbell*     m_doorbell = NULL;
+    env_shared::Channel*      m_channel = NULL;
+    uint32_t                  m_sequence = 0;
+    int                       m_spin_count = 4096;
+
+    int32_t* m_actions      = NULL;
+    float*   m_observations = NULL,
+         *   m_rewards      = NULL;
+    int32_t* m_dones        = NULL;
+
+    bool request(uint32_t command, uint32_t seed);
+
+public:
+    EnvClient() = default;
+    ~EnvClient();
+
+    EnvClient(const EnvClient&) = delete;
+    EnvClient& operator=(const EnvClient&) = delete;
+
+    // Claims the next free channel of the server's segment. False if there's no such segment, it
+    // is from another version, or every channel is taken.
+    bool attach(const char* name, int spin_count = 4096);
+    void detach();
+
+    // Each blocks until the server has answered. False once the server is stopping.
+    bool reset(unsigned int seed);
+    // One step of every env under get_actions(). An env that finished on the previous step is
+    // reset onto its next seed first, so the step that reports done still shows the final state.
+    bool step();
+
+    // ————— GETTERS ————— //
+    int      const get_env_count()    const { return m_header != NULL ? (int)m_header->envs_per_client : 0; };
+    int32_t*       get_actions()            { return m_actions; };       // LanderAction bits, one per env
+    const float*   get_observations() const { return m_observations; };  // env_count rows of LANDER_OBSERVATION_SIZE
+    const float*   get_rewards()      const { return m_rewards; };
+    const int32_t* get_dones()        const { return m_dones; };         // LanderDone codes
+};
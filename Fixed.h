@@ -0,0 +1,47 @@
+#pragma once
+
+// Q16.16 fixed point: 16 integer bits, 16 fraction bits, stored in an int32. Every operation is
+// plain integer arithmetic, so the same inputs give the same bits on any compiler, CPU or
+// optimisation level. Range is about +/-32768 with a resolution of 1/65536.
+#include <cmath>
+#include <cstdint>
+
+struct Fixed
+{
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    int32_t raw;
+
+    // Trivial, like float's, so glm can keep Fixed in its vector unions
+    Fixed() = default;
+
+    // Deterministic too: the scale by 2^16 is exact, and lround rounds the same everywhere
+    Fixed(float value) : raw((int32_t)std::lround((double)value * ONE)) {}
+
+    static Fixed from_raw(int32_t raw_value) { Fixed result; result.raw = raw_value; return result; }
+
+    explicit operator float() const { return (float)raw / (float)ONE; }
+
+    Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+    Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+    Fixed& operator*=(Fixed other) { *this = *this * other; return *this; }
+    Fixed& operator/=(Fixed other) { *this = *this / other; return *this; }
+
+    friend Fixed operator+(Fixed a, Fixed b) { return from_raw(a.raw + b.raw); }
+    friend Fixed operator-(Fixed a, Fixed b) { return from_raw(a.raw - b.raw); }
+    friend Fixed operator-(Fixed a)          { return from_raw(-a.raw); }
+
+    // 64-bit intermediates; the shift rounds toward negative infinity on every target we build for
+    friend Fixed operator*(Fixed a, Fixed b) { return from_raw((int32_t)(((int64_t)a.raw * b.raw) >> FRACTION_BITS)); }
+    friend Fixed operator/(Fixed a, Fixed b) { return from_raw((int32_t)(((int64_t)a.raw * ONE) / b.raw)); }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool operator< (Fixed a, Fixed b) { return a.raw <  b.raw; }
+    friend bool operator> (Fixed a, Fixed b) { return a.raw >  b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+};
+
+inline Fixed fabs(Fixed value) { return Fixed::from_raw(value.raw < 0 ? -value.raw : value.raw); }
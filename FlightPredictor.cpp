@@ -0,0 +1,102 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "FlightPredictor.h"
+
+FlightPredictor::FlightPredictor(const Entity& lander, float movement_x, bool booster_active, float boosting_timestep)
+{
+    m_position = glm::vec2(lander.get_position());
+    m_velocity = glm::vec2(lander.get_velocity());
+
+    glm::vec2 field = lander.get_field_acceleration();
+    float thrust    = (float)lander.m_thrust,
+          burn_rate = (float)lander.m_burn_rate,
+          mass      = (float)(lander.m_dry_mass + lander.m_fuel);
+
+    // STEP 1: Vertically, everything that holds still goes into one acceleration; only a booster
+    //         that burns fuel is left over, and only until the tank is dry
+    m_acceleration_y = lander.get_acceleration().y + field.y;
+    m_fuel = (float)lander.m_fuel;
+
+    if (booster_active && thrust > 0.0f && burn_rate > 0.0f)
+    {
+        m_exhaust_speed = thrust / burn_rate;
+        m_burn_rate     = burn_rate;
+        m_start_mass    = mass;
+        m_burn_time     = std::max(m_fuel, 0.0f) / burn_rate;
+    }
+    else if (booster_active)
+    {
+        m_acceleration_y += lander.get_engine_acceleration(boosting_timestep);
+    }
+
+    // STEP 2: Sideways, the push against drag. Moving, drag works against the motion; if that
+    //         slows the lander to rest, it stays there unless the push beats drag.
+    float push = movement_x * lander.get_speed() + field.x,
+          drag = (float)lander.m_drag;
+
+    if (m_velocity.x != 0.0f)
+    {
+        float direction = m_velocity.x > 0.0f ? 1.0f : -1.0f;
+        m_slowing_acceleration = push - drag * direction;
+        m_stop_time = m_slowing_acceleration * direction < 0.0f ? -m_velocity.x / m_slowing_acceleration : INFINITY;
+    }
+
+    if (std::fabs(push) > drag) m_resting_acceleration = push - (push > 0.0f ? drag : -drag);
+}
+
+glm::vec2 FlightPredictor::get_position(float time) const
+{
+    // Sideways: slowing until at rest, then pushed off from rest
+    float slowing = std::min(time, m_stop_time),
+          resting = time - slowing;
+    float x = m_position.x + m_velocity.x * slowing + 0.5f * m_slowing_acceleration * slowing * slowing
+                           + 0.5f * m_resting_acceleration * resting * resting;
+
+    // Vertically: the steady acceleration, plus whatever the burn adds and the coasting after it
+    float y = m_position.y + m_velocity.y * time + 0.5f * m_acceleration_y * time * time;
+    float burn = std::min(time, m_burn_time);
+    if (burn > 0.0f)
+    {
+        float end_mass = m_start_mass - m_burn_rate * burn,
+              log_ratio = std::log(m_start_mass / end_mass);
+        y += m_exhaust_speed * (burn - end_mass / m_burn_rate * log_ratio)  // during the burn
+           + m_exhaust_speed * log_ratio * (time - burn);                   // coasting on what it gave
+    }
+
+    return glm::vec2(x, y);
+}
+
+glm::vec2 FlightPredictor::get_velocity(float time) const
+{
+    float velocity_x = time < m_stop_time ? m_velocity.x + m_slowing_acceleration * time
+                                          : m_resting_acceleration * (time - m_stop_time);
+
+    float velocity_y = m_velocity.y + m_acceleration_y * time;
+    float burn = std::min(time, m_burn_time);
+    if (burn > 0.0f) velocity_y += m_exhaust_speed * std::log(m_start_mass / (m_start_mass - m_burn_rate * burn));
+
+    return glm::vec2(velocity_x, velocity_y);
+}
+
+float FlightPredictor::get_fuel(float time) const
+{
+    return std::max(m_fuel - m_burn_rate * std::min(time, m_burn_time), 0.0f);
+}
+
+void FlightPredictor::sample_path(float horizon, glm::vec2* points, int count) const
+{
+    for (int i = 0; i < count; i++)
+    {
+        points[i] = get_position(count > 1 ? horizon * (float)i / (float)(count - 1) : 0.0f);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Where a lander will be after holding one set of controls for a while, worked out in closed form
+// rather than stepped, so a planner can weigh many controls, or the HUD draw where the lander is
+// headed, for the price of a few logs. It flies the model the rate integrators close in on as
+// their step shrinks, in free flight: platforms, terrain and the ground are not seen, and the
+// force-field acceleration at the start is held throughout.
+//
+// Vertically that is gravity plus the booster, which with fuel (FuelModel.h) burns until the tank
+// is dry and then coasts. Sideways, the movement pushes against drag, and since drag only ever
+// slows there are at most two pieces: until the lander comes to rest, and from rest on.
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+
+class FlightPredictor
+{
+private:
+    glm::vec2 m_position = glm::vec2(0.0f),
+              m_velocity = glm::vec2(0.0f);
+
+    // ————— VERTICAL ————— //
+    float m_acceleration_y = 0.0f;   // gravity, the field's, and a booster that never runs out
+    float m_exhaust_speed = 0.0f,    // thrust over burn rate, while a fuelled booster burns
+          m_burn_rate     = 0.0f,
+          m_start_mass    = 1.0f,
+          m_burn_time     = 0.0f,    // until the tank is dry
+          m_fuel          = 0.0f;
+
+    // ————— SIDEWAYS ————— //
+    float m_slowing_acceleration = 0.0f,  // until m_stop_time
+          m_stop_time            = 0.0f,
+          m_resting_acceleration = 0.0f;  // from rest after it
+
+public:
+    FlightPredictor() = default;
+    // `lander` as it is now, holding movement_x and the booster from here on. boosting_timestep is
+    // the step a plain m_boosting_power booster kicks once in (see Entity::get_engine_acceleration).
+    FlightPredictor(const Entity& lander, float movement_x, bool booster_active, float boosting_timestep = BOOST_REFERENCE_TIMESTEP);
+
+    glm::vec2 get_position(float time) const;
+    glm::vec2 get_velocity(float time) const;
+    float     get_fuel(float time) const;
+
+    // `count` positions evenly over [0, horizon], both ends included, for drawing
+    void sample_path(float horizon, glm::vec2* points, int count) const;
+};
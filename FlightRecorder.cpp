@@ -0,0 +1,92 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include "FlightRecorder.h"
+#include "Trace.h"
+
+static const int FATAL_SIGNALS[] = { SIGSEGV, SIGABRT, SIGFPE, SIGILL };
+static const int FATAL_SIGNAL_COUNT = (int)(sizeof(FATAL_SIGNALS) / sizeof(FATAL_SIGNALS[0]));
+
+// The handler gets nothing but the signal number, so the recorder it dumps is kept here
+static FlightRecorder* volatile s_crash_recorder = NULL;
+
+static void copy_path(char* destination, const char* source, size_t size)
+{
+    std::strncpy(destination, source != NULL ? source : "", size - 1);
+    destination[size - 1] = '\0';
+}
+
+void FlightRecorder::handle_fatal_signal(int signal_number)
+{
+    // STEP 1: Once only, in case the dump itself faults
+    FlightRecorder* recorder = s_crash_recorder;
+    s_crash_recorder = NULL;
+    if (recorder != NULL && recorder->m_crash_filepath[0] != '\0') recorder->dump(recorder->m_crash_filepath);
+
+    // STEP 2: Down the way it would have gone without us, core dump and exit code included
+    std::signal(signal_number, SIG_DFL);
+    std::raise(signal_number);
+}
+
+void FlightRecorder::initialise(const char* crash_filepath, const char* hitch_filepath, float hitch_ms)
+{
+    copy_path(m_crash_filepath, crash_filepath, sizeof(m_crash_filepath));
+    copy_path(m_hitch_filepath, hitch_filepath, sizeof(m_hitch_filepath));
+    m_hitch_ms = hitch_ms > 0.0f ? hitch_ms : 0.0f;
+    m_recorded_count = 0;
+    m_hitch_dump_count = 0;
+
+    s_crash_recorder = this;
+    for (int i = 0; i < FATAL_SIGNAL_COUNT; i++) std::signal(FATAL_SIGNALS[i], handle_fatal_signal);
+}
+
+void FlightRecorder::cleanup()
+{
+    if (s_crash_recorder != this) return;
+
+    s_crash_recorder = NULL;
+    for (int i = 0; i < FATAL_SIGNAL_COUNT; i++) std::signal(FATAL_SIGNALS[i], SIG_DFL);
+}
+
+bool FlightRecorder::check_hitch(float frame_ms, double time)
+{
+    if (!(m_hitch_ms > 0.0f) || frame_ms <= m_hitch_ms || m_hitch_filepath[0] == '\0') return false;
+    if (time - m_last_hitch_dump < HITCH_COOLDOWN_SECONDS) return false;
+
+    TRACE_ZONE("FlightRecorder::dump");
+    m_last_hitch_dump = time;
+    if (!dump(m_hitch_filepath)) return false;
+    m_hitch_dump_count++;
+    return true;
+}
+
+bool FlightRecorder::dump(const char* filepath) const
+{
+    FILE* file = std::fopen(filepath, "wb");
+    if (file == NULL) return false;
+
+    TelemetryFileHeader header;
+    std::memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version     = TELEMETRY_VERSION;
+    header.record_size = sizeof(TelemetryRecord);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // The ring in two pieces: from the oldest to the end of the array, then from its start
+    size_t held   = (size_t)(m_recorded_count < CAPACITY ? m_recorded_count : CAPACITY),
+           oldest = (size_t)(m_recorded_count < CAPACITY ? 0 : m_recorded_count % CAPACITY),
+           first  = held < CAPACITY - oldest ? held : CAPACITY - oldest;
+    if (first > 0)    ok = std::fwrite(m_records + oldest, sizeof(TelemetryRecord), first, file) == first && ok;
+    if (held > first) ok = std::fwrite(m_records, sizeof(TelemetryRecord), held - first, file) == held - first && ok;
+
+    return std::fclose(file) == 0 && ok;
+}
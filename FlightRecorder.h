@@ -0,0 +1,59 @@
+#pragma once
+
+// The last few seconds of the game, always kept, for when a cabinet reports a freeze or a crash.
+// Every frame's telemetry records (TelemetryLog.h) are copied into a ring that is part of the
+// recorder itself, so recording never allocates and never touches the disk. The ring is dumped,
+// oldest record first, in TelemetryLog's file format, so TelemetryDecoder reads dumps too:
+//
+//     on a fatal signal (SIGSEGV, SIGABRT, SIGFPE, SIGILL), to the crash file, before the
+//     process goes down the way it would have without the recorder
+//     on a hitch, a frame longer than the threshold, to the hitch file; at most one dump every
+//     HITCH_COOLDOWN_SECONDS, since writing one is a hitch of its own
+//
+// Only one recorder can hold the signal handlers at a time.
+#include "TelemetryLog.h"
+
+class FlightRecorder
+{
+public:
+    static const int CAPACITY = 2048;  // records: over ten seconds of three a frame at 60 fps
+    static constexpr double HITCH_COOLDOWN_SECONDS = 5.0;
+
+private:
+    static const int MAX_PATH_LENGTH = 256;
+
+    TelemetryRecord m_records[CAPACITY];
+    long long       m_recorded_count = 0;  // m_records[m_recorded_count % CAPACITY] is next
+
+    // Copied in up front, so the signal handler has nothing to build
+    char   m_crash_filepath[MAX_PATH_LENGTH] = {},
+           m_hitch_filepath[MAX_PATH_LENGTH] = {};
+    float  m_hitch_ms = 0.0f;               // 0 for no hitch dumps
+    double m_last_hitch_dump = -HITCH_COOLDOWN_SECONDS;
+    int    m_hitch_dump_count = 0;
+
+    static void handle_fatal_signal(int signal_number);
+
+public:
+    // Installs the signal handlers. `hitch_ms` of 0 leaves hitches alone.
+    void initialise(const char* crash_filepath, const char* hitch_filepath, float hitch_ms);
+    // Gives the signals back to their defaults
+    void cleanup();
+
+    void record(const TelemetryRecord& record)
+    {
+        m_records[m_recorded_count % CAPACITY] = record;
+        m_recorded_count++;
+    };
+
+    // Once a frame, with how long the frame took start to start and when it ended, in seconds on
+    // any steady clock. Dumps to the hitch file if it ran long; true if it did.
+    bool check_hitch(float frame_ms, double time);
+
+    // Everything held, oldest first, with TelemetryLog's header. Only stdio and no allocation of
+    // its own, so it is as close to safe inside a signal handler as portable code gets.
+    bool dump(const char* filepath) const;
+
+    long long const get_recorded_count()   const { return m_recorded_count; };
+    int       const get_hitch_dump_count() const { return m_hitch_dump_count; };
+};
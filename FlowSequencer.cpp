@@ -0,0 +1,187 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <exception>
+#include <new>
+#include "FlowSequencer.h"
+
+// ————— FRAME POOL ————— //
+// Game flow keeps a handful of scripts alive at once, each with a frame of a few hundred bytes
+namespace
+{
+    const size_t FRAME_SIZE  = 512;
+    const int    FRAME_COUNT = 32;
+
+    struct FramePool
+    {
+        alignas(std::max_align_t) unsigned char frames[FRAME_COUNT][FRAME_SIZE];
+        void* free_frames[FRAME_COUNT];
+        int   free_count;
+
+        FramePool() : free_count(FRAME_COUNT)
+        {
+            for (int i = 0; i < FRAME_COUNT; i++) free_frames[i] = frames[FRAME_COUNT - 1 - i];
+        }
+
+        bool owns(void* frame) const
+        {
+            return frame >= (const void*)frames && frame < (const void*)(frames + FRAME_COUNT);
+        }
+    };
+
+    FramePool& get_frame_pool()
+    {
+        static FramePool pool;
+        return pool;
+    }
+}
+
+void* FlowTask::promise_type::operator new(size_t size)
+{
+    FramePool& pool = get_frame_pool();
+    if (size <= FRAME_SIZE && pool.free_count > 0) return pool.free_frames[--pool.free_count];
+    return ::operator new(size);
+}
+
+void FlowTask::promise_type::operator delete(void* frame, size_t size)
+{
+    FramePool& pool = get_frame_pool();
+    if (pool.owns(frame)) pool.free_frames[pool.free_count++] = frame;
+    else                  ::operator delete(frame);
+}
+
+void FlowTask::promise_type::unhandled_exception()
+{
+    // A flow script that throws has left the game in a state nothing else knows how to get out of
+    std::terminate();
+}
+
+// ————— FLOW TASK ————— //
+FlowTask& FlowTask::operator=(FlowTask&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle) m_handle.destroy();
+        m_handle = other.m_handle;
+        other.m_handle = {};
+    }
+    return *this;
+}
+
+FlowTask::~FlowTask()
+{
+    // Also destroys whatever script this one is co_awaiting, since that lives in its frame
+    if (m_handle) m_handle.destroy();
+}
+
+std::coroutine_handle<> FlowTask::await_suspend(std::coroutine_handle<> awaiting)
+{
+    m_handle.promise().continuation = awaiting;
+    return m_handle;
+}
+
+// ————— SEQUENCER ————— //
+void FlowSequencer::TimerAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    sequencer.m_timers.push_back(Timer{ sequencer.m_time + seconds, handle });
+    std::push_heap(sequencer.m_timers.begin(), sequencer.m_timers.end(), [](const Timer& a, const Timer& b) { return a.time > b.time; });
+}
+
+void FlowSequencer::StepAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    sequencer.m_step_timers.schedule((uint64_t)steps, [](void* frame) { std::coroutine_handle<>::from_address(frame).resume(); }, handle.address());
+}
+
+void FlowSequencer::EventAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    sequencer.m_event_waiters.push_back(EventWaiter{ events, &signalled, handle });
+}
+
+void FlowSequencer::start(FlowTask script)
+{
+    std::coroutine_handle<> handle = script.get_handle();
+    m_scripts.push_back(std::move(script));
+    handle.resume();
+
+    if (m_scripts.back().is_finished()) m_scripts.pop_back();
+}
+
+void FlowSequencer::stop_all()
+{
+    m_frame_waiters.clear();
+    m_timers.clear();
+    m_step_timers.clear(m_step_timers.get_now());
+    m_event_waiters.clear();
+    m_scripts.clear();
+}
+
+void FlowSequencer::update(double delta_time)
+{
+    m_time += delta_time;
+
+    // STEP 1: Everything waiting on a frame; the ones that wait again land in the emptied list
+    m_resuming.swap(m_frame_waiters);
+    for (std::coroutine_handle<> handle : m_resuming) handle.resume();
+    m_resuming.clear();
+
+    // STEP 2: Timers, earliest first, including any set by the scripts just resumed that are
+    //         already due
+    while (!m_timers.empty() && m_timers.front().time <= m_time)
+    {
+        std::pop_heap(m_timers.begin(), m_timers.end(), [](const Timer& a, const Timer& b) { return a.time > b.time; });
+        std::coroutine_handle<> handle = m_timers.back().handle;
+        m_timers.pop_back();
+        handle.resume();
+    }
+
+    // STEP 3: Let go of the scripts that have run to the end
+    m_scripts.erase(std::remove_if(m_scripts.begin(), m_scripts.end(), [](const FlowTask& script) { return script.is_finished(); }), m_scripts.end());
+}
+
+void FlowSequencer::advance_steps(int steps)
+{
+    if (steps <= 0) return;
+
+    m_step_timers.advance((uint64_t)steps);
+    m_scripts.erase(std::remove_if(m_scripts.begin(), m_scripts.end(), [](const FlowTask& script) { return script.is_finished(); }), m_scripts.end());
+}
+
+void FlowSequencer::signal(int event)
+{
+    // STEP 1: Take the waiters off the list before resuming any, since they may wait again. The
+    //         list is swapped out so a script can signal another in turn.
+    std::vector<EventWaiter> signalled;
+    signalled.swap(m_signalled);
+    signalled.clear();
+
+    size_t kept = 0;
+    for (EventWaiter& waiter : m_event_waiters)
+    {
+        if (waiter.events & event) signalled.push_back(waiter);
+        else                       m_event_waiters[kept++] = waiter;
+    }
+    m_event_waiters.resize(kept);
+
+    // STEP 2: Resume them, each told which of its events it was
+    for (EventWaiter& waiter : signalled)
+    {
+        *waiter.signalled = waiter.events & event;
+        waiter.handle.resume();
+    }
+    if (m_signalled.capacity() < signalled.capacity()) m_signalled.swap(signalled);
+
+    m_scripts.erase(std::remove_if(m_scripts.begin(), m_scripts.end(), [](const FlowTask& script) { return script.is_finished(); }), m_scripts.end());
+}
+
+double const FlowSequencer::get_seconds_until_timer() const
+{
+    return m_timers.empty() ? -1.0 : std::max(m_timers.front().time - m_time, 0.0);
+}
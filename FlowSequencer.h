@@ -0,0 +1,175 @@
+#pragma once
+
+// Game flow as scripts rather than flags: a flow script is a C++20 coroutine returning FlowTask
+// that co_awaits what it needs next, from a FlowSequencer that resumes it when it's due:
+//
+//   FlowTask level_flow()
+//   {
+//       int outcome = co_await g_flow.wait_event(FLOW_WON | FLOW_LOST);
+//       show_banner(outcome);
+//       co_await g_flow.wait_seconds(2.0);
+//       show_hint();
+//       co_await g_flow.wait_steps(120);
+//       hide_hint();
+//   }
+//
+// Scripts can also co_await each other, and carry on when the one they started finishes.
+//
+// wait_seconds() is on frame time; wait_steps() is on simulation steps, as advance_steps() counts
+// them, so it stops with the simulation and comes out the same on every machine.
+//
+// A script waiting on an event or a timer costs nothing per frame: events are only looked at
+// when signalled, update() only checks the earliest timer, and advance_steps() only the slots of
+// a TimerWheel that come due. Only next_frame() waiters run
+// every frame. Coroutine frames come from a fixed pool rather than the heap, and the waiting
+// lists keep their capacity, so nothing is allocated once the scripts are warmed up.
+//
+// Everything here is for one thread, the one that calls update().
+#include <coroutine>
+#include <cstddef>
+#include <vector>
+#include "TimerWheel.h"
+
+class FlowTask
+{
+public:
+    struct promise_type;
+
+    // Hands back to whichever script co_awaited this one, if any
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; };
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+        void await_resume() noexcept {};
+    };
+
+    struct promise_type
+    {
+        std::coroutine_handle<> continuation;
+
+        FlowTask get_return_object() { return FlowTask(std::coroutine_handle<promise_type>::from_promise(*this)); };
+        // Started by FlowSequencer::start() or by being co_awaited, not on the call
+        std::suspend_always initial_suspend() noexcept { return {}; };
+        FinalAwaiter final_suspend() noexcept { return {}; };
+        void return_void() {};
+        void unhandled_exception();
+
+        // From the frame pool, falling back on the heap for frames too big for it or once it's full
+        static void* operator new(size_t size);
+        static void  operator delete(void* frame, size_t size);
+    };
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+public:
+    FlowTask() = default;
+    explicit FlowTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {};
+    FlowTask(FlowTask&& other) noexcept : m_handle(other.m_handle) { other.m_handle = {}; };
+    FlowTask& operator=(FlowTask&& other) noexcept;
+    FlowTask(const FlowTask&) = delete;
+    FlowTask& operator=(const FlowTask&) = delete;
+    ~FlowTask();
+
+    // co_await another script: runs it, and picks up here once it has finished
+    bool await_ready() const { return !m_handle || m_handle.done(); };
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting);
+    void await_resume() {};
+
+    bool const is_finished() const { return !m_handle || m_handle.done(); };
+    std::coroutine_handle<promise_type> const get_handle() const { return m_handle; };
+};
+
+inline std::coroutine_handle<> FlowTask::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+{
+    std::coroutine_handle<> continuation = handle.promise().continuation;
+    return continuation ? continuation : std::noop_coroutine();
+}
+
+class FlowSequencer
+{
+public:
+    struct FrameAwaiter
+    {
+        FlowSequencer& sequencer;
+        bool await_ready() { return false; };
+        void await_suspend(std::coroutine_handle<> handle) { sequencer.m_frame_waiters.push_back(handle); };
+        void await_resume() {};
+    };
+
+    struct TimerAwaiter
+    {
+        FlowSequencer& sequencer;
+        double         seconds;
+        bool await_ready() { return seconds <= 0.0; };
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() {};
+    };
+
+    struct StepAwaiter
+    {
+        FlowSequencer& sequencer;
+        int            steps;
+        bool await_ready() { return steps <= 0; };
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() {};
+    };
+
+    // Resumes with whichever of the events it waited on was signalled
+    struct EventAwaiter
+    {
+        FlowSequencer& sequencer;
+        int            events;
+        int            signalled = 0;
+        bool await_ready() { return false; };
+        void await_suspend(std::coroutine_handle<> handle);
+        int  await_resume() { return signalled; };
+    };
+
+private:
+    struct Timer
+    {
+        double                  time;
+        std::coroutine_handle<> handle;
+    };
+
+    struct EventWaiter
+    {
+        int                     events;
+        int*                    signalled;
+        std::coroutine_handle<> handle;
+    };
+
+    std::vector<FlowTask>                m_scripts;
+    std::vector<std::coroutine_handle<>> m_frame_waiters,
+                                         m_resuming;  // swapped with m_frame_waiters each update
+    std::vector<Timer>                   m_timers;    // a min-heap on time
+    TimerWheel                           m_step_timers;
+    std::vector<EventWaiter>             m_event_waiters,
+                                         m_signalled;
+    double                               m_time = 0.0;
+
+public:
+    // Runs the script up to its first co_await; the sequencer owns it from then on
+    void start(FlowTask script);
+    // Destroys every script, wherever it's waiting. Not for calling from inside one.
+    void stop_all();
+
+    // Resumes the scripts waiting on a frame, then any whose timers are due
+    void update(double delta_time);
+    // Resumes the scripts whose wait_steps() come due over the next `steps` simulation steps
+    void advance_steps(int steps);
+    // Resumes the scripts waiting on any of the bits in `event`. Signals nobody waits on are dropped.
+    void signal(int event);
+
+    FrameAwaiter next_frame()                { return FrameAwaiter{ *this }; };
+    TimerAwaiter wait_seconds(double seconds) { return TimerAwaiter{ *this, seconds }; };
+    StepAwaiter  wait_steps(int steps)        { return StepAwaiter{ *this, steps }; };
+    EventAwaiter wait_event(int events)       { return EventAwaiter{ *this, events }; };
+
+    // Whether update() has anything to do next frame besides timers
+    bool   const has_frame_waiters() const { return !m_frame_waiters.empty(); };
+    // Until the earliest timer, or a negative number with none set
+    double const get_seconds_until_timer() const;
+    int    const get_script_count() const { return (int)m_scripts.size(); };
+};
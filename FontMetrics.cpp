@@ -0,0 +1,121 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include "FontMetrics.h"
+#include "SpriteSheet.h"
+
+void FontMetrics::make_grid()
+{
+    glm::vec4 frames[FONT_SHEET.FRAME_COUNT];
+    map_sheet(FONT_SHEET, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), frames);
+
+    for (int glyph = 0; glyph < GLYPH_COUNT; glyph++)
+    {
+        m_glyphs[glyph].uv_rect = frames[glyph];
+        m_glyphs[glyph].bearing = glm::vec2(0.0f, 0.5f);
+        m_glyphs[glyph].size    = glm::vec2(1.0f);
+        m_glyphs[glyph].advance = 1.0f;
+    }
+
+    m_kerning.clear();
+    index_kerning();
+    m_proportional = false;
+}
+
+bool FontMetrics::load(const char* filepath)
+{
+    // Lines of `font <version> <atlas width> <atlas height> <texels per em>`, then
+    // `glyph <code> <x> <y> <width> <height> <bearing x> <bearing y> <advance>` with the rect in
+    // atlas texels, and `kern <first> <second> <amount>`; # starts a comment
+    std::ifstream file(filepath);
+    if (!file) return false;
+
+    GlyphMetrics glyphs[GLYPH_COUNT];
+    std::vector<KerningPair> kerning;
+    float atlas_width = 0.0f, atlas_height = 0.0f, texels_per_em = 0.0f;
+
+    std::string keyword;
+    while (file >> keyword)
+    {
+        if (keyword[0] == '#')
+        {
+            std::getline(file, keyword);
+        }
+        else if (keyword == "font")
+        {
+            int version;
+            if (!(file >> version >> atlas_width >> atlas_height >> texels_per_em) || version != 1) return false;
+            if (atlas_width <= 0.0f || atlas_height <= 0.0f || texels_per_em <= 0.0f) return false;
+        }
+        else if (keyword == "glyph")
+        {
+            int code;
+            float x, y, width, height;
+            GlyphMetrics metrics;
+            if (!(file >> code >> x >> y >> width >> height >> metrics.bearing.x >> metrics.bearing.y >> metrics.advance)) return false;
+            if (code < 0 || code >= GLYPH_COUNT || texels_per_em <= 0.0f) return false;
+
+            metrics.uv_rect = glm::vec4(x / atlas_width, y / atlas_height, width / atlas_width, height / atlas_height);
+            metrics.size    = glm::vec2(width, height) / texels_per_em;
+            glyphs[code] = metrics;
+        }
+        else if (keyword == "kern")
+        {
+            int first, second;
+            float amount;
+            if (!(file >> first >> second >> amount)) return false;
+            if (first < 0 || first >= GLYPH_COUNT || second < 0 || second >= GLYPH_COUNT) return false;
+
+            kerning.push_back({ (unsigned char)first, (unsigned char)second, amount });
+        }
+        else return false;
+    }
+    if (texels_per_em <= 0.0f) return false;
+
+    std::copy(glyphs, glyphs + GLYPH_COUNT, m_glyphs);
+    m_kerning = std::move(kerning);
+    std::sort(m_kerning.begin(), m_kerning.end(),
+              [](const KerningPair& a, const KerningPair& b) { return a.first != b.first ? a.first < b.first : a.second < b.second; });
+    index_kerning();
+    m_proportional = true;
+    return true;
+}
+
+void FontMetrics::index_kerning()
+{
+    int pair = 0;
+    for (int glyph = 0; glyph <= GLYPH_COUNT; glyph++)
+    {
+        while (pair < (int)m_kerning.size() && m_kerning[pair].first < glyph) pair++;
+        m_kerning_starts[glyph] = pair;
+    }
+}
+
+void FontMetrics::place(glm::vec4 region)
+{
+    for (GlyphMetrics& glyph : m_glyphs)
+    {
+        glyph.uv_rect = glm::vec4(region.x + glyph.uv_rect.x * region.z, region.y + glyph.uv_rect.y * region.w,
+                                  glyph.uv_rect.z * region.z, glyph.uv_rect.w * region.w);
+    }
+}
+
+float FontMetrics::get_kerning(unsigned char first, unsigned char second) const
+{
+    // A glyph kerns against a handful of others at most, so a scan of its own pairs is enough
+    for (int pair = m_kerning_starts[first]; pair < m_kerning_starts[first + 1]; pair++)
+    {
+        if (m_kerning[pair].second == second) return m_kerning[pair].amount;
+    }
+    return 0.0f;
+}
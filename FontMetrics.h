@@ -0,0 +1,57 @@
+#pragma once
+
+// Where each glyph sits in the font's texture and how text made of them is laid out: the quad's
+// size and bearing from the pen, how far the pen then moves on, and kerning between pairs. All in
+// ems, one em being the height of a cell of the original 16x16 sheet, so screen_size scales them
+// like it always has.
+//
+// Two sources: make_grid() describes the fixed 16x16 sheet as it always was, every glyph a full
+// cell a full em apart, and load() reads the metrics SdfFontGenerator --metrics writes next to a
+// tightly packed atlas. Either way place() then maps the UVs into the atlas region the font
+// texture ended up in, and TextGeometry lays text out from the result.
+#include <vector>
+#include "glm/mat4x4.hpp"
+
+struct GlyphMetrics
+{
+    glm::vec4 uv_rect = glm::vec4(0.0f);  // u, v, width, height; v grows downwards
+    glm::vec2 bearing = glm::vec2(0.0f);  // the quad's top-left corner from the pen, up being positive
+    glm::vec2 size    = glm::vec2(0.0f);  // zero for a glyph with nothing to draw, like a space
+    float     advance = 0.0f;
+};
+
+class FontMetrics
+{
+private:
+    static const int GLYPH_COUNT = 256;
+
+    struct KerningPair
+    {
+        unsigned char first,
+                      second;
+        float         amount;  // added to the first glyph's advance; negative pulls the pair together
+    };
+
+    GlyphMetrics             m_glyphs[GLYPH_COUNT];
+    std::vector<KerningPair> m_kerning;  // sorted by first, then second
+    int                      m_kerning_starts[GLYPH_COUNT + 1] = {};  // first's pairs begin here
+    bool                     m_proportional = false;
+
+    void index_kerning();
+
+public:
+    // The 16x16 FONT_SHEET, monospaced: every glyph's quad is its whole cell
+    void make_grid();
+
+    // A metrics file from SdfFontGenerator --metrics. On failure the metrics are left as they were.
+    bool load(const char* filepath);
+
+    // Maps every glyph's UVs from the font texture's own 0-1 plane into `region` of a bigger page
+    void place(glm::vec4 region);
+
+    const GlyphMetrics& get_glyph(unsigned char glyph) const { return m_glyphs[glyph]; };
+    float get_kerning(unsigned char first, unsigned char second) const;
+
+    bool const is_proportional()   const { return m_proportional; };
+    int  const get_kerning_count() const { return (int)m_kerning.size(); };
+};
@@ -0,0 +1,291 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "ForceFields.h"
+#include "SimdDispatch.h"
+
+#ifdef LANDER_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef LANDER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+const int   FORCE_FIELD_MAX_CELLS = 4096;
+const float FORCE_FIELD_MIN_DISTANCE_SQUARED = 1e-6f;  // keeps 1/r finite at a well's centre
+
+// ————— FIELDS ————— //
+void ForceFields::add_gravity_well(glm::vec2 centre, float radius, float strength)
+{
+    Field field = {};
+    field.min = centre - glm::vec2(radius);
+    field.max = centre + glm::vec2(radius);
+    field.centre = centre;
+    field.well = strength;
+    field.inverse_radius = 1.0f / radius;
+    field.radius_squared = radius * radius;
+    m_fields.push_back(field);
+}
+
+void ForceFields::add_wind_zone(glm::vec2 min, glm::vec2 max, glm::vec2 acceleration)
+{
+    Field field = {};
+    field.min = min;
+    field.max = max;
+    field.centre = (min + max) / 2.0f;
+    field.constant = acceleration;
+    field.radius_squared = INFINITY;
+    m_fields.push_back(field);
+}
+
+void ForceFields::add_tractor_beam(glm::vec2 min, glm::vec2 max, float strength)
+{
+    Field field = {};
+    field.min = min;
+    field.max = max;
+    field.centre = (min + max) / 2.0f;
+    field.spring = strength;
+    field.radius_squared = INFINITY;
+    m_fields.push_back(field);
+}
+
+void ForceFields::clear()
+{
+    m_fields.clear();
+    m_cell_starts.clear();
+    std::vector<float>* columns[] = { &m_min_x, &m_min_y, &m_max_x, &m_max_y, &m_centre_x, &m_centre_y, &m_constant_x, &m_constant_y,
+                                      &m_spring, &m_well, &m_inverse_radius, &m_radius_squared };
+    for (std::vector<float>* column : columns) column->clear();
+    m_columns = m_rows = 0;
+}
+
+void ForceFields::pack(int row, const Field& field)
+{
+    m_min_x[row] = field.min.x;
+    m_min_y[row] = field.min.y;
+    m_max_x[row] = field.max.x;
+    m_max_y[row] = field.max.y;
+    m_centre_x[row] = field.centre.x;
+    m_centre_y[row] = field.centre.y;
+    m_constant_x[row] = field.constant.x;
+    m_constant_y[row] = field.constant.y;
+    m_spring[row] = field.spring;
+    m_well[row] = field.well;
+    m_inverse_radius[row] = field.inverse_radius;
+    m_radius_squared[row] = field.radius_squared;
+}
+
+// ————— GRID ————— //
+void ForceFields::build(float cell_size)
+{
+    m_cell_starts.clear();
+    m_columns = m_rows = 0;
+    if (m_fields.empty()) return;
+
+    // STEP 1: Bounds of every field, and the cell size if none was given: the smallest field's,
+    //         doubled until the grid stays under FORCE_FIELD_MAX_CELLS
+    glm::vec2 min = glm::vec2(INFINITY), max = glm::vec2(-INFINITY);
+    float smallest_extent = INFINITY;
+    for (const Field& field : m_fields)
+    {
+        min = glm::min(min, field.min);
+        max = glm::max(max, field.max);
+        smallest_extent = std::min(smallest_extent, std::max(field.max.x - field.min.x, field.max.y - field.min.y));
+    }
+
+    m_origin    = min;
+    m_cell_size = cell_size > 0.0f ? cell_size : std::max(smallest_extent, 0.001f);
+    for (;;)
+    {
+        m_columns = (int)std::min(floorf((max.x - min.x) / m_cell_size) + 1.0f, (float)FORCE_FIELD_MAX_CELLS + 1.0f);
+        m_rows    = (int)std::min(floorf((max.y - min.y) / m_cell_size) + 1.0f, (float)FORCE_FIELD_MAX_CELLS + 1.0f);
+        if (m_columns * m_rows <= FORCE_FIELD_MAX_CELLS) break;
+        m_cell_size *= 2.0f;
+    }
+
+    // STEP 2: Count the fields touching each cell, padded to whole LANES, and turn the counts
+    //         into offsets
+    std::vector<int> first_column(m_fields.size()), first_row(m_fields.size()), last_column(m_fields.size()), last_row(m_fields.size());
+    m_cell_starts.assign(m_columns * m_rows + 1, 0);
+
+    for (size_t i = 0; i < m_fields.size(); i++)
+    {
+        const Field& field = m_fields[i];
+        first_column[i] = (int)floorf((field.min.x - m_origin.x) / m_cell_size);
+        first_row[i]    = (int)floorf((field.min.y - m_origin.y) / m_cell_size);
+        last_column[i]  = std::min((int)floorf((field.max.x - m_origin.x) / m_cell_size), m_columns - 1);
+        last_row[i]     = std::min((int)floorf((field.max.y - m_origin.y) / m_cell_size), m_rows - 1);
+
+        for (int row = first_row[i]; row <= last_row[i]; row++)
+            for (int column = first_column[i]; column <= last_column[i]; column++) m_cell_starts[row * m_columns + column + 1]++;
+    }
+
+    for (int c = 1; c <= m_columns * m_rows; c++)
+    {
+        m_cell_starts[c] = m_cell_starts[c - 1] + (m_cell_starts[c] + LANES - 1) / LANES * LANES;
+    }
+
+    // STEP 3: Every row starts out as padding that nothing is inside; then each field is copied
+    //         into the cells it touches, in the order it was added
+    Field padding = {};
+    padding.min = glm::vec2(INFINITY);
+    padding.max = glm::vec2(-INFINITY);
+
+    std::vector<float>* columns[] = { &m_min_x, &m_min_y, &m_max_x, &m_max_y, &m_centre_x, &m_centre_y, &m_constant_x, &m_constant_y,
+                                      &m_spring, &m_well, &m_inverse_radius, &m_radius_squared };
+    for (std::vector<float>* column : columns) column->resize(m_cell_starts.back());
+    for (int row = 0; row < m_cell_starts.back(); row++) pack(row, padding);
+
+    std::vector<int> cursor(m_cell_starts.begin(), m_cell_starts.end() - 1);
+    for (size_t i = 0; i < m_fields.size(); i++)
+    {
+        for (int row = first_row[i]; row <= last_row[i]; row++)
+            for (int column = first_column[i]; column <= last_column[i]; column++) pack(cursor[row * m_columns + column]++, m_fields[i]);
+    }
+}
+
+// ————— ACCUMULATION ————— //
+// Each lane keeps its own sum, added together the same way at the end, so that the scalar pass
+// rounds exactly as the SIMD ones do
+glm::vec2 ForceFields::accumulate_scalar(int first, int last, glm::vec2 position) const
+{
+    float sum_x[LANES] = {}, sum_y[LANES] = {};
+
+    for (int row = first; row < last; row++)
+    {
+        float x_offset = m_centre_x[row] - position.x,
+              y_offset = m_centre_y[row] - position.y,
+              distance_squared = x_offset * x_offset + y_offset * y_offset;
+
+        float inverse_distance = 1.0f / sqrtf(distance_squared > FORCE_FIELD_MIN_DISTANCE_SQUARED ? distance_squared : FORCE_FIELD_MIN_DISTANCE_SQUARED),
+              falloff = inverse_distance - m_inverse_radius[row];
+        falloff = falloff > 0.0f ? falloff : 0.0f;
+
+        float scale = m_spring[row] + m_well[row] * falloff;
+        bool  inside = position.x >= m_min_x[row] && position.x <= m_max_x[row] &&
+                       position.y >= m_min_y[row] && position.y <= m_max_y[row] && distance_squared < m_radius_squared[row];
+
+        sum_x[row % LANES] += inside ? m_constant_x[row] + x_offset * scale : 0.0f;
+        sum_y[row % LANES] += inside ? m_constant_y[row] + y_offset * scale : 0.0f;
+    }
+
+    return glm::vec2((sum_x[0] + sum_x[1]) + (sum_x[2] + sum_x[3]), (sum_y[0] + sum_y[1]) + (sum_y[2] + sum_y[3]));
+}
+
+#ifdef LANDER_SIMD_SSE2
+glm::vec2 ForceFields::accumulate_sse2(int first, int last, glm::vec2 position) const
+{
+    const __m128 xs = _mm_set1_ps(position.x), ys = _mm_set1_ps(position.y),
+                 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(),
+                 min_distance_squared = _mm_set1_ps(FORCE_FIELD_MIN_DISTANCE_SQUARED);
+    __m128 sum_x = zero, sum_y = zero;
+
+    // Cells start on a multiple of LANES and are padded to one, so every row is in a full batch
+    for (int row = first; row < last; row += LANES)
+    {
+        __m128 x_offset = _mm_sub_ps(_mm_loadu_ps(&m_centre_x[row]), xs),
+               y_offset = _mm_sub_ps(_mm_loadu_ps(&m_centre_y[row]), ys),
+               distance_squared = _mm_add_ps(_mm_mul_ps(x_offset, x_offset), _mm_mul_ps(y_offset, y_offset));
+
+        __m128 inverse_distance = _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(distance_squared, min_distance_squared))),
+               falloff = _mm_max_ps(_mm_sub_ps(inverse_distance, _mm_loadu_ps(&m_inverse_radius[row])), zero);
+
+        __m128 scale = _mm_add_ps(_mm_loadu_ps(&m_spring[row]), _mm_mul_ps(_mm_loadu_ps(&m_well[row]), falloff));
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(xs, _mm_loadu_ps(&m_min_x[row])), _mm_cmple_ps(xs, _mm_loadu_ps(&m_max_x[row]))),
+                                   _mm_and_ps(_mm_cmpge_ps(ys, _mm_loadu_ps(&m_min_y[row])), _mm_cmple_ps(ys, _mm_loadu_ps(&m_max_y[row]))));
+        inside = _mm_and_ps(inside, _mm_cmplt_ps(distance_squared, _mm_loadu_ps(&m_radius_squared[row])));
+
+        sum_x = _mm_add_ps(sum_x, _mm_and_ps(inside, _mm_add_ps(_mm_loadu_ps(&m_constant_x[row]), _mm_mul_ps(x_offset, scale))));
+        sum_y = _mm_add_ps(sum_y, _mm_and_ps(inside, _mm_add_ps(_mm_loadu_ps(&m_constant_y[row]), _mm_mul_ps(y_offset, scale))));
+    }
+
+    float lanes_x[LANES], lanes_y[LANES];
+    _mm_storeu_ps(lanes_x, sum_x);
+    _mm_storeu_ps(lanes_y, sum_y);
+    return glm::vec2((lanes_x[0] + lanes_x[1]) + (lanes_x[2] + lanes_x[3]), (lanes_y[0] + lanes_y[1]) + (lanes_y[2] + lanes_y[3]));
+}
+#endif
+
+#ifdef LANDER_SIMD_NEON
+glm::vec2 ForceFields::accumulate_neon(int first, int last, glm::vec2 position) const
+{
+    const float32x4_t xs = vdupq_n_f32(position.x), ys = vdupq_n_f32(position.y),
+                      one = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0.0f),
+                      min_distance_squared = vdupq_n_f32(FORCE_FIELD_MIN_DISTANCE_SQUARED);
+    float32x4_t sum_x = zero, sum_y = zero;
+
+    // vmulq and vaddq apart rather than vmlaq, which may fuse and round differently
+    for (int row = first; row < last; row += LANES)
+    {
+        float32x4_t x_offset = vsubq_f32(vld1q_f32(&m_centre_x[row]), xs),
+                    y_offset = vsubq_f32(vld1q_f32(&m_centre_y[row]), ys),
+                    distance_squared = vaddq_f32(vmulq_f32(x_offset, x_offset), vmulq_f32(y_offset, y_offset));
+
+        float32x4_t inverse_distance = vdivq_f32(one, vsqrtq_f32(vmaxq_f32(distance_squared, min_distance_squared))),
+                    falloff = vmaxq_f32(vsubq_f32(inverse_distance, vld1q_f32(&m_inverse_radius[row])), zero);
+
+        float32x4_t scale = vaddq_f32(vld1q_f32(&m_spring[row]), vmulq_f32(vld1q_f32(&m_well[row]), falloff));
+        uint32x4_t  inside = vandq_u32(vandq_u32(vcgeq_f32(xs, vld1q_f32(&m_min_x[row])), vcleq_f32(xs, vld1q_f32(&m_max_x[row]))),
+                                       vandq_u32(vcgeq_f32(ys, vld1q_f32(&m_min_y[row])), vcleq_f32(ys, vld1q_f32(&m_max_y[row]))));
+        inside = vandq_u32(inside, vcltq_f32(distance_squared, vld1q_f32(&m_radius_squared[row])));
+
+        float32x4_t x_term = vaddq_f32(vld1q_f32(&m_constant_x[row]), vmulq_f32(x_offset, scale)),
+                    y_term = vaddq_f32(vld1q_f32(&m_constant_y[row]), vmulq_f32(y_offset, scale));
+        sum_x = vaddq_f32(sum_x, vreinterpretq_f32_u32(vandq_u32(inside, vreinterpretq_u32_f32(x_term))));
+        sum_y = vaddq_f32(sum_y, vreinterpretq_f32_u32(vandq_u32(inside, vreinterpretq_u32_f32(y_term))));
+    }
+
+    float lanes_x[LANES], lanes_y[LANES];
+    vst1q_f32(lanes_x, sum_x);
+    vst1q_f32(lanes_y, sum_y);
+    return glm::vec2((lanes_x[0] + lanes_x[1]) + (lanes_x[2] + lanes_x[3]), (lanes_y[0] + lanes_y[1]) + (lanes_y[2] + lanes_y[3]));
+}
+#endif
+
+// ————— LOOKUP ————— //
+int ForceFields::find_cell(glm::vec2 position) const
+{
+    // Tested as floats, so a lander far off the level can't overflow the int conversion
+    float column = floorf((position.x - m_origin.x) / m_cell_size),
+          row    = floorf((position.y - m_origin.y) / m_cell_size);
+    if (!(column >= 0.0f && column < (float)m_columns && row >= 0.0f && row < (float)m_rows)) return -1;
+
+    return (int)row * m_columns + (int)column;
+}
+
+glm::vec2 ForceFields::get_acceleration(glm::vec2 position) const
+{
+    int cell = find_cell(position);
+    if (cell < 0) return glm::vec2(0.0f);
+
+#if defined(LANDER_SIMD_SSE2) || defined(LANDER_SIMD_NEON)
+    static const bool simd = get_simd_isa() != SIMD_SCALAR;
+    if (simd)
+    {
+#if defined(LANDER_SIMD_SSE2)
+        return accumulate_sse2(m_cell_starts[cell], m_cell_starts[cell + 1], position);
+#else
+        return accumulate_neon(m_cell_starts[cell], m_cell_starts[cell + 1], position);
+#endif
+    }
+#endif
+    return accumulate_scalar(m_cell_starts[cell], m_cell_starts[cell + 1], position);
+}
+
+glm::vec2 ForceFields::get_acceleration_scalar(glm::vec2 position) const
+{
+    int cell = find_cell(position);
+    if (cell < 0) return glm::vec2(0.0f);
+
+    return accumulate_scalar(m_cell_starts[cell], m_cell_starts[cell + 1], position);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Accelerations that depend on where a lander is, on top of the constant gravity every lander
+// starts with: gravity wells, wind zones and tractor beams. step_simulation looks each lander's
+// position up here before it moves, and the integrator adds the result to its own acceleration.
+//
+// Every kind of field is the one formula with different coefficients, so a lander's total is a
+// single pass over the fields that can reach it, four at a time:
+//   inside the field's box (and, for a well, its radius):
+//     a = constant + (centre - position) * (spring + well * max(1/r - 1/radius, 0))
+// where r is the distance to the centre. A uniform grid over the fields' boxes does the spatial
+// lookup, and each cell keeps its own packed copy of the fields touching it, so the pass reads
+// straight down its columns with no indirection. A lander outside every cell costs one test.
+//
+// The SIMD and scalar passes add in the same order, lane by lane, and agree to the bit.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "OverlapKernels.h"
+
+class ForceFields
+{
+private:
+    static const int LANES = 4;
+
+    // One field's coefficients; see the formula above
+    struct Field
+    {
+        glm::vec2 min, max;
+        glm::vec2 centre;
+        glm::vec2 constant;
+        float     spring,
+                  well,
+                  inverse_radius,
+                  radius_squared;
+    };
+
+    std::vector<Field> m_fields;
+
+    // ————— GRID ————— //
+    glm::vec2 m_origin = glm::vec2(0.0f);
+    float     m_cell_size = 1.0f;
+    int       m_columns = 0,
+              m_rows    = 0;
+
+    // Cell c's fields are rows m_cell_starts[c] .. m_cell_starts[c + 1] of the columns below,
+    // padded to a whole number of LANES with fields nothing is ever inside
+    std::vector<int> m_cell_starts;
+    std::vector<float> m_min_x, m_min_y, m_max_x, m_max_y,
+                       m_centre_x, m_centre_y,
+                       m_constant_x, m_constant_y,
+                       m_spring, m_well, m_inverse_radius, m_radius_squared;
+
+    void pack(int row, const Field& field);
+    int  find_cell(glm::vec2 position) const;  // -1 outside the grid
+    glm::vec2 accumulate_scalar(int first, int last, glm::vec2 position) const;
+#ifdef LANDER_SIMD_SSE2
+    glm::vec2 accumulate_sse2(int first, int last, glm::vec2 position) const;
+#endif
+#ifdef LANDER_SIMD_NEON
+    glm::vec2 accumulate_neon(int first, int last, glm::vec2 position) const;
+#endif
+
+public:
+    // Pulls toward `centre`, at `strength` at the centre falling off to nothing at `radius`
+    void add_gravity_well(glm::vec2 centre, float radius, float strength);
+    // A constant `acceleration` anywhere inside the box
+    void add_wind_zone(glm::vec2 min, glm::vec2 max, glm::vec2 acceleration);
+    // Pulls toward the box's centre like a spring, `strength` per unit away from it
+    void add_tractor_beam(glm::vec2 min, glm::vec2 max, float strength);
+
+    // Has to follow the last add_ before any lookup. A cell_size of 0 picks one from the fields.
+    void build(float cell_size = 0.0f);
+    void clear();
+
+    // The sum of every field at `position`; the same with or without SIMD
+    glm::vec2 get_acceleration(glm::vec2 position) const;
+    glm::vec2 get_acceleration_scalar(glm::vec2 position) const;
+
+    int  const get_count()      const { return (int)m_fields.size(); };
+    int  const get_cell_count() const { return m_columns * m_rows; };
+    bool const is_empty()       const { return m_cell_starts.empty(); };
+};
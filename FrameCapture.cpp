@@ -0,0 +1,393 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include "FrameCapture.h"
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "Trace.h"
+
+// ————— PNG ————— //
+// Stored (uncompressed) deflate blocks: nothing to link against, and the encoder keeps up with a
+// recording, which it wouldn't if it were compressing. Anything that reads PNGs reads these.
+static uint32_t crc32(uint32_t crc, const unsigned char* data, size_t size)
+{
+    static uint32_t table[256];
+    static bool     built = false;
+    if (!built)
+    {
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        built = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void put_u32(std::vector<unsigned char>& out, uint32_t value)
+{
+    unsigned char bytes[4] = { (unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value };
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void write_chunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+{
+    std::vector<unsigned char> header;
+    put_u32(header, (uint32_t)data.size());
+    header.insert(header.end(), type, type + 4);
+
+    uint32_t crc = crc32(crc32(0, header.data() + 4, 4), data.data(), data.size());
+    std::vector<unsigned char> footer;
+    put_u32(footer, crc);
+
+    file.write((const char*)header.data(), header.size());
+    file.write((const char*)data.data(), data.size());
+    file.write((const char*)footer.data(), footer.size());
+}
+
+// `pixels` as GL reads them, bottom row first
+static bool write_png(const std::string& filepath, int width, int height, const unsigned char* pixels)
+{
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    static const unsigned char SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write((const char*)SIGNATURE, sizeof(SIGNATURE));
+
+    std::vector<unsigned char> header;
+    put_u32(header, (uint32_t)width);
+    put_u32(header, (uint32_t)height);
+    header.insert(header.end(), { 8, 6, 0, 0, 0 });  // 8 bits, RGBA, deflate, adaptive filters, no interlace
+    write_chunk(file, "IHDR", header);
+
+    // STEP 1: The filtered image: each row top first, behind a "no filter" byte
+    const size_t row_bytes = (size_t)width * 4;
+    std::vector<unsigned char> raw((row_bytes + 1) * height);
+    for (int y = 0; y < height; y++)
+    {
+        unsigned char* row = raw.data() + (row_bytes + 1) * y;
+        row[0] = 0;
+        std::memcpy(row + 1, pixels + row_bytes * (height - 1 - y), row_bytes);
+    }
+
+    // STEP 2: Wrapped in zlib as stored blocks of up to 65535 bytes, with its Adler-32
+    std::vector<unsigned char> data = { 0x78, 0x01 };
+    data.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+    uint32_t a = 1, b = 0;
+    for (size_t offset = 0; ; )
+    {
+        size_t length = std::min(raw.size() - offset, (size_t)65535);
+        bool   last   = offset + length == raw.size();
+        data.insert(data.end(), { (unsigned char)(last ? 1 : 0), (unsigned char)length, (unsigned char)(length >> 8),
+                                  (unsigned char)~length, (unsigned char)(~length >> 8) });
+        data.insert(data.end(), raw.begin() + offset, raw.begin() + offset + length);
+
+        for (size_t i = offset; i < offset + length; i++)
+        {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        offset += length;
+        if (last) break;
+    }
+    put_u32(data, (b << 16) | a);
+    write_chunk(file, "IDAT", data);
+    write_chunk(file, "IEND", {});
+
+    return (bool)file;
+}
+
+// ————— SET-UP ————— //
+void FrameCapture::initialise(int width, int height, const char* directory, CaptureFormat format)
+{
+    m_width = width;
+    m_height = height;
+    m_directory = directory;
+    m_format = format;
+
+    // Both are needed: the buffer so the read doesn't wait, the fence to know when it's safe to map
+    m_asynchronous = supports_pixel_buffer_objects() && supports_fence_sync();
+    if (m_asynchronous)
+    {
+        size_t image_size = (size_t)width * height * CHANNELS;
+        for (Readback& readback : m_readbacks)
+        {
+            glGenBuffers(1, &readback.buffer);
+            count_gl_call(GL_CALL_BIND);
+            count_gl_call(GL_CALL_UPLOAD);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, image_size, NULL, GL_STREAM_READ);
+            track_gpu_buffer(readback.buffer, (long long)image_size);
+        }
+        count_gl_call(GL_CALL_BIND);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    m_stopping = false;
+    m_encoder = std::thread(&FrameCapture::encoder_loop, this);
+}
+
+void FrameCapture::cleanup()
+{
+    if (!m_encoder.joinable()) return;
+
+    // STEP 1: Whatever the GPU has finished still goes out; the rest is given up
+    m_recording = false;
+    collect_readbacks();
+    for (Readback& readback : m_readbacks)
+    {
+        if (readback.fence != NULL) glDeleteSync(readback.fence);
+        if (readback.buffer != 0)
+        {
+            untrack_gpu_buffers(1, &readback.buffer);
+            glDeleteBuffers(1, &readback.buffer);
+        }
+        readback = Readback();
+    }
+
+    // STEP 2: The encoder drains its queue before it stops
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_encoder.join();
+
+    m_frames.clear();
+    m_free_frames.clear();
+}
+
+bool FrameCapture::start_recording()
+{
+    if (!m_asynchronous || m_recording) return m_recording;
+
+    // A fresh file or directory for every recording, named by when it started
+    char name[64];
+    std::snprintf(name, sizeof(name), "recording_%lld", (long long)std::time(NULL));
+    m_recording_path = m_directory + "/" + name;
+    if (m_format == CAPTURE_RAW) m_recording_path += "_" + std::to_string(m_width) + "x" + std::to_string(m_height) + ".rgba";
+
+    std::error_code error;
+    std::filesystem::create_directories(m_format == CAPTURE_PNG ? m_recording_path : m_directory, error);
+    if (error) return false;
+
+    m_recording_frame = 0;
+    m_recording = true;
+    return true;
+}
+
+void FrameCapture::stop_recording()
+{
+    m_recording = false;
+}
+
+// ————— GAME THREAD ————— //
+int FrameCapture::take_frame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_frames.empty())
+    {
+        // Allocated once, on the first capture, so a session that never captures pays nothing
+        MemoryScope memory(MEMORY_RENDER);
+        m_frames.assign(POOLED_FRAMES, std::vector<unsigned char>((size_t)m_width * m_height * CHANNELS));
+        for (int frame = POOLED_FRAMES - 1; frame >= 0; frame--) m_free_frames.push_back(frame);
+    }
+    if (m_free_frames.empty()) return -1;
+
+    int frame = m_free_frames.back();
+    m_free_frames.pop_back();
+    return frame;
+}
+
+void FrameCapture::queue_frame(int frame, const std::string& filepath, bool png)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back({ frame, filepath, png });
+    }
+    m_wake.notify_one();
+}
+
+void FrameCapture::collect_readbacks()
+{
+    // Oldest first, so frames reach the encoder in order; the first unfinished one stops the rest
+    for (int i = 0; i < READBACK_BUFFERS; i++)
+    {
+        Readback& readback = m_readbacks[(m_next_readback + i) % READBACK_BUFFERS];
+        if (readback.fence == NULL) continue;
+        if (glClientWaitSync(readback.fence, 0, 0) == GL_TIMEOUT_EXPIRED) break;
+
+        glDeleteSync(readback.fence);
+        readback.fence = NULL;
+
+        int frame = take_frame();
+        if (frame < 0)
+        {
+            m_dropped++;
+            continue;
+        }
+
+        count_gl_call(GL_CALL_BIND, 2);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (pixels != NULL)
+        {
+            std::memcpy(m_frames[frame].data(), pixels, m_frames[frame].size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        if (pixels != NULL) queue_frame(frame, readback.filepath, readback.png);
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free_frames.push_back(frame);
+            m_dropped++;
+        }
+    }
+}
+
+void FrameCapture::read_frame(const std::string& filepath, bool png)
+{
+    // No way to read without waiting: only ever a screenshot, so the one stall is on a keypress
+    if (!m_asynchronous)
+    {
+        int frame = take_frame();
+        if (frame < 0)
+        {
+            m_dropped++;
+            return;
+        }
+        glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, m_frames[frame].data());
+        queue_frame(frame, filepath, png);
+        m_captured++;
+        return;
+    }
+
+    // The ring is full of copies the GPU hasn't finished: this frame is dropped, not waited for
+    Readback& readback = m_readbacks[m_next_readback];
+    if (readback.fence != NULL)
+    {
+        m_dropped++;
+        return;
+    }
+
+    // Returns straight away: the copy into the buffer is queued behind this frame's draws
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.filepath = filepath;
+    readback.png = png;
+
+    m_next_readback = (m_next_readback + 1) % READBACK_BUFFERS;
+    m_captured++;
+}
+
+void FrameCapture::end_frame()
+{
+    if (!m_encoder.joinable()) return;
+    TRACE_ZONE("FrameCapture::end_frame");
+    auto start = std::chrono::steady_clock::now();
+
+    // STEP 1: Hand over every frame the GPU has finished copying
+    if (m_asynchronous) collect_readbacks();
+
+    // STEP 2: Start reading this one, if anybody wants it. A screenshot during a recording is a
+    //         frame of its own; the recording just misses it, which the frame count shows.
+    if (m_screenshot_requested)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "/screenshot_%lld_%u.png", (long long)std::time(NULL), m_screenshot_count++);
+        read_frame(m_directory + name, true);
+        m_screenshot_requested = false;
+    }
+    else if (m_recording)
+    {
+        if (m_format == CAPTURE_PNG)
+        {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame_%06u.png", m_recording_frame);
+            read_frame(m_recording_path + name, true);
+        }
+        else read_frame(m_recording_path, false);
+        m_recording_frame++;
+    }
+
+    m_last_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (m_last_ms > m_max_ms) m_max_ms = m_last_ms;
+}
+
+// ————— ENCODER THREAD ————— //
+void FrameCapture::encoder_loop()
+{
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_jobs.empty()) break;  // only once stopping, so nothing queued is lost
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        encode(job);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free_frames.push_back(job.frame);
+    }
+
+    m_raw_file.close();
+    m_raw_path.clear();
+}
+
+void FrameCapture::encode(const Job& job)
+{
+    TRACE_ZONE("encode frame");
+    const unsigned char* pixels = m_frames[job.frame].data();
+
+    if (job.png)
+    {
+        if (write_png(job.filepath, m_width, m_height, pixels)) m_written.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Raw frames append to their recording's file, which stays open until the next recording
+    if (job.filepath != m_raw_path)
+    {
+        m_raw_file.close();
+        m_raw_file.open(job.filepath, std::ios::binary | std::ios::app);
+        m_raw_path = job.filepath;
+    }
+
+    const size_t row_bytes = (size_t)m_width * CHANNELS;
+    for (int y = m_height - 1; y >= 0; y--) m_raw_file.write((const char*)pixels + row_bytes * y, row_bytes);
+    if (m_raw_file) m_written.fetch_add(1, std::memory_order_relaxed);
+}
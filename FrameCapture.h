@@ -0,0 +1,124 @@
+#pragma once
+
+// Screenshots and gameplay recordings without stalling the GPU. A synchronous glReadPixels waits
+// for every draw queued before it; here each frame is read into one of a ring of pixel buffer
+// objects instead, behind a fence, and collected a few frames later once the fence says the copy
+// is done. The pixels are copied out of the mapped buffer into a pooled frame and handed to an
+// encoder thread, so the game thread only ever pays for the readback call and one memcpy.
+//
+// Nothing waits when the pipeline falls behind: a frame whose buffer is still busy, or that finds
+// the encoder's queue full, is dropped and counted. Recording needs PBOs and fences; without
+// them a screenshot still works, read synchronously, since one stall on a keypress is fine.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum CaptureFormat
+{
+    CAPTURE_RAW,  // one file per recording, RGBA rows top first, frame after frame
+    CAPTURE_PNG,  // a numbered sequence, uncompressed; screenshots are always PNG
+};
+
+class FrameCapture
+{
+private:
+    static const int READBACK_BUFFERS = 4,  // a frame is collected two or three frames after it's read
+                     POOLED_FRAMES    = 8,  // waiting for or being written by the encoder
+                     CHANNELS         = 4;
+
+    struct Readback
+    {
+        GLuint      buffer;
+        GLsync      fence;  // NULL when the buffer is free
+        std::string filepath;
+        bool        png;
+    };
+
+    struct Job
+    {
+        int         frame;  // into m_frames
+        std::string filepath;
+        bool        png;
+    };
+
+    int           m_width = 0,
+                  m_height = 0;
+    std::string   m_directory;
+    CaptureFormat m_format = CAPTURE_RAW;
+    bool          m_asynchronous = false;
+
+    // ————— GL THREAD ONLY ————— //
+    Readback m_readbacks[READBACK_BUFFERS] = {};
+    int      m_next_readback = 0;
+
+    bool         m_recording = false,
+                 m_screenshot_requested = false;
+    std::string  m_recording_path;  // the raw file, or the PNG sequence's directory
+    unsigned int m_recording_frame = 0,
+                 m_screenshot_count = 0;
+
+    int   m_captured = 0,
+          m_dropped  = 0;
+    float m_last_ms  = 0.0f,
+          m_max_ms   = 0.0f;
+
+    // ————— SHARED WITH THE ENCODER ————— //
+    std::vector<std::vector<unsigned char>> m_frames;  // allocated on the first capture
+    std::vector<int>        m_free_frames;
+    std::deque<Job>         m_jobs;
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    bool                    m_stopping = false;
+    std::atomic<int>        m_written { 0 };
+    std::thread             m_encoder;
+
+    // ————— ENCODER THREAD ONLY ————— //
+    std::ofstream m_raw_file;
+    std::string   m_raw_path;
+
+    int  take_frame();
+    void queue_frame(int frame, const std::string& filepath, bool png);
+    void collect_readbacks();
+    void read_frame(const std::string& filepath, bool png);
+    void encoder_loop();
+    void encode(const Job& job);
+
+public:
+    FrameCapture() = default;
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    ~FrameCapture() { cleanup(); }
+
+    // GL thread. Captures the bottom-left width x height of the window into files under
+    // `directory`, which is made if need be.
+    void initialise(int width, int height, const char* directory, CaptureFormat format);
+
+    // Collects whatever the GPU has finished, then lets the encoder write out everything queued
+    void cleanup();
+
+    // False, and not recording, where frames can't be read back without a stall
+    bool start_recording();
+    void stop_recording();
+    void request_screenshot() { m_screenshot_requested = true; };
+
+    // GL thread, once a frame after the last draw and before the swap
+    void end_frame();
+
+    bool  const is_recording()         const { return m_recording; };
+    bool  const is_asynchronous()      const { return m_asynchronous; };
+    int   const get_captured_count()   const { return m_captured; };
+    int   const get_dropped_count()    const { return m_dropped; };
+    int   const get_written_count()    const { return m_written.load(std::memory_order_relaxed); };
+    float const get_last_ms()          const { return m_last_ms; };  // on the game thread
+    float const get_max_ms()           const { return m_max_ms; };
+};
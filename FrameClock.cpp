@@ -0,0 +1,37 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "FrameClock.h"
+#include "Simulation.h"
+
+int64_t FrameClock::get_ticks_since_start() const
+{
+    // Whole seconds and the remainder apart, so the multiply can't overflow for any frequency
+    // or uptime a counter will ever see
+    Uint64 counts = SDL_GetPerformanceCounter() - m_start;
+    Uint64 seconds = counts / m_frequency,
+           remainder = counts % m_frequency;
+    return (int64_t)(seconds * TICKS_PER_SECOND + remainder * TICKS_PER_SECOND / m_frequency);
+}
+
+void FrameClock::reset()
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_start = SDL_GetPerformanceCounter();
+    m_previous = 0;
+}
+
+int64_t FrameClock::tick()
+{
+    int64_t now = get_ticks_since_start();
+    int64_t elapsed = now - m_previous;
+    m_previous = now;
+    return elapsed;
+}
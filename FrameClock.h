@@ -0,0 +1,28 @@
+#pragma once
+
+// The game loop's clock, on SDL's performance counter. It counts in whole ticks of
+// advance_simulation (TICKS_PER_SECOND) measured from the first reset(), and every frame's
+// elapsed time is the difference of two such readings. The rounding of one frame is made up
+// in the next, so the frames always add up to the exact time since reset(), even weeks in.
+#include <cstdint>
+#include <SDL.h>
+
+class FrameClock
+{
+private:
+    Uint64  m_frequency = 1,
+            m_start     = 0;
+    int64_t m_previous  = 0;  // ticks since m_start at the last tick()
+
+    int64_t get_ticks_since_start() const;
+
+public:
+    // Starts the clock, or restarts it so the next tick() doesn't count the time before now
+    void reset();
+
+    // Ticks since the last tick() or reset()
+    int64_t tick();
+
+    // Ticks since reset(), without ending the frame
+    int64_t const get_ticks() const { return get_ticks_since_start(); };
+};
@@ -0,0 +1,71 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <fstream>
+#include "AllocationCounter.h"
+#include "GLCallCounter.h"
+#include "FrameCounters.h"
+
+static const char* const COUNTER_NAMES[FRAME_COUNTER_COUNT] = { "allocations", "allocated_bytes", "gl_binds", "gl_uniforms", "gl_uploads", "gl_draws" };
+
+const char* FrameCounters::get_name(FrameCounter counter)
+{
+    return COUNTER_NAMES[counter];
+}
+
+void FrameCounters::read_totals(long long totals[FRAME_COUNTER_COUNT])
+{
+    AllocationCounts allocations = get_allocation_counts();
+
+    totals[COUNTER_ALLOCATIONS]     = allocations.allocations;
+    totals[COUNTER_ALLOCATED_BYTES] = (long long)allocations.bytes;
+    totals[COUNTER_GL_BINDS]        = get_gl_call_count(GL_CALL_BIND);
+    totals[COUNTER_GL_UNIFORMS]     = get_gl_call_count(GL_CALL_UNIFORM);
+    totals[COUNTER_GL_UPLOADS]      = get_gl_call_count(GL_CALL_UPLOAD);
+    totals[COUNTER_GL_DRAWS]        = get_gl_call_count(GL_CALL_DRAW);
+}
+
+void FrameCounters::begin_frame()
+{
+    read_totals(m_start);
+}
+
+void FrameCounters::end_frame()
+{
+    long long totals[FRAME_COUNTER_COUNT];
+    read_totals(totals);
+
+    for (int counter = 0; counter < FRAME_COUNTER_COUNT; counter++)
+    {
+        m_last[counter] = totals[counter] - m_start[counter];
+        m_max[counter] = std::max(m_max[counter], m_last[counter]);
+        m_total[counter] += m_last[counter];
+    }
+    m_frame_count++;
+}
+
+bool FrameCounters::write_report(const char* filepath) const
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    file << "{\n  \"frames\": " << m_frame_count << ",\n  \"counters\": {\n";
+    for (int counter = 0; counter < FRAME_COUNTER_COUNT; counter++)
+    {
+        FrameCounter id = (FrameCounter)counter;
+        file << "    \"" << COUNTER_NAMES[counter] << "\": { \"avg\": " << get_average(id) << ", \"max\": " << m_max[counter]
+             << ", \"total\": " << m_total[counter] << " }" << (counter + 1 < FRAME_COUNTER_COUNT ? ",\n" : "\n");
+    }
+    file << "  }\n}\n";
+
+    return (bool)file;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Allocations and GL calls per frame, from the running totals in AllocationCounter and
+// GLCallCounter: the last frame's for the HUD, and the average and worst over the run for the
+// report written at shutdown.
+enum FrameCounter
+{
+    COUNTER_ALLOCATIONS,
+    COUNTER_ALLOCATED_BYTES,
+    COUNTER_GL_BINDS,
+    COUNTER_GL_UNIFORMS,
+    COUNTER_GL_UPLOADS,
+    COUNTER_GL_DRAWS,
+    FRAME_COUNTER_COUNT
+};
+
+class FrameCounters
+{
+private:
+    long long m_start[FRAME_COUNTER_COUNT] = {},
+              m_last[FRAME_COUNTER_COUNT]  = {},
+              m_max[FRAME_COUNTER_COUNT]   = {},
+              m_total[FRAME_COUNTER_COUNT] = {};
+    long long m_frame_count = 0;
+
+    static void read_totals(long long totals[FRAME_COUNTER_COUNT]);
+
+public:
+    void begin_frame();
+    void end_frame();
+
+    // Per-frame average, max and run total of every counter, as JSON
+    bool write_report(const char* filepath) const;
+
+    static const char* get_name(FrameCounter counter);
+
+    long long const get_last(FrameCounter counter)    const { return m_last[counter]; };
+    long long const get_max(FrameCounter counter)     const { return m_max[counter]; };
+    double    const get_average(FrameCounter counter) const { return m_frame_count > 0 ? (double)m_total[counter] / m_frame_count : 0.0; };
+    long long const get_frame_count()                 const { return m_frame_count; };
+};
@@ -0,0 +1,115 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include "FrameHistogram.h"
+
+static const double REPORT_PERCENTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+static const char* const REPORT_NAMES[]  = { "p50", "p90", "p99", "p99_9" };
+
+int FrameHistogram::get_bucket(uint64_t microseconds)
+{
+    if (microseconds < (uint64_t)SUB_BUCKET_COUNT) return (int)microseconds;
+
+    // Keep the top SUB_BUCKET_BITS - 1 bits below the leading one; everything under them is the error
+    int magnitude = 63;
+    while (!(microseconds >> magnitude & 1)) magnitude--;
+    if (magnitude >= MAX_MAGNITUDE) return BUCKET_COUNT - 1;
+
+    int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    int top   = (int)(microseconds >> shift);  // HALF_COUNT..SUB_BUCKET_COUNT-1
+
+    return SUB_BUCKET_COUNT + (magnitude - SUB_BUCKET_BITS) * HALF_COUNT + (top - HALF_COUNT);
+}
+
+uint64_t FrameHistogram::get_bucket_upper(int bucket)
+{
+    if (bucket < SUB_BUCKET_COUNT) return (uint64_t)bucket;
+
+    int magnitude = SUB_BUCKET_BITS + (bucket - SUB_BUCKET_COUNT) / HALF_COUNT,
+        top       = HALF_COUNT + (bucket - SUB_BUCKET_COUNT) % HALF_COUNT,
+        shift     = magnitude - (SUB_BUCKET_BITS - 1);
+
+    return (((uint64_t)top + 1) << shift) - 1;
+}
+
+void FrameHistogram::record(double frame_seconds)
+{
+    uint64_t microseconds = (uint64_t)std::max(0.0, std::round(frame_seconds * 1000000.0));
+
+    m_counts[get_bucket(microseconds)]++;
+    m_total++;
+    m_max_us = std::max(m_max_us, microseconds);
+
+    if (m_budget_seconds > 0.0 && frame_seconds > m_budget_seconds * OVER_BUDGET_TOLERANCE) m_over_budget++;
+}
+
+void FrameHistogram::clear()
+{
+    std::fill(std::begin(m_counts), std::end(m_counts), 0);
+    m_total = m_over_budget = 0;
+    m_max_us = 0;
+}
+
+double FrameHistogram::get_percentile_ms(double fraction) const
+{
+    if (m_total == 0) return 0.0;
+
+    // The frame ranked ceil(fraction * total), reported as the top of its bucket so a percentile
+    // never reads better than it was; the max clamps the last bucket to what was actually seen
+    long long rank = std::max(1LL, (long long)std::ceil(fraction * m_total)),
+              seen = 0;
+
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+    {
+        seen += m_counts[bucket];
+        if (seen >= rank) return std::min(get_bucket_upper(bucket), m_max_us) / 1000.0;
+    }
+    return get_max_ms();
+}
+
+bool FrameHistogram::write_report(const char* filepath) const
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    file << "{\n  \"frames\": " << m_total << ",\n  \"budget_ms\": " << m_budget_seconds * 1000.0
+         << ",\n  \"over_budget\": " << m_over_budget << ",\n";
+
+    for (int i = 0; i < 4; i++) file << "  \"" << REPORT_NAMES[i] << "_ms\": " << get_percentile_ms(REPORT_PERCENTILES[i]) << ",\n";
+    file << "  \"max_ms\": " << get_max_ms() << ",\n";
+
+    // [upper bound in us, count] for every bucket that was hit, so runs can be merged later
+    file << "  \"buckets_us\": [";
+    bool first = true;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+    {
+        if (m_counts[bucket] == 0) continue;
+
+        file << (first ? "" : ", ") << "[" << get_bucket_upper(bucket) << ", " << m_counts[bucket] << "]";
+        first = false;
+    }
+    file << "]\n}\n";
+
+    return (bool)file;
+}
+
+void FrameHistogram::report() const
+{
+    if (m_total == 0) return;
+
+    std::cout << "Frame times:";
+    for (int i = 0; i < 4; i++) std::cout << " " << REPORT_NAMES[i] << " " << get_percentile_ms(REPORT_PERCENTILES[i]) << " ms";
+    std::cout << ", max " << get_max_ms() << " ms, " << m_over_budget << " of " << m_total << " frames over budget" << std::endl;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+// Every frame's duration in a fixed-size log-linear histogram (HdrHistogram's layout): exact up to
+// 128 us, and within 1/64 of the true value above that, up to hours. Recording is an increment,
+// so it costs the same on frame one million as on frame one, and the buckets of many runs can be
+// summed to get fleet-wide percentiles, which averaging per-run percentiles cannot.
+#include <cstdint>
+
+class FrameHistogram
+{
+private:
+    static const int SUB_BUCKET_BITS  = 7,
+                     SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,       // exact values below this
+                     HALF_COUNT       = SUB_BUCKET_COUNT / 2,       // buckets per power of two above it
+                     MAX_MAGNITUDE    = 34;                         // 2^34 us, about 4.8 hours
+
+    static const int BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_MAGNITUDE - SUB_BUCKET_BITS) * HALF_COUNT;
+
+    long long m_counts[BUCKET_COUNT] = {};
+    long long m_total      = 0,
+              m_over_budget = 0;
+    uint64_t  m_max_us     = 0;
+    double    m_budget_seconds = 0.0;
+
+    static int      get_bucket(uint64_t microseconds);
+    static uint64_t get_bucket_upper(int bucket);  // highest value that lands in the bucket
+
+public:
+    // A frame more than this much past the budget counts as over it; vsync and the pacer's spin
+    // put ordinary frames a hair either side of it
+    static constexpr double OVER_BUDGET_TOLERANCE = 1.1;
+
+    void set_budget(double budget_seconds) { m_budget_seconds = budget_seconds; };
+    void record(double frame_seconds);
+    void clear();
+
+    // Frame time at or below which the given fraction (0.5, 0.99, ...) of frames fell, in ms
+    double get_percentile_ms(double fraction) const;
+
+    // Percentiles, max, over-budget count and the raw non-empty buckets, as JSON
+    bool write_report(const char* filepath) const;
+    void report() const;
+
+    long long const get_frame_count()       const { return m_total; };
+    long long const get_over_budget_count() const { return m_over_budget; };
+    double    const get_max_ms()            const { return m_max_us / 1000.0; };
+};
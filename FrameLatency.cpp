@@ -0,0 +1,91 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <iostream>
+#include "FrameLatency.h"
+#include "GLCapabilities.h"
+
+bool FrameLatency::initialise(int max_queued_frames)
+{
+    cleanup();
+    if (!supports_fence_sync()) return false;
+
+    m_max_queued_frames = std::min(std::max(max_queued_frames, 0), MAX_QUEUED_FRAMES);
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_enabled = true;
+    return true;
+}
+
+void FrameLatency::cleanup()
+{
+    for (int i = 0; i < m_count; i++) glDeleteSync(m_frames[(m_oldest + i) % (MAX_QUEUED_FRAMES + 1)].fence);
+    m_oldest = 0;
+    m_count = 0;
+    m_enabled = false;
+}
+
+bool FrameLatency::retire_oldest(bool wait)
+{
+    Frame& frame = m_frames[m_oldest];
+
+    GLenum result = glClientWaitSync(frame.fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        if (!wait) return false;
+
+        Uint64 wait_start = SDL_GetPerformanceCounter();
+        glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+        m_waited_seconds += (double)(SDL_GetPerformanceCounter() - wait_start) / (double)m_frequency;
+        m_waits++;
+    }
+
+    m_latency.record((double)(SDL_GetPerformanceCounter() - frame.input_ticks) / (double)m_frequency);
+    glDeleteSync(frame.fence);
+    m_oldest = (m_oldest + 1) % (MAX_QUEUED_FRAMES + 1);
+    m_count--;
+    return true;
+}
+
+void FrameLatency::begin_frame()
+{
+    if (!m_enabled) return;
+
+    // STEP 1: With a cap, the frames over it are waited out; without one, only a full ring is
+    int max_in_flight = m_max_queued_frames > 0 ? m_max_queued_frames - 1 : MAX_QUEUED_FRAMES;
+    while (m_count > max_in_flight) retire_oldest(true);
+
+    // STEP 2: Whatever else has finished since, for its latency
+    while (m_count > 0 && retire_oldest(false)) {}
+
+    m_input_ticks = SDL_GetPerformanceCounter();
+}
+
+void FrameLatency::end_frame()
+{
+    if (!m_enabled) return;
+
+    Frame& frame = m_frames[(m_oldest + m_count) % (MAX_QUEUED_FRAMES + 1)];
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.input_ticks = m_input_ticks;
+    m_count++;
+}
+
+void FrameLatency::report() const
+{
+    if (!m_enabled || m_latency.get_frame_count() == 0) return;
+
+    std::cout << "Frame latency: input to GPU done p50 " << m_latency.get_percentile_ms(0.5)
+              << " ms, p99 " << m_latency.get_percentile_ms(0.99) << " ms, max " << m_latency.get_max_ms() << " ms over "
+              << m_latency.get_frame_count() << " frames";
+    if (m_max_queued_frames > 0) std::cout << "; at most " << m_max_queued_frames << " queued, " << m_waits
+                                           << " waits, " << m_waited_seconds << " s waited";
+    std::cout << std::endl;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// How far the GPU runs behind input, and a cap on it. Left alone, the driver queues up to several
+// finished frames ahead of the display, and each one queued is a frame more between a key going
+// down and the picture showing it. Every swapped frame gets a fence; before the next frame reads
+// its input, begin_frame() waits for all but max_queued_frames - 1 of those earlier frames to be
+// through the GPU, so at most max_queued_frames are ever in flight. With 0, nothing waits and the
+// fences only measure.
+//
+// The latency measured is from reading a frame's input to the GPU finishing that frame, as seen
+// from here: exact for a fence begin_frame() waited on, and up to a frame late for one it found
+// already signalled. Scan-out comes on top: half a refresh on average, without the compositor.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "FrameHistogram.h"
+
+class FrameLatency
+{
+public:
+    static const int MAX_QUEUED_FRAMES = 3;
+
+private:
+    static const Uint64 FENCE_TIMEOUT_NS = 100000000;  // a tenth of a second; past that, the driver is the problem
+
+    struct Frame
+    {
+        GLsync fence;
+        Uint64 input_ticks;
+    };
+
+    Frame m_frames[MAX_QUEUED_FRAMES + 1] = {};  // a ring of the frames still in flight, oldest first
+    int   m_oldest = 0,
+          m_count  = 0;
+
+    bool   m_enabled = false;
+    int    m_max_queued_frames = 0;
+    Uint64 m_frequency   = 1,
+           m_input_ticks = 0;  // the frame under way's
+
+    FrameHistogram m_latency;
+    double         m_waited_seconds = 0.0;
+    long long      m_waits = 0;
+
+    // Takes the oldest frame off the ring if its fence has signalled, waiting for it first if
+    // asked; false if it hadn't and wasn't waited for
+    bool retire_oldest(bool wait);
+
+public:
+    FrameLatency() = default;
+    FrameLatency(const FrameLatency&) = delete;
+    FrameLatency& operator=(const FrameLatency&) = delete;
+    ~FrameLatency() { cleanup(); }
+
+    // GL thread, with the context current. max_queued_frames is clamped to MAX_QUEUED_FRAMES.
+    // False, with nothing measured or waited on, without fence sync.
+    bool initialise(int max_queued_frames);
+    void cleanup();
+
+    // Right before the frame's input is read
+    void begin_frame();
+    // Right after the swap
+    void end_frame();
+
+    void report() const;
+
+    bool const is_enabled()              const { return m_enabled; };
+    int  const get_max_queued_frames()   const { return m_max_queued_frames; };
+    // Time spent in begin_frame() waiting on the GPU
+    double    const get_waited_seconds() const { return m_waited_seconds; };
+    const FrameHistogram& get_latency()  const { return m_latency; };
+};
@@ -0,0 +1,141 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "FramePacer.h"
+
+static const char* const VSYNC_NAMES[] = { "adaptive", "off", "on" };  // by VsyncMode + 1
+
+bool parse_vsync_mode(const char* name, VsyncMode& mode)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        if (std::strcmp(name, VSYNC_NAMES[i]) == 0)
+        {
+            mode = (VsyncMode)(i - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+double FramePacer::seconds_since(Uint64 ticks) const
+{
+    return (double)(SDL_GetPerformanceCounter() - ticks) / (double)m_frequency;
+}
+
+void FramePacer::initialise(int target_fps, VsyncMode vsync_mode)
+{
+    m_frequency = SDL_GetPerformanceFrequency();
+    m_run_start = SDL_GetPerformanceCounter();
+    m_frame_start = m_run_start;
+
+    set_target_fps(target_fps);
+
+    // SDL_GL_SetSwapInterval returns -1 when the driver doesn't support the requested mode
+    m_vsync_mode = vsync_mode;
+    if (m_vsync_mode == VSYNC_ADAPTIVE && SDL_GL_SetSwapInterval(VSYNC_ADAPTIVE) != 0) m_vsync_mode = VSYNC_ON;
+    if (m_vsync_mode == VSYNC_ON && SDL_GL_SetSwapInterval(VSYNC_ON) != 0)             m_vsync_mode = VSYNC_OFF;
+    if (m_vsync_mode == VSYNC_OFF) SDL_GL_SetSwapInterval(VSYNC_OFF);
+}
+
+void FramePacer::set_target_fps(int target_fps)
+{
+#ifdef __EMSCRIPTEN__
+    // The browser calls each frame back on the display's refresh, and sleeping would only stall it
+    target_fps = 0;
+#endif
+    m_target_frame_seconds = target_fps > 0 ? 1.0 / (double)target_fps : 0.0;
+
+    SDL_DisplayMode mode;
+    int refresh_rate = (SDL_GetDesktopDisplayMode(0, &mode) == 0 && mode.refresh_rate > 0) ? mode.refresh_rate : DEFAULT_REFRESH_RATE;
+    m_frame_times.set_budget(m_target_frame_seconds > 0.0 ? m_target_frame_seconds : 1.0 / refresh_rate);
+}
+
+void FramePacer::begin_frame()
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (m_frame_count > 0 && !m_frame_recorded) m_frame_times.record((double)(now - m_frame_start) / (double)m_frequency);
+
+    m_frame_start = now;
+    m_frame_recorded = false;
+}
+
+void FramePacer::wait_for_event(double timeout_seconds)
+{
+    // The frame that just ended is recorded now, and the next one starts from the wake-up
+    Uint64 wait_start = SDL_GetPerformanceCounter();
+    if (m_frame_count > 0) m_frame_times.record((double)(wait_start - m_frame_start) / (double)m_frequency);
+
+    // A NULL event leaves whatever woke us in the queue. Rounded up, so it never wakes before a timer is due.
+    SDL_WaitEventTimeout(NULL, (int)std::ceil(timeout_seconds * 1000.0));
+
+    m_idle_seconds += seconds_since(wait_start);
+    m_frame_start = SDL_GetPerformanceCounter();
+    m_frame_recorded = true;
+}
+
+bool FramePacer::poll_for_event(double timeout_seconds)
+{
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (m_poll_start == 0)
+    {
+        if (m_frame_count > 0) m_frame_times.record((double)(now - m_frame_start) / (double)m_frequency);
+        m_poll_start = now;
+        m_poll_deadline = ~(Uint64)0;
+    }
+    m_poll_deadline = std::min(m_poll_deadline, now + (Uint64)(std::max(timeout_seconds, 0.0) * (double)m_frequency));
+
+    SDL_PumpEvents();
+    if (SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) == 0 && now < m_poll_deadline) return false;
+
+    m_idle_seconds += seconds_since(m_poll_start);
+    m_frame_start = SDL_GetPerformanceCounter();
+    m_frame_recorded = true;
+    m_poll_start = 0;
+    return true;
+}
+
+void FramePacer::end_frame()
+{
+    m_frame_count++;
+    if (m_target_frame_seconds <= 0.0) return;
+
+    // STEP 1: Sleep through most of what is left, giving the core back to the OS
+    double remaining = m_target_frame_seconds - seconds_since(m_frame_start);
+    if (remaining > SPIN_SECONDS)
+    {
+        Uint64 sleep_start = SDL_GetPerformanceCounter();
+        SDL_Delay((Uint32)((remaining - SPIN_SECONDS) * 1000.0));
+        m_slept_seconds += seconds_since(sleep_start);
+    }
+
+    // STEP 2: Spin the last stretch for an accurate wake-up
+    Uint64 spin_start = SDL_GetPerformanceCounter();
+    while (seconds_since(m_frame_start) < m_target_frame_seconds) {}
+    m_spun_seconds += seconds_since(spin_start);
+}
+
+void FramePacer::report() const
+{
+    double wall_seconds = seconds_since(m_run_start);
+    if (wall_seconds <= 0.0) return;
+
+    std::cout << "Frame pacer: " << m_frame_count << " frames in " << wall_seconds << " s"
+              << " (vsync " << VSYNC_NAMES[m_vsync_mode + 1] << ")" << std::endl;
+    std::cout << "Frame pacer: slept " << m_slept_seconds << " s ("
+              << 100.0 * m_slept_seconds / wall_seconds << "% of wall time), spun "
+              << m_spun_seconds << " s, idle " << m_idle_seconds << " s" << std::endl;
+
+    m_frame_times.report();
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <SDL.h>
+#include "FrameHistogram.h"
+
+enum VsyncMode { VSYNC_ADAPTIVE = -1, VSYNC_OFF = 0, VSYNC_ON = 1 };
+
+// "adaptive", "off" or "on"; false, leaving `mode` alone, for anything else
+bool parse_vsync_mode(const char* name, VsyncMode& mode);
+
+class FramePacer
+{
+private:
+    // SDL_Delay can oversleep by about a millisecond, so the tail of every wait is spun instead
+    static constexpr double SPIN_SECONDS = 0.002;
+    static const int DEFAULT_REFRESH_RATE = 60;  // when SDL can't tell
+
+    Uint64 m_frequency   = 1,
+           m_frame_start = 0,
+           m_run_start   = 0;
+
+    double m_target_frame_seconds = 0.0;  // 0 means uncapped (vsync alone paces the loop)
+    VsyncMode m_vsync_mode = VSYNC_OFF;
+
+    double m_slept_seconds = 0.0,
+           m_spun_seconds  = 0.0,
+           m_idle_seconds  = 0.0;
+    long long m_frame_count = 0;
+    bool m_frame_recorded = false;  // by wait_for_event, before the wait
+    Uint64 m_poll_start    = 0,     // poll_for_event's idle stretch so far; 0 when not idling
+           m_poll_deadline = 0;
+
+    // Start to start, so it covers the whole frame: the work, the swap and the sleep
+    FrameHistogram m_frame_times;
+
+    double seconds_since(Uint64 ticks) const;
+
+public:
+    // Must run after the GL context is current. Adaptive vsync falls back to regular vsync,
+    // and that to no vsync, if the driver turns the request down.
+    void initialise(int target_fps, VsyncMode vsync_mode);
+    // Also sets the budget frame times are judged against: the target, or when uncapped the
+    // display's refresh rate
+    void set_target_fps(int target_fps);
+
+    void begin_frame();
+    void end_frame();   // call after SDL_GL_SwapWindow; waits out the rest of the frame budget
+
+    // Between frames, when there's nothing new to draw: blocks until an event arrives (left in the
+    // queue for the next frame to handle) or timeout_seconds pass. The wait isn't counted as frame
+    // time, so idling doesn't read as a stall.
+    void wait_for_event(double timeout_seconds);
+
+    // The same without blocking, for a browser's frame callback: true once an event is queued or
+    // the timeout has run out, counted from the first call of the idle stretch. Each call's
+    // timeout only ever brings the deadline forward.
+    bool poll_for_event(double timeout_seconds);
+
+    void report() const;
+
+    // Drops the frames so far, e.g. the loading screen's, from the frame-time histogram
+    void clear_frame_times() { m_frame_times.clear(); };
+
+    VsyncMode const get_vsync_mode()    const { return m_vsync_mode; };
+    double    const get_slept_seconds() const { return m_slept_seconds; };
+    double    const get_spun_seconds()  const { return m_spun_seconds; };
+    double    const get_idle_seconds()  const { return m_idle_seconds; };
+    long long const get_frame_count()   const { return m_frame_count; };
+    const FrameHistogram& get_frame_times() const { return m_frame_times; };
+};
@@ -0,0 +1,80 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "FrameProfiler.h"
+
+void FrameProfiler::begin_frame()
+{
+    if (m_frame_count > 0) m_current = (m_current + 1) % SAMPLE_COUNT;
+    m_frame_count = std::min(m_frame_count + 1, SAMPLE_COUNT);
+
+    for (int section = 0; section < PROFILE_SECTION_COUNT; section++) m_samples[section][m_current] = 0.0f;
+    m_step_counts[m_current] = 0;
+}
+
+void FrameProfiler::begin_section(ProfileSection section)
+{
+    m_section_start[section] = Clock::now();
+}
+
+void FrameProfiler::end_section(ProfileSection section)
+{
+    m_samples[section][m_current] += std::chrono::duration<float, std::milli>(Clock::now() - m_section_start[section]).count();
+}
+
+SectionStats FrameProfiler::get_stats(ProfileSection section) const
+{
+    SectionStats stats = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    int count = get_sample_count();
+    if (count == 0) return stats;
+
+    float sorted[SAMPLE_COUNT];
+    float total = 0.0f;
+    for (int age = 1; age <= count; age++)
+    {
+        sorted[age - 1] = m_samples[section][frame_index(age)];
+        total += sorted[age - 1];
+    }
+
+    // Nearest rank: the smallest sample that at least 99% of frames come in under
+    int p99_rank = std::max((count * 99 + 99) / 100 - 1, 0);
+    std::nth_element(sorted, sorted + p99_rank, sorted + count);
+
+    stats.p99_ms = sorted[p99_rank];
+    stats.min_ms = *std::min_element(sorted, sorted + count);
+    stats.max_ms = *std::max_element(sorted, sorted + count);
+    stats.avg_ms = total / count;
+    return stats;
+}
+
+void FrameProfiler::build_graph_row(ProfileSection section, int row, int row_count, float scale_ms, char* out, int columns) const
+{
+    // Thresholds for this row, from the top row at scale_ms down to the bottom one
+    float full = scale_ms * (row_count - row) / row_count,
+          half = full - 0.5f * scale_ms / row_count;
+
+    int count = get_sample_count();
+    for (int column = 0; column < columns; column++)
+    {
+        int age = columns - column;
+        if (age > count)
+        {
+            out[column] = ' ';
+            continue;
+        }
+
+        float sample = m_samples[section][frame_index(age)];
+        out[column] = sample >= full ? '#' : sample >= half ? ':' : ' ';
+    }
+    out[columns] = '\0';
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// CPU time of each part of the frame over the last few seconds, for the on-screen profiler. Cheap
+// enough to leave recording all the time, so the history is already there when the HUD is opened.
+#include <chrono>
+
+enum ProfileSection { PROFILE_INPUT, PROFILE_UPDATE, PROFILE_RENDER, PROFILE_SECTION_COUNT };
+
+struct SectionStats
+{
+    float min_ms, avg_ms, p99_ms, max_ms;
+};
+
+class FrameProfiler
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    static constexpr int SAMPLE_COUNT = 240;  // four seconds at 60 fps
+
+    // Ring of frames; m_current is the one being recorded and is left out of every statistic
+    float m_samples[PROFILE_SECTION_COUNT][SAMPLE_COUNT] = {};
+    int   m_step_counts[SAMPLE_COUNT] = {};
+    int   m_current = 0,
+          m_frame_count = 0;
+
+    Clock::time_point m_section_start[PROFILE_SECTION_COUNT];
+
+    // Index of the completed frame `age` frames back, 1 being the last one
+    int const frame_index(int age) const { return (m_current - age + SAMPLE_COUNT) % SAMPLE_COUNT; };
+
+public:
+    class Scope
+    {
+    private:
+        FrameProfiler* m_profiler;
+        ProfileSection m_section;
+
+    public:
+        Scope(FrameProfiler& profiler, ProfileSection section) : m_profiler(&profiler), m_section(section) { m_profiler->begin_section(section); };
+        ~Scope() { m_profiler->end_section(m_section); };
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    void begin_frame();
+
+    // A section may be entered more than once a frame; its times add up
+    void begin_section(ProfileSection section);
+    void end_section(ProfileSection section);
+
+    // Fixed simulation steps run this frame
+    void set_step_count(int step_count) { m_step_counts[m_current] = step_count; };
+
+    SectionStats get_stats(ProfileSection section) const;
+
+    // One row of a bar graph of the last `columns` frames, oldest on the left, written to out as
+    // `columns` characters plus a terminator. Row 0 is the top; a column is '#' where its sample
+    // reaches the row, ':' where it reaches half of it and blank otherwise.
+    void build_graph_row(ProfileSection section, int row, int row_count, float scale_ms, char* out, int columns) const;
+
+    float const get_last_ms(ProfileSection section) const { return m_frame_count > 1 ? m_samples[section][frame_index(1)] : 0.0f; };
+    int   const get_last_step_count()               const { return m_frame_count > 1 ? m_step_counts[frame_index(1)] : 0; };
+    int   const get_sample_count()                  const { return m_frame_count > 1 ? m_frame_count - 1 : 0; };
+};
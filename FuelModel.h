@@ -0,0 +1,29 @@
+#pragma once
+
+// The booster as a rocket: a constant thrust F burning fuel at a constant rate b, pushing a mass
+// that gets lighter as it burns. Over a burn of length t, from mass m0 down to m1 = m0 - b t, the
+// velocity it adds has a closed form (Tsiolkovsky's),
+//     dv = (F / b) ln(m0 / m1)
+// and the distance it adds on top of coasting another,
+//     dx = (F / b) (t - (m1 / b) ln(m0 / m1))
+// so a step, or a whole flight, is worked out in one go rather than in many small ones.
+
+// ln(m0 / m1) for m0 >= m1 > 0, as 2 atanh(z) with z = (m0 - m1) / (m0 + m1), summed to four
+// terms. Only + - * /, so fixed-point builds stay bit-identical everywhere, as std::log wouldn't.
+// A step burns a sliver of the mass, which keeps z tiny; the error is under z^9 / 4.
+template <typename Scalar>
+inline Scalar log_mass_ratio(Scalar m0, Scalar m1)
+{
+    Scalar z  = (m0 - m1) / (m0 + m1),
+           z2 = z * z;
+    return Scalar(2.0f) * z * (Scalar(1.0f) + z2 * (Scalar(1.0f / 3.0f) + z2 * (Scalar(1.0f / 5.0f) + z2 * Scalar(1.0f / 7.0f))));
+}
+
+// The velocity `thrust` adds over `burn_time` seconds, starting at `mass` and burning
+// `burn_rate` a second; with no burn rate the mass stays put and the push is constant
+template <typename Scalar>
+inline Scalar burn_velocity_change(Scalar thrust, Scalar burn_rate, Scalar mass, Scalar burn_time)
+{
+    if (!(burn_rate > Scalar(0.0f))) return thrust / mass * burn_time;
+    return thrust / burn_rate * log_mass_ratio(mass, mass - burn_rate * burn_time);
+}
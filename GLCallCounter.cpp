@@ -0,0 +1,19 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include "GLCallCounter.h"
+
+long long g_gl_call_counts[GL_CALL_CATEGORY_COUNT] = {};
+
+long long get_gl_call_count(GLCallCategory category)
+{
+    return g_gl_call_counts[category];
+}
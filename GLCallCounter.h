@@ -0,0 +1,20 @@
+#pragma once
+
+// GL calls by kind, bumped by the render code next to every call it makes, so a redundant bind or
+// a stray upload shows up as a number in the HUD rather than as a vague slowdown. GL only ever
+// runs on the main thread, so these are plain counters.
+enum GLCallCategory
+{
+    GL_CALL_BIND,     // buffers, textures, vertex arrays, programs and framebuffers (unbinds too)
+    GL_CALL_UNIFORM,
+    GL_CALL_UPLOAD,   // buffer and texture data
+    GL_CALL_DRAW,
+    GL_CALL_CATEGORY_COUNT
+};
+
+extern long long g_gl_call_counts[GL_CALL_CATEGORY_COUNT];
+
+inline void count_gl_call(GLCallCategory category, int calls = 1) { g_gl_call_counts[category] += calls; }
+
+// Running totals since startup; subtract two readings to get a frame's
+long long get_gl_call_count(GLCallCategory category);
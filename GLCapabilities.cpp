@@ -0,0 +1,255 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <stdio.h>
+#include <string.h>
+#include "GLCapabilities.h"
+#include "CompressedTexture.h"
+
+int gl_version()
+{
+    static int version = -1;
+    if (version >= 0) return version;
+
+    // ES contexts report "OpenGL ES x.y", which doesn't parse here and leaves us at 0
+    int major = 0, minor = 0;
+    const char* version_string = (const char*)glGetString(GL_VERSION);
+    if (version_string != NULL) sscanf(version_string, "%d.%d", &major, &minor);
+
+    version = major * 10 + minor;
+    return version;
+}
+
+bool is_gles()
+{
+    static int gles = -1;
+    if (gles >= 0) return gles == 1;
+
+    const char* version_string = (const char*)glGetString(GL_VERSION);
+    gles = version_string != NULL && strncmp(version_string, "OpenGL ES", 9) == 0 ? 1 : 0;
+    return gles == 1;
+}
+
+bool is_core_profile()
+{
+#if defined(__APPLE__)
+    // Only ever a legacy context there; see supports_vertex_arrays
+    return false;
+#else
+    static int core = -1;
+    if (core >= 0) return core == 1;
+
+    // The profile mask only exists from 3.2 on, and anything older is compatibility by definition
+    GLint mask = 0;
+    if (gl_version() >= 32) glGetIntegerv(GL_CONTEXT_PROFILE_MASK, &mask);
+
+    core = (mask & GL_CONTEXT_CORE_PROFILE_BIT) ? 1 : 0;
+    return core == 1;
+#endif
+}
+
+bool supports_glsl_330()
+{
+#if defined(__APPLE__)
+    return false;
+#else
+    return gl_version() >= 33;
+#endif
+}
+
+bool supports_vertex_arrays()
+{
+#if defined(__APPLE__)
+    // Legacy macOS contexts only expose the APPLE variant, so stick to plain buffers there
+    return false;
+#elif defined(_WINDOWS)
+    // GLEW leaves the entry point NULL on pre-3.0 drivers without ARB_vertex_array_object
+    return glGenVertexArrays != NULL;
+#else
+    return gl_version() >= 30;
+#endif
+}
+
+bool supports_instancing()
+{
+#if defined(__APPLE__)
+    return false;
+#elif defined(_WINDOWS)
+    return glDrawArraysInstanced != NULL && glVertexAttribDivisor != NULL;
+#else
+    return gl_version() >= 33;
+#endif
+}
+
+bool supports_extension(const char* name)
+{
+    const size_t length = strlen(name);
+
+#if !defined(__APPLE__)
+    // Core profiles have no GL_EXTENSIONS string, only the indexed list
+    if (gl_version() >= 30)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++)
+        {
+            const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (extension != NULL && strcmp(extension, name) == 0) return true;
+        }
+        if (count > 0) return false;
+    }
+#endif
+
+    // Whole-word match, so that e.g. GL_EXT_foo doesn't match GL_EXT_foo_bar
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    while (extensions != NULL && (extensions = strstr(extensions, name)) != NULL)
+    {
+        if (extensions[length] == ' ' || extensions[length] == '\0') return true;
+        extensions += length;
+    }
+    return false;
+}
+
+bool supports_compressed_format(GLenum internal_format)
+{
+    switch (internal_format)
+    {
+    case COMPRESSED_RGB_S3TC_DXT1:
+    case COMPRESSED_RGBA_S3TC_DXT1:
+    case COMPRESSED_RGBA_S3TC_DXT3:
+    case COMPRESSED_RGBA_S3TC_DXT5:
+        return supports_extension("GL_EXT_texture_compression_s3tc");
+
+    case COMPRESSED_RGBA_BPTC_UNORM:
+        return gl_version() >= 42 || supports_extension("GL_ARB_texture_compression_bptc");
+
+    case COMPRESSED_RGB8_ETC2:
+    case COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+    case COMPRESSED_RGBA8_ETC2_EAC:
+        return gl_version() >= 43 || supports_extension("GL_ARB_ES3_compatibility");
+
+    default:
+        return false;
+    }
+}
+
+bool supports_program_binaries()
+{
+#if defined(__APPLE__)
+    return false;
+#else
+#if defined(_WINDOWS)
+    if (glGetProgramBinary == NULL || glProgramBinary == NULL) return false;
+#else
+    if (gl_version() < 41 && !supports_extension("GL_ARB_get_program_binary")) return false;
+#endif
+    // Some drivers expose the entry points but no format to go with them
+    GLint format_count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+    return format_count > 0;
+#endif
+}
+
+bool supports_generate_mipmap()
+{
+#if defined(__APPLE__)
+    return false;
+#elif defined(_WINDOWS)
+    return glGenerateMipmap != NULL;
+#else
+    return gl_version() >= 30 || supports_extension("GL_ARB_framebuffer_object");
+#endif
+}
+
+// WebGL maps no buffers and times no passes (its timer query extension is often withheld, and
+// isn't in Emscripten's GL names), so the web build leaves the three below off
+bool supports_timer_queries()
+{
+#if defined(__APPLE__) || defined(__EMSCRIPTEN__)
+    return false;
+#elif defined(_WINDOWS)
+    return glGenQueries != NULL && glGetQueryObjectui64v != NULL;
+#else
+    return gl_version() >= 33 || supports_extension("GL_ARB_timer_query");
+#endif
+}
+
+bool supports_framebuffer_objects()
+{
+#if defined(__APPLE__)
+    return false;
+#elif defined(_WINDOWS)
+    return glGenFramebuffers != NULL && glCheckFramebufferStatus != NULL;
+#else
+    return gl_version() >= 30 || supports_extension("GL_ARB_framebuffer_object");
+#endif
+}
+
+bool supports_blend_minmax()
+{
+#if defined(_WINDOWS)
+    return glBlendEquation != NULL;
+#else
+    return is_gles() ? supports_extension("GL_EXT_blend_minmax") : gl_version() >= 14;
+#endif
+}
+
+bool supports_pixel_buffer_objects()
+{
+#if defined(__APPLE__) || defined(__EMSCRIPTEN__)
+    return false;
+#elif defined(_WINDOWS)
+    return glMapBuffer != NULL && glUnmapBuffer != NULL;
+#else
+    return gl_version() >= 21 || supports_extension("GL_ARB_pixel_buffer_object");
+#endif
+}
+
+bool supports_buffer_storage()
+{
+#if defined(__APPLE__) || defined(__EMSCRIPTEN__)
+    return false;
+#elif defined(_WINDOWS)
+    return glBufferStorage != NULL && glFenceSync != NULL;
+#else
+    return gl_version() >= 44 || (gl_version() >= 32 && supports_extension("GL_ARB_buffer_storage"));
+#endif
+}
+
+bool supports_fence_sync()
+{
+#if defined(__APPLE__) || defined(__EMSCRIPTEN__)
+    return false;
+#elif defined(_WINDOWS)
+    return glFenceSync != NULL && glClientWaitSync != NULL;
+#else
+    return gl_version() >= 32 || supports_extension("GL_ARB_sync");
+#endif
+}
+
+bool supports_direct_state_access()
+{
+#if defined(__APPLE__)
+    return false;
+#elif defined(_WINDOWS)
+    return glCreateBuffers != NULL && glCreateVertexArrays != NULL && glTextureStorage2D != NULL;
+#else
+    // The extension needs a 3.1 context underneath it, and the VAO calls need vertex arrays
+    return gl_version() >= 45 || (gl_version() >= 31 && supports_extension("GL_ARB_direct_state_access"));
+#endif
+}
+
+bool supports_texture_arrays()
+{
+    // Arrays are core from 3.0, but the layered sprite shader is only written against GLSL 3.30
+    return supports_glsl_330();
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+// ————— RUNTIME FEATURE CHECKS ————— //
+// These must be called with a current GL context (i.e. after SDL_GL_CreateContext)
+int  gl_version();              // major * 10 + minor, e.g. 33 for OpenGL 3.3; 0 if unknown, and for ES
+bool is_gles();                 // an OpenGL ES context, where only ES 2.0 is assumed (see RenderBackend.h)
+bool is_core_profile();         // a 3.2+ core context: no client-side arrays, no default VAO, no GLSL 1.10
+bool supports_glsl_330();       // #version 330 shaders, uniform blocks included: any 3.3 context, core or not
+bool supports_vertex_arrays();
+bool supports_instancing();
+bool supports_extension(const char* name);
+bool supports_program_binaries();  // glGetProgramBinary/glProgramBinary with at least one binary format
+bool supports_generate_mipmap();   // glGenerateMipmap (GL 3.0 or ARB_framebuffer_object)
+bool supports_timer_queries();     // GL_TIME_ELAPSED queries with 64-bit results (GL 3.3 or ARB_timer_query)
+bool supports_framebuffer_objects();  // render targets other than the window (GL 3.0 or ARB_framebuffer_object)
+bool supports_blend_minmax();         // glBlendEquation(GL_MIN / GL_MAX): GL 1.4, or EXT_blend_minmax on ES
+bool supports_pixel_buffer_objects(); // glReadPixels into a buffer object, without waiting (GL 2.1 or ARB_pixel_buffer_object)
+bool supports_buffer_storage();       // persistent, coherent mappings with glBufferStorage (GL 4.4 or ARB_buffer_storage)
+bool supports_fence_sync();           // glFenceSync and polling it with glClientWaitSync (GL 3.2 or ARB_sync)
+bool supports_direct_state_access(); // editing objects by name, glCreate* and glNamed* (GL 4.5 or ARB_direct_state_access)
+bool supports_texture_arrays();       // GL_TEXTURE_2D_ARRAY, sampled by the GLSL 3.30 sprite shaders (SHADER_LAYERED)
+bool supports_compressed_format(GLenum internal_format);  // one of the formats in CompressedTexture.h
@@ -0,0 +1,50 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "GameEvents.h"
+
+bool GameEventBuffer::has_event(GameEventType type, int first) const
+{
+    for (size_t i = (size_t)first; i < m_events.size(); i++)
+    {
+        if (m_events[i].type == type) return true;
+    }
+    return false;
+}
+
+void GameEventStream::merge(const GameEventBuffer* const* buffers, int buffer_count)
+{
+    m_step++;
+    for (int buffer = 0; buffer < buffer_count; buffer++)
+    {
+        for (int i = 0; i < buffers[buffer]->get_count(); i++)
+        {
+            GameEvent event = buffers[buffer]->get_event(i);
+            event.step = m_step;
+            if (!m_ring.try_push(event)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+int GameEventStream::collect()
+{
+    // Whatever was merged by the time we look; anything merged after waits for the next call
+    m_events.resize(m_ring.get_capacity());
+    size_t count = m_ring.try_pop(m_events.data(), m_events.size());
+    m_events.resize(count);
+    return (int)count;
+}
+
+int const GameEventStream::count_events(GameEventType type) const
+{
+    int count = 0;
+    for (const GameEvent& event : m_events) count += event.type == type;
+    return count;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+// What happened during a step, as typed records rather than flags: a lander touching down (and
+// how hard), scraping a wall, running its tank dry. Entity::update appends them to whichever
+// GameEventBuffer its caller hands it, one buffer per thread, so producing one is a push_back
+// and nothing on the hot path calls anything back. Once the step is over, the buffers are merged
+// into a GameEventStream for audio, the HUD, telemetry and the flow scripts to read at their
+// leisure, on another thread if need be. A new kind of event is a new GameEventType, not another
+// out-parameter on every update() in the tree.
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "SpscRing.h"
+
+enum GameEventType : uint8_t
+{
+    EVENT_LANDED,      // down on a WIN surface; every step it stays down there, until it's decided
+    EVENT_CRASHED,     // down on a DEATH surface, or rock that isn't a pad
+    EVENT_SCRAPE,      // ran into something sideways, having been clear of it the step before
+    EVENT_FUEL_EMPTY,  // the booster burned the last of the tank
+    GAME_EVENT_TYPE_COUNT
+};
+
+struct GameEvent
+{
+    uint32_t  step;      // the GameEventStream's count of steps merged; 0 until merged
+    int16_t   lander;    // as get_lander() counts: 0 is the player
+    uint8_t   type;      // a GameEventType
+    uint8_t   surface;   // the EntityType touched, for the contact events
+    int32_t   platform;  // Contact::index of what was touched; -1 for none
+    float     speed;     // into the surface, or the lander's speed when its tank ran dry
+    glm::vec2 position;  // the lander's, after the step
+};
+
+// One thread's events from the step under way. Appends only; whoever owns it clears it.
+class GameEventBuffer
+{
+private:
+    std::vector<GameEvent> m_events;
+    int16_t                m_lander = 0;
+
+public:
+    // Stamped on everything pushed from now on
+    void set_lander(int lander) { m_lander = (int16_t)lander; };
+
+    void push(GameEventType type, int surface, int platform, float speed, glm::vec2 position)
+    {
+        m_events.push_back({ 0, m_lander, (uint8_t)type, (uint8_t)surface, platform, speed, position });
+    };
+    // One taken from another buffer, lander and all
+    void push(const GameEvent& event) { m_events.push_back(event); };
+    void clear() { m_events.clear(); };
+
+    // Whether one of `type` came in at index `first` or after
+    bool has_event(GameEventType type, int first = 0) const;
+
+    int              const get_count()    const { return (int)m_events.size(); };
+    const GameEvent& get_event(int index) const { return m_events[index]; };
+    const GameEvent* data()               const { return m_events.data(); };
+};
+
+// From the thread that steps to the thread that reads. The stepping thread merges each step's
+// buffers in once the step is done; the reading thread collects everything merged since its
+// last look once a frame, and every reader then goes over the same list. The hand-over is an
+// SpscRing, so neither side waits on the other; if the readers fall a ring behind, the newest
+// events are dropped and counted rather than stalling the simulation.
+class GameEventStream
+{
+private:
+    SpscRing<GameEvent> m_ring;
+
+    // ————— STEPPING THREAD ————— //
+    uint32_t               m_step = 0;
+    std::atomic<long long> m_dropped{ 0 };
+
+    // ————— READING THREAD ————— //
+    std::vector<GameEvent> m_events;
+
+public:
+    static const size_t DEFAULT_CAPACITY = 4096;
+
+    explicit GameEventStream(size_t capacity = DEFAULT_CAPACITY) : m_ring(capacity) {}
+
+    // Stepping thread, once a step, with every buffer the step's producers wrote to, in an order
+    // that doesn't change from step to step. Takes their events in that order; the caller clears
+    // them.
+    void merge(const GameEventBuffer* const* buffers, int buffer_count);
+
+    // Reading thread: replaces get_events() with whatever has been merged since; returns how many
+    int collect();
+
+    // Reading thread
+    const std::vector<GameEvent>& get_events() const { return m_events; };
+    int       const count_events(GameEventType type) const;
+    // Either thread
+    long long const get_dropped_count() const { return m_dropped.load(std::memory_order_relaxed); };
+};
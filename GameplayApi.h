@@ -0,0 +1,42 @@
+#pragma once
+
+// What a hot-reloadable gameplay module (gameplay_module.cpp, built as LanderGameplay) hands the
+// game: the physics step, the player's tuning and level generation, as plain function pointers
+// behind one C entry point, so the game can swap in a rebuilt copy without restarting.
+//
+// The state stays in the game: GameState, its Entities and SceneConfig are passed in by pointer
+// and laid out by the same headers on both sides. That layout is the ABI. A module is only taken
+// if its version and the three sizes match the game's; anything that changes them (a member added
+// to Entity, say) needs the game rebuilt too, and GAMEPLAY_API_VERSION bumped if the sizes happen
+// to come out the same. Constants and code behind the functions can change freely: gravity,
+// m_boosting_power and m_drag in setup_player, how Entity::update integrates, the scene layouts.
+#include <cstdint>
+#include "Entity.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+
+const uint32_t GAMEPLAY_API_VERSION = 1;
+
+struct GameplayApi
+{
+    uint32_t version;
+    uint32_t game_state_size,
+             entity_size,
+             scene_config_size;
+
+    void (*setup_player)(Entity* player);
+    void (*retune_lander)(Entity& lander);
+    void (*step_simulation)(GameState& state, float delta_time);
+    void (*generate_scene)(Entity* platforms, const SceneConfig& config, unsigned int seed);
+};
+
+// The module's one export, looked up by name
+#define GAMEPLAY_API_ENTRY "lander_gameplay_api"
+typedef const GameplayApi* (*GameplayApiEntry)();
+
+// The table over whichever copy of the functions is linked in: the game's own, or the module's
+inline GameplayApi make_gameplay_api()
+{
+    return { GAMEPLAY_API_VERSION, (uint32_t)sizeof(GameState), (uint32_t)sizeof(Entity), (uint32_t)sizeof(SceneConfig),
+             setup_player, retune_lander, step_simulation, generate_scene };
+}
@@ -0,0 +1,144 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <iostream>
+#include "GameplayModule.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+static void* open_library(const std::string& path)
+{
+#ifdef _WIN32
+    return (void*)LoadLibraryA(path.c_str());
+#else
+    return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+static void* find_symbol(void* library, const char* name)
+{
+#ifdef _WIN32
+    return (void*)GetProcAddress((HMODULE)library, name);
+#else
+    return dlsym(library, name);
+#endif
+}
+
+static void close_library(void* library)
+{
+#ifdef _WIN32
+    FreeLibrary((HMODULE)library);
+#else
+    dlclose(library);
+#endif
+}
+
+const GameplayApi& GameplayModule::get_builtin()
+{
+    static const GameplayApi api = make_gameplay_api();
+    return api;
+}
+
+bool GameplayModule::load(const char* filepath)
+{
+    unload();
+    m_path = filepath;
+
+    std::error_code error;
+    m_loaded_time = m_seen_time = std::filesystem::last_write_time(m_path, error);
+    if (error || !load_current())
+    {
+        unload();
+        return false;
+    }
+    return true;
+}
+
+bool GameplayModule::load_current()
+{
+    // STEP 1: A copy of its own, so the original can be rebuilt over while this one is in use
+    std::string copy = m_path + "." + std::to_string(m_copies.size() + 1);
+    std::error_code error;
+    std::filesystem::copy_file(m_path, copy, std::filesystem::copy_options::overwrite_existing, error);
+    if (error)
+    {
+        std::cout << "Gameplay module: unable to copy " << m_path << " (" << error.message() << ")" << std::endl;
+        return false;
+    }
+    m_copies.push_back(copy);
+
+    void* library = open_library(copy);
+    if (library == NULL)
+    {
+#ifdef _WIN32
+        std::cout << "Gameplay module: unable to load " << copy << std::endl;
+#else
+        std::cout << "Gameplay module: " << dlerror() << std::endl;
+#endif
+        return false;
+    }
+
+    // STEP 2: Only a table laid out over the same state as this build's
+    GameplayApiEntry entry = (GameplayApiEntry)find_symbol(library, GAMEPLAY_API_ENTRY);
+    const GameplayApi* api = entry != NULL ? entry() : NULL;
+    if (api == NULL || api->version != GAMEPLAY_API_VERSION || api->game_state_size != sizeof(GameState) ||
+        api->entity_size != sizeof(Entity) || api->scene_config_size != sizeof(SceneConfig))
+    {
+        std::cout << "Gameplay module: " << m_path << " doesn't match this build's GameState and Entity; rebuild the game too" << std::endl;
+        close_library(library);
+        return false;
+    }
+
+    m_libraries.push_back(library);
+    m_api = api;
+    return true;
+}
+
+void GameplayModule::unload()
+{
+    m_api = NULL;
+    for (void* library : m_libraries) close_library(library);
+    m_libraries.clear();
+
+    std::error_code error;
+    for (const std::string& copy : m_copies) std::filesystem::remove(copy, error);
+    m_copies.clear();
+}
+
+bool GameplayModule::poll()
+{
+    if (m_api == NULL) return false;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < m_next_poll) return false;
+    m_next_poll = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(POLL_SECONDS));
+
+    // STEP 1: Changed since the version loaded, and the same as at the last check
+    std::error_code error;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(m_path, error);
+    bool settled = time == m_seen_time;
+    m_seen_time = time;
+    if (error || time == m_loaded_time || !settled) return false;
+
+    // STEP 2: Tried once per build; a broken one waits for the next
+    m_loaded_time = time;
+    if (!load_current()) return false;
+
+    m_reload_count++;
+    std::cout << "Gameplay module: reloaded " << m_path << " (version " << m_reload_count + 1 << ")" << std::endl;
+    return true;
+}
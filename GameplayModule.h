@@ -0,0 +1,58 @@
+#pragma once
+
+// The game's side of the gameplay module (GameplayApi.h): loads LanderGameplay, then checks it
+// a few times a second and swaps in any rebuild between frames, so physics tuning and level
+// generation can change while the window, GL context, textures and GameState all carry on.
+//
+// Each version is loaded from a copy next to the original (LanderGameplay.so.1, .2, ...), which
+// leaves the original free for the linker to overwrite (Windows won't let it while it's loaded)
+// and gives every version its own name for the loader. A rebuild is only taken once its file has
+// stopped changing between two checks, so a half-written library is never opened. Old versions
+// stay loaded until exit, since a level being prepared on another thread may still be in them.
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "GameplayApi.h"
+
+class GameplayModule
+{
+private:
+    static constexpr double POLL_SECONDS = 0.25;
+
+    std::string        m_path;
+    std::vector<void*> m_libraries;  // every version loaded, the current one last
+    std::vector<std::string> m_copies;
+    std::atomic<const GameplayApi*> m_api{ NULL };  // read by levels being prepared on other threads
+
+    std::filesystem::file_time_type m_loaded_time,
+                                    m_seen_time;  // at the last check, to tell when it settles
+    std::chrono::steady_clock::time_point m_next_poll;
+    int m_reload_count = 0;
+
+    // Loads the file as it is now; false, leaving the current version in place, if it won't load
+    // or its ABI doesn't match this build's
+    bool load_current();
+
+public:
+    GameplayModule() = default;
+    GameplayModule(const GameplayModule&) = delete;
+    GameplayModule& operator=(const GameplayModule&) = delete;
+    ~GameplayModule() { unload(); }
+
+    // The game's own functions, for when no module is loaded
+    static const GameplayApi& get_builtin();
+
+    bool load(const char* filepath);
+    void unload();
+
+    // Once a frame, on the main thread; true when a new version has just been swapped in. Anything
+    // holding a function from the old table keeps working, and picks up the new one when it asks.
+    bool poll();
+
+    const GameplayApi& get_api()                const { const GameplayApi* api = m_api; return api != NULL ? *api : get_builtin(); };
+    bool               const is_loaded()        const { return m_api != NULL; };
+    int                const get_reload_count() const { return m_reload_count; };
+    const std::string& get_path()               const { return m_path; };
+};
@@ -0,0 +1,152 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include "GhostFleet.h"
+#include "Trace.h"
+
+int GhostFleet::load(const char* directory, float fixed_timestep)
+{
+    m_ghosts.clear();
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".lrp") continue;
+
+        Ghost ghost;
+        if (!ghost.replay.load(entry.path().string().c_str())) continue;
+        if (std::fabs(ghost.replay.get_fixed_timestep() - fixed_timestep) > 1e-6f) continue;
+        m_ghosts.push_back(std::move(ghost));
+    }
+
+    // The quickest down are the best, and the leaderboard only has room for so many
+    std::stable_sort(m_ghosts.begin(), m_ghosts.end(), [](const Ghost& a, const Ghost& b) { return a.replay.get_step_count() < b.replay.get_step_count(); });
+    if ((int)m_ghosts.size() > MAX_GHOSTS) m_ghosts.resize(MAX_GHOSTS);
+
+    m_landers.assign(m_ghosts.size(), Entity());
+    m_outcomes.assign(m_ghosts.size(), LanderOutcome());
+    m_instances.assign(m_ghosts.size(), SpriteInstance());
+    return (int)m_ghosts.size();
+}
+
+void GhostFleet::initialise(ShaderProgram* program, GLuint texture_id, const glm::vec4* frames)
+{
+    m_program = program;
+    m_texture_id = texture_id;
+    for (int i = 0; i < 3; i++) m_frames[i] = frames[i];
+
+    m_renderer.initialise(program);
+    if (m_renderer.is_supported() && !m_ghosts.empty()) m_group = m_renderer.add_group(program, texture_id, m_instances, true);
+}
+
+void GhostFleet::cleanup()
+{
+    m_renderer.cleanup();
+    m_group = -1;
+}
+
+void GhostFleet::restart(const GameState& level, const SceneConfig& scene, unsigned int seed)
+{
+    // STEP 1: The game's level, shared: with packed colliders, collision only reads the platforms
+    m_idle.deactivate();
+    m_state.player = &m_idle;
+    m_state.platforms = level.platforms;
+    m_state.platform_count = level.platform_count;
+    m_state.platform_broadphase = level.platform_broadphase;
+    m_state.platform_colliders = level.platform_colliders;
+    m_state.terrain = level.terrain;
+    m_state.distance_field = level.distance_field;
+    m_state.force_fields = level.force_fields;
+    m_state.fixed_timestep = level.fixed_timestep;
+    m_state.landers = m_landers.data();
+    m_state.lander_outcomes = m_outcomes.data();
+    m_state.lander_count = (int)m_landers.size();
+
+    // STEP 2: Every ghost back to the start, left out unless it flew this level
+    m_flying_count = 0;
+    for (size_t i = 0; i < m_ghosts.size(); i++)
+    {
+        Ghost& ghost = m_ghosts[i];
+        const SceneConfig& flown = ghost.replay.get_scene();
+        ghost.shown = ghost.replay.get_seed() == seed && flown.layout == scene.layout && flown.platform_count == scene.platform_count;
+        ghost.flying = ghost.shown;
+        ghost.run_offset = 0;
+        ghost.run_remaining = 0;
+
+        Entity& lander = m_landers[i];
+        setup_player(&lander);
+        reset_lander(lander, level.spawn_position);
+        m_outcomes[i] = LanderOutcome();
+        if (ghost.flying)
+        {
+            lander.activate();
+            m_flying_count++;
+        }
+        else lander.deactivate();
+    }
+}
+
+void GhostFleet::step()
+{
+    if (m_flying_count == 0) return;
+    TRACE_ZONE("GhostFleet::step");
+
+    // STEP 1: Each ghost's keys for this step, a run decoded whenever the last one runs out
+    for (size_t i = 0; i < m_ghosts.size(); i++)
+    {
+        Ghost& ghost = m_ghosts[i];
+        if (!ghost.flying) continue;
+
+        const LanderOutcome& outcome = m_outcomes[i];
+        if (outcome.win || outcome.loss || (ghost.run_remaining == 0 && !ghost.replay.read_run(ghost.run_offset, ghost.run_action, ghost.run_remaining)))
+        {
+            // Down, or out of keys: it stays where it ended, and the steps pass it by
+            ghost.flying = false;
+            m_landers[i].deactivate();
+            m_flying_count--;
+            continue;
+        }
+
+        apply_replay_action(&m_landers[i], ghost.run_action);
+        ghost.run_remaining--;
+    }
+
+    // STEP 2: All of them at once, against the same level
+    step_simulation(m_state, m_state.fixed_timestep);
+}
+
+void GhostFleet::draw(float alpha)
+{
+    if (m_group < 0) return;
+
+    // Every ghost that flew this level, the ones that have come down included, where they stopped
+    int count = 0;
+    for (size_t i = 0; i < m_ghosts.size(); i++)
+    {
+        if (!m_ghosts[i].shown) continue;
+        const Entity& lander = m_landers[i];
+
+        // The booster's frame picked as Entity::update picks its clip
+        float velocity_y = m_ghosts[i].flying ? (float)lander.get_velocity().y : 0.0f;
+        int   frame      = velocity_y > 1 ? Entity::HIGH : (velocity_y > 0 ? Entity::LOW : Entity::IDLE);
+        glm::vec2 position = glm::vec2(m_ghosts[i].flying ? lander.get_interpolated_position(alpha) : lander.get_position());
+        m_instances[count++] = { position, glm::vec2(lander.get_width(), lander.get_height()), m_frames[frame] };
+    }
+    if (count == 0) return;
+
+    m_renderer.update_group(m_group, m_instances.data(), count);
+    m_program->set_colour(1.0f, 1.0f, 1.0f, ALPHA);
+    m_renderer.draw(m_program);
+}
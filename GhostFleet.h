@@ -0,0 +1,86 @@
+#pragma once
+
+// Other attempts at the level flying alongside the player, from their replay files. A replay is
+// only the keys held (InputReplay.h), so each ghost is a lander stepped with them: every ghost
+// is one of the fleet's own GameState's landers, against the game's platforms, and one
+// step_simulation moves them all in lockstep with the player's steps. Runs are decoded one at a
+// time as the steps reach them, so no ghost's path is ever worked out ahead or held whole.
+//
+// Ghosts only collide with the level, never the player or each other, and only fly on the level
+// their replay was recorded on; restart() leaves the others out. All of them go up in one
+// streamed instance buffer and draw in one instanced call, translucent through the tinted
+// variant, so a hundred cost about what one does.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "InputReplay.h"
+#include "InstancedRenderer.h"
+#include "Simulation.h"
+
+class GhostFleet
+{
+private:
+    struct Ghost
+    {
+        InputReplay replay;
+        size_t      run_offset    = 0;
+        int         run_action    = REPLAY_NONE,
+                    run_remaining = 0;
+        bool        shown         = false,  // recorded on this level
+                    flying        = false;  // and still in the air, with keys left
+    };
+
+    std::vector<Ghost>         m_ghosts;    // best first
+    std::vector<Entity>        m_landers;   // one per ghost, as m_state.landers
+    std::vector<LanderOutcome> m_outcomes;
+    Entity                     m_idle;      // m_state.player, never active
+    GameState                  m_state;
+
+    ShaderProgram*              m_program = NULL;  // SHADER_TEXTURED | SHADER_INSTANCED | SHADER_TINTED
+    InstancedRenderer           m_renderer;
+    int                         m_group = -1;
+    GLuint                      m_texture_id = 0;
+    glm::vec4                   m_frames[3];       // the ship's IDLE, LOW and HIGH
+    std::vector<SpriteInstance> m_instances;
+
+    int m_flying_count = 0;
+
+public:
+    static const int           MAX_GHOSTS = 100;
+    static constexpr float     ALPHA      = 0.35f;
+
+    // Every replay in `directory` recorded at `fixed_timestep`, the MAX_GHOSTS shortest kept.
+    // Returns how many were kept.
+    int load(const char* directory, float fixed_timestep);
+
+    // GL thread. `frames` are the ship's IDLE, LOW and HIGH frames in texture_id.
+    void initialise(ShaderProgram* program, GLuint texture_id, const glm::vec4* frames);
+    void cleanup();
+
+    // Every ghost recorded on this level back on the spawn point, flying against `level`'s
+    // platforms; the rest sit it out. Call whenever the player starts a level.
+    void restart(const GameState& level, const SceneConfig& scene, unsigned int seed);
+
+    // Alongside each of the player's steps
+    void step();
+
+    // GL thread: every flying ghost drawn `alpha` of the way into its latest step, in one draw
+    void draw(float alpha);
+
+    int          const get_ghost_count()   const { return (int)m_ghosts.size(); };
+    const Entity&      get_lander(int i)   const { return m_landers[i]; };  // in load()'s order, best first
+    bool         const is_shown(int i)     const { return m_ghosts[i].shown; };
+    int          const get_flying_count()  const { return m_flying_count; };
+    int          const get_draw_calls()    const { return m_renderer.get_draw_calls(); };
+    GLuint       const get_texture_id()    const { return m_texture_id; };
+    ShaderProgram*     get_program()       const { return m_program; };
+
+    // The level the best ghost flew, for starting on it
+    bool               has_ghosts()        const { return !m_ghosts.empty(); };
+    const SceneConfig& get_best_scene()    const { return m_ghosts[0].replay.get_scene(); };
+    unsigned int const get_best_seed()     const { return m_ghosts[0].replay.get_seed(); };
+};
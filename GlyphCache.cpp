@@ -0,0 +1,249 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <fstream>
+#include "GlyphCache.h"
+#include "TextureSampling.h"
+
+namespace
+{
+    // 3x5 hex digits for the missing-glyph box, a row of three bits at a time from the top
+    const uint16_t BOX_DIGITS[16] =
+    {
+        0b111'101'101'101'111, 0b010'110'010'010'111, 0b111'001'111'100'111, 0b111'001'111'001'111,
+        0b101'101'111'001'001, 0b111'100'111'001'111, 0b111'100'111'101'111, 0b111'001'001'001'001,
+        0b111'101'111'101'111, 0b111'101'111'001'111, 0b010'101'111'101'101, 0b110'101'110'101'110,
+        0b011'100'100'100'011, 0b110'101'101'101'110, 0b111'100'111'100'111, 0b111'100'111'100'100
+    };
+
+    int hex_value(char digit)
+    {
+        if (digit >= '0' && digit <= '9') return digit - '0';
+        if (digit >= 'A' && digit <= 'F') return digit - 'A' + 10;
+        if (digit >= 'a' && digit <= 'f') return digit - 'a' + 10;
+        return -1;
+    }
+}
+
+void GlyphCache::initialise(int max_pages, int upload_budget)
+{
+    m_backend = get_render_backend();
+    m_max_pages = std::max(max_pages, 1);
+    m_upload_budget = std::max(upload_budget, 1);
+
+    // Never grown past this, so the glyphs get() hands out stay put
+    m_slots.reserve((size_t)m_max_pages * PAGE_CELLS * PAGE_CELLS);
+}
+
+void GlyphCache::cleanup()
+{
+    for (GLuint page : m_pages) m_backend->delete_texture(page);
+    m_pages.clear();
+    m_slots.clear();
+    m_recency.clear();
+    m_resident.clear();
+    m_backend = NULL;
+}
+
+bool GlyphCache::load_hex_font(const char* filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) return false;
+
+    // Only where each glyph's bits are; a line is read again when its glyph is first drawn
+    std::vector<HexEntry> index;
+    std::string line;
+    std::streamoff line_start = 0;
+    while (std::getline(file, line))
+    {
+        size_t colon = line.find(':');
+        size_t bits = line.size() - (colon + 1);
+        if (!line.empty() && line.back() == '\r') bits--;
+
+        if (colon != std::string::npos && colon > 0 && colon <= 6 && (bits == 32 || bits == 64))
+        {
+            char32_t code = 0;
+            bool valid = true;
+            for (size_t i = 0; i < colon; i++)
+            {
+                int digit = hex_value(line[i]);
+                valid = valid && digit >= 0;
+                code = code << 4 | (char32_t)std::max(digit, 0);
+            }
+            if (valid) index.push_back({ code, (uint32_t)(line_start + (std::streamoff)colon + 1), bits == 64 });
+        }
+        line_start += (std::streamoff)line.size() + 1;
+    }
+    if (index.empty()) return false;
+
+    std::sort(index.begin(), index.end(), [](const HexEntry& a, const HexEntry& b) { return a.code < b.code; });
+    m_hex_filepath = filepath;
+    m_hex_index = std::move(index);
+    return true;
+}
+
+const GlyphCache::HexEntry* GlyphCache::find_hex(char32_t code) const
+{
+    auto found = std::lower_bound(m_hex_index.begin(), m_hex_index.end(), code,
+                                  [](const HexEntry& entry, char32_t code) { return entry.code < code; });
+    return found != m_hex_index.end() && found->code == code ? &*found : NULL;
+}
+
+float GlyphCache::get_advance(char32_t code) const
+{
+    // The missing-glyph box is a wide one
+    const HexEntry* entry = find_hex(code);
+    return entry != NULL && !entry->wide ? 0.5f : 1.0f;
+}
+
+bool GlyphCache::rasterise(char32_t code, uint32_t* texels, bool& wide) const
+{
+    std::fill(texels, texels + CELL_SIZE * CELL_SIZE, 0u);
+    auto ink = [texels](int x, int y) { texels[(y + 1) * CELL_SIZE + x + 1] = 0xFFFFFFFFu; };
+
+    // STEP 1: The font's bits, a row at a time from the top, leftmost texel in the high bit
+    const HexEntry* entry = find_hex(code);
+    if (entry != NULL)
+    {
+        char bits[64];
+        std::ifstream file(m_hex_filepath, std::ios::binary);
+        int width = entry->wide ? 16 : 8,
+            digits = width / 4 * GLYPH_HEIGHT;
+
+        if (file.seekg(entry->offset) && file.read(bits, digits))
+        {
+            wide = entry->wide;
+            for (int y = 0; y < GLYPH_HEIGHT; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    int digit = hex_value(bits[y * width / 4 + x / 4]);
+                    if (digit > 0 && (digit & (8 >> (x % 4)))) ink(x, y);
+                }
+            }
+            return true;
+        }
+    }
+
+    // STEP 2: Otherwise a box with the code point in it, two rows of hex digits
+    wide = true;
+    for (int i = 0; i < GLYPH_HEIGHT; i++)
+    {
+        ink(i, 0);
+        ink(i, GLYPH_HEIGHT - 1);
+        ink(0, i);
+        ink(GLYPH_HEIGHT - 1, i);
+    }
+
+    int digit_count = code > 0xFFFF ? 6 : 4,
+        columns     = digit_count / 2,
+        left        = (GLYPH_HEIGHT - (columns * 4 - 1)) / 2;
+    for (int i = 0; i < digit_count; i++)
+    {
+        uint16_t digit = BOX_DIGITS[(code >> (4 * (digit_count - 1 - i))) & 0xF];
+        int x0 = left + (i % columns) * 4,
+            y0 = 2 + (i / columns) * 7;
+        for (int bit = 0; bit < 15; bit++)
+        {
+            if (digit & (1 << (14 - bit))) ink(x0 + bit % 3, y0 + bit / 3);
+        }
+    }
+    return false;
+}
+
+void GlyphCache::begin_frame()
+{
+    m_frame++;
+    m_frame_uploads = 0;
+}
+
+int GlyphCache::claim_slot()
+{
+    // STEP 1: A cell nobody has had yet, on a new page if the last one is full
+    int capacity = m_max_pages * PAGE_CELLS * PAGE_CELLS;
+    if ((int)m_slots.size() < capacity)
+    {
+        int index = (int)m_slots.size();
+        if (index / (PAGE_CELLS * PAGE_CELLS) >= (int)m_pages.size())
+        {
+            GLuint page = m_backend->create_texture(PAGE_SIZE, PAGE_SIZE, 1, NULL);
+            prepare_mip_chain(page, false);
+            apply_sampler_preset(page, SAMPLER_PIXEL_ART);
+            m_pages.push_back(page);
+        }
+
+        m_slots.push_back(Slot());
+        m_recency.push_front(index);
+        m_slots[index].recency = m_recency.begin();
+        return index;
+    }
+
+    // STEP 2: Full: the least recently drawn glyph goes, unless even that one is on screen now
+    int index = m_recency.back();
+    if (m_slots[index].last_frame == m_frame) return -1;
+
+    m_resident.erase(m_slots[index].code);
+    m_recency.splice(m_recency.begin(), m_recency, m_slots[index].recency);
+    m_evictions++;
+    return index;
+}
+
+const CachedGlyph* GlyphCache::get(char32_t code)
+{
+    // STEP 1: Resident: it moves to the front of the queue for eviction's sake
+    auto found = m_resident.find(code);
+    if (found != m_resident.end())
+    {
+        Slot& slot = m_slots[found->second];
+        slot.last_frame = m_frame;
+        m_recency.splice(m_recency.begin(), m_recency, slot.recency);
+        return &slot.glyph;
+    }
+
+    // STEP 2: A miss costs an upload, so it waits if this frame has had its share
+    if (m_backend == NULL) return NULL;
+    int index = m_frame_uploads < m_upload_budget ? claim_slot() : -1;
+    if (index < 0)
+    {
+        m_deferred++;
+        return NULL;
+    }
+
+    // STEP 3: Into its cell, clear border and all, so nothing of the glyph before it is left
+    uint32_t texels[CELL_SIZE * CELL_SIZE];
+    bool wide;
+    rasterise(code, texels, wide);
+
+    int cell = index % (PAGE_CELLS * PAGE_CELLS),
+        x    = cell % PAGE_CELLS * CELL_SIZE,
+        y    = cell / PAGE_CELLS * CELL_SIZE;
+    GLuint page = m_pages[index / (PAGE_CELLS * PAGE_CELLS)];
+    m_backend->update_texture(page, x, y, CELL_SIZE, CELL_SIZE, texels);
+    m_frame_uploads++;
+    m_uploads++;
+
+    // STEP 4: Laid out like the grid sheet's glyphs: an em high, its top half an em above the pen
+    float width = wide ? 16.0f : 8.0f;
+
+    Slot& slot = m_slots[index];
+    slot.code = code;
+    slot.last_frame = m_frame;
+    slot.glyph.texture_id = page;
+    slot.glyph.uv_rect = glm::vec4(x + 1, y + 1, width, GLYPH_HEIGHT) / (float)PAGE_SIZE;
+    slot.glyph.bearing = glm::vec2(0.0f, 0.5f);
+    slot.glyph.size    = glm::vec2(width / GLYPH_HEIGHT, 1.0f);
+    slot.glyph.advance = width / GLYPH_HEIGHT;
+
+    m_resident[code] = index;
+    return &slot.glyph;
+}
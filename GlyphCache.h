@@ -0,0 +1,113 @@
+#pragma once
+
+// Glyphs past ASCII (player names, localised strings), rasterised the first time they're drawn
+// into atlas pages of fixed-size cells and kept there for as long as they keep being drawn. When
+// every cell is taken, the least recently drawn glyph gives its cell up, so however many distinct
+// characters go by (CJK included), the cache never holds more than max_pages pages.
+//
+// Glyphs come out of a GNU Unifont-style .hex file (one `XXXX:bits` line per code point, 8 or 16
+// pixels wide by 16 high): load_hex_font indexes it, and a glyph's line is only read and turned
+// into texels on a miss. Code points the file lacks, or all of them without a file, are drawn as a
+// box with their hex digits in it, so nothing is ever silently dropped.
+//
+// Each new glyph is one sub-image upload, and a frame only does upload_budget of them: a string
+// full of new characters fills in over a few frames rather than hitching one. Pages are plain
+// RGBA, white where the glyph is inked, for the sprite batch to draw as ordinary sprites.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "RenderBackend.h"
+
+struct CachedGlyph
+{
+    GLuint    texture_id = 0;
+    glm::vec4 uv_rect = glm::vec4(0.0f);
+    glm::vec2 bearing = glm::vec2(0.0f);  // in ems, as GlyphMetrics
+    glm::vec2 size    = glm::vec2(0.0f);
+    float     advance = 0.0f;
+};
+
+class GlyphCache
+{
+public:
+    static const int GLYPH_HEIGHT = 16,                    // texels, and one em
+                     CELL_SIZE    = GLYPH_HEIGHT + 2,      // a clear texel all round, so neighbours never bleed
+                     PAGE_CELLS   = 16,                    // cells along each side of a page
+                     PAGE_SIZE    = CELL_SIZE * PAGE_CELLS,
+                     DEFAULT_MAX_PAGES     = 4,
+                     DEFAULT_UPLOAD_BUDGET = 32;           // new glyphs a frame
+
+private:
+    struct HexEntry
+    {
+        char32_t code;
+        uint32_t offset;  // of the line's bits in the file
+        bool     wide;    // 16 texels across rather than 8
+    };
+
+    struct Slot
+    {
+        char32_t    code;
+        CachedGlyph glyph;
+        long long   last_frame;
+        std::list<int>::iterator recency;
+    };
+
+    // ————— SOURCE ————— //
+    std::string           m_hex_filepath;
+    std::vector<HexEntry> m_hex_index;  // sorted by code
+
+    // ————— CACHE ————— //
+    std::vector<GLuint>               m_pages;
+    std::vector<Slot>                 m_slots;
+    std::list<int>                    m_recency;  // slot indices, most recently drawn first
+    std::unordered_map<char32_t, int> m_resident;
+
+    RenderBackend* m_backend = NULL;
+    int       m_max_pages     = DEFAULT_MAX_PAGES,
+              m_upload_budget = DEFAULT_UPLOAD_BUDGET,
+              m_frame_uploads = 0;
+    long long m_frame = 0;
+
+    long long m_uploads   = 0,
+              m_evictions = 0,
+              m_deferred  = 0;
+
+    const HexEntry* find_hex(char32_t code) const;
+    bool rasterise(char32_t code, uint32_t* texels, bool& wide) const;
+    int  claim_slot();
+
+public:
+    // GL thread. Pages are only made as glyphs need them.
+    void initialise(int max_pages = DEFAULT_MAX_PAGES, int upload_budget = DEFAULT_UPLOAD_BUDGET);
+    void cleanup();
+
+    // Indexes a .hex font; returns false, and keeps whatever was loaded before, if it can't be read
+    bool load_hex_font(const char* filepath);
+
+    // Once a frame, before any text is laid out: a new upload budget, and what counts as drawn "now"
+    void begin_frame();
+
+    // The glyph for `code`, rasterised and uploaded if it wasn't already. NULL when it isn't
+    // resident and can't be this frame: the upload budget is spent, or every cell holds a glyph
+    // already drawn this frame. Try again next frame.
+    const CachedGlyph* get(char32_t code);
+
+    // How far the pen moves past `code`, in ems, whether or not it's resident yet
+    float get_advance(char32_t code) const;
+
+    int       const get_resident_count() const { return (int)m_resident.size(); };
+    int       const get_page_count()     const { return (int)m_pages.size(); };
+    int       const get_glyph_count()    const { return (int)m_hex_index.size(); };  // in the loaded font
+    long long const get_uploads()        const { return m_uploads; };
+    long long const get_evictions()      const { return m_evictions; };
+    long long const get_deferred()       const { return m_deferred; };  // misses put off to a later frame
+};
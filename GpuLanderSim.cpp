@@ -0,0 +1,314 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstring>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "GpuLanderSim.h"
+#include "MemoryAccounting.h"
+#include "Trace.h"
+
+static const char* const STEP_VARYINGS[]    = { "outPosition", "outVelocity", "outOutcome" };
+static const char* const COLLECT_VARYINGS[] = { "outLander", "outPosition", "outVelocity", "outOutcome" };
+
+bool GpuLanderSim::is_supported()
+{
+    // Buffer textures and geometry shaders both come with any GLSL 3.30 context
+    return supports_glsl_330() && supports_vertex_arrays();
+}
+
+void GpuLanderSim::pack_setup(const GpuLanderSetup& setup, float* out)
+{
+    const float packed[FLOATS_PER_SETUP] = { setup.spawn.x, setup.spawn.y, setup.launch_velocity.x, setup.launch_velocity.y,
+                                             setup.gravity, setup.movement_x, setup.booster_active ? 1.0f : 0.0f, 0.0f };
+    std::memcpy(out, packed, sizeof(packed));
+}
+
+bool GpuLanderSim::initialise(const Entity& prototype, const GpuLanderSetup* setups, int lander_count, int max_steps)
+{
+    if (!is_supported() || lander_count <= 0) return false;
+
+    m_lander_count = lander_count;
+    m_max_steps    = std::max(max_steps, 0);
+    m_physics      = glm::vec4(prototype.get_speed(), (float)prototype.m_drag, (float)prototype.m_boosting_power, 0.0f);
+    m_lander_size  = glm::vec2(prototype.get_width(), prototype.get_height());
+
+    // ————— PROGRAMS ————— //
+    m_step_program.set_feedback_varyings(STEP_VARYINGS, 3);
+    m_step_program.load(EmbeddedShaders::LANDER_STEP_VERTEX, EmbeddedShaders::PARTICLE_UPDATE_FRAGMENT);
+
+    GLuint step_id = m_step_program.get_program_id();
+    m_platforms_uniform      = glGetUniformLocation(step_id, "platforms");
+    m_platform_count_uniform = glGetUniformLocation(step_id, "platformCount");
+    m_delta_time_uniform     = glGetUniformLocation(step_id, "deltaTime");
+    m_physics_uniform        = glGetUniformLocation(step_id, "physics");
+    m_lander_size_uniform    = glGetUniformLocation(step_id, "landerSize");
+    m_bounds_uniform         = glGetUniformLocation(step_id, "bounds");
+    m_max_steps_uniform      = glGetUniformLocation(step_id, "maxSteps");
+    m_relaunch_uniform       = glGetUniformLocation(step_id, "relaunch");
+
+    m_collect_program.set_feedback_varyings(COLLECT_VARYINGS, 4);
+    m_collect_program.set_geometry_shader(&EmbeddedShaders::LANDER_COLLECT_GEOMETRY);
+    m_collect_program.load(EmbeddedShaders::LANDER_COLLECT_VERTEX, EmbeddedShaders::PARTICLE_UPDATE_FRAGMENT);
+
+    // ————— BUFFERS ————— //
+    // Every lander on the launch pad of its setup, at the start of its first episode
+    std::vector<float> state((size_t)lander_count * FLOATS_PER_LANDER, 0.0f),
+                       packed_setups((size_t)lander_count * FLOATS_PER_SETUP);
+    for (int i = 0; i < lander_count; i++)
+    {
+        pack_setup(setups[i], &packed_setups[(size_t)i * FLOATS_PER_SETUP]);
+        std::memcpy(&state[(size_t)i * FLOATS_PER_LANDER], &packed_setups[(size_t)i * FLOATS_PER_SETUP], 4 * sizeof(float));
+    }
+
+    count_gl_call(GL_CALL_BIND, 4);
+    count_gl_call(GL_CALL_UPLOAD, 4);
+    glGenBuffers(2, m_state_buffers);
+    for (GLuint buffer : m_state_buffers)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, state.size() * sizeof(float), state.data(), GL_DYNAMIC_COPY);
+        track_gpu_buffer(buffer, (long long)(state.size() * sizeof(float)));
+    }
+
+    glGenBuffers(1, &m_setup_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_setup_buffer);
+    glBufferData(GL_ARRAY_BUFFER, packed_setups.size() * sizeof(float), packed_setups.data(), GL_STATIC_DRAW);
+    track_gpu_buffer(m_setup_buffer, (long long)(packed_setups.size() * sizeof(float)));
+
+    // Room for every lander at once, which is what a collect after a long gap can find
+    glGenBuffers(1, &m_result_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_result_buffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)lander_count * sizeof(ResultRecord), NULL, GL_STREAM_READ);
+    track_gpu_buffer(m_result_buffer, (long long)lander_count * (long long)sizeof(ResultRecord));
+
+    glGenBuffers(1, &m_platform_buffer);
+    glGenTextures(1, &m_platform_texture);
+    glGenQueries(1, &m_result_query);
+
+    // ————— VERTEX ARRAYS ————— //
+    // Two of each, one per state buffer, so the ping-pong is a choice of array
+    const GLsizei state_stride = FLOATS_PER_LANDER * sizeof(float),
+                  setup_stride = FLOATS_PER_SETUP * sizeof(float);
+    GLuint collect_id = m_collect_program.get_program_id();
+    const char* const state_names[] = { "landerPosition", "landerVelocity", "landerOutcome" };
+    const GLint  state_sizes[]      = { 2, 2, 4 };
+    const size_t state_offsets[]    = { 0, 2, 4 };  // in floats
+
+    glGenVertexArrays(2, m_step_arrays);
+    glGenVertexArrays(2, m_collect_arrays);
+    for (int i = 0; i < 2; i++)
+    {
+        GLuint arrays[]   = { m_step_arrays[i], m_collect_arrays[i] };
+        GLuint programs[] = { step_id, collect_id };
+        for (int pass = 0; pass < 2; pass++)
+        {
+            count_gl_call(GL_CALL_BIND, 2);
+            glBindVertexArray(arrays[pass]);
+            glBindBuffer(GL_ARRAY_BUFFER, m_state_buffers[i]);
+            for (int a = 0; a < 3; a++)
+            {
+                GLint attribute = glGetAttribLocation(programs[pass], state_names[a]);
+                if (attribute < 0) continue;
+                glVertexAttribPointer(attribute, state_sizes[a], GL_FLOAT, false, state_stride, (void*)(state_offsets[a] * sizeof(float)));
+                glEnableVertexAttribArray(attribute);
+            }
+        }
+
+        // Only the step reads the setups
+        glBindVertexArray(m_step_arrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, m_setup_buffer);
+        GLint setup_attributes[] = { glGetAttribLocation(step_id, "launch"), glGetAttribLocation(step_id, "controls") };
+        for (int a = 0; a < 2; a++)
+        {
+            if (setup_attributes[a] < 0) continue;
+            glVertexAttribPointer(setup_attributes[a], 4, GL_FLOAT, false, setup_stride, (void*)(a * 4 * sizeof(float)));
+            glEnableVertexAttribArray(setup_attributes[a]);
+        }
+    }
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_current = 0;
+    m_relaunch = false;
+    m_step_count = 0;
+    set_platforms(NULL, 0);
+    return true;
+}
+
+void GpuLanderSim::cleanup()
+{
+    if (!is_initialised()) return;
+
+    glDeleteVertexArrays(2, m_step_arrays);
+    glDeleteVertexArrays(2, m_collect_arrays);
+    GLuint buffers[] = { m_state_buffers[0], m_state_buffers[1], m_setup_buffer, m_result_buffer, m_platform_buffer };
+    untrack_gpu_buffers(5, buffers);
+    glDeleteBuffers(5, buffers);
+    glDeleteTextures(1, &m_platform_texture);
+    glDeleteQueries(1, &m_result_query);
+
+    for (int i = 0; i < 2; i++) m_step_arrays[i] = m_collect_arrays[i] = m_state_buffers[i] = 0;
+    m_setup_buffer = m_result_buffer = m_platform_buffer = m_platform_texture = m_result_query = 0;
+    m_lander_count = 0;
+}
+
+void GpuLanderSim::set_platforms(const Entity* platforms, int platform_count)
+{
+    if (!is_initialised()) return;
+
+    // Two texels a platform: centre and size, then the win and death flags
+    std::vector<glm::vec4> texels;
+    for (int i = 0; i < platform_count; i++)
+    {
+        if (!platforms[i].is_active()) continue;
+
+        glm::vec3 position = platforms[i].get_position();
+        texels.push_back(glm::vec4(position.x, position.y, platforms[i].get_width(), platforms[i].get_height()));
+        texels.push_back(glm::vec4(platforms[i].get_entity_type() == WIN_PLATFORM ? 1.0f : 0.0f,
+                                   platforms[i].get_entity_type() == DEATH_PLATFORM ? 1.0f : 0.0f, 0.0f, 0.0f));
+    }
+    m_platform_count = (int)texels.size() / 2;
+
+    // Never empty, so the texture always has storage behind it
+    if (texels.empty()) texels.push_back(glm::vec4(0.0f));
+
+    count_gl_call(GL_CALL_BIND, 4);
+    count_gl_call(GL_CALL_UPLOAD);
+    untrack_gpu_buffers(1, &m_platform_buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, m_platform_buffer);
+    glBufferData(GL_TEXTURE_BUFFER, texels.size() * sizeof(glm::vec4), texels.data(), GL_STATIC_DRAW);
+    track_gpu_buffer(m_platform_buffer, (long long)(texels.size() * sizeof(glm::vec4)));
+    glBindTexture(GL_TEXTURE_BUFFER, m_platform_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_platform_buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void GpuLanderSim::set_setups(int first, const GpuLanderSetup* setups, int count)
+{
+    first = std::max(first, 0);
+    count = std::min(count, m_lander_count - first);
+    if (!is_initialised() || count <= 0) return;
+
+    std::vector<float> packed((size_t)count * FLOATS_PER_SETUP);
+    for (int i = 0; i < count; i++) pack_setup(setups[i], &packed[(size_t)i * FLOATS_PER_SETUP]);
+
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindBuffer(GL_ARRAY_BUFFER, m_setup_buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)first * FLOATS_PER_SETUP * sizeof(float), packed.size() * sizeof(float), packed.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuLanderSim::step(float delta_time)
+{
+    if (!is_initialised()) return;
+    TRACE_ZONE("GpuLanderSim::step");
+
+    // STEP 1: The step's settings, all as uniforms
+    m_step_program.use();
+    count_gl_call(GL_CALL_UNIFORM, 8);
+    glUniform1i(m_platforms_uniform, 0);
+    glUniform1i(m_platform_count_uniform, m_platform_count);
+    glUniform1f(m_delta_time_uniform, delta_time);
+    glUniform3f(m_physics_uniform, m_physics.x, m_physics.y, m_physics.z);
+    glUniform2f(m_lander_size_uniform, m_lander_size.x, m_lander_size.y);
+    glUniform4f(m_bounds_uniform, m_bounds.x, m_bounds.y, m_bounds.z, m_bounds.w);
+    glUniform1i(m_max_steps_uniform, m_max_steps);
+    glUniform1i(m_relaunch_uniform, m_relaunch ? 1 : 0);
+    m_relaunch = false;
+
+    // STEP 2: Every lander through the vertex shader and into the other buffer, drawing nothing
+    count_gl_call(GL_CALL_BIND, 3);
+    glBindTexture(GL_TEXTURE_BUFFER, m_platform_texture);
+    glBindVertexArray(m_step_arrays[m_current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_state_buffers[1 - m_current]);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_POINTS, 0, m_lander_count);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    count_gl_call(GL_CALL_BIND, 3);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    m_current = 1 - m_current;
+    m_step_count++;
+}
+
+int GpuLanderSim::collect(std::vector<GpuLanderResult>& results)
+{
+    if (!is_initialised()) return 0;
+    TRACE_ZONE("GpuLanderSim::collect");
+
+    // STEP 1: The finished landers, packed by the geometry shader into the results buffer, with
+    //         the query counting how many it let through
+    m_collect_program.use();
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindVertexArray(m_collect_arrays[m_current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_result_buffer);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_result_query);
+    glBeginTransformFeedback(GL_POINTS);
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_POINTS, 0, m_lander_count);
+    glEndTransformFeedback();
+    glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+
+    // STEP 2: Only as many records as there were, which is where the wait for the GPU happens
+    GLuint count = 0;
+    glGetQueryObjectuiv(m_result_query, GL_QUERY_RESULT, &count);
+    if (count == 0) return 0;
+
+    m_records.resize(count);
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBuffer(GL_ARRAY_BUFFER, m_result_buffer);
+    const void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)count * sizeof(ResultRecord), GL_MAP_READ_BIT);
+    if (mapped != NULL)
+    {
+        std::memcpy(m_records.data(), mapped, (size_t)count * sizeof(ResultRecord));
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (mapped == NULL) return 0;
+
+    for (const ResultRecord& record : m_records)
+    {
+        GpuLanderResult result;
+        result.lander          = record.lander;
+        result.outcome         = (int)record.outcome[0];
+        result.steps           = (int)record.outcome[1];
+        result.touchdown_speed = record.outcome[2];
+        result.episode         = (int)record.outcome[3];
+        result.position        = glm::vec2(record.position[0], record.position[1]);
+        result.velocity        = glm::vec2(record.velocity[0], record.velocity[1]);
+        results.push_back(result);
+    }
+
+    // STEP 3: Read out, so the next step sends them round again
+    m_relaunch = true;
+    return (int)count;
+}
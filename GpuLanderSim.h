@@ -0,0 +1,138 @@
+#pragma once
+
+// BatchedLanderSim's step on the GPU, for parameter sweeps over more landers than the CPU can
+// carry. Every lander lives in a pair of buffers, and a step is one transform feedback draw
+// (shaders/lander_step_vertex.glsl) that integrates, collides against the platforms in a buffer
+// texture and decides the outcome, reading one buffer and writing the other; the CPU uploads
+// nothing per step. A lander that finishes holds still until collect(), whose geometry shader
+// pass (shaders/lander_collect_geometry.glsl) packs just the finished ones into a results buffer,
+// so the only readback is one record per completed episode. The next step relaunches them.
+//
+// A sweep is a table of GpuLanderSetups, one per lander: where it starts, how fast, under what
+// gravity and on which fixed controls. The arithmetic is the scalar path's, but GPUs are free to
+// fuse and reorder, so outcomes agree with BatchedLanderSim rather than matching it bit for bit.
+// Needs GLSL 3.30 (see is_supported); no CUDA, since nothing else here would use it.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec4.hpp"
+#include "Entity.h"
+#include "ShaderProgram.h"
+#include "Simulation.h"
+
+enum GpuLanderOutcome
+{
+    GPU_LANDER_FLYING,         // lander_step_vertex.glsl's codes
+    GPU_LANDER_WON,
+    GPU_LANDER_CRASHED,        // onto a DEATH_PLATFORM
+    GPU_LANDER_OUT_OF_BOUNDS,
+    GPU_LANDER_TIMED_OUT       // ran out of max_steps
+};
+
+// Where one lander starts every episode and how it flies it
+struct GpuLanderSetup
+{
+    glm::vec2 spawn           = glm::vec2(0.0f, 3.0f);  // GameState's spawn_position
+    glm::vec2 launch_velocity = glm::vec2(0.0f);
+    float     gravity         = ACC_OF_GRAVITY,
+              movement_x      = 0.0f;
+    bool      booster_active  = false;
+};
+
+// A finished episode, as collect() reads it back
+struct GpuLanderResult
+{
+    int       lander,
+              outcome,   // GpuLanderOutcome
+              steps,
+              episode;   // the lander's own count, from 0
+    glm::vec2 position,
+              velocity;
+    float     touchdown_speed;  // downward speed on the last touchdown, else 0
+};
+
+class GpuLanderSim
+{
+private:
+    static const int FLOATS_PER_LANDER = 8,  // position, velocity, outcome: the order captured
+                     FLOATS_PER_SETUP  = 8;  // launch, controls
+
+    // What the collect pass captures for each finished lander
+    struct ResultRecord
+    {
+        int32_t lander;
+        float   position[2],
+                velocity[2],
+                outcome[4];  // as landerOutcome
+    };
+    static_assert(sizeof(ResultRecord) == 9 * 4, "captured interleaved, with nothing between the fields");
+
+    // ————— GPU STATE ————— //
+    ShaderProgram m_step_program,
+                  m_collect_program;
+    GLuint m_state_buffers[2]   = { 0, 0 },
+           m_step_arrays[2]     = { 0, 0 },  // the step pass reading each buffer
+           m_collect_arrays[2]  = { 0, 0 },  // the collect pass reading each buffer
+           m_setup_buffer       = 0,
+           m_result_buffer      = 0,
+           m_platform_buffer    = 0,
+           m_platform_texture   = 0,
+           m_result_query       = 0;
+    int    m_current = 0;  // which buffer holds the latest state
+
+    GLint m_platforms_uniform      = -1,
+          m_platform_count_uniform = -1,
+          m_delta_time_uniform     = -1,
+          m_physics_uniform        = -1,
+          m_lander_size_uniform    = -1,
+          m_bounds_uniform         = -1,
+          m_max_steps_uniform      = -1,
+          m_relaunch_uniform       = -1;
+
+    // ————— CPU STATE ————— //
+    int       m_lander_count   = 0,
+              m_platform_count = 0,
+              m_max_steps      = 0;
+    glm::vec4 m_physics        = glm::vec4(0.0f);  // speed, drag, boosting power
+    glm::vec2 m_lander_size    = glm::vec2(1.0f);
+    glm::vec4 m_bounds         = glm::vec4(1.0f, 1.0f, -1.0f, -1.0f);  // off until set_bounds()
+    bool      m_relaunch       = false;  // collect() has read the finished landers out
+    long long m_step_count     = 0;
+
+    std::vector<ResultRecord> m_records;
+
+    static void pack_setup(const GpuLanderSetup& setup, float* out);
+
+public:
+    static bool is_supported();  // transform feedback, geometry shaders and buffer textures, with GLSL 3.30
+
+    // GL thread. Physical constants (speed, drag, boosting power, size) come from the prototype,
+    // as BatchedLanderSim's do; every lander starts at its setup. max_steps 0 never times out.
+    // False, having made nothing, where is_supported() would be.
+    bool initialise(const Entity& prototype, const GpuLanderSetup* setups, int lander_count, int max_steps = 0);
+    void cleanup();
+
+    // Inactive platforms are dropped, as BatchedLanderSim drops them
+    void set_platforms(const Entity* platforms, int platform_count);
+    // Landers whose centre leaves the box are done, GPU_LANDER_OUT_OF_BOUNDS
+    void set_bounds(glm::vec2 min, glm::vec2 max) { m_bounds = glm::vec4(min, max); };
+    // New setups for landers [first, first + count): controls from the next step, launches from
+    // their next episode
+    void set_setups(int first, const GpuLanderSetup* setups, int count);
+
+    // One fixed step of every lander still flying: a single draw, nothing read back
+    void step(float delta_time);
+
+    // Appends every episode that has finished since the last collect, and returns how many.
+    // Waits for the GPU to catch up, so call it every so many steps rather than after each.
+    int collect(std::vector<GpuLanderResult>& results);
+
+    bool      const is_initialised()    const { return m_state_buffers[0] != 0; };
+    int       const get_lander_count()  const { return m_lander_count; };
+    long long const get_step_count()    const { return m_step_count; };
+};
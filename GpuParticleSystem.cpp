@@ -0,0 +1,244 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <vector>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "GpuParticleSystem.h"
+#include "Trace.h"
+
+static const char* const FEEDBACK_VARYINGS[] = { "outOffset", "outScale", "outVelocity", "outAge" };
+static const float DEAD_AGE = 1.0e30f;  // older than any lifetime
+
+bool GpuParticleSystem::is_supported()
+{
+    return supports_glsl_330() && supports_instancing();
+}
+
+void GpuParticleSystem::initialise(ShaderProgram* program, GLuint texture_id, glm::vec4 uv_rect, int capacity)
+{
+    if (!is_supported() || capacity <= 0) return;
+
+    m_capacity = capacity;
+    m_texture_id = texture_id;
+    m_uv_rect = uv_rect;
+
+    // ————— UPDATE PROGRAM ————— //
+    m_update_program.set_feedback_varyings(FEEDBACK_VARYINGS, 4);
+    m_update_program.load(EmbeddedShaders::PARTICLE_UPDATE_VERTEX, EmbeddedShaders::PARTICLE_UPDATE_FRAGMENT);
+
+    GLuint update_id = m_update_program.get_program_id();
+    m_delta_time_uniform  = glGetUniformLocation(update_id, "deltaTime");
+    m_lifetime_uniform    = glGetUniformLocation(update_id, "lifetime");
+    m_gravity_uniform     = glGetUniformLocation(update_id, "gravity");
+    m_sizes_uniform       = glGetUniformLocation(update_id, "sizes");
+    m_capacity_uniform    = glGetUniformLocation(update_id, "capacity");
+    m_emit_count_uniform  = glGetUniformLocation(update_id, "emitCount");
+    m_emit_motion_uniform = glGetUniformLocation(update_id, "emitMotion");
+    m_emit_slots_uniform  = glGetUniformLocation(update_id, "emitSlots");
+
+    GLint offset_attribute   = glGetAttribLocation(update_id, "offset"),
+          velocity_attribute = glGetAttribLocation(update_id, "velocity"),
+          age_attribute      = glGetAttribLocation(update_id, "age");
+
+    // ————— BUFFERS ————— //
+    // Both start out dead, so nothing appears before the first emit
+    std::vector<float> particles((size_t)capacity * FLOATS_PER_PARTICLE, 0.0f);
+    for (int i = 0; i < capacity; i++) particles[(size_t)i * FLOATS_PER_PARTICLE + 6] = DEAD_AGE;
+
+    // Same corner and UV layout as InstancedRenderer's quad
+    const float quad[] =
+    {
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f, 0.0f, 0.0f
+    };
+
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD, 3);
+    glGenBuffers(2, m_particle_buffers);
+    for (GLuint buffer : m_particle_buffers)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(float), particles.data(), GL_DYNAMIC_COPY);
+        track_gpu_buffer(buffer, (long long)(particles.size() * sizeof(float)));
+    }
+
+    // The whole pool shares one frame of the sheet: a one-element array that never advances
+    glGenBuffers(1, &m_quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad) + sizeof(glm::vec4), NULL, GL_STATIC_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(quad), quad);
+    glBufferSubData(GL_ARRAY_BUFFER, sizeof(quad), sizeof(glm::vec4), &m_uv_rect);
+
+    // ————— VERTEX ARRAYS ————— //
+    // Two of each, one per buffer, so the ping-pong is a choice of array and nothing is re-pointed
+    const GLsizei stride = FLOATS_PER_PARTICLE * sizeof(float);
+    GLint offset_instance  = glGetAttribLocation(program->get_program_id(), "instanceOffset"),
+          scale_instance   = glGetAttribLocation(program->get_program_id(), "instanceScale");
+    m_uv_rect_attribute    = glGetAttribLocation(program->get_program_id(), "instanceUvRect");
+
+    glGenVertexArrays(2, m_update_arrays);
+    glGenVertexArrays(2, m_draw_arrays);
+    for (int i = 0; i < 2; i++)
+    {
+        count_gl_call(GL_CALL_BIND, 4);
+        glBindVertexArray(m_update_arrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, m_particle_buffers[i]);
+        GLint attributes[] = { offset_attribute, velocity_attribute, age_attribute };
+        GLint sizes[]      = { 2, 2, 1 };
+        size_t offsets[]   = { 0, 4, 6 };  // in floats
+        for (int a = 0; a < 3; a++)
+        {
+            if (attributes[a] < 0) continue;
+            glVertexAttribPointer(attributes[a], sizes[a], GL_FLOAT, false, stride, (void*)(offsets[a] * sizeof(float)));
+            glEnableVertexAttribArray(attributes[a]);
+        }
+
+        glBindVertexArray(m_draw_arrays[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+        glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 4 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(program->get_position_attribute());
+        glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+        if (m_uv_rect_attribute >= 0)
+        {
+            glVertexAttribPointer(m_uv_rect_attribute, 4, GL_FLOAT, false, 0, (void*)sizeof(quad));
+            glEnableVertexAttribArray(m_uv_rect_attribute);
+            glVertexAttribDivisor(m_uv_rect_attribute, capacity);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_particle_buffers[i]);
+        GLint instance_attributes[] = { offset_instance, scale_instance };
+        for (int a = 0; a < 2; a++)
+        {
+            if (instance_attributes[a] < 0) continue;
+            glVertexAttribPointer(instance_attributes[a], 2, GL_FLOAT, false, stride, (void*)(a * 2 * sizeof(float)));
+            glEnableVertexAttribArray(instance_attributes[a]);
+            glVertexAttribDivisor(instance_attributes[a], 1);
+        }
+    }
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_current = 0;
+    m_head = 0;
+    m_emit_count = 0;
+    m_retired = true;
+}
+
+void GpuParticleSystem::cleanup()
+{
+    if (!is_initialised()) return;
+
+    glDeleteVertexArrays(2, m_update_arrays);
+    glDeleteVertexArrays(2, m_draw_arrays);
+    untrack_gpu_buffers(2, m_particle_buffers);
+    glDeleteBuffers(2, m_particle_buffers);
+    glDeleteBuffers(1, &m_quad_buffer);
+
+    for (int i = 0; i < 2; i++) m_update_arrays[i] = m_draw_arrays[i] = m_particle_buffers[i] = 0;
+    m_quad_buffer = 0;
+    m_capacity = 0;
+}
+
+void GpuParticleSystem::burst(int count, glm::vec2 position, glm::vec2 velocity, float spread)
+{
+    count = std::min(count, m_capacity);
+    if (count <= 0 || m_emit_count == MAX_EMITS) return;
+
+    // The slots are handed out here, so the shader only has to check which range it falls in
+    m_emits[m_emit_count++] = { glm::vec4(position, velocity), glm::vec4((float)m_head, (float)count, spread, (float)m_seed) };
+    m_head = (m_head + count) % m_capacity;
+    m_seed = (m_seed + 1) & 0xFFFFFF;  // kept exact as a float
+    m_last_emit = m_time;
+}
+
+void GpuParticleSystem::spawn(float delta_time, float rate, glm::vec2 position, glm::vec2 velocity, float spread)
+{
+    m_spawn_carry += rate * delta_time;
+
+    int count = (int)m_spawn_carry;
+    m_spawn_carry -= count;
+
+    burst(count, position, velocity, spread);
+}
+
+void GpuParticleSystem::update(float delta_time)
+{
+    m_time += delta_time;
+    if (!is_initialised() || (m_emit_count == 0 && m_retired)) return;
+    TRACE_ZONE("GpuParticleSystem::update");
+
+    // The first update after the last particle's lifetime ages the whole pool past it, so the
+    // GPU's own count of time can't leave a straggler, and from then on nothing runs until an emit
+    m_retired = !is_active();
+    float step = m_retired ? m_lifetime : delta_time;
+
+    // STEP 1: This frame's emits and the pool's settings, all as uniforms
+    m_update_program.use();
+    count_gl_call(GL_CALL_UNIFORM, 8);
+    glUniform1f(m_delta_time_uniform, step);
+    glUniform1f(m_lifetime_uniform, m_lifetime);
+    glUniform1f(m_gravity_uniform, m_gravity);
+    glUniform2f(m_sizes_uniform, m_start_size, m_end_size);
+    glUniform1i(m_capacity_uniform, m_capacity);
+    glUniform1i(m_emit_count_uniform, m_emit_count);
+    if (m_emit_count > 0)
+    {
+        glUniform4fv(m_emit_motion_uniform, m_emit_count, &m_emits[0].motion.x);
+        glUniform4fv(m_emit_slots_uniform, m_emit_count, &m_emits[0].slots.x);
+    }
+    m_emit_count = 0;
+
+    // STEP 2: Every particle through the vertex shader and into the other buffer, drawing nothing
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindVertexArray(m_update_arrays[m_current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_particle_buffers[1 - m_current]);
+
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_POINTS, 0, m_capacity);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+
+    m_current = 1 - m_current;
+}
+
+void GpuParticleSystem::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (!is_initialised() || !is_active()) return;
+
+    // Dead slots come out with no size, so the whole pool is drawn rather than working out which
+    // part of the ring is alive
+    program->use();
+    count_gl_call(GL_CALL_BIND, 3);
+    count_gl_call(GL_CALL_DRAW);
+    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    glBindVertexArray(m_draw_arrays[m_current]);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, m_capacity);
+    glBindVertexArray(0);
+    m_draw_calls++;
+}
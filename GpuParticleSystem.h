@@ -0,0 +1,103 @@
+#pragma once
+
+// Particles that live entirely on the GPU, for the big one-off effects (crash debris, touchdown
+// dust) that would swamp ParticleSystem's per-particle CPU pass. The pool is a pair of buffers:
+// every frame a transform feedback pass (shaders/particle_update_vertex.glsl) reads one, ages each
+// particle and writes the other, and the instanced sprite shader draws straight out of the
+// result. The CPU never touches a particle: an emit is a slot range and a seed, handed to the
+// update pass as uniforms, so the frame's CPU cost is the same for ten particles or a million.
+//
+// Like ParticleSystem, everything shares one lifetime and new particles take over ring slots in
+// birth order, so a full pool overwrites its oldest. Needs GLSL 3.30 (see is_supported); callers
+// fall back to ParticleSystem without it.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+class GpuParticleSystem
+{
+public:
+    static const int DEFAULT_CAPACITY = 1 << 18,
+                     MAX_EMITS        = 16;  // per update(); the shader's MAX_EMITS
+
+private:
+    static const int FLOATS_PER_PARTICLE = 7;  // offset, scale, velocity, age: the order captured
+
+    struct EmitCommand
+    {
+        glm::vec4 motion;  // position, velocity
+        glm::vec4 slots;   // first slot, slot count, spread, seed
+    };
+
+    // ————— GPU STATE ————— //
+    ShaderProgram m_update_program;
+    GLuint m_particle_buffers[2] = { 0, 0 },
+           m_update_arrays[2]    = { 0, 0 },  // the update pass reading each buffer
+           m_draw_arrays[2]      = { 0, 0 },  // the sprite draw reading each buffer
+           m_quad_buffer         = 0;
+    int    m_current = 0;  // which buffer holds the latest particles
+
+    GLint m_delta_time_uniform = -1,
+          m_lifetime_uniform   = -1,
+          m_gravity_uniform    = -1,
+          m_sizes_uniform      = -1,
+          m_capacity_uniform   = -1,
+          m_emit_count_uniform = -1,
+          m_emit_motion_uniform = -1,
+          m_emit_slots_uniform  = -1;
+    GLint m_uv_rect_attribute  = -1;
+
+    GLuint    m_texture_id = 0;
+    glm::vec4 m_uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    // ————— CPU STATE ————— //
+    // Only slot bookkeeping; the particles themselves are never read back
+    EmitCommand m_emits[MAX_EMITS];
+    int         m_emit_count = 0,
+                m_capacity   = 0,
+                m_head       = 0;  // the next slot to launch
+    uint32_t    m_seed       = 1;
+    bool        m_retired    = true;  // the buffers hold nothing alive, so update() can skip
+
+    float  m_spawn_carry = 0.0f;
+    double m_time        = 0.0,
+           m_last_emit   = -1.0e9;  // when the newest particles were launched
+
+    int m_draw_calls = 0;
+
+public:
+    float m_lifetime   = 1.4f,
+          m_gravity    = -1.62f,
+          m_start_size = 0.1f,
+          m_end_size   = 0.02f;
+
+    // GL thread. `program` is the SHADER_TEXTURED | SHADER_INSTANCED sprite variant that draws
+    // the particles; does nothing where is_supported() would be false.
+    void initialise(ShaderProgram* program, GLuint texture_id, glm::vec4 uv_rect, int capacity = DEFAULT_CAPACITY);
+    void cleanup();
+
+    // `count` particles at once, fanned out by up to `spread` in velocity. Past MAX_EMITS in a
+    // frame, the rest are dropped until the next update().
+    void burst(int count, glm::vec2 position, glm::vec2 velocity, float spread);
+    // `rate` particles per second over delta_time, as ParticleSystem::spawn
+    void spawn(float delta_time, float rate, glm::vec2 position, glm::vec2 velocity, float spread);
+
+    // GL thread: launches this frame's emits and ages the pool, all on the GPU. Skipped once
+    // every particle has died.
+    void update(float delta_time);
+    void draw(ShaderProgram* program);
+
+    static bool is_supported();  // transform feedback, with the GLSL 3.30 shader it runs
+
+    bool   const is_initialised()  const { return m_particle_buffers[0] != 0; };
+    // Some particle may still be alive; exact, as everything lives for m_lifetime
+    bool   const is_active()       const { return m_time - m_last_emit < m_lifetime; };
+    int    const get_capacity()    const { return m_capacity; };
+    int    const get_draw_calls()  const { return m_draw_calls; };
+    GLuint const get_texture_id()  const { return m_texture_id; };
+};
@@ -0,0 +1,99 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include "GLCapabilities.h"
+#include "GpuProfiler.h"
+
+void GpuProfiler::initialise()
+{
+    m_supported = supports_timer_queries();
+    if (!m_supported) return;
+
+    glGenQueries(FRAME_LATENCY * MAX_PASSES, &m_queries[0][0]);
+}
+
+void GpuProfiler::cleanup()
+{
+    end_pass();
+    if (m_supported) glDeleteQueries(FRAME_LATENCY * MAX_PASSES, &m_queries[0][0]);
+
+    for (int frame = 0; frame < FRAME_LATENCY; frame++)
+    {
+        for (int pass = 0; pass < MAX_PASSES; pass++)
+        {
+            m_queries[frame][pass] = 0;
+            m_issued[frame][pass] = false;
+        }
+    }
+    m_supported = false;
+}
+
+void GpuProfiler::set_enabled(bool enabled)
+{
+    if (!enabled) end_pass();
+    m_enabled = enabled;
+}
+
+void GpuProfiler::collect(int frame)
+{
+    for (int pass = 0; pass < MAX_PASSES; pass++)
+    {
+        if (!m_issued[frame][pass])
+        {
+            // Nothing drew in this pass that frame
+            m_pass_ms[pass] = 0.0f;
+            continue;
+        }
+
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[frame][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+        {
+            GLuint64 nanoseconds = 0;
+#ifndef __EMSCRIPTEN__
+            glGetQueryObjectui64v(m_queries[frame][pass], GL_QUERY_RESULT, &nanoseconds);
+#endif
+            m_pass_ms[pass] = (float)(nanoseconds / 1.0e6);
+        }
+
+        m_issued[frame][pass] = false;
+    }
+}
+
+void GpuProfiler::begin_frame()
+{
+    end_pass();
+    if (!m_supported) return;
+
+    // The slot about to be reused is the oldest one, FRAME_LATENCY frames back
+    m_frame = (m_frame + 1) % FRAME_LATENCY;
+    collect(m_frame);
+}
+
+void GpuProfiler::begin_pass(int pass)
+{
+    end_pass();
+    if (!is_enabled() || pass < 0 || pass >= MAX_PASSES || m_issued[m_frame][pass]) return;
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_frame][pass]);
+    m_issued[m_frame][pass] = true;
+    m_active_pass = pass;
+}
+
+void GpuProfiler::end_pass()
+{
+    if (m_active_pass < 0) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_active_pass = -1;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// GPU time per render pass from GL_TIME_ELAPSED queries, the counterpart to FrameProfiler's CPU
+// times. A frame's queries are only read back once FRAME_LATENCY more frames have been issued, by
+// which time the GPU has long finished them, so profiling never stalls the pipeline. A result that
+// still isn't in by then is dropped rather than waited for.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+class GpuProfiler
+{
+public:
+    static const int MAX_PASSES    = 8,
+                     FRAME_LATENCY = 3;
+
+private:
+    GLuint m_queries[FRAME_LATENCY][MAX_PASSES] = {};
+    bool   m_issued[FRAME_LATENCY][MAX_PASSES]  = {};
+    float  m_pass_ms[MAX_PASSES] = {};  // newest result per pass, FRAME_LATENCY frames old
+
+    int  m_frame       = 0,
+         m_active_pass = -1;
+    bool m_supported   = false,
+         m_enabled     = false;
+
+    // Reads back whatever the given frame slot issued, which frees it for reuse
+    void collect(int frame);
+
+public:
+    // Needs a current context; leaves the profiler disabled when the driver has no timer queries
+    void initialise();
+    void cleanup();
+
+    void set_enabled(bool enabled);
+
+    // Once a frame, before any pass
+    void begin_frame();
+
+    // The GL only times one query at a time, so beginning a pass ends the one still running.
+    // A pass can be timed once a frame; later attempts go untimed.
+    void begin_pass(int pass);
+    void end_pass();
+
+    bool  const is_supported()        const { return m_supported; };
+    bool  const is_enabled()          const { return m_supported && m_enabled; };
+    float const get_pass_ms(int pass) const { return m_pass_ms[pass]; };
+};
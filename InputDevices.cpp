@@ -0,0 +1,220 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cstdlib>
+#include "InputDevices.h"
+
+// Past the dead zone, rescaled so the edge of it is 0 and full deflection 1
+static float apply_deadzone(Sint16 value, Sint16 deadzone)
+{
+    int magnitude = std::min(std::abs((int)value), 32767);
+    if (magnitude <= deadzone) return 0.0f;
+
+    float scaled = (float)(magnitude - deadzone) / (float)(32767 - deadzone);
+    return value < 0 ? -scaled : scaled;
+}
+
+// ————— KEYS ————— //
+int InputDevices::get_key_bit(SDL_Scancode scancode)
+{
+    switch (scancode)
+    {
+    case SDL_SCANCODE_UP:        return HELD_BOOST;
+    case SDL_SCANCODE_W:         return HELD_BOOST_2;
+    case SDL_SCANCODE_LEFT:      return HELD_LEFT;
+    case SDL_SCANCODE_A:         return HELD_LEFT_2;
+    case SDL_SCANCODE_RIGHT:     return HELD_RIGHT;
+    case SDL_SCANCODE_D:         return HELD_RIGHT_2;
+    case SDL_SCANCODE_BACKSPACE: return HELD_REWIND;
+    default:                     return 0;
+    }
+}
+
+// ————— CONTROLLERS ————— //
+InputDevices::Controller* InputDevices::find_controller(SDL_JoystickID id)
+{
+    for (Controller& controller : m_controllers)
+    {
+        if (controller.handle != NULL && controller.id == id) return &controller;
+    }
+    return NULL;
+}
+
+void InputDevices::open_controller(int device_index)
+{
+    for (Controller& controller : m_controllers)
+    {
+        if (controller.handle != NULL) continue;
+
+        SDL_GameController* handle = SDL_GameControllerOpen(device_index);
+        if (handle == NULL) return;
+
+        SDL_JoystickID id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(handle));
+        if (find_controller(id) != NULL)
+        {
+            // Already open: SDL reports controllers present at startup a second time
+            SDL_GameControllerClose(handle);
+            return;
+        }
+
+        controller = Controller();
+        controller.handle = handle;
+        controller.id = id;
+        return;
+    }
+}
+
+void InputDevices::close_controller(SDL_JoystickID id)
+{
+    Controller* controller = find_controller(id);
+    if (controller == NULL) return;
+
+    SDL_GameControllerClose(controller->handle);
+    *controller = Controller();
+}
+
+void InputDevices::close_all()
+{
+    for (Controller& controller : m_controllers)
+    {
+        if (controller.handle != NULL) SDL_GameControllerClose(controller.handle);
+        controller = Controller();
+    }
+    m_keys = 0;
+}
+
+// ————— EVENTS ————— //
+bool InputDevices::handle_event(const SDL_Event& event)
+{
+    switch (event.type)
+    {
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+    {
+        int bit = get_key_bit(event.key.keysym.scancode);
+        if (bit == 0 || event.key.repeat) return bit != 0;
+
+        if (event.type == SDL_KEYDOWN) m_keys |= bit;
+        else                           m_keys &= ~bit;
+        return true;
+    }
+
+    case SDL_CONTROLLERAXISMOTION:
+    {
+        Controller* controller = find_controller(event.caxis.which);
+        if (controller == NULL) return true;
+
+        if (event.caxis.axis == SDL_CONTROLLER_AXIS_LEFTX)             controller->steer    = apply_deadzone(event.caxis.value, STICK_DEADZONE);
+        else if (event.caxis.axis == SDL_CONTROLLER_AXIS_TRIGGERRIGHT) controller->throttle = std::max(apply_deadzone(event.caxis.value, TRIGGER_DEADZONE), 0.0f);
+        return true;
+    }
+
+    case SDL_CONTROLLERBUTTONDOWN:
+    case SDL_CONTROLLERBUTTONUP:
+    {
+        Controller* controller = find_controller(event.cbutton.which);
+        if (controller == NULL) return true;
+
+        int bit = 0;
+        switch (event.cbutton.button)
+        {
+        case SDL_CONTROLLER_BUTTON_A:            bit = HELD_BOOST;  break;
+        case SDL_CONTROLLER_BUTTON_DPAD_LEFT:    bit = HELD_LEFT;   break;
+        case SDL_CONTROLLER_BUTTON_DPAD_RIGHT:   bit = HELD_RIGHT;  break;
+        case SDL_CONTROLLER_BUTTON_LEFTSHOULDER: bit = HELD_REWIND; break;
+        default:                                 break;
+        }
+
+        if (event.type == SDL_CONTROLLERBUTTONDOWN) controller->held |= bit;
+        else                                        controller->held &= ~bit;
+        return true;
+    }
+
+    case SDL_CONTROLLERDEVICEADDED:
+        open_controller(event.cdevice.which);
+        return true;
+
+    case SDL_CONTROLLERDEVICEREMOVED:
+        close_controller(event.cdevice.which);
+        return true;
+
+    case SDL_WINDOWEVENT:
+        // Whatever's let go meanwhile goes unheard, so it's all let go now
+        if (event.window.event != SDL_WINDOWEVENT_FOCUS_LOST) return false;
+        release_all();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void InputDevices::release_all()
+{
+    m_keys = 0;
+    for (Controller& controller : m_controllers)
+    {
+        controller.steer = 0.0f;
+        controller.throttle = 0.0f;
+        controller.held = 0;
+    }
+}
+
+void InputDevices::peek_pending()
+{
+    // Keys and controllers don't affect each other, so each range can be run on its own
+    const Uint32 ranges[][2] = { { SDL_KEYDOWN, SDL_KEYUP }, { SDL_CONTROLLERAXISMOTION, SDL_CONTROLLERBUTTONUP } };
+
+    SDL_PumpEvents();
+    SDL_Event events[PEEK_BATCH];
+    for (const Uint32* range : ranges)
+    {
+        int count = SDL_PeepEvents(events, PEEK_BATCH, SDL_PEEKEVENT, range[0], range[1]);
+        for (int i = 0; i < count; i++) handle_event(events[i]);
+    }
+}
+
+// ————— ACTION ————— //
+int const InputDevices::get_action() const
+{
+    int held = m_keys;
+    float steer = 0.0f,
+          throttle = 0.0f;
+    for (const Controller& controller : m_controllers)
+    {
+        if (controller.handle == NULL) continue;
+        held |= controller.held;
+        steer += controller.steer;
+        throttle = std::max(throttle, controller.throttle);
+    }
+
+    if (held & (HELD_LEFT | HELD_LEFT_2))   steer -= 1.0f;
+    if (held & (HELD_RIGHT | HELD_RIGHT_2)) steer += 1.0f;
+    if (held & (HELD_BOOST | HELD_BOOST_2)) throttle = 1.0f;
+    return make_action(steer, throttle);
+}
+
+bool const InputDevices::is_rewind_held() const
+{
+    if (m_keys & HELD_REWIND) return true;
+    for (const Controller& controller : m_controllers)
+    {
+        if (controller.handle != NULL && (controller.held & HELD_REWIND)) return true;
+    }
+    return false;
+}
+
+int const InputDevices::get_controller_count() const
+{
+    int count = 0;
+    for (const Controller& controller : m_controllers) count += controller.handle != NULL ? 1 : 0;
+    return count;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// The keyboard and any game controllers, kept up to date from their events alone, and read as
+// one action record (ActionRecord.h). Nothing polls a key-state array: every press, release and
+// axis move is handled as it's polled, so the caller can stamp each change with when it happened.
+//
+// Everything held combines. Keys and the d-pad steer all the way, the left stick as far as it's
+// pushed past its dead zone, and they add up, left against right; the booster fires at the
+// furthest any of the keys, the A button or the right trigger asks for.
+//
+// A copy holds the same state, so a frame can run the events still queued through one to see
+// what's held now without taking them off the queue. Only the original opens and closes
+// controllers.
+#include <SDL.h>
+#include "ActionRecord.h"
+
+class InputDevices
+{
+public:
+    static const int MAX_CONTROLLERS = 4;
+
+private:
+    static const Sint16 STICK_DEADZONE   = 8000,  // about a quarter of the way over
+                        TRIGGER_DEADZONE = 1000;
+    static const int    PEEK_BATCH = 64;
+
+    // Held, a bit each, so letting go of one of two keys for the same thing keeps it held
+    enum HeldBit
+    {
+        HELD_BOOST   = 1,
+        HELD_LEFT    = 2,
+        HELD_RIGHT   = 4,
+        HELD_REWIND  = 8,
+        HELD_BOOST_2 = 16,
+        HELD_LEFT_2  = 32,
+        HELD_RIGHT_2 = 64
+    };
+
+    struct Controller
+    {
+        SDL_GameController* handle = NULL;
+        SDL_JoystickID      id = -1;
+        float               steer    = 0.0f,  // the stick's, -1 to 1
+                            throttle = 0.0f;  // the trigger's, 0 to 1
+        int                 held = 0;         // buttons, as HeldBits
+    };
+
+    int        m_keys = 0;  // HeldBits
+    Controller m_controllers[MAX_CONTROLLERS];
+
+    // The key's HeldBit, or 0 for one that isn't a control
+    static int get_key_bit(SDL_Scancode scancode);
+
+    Controller* find_controller(SDL_JoystickID id);
+    void        open_controller(int device_index);
+    void        close_controller(SDL_JoystickID id);
+
+public:
+    // False for anything that isn't input, which is left to the caller; true for what is, whether
+    // or not it changed the action
+    bool handle_event(const SDL_Event& event);
+    // As if everything had been let go, for when the window loses focus and stops hearing about it
+    void release_all();
+    void close_all();
+
+    // Runs whatever key and controller events are still queued through this, leaving the queue
+    // as it was. For a copy, to see ahead.
+    void peek_pending();
+
+    int  const get_action()      const;
+    bool const is_rewind_held()  const;
+    int  const get_controller_count() const;
+};
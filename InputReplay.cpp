@@ -0,0 +1,319 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "InputReplay.h"
+#include "Trace.h"
+
+const char InputReplay::MAGIC[4] = { 'L', 'R', 'P', 'Y' };
+
+// A run's varint carries the action's low bits, ACTION_ANALOG's included; version 2 and before
+// had no analog actions, and only three
+const int RUN_ACTION_BITS    = 4,
+          V2_RUN_ACTION_BITS = 3;
+
+// Runs longer than this are split, so every varint fits in 32 bits
+const int MAX_RUN_LENGTH = 1 << (32 - RUN_ACTION_BITS);
+
+int get_replay_action(const Entity& player)
+{
+    // Set from an action in the first place, so it packs back into the same one
+    return make_action(player.get_movement().x, player.m_booster_active ? (float)player.m_throttle : 0.0f);
+}
+
+void apply_replay_action(Entity* player, int action)
+{
+    player->set_movement(glm::vec3(get_action_steer(action), 0.0f, 0.0f));
+    player->m_booster_active = (action & REPLAY_BOOST) != 0;
+    player->m_throttle = (action & REPLAY_BOOST) ? get_action_throttle(action) : 1.0f;
+}
+
+glm::vec2 predict_action_offset(const Entity& player, int action, float seconds, float fixed_timestep)
+{
+    int held = get_replay_action(player);
+    if (action == held) return glm::vec2(0.0f);
+
+    // Sideways thrust is an acceleration, and so in effect is the booster: its power once a step,
+    // or its thrust over the mass with fuel, scaled by each action's throttle
+    float side_change  = get_action_steer(action) - get_action_steer(held),
+          boost_change = ((action & REPLAY_BOOST) ? get_action_throttle(action) : 0.0f) - ((held & REPLAY_BOOST) ? get_action_throttle(held) : 0.0f),
+          full_engine  = player.get_engine_acceleration(fixed_timestep) / (float)player.m_throttle;
+
+    glm::vec2 acceleration_change(side_change * player.get_speed(), boost_change * full_engine);
+    return 0.5f * acceleration_change * seconds * seconds;
+}
+
+// ————— RECORDING ————— //
+void InputReplay::begin(const SceneConfig& scene, unsigned int seed, float fixed_timestep)
+{
+    m_scene = scene;
+    m_seed = seed;
+    m_fixed_timestep = fixed_timestep;
+    m_step_count = 0;
+    m_runs.clear();
+    m_step_hashes.clear();
+    m_final_hash = 0;
+    m_open_action = REPLAY_NONE;
+    m_open_length = 0;
+    m_version = VERSION;
+}
+
+void InputReplay::close_run()
+{
+    if (m_open_length == 0) return;
+
+    uint32_t value = ((uint32_t)(m_open_length - 1) << RUN_ACTION_BITS) | (uint32_t)(m_open_action & ((1 << RUN_ACTION_BITS) - 1));
+    do
+    {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        m_runs.push_back(value != 0 ? byte | 0x80 : byte);
+    } while (value != 0);
+
+    if (m_open_action & ACTION_ANALOG)
+    {
+        m_runs.push_back((uint8_t)(m_open_action >> ACTION_STEER_SHIFT));
+        m_runs.push_back((uint8_t)(m_open_action >> ACTION_THROTTLE_SHIFT));
+    }
+
+    m_open_length = 0;
+}
+
+void InputReplay::record(int action, int steps)
+{
+    action &= ACTION_RECORD_MASK;
+
+    while (steps > 0)
+    {
+        if (action != m_open_action || m_open_length == MAX_RUN_LENGTH)
+        {
+            close_run();
+            m_open_action = action;
+        }
+
+        int taken = std::min(steps, MAX_RUN_LENGTH - m_open_length);
+        m_open_length += taken;
+        m_step_count += taken;
+        steps -= taken;
+    }
+}
+
+void InputReplay::record_step_hash(uint64_t step_hash)
+{
+    m_step_hashes.push_back((uint16_t)step_hash);
+    m_final_hash = step_hash;
+}
+
+bool InputReplay::save(const char* filepath)
+{
+    close_run();
+
+    ReplayHeader header = {};
+    memcpy(header.magic, MAGIC, sizeof(header.magic));
+    header.version = m_version >= 3 ? VERSION : 2;  // a loaded replay keeps its runs' packing
+    header.seed = m_seed;
+    header.layout = (uint32_t)m_scene.layout;
+    header.platform_count = (uint32_t)m_scene.platform_count;
+    header.fixed_timestep = m_fixed_timestep;
+    header.step_count = (uint32_t)m_step_count;
+    header.run_bytes = (uint32_t)m_runs.size();
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)m_runs.data(), m_runs.size());
+
+    uint32_t hash_count = (uint32_t)m_step_hashes.size();
+    file.write((const char*)&hash_count, sizeof(hash_count));
+    file.write((const char*)&m_final_hash, sizeof(m_final_hash));
+    file.write((const char*)m_step_hashes.data(), m_step_hashes.size() * sizeof(uint16_t));
+    return (bool)file;
+}
+
+bool InputReplay::load(const char* filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) return false;
+
+    ReplayHeader header;
+    if (!file.read((char*)&header, sizeof(header))) return false;
+    if (memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0 || header.version < 1 || header.version > VERSION ||
+        header.layout >= SCENE_LAYOUT_COUNT || header.platform_count == 0) return false;
+
+    std::vector<uint8_t> runs(header.run_bytes);
+    if (!file.read((char*)runs.data(), runs.size())) return false;
+
+    uint32_t hash_count = 0;
+    uint64_t final_hash = 0;
+    std::vector<uint16_t> step_hashes;
+    if (header.version >= 2)
+    {
+        if (!file.read((char*)&hash_count, sizeof(hash_count)) || !file.read((char*)&final_hash, sizeof(final_hash))) return false;
+        if (hash_count > header.step_count + 1) return false;
+        step_hashes.resize(hash_count);
+        if (!file.read((char*)step_hashes.data(), step_hashes.size() * sizeof(uint16_t))) return false;
+    }
+
+    SceneConfig scene;
+    scene.layout = (SceneLayout)header.layout;
+    scene.platform_count = (int)header.platform_count;
+
+    begin(scene, header.seed, header.fixed_timestep);
+    m_runs.swap(runs);
+    m_step_hashes.swap(step_hashes);
+    m_final_hash = final_hash;
+    m_step_count = (int)header.step_count;
+    m_version = header.version;
+    return true;
+}
+
+bool InputReplay::read_run(size_t& offset, int& action, int& length) const
+{
+    uint32_t value = 0;
+    int      shift = 0;
+    while (offset < m_runs.size())
+    {
+        uint8_t byte = m_runs[offset++];
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        shift += 7;
+
+        if ((byte & 0x80) == 0)
+        {
+            int action_bits = m_version >= 3 ? RUN_ACTION_BITS : V2_RUN_ACTION_BITS;
+            action = (int)(value & ((1u << action_bits) - 1));
+            length = (int)(value >> action_bits) + 1;
+            if (!(action & ACTION_ANALOG)) return true;
+
+            // Its steer and throttle, a byte each
+
+            if (offset + 2 > m_runs.size()) return false;
+            action |= (int)m_runs[offset] << ACTION_STEER_SHIFT | (int)m_runs[offset + 1] << ACTION_THROTTLE_SHIFT;
+            offset += 2;
+            return true;
+        }
+        if (shift >= 32) break;
+    }
+    return false;
+}
+
+// ————— PLAYBACK ————— //
+ReplayPlayer::ReplayPlayer(const InputReplay& replay, int keyframe_interval)
+    : m_replay(replay), m_world(replay.get_scene().platform_count), m_keyframe_interval(std::max(keyframe_interval, 1))
+{
+    GameState& state = m_world.state;
+    setup_player(&m_world.player);
+    generate_scene(state.platforms, replay.get_scene(), replay.get_seed());
+    state.platform_colliders->build(state.platforms, state.platform_count);
+    state.fixed_timestep = replay.get_fixed_timestep();
+
+    // The same choice of broadphase as the game, which files even the classic level
+    m_world.broadphase.build(state.platforms, state.platform_count);
+    state.platform_broadphase = &m_world.broadphase;
+
+    state.hash_steps = replay.get_step_hash_count() > 0;
+    reset_episode(state);
+    check_step_hash(0);
+
+    Keyframe start = {};
+    m_use_keyframes = save_snapshot(state, start.snapshot);
+    m_keyframes.push_back(start);
+}
+
+bool ReplayPlayer::next_run()
+{
+    return m_replay.read_run(m_run_offset, m_run_action, m_run_remaining);
+}
+
+void ReplayPlayer::restore(const Keyframe& keyframe)
+{
+    GameState& state = m_world.state;
+
+    if (m_use_keyframes) restore_snapshot(state, keyframe.snapshot);
+    else                 reset_episode(state);
+
+    m_step = keyframe.step;
+    m_run_offset = keyframe.run_offset;
+    m_run_action = keyframe.run_action;
+    m_run_remaining = keyframe.run_remaining;
+}
+
+void ReplayPlayer::check_step_hash(int step)
+{
+    if (step >= m_replay.get_step_hash_count() || (m_divergent_step >= 0 && m_divergent_step <= step)) return;
+
+    // The last recorded hash is also there in full
+    uint64_t step_hash = m_world.state.step_hash;
+    bool matches = step + 1 == m_replay.get_step_hash_count() ? step_hash == m_replay.get_final_hash() : (uint16_t)step_hash == m_replay.get_step_hash(step);
+    if (!matches) m_divergent_step = step;
+}
+
+void ReplayPlayer::restart()
+{
+    restore(m_keyframes[0]);
+}
+
+int ReplayPlayer::advance(int steps)
+{
+    TRACE_ZONE("ReplayPlayer::advance");
+    GameState& state = m_world.state;
+    int taken = 0;
+
+    while (taken < steps && !is_finished())
+    {
+        if (m_run_remaining == 0 && !next_run()) break;
+
+        // The whole run, or as much of it as is wanted, at one action; keyframes cut it short
+        int batch = std::min(m_run_remaining, steps - taken);
+        if (m_use_keyframes)
+        {
+            int next_keyframe = (m_step / m_keyframe_interval + 1) * m_keyframe_interval;
+            batch = std::min(batch, next_keyframe - m_step);
+        }
+
+        apply_replay_action(state.player, m_run_action);
+        int ran = 0;
+        while (ran < batch && !state.win && !state.loss)
+        {
+            step_simulation(state, state.fixed_timestep);
+            ran++;
+            check_step_hash(m_step + ran);
+        }
+
+        m_step += ran;
+        m_run_remaining -= ran;
+        taken += ran;
+
+        // Filed the first time playback passes each one
+        if (m_use_keyframes && m_step % m_keyframe_interval == 0 && m_step > m_keyframes.back().step)
+        {
+            Keyframe keyframe = { m_step, m_run_offset, m_run_action, m_run_remaining, {} };
+            save_snapshot(state, keyframe.snapshot);
+            m_keyframes.push_back(keyframe);
+        }
+    }
+
+    return taken;
+}
+
+void ReplayPlayer::seek(int step)
+{
+    step = std::min(std::max(step, 0), m_replay.get_step_count());
+
+    // STEP 1: Carry on from where we are unless the target is behind us or a keyframe is closer
+    auto after = std::upper_bound(m_keyframes.begin(), m_keyframes.end(), step, [](int value, const Keyframe& keyframe) { return value < keyframe.step; });
+    const Keyframe& nearest = *(after - 1);
+
+    if (step < m_step || nearest.step > m_step || m_world.state.win || m_world.state.loss) restore(nearest);
+
+    // STEP 2: Re-simulate the rest
+    advance(step - m_step);
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+// Input replays: the scene seed plus what the player held on every simulation step, which is
+// all a deterministic step needs to play a session back exactly.
+//
+//   ReplayHeader | runs | u32 hash count | u64 final hash | u16 step hashes
+//
+// Each run is one action held for some number of steps, packed as a LEB128 varint of
+// (length - 1) << 4 | the action's low four bits, so a step of steady input costs nothing and a
+// whole descent of a few dozen key changes is a few dozen bytes. An analog action (ActionRecord.h)
+// follows its varint with two bytes, its steer and its throttle. All fields are little-endian.
+//
+// Since version 2 the recording also keeps GameState::step_hash as it stood before each step,
+// and after the last: the low 16 bits of each, plus the last in full. The hashes are chained, so
+// once playback strays every later one misses too, and the first to miss is the step it strayed
+// on (one short hash in 65536 matches by chance, which only moves that a step later). Version 1
+// replays, with no hashes, still load. Versions before 3 had no analog actions, and packed
+// runs with three action bits rather than four; they load too.
+#include <cstdint>
+#include <vector>
+#include "ActionRecord.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+#include "WorldPool.h"
+
+// The same bits as LanderAction. An action can also be an analog one, as ActionRecord.h packs it.
+enum ReplayAction
+{
+    REPLAY_NONE  = 0,
+    REPLAY_LEFT  = ACTION_LEFT,
+    REPLAY_RIGHT = ACTION_RIGHT,
+    REPLAY_BOOST = ACTION_BOOST
+};
+
+struct ReplayHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t seed;
+    uint32_t layout;          // a SceneLayout
+    uint32_t platform_count;
+    float    fixed_timestep;
+    uint32_t step_count;
+    uint32_t run_bytes;
+};
+
+// What the player is holding this step, as ReplayAction bits, or an analog action where the
+// controls are set in between
+int get_replay_action(const Entity& player);
+void apply_replay_action(Entity* player, int action);
+
+// How much further `action` would have carried the player `seconds` into a step than the
+// controls it is actually stepping with: the change in acceleration, integrated over that time.
+// For drawing the newest keys before the simulation has run a step with them; never simulated.
+glm::vec2 predict_action_offset(const Entity& player, int action, float seconds, float fixed_timestep);
+
+class InputReplay
+{
+private:
+    SceneConfig  m_scene;
+    unsigned int m_seed = 0;
+    float        m_fixed_timestep = FIXED_TIMESTEP;
+    int          m_step_count = 0;
+
+    std::vector<uint8_t>  m_runs;
+    std::vector<uint16_t> m_step_hashes;  // [n] is the state after n steps
+    uint64_t              m_final_hash = 0;
+
+    // The run still being recorded; only encoded once the action changes or the replay is saved
+    int m_open_action = REPLAY_NONE,
+        m_open_length = 0;
+
+    uint32_t m_version = VERSION;  // the file's, for how its runs are packed
+
+    void close_run();
+
+public:
+    static const uint32_t VERSION = 3;
+    static const char     MAGIC[4];
+
+    // Starts over for a new level; anything recorded so far is dropped
+    void begin(const SceneConfig& scene, unsigned int seed, float fixed_timestep);
+    // `steps` consecutive steps of the same action
+    void record(int action, int steps = 1);
+    // GameState::step_hash before each step recorded, and once more after the last
+    void record_step_hash(uint64_t step_hash);
+
+    // The run starting `offset` bytes into the runs, moving `offset` past it; false at the end.
+    // For playing a replay back a run at a time, as ReplayPlayer and the game's ghosts do.
+    bool read_run(size_t& offset, int& action, int& length) const;
+
+    // False if the file can't be written, or on load if it is missing, truncated or from another version
+    bool save(const char* filepath);
+    bool load(const char* filepath);
+
+    const SceneConfig& get_scene()  const { return m_scene; };
+    unsigned int const get_seed()           const { return m_seed; };
+    float        const get_fixed_timestep() const { return m_fixed_timestep; };
+    int          const get_step_count()     const { return m_step_count; };
+    size_t       const get_size()           const { return sizeof(ReplayHeader) + m_runs.size() + sizeof(uint32_t) + sizeof(m_final_hash) + m_step_hashes.size() * sizeof(uint16_t); };
+    // None for a version 1 replay, or one recorded without GameState::hash_steps
+    int          const get_step_hash_count() const { return (int)m_step_hashes.size(); };
+    uint16_t     const get_step_hash(int step) const { return m_step_hashes[step]; };
+    uint64_t     const get_final_hash()     const { return m_final_hash; };
+};
+
+// Plays an InputReplay back through the headless core as fast as it will step. A snapshot is
+// kept every keyframe_interval steps on the way, so seeking backwards only re-simulates from the
+// keyframe before the target. Scenes too big for a fixed-capacity SimulationSnapshot (see
+// LANDER_SNAPSHOT_PLATFORMS) seek from the start.
+class ReplayPlayer
+{
+private:
+    struct Keyframe
+    {
+        int                step;
+        size_t             run_offset;      // where the next run starts in the replay's bytes
+        int                run_action,
+                           run_remaining;   // steps left of the current run
+        SimulationSnapshot snapshot;
+    };
+
+    const InputReplay& m_replay;
+    World              m_world;
+    int                m_keyframe_interval;
+    bool               m_use_keyframes;
+
+    std::vector<Keyframe> m_keyframes;  // in step order; [0] is the start of the level
+
+    int    m_step = 0;
+    int    m_divergent_step = -1;
+    size_t m_run_offset = 0;
+    int    m_run_action = REPLAY_NONE,
+           m_run_remaining = 0;
+
+    bool next_run();
+    void restore(const Keyframe& keyframe);
+    void check_step_hash(int step);
+
+public:
+    ReplayPlayer(const InputReplay& replay, int keyframe_interval = 1024);
+
+    ReplayPlayer(const ReplayPlayer&) = delete;
+    ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+    // Back to the first step
+    void restart();
+    // Up to `steps` more steps, stopping early at the end of the replay or of the episode;
+    // returns how many ran
+    int  advance(int steps);
+    // To just after step `step` (0 for the start), from the nearest keyframe at or before it
+    void seek(int step);
+
+    const GameState& get_state()       const { return m_world.state; };
+    int        const get_step()        const { return m_step; };
+    bool       const is_finished()     const { return m_step >= m_replay.get_step_count() || m_world.state.win || m_world.state.loss; };
+    int        const get_keyframe_count() const { return (int)m_keyframes.size(); };
+    // The first step played whose state differs from the recording's, or -1 if none has (or the
+    // replay has no hashes to check). Steps count from 0 for the state the level starts in.
+    int        const get_divergent_step() const { return m_divergent_step; };
+};
@@ -0,0 +1,35 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "InputTimeline.h"
+
+bool InputTimeline::push(double time, int action)
+{
+    if (action == m_pushed_action) return true;
+    if (!m_ring.try_push(TimedInput{ time, action })) return false;
+
+    m_pushed_action = action;
+    return true;
+}
+
+int InputTimeline::get_action(double time)
+{
+    // STEP 1: Everything pushed since the last call, behind whatever was already waiting
+    TimedInput arrived[32];
+    size_t count;
+    while ((count = m_ring.try_pop(arrived, 32)) > 0) m_pending.insert(m_pending.end(), arrived, arrived + count);
+
+    // STEP 2: The newest change that had happened by `time`
+    size_t due = 0;
+    while (due < m_pending.size() && m_pending[due].time <= time) m_action = m_pending[due++].action;
+    m_pending.erase(m_pending.begin(), m_pending.begin() + due);
+
+    return m_action;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// The player's input as a timeline of changes rather than a once-a-frame sample: each change is
+// stamped with when it happened, and the simulation asks what was held at the start of each
+// fixed step. A key pressed late in a frame then only reaches the steps after it, not every step
+// the frame runs, and a replay records what each step actually saw.
+//
+// One thread pushes (the one that polls the window's events) and one thread reads (whichever
+// steps the simulation); they can be the same one. The handoff is an SpscRing, so neither waits.
+#include <vector>
+#include "SpscRing.h"
+
+struct TimedInput
+{
+    double time;    // seconds, on the clock the simulation is advanced with
+    int    action;  // whatever the caller's actions are, e.g. ReplayAction bits
+};
+
+class InputTimeline
+{
+private:
+    SpscRing<TimedInput> m_ring;
+
+    // ————— PRODUCER ————— //
+    int m_pushed_action = 0;
+
+    // ————— CONSUMER ————— //
+    std::vector<TimedInput> m_pending;  // popped from the ring, not yet due
+    int                     m_action = 0;
+
+public:
+    InputTimeline() : m_ring(256) {};
+
+    // Producer: the action held from `time` on. Unchanged actions are dropped; times must not go
+    // backwards. False when the reader has fallen a whole ring behind, and the change is lost.
+    bool push(double time, int action);
+    int const get_pushed_action() const { return m_pushed_action; };
+
+    // Consumer: the action held at `time`, which must not go backwards from one call to the next
+    int get_action(double time);
+};
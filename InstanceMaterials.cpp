@@ -0,0 +1,57 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+#include <algorithm>
+#include <cmath>
+#include "glm/common.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "GLCallCounter.h"
+#include "InstanceMaterials.h"
+
+int InstanceMaterials::add_palette(glm::vec3 shadow, glm::vec3 highlight)
+{
+    if (m_palette_count == MAX_PALETTES) return -1;
+
+    m_ramps[m_palette_count * 2] = shadow;
+    m_ramps[m_palette_count * 2 + 1] = highlight;
+    return m_palette_count++;
+}
+
+int InstanceMaterials::add_material(int palette, glm::vec4 tint, bool vary_uvs)
+{
+    m_materials.push_back({ std::min(std::max(palette, 0), MAX_PALETTES - 1), tint, vary_uvs });
+    return (int)m_materials.size() - 1;
+}
+
+void InstanceMaterials::apply(int material, glm::vec2 position, SpriteInstance& instance) const
+{
+    const InstanceMaterial& entry = m_materials[material];
+    glm::vec4 tint = glm::clamp(entry.tint, 0.0f, 1.0f) * 255.0f + 0.5f;
+    for (int i = 0; i < 4; i++) instance.tint[i] = (uint8_t)tint[i];
+    instance.palette = (uint8_t)entry.palette;
+
+    // Hashed from the cell it sits in, so the same platform mirrors the same way every time it's dressed
+    instance.variation = 0;
+    if (entry.vary_uvs)
+    {
+        unsigned int hash = (unsigned int)(int)std::floor(position.x) * 73856093u ^ (unsigned int)(int)std::floor(position.y) * 19349663u;
+        hash ^= hash >> 13;
+        hash *= 0x5bd1e995u;
+        instance.variation = (uint8_t)((hash >> 15) & 3u);
+    }
+}
+
+void InstanceMaterials::upload(ShaderProgram* program) const
+{
+    program->use();
+    count_gl_call(GL_CALL_UNIFORM);
+    glUniform3fv(glGetUniformLocation(program->get_program_id(), "palette"), MAX_PALETTES * 2, glm::value_ptr(m_ramps[0]));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// Looks for instanced sprites that share one greyscale frame. A palette is a ramp from a shadow
+// colour to a highlight colour that the frame's grey levels are read along; a material picks a
+// palette and a tint, and whether each instance mirrors the frame its own way so neighbours don't
+// repeat. Everything a material decides goes into the instance itself (SpriteInstance's tint,
+// palette and variation), so one SHADER_MATERIAL batch draws every look, and another look costs a
+// table entry rather than another texture.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "InstancedRenderer.h"
+#include "ShaderProgram.h"
+
+struct InstanceMaterial
+{
+    int       palette;
+    glm::vec4 tint;
+    bool      vary_uvs;  // mirror the frame by where the instance is
+};
+
+class InstanceMaterials
+{
+public:
+    static const int MAX_PALETTES = 8;  // PALETTE_SIZE in sprite_vertex.glsl
+
+private:
+    glm::vec3 m_ramps[MAX_PALETTES * 2] = {};  // shadow, highlight
+    int       m_palette_count = 0;
+
+    std::vector<InstanceMaterial> m_materials;
+
+public:
+    // -1 once MAX_PALETTES are in
+    int add_palette(glm::vec3 shadow, glm::vec3 highlight);
+    int add_material(int palette, glm::vec4 tint = glm::vec4(1.0f), bool vary_uvs = true);
+
+    // Writes the material into the instance. Only reads the table, so any thread can dress
+    // instances once the materials are in.
+    void apply(int material, glm::vec2 position, SpriteInstance& instance) const;
+
+    // Every palette into `program`'s uniforms; uses the program
+    void upload(ShaderProgram* program) const;
+
+    int const get_palette_count()  const { return m_palette_count; };
+    int const get_material_count() const { return (int)m_materials.size(); };
+};
@@ -0,0 +1,234 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstddef>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "InstancedRenderer.h"
+
+void InstancedRenderer::initialise(ShaderProgram* program)
+{
+    m_supported = supports_instancing();
+    if (!m_supported) return;
+
+    m_use_vertex_array = supports_vertex_arrays();
+
+    // Same corner and UV layout as the unit quad Entity used to draw by hand
+    float quad[] =
+    {
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f, 0.0f, 0.0f
+    };
+
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenBuffers(1, &m_quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_offset_attribute  = glGetAttribLocation(program->get_program_id(), "instanceOffset");
+    m_scale_attribute   = glGetAttribLocation(program->get_program_id(), "instanceScale");
+    m_uv_rect_attribute = glGetAttribLocation(program->get_program_id(), "instanceUvRect");
+    m_tint_attribute     = glGetAttribLocation(program->get_program_id(), "instanceTint");
+    m_material_attribute = glGetAttribLocation(program->get_program_id(), "instanceMaterial");
+}
+
+void InstancedRenderer::cleanup()
+{
+    clear_groups();
+    if (m_quad_buffer != 0) glDeleteBuffers(1, &m_quad_buffer);
+    m_quad_buffer = 0;
+}
+
+void InstancedRenderer::bind_attributes(ShaderProgram* program, InstanceGroup& group)
+{
+    // ————— PER-VERTEX ————— //
+    const GLsizei vertex_stride = FLOATS_PER_VERTEX * sizeof(float);
+
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, vertex_stride, (void*)0);
+    glEnableVertexAttribArray(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, vertex_stride, (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+
+    // ————— PER-INSTANCE ————— //
+    point_instance_attributes(group);
+}
+
+void InstancedRenderer::point_instance_attributes(InstanceGroup& group)
+{
+    const GLsizei instance_stride = sizeof(SpriteInstance);
+
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(GL_ARRAY_BUFFER, group.instance_buffer);
+
+    // Without base-instance draws (GL 4.2), a range starts wherever the pointers do
+    size_t base = (size_t)group.first_drawn * instance_stride;
+
+    struct { GLint attribute; int components; GLenum type; bool normalised; size_t offset; } attributes[] =
+    {
+        { m_offset_attribute,   2, GL_FLOAT,         false, offsetof(SpriteInstance, offset) },
+        { m_scale_attribute,    2, GL_FLOAT,         false, offsetof(SpriteInstance, scale) },
+        { m_uv_rect_attribute,  4, GL_FLOAT,         false, offsetof(SpriteInstance, uv_rect) },
+        { m_tint_attribute,     4, GL_UNSIGNED_BYTE, true,  offsetof(SpriteInstance, tint) },
+        { m_material_attribute, 2, GL_UNSIGNED_BYTE, false, offsetof(SpriteInstance, palette) }
+    };
+
+    for (const auto& attribute : attributes)
+    {
+        // The compiler is free to drop attributes the shader doesn't use
+        if (attribute.attribute < 0) continue;
+
+        glVertexAttribPointer(attribute.attribute, attribute.components, attribute.type, attribute.normalised, instance_stride, (void*)(base + attribute.offset));
+        glEnableVertexAttribArray(attribute.attribute);
+        glVertexAttribDivisor(attribute.attribute, 1);
+    }
+    group.bound_first = group.first_drawn;
+}
+
+void InstancedRenderer::unbind_attributes(ShaderProgram* program)
+{
+    glDisableVertexAttribArray(program->get_position_attribute());
+    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+
+    // Divisors live in the default vertex array too, so put them back for the non-instanced paths
+    GLint attributes[] = { m_offset_attribute, m_scale_attribute, m_uv_rect_attribute, m_tint_attribute, m_material_attribute };
+    for (GLint attribute : attributes)
+    {
+        if (attribute < 0) continue;
+        glVertexAttribDivisor(attribute, 0);
+        glDisableVertexAttribArray(attribute);
+    }
+}
+
+int InstancedRenderer::add_group(ShaderProgram* program, GLuint texture_id, const std::vector<SpriteInstance>& instances, bool streaming)
+{
+    InstanceGroup group = { texture_id, 0, 0, 0, (GLenum)(streaming ? GL_STREAM_DRAW : GL_STATIC_DRAW), 0, 0, 0 };
+
+    glGenBuffers(1, &group.instance_buffer);
+    m_groups.push_back(group);
+
+    int group_index = (int)m_groups.size() - 1;
+    update_group(group_index, instances);
+
+    if (m_use_vertex_array)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glGenVertexArrays(1, &m_groups[group_index].vertex_array);
+        glBindVertexArray(m_groups[group_index].vertex_array);
+        bind_attributes(program, m_groups[group_index]);
+        count_gl_call(GL_CALL_BIND, 2);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    return group_index;
+}
+
+void InstancedRenderer::update_group(int group_index, const std::vector<SpriteInstance>& instances)
+{
+    update_group(group_index, instances.data(), (int)instances.size());
+}
+
+void InstancedRenderer::update_group(int group_index, const SpriteInstance* instances, int instance_count)
+{
+    InstanceGroup& group = m_groups[group_index];
+    group.instance_count = instance_count;
+    group.first_drawn = 0;
+    group.drawn_count = instance_count;
+
+    // Respecifying the whole store also orphans the old one, so a streaming group never waits
+    // on the draws still reading last frame's data
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindBuffer(GL_ARRAY_BUFFER, group.instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, instance_count * sizeof(SpriteInstance), instances, group.usage);
+    track_gpu_buffer(group.instance_buffer, (long long)(instance_count * sizeof(SpriteInstance)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+int InstancedRenderer::reserve_group(ShaderProgram* program, GLuint texture_id, int instance_count)
+{
+    int group_index = add_group(program, texture_id, std::vector<SpriteInstance>());
+    update_group(group_index, NULL, instance_count);
+    return group_index;
+}
+
+void InstancedRenderer::upload_group_range(int group_index, int first, const SpriteInstance* instances, int instance_count)
+{
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindBuffer(GL_ARRAY_BUFFER, m_groups[group_index].instance_buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(SpriteInstance), instance_count * sizeof(SpriteInstance), instances);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedRenderer::set_group_range(int group_index, int first, int count)
+{
+    InstanceGroup& group = m_groups[group_index];
+    group.first_drawn = std::min(std::max(first, 0), group.instance_count);
+    group.drawn_count = std::min(std::max(count, 0), group.instance_count - group.first_drawn);
+}
+
+void InstancedRenderer::clear_groups()
+{
+    for (InstanceGroup& group : m_groups)
+    {
+        untrack_gpu_buffers(1, &group.instance_buffer);
+        glDeleteBuffers(1, &group.instance_buffer);
+        if (group.vertex_array != 0) glDeleteVertexArrays(1, &group.vertex_array);
+    }
+    m_groups.clear();
+}
+
+void InstancedRenderer::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (!m_supported || m_groups.empty()) return;
+
+    program->use();
+
+    for (InstanceGroup& group : m_groups)
+    {
+        if (group.drawn_count == 0) continue;
+
+        count_gl_call(GL_CALL_BIND, m_use_vertex_array ? 1 : 0);
+        if (m_use_vertex_array)
+        {
+            // The vertex array remembers the last range's pointers, so they only move with it
+            glBindVertexArray(group.vertex_array);
+            if (group.bound_first != group.first_drawn) point_instance_attributes(group);
+        }
+        else bind_attributes(program, group);
+
+        count_gl_call(GL_CALL_BIND);
+        count_gl_call(GL_CALL_DRAW);
+        glBindTexture(GL_TEXTURE_2D, group.texture_id);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, VERTICES_PER_QUAD, group.drawn_count);
+        m_draw_calls++;
+
+        if (!m_use_vertex_array) unbind_attributes(program);
+    }
+
+    count_gl_call(GL_CALL_BIND, m_use_vertex_array ? 1 : 0);
+    if (m_use_vertex_array) glBindVertexArray(0);
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
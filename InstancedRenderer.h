@@ -0,0 +1,89 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+struct SpriteInstance
+{
+    glm::vec2 offset;
+    glm::vec2 scale;
+    glm::vec4 uv_rect; // atlas frame: u, v, width, height in the UV-plane
+
+    // Only SHADER_MATERIAL variants read these (see InstanceMaterials)
+    uint8_t   tint[4]    = { 255, 255, 255, 255 };
+    uint8_t   palette    = 0,
+              variation  = 0,  // bit 0 mirrors the frame across u, bit 1 across v
+              padding[2] = { 0, 0 };
+};
+static_assert(sizeof(SpriteInstance) == 40, "eight floats and two words of material a sprite");
+
+class InstancedRenderer
+{
+private:
+    struct InstanceGroup
+    {
+        GLuint texture_id;
+        GLuint instance_buffer;
+        GLuint vertex_array;
+        int    instance_count;
+        GLenum usage;  // GL_STATIC_DRAW, or GL_STREAM_DRAW for data rewritten every frame
+
+        // The slice draw() covers; the whole group unless set_group_range says otherwise
+        int    first_drawn, drawn_count,
+               bound_first;  // what the vertex array's instance attributes point at
+    };
+
+    static const int FLOATS_PER_VERTEX = 4,  // x, y, u, v
+                     VERTICES_PER_QUAD = 6;
+
+    // One unit quad shared by every group; only the per-instance data differs
+    GLuint m_quad_buffer = 0;
+
+    GLint m_offset_attribute   = -1,
+          m_scale_attribute    = -1,
+          m_uv_rect_attribute  = -1,
+          m_tint_attribute     = -1,  // SHADER_MATERIAL programs only
+          m_material_attribute = -1;
+
+    bool m_supported        = false,
+         m_use_vertex_array = false;
+
+    std::vector<InstanceGroup> m_groups;
+
+    int m_draw_calls = 0;
+
+    void bind_attributes(ShaderProgram* program, InstanceGroup& group);
+    void point_instance_attributes(InstanceGroup& group);
+    void unbind_attributes(ShaderProgram* program);
+
+public:
+    void initialise(ShaderProgram* program);
+    void cleanup();
+
+    // Instance data is uploaded once here and stays on the GPU until updated or cleared.
+    // Streaming groups expect a new upload most frames and hint the driver accordingly.
+    int  add_group(ShaderProgram* program, GLuint texture_id, const std::vector<SpriteInstance>& instances, bool streaming = false);
+    void update_group(int group_index, const std::vector<SpriteInstance>& instances);
+    void update_group(int group_index, const SpriteInstance* instances, int instance_count);
+    // A group with room for instance_count instances and nothing in it yet, for filling a slice at
+    // a time with upload_group_range, e.g. to spread a big upload over several frames
+    int  reserve_group(ShaderProgram* program, GLuint texture_id, int instance_count);
+    void upload_group_range(int group_index, int first, const SpriteInstance* instances, int instance_count);
+    void clear_groups();
+
+    // Draw only instances first..first + count - 1, e.g. the ones on screen out of a group sorted
+    // along x. Updating the group resets it to the whole group.
+    void set_group_range(int group_index, int first, int count);
+
+    void draw(ShaderProgram* program);
+
+    bool const is_supported()   const { return m_supported; };
+    int  const get_draw_calls() const { return m_draw_calls; };
+};
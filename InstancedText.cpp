@@ -0,0 +1,174 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cstddef>
+#include "EmbeddedShaders.h"
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "InstancedText.h"
+
+void InstancedText::initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font)
+{
+    m_supported = supports_glsl_330() && supports_instancing() && supports_vertex_arrays();
+    if (!m_supported) return;
+
+    m_font_texture_id = font_texture_id;
+    m_font = font;
+    m_font.place(font_uv_rect);
+
+    // STEP 1: The program, and where its per-glyph attributes ended up
+    m_program.load(EmbeddedShaders::GLYPH_VERTEX, EmbeddedShaders::GLYPH_FRAGMENT);
+    m_pen_attribute    = glGetAttribLocation(m_program.get_program_id(), "instancePen");
+    m_size_attribute   = glGetAttribLocation(m_program.get_program_id(), "instanceSize");
+    m_glyph_attribute  = glGetAttribLocation(m_program.get_program_id(), "instanceGlyph");
+    m_colour_attribute = glGetAttribLocation(m_program.get_program_id(), "instanceColour");
+
+    GLuint table_block = glGetUniformBlockIndex(m_program.get_program_id(), "GlyphTable");
+    if (table_block != GL_INVALID_INDEX) glUniformBlockBinding(m_program.get_program_id(), table_block, GLYPH_TABLE_BINDING);
+
+    // STEP 2: Every glyph's rect and box, in the block's std140 order: all the rects, then all the boxes
+    glm::vec4 table[2 * GLYPH_COUNT];
+    for (int glyph = 0; glyph < GLYPH_COUNT; glyph++)
+    {
+        const GlyphMetrics& metrics = m_font.get_glyph((unsigned char)glyph);
+        table[glyph] = metrics.uv_rect;
+        table[GLYPH_COUNT + glyph] = glm::vec4(metrics.bearing, metrics.size);
+    }
+
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenBuffers(1, &m_glyph_table);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_glyph_table);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(table), table, GL_STATIC_DRAW);
+    track_gpu_buffer(m_glyph_table, sizeof(table));
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // STEP 3: The unit quad every glyph shares, from its top-left corner down
+    const float quad[] =
+    {
+        0.0f, 0.0f,  0.0f, 1.0f,  1.0f, 0.0f,
+        1.0f, 1.0f,  1.0f, 0.0f,  0.0f, 1.0f
+    };
+
+    count_gl_call(GL_CALL_BIND, 3);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenVertexArrays(1, &m_vertex_array);
+    glBindVertexArray(m_vertex_array);
+    glGenBuffers(1, &m_quad_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_quad_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(quad), quad, GL_STATIC_DRAW);
+    glVertexAttribPointer(m_program.get_position_attribute(), 2, GL_FLOAT, false, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(m_program.get_position_attribute());
+
+    // STEP 4: The instance buffer's attributes, recorded once in the vertex array; the data is
+    //         respecified every frame, which leaves the pointers as they are
+    count_gl_call(GL_CALL_BIND, 2);
+    glGenBuffers(1, &m_instance_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+
+    struct { GLint attribute; int components; GLenum type; bool normalised; size_t offset; } attributes[] =
+    {
+        { m_pen_attribute,    2, GL_FLOAT,         false, offsetof(GlyphInstance, pen) },
+        { m_size_attribute,   1, GL_FLOAT,         false, offsetof(GlyphInstance, size) },
+        { m_glyph_attribute,  1, GL_UNSIGNED_BYTE, false, offsetof(GlyphInstance, glyph) },
+        { m_colour_attribute, 3, GL_UNSIGNED_BYTE, true,  offsetof(GlyphInstance, colour) }
+    };
+    for (const auto& attribute : attributes)
+    {
+        if (attribute.attribute < 0) continue;
+        glVertexAttribPointer(attribute.attribute, attribute.components, attribute.type, attribute.normalised, sizeof(GlyphInstance), (void*)attribute.offset);
+        glEnableVertexAttribArray(attribute.attribute);
+        glVertexAttribDivisor(attribute.attribute, 1);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedText::cleanup()
+{
+    if (m_vertex_array != 0)    glDeleteVertexArrays(1, &m_vertex_array);
+    if (m_quad_buffer != 0)     glDeleteBuffers(1, &m_quad_buffer);
+    if (m_instance_buffer != 0) glDeleteBuffers(1, &m_instance_buffer);
+    if (m_glyph_table != 0)     glDeleteBuffers(1, &m_glyph_table);
+    untrack_gpu_buffers(1, &m_instance_buffer);
+    untrack_gpu_buffers(1, &m_glyph_table);
+    m_vertex_array = m_quad_buffer = m_instance_buffer = m_glyph_table = 0;
+    m_buffer_capacity = 0;
+
+    m_instances.clear();
+    m_supported = false;
+}
+
+void InstancedText::begin()
+{
+    m_instances.clear();
+}
+
+void InstancedText::add(std::string_view text, float screen_size, float spacing, glm::vec2 position, glm::vec3 colour)
+{
+    uint8_t fill[3];
+    for (int i = 0; i < 3; i++) fill[i] = (uint8_t)(std::min(std::max(colour[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+
+    // Only the pens are worked out here; the boxes come out of the glyph table on the GPU
+    float pen_x = position.x - 0.5f * screen_size;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        unsigned char code = (unsigned char)text[i];
+        const GlyphMetrics& glyph = m_font.get_glyph(code);
+
+        if (glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+        {
+            m_instances.push_back({ glm::vec2(pen_x, position.y), screen_size, code, { fill[0], fill[1], fill[2] } });
+        }
+
+        float advance = glyph.advance;
+        if (i + 1 < text.size()) advance += m_font.get_kerning(code, (unsigned char)text[i + 1]);
+        pen_x += advance * screen_size + spacing;
+    }
+}
+
+void InstancedText::draw()
+{
+    m_draw_calls = 0;
+    if (!m_supported || m_instances.empty()) return;
+
+    m_program.use();
+
+    // STEP 1: The frame's glyphs in one go. Respecifying the store orphans last frame's, so the
+    //         upload never waits on its draw; a bigger frame grows it geometrically.
+    size_t bytes = m_instances.size() * sizeof(GlyphInstance);
+    m_buffer_capacity = std::max(m_buffer_capacity, std::max(m_instances.size(), m_buffer_capacity * 2));
+
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD, 2);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_buffer_capacity * sizeof(GlyphInstance), NULL, GL_STREAM_DRAW);
+    track_gpu_buffer(m_instance_buffer, (long long)(m_buffer_capacity * sizeof(GlyphInstance)));
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_uploaded_bytes += bytes;
+
+    // STEP 2: One draw, six corners an instance
+    count_gl_call(GL_CALL_BIND, 3);
+    count_gl_call(GL_CALL_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, GLYPH_TABLE_BINDING, m_glyph_table);
+    glBindTexture(GL_TEXTURE_2D, m_font_texture_id);
+    glBindVertexArray(m_vertex_array);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)m_instances.size());
+    m_draw_calls++;
+
+    count_gl_call(GL_CALL_BIND);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+// Text for the overlays that rewrite most of their lines every frame (the profiler HUD), drawn
+// instanced: each glyph is one 16-byte record of pen position, size, glyph index and colour, and
+// the vertex shader (shaders/glyph_vertex.glsl) expands the shared unit quad from the font's
+// metrics, which sit on the GPU in a uniform block written once. Against TextMeshCache's six
+// vertices of position and UV a glyph, that's a sixth of the bytes to build and upload, and the
+// whole overlay is one upload and one draw however many lines it has.
+//
+// Needs GLSL 3.30 and instancing (see is_supported); callers fall back to the render queue's text.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "FontMetrics.h"
+#include "ShaderProgram.h"
+
+struct GlyphInstance
+{
+    glm::vec2 pen;        // in the world; the glyph's box hangs off it by its bearing
+    float     size;       // screen_size
+    uint8_t   glyph;
+    uint8_t   colour[3];  // fill; the outline stays black
+};
+static_assert(sizeof(GlyphInstance) == 16, "four floats' worth a glyph");
+
+class InstancedText
+{
+public:
+    // Where the glyph table's uniform block is bound; the camera has ShaderProgram::CAMERA_BINDING
+    static const GLuint GLYPH_TABLE_BINDING = 1;
+
+private:
+    static const int GLYPH_COUNT = 256;
+
+    ShaderProgram m_program;
+    GLint m_pen_attribute    = -1,
+          m_size_attribute   = -1,
+          m_glyph_attribute  = -1,
+          m_colour_attribute = -1;
+
+    GLuint m_quad_buffer     = 0,
+           m_instance_buffer = 0,
+           m_glyph_table     = 0,
+           m_vertex_array    = 0;
+    GLuint m_font_texture_id = 0;
+
+    FontMetrics m_font;  // placed in the font's region, for the layout on the CPU
+
+    // Rebuilt by the frame's add() calls and uploaded whole at draw
+    std::vector<GlyphInstance> m_instances;
+    size_t m_buffer_capacity = 0;  // instances the buffer has room for
+
+    bool m_supported = false;
+    int  m_draw_calls = 0;
+    long long m_uploaded_bytes = 0;
+
+public:
+    // font_uv_rect and `font` as for TextMeshCache. Does nothing where unsupported.
+    void initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font);
+    void cleanup();
+
+    // Empties the overlay; call once a frame before adding its lines
+    void begin();
+
+    // Laid out like the render queue's text: `position` is where its first glyph's cell is centred
+    void add(std::string_view text, float screen_size, float spacing, glm::vec2 position, glm::vec3 colour = glm::vec3(1.0f));
+
+    // Everything added since begin(), in one instanced draw
+    void draw();
+
+    ShaderProgram* get_program() { return &m_program; };
+    bool      const is_supported()        const { return m_supported; };
+    int       const get_instance_count()  const { return (int)m_instances.size(); };
+    int       const get_draw_calls()      const { return m_draw_calls; };
+    long long const get_uploaded_bytes()  const { return m_uploaded_bytes; };  // since initialise
+};
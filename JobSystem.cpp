@@ -0,0 +1,194 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "JobSystem.h"
+#include "Trace.h"
+
+// ————— TASK GRAPH ————— //
+int TaskGraph::add(JobFunction function, void* user_data)
+{
+    if (m_task_count == (int)m_tasks.size()) m_tasks.emplace_back();
+
+    Task& task = m_tasks[m_task_count];
+    task.function = function;
+    task.user_data = user_data;
+    task.prerequisite_count = 0;
+    task.dependents.clear();
+    return m_task_count++;
+}
+
+void TaskGraph::add_dependency(int task, int prerequisite)
+{
+    m_tasks[prerequisite].dependents.push_back(task);
+    m_tasks[task].prerequisite_count++;
+}
+
+// ————— JOB SYSTEM ————— //
+JobSystem::JobSystem(int thread_count)
+{
+    if (thread_count <= 0) thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int i = 0; i < thread_count; i++) m_queues.emplace_back(new WorkQueue());
+    for (int i = 1; i < thread_count; i++) m_threads.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void JobSystem::run(TaskGraph& graph)
+{
+    const int task_count = graph.get_task_count();
+    if (task_count == 0) return;
+
+    // STEP 1: Room for every task in every queue and a countdown per task, grown only when a
+    //         graph outgrows the last one
+    if (task_count > m_waiting_capacity)
+    {
+        m_waiting_capacity = std::max(task_count, m_waiting_capacity * 2);
+        m_waiting.reset(new std::atomic<int>[m_waiting_capacity]);
+        for (std::unique_ptr<WorkQueue>& queue : m_queues) queue->tasks.resize(m_waiting_capacity);
+    }
+
+    m_graph = &graph;
+    m_pending.store(task_count, std::memory_order_relaxed);
+    for (int i = 0; i < task_count; i++) m_waiting[i].store(graph.m_tasks[i].prerequisite_count, std::memory_order_relaxed);
+
+    // STEP 2: Deal the tasks that are ready out round the queues, the caller's first
+    const int queue_count = (int)m_queues.size();
+    int next_queue = 0;
+    for (int i = 0; i < task_count; i++)
+    {
+        if (graph.m_tasks[i].prerequisite_count != 0) continue;
+        push_task(next_queue, i);
+        next_queue = (next_queue + 1) % queue_count;
+    }
+
+    // STEP 3: Wake the workers, join in, and wait until the last of them has let go of the graph
+    if (!m_threads.empty())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active_workers = (int)m_threads.size();
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    work(0);
+
+    if (!m_threads.empty())
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this]() { return m_active_workers == 0; });
+    }
+
+    m_graph = NULL;
+}
+
+void JobSystem::push_task(int worker, int task)
+{
+    WorkQueue& queue = *m_queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    // A task is only ever queued once per run, so the ring never holds more than the graph
+    queue.tasks[(queue.front + queue.count) % m_waiting_capacity] = task;
+    queue.count++;
+}
+
+bool JobSystem::next_task(int worker, int& task)
+{
+    // Own queue from the back...
+    {
+        WorkQueue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.count > 0)
+        {
+            own.count--;
+            task = own.tasks[(own.front + own.count) % m_waiting_capacity];
+            return true;
+        }
+    }
+
+    // ...then everyone else's from the front, starting with the next thread along
+    const int queue_count = (int)m_queues.size();
+    for (int offset = 1; offset < queue_count; offset++)
+    {
+        WorkQueue& victim = *m_queues[(worker + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count > 0)
+        {
+            task = victim.tasks[victim.front];
+            victim.front = (victim.front + 1) % m_waiting_capacity;
+            victim.count--;
+            m_steal_count++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::work(int worker)
+{
+    // Until the whole graph is done, not just until the queues look empty: a running task can
+    // still release dependents for us to pick up
+    while (m_pending.load(std::memory_order_acquire) > 0)
+    {
+        int index;
+        if (!next_task(worker, index))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const TaskGraph::Task& task = m_graph->m_tasks[index];
+        {
+            TRACE_ZONE("job");
+            task.function(task.user_data);
+        }
+
+        // The last prerequisite to finish queues the dependent on its own thread, where its
+        // inputs are still in cache
+        for (int dependent : task.dependents)
+        {
+            if (m_waiting[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) push_task(worker, dependent);
+        }
+        m_pending.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void JobSystem::worker_loop(int worker)
+{
+    int seen_generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stopping || m_generation != seen_generation; });
+            if (m_stopping) return;
+            seen_generation = m_generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active_workers == 0) m_finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// A fixed pool of worker threads for running a frame's independent pieces of work side by side.
+// The work is declared as a TaskGraph: plain function-and-argument tasks, each counting down the
+// prerequisites it waits on. JobSystem::run() starts every task with none, and a task that
+// finishes starts whichever dependents it was the last prerequisite of.
+//
+// Each thread, the caller's included, keeps its own queue of ready tasks: it works newest-first
+// from the back of its own, and once that runs dry it steals the oldest from the front of
+// another's, the way WorldPool shares out worlds. A JobSystem of one thread has no workers at
+// all and runs the whole graph on the caller, in dependency order.
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef void (*JobFunction)(void* user_data);
+
+class TaskGraph
+{
+private:
+    friend class JobSystem;
+
+    struct Task
+    {
+        JobFunction      function;
+        void*            user_data;
+        int              prerequisite_count;
+        std::vector<int> dependents;
+    };
+
+    // Kept from one frame's graph to the next, so a graph rebuilt every frame stops allocating
+    std::vector<Task> m_tasks;
+    int               m_task_count = 0;
+
+public:
+    // Returns the task's handle for add_dependency
+    int  add(JobFunction function, void* user_data = NULL);
+    // `task` doesn't start until `prerequisite` has finished. The graph must stay acyclic.
+    void add_dependency(int task, int prerequisite);
+    void clear() { m_task_count = 0; };
+
+    int const get_task_count() const { return m_task_count; };
+};
+
+class JobSystem
+{
+private:
+    // A ring of ready tasks: its thread takes from the back, thieves from the front
+    struct WorkQueue
+    {
+        std::mutex       mutex;
+        std::vector<int> tasks;
+        int              front = 0,
+                         count = 0;
+    };
+
+    std::vector<std::thread>                m_threads;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;  // [0] is the caller's
+
+    // ————— CURRENT GRAPH ————— //
+    TaskGraph*                          m_graph = NULL;
+    std::unique_ptr<std::atomic<int>[]> m_waiting;  // per task: prerequisites still running
+    int                                 m_waiting_capacity = 0;
+    std::atomic<int>                    m_pending{ 0 };  // tasks not yet finished
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake,
+                            m_finished;
+    int  m_generation     = 0,
+         m_active_workers = 0;
+    bool m_stopping       = false;
+
+    std::atomic<long long> m_steal_count{ 0 };
+
+    void worker_loop(int worker);
+    void work(int worker);
+    bool next_task(int worker, int& task);
+    void push_task(int worker, int task);
+
+public:
+    // Counting the caller: 1 (the default) runs every graph on the caller alone, and 0 means one
+    // per hardware thread
+    JobSystem(int thread_count = 1);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Runs every task in the graph, the caller joining in, and returns once they've all finished
+    void run(TaskGraph& graph);
+
+    int       const get_thread_count() const { return (int)m_queues.size(); };
+    long long const get_steal_count()  const { return m_steal_count.load(); };
+};
@@ -0,0 +1,192 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "ActionRecord.h"
+#include "LanderEnv.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+#include "WorldPool.h"
+
+struct LanderEnv
+{
+    World       world;
+    SceneConfig scene;
+    int         max_steps,
+                step_count = 0;
+    bool        use_broadphase;
+
+    // Centres of the WIN platforms sorted by x, so the nearest one is a binary search away
+    std::vector<glm::vec2> win_platforms;
+
+    LanderEnv(const SceneConfig& config, int max_steps) : world(config.platform_count), scene(config), max_steps(max_steps)
+    {
+        // Matches the headless driver: the classic level is small enough for a plain scan
+        use_broadphase = scene.layout != SCENE_CLASSIC || scene.platform_count > PLATFORM_COUNT;
+        win_platforms.reserve(scene.platform_count);
+        setup_player(&world.player);
+    }
+};
+
+static glm::vec2 nearest_win_platform(const LanderEnv* env, float x)
+{
+    const std::vector<glm::vec2>& wins = env->win_platforms;
+
+    auto after = std::lower_bound(wins.begin(), wins.end(), x, [](const glm::vec2& platform, float value) { return platform.x < value; });
+    if (after == wins.begin()) return *after;
+    if (after == wins.end())   return *(after - 1);
+
+    return (x - (after - 1)->x <= after->x - x) ? *(after - 1) : *after;
+}
+
+// ————— API ————— //
+LanderEnv* lander_env_create(int platform_count, int layout, int max_steps)
+{
+    if (platform_count < 0 || layout < 0 || layout >= SCENE_LAYOUT_COUNT) return NULL;
+
+    SceneConfig config;
+    config.layout = (SceneLayout)layout;
+    if (platform_count > 0) config.platform_count = platform_count;
+
+    LanderEnv* env = new LanderEnv(config, std::max(max_steps, 0));
+    lander_env_reset(env, 0, NULL);
+    return env;
+}
+
+void lander_env_destroy(LanderEnv* env)
+{
+    delete env;
+}
+
+void lander_env_reset(LanderEnv* env, unsigned int seed, float* observation)
+{
+    GameState& state = env->world.state;
+
+    // STEP 1: A fresh scene, with the boxes and broadphase rebuilt over it
+    generate_scene(state.platforms, env->scene, seed);
+    state.platform_colliders->build(state.platforms, state.platform_count);
+
+    if (env->use_broadphase)
+    {
+        env->world.broadphase.build(state.platforms, state.platform_count);
+        state.platform_broadphase = &env->world.broadphase;
+    }
+
+    // STEP 2: Index the targets; the capacity was reserved up front, so this never allocates
+    env->win_platforms.clear();
+    for (int i = 0; i < state.platform_count; i++)
+    {
+        if (state.platforms[i].get_entity_type() == WIN_PLATFORM) env->win_platforms.push_back(glm::vec2(state.platforms[i].get_position()));
+    }
+    std::sort(env->win_platforms.begin(), env->win_platforms.end(), [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+
+    // STEP 3: Back to the spawn point
+    reset_episode(state);
+    env->step_count = 0;
+
+    lander_env_observe(env, observation);
+}
+
+void lander_env_step(LanderEnv* env, int action, float* observation, float* reward, int* done)
+{
+    lander_env_step_repeat(env, action, 1, LANDER_POOL_LAST, observation, reward, done);
+}
+
+void lander_env_step_repeat(LanderEnv* env, int action, int repeat, int pooling, float* observation, float* reward, int* done)
+{
+    GameState& state = env->world.state;
+    float total_reward = 0.0f;
+
+    // ————— INPUT ————— //
+    // Held for every sub-step, so it only needs working out once
+    Entity* player = state.player;
+    float movement_x = get_action_steer(action),
+          throttle   = (action & LANDER_ACTION_BOOST) ? get_action_throttle(action) : 1.0f;
+
+    // ————— SUB-STEPS ————— //
+    bool pool = observation != NULL && pooling != LANDER_POOL_LAST;
+    float pooled[LANDER_OBSERVATION_SIZE],
+          current[LANDER_OBSERVATION_SIZE];
+    int sub_steps = 0;
+
+    for (int i = 0; i < std::max(repeat, 1); i++)
+    {
+        if (state.win || state.loss || (env->max_steps > 0 && env->step_count >= env->max_steps)) break;
+
+        player->set_movement(glm::vec3(movement_x, 0.0f, 0.0f));
+        player->m_booster_active = (action & LANDER_ACTION_BOOST) != 0;
+        player->m_throttle = throttle;
+
+        step_simulation(state, state.fixed_timestep);
+        env->step_count++;
+        sub_steps++;
+
+        if      (state.win)  total_reward += LANDER_REWARD_WIN;
+        else if (state.loss) total_reward += LANDER_REWARD_LOSS;
+
+        if (!pool) continue;
+
+        lander_env_observe(env, current);
+        for (int j = 0; j < LANDER_OBSERVATION_SIZE; j++)
+        {
+            if      (sub_steps == 1)             pooled[j] = current[j];
+            else if (pooling == LANDER_POOL_MAX) pooled[j] = std::max(pooled[j], current[j]);
+            else                                 pooled[j] += current[j];
+        }
+    }
+
+    if (reward != NULL) *reward = total_reward;
+    if (done != NULL)
+    {
+        if      (state.win || state.loss)                                 *done = LANDER_DONE_TERMINAL;
+        else if (env->max_steps > 0 && env->step_count >= env->max_steps) *done = LANDER_DONE_TRUNCATED;
+        else                                                              *done = LANDER_DONE_NONE;
+    }
+
+    // A finished episode steps nothing, so there's nothing to pool either: report it as it stands
+    if (!pool || sub_steps == 0)
+    {
+        lander_env_observe(env, observation);
+        return;
+    }
+
+    for (int j = 0; j < LANDER_OBSERVATION_SIZE; j++) observation[j] = pooling == LANDER_POOL_MEAN ? pooled[j] / sub_steps : pooled[j];
+}
+
+void lander_env_observe(const LanderEnv* env, float* observation)
+{
+    if (observation == NULL) return;
+
+    const Entity& player = env->world.player;
+    glm::vec3 position = player.get_position(),
+              velocity = player.get_velocity();
+
+    glm::vec2 win_offset = glm::vec2(0.0f);
+    if (!env->win_platforms.empty()) win_offset = nearest_win_platform(env, position.x) - glm::vec2(position);
+
+    observation[LANDER_OBS_POSITION_X]     = position.x;
+    observation[LANDER_OBS_POSITION_Y]     = position.y;
+    observation[LANDER_OBS_VELOCITY_X]     = velocity.x;
+    observation[LANDER_OBS_VELOCITY_Y]     = velocity.y;
+    observation[LANDER_OBS_WIN_OFFSET_X]   = win_offset.x;
+    observation[LANDER_OBS_WIN_OFFSET_Y]   = win_offset.y;
+    observation[LANDER_OBS_CONTACT_TOP]    = player.m_collided_top    ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_BOTTOM] = player.m_collided_bottom ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_LEFT]   = player.m_collided_left   ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_RIGHT]  = player.m_collided_right  ? 1.0f : 0.0f;
+}
+
+int lander_env_get_step_count(const LanderEnv* env)
+{
+    return env->step_count;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+// Step/reset interface to the headless lander for learning controllers, callable from C (or
+// through ctypes / cffi). Observations are written into buffers the caller owns, and nothing
+// is allocated after lander_env_create, so a training loop can step millions of times without
+// the env showing up in its profile.
+//
+//     LanderEnv* env = lander_env_create(0, LANDER_LAYOUT_CLASSIC, 3600);
+//     float observation[LANDER_OBSERVATION_SIZE], reward;
+//     int   done = LANDER_DONE_NONE;
+//
+//     lander_env_reset(env, seed, observation);
+//     while (done == LANDER_DONE_NONE) lander_env_step(env, policy(observation), observation, &reward, &done);
+//     lander_env_destroy(env);
+//
+// One env is one world; it must only be used from one thread at a time, but separate envs can
+// run on separate threads.
+#if defined(_WIN32) && defined(LANDER_ENV_EXPORTS)
+#define LANDER_ENV_API __declspec(dllexport)
+#elif defined(_WIN32) && !defined(LANDER_ENV_STATIC)
+#define LANDER_ENV_API __declspec(dllimport)
+#else
+#define LANDER_ENV_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct LanderEnv LanderEnv;
+
+// Same order as SceneLayout
+enum LanderLayout
+{
+    LANDER_LAYOUT_CLASSIC,
+    LANDER_LAYOUT_UNIFORM,
+    LANDER_LAYOUT_CLUSTERED,
+    LANDER_LAYOUT_TERRAIN
+};
+
+// Bits of the action passed to lander_env_step; left and right together cancel out. With
+// LANDER_ACTION_ANALOG set, the action also carries how far: a signed byte of steer from -127
+// (full left) to 127 at LANDER_ACTION_STEER_SHIFT, and a byte of throttle from 0 to 255 at
+// LANDER_ACTION_THROTTLE_SHIFT, with LEFT, RIGHT and BOOST set by their signs (the game's own
+// action records, ActionRecord.h, which its replays hold).
+enum LanderAction
+{
+    LANDER_ACTION_NONE   = 0,
+    LANDER_ACTION_LEFT   = 1,
+    LANDER_ACTION_RIGHT  = 2,
+    LANDER_ACTION_BOOST  = 4,
+    LANDER_ACTION_ANALOG = 8,
+
+    LANDER_ACTION_STEER_SHIFT    = 8,
+    LANDER_ACTION_THROTTLE_SHIFT = 16
+};
+
+// Indices into an observation buffer. The WIN offsets are from the lander's centre to the centre
+// of the WIN platform nearest along x, and zero when the scene has none; contacts are 0 or 1.
+enum LanderObservation
+{
+    LANDER_OBS_POSITION_X,
+    LANDER_OBS_POSITION_Y,
+    LANDER_OBS_VELOCITY_X,
+    LANDER_OBS_VELOCITY_Y,
+    LANDER_OBS_WIN_OFFSET_X,
+    LANDER_OBS_WIN_OFFSET_Y,
+    LANDER_OBS_CONTACT_TOP,
+    LANDER_OBS_CONTACT_BOTTOM,
+    LANDER_OBS_CONTACT_LEFT,
+    LANDER_OBS_CONTACT_RIGHT,
+    LANDER_OBSERVATION_SIZE
+};
+
+enum LanderDone
+{
+    LANDER_DONE_NONE,       // still flying
+    LANDER_DONE_TERMINAL,   // landed or crashed
+    LANDER_DONE_TRUNCATED   // ran out of max_steps
+};
+
+// How lander_env_step_repeat folds the observations of its sub-steps into the one it returns
+enum LanderPooling
+{
+    LANDER_POOL_LAST,  // just the final sub-step's
+    LANDER_POOL_MAX,   // element-wise max over every sub-step's
+    LANDER_POOL_MEAN   // element-wise mean over every sub-step's
+};
+
+// Rewards are sparse: LANDER_REWARD_WIN on landing, LANDER_REWARD_LOSS on crashing and zero on
+// every other step, so any shaping is left to the controller
+#define LANDER_REWARD_WIN   1.0f
+#define LANDER_REWARD_LOSS -1.0f
+
+// platform_count 0 means the classic nine; max_steps 0 means episodes never truncate. Returns
+// NULL for an unknown layout or a negative count.
+LANDER_ENV_API LanderEnv* lander_env_create(int platform_count, int layout, int max_steps);
+LANDER_ENV_API void       lander_env_destroy(LanderEnv* env);
+
+// Builds the scene for `seed` and puts the lander back at the spawn point. observation may be
+// NULL. The same seed always gives the same scene and, for the same actions, the same episode.
+LANDER_ENV_API void lander_env_reset(LanderEnv* env, unsigned int seed, float* observation);
+
+// One fixed step of the simulation under `action`. Any of the outputs may be NULL. Stepping a
+// finished episode does nothing but report it as done again, with zero reward.
+LANDER_ENV_API void lander_env_step(LanderEnv* env, int action, float* observation, float* reward, int* done);
+
+// Action repeat: `repeat` fixed steps under the same action in one call, stopping early if the
+// episode ends, with the rewards summed and the observations pooled. LANDER_POOL_LAST only
+// observes once, after the last sub-step. repeat below 1 counts as 1.
+LANDER_ENV_API void lander_env_step_repeat(LanderEnv* env, int action, int repeat, int pooling, float* observation, float* reward, int* done);
+
+// Writes the current observation without stepping
+LANDER_ENV_API void lander_env_observe(const LanderEnv* env, float* observation);
+
+LANDER_ENV_API int lander_env_get_step_count(const LanderEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,217 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "LandingSiteMap.h"
+
+void LandingSiteMap::clear()
+{
+    m_sites.clear();
+    m_xs.clear();
+    m_tree.clear();
+    m_site_of.clear();
+    m_leaf_count = 0;
+}
+
+int LandingSiteMap::better(int a, int b) const
+{
+    if (a < 0) return b;
+    if (b < 0) return a;
+    return m_sites[b].score > m_sites[a].score ? b : a;
+}
+
+LandingSite LandingSiteMap::score_site(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, int i)
+{
+    const Entity& pad = platforms[i];
+    glm::vec2 centre = glm::vec2(pad.get_position()),
+              extent = glm::vec2(pad.get_width(), pad.get_height()) * 0.5f;
+    float top = centre.y + extent.y;
+
+    // STEP 1: Everything that could cut the clearance or be a hazard, in one box around the pad
+    glm::vec2 min = glm::vec2(centre.x - extent.x - MAX_HAZARD_DISTANCE, centre.y - extent.y - MAX_HAZARD_DISTANCE),
+              max = glm::vec2(centre.x + extent.x + MAX_HAZARD_DISTANCE, top + MAX_CLEARANCE);
+    int count = platform_count;
+    if (broadphase != NULL)
+    {
+        int cursor = -1;
+        broadphase->query(min, max, m_candidates, cursor);
+        count = (int)m_candidates.size();
+    }
+
+    LandingSite site = { glm::vec2(centre.x, top), extent.x, MAX_CLEARANCE, MAX_HAZARD_DISTANCE, 0.0f, i };
+    for (int n = 0; n < count; n++)
+    {
+        int index = broadphase != NULL ? m_candidates[n] : n;
+        const Entity& other = platforms[index];
+        if (index == i || !other.is_active()) continue;
+
+        glm::vec2 other_centre = glm::vec2(other.get_position()),
+                  other_extent = glm::vec2(other.get_width(), other.get_height()) * 0.5f;
+
+        // STEP 2: Anything over the pad's span is a ceiling, however harmless...
+        float gap_x = std::fabs(other_centre.x - centre.x) - other_extent.x - extent.x,
+              bottom = other_centre.y - other_extent.y;
+        if (gap_x < 0.0f && bottom >= top) site.clearance = std::min(site.clearance, bottom - top);
+
+        // STEP 3: ...and a DEATH platform anywhere near is a hazard, by the gap between the boxes
+        if (other.get_entity_type() == DEATH_PLATFORM)
+        {
+            float gap_y = std::fabs(other_centre.y - centre.y) - other_extent.y - extent.y;
+            float gap   = std::sqrt(std::max(gap_x, 0.0f) * std::max(gap_x, 0.0f) + std::max(gap_y, 0.0f) * std::max(gap_y, 0.0f));
+            site.hazard_distance = std::min(site.hazard_distance, gap);
+        }
+    }
+
+    // STEP 4: Each measure as a fraction of its best, multiplied. A hazard right alongside only
+    //         halves the score, since most pads in a row of platforms have one.
+    if (site.clearance >= MIN_CLEARANCE)
+    {
+        site.score = (site.clearance / MAX_CLEARANCE) * (0.5f + 0.5f * site.hazard_distance / MAX_HAZARD_DISTANCE)
+                   * std::min(2.0f * site.half_width / GOOD_WIDTH, 1.0f);
+    }
+    return site;
+}
+
+void LandingSiteMap::build(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase)
+{
+    clear();
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        const Entity& pad = platforms[i];
+        if (!pad.is_active() || pad.get_entity_type() != WIN_PLATFORM) continue;
+        m_sites.push_back(score_site(platforms, platform_count, broadphase, i));
+    }
+
+    // STEP 5: Sorted along x, then the tree built bottom up over them
+    std::sort(m_sites.begin(), m_sites.end(), [](const LandingSite& a, const LandingSite& b) { return a.pad.x < b.pad.x; });
+    m_site_of.assign(platform_count, -1);
+    for (int i = 0; i < (int)m_sites.size(); i++)
+    {
+        m_xs.push_back(m_sites[i].pad.x);
+        m_site_of[m_sites[i].platform] = i;
+    }
+
+    m_leaf_count = 1;
+    while (m_leaf_count < (int)m_sites.size()) m_leaf_count *= 2;
+    m_tree.assign(2 * m_leaf_count, -1);
+    for (int i = 0; i < (int)m_sites.size(); i++) m_tree[m_leaf_count + i] = i;
+    for (int node = m_leaf_count - 1; node > 0; node--) m_tree[node] = better(m_tree[2 * node], m_tree[2 * node + 1]);
+}
+
+void LandingSiteMap::refit(int site)
+{
+    for (int node = (m_leaf_count + site) / 2; node > 0; node /= 2) m_tree[node] = better(m_tree[2 * node], m_tree[2 * node + 1]);
+}
+
+void LandingSiteMap::update_platform(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase,
+                                     int platform, glm::vec2 old_min, glm::vec2 old_max)
+{
+    if ((int)m_site_of.size() != platform_count) return;
+
+    // STEP 1: A pad of its own slides along x to its new place, and the sites it passed each
+    //         shift over by one, so the sorted order and the leaves stay as build left them
+    int site = m_site_of[platform];
+    if (site >= 0)
+    {
+        float x = platforms[platform].get_position().x;
+        bool rightward = x > m_xs[site];
+        int first = site, last = site;
+        if (rightward)
+        {
+            last = (int)(std::lower_bound(m_xs.begin() + site + 1, m_xs.end(), x) - m_xs.begin()) - 1;
+            std::rotate(m_sites.begin() + site, m_sites.begin() + site + 1, m_sites.begin() + last + 1);
+            std::rotate(m_xs.begin() + site, m_xs.begin() + site + 1, m_xs.begin() + last + 1);
+        }
+        else if (x < m_xs[site])
+        {
+            first = (int)(std::lower_bound(m_xs.begin(), m_xs.begin() + site, x) - m_xs.begin());
+            std::rotate(m_sites.begin() + first, m_sites.begin() + site, m_sites.begin() + site + 1);
+            std::rotate(m_xs.begin() + first, m_xs.begin() + site, m_xs.begin() + site + 1);
+        }
+        site = rightward ? last : first;
+
+        m_sites[site] = score_site(platforms, platform_count, broadphase, platform);
+        m_xs[site] = m_sites[site].pad.x;
+        for (int i = first; i <= last; i++)
+        {
+            m_site_of[m_sites[i].platform] = i;
+            refit(i);
+        }
+    }
+
+    // STEP 2: Every other pad whose box around it (see score_site) reaches where the platform was
+    //         or is now
+    const Entity& moved = platforms[platform];
+    glm::vec2 centre = glm::vec2(moved.get_position()),
+              extent = glm::vec2(moved.get_width(), moved.get_height()) * 0.5f;
+    const glm::vec2 boxes[2][2] = { { old_min, old_max }, { centre - extent, centre + extent } };
+
+    for (const glm::vec2* box : boxes)
+    {
+        glm::vec2 min = glm::vec2(box[0].x - MAX_HAZARD_DISTANCE, box[0].y - MAX_CLEARANCE),
+                  max = glm::vec2(box[1].x + MAX_HAZARD_DISTANCE, box[1].y + MAX_HAZARD_DISTANCE);
+        m_nearby.clear();
+        if (broadphase != NULL)
+        {
+            int cursor = -1;
+            broadphase->query(min, max, m_nearby, cursor);
+        }
+        else
+        {
+            for (int i = 0; i < platform_count; i++)
+            {
+                glm::vec2 other_centre = glm::vec2(platforms[i].get_position()),
+                          other_extent = glm::vec2(platforms[i].get_width(), platforms[i].get_height()) * 0.5f;
+                if (other_centre.x + other_extent.x < min.x || other_centre.x - other_extent.x > max.x ||
+                    other_centre.y + other_extent.y < min.y || other_centre.y - other_extent.y > max.y) continue;
+                m_nearby.push_back(i);
+            }
+        }
+
+        for (int index : m_nearby)
+        {
+            int nearby_site = m_site_of[index];
+            if (index == platform || nearby_site < 0) continue;
+
+            m_sites[nearby_site] = score_site(platforms, platform_count, broadphase, index);
+            refit(nearby_site);
+        }
+    }
+}
+
+int LandingSiteMap::find_best(float x, float range) const
+{
+    // STEP 1: The sites in range, as a run of leaves...
+    int first = (int)(std::lower_bound(m_xs.begin(), m_xs.end(), x - range) - m_xs.begin()),
+        last  = (int)(std::upper_bound(m_xs.begin(), m_xs.end(), x + range) - m_xs.begin());
+    if (first >= last) return -1;
+
+    // STEP 2: ...and the best of them, from the fewest nodes that cover the run. The left side
+    //         is kept apart from the right so the leftmost still wins a tie.
+    int left = -1, right = -1;
+    for (int low = first + m_leaf_count, high = last + m_leaf_count; low < high; low /= 2, high /= 2)
+    {
+        if (low & 1)  left  = better(left, m_tree[low++]);
+        if (high & 1) right = better(m_tree[--high], right);
+    }
+    return better(left, right);
+}
+
+int LandingSiteMap::find_nearest(float x) const
+{
+    if (m_sites.empty()) return -1;
+
+    int after = (int)(std::lower_bound(m_xs.begin(), m_xs.end(), x) - m_xs.begin());
+    if (after == 0)                  return 0;
+    if (after == (int)m_xs.size())   return after - 1;
+    return x - m_xs[after - 1] <= m_xs[after] - x ? after - 1 : after;
+}
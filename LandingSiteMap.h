@@ -0,0 +1,75 @@
+#pragma once
+
+// Every WIN platform scored once, when the level is built, for how good a place to land it is,
+// so bots and hints ask a table instead of rescanning the platforms each decision:
+//
+//   clearance        open air straight above the pad, up to MAX_CLEARANCE; under a lander's
+//                    height it can't be landed on at all
+//   hazard distance  the gap between the pad and the nearest DEATH platform, up to
+//                    MAX_HAZARD_DISTANCE; a pad wedged between hazards punishes any drift, so
+//                    one right alongside halves the score
+//   width            wider pads take a sloppier approach
+//
+// The sites are kept sorted along x with a max-score segment tree over them, so the best pad
+// within some distance of any x is two binary searches and an O(log n) walk up the tree. Scores
+// are for the platforms where they were at build time; a level whose platforms are added or
+// removed (LevelStreamer swapping chunks) has to build again, as its broadphase does. One moved in
+// place (by the level editor) goes through update_platform(), which rescores only the pads it
+// left or came near.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+#include "PlatformBroadphase.h"
+
+struct LandingSite
+{
+    glm::vec2 pad;              // top centre
+    float     half_width;
+    float     clearance,
+              hazard_distance;
+    float     score;            // 0 for unlandable to 1 for as good as pads get
+    int       platform;         // index into the platforms it was built from
+};
+
+class LandingSiteMap
+{
+private:
+    std::vector<LandingSite> m_sites;  // by pad.x
+    std::vector<float>       m_xs;     // m_sites' pad.x, for the searches
+    std::vector<int>         m_tree;   // the best site under each node; leaves from m_leaf_count
+    int                      m_leaf_count = 0;
+    std::vector<int>         m_site_of;     // platform index -> its site, -1 for none
+    std::vector<int>         m_candidates;  // broadphase scratch, for scoring
+    std::vector<int>         m_nearby;      // likewise, for update_platform
+
+    int better(int a, int b) const;  // by score, then the lower index
+    LandingSite score_site(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, int index);
+    // The tree from the site's leaf up
+    void refit(int site);
+
+public:
+    static constexpr float MAX_CLEARANCE        = 6.0f,
+                           MAX_HAZARD_DISTANCE  = 3.0f,
+                           MIN_CLEARANCE        = 1.0f,  // a lander's height
+                           GOOD_WIDTH           = 2.0f;  // twice a lander's width
+
+    // `broadphase`, when given, must be over the same platforms; without one every pad checks
+    // every platform
+    void build(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase = NULL);
+    void clear();
+
+    // After the platform moved from [old_min, old_max] to where it is now, in the same broadphase
+    void update_platform(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase,
+                         int platform, glm::vec2 old_min, glm::vec2 old_max);
+
+    // The highest-scoring site whose pad is within `range` of x along x, the leftmost on a tie;
+    // -1 if there is none in range
+    int find_best(float x, float range) const;
+
+    // The site whose pad is nearest x along x; -1 for a level without any
+    int find_nearest(float x) const;
+
+    const LandingSite& get_site(int site)  const { return m_sites[site]; };
+    int          const get_site_count()    const { return (int)m_sites.size(); };
+    bool         const is_empty()          const { return m_sites.empty(); };
+};
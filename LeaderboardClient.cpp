@@ -0,0 +1,245 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include "LeaderboardClient.h"
+#include "NetSocket.h"
+#include "Trace.h"
+
+static const char     SPOOL_MAGIC[4] = { 'L', 'L', 'B', 'S' };
+static const uint32_t SPOOL_VERSION  = 1;
+
+typedef std::chrono::steady_clock Clock;
+
+bool LeaderboardClient::parse_url(const char* url, std::string& host, std::string& host_port, std::string& path)
+{
+    static const char SCHEME[] = "http://";
+    if (std::strncmp(url, SCHEME, sizeof(SCHEME) - 1) != 0) return false;
+
+    std::string rest(url + sizeof(SCHEME) - 1);
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    path = slash == std::string::npos ? "/" : rest.substr(slash);
+
+    size_t colon = authority.rfind(':');
+    host = authority.substr(0, colon);
+    host_port = colon == std::string::npos ? authority + ":80" : authority;
+    return !host.empty();
+}
+
+bool LeaderboardClient::start(const char* url, const char* spool_filepath)
+{
+    stop();
+    if (!parse_url(url, m_host, m_host_port, m_path)) return false;
+
+    m_spool_filepath = spool_filepath;
+    m_stopping = false;
+    m_queued.reserve(MAX_BATCH);
+
+    // Ids only need to differ between cabinets and runs, not be unguessable
+    std::random_device device;
+    uint64_t seed = ((uint64_t)device() << 32) ^ device() ^ (uint64_t)Clock::now().time_since_epoch().count();
+    m_ids    = Rng(seed, 0);
+    m_jitter = Rng(seed, 1);
+
+    m_worker = std::thread(&LeaderboardClient::worker_loop, this);
+    return true;
+}
+
+void LeaderboardClient::stop()
+{
+    if (!m_worker.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_worker.join();
+}
+
+void LeaderboardClient::submit(const LeaderboardEntry& entry)
+{
+    LeaderboardEntry queued = entry;
+    queued.submitted_at = (int64_t)std::time(NULL);
+    queued.player[sizeof(queued.player) - 1] = '\0';
+    for (char* c = queued.player; *c != '\0'; c++)
+    {
+        bool allowed = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '-' || *c == '_';
+        if (!allowed) *c = '_';
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_worker.joinable()) return;
+        queued.id = m_ids.next_u64();
+        m_queued.push_back(queued);
+    }
+    m_wake.notify_one();
+}
+
+// ————— WORKER ————— //
+void LeaderboardClient::worker_loop()
+{
+    load_spool();
+
+    double backoff = 0.0;
+    Clock::time_point next_attempt = Clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        // STEP 1: Asleep until there's something new, or the spool's next attempt is due
+        if (m_pending.empty()) m_wake.wait(lock, [this] { return m_stopping || !m_queued.empty(); });
+        else m_wake.wait_until(lock, next_attempt, [this] { return m_stopping || !m_queued.empty(); });
+        if (m_stopping) break;
+
+        // STEP 2: A new submission waits a moment for others to share its request
+        if (!m_queued.empty())
+        {
+            m_wake.wait_for(lock, std::chrono::duration<double>(COALESCE_SECONDS), [this] { return m_stopping || (int)m_queued.size() >= MAX_BATCH; });
+            m_pending.insert(m_pending.end(), m_queued.begin(), m_queued.end());
+            m_queued.clear();
+            if (m_stopping) break;
+
+            // On disk before the network gets a chance to lose it
+            lock.unlock();
+            write_spool();
+            lock.lock();
+        }
+        if (Clock::now() < next_attempt) continue;
+
+        // STEP 3: The oldest batch up, without the lock, so submit() never waits on it
+        lock.unlock();
+        int count  = std::min((int)m_pending.size(), MAX_BATCH),
+            status = post(m_pending.data(), count);
+
+        // Accepted, or turned down for good (bad request and the like): either way it's done with.
+        // Anything else, a timeout or a server error or a 429, is tried again later.
+        bool rejected = status >= 400 && status < 500 && status != 408 && status != 429;
+        if ((status >= 200 && status < 300) || rejected)
+        {
+            (rejected ? m_rejected_count : m_uploaded_count).fetch_add(count, std::memory_order_relaxed);
+            m_pending.erase(m_pending.begin(), m_pending.begin() + count);
+            write_spool();
+            backoff = 0.0;
+            next_attempt = Clock::now();
+        }
+        else
+        {
+            m_failed_attempts.fetch_add(1, std::memory_order_relaxed);
+            backoff = std::min(backoff > 0.0 ? backoff * 2.0 : FIRST_BACKOFF_SECONDS, MAX_BACKOFF_SECONDS);
+            double wait = backoff * (0.75 + 0.5 * m_jitter.next_float());
+            next_attempt = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait));
+        }
+        lock.lock();
+    }
+
+    // Whatever never made it waits in the spool for the next run
+    m_pending.insert(m_pending.end(), m_queued.begin(), m_queued.end());
+    m_queued.clear();
+    lock.unlock();
+    write_spool();
+}
+
+int LeaderboardClient::post(const LeaderboardEntry* entries, int count)
+{
+    TRACE_ZONE("LeaderboardClient::post");
+
+    // STEP 1: The batch as JSON; names are already down to characters that need no escaping
+    std::string body = "{\"entries\":[";
+    char line[256];
+    for (int i = 0; i < count; i++)
+    {
+        const LeaderboardEntry& entry = entries[i];
+        std::snprintf(line, sizeof(line), "%s{\"id\":\"%016llx\",\"player\":\"%s\",\"seed\":%u,\"layout\":%d,\"platforms\":%d,\"score\":%d,\"landing_seconds\":%.4f,\"submitted_at\":%lld}",
+                      i > 0 ? "," : "", (unsigned long long)entry.id, entry.player, entry.seed, entry.layout, entry.platform_count, entry.score,
+                      entry.landing_seconds, (long long)entry.submitted_at);
+        body += line;
+    }
+    body += "]}";
+
+    std::string request = "POST " + m_path + " HTTP/1.1\r\nHost: " + m_host + "\r\nContent-Type: application/json\r\nContent-Length: "
+                        + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+
+    // STEP 2: Resolved every attempt, since the service may well have moved while it was down
+    NetAddress address;
+    TcpStream stream;
+    if (!resolve_address(m_host_port.c_str(), address) || !stream.connect(address, TIMEOUT_MS) || !stream.send_all(request.data(), request.size())) return 0;
+
+    // STEP 3: Only the status line matters
+    char response[128];
+    int received = 0, size;
+    while (received < (int)sizeof(response) - 1 && (size = stream.receive(response + received, sizeof(response) - 1 - received)) > 0)
+    {
+        received += size;
+        if (std::memchr(response, '\n', received) != NULL) break;
+    }
+    response[received] = '\0';
+
+    int status = 0;
+    if (std::sscanf(response, "HTTP/%*d.%*d %d", &status) != 1) return 0;
+    return status;
+}
+
+bool LeaderboardClient::load_spool()
+{
+    FILE* file = std::fopen(m_spool_filepath.c_str(), "rb");
+    if (file == NULL) return false;
+
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 && std::memcmp(magic, SPOOL_MAGIC, sizeof(magic)) == 0
+              && std::fread(&version, sizeof(version), 1, file) == 1 && version == SPOOL_VERSION
+              && std::fread(&count, sizeof(count), 1, file) == 1;
+    if (ok)
+    {
+        size_t first = m_pending.size();
+        m_pending.resize(first + count);
+        ok = std::fread(m_pending.data() + first, sizeof(LeaderboardEntry), count, file) == count;
+        if (!ok) m_pending.resize(first);
+    }
+    std::fclose(file);
+    return ok;
+}
+
+void LeaderboardClient::write_spool() const
+{
+    // Into a new file that then takes the old one's place, so a crash mid-write loses nothing
+    std::string temporary = m_spool_filepath + ".tmp";
+    if (m_pending.empty())
+    {
+        std::remove(m_spool_filepath.c_str());
+        return;
+    }
+
+    FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (file == NULL) return;
+
+    uint32_t count = (uint32_t)m_pending.size();
+    bool ok = std::fwrite(SPOOL_MAGIC, sizeof(SPOOL_MAGIC), 1, file) == 1
+              && std::fwrite(&SPOOL_VERSION, sizeof(SPOOL_VERSION), 1, file) == 1
+              && std::fwrite(&count, sizeof(count), 1, file) == 1
+              && std::fwrite(m_pending.data(), sizeof(LeaderboardEntry), count, file) == count;
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok)
+    {
+        std::remove(temporary.c_str());
+        return;
+    }
+    std::remove(m_spool_filepath.c_str());  // rename won't replace a file on Windows
+    std::rename(temporary.c_str(), m_spool_filepath.c_str());
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// Landings up to the leaderboard service without the game ever waiting on the network. submit()
+// only appends to a queue under a lock held for that append; a worker thread does everything
+// else. It lets submissions gather for COALESCE_SECONDS, then posts up to MAX_BATCH of them as
+// one JSON request, and keeps whatever hasn't been accepted in a spool file, so scores set while
+// the service is down (or the cabinet offline) go up on a later attempt or a later run.
+//
+// Failed attempts back off exponentially, with jitter so a room of cabinets doesn't come back in
+// step after an outage. Every entry carries a random id, so a batch sent again after its response
+// went missing can be told apart from new landings by the service.
+//
+// The transport is plain HTTP/1.1 over TcpStream: there is no TLS library in this build, so an
+// https:// service has to be reached through a local TLS-terminating proxy.
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Rng.h"
+
+struct LeaderboardEntry
+{
+    uint64_t id = 0;                   // filled in by submit()
+    char     player[24] = {};          // letters, digits, '-' and '_'; anything else becomes '_'
+    uint32_t seed = 0;
+    int32_t  layout = 0,
+             platform_count = 0,
+             score = 0;                // levels landed in the session so far, this one included
+    float    landing_seconds = 0.0f;   // simulated time from the first step to touchdown
+    int64_t  submitted_at = 0;         // Unix seconds, filled in by submit()
+};
+
+class LeaderboardClient
+{
+private:
+    static const int MAX_BATCH  = 32,
+                     TIMEOUT_MS = 5000;  // each of connect, send and receive
+    static constexpr double COALESCE_SECONDS      = 2.0,
+                            FIRST_BACKOFF_SECONDS = 2.0,
+                            MAX_BACKOFF_SECONDS   = 300.0;
+
+    std::string m_host_port,
+                m_host,
+                m_path,
+                m_spool_filepath;
+    std::thread m_worker;
+
+    // ————— SHARED WITH THE WORKER ————— //
+    std::mutex                    m_mutex;
+    std::condition_variable       m_wake;
+    std::vector<LeaderboardEntry> m_queued;  // submitted and not yet taken by the worker
+    bool                          m_stopping = false;
+    Rng                           m_ids;
+
+    // ————— WORKER ONLY ————— //
+    std::vector<LeaderboardEntry> m_pending;  // taken and not yet accepted; what the spool holds
+    Rng                           m_jitter;
+
+    std::atomic<long long> m_uploaded_count{ 0 },
+                           m_rejected_count{ 0 },
+                           m_failed_attempts{ 0 };
+
+    void worker_loop();
+    // The HTTP status, or 0 if the exchange never finished
+    int  post(const LeaderboardEntry* entries, int count);
+    bool load_spool();
+    void write_spool() const;
+
+public:
+    LeaderboardClient() = default;
+    LeaderboardClient(const LeaderboardClient&) = delete;
+    LeaderboardClient& operator=(const LeaderboardClient&) = delete;
+    ~LeaderboardClient() { stop(); }
+
+    // "http://host:port/path", the port optional; false for anything else, https:// included
+    static bool parse_url(const char* url, std::string& host, std::string& host_port, std::string& path);
+
+    // Starts the worker, which first picks up whatever a previous run left in the spool. False,
+    // with nothing started, for a URL parse_url turns down.
+    bool start(const char* url, const char* spool_filepath);
+
+    // Waits out an attempt already under way (TIMEOUT_MS at worst), then spools whatever is left
+    void stop();
+
+    // Game thread. Never touches the network or the disk.
+    void submit(const LeaderboardEntry& entry);
+
+    bool      const is_running()           const { return m_worker.joinable(); };
+    long long const get_uploaded_count()   const { return m_uploaded_count.load(std::memory_order_relaxed); };
+    long long const get_rejected_count()   const { return m_rejected_count.load(std::memory_order_relaxed); };
+    long long const get_failed_attempts()  const { return m_failed_attempts.load(std::memory_order_relaxed); };
+    // Waiting in the spool; only meaningful once stop() has returned
+    size_t    const get_spooled_count()    const { return m_pending.size(); };
+};
@@ -0,0 +1,71 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "LevelArena.h"
+
+static size_t align_up(size_t offset, size_t alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+void LevelArena::initialise(size_t block_size)
+{
+    m_block_size = block_size;
+    if (m_blocks.empty()) m_blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[block_size]), block_size });
+}
+
+void* LevelArena::allocate(size_t size, size_t alignment)
+{
+    if (m_block_size == 0) initialise();
+
+    // STEP 1: Bump within the current block if it still fits...
+    while (m_block < m_blocks.size())
+    {
+        Block& block = m_blocks[m_block];
+
+        // Aligned on the address, not the offset, since new[] only promises max_align_t
+        size_t base  = (size_t)block.data.get(),
+               start = align_up(base + m_offset, alignment) - base;
+
+        if (start + size <= block.capacity)
+        {
+            m_used += start + size - m_offset;
+            m_peak = std::max(m_peak, m_used);
+            m_offset = start + size;
+            return block.data.get() + start;
+        }
+
+        // ...or move on to the next block a previous level already grew into
+        m_used += block.capacity - m_offset;
+        m_block++;
+        m_offset = 0;
+    }
+
+    // STEP 2: Only a level bigger than any before it gets here
+    size_t capacity = std::max(m_block_size, size + alignment);
+    m_blocks.push_back({ std::unique_ptr<unsigned char[]>(new unsigned char[capacity]), capacity });
+
+    return allocate(size, alignment);
+}
+
+void LevelArena::reset()
+{
+    for (Finalizer* finalizer = m_finalizers; finalizer != NULL; finalizer = finalizer->next)
+    {
+        finalizer->destroy(finalizer->objects, finalizer->count);
+    }
+
+    m_finalizers = NULL;
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+// Bump allocator for everything that lives exactly as long as one level: the entities, their
+// animation tables and any level data. Nothing is freed on its own; reset() hands the whole
+// arena back at once, so restarting a level never goes near the heap once the blocks exist.
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class LevelArena
+{
+private:
+    struct Block
+    {
+        std::unique_ptr<unsigned char[]> data;
+        size_t capacity;
+    };
+
+    // Objects with a destructor leave one of these behind, allocated in the arena itself
+    struct Finalizer
+    {
+        void      (*destroy)(void* objects, size_t count);
+        void*      objects;
+        size_t     count;
+        Finalizer* next;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_block  = 0,  // block currently being bumped
+           m_offset = 0;  // first free byte in it
+
+    size_t     m_block_size = 0;
+    Finalizer* m_finalizers = NULL;
+
+    // High-water mark across resets, for sizing DEFAULT_BLOCK_SIZE
+    size_t m_used = 0,
+           m_peak = 0;
+
+    template <typename T>
+    static void destroy_objects(void* objects, size_t count)
+    {
+        T* typed = (T*)objects;
+        for (size_t i = count; i > 0; i--) typed[i - 1].~T();
+    }
+
+    template <typename T>
+    void track(T* objects, size_t count)
+    {
+        if (std::is_trivially_destructible<T>::value) return;
+
+        Finalizer* finalizer = new (allocate(sizeof(Finalizer), alignof(Finalizer))) Finalizer;
+        *finalizer = { &destroy_objects<T>, objects, count, m_finalizers };
+        m_finalizers = finalizer;
+    }
+
+public:
+    static const size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    LevelArena() = default;
+    LevelArena(const LevelArena&) = delete;
+    LevelArena& operator=(const LevelArena&) = delete;
+    ~LevelArena() { reset(); }
+
+    // Allocates the first block up front, so the first level doesn't pay for it mid-load
+    void initialise(size_t block_size = DEFAULT_BLOCK_SIZE);
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        track(object, 1);
+        return object;
+    }
+
+    // Default-constructs `count` objects in one contiguous run, like new T[count]
+    template <typename T>
+    T* create_array(size_t count)
+    {
+        T* objects = (T*)allocate(sizeof(T) * count, alignof(T));
+        for (size_t i = 0; i < count; i++) new (&objects[i]) T();
+        track(objects, count);
+        return objects;
+    }
+
+    // Destroys whatever registered a destructor, newest first, and rewinds to the first block.
+    // The blocks themselves are kept for the next level.
+    void reset();
+
+    size_t const get_used()        const { return m_used; };
+    size_t const get_peak()        const { return m_peak; };
+    int    const get_block_count() const { return (int)m_blocks.size(); };
+};
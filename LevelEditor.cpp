@@ -0,0 +1,110 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <chrono>
+#include "LevelEditor.h"
+
+static void get_box(const Entity& platform, glm::vec2& min, glm::vec2& max)
+{
+    glm::vec2 centre    = glm::vec2(platform.get_position()),
+              half_size = glm::vec2(platform.get_width(), platform.get_height()) / 2.0f;
+    min = centre - half_size;
+    max = centre + half_size;
+}
+
+// ————— PICKING ————— //
+int LevelEditor::pick(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, glm::vec2 point)
+{
+    m_candidates.clear();
+    if (broadphase != NULL)
+    {
+        int cursor = -1;
+        broadphase->query(point, point, m_candidates, cursor);
+    }
+    else
+    {
+        for (int i = 0; i < platform_count; i++) m_candidates.push_back(i);
+    }
+
+    // Later platforms draw over earlier ones, so the last one under the point is on top
+    for (int i = (int)m_candidates.size() - 1; i >= 0; i--)
+    {
+        const Entity& platform = platforms[m_candidates[i]];
+        if (!platform.is_active() || platform.get_body_type() != STATIC_BODY) continue;
+
+        glm::vec2 min, max;
+        get_box(platform, min, max);
+        if (point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y) return m_candidates[i];
+    }
+    return -1;
+}
+
+// ————— CHANGE SET ————— //
+void LevelEditor::move(int platform, glm::vec2 position)
+{
+    // A drag only ever has a handful in flight, so a scan beats a map
+    for (PendingMove& pending : m_pending)
+    {
+        if (pending.platform != platform) continue;
+        pending.position = position;
+        return;
+    }
+    m_pending.push_back({ platform, position });
+}
+
+bool LevelEditor::begin_drag(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, glm::vec2 point)
+{
+    m_dragged = pick(platforms, platform_count, broadphase, point);
+    if (m_dragged < 0) return false;
+
+    m_grab_offset = glm::vec2(platforms[m_dragged].get_position()) - point;
+    return true;
+}
+
+void LevelEditor::drag_to(glm::vec2 point)
+{
+    if (m_dragged >= 0) move(m_dragged, point + m_grab_offset);
+}
+
+void LevelEditor::apply(Entity* platforms, PlatformColliders& colliders, PlatformBroadphase* broadphase, std::vector<PlatformMove>& moves)
+{
+    moves.clear();
+    if (m_pending.empty()) return;
+    auto start = std::chrono::steady_clock::now();
+
+    for (const PendingMove& pending : m_pending)
+    {
+        Entity& platform = platforms[pending.platform];
+
+        PlatformMove move;
+        move.platform = pending.platform;
+        get_box(platform, move.from_min, move.from_max);
+
+        // STEP 1: The platform itself, where rendering and the next snapshot read it
+        platform.set_position(glm::vec3(pending.position, platform.get_position().z));
+        get_box(platform, move.to_min, move.to_max);
+
+        // STEP 2: What collision reads: its box, and where the broadphase has it filed
+        colliders.sync_platform(platforms, pending.platform);
+        if (broadphase != NULL) broadphase->refile(platforms, pending.platform);
+
+        moves.push_back(move);
+    }
+
+    m_moves_applied += (long long)m_pending.size();
+    m_pending.clear();
+    m_last_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void LevelEditor::reset()
+{
+    m_pending.clear();
+    m_dragged = -1;
+}
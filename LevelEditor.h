@@ -0,0 +1,69 @@
+#pragma once
+
+// Static platforms dragged about by hand while the level runs (--editor). A drag doesn't touch
+// the level as it happens: each move is queued in a change set, one entry a platform however many
+// times it moved, and apply() writes the set through once a frame. Every derived structure is
+// patched for just the platforms in it: their collider boxes, their broadphase filing (see
+// PlatformBroadphase::refile), and whatever the caller draws them from, which gets the boxes each
+// platform left and took. Nothing is rebuilt, so a move costs the same on a level of a million
+// platforms as on one of ten.
+//
+// Only static platforms can be picked up; the movers follow their own paths. Landing site scores
+// are for where the pads were built, so the caller rebuilds those once editing is done.
+#include <vector>
+#include "glm/vec2.hpp"
+#include "Entity.h"
+#include "PlatformBroadphase.h"
+#include "PlatformColliders.h"
+
+// The box a platform left and the one it took, for what redraws by area
+struct PlatformMove
+{
+    int       platform;
+    glm::vec2 from_min, from_max,
+              to_min, to_max;
+};
+
+class LevelEditor
+{
+private:
+    struct PendingMove
+    {
+        int       platform;
+        glm::vec2 position;
+    };
+
+    std::vector<PendingMove> m_pending;  // this frame's change set
+    std::vector<int>         m_candidates;
+
+    int       m_dragged = -1;
+    glm::vec2 m_grab_offset = glm::vec2(0.0f);  // from the grabbed point to the platform's centre
+
+    long long m_moves_applied = 0;
+    float     m_last_ms = 0.0f;
+
+public:
+    // The topmost static platform under `point`, or -1. Asks the broadphase where there is one.
+    int pick(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, glm::vec2 point);
+
+    // Queues the platform's centre to `position`; a later move of the same platform replaces it
+    void move(int platform, glm::vec2 position);
+
+    // Picks up whatever is under `point`; false if nothing is
+    bool begin_drag(const Entity* platforms, int platform_count, const PlatformBroadphase* broadphase, glm::vec2 point);
+    void drag_to(glm::vec2 point);
+    void end_drag() { m_dragged = -1; };
+
+    // Once a frame: writes the change set into the platforms, their colliders and the broadphase,
+    // and empties it. `moves` gets one entry a platform moved, for the caller's own caches.
+    void apply(Entity* platforms, PlatformColliders& colliders, PlatformBroadphase* broadphase, std::vector<PlatformMove>& moves);
+
+    // Drops the change set and any drag, e.g. when the level is replaced
+    void reset();
+
+    bool      const is_dragging()       const { return m_dragged >= 0; };
+    int       const get_dragged()       const { return m_dragged; };
+    int       const get_pending_count() const { return (int)m_pending.size(); };
+    long long const get_moves_applied() const { return m_moves_applied; };
+    float     const get_last_ms()       const { return m_last_ms; };
+};
@@ -0,0 +1,273 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "LevelFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char LevelFile::MAGIC[4] = { 'L', 'L', 'V', 'L' };
+
+static_assert(sizeof(LevelFileHeader) == 64, "the header is part of the file format");
+static_assert(sizeof(LevelPlatform) == 24, "platforms are part of the file format");
+
+static size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Whether [offset, offset + count * element_size) lies inside the file, without overflowing
+static bool section_fits(uint64_t offset, uint64_t count, uint64_t element_size, size_t file_size)
+{
+    if (offset > file_size || offset % alignof(float) != 0) return false;
+    return count <= (file_size - offset) / element_size;
+}
+
+bool LevelFile::open(const char* filepath)
+{
+    close();
+
+    // STEP 1: Map the file
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (size_t)size.QuadPart;
+#else
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    m_file = file;
+    m_data = data == MAP_FAILED ? NULL : (const unsigned char*)data;
+    m_size = (size_t)status.st_size;
+#endif
+
+    if (m_data == NULL)
+    {
+        close();
+        return false;
+    }
+
+    // STEP 2: Only the header and the section bounds; the arrays themselves are left unread
+    const LevelFileHeader* header = (const LevelFileHeader*)m_data;
+    bool valid = m_size >= sizeof(LevelFileHeader) && std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION;
+
+    valid = valid && section_fits(header->platforms_offset, header->platform_count, sizeof(LevelPlatform), m_size);
+    if (valid && header->terrain_sample_count > 0)
+    {
+        valid = header->terrain_sample_count >= 2 && header->terrain_spacing > 0.0f &&
+                section_fits(header->terrain_heights_offset, header->terrain_sample_count, sizeof(float), m_size) &&
+                section_fits(header->terrain_pads_offset, header->terrain_sample_count - 1, 1, m_size);
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    m_header = header;
+    return true;
+}
+
+void LevelFile::close()
+{
+#ifdef _WIN32
+    if (m_data != NULL) UnmapViewOfFile(m_data);
+    if (m_mapping != NULL) CloseHandle(m_mapping);
+    if (m_file != NULL) CloseHandle(m_file);
+    m_file = m_mapping = NULL;
+#else
+    if (m_data != NULL) munmap((void*)m_data, m_size);
+    if (m_file >= 0) ::close(m_file);
+    m_file = -1;
+#endif
+
+    m_data = NULL;
+    m_size = 0;
+    m_header = NULL;
+}
+
+bool write_level_file(const char* filepath, const LevelData& level)
+{
+    bool has_terrain = level.terrain_heights.size() >= 2;
+    uint32_t sample_count = has_terrain ? (uint32_t)level.terrain_heights.size() : 0;
+
+    // STEP 1: Lay the sections out after the header
+    LevelFileHeader header = {};
+    std::memcpy(header.magic, LevelFile::MAGIC, sizeof(header.magic));
+    header.version = LevelFile::VERSION;
+    header.platform_count = (uint32_t)level.platforms.size();
+    header.terrain_sample_count = sample_count;
+    header.spawn_x = level.spawn.x;
+    header.spawn_y = level.spawn.y;
+    header.terrain_origin_x = level.terrain_origin_x;
+    header.terrain_spacing = level.terrain_spacing;
+
+    size_t offset = align_up(sizeof(LevelFileHeader), LevelFile::SECTION_ALIGNMENT);
+    header.platforms_offset = offset;
+    offset = align_up(offset + level.platforms.size() * sizeof(LevelPlatform), LevelFile::SECTION_ALIGNMENT);
+    header.terrain_heights_offset = offset;
+    offset = align_up(offset + sample_count * sizeof(float), LevelFile::SECTION_ALIGNMENT);
+    header.terrain_pads_offset = offset;
+
+    // Pads are padded out to one per segment, whatever the caller filled in
+    std::vector<unsigned char> pads;
+    if (has_terrain)
+    {
+        pads = level.terrain_pads;
+        pads.resize(sample_count - 1, 0);
+    }
+
+    // STEP 2: Write everything in order, zero-filling the gaps
+    std::ofstream output(filepath, std::ios::binary);
+    if (!output) return false;
+
+    auto write_at = [&output](uint64_t offset, const void* data, size_t size)
+        {
+            static const char zeros[LevelFile::SECTION_ALIGNMENT] = {};
+            while ((uint64_t)output.tellp() < offset) output.write(zeros, (std::streamsize)std::min<uint64_t>(offset - output.tellp(), sizeof(zeros)));
+            if (size > 0) output.write((const char*)data, (std::streamsize)size);
+        };
+
+    write_at(0, &header, sizeof(header));
+    write_at(header.platforms_offset, level.platforms.data(), level.platforms.size() * sizeof(LevelPlatform));
+    if (has_terrain)
+    {
+        write_at(header.terrain_heights_offset, level.terrain_heights.data(), sample_count * sizeof(float));
+        write_at(header.terrain_pads_offset, pads.data(), pads.size());
+    }
+
+    return (bool)output;
+}
+
+LevelPlatform make_level_platform(const Entity& platform)
+{
+    LevelPlatform level_platform = {};
+    level_platform.x = platform.get_position().x;
+    level_platform.y = platform.get_position().y;
+    level_platform.width = platform.get_width();
+    level_platform.height = platform.get_height();
+    level_platform.entity_type = (uint32_t)platform.get_entity_type();
+    return level_platform;
+}
+
+// The low 16 bits of v moved to the even bits, for interleaving with another coordinate
+static uint32_t spread_bits(uint32_t v)
+{
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+std::vector<int> get_morton_order(const LevelPlatform* platforms, int count)
+{
+    std::vector<int> order(count);
+    if (count == 0) return order;
+
+    // STEP 1: Square cells over the centres' bounds, so a long strip is cut along its length and
+    //         the order stays mostly left to right
+    float min_x = platforms[0].x, max_x = platforms[0].x,
+          min_y = platforms[0].y, max_y = platforms[0].y;
+    for (int i = 1; i < count; i++)
+    {
+        min_x = std::min(min_x, platforms[i].x);
+        max_x = std::max(max_x, platforms[i].x);
+        min_y = std::min(min_y, platforms[i].y);
+        max_y = std::max(max_y, platforms[i].y);
+    }
+    float extent = std::max(max_x - min_x, max_y - min_y),
+          scale  = extent > 0.0f ? 65535.0f / extent : 0.0f;
+
+    // STEP 2: Code above index in one key, so ties keep the file's order and the sort is plain
+    std::vector<uint64_t> keys(count);
+    for (int i = 0; i < count; i++)
+    {
+        uint32_t column = (uint32_t)((platforms[i].x - min_x) * scale),
+                 row    = (uint32_t)((platforms[i].y - min_y) * scale);
+        keys[i] = (uint64_t)(spread_bits(column) | (spread_bits(row) << 1)) << 32 | (uint32_t)i;
+    }
+    std::sort(keys.begin(), keys.end());
+
+    for (int i = 0; i < count; i++) order[i] = (int)(uint32_t)keys[i];
+    return order;
+}
+
+void load_level_platforms(const LevelFile& file, Entity* platforms)
+{
+    const LevelPlatform* level_platforms = file.get_platforms();
+    int count = file.get_platform_count();
+
+    // Files keep platforms in whatever order they were written; near neighbours go next to each
+    // other here, so the colliders and the broadphase built over this array read it in runs
+    std::vector<int> order = get_morton_order(level_platforms, count);
+
+    for (int i = 0; i < count; i++)
+    {
+        const LevelPlatform& level_platform = level_platforms[order[i]];
+
+        // Anything but a landing pad is something to crash into
+        platforms[i].set_position(glm::vec3(level_platform.x, level_platform.y, 0.0f));
+        platforms[i].set_width(level_platform.width);
+        platforms[i].set_height(level_platform.height);
+        platforms[i].set_entity_type(level_platform.entity_type == WIN_PLATFORM ? WIN_PLATFORM : DEATH_PLATFORM);
+        platforms[i].set_body_type(STATIC_BODY);
+    }
+}
+
+bool load_level_terrain(const LevelFile& file, Terrain& terrain)
+{
+    if (!file.has_terrain()) return false;
+
+    // Terrain owns its samples, so this is the one copy a level with terrain makes
+    const LevelFileHeader& header = file.get_header();
+    const float*         heights = file.get_terrain_heights();
+    const unsigned char* pads    = file.get_terrain_pads();
+
+    terrain.set_samples(header.terrain_origin_x, header.terrain_spacing,
+                        std::vector<float>(heights, heights + header.terrain_sample_count),
+                        std::vector<unsigned char>(pads, pads + header.terrain_sample_count - 1));
+    return true;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+// .lvl: a level laid out on disk the way it is used, so opening one maps the file and points into
+// it rather than reading or parsing anything. Written by LevelPacker from a text description or
+// a generated scene.
+//
+//   LevelFileHeader | LevelPlatform[platform_count] | float heights[terrain_sample_count]
+//                   | uint8 pads[terrain_sample_count - 1]
+//
+// Every section starts SECTION_ALIGNMENT-aligned. All fields are little-endian; offsets count
+// from the start of the file. Only the header and the section bounds are checked on open, so a
+// page of platforms is only faulted in once something actually reads it.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "Entity.h"
+#include "Terrain.h"
+
+struct LevelFileHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t platform_count;
+    uint32_t terrain_sample_count;       // 0 for a level without terrain
+    float    spawn_x, spawn_y;
+    float    terrain_origin_x, terrain_spacing;
+    uint64_t platforms_offset,
+             terrain_heights_offset,
+             terrain_pads_offset;
+    uint64_t reserved;
+};
+
+struct LevelPlatform
+{
+    float    x, y,
+             width, height;
+    uint32_t entity_type;  // WIN_PLATFORM or DEATH_PLATFORM
+    uint32_t reserved;
+};
+
+// What write_level_file lays out; the in-memory side of the format
+struct LevelData
+{
+    std::vector<LevelPlatform> platforms;
+    glm::vec2                  spawn = glm::vec2(0.0f, 3.0f);
+
+    float                      terrain_origin_x = 0.0f,
+                               terrain_spacing  = 1.0f;
+    std::vector<float>         terrain_heights;
+    std::vector<unsigned char> terrain_pads;  // terrain_heights.size() - 1 segment flags
+};
+
+class LevelFile
+{
+private:
+    const unsigned char*   m_data   = NULL;
+    size_t                 m_size   = 0;
+    const LevelFileHeader* m_header = NULL;
+
+#ifdef _WIN32
+    void* m_file    = NULL,
+        * m_mapping = NULL;
+#else
+    int m_file = -1;
+#endif
+
+public:
+    static const uint32_t VERSION           = 1;
+    static const size_t   SECTION_ALIGNMENT = 64;
+    static const char     MAGIC[4];
+
+    LevelFile() = default;
+    LevelFile(const LevelFile&) = delete;
+    LevelFile& operator=(const LevelFile&) = delete;
+    ~LevelFile() { close(); }
+
+    // Maps the whole file read-only; false if it is missing, truncated or from another version
+    bool open(const char* filepath);
+    void close();
+
+    // Everything below points straight into the mapped pages and stays valid until close()
+    const LevelPlatform* get_platforms()       const { return (const LevelPlatform*)(m_data + m_header->platforms_offset); };
+    const float*         get_terrain_heights() const { return (const float*)(m_data + m_header->terrain_heights_offset); };
+    const unsigned char* get_terrain_pads()    const { return m_data + m_header->terrain_pads_offset; };
+
+    bool      const is_open()            const { return m_data != NULL; };
+    const LevelFileHeader& get_header()  const { return *m_header; };
+    int       const get_platform_count() const { return (int)m_header->platform_count; };
+    bool      const has_terrain()        const { return m_header->terrain_sample_count >= 2; };
+    glm::vec2 const get_spawn()          const { return glm::vec2(m_header->spawn_x, m_header->spawn_y); };
+    size_t    const get_size()           const { return m_size; };
+};
+
+// False if the file can't be written
+bool write_level_file(const char* filepath, const LevelData& level);
+
+LevelPlatform make_level_platform(const Entity& platform);
+
+// Indices of `platforms` in Z-order of their centres (a Morton code over 16-bit square cells), so
+// platforms near each other in the level end up near each other in memory
+std::vector<int> get_morton_order(const LevelPlatform* platforms, int count);
+
+// Static platforms for the game, one per LevelPlatform but in get_morton_order's order rather
+// than the file's; `platforms` must hold get_platform_count()
+void load_level_platforms(const LevelFile& file, Entity* platforms);
+// False, leaving terrain untouched, when the level has none
+bool load_level_terrain(const LevelFile& file, Terrain& terrain);
@@ -0,0 +1,111 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include "LevelStreamer.h"
+#include "Rng.h"
+
+// Chunk 0 starts where the classic level does, so the spawn point sits over familiar ground
+const float COURSE_ORIGIN_X = -4.0f;
+
+const int NO_CHUNK = INT32_MIN;
+
+LevelStreamer::LevelStreamer() : m_platforms(RESIDENT_CHUNKS * CHUNK_PLATFORMS)
+{
+    for (int& chunk : m_slot_chunks) chunk = NO_CHUNK;
+}
+
+int const LevelStreamer::get_chunk_at(float x) const
+{
+    return (int)std::floor((x - COURSE_ORIGIN_X) / CHUNK_WIDTH) + m_origin_chunk;
+}
+
+float LevelStreamer::get_chunk_x(int chunk) const
+{
+    return COURSE_ORIGIN_X + (chunk - m_origin_chunk) * CHUNK_WIDTH;
+}
+
+void LevelStreamer::generate_chunk(int chunk, int slot)
+{
+    // Same draws as generate_platforms, from the chunk's own stream
+    Rng rng(m_seed, (uint64_t)(int64_t)chunk);
+    Entity* platforms = &m_platforms[slot * CHUNK_PLATFORMS];
+    float chunk_x = get_chunk_x(chunk);
+
+    for (int i = 0; i < CHUNK_PLATFORMS; i++)
+    {
+        bool rand_bool = rng.next_bool();
+        float rand_float = (float)rng.next_int(-3, 1);
+
+        platforms[i] = Entity();
+        platforms[i].set_position(glm::vec3(chunk_x + i, rand_float, 0.0f));
+        platforms[i].set_entity_type((rand_bool) ? WIN_PLATFORM : DEATH_PLATFORM);
+        platforms[i].set_body_type(STATIC_BODY);
+    }
+
+    m_slot_chunks[slot] = chunk;
+    m_generated_chunks++;
+}
+
+void LevelStreamer::begin(unsigned int seed, float x)
+{
+    m_seed = seed;
+    m_origin_chunk = 0;
+    for (int& chunk : m_slot_chunks) chunk = NO_CHUNK;
+
+    m_centre_chunk = get_chunk_at(x);
+    update(x);
+}
+
+bool LevelStreamer::update(float x)
+{
+    m_centre_chunk = get_chunk_at(x);
+
+    // Chunk n always lives in slot n mod RESIDENT_CHUNKS, so a chunk leaving the window at one
+    // end frees exactly the slot the chunk entering at the other end needs
+    bool changed = false;
+    for (int chunk = m_centre_chunk - CHUNKS_AROUND; chunk <= m_centre_chunk + CHUNKS_AROUND; chunk++)
+    {
+        int slot = ((chunk % RESIDENT_CHUNKS) + RESIDENT_CHUNKS) % RESIDENT_CHUNKS;
+        if (m_slot_chunks[slot] == chunk) continue;
+
+        generate_chunk(chunk, slot);
+        changed = true;
+    }
+    return changed;
+}
+
+float LevelStreamer::rebase(float x)
+{
+    int shift = (int)std::floor((x - COURSE_ORIGIN_X) / CHUNK_WIDTH);
+    if (std::abs(shift) < REBASE_CHUNKS) return 0.0f;
+
+    // Placed again from their chunk and index rather than moved, so no rounding builds up over
+    // many rebases
+    m_origin_chunk += shift;
+    for (int slot = 0; slot < RESIDENT_CHUNKS; slot++)
+    {
+        if (m_slot_chunks[slot] == NO_CHUNK) continue;
+
+        float chunk_x = get_chunk_x(m_slot_chunks[slot]);
+        Entity* platforms = &m_platforms[slot * CHUNK_PLATFORMS];
+        for (int i = 0; i < CHUNK_PLATFORMS; i++)
+        {
+            glm::vec3 position = platforms[i].get_position();
+            platforms[i].set_position(glm::vec3(chunk_x + i, position.y, position.z));
+        }
+    }
+
+    m_rebase_count++;
+    return -shift * CHUNK_WIDTH;
+}
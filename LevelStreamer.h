@@ -0,0 +1,69 @@
+#pragma once
+
+// An endless course, split along x into chunks that are generated as the camera nears them and
+// dropped once it has moved on. Only a fixed window of chunks around the camera is ever
+// resident, each in its own slot of one platform array allocated up front, so memory stays the
+// same however far the course runs.
+//
+// Chunk n is the same for a given seed every time it's generated (its platforms come from
+// Rng(seed, n)), so flying back over dropped ground brings back exactly what was there.
+//
+// Floats thin out far from zero, and a long enough run gets to where overlap tests jitter. So a
+// position on the course is a chunk index plus a local float: the origin chunk is where the
+// local coordinates the simulation and the renderer see start, and rebase() moves it up to the
+// camera every REBASE_CHUNKS chunks, keeping every local coordinate near zero however far the
+// course runs.
+#include <vector>
+#include "Entity.h"
+
+class LevelStreamer
+{
+public:
+    static const int CHUNK_PLATFORMS = 8;  // one per unit, as in the classic level
+    static constexpr float CHUNK_WIDTH = (float)CHUNK_PLATFORMS;
+    static const int CHUNKS_AROUND   = 2;  // resident either side of the camera's chunk
+    static const int RESIDENT_CHUNKS = 2 * CHUNKS_AROUND + 1;
+    static const int REBASE_CHUNKS   = 16;  // from the origin's chunk before rebase() moves it
+
+private:
+    unsigned int        m_seed = 0;
+    std::vector<Entity> m_platforms;           // RESIDENT_CHUNKS slots of CHUNK_PLATFORMS
+    int                 m_slot_chunks[RESIDENT_CHUNKS];
+    int                 m_centre_chunk = 0;
+    int                 m_origin_chunk = 0;  // the chunk that starts at COURSE_ORIGIN_X locally
+    long long           m_generated_chunks = 0;
+    int                 m_rebase_count = 0;
+
+    float get_chunk_x(int chunk) const;
+    void  generate_chunk(int chunk, int slot);
+
+public:
+    LevelStreamer();
+
+    // A new course, with the window centred on the chunk under x and the origin back at chunk 0
+    void begin(unsigned int seed, float x);
+
+    // Brings the window to the chunk under x, generating whatever came into range over the
+    // slots of whatever fell out of it. Returns whether any platform changed, in which case
+    // anything built from get_platforms() (broadphase, colliders, instances) must be rebuilt.
+    bool update(float x);
+
+    int const get_chunk_at(float x) const;
+
+    // Once x is REBASE_CHUNKS chunks from the origin, moves the origin to the chunk under it, with
+    // every resident platform put where it would have been generated under the new one. Returns
+    // how far local coordinates moved, a whole number of chunks, by which everything else holding
+    // one (landers, the camera, particles) has to move too; 0 when they didn't. Anything built from
+    // the platforms has to be rebuilt, as after update().
+    float rebase(float x);
+
+    // ————— GETTERS ————— //
+    Entity*         get_platforms()              { return m_platforms.data(); };
+    int       const get_platform_count()   const { return (int)m_platforms.size(); };
+    int       const get_centre_chunk()     const { return m_centre_chunk; };
+    int       const get_origin_chunk()     const { return m_origin_chunk; };
+    // Local x plus this is the course's x; exact, being a whole number of chunks
+    float     const get_origin_x()         const { return m_origin_chunk * CHUNK_WIDTH; };
+    int       const get_rebase_count()     const { return m_rebase_count; };
+    long long const get_generated_chunks() const { return m_generated_chunks; };
+};
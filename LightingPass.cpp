@@ -0,0 +1,285 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include "EmbeddedShaders.h"
+#include "GLCallCounter.h"
+#include "GLCapabilities.h"
+#include "LightingPass.h"
+
+static const float PI = 3.14159265f;
+
+bool LightingPass::initialise()
+{
+    if (!supports_blend_minmax() || !m_shadow_map.initialise(MAX_SHADOW_RESOLUTION, MAX_LIGHTS, true)) return false;
+
+    // STEP 1: The shadow maps' edges, a quad each
+    m_shadow_program.load(EmbeddedShaders::SHADOW_MAP_VERTEX, EmbeddedShaders::SHADOW_MAP_FRAGMENT);
+    m_angle_scale_uniform = glGetUniformLocation(m_shadow_program.get_program_id(), "angleScale");
+
+    m_backend = get_render_backend();
+    VertexLayout shadow_layout;
+    shadow_layout.stride = sizeof(ShadowVertex);
+    shadow_layout.add(m_shadow_program.get_position_attribute(), 2, offsetof(ShadowVertex, position))
+                 .add(m_shadow_program.get_tex_coordinate_attribute(), 4, offsetof(ShadowVertex, edge));
+    m_backend->create_pipeline(m_shadow_pipeline, &m_shadow_program, shadow_layout);
+
+    // STEP 2: The lights, over one triangle big enough that the screen is the part of it inside
+    //         clip space
+    std::string defines = "#define MAX_LIGHTS " + std::to_string(MAX_LIGHTS) + "\n";
+    m_light_program.load(EmbeddedShaders::LIGHTING_VERTEX, EmbeddedShaders::LIGHTING_FRAGMENT, defines);
+    GLuint id = m_light_program.get_program_id();
+    m_view_min_uniform     = glGetUniformLocation(id, "viewMin");
+    m_view_max_uniform     = glGetUniformLocation(id, "viewMax");
+    m_lights_uniform       = glGetUniformLocation(id, "lights");
+    m_colours_uniform      = glGetUniformLocation(id, "lightColours");
+    m_light_count_uniform  = glGetUniformLocation(id, "lightCount");
+    m_shadow_scale_uniform = glGetUniformLocation(id, "shadowScale");
+
+    m_light_program.use();
+    count_gl_call(GL_CALL_UNIFORM, 2);
+    glUniform1i(glGetUniformLocation(id, "shadowMap"), 0);
+    glUniform1f(glGetUniformLocation(id, "ambient"), AMBIENT);
+
+    const float vertices[] = { -1.0f, -1.0f,
+                                3.0f, -1.0f,
+                               -1.0f,  3.0f };
+    m_triangle_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    VertexLayout light_layout;
+    light_layout.stride = 2 * sizeof(float);
+    m_backend->create_pipeline(m_light_pipeline, &m_light_program, light_layout.add(m_light_program.get_position_attribute(), 2, 0));
+    return true;
+}
+
+void LightingPass::cleanup()
+{
+    if (!is_enabled()) return;
+
+    m_backend->delete_pipeline(m_shadow_pipeline);
+    m_backend->delete_pipeline(m_light_pipeline);
+    m_backend->delete_buffer(m_triangle_buffer);
+    if (m_edge_buffer != 0) m_backend->delete_buffer(m_edge_buffer);
+    m_triangle_buffer = m_edge_buffer = 0;
+    m_edge_buffer_bytes = 0;
+    m_shadow_map.cleanup();
+}
+
+void LightingPass::set_limits(int light_count, int shadow_resolution)
+{
+    m_max_lights = std::clamp(light_count, 0, MAX_LIGHTS);
+    m_shadow_resolution = std::clamp(shadow_resolution, 1, MAX_SHADOW_RESOLUTION);
+}
+
+// ————— THIS FRAME ————— //
+void LightingPass::begin_frame()
+{
+    m_lights.clear();
+    m_occluders.clear();
+}
+
+bool LightingPass::add_light(glm::vec2 position, float radius, glm::vec3 colour)
+{
+    if ((int)m_lights.size() >= m_max_lights || !(radius > 0.0f)) return false;
+
+    m_lights.push_back({ position, radius, colour });
+    return true;
+}
+
+void LightingPass::add_occluder(glm::vec2 min, glm::vec2 max)
+{
+    m_occluders.push_back(glm::vec4(min, max));
+}
+
+bool LightingPass::get_light_bounds(glm::vec2& min, glm::vec2& max) const
+{
+    if (m_lights.empty()) return false;
+
+    min = m_lights[0].position - m_lights[0].radius;
+    max = m_lights[0].position + m_lights[0].radius;
+    for (const Light& light : m_lights)
+    {
+        min = glm::min(min, light.position - light.radius);
+        max = glm::max(max, light.position + light.radius);
+    }
+    return true;
+}
+
+// ————— SHADOW MAPS ————— //
+void LightingPass::add_quad(int row, float first_angle, float last_angle, glm::vec4 edge)
+{
+    // Half a texel wider each side, so every texel the edge touches is covered, even by an edge
+    // narrower than one
+    float pad    = PI / (float)m_shadow_resolution;
+    float left   = (first_angle - pad) / PI,
+          right  = (last_angle + pad) / PI,
+          bottom = 2.0f * (float)row / (float)MAX_LIGHTS - 1.0f,
+          top    = 2.0f * (float)(row + 1) / (float)MAX_LIGHTS - 1.0f;
+
+    m_vertices.push_back({ glm::vec2(left,  bottom), edge });
+    m_vertices.push_back({ glm::vec2(right, bottom), edge });
+    m_vertices.push_back({ glm::vec2(right, top),    edge });
+    m_vertices.push_back({ glm::vec2(left,  bottom), edge });
+    m_vertices.push_back({ glm::vec2(right, top),    edge });
+    m_vertices.push_back({ glm::vec2(left,  top),    edge });
+}
+
+void LightingPass::add_edge(int row, glm::vec2 start, glm::vec2 end)
+{
+    // The shorter way round from one end to the other: a facing edge never has the light on its line
+    float first = std::atan2(start.y, start.x),
+          span  = std::atan2(end.y, end.x) - first;
+    if (span > PI)       span -= 2.0f * PI;
+    else if (span < -PI) span += 2.0f * PI;
+
+    float low  = std::min(first, first + span),
+          high = std::max(first, first + span);
+    glm::vec4 edge = glm::vec4(start, end);
+
+    // The row starts and ends at -pi, so an edge across it is drawn in two pieces
+    if (low < -PI)
+    {
+        add_quad(row, low + 2.0f * PI, PI, edge);
+        add_quad(row, -PI, high, edge);
+    }
+    else if (high > PI)
+    {
+        add_quad(row, low, PI, edge);
+        add_quad(row, -PI, high - 2.0f * PI, edge);
+    }
+    else add_quad(row, low, high, edge);
+    m_edge_count++;
+}
+
+void LightingPass::render_shadow_maps()
+{
+    m_draw_calls = 0;
+    m_edge_count = 0;
+    m_vertices.clear();
+    if (!is_enabled() || m_lights.empty()) return;
+
+    // STEP 1: The sides of each box that face each light, from the light and in its radii. A
+    //         light inside a box is in the dark all round, which an edge of no length gives.
+    for (int row = 0; row < (int)m_lights.size(); row++)
+    {
+        const Light& light = m_lights[row];
+        float inverse_radius = 1.0f / light.radius;
+
+        for (const glm::vec4& occluder : m_occluders)
+        {
+            glm::vec2 min = (glm::vec2(occluder.x, occluder.y) - light.position) * inverse_radius,
+                      max = (glm::vec2(occluder.z, occluder.w) - light.position) * inverse_radius;
+            glm::vec2 nearest = glm::clamp(glm::vec2(0.0f), min, max);
+            if (glm::dot(nearest, nearest) >= 1.0f) continue;
+
+            if (nearest == glm::vec2(0.0f))
+            {
+                add_quad(row, -PI, PI, glm::vec4(0.0f));
+                continue;
+            }
+            if (min.x > 0.0f) add_edge(row, glm::vec2(min.x, min.y), glm::vec2(min.x, max.y));
+            if (max.x < 0.0f) add_edge(row, glm::vec2(max.x, min.y), glm::vec2(max.x, max.y));
+            if (min.y > 0.0f) add_edge(row, glm::vec2(min.x, min.y), glm::vec2(max.x, min.y));
+            if (max.y < 0.0f) add_edge(row, glm::vec2(min.x, max.y), glm::vec2(max.x, max.y));
+        }
+    }
+
+    // STEP 2: Up in one go, into a buffer that only ever grows
+    size_t bytes = m_vertices.size() * sizeof(ShadowVertex);
+    if (bytes > m_edge_buffer_bytes)
+    {
+        if (m_edge_buffer != 0) m_backend->delete_buffer(m_edge_buffer);
+        m_edge_buffer_bytes = std::max(bytes, 2 * m_edge_buffer_bytes);
+        m_edge_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, m_edge_buffer_bytes, NULL, GL_STREAM_DRAW);
+    }
+    if (bytes > 0) m_backend->update_buffer(m_edge_buffer, GL_ARRAY_BUFFER, 0, bytes, m_vertices.data());
+
+    // STEP 3: Every row cleared to out of reach, then the nearest edge kept in each texel
+    GLint framebuffer = 0, viewport[4];
+    GLfloat clear_colour[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_colour);
+
+    m_shadow_map.bind();
+    glViewport(0, 0, m_shadow_resolution, MAX_LIGHTS);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clear_colour[0], clear_colour[1], clear_colour[2], clear_colour[3]);
+
+    if (!m_vertices.empty())
+    {
+        glBlendEquation(GL_MIN);
+        m_backend->begin_draws(m_shadow_pipeline, m_edge_buffer, 0);
+        count_gl_call(GL_CALL_UNIFORM);
+        glUniform1f(m_angle_scale_uniform, 2.0f * PI / (float)m_shadow_resolution);
+        m_backend->draw_triangles(0, (int)m_vertices.size());
+        m_backend->end_draws();
+        glBlendEquation(GL_FUNC_ADD);
+        m_draw_calls++;
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)framebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+// ————— LIGHTS ————— //
+void LightingPass::apply(glm::vec2 view_min, glm::vec2 view_max)
+{
+    if (!is_enabled() || m_lights.empty()) return;
+
+    float positions[MAX_LIGHTS * 4], colours[MAX_LIGHTS * 3];
+    int count = (int)m_lights.size();
+    for (int i = 0; i < count; i++)
+    {
+        const Light& light = m_lights[i];
+        positions[i * 4 + 0] = light.position.x;
+        positions[i * 4 + 1] = light.position.y;
+        positions[i * 4 + 2] = light.radius;
+        positions[i * 4 + 3] = 0.0f;
+        colours[i * 3 + 0] = light.colour.r;
+        colours[i * 3 + 1] = light.colour.g;
+        colours[i * 3 + 2] = light.colour.b;
+    }
+
+    // source * destination + destination * source: twice the scene at most, and 0.5 is no change
+    glBlendFunc(GL_DST_COLOR, GL_SRC_COLOR);
+    m_backend->begin_draws(m_light_pipeline, m_triangle_buffer, 0);
+
+    count_gl_call(GL_CALL_UNIFORM, 6);
+    glUniform2f(m_view_min_uniform, view_min.x, view_min.y);
+    glUniform2f(m_view_max_uniform, view_max.x, view_max.y);
+    glUniform4fv(m_lights_uniform, count, positions);
+    glUniform3fv(m_colours_uniform, count, colours);
+    glUniform1i(m_light_count_uniform, count);
+    glUniform1f(m_shadow_scale_uniform, (float)m_shadow_resolution / (float)MAX_SHADOW_RESOLUTION);
+    m_backend->bind_texture(GL_TEXTURE_2D, m_shadow_map.get_texture_id());
+
+    m_backend->draw_triangles(0, 3);
+    m_backend->end_draws();
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_draw_calls++;
+}
+
+void LightingPass::warm_up(PipelineWarmup& warmup)
+{
+    if (!is_enabled()) return;
+
+    warmup.warm_up(m_shadow_pipeline);
+    warmup.warm_up(m_light_pipeline);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// 2D lights that the platforms cast shadows from: the lander's lamp and its flame, and the other
+// landers' lamps. Every light gets a 1D polar shadow map, a row of texels around it each holding
+// how far the nearest occluder is in that direction, and all of the rows are packed into one
+// target, a light to a row. An occluder goes in as the edges of its box that face each light, one
+// quad per edge over the angles it covers, and GL_MIN blending keeps the nearest; the fragment
+// shader finds the distance along its own texel's ray, so an edge never needs splitting up.
+//
+// The lights are then applied in a single full-screen pass over the world drawn so far, every
+// light in one loop, multiplied into the framebuffer at up to twice its brightness. How many
+// lights there are and how much of each row is used are QualityGovernor's to choose; the target
+// is allocated for the most of both, so a change only moves a viewport and a uniform.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "OffscreenTarget.h"
+#include "PipelineWarmup.h"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+
+struct Light
+{
+    glm::vec2 position;
+    float     radius;
+    glm::vec3 colour;  // added to the ambient at the centre, fading to nothing at the radius
+};
+
+class LightingPass
+{
+public:
+    static const int MAX_LIGHTS            = 16,
+                     MAX_SHADOW_RESOLUTION = 1024;  // texels around each light
+    static constexpr float AMBIENT = 0.6f;  // away from every light; 1.0 would leave the scene as drawn
+
+private:
+    struct ShadowVertex
+    {
+        glm::vec2 position;  // in the shadow map's clip space
+        glm::vec4 edge;      // both ends, from the light, in radii
+    };
+
+    OffscreenTarget m_shadow_map;  // MAX_SHADOW_RESOLUTION x MAX_LIGHTS
+    ShaderProgram   m_shadow_program,
+                    m_light_program;
+    Pipeline        m_shadow_pipeline,
+                    m_light_pipeline;
+    RenderBackend*  m_backend = NULL;
+    GLuint          m_triangle_buffer = 0,
+                    m_edge_buffer = 0;
+    size_t          m_edge_buffer_bytes = 0;
+
+    GLint m_angle_scale_uniform  = -1,
+          m_view_min_uniform     = -1,
+          m_view_max_uniform     = -1,
+          m_lights_uniform       = -1,
+          m_colours_uniform      = -1,
+          m_light_count_uniform  = -1,
+          m_shadow_scale_uniform = -1;
+
+    int m_max_lights        = MAX_LIGHTS,
+        m_shadow_resolution = MAX_SHADOW_RESOLUTION;
+
+    // This frame's
+    std::vector<Light>        m_lights;
+    std::vector<glm::vec4>    m_occluders;  // min in xy, max in zw
+    std::vector<ShadowVertex> m_vertices;
+    int m_edge_count = 0,
+        m_draw_calls = 0;
+
+    // `start` and `end` from the light, in radii
+    void add_edge(int row, glm::vec2 start, glm::vec2 end);
+    void add_quad(int row, float first_angle, float last_angle, glm::vec4 edge);
+
+public:
+    // GL thread. False, with nothing allocated, without framebuffer objects or min blending.
+    bool initialise();
+    void cleanup();
+
+    // QualityGovernor's: lights past the count are dropped, and each row uses this many texels
+    void set_limits(int light_count, int shadow_resolution);
+
+    // Once a frame, before anything is added
+    void begin_frame();
+    // Most important first, since the ones past the limit are the ones dropped; false for those
+    bool add_light(glm::vec2 position, float radius, glm::vec3 colour);
+    void add_occluder(glm::vec2 min, glm::vec2 max);
+    // Everything the lights reach, so only occluders in there need adding; false with no lights
+    bool get_light_bounds(glm::vec2& min, glm::vec2& max) const;
+
+    // After the occluders are in. Leaves the framebuffer and the viewport as it found them.
+    void render_shadow_maps();
+    // Over the world drawn so far, in the current viewport, which shows [view_min, view_max]. Can
+    // run again for another view of the same frame without redrawing the shadow maps.
+    void apply(glm::vec2 view_min, glm::vec2 view_max);
+
+    void warm_up(PipelineWarmup& warmup);
+
+    bool const is_enabled()            const { return m_shadow_map.is_ready(); };
+    int  const get_light_count()       const { return (int)m_lights.size(); };
+    int  const get_max_lights()        const { return m_max_lights; };
+    int  const get_shadow_resolution() const { return m_shadow_resolution; };
+    int  const get_edge_count()        const { return m_edge_count; };
+    int  const get_draw_calls()        const { return m_draw_calls; };
+};
@@ -0,0 +1,104 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <chrono>
+#include "LoadingSequence.h"
+
+void LoadingSequence::add_step(const char* name, float weight, std::function<void()> work)
+{
+    m_steps.push_back({ name, weight, false, std::move(work), nullptr });
+    m_total_weight += weight;
+}
+
+void LoadingSequence::add_background_step(const char* name, float weight, std::function<unsigned long long()> job)
+{
+    m_steps.push_back({ name, weight, true, nullptr, std::move(job) });
+    m_total_weight += weight;
+}
+
+bool LoadingSequence::poll_background()
+{
+    for (size_t i = 0; i < m_running.size();)
+    {
+        if (m_running[i].result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            i++;
+            continue;
+        }
+
+        const Step& step = m_steps[m_running[i].step];
+        BackgroundResult result = m_running[i].result.get();
+
+        if (m_profiler != NULL) m_profiler->add_phase(step.name.c_str(), result.seconds, result.bytes);
+        m_done_weight += step.weight;
+
+        m_running.erase(m_running.begin() + i);
+    }
+
+    return m_running.empty();
+}
+
+bool LoadingSequence::run(float budget_seconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point started = Clock::now();
+
+    while (m_next_step < (int)m_steps.size())
+    {
+        Step& step = m_steps[m_next_step];
+
+        // STEP 1: Background steps only need starting, so the sequence moves straight on
+        if (step.background)
+        {
+            std::function<unsigned long long()> job = step.job;
+            m_running.push_back({ m_next_step, std::async(std::launch::async, [job]()
+                {
+                    Clock::time_point job_started = Clock::now();
+                    unsigned long long bytes = job();
+                    return BackgroundResult{ std::chrono::duration<double>(Clock::now() - job_started).count(), bytes };
+                }) });
+
+            m_next_step++;
+            continue;
+        }
+
+        // STEP 2: A main-thread step may depend on anything queued before it, so it waits for the
+        //         background to drain. The frame goes out in the meantime.
+        if (!poll_background()) break;
+
+        if (m_profiler != NULL)
+        {
+            StartupProfiler::Scope phase(*m_profiler, step.name.c_str());
+            step.work();
+        }
+        else step.work();
+        m_done_weight += step.weight;
+        m_next_step++;
+
+        if (std::chrono::duration<float>(Clock::now() - started).count() >= budget_seconds) break;
+    }
+
+    poll_background();
+    return is_finished();
+}
+
+void LoadingSequence::wait()
+{
+    for (RunningStep& running : m_running) running.result.wait();
+    poll_background();
+}
+
+const char* LoadingSequence::get_current_step_name() const
+{
+    if (!m_running.empty())                return m_steps[m_running.front().step].name.c_str();
+    if (m_next_step < (int)m_steps.size()) return m_steps[m_next_step].name.c_str();
+    return "";
+}
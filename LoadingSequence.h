@@ -0,0 +1,75 @@
+#pragma once
+
+// Startup split into steps that are worked through a little every frame, so a loading screen can
+// keep presenting while the rest comes in. Main-thread steps are for anything that needs the GL
+// context. Background steps run on their own thread from the moment the sequence reaches them,
+// alongside whatever comes next, and every main-thread step waits for all the background steps
+// queued before it, which is how a step says it needs their results.
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+#include "StartupProfiler.h"
+
+class LoadingSequence
+{
+private:
+    struct Step
+    {
+        std::string                         name;
+        float                               weight;      // share of the progress bar
+        bool                                background;
+        std::function<void()>               work;        // main-thread steps
+        std::function<unsigned long long()> job;         // background steps return the bytes they read
+    };
+
+    struct BackgroundResult
+    {
+        double             seconds;
+        unsigned long long bytes;
+    };
+
+    struct RunningStep
+    {
+        int                           step;
+        std::future<BackgroundResult> result;
+    };
+
+    std::vector<Step>        m_steps;
+    std::vector<RunningStep> m_running;
+    int              m_next_step = 0;
+    float            m_total_weight = 0.0f,
+                     m_done_weight  = 0.0f;
+    StartupProfiler* m_profiler = NULL;
+
+    // Collects whatever background steps have finished; true once none are left running
+    bool poll_background();
+
+public:
+    LoadingSequence() = default;
+    LoadingSequence(const LoadingSequence&) = delete;
+    LoadingSequence& operator=(const LoadingSequence&) = delete;
+    ~LoadingSequence() { wait(); }
+
+    // Every step becomes a phase in the profiler's report
+    void set_profiler(StartupProfiler* profiler) { m_profiler = profiler; };
+
+    void add_step(const char* name, float weight, std::function<void()> work);
+
+    // The job must not touch GL or the profiler, and nothing else may touch what it writes until
+    // the next main-thread step
+    void add_background_step(const char* name, float weight, std::function<unsigned long long()> job);
+
+    // GL thread, once a frame. Starts and runs steps until budget_seconds have gone by, and always
+    // at least one main-thread step when nothing is holding it up. Returns is_finished().
+    bool run(float budget_seconds);
+
+    // Blocks until the background steps already started are done, e.g. when quitting mid-load
+    void wait();
+
+    bool  const is_finished()  const { return m_next_step == (int)m_steps.size() && m_running.empty(); };
+    float const get_progress() const { return m_total_weight > 0.0f ? m_done_weight / m_total_weight : 1.0f; };
+
+    // The step that will run next, or the first one still running in the background
+    const char* get_current_step_name() const;
+};
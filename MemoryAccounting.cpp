@@ -0,0 +1,178 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include "MemoryAccounting.h"
+
+static const char* const TAG_NAMES[MEMORY_TAG_COUNT] = { "untagged", "entities", "render", "text", "audio", "assets" };
+
+// ————— CPU ————— //
+// Every thread allocates, so these are atomic; relaxed, as AllocationCounter's, since they only
+// ever feed reports
+static thread_local MemoryTag t_memory_tag = MEMORY_UNTAGGED;
+static std::atomic<long long> g_cpu_bytes[MEMORY_TAG_COUNT],
+                              g_cpu_peak[MEMORY_TAG_COUNT];
+
+MemoryScope::MemoryScope(MemoryTag tag) : m_previous(t_memory_tag)
+{
+    t_memory_tag = tag;
+}
+
+MemoryScope::~MemoryScope()
+{
+    t_memory_tag = m_previous;
+}
+
+MemoryTag get_memory_tag()
+{
+    return t_memory_tag;
+}
+
+void add_cpu_memory(MemoryTag tag, long long bytes)
+{
+    long long live = g_cpu_bytes[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes <= 0) return;
+
+    long long peak = g_cpu_peak[tag].load(std::memory_order_relaxed);
+    while (live > peak && !g_cpu_peak[tag].compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+// ————— GPU ————— //
+struct GpuStore
+{
+    long long bytes;
+    MemoryTag tag;
+};
+
+// One map per kind of object, since GL names them separately
+static std::unordered_map<unsigned int, GpuStore> g_gpu_buffers,
+                                                  g_gpu_textures,
+                                                  g_gpu_renderbuffers;
+static long long g_gpu_bytes[MEMORY_TAG_COUNT] = {},
+                 g_gpu_peak[MEMORY_TAG_COUNT]  = {};
+
+static void track_store(std::unordered_map<unsigned int, GpuStore>& stores, unsigned int name, long long bytes)
+{
+    if (name == 0) return;
+
+    auto found = stores.find(name);
+    if (found == stores.end()) found = stores.emplace(name, GpuStore { 0, t_memory_tag }).first;
+
+    GpuStore& store = found->second;
+    g_gpu_bytes[store.tag] += bytes - store.bytes;
+    store.bytes = bytes;
+    if (g_gpu_bytes[store.tag] > g_gpu_peak[store.tag]) g_gpu_peak[store.tag] = g_gpu_bytes[store.tag];
+}
+
+static void untrack_stores(std::unordered_map<unsigned int, GpuStore>& stores, int count, const unsigned int* names)
+{
+    for (int i = 0; i < count; i++)
+    {
+        auto found = stores.find(names[i]);
+        if (found == stores.end()) continue;
+
+        g_gpu_bytes[found->second.tag] -= found->second.bytes;
+        stores.erase(found);
+    }
+}
+
+void track_gpu_buffer(unsigned int buffer, long long bytes)                        { track_store(g_gpu_buffers, buffer, bytes); }
+void track_gpu_texture(unsigned int texture, long long bytes)                      { track_store(g_gpu_textures, texture, bytes); }
+void track_gpu_renderbuffer(unsigned int renderbuffer, long long bytes)            { track_store(g_gpu_renderbuffers, renderbuffer, bytes); }
+void untrack_gpu_buffers(int count, const unsigned int* buffers)                   { untrack_stores(g_gpu_buffers, count, buffers); }
+void untrack_gpu_textures(int count, const unsigned int* textures)                 { untrack_stores(g_gpu_textures, count, textures); }
+void untrack_gpu_renderbuffers(int count, const unsigned int* renderbuffers)       { untrack_stores(g_gpu_renderbuffers, count, renderbuffers); }
+
+long long get_gpu_texture_bytes(unsigned int texture)
+{
+    auto found = g_gpu_textures.find(texture);
+    return found != g_gpu_textures.end() ? found->second.bytes : 0;
+}
+
+// ————— TOTALS AND BUDGETS ————— //
+static long long g_cpu_budgets[MEMORY_TAG_COUNT] = {},
+                 g_gpu_budgets[MEMORY_TAG_COUNT] = {};
+static bool      g_over_budget[MEMORY_TAG_COUNT] = {};
+
+MemoryUsage get_memory_usage(MemoryTag tag)
+{
+    return { g_cpu_bytes[tag].load(std::memory_order_relaxed), g_cpu_peak[tag].load(std::memory_order_relaxed), g_gpu_bytes[tag], g_gpu_peak[tag] };
+}
+
+const char* get_memory_tag_name(MemoryTag tag)
+{
+    return TAG_NAMES[tag];
+}
+
+void set_memory_budget(MemoryTag tag, long long cpu_bytes, long long gpu_bytes)
+{
+    g_cpu_budgets[tag] = cpu_bytes;
+    g_gpu_budgets[tag] = gpu_bytes;
+    g_over_budget[tag] = false;
+}
+
+bool parse_memory_budget(std::string_view text)
+{
+    size_t equals = text.find('=');
+    if (equals == std::string_view::npos) return false;
+
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+    {
+        if (text.substr(0, equals) != TAG_NAMES[tag]) continue;
+
+        double cpu_mb = 0.0, gpu_mb = 0.0;
+        std::string numbers(text.substr(equals + 1));
+        if (std::sscanf(numbers.c_str(), "%lf,%lf", &cpu_mb, &gpu_mb) < 1) return false;
+
+        set_memory_budget((MemoryTag)tag, (long long)(cpu_mb * 1024.0 * 1024.0), (long long)(gpu_mb * 1024.0 * 1024.0));
+        return true;
+    }
+    return false;
+}
+
+long long get_cpu_budget(MemoryTag tag) { return g_cpu_budgets[tag]; }
+long long get_gpu_budget(MemoryTag tag) { return g_gpu_budgets[tag]; }
+
+unsigned int check_memory_budgets()
+{
+    unsigned int crossed = 0;
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+    {
+        MemoryUsage usage = get_memory_usage((MemoryTag)tag);
+        bool over = (g_cpu_budgets[tag] > 0 && usage.cpu_bytes > g_cpu_budgets[tag]) ||
+                    (g_gpu_budgets[tag] > 0 && usage.gpu_bytes > g_gpu_budgets[tag]);
+
+        if (over && !g_over_budget[tag]) crossed |= 1u << tag;
+        g_over_budget[tag] = over;
+    }
+    return crossed;
+}
+
+bool write_memory_report(const char* filepath)
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    file << "{\n  \"tags\": {\n";
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+    {
+        MemoryUsage usage = get_memory_usage((MemoryTag)tag);
+        file << "    \"" << TAG_NAMES[tag] << "\": { \"cpu\": " << usage.cpu_bytes << ", \"cpu_peak\": " << usage.cpu_peak
+             << ", \"cpu_budget\": " << g_cpu_budgets[tag] << ", \"gpu\": " << usage.gpu_bytes << ", \"gpu_peak\": " << usage.gpu_peak
+             << ", \"gpu_budget\": " << g_gpu_budgets[tag] << " }" << (tag + 1 < MEMORY_TAG_COUNT ? ",\n" : "\n");
+    }
+    file << "  }\n}\n";
+
+    return (bool)file;
+}
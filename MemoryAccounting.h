@@ -0,0 +1,86 @@
+#pragma once
+
+// What each part of the game holds in memory, for the boards with 512 MB to share between CPU and
+// GPU. CPU bytes come from AllocationCounter's operator new, which charges every allocation to the
+// tag of the MemoryScope its thread is in and gives it back to the same tag when it's freed.
+// GPU bytes are estimated: every buffer and texture store is reported as it's specified, by the
+// code next to the GL call, and dropped when the object is deleted.
+//
+// Each tag can have a budget; check_memory_budgets says which went over since it last looked, so
+// the caller warns once per crossing rather than once a frame.
+#include <string_view>
+
+enum MemoryTag
+{
+    MEMORY_UNTAGGED,  // anything outside a scope: SDL, the driver's own allocations through new, startup
+    MEMORY_ENTITIES,  // levels, platforms, landers and the simulation
+    MEMORY_RENDER,    // shaders, batches, instance buffers, render targets
+    MEMORY_TEXT,      // fonts, glyph caches and text meshes
+    MEMORY_AUDIO,
+    MEMORY_ASSETS,    // the asset pack, decoded images and the textures made from them
+    MEMORY_TAG_COUNT
+};
+
+struct MemoryUsage
+{
+    long long cpu_bytes, cpu_peak,
+              gpu_bytes, gpu_peak;
+};
+
+// Charges this thread's allocations to `tag` until it goes out of scope, then to whatever was
+// charged before
+class MemoryScope
+{
+private:
+    MemoryTag m_previous;
+
+public:
+    explicit MemoryScope(MemoryTag tag);
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+MemoryTag get_memory_tag();
+
+// From the allocation functions, on any thread; `bytes` is negative for a free
+void add_cpu_memory(MemoryTag tag, long long bytes);
+
+// GL thread. Specifying a store again replaces its size but keeps the tag it was first made
+// under, so a buffer filled each frame stays charged to whoever created it.
+void track_gpu_buffer(unsigned int buffer, long long bytes);
+void track_gpu_texture(unsigned int texture, long long bytes);
+void track_gpu_renderbuffer(unsigned int renderbuffer, long long bytes);
+void untrack_gpu_buffers(int count, const unsigned int* buffers);
+void untrack_gpu_textures(int count, const unsigned int* textures);
+void untrack_gpu_renderbuffers(int count, const unsigned int* renderbuffers);
+
+// What a texture's store was last reported as; 0 if it isn't tracked
+long long get_gpu_texture_bytes(unsigned int texture);
+
+// RGBA8 with or without a full mip chain, as most of the game's textures are
+inline long long estimate_texture_bytes(int width, int height, bool mipmapped = false)
+{
+    long long bytes = 4LL * width * height;
+    return mipmapped ? bytes * 4 / 3 : bytes;
+}
+
+MemoryUsage get_memory_usage(MemoryTag tag);
+const char* get_memory_tag_name(MemoryTag tag);
+
+// 0 for no budget on that side
+void set_memory_budget(MemoryTag tag, long long cpu_bytes, long long gpu_bytes);
+
+// "assets=64" or "assets=64,96": a tag's CPU and optionally GPU budget in MB. False, changing
+// nothing, for an unknown tag or no number.
+bool parse_memory_budget(std::string_view text);
+long long get_cpu_budget(MemoryTag tag);
+long long get_gpu_budget(MemoryTag tag);
+
+// Bit (1 << tag) for every tag that went over its budget since the last call; a tag has to drop
+// back under before it's reported again
+unsigned int check_memory_budgets();
+
+// Every tag's live and peak bytes and its budgets, as JSON
+bool write_memory_report(const char* filepath);
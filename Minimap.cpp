@@ -0,0 +1,419 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "glm/gtc/matrix_transform.hpp"
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "Minimap.h"
+
+static const glm::vec4 BACKGROUND_COLOUR = glm::vec4(0.0f, 0.0f, 0.0f, 0.5f),
+                       GROUND_COLOUR     = glm::vec4(0.45f, 0.45f, 0.5f, 1.0f),
+                       PAD_COLOUR        = glm::vec4(0.3f, 0.9f, 0.4f, 1.0f),
+                       DEATH_COLOUR      = glm::vec4(0.8f, 0.35f, 0.3f, 1.0f);
+
+static const int QUAD_FLOATS = 6 * 4;  // the map quad: six corners of x, y, u, v
+
+bool Minimap::initialise(ShaderVariants* shaders, int width, int height)
+{
+    if (!m_target.initialise(width, height, true)) return false;
+
+    m_shaders = shaders;
+    m_map_program = shaders->get(SHADER_TEXTURED);
+    m_marker_program = shaders->get(SHADER_VERTEX_COLOUR);
+
+    glGenBuffers(1, &m_static_buffer);
+    glGenBuffers(1, &m_frame_buffer);
+    if (supports_vertex_arrays()) glGenVertexArrays(1, &m_vertex_array);
+
+    m_tile_dirty.assign(TILE_COUNT * TILE_COUNT, 0);
+    m_dirty_tiles.clear();
+    m_drawn_version = -1;
+    m_invalid = true;
+    return true;
+}
+
+void Minimap::cleanup()
+{
+    if (m_vertex_array != 0)  glDeleteVertexArrays(1, &m_vertex_array);
+    if (m_static_buffer != 0) glDeleteBuffers(1, &m_static_buffer);
+    if (m_frame_buffer != 0)  glDeleteBuffers(1, &m_frame_buffer);
+    untrack_gpu_buffers(1, &m_static_buffer);
+    untrack_gpu_buffers(1, &m_frame_buffer);
+    m_vertex_array = m_static_buffer = m_frame_buffer = 0;
+    m_target.cleanup();
+
+    m_vertices.clear();
+    m_markers.clear();
+    m_tile_dirty.clear();
+    m_dirty_tiles.clear();
+    m_drawn_version = -1;
+}
+
+void Minimap::add_quad(std::vector<MapVertex>& vertices, glm::vec2 min, glm::vec2 max, glm::vec4 colour)
+{
+    MapVertex vertex;
+    for (int i = 0; i < 4; i++) vertex.colour[i] = (unsigned char)(std::clamp(colour[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+    const glm::vec2 corners[6] = { min, glm::vec2(max.x, min.y), max, min, max, glm::vec2(min.x, max.y) };
+    for (glm::vec2 corner : corners)
+    {
+        vertex.position = corner;
+        vertices.push_back(vertex);
+    }
+}
+
+void Minimap::add_ground(const Terrain* terrain, float min_x, float max_x)
+{
+    if (terrain == NULL || terrain->get_sample_count() < 2) return;
+
+    // Clamped as floats, so an unbounded range can't overflow the conversion
+    const float* heights = terrain->get_heights();
+    float spacing   = terrain->get_spacing(),
+          origin    = terrain->get_origin_x(),
+          last_segment = (float)(terrain->get_sample_count() - 2);
+    int first = (int)std::clamp(floorf((min_x - origin) / spacing), 0.0f, last_segment),
+        last  = (int)std::clamp(floorf((max_x - origin) / spacing), -1.0f, last_segment);
+
+    for (int segment = first; segment <= last; segment++)
+    {
+        float x = origin + segment * spacing;
+        add_quad(m_vertices, glm::vec2(x, m_world_min.y), glm::vec2(x + spacing, std::max(heights[segment], heights[segment + 1])),
+                 terrain->is_pad(segment) ? PAD_COLOUR : GROUND_COLOUR);
+    }
+}
+
+// Every platform that stays put. Pads are left for the markers, which show them whatever the
+// map's resolution.
+void Minimap::add_platform(const Entity& platform)
+{
+    if (!platform.is_active() || platform.get_body_type() != STATIC_BODY || platform.get_entity_type() == WIN_PLATFORM) return;
+
+    glm::vec2 centre = glm::vec2(platform.get_position()),
+              extent = glm::vec2(platform.get_width(), platform.get_height()) * 0.5f;
+    add_quad(m_vertices, centre - extent, centre + extent, DEATH_COLOUR);
+}
+
+void Minimap::fit_bounds(const Entity* platforms, int platform_count, const Terrain* terrain)
+{
+    // STEP 1: Everything that can appear on the map, moving platforms included
+    glm::vec2 world_min = glm::vec2(INFINITY),
+              world_max = glm::vec2(-INFINITY);
+    for (int i = 0; i < platform_count; i++)
+    {
+        glm::vec2 centre = glm::vec2(platforms[i].get_position()),
+                  extent = glm::vec2(platforms[i].get_width(), platforms[i].get_height()) * 0.5f;
+        world_min = glm::min(world_min, centre - extent);
+        world_max = glm::max(world_max, centre + extent);
+    }
+    if (terrain != NULL && terrain->get_sample_count() > 1)
+    {
+        const float* heights = terrain->get_heights();
+        int count = terrain->get_sample_count();
+        world_min.x = std::min(world_min.x, terrain->get_origin_x());
+        world_max.x = std::max(world_max.x, terrain->get_origin_x() + (count - 1) * terrain->get_spacing());
+        for (int i = 0; i < count; i++)
+        {
+            world_min.y = std::min(world_min.y, heights[i]);
+            world_max.y = std::max(world_max.y, heights[i]);
+        }
+    }
+    if (!(world_min.x <= world_max.x)) world_min = world_max = glm::vec2(0.0f);
+
+    world_min -= glm::vec2(MARGIN);
+    world_max += glm::vec2(MARGIN);
+
+    // STEP 2: Grown along the short side to the texture's aspect, so nothing on the map is stretched
+    float aspect = (float)m_target.get_width() / (float)m_target.get_height();
+    glm::vec2 size = world_max - world_min,
+              centre = (world_min + world_max) * 0.5f;
+    if (size.x < size.y * aspect) size.x = size.y * aspect;
+    else                          size.y = size.x / aspect;
+
+    m_world_min = centre - size * 0.5f;
+    m_world_max = centre + size * 0.5f;
+}
+
+void Minimap::bind_colour_vertices(size_t offset)
+{
+    GLint position = m_marker_program->get_position_attribute(),
+          colour   = m_marker_program->get_vertex_colour_attribute();
+    glVertexAttribPointer(position, 2, GL_FLOAT, false, sizeof(MapVertex), (void*)(offset + offsetof(MapVertex, position)));
+    glEnableVertexAttribArray(position);
+    glVertexAttribPointer(colour, 4, GL_UNSIGNED_BYTE, true, sizeof(MapVertex), (void*)(offset + offsetof(MapVertex, colour)));
+    glEnableVertexAttribArray(colour);
+}
+
+void Minimap::get_tile_texels(int tile, int& x, int& y, int& width, int& height) const
+{
+    int column = tile % TILE_COUNT,
+        row    = tile / TILE_COUNT;
+    x = column * m_target.get_width() / TILE_COUNT;
+    y = row * m_target.get_height() / TILE_COUNT;
+    width  = (column + 1) * m_target.get_width() / TILE_COUNT - x;
+    height = (row + 1) * m_target.get_height() / TILE_COUNT - y;
+}
+
+void Minimap::redraw(const Entity* platforms, int platform_count, const Terrain* terrain)
+{
+    fit_bounds(platforms, platform_count, terrain);
+
+    m_vertices.clear();
+    add_ground(terrain, -INFINITY, INFINITY);
+    for (int i = 0; i < platform_count; i++) add_platform(platforms[i]);
+
+    draw_static(NULL);
+    m_redraws++;
+}
+
+void Minimap::redraw_tiles(const Entity* platforms, int platform_count, const Terrain* terrain, const PlatformBroadphase* broadphase)
+{
+    // STEP 1: The world the dirty tiles cover, as texels back onto the map
+    glm::vec2 world_size = m_world_max - m_world_min,
+              texture_size = glm::vec2((float)m_target.get_width(), (float)m_target.get_height()),
+              min = glm::vec2(INFINITY),
+              max = glm::vec2(-INFINITY);
+    for (int tile : m_dirty_tiles)
+    {
+        int x, y, width, height;
+        get_tile_texels(tile, x, y, width, height);
+        min = glm::min(min, m_world_min + glm::vec2((float)x, (float)y) / texture_size * world_size);
+        max = glm::max(max, m_world_min + glm::vec2((float)(x + width), (float)(y + height)) / texture_size * world_size);
+    }
+
+    // STEP 2: Only what reaches into it; the scissor trims whatever spills into clean tiles
+    m_vertices.clear();
+    add_ground(terrain, min.x, max.x);
+    if (broadphase != NULL)
+    {
+        int cursor = -1;
+        broadphase->query(min, max, m_candidates, cursor);
+        for (int i : m_candidates) add_platform(platforms[i]);
+    }
+    else
+    {
+        for (int i = 0; i < platform_count; i++)
+        {
+            glm::vec2 centre = glm::vec2(platforms[i].get_position()),
+                      extent = glm::vec2(platforms[i].get_width(), platforms[i].get_height()) * 0.5f;
+            if (centre.x + extent.x < min.x || centre.x - extent.x > max.x || centre.y + extent.y < min.y || centre.y - extent.y > max.y) continue;
+            add_platform(platforms[i]);
+        }
+    }
+
+    draw_static(&m_dirty_tiles);
+
+    m_tile_redraws += (long long)m_dirty_tiles.size();
+    for (int tile : m_dirty_tiles) m_tile_dirty[tile] = 0;
+    m_dirty_tiles.clear();
+}
+
+void Minimap::draw_static(const std::vector<int>* tiles)
+{
+    // Under a camera that fits the level to the texture. The variants share one camera, so the
+    // game's goes back afterwards, as does the viewport.
+    GLint viewport[4];
+    GLfloat clear_colour[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clear_colour);
+
+    m_target.bind();
+    glViewport(0, 0, m_target.get_width(), m_target.get_height());
+    glClearColor(BACKGROUND_COLOUR.r, BACKGROUND_COLOUR.g, BACKGROUND_COLOUR.b, BACKGROUND_COLOUR.a);
+
+    glm::mat4 projection_matrix = m_shaders->get_projection_matrix(),
+              view_matrix       = m_shaders->get_view_matrix();
+    if (!m_vertices.empty())
+    {
+        m_shaders->set_camera(glm::ortho(m_world_min.x, m_world_max.x, m_world_min.y, m_world_max.y, -1.0f, 1.0f), glm::mat4(1.0f));
+
+        m_marker_program->use();
+        m_marker_program->set_model_transform(ModelTransform());
+
+        count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+        if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);
+        glBindBuffer(GL_ARRAY_BUFFER, m_static_buffer);
+        count_gl_call(GL_CALL_UPLOAD);
+        glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(MapVertex), m_vertices.data(), GL_STATIC_DRAW);
+        track_gpu_buffer(m_static_buffer, (long long)(m_vertices.size() * sizeof(MapVertex)));
+        bind_colour_vertices(0);
+    }
+
+    // Once for the whole texture, or once a tile with the scissor around it
+    int passes = tiles != NULL ? (int)tiles->size() : 1;
+    if (tiles != NULL) glEnable(GL_SCISSOR_TEST);
+    for (int pass = 0; pass < passes; pass++)
+    {
+        if (tiles != NULL)
+        {
+            int x, y, width, height;
+            get_tile_texels((*tiles)[pass], x, y, width, height);
+            glScissor(x, y, width, height);
+        }
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        if (m_vertices.empty()) continue;
+        count_gl_call(GL_CALL_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_vertices.size());
+    }
+    if (tiles != NULL) glDisable(GL_SCISSOR_TEST);
+
+    if (!m_vertices.empty())
+    {
+        count_gl_call(GL_CALL_BIND);
+        glDisableVertexAttribArray(m_marker_program->get_vertex_colour_attribute());
+        glDisableVertexAttribArray(m_marker_program->get_position_attribute());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        if (m_vertex_array != 0) glBindVertexArray(0);
+
+        m_shaders->set_camera(projection_matrix, view_matrix);
+    }
+
+    m_target.unbind();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glClearColor(clear_colour[0], clear_colour[1], clear_colour[2], clear_colour[3]);
+}
+
+void Minimap::update(const Entity* platforms, int platform_count, const Terrain* terrain, int colliders_version,
+                     const PlatformBroadphase* broadphase)
+{
+    if (!m_target.is_ready()) return;
+
+    if (m_invalid || colliders_version != m_drawn_version)
+    {
+        redraw(platforms, platform_count, terrain);
+        m_drawn_version = colliders_version;
+        m_invalid = false;
+
+        for (int tile : m_dirty_tiles) m_tile_dirty[tile] = 0;
+        m_dirty_tiles.clear();
+    }
+    else if (!m_dirty_tiles.empty()) redraw_tiles(platforms, platform_count, terrain, broadphase);
+}
+
+void Minimap::invalidate_region(glm::vec2 min, glm::vec2 max)
+{
+    // Nothing drawn to patch, or a full redraw coming anyway
+    if (!m_target.is_ready() || m_drawn_version < 0 || m_invalid) return;
+
+    if (min.x < m_world_min.x || min.y < m_world_min.y || max.x > m_world_max.x || max.y > m_world_max.y)
+    {
+        m_invalid = true;
+        return;
+    }
+
+    // A texel over, since the tiles' edges are rounded to texels
+    glm::vec2 texel = (m_world_max - m_world_min) / glm::vec2((float)m_target.get_width(), (float)m_target.get_height());
+    min -= texel;
+    max += texel;
+
+    glm::vec2 scale = (float)TILE_COUNT / (m_world_max - m_world_min);
+    glm::ivec2 first = glm::clamp(glm::ivec2(glm::floor((min - m_world_min) * scale)), 0, TILE_COUNT - 1),
+               last  = glm::clamp(glm::ivec2(glm::floor((max - m_world_min) * scale)), 0, TILE_COUNT - 1);
+    for (int row = first.y; row <= last.y; row++)
+    {
+        for (int column = first.x; column <= last.x; column++)
+        {
+            int tile = row * TILE_COUNT + column;
+            if (m_tile_dirty[tile]) continue;
+            m_tile_dirty[tile] = 1;
+            m_dirty_tiles.push_back(tile);
+        }
+    }
+}
+
+void Minimap::add_marker(glm::vec2 world_position, glm::vec4 colour, float half_size)
+{
+    m_markers.push_back({ world_position, half_size, colour });
+}
+
+void Minimap::draw(glm::vec2 hud_min, glm::vec2 hud_max)
+{
+    m_draw_calls = 0;
+    if (!m_target.is_ready() || m_drawn_version < 0)
+    {
+        m_markers.clear();
+        return;
+    }
+
+    // STEP 1: The map quad, then the markers moved from the level onto it, in one upload. The
+    //         texture's rows run bottom up, so v does too.
+    const float quad[QUAD_FLOATS] = {
+        hud_min.x, hud_min.y, 0.0f, 0.0f,   hud_max.x, hud_min.y, 1.0f, 0.0f,   hud_max.x, hud_max.y, 1.0f, 1.0f,
+        hud_min.x, hud_min.y, 0.0f, 0.0f,   hud_max.x, hud_max.y, 1.0f, 1.0f,   hud_min.x, hud_max.y, 0.0f, 1.0f,
+    };
+
+    glm::vec2 scale = (hud_max - hud_min) / (m_world_max - m_world_min);
+    m_vertices.clear();
+    for (const Marker& marker : m_markers)
+    {
+        glm::vec2 centre = hud_min + (marker.position - m_world_min) * scale;
+        if (centre.x < hud_min.x || centre.x > hud_max.x || centre.y < hud_min.y || centre.y > hud_max.y) continue;
+        add_quad(m_vertices, centre - glm::vec2(marker.half_size), centre + glm::vec2(marker.half_size), marker.colour);
+    }
+    m_markers.clear();
+
+    size_t quad_bytes   = sizeof(quad),
+           marker_bytes = m_vertices.size() * sizeof(MapVertex);
+
+    count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+    if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_frame_buffer);
+    count_gl_call(GL_CALL_UPLOAD, 2);
+    glBufferData(GL_ARRAY_BUFFER, quad_bytes + marker_bytes, NULL, GL_STREAM_DRAW);
+    track_gpu_buffer(m_frame_buffer, (long long)(quad_bytes + marker_bytes));
+    glBufferSubData(GL_ARRAY_BUFFER, 0, quad_bytes, quad);
+    if (marker_bytes > 0)
+    {
+        count_gl_call(GL_CALL_UPLOAD);
+        glBufferSubData(GL_ARRAY_BUFFER, quad_bytes, marker_bytes, m_vertices.data());
+    }
+
+    // STEP 2: The kept map, however much of the level it shows
+    m_map_program->use();
+    m_map_program->set_model_transform(ModelTransform());
+    GLuint position = m_map_program->get_position_attribute(),
+           tex_coordinate = m_map_program->get_tex_coordinate_attribute();
+    glVertexAttribPointer(position, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(position);
+    glVertexAttribPointer(tex_coordinate, 2, GL_FLOAT, false, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(tex_coordinate);
+
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(GL_TEXTURE_2D, m_target.get_texture_id());
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    m_draw_calls++;
+    glDisableVertexAttribArray(tex_coordinate);
+    glDisableVertexAttribArray(position);
+
+    // STEP 3: Every marker in one more
+    if (!m_vertices.empty())
+    {
+        m_marker_program->use();
+        m_marker_program->set_model_transform(ModelTransform());
+        bind_colour_vertices(quad_bytes);
+
+        count_gl_call(GL_CALL_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_vertices.size());
+        m_draw_calls++;
+        glDisableVertexAttribArray(m_marker_program->get_vertex_colour_attribute());
+        glDisableVertexAttribArray(m_marker_program->get_position_attribute());
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0) glBindVertexArray(0);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// The whole level, small, in a corner of the HUD. What doesn't move (the ground and the static
+// platforms) is drawn once into a low-resolution texture and kept; every frame only draws that
+// texture as one quad and a marker for each thing that does move or matters (landers, target pads,
+// moving platforms), two draws however big the level is.
+//
+// The texture is redrawn only when the static geometry changes, which the level's
+// PlatformColliders version tells: it's bumped when a level is built and when streaming replaces
+// chunks. A change that doesn't rebuild the colliders (a rock destroyed in place, say) goes
+// through invalidate(). One that only touches a small area (a platform the level editor moved)
+// goes through invalidate_region(), which marks the tiles of the texture it covers (TILE_COUNT
+// along each side); the next update() redraws just those, from the platforms the broadphase has
+// there. The
+// map keeps the texture's aspect, so the level's longer side fills it.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+#include "OffscreenTarget.h"
+#include "PlatformBroadphase.h"
+#include "ShaderVariants.h"
+#include "Terrain.h"
+
+class Minimap
+{
+public:
+    static const int TILE_COUNT = 8;  // along each side of the texture
+
+private:
+    static constexpr float MARGIN = 0.5f;  // world units of space around the level
+
+    struct MapVertex
+    {
+        glm::vec2     position;
+        unsigned char colour[4];
+    };
+
+    struct Marker
+    {
+        glm::vec2 position;   // world
+        float     half_size;  // HUD
+        glm::vec4 colour;
+    };
+
+    OffscreenTarget m_target;
+    ShaderVariants* m_shaders = NULL;
+    ShaderProgram*  m_map_program    = NULL,  // textured, for the kept map
+                  * m_marker_program = NULL;  // per-vertex colour, for the static geometry and the markers
+
+    GLuint m_static_buffer = 0,  // the static geometry, as drawn into the target
+           m_frame_buffer  = 0,  // the map quad and this frame's markers
+           m_vertex_array  = 0;
+
+    glm::vec2 m_world_min = glm::vec2(0.0f),
+              m_world_max = glm::vec2(1.0f);
+    int       m_drawn_version = -1;  // of the colliders the texture shows; -1 for none yet
+    bool      m_invalid = true;
+
+    std::vector<unsigned char> m_tile_dirty;   // per tile, rows bottom up
+    std::vector<int>           m_dirty_tiles;  // the same, as a list
+
+    std::vector<MapVertex> m_vertices;    // scratch, for both passes
+    std::vector<Marker>    m_markers;     // added this frame
+    std::vector<int>       m_candidates;  // scratch, for a tile redraw's broadphase query
+
+    int       m_draw_calls = 0;
+    long long m_redraws      = 0,
+              m_tile_redraws = 0;
+
+    static void add_quad(std::vector<MapVertex>& vertices, glm::vec2 min, glm::vec2 max, glm::vec4 colour);
+    // The ground under [min_x, max_x], down to the bottom of the map
+    void add_ground(const Terrain* terrain, float min_x, float max_x);
+    void add_platform(const Entity& platform);
+    void fit_bounds(const Entity* platforms, int platform_count, const Terrain* terrain);
+    void get_tile_texels(int tile, int& x, int& y, int& width, int& height) const;
+    void redraw(const Entity* platforms, int platform_count, const Terrain* terrain);
+    void redraw_tiles(const Entity* platforms, int platform_count, const Terrain* terrain, const PlatformBroadphase* broadphase);
+    // m_vertices into the texture: the whole of it, or only the listed tiles
+    void draw_static(const std::vector<int>* tiles);
+    void bind_colour_vertices(size_t offset);
+
+public:
+    // False without framebuffer objects, in which case nothing else does anything
+    bool initialise(ShaderVariants* shaders, int width, int height);
+    void cleanup();
+
+    // Before the frame's scene is bound: redraws the texture if `colliders_version` is not the one
+    // it shows or invalidate() was called, else the tiles invalidate_region() marked, and does
+    // nothing otherwise. The broadphase, if given, finds a tile's platforms without a scan.
+    void update(const Entity* platforms, int platform_count, const Terrain* terrain, int colliders_version,
+                const PlatformBroadphase* broadphase = NULL);
+    void invalidate() { m_invalid = true; };
+    // The world box's tiles, redrawn by the next update(); all of it, to fit the map again, where
+    // the box reaches past the edge
+    void invalidate_region(glm::vec2 min, glm::vec2 max);
+
+    // For this frame only; `half_size` is in HUD units, so a marker is the same size on any level
+    void add_marker(glm::vec2 world_position, glm::vec4 colour, float half_size);
+
+    // The map over [hud_min, hud_max] of the HUD's world-space plane, markers on top; empties the markers
+    void draw(glm::vec2 hud_min, glm::vec2 hud_max);
+
+    bool      const is_ready()       const { return m_target.is_ready(); };
+    GLuint    const get_texture_id() const { return m_target.get_texture_id(); };
+    ShaderProgram*  get_program()    const { return m_map_program; };
+    int       const get_draw_calls() const { return m_draw_calls; };
+    long long const get_redraws()    const { return m_redraws; };
+    long long const get_tile_redraws() const { return m_tile_redraws; };
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+// Where a mesh sits in the world. Nothing here is drawn with anything but a 2D affine transform
+// (translate, rotate, scale), so rather than a 4x4 matrix, only the columns that can change are
+// kept: the images of the x and y axes and the translation, 6 floats against 16. The vertex
+// shaders take it as `uniform vec2 modelTransform[3]` in that order and expand it themselves.
+// Registry's Transform2D is something else: a component holding where an entity is.
+#include <cmath>
+#include "glm/vec2.hpp"
+#include "glm/mat4x4.hpp"
+
+struct ModelTransform
+{
+    glm::vec2 x_axis      = glm::vec2(1.0f, 0.0f),
+              y_axis      = glm::vec2(0.0f, 1.0f),
+              translation = glm::vec2(0.0f);
+
+    // Scaled, then rotated (radians, anticlockwise), then moved to `translation`
+    static ModelTransform make(glm::vec2 translation, float rotation = 0.0f, glm::vec2 scale = glm::vec2(1.0f))
+    {
+        float cosine = std::cos(rotation), sine = std::sin(rotation);
+        ModelTransform transform;
+        transform.x_axis      = glm::vec2(cosine, sine) * scale.x;
+        transform.y_axis      = glm::vec2(-sine, cosine) * scale.y;
+        transform.translation = translation;
+        return transform;
+    }
+
+    glm::vec2 apply(glm::vec2 point) const { return x_axis * point.x + y_axis * point.y + translation; }
+
+    // `child` placed in this one's space: this applied after it, as a parent's transform is to its child's
+    ModelTransform operator*(const ModelTransform& child) const
+    {
+        ModelTransform transform;
+        transform.x_axis      = x_axis * child.x_axis.x + y_axis * child.x_axis.y;
+        transform.y_axis      = x_axis * child.y_axis.x + y_axis * child.y_axis.y;
+        transform.translation = apply(child.translation);
+        return transform;
+    }
+
+    // For the odd caller that still wants the full matrix, e.g. to combine with a view
+    glm::mat4 to_mat4() const
+    {
+        glm::mat4 matrix(1.0f);
+        matrix[0] = glm::vec4(x_axis, 0.0f, 0.0f);
+        matrix[1] = glm::vec4(y_axis, 0.0f, 0.0f);
+        matrix[3] = glm::vec4(translation, 0.0f, 1.0f);
+        return matrix;
+    }
+
+    bool operator==(const ModelTransform& other) const { return x_axis == other.x_axis && y_axis == other.y_axis && translation == other.translation; }
+    bool operator!=(const ModelTransform& other) const { return !(*this == other); }
+};
@@ -0,0 +1,576 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "InputReplay.h"
+#include "NetSession.h"
+#include "Trace.h"
+
+const double NetClient::KEEPALIVE_SECONDS = 1.0 / 30.0;
+const double CONNECT_RETRY_SECONDS = 0.25;
+
+static uint32_t float_bits(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bits_float(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void write_header(BitWriter& writer, NetPacketType type)
+{
+    writer.write_bits(NET_PROTOCOL_ID, 32);
+    writer.write_bits((uint32_t)type, NET_PACKET_TYPE_BITS);
+}
+
+// False for anything that isn't ours, which on an open port is bound to turn up
+static bool read_header(BitReader& reader, NetPacketType& type)
+{
+    if (reader.read_bits(32) != NET_PROTOCOL_ID) return false;
+    type = (NetPacketType)reader.read_bits(NET_PACKET_TYPE_BITS);
+    return !reader.has_overflowed();
+}
+
+// ————— SERVER ————— //
+NetServer::NetServer() : m_world(PLATFORM_COUNT) {}
+
+bool NetServer::start(const NetServerConfig& config)
+{
+    stop();
+    m_config = config;
+    m_config.max_clients = std::min(std::max(m_config.max_clients, 1), NET_MAX_LANDERS);
+    m_config.snapshot_interval = std::max(m_config.snapshot_interval, 1);
+    if (!m_socket.open(m_config.port)) return false;
+
+    // STEP 1: The level, built the same way a client builds it from the welcome
+    GameState& state = m_world.state;
+    m_world.platforms.reset(new Entity[m_config.scene.platform_count]);
+    state.platforms = m_world.platforms.get();
+    state.platform_count = m_config.scene.platform_count;
+
+    setup_player(&m_world.player);
+    generate_scene(state.platforms, m_config.scene, m_config.seed);
+    state.platform_colliders->build(state.platforms, state.platform_count);
+    m_world.broadphase.build(state.platforms, state.platform_count);
+    state.platform_broadphase = &m_world.broadphase;
+    state.fixed_timestep = m_config.fixed_timestep;
+
+    // STEP 2: A lander for every slot, each out of play until someone connects to it
+    int extra = m_config.max_clients - 1;
+    m_landers.reset(extra > 0 ? new Entity[extra] : NULL);
+    m_outcomes.reset(extra > 0 ? new LanderOutcome[extra] : NULL);
+    for (int i = 0; i < extra; i++) setup_player(&m_landers[i]);
+    state.landers = m_landers.get();
+    state.lander_outcomes = m_outcomes.get();
+    state.lander_count = extra;
+
+    for (int slot = 0; slot < m_config.max_clients; slot++)
+    {
+        m_clients[slot] = Client();
+        get_lander(state, slot)->deactivate();
+    }
+
+    for (NetSnapshot& snapshot : m_history) snapshot.tick = UINT32_MAX;
+    m_tick = 0;
+    m_round = 0;
+    m_bytes_sent = 0;
+    m_snapshots_sent = 0;
+    start_round();
+    return true;
+}
+
+void NetServer::stop()
+{
+    for (int slot = 0; slot < NET_MAX_LANDERS; slot++)
+    {
+        if (!m_clients[slot].connected) continue;
+
+        uint8_t buffer[8];
+        BitWriter writer(buffer, sizeof(buffer));
+        write_header(writer, NET_DISCONNECT);
+        send_packet(m_clients[slot].address, writer, buffer);
+        m_clients[slot].connected = false;
+    }
+    m_socket.close();
+}
+
+int const NetServer::get_client_count() const
+{
+    int count = 0;
+    for (const Client& client : m_clients) count += client.connected ? 1 : 0;
+    return count;
+}
+
+void NetServer::start_round()
+{
+    reset_episode(m_world.state);
+    m_round++;
+    m_decided_ticks = 0;
+}
+
+void NetServer::send_packet(const NetAddress& address, const BitWriter& writer, const uint8_t* buffer)
+{
+    if (writer.has_overflowed()) return;
+    if (m_socket.send(address, buffer, writer.get_byte_count())) m_bytes_sent += (long long)writer.get_byte_count();
+}
+
+void NetServer::receive(double now)
+{
+    TRACE_ZONE("net server receive");
+
+    uint8_t    buffer[NET_MAX_PACKET];
+    NetAddress address;
+    int size;
+    while ((size = m_socket.receive(address, buffer, sizeof(buffer))) > 0)
+    {
+        BitReader reader(buffer, (size_t)size);
+        NetPacketType type;
+        if (!read_header(reader, type)) continue;
+
+        if (type == NET_CONNECT)
+        {
+            receive_connect(address, now);
+            continue;
+        }
+
+        // Everything else only from a client that has a slot
+        int slot = 0;
+        while (slot < m_config.max_clients && !(m_clients[slot].connected && m_clients[slot].address == address)) slot++;
+        if (slot == m_config.max_clients) continue;
+
+        Client& client = m_clients[slot];
+        client.last_heard = now;
+
+        if (type == NET_INPUT) receive_input(client, reader);
+        else if (type == NET_DISCONNECT)
+        {
+            client.connected = false;
+            get_lander(m_world.state, slot)->deactivate();
+        }
+    }
+
+    for (int slot = 0; slot < m_config.max_clients; slot++)
+    {
+        if (m_clients[slot].connected && now - m_clients[slot].last_heard > NET_CLIENT_TIMEOUT)
+        {
+            m_clients[slot].connected = false;
+            get_lander(m_world.state, slot)->deactivate();
+        }
+    }
+}
+
+void NetServer::receive_connect(const NetAddress& address, double now)
+{
+    // STEP 1: A client that missed its welcome asks again; it gets the same slot
+    int slot = 0, free_slot = -1;
+    for (; slot < m_config.max_clients; slot++)
+    {
+        if (m_clients[slot].connected && m_clients[slot].address == address) break;
+        if (!m_clients[slot].connected && free_slot < 0) free_slot = slot;
+    }
+
+    if (slot == m_config.max_clients)
+    {
+        if (free_slot < 0)
+        {
+            uint8_t buffer[8];
+            BitWriter writer(buffer, sizeof(buffer));
+            write_header(writer, NET_REJECT);
+            send_packet(address, writer, buffer);
+            return;
+        }
+
+        // STEP 2: A new client starts from the spawn point, even partway through a round
+        slot = free_slot;
+        m_clients[slot] = Client();
+        m_clients[slot].connected = true;
+        m_clients[slot].address = address;
+
+        GameState& state = m_world.state;
+        Entity* lander = get_lander(state, slot);
+        reset_lander(*lander, state.spawn_position);
+        lander->activate();
+        if (slot == 0)
+        {
+            state.win = false;
+            state.loss = false;
+        }
+        else state.lander_outcomes[slot - 1] = LanderOutcome();
+    }
+
+    m_clients[slot].last_heard = now;
+    send_welcome(slot);
+}
+
+void NetServer::send_welcome(int slot)
+{
+    const SceneConfig& scene = m_config.scene;
+
+    uint8_t buffer[64];
+    BitWriter writer(buffer, sizeof(buffer));
+    write_header(writer, NET_WELCOME);
+    writer.write_bits((uint32_t)slot, 4);
+    writer.write_bits(m_config.seed, 32);
+    writer.write_bits((uint32_t)scene.layout, 8);
+    writer.write_bits((uint32_t)scene.platform_count, 32);
+    writer.write_bits(float_bits(scene.density), 32);
+    writer.write_bits((uint32_t)scene.cluster_size, 32);
+    writer.write_bits(float_bits(scene.cluster_spread), 32);
+    writer.write_bits(float_bits(scene.win_chance), 32);
+    writer.write_bits(float_bits(m_config.fixed_timestep), 32);
+    send_packet(m_clients[slot].address, writer, buffer);
+}
+
+void NetServer::receive_input(Client& client, BitReader& reader)
+{
+    bool     has_ack  = reader.read_bool();
+    uint32_t ack      = has_ack ? reader.read_bits(32) : 0;
+    uint32_t newest   = reader.read_bits(32);
+    int      count    = (int)reader.read_bits(4);
+    int      actions[NET_INPUT_REDUNDANCY];
+    for (int i = 0; i < count && i < NET_INPUT_REDUNDANCY; i++) actions[i] = (int)reader.read_bits(3);
+    if (reader.has_overflowed() || count > NET_INPUT_REDUNDANCY) return;
+
+    // Acks only move forward; a late packet's older ack would just make the deltas bigger
+    if (has_ack && ack <= m_tick && (!client.has_ack || ack > client.acked_tick))
+    {
+        client.has_ack = true;
+        client.acked_tick = ack;
+    }
+
+    // STEP 1: Whichever of the inputs are new, oldest first (they're sent newest first)
+    for (int i = count - 1; i >= 0; i--)
+    {
+        uint32_t sequence = newest - (uint32_t)i;
+        if (sequence <= client.received_input) continue;
+
+        // STEP 2: Too far ahead of the steps; the oldest is dropped, as good as applied
+        if (client.queued_count == MAX_QUEUED_INPUTS)
+        {
+            std::copy(client.queued + 1, client.queued + MAX_QUEUED_INPUTS, client.queued);
+            client.queued_count--;
+        }
+        client.queued[client.queued_count++] = actions[i];
+        client.received_input = sequence;
+    }
+}
+
+void NetServer::capture(NetSnapshot& snapshot)
+{
+    GameState& state = m_world.state;
+
+    snapshot.tick = m_tick;
+    snapshot.round = m_round;
+    snapshot.lander_count = m_config.max_clients;
+    for (int slot = 0; slot < m_config.max_clients; slot++)
+    {
+        LanderOutcome outcome = get_lander_outcome(state, slot);
+        snapshot.landers[slot] = capture_lander(*get_lander(state, slot), m_config.fixed_timestep, m_clients[slot].connected, outcome.win, outcome.loss);
+    }
+}
+
+void NetServer::step()
+{
+    TRACE_ZONE("net server step");
+    GameState& state = m_world.state;
+    const float fixed_timestep = m_config.fixed_timestep;
+
+    // STEP 1: Each client's next input, or its last one again if none has arrived in time. A
+    //         decided lander lets go of the controls.
+    int connected = 0, decided = 0;
+    for (int slot = 0; slot < m_config.max_clients; slot++)
+    {
+        Client& client = m_clients[slot];
+        if (!client.connected) continue;
+
+        if (client.queued_count > 0)
+        {
+            client.action = client.queued[0];
+            std::copy(client.queued + 1, client.queued + client.queued_count, client.queued);
+            client.queued_count--;
+        }
+        // Everything received and no longer queued has been used, or dropped as good as used
+        client.applied_input = client.received_input - (uint32_t)client.queued_count;
+
+        Entity* lander = get_lander(state, slot);
+        LanderOutcome outcome = get_lander_outcome(state, slot);
+        bool is_decided = outcome.win || outcome.loss;
+
+        quantize_lander(*lander, fixed_timestep);
+        apply_replay_action(lander, is_decided ? REPLAY_NONE : client.action);
+
+        connected++;
+        decided += is_decided ? 1 : 0;
+    }
+
+    // STEP 2: The step itself, the same one every client predicts with
+    if (connected > 0) step_simulation(state, fixed_timestep);
+    m_tick++;
+
+    // STEP 3: A new round a little while after the last lander is down
+    if (connected > 0 && decided == connected)
+    {
+        if (++m_decided_ticks * fixed_timestep >= m_config.round_reset_seconds) start_round();
+    }
+    else m_decided_ticks = 0;
+
+    // STEP 4: Snapshots, each against what its client last acknowledged
+    if (m_tick % m_config.snapshot_interval != 0 || connected == 0) return;
+
+    NetSnapshot& snapshot = m_history[m_tick % NET_SNAPSHOT_HISTORY];
+    capture(snapshot);
+    for (int slot = 0; slot < m_config.max_clients; slot++)
+    {
+        if (m_clients[slot].connected) send_snapshot(slot, snapshot);
+    }
+}
+
+void NetServer::send_snapshot(int slot, const NetSnapshot& snapshot)
+{
+    const Client& client = m_clients[slot];
+
+    // The acked snapshot is only a baseline while it's still in the history on both ends
+    const NetSnapshot* baseline = NULL;
+    if (client.has_ack && m_tick - client.acked_tick < (uint32_t)NET_SNAPSHOT_HISTORY)
+    {
+        const NetSnapshot& acked = m_history[client.acked_tick % NET_SNAPSHOT_HISTORY];
+        if (acked.tick == client.acked_tick) baseline = &acked;
+    }
+
+    uint8_t buffer[NET_MAX_PACKET];
+    BitWriter writer(buffer, sizeof(buffer));
+    write_header(writer, NET_SNAPSHOT);
+    writer.write_bits(client.applied_input, 32);
+    write_snapshot(writer, snapshot, baseline);
+    send_packet(client.address, writer, buffer);
+    m_snapshots_sent++;
+}
+
+// ————— CLIENT ————— //
+bool NetClient::connect(const char* host_port, double timeout)
+{
+    disconnect();
+    if (!resolve_address(host_port, m_server) || !m_socket.open(0)) return false;
+
+    m_input_sequence = 0;
+    m_input_unsent = false;
+    m_has_snapshot = false;
+    m_has_new_snapshot = false;
+    m_applied_input = 0;
+    m_bytes_received = 0;
+    for (NetSnapshot& snapshot : m_history) snapshot.tick = UINT32_MAX;
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0, next_attempt = 0.0;
+    while (seconds < timeout)
+    {
+        // STEP 1: Ask, and keep asking, since either packet may be lost
+        if (seconds >= next_attempt)
+        {
+            uint8_t buffer[8];
+            BitWriter writer(buffer, sizeof(buffer));
+            write_header(writer, NET_CONNECT);
+            m_socket.send(m_server, buffer, writer.get_byte_count());
+            next_attempt = seconds + CONNECT_RETRY_SECONDS;
+        }
+
+        // STEP 2: The answer, from the server and nobody else
+        uint8_t    buffer[NET_MAX_PACKET];
+        NetAddress address;
+        int size = m_socket.receive(address, buffer, sizeof(buffer));
+        if (size > 0 && address == m_server)
+        {
+            BitReader reader(buffer, (size_t)size);
+            NetPacketType type;
+            if (read_header(reader, type))
+            {
+                if (type == NET_REJECT) break;
+                if (type == NET_WELCOME)
+                {
+                    SceneConfig& scene = m_welcome.scene;
+                    m_welcome.lander        = (int)reader.read_bits(4);
+                    m_welcome.seed          = reader.read_bits(32);
+                    scene.layout            = (SceneLayout)reader.read_bits(8);
+                    scene.platform_count    = (int)reader.read_bits(32);
+                    scene.density           = bits_float(reader.read_bits(32));
+                    scene.cluster_size      = (int)reader.read_bits(32);
+                    scene.cluster_spread    = bits_float(reader.read_bits(32));
+                    scene.win_chance        = bits_float(reader.read_bits(32));
+                    m_welcome.fixed_timestep = bits_float(reader.read_bits(32));
+
+                    m_connected = !reader.has_overflowed() && m_welcome.lander < NET_MAX_LANDERS && scene.layout < SCENE_LAYOUT_COUNT && scene.platform_count > 0;
+                    if (m_connected) return true;
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    m_socket.close();
+    return false;
+}
+
+void NetClient::disconnect()
+{
+    if (m_connected)
+    {
+        uint8_t buffer[8];
+        BitWriter writer(buffer, sizeof(buffer));
+        write_header(writer, NET_DISCONNECT);
+        m_socket.send(m_server, buffer, writer.get_byte_count());
+    }
+    m_connected = false;
+    m_socket.close();
+}
+
+void NetClient::queue_input(int action)
+{
+    m_input_sequence++;
+    m_inputs[m_input_sequence % INPUT_HISTORY] = action;
+    m_input_unsent = true;
+}
+
+void NetClient::send(double now)
+{
+    if (!m_connected || (!m_input_unsent && now - m_last_send < KEEPALIVE_SECONDS)) return;
+
+    uint8_t buffer[64];
+    BitWriter writer(buffer, sizeof(buffer));
+    write_header(writer, NET_INPUT);
+    writer.write_bool(m_has_snapshot);
+    if (m_has_snapshot) writer.write_bits(m_latest.tick, 32);
+
+    // Newest first, as many as there are up to the redundancy
+    int count = (int)std::min<uint32_t>(m_input_sequence, NET_INPUT_REDUNDANCY);
+    writer.write_bits(m_input_sequence, 32);
+    writer.write_bits((uint32_t)count, 4);
+    for (int i = 0; i < count; i++) writer.write_bits((uint32_t)m_inputs[(m_input_sequence - i) % INPUT_HISTORY], 3);
+
+    m_socket.send(m_server, buffer, writer.get_byte_count());
+    m_input_unsent = false;
+    m_last_send = now;
+}
+
+bool NetClient::receive(double now)
+{
+    if (!m_connected) return false;
+    TRACE_ZONE("net client receive");
+
+    bool received = false;
+    uint8_t    buffer[NET_MAX_PACKET];
+    NetAddress address;
+    int size;
+    while ((size = m_socket.receive(address, buffer, sizeof(buffer))) > 0)
+    {
+        if (address != m_server) continue;
+        m_bytes_received += size;
+
+        BitReader reader(buffer, (size_t)size);
+        NetPacketType type;
+        if (!read_header(reader, type)) continue;
+
+        if (type == NET_SNAPSHOT)
+        {
+            uint32_t previous_tick = m_latest.tick;
+            bool had_snapshot = m_has_snapshot;
+            receive_snapshot(reader, now);
+            received |= m_has_snapshot && (!had_snapshot || m_latest.tick != previous_tick);
+        }
+        else if (type == NET_DISCONNECT)
+        {
+            m_connected = false;
+            m_socket.close();
+            break;
+        }
+    }
+    return received;
+}
+
+void NetClient::receive_snapshot(BitReader& reader, double now)
+{
+    uint32_t applied_input = reader.read_bits(32);
+    uint32_t tick;
+    int      baseline_age;
+    read_snapshot_header(reader, tick, baseline_age);
+
+    // STEP 1: Late or duplicated packets have nothing newer to say
+    if (reader.has_overflowed() || (m_has_snapshot && (int32_t)(tick - m_latest.tick) <= 0)) return;
+
+    // STEP 2: The baseline it was written against, which has to be one we still have
+    const NetSnapshot* baseline = NULL;
+    if (baseline_age > 0)
+    {
+        if (baseline_age >= NET_SNAPSHOT_HISTORY) return;
+        baseline = &m_history[(tick - baseline_age) % NET_SNAPSHOT_HISTORY];
+        if (baseline->tick != tick - baseline_age) return;
+    }
+
+    NetSnapshot snapshot;
+    if (!read_snapshot_body(reader, snapshot, tick, baseline)) return;
+
+    // STEP 3: Kept for the next one to delta against, and for drawing
+    m_history[tick % NET_SNAPSHOT_HISTORY] = snapshot;
+    m_latest = snapshot;
+    m_applied_input = applied_input;
+
+    // The other landers are drawn a snapshot behind, moving between the last two over however
+    // long snapshots have been taking to arrive
+    double gap = now - m_snapshot_time;
+    if      (!m_has_snapshot)           m_snapshot_spacing = 0.0;
+    else if (m_snapshot_spacing <= 0.0) m_snapshot_spacing = gap;
+    else                                m_snapshot_spacing += (gap - m_snapshot_spacing) * 0.1;
+    m_snapshot_time = now;
+
+    m_has_snapshot = true;
+    m_has_new_snapshot = true;
+}
+
+void NetClient::reconcile(GameState& state)
+{
+    if (!m_has_new_snapshot || m_welcome.lander >= m_latest.lander_count) return;
+    m_has_new_snapshot = false;
+    TRACE_ZONE("net reconcile");
+
+    const float fixed_timestep = m_welcome.fixed_timestep;
+    const NetLanderState& own = m_latest.landers[m_welcome.lander];
+
+    // STEP 1: Where the server had us after the last input it applied
+    apply_lander(own, *state.player, fixed_timestep);
+    state.win  = (own.flags & NET_LANDER_WIN) != 0;
+    state.loss = (own.flags & NET_LANDER_LOSS) != 0;
+
+    // STEP 2: The inputs since, stepped exactly as they were the first time
+    uint32_t first = m_applied_input + 1;
+    if (m_input_sequence - m_applied_input > (uint32_t)INPUT_HISTORY) first = m_input_sequence - INPUT_HISTORY + 1;
+
+    for (uint32_t sequence = first; sequence <= m_input_sequence && !state.win && !state.loss; sequence++)
+    {
+        quantize_lander(*state.player, fixed_timestep);
+        apply_replay_action(state.player, m_inputs[sequence % INPUT_HISTORY]);
+        step_simulation(state, fixed_timestep);
+    }
+}
+
+float NetClient::get_snapshot_alpha(double now) const
+{
+    if (m_snapshot_spacing <= 0.0) return 1.0f;
+    return (float)std::min(std::max((now - m_snapshot_time) / m_snapshot_spacing, 0.0), 1.0);
+}
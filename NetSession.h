@@ -0,0 +1,193 @@
+#pragma once
+
+// Networked play over UDP. The server is authoritative: it runs the headless core at the fixed
+// timestep with one lander per client, and every few steps sends each client a NetSnapshot
+// delta-compressed against the last one that client acknowledged. Clients simulate their own
+// lander ahead of the server with their own inputs, send those inputs up, and on each snapshot
+// reconcile: jump back to the server's state and replay the inputs it hasn't seen yet.
+//
+// Every packet starts with NET_PROTOCOL_ID and a NetPacketType:
+//
+//   CONNECT    client -> server, until a WELCOME or REJECT comes back
+//   WELCOME    the level (seed, layout, platform count, fixed timestep) and the client's lander
+//   REJECT     the server is full
+//   INPUT      the client's newest acknowledged snapshot and its last NET_INPUT_REDUNDANCY
+//              inputs, so a lost packet's inputs arrive with the next one
+//   SNAPSHOT   the last input of the client's the server has applied, then the snapshot
+//   DISCONNECT either way; otherwise the server times a silent client out
+//
+// Landers don't collide with each other, so a client only predicts its own; the others are drawn
+// from the snapshots as they come.
+#include <cstdint>
+#include <memory>
+#include "NetSnapshot.h"
+#include "NetSocket.h"
+#include "SceneGenerator.h"
+#include "WorldPool.h"
+
+const uint32_t NET_PROTOCOL_ID       = 0x4c4e4431;  // "LND1"
+const int      NET_MAX_PACKET        = 512;
+const int      NET_INPUT_REDUNDANCY  = 8;
+const int      NET_SNAPSHOT_HISTORY  = 64;          // ticks of snapshots either end can delta against
+const double   NET_CLIENT_TIMEOUT    = 5.0;         // seconds without a packet
+
+enum NetPacketType
+{
+    NET_CONNECT,
+    NET_WELCOME,
+    NET_REJECT,
+    NET_INPUT,
+    NET_SNAPSHOT,
+    NET_DISCONNECT,
+    NET_PACKET_TYPE_BITS = 3
+};
+
+struct NetWelcome
+{
+    int          lander;          // this client's index into every snapshot
+    unsigned int seed;
+    SceneConfig  scene;
+    float        fixed_timestep;
+};
+
+struct NetServerConfig
+{
+    uint16_t     port                = 27960;
+    int          max_clients         = 4;    // up to NET_MAX_LANDERS
+    unsigned int seed                = 1;
+    SceneConfig  scene;
+    float        fixed_timestep      = FIXED_TIMESTEP;
+    int          snapshot_interval   = 2;    // steps between snapshots: 30 a second
+    double       round_reset_seconds = 3.0;  // once every lander has landed or crashed
+};
+
+// ————— SERVER ————— //
+class NetServer
+{
+private:
+    // Inputs waiting to be applied beyond this many are dropped, oldest first, so a client whose
+    // clock runs fast can't build up lag
+    static const int MAX_QUEUED_INPUTS = 8;
+
+    struct Client
+    {
+        bool       connected = false;
+        NetAddress address;
+        double     last_heard = 0.0;
+
+        uint32_t   received_input = 0,   // the newest input sequence number taken off the wire
+                   applied_input  = 0;   // the newest one a step has used
+        int        queued[MAX_QUEUED_INPUTS];
+        int        queued_count = 0;
+        int        action = 0;           // held until the next input is due
+
+        bool       has_ack = false;
+        uint32_t   acked_tick = 0;
+    };
+
+    NetServerConfig m_config;
+    UdpSocket       m_socket;
+
+    World                          m_world;
+    std::unique_ptr<Entity[]>      m_landers;   // slots 1 on; slot 0 is the world's player
+    std::unique_ptr<LanderOutcome[]> m_outcomes;
+    Client                         m_clients[NET_MAX_LANDERS];
+
+    uint32_t    m_tick = 0;
+    uint8_t     m_round = 0;
+    int         m_decided_ticks = 0;  // how long every connected lander has been landed or crashed
+    NetSnapshot m_history[NET_SNAPSHOT_HISTORY];
+
+    // ————— COUNTERS ————— //
+    long long m_bytes_sent = 0,
+              m_snapshots_sent = 0;
+
+    void receive_connect(const NetAddress& address, double now);
+    void receive_input(Client& client, BitReader& reader);
+    void send_welcome(int slot);
+    void send_snapshot(int slot, const NetSnapshot& snapshot);
+    void send_packet(const NetAddress& address, const BitWriter& writer, const uint8_t* buffer);
+
+    void capture(NetSnapshot& snapshot);
+    void start_round();
+
+public:
+    NetServer();
+
+    NetServer(const NetServer&) = delete;
+    NetServer& operator=(const NetServer&) = delete;
+
+    // Opens the port and builds the level; false if the port can't be had
+    bool start(const NetServerConfig& config);
+    void stop();
+
+    // Every packet waiting, with `now` in seconds on any steady clock, for the timeouts
+    void receive(double now);
+    // One fixed step for every connected lander, then the snapshots when one is due
+    void step();
+
+    int       const get_client_count()    const;
+    uint32_t  const get_tick()            const { return m_tick; };
+    long long const get_bytes_sent()      const { return m_bytes_sent; };
+    long long const get_snapshots_sent()  const { return m_snapshots_sent; };
+    float     const get_fixed_timestep()  const { return m_config.fixed_timestep; };
+};
+
+// ————— CLIENT ————— //
+class NetClient
+{
+private:
+    static const int INPUT_HISTORY = 128;   // steps of unacknowledged input kept for replay
+    static const double KEEPALIVE_SECONDS;  // between packets when there's no new input
+
+    UdpSocket  m_socket;
+    NetAddress m_server;
+    bool       m_connected = false;
+    NetWelcome m_welcome;
+
+    // ————— INPUT ————— //
+    uint32_t m_input_sequence = 0;          // of the newest input queued
+    int      m_inputs[INPUT_HISTORY];       // by sequence number
+    bool     m_input_unsent = false;
+    double   m_last_send = 0.0;
+
+    // ————— SNAPSHOTS ————— //
+    NetSnapshot m_history[NET_SNAPSHOT_HISTORY];  // by tick
+    NetSnapshot m_latest;
+    bool        m_has_snapshot = false,
+                m_has_new_snapshot = false;
+    uint32_t    m_applied_input = 0;        // what the latest snapshot says the server has used
+    double      m_snapshot_time = 0.0;
+    double      m_snapshot_spacing = 0.0;   // seconds between the last two snapshots
+
+    long long   m_bytes_received = 0;
+
+    void receive_snapshot(BitReader& reader, double now);
+
+public:
+    // Blocks until the server answers or `timeout` seconds pass. False if it can't be reached,
+    // is full, or speaks another protocol.
+    bool connect(const char* host_port, double timeout);
+    void disconnect();
+
+    // The action the client's lander takes in the step about to run; call once per step
+    void queue_input(int action);
+    // Sends the newest inputs and the ack, if there's anything new or it's been a while
+    void send(double now);
+    // Every packet waiting; true if a newer snapshot arrived
+    bool receive(double now);
+
+    // Puts the client's lander where the latest snapshot has it and replays every input the
+    // server hadn't applied yet on top. state.player must be this client's lander, with no
+    // other landers, in the level from the welcome.
+    void reconcile(GameState& state);
+
+    // How far between the previous snapshot and the latest to draw the other landers, from 0 to 1
+    float get_snapshot_alpha(double now) const;
+
+    bool               const is_connected()      const { return m_connected; };
+    const NetWelcome&  get_welcome()  const { return m_welcome; };
+    const NetSnapshot& get_snapshot() const { return m_latest; };
+    bool               const has_snapshot()      const { return m_has_snapshot; };
+    long long          const get_bytes_received() const { return m_bytes_received; };
+};
@@ -0,0 +1,148 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cmath>
+#include "NetSnapshot.h"
+
+static int32_t quantize(float value, float scale)   { return (int32_t)std::lround(value * scale); }
+
+// Velocity steps per unit per second
+static float get_velocity_scale(float fixed_timestep) { return NET_POSITION_SCALE * (float)NET_VELOCITY_SUBSTEPS * fixed_timestep; }
+
+// Where the baseline's velocity carries it over `ticks` steps, rounded to the nearest position step
+static int32_t extrapolate(int32_t position, int32_t velocity, uint32_t ticks)
+{
+    int64_t travelled = (int64_t)velocity * ticks;
+    return position + (int32_t)((travelled + NET_VELOCITY_SUBSTEPS / 2) >> 4);
+}
+
+static_assert(NET_VELOCITY_SUBSTEPS == 16, "extrapolate() shifts by log2(NET_VELOCITY_SUBSTEPS)");
+
+// ————— LANDERS ————— //
+void quantize_lander(Entity& lander, float fixed_timestep)
+{
+    NetLanderState state = capture_lander(lander, fixed_timestep, true, false, false);
+    lander.set_position(glm::vec3((float)state.x / NET_POSITION_SCALE, (float)state.y / NET_POSITION_SCALE, lander.get_position().z));
+    lander.set_velocity(glm::vec3((float)state.vx / get_velocity_scale(fixed_timestep), (float)state.vy / get_velocity_scale(fixed_timestep), lander.get_velocity().z));
+}
+
+NetLanderState capture_lander(const Entity& lander, float fixed_timestep, bool active, bool win, bool loss)
+{
+    NetLanderState state;
+    state.x  = quantize(lander.get_position().x, NET_POSITION_SCALE);
+    state.y  = quantize(lander.get_position().y, NET_POSITION_SCALE);
+    state.vx = quantize(lander.get_velocity().x, get_velocity_scale(fixed_timestep));
+    state.vy = quantize(lander.get_velocity().y, get_velocity_scale(fixed_timestep));
+
+    state.flags = 0;
+    if (active)                           state.flags |= NET_LANDER_ACTIVE;
+    if (lander.get_movement().x < 0.0f)   state.flags |= NET_LANDER_LEFT;
+    if (lander.get_movement().x > 0.0f)   state.flags |= NET_LANDER_RIGHT;
+    if (lander.m_booster_active)          state.flags |= NET_LANDER_BOOST;
+    if (win)                              state.flags |= NET_LANDER_WIN;
+    if (loss)                             state.flags |= NET_LANDER_LOSS;
+    return state;
+}
+
+void apply_lander(const NetLanderState& state, Entity& lander, float fixed_timestep)
+{
+    BodyState body;
+    lander.save_state(body);
+
+    glm::vec3 position = glm::vec3((float)state.x / NET_POSITION_SCALE, (float)state.y / NET_POSITION_SCALE, 0.0f),
+              velocity = glm::vec3((float)state.vx, (float)state.vy, 0.0f) / get_velocity_scale(fixed_timestep);
+    body.previous_position = glm::vec3(body.position);
+    body.position = PhysicsVec3(position);
+    body.velocity = PhysicsVec3(velocity);
+
+    float movement_x = 0.0f;
+    if (state.flags & NET_LANDER_LEFT)  movement_x -= 1.0f;
+    if (state.flags & NET_LANDER_RIGHT) movement_x += 1.0f;
+    body.movement = glm::vec3(movement_x, 0.0f, 0.0f);
+    body.booster_active = (state.flags & NET_LANDER_BOOST) != 0;
+    body.throttle = 1.0f;  // the protocol carries the action bits alone
+
+    lander.restore_state(body);
+}
+
+// ————— ENCODING ————— //
+void write_snapshot(BitWriter& writer, const NetSnapshot& snapshot, const NetSnapshot* baseline)
+{
+    static const NetLanderState AT_REST = {};
+
+    uint32_t age = baseline != NULL ? snapshot.tick - baseline->tick : 0;
+    writer.write_bits(snapshot.tick, 32);
+    writer.write_bits(age, 8);
+    writer.write_bits(snapshot.round, 8);
+    writer.write_bits((uint32_t)snapshot.lander_count, 4);
+
+    for (int i = 0; i < snapshot.lander_count; i++)
+    {
+        const NetLanderState& lander = snapshot.landers[i];
+        const NetLanderState& base   = baseline != NULL && i < baseline->lander_count ? baseline->landers[i] : AT_REST;
+
+        // STEP 1: The differences from the prediction, which for anything coasting are zero
+        int32_t dx  = lander.x - extrapolate(base.x, base.vx, age),
+                dy  = lander.y - extrapolate(base.y, base.vy, age),
+                dvx = lander.vx - base.vx,
+                dvy = lander.vy - base.vy;
+        bool flags_changed = lander.flags != base.flags;
+
+        // STEP 2: One bit for a lander that's exactly where it was predicted to be
+        bool changed = dx != 0 || dy != 0 || dvx != 0 || dvy != 0 || flags_changed;
+        writer.write_bool(changed);
+        if (!changed) continue;
+
+        writer.write_signed(dx);
+        writer.write_signed(dy);
+        writer.write_signed(dvx);
+        writer.write_signed(dvy);
+        writer.write_bool(flags_changed);
+        if (flags_changed) writer.write_bits(lander.flags, NET_LANDER_FLAG_BITS);
+    }
+}
+
+void read_snapshot_header(BitReader& reader, uint32_t& tick, int& baseline_age)
+{
+    tick = reader.read_bits(32);
+    baseline_age = (int)reader.read_bits(8);
+}
+
+bool read_snapshot_body(BitReader& reader, NetSnapshot& snapshot, uint32_t tick, const NetSnapshot* baseline)
+{
+    static const NetLanderState AT_REST = {};
+
+    uint32_t age = baseline != NULL ? tick - baseline->tick : 0;
+    snapshot.tick = tick;
+    snapshot.round = (uint8_t)reader.read_bits(8);
+    snapshot.lander_count = (int)reader.read_bits(4);
+    if (snapshot.lander_count > NET_MAX_LANDERS) return false;
+
+    for (int i = 0; i < snapshot.lander_count; i++)
+    {
+        NetLanderState& lander = snapshot.landers[i];
+        const NetLanderState& base = baseline != NULL && i < baseline->lander_count ? baseline->landers[i] : AT_REST;
+
+        lander.x  = extrapolate(base.x, base.vx, age);
+        lander.y  = extrapolate(base.y, base.vy, age);
+        lander.vx = base.vx;
+        lander.vy = base.vy;
+        lander.flags = base.flags;
+        if (!reader.read_bool()) continue;
+
+        lander.x  += reader.read_signed();
+        lander.y  += reader.read_signed();
+        lander.vx += reader.read_signed();
+        lander.vy += reader.read_signed();
+        if (reader.read_bool()) lander.flags = (uint8_t)reader.read_bits(NET_LANDER_FLAG_BITS);
+    }
+
+    return !reader.has_overflowed();
+}
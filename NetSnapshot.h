@@ -0,0 +1,68 @@
+#pragma once
+
+// What a multiplayer server sends its clients each snapshot: every lander's position, velocity,
+// controls and outcome, quantized to fixed point. Landers are written as deltas against an older
+// snapshot the client has acknowledged (its baseline): positions against where the baseline's
+// velocity would have carried them by now, velocities against the baseline's. A lander coasting
+// or resting on a platform then costs a bit or two a field, and one that hasn't changed at all
+// costs a single bit.
+//
+//   tick (32) | baseline age (8; 0 for none) | round (8) | lander count (4) | landers
+//
+// Velocities are kept per fixed step rather than per second, so extrapolating is integer
+// arithmetic and comes out the same on every machine.
+//
+// Quantizing is part of the simulation's contract with the network, not just its encoding: in
+// networked play the server and every client round their landers to the grid before each step, so
+// a client replaying its inputs from a snapshot lands exactly where the server did.
+#include <cstdint>
+#include "BitStream.h"
+#include "Entity.h"
+
+const int   NET_MAX_LANDERS       = 8;
+const float NET_POSITION_SCALE    = 2048.0f;  // steps per unit; about half a millimetre a metre
+const int   NET_VELOCITY_SUBSTEPS = 16;       // velocity steps per position step per fixed step
+
+enum NetLanderFlags
+{
+    NET_LANDER_ACTIVE = 1,   // a connected player's; the rest of the slots are left out of play
+    NET_LANDER_LEFT   = 2,
+    NET_LANDER_RIGHT  = 4,
+    NET_LANDER_BOOST  = 8,
+    NET_LANDER_WIN    = 16,
+    NET_LANDER_LOSS   = 32,
+    NET_LANDER_FLAG_BITS = 6
+};
+
+struct NetLanderState
+{
+    int32_t x, y,    // in 1 / NET_POSITION_SCALE units
+            vx, vy;  // in 1 / NET_VELOCITY_SUBSTEPS position steps per fixed step
+    uint8_t flags;   // NetLanderFlags
+};
+
+struct NetSnapshot
+{
+    uint32_t       tick;
+    uint8_t        round;         // goes up every time the server resets the level
+    int            lander_count;
+    NetLanderState landers[NET_MAX_LANDERS];
+};
+
+// Rounds the lander's position and velocity to the network grid; see above
+void quantize_lander(Entity& lander, float fixed_timestep);
+
+NetLanderState capture_lander(const Entity& lander, float fixed_timestep, bool active, bool win, bool loss);
+// Sets the lander's body to the state, with its controls held as they were. Where it was before
+// becomes its previous position, so render() can draw it between the two. Textures, animation
+// and everything else about it are left alone.
+void apply_lander(const NetLanderState& state, Entity& lander, float fixed_timestep);
+
+// With no baseline, every lander is written against one at rest at the origin
+void write_snapshot(BitWriter& writer, const NetSnapshot& snapshot, const NetSnapshot* baseline);
+
+// Reads the header alone, so the receiver can look up the baseline it names: the snapshot from
+// `tick - baseline_age`
+void read_snapshot_header(BitReader& reader, uint32_t& tick, int& baseline_age);
+// The rest, against that baseline (NULL when the age was 0). False on a malformed packet.
+bool read_snapshot_body(BitReader& reader, NetSnapshot& snapshot, uint32_t tick, const NetSnapshot* baseline);
@@ -0,0 +1,339 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "NetSocket.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+const uintptr_t NO_SOCKET = (uintptr_t)INVALID_SOCKET;
+
+// Winsock has to be started before anything resolves or opens; once per process is enough
+static bool start_network()
+{
+    static bool started = false;
+    if (!started)
+    {
+        WSADATA data;
+        started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+    return started;
+}
+#else
+const int NO_SOCKET = -1;
+
+static bool start_network() { return true; }
+#endif
+
+bool resolve_address(const char* host_port, NetAddress& address)
+{
+    const char* colon = std::strrchr(host_port, ':');
+    if (colon == NULL || !start_network()) return false;
+
+    std::string host(host_port, colon - host_port);
+    int port = std::atoi(colon + 1);
+    if (port <= 0 || port > 65535) return false;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+
+    addrinfo* result = NULL;
+    if (getaddrinfo(host.empty() ? "127.0.0.1" : host.c_str(), NULL, &hints, &result) != 0 || result == NULL) return false;
+
+    address.host = ntohl(((const sockaddr_in*)result->ai_addr)->sin_addr.s_addr);
+    address.port = (uint16_t)port;
+    freeaddrinfo(result);
+    return true;
+}
+
+UdpSocket::UdpSocket() : m_socket(NO_SOCKET) {}
+
+UdpSocket::~UdpSocket()
+{
+    close();
+}
+
+bool UdpSocket::open(uint16_t port)
+{
+    close();
+    if (!start_network()) return false;
+
+    m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_socket == NO_SOCKET) return false;
+    m_open = true;
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+
+    // Non-blocking, so a receive with nothing waiting returns straight away
+#ifdef _WIN32
+    u_long non_blocking = 1;
+    bool configured = ioctlsocket((SOCKET)m_socket, FIONBIO, &non_blocking) == 0;
+#else
+    bool configured = fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!configured || bind(m_socket, (const sockaddr*)&local, sizeof(local)) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close()
+{
+    if (!m_open) return;
+#ifdef _WIN32
+    closesocket((SOCKET)m_socket);
+#else
+    ::close(m_socket);
+#endif
+    m_socket = NO_SOCKET;
+    m_open = false;
+}
+
+bool UdpSocket::send(const NetAddress& address, const void* data, size_t size)
+{
+    if (!m_open) return false;
+
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = htonl(address.host);
+    remote.sin_port = htons(address.port);
+
+    return sendto(m_socket, (const char*)data, (int)size, 0, (const sockaddr*)&remote, sizeof(remote)) == (int)size;
+}
+
+int UdpSocket::receive(NetAddress& address, void* buffer, size_t capacity)
+{
+    if (!m_open) return -1;
+
+    sockaddr_in remote = {};
+    socklen_t remote_size = sizeof(remote);
+    int size = (int)recvfrom(m_socket, (char*)buffer, (int)capacity, 0, (sockaddr*)&remote, &remote_size);
+
+    if (size < 0)
+    {
+        // Nothing waiting isn't an error for a non-blocking socket. Windows also reports an
+        // earlier send's ICMP port-unreachable here, which says nothing about this receive.
+#ifdef _WIN32
+        int error = WSAGetLastError();
+        return error == WSAEWOULDBLOCK || error == WSAECONNRESET || error == WSAEMSGSIZE ? 0 : -1;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+#endif
+    }
+
+    address.host = ntohl(remote.sin_addr.s_addr);
+    address.port = ntohs(remote.sin_port);
+    return size;
+}
+
+// ————— TCP ————— //
+TcpStream::TcpStream() : m_socket(NO_SOCKET) {}
+
+TcpStream::~TcpStream()
+{
+    close();
+}
+
+bool TcpStream::connect(const NetAddress& address, int timeout_ms)
+{
+    close();
+    if (!start_network()) return false;
+
+    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_socket == NO_SOCKET) return false;
+    m_open = true;
+
+    sockaddr_in remote = {};
+    remote.sin_family = AF_INET;
+    remote.sin_addr.s_addr = htonl(address.host);
+    remote.sin_port = htons(address.port);
+
+    // STEP 1: Connect without blocking, so an unreachable host costs the timeout and no more...
+#ifdef _WIN32
+    u_long non_blocking = 1;
+    ioctlsocket((SOCKET)m_socket, FIONBIO, &non_blocking);
+#else
+    int flags = fcntl(m_socket, F_GETFL, 0);
+    fcntl(m_socket, F_SETFL, flags | O_NONBLOCK);
+#endif
+    bool connected = ::connect(m_socket, (const sockaddr*)&remote, sizeof(remote)) == 0;
+    if (!connected)
+    {
+        fd_set writable, failed;
+        FD_ZERO(&writable);
+        FD_ZERO(&failed);
+        FD_SET(m_socket, &writable);
+        FD_SET(m_socket, &failed);
+        timeval timeout = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+
+        int error = 0;
+        socklen_t error_size = sizeof(error);
+        connected = select((int)m_socket + 1, NULL, &writable, &failed, &timeout) > 0 && FD_ISSET(m_socket, &writable)
+                    && getsockopt(m_socket, SOL_SOCKET, SO_ERROR, (char*)&error, &error_size) == 0 && error == 0;
+    }
+
+    // STEP 2: ...then blocking again, with the same timeout on every send and receive
+#ifdef _WIN32
+    non_blocking = 0;
+    ioctlsocket((SOCKET)m_socket, FIONBIO, &non_blocking);
+#else
+    fcntl(m_socket, F_SETFL, flags);
+#endif
+    if (!connected || !set_timeout(timeout_ms))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TcpStream::set_timeout(int timeout_ms)
+{
+    if (!m_open) return false;
+
+#ifdef _WIN32
+    DWORD timeout_value = (DWORD)timeout_ms;
+#else
+    timeval timeout_value = { timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+#endif
+    return setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout_value, sizeof(timeout_value)) == 0
+        && setsockopt(m_socket, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout_value, sizeof(timeout_value)) == 0;
+}
+
+void TcpStream::close()
+{
+    if (!m_open) return;
+#ifdef _WIN32
+    closesocket((SOCKET)m_socket);
+#else
+    ::close(m_socket);
+#endif
+    m_socket = NO_SOCKET;
+    m_open = false;
+}
+
+bool TcpStream::send_all(const void* data, size_t size)
+{
+    const char* bytes = (const char*)data;
+    while (m_open && size > 0)
+    {
+        // A peer that hung up is an error to report, not a SIGPIPE to die of
+#ifdef MSG_NOSIGNAL
+        int sent = (int)::send(m_socket, bytes, (int)size, MSG_NOSIGNAL);
+#else
+        int sent = (int)::send(m_socket, bytes, (int)size, 0);
+#endif
+        if (sent <= 0) return false;
+        bytes += sent;
+        size  -= (size_t)sent;
+    }
+    return m_open;
+}
+
+int TcpStream::receive(void* buffer, size_t capacity)
+{
+    if (!m_open) return -1;
+
+    int size = (int)recv(m_socket, (char*)buffer, (int)capacity, 0);
+    return size < 0 ? -1 : size;
+}
+
+TcpListener::TcpListener() : m_socket(NO_SOCKET) {}
+
+TcpListener::~TcpListener()
+{
+    close();
+}
+
+bool TcpListener::open(uint16_t port)
+{
+    close();
+    if (!start_network()) return false;
+
+    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_socket == NO_SOCKET) return false;
+    m_open = true;
+
+    // A coordinator restarted straight away shouldn't find its own old connections holding the port
+    int reuse = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in local = {};
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = htons(port);
+
+    if (bind(m_socket, (const sockaddr*)&local, sizeof(local)) != 0 || listen(m_socket, SOMAXCONN) != 0)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TcpListener::close()
+{
+    if (!m_open) return;
+#ifdef _WIN32
+    closesocket((SOCKET)m_socket);
+#else
+    ::close(m_socket);
+#endif
+    m_socket = NO_SOCKET;
+    m_open = false;
+}
+
+bool TcpListener::accept(TcpStream& stream, int wait_ms, int timeout_ms)
+{
+    if (!m_open) return false;
+
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(m_socket, &readable);
+    timeval wait = { wait_ms / 1000, (wait_ms % 1000) * 1000 };
+    if (select((int)m_socket + 1, &readable, NULL, NULL, &wait) <= 0) return false;
+
+    stream.close();
+    stream.m_socket = ::accept(m_socket, NULL, NULL);
+    if (stream.m_socket == NO_SOCKET) return false;
+    stream.m_open = true;
+
+    if (!stream.set_timeout(timeout_ms))
+    {
+        stream.close();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// A non-blocking IPv4 UDP socket, over BSD sockets or Winsock. Datagrams either arrive whole or
+// not at all; everything above this copes with loss, duplicates and reordering itself.
+//
+// TcpStream is the blocking counterpart for the odd request/response exchange, only ever used
+// off the game thread; every call gives up after its timeout rather than hanging on a dead peer.
+// TcpListener hands out the server side of one.
+#include <cstddef>
+#include <cstdint>
+
+struct NetAddress
+{
+    uint32_t host = 0;  // in host byte order
+    uint16_t port = 0;
+
+    bool operator==(const NetAddress& other) const { return host == other.host && port == other.port; };
+    bool operator!=(const NetAddress& other) const { return !(*this == other); };
+};
+
+// "host:port", where host is a name or a dotted address; false if it doesn't resolve
+bool resolve_address(const char* host_port, NetAddress& address);
+
+class UdpSocket
+{
+private:
+#ifdef _WIN32
+    uintptr_t m_socket;  // a SOCKET
+#else
+    int       m_socket;
+#endif
+    bool m_open = false;
+
+public:
+    UdpSocket();
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Port 0 for any free one. False if the port is taken or there's no network stack.
+    bool open(uint16_t port = 0);
+    void close();
+
+    bool send(const NetAddress& address, const void* data, size_t size);
+    // The size of the next waiting datagram, 0 when there's none, or -1 on an error. Datagrams
+    // longer than `capacity` are cut short.
+    int  receive(NetAddress& address, void* buffer, size_t capacity);
+
+    bool const is_open() const { return m_open; };
+};
+
+class TcpStream
+{
+private:
+    friend class TcpListener;
+
+#ifdef _WIN32
+    uintptr_t m_socket;  // a SOCKET
+#else
+    int       m_socket;
+#endif
+    bool m_open = false;
+
+public:
+    TcpStream();
+    ~TcpStream();
+
+    TcpStream(const TcpStream&) = delete;
+    TcpStream& operator=(const TcpStream&) = delete;
+
+    // False if nothing answers within timeout_ms, which then also bounds every send and receive
+    bool connect(const NetAddress& address, int timeout_ms);
+    void close();
+    // For every send and receive from now on
+    bool set_timeout(int timeout_ms);
+
+    bool send_all(const void* data, size_t size);
+    // Up to `capacity` bytes as they arrive: 0 once the peer has closed, -1 on an error or timeout
+    int  receive(void* buffer, size_t capacity);
+
+    bool const is_open() const { return m_open; };
+};
+
+class TcpListener
+{
+private:
+#ifdef _WIN32
+    uintptr_t m_socket;  // a SOCKET
+#else
+    int       m_socket;
+#endif
+    bool m_open = false;
+
+public:
+    TcpListener();
+    ~TcpListener();
+
+    TcpListener(const TcpListener&) = delete;
+    TcpListener& operator=(const TcpListener&) = delete;
+
+    // False if the port is taken or there's no network stack
+    bool open(uint16_t port);
+    void close();
+
+    // Waits up to wait_ms for the next connection, which then has timeout_ms on every send and
+    // receive; false if none came
+    bool accept(TcpStream& stream, int wait_ms, int timeout_ms);
+
+    bool const is_open() const { return m_open; };
+};
@@ -0,0 +1,228 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "glm/gtc/matrix_transform.hpp"
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "ObservationRenderer.h"
+#include "Trace.h"
+
+bool ObservationRenderer::initialise(ShaderVariants* shaders, const ObservationSprites& sprites, int tile_width, int tile_height, int capacity,
+                                     glm::vec2 view_min, glm::vec2 view_max)
+{
+    if (!supports_framebuffer_objects() || !supports_instancing() || capacity <= 0) return false;
+
+    m_shaders = shaders;
+    m_program = shaders->get(SHADER_TEXTURED | SHADER_INSTANCED);
+    m_sprites = sprites;
+    m_tile_width = tile_width;
+    m_tile_height = tile_height;
+    m_view_min = view_min;
+    m_view_max = view_max;
+
+    // As square a grid as the capacity allows, to stay well inside GL_MAX_RENDERBUFFER_SIZE
+    m_tile_columns = (int)std::ceil(std::sqrt((double)capacity));
+    m_tile_rows = (capacity + m_tile_columns - 1) / m_tile_columns;
+
+    if (!m_target.initialise(m_tile_columns * tile_width, m_tile_rows * tile_height)) return false;
+
+    m_renderer.initialise(m_program);
+    m_group = m_renderer.add_group(m_program, sprites.texture_id, m_instances, true);
+
+    // Every buffer gets the whole target up front, so a batch never reallocates one
+    const GLsizeiptr image_size = (GLsizeiptr)m_target.get_width() * m_target.get_height() * CHANNELS;
+
+    m_use_pixel_buffers = supports_pixel_buffer_objects();
+    if (m_use_pixel_buffers)
+    {
+        glGenBuffers(READBACK_BUFFERS, m_pixel_buffers);
+        for (GLuint buffer : m_pixel_buffers)
+        {
+            count_gl_call(GL_CALL_BIND);
+            count_gl_call(GL_CALL_UPLOAD);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, image_size, NULL, GL_STREAM_READ);
+            track_gpu_buffer(buffer, (long long)image_size);
+        }
+        count_gl_call(GL_CALL_BIND);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    else m_sync_pixels.resize(image_size);
+
+    m_instances.reserve(capacity * (PLATFORM_COUNT + 1));
+    return true;
+}
+
+void ObservationRenderer::cleanup()
+{
+    if (m_use_pixel_buffers) untrack_gpu_buffers(READBACK_BUFFERS, m_pixel_buffers);
+    if (m_use_pixel_buffers) glDeleteBuffers(READBACK_BUFFERS, m_pixel_buffers);
+    std::fill(std::begin(m_pixel_buffers), std::end(m_pixel_buffers), 0);
+    std::fill(std::begin(m_pending_tiles), std::end(m_pending_tiles), 0);
+
+    m_renderer.cleanup();
+    m_target.cleanup();
+    m_group = -1;
+}
+
+void ObservationRenderer::add_sprite(int tile, glm::vec2 position, glm::vec4 uv_rect)
+{
+    // STEP 1: From world units into the grid's, where tile (column, row) is the unit square at (column, row)
+    glm::vec2 origin    = glm::vec2(tile % m_tile_columns, tile / m_tile_columns),
+              view_size = m_view_max - m_view_min,
+              centre    = origin + (position - m_view_min) / view_size,
+              half_size = 0.5f / view_size;  // sprites are one world unit square
+
+    glm::vec2 low  = centre - half_size,
+              high = centre + half_size;
+
+    // STEP 2: Crop to the tile, taking the same fraction off the UV rectangle. V runs top down,
+    //         so the top edge is what moves the rectangle's origin.
+    glm::vec2 clipped_low  = glm::max(low, origin),
+              clipped_high = glm::min(high, origin + glm::vec2(1.0f));
+    if (clipped_low.x >= clipped_high.x || clipped_low.y >= clipped_high.y) return;
+
+    glm::vec2 size = high - low;
+    uv_rect.x += uv_rect.z * (clipped_low.x - low.x) / size.x;
+    uv_rect.y += uv_rect.w * (high.y - clipped_high.y) / size.y;
+    uv_rect.z *= (clipped_high.x - clipped_low.x) / size.x;
+    uv_rect.w *= (clipped_high.y - clipped_low.y) / size.y;
+
+    m_instances.push_back({ (clipped_low + clipped_high) / 2.0f, clipped_high - clipped_low, uv_rect });
+}
+
+void ObservationRenderer::render_batch(const GameState* const* states, int count)
+{
+    TRACE_ZONE("ObservationRenderer::render_batch");
+    count = std::min(count, get_capacity());
+
+    // ————— INSTANCES ————— //
+    m_instances.clear();
+    for (int tile = 0; tile < count; tile++)
+    {
+        const GameState& state = *states[tile];
+
+        for (int i = 0; i < state.platform_count; i++)
+        {
+            const Entity& platform = state.platforms[i];
+            if (!platform.is_active()) continue;
+
+            add_sprite(tile, glm::vec2(platform.get_position()),
+                       platform.get_entity_type() == WIN_PLATFORM ? m_sprites.win_platform : m_sprites.death_platform);
+        }
+
+        float velocity_y = state.player->get_velocity().y;
+        int   frame      = velocity_y > 1 ? Entity::HIGH : (velocity_y > 0 ? Entity::LOW : Entity::IDLE);
+        add_sprite(tile, glm::vec2(state.player->get_position()), m_sprites.ship_frames[frame]);
+    }
+    m_renderer.update_group(m_group, m_instances.data(), (int)m_instances.size());
+
+    // ————— DRAW ————— //
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    m_target.bind();
+    glViewport(0, 0, m_target.get_width(), m_target.get_height());
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // The variants share one camera, so the game's goes back once the tiles are drawn
+    glm::mat4 projection_matrix = m_shaders->get_projection_matrix(),
+              view_matrix       = m_shaders->get_view_matrix();
+    m_shaders->set_camera(glm::ortho(0.0f, (float)m_tile_columns, 0.0f, (float)m_tile_rows, -1.0f, 1.0f), glm::mat4(1.0f));
+
+    m_program->use();
+    m_renderer.draw(m_program);
+    m_shaders->set_camera(projection_matrix, view_matrix);
+
+    // ————— READBACK ————— //
+    // Only the rows of tiles this batch filled
+    int rows_used = (count + m_tile_columns - 1) / m_tile_columns;
+    GLsizei width = m_target.get_width(),
+            height = rows_used * m_tile_height;
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    if (m_use_pixel_buffers)
+    {
+        // Returns straight away: the copy into the buffer is queued behind the draw
+        count_gl_call(GL_CALL_BIND, 2);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[m_next_buffer]);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        m_pending_tiles[m_next_buffer] = count;
+        m_next_buffer = (m_next_buffer + 1) % READBACK_BUFFERS;
+    }
+    else
+    {
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, m_sync_pixels.data());
+        m_pending_tiles[0] = count;
+    }
+
+    m_target.unbind();
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+int ObservationRenderer::read_observations(unsigned char* out)
+{
+    // After render_batch, the next buffer to write is the one holding the batch before it
+    int buffer = m_use_pixel_buffers ? m_next_buffer : 0,
+        count  = m_pending_tiles[buffer];
+    if (count == 0) return 0;
+
+    const unsigned char* pixels = m_sync_pixels.data();
+    if (m_use_pixel_buffers)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixel_buffers[buffer]);
+#ifndef __EMSCRIPTEN__
+        pixels = (const unsigned char*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#endif
+    }
+
+    // GL's rows run bottom up across the whole target; each observation's run top down within its tile
+    if (pixels != NULL)
+    {
+        const size_t target_stride = (size_t)m_target.get_width() * CHANNELS,
+                     tile_stride   = (size_t)m_tile_width * CHANNELS;
+
+        for (int tile = 0; tile < count; tile++)
+        {
+            int column = tile % m_tile_columns,
+                row    = tile / m_tile_columns;
+            unsigned char* observation = out + (size_t)tile * get_observation_size();
+
+            for (int y = 0; y < m_tile_height; y++)
+            {
+                size_t source_row = (size_t)row * m_tile_height + (m_tile_height - 1 - y);
+                std::memcpy(observation + y * tile_stride, pixels + source_row * target_stride + column * tile_stride, tile_stride);
+            }
+        }
+    }
+    else count = 0;
+
+    if (m_use_pixel_buffers)
+    {
+#ifndef __EMSCRIPTEN__
+        if (pixels != NULL) glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+#endif
+        count_gl_call(GL_CALL_BIND);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    m_pending_tiles[buffer] = 0;
+    return count;
+}
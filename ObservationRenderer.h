@@ -0,0 +1,84 @@
+#pragma once
+
+// Renders many GameStates at once as pixel observations. Every state gets a tile of one large
+// offscreen target, and the whole batch is a single instanced draw: sprites are moved into
+// their tile's rectangle on the CPU (and cropped to it, so nothing bleeds into a neighbour),
+// and all of them come from the one atlas page.
+//
+// The readback goes through a pair of pixel buffer objects: render_batch() starts copying this
+// batch's pixels and read_observations() collects the previous batch's, which the GPU has long
+// since finished by then. Observations therefore arrive one batch late, for one readback per
+// batch and no stall. Drivers without PBOs fall back to a synchronous glReadPixels.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "InstancedRenderer.h"
+#include "OffscreenTarget.h"
+#include "ShaderVariants.h"
+#include "Simulation.h"
+
+// Where each kind of sprite sits in the atlas
+struct ObservationSprites
+{
+    GLuint    texture_id;
+    glm::vec4 ship_frames[3];   // IDLE, LOW and HIGH, picked by vertical speed as Entity::update does
+    glm::vec4 win_platform,
+              death_platform;
+};
+
+class ObservationRenderer
+{
+private:
+    static const int READBACK_BUFFERS = 2,
+                     CHANNELS         = 4;  // RGBA, the format drivers read back fastest
+
+    OffscreenTarget    m_target;
+    InstancedRenderer  m_renderer;
+    ShaderVariants*    m_shaders = NULL;
+    ShaderProgram*     m_program = NULL;  // m_shaders' textured, instanced variant
+    ObservationSprites m_sprites = {};
+    int                m_group   = -1;
+
+    int       m_tile_width   = 0,
+              m_tile_height  = 0,
+              m_tile_columns = 0,
+              m_tile_rows    = 0;
+    glm::vec2 m_view_min, m_view_max;  // the world rectangle each tile shows
+
+    std::vector<SpriteInstance> m_instances;
+
+    // ————— READBACK ————— //
+    bool   m_use_pixel_buffers = false;
+    GLuint m_pixel_buffers[READBACK_BUFFERS] = {};
+    int    m_pending_tiles[READBACK_BUFFERS] = {};  // how many tiles each buffer holds; 0 for none
+    int    m_next_buffer = 0;
+    std::vector<unsigned char> m_sync_pixels;  // the whole target, without PBOs
+
+    void add_sprite(int tile, glm::vec2 position, glm::vec4 uv_rect);
+
+public:
+    // One tile_width x tile_height tile per state, up to `capacity` of them laid out in a grid.
+    // Draws with the textured, instanced variant of `shaders`, whose camera it puts back after each
+    // batch. False if this driver can't render offscreen or instance.
+    bool initialise(ShaderVariants* shaders, const ObservationSprites& sprites, int tile_width, int tile_height, int capacity,
+                    glm::vec2 view_min, glm::vec2 view_max);
+    void cleanup();
+
+    // Draws states[0..count) into tiles 0..count) and starts reading them back. Leaves the
+    // window's framebuffer bound and its viewport restored, but overwrites the program's
+    // projection and view matrices, so callers sharing it must set theirs again.
+    void render_batch(const GameState* const* states, int count);
+
+    // Writes the batch before the latest as count x tile_height x tile_width x 4 bytes, rows top
+    // first, and returns its count; 0 (with out untouched) before there is one. Without PBOs
+    // this is the latest batch instead.
+    int  read_observations(unsigned char* out);
+
+    int  const get_capacity()            const { return m_tile_columns * m_tile_rows; };
+    int  const get_observation_size()    const { return m_tile_width * m_tile_height * CHANNELS; };
+    bool const uses_pixel_buffers()      const { return m_use_pixel_buffers; };
+};
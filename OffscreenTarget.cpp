@@ -0,0 +1,99 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <cstddef>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "OffscreenTarget.h"
+
+bool OffscreenTarget::initialise(int width, int height, bool sampled)
+{
+    if (!supports_framebuffer_objects()) return false;
+
+    m_width = width;
+    m_height = height;
+
+    // A renderbuffer unless something samples the result
+    if (sampled)
+    {
+        count_gl_call(GL_CALL_BIND, 2);
+        glGenTextures(1, &m_texture_id);
+        glBindTexture(GL_TEXTURE_2D, m_texture_id);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        track_gpu_texture(m_texture_id, estimate_texture_bytes(width, height));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    else
+    {
+        count_gl_call(GL_CALL_BIND, 2);
+        glGenRenderbuffers(1, &m_color_buffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_color_buffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        track_gpu_renderbuffer(m_color_buffer, estimate_texture_bytes(width, height));
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    glGenFramebuffers(1, &m_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+    if (sampled) glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture_id, 0);
+    else         glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_buffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    count_gl_call(GL_CALL_BIND);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void OffscreenTarget::cleanup()
+{
+    if (m_framebuffer != 0)  glDeleteFramebuffers(1, &m_framebuffer);
+    if (m_color_buffer != 0) glDeleteRenderbuffers(1, &m_color_buffer);
+    if (m_texture_id != 0)   glDeleteTextures(1, &m_texture_id);
+    untrack_gpu_renderbuffers(1, &m_color_buffer);
+    untrack_gpu_textures(1, &m_texture_id);
+    m_framebuffer = m_color_buffer = m_texture_id = 0;
+}
+
+void OffscreenTarget::bind() const
+{
+    count_gl_call(GL_CALL_BIND);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+}
+
+void OffscreenTarget::unbind() const
+{
+    count_gl_call(GL_CALL_BIND);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void OffscreenTarget::blit_to_window(int source_width, int source_height, int window_width, int window_height) const
+{
+    count_gl_call(GL_CALL_BIND, 3);
+    count_gl_call(GL_CALL_DRAW);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, source_width, source_height, 0, 0, window_width, window_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
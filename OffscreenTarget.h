@@ -0,0 +1,40 @@
+#pragma once
+
+// A colour-only framebuffer object to render into instead of the window, e.g. for benchmarking
+// on a machine whose window is hidden or has no display behind it, or for something drawn once and
+// then sampled as a texture, like the minimap
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+
+class OffscreenTarget
+{
+private:
+    GLuint m_framebuffer  = 0,
+           m_color_buffer = 0,  // a renderbuffer, or...
+           m_texture_id   = 0;  // ...a texture, when it's to be sampled
+    int    m_width  = 0,
+           m_height = 0;
+
+public:
+    // False, with nothing left allocated, without framebuffer objects or if the driver rejects
+    // the attachment. `sampled` puts the colour in a linearly filtered texture instead of a
+    // renderbuffer, so it can be drawn with.
+    bool initialise(int width, int height, bool sampled = false);
+    void cleanup();
+
+    // Draws go here until unbind(); the viewport is left to the caller
+    void bind() const;
+    void unbind() const;
+
+    // Stretches the bottom-left source_width x source_height of the target over the window's
+    // bottom-left window_width x window_height, filtered linearly, and leaves the window bound
+    void blit_to_window(int source_width, int source_height, int window_width, int window_height) const;
+
+    bool   const is_ready()       const { return m_framebuffer != 0; };
+    GLuint const get_texture_id() const { return m_texture_id; };  // 0 unless sampled
+    int    const get_width()      const { return m_width; };
+    int    const get_height()     const { return m_height; };
+};
@@ -0,0 +1,171 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cmath>
+#include "OverlapKernels.h"
+#include "SimdDispatch.h"
+
+#ifdef LANDER_SIMD_SSE2
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define LANDER_TARGET_AVX2
+#else
+#define LANDER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef LANDER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// ————— SCALAR ————— //
+static bool overlaps(const OverlapBoxes& boxes, int index, float x, float y, float width, float height)
+{
+    float x_gap = std::fabs(x - boxes.x[index]) - ((width + boxes.width[index]) / 2.0f),
+          y_gap = std::fabs(y - boxes.y[index]) - ((height + boxes.height[index]) / 2.0f);
+    return x_gap < 0.0f && y_gap < 0.0f;
+}
+
+uint32_t overlap_mask_scalar(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (overlaps(boxes, indices[i], x, y, width, height)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+// ————— SSE2 / AVX2 ————— //
+#ifdef LANDER_SIMD_SSE2
+uint32_t overlap_mask_sse2(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height)
+{
+    const __m128 xs = _mm_set1_ps(x), ys = _mm_set1_ps(y),
+                 widths = _mm_set1_ps(width), heights = _mm_set1_ps(height),
+                 half = _mm_set1_ps(0.5f), zero = _mm_setzero_ps(),
+                 sign = _mm_set1_ps(-0.0f);
+
+    uint32_t mask = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const int* lane = indices + i;
+        __m128 other_x      = _mm_setr_ps(boxes.x[lane[0]], boxes.x[lane[1]], boxes.x[lane[2]], boxes.x[lane[3]]),
+               other_y      = _mm_setr_ps(boxes.y[lane[0]], boxes.y[lane[1]], boxes.y[lane[2]], boxes.y[lane[3]]),
+               other_width  = _mm_setr_ps(boxes.width[lane[0]], boxes.width[lane[1]], boxes.width[lane[2]], boxes.width[lane[3]]),
+               other_height = _mm_setr_ps(boxes.height[lane[0]], boxes.height[lane[1]], boxes.height[lane[2]], boxes.height[lane[3]]);
+
+        // Halving is exact, so * 0.5 is the scalar / 2 to the bit
+        __m128 x_gap = _mm_sub_ps(_mm_andnot_ps(sign, _mm_sub_ps(xs, other_x)), _mm_mul_ps(_mm_add_ps(widths, other_width), half)),
+               y_gap = _mm_sub_ps(_mm_andnot_ps(sign, _mm_sub_ps(ys, other_y)), _mm_mul_ps(_mm_add_ps(heights, other_height), half));
+
+        mask |= (uint32_t)_mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(x_gap, zero), _mm_cmplt_ps(y_gap, zero))) << i;
+    }
+    for (; i < count; i++)
+    {
+        if (overlaps(boxes, indices[i], x, y, width, height)) mask |= 1u << i;
+    }
+    return mask;
+}
+
+LANDER_TARGET_AVX2 uint32_t overlap_mask_avx2(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height)
+{
+    const __m256 xs = _mm256_set1_ps(x), ys = _mm256_set1_ps(y),
+                 widths = _mm256_set1_ps(width), heights = _mm256_set1_ps(height),
+                 half = _mm256_set1_ps(0.5f), zero = _mm256_setzero_ps(),
+                 sign = _mm256_set1_ps(-0.0f);
+
+    uint32_t mask = 0;
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i lane = _mm256_loadu_si256((const __m256i*)(indices + i));
+        __m256 other_x      = _mm256_i32gather_ps(boxes.x, lane, 4),
+               other_y      = _mm256_i32gather_ps(boxes.y, lane, 4),
+               other_width  = _mm256_i32gather_ps(boxes.width, lane, 4),
+               other_height = _mm256_i32gather_ps(boxes.height, lane, 4);
+
+        // Separate multiplies and adds, never fused, so the rounding matches the scalar test
+        __m256 x_gap = _mm256_sub_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(xs, other_x)), _mm256_mul_ps(_mm256_add_ps(widths, other_width), half)),
+               y_gap = _mm256_sub_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(ys, other_y)), _mm256_mul_ps(_mm256_add_ps(heights, other_height), half));
+
+        __m256 hit = _mm256_and_ps(_mm256_cmp_ps(x_gap, zero, _CMP_LT_OQ), _mm256_cmp_ps(y_gap, zero, _CMP_LT_OQ));
+        mask |= (uint32_t)_mm256_movemask_ps(hit) << i;
+    }
+    return mask | (i < count ? overlap_mask_sse2(boxes, indices + i, count - i, x, y, width, height) << i : 0);
+}
+#endif
+
+// ————— NEON ————— //
+#ifdef LANDER_SIMD_NEON
+uint32_t overlap_mask_neon(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height)
+{
+    const float32x4_t xs = vdupq_n_f32(x), ys = vdupq_n_f32(y),
+                      widths = vdupq_n_f32(width), heights = vdupq_n_f32(height),
+                      half = vdupq_n_f32(0.5f), zero = vdupq_n_f32(0.0f);
+    const uint32_t    lane_bits[4] = { 1, 2, 4, 8 };
+    const uint32x4_t  bits = vld1q_u32(lane_bits);
+
+    uint32_t mask = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const int* lane = indices + i;
+        float other_x[4]      = { boxes.x[lane[0]], boxes.x[lane[1]], boxes.x[lane[2]], boxes.x[lane[3]] },
+              other_y[4]      = { boxes.y[lane[0]], boxes.y[lane[1]], boxes.y[lane[2]], boxes.y[lane[3]] },
+              other_width[4]  = { boxes.width[lane[0]], boxes.width[lane[1]], boxes.width[lane[2]], boxes.width[lane[3]] },
+              other_height[4] = { boxes.height[lane[0]], boxes.height[lane[1]], boxes.height[lane[2]], boxes.height[lane[3]] };
+
+        // vmulq and vaddq apart rather than vmlaq, which may fuse and round differently
+        float32x4_t x_gap = vsubq_f32(vabsq_f32(vsubq_f32(xs, vld1q_f32(other_x))), vmulq_f32(vaddq_f32(widths, vld1q_f32(other_width)), half)),
+                    y_gap = vsubq_f32(vabsq_f32(vsubq_f32(ys, vld1q_f32(other_y))), vmulq_f32(vaddq_f32(heights, vld1q_f32(other_height)), half));
+
+        uint32x4_t hit = vandq_u32(vcltq_f32(x_gap, zero), vcltq_f32(y_gap, zero));
+        mask |= vaddvq_u32(vandq_u32(hit, bits)) << i;
+    }
+    for (; i < count; i++)
+    {
+        if (overlaps(boxes, indices[i], x, y, width, height)) mask |= 1u << i;
+    }
+    return mask;
+}
+#endif
+
+// ————— DISPATCH ————— //
+struct OverlapKernelChoice
+{
+    OverlapKernel kernel;
+    const char*   name;
+};
+
+static OverlapKernelChoice choose_overlap_kernel()
+{
+    switch (get_simd_isa())
+    {
+#if defined(LANDER_SIMD_SSE2)
+    case SIMD_AVX512:
+    case SIMD_AVX2:   return { overlap_mask_avx2, "AVX2" };
+    case SIMD_SSE2:   return { overlap_mask_sse2, "SSE2" };
+#elif defined(LANDER_SIMD_NEON)
+    case SIMD_NEON:   return { overlap_mask_neon, "NEON" };
+#endif
+    default:          return { overlap_mask_scalar, "scalar" };
+    }
+}
+
+static const OverlapKernelChoice& get_overlap_kernel_choice()
+{
+    static const OverlapKernelChoice choice = choose_overlap_kernel();
+    return choice;
+}
+
+OverlapKernel get_overlap_kernel()      { return get_overlap_kernel_choice().kernel; }
+const char*   get_overlap_kernel_name() { return get_overlap_kernel_choice().name; }
@@ -0,0 +1,68 @@
+#pragma once
+
+// The narrowphase box test, run on several platforms per instruction for when a dense cluster
+// leaves the broadphase handing back dozens of candidates. Platforms are read in structure-of-
+// arrays form through a list of indices, and a kernel returns one bit per candidate; the caller
+// walks the set bits in order, exactly as it would have walked the candidates.
+//
+// Every variant does Entity's own arithmetic in the same order, |dx| - (w + other_w) / 2 < 0 on
+// both axes, so they all agree with it and with each other to the bit:
+//   scalar  one box at a time, anywhere
+//   SSE2    4 boxes, on every x64 CPU
+//   AVX2    8 boxes, with gathered loads, where the CPU and OS support it
+// The kernel is picked once, from get_simd_isa() (SimdDispatch.h).
+//   NEON    4 boxes, on every AArch64 CPU
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LANDER_SIMD_SSE2 1
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define LANDER_SIMD_NEON 1
+#endif
+
+// Platform boxes by centre and full size. A box that should never be hit (an inactive platform)
+// has a width of -infinity, which no gap can be under.
+struct OverlapBoxes
+{
+    const float* x;
+    const float* y;
+    const float* width;
+    const float* height;
+};
+
+// Bit i of the result is set where boxes[indices[i]] overlaps the box centred on (x, y) and
+// sized (width, height). Up to OVERLAP_KERNEL_BATCH candidates per call.
+typedef uint32_t (*OverlapKernel)(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height);
+
+const int OVERLAP_KERNEL_BATCH = 32;
+const int OVERLAP_KERNEL_MIN_CANDIDATES = 8;  // below this, the scalar loop wins
+
+uint32_t overlap_mask_scalar(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height);
+#ifdef LANDER_SIMD_SSE2
+uint32_t overlap_mask_sse2(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height);
+uint32_t overlap_mask_avx2(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height);
+#endif
+#ifdef LANDER_SIMD_NEON
+uint32_t overlap_mask_neon(const OverlapBoxes& boxes, const int* indices, int count, float x, float y, float width, float height);
+#endif
+
+// The kernel for get_simd_isa(), bound on the first call
+OverlapKernel get_overlap_kernel();
+const char*   get_overlap_kernel_name();
+
+// Of a non-zero mask, the first candidate it hits
+inline int lowest_set_bit(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
@@ -0,0 +1,138 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "ParticleSystem.h"
+
+void ParticleSystem::initialise(ShaderProgram* program, GLuint texture_id, glm::vec4 uv_rect, int capacity)
+{
+    m_capacity = capacity;
+    m_texture_id = texture_id;
+    m_uv_rect = uv_rect;
+
+    m_origin_x.assign(capacity, 0.0f);
+    m_origin_y.assign(capacity, 0.0f);
+    m_velocity_x.assign(capacity, 0.0f);
+    m_velocity_y.assign(capacity, 0.0f);
+    m_birth_time.assign(capacity, 0.0f);
+    m_instances.assign(capacity, SpriteInstance());
+
+    m_renderer.initialise(program);
+    if (m_renderer.is_supported()) m_group = m_renderer.add_group(program, texture_id, std::vector<SpriteInstance>(), true);
+}
+
+void ParticleSystem::cleanup()
+{
+    m_renderer.cleanup();
+    m_group = -1;
+    m_count = 0;
+}
+
+float ParticleSystem::random_unit()
+{
+    // xorshift32: plenty for exhaust, and no state beyond one word
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return (float)(m_random >> 8) / (float)(1 << 23) - 1.0f;
+}
+
+void ParticleSystem::emit(glm::vec2 position, glm::vec2 velocity)
+{
+    if (m_capacity == 0) return;
+
+    // A full pool gives up its oldest particle rather than the new one
+    if (m_count == m_capacity)
+    {
+        m_tail = (m_tail + 1) % m_capacity;
+        m_count--;
+    }
+
+    int head = (m_tail + m_count) % m_capacity;
+    m_origin_x[head] = position.x;
+    m_origin_y[head] = position.y;
+    m_velocity_x[head] = velocity.x;
+    m_velocity_y[head] = velocity.y;
+    m_birth_time[head] = (float)m_time;
+    m_count++;
+}
+
+void ParticleSystem::spawn(float delta_time, float rate, glm::vec2 position, glm::vec2 velocity, float spread)
+{
+    m_spawn_carry += rate * delta_time;
+
+    int count = (int)m_spawn_carry;
+    m_spawn_carry -= count;
+
+    for (int i = 0; i < count; i++)
+    {
+        emit(position, velocity + glm::vec2(random_unit(), random_unit()) * spread);
+    }
+}
+
+void ParticleSystem::burst(int count, glm::vec2 position, glm::vec2 velocity, float spread)
+{
+    for (int i = 0; i < count; i++)
+    {
+        emit(position, velocity + glm::vec2(random_unit(), random_unit()) * spread);
+    }
+}
+
+void ParticleSystem::translate(glm::vec2 offset)
+{
+    // The whole pool rather than the live run, which can wrap; dead slots are overwritten anyway
+    for (float& x : m_origin_x) x += offset.x;
+    for (float& y : m_origin_y) y += offset.y;
+}
+
+void ParticleSystem::update(float delta_time)
+{
+    m_time += delta_time;
+    float now = (float)m_time;
+
+    // STEP 1: Everyone lives for m_lifetime, so the expired particles are exactly the ones at the tail
+    while (m_count > 0 && now - m_birth_time[m_tail] >= m_lifetime)
+    {
+        m_tail = (m_tail + 1) % m_capacity;
+        m_count--;
+    }
+
+    // STEP 2: One pass over the live range (in up to two runs, as it may wrap) writing instances
+    m_instance_count = 0;
+    int first_run = std::min(m_count, m_capacity - m_tail);
+    int runs[][2] = { { m_tail, m_tail + first_run }, { 0, m_count - first_run } };
+
+    for (const auto& run : runs)
+    {
+        for (int i = run[0]; i < run[1]; i++)
+        {
+            float age = now - m_birth_time[i];
+            float life = age / m_lifetime;
+            float size = m_start_size + (m_end_size - m_start_size) * life;
+
+            SpriteInstance& instance = m_instances[m_instance_count++];
+            instance.offset = glm::vec2(m_origin_x[i] + m_velocity_x[i] * age,
+                                        m_origin_y[i] + m_velocity_y[i] * age + 0.5f * m_gravity * age * age);
+            instance.scale = glm::vec2(size);
+            instance.uv_rect = m_uv_rect;
+        }
+    }
+
+    // STEP 3: Straight to the GPU, orphaning last frame's buffer
+    if (m_group >= 0) m_renderer.update_group(m_group, m_instances.data(), m_instance_count);
+}
+
+void ParticleSystem::draw(ShaderProgram* program)
+{
+    m_renderer.draw(program);
+}
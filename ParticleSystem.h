@@ -0,0 +1,78 @@
+#pragma once
+
+// Fixed-capacity pool of short-lived sprites, for the thruster exhaust. Every particle lives
+// for the same time, so the pool is a ring buffer in birth order: new ones go in at the head,
+// expired ones drop off the tail, and a full pool simply overwrites its oldest. Particles are
+// stored as launch parameters and their positions evaluated in closed form, so update() is a
+// single pass that writes the instance data straight out for one instanced draw.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+#include "InstancedRenderer.h"
+
+class ParticleSystem
+{
+private:
+    // ————— PARTICLES (SoA) ————— //
+    std::vector<float> m_origin_x, m_origin_y,
+                       m_velocity_x, m_velocity_y,
+                       m_birth_time;
+
+    int m_capacity = 0,
+        m_tail     = 0,  // oldest live particle
+        m_count    = 0;
+
+    double m_time = 0.0;  // seconds since initialise(); birth times are relative to it
+
+    // ————— RENDERING ————— //
+    std::vector<SpriteInstance> m_instances;  // sized to capacity once, never reallocated
+    int                         m_instance_count = 0;
+    InstancedRenderer           m_renderer;
+    int                         m_group = -1;
+    GLuint                      m_texture_id = 0;
+    glm::vec4                   m_uv_rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    float    m_spawn_carry = 0.0f;  // fraction of a particle left over from the last spawn()
+    uint32_t m_random      = 2463534242u;
+
+    float random_unit();  // -1 to 1
+
+public:
+    static const int DEFAULT_CAPACITY = 50000;
+
+    float m_lifetime   = 0.6f,
+          m_gravity    = -1.62f,
+          m_start_size = 0.18f,
+          m_end_size   = 0.02f;
+
+    // Everything is allocated here; nothing after this allocates
+    void initialise(ShaderProgram* program, GLuint texture_id, glm::vec4 uv_rect, int capacity = DEFAULT_CAPACITY);
+    void cleanup();
+
+    // `rate` particles per second over delta_time, fanned out by up to `spread` in velocity
+    void spawn(float delta_time, float rate, glm::vec2 position, glm::vec2 velocity, float spread);
+    void emit(glm::vec2 position, glm::vec2 velocity);
+    // `count` particles at once, e.g. where GpuParticleSystem isn't supported
+    void burst(int count, glm::vec2 position, glm::vec2 velocity, float spread);
+
+    // Every live particle's launch point, in one pass, when the origin moves
+    void translate(glm::vec2 offset);
+
+    // Ages the pool, retires expired particles and uploads this frame's instances
+    void update(float delta_time);
+    void draw(ShaderProgram* program);
+
+    // What update() last uploaded, for drawing through the sprite batch without instancing
+    const SpriteInstance* get_instances() const { return m_instances.data(); };
+    int  const get_instance_count() const { return m_instance_count; };
+    int  const get_count()          const { return m_count; };
+    bool const is_instanced()       const { return m_renderer.is_supported(); };
+    int  const get_draw_calls()     const { return m_renderer.get_draw_calls(); };
+    GLuint const get_texture_id()   const { return m_texture_id; };
+};
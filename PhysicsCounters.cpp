@@ -0,0 +1,56 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "PhysicsCounters.h"
+
+void PhysicsCounters::record_frame(const GameState& state, int steps, float delta_time)
+{
+    record_frame(state.timings, state.budget, state.time_accumulator, steps, delta_time);
+}
+
+void PhysicsCounters::record_frame(const StepTimings& timings, const StepBudget& budget, float time_accumulator, int steps, float delta_time)
+{
+    if (m_window_frames == 0)
+    {
+        m_window_start_collision   = timings.collision_seconds;
+        m_window_start_integration = timings.integration_seconds;
+        m_window_start_dropped     = budget.dropped_seconds;
+    }
+
+    m_window_seconds += delta_time;
+    m_window_frames++;
+    m_window_steps += steps;
+    m_window_max_steps = std::max(m_window_max_steps, steps);
+    m_window_max_accumulator = std::max(m_window_max_accumulator, time_accumulator);
+    m_run_max_steps = std::max(m_run_max_steps, steps);
+
+    if (m_window_seconds < WINDOW_SECONDS) return;
+
+    // ————— PUBLISH ————— //
+    m_stats.steps_per_second         = (float)(m_window_steps / m_window_seconds);
+    m_stats.average_steps_per_frame  = (float)m_window_steps / m_window_frames;
+    m_stats.max_steps_per_frame      = m_window_max_steps;
+    m_stats.accumulator_ms           = time_accumulator * 1000.0f;
+    m_stats.max_accumulator_ms       = m_window_max_accumulator * 1000.0f;
+    m_stats.collision_ms_per_frame   = (float)((timings.collision_seconds - m_window_start_collision) * 1000.0 / m_window_frames);
+    m_stats.integration_ms_per_frame = (float)((timings.integration_seconds - m_window_start_integration) * 1000.0 / m_window_frames);
+    m_stats.dropped_ms               = (float)((budget.dropped_seconds - m_window_start_dropped) * 1000.0);
+
+    m_window_seconds = 0.0;
+    m_window_frames = m_window_steps = 0;
+    m_window_max_steps = 0;
+    m_window_max_accumulator = 0.0f;
+}
+
+void PhysicsCounters::clear()
+{
+    *this = PhysicsCounters();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Simulation.h"
+
+// One window's worth of simulation throughput and lag, for sizing the fixed timestep: if
+// max_steps_per_frame keeps hitting the step budget, or the accumulator never drains, the
+// machine can't keep up with the timestep it was given
+struct PhysicsStats
+{
+    float steps_per_second         = 0.0f;
+    float average_steps_per_frame  = 0.0f;
+    int   max_steps_per_frame      = 0;
+    float accumulator_ms           = 0.0f,  // left over for the next frame, at the end of the window
+          max_accumulator_ms       = 0.0f;
+    float collision_ms_per_frame   = 0.0f,  // zero unless the GameState's timings are enabled
+          integration_ms_per_frame = 0.0f;
+    float dropped_ms               = 0.0f;  // real time the step budget threw away
+};
+
+// Samples a GameState once per game frame and republishes PhysicsStats every WINDOW_SECONDS,
+// so the numbers hold still long enough to read on the overlay
+class PhysicsCounters
+{
+private:
+    static constexpr double WINDOW_SECONDS = 1.0;
+
+    double    m_window_seconds         = 0.0;
+    long long m_window_frames          = 0,
+              m_window_steps           = 0;
+    int       m_window_max_steps       = 0;
+    float     m_window_max_accumulator = 0.0f;
+
+    double    m_window_start_collision   = 0.0,
+              m_window_start_integration = 0.0,
+              m_window_start_dropped     = 0.0;
+
+    PhysicsStats m_stats;
+    int          m_run_max_steps = 0;
+
+public:
+    // delta_time is the real time the frame handed to advance_simulation, and steps what it returned
+    void record_frame(const GameState& state, int steps, float delta_time);
+    // The same from copies of the state's counters, for a simulation stepped on another thread
+    void record_frame(const StepTimings& timings, const StepBudget& budget, float time_accumulator, int steps, float delta_time);
+    void clear();
+
+    const PhysicsStats& get_stats()         const { return m_stats; };
+    int  const          get_run_max_steps() const { return m_run_max_steps; };
+};
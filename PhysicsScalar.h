@@ -0,0 +1,16 @@
+#pragma once
+
+// The number type of the lander physics, picked at compile time. Define LANDER_FIXED_POINT for
+// Q16.16 fixed point, which is bit-identical across compilers, CPUs and build types and so suits
+// lockstep and replay verification; the default float is faster and is what the game ships with.
+#include "glm/mat4x4.hpp"
+#include "Fixed.h"
+
+#ifdef LANDER_FIXED_POINT
+typedef Fixed PhysicsScalar;
+#else
+typedef float PhysicsScalar;
+#endif
+
+typedef glm::vec<2, PhysicsScalar> PhysicsVec2;
+typedef glm::vec<3, PhysicsScalar> PhysicsVec3;
@@ -0,0 +1,50 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+#define GL_SILENCE_DEPRECATION
+
+#include <vector>
+#include "PipelineWarmup.h"
+#include "Trace.h"
+
+void PipelineWarmup::initialise(RenderBackend* backend)
+{
+    m_backend = backend;
+    m_pipelines = 0;
+    m_draws = 0;
+
+    std::vector<unsigned char> zeros(3 * MAX_VERTEX_BYTES, 0);
+    if (m_vertex_buffer == 0) m_vertex_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, zeros.size(), zeros.data(), GL_STATIC_DRAW);
+}
+
+void PipelineWarmup::cleanup()
+{
+    if (m_vertex_buffer != 0) m_backend->delete_buffer(m_vertex_buffer);
+    m_vertex_buffer = 0;
+}
+
+void PipelineWarmup::warm_up(const Pipeline& pipeline)
+{
+    if (m_vertex_buffer == 0 || pipeline.program == NULL || (size_t)pipeline.layout.stride > MAX_VERTEX_BYTES) return;
+    TRACE_ZONE("PipelineWarmup::warm_up");
+
+    // Every attribute reads zero, so the triangle has no area whatever the program does with it
+    m_backend->begin_draws(pipeline, m_vertex_buffer, 0);
+    for (int blended = 0; blended < 2; blended++)
+    {
+        if (blended) glEnable(GL_BLEND);
+        else         glDisable(GL_BLEND);
+
+        m_backend->draw_triangles(0, 3);
+        m_draws++;
+    }
+    m_backend->end_draws();
+
+    m_pipelines++;
+}
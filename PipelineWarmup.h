@@ -0,0 +1,38 @@
+#pragma once
+
+// Pays the driver's deferred work behind the loading screen. Many drivers only finish compiling a
+// program, and build the vertex fetch for its layout, at the first draw that uses it; tilers also
+// patch the blend state into the shader there. A permutation first drawn mid-game (a post-effect
+// combination the governor falls back to, a cutout sprite) then stutters.
+//
+// warm_up() issues that first draw up front: one triangle with every vertex at the origin, which
+// covers no pixels, once unblended and once blended, as RenderQueue draws opaque and translucent
+// commands. It can go into whatever framebuffer is bound, the splash's included.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include "RenderBackend.h"
+
+class PipelineWarmup
+{
+private:
+    static const size_t MAX_VERTEX_BYTES = 256;  // wider than any VertexLayout in the game
+
+    RenderBackend* m_backend = NULL;
+    GLuint         m_vertex_buffer = 0;  // three vertices of zeros
+
+    int m_pipelines = 0,
+        m_draws     = 0;
+
+public:
+    void initialise(RenderBackend* backend);
+    void cleanup();
+
+    // GL thread. Leaves blending on, as initialise() in main.cpp sets it
+    void warm_up(const Pipeline& pipeline);
+
+    int const get_pipeline_count() const { return m_pipelines; };
+    int const get_draw_count()     const { return m_draws; };
+};
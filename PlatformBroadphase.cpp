@@ -0,0 +1,113 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "PlatformBroadphase.h"
+#include "Entity.h"
+
+static void get_box(const Entity& platform, glm::vec2& min, glm::vec2& max)
+{
+    glm::vec2 centre    = glm::vec2(platform.get_position()),
+              half_size = glm::vec2(platform.get_width(), platform.get_height()) / 2.0f;
+    min = centre - half_size;
+    max = centre + half_size;
+}
+
+bool PlatformBroadphase::file_or_track(const Entity* platforms, int index)
+{
+    if (platforms[index].get_body_type() == STATIC_BODY) return true;
+
+    glm::vec2 min, max;
+    get_box(platforms[index], min, max);
+    m_movers.push_back(index);
+    m_mover_proxies.push_back(m_mover_tree.insert(index, min, max));
+    m_mover_centres.push_back(glm::vec2(platforms[index].get_position()));
+    return false;
+}
+
+void PlatformBroadphase::clear_movers()
+{
+    m_movers.clear();
+    m_mover_proxies.clear();
+    m_mover_centres.clear();
+    m_mover_tree.clear();
+    m_refiled.clear();
+    m_refiled_proxies.clear();
+}
+
+void PlatformBroadphase::append_movers(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates) const
+{
+    if (m_movers.empty() && m_refiled.empty()) return;
+
+    // Where a refiled platform was filed is stale; the tree has where it is now
+    if (!m_refiled.empty())
+    {
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [this](int index) { return std::binary_search(m_refiled.begin(), m_refiled.end(), index); }),
+                         candidates.end());
+    }
+
+    // The tree's order is its own, so its share is sorted before both lists merge
+    size_t filed_count = candidates.size();
+    m_mover_tree.query(min, max, candidates);
+    std::sort(candidates.begin() + filed_count, candidates.end());
+    std::inplace_merge(candidates.begin(), candidates.begin() + filed_count, candidates.end());
+}
+
+void PlatformBroadphase::sync_movers(const Entity* platforms)
+{
+    for (size_t i = 0; i < m_movers.size(); i++)
+    {
+        const Entity& platform = platforms[m_movers[i]];
+        glm::vec2 min, max,
+                  centre = glm::vec2(platform.get_position());
+        get_box(platform, min, max);
+
+        m_mover_tree.move(m_mover_proxies[i], min, max, centre - m_mover_centres[i]);
+        m_mover_centres[i] = centre;
+    }
+}
+
+void PlatformBroadphase::refile(const Entity* platforms, int index)
+{
+    glm::vec2 min, max;
+    get_box(platforms[index], min, max);
+
+    // Moved before: just its leaf, which a short drag mostly leaves inside its fat box
+    auto position = std::lower_bound(m_refiled.begin(), m_refiled.end(), index);
+    size_t slot = position - m_refiled.begin();
+    if (position != m_refiled.end() && *position == index)
+    {
+        m_mover_tree.move(m_refiled_proxies[slot], min, max, glm::vec2(0.0f));
+        return;
+    }
+
+    m_refiled.insert(position, index);
+    m_refiled_proxies.insert(m_refiled_proxies.begin() + slot, m_mover_tree.insert(index, min, max));
+}
+
+void PlatformBroadphase::query_mover_pairs(std::vector<glm::ivec2>& pairs) const
+{
+    pairs.clear();
+    std::vector<int> candidates;
+    int cursor = -1;
+
+    for (size_t i = 0; i < m_movers.size(); i++)
+    {
+        int proxy = m_mover_proxies[i];
+        query(m_mover_tree.get_fat_min(proxy), m_mover_tree.get_fat_max(proxy), candidates, cursor);
+
+        // The query answers with the movers too, this one included; both lists are ascending
+        for (int candidate : candidates)
+        {
+            if (!std::binary_search(m_movers.begin(), m_movers.end(), candidate)) pairs.push_back(glm::ivec2(m_movers[i], candidate));
+        }
+    }
+}
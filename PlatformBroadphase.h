@@ -0,0 +1,61 @@
+#pragma once
+
+// Common face of the platform broadphases, so Entity can take whichever suits the level. The
+// static platforms are filed in whatever structure the subclass builds; the movers go in a
+// DynamicAabbTree here, and every query answers from both.
+//
+// A static platform moved after the build (by the level editor) is refiled rather than rebuilt:
+// its old filing is skipped from then on and it goes in the tree with the movers, so a move costs
+// a reinsertion however big the level is. The next build files it where it ended up.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "DynamicAabbTree.h"
+
+class Entity;
+
+class PlatformBroadphase
+{
+private:
+    std::vector<int>       m_mover_proxies;  // each mover's leaf in m_mover_tree
+    std::vector<glm::vec2> m_mover_centres;  // as of the last sync, for how far they moved
+    DynamicAabbTree        m_mover_tree;
+
+    // Static platforms refiled since the build, ascending, and each one's leaf in m_mover_tree
+    std::vector<int> m_refiled;
+    std::vector<int> m_refiled_proxies;
+
+protected:
+    // Only STATIC_BODY platforms are filed at build time and never touched again. Anything that
+    // can move goes in this dense list instead, ascending, and into the tree.
+    std::vector<int> m_movers;
+
+    // Returns whether the platform is static and should be filed; movers are recorded here
+    bool file_or_track(const Entity* platforms, int index);
+    void clear_movers();
+    // Drops the refiled platforms' old filings from the candidates, then merges in the movers and
+    // refiled platforms whose fat boxes overlap [min, max], in index order
+    void append_movers(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates) const;
+
+public:
+    virtual ~PlatformBroadphase() {}
+
+    // Indices of every platform that may overlap the box, ascending and without repeats.
+    // `cursor` belongs to the caller and lets an index resume from where the last query left
+    // off; -1 means no history. Indices that have no use for it leave it alone.
+    virtual void query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const = 0;
+
+    // After the movers have moved, before anything queries: only those that left their fat boxes
+    // are refiled
+    void sync_movers(const Entity* platforms);
+
+    // After a static platform was moved: files it where it is now, until the next build
+    void refile(const Entity* platforms, int index);
+
+    // Every (mover, static platform) pair whose boxes may overlap, as x and y, each mover's fat box
+    // queried in turn so the index's cursor carries over from one to the next
+    void query_mover_pairs(std::vector<glm::ivec2>& pairs) const;
+
+    int       const get_mover_count()        const { return (int)m_movers.size(); };
+    int       const get_refiled_count()      const { return (int)m_refiled.size(); };
+    long long const get_mover_reinsertions() const { return m_mover_tree.get_reinsertions(); };
+};
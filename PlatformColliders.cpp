@@ -0,0 +1,91 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <limits>
+#include "PlatformColliders.h"
+
+ColliderBox make_collider_box(const Entity& platform)
+{
+    ColliderBox box;
+    box.x = platform.get_physics_position().x;
+    box.y = platform.get_physics_position().y;
+    box.width = platform.get_physics_width();
+    box.height = platform.get_physics_height();
+    box.entity_type = (unsigned char)platform.get_entity_type();
+    box.active = platform.is_active();
+    return box;
+}
+
+void PlatformColliders::build(const Entity* platforms, int platform_count)
+{
+    clear();
+    m_boxes.resize(platform_count);
+#ifndef LANDER_FIXED_POINT
+    m_overlap_x.resize(platform_count);
+    m_overlap_y.resize(platform_count);
+    m_overlap_width.resize(platform_count);
+    m_overlap_height.resize(platform_count);
+#endif
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        m_boxes[i] = make_collider_box(platforms[i]);
+        if (platforms[i].get_body_type() != STATIC_BODY) m_movers.push_back(i);
+#ifndef LANDER_FIXED_POINT
+        set_overlap_box(i);
+#endif
+    }
+}
+
+#ifndef LANDER_FIXED_POINT
+void PlatformColliders::set_overlap_box(int index)
+{
+    const ColliderBox& box = m_boxes[index];
+    m_overlap_x[index] = box.x;
+    m_overlap_y[index] = box.y;
+    m_overlap_width[index] = box.active ? box.width : -std::numeric_limits<float>::infinity();
+    m_overlap_height[index] = box.height;
+}
+#endif
+
+void PlatformColliders::sync_movers(const Entity* platforms)
+{
+    for (int index : m_movers)
+    {
+        m_boxes[index].x = platforms[index].get_physics_position().x;
+        m_boxes[index].y = platforms[index].get_physics_position().y;
+        m_boxes[index].active = platforms[index].is_active();
+#ifndef LANDER_FIXED_POINT
+        set_overlap_box(index);
+#endif
+    }
+}
+
+void PlatformColliders::sync_platform(const Entity* platforms, int index)
+{
+    m_boxes[index] = make_collider_box(platforms[index]);
+#ifndef LANDER_FIXED_POINT
+    set_overlap_box(index);
+#endif
+    m_edits++;
+}
+
+void PlatformColliders::clear()
+{
+    m_boxes.clear();
+    m_movers.clear();
+#ifndef LANDER_FIXED_POINT
+    m_overlap_x.clear();
+    m_overlap_y.clear();
+    m_overlap_width.clear();
+    m_overlap_height.clear();
+#endif
+    m_version++;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+// The part of every platform that collision actually reads, packed apart from the render and
+// animation state that makes up most of an Entity: 20 bytes a platform instead of a few hundred,
+// in one array, so a pass over 100k platforms streams through memory instead of striding.
+#include <vector>
+#include "Entity.h"
+#include "OverlapKernels.h"
+
+// Plain data, so snapshots store platforms the same way
+struct ColliderBox
+{
+    PhysicsScalar x, y,
+                  width, height;
+    unsigned char entity_type,  // an EntityType
+                  active;
+};
+
+ColliderBox make_collider_box(const Entity& platform);
+
+class PlatformColliders
+{
+private:
+    // One allocation for the lot; a single small level then fits in a few cache lines
+    std::vector<ColliderBox> m_boxes;
+
+    // Platforms that aren't STATIC_BODY, whose positions sync_movers() copies back each step
+    std::vector<int> m_movers;
+
+    int m_version = 0;  // bumped by build() and clear(), so caches can tell a new level apart
+    int m_edits   = 0;  // bumped by sync_platform(), for caches of where static platforms are
+
+#ifndef LANDER_FIXED_POINT
+    // The boxes again as float columns, for OverlapKernels; an inactive box is -infinity wide
+    std::vector<float> m_overlap_x, m_overlap_y,
+                       m_overlap_width, m_overlap_height;
+
+    void set_overlap_box(int index);
+#endif
+
+public:
+    void build(const Entity* platforms, int platform_count);
+    void sync_movers(const Entity* platforms);
+    // One static platform again, after the level editor moved it
+    void sync_platform(const Entity* platforms, int index);
+    void clear();
+
+    int const get_count()   const { return (int)m_boxes.size(); };
+    int const get_version() const { return m_version; };
+    int const get_edits()   const { return m_edits; };
+    const std::vector<int>& get_movers() const { return m_movers; };
+
+    PhysicsScalar const get_x(int index)      const { return m_boxes[index].x; };
+    PhysicsScalar const get_y(int index)      const { return m_boxes[index].y; };
+    PhysicsScalar const get_width(int index)  const { return m_boxes[index].width; };
+    PhysicsScalar const get_height(int index) const { return m_boxes[index].height; };
+    EntityType    const get_entity_type(int index) const { return (EntityType)m_boxes[index].entity_type; };
+    bool          const is_active(int index)  const { return m_boxes[index].active != 0; };
+
+#ifndef LANDER_FIXED_POINT
+    OverlapBoxes const get_overlap_boxes() const
+    {
+        return { m_overlap_x.data(), m_overlap_y.data(), m_overlap_width.data(), m_overlap_height.data() };
+    };
+#endif
+};
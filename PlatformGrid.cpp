@@ -0,0 +1,132 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "PlatformGrid.h"
+#include "Entity.h"
+
+void PlatformGrid::clear()
+{
+    clear_movers();
+    m_cell_starts.clear();
+    m_cell_items.clear();
+    m_columns = m_rows = 0;
+}
+
+// Clamped as a float first, so a lander far off the level can't overflow the int conversion
+static int to_cell(float offset, float cell_size, int cell_count)
+{
+    return (int)std::min(std::max(floorf(offset / cell_size), -1.0f), (float)cell_count);
+}
+
+void PlatformGrid::cell_range(glm::vec2 min, glm::vec2 max, int& first_column, int& first_row, int& last_column, int& last_row) const
+{
+    first_column = std::max(0, to_cell(min.x - m_origin.x, m_cell_size, m_columns));
+    first_row    = std::max(0, to_cell(min.y - m_origin.y, m_cell_size, m_rows));
+    last_column  = std::min(m_columns - 1, to_cell(max.x - m_origin.x, m_cell_size, m_columns));
+    last_row     = std::min(m_rows - 1,    to_cell(max.y - m_origin.y, m_cell_size, m_rows));
+}
+
+void PlatformGrid::build(const Entity* platforms, int platform_count, float cell_size)
+{
+    clear();
+
+    // STEP 1: Bounds of the whole level, and the cell size if none was given
+    glm::vec2 min = glm::vec2(INFINITY), max = glm::vec2(-INFINITY);
+    float largest_extent = 0.0f;
+    std::vector<int> filed;
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        if (!file_or_track(platforms, i)) continue;
+        filed.push_back(i);
+
+        glm::vec2 half_size = glm::vec2(platforms[i].get_width(), platforms[i].get_height()) / 2.0f;
+        glm::vec2 centre = glm::vec2(platforms[i].get_position());
+
+        min = glm::min(min, centre - half_size);
+        max = glm::max(max, centre + half_size);
+        largest_extent = std::max(largest_extent, std::max(half_size.x, half_size.y) * 2.0f);
+    }
+
+    if (filed.empty()) return;
+
+    m_cell_size = cell_size > 0.0f ? cell_size : std::max(largest_extent, 0.001f);
+    m_origin    = min;
+    m_columns   = (int)floor((max.x - min.x) / m_cell_size) + 1;
+    m_rows      = (int)floor((max.y - min.y) / m_cell_size) + 1;
+
+    // STEP 2: Count how many platforms touch each cell, then turn the counts into offsets
+    m_cell_starts.assign(m_columns * m_rows + 1, 0);
+
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<int> cursor;
+        if (pass == 1)
+        {
+            for (int c = 1; c <= m_columns * m_rows; c++) m_cell_starts[c] += m_cell_starts[c - 1];
+            m_cell_items.resize(m_cell_starts.back());
+            cursor.assign(m_cell_starts.begin(), m_cell_starts.end() - 1);
+        }
+
+        // STEP 3: On the second pass, file every platform into the cells it touches. Platforms are
+        //         visited in index order, so every cell list comes out already sorted.
+        for (int i : filed)
+        {
+            glm::vec2 half_size = glm::vec2(platforms[i].get_width(), platforms[i].get_height()) / 2.0f;
+            glm::vec2 centre = glm::vec2(platforms[i].get_position());
+
+            int first_column, first_row, last_column, last_row;
+            cell_range(centre - half_size, centre + half_size, first_column, first_row, last_column, last_row);
+
+            for (int row = first_row; row <= last_row; row++)
+            {
+                for (int column = first_column; column <= last_column; column++)
+                {
+                    int cell = row * m_columns + column;
+                    if (pass == 0) m_cell_starts[cell + 1]++;
+                    else           m_cell_items[cursor[cell]++] = i;
+                }
+            }
+        }
+    }
+}
+
+void PlatformGrid::query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& /*cursor*/) const
+{
+    candidates.clear();
+    if (is_empty())
+    {
+        append_movers(min, max, candidates);
+        return;
+    }
+
+    int first_column, first_row, last_column, last_row;
+    cell_range(min, max, first_column, first_row, last_column, last_row);
+
+    for (int row = first_row; row <= last_row; row++)
+    {
+        for (int column = first_column; column <= last_column; column++)
+        {
+            int cell = row * m_columns + column;
+            candidates.insert(candidates.end(), m_cell_items.begin() + m_cell_starts[cell], m_cell_items.begin() + m_cell_starts[cell + 1]);
+        }
+    }
+
+    // A box spanning several cells sees the platforms that straddle them more than once
+    if (first_column != last_column || first_row != last_row)
+    {
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    append_movers(min, max, candidates);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+// Static uniform grid over the platforms, built once after they are placed. Each cell lists
+// the platforms whose box touches it, so a query only visits the cells a box overlaps instead
+// of every platform in the level.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "PlatformBroadphase.h"
+
+class Entity;
+
+class PlatformGrid : public PlatformBroadphase
+{
+private:
+    glm::vec2 m_origin = glm::vec2(0.0f);
+    float     m_cell_size = 1.0f;
+    int       m_columns = 0,
+              m_rows    = 0;
+
+    // Compressed cell lists: the platforms of cell c are m_cell_items[m_cell_starts[c] .. m_cell_starts[c + 1])
+    std::vector<int> m_cell_starts;
+    std::vector<int> m_cell_items;
+
+    void cell_range(glm::vec2 min, glm::vec2 max, int& first_column, int& first_row, int& last_column, int& last_row) const;
+
+public:
+    // A cell_size of 0 picks the largest platform extent, so most platforms land in one to four cells
+    void build(const Entity* platforms, int platform_count, float cell_size = 0.0f);
+    void clear();
+
+    // Ascending order keeps collision resolution in the same order as a full scan; no cursor needed
+    void query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const override;
+
+    bool  const is_empty()      const { return m_cell_starts.empty(); };
+    float const get_cell_size() const { return m_cell_size; };
+    int   const get_cell_count() const { return m_columns * m_rows; };
+};
@@ -0,0 +1,101 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "PlatformIntervalIndex.h"
+#include "Entity.h"
+
+void PlatformIntervalIndex::clear()
+{
+    clear_movers();
+    m_min_x.clear();
+    m_max_x.clear();
+    m_min_y.clear();
+    m_max_y.clear();
+    m_indices.clear();
+    m_widest = 0.0f;
+    m_in_index_order = true;
+}
+
+void PlatformIntervalIndex::build(const Entity* platforms, int platform_count)
+{
+    clear();
+
+    std::vector<int> order;
+    for (int i = 0; i < platform_count; i++)
+    {
+        if (file_or_track(platforms, i)) order.push_back(i);
+    }
+
+    // Stable, so platforms sharing a left edge stay in index order
+    std::stable_sort(order.begin(), order.end(), [platforms](int a, int b)
+        {
+            return platforms[a].get_position().x - platforms[a].get_width() / 2.0f <
+                   platforms[b].get_position().x - platforms[b].get_width() / 2.0f;
+        });
+
+    for (int index : order)
+    {
+        glm::vec3 position = platforms[index].get_position();
+        float half_width  = platforms[index].get_width() / 2.0f,
+              half_height = platforms[index].get_height() / 2.0f;
+
+        m_min_x.push_back(position.x - half_width);
+        m_max_x.push_back(position.x + half_width);
+        m_min_y.push_back(position.y - half_height);
+        m_max_y.push_back(position.y + half_height);
+        m_indices.push_back(index);
+
+        m_widest = std::max(m_widest, half_width * 2.0f);
+    }
+
+    // Already true for generate_platforms; when it holds, query results need no re-sort
+    m_in_index_order = std::is_sorted(m_indices.begin(), m_indices.end());
+}
+
+int PlatformIntervalIndex::seek(float min_x, int cursor) const
+{
+    // First entry whose left edge is at or past min_x
+    const int count = (int)m_min_x.size();
+
+    if (cursor >= 0 && cursor <= count)
+    {
+        for (int steps = 0; steps < MAX_CURSOR_WALK; steps++)
+        {
+            if (cursor > 0 && m_min_x[cursor - 1] >= min_x) cursor--;
+            else if (cursor < count && m_min_x[cursor] < min_x) cursor++;
+            else return cursor;
+        }
+    }
+
+    return (int)(std::lower_bound(m_min_x.begin(), m_min_x.end(), min_x) - m_min_x.begin());
+}
+
+void PlatformIntervalIndex::query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const
+{
+    candidates.clear();
+    if (is_empty())
+    {
+        append_movers(min, max, candidates);
+        return;
+    }
+
+    // Nothing that starts further left than the widest platform can reach min.x
+    cursor = seek(min.x - m_widest, cursor);
+
+    for (int i = cursor; i < (int)m_min_x.size() && m_min_x[i] <= max.x; i++)
+    {
+        if (m_max_x[i] < min.x || m_max_y[i] < min.y || m_min_y[i] > max.y) continue;
+        candidates.push_back(m_indices[i]);
+    }
+
+    if (!m_in_index_order) std::sort(candidates.begin(), candidates.end());
+    append_movers(min, max, candidates);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Platforms sorted by their left edge (sweep and prune along x). A row of platforms — which is
+// what generate_platforms lays out — costs two floats and an int per platform, and a lander that
+// moves a little each step finds its spot again by walking from its last cursor.
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "PlatformBroadphase.h"
+
+class Entity;
+
+class PlatformIntervalIndex : public PlatformBroadphase
+{
+private:
+    // A walk longer than this is a teleport (a reset, a new episode), so binary search instead
+    static const int MAX_CURSOR_WALK = 8;
+
+    // Parallel arrays, in order of increasing min_x
+    std::vector<float> m_min_x, m_max_x,
+                       m_min_y, m_max_y;
+    std::vector<int>   m_indices;
+
+    float m_widest = 0.0f;  // how far left of a query a platform can start and still reach it
+    bool  m_in_index_order = true;
+
+    int seek(float min_x, int cursor) const;
+
+public:
+    void build(const Entity* platforms, int platform_count);
+    void clear();
+
+    void query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const override;
+
+    bool const is_empty() const { return m_indices.empty(); };
+};
@@ -0,0 +1,170 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "PlatformColliders.h"
+#include "PlatformQueryBatch.h"
+#include "Entity.h"
+
+static bool overlaps(const glm::vec4& bounds, glm::vec2 min, glm::vec2 max)
+{
+    return !(bounds.z < min.x || bounds.x > max.x || bounds.w < min.y || bounds.y > max.y);
+}
+
+glm::vec4 PlatformQueryBatch::get_bounds(int index) const
+{
+    // The packed copy is what collision reads when there is one
+    glm::vec2 position, half_size;
+    if (m_colliders != NULL)
+    {
+        position  = glm::vec2((float)m_colliders->get_x(index), (float)m_colliders->get_y(index));
+        half_size = glm::vec2((float)m_colliders->get_width(index), (float)m_colliders->get_height(index)) / 2.0f;
+    }
+    else
+    {
+        position  = glm::vec2(m_platforms[index].get_position());
+        half_size = glm::vec2(m_platforms[index].get_width(), m_platforms[index].get_height()) / 2.0f;
+    }
+
+    return glm::vec4(position - half_size, position + half_size);
+}
+
+bool const PlatformQueryBatch::contains(const Region& region, glm::vec2 min, glm::vec2 max) const
+{
+    return min.x >= region.min.x && min.y >= region.min.y && max.x <= region.max.x && max.y <= region.max.y;
+}
+
+void PlatformQueryBatch::scan(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates) const
+{
+    candidates.clear();
+    for (int i = 0; i < m_platform_count; i++)
+    {
+        if (overlaps(get_bounds(i), min, max)) candidates.push_back(i);
+    }
+}
+
+void PlatformQueryBatch::begin(const Entity* platforms, int platform_count, const PlatformColliders* colliders)
+{
+    // Another level, or platforms that may have moved since the last fill. Without colliders
+    // there is no list of movers to tell, so nothing is kept.
+    bool same_level = platforms == m_platforms && platform_count == m_platform_count && colliders == m_colliders &&
+                      (colliders == NULL || (colliders->get_version() == m_version && colliders->get_edits() == m_edits));
+    bool has_movers = colliders == NULL || !colliders->get_movers().empty();
+    if (!same_level || has_movers) m_refill_all = true;
+
+    m_platforms = platforms;
+    m_platform_count = platform_count;
+    m_colliders = colliders;
+    m_lander_boxes.clear();
+}
+
+void PlatformQueryBatch::add_lander(const Entity& lander, float delta_time)
+{
+    // Anywhere this step's move can take the lander. Static and inactive landers never query,
+    // but keep their place so every region stays with its lander.
+    glm::vec2 velocity  = glm::vec2(lander.get_velocity()) + glm::vec2(lander.get_acceleration()) * delta_time;
+    glm::vec2 reach     = glm::abs(velocity) * delta_time + Entity::BROADPHASE_MARGIN;
+    glm::vec2 position  = glm::vec2(lander.get_position()),
+              half_size = glm::vec2(lander.get_width(), lander.get_height()) / 2.0f;
+
+    if (!lander.is_active() || lander.get_body_type() != DYNAMIC_BODY) reach = half_size = glm::vec2(0.0f);
+
+    m_lander_boxes.push_back(glm::vec4(position - half_size - reach, position + half_size + reach));
+}
+
+void PlatformQueryBatch::gather()
+{
+    // STEP 1: Which regions their landers have left
+    if (m_regions.size() != m_lander_boxes.size())
+    {
+        m_regions.resize(m_lander_boxes.size());
+        m_refill_all = true;
+    }
+
+    m_stale.clear();
+    for (int i = 0; i < (int)m_regions.size(); i++)
+    {
+        const glm::vec4& box = m_lander_boxes[i];
+        if (m_refill_all || !contains(m_regions[i], glm::vec2(box.x, box.y), glm::vec2(box.z, box.w))) m_stale.push_back(i);
+    }
+
+    m_refill_all = false;
+    m_version = m_colliders != NULL ? m_colliders->get_version() : -1;
+    m_edits   = m_colliders != NULL ? m_colliders->get_edits() : -1;
+    if (m_stale.empty()) return;
+    m_fills++;
+
+    for (int i : m_stale)
+    {
+        const glm::vec4& box = m_lander_boxes[i];
+        Region& region = m_regions[i];
+
+        region.min = glm::vec2(box.x, box.y) - REGION_MARGIN;
+        region.max = glm::vec2(box.z, box.w) + REGION_MARGIN;
+        region.candidates.clear();
+        region.bounds.clear();
+    }
+
+    // STEP 2: Refill them all in one pass over the platforms, with each candidate's box kept next
+    //         to it for the filter. Most platforms miss every region, which one test against
+    //         their union settles.
+    glm::vec2 union_min = m_regions[m_stale[0]].min,
+              union_max = m_regions[m_stale[0]].max;
+    for (int i : m_stale)
+    {
+        union_min = glm::min(union_min, m_regions[i].min);
+        union_max = glm::max(union_max, m_regions[i].max);
+    }
+
+    for (int index = 0; index < m_platform_count; index++)
+    {
+        glm::vec4 bounds = get_bounds(index);
+        if (!overlaps(bounds, union_min, union_max)) continue;
+
+        for (int i : m_stale)
+        {
+            Region& region = m_regions[i];
+            if (!overlaps(bounds, region.min, region.max)) continue;
+
+            region.candidates.push_back(index);
+            region.bounds.push_back(bounds);
+        }
+    }
+}
+
+void PlatformQueryBatch::query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const
+{
+    // STEP 1: The cursor holds the caller's region from last time; search the rest only if it moved
+    int region_index = -1;
+    if (cursor >= 0 && cursor < (int)m_regions.size() && contains(m_regions[cursor], min, max)) region_index = cursor;
+    for (int i = 0; i < (int)m_regions.size() && region_index < 0; i++)
+    {
+        if (contains(m_regions[i], min, max)) region_index = i;
+    }
+
+    // STEP 2: Outside every region, only a scan of the lot will do
+    if (region_index < 0)
+    {
+        m_fallback_queries++;
+        scan(min, max, candidates);
+        return;
+    }
+
+    m_batched_queries++;
+    cursor = region_index;
+
+    const Region& region = m_regions[region_index];
+    candidates.clear();
+    for (size_t k = 0; k < region.candidates.size(); k++)
+    {
+        if (overlaps(region.bounds[k], min, max)) candidates.push_back(region.candidates[k]);
+    }
+}
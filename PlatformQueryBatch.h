@@ -0,0 +1,72 @@
+#pragma once
+
+// A broadphase for several landers in a level that has none: their platform queries for a step
+// come out of one shared scan instead of every lander scanning the whole level on its own. Each
+// lander gets a region (its swept box plus a margin) holding the platforms that reach into it;
+// the queries it makes while it collides are filtered out of that short list, and the caller's
+// cursor remembers which region is its own.
+//
+// Like Entity's contact cache, a region is kept from step to step while its lander stays inside
+// it, and the ones that ran out are refilled together. A query outside every region scans, so
+// the answer is always the set, in the order, a full scan would have given.
+//
+// A level with a real broadphase is better off without this: its cursors already make every
+// lander's own query close to free (see bench_landers).
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "PlatformBroadphase.h"
+
+class Entity;
+class PlatformColliders;
+
+class PlatformQueryBatch : public PlatformBroadphase
+{
+private:
+    // How far past its swept box a lander's region reaches when filled
+    static constexpr float REGION_MARGIN = 0.5f;
+
+    struct Region
+    {
+        glm::vec2              min = glm::vec2(0.0f),
+                               max = glm::vec2(-1.0f);  // empty until filled
+        std::vector<int>       candidates;              // ascending, as a full scan finds them
+        std::vector<glm::vec4> bounds;                  // min x, min y, max x, max y of each candidate
+    };
+
+    const Entity*            m_platforms      = NULL;
+    const PlatformColliders* m_colliders      = NULL;
+    int                      m_platform_count = 0,
+                             m_version        = -1,  // the colliders' at the last fill
+                             m_edits          = -1;
+
+    std::vector<Region>    m_regions;       // one per lander, in the order they were added
+    std::vector<glm::vec4> m_lander_boxes;  // this step's swept boxes, likewise
+    std::vector<int>       m_stale;         // regions gather() has to refill
+    bool                   m_refill_all = true;
+
+    mutable long long m_fills            = 0,
+                      m_batched_queries  = 0,
+                      m_fallback_queries = 0;
+
+    glm::vec4 get_bounds(int index) const;
+    bool const contains(const Region& region, glm::vec2 min, glm::vec2 max) const;
+    // Every platform overlapping the box
+    void scan(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates) const;
+
+public:
+    // Starts a step over the same platforms and colliders the landers collide with
+    void begin(const Entity* platforms, int platform_count, const PlatformColliders* colliders);
+    // Before gather(), once per lander stepped by delta_time, in the same order every step
+    void add_lander(const Entity& lander, float delta_time);
+    // Refills the regions whose landers left them
+    void gather();
+    // Forces the next gather() to refill everything, for platforms changed behind the colliders' back
+    void invalidate() { m_refill_all = true; };
+
+    void query(glm::vec2 min, glm::vec2 max, std::vector<int>& candidates, int& cursor) const override;
+
+    int       const get_region_count()     const { return (int)m_regions.size(); };
+    long long const get_fills()            const { return m_fills; };
+    long long const get_batched_queries()  const { return m_batched_queries; };
+    long long const get_fallback_queries() const { return m_fallback_queries; };
+};
@@ -0,0 +1,256 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <chrono>
+#include "ForceFields.h"
+#include "InputReplay.h"
+#include "PolicyFleet.h"
+#include "Trace.h"
+
+const glm::vec4 PolicyFleet::TINT = glm::vec4(1.0f, 0.7f, 0.45f, 1.0f);
+
+bool PolicyFleet::load(const char* filepath, int lander_count)
+{
+    if (!m_network.load(filepath)) return false;
+    if (m_network.get_output_size() != OUTPUT_SIZE || m_network.get_input_size() > LANDER_OBSERVATION_SIZE)
+    {
+        m_network = PolicyNetwork();
+        return false;
+    }
+
+    lander_count = std::min(std::max(lander_count, 1), MAX_LANDERS);
+    m_landers.assign(lander_count, Entity());
+    m_outcomes.assign(lander_count, LanderOutcome());
+    m_flying.reserve(lander_count);
+    m_deciding.reserve(lander_count);
+    m_last_steps.assign(lander_count, 0);
+    m_observations.assign((size_t)lander_count * LANDER_OBSERVATION_SIZE, 0.0f);
+    m_scores.assign((size_t)lander_count * OUTPUT_SIZE, 0.0f);
+    m_instances.assign(lander_count, SpriteInstance());
+    return true;
+}
+
+void PolicyFleet::initialise(ShaderProgram* program, GLuint texture_id, const glm::vec4* frames)
+{
+    m_program = program;
+    m_texture_id = texture_id;
+    for (int i = 0; i < 3; i++) m_frames[i] = frames[i];
+
+    m_renderer.initialise(program);
+    if (m_renderer.is_supported() && !m_landers.empty()) m_group = m_renderer.add_group(program, texture_id, m_instances, true);
+}
+
+void PolicyFleet::cleanup()
+{
+    m_renderer.cleanup();
+    m_group = -1;
+}
+
+void PolicyFleet::restart(const GameState& level)
+{
+    // STEP 1: The game's level, shared, as GhostFleet shares it
+    m_idle.deactivate();
+    m_state.player = &m_idle;
+    m_state.platforms = level.platforms;
+    m_state.platform_count = level.platform_count;
+    m_state.platform_broadphase = level.platform_broadphase;
+    m_state.platform_colliders = level.platform_colliders;
+    m_state.terrain = level.terrain;
+    m_state.distance_field = level.distance_field;
+    m_state.force_fields = level.force_fields;
+    m_state.fixed_timestep = level.fixed_timestep;
+    m_state.landers = m_landers.data();
+    m_state.lander_outcomes = m_outcomes.data();
+    m_state.lander_count = (int)m_landers.size();
+
+    // STEP 2: What the landers aim for, found once a level rather than every step
+    m_win_platforms.clear();
+    for (int i = 0; i < level.platform_count; i++)
+    {
+        const Entity& platform = level.platforms[i];
+        if (platform.get_entity_type() == WIN_PLATFORM && platform.is_active()) m_win_platforms.push_back(glm::vec2(platform.get_position()));
+    }
+    std::sort(m_win_platforms.begin(), m_win_platforms.end(), [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+
+    // STEP 3: Every lander at rest, evenly either side of the spawn point: SPAWN_SPREAD, or
+    //         further if that would put them closer than SPAWN_SPACING
+    int count = (int)m_landers.size();
+    float spread = std::max(SPAWN_SPREAD, SPAWN_SPACING * (count - 1) / 2.0f);
+    m_flying.clear();
+    m_step_count = 0;
+    for (int i = 0; i < count; i++)
+    {
+        float offset = count > 1 ? spread * (2.0f * i / (count - 1) - 1.0f) : 0.0f;
+
+        Entity& lander = m_landers[i];
+        setup_player(&lander);
+        reset_lander(lander, level.spawn_position + glm::vec3(offset, 0.0f, 0.0f));
+        lander.activate();
+        m_outcomes[i] = LanderOutcome();
+        m_last_steps[i] = 0;
+        m_flying.push_back(i);
+    }
+}
+
+void PolicyFleet::observe(int index, float* observation) const
+{
+    const Entity& lander = m_landers[index];
+    glm::vec3 position = lander.get_position(),
+              velocity = lander.get_velocity();
+
+    // The WIN platform nearest along x, as LanderEnv picks it
+    glm::vec2 win_offset = glm::vec2(0.0f);
+    if (!m_win_platforms.empty())
+    {
+        auto after = std::lower_bound(m_win_platforms.begin(), m_win_platforms.end(), position.x,
+                                      [](const glm::vec2& platform, float x) { return platform.x < x; });
+
+        glm::vec2 nearest;
+        if      (after == m_win_platforms.begin()) nearest = *after;
+        else if (after == m_win_platforms.end())   nearest = *(after - 1);
+        else    nearest = (position.x - (after - 1)->x <= after->x - position.x) ? *(after - 1) : *after;
+
+        win_offset = nearest - glm::vec2(position);
+    }
+
+    observation[LANDER_OBS_POSITION_X]     = position.x;
+    observation[LANDER_OBS_POSITION_Y]     = position.y;
+    observation[LANDER_OBS_VELOCITY_X]     = velocity.x;
+    observation[LANDER_OBS_VELOCITY_Y]     = velocity.y;
+    observation[LANDER_OBS_WIN_OFFSET_X]   = win_offset.x;
+    observation[LANDER_OBS_WIN_OFFSET_Y]   = win_offset.y;
+    observation[LANDER_OBS_CONTACT_TOP]    = lander.m_collided_top    ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_BOTTOM] = lander.m_collided_bottom ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_LEFT]   = lander.m_collided_left   ? 1.0f : 0.0f;
+    observation[LANDER_OBS_CONTACT_RIGHT]  = lander.m_collided_right  ? 1.0f : 0.0f;
+}
+
+void PolicyFleet::set_view(glm::vec2 view_min, glm::vec2 view_max)
+{
+    m_view_min = view_min;
+    m_view_max = view_max;
+    m_has_view = true;
+}
+
+void PolicyFleet::translate(glm::vec2 offset)
+{
+    for (Entity& lander : m_landers) lander.translate(glm::vec3(offset, 0.0f));
+    for (glm::vec2& platform : m_win_platforms) platform += offset;
+    m_view_min += offset;
+    m_view_max += offset;
+}
+
+int PolicyFleet::get_lod(int index) const
+{
+    if (!m_has_view) return LOD_NEAR;
+
+    // How far outside the screen the lander is, 0 anywhere on it
+    glm::vec2 position = glm::vec2(m_landers[index].get_position()),
+              outside  = glm::max(glm::max(m_view_min - position, position - m_view_max), glm::vec2(0.0f));
+    float distance = std::max(outside.x, outside.y);
+
+    if (distance <= NEAR_MARGIN)   return LOD_NEAR;
+    if (distance <= PARK_DISTANCE) return LOD_FAR;
+    return LOD_PARKED;
+}
+
+void PolicyFleet::step()
+{
+    if (m_flying.empty()) return;
+    TRACE_ZONE("PolicyFleet::step");
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // STEP 1: Down is down: those landers stay where they ended, and the steps pass them by. So
+    //         do any that never find the ground, after long enough.
+    bool timed_out = ++m_step_count * m_state.fixed_timestep > MAX_FLIGHT_SECONDS;
+    size_t kept = 0;
+    for (int index : m_flying)
+    {
+        if (timed_out || m_outcomes[index].win || m_outcomes[index].loss) m_landers[index].deactivate();
+        else m_flying[kept++] = index;
+    }
+    m_flying.resize(kept);
+    if (m_flying.empty()) return;
+
+    // STEP 2: Which of them step this time: every near one, the far ones whose turn it is. Parked
+    //         ones let the time go by, so they don't make it all up at once when they wake.
+    for (int& count : m_lod_counts) count = 0;
+    m_deciding.clear();
+    for (int index : m_flying)
+    {
+        int lod = get_lod(index);
+        m_lod_counts[lod]++;
+
+        bool due = lod == LOD_NEAR || (lod == LOD_FAR && (m_step_count + index) % FAR_STEP_INTERVAL == 0);
+        if (due) m_deciding.push_back(index);
+        else if (lod == LOD_PARKED) m_last_steps[index] = m_step_count;
+    }
+    int count = (int)m_deciding.size();
+    if (count == 0) return;
+
+    // STEP 3: Every lander due observed, then all of them through the network at once...
+    for (int i = 0; i < count; i++) observe(m_deciding[i], &m_observations[(size_t)i * LANDER_OBSERVATION_SIZE]);
+    m_network.evaluate(m_observations.data(), LANDER_OBSERVATION_SIZE, count, m_scores.data(), OUTPUT_SIZE);
+
+    // STEP 4: ...and each holding whatever its scores say
+    for (int i = 0; i < count; i++)
+    {
+        const float* scores = &m_scores[(size_t)i * OUTPUT_SIZE];
+        int action = (scores[0] > 0.0f ? REPLAY_LEFT : 0) | (scores[1] > 0.0f ? REPLAY_RIGHT : 0) | (scores[2] > 0.0f ? REPLAY_BOOST : 0);
+        apply_replay_action(&m_landers[m_deciding[i]], action);
+    }
+    m_decide_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    m_decide_count++;
+
+    // STEP 5: Each over however many steps it's been since it last moved (one, for near landers),
+    //         against the same level, as step_simulation would step them
+    sync_movers(m_state);
+    m_events.clear();
+    for (int index : m_deciding)
+    {
+        Entity& lander = m_landers[index];
+        float delta_time = (m_step_count - m_last_steps[index]) * m_state.fixed_timestep;
+        m_last_steps[index] = m_step_count;
+
+        if (m_state.force_fields != NULL) lander.set_field_acceleration(m_state.force_fields->get_acceleration(glm::vec2(lander.get_position())));
+        int first = m_events.get_count();
+        m_events.set_lander(index + 1);
+        lander.update(delta_time, m_state.platforms, m_state.platform_count, &m_events, m_state.platform_broadphase,
+                      m_state.platform_colliders, NULL, m_state.terrain, m_state.distance_field);
+        add_outcome_events(m_events, first, m_outcomes[index]);
+    }
+    m_updates += count;
+}
+
+void PolicyFleet::draw(float alpha)
+{
+    if (m_group < 0) return;
+
+    // Landers that moved this step between their last two positions; the rest where they are,
+    // since a far lander's last move was longer than one of the player's steps
+    for (size_t i = 0; i < m_landers.size(); i++)
+    {
+        const Entity& lander = m_landers[i];
+        bool flying = lander.is_active(),
+             moved  = flying && m_last_steps[i] == m_step_count;
+
+        float velocity_y = flying ? (float)lander.get_velocity().y : 0.0f;
+        int   frame      = velocity_y > 1 ? Entity::HIGH : (velocity_y > 0 ? Entity::LOW : Entity::IDLE);
+        glm::vec2 position = glm::vec2(moved ? lander.get_interpolated_position(alpha) : lander.get_position());
+        m_instances[i] = { position, glm::vec2(lander.get_width(), lander.get_height()), m_frames[frame] };
+    }
+
+    m_renderer.update_group(m_group, m_instances.data(), (int)m_instances.size());
+    m_program->set_colour(TINT.r, TINT.g, TINT.b, TINT.a);
+    m_renderer.draw(m_program);
+}
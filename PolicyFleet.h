@@ -0,0 +1,128 @@
+#pragma once
+
+// AI landers flown by a trained policy (PolicyNetwork.h), alongside the player. Built like
+// GhostFleet: the landers are the fleet's own GameState's, against the game's platforms, stepped
+// in lockstep with the player's steps and drawn in one instanced call. Before each step, every
+// lander still flying is observed as LanderEnv observes its lander, and all of them go through
+// the network in one evaluate(), so a thousand of them decide in about the time a handful would
+// take one at a time.
+//
+// The network takes the first get_input_size() fields of a LanderObservation (6 for policies
+// trained on BatchedLanderEnv, all 10 for LanderEnv's) and gives a score each for LEFT, RIGHT and
+// BOOST, held wherever the score is over 0. The landers start spread along x around the spawn
+// point, or over the whole level when there are enough of them, so that one deterministic policy
+// doesn't fly them all as one.
+//
+// With thousands of landers (a busy spaceport), what a step costs follows what the camera shows,
+// by level of detail, worked out afresh every step from the last set_view():
+//   LOD_NEAR    on screen or nearly: decides and steps at the fixed timestep, as the player does
+//   LOD_FAR     off screen: decides and steps once every FAR_STEP_INTERVAL steps, over all of them
+//               at once. Entity::update sweeps a move that long for the platforms it crosses, so
+//               far landers can't tunnel; they collide coarsely rather than wrongly. The landers
+//               due take turns, so each step updates about the same share of them.
+//   LOD_PARKED  beyond PARK_DISTANCE of the screen: held where they are, time stopped, until the
+//               camera comes back near
+// A lander drawn is always a near one, so the coarse steps are never seen.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "InstancedRenderer.h"
+#include "LanderEnv.h"
+#include "PolicyNetwork.h"
+#include "Simulation.h"
+
+enum LanderLod
+{
+    LOD_NEAR,
+    LOD_FAR,
+    LOD_PARKED,
+    LOD_COUNT
+};
+
+class PolicyFleet
+{
+private:
+    PolicyNetwork              m_network;
+    std::vector<Entity>        m_landers;       // as m_state.landers
+    std::vector<LanderOutcome> m_outcomes;
+    GameEventBuffer            m_events;        // the landers' reports this step, scored into m_outcomes
+    std::vector<int>           m_flying;        // landers in the air this step, in order
+    std::vector<int>           m_deciding;      // those of them stepped this step
+    std::vector<int>           m_last_steps;    // the step each lander was last moved on, or parked through
+    std::vector<float>         m_observations,  // a LANDER_OBSERVATION_SIZE row per flying lander
+                               m_scores;        // an OUTPUT_SIZE row per flying lander
+    std::vector<glm::vec2>     m_win_platforms; // centres, by x
+    Entity                     m_idle;          // m_state.player, never active
+    GameState                  m_state;
+
+    ShaderProgram*              m_program = NULL;  // SHADER_TEXTURED | SHADER_INSTANCED | SHADER_TINTED
+    InstancedRenderer           m_renderer;
+    int                         m_group = -1;
+    GLuint                      m_texture_id = 0;
+    glm::vec4                   m_frames[3];       // the ship's IDLE, LOW and HIGH
+    std::vector<SpriteInstance> m_instances;
+
+    glm::vec2 m_view_min = glm::vec2(0.0f),
+              m_view_max = glm::vec2(0.0f);
+    bool      m_has_view = false;          // without one, every lander is near
+    int       m_lod_counts[LOD_COUNT] = {};  // the last step's flying landers, by level of detail
+
+    int       m_step_count = 0;        // since restart()
+    long long m_updates    = 0;        // lander updates over every step so far
+    double    m_decide_seconds = 0.0;  // observing and evaluating, over every step so far
+    long long m_decide_count   = 0;
+
+    void observe(int lander, float* observation) const;
+    int  get_lod(int lander) const;
+
+public:
+    static const int       OUTPUT_SIZE  = 3,
+                           MAX_LANDERS  = 4096;
+    static const int       FAR_STEP_INTERVAL  = 4;
+    static constexpr float SPAWN_SPREAD       = 3.0f,   // either side of the spawn point, at least
+                           SPAWN_SPACING      = 0.5f,   // between landers, when they'd be closer
+                           MAX_FLIGHT_SECONDS = 60.0f,  // then any still up are grounded where they are
+                           NEAR_MARGIN        = 2.0f,   // past the screen's edges that landers are still near
+                           PARK_DISTANCE      = 30.0f;  // past the screen's edges that landers are parked
+    static const glm::vec4 TINT;
+
+    // The policy, and room for `lander_count` landers. False if the file isn't a network with
+    // OUTPUT_SIZE outputs taking at most LANDER_OBSERVATION_SIZE inputs.
+    bool load(const char* filepath, int lander_count);
+
+    // GL thread. `frames` are the ship's IDLE, LOW and HIGH frames in texture_id.
+    void initialise(ShaderProgram* program, GLuint texture_id, const glm::vec4* frames);
+    void cleanup();
+
+    // Every lander back near the spawn point, flying against `level`'s platforms. Call whenever
+    // the player starts a level.
+    void restart(const GameState& level);
+
+    // The world-space box the camera shows, for the levels of detail; once a frame
+    void set_view(glm::vec2 view_min, glm::vec2 view_max);
+
+    // Every lander and pad by `offset`, when the origin moves
+    void translate(glm::vec2 offset);
+
+    // Alongside each of the player's steps: every flying lander due a step decides, then they step
+    void step();
+
+    // GL thread: every lander drawn `alpha` of the way into its latest step, in one draw
+    void draw(float alpha);
+
+    bool         const is_loaded()          const { return m_network.is_loaded(); };
+    int          const get_lander_count()   const { return (int)m_landers.size(); };
+    int          const get_flying_count()   const { return (int)m_flying.size(); };
+    int          const get_lod_count(int lod) const { return m_lod_counts[lod]; };
+    // Mean landers stepped a step, which the levels of detail keep to what's near the screen
+    double       const get_mean_updates()   const { return m_decide_count > 0 ? (double)m_updates / m_decide_count : 0.0; };
+    const PolicyNetwork& get_network()      const { return m_network; };
+    // Mean time a step's decisions took, observing included
+    double       const get_mean_decide_ms() const { return m_decide_count > 0 ? m_decide_seconds / m_decide_count * 1000.0 : 0.0; };
+    GLuint       const get_texture_id()     const { return m_texture_id; };
+    ShaderProgram*     get_program()        const { return m_program; };
+};
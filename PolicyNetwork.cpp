@@ -0,0 +1,390 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "PolicyNetwork.h"
+#include "SimdDispatch.h"
+#include "Trace.h"
+
+#ifdef LANDER_SIMD_SSE2
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define LANDER_TARGET_AVX2
+#else
+#define LANDER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+#ifdef LANDER_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+const char PolicyNetwork::MAGIC[4] = { 'L', 'P', 'O', 'L' };
+
+// tanh(x) ~ x P(x^2) / Q(x^2), the rational fit Eigen uses for float tanh, evaluated by Horner's
+// rule in the same order by every kernel. Past the clamp it's 1 to within a float anyway.
+static const float TANH_CLAMP = 7.90531110763549805f;
+static const int   TANH_P_COUNT = 7,
+                   TANH_Q_COUNT = 4;
+static const float TANH_P[TANH_P_COUNT] = { -2.76076847742355e-16f, 2.00018790482477e-13f, -8.60467152213735e-11f, 5.12229709037114e-08f,
+                                            1.48572235717979e-05f, 6.37261928875436e-04f, 4.89352455891786e-03f },
+                   TANH_Q[TANH_Q_COUNT] = { 1.19825839466702e-06f, 1.18534705686654e-04f, 2.26843463243900e-03f, 4.89352518554385e-03f };
+
+// ————— SCALAR ————— //
+static float activate(float value, int activation)
+{
+    if (activation == POLICY_RELU) return value > 0.0f ? value : 0.0f;
+    if (activation != POLICY_TANH) return value;
+
+    float x  = std::min(std::max(value, -TANH_CLAMP), TANH_CLAMP),
+          x2 = x * x,
+          p  = TANH_P[0],
+          q  = TANH_Q[0];
+    for (int i = 1; i < TANH_P_COUNT; i++) p = p * x2 + TANH_P[i];
+    for (int i = 1; i < TANH_Q_COUNT; i++) q = q * x2 + TANH_Q[i];
+    return (p * x) / q;
+}
+
+void policy_layer_scalar(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out)
+{
+    for (int o = 0; o < output_size; o++)
+    {
+        const float* row = weights + (size_t)o * input_size;
+        float* sums = out + (size_t)o * POLICY_TILE;
+
+        for (int lane = 0; lane < POLICY_TILE; lane++) sums[lane] = biases[o];
+        for (int i = 0; i < input_size; i++)
+        {
+            const float* inputs = in + (size_t)i * POLICY_TILE;
+            for (int lane = 0; lane < POLICY_TILE; lane++)
+            {
+                float product = row[i] * inputs[lane];
+                sums[lane] = sums[lane] + product;
+            }
+        }
+        for (int lane = 0; lane < POLICY_TILE; lane++) sums[lane] = activate(sums[lane], activation);
+    }
+}
+
+// ————— SSE2 / AVX2 ————— //
+#ifdef LANDER_SIMD_SSE2
+static __m128 activate_sse2(__m128 value, int activation)
+{
+    if (activation == POLICY_RELU) return _mm_max_ps(value, _mm_setzero_ps());
+    if (activation != POLICY_TANH) return value;
+
+    __m128 x  = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-TANH_CLAMP)), _mm_set1_ps(TANH_CLAMP)),
+           x2 = _mm_mul_ps(x, x),
+           p  = _mm_set1_ps(TANH_P[0]),
+           q  = _mm_set1_ps(TANH_Q[0]);
+    for (int i = 1; i < TANH_P_COUNT; i++) p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(TANH_P[i]));
+    for (int i = 1; i < TANH_Q_COUNT; i++) q = _mm_add_ps(_mm_mul_ps(q, x2), _mm_set1_ps(TANH_Q[i]));
+    return _mm_div_ps(_mm_mul_ps(p, x), q);
+}
+
+void policy_layer_sse2(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out)
+{
+    const int REGISTERS = POLICY_TILE / 4;
+
+    for (int o = 0; o < output_size; o++)
+    {
+        const float* row = weights + (size_t)o * input_size;
+        __m128 sums[REGISTERS];
+        for (int r = 0; r < REGISTERS; r++) sums[r] = _mm_set1_ps(biases[o]);
+
+        for (int i = 0; i < input_size; i++)
+        {
+            const float* inputs = in + (size_t)i * POLICY_TILE;
+            __m128 weight = _mm_set1_ps(row[i]);
+            for (int r = 0; r < REGISTERS; r++) sums[r] = _mm_add_ps(sums[r], _mm_mul_ps(weight, _mm_load_ps(inputs + 4 * r)));
+        }
+
+        float* outputs = out + (size_t)o * POLICY_TILE;
+        for (int r = 0; r < REGISTERS; r++) _mm_store_ps(outputs + 4 * r, activate_sse2(sums[r], activation));
+    }
+}
+
+LANDER_TARGET_AVX2 static __m256 activate_avx2(__m256 value, int activation)
+{
+    if (activation == POLICY_RELU) return _mm256_max_ps(value, _mm256_setzero_ps());
+    if (activation != POLICY_TANH) return value;
+
+    __m256 x  = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(-TANH_CLAMP)), _mm256_set1_ps(TANH_CLAMP)),
+           x2 = _mm256_mul_ps(x, x),
+           p  = _mm256_set1_ps(TANH_P[0]),
+           q  = _mm256_set1_ps(TANH_Q[0]);
+    for (int i = 1; i < TANH_P_COUNT; i++) p = _mm256_add_ps(_mm256_mul_ps(p, x2), _mm256_set1_ps(TANH_P[i]));
+    for (int i = 1; i < TANH_Q_COUNT; i++) q = _mm256_add_ps(_mm256_mul_ps(q, x2), _mm256_set1_ps(TANH_Q[i]));
+    return _mm256_div_ps(_mm256_mul_ps(p, x), q);
+}
+
+LANDER_TARGET_AVX2 void policy_layer_avx2(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out)
+{
+    const int REGISTERS = POLICY_TILE / 8;
+
+    // Two outputs a pass: eight independent sums hide the adds' latency, where four would leave
+    // the core waiting on them, and each row of inputs is loaded once for both
+    int o = 0;
+    for (; o + 2 <= output_size; o += 2)
+    {
+        const float* row_a = weights + (size_t)o * input_size;
+        const float* row_b = row_a + input_size;
+        __m256 sums_a[REGISTERS], sums_b[REGISTERS];
+        for (int r = 0; r < REGISTERS; r++)
+        {
+            sums_a[r] = _mm256_set1_ps(biases[o]);
+            sums_b[r] = _mm256_set1_ps(biases[o + 1]);
+        }
+
+        // Separate multiplies and adds, never fused, so the rounding matches the scalar kernel
+        for (int i = 0; i < input_size; i++)
+        {
+            const float* inputs = in + (size_t)i * POLICY_TILE;
+            __m256 weight_a = _mm256_set1_ps(row_a[i]),
+                   weight_b = _mm256_set1_ps(row_b[i]);
+            for (int r = 0; r < REGISTERS; r++)
+            {
+                __m256 input = _mm256_load_ps(inputs + 8 * r);
+                sums_a[r] = _mm256_add_ps(sums_a[r], _mm256_mul_ps(weight_a, input));
+                sums_b[r] = _mm256_add_ps(sums_b[r], _mm256_mul_ps(weight_b, input));
+            }
+        }
+
+        float* outputs = out + (size_t)o * POLICY_TILE;
+        for (int r = 0; r < REGISTERS; r++)
+        {
+            _mm256_store_ps(outputs + 8 * r, activate_avx2(sums_a[r], activation));
+            _mm256_store_ps(outputs + POLICY_TILE + 8 * r, activate_avx2(sums_b[r], activation));
+        }
+    }
+
+    // An odd last output on its own
+    for (; o < output_size; o++)
+    {
+        const float* row = weights + (size_t)o * input_size;
+        __m256 sums[REGISTERS];
+        for (int r = 0; r < REGISTERS; r++) sums[r] = _mm256_set1_ps(biases[o]);
+
+        for (int i = 0; i < input_size; i++)
+        {
+            const float* inputs = in + (size_t)i * POLICY_TILE;
+            __m256 weight = _mm256_set1_ps(row[i]);
+            for (int r = 0; r < REGISTERS; r++) sums[r] = _mm256_add_ps(sums[r], _mm256_mul_ps(weight, _mm256_load_ps(inputs + 8 * r)));
+        }
+
+        float* outputs = out + (size_t)o * POLICY_TILE;
+        for (int r = 0; r < REGISTERS; r++) _mm256_store_ps(outputs + 8 * r, activate_avx2(sums[r], activation));
+    }
+}
+#endif
+
+// ————— NEON ————— //
+#ifdef LANDER_SIMD_NEON
+static float32x4_t activate_neon(float32x4_t value, int activation)
+{
+    if (activation == POLICY_RELU) return vmaxq_f32(value, vdupq_n_f32(0.0f));
+    if (activation != POLICY_TANH) return value;
+
+    float32x4_t x  = vminq_f32(vmaxq_f32(value, vdupq_n_f32(-TANH_CLAMP)), vdupq_n_f32(TANH_CLAMP)),
+                x2 = vmulq_f32(x, x),
+                p  = vdupq_n_f32(TANH_P[0]),
+                q  = vdupq_n_f32(TANH_Q[0]);
+    for (int i = 1; i < TANH_P_COUNT; i++) p = vaddq_f32(vmulq_f32(p, x2), vdupq_n_f32(TANH_P[i]));
+    for (int i = 1; i < TANH_Q_COUNT; i++) q = vaddq_f32(vmulq_f32(q, x2), vdupq_n_f32(TANH_Q[i]));
+    return vdivq_f32(vmulq_f32(p, x), q);
+}
+
+void policy_layer_neon(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out)
+{
+    const int REGISTERS = POLICY_TILE / 4;
+
+    for (int o = 0; o < output_size; o++)
+    {
+        const float* row = weights + (size_t)o * input_size;
+        float32x4_t sums[REGISTERS];
+        for (int r = 0; r < REGISTERS; r++) sums[r] = vdupq_n_f32(biases[o]);
+
+        // vmulq and vaddq apart rather than vmlaq, which may fuse and round differently
+        for (int i = 0; i < input_size; i++)
+        {
+            const float* inputs = in + (size_t)i * POLICY_TILE;
+            float32x4_t weight = vdupq_n_f32(row[i]);
+            for (int r = 0; r < REGISTERS; r++) sums[r] = vaddq_f32(sums[r], vmulq_f32(weight, vld1q_f32(inputs + 4 * r)));
+        }
+
+        float* outputs = out + (size_t)o * POLICY_TILE;
+        for (int r = 0; r < REGISTERS; r++) vst1q_f32(outputs + 4 * r, activate_neon(sums[r], activation));
+    }
+}
+#endif
+
+// ————— DISPATCH ————— //
+struct PolicyKernelChoice
+{
+    PolicyLayerKernel kernel;
+    const char*       name;
+};
+
+static PolicyKernelChoice choose_policy_kernel()
+{
+    switch (get_simd_isa())
+    {
+#if defined(LANDER_SIMD_SSE2)
+    case SIMD_AVX512:
+    case SIMD_AVX2:   return { policy_layer_avx2, "AVX2" };
+    case SIMD_SSE2:   return { policy_layer_sse2, "SSE2" };
+#elif defined(LANDER_SIMD_NEON)
+    case SIMD_NEON:   return { policy_layer_neon, "NEON" };
+#endif
+    default:          return { policy_layer_scalar, "scalar" };
+    }
+}
+
+static const PolicyKernelChoice& get_policy_kernel_choice()
+{
+    static const PolicyKernelChoice choice = choose_policy_kernel();
+    return choice;
+}
+
+PolicyLayerKernel get_policy_kernel()      { return get_policy_kernel_choice().kernel; }
+const char*       get_policy_kernel_name() { return get_policy_kernel_choice().name; }
+
+// ————— NETWORK ————— //
+static bool read_u32(const uint8_t*& cursor, const uint8_t* end, uint32_t& value)
+{
+    if ((size_t)(end - cursor) < sizeof(value)) return false;
+    std::memcpy(&value, cursor, sizeof(value));
+    cursor += sizeof(value);
+    return true;
+}
+
+bool PolicyNetwork::load(const char* filepath)
+{
+    m_layers.clear();
+
+    std::vector<uint8_t> contents;
+    FILE* file = std::fopen(filepath, "rb");
+    if (file == NULL) return false;
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size > 0)
+    {
+        contents.resize((size_t)size);
+        contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+    }
+    std::fclose(file);
+
+    return parse(contents.data(), contents.size());
+}
+
+bool PolicyNetwork::parse(const uint8_t* bytes, size_t size)
+{
+    m_layers.clear();
+    m_parameters.clear();
+    m_input_size = 0;
+    m_max_width = 0;
+
+    // STEP 1: The header...
+    const uint8_t* cursor = bytes;
+    const uint8_t* end    = bytes + size;
+    uint32_t version, input_size, layer_count;
+    if (size < sizeof(MAGIC) || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) return false;
+    cursor += sizeof(MAGIC);
+    if (!read_u32(cursor, end, version) || version != VERSION || !read_u32(cursor, end, input_size) || !read_u32(cursor, end, layer_count)) return false;
+    if (input_size == 0 || input_size > MAX_WIDTH || layer_count == 0 || layer_count > MAX_LAYERS) return false;
+
+    // STEP 2: ...then each layer's shape and parameters, straight into one array
+    std::vector<Layer> layers;
+    int width = (int)input_size, max_width = width;
+    for (uint32_t l = 0; l < layer_count; l++)
+    {
+        uint32_t output_size, activation;
+        if (!read_u32(cursor, end, output_size) || !read_u32(cursor, end, activation)) return false;
+        if (output_size == 0 || output_size > MAX_WIDTH || activation >= POLICY_ACTIVATION_COUNT) return false;
+
+        Layer layer = { width, (int)output_size, (int)activation, m_parameters.size(), m_parameters.size() + (size_t)width * output_size };
+        size_t count = (size_t)width * output_size + output_size;
+        if ((size_t)(end - cursor) < count * sizeof(float)) return false;
+        m_parameters.resize(m_parameters.size() + count);
+        std::memcpy(m_parameters.data() + layer.weight_offset, cursor, count * sizeof(float));
+        cursor += count * sizeof(float);
+
+        layers.push_back(layer);
+        width = (int)output_size;
+        max_width = std::max(max_width, width);
+    }
+    if (cursor != end) return false;
+
+    // STEP 3: The tiles sized once, so evaluating never allocates
+    m_layers.swap(layers);
+    m_input_size = (int)input_size;
+    m_max_width = max_width;
+    for (std::vector<float>& tile : m_tiles) tile.assign((size_t)max_width * POLICY_TILE + POLICY_TILE, 0.0f);
+    return true;
+}
+
+// The kernels' loads want 32-byte alignment, which a vector's floats only promise 4 bytes of
+static float* align_tile(std::vector<float>& tile)
+{
+    uintptr_t address = (uintptr_t)tile.data();
+    return (float*)((address + 31) & ~(uintptr_t)31);
+}
+
+void PolicyNetwork::evaluate(const float* inputs, int input_stride, int count, float* outputs, int output_stride)
+{
+    if (m_layers.empty()) return;
+    TRACE_ZONE("PolicyNetwork::evaluate");
+
+    float* tiles[2] = { align_tile(m_tiles[0]), align_tile(m_tiles[1]) };
+    int output_size = get_output_size();
+
+    for (int first = 0; first < count; first += POLICY_TILE)
+    {
+        int lanes = std::min(POLICY_TILE, count - first);
+
+        // STEP 1: This tile's landers in, one feature to a row; lanes past the last lander are zero
+        float* in = tiles[0];
+        for (int i = 0; i < m_input_size; i++)
+        {
+            float* row = in + (size_t)i * POLICY_TILE;
+            for (int lane = 0; lane < lanes; lane++) row[lane] = inputs[(size_t)(first + lane) * input_stride + i];
+            for (int lane = lanes; lane < POLICY_TILE; lane++) row[lane] = 0.0f;
+        }
+
+        // STEP 2: Every layer, back and forth between the two tiles
+        int current = 0;
+        for (const Layer& layer : m_layers)
+        {
+            m_kernel(m_parameters.data() + layer.weight_offset, m_parameters.data() + layer.bias_offset, layer.input_size, layer.output_size,
+                     layer.activation, tiles[current], tiles[1 - current]);
+            current = 1 - current;
+        }
+
+        // STEP 3: The last layer's outputs back out, one lander to a row
+        const float* out = tiles[current];
+        for (int o = 0; o < output_size; o++)
+        {
+            const float* row = out + (size_t)o * POLICY_TILE;
+            for (int lane = 0; lane < lanes; lane++) outputs[(size_t)(first + lane) * output_stride + o] = row[lane];
+        }
+    }
+}
+
+long long const PolicyNetwork::get_weight_count() const
+{
+    long long count = 0;
+    for (const Layer& layer : m_layers) count += (long long)layer.input_size * layer.output_size;
+    return count;
+}
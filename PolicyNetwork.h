@@ -0,0 +1,104 @@
+#pragma once
+
+// Inference for the small multilayer perceptrons the landers are trained as: dense layers, each
+// followed by nothing, ReLU or tanh, read from a flat little-endian file the training side writes
+// out with a few lines of numpy:
+//
+//   "LPOL" | u32 version | u32 input size | u32 layer count | layers
+//   layer:   u32 output size | u32 PolicyActivation | f32 weights[output][input] | f32 biases[output]
+//
+// Weights are row-major by output, as a PyTorch nn.Linear holds them, and each layer's input is
+// the one before's output.
+//
+// evaluate() is for many landers at once. They go through in tiles of POLICY_TILE, transposed so
+// each row of a tile is one feature across every lander in it: a layer is then, per output, one
+// broadcast weight times a row of inputs added into a register's worth of landers, with no
+// horizontal sums, and the weights stream through once per tile rather than once per lander.
+// The kernels, like OverlapKernels', do the same multiplies and adds in the same order, never
+// fused, so every one of them gives the scalar kernel's outputs to the bit:
+//   scalar  anywhere
+//   SSE2    4 landers a register, on every x64 CPU
+//   AVX2    8 landers a register, where the CPU and OS support it
+//   NEON    4 landers a register, on every AArch64 CPU
+// tanh is a rational approximation (within 4e-7 of std::tanh), since the library's can't be
+// vectorised and still agree with the scalar kernel.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "OverlapKernels.h"
+
+enum PolicyActivation
+{
+    POLICY_LINEAR,
+    POLICY_RELU,
+    POLICY_TANH,
+    POLICY_ACTIVATION_COUNT
+};
+
+// Landers a kernel call covers: four registers' worth for AVX2, so it always has independent
+// sums in flight
+const int POLICY_TILE = 32;
+
+// One layer over one tile: `in` is input_size rows of POLICY_TILE, `out` gets output_size rows
+typedef void (*PolicyLayerKernel)(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out);
+
+void policy_layer_scalar(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out);
+#ifdef LANDER_SIMD_SSE2
+void policy_layer_sse2(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out);
+void policy_layer_avx2(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out);
+#endif
+#ifdef LANDER_SIMD_NEON
+void policy_layer_neon(const float* weights, const float* biases, int input_size, int output_size, int activation, const float* in, float* out);
+#endif
+
+// The kernel for get_simd_isa(), bound on the first call
+PolicyLayerKernel get_policy_kernel();
+const char*       get_policy_kernel_name();
+
+class PolicyNetwork
+{
+private:
+    struct Layer
+    {
+        int    input_size,
+               output_size,
+               activation;
+        size_t weight_offset,  // into m_parameters; the biases follow the weights
+               bias_offset;
+    };
+
+    std::vector<Layer> m_layers;
+    std::vector<float> m_parameters;
+    int                m_input_size = 0,
+                       m_max_width  = 0;  // the widest layer, inputs included
+
+    // Two tiles of m_max_width rows, each layer reading one and writing the other
+    std::vector<float> m_tiles[2];
+
+    PolicyLayerKernel m_kernel = get_policy_kernel();
+
+public:
+    static const uint32_t VERSION    = 1;
+    static const int      MAX_WIDTH  = 1024,
+                          MAX_LAYERS = 16;
+    static const char     MAGIC[4];
+
+    // False, leaving no network, for a file that's missing, truncated, from another version or
+    // wider or deeper than MAX_WIDTH and MAX_LAYERS
+    bool load(const char* filepath);
+    bool parse(const uint8_t* bytes, size_t size);
+
+    // `count` landers' inputs, input_stride floats apart, to their outputs, output_stride apart.
+    // Allocates nothing.
+    void evaluate(const float* inputs, int input_stride, int count, float* outputs, int output_stride);
+
+    // For checking one kernel against another; the fastest is used otherwise
+    void set_kernel(PolicyLayerKernel kernel) { m_kernel = kernel; };
+
+    bool const is_loaded()         const { return !m_layers.empty(); };
+    int  const get_input_size()    const { return m_input_size; };
+    int  const get_output_size()   const { return m_layers.empty() ? 0 : m_layers.back().output_size; };
+    int  const get_layer_count()   const { return (int)m_layers.size(); };
+    // Multiplies one lander's evaluation takes
+    long long const get_weight_count() const;
+};
@@ -0,0 +1,237 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <string>
+#include "EmbeddedShaders.h"
+#include "GLCallCounter.h"
+#include "PostProcess.h"
+
+static const char* const POST_DEFINE_NAMES[POST_EFFECT_COUNT + 2] = { "BLOOM", "VIGNETTE", "CRT", "BRIGHT", "BLUR" };
+static const char* const POST_EFFECT_NAMES[POST_EFFECT_COUNT]     = { "bloom", "vignette", "crt" };
+
+unsigned int PostProcess::parse_effects(std::string_view names)
+{
+    unsigned int effects = 0;
+    while (!names.empty())
+    {
+        size_t comma = names.find(',');
+        std::string_view name = names.substr(0, comma);
+        names = comma == std::string_view::npos ? std::string_view() : names.substr(comma + 1);
+
+        int effect = 0;
+        while (effect < POST_EFFECT_COUNT && name != POST_EFFECT_NAMES[effect]) effect++;
+        if (effect == POST_EFFECT_COUNT) return 0;
+        effects |= 1u << effect;
+    }
+    return effects;
+}
+
+bool PostProcess::initialise(int width, int height, unsigned int effects, bool merge)
+{
+    if (effects == 0) return false;
+
+    m_width = width;
+    m_height = height;
+    m_effects = effects;
+    m_merge = merge;
+
+    // STEP 1: The targets this chain actually passes through, all allocated at their full size once
+    bool ready = m_scene.initialise(width, height, true);
+    if (ready && !merge) ready = m_ping_pong[0].initialise(width, height, true) && m_ping_pong[1].initialise(width, height, true);
+    if (ready && (effects & POST_BLOOM))
+    {
+        int bloom_width  = std::max(width / BLOOM_DOWNSAMPLE, 1),
+            bloom_height = std::max(height / BLOOM_DOWNSAMPLE, 1);
+        ready = m_bloom[0].initialise(bloom_width, bloom_height, true) && m_bloom[1].initialise(bloom_width, bloom_height, true);
+    }
+    if (!ready)
+    {
+        cleanup();
+        return false;
+    }
+
+    // STEP 2: One triangle big enough that the target is the part of it inside clip space
+    const float vertices[] = { -1.0f, -1.0f,
+                                3.0f, -1.0f,
+                               -1.0f,  3.0f };
+
+    m_backend = get_render_backend();
+    m_vertex_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    return true;
+}
+
+void PostProcess::cleanup()
+{
+    for (auto& entry : m_programs) m_backend->delete_pipeline(entry.second->pipeline);
+    m_programs.clear();
+    if (m_vertex_buffer != 0) m_backend->delete_buffer(m_vertex_buffer);
+    m_vertex_buffer = 0;
+
+    m_scene.cleanup();
+    for (OffscreenTarget& target : m_ping_pong) target.cleanup();
+    for (OffscreenTarget& target : m_bloom)     target.cleanup();
+    m_scene_bound = false;
+}
+
+PostProcess::PostProgram* PostProcess::get_program(unsigned int features)
+{
+    auto found = m_programs.find(features);
+    if (found != m_programs.end()) return found->second.get();
+
+    // First use of this combination: compiled, and its sampler units set once for good
+    std::string defines;
+    for (int bit = 0; bit < POST_EFFECT_COUNT + 2; bit++)
+    {
+        if (features & (1u << bit)) defines += std::string("#define ") + POST_DEFINE_NAMES[bit] + " 1\n";
+    }
+
+    std::unique_ptr<PostProgram> post(new PostProgram());
+    ShaderProgram& program = post->program;
+    program.load(EmbeddedShaders::POST_VERTEX, EmbeddedShaders::POST_FRAGMENT, defines);
+
+    GLuint id = program.get_program_id();
+    post->uv_scale       = glGetUniformLocation(id, "uvScale");
+    post->texel_size     = glGetUniformLocation(id, "texelSize");
+    post->direction      = glGetUniformLocation(id, "direction");
+    post->threshold      = glGetUniformLocation(id, "threshold");
+    post->bloom_strength = glGetUniformLocation(id, "bloomStrength");
+    post->output_size    = glGetUniformLocation(id, "outputSize");
+
+    program.use();
+    count_gl_call(GL_CALL_UNIFORM, 4);
+    glUniform1i(glGetUniformLocation(id, "source"), 0);
+    glUniform1i(glGetUniformLocation(id, "bloom"), 1);
+    glUniform1f(post->threshold, BLOOM_THRESHOLD);
+    glUniform1f(post->bloom_strength, BLOOM_STRENGTH);
+
+    VertexLayout layout;
+    layout.stride = 2 * sizeof(float);
+    m_backend->create_pipeline(post->pipeline, &program, layout.add(program.get_position_attribute(), 2, 0));
+
+    PostProgram* result = post.get();
+    m_programs[features] = std::move(post);
+    return result;
+}
+
+void PostProcess::run_pass(unsigned int features, const OffscreenTarget& source, glm::vec2 uv_scale, const OffscreenTarget* target, glm::vec2 direction)
+{
+    PostProgram* post = get_program(features);
+
+    int width  = target != NULL ? target->get_width()  : m_width,
+        height = target != NULL ? target->get_height() : m_height;
+    if (target != NULL) target->bind();
+    else                m_scene.unbind();
+    glViewport(0, 0, width, height);
+
+    m_backend->begin_draws(post->pipeline, m_vertex_buffer, 0);
+
+    count_gl_call(GL_CALL_UNIFORM, 4);
+    glUniform2f(post->uv_scale, uv_scale.x, uv_scale.y);
+    glUniform2f(post->texel_size, 1.0f / (float)source.get_width(), 1.0f / (float)source.get_height());
+    glUniform2f(post->direction, direction.x, direction.y);
+    glUniform2f(post->output_size, (float)width, (float)height);
+
+    // The blurred highlights on unit 1 for whichever pass composites them
+    if (features & POST_BLOOM)
+    {
+        count_gl_call(GL_CALL_BIND, 3);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, m_bloom[0].get_texture_id());
+        glActiveTexture(GL_TEXTURE0);
+    }
+    m_backend->bind_texture(GL_TEXTURE_2D, source.get_texture_id());
+
+    m_backend->draw_triangles(0, 3);
+    m_backend->end_draws();
+
+    m_passes++;
+    m_draw_calls++;
+}
+
+void PostProcess::warm_up(PipelineWarmup& warmup)
+{
+    if (!is_enabled()) return;
+
+    // Subsets of m_effects, counting down through its bits
+    for (unsigned int effects = m_effects; effects != 0; effects = (effects - 1) & m_effects)
+    {
+        bool single = (effects & (effects - 1)) == 0;
+        if (m_merge || single) warmup.warm_up(get_program(effects)->pipeline);
+    }
+
+    if (m_effects & POST_BLOOM)
+    {
+        warmup.warm_up(get_program(STAGE_BRIGHT)->pipeline);
+        warmup.warm_up(get_program(STAGE_BLUR)->pipeline);
+    }
+}
+
+void PostProcess::begin_scene(int scene_width, int scene_height)
+{
+    if (!is_enabled()) return;
+
+    m_scene_width = std::min(scene_width, m_width);
+    m_scene_height = std::min(scene_height, m_height);
+    m_scene.bind();
+    glViewport(0, 0, m_scene_width, m_scene_height);
+    m_scene_bound = true;
+}
+
+void PostProcess::end_scene()
+{
+    if (!m_scene_bound) return;
+    m_scene_bound = false;
+    m_passes = 0;
+    m_draw_calls = 0;
+    unsigned int effects = get_active_effects();
+
+    glm::vec2 scene_scale = glm::vec2((float)m_scene_width / (float)m_width, (float)m_scene_height / (float)m_height);
+
+    // STEP 1: Bloom's highlights, extracted while shrinking to a quarter and then blurred across
+    //         and down; they end up in m_bloom[0]
+    if (effects & POST_BLOOM)
+    {
+        glm::vec2 texel = glm::vec2(1.0f / (float)m_bloom[0].get_width(), 1.0f / (float)m_bloom[0].get_height());
+        run_pass(STAGE_BRIGHT, m_scene, scene_scale, &m_bloom[0]);
+        run_pass(STAGE_BLUR, m_bloom[0], glm::vec2(1.0f), &m_bloom[1], glm::vec2(texel.x, 0.0f));
+        run_pass(STAGE_BLUR, m_bloom[1], glm::vec2(1.0f), &m_bloom[0], glm::vec2(0.0f, texel.y));
+    }
+
+    // STEP 2: Every per-pixel pass in one draw, straight into the window...
+    if (m_merge)
+    {
+        run_pass(effects, m_scene, scene_scale, NULL);
+    }
+    // ...or one draw each, back and forth between the full-size pair, the last into the window
+    else
+    {
+        const OffscreenTarget* source = &m_scene;
+        glm::vec2 uv_scale = scene_scale;
+        int last = 0, target = 0;
+        for (int effect = 0; effect < POST_EFFECT_COUNT; effect++) if (effects & (1u << effect)) last = effect;
+        for (int effect = 0; effect <= last; effect++)
+        {
+            if (!(effects & (1u << effect))) continue;
+
+            const OffscreenTarget* output = effect == last ? NULL : &m_ping_pong[target];
+            run_pass(1u << effect, *source, uv_scale, output);
+
+            source = output;
+            uv_scale = glm::vec2(1.0f);
+            target ^= 1;
+        }
+    }
+
+    // Left as end_scene promises: the window, and all of it
+    glViewport(0, 0, m_width, m_height);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+// Full-screen effects over the world: bloom on anything bright (the thruster flames, mostly), a
+// vignette and a CRT filter. The world is drawn once into a scene target, and the chain then runs
+// as full-screen triangles between targets, the last pass straight into the window.
+//
+// The passes that only look at their own pixel (bloom's composite, the vignette, the CRT's mask
+// and scanlines) are merged: one shader variant runs them all, each a function of the last, so
+// the whole chain after the bloom is a single full-screen draw. Bloom's own passes (bright
+// extraction and a separable blur) read neighbours and can't merge; they run on a quarter-size
+// pair of targets, a sixteenth of the pixels. With merging off, every pass gets its own draw
+// between a full-size ping-pong pair, for comparing against.
+//
+// The scene can be drawn into a corner of the scene target (see DynamicResolution); the first
+// pass reads only that corner and the last one stretches it over the window, so the two combine
+// without a blit in between. Whatever is drawn after end_scene (the HUD) is left untouched.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include "glm/mat4x4.hpp"
+#include "OffscreenTarget.h"
+#include "PipelineWarmup.h"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+
+enum PostEffect
+{
+    POST_BLOOM    = 1 << 0,
+    POST_VIGNETTE = 1 << 1,
+    POST_CRT      = 1 << 2,
+    POST_EFFECT_COUNT = 3
+};
+
+class PostProcess
+{
+private:
+    static const int       BLOOM_DOWNSAMPLE = 4;  // the bloom targets' size, as a fraction of the window's
+    static constexpr float BLOOM_THRESHOLD  = 0.6f,
+                           BLOOM_STRENGTH   = 1.2f;
+
+    // The bloom's own passes, as further #defines after the effects'
+    static const unsigned int STAGE_BRIGHT = 1u << POST_EFFECT_COUNT,
+                              STAGE_BLUR   = 1u << (POST_EFFECT_COUNT + 1);
+
+    struct PostProgram
+    {
+        ShaderProgram program;
+        Pipeline      pipeline;
+        GLint         uv_scale       = -1,
+                      texel_size     = -1,
+                      direction      = -1,
+                      threshold      = -1,
+                      bloom_strength = -1,
+                      output_size    = -1;
+    };
+
+    unsigned int m_effects = 0,
+                 m_effect_mask = ~0u;  // QualityGovernor's; what's left of m_effects runs
+    bool         m_merge   = true;
+    int          m_width   = 0,
+                 m_height  = 0;
+
+    OffscreenTarget m_scene,
+                    m_ping_pong[2],  // full size; only without merging
+                    m_bloom[2];      // a BLOOM_DOWNSAMPLE-th of the size each way
+
+    int  m_scene_width  = 0,
+         m_scene_height = 0;
+    bool m_scene_bound  = false;
+
+    std::unordered_map<unsigned int, std::unique_ptr<PostProgram>> m_programs;  // by #define bits
+    RenderBackend* m_backend = NULL;
+    GLuint         m_vertex_buffer = 0;
+
+    int m_passes     = 0,  // by the last end_scene
+        m_draw_calls = 0;
+
+    PostProgram* get_program(unsigned int features);
+
+    // One full-screen triangle of `features` from `source` into `target` (NULL for the window).
+    // `uv_scale` is how much of the source holds the picture.
+    void run_pass(unsigned int features, const OffscreenTarget& source, glm::vec2 uv_scale, const OffscreenTarget* target,
+                  glm::vec2 direction = glm::vec2(0.0f));
+
+public:
+    // GL thread. False, with nothing allocated, without framebuffer objects or with no effects.
+    // width and height are the window's viewport, from its corner.
+    bool initialise(int width, int height, unsigned int effects, bool merge);
+    void cleanup();
+
+    // Around the world's draws, as DynamicResolution's. The scene is drawn at scene_width x
+    // scene_height into the target's corner; end_scene runs the chain and leaves the window bound
+    // with its full viewport.
+    void begin_scene(int scene_width, int scene_height);
+    void end_scene();
+
+    // Compiles and draws every pass any mask could lead to: each combination of the effects when
+    // merged, each effect alone when not, and bloom's own passes. Otherwise the first frame after
+    // the governor drops an effect compiles that combination in the middle of the game.
+    void warm_up(PipelineWarmup& warmup);
+
+    // Holds back the effects not in `mask` without freeing anything, so they can come back
+    void set_effect_mask(unsigned int mask) { m_effect_mask = mask; };
+
+    // "bloom,vignette,crt" in any order and combination, as POST_ bits; 0 if any name is unknown
+    static unsigned int parse_effects(std::string_view names);
+
+    bool         const is_enabled()     const { return m_scene.is_ready(); };
+    // Enabled with something left to run; the scene can go straight to the window otherwise
+    bool         const is_active()      const { return is_enabled() && get_active_effects() != 0; };
+    unsigned int const get_effects()    const { return m_effects; };
+    unsigned int const get_active_effects() const { return m_effects & m_effect_mask; };
+    bool         const is_merged()      const { return m_merge; };
+    int          const get_passes()     const { return m_passes; };
+    int          const get_draw_calls() const { return m_draw_calls; };
+};
@@ -0,0 +1,90 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "PostProcess.h"
+#include "QualityGovernor.h"
+
+const QualityLevel QualityGovernor::LEVELS[LEVEL_COUNT] =
+{
+    // name                  particles  post effects               resolution  starfield  lights  shadow texels
+    { "full",                1.0f,      ~0u,                       1.0f,       true,      16,     1024 },
+    { "no bloom",            1.0f,      POST_VIGNETTE | POST_CRT,  1.0f,       true,      16,     512  },
+    { "no post",             0.5f,      0u,                        1.0f,       true,      8,      512  },
+    { "three-quarter res",   0.25f,     0u,                        0.75f,      true,      4,      256  },
+    { "half res, no stars",  0.25f,     0u,                        0.5f,       false,     2,      128  },
+};
+
+void QualityGovernor::initialise(float budget_ms)
+{
+    m_budget_ms = budget_ms;
+    m_window_count = 0;
+    m_settle_frames = 0;
+    m_last_p95_ms = 0.0f;
+    m_level = 0;
+    m_calm_windows = 0;
+    m_raise_windows = RAISE_WINDOWS;
+    m_windows_since_raise = -1;
+    m_change_count = 0;
+}
+
+void QualityGovernor::change_level(int level)
+{
+    m_level = level;
+    m_calm_windows = 0;
+    m_settle_frames = SETTLE_FRAMES;
+    m_change_count++;
+}
+
+bool QualityGovernor::record(float frame_ms)
+{
+    if (!is_enabled() || frame_ms <= 0.0f) return false;
+    if (m_settle_frames > 0)
+    {
+        m_settle_frames--;
+        return false;
+    }
+
+    m_window[m_window_count++] = frame_ms;
+    if (m_window_count < WINDOW_FRAMES) return false;
+    m_window_count = 0;
+
+    // STEP 1: The window's p95; its order doesn't matter any more, so it's partitioned in place
+    int rank = (int)(PERCENTILE * (WINDOW_FRAMES - 1) + 0.5f);
+    std::nth_element(m_window, m_window + rank, m_window + WINDOW_FRAMES);
+    m_last_p95_ms = m_window[rank];
+
+    if (m_windows_since_raise >= 0 && ++m_windows_since_raise > PROBATION_WINDOWS)
+    {
+        // The raise held, so the next one is tried as soon as any other
+        m_windows_since_raise = -1;
+        m_raise_windows = RAISE_WINDOWS;
+    }
+
+    // STEP 2: Over budget: down a level now, and if that undoes a raise, wait longer next time
+    if (m_last_p95_ms > m_budget_ms)
+    {
+        if (m_level == LEVEL_COUNT - 1) return false;
+        if (m_windows_since_raise >= 0) m_raise_windows = std::min(m_raise_windows * 2, MAX_RAISE_WINDOWS);
+        m_windows_since_raise = -1;
+        change_level(m_level + 1);
+        return true;
+    }
+
+    // STEP 3: Well under it for long enough: back up a level
+    if (m_last_p95_ms < m_budget_ms * RAISE_BELOW) m_calm_windows++;
+    else                                           m_calm_windows = 0;
+
+    if (m_level == 0 || m_calm_windows < m_raise_windows) return false;
+    m_windows_since_raise = 0;
+    change_level(m_level - 1);
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// Trades looks for frame time when the machine can't hold the budget. The levels run from
+// everything on down to the bare game, each giving up a little more than the last: bloom, then
+// the rest of the post-processing, then particles and resolution, and last the starfield. The
+// lights and their shadow maps thin out along the way.
+//
+// Every frame's cost comes in, and once a window of WINDOW_FRAMES it is judged on its p95:
+//
+//   over the budget                              one level down, straight away
+//   under RAISE_BELOW of it, m_raise_windows     one level back up
+//   windows in a row
+//
+// The gap between the two thresholds, and the wait before raising, keep it from hunting. A
+// raised level that falls back within PROBATION_WINDOWS doubles the wait before the next try, so
+// a machine that sits right on the edge of a level tries it less and less often. The frames
+// straight after a change are left out, since they still show the old level's GPU work.
+struct QualityLevel
+{
+    const char*  name;
+    float        particle_scale;  // of the exhaust's rate and every burst's count
+    unsigned int post_effects;    // the PostEffect bits allowed to run
+    float        max_resolution;  // DynamicResolution's ceiling
+    bool         starfield;
+    int          lights;             // LightingPass's, the lander's own first
+    int          shadow_resolution;  // texels around each light
+};
+
+class QualityGovernor
+{
+public:
+    static const int LEVEL_COUNT = 5;
+    static const QualityLevel LEVELS[LEVEL_COUNT];  // best first
+
+private:
+    static constexpr int   WINDOW_FRAMES     = 60,
+                           SETTLE_FRAMES     = 8,   // GpuProfiler::FRAME_LATENCY and then some
+                           RAISE_WINDOWS     = 4,
+                           MAX_RAISE_WINDOWS = 64,
+                           PROBATION_WINDOWS = 4;
+    static constexpr float PERCENTILE  = 0.95f,
+                           RAISE_BELOW = 0.7f;
+
+    float m_window[WINDOW_FRAMES];
+    int   m_window_count = 0,
+          m_settle_frames = 0;
+    float m_budget_ms = 0.0f,
+          m_last_p95_ms = 0.0f;
+
+    int m_level = 0,
+        m_calm_windows = 0,
+        m_raise_windows = RAISE_WINDOWS,
+        m_windows_since_raise = -1,  // -1 when the level wasn't reached by raising
+        m_change_count = 0;
+
+    void change_level(int level);
+
+public:
+    // With the frame time to stay under; 0 leaves it off, at the best level
+    void initialise(float budget_ms);
+
+    // Once a frame, with what the frame cost; true when the level changed. 0 (nothing measured)
+    // is ignored.
+    bool record(float frame_ms);
+
+    bool                const is_enabled()         const { return m_budget_ms > 0.0f; };
+    int                 const get_level()          const { return m_level; };
+    const QualityLevel&       get_settings()       const { return LEVELS[m_level]; };
+    float               const get_budget_ms()      const { return m_budget_ms; };
+    float               const get_last_p95_ms()    const { return m_last_p95_ms; };
+    int                 const get_change_count()   const { return m_change_count; };
+};
@@ -0,0 +1,50 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include "Registry.h"
+
+EntityId Registry::create()
+{
+    // Ids are recycled so that the pools' sparse tables stay as small as the live entity count
+    if (!m_free_ids.empty())
+    {
+        EntityId entity = m_free_ids.back();
+        m_free_ids.pop_back();
+        return entity;
+    }
+
+    return m_next_id++;
+}
+
+void Registry::destroy(EntityId entity)
+{
+    transforms.remove(entity);
+    bodies.remove(entity);
+    boxes.remove(entity);
+    sprites.remove(entity);
+    animators.remove(entity);
+    boosters.remove(entity);
+
+    m_free_ids.push_back(entity);
+}
+
+void Registry::clear()
+{
+    transforms.clear();
+    bodies.clear();
+    boxes.clear();
+    sprites.clear();
+    animators.clear();
+    boosters.clear();
+
+    m_free_ids.clear();
+    m_next_id = 0;
+}
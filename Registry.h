@@ -0,0 +1,145 @@
+#pragma once
+
+// Entity-component storage. An entity is just an id; each component type lives in its own
+// densely packed pool, so a system walks only the arrays it needs instead of striding over
+// whole Entity objects. Static rocks carry a Transform2D, an AABB and a Sprite and nothing else.
+#include <cstdint>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+
+typedef uint32_t EntityId;
+
+const EntityId NULL_ENTITY = 0xFFFFFFFF;
+
+// ————— COMPONENTS ————— //
+struct Transform2D
+{
+    glm::vec2 position          = glm::vec2(0.0f);
+    glm::vec2 previous_position = glm::vec2(0.0f);  // for render interpolation
+};
+
+struct Body
+{
+    BodyType  type         = DYNAMIC_BODY;
+    glm::vec2 velocity     = glm::vec2(0.0f),
+              acceleration = glm::vec2(0.0f),
+              movement     = glm::vec2(0.0f);
+    float     speed        = 0.0f,
+              drag         = 0.0f;
+
+    bool collided_top    = false,
+         collided_bottom = false,
+         collided_left   = false,
+         collided_right  = false;
+    bool win  = false,
+         loss = false;
+};
+
+struct AABB
+{
+    glm::vec2  half_size = glm::vec2(0.5f);
+    EntityType kind      = DEATH_PLATFORM;  // what landing on it means
+};
+
+struct Sprite
+{
+    unsigned int texture_id = 0;  // a GLuint
+    glm::vec4    uv_rect    = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    glm::vec2    size       = glm::vec2(1.0f);
+    int          layer      = 0;  // a RenderLayer
+    RenderMaterial material = TRANSLUCENT_MATERIAL;
+};
+
+struct SpriteAnimator
+{
+    static const int MAX_FRAMES = 4;
+
+    int frames[MAX_FRAMES] = { 0 };
+    int frame_count = 0,
+        current     = 0,  // index into frames
+        columns     = 1,
+        rows        = 1;
+};
+
+struct Booster
+{
+    float power  = 0.0f;
+    bool  active = false;
+};
+
+// ————— POOLS ————— //
+template <typename Component>
+class ComponentPool
+{
+private:
+    std::vector<Component> m_components;
+    std::vector<EntityId>  m_entities;  // owner of each dense slot
+    std::vector<int>       m_slots;     // entity id -> dense slot, -1 when absent
+
+public:
+    Component& add(EntityId entity, const Component& component = Component())
+    {
+        if (entity >= m_slots.size()) m_slots.resize(entity + 1, -1);
+        if (m_slots[entity] >= 0) return m_components[m_slots[entity]] = component;
+
+        m_slots[entity] = (int)m_components.size();
+        m_components.push_back(component);
+        m_entities.push_back(entity);
+        return m_components.back();
+    }
+
+    // Swaps the last component into the hole, so the pool stays dense but loses insertion order
+    void remove(EntityId entity)
+    {
+        if (!has(entity)) return;
+
+        int slot = m_slots[entity],
+            last = (int)m_components.size() - 1;
+
+        m_components[slot] = m_components[last];
+        m_entities[slot] = m_entities[last];
+        m_slots[m_entities[slot]] = slot;
+
+        m_components.pop_back();
+        m_entities.pop_back();
+        m_slots[entity] = -1;
+    }
+
+    void clear()
+    {
+        m_components.clear();
+        m_entities.clear();
+        m_slots.clear();
+    }
+
+    bool has(EntityId entity) const { return entity < m_slots.size() && m_slots[entity] >= 0; }
+
+    Component&       get(EntityId entity)       { return m_components[m_slots[entity]]; }
+    const Component& get(EntityId entity) const { return m_components[m_slots[entity]]; }
+
+    // Dense iteration: slot i holds the component of entity_at(i)
+    int size() const { return (int)m_components.size(); }
+    Component&       at(int slot)       { return m_components[slot]; }
+    const Component& at(int slot) const { return m_components[slot]; }
+    EntityId entity_at(int slot) const  { return m_entities[slot]; }
+};
+
+class Registry
+{
+private:
+    EntityId m_next_id = 0;
+    std::vector<EntityId> m_free_ids;
+
+public:
+    ComponentPool<Transform2D>    transforms;
+    ComponentPool<Body>           bodies;
+    ComponentPool<AABB>           boxes;
+    ComponentPool<Sprite>         sprites;
+    ComponentPool<SpriteAnimator> animators;
+    ComponentPool<Booster>        boosters;
+
+    EntityId create();
+    void     destroy(EntityId entity);
+    void     clear();
+};
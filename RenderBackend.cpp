@@ -0,0 +1,298 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+#define GL_SILENCE_DEPRECATION
+
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "RenderBackend.h"
+
+static RenderBackend* g_render_backend = NULL;
+
+RenderBackend* get_render_backend(RenderBackendType preferred)
+{
+    if (g_render_backend != NULL) return g_render_backend;
+
+    // Anything short of DSA gets the ES 2.0 path, which every context we run on can take
+    bool direct_state_access = !is_gles() && supports_direct_state_access();
+    if (direct_state_access && preferred != RENDER_BACKEND_GLES2) g_render_backend = new Gl45RenderBackend();
+    else                                                          g_render_backend = new Gles2RenderBackend();
+
+    return g_render_backend;
+}
+
+void destroy_render_backend()
+{
+    delete g_render_backend;
+    g_render_backend = NULL;
+}
+
+// ————— GLES2 ————— //
+Gles2RenderBackend::Gles2RenderBackend()
+{
+    // ES 2.0 has no vertex arrays and needs none; a desktop core profile refuses to draw without
+    // one bound, so there a single one stands in for the default
+    if (is_core_profile()) glGenVertexArrays(1, &m_vertex_array);
+}
+
+Gles2RenderBackend::~Gles2RenderBackend()
+{
+    if (m_vertex_array != 0) glDeleteVertexArrays(1, &m_vertex_array);
+}
+
+GLuint Gles2RenderBackend::create_buffer(GLenum target, size_t size, const void* data, GLenum usage)
+{
+    GLuint buffer = 0;
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    glBufferData(target, size, data, usage);
+    glBindBuffer(target, 0);
+    track_gpu_buffer(buffer, (long long)size);
+    return buffer;
+}
+
+void Gles2RenderBackend::update_buffer(GLuint buffer, GLenum target, size_t offset, size_t size, const void* data)
+{
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindBuffer(target, buffer);
+    glBufferSubData(target, offset, size, data);
+    glBindBuffer(target, 0);
+}
+
+void Gles2RenderBackend::delete_buffer(GLuint buffer)
+{
+    untrack_gpu_buffers(1, &buffer);
+    glDeleteBuffers(1, &buffer);
+}
+
+GLuint Gles2RenderBackend::create_texture(int width, int height, int levels, const void* pixels)
+{
+    // ES 2.0 wants the internal format to match the data's, and allocates mip levels as they're
+    // filled. Desktop GL can at least be told where the chain stops, as immutable storage would.
+    GLuint texture = 0;
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    track_gpu_texture(texture, estimate_texture_bytes(width, height, levels > 1));
+
+    if (!is_gles()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels < 1 ? 0 : levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+void Gles2RenderBackend::update_texture(GLuint texture, int x, int y, int width, int height, const void* pixels)
+{
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+void Gles2RenderBackend::delete_texture(GLuint texture)
+{
+    untrack_gpu_textures(1, &texture);
+    glDeleteTextures(1, &texture);
+}
+
+void Gles2RenderBackend::create_pipeline(Pipeline& pipeline, ShaderProgram* program, const VertexLayout& layout)
+{
+    // Nothing to record: the attributes are pointed at whichever buffer each begin_draws names
+    pipeline.program = program;
+    pipeline.layout = layout;
+    pipeline.vertex_array = 0;
+}
+
+void Gles2RenderBackend::delete_pipeline(Pipeline& pipeline)
+{
+    pipeline.program = NULL;
+}
+
+void Gles2RenderBackend::begin_draws(const Pipeline& pipeline, GLuint vertex_buffer, size_t vertex_offset, GLuint index_buffer)
+{
+    m_pipeline = &pipeline;
+    pipeline.program->use();
+
+    if (m_vertex_array != 0)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glBindVertexArray(m_vertex_array);
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    for (int i = 0; i < pipeline.layout.attribute_count; i++)
+    {
+        const VertexLayout::Attribute& attribute = pipeline.layout.attributes[i];
+        glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalised, pipeline.layout.stride,
+                              (void*)(vertex_offset + attribute.offset));
+        glEnableVertexAttribArray(attribute.location);
+    }
+
+    if (index_buffer != 0)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    }
+}
+
+void Gles2RenderBackend::bind_texture(GLenum target, GLuint texture)
+{
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(target, texture);
+}
+
+void Gles2RenderBackend::draw_triangles(int first_vertex, int vertex_count)
+{
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_TRIANGLES, first_vertex, vertex_count);
+}
+
+void Gles2RenderBackend::draw_indexed_triangles(int first_index, int index_count)
+{
+    // GL_UNSIGNED_INT indices are OES_element_index_uint on ES 2.0, which every board we target has
+    count_gl_call(GL_CALL_DRAW);
+    glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, (void*)((size_t)first_index * sizeof(GLuint)));
+}
+
+void Gles2RenderBackend::end_draws()
+{
+    if (m_pipeline == NULL) return;
+
+    for (int i = 0; i < m_pipeline->layout.attribute_count; i++) glDisableVertexAttribArray(m_pipeline->layout.attributes[i].location);
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glBindVertexArray(0);
+    }
+    m_pipeline = NULL;
+}
+
+// ————— GL 4.5 DSA ————— //
+GLuint Gl45RenderBackend::create_buffer(GLenum target, size_t size, const void* data, GLenum usage)
+{
+    // Mutable storage, so a later glNamedBufferData can still orphan it
+    GLuint buffer = 0;
+    count_gl_call(GL_CALL_UPLOAD);
+    glCreateBuffers(1, &buffer);
+    glNamedBufferData(buffer, size, data, usage);
+    track_gpu_buffer(buffer, (long long)size);
+    return buffer;
+}
+
+void Gl45RenderBackend::update_buffer(GLuint buffer, GLenum target, size_t offset, size_t size, const void* data)
+{
+    count_gl_call(GL_CALL_UPLOAD);
+    glNamedBufferSubData(buffer, offset, size, data);
+}
+
+void Gl45RenderBackend::delete_buffer(GLuint buffer)
+{
+    untrack_gpu_buffers(1, &buffer);
+    glDeleteBuffers(1, &buffer);
+}
+
+GLuint Gl45RenderBackend::create_texture(int width, int height, int levels, const void* pixels)
+{
+    // Immutable storage for the whole chain up front, so the driver never has to re-validate it
+    GLuint texture = 0;
+    count_gl_call(GL_CALL_UPLOAD);
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, levels < 1 ? 1 : levels, GL_RGBA8, width, height);
+    if (pixels != NULL) glTextureSubImage2D(texture, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    track_gpu_texture(texture, estimate_texture_bytes(width, height, levels > 1));
+
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    return texture;
+}
+
+void Gl45RenderBackend::update_texture(GLuint texture, int x, int y, int width, int height, const void* pixels)
+{
+    count_gl_call(GL_CALL_UPLOAD);
+    glTextureSubImage2D(texture, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+void Gl45RenderBackend::delete_texture(GLuint texture)
+{
+    untrack_gpu_textures(1, &texture);
+    glDeleteTextures(1, &texture);
+}
+
+void Gl45RenderBackend::create_pipeline(Pipeline& pipeline, ShaderProgram* program, const VertexLayout& layout)
+{
+    pipeline.program = program;
+    pipeline.layout = layout;
+
+    // The format is recorded once; begin_draws only swaps the buffer behind binding point 0
+    glCreateVertexArrays(1, &pipeline.vertex_array);
+    for (int i = 0; i < layout.attribute_count; i++)
+    {
+        const VertexLayout::Attribute& attribute = layout.attributes[i];
+        glEnableVertexArrayAttrib(pipeline.vertex_array, attribute.location);
+        glVertexArrayAttribFormat(pipeline.vertex_array, attribute.location, attribute.components, attribute.type, attribute.normalised, (GLuint)attribute.offset);
+        glVertexArrayAttribBinding(pipeline.vertex_array, attribute.location, 0);
+    }
+}
+
+void Gl45RenderBackend::delete_pipeline(Pipeline& pipeline)
+{
+    if (pipeline.vertex_array != 0) glDeleteVertexArrays(1, &pipeline.vertex_array);
+    pipeline.vertex_array = 0;
+    pipeline.program = NULL;
+}
+
+void Gl45RenderBackend::begin_draws(const Pipeline& pipeline, GLuint vertex_buffer, size_t vertex_offset, GLuint index_buffer)
+{
+    m_pipeline = &pipeline;
+    pipeline.program->use();
+
+    count_gl_call(GL_CALL_BIND, 3);
+    glVertexArrayVertexBuffer(pipeline.vertex_array, 0, vertex_buffer, (GLintptr)vertex_offset, pipeline.layout.stride);
+    glVertexArrayElementBuffer(pipeline.vertex_array, index_buffer);
+    glBindVertexArray(pipeline.vertex_array);
+}
+
+void Gl45RenderBackend::bind_texture(GLenum target, GLuint texture)
+{
+    // The texture carries its own target
+    count_gl_call(GL_CALL_BIND);
+    glBindTextureUnit(0, texture);
+}
+
+void Gl45RenderBackend::draw_triangles(int first_vertex, int vertex_count)
+{
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_TRIANGLES, first_vertex, vertex_count);
+}
+
+void Gl45RenderBackend::draw_indexed_triangles(int first_index, int index_count)
+{
+    count_gl_call(GL_CALL_DRAW);
+    glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, (void*)((size_t)first_index * sizeof(GLuint)));
+}
+
+void Gl45RenderBackend::end_draws()
+{
+    if (m_pipeline == NULL) return;
+
+    count_gl_call(GL_CALL_BIND);
+    glBindVertexArray(0);
+    m_pipeline = NULL;
+}
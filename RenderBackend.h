@@ -0,0 +1,155 @@
+#pragma once
+
+// The GL the renderers need to create and fill buffers and textures, describe their vertices
+// and draw, behind one interface with an implementation per tier of driver:
+//   Gles2RenderBackend  OpenGL ES 2.0 (the ARM boards), and any desktop GL without direct state
+//                       access. Binds to edit, and points the attributes afresh at every draw.
+//   Gl45RenderBackend   GL 4.5 or ARB_direct_state_access. Edits objects by name without touching
+//                       a binding, and records each pipeline's layout once in its own vertex array.
+// get_render_backend() picks the best one the context has, so a renderer written against it has
+// no version checks or platform #ifdefs of its own. Programs and uniforms stay with ShaderProgram.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstddef>
+#include "ShaderProgram.h"
+
+enum RenderBackendType { RENDER_BACKEND_AUTO, RENDER_BACKEND_GLES2, RENDER_BACKEND_GL45 };
+
+// Interleaved attributes in one buffer. Integer types reach the shader as floats: normalised to
+// [0, 1] or [-1, 1], or else as the plain value, e.g. GL_SHORT positions scaled by the model matrix.
+struct VertexLayout
+{
+    static const int MAX_ATTRIBUTES = 4;
+
+    struct Attribute
+    {
+        GLint     location;    // from the program; -1 (compiled out) is skipped
+        int       components;
+        size_t    offset;      // bytes into the vertex
+        GLenum    type;
+        GLboolean normalised;
+    };
+
+    Attribute attributes[MAX_ATTRIBUTES];
+    int       attribute_count = 0;
+    GLsizei   stride = 0;
+
+    VertexLayout& add(GLint location, int components, size_t offset, GLenum type = GL_FLOAT, bool normalised = false)
+    {
+        if (location >= 0 && attribute_count < MAX_ATTRIBUTES)
+        {
+            attributes[attribute_count++] = { location, components, offset, type, (GLboolean)(normalised ? GL_TRUE : GL_FALSE) };
+        }
+        return *this;
+    }
+};
+
+// A program and the vertices it reads, made by create_pipeline and owned by the caller
+struct Pipeline
+{
+    ShaderProgram* program = NULL;
+    VertexLayout   layout;
+    GLuint         vertex_array = 0;  // Gl45RenderBackend's record of the layout
+};
+
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() {};
+
+    // ————— BUFFERS ————— //
+    // `target` is GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER; data may be NULL
+    virtual GLuint create_buffer(GLenum target, size_t size, const void* data, GLenum usage) = 0;
+    virtual void   update_buffer(GLuint buffer, GLenum target, size_t offset, size_t size, const void* data) = 0;
+    virtual void   delete_buffer(GLuint buffer) = 0;
+
+    // ————— TEXTURES ————— //
+    // RGBA8 with room for `levels` mip levels, clamped to the edge; filters are TextureSampling's
+    virtual GLuint create_texture(int width, int height, int levels, const void* pixels) = 0;
+    virtual void   update_texture(GLuint texture, int x, int y, int width, int height, const void* pixels) = 0;
+    virtual void   delete_texture(GLuint texture) = 0;
+
+    // ————— PIPELINES ————— //
+    virtual void create_pipeline(Pipeline& pipeline, ShaderProgram* program, const VertexLayout& layout) = 0;
+    virtual void delete_pipeline(Pipeline& pipeline) = 0;
+
+    // ————— DRAWS ————— //
+    // Every draw between begin_draws and end_draws reads the pipeline's vertices from
+    // `vertex_buffer`, starting `vertex_offset` bytes in, and GL_UNSIGNED_INT indices from
+    // `index_buffer` if there is one. The program is made current.
+    virtual void begin_draws(const Pipeline& pipeline, GLuint vertex_buffer, size_t vertex_offset, GLuint index_buffer = 0) = 0;
+    virtual void bind_texture(GLenum target, GLuint texture) = 0;  // on unit 0
+    virtual void draw_triangles(int first_vertex, int vertex_count) = 0;
+    virtual void draw_indexed_triangles(int first_index, int index_count) = 0;
+    // Leaves no buffers or attribute arrays behind for the renderers still calling GL directly
+    virtual void end_draws() = 0;
+
+    virtual RenderBackendType const get_type() const = 0;
+    virtual const char*       const get_name() const = 0;
+};
+
+class Gles2RenderBackend : public RenderBackend
+{
+private:
+    const Pipeline* m_pipeline = NULL;
+    GLuint          m_vertex_array = 0;  // only in core profiles, which won't draw without one
+
+public:
+    Gles2RenderBackend();
+    ~Gles2RenderBackend();
+
+    GLuint create_buffer(GLenum target, size_t size, const void* data, GLenum usage) override;
+    void   update_buffer(GLuint buffer, GLenum target, size_t offset, size_t size, const void* data) override;
+    void   delete_buffer(GLuint buffer) override;
+
+    GLuint create_texture(int width, int height, int levels, const void* pixels) override;
+    void   update_texture(GLuint texture, int x, int y, int width, int height, const void* pixels) override;
+    void   delete_texture(GLuint texture) override;
+
+    void create_pipeline(Pipeline& pipeline, ShaderProgram* program, const VertexLayout& layout) override;
+    void delete_pipeline(Pipeline& pipeline) override;
+
+    void begin_draws(const Pipeline& pipeline, GLuint vertex_buffer, size_t vertex_offset, GLuint index_buffer = 0) override;
+    void bind_texture(GLenum target, GLuint texture) override;
+    void draw_triangles(int first_vertex, int vertex_count) override;
+    void draw_indexed_triangles(int first_index, int index_count) override;
+    void end_draws() override;
+
+    RenderBackendType const get_type() const override { return RENDER_BACKEND_GLES2; };
+    const char*       const get_name() const override { return "GLES2"; };
+};
+
+class Gl45RenderBackend : public RenderBackend
+{
+private:
+    const Pipeline* m_pipeline = NULL;
+
+public:
+    GLuint create_buffer(GLenum target, size_t size, const void* data, GLenum usage) override;
+    void   update_buffer(GLuint buffer, GLenum target, size_t offset, size_t size, const void* data) override;
+    void   delete_buffer(GLuint buffer) override;
+
+    GLuint create_texture(int width, int height, int levels, const void* pixels) override;
+    void   update_texture(GLuint texture, int x, int y, int width, int height, const void* pixels) override;
+    void   delete_texture(GLuint texture) override;
+
+    void create_pipeline(Pipeline& pipeline, ShaderProgram* program, const VertexLayout& layout) override;
+    void delete_pipeline(Pipeline& pipeline) override;
+
+    void begin_draws(const Pipeline& pipeline, GLuint vertex_buffer, size_t vertex_offset, GLuint index_buffer = 0) override;
+    void bind_texture(GLenum target, GLuint texture) override;
+    void draw_triangles(int first_vertex, int vertex_count) override;
+    void draw_indexed_triangles(int first_index, int index_count) override;
+    void end_draws() override;
+
+    RenderBackendType const get_type() const override { return RENDER_BACKEND_GL45; };
+    const char*       const get_name() const override { return "GL 4.5 DSA"; };
+};
+
+// GL thread, with the context current. Made on first use, of the `preferred` type if the context
+// supports it (RENDER_BACKEND_AUTO picks the fastest), and kept until destroy_render_backend.
+RenderBackend* get_render_backend(RenderBackendType preferred = RENDER_BACKEND_AUTO);
+void           destroy_render_backend();
@@ -0,0 +1,28 @@
+#pragma once
+
+// How a sprite's texels cover what is under them, which decides how RenderQueue draws it:
+//   OPAQUE_MATERIAL       every texel is solid, so blending is switched off and the GPU only writes
+//   CUTOUT_MATERIAL       texels are solid or empty; the empty ones are discarded, still unblended
+//   TRANSLUCENT_MATERIAL  anything in between, blended, and drawn after the other two in its layer
+// In enum order, so the worst of two materials is the larger.
+#include <cstddef>
+
+enum RenderMaterial { OPAQUE_MATERIAL, CUTOUT_MATERIAL, TRANSLUCENT_MATERIAL, RENDER_MATERIAL_COUNT };
+
+// The cheapest material that still draws width x height RGBA texels (rows `stride` bytes apart) as
+// blending would, at least where they aren't filtered into their neighbours
+inline RenderMaterial classify_material(const unsigned char* pixels, int width, int height, int stride)
+{
+    RenderMaterial material = OPAQUE_MATERIAL;
+    for (int y = 0; y < height; y++)
+    {
+        const unsigned char* row = pixels + (size_t)y * stride;
+        for (int x = 0; x < width; x++)
+        {
+            unsigned char alpha = row[x * 4 + 3];
+            if (alpha == 0)               material = CUTOUT_MATERIAL;
+            else if (alpha != 255) return TRANSLUCENT_MATERIAL;
+        }
+    }
+    return material;
+}
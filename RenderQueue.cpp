@@ -0,0 +1,352 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "RenderQueue.h"
+#include "Trace.h"
+
+// Where the fields of RenderCommand::sort_key start
+const int LAYER_SHIFT    = 56,
+          MATERIAL_SHIFT = 54,
+          SHADER_SHIFT   = 38,
+          TEXTURE_SHIFT  = 14;
+
+uint64_t RenderCommandBuffer::make_sort_key(RenderLayer layer, RenderMaterial material, ShaderProgram* program, GLuint texture_id)
+{
+    uint64_t shader = program != NULL ? program->get_program_id() : 0;
+
+    return ((uint64_t)layer & 0xFF) << LAYER_SHIFT |
+           ((uint64_t)material & 0x3) << MATERIAL_SHIFT |
+           (shader & 0xFFFF) << SHADER_SHIFT |
+           ((uint64_t)texture_id & 0xFFFFFF) << TEXTURE_SHIFT;
+}
+
+// ————— RECORDING ————— //
+void RenderCommandBuffer::begin(const RenderCommandBuffer& settings)
+{
+    m_commands.clear();
+    m_text_storage.clear();
+    m_culled_sprites = 0;
+
+    m_sprite_program = settings.m_sprite_program;
+    m_layered_program = settings.m_layered_program;
+    m_cutout_program = settings.m_cutout_program;
+    m_cutout_layered_program = settings.m_cutout_layered_program;
+    m_font_texture_id = settings.m_font_texture_id;
+    m_culling = settings.m_culling;
+    m_cull_min = settings.m_cull_min;
+    m_cull_max = settings.m_cull_max;
+}
+
+void RenderCommandBuffer::set_cull_bounds(glm::vec2 view_min, glm::vec2 view_max)
+{
+    m_culling = true;
+    m_cull_min = view_min;
+    m_cull_max = view_max;
+}
+
+bool RenderCommandBuffer::is_culled(RenderLayer layer, glm::vec2 position, glm::vec2 size)
+{
+    // The HUD is placed on screen by hand, so only the world is culled
+    glm::vec2 half_size = size * 0.5f;
+    if (m_culling && layer != HUD_LAYER &&
+        (position.x + half_size.x < m_cull_min.x || position.x - half_size.x > m_cull_max.x ||
+         position.y + half_size.y < m_cull_min.y || position.y - half_size.y > m_cull_max.y))
+    {
+        m_culled_sprites++;
+        return true;
+    }
+    return false;
+}
+
+void RenderCommandBuffer::submit_sprite_command(RenderLayer layer, RenderMaterial material, ShaderProgram* program, ShaderProgram* cutout_program, const SpriteQuad& sprite)
+{
+    // Cutouts need the discard; without it the empty texels would be drawn solid
+    if (material == CUTOUT_MATERIAL)
+    {
+        if (cutout_program != NULL) program = cutout_program;
+        else                        material = TRANSLUCENT_MATERIAL;
+    }
+
+    RenderCommand command = {};
+    command.sort_key = make_sort_key(layer, material, program, sprite.texture_id);
+    command.type = SPRITE_COMMAND;
+    command.program = program;
+    command.sprite = sprite;
+
+    m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::submit_sprite(RenderLayer layer, glm::vec2 position, glm::vec2 size, glm::vec4 uv_rect, GLuint texture_id, RenderMaterial material)
+{
+    if (is_culled(layer, position, size)) return;
+
+    submit_sprite_command(layer, material, m_sprite_program, m_cutout_program, { position, size, uv_rect, texture_id });
+}
+
+void RenderCommandBuffer::submit_layered_sprite(RenderLayer layer, glm::vec2 position, glm::vec2 size, int frame, GLuint array_id, RenderMaterial material)
+{
+    if (is_culled(layer, position, size)) return;
+
+    submit_sprite_command(layer, material, m_layered_program, m_cutout_layered_program,
+                          { position, size, glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), array_id, (float)frame });
+}
+
+void RenderCommandBuffer::submit_sprite_run(RenderLayer layer, SpriteQuad* quads, int count, RenderMaterial material)
+{
+    int kept = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!is_culled(layer, quads[i].position, quads[i].size)) quads[kept++] = quads[i];
+    }
+    if (kept == 0) return;
+
+    submit_sprite_command(layer, material, m_sprite_program, m_cutout_program, quads[0]);
+    m_commands.back().type = SPRITE_RUN_COMMAND;
+    m_commands.back().sprites = quads;
+    m_commands.back().sprite_count = kept;
+}
+
+void RenderCommandBuffer::submit_text(RenderLayer layer, ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position)
+{
+    // Batched text sorts with the sprites on its texture, so painter's order holds between them
+    bool batched = m_font_texture_id != 0 && program == m_sprite_program;
+
+    RenderCommand command = {};
+    command.sort_key = make_sort_key(layer, TRANSLUCENT_MATERIAL, program, batched ? m_font_texture_id : 0);
+    command.type = TEXT_COMMAND;
+    command.program = program;
+    command.batched = batched;
+    command.text_offset = (int)m_text_storage.size();
+    command.text_length = (int)text.size();
+    command.screen_size = screen_size;
+    command.spacing = spacing;
+    command.position = position;
+
+    m_text_storage.insert(m_text_storage.end(), text.begin(), text.end());
+    m_commands.push_back(command);
+}
+
+void RenderCommandBuffer::submit_transient_text(RenderLayer layer, ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position)
+{
+    submit_text(layer, program, text, screen_size, spacing, position);
+    m_commands.back().transient = true;
+}
+
+void RenderCommandBuffer::submit_custom(RenderLayer layer, ShaderProgram* program, GLuint texture_id, RenderCallback callback, void* user_data, RenderMaterial material)
+{
+    RenderCommand command = {};
+    command.sort_key = make_sort_key(layer, material, program, texture_id);
+    command.type = CUSTOM_COMMAND;
+    command.program = program;
+    command.callback = callback;
+    command.user_data = user_data;
+
+    m_commands.push_back(command);
+}
+
+// ————— QUEUE ————— //
+void RenderQueue::initialise(ShaderProgram* sprite_program, SpriteBatch* sprite_batch, TextMeshCache* text_meshes, FrameArena* frame_arena)
+{
+    m_sprite_program = sprite_program;
+    m_sprite_batch = sprite_batch;
+    m_text_meshes = text_meshes;
+    m_frame_arena = frame_arena;
+}
+
+void RenderQueue::begin()
+{
+    // Last frame's storage went back with the arena reset, so start over in fresh arena memory,
+    // sized from last frame so that a steady scene grows nothing
+    size_t command_count = m_commands.size(),
+           text_length   = m_text_storage.size();
+
+    m_commands = FrameVector<RenderCommand>(ArenaAllocator<RenderCommand>(m_frame_arena));
+    m_text_storage = FrameVector<char>(ArenaAllocator<char>(m_frame_arena));
+    m_order = FrameVector<int>(ArenaAllocator<int>(m_frame_arena));
+
+    m_commands.reserve(command_count);
+    m_text_storage.reserve(text_length);
+    m_culled_sprites = 0;
+}
+
+void RenderQueue::merge(const RenderCommandBuffer& buffer)
+{
+    // The buffer's text goes after the queue's, so its commands' offsets move up by as much
+    size_t command_count = m_commands.size(),
+           text_offset   = m_text_storage.size();
+
+    m_commands.insert(m_commands.end(), buffer.m_commands.begin(), buffer.m_commands.end());
+    m_text_storage.insert(m_text_storage.end(), buffer.m_text_storage.begin(), buffer.m_text_storage.end());
+
+    for (size_t i = command_count; i < m_commands.size(); i++)
+    {
+        if (m_commands[i].type == TEXT_COMMAND) m_commands[i].text_offset += (int)text_offset;
+    }
+    m_culled_sprites += buffer.m_culled_sprites;
+}
+
+void RenderQueue::flush_sprites(ShaderProgram* program)
+{
+    bool layered = program == m_layered_program || program == m_cutout_layered_program;
+    m_sprite_batch->flush(program, layered ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D);
+    m_draw_calls += m_sprite_batch->get_draw_calls();
+}
+
+void RenderQueue::sort_commands()
+{
+    m_program_changes = 0;
+    m_texture_changes = 0;
+    m_blend_changes = 0;
+    m_draw_calls = 0;
+
+    // Sorted through an index array in the frame arena: std::stable_sort would borrow a heap
+    // buffer every frame. The index breaks ties, so commands with equal keys keep their
+    // submission order (i.e. painter's order inside a layer).
+    m_order.resize(m_commands.size());
+    for (size_t i = 0; i < m_order.size(); i++) m_order[i] = (int)i;
+
+    std::sort(m_order.begin(), m_order.end(), [this](int a, int b)
+        {
+            if (m_commands[a].sort_key != m_commands[b].sort_key) return m_commands[a].sort_key < m_commands[b].sort_key;
+            return a < b;
+        });
+}
+
+void RenderQueue::flush(RenderLayer first, RenderLayer end)
+{
+    TRACE_ZONE("RenderQueue::flush");
+    if (m_order.size() != m_commands.size()) sort_commands();
+
+    const uint64_t BATCH_MASK   = ~(((uint64_t)1 << SHADER_SHIFT) - 1),                    // layer, material and shader bits
+                   PROGRAM_MASK = BATCH_MASK & (((uint64_t)1 << LAYER_SHIFT) - 1),            // material and shader bits
+                   TEXTURE_MASK = (((uint64_t)1 << SHADER_SHIFT) - 1) & ~(((uint64_t)1 << TEXTURE_SHIFT) - 1);
+    bool timing_layers = m_gpu_profiler != NULL && m_gpu_profiler->is_enabled();
+
+    // The layers are contiguous in key order, so the range is one slice of it
+    size_t begin_index = std::lower_bound(m_order.begin(), m_order.end(), (uint64_t)first << LAYER_SHIFT,
+                                          [this](int index, uint64_t key) { return m_commands[index].sort_key < key; }) - m_order.begin(),
+           end_index   = std::lower_bound(m_order.begin(), m_order.end(), (uint64_t)end << LAYER_SHIFT,
+                                          [this](int index, uint64_t key) { return m_commands[index].sort_key < key; }) - m_order.begin();
+
+    uint64_t batch_key = 0,
+             batch_texture = 0,
+             previous_key = 0;
+    bool batch_open = false,
+         batch_one_texture = true,
+         blending   = true;  // as initialise() left it
+    ShaderProgram* batch_program = NULL;
+
+    for (size_t i = begin_index; i < end_index; i++)
+    {
+        const RenderCommand& command = m_commands[m_order[i]];
+
+        if (i == begin_index || (command.sort_key >> SHADER_SHIFT) != (previous_key >> SHADER_SHIFT)) m_program_changes++;
+        if (i == begin_index || (command.sort_key & ~BATCH_MASK) != (previous_key & ~BATCH_MASK)) m_texture_changes++;
+        if (m_texture_cache != NULL && (i == begin_index || (command.sort_key & TEXTURE_MASK) != (previous_key & TEXTURE_MASK)))
+        {
+            m_texture_cache->touch((GLuint)((command.sort_key & TEXTURE_MASK) >> TEXTURE_SHIFT));
+        }
+        previous_key = command.sort_key;
+
+        // A sprite run ends when the material or shader changes, or something else has to draw in
+        // between. A new layer ends it too, unless everything so far and this are on one texture.
+        bool sprites = command.type == SPRITE_COMMAND || command.type == SPRITE_RUN_COMMAND || (command.type == TEXT_COMMAND && command.batched);
+        if (batch_open && sprites && (command.sort_key & BATCH_MASK) != batch_key)
+        {
+            bool carries_on = !timing_layers && (command.sort_key & PROGRAM_MASK) == (batch_key & PROGRAM_MASK) &&
+                              batch_one_texture && (command.sort_key & TEXTURE_MASK) == batch_texture;
+            if (carries_on) batch_key = command.sort_key & BATCH_MASK;
+            else
+            {
+                flush_sprites(batch_program);
+                batch_open = false;
+            }
+        }
+        else if (batch_open && !sprites)
+        {
+            flush_sprites(batch_program);
+            batch_open = false;
+        }
+        if (batch_open && (command.sort_key & TEXTURE_MASK) != batch_texture) batch_one_texture = false;
+
+        // Commands are sorted by layer, so each layer is one contiguous pass
+        if (m_gpu_profiler != NULL && (i == begin_index || (command.sort_key >> LAYER_SHIFT) != (m_commands[m_order[i - 1]].sort_key >> LAYER_SHIFT)))
+        {
+            m_gpu_profiler->begin_pass((int)(command.sort_key >> LAYER_SHIFT));
+        }
+
+        // Only translucent texels need the framebuffer read back; the rest of the layer just writes
+        bool translucent = ((command.sort_key >> MATERIAL_SHIFT) & 0x3) == TRANSLUCENT_MATERIAL;
+        if (translucent != blending)
+        {
+            if (translucent) glEnable(GL_BLEND);
+            else             glDisable(GL_BLEND);
+            blending = translucent;
+            m_blend_changes++;
+        }
+
+        if (sprites && !batch_open)
+        {
+            m_sprite_batch->begin();
+            batch_key = command.sort_key & BATCH_MASK;
+            batch_texture = command.sort_key & TEXTURE_MASK;
+            batch_program = command.program;
+            batch_open = true;
+            batch_one_texture = true;
+        }
+
+        switch (command.type)
+        {
+        case SPRITE_COMMAND:
+            m_sprite_batch->submit(command.sprite.position, command.sprite.size, command.sprite.uv_rect, command.sprite.texture_id, command.sprite.layer);
+            break;
+
+        case SPRITE_RUN_COMMAND:
+            m_sprite_batch->submit(command.sprites, command.sprite_count);
+            break;
+
+        case TEXT_COMMAND:
+        {
+            std::string_view text(m_text_storage.data() + command.text_offset, command.text_length);
+            if (command.batched)
+            {
+                // Quads in the frame arena, which the batch copies out of before the next reset
+                SpriteQuad* quads = ArenaAllocator<SpriteQuad>(m_frame_arena).allocate(text.size());
+                m_sprite_batch->submit(quads, m_text_meshes->write_glyph_quads(text, command.screen_size, command.spacing, command.position, quads));
+                break;
+            }
+            if (command.transient) m_text_meshes->draw_transient(command.program, text, command.screen_size, command.spacing, command.position);
+            else                   m_text_meshes->draw(command.program, text, command.screen_size, command.spacing, command.position);
+            m_draw_calls++;
+            break;
+        }
+
+        case CUSTOM_COMMAND:
+            command.callback(command.user_data);
+            break;
+        }
+    }
+
+    if (batch_open) flush_sprites(batch_program);
+    if (!blending) glEnable(GL_BLEND);
+    if (m_gpu_profiler != NULL) m_gpu_profiler->end_pass();
+}
+
+void RenderQueue::warm_up(PipelineWarmup& warmup)
+{
+    ShaderProgram* programs[] = { m_sprite_program, m_layered_program, m_cutout_program, m_cutout_layered_program };
+    for (ShaderProgram* program : programs)
+    {
+        if (program != NULL) m_sprite_batch->warm_up(warmup, program);
+    }
+}
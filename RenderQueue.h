@@ -0,0 +1,183 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ArenaAllocator.h"
+#include "GpuProfiler.h"
+#include "RenderMaterial.h"
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "TextMeshCache.h"
+#include "TextureCache.h"
+
+// Drawn back to front in this order
+enum RenderLayer { BACKGROUND_LAYER, WORLD_LAYER, ACTOR_LAYER, PARTICLE_LAYER, HUD_LAYER, RENDER_LAYER_COUNT };
+static_assert(RENDER_LAYER_COUNT <= GpuProfiler::MAX_PASSES, "the GPU profiler times one pass per layer");
+
+enum RenderCommandType { SPRITE_COMMAND, SPRITE_RUN_COMMAND, TEXT_COMMAND, CUSTOM_COMMAND };
+
+typedef void (*RenderCallback)(void* user_data);
+
+struct RenderCommand
+{
+    // layer (8 bits) | material (2 bits) | shader (16 bits) | texture (24 bits) | unused (14 bits)
+    uint64_t          sort_key;
+    RenderCommandType type;
+    ShaderProgram*    program;
+
+    SpriteQuad sprite;
+
+    // A run's quads, which stay where the caller put them
+    const SpriteQuad* sprites;
+    int               sprite_count;
+
+    // Text lives in the queue's own per-frame storage, so callers may pass temporaries
+    int       text_offset, text_length;
+    float     screen_size, spacing;
+    glm::vec3 position;
+    bool      transient;  // rebuilt every frame through TextMeshCache::draw_transient, never cached
+    bool      batched;    // goes into the sprite batch as glyph quads instead (set_glyph_batching)
+
+    RenderCallback callback;
+    void*          user_data;
+};
+
+// Commands recorded ahead of a RenderQueue's flush. The queue is one itself; standalone buffers
+// can be filled on job threads, one per task, and handed to the queue with merge() on the GL
+// thread. Recording never touches GL or anything another buffer does, so they all fill at once.
+// A standalone buffer keeps its heap storage from frame to frame, so a steady scene allocates
+// nothing once it has grown.
+class RenderCommandBuffer
+{
+protected:
+    friend class RenderQueue;
+
+    // The queue's live in the frame arena and are re-made by its begin(), after the arena's reset
+    FrameVector<RenderCommand> m_commands;
+    FrameVector<char>          m_text_storage;
+
+    ShaderProgram* m_sprite_program  = NULL,
+                 * m_layered_program = NULL,  // SHADER_LAYERED, for sprites out of texture arrays
+                 * m_cutout_program  = NULL,  // the same two with SHADER_ALPHA_TEST
+                 * m_cutout_layered_program = NULL;
+
+    int m_culled_sprites = 0;
+
+    GLuint m_font_texture_id = 0;  // set when text drawn with m_sprite_program batches with the sprites
+
+    bool      m_culling = false;
+    glm::vec2 m_cull_min, m_cull_max;
+
+    static uint64_t make_sort_key(RenderLayer layer, RenderMaterial material, ShaderProgram* program, GLuint texture_id);
+    bool is_culled(RenderLayer layer, glm::vec2 position, glm::vec2 size);
+    void submit_sprite_command(RenderLayer layer, RenderMaterial material, ShaderProgram* program, ShaderProgram* cutout_program, const SpriteQuad& sprite);
+
+public:
+    // Empties the buffer and takes `settings`' programs and cull bounds, e.g. the queue's once
+    // it has begun the frame
+    void begin(const RenderCommandBuffer& settings);
+
+    // Needed before submit_layered_sprite: a SHADER_TEXTURED | SHADER_LAYERED variant
+    void set_layered_program(ShaderProgram* layered_program) { m_layered_program = layered_program; };
+
+    // The SHADER_ALPHA_TEST variants of the sprite and layered programs. Without them, cutout
+    // sprites are drawn as translucent ones.
+    void set_cutout_programs(ShaderProgram* cutout_program, ShaderProgram* cutout_layered_program)
+    {
+        m_cutout_program = cutout_program;
+        m_cutout_layered_program = cutout_layered_program;
+    };
+
+    // When the sprite program is a SHADER_GLYPHS variant: text submitted with that same program is
+    // laid out as glyph quads from `font_texture_id` (TextMeshCache's) and batched with the sprites,
+    // rather than drawn on its own. 0 turns it off.
+    void set_glyph_batching(GLuint font_texture_id) { m_font_texture_id = font_texture_id; };
+
+    // Sprites below the HUD that lie wholly outside [view_min, view_max] are dropped on submit,
+    // until set again or disable_culling()
+    void set_cull_bounds(glm::vec2 view_min, glm::vec2 view_max);
+    void disable_culling() { m_culling = false; };
+
+    // `material` is the texels' (AtlasRegion::material); opaque and cutout ones draw unblended
+    void submit_sprite(RenderLayer layer, glm::vec2 position, glm::vec2 size, glm::vec4 uv_rect, GLuint texture_id, RenderMaterial material = TRANSLUCENT_MATERIAL);
+    // Layer `frame` of a texture array (TextureArray.h), whole. Frames of every array batch together.
+    void submit_layered_sprite(RenderLayer layer, glm::vec2 position, glm::vec2 size, int frame, GLuint array_id, RenderMaterial material = TRANSLUCENT_MATERIAL);
+    // `count` sprites as one command, e.g. from Entity::write_sprite_quads, with `material` the
+    // worst of theirs. They sort under the first one's texture. Culled ones are dropped by moving
+    // the rest down, and the array must then stay put until the flush: the frame arena's, say.
+    void submit_sprite_run(RenderLayer layer, SpriteQuad* quads, int count, RenderMaterial material = TRANSLUCENT_MATERIAL);
+    void submit_text(RenderLayer layer, ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position);
+
+    // For text that changes most frames (timers, stats), which would only churn the mesh cache
+    void submit_transient_text(RenderLayer layer, ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position);
+
+    // For draws that manage their own geometry (instanced groups, full-screen passes, ...). The
+    // queue only sets the blending for `material`: a cutout callback has to discard for itself.
+    void submit_custom(RenderLayer layer, ShaderProgram* program, GLuint texture_id, RenderCallback callback, void* user_data, RenderMaterial material = TRANSLUCENT_MATERIAL);
+
+    int const get_command_count()  const { return (int)m_commands.size(); };
+    int const get_culled_sprites() const { return m_culled_sprites; };  // since begin()
+};
+
+class RenderQueue : public RenderCommandBuffer
+{
+private:
+    FrameVector<int> m_order;  // m_commands by key, once the first flush has sorted them
+    FrameArena*      m_frame_arena = NULL;
+
+    SpriteBatch*   m_sprite_batch   = NULL;
+    TextMeshCache* m_text_meshes    = NULL;
+    GpuProfiler*   m_gpu_profiler   = NULL;
+    TextureCache*  m_texture_cache  = NULL;
+
+    int m_program_changes = 0,
+        m_texture_changes = 0,
+        m_blend_changes   = 0,
+        m_draw_calls      = 0;  // sprite batches and unbatched text; custom commands count their own
+
+    void flush_sprites(ShaderProgram* program);
+    void sort_commands();
+
+public:
+    void initialise(ShaderProgram* sprite_program, SpriteBatch* sprite_batch, TextMeshCache* text_meshes, FrameArena* frame_arena);
+
+    // Every layer flush() draws becomes one GPU pass, indexed by its RenderLayer
+    void set_gpu_profiler(GpuProfiler* gpu_profiler) { m_gpu_profiler = gpu_profiler; };
+
+    // Every texture flush() draws from is touched, so the cache knows what's in use (a run of
+    // sprites by the texture it sorted under)
+    void set_texture_cache(TextureCache* texture_cache) { m_texture_cache = texture_cache; };
+
+    // Call after resetting the frame arena: anything queued before it is discarded
+    void begin();
+
+    // Appends what `buffer` recorded, as if submitted here in one go, so merging buffers in a
+    // fixed order keeps painter's order however the recording was shared out. GL thread, once
+    // every job writing to `buffer` has finished, and before flush().
+    void merge(const RenderCommandBuffer& buffer);
+
+    // Sorts by key and draws layers [first, end), batching every run of sprites (and batched text)
+    // that share a layer, material and shader. A run carries on into the next layer while it is all
+    // one texture, since the batch only reorders by texture, unless the GPU profiler is timing the
+    // layers apart. Inside a layer, opaque commands draw first and translucent ones last, blending
+    // only for those; it is left on afterwards, as initialise() in main.cpp sets it.
+    // Several calls over rising ranges leave room for work between layers, like DynamicResolution's
+    // upscale before the HUD; the queue is only sorted once, so submit first.
+    void flush(RenderLayer first = BACKGROUND_LAYER, RenderLayer end = RENDER_LAYER_COUNT);
+
+    // After the programs are set: every sprite program flush() can batch with, through the batch
+    void warm_up(PipelineWarmup& warmup);
+
+    // Since the last sort, i.e. over every flush of the frame
+    int const get_program_changes() const { return m_program_changes; };
+    int const get_texture_changes() const { return m_texture_changes; };
+    int const get_blend_changes()   const { return m_blend_changes; };
+    int const get_draw_calls()      const { return m_draw_calls; };
+};
@@ -0,0 +1,308 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cstring>
+#include "RewindBuffer.h"
+#include "Trace.h"
+
+// Zeros shorter than this stay inside a literal, since a new run would cost two varints
+const size_t MIN_ZERO_RUN = 4;
+
+// ————— CODEC ————— //
+static void write_varint(std::vector<uint8_t>& out, size_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+static size_t read_varint(const uint8_t*& in)
+{
+    size_t value = 0;
+    int shift = 0;
+    while (*in & 0x80)
+    {
+        value |= (size_t)(*in++ & 0x7f) << shift;
+        shift += 7;
+    }
+    value |= (size_t)*in++ << shift;
+    return value;
+}
+
+void RewindBuffer::encode_delta(const uint8_t* image, const uint8_t* reference, size_t size, std::vector<uint8_t>& out)
+{
+    auto delta = [image, reference](size_t i) { return (uint8_t)(image[i] ^ (reference != NULL ? reference[i] : 0)); };
+
+    size_t i = 0;
+    while (i < size)
+    {
+        // STEP 1: Unchanged bytes, eight at a time while they last
+        size_t zero_start = i;
+        if (reference != NULL)
+        {
+            while (i + 8 <= size && std::memcmp(image + i, reference + i, 8) == 0) i += 8;
+        }
+        while (i < size && delta(i) == 0) i++;
+
+        // STEP 2: Changed bytes, up to the next run of zeros worth its own varints
+        size_t literal_start = i;
+        while (i < size)
+        {
+            if (delta(i) != 0)
+            {
+                i++;
+                continue;
+            }
+            size_t run_end = i;
+            while (run_end < size && run_end - i < MIN_ZERO_RUN && delta(run_end) == 0) run_end++;
+            if (run_end - i >= MIN_ZERO_RUN || run_end == size) break;
+            i = run_end;
+        }
+
+        write_varint(out, literal_start - zero_start);
+        write_varint(out, i - literal_start);
+        for (size_t j = literal_start; j < i; j++) out.push_back(delta(j));
+    }
+}
+
+void RewindBuffer::decode_delta(const uint8_t* encoded, size_t encoded_size, const uint8_t* reference, size_t size, uint8_t* image)
+{
+    if (reference != NULL) std::memcpy(image, reference, size);
+    else                   std::memset(image, 0, size);
+
+    const uint8_t* in  = encoded,
+                 * end = encoded + encoded_size;
+    size_t position = 0;
+    while (in < end)
+    {
+        position += read_varint(in);
+        size_t literals = read_varint(in);
+        for (size_t j = 0; j < literals; j++) image[position++] ^= *in++;
+    }
+}
+
+// ————— IMAGES ————— //
+template <typename T>
+static void append(std::vector<uint8_t>& image, const T& value)
+{
+    const uint8_t* bytes = (const uint8_t*)&value;
+    image.insert(image.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static void take(const uint8_t*& in, T& value)
+{
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+}
+
+bool RewindBuffer::pack(const GameState& state, std::vector<uint8_t>& image)
+{
+    if (!save_snapshot(state, m_snapshot)) return false;
+
+    // Field by field, so nothing between them is padding that could differ from step to step
+    image.clear();
+    append(image, m_snapshot.player);
+    append(image, m_snapshot.lander_count);
+    for (int i = 0; i < m_snapshot.lander_count; i++)
+    {
+        append(image, m_snapshot.landers[i]);
+        append(image, m_snapshot.lander_outcomes[i]);
+    }
+
+    int platform_count = m_snapshot.platforms.get_count();
+    append(image, platform_count);
+    const ColliderBox* boxes = m_snapshot.platforms.data();
+    for (int i = 0; i < platform_count; i++)
+    {
+        append(image, boxes[i].x);
+        append(image, boxes[i].y);
+        append(image, boxes[i].width);
+        append(image, boxes[i].height);
+        append(image, boxes[i].entity_type);
+        append(image, boxes[i].active);
+    }
+
+    append(image, m_snapshot.win);
+    append(image, m_snapshot.loss);
+    append(image, m_snapshot.tick_accumulator);
+    append(image, m_snapshot.step_hash);
+    return true;
+}
+
+void RewindBuffer::unpack(const std::vector<uint8_t>& image, GameState& state)
+{
+    const uint8_t* in = image.data();
+    take(in, m_snapshot.player);
+    take(in, m_snapshot.lander_count);
+    for (int i = 0; i < m_snapshot.lander_count; i++)
+    {
+        take(in, m_snapshot.landers[i]);
+        take(in, m_snapshot.lander_outcomes[i]);
+    }
+
+    int platform_count = 0;
+    take(in, platform_count);
+    m_snapshot.platforms.resize(platform_count);
+    ColliderBox* boxes = m_snapshot.platforms.data();
+    for (int i = 0; i < platform_count; i++)
+    {
+        take(in, boxes[i].x);
+        take(in, boxes[i].y);
+        take(in, boxes[i].width);
+        take(in, boxes[i].height);
+        take(in, boxes[i].entity_type);
+        take(in, boxes[i].active);
+    }
+
+    take(in, m_snapshot.win);
+    take(in, m_snapshot.loss);
+    take(in, m_snapshot.tick_accumulator);
+    take(in, m_snapshot.step_hash);
+
+    restore_snapshot(state, m_snapshot);
+}
+
+// ————— RING ————— //
+void RewindBuffer::initialise(int capacity_steps, int keyframe_interval)
+{
+    m_keyframe_interval = std::max(keyframe_interval, 1);
+
+    // One more block than the steps need, since the oldest is dropped whole
+    int block_count = (std::max(capacity_steps, 1) + m_keyframe_interval - 1) / m_keyframe_interval + 1;
+    m_blocks.assign(block_count, Block());
+    clear();
+}
+
+void RewindBuffer::clear()
+{
+    m_first_block = 0;
+    m_block_count = 0;
+    m_newest_step = -1;
+}
+
+bool RewindBuffer::record(const GameState& state)
+{
+    TRACE_ZONE("RewindBuffer::record");
+    if (m_blocks.empty() || !pack(state, m_image)) return false;
+
+    // The first image is what every keyframe is told apart from; a level of another size starts over
+    if (is_empty() || m_image.size() != m_base.size())
+    {
+        clear();
+        m_base = m_image;
+    }
+    long long step = m_newest_step + 1;
+
+    // STEP 1: A keyframe to start a new block, the oldest dropped if the ring is full...
+    if (m_block_count == 0 || get_block(m_block_count - 1).step_count == m_keyframe_interval)
+    {
+        if (m_block_count == (int)m_blocks.size())
+        {
+            m_first_block = (m_first_block + 1) % (int)m_blocks.size();
+            m_block_count--;
+        }
+
+        Block& block = get_block(m_block_count++);
+        block.first_step = step;
+        block.step_count = 1;
+        block.keyframe.clear();
+        block.deltas.clear();
+        block.delta_ends.clear();
+        encode_delta(m_image.data(), m_base.data(), m_image.size(), block.keyframe);
+        m_keyframe_image = m_image;
+    }
+    // ...or the step against the block's keyframe
+    else
+    {
+        Block& block = get_block(m_block_count - 1);
+        encode_delta(m_image.data(), m_keyframe_image.data(), m_image.size(), block.deltas);
+        block.delta_ends.push_back((uint32_t)block.deltas.size());
+        block.step_count++;
+    }
+
+    m_newest_step = step;
+    return true;
+}
+
+void RewindBuffer::decode_step(long long step)
+{
+    const Block& block = get_block((int)((step - get_block(0).first_step) / m_keyframe_interval));
+    int index = (int)(step - block.first_step);
+
+    m_restored.resize(m_base.size());
+    m_image.resize(m_base.size());
+    decode_delta(block.keyframe.data(), block.keyframe.size(), m_base.data(), m_base.size(), m_restored.data());
+    if (index == 0)
+    {
+        std::memcpy(m_image.data(), m_restored.data(), m_base.size());
+        return;
+    }
+
+    uint32_t start = index > 1 ? block.delta_ends[index - 2] : 0,
+             end   = block.delta_ends[index - 1];
+    decode_delta(block.deltas.data() + start, end - start, m_restored.data(), m_base.size(), m_image.data());
+}
+
+int RewindBuffer::rewind(GameState& state, int steps)
+{
+    TRACE_ZONE("RewindBuffer::rewind");
+    if (is_empty() || steps <= 0) return 0;
+
+    long long oldest = get_block(0).first_step,
+              target = std::max(m_newest_step - steps, oldest);
+    if (target == m_newest_step) return 0;
+
+    decode_step(target);
+    unpack(m_image, state);
+
+    // Everything after the target goes; its block carries on from it, with its keyframe as decoded
+    int order = (int)((target - oldest) / m_keyframe_interval);
+    Block& block = get_block(order);
+    block.step_count = (int)(target - block.first_step) + 1;
+    block.delta_ends.resize(block.step_count - 1);
+    block.deltas.resize(block.delta_ends.empty() ? 0 : block.delta_ends.back());
+    m_block_count = order + 1;
+    m_keyframe_image = m_restored;
+
+    int rewound = (int)(m_newest_step - target);
+    m_newest_step = target;
+    return rewound;
+}
+
+int const RewindBuffer::get_step_count() const
+{
+    return is_empty() ? 0 : (int)(m_newest_step - get_block(0).first_step + 1);
+}
+
+size_t const RewindBuffer::get_encoded_bytes() const
+{
+    size_t bytes = 0;
+    for (int i = 0; i < m_block_count; i++)
+    {
+        const Block& block = get_block(i);
+        bytes += block.keyframe.size() + block.deltas.size() + block.delta_ends.size() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+size_t const RewindBuffer::get_memory_bytes() const
+{
+    size_t bytes = m_blocks.capacity() * sizeof(Block) + m_base.capacity() + m_keyframe_image.capacity() + m_image.capacity() + m_restored.capacity();
+    for (const Block& block : m_blocks)
+    {
+        bytes += block.keyframe.capacity() + block.deltas.capacity() + block.delta_ends.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// The last few seconds of a level, step by step, for rewinding in practice. Every step's state is
+// flattened into a byte image (the landers' BodyStates, the platforms' boxes, the outcome), and
+// almost none of it changes from one step to the next: the platforms only move if they are
+// movers, and the landers are a few hundred bytes. So images are stored as XOR deltas, which are
+// mostly zeros, packed by a zero-run codec: a varint count of zero bytes, a varint count of
+// literal bytes, the literals, and again. Encoding skips matching bytes eight at a time.
+//
+// Steps are grouped into blocks of keyframe_interval. A block starts with a keyframe, delta'd
+// against the level's first image so that everything standing still costs nothing, and every
+// other step in it is delta'd against that keyframe. Restoring any step is then two decodes, never
+// a chain of them, and a whole block is dropped when the ring needs room. Nothing allocates once
+// each block has grown to its working size.
+//
+// Like SimulationSnapshot (whose save and restore this goes through), a rewind only goes back
+// within the level the buffer was filled from; clear() when another is entered.
+#include <cstdint>
+#include <vector>
+#include "Simulation.h"
+
+class RewindBuffer
+{
+private:
+    struct Block
+    {
+        long long             first_step = 0;
+        int                   step_count = 0;  // the keyframe included
+        std::vector<uint8_t>  keyframe;        // against m_base
+        std::vector<uint8_t>  deltas;          // against the keyframe, one after another
+        std::vector<uint32_t> delta_ends;      // where step first_step + 1 + i's delta ends
+    };
+
+    int m_keyframe_interval = 30;
+
+    std::vector<Block> m_blocks;  // a ring
+    int m_first_block = 0,
+        m_block_count = 0;
+
+    std::vector<uint8_t> m_base,            // the first image since clear()
+                         m_keyframe_image,  // the newest block's keyframe, decoded
+                         m_image,           // scratch
+                         m_restored;        // scratch
+    SimulationSnapshot   m_snapshot;        // scratch
+
+    long long m_newest_step = -1;  // -1 while empty
+
+    bool pack(const GameState& state, std::vector<uint8_t>& image);
+    void unpack(const std::vector<uint8_t>& image, GameState& state);
+    Block& get_block(int order) { return m_blocks[(m_first_block + order) % (int)m_blocks.size()]; };
+    const Block& get_block(int order) const { return m_blocks[(m_first_block + order) % (int)m_blocks.size()]; };
+    // Into m_image, with its block's keyframe left in m_restored
+    void decode_step(long long step);
+
+public:
+    // Room for at least `capacity_steps` steps, in blocks of `keyframe_interval`
+    void initialise(int capacity_steps, int keyframe_interval = 30);
+    void clear();
+
+    // After every step: `state` as it now stands becomes the newest step. False, with nothing
+    // recorded, for a state save_snapshot can't hold.
+    bool record(const GameState& state);
+
+    // Back `steps` steps from the newest, as far as the oldest held, into `state`; everything newer
+    // is dropped, so recording carries on from there. Returns how many steps it went back.
+    int rewind(GameState& state, int steps);
+
+    bool      const is_empty()          const { return m_newest_step < 0; };
+    int       const get_step_count()    const;
+    long long const get_newest_step()   const { return m_newest_step; };
+    size_t    const get_encoded_bytes() const;  // the deltas and keyframes held
+    size_t    const get_memory_bytes()  const;  // everything allocated, scratch included
+
+    // The codec, for anything else with mostly-unchanged images. `reference` is NULL to encode
+    // the image itself; decoding needs the same reference and the image's size.
+    static void encode_delta(const uint8_t* image, const uint8_t* reference, size_t size, std::vector<uint8_t>& out);
+    static void decode_delta(const uint8_t* encoded, size_t encoded_size, const uint8_t* reference, size_t size, uint8_t* image);
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+// Counter-based random numbers: the n-th value of a stream is a hash of (key, n), so any stream
+// can be started anywhere without stepping through the ones before it, and streams for different
+// seeds or stream ids don't overlap the way adjacent seeds of a shared generator can. Every world
+// or env can own one, seeded from its own index, and parallel runs never have to coordinate.
+//
+// Only integer arithmetic and basic float operations are used, never <random>'s distributions or
+// libm, since those are free to differ between standard libraries. One seed gives the same
+// numbers with MSVC, GCC and Clang, on any CPU.
+#include <cstdint>
+
+class Rng
+{
+private:
+    static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ull;
+
+    uint64_t m_key     = 0,
+             m_counter = 0;
+
+    // SplitMix64's finaliser
+    static uint64_t mix(uint64_t value)
+    {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+public:
+    Rng() = default;
+    // `stream` picks one of many independent sequences under the same seed, e.g. one per env
+    explicit Rng(uint64_t seed, uint64_t stream = 0) : m_key(mix(seed ^ mix(stream + GOLDEN_GAMMA))) {}
+
+    uint64_t next_u64() { return mix(m_key + GOLDEN_GAMMA * ++m_counter); }
+    uint32_t next_u32() { return (uint32_t)(next_u64() >> 32); }
+
+    // [0, 1), from the top 24 bits so every value is exact in a float
+    float next_float() { return (float)(next_u32() >> 8) * (1.0f / 16777216.0f); }
+
+    // min to max inclusive. Multiply-shift rather than rejection, so it always takes one draw;
+    // the bias is below range / 2^32, far under anything a level layout can show.
+    int next_int(int min, int max) { return min + (int)(((uint64_t)next_u32() * (uint64_t)(max - min + 1)) >> 32); }
+
+    bool next_bool() { return (next_u32() >> 31) != 0; }
+
+    // Twelve uniforms summed (Irwin-Hall): close to normal out to 6 standard deviations either side and
+    // built from additions alone, so unlike Box-Muller it needs no log or cos to agree everywhere
+    float next_normal(float mean, float standard_deviation)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < 12; i++) sum += next_float();
+        return mean + (sum - 6.0f) * standard_deviation;
+    }
+
+    // Jump to the n-th value of the stream
+    void     seek(uint64_t counter)  { m_counter = counter; }
+    uint64_t get_counter()     const { return m_counter; }
+};
@@ -0,0 +1,355 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <thread>
+#include "BitStream.h"
+#include "InputReplay.h"
+#include "RollbackSession.h"
+#include "Trace.h"
+
+const double   RollbackPeer::RESEND_SECONDS = 1.0 / 30.0;
+const uint32_t ROLLBACK_PROTOCOL_ID = 0x4c4e5631;  // "LNV1"
+const double   HELLO_RETRY_SECONDS  = 0.1;
+const int      MAX_PACKET           = 128;
+
+enum RollbackPacketType { ROLLBACK_HELLO, ROLLBACK_INPUT, ROLLBACK_BYE };
+
+// ————— SESSION ————— //
+void RollbackSession::begin(GameState& state, int player_count, int local_player)
+{
+    m_state = &state;
+    m_player_count = std::min(player_count, ROLLBACK_MAX_PLAYERS);
+    m_local_player = local_player;
+    m_frame = 0;
+    m_rollback_frame = INT_MAX;
+
+    for (int player = 0; player < ROLLBACK_MAX_PLAYERS; player++)
+    {
+        m_confirmed[player] = -1;
+        std::fill(m_input_frames[player], m_input_frames[player] + INPUT_RING, -1);
+    }
+
+    m_rollbacks = 0;
+    m_resimulated_frames = 0;
+    m_deepest_rollback = 0;
+}
+
+bool RollbackSession::has_input(int player, int frame) const
+{
+    return frame >= 0 && m_input_frames[player][frame % INPUT_RING] == frame;
+}
+
+int RollbackSession::get_input(int player, int frame) const
+{
+    if (has_input(player, frame)) return m_inputs[player][frame % INPUT_RING];
+
+    // Not in yet: whatever the player was last known to be holding
+    int last = m_confirmed[player];
+    return has_input(player, last) ? m_inputs[player][last % INPUT_RING] : REPLAY_NONE;
+}
+
+void RollbackSession::store_input(int player, int frame, int action)
+{
+    m_inputs[player][frame % INPUT_RING] = action;
+    m_input_frames[player][frame % INPUT_RING] = frame;
+    while (has_input(player, m_confirmed[player] + 1)) m_confirmed[player]++;
+}
+
+void RollbackSession::add_remote_input(int player, int frame, int action)
+{
+    if (player < 0 || player >= m_player_count || player == m_local_player) return;
+
+    // Before the window it can't be corrected; far past it, the slot still holds one that's needed
+    if (frame < m_frame - ROLLBACK_WINDOW || frame >= m_frame + INPUT_RING - ROLLBACK_WINDOW || has_input(player, frame)) return;
+    store_input(player, frame, action);
+
+    // A frame already simulated with a different guess has to be done again
+    if (frame < m_frame && m_frames[frame % ROLLBACK_WINDOW].inputs[player] != action) m_rollback_frame = std::min(m_rollback_frame, frame);
+}
+
+bool const RollbackSession::can_advance() const
+{
+    for (int player = 0; player < m_player_count; player++)
+    {
+        if (player != m_local_player && m_frame - m_confirmed[player] > ROLLBACK_WINDOW) return false;
+    }
+    return true;
+}
+
+void RollbackSession::save_frame(Frame& frame) const
+{
+    for (int player = 0; player < m_player_count; player++)
+    {
+        get_lander(*m_state, player)->save_state(frame.landers[player]);
+        frame.outcomes[player] = get_lander_outcome(*m_state, player);
+    }
+}
+
+void RollbackSession::restore_frame(const Frame& frame)
+{
+    for (int player = 0; player < m_player_count; player++)
+    {
+        get_lander(*m_state, player)->restore_state(frame.landers[player]);
+        if (player == 0)
+        {
+            m_state->win = frame.outcomes[0].win;
+            m_state->loss = frame.outcomes[0].loss;
+        }
+        else m_state->lander_outcomes[player - 1] = frame.outcomes[player];
+    }
+}
+
+void RollbackSession::simulate(int frame_index)
+{
+    Frame& frame = m_frames[frame_index % ROLLBACK_WINDOW];
+    save_frame(frame);
+
+    // A lander that's down lets go of the controls, as on every other peer
+    for (int player = 0; player < m_player_count; player++)
+    {
+        LanderOutcome outcome = get_lander_outcome(*m_state, player);
+        frame.inputs[player] = get_input(player, frame_index);
+        apply_replay_action(get_lander(*m_state, player), outcome.win || outcome.loss ? REPLAY_NONE : frame.inputs[player]);
+    }
+    step_simulation(*m_state, m_state->fixed_timestep);
+}
+
+void RollbackSession::advance(int local_action)
+{
+    TRACE_ZONE("rollback advance");
+    store_input(m_local_player, m_frame, local_action);
+
+    // STEP 1: Back to the first frame that guessed wrong, and forward again with what's known now
+    if (m_rollback_frame < m_frame)
+    {
+        TRACE_ZONE("rollback");
+        int depth = m_frame - m_rollback_frame;
+        restore_frame(m_frames[m_rollback_frame % ROLLBACK_WINDOW]);
+
+        // The readers heard these frames' events the first time round
+        GameEventStream* events = m_state->events;
+        m_state->events = NULL;
+        for (int frame = m_rollback_frame; frame < m_frame; frame++) simulate(frame);
+        m_state->events = events;
+
+        m_rollbacks++;
+        m_resimulated_frames += depth;
+        m_deepest_rollback = std::max(m_deepest_rollback, depth);
+    }
+    m_rollback_frame = INT_MAX;
+
+    // STEP 2: The new frame
+    simulate(m_frame);
+    m_frame++;
+}
+
+// ————— TRANSPORT ————— //
+static void write_header(BitWriter& writer, RollbackPacketType type)
+{
+    writer.write_bits(ROLLBACK_PROTOCOL_ID, 32);
+    writer.write_bits((uint32_t)type, 2);
+}
+
+void RollbackPeer::send_hello(bool heard)
+{
+    uint8_t buffer[MAX_PACKET];
+    BitWriter writer(buffer, sizeof(buffer));
+    write_header(writer, ROLLBACK_HELLO);
+    writer.write_bits(m_nonce, 32);
+    writer.write_bool(heard);
+    writer.write_bits(m_own_seed, 32);
+    writer.write_bits((uint32_t)m_own_scene.layout, 8);
+    writer.write_bits((uint32_t)m_own_scene.platform_count, 32);
+    m_socket.send(m_peer, buffer, writer.get_byte_count());
+}
+
+bool RollbackPeer::connect(uint16_t port, const char* peer_host_port, unsigned int seed, const SceneConfig& scene, double timeout)
+{
+    disconnect();
+    if (!resolve_address(peer_host_port, m_peer) || !m_socket.open(port)) return false;
+
+    m_nonce = std::random_device{}();
+    m_own_seed = seed;
+    m_own_scene = scene;
+    m_acked_frame = -1;
+    m_sent_frame = -1;
+    m_peer_frame = -1;
+    m_peer_ahead = 0;
+
+    bool heard = false, heard_back = false;
+    uint32_t     peer_nonce = 0;
+    unsigned int peer_seed = 0;
+    SceneConfig  peer_scene = scene;
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0, next_hello = 0.0;
+    while (seconds < timeout && !(heard && heard_back))
+    {
+        // STEP 1: Hello, and again, until the peer has said it heard us
+        if (seconds >= next_hello)
+        {
+            send_hello(heard);
+            next_hello = seconds + HELLO_RETRY_SECONDS;
+        }
+
+        // STEP 2: The peer's hello, or its first inputs if it heard us and has already started
+        uint8_t    buffer[MAX_PACKET];
+        NetAddress address;
+        int size;
+        while ((size = m_socket.receive(address, buffer, sizeof(buffer))) > 0)
+        {
+            BitReader reader(buffer, (size_t)size);
+            if (address != m_peer || reader.read_bits(32) != ROLLBACK_PROTOCOL_ID) continue;
+
+            RollbackPacketType type = (RollbackPacketType)reader.read_bits(2);
+            if (type == ROLLBACK_INPUT) heard_back = true;
+            if (type != ROLLBACK_HELLO) continue;
+
+            uint32_t nonce = reader.read_bits(32);
+            bool     peer_heard = reader.read_bool();
+            unsigned int hello_seed = reader.read_bits(32);
+            SceneLayout  layout = (SceneLayout)reader.read_bits(8);
+            int          platform_count = (int)reader.read_bits(32);
+            if (reader.has_overflowed() || layout >= SCENE_LAYOUT_COUNT || platform_count <= 0) continue;
+
+            // Both ends starting with the same nonce is one in four billion; pick again and carry on
+            if (nonce == m_nonce)
+            {
+                m_nonce = std::random_device{}();
+                continue;
+            }
+
+            peer_nonce = nonce;
+            peer_seed = hello_seed;
+            peer_scene.layout = layout;
+            peer_scene.platform_count = platform_count;
+            heard_back |= peer_heard;
+            if (!heard) next_hello = seconds;  // tell it straight away
+            heard = true;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    if (!heard || !heard_back)
+    {
+        m_socket.close();
+        return false;
+    }
+
+    // One last hello, in case the peer is still waiting to hear it was heard
+    send_hello(true);
+
+    bool own_level = m_nonce < peer_nonce;
+    m_seed  = own_level ? m_own_seed : peer_seed;
+    m_scene = own_level ? m_own_scene : peer_scene;
+    m_connected = true;
+    return true;
+}
+
+void RollbackPeer::disconnect()
+{
+    if (m_connected)
+    {
+        uint8_t buffer[8];
+        BitWriter writer(buffer, sizeof(buffer));
+        write_header(writer, ROLLBACK_BYE);
+        m_socket.send(m_peer, buffer, writer.get_byte_count());
+    }
+    m_connected = false;
+    m_socket.close();
+}
+
+void RollbackPeer::receive(RollbackSession& session)
+{
+    if (!m_connected) return;
+    TRACE_ZONE("rollback receive");
+
+    uint8_t    buffer[MAX_PACKET];
+    NetAddress address;
+    int size;
+    while ((size = m_socket.receive(address, buffer, sizeof(buffer))) > 0)
+    {
+        BitReader reader(buffer, (size_t)size);
+        if (address != m_peer || reader.read_bits(32) != ROLLBACK_PROTOCOL_ID) continue;
+
+        RollbackPacketType type = (RollbackPacketType)reader.read_bits(2);
+        if (type == ROLLBACK_HELLO)
+        {
+            // Its last hello's answer was lost
+            send_hello(true);
+            continue;
+        }
+        if (type == ROLLBACK_BYE)
+        {
+            m_connected = false;
+            m_socket.close();
+            return;
+        }
+
+        int ack         = (int)reader.read_bits(32) - 1;
+        int peer_frame  = (int)reader.read_bits(32);
+        int peer_ahead  = (int8_t)reader.read_bits(8);
+        int first_frame = (int)reader.read_bits(32);
+        int count       = (int)reader.read_bits(5);
+        int actions[MAX_INPUTS_PER_PACKET];
+        for (int i = 0; i < count; i++) actions[i] = (int)reader.read_bits(3);
+        if (reader.has_overflowed()) continue;
+
+        m_acked_frame = std::max(m_acked_frame, ack);
+        if (peer_frame > m_peer_frame)
+        {
+            m_peer_frame = peer_frame;
+            m_peer_ahead = peer_ahead;
+        }
+        for (int i = 0; i < count; i++) session.add_remote_input(1, first_frame + i, actions[i]);
+    }
+}
+
+void RollbackPeer::send(const RollbackSession& session, double now)
+{
+    if (!m_connected) return;
+
+    int newest = session.get_frame() - 1;
+    if (newest <= m_sent_frame && now - m_last_send < RESEND_SECONDS) return;
+
+    // Everything the peer hasn't acknowledged, oldest first, as many as fit
+    int first = std::max(m_acked_frame + 1, 0),
+        count = std::min(newest - first + 1, (int)MAX_INPUTS_PER_PACKET);
+    count = std::max(count, 0);
+
+    uint8_t buffer[MAX_PACKET];
+    BitWriter writer(buffer, sizeof(buffer));
+    write_header(writer, ROLLBACK_INPUT);
+    writer.write_bits((uint32_t)(session.get_confirmed_frame(1) + 1), 32);
+    writer.write_bits((uint32_t)session.get_frame(), 32);
+    writer.write_bits((uint32_t)(uint8_t)(int8_t)std::min(std::max(session.get_frame() - m_peer_frame, -127), 127), 8);
+    writer.write_bits((uint32_t)first, 32);
+    writer.write_bits((uint32_t)count, 5);
+    for (int i = 0; i < count; i++) writer.write_bits((uint32_t)session.get_local_input(first + i), 3);
+
+    m_socket.send(m_peer, buffer, writer.get_byte_count());
+    m_sent_frame = std::max(m_sent_frame, first + count - 1);
+    m_last_send = now;
+}
+
+int const RollbackPeer::get_frames_to_wait(const RollbackSession& session) const
+{
+    if (m_peer_frame < 0) return 0;
+
+    // Each end sees the other's frame one trip late, which the difference of the two cancels out
+    int ahead = session.get_frame() - m_peer_frame;
+    return std::max((ahead - m_peer_ahead) / 2, 0);
+}
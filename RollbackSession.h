@@ -0,0 +1,138 @@
+#pragma once
+
+// GGPO-style rollback for head-to-head play. Every peer simulates every lander every frame
+// without waiting on the network: a remote input that hasn't arrived is predicted as whatever that
+// player last sent. Each frame's starting state goes into a ring of the last ROLLBACK_WINDOW, so
+// when a late input turns out to differ from its prediction, the frame it belonged to is restored
+// and everything since is simulated again with the input corrected, all inside the one call.
+//
+// Only the landers are kept per frame: step_simulation never moves a platform, so rewinding them
+// would be wasted copying, and a scene of any size rolls back at the same cost.
+//
+// Landers don't collide with each other, so each peer can list the landers in its own order (its
+// own first); only the inputs for each lander have to agree.
+//
+// RollbackPeer carries the inputs between two peers over UDP.
+#include <cstdint>
+#include "NetSocket.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+
+const int ROLLBACK_WINDOW      = 16;  // frames a late input can be corrected across, about 270 ms
+const int ROLLBACK_MAX_PLAYERS = 1 + SimulationSnapshot::MAX_LANDERS;
+
+class RollbackSession
+{
+private:
+    static const int INPUT_RING = ROLLBACK_WINDOW * 4;  // inputs from a peer running ahead of us fit too
+
+    // The landers as they were before a frame, and the inputs that frame was simulated with
+    struct Frame
+    {
+        BodyState     landers[ROLLBACK_MAX_PLAYERS];
+        LanderOutcome outcomes[ROLLBACK_MAX_PLAYERS];
+        int           inputs[ROLLBACK_MAX_PLAYERS];
+    };
+
+    GameState* m_state = NULL;
+    int        m_player_count = 0,
+               m_local_player = 0;
+
+    Frame m_frames[ROLLBACK_WINDOW];  // frame f in [f % ROLLBACK_WINDOW]
+    int   m_frame = 0;                // the next one to simulate
+
+    // ————— INPUTS ————— //
+    int  m_inputs[ROLLBACK_MAX_PLAYERS][INPUT_RING];
+    int  m_input_frames[ROLLBACK_MAX_PLAYERS][INPUT_RING];  // which frame each slot holds, -1 for none
+    int  m_confirmed[ROLLBACK_MAX_PLAYERS];  // every input up to and including this frame is in
+    int  m_rollback_frame;                   // earliest frame simulated with a wrong prediction
+
+    // ————— COUNTERS ————— //
+    long long m_rollbacks = 0,
+              m_resimulated_frames = 0;
+    int       m_deepest_rollback = 0;
+
+    bool has_input(int player, int frame) const;
+    int  get_input(int player, int frame) const;  // confirmed, or predicted
+    void store_input(int player, int frame, int action);
+    void save_frame(Frame& frame) const;
+    void restore_frame(const Frame& frame);
+    void simulate(int frame);
+
+public:
+    // Lander i of `state` is player i; the state must have player_count landers, already reset
+    void begin(GameState& state, int player_count, int local_player);
+
+    // Any order, any number of times; inputs from before the window are too late to matter
+    void add_remote_input(int player, int frame, int action);
+
+    // False while this peer is a whole window ahead of some other's confirmed inputs, since a
+    // correction that far back couldn't be made; the caller holds the frame back until they arrive
+    bool const can_advance() const;
+
+    // Corrects any mispredicted frames first, then simulates the next frame with the local
+    // player's action
+    void advance(int local_action);
+
+    // The local player's input for a frame already advanced, for sending
+    int const get_local_input(int frame) const { return get_input(m_local_player, frame); };
+
+    int       const get_frame()              const { return m_frame; };
+    int       const get_confirmed_frame(int player) const { return m_confirmed[player]; };
+    long long const get_rollback_count()     const { return m_rollbacks; };
+    long long const get_resimulated_frames() const { return m_resimulated_frames; };
+    int       const get_deepest_rollback()   const { return m_deepest_rollback; };
+};
+
+// ————— TRANSPORT ————— //
+// Two peers, each sending the other the inputs it hasn't acknowledged yet, so a lost packet's
+// inputs arrive with the next. Each end is player 0 in its own session and the other is player 1.
+//
+//   HELLO  nonce (32) | heard you (1) | seed (32) | layout (8) | platform count (32)
+//   INPUT  ack (32) | frame (32) | frames ahead (8, signed) | first input's frame (32) |
+//          count (5) | actions (3 each)
+//
+// The peer whose nonce is lower picks the level. Each also reports how far ahead of the other it
+// thinks it is, so the one further ahead can hold back a frame now and then instead of making the
+// other roll back on every frame (GGPO's time sync).
+class RollbackPeer
+{
+private:
+    static const int    MAX_INPUTS_PER_PACKET = 31;
+    static const double RESEND_SECONDS;
+
+    UdpSocket  m_socket;
+    NetAddress m_peer;
+    bool       m_connected = false;
+
+    uint32_t     m_nonce = 0;
+    unsigned int m_own_seed = 0, m_seed = 0;  // this end's proposal, and the one agreed on
+    SceneConfig  m_own_scene, m_scene;
+
+    int    m_acked_frame = -1;    // the newest of our inputs the peer has, with all before it
+    int    m_sent_frame = -1;     // the newest we've sent
+    double m_last_send = 0.0;
+
+    int    m_peer_frame = -1;     // the peer's next frame, as of its last packet
+    int    m_peer_ahead = 0;      // how far the peer thought it was ahead of us
+
+    void send_hello(bool heard);
+
+public:
+    // Listens on `port` and says hello to `peer_host_port` until it says hello back, or `timeout`
+    // seconds pass. `seed` and `scene` are this end's proposal for the level.
+    bool connect(uint16_t port, const char* peer_host_port, unsigned int seed, const SceneConfig& scene, double timeout);
+    void disconnect();
+
+    // Every packet waiting, into the session as player 1's inputs
+    void receive(RollbackSession& session);
+    // Player 0's inputs the peer hasn't acknowledged, when there are new ones or it's been a while
+    void send(const RollbackSession& session, double now);
+
+    // Frames this end should hold back to let the other catch up; 0 when they're level
+    int const get_frames_to_wait(const RollbackSession& session) const;
+
+    bool         const is_connected() const { return m_connected; };
+    unsigned int const get_seed()     const { return m_seed; };
+    const SceneConfig& get_scene()    const { return m_scene; };
+};
@@ -0,0 +1,169 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include "CpuTopology.h"
+#include "RolloutCollector.h"
+#include "TrajectoryStore.h"
+
+RolloutCollector::RolloutCollector(const RolloutConfig& config, RolloutPolicy policy, void* user_data)
+    : m_config(config), m_policy(policy), m_user_data(user_data)
+{
+    if (m_config.worker_count <= 0) m_config.worker_count = std::max(1, (int)std::thread::hardware_concurrency());
+    m_config.envs_per_worker = std::max(1, m_config.envs_per_worker);
+
+    CpuTopology topology;
+    if (m_config.pin_workers) topology.detect();
+
+    // Only the shells here: the envs wait for the worker's own thread (see create_envs)
+    for (int w = 0; w < m_config.worker_count; w++)
+    {
+        Worker* worker = new Worker(m_config.ring_capacity);
+        if (m_config.pin_workers) worker->cpu = topology.get_cpu(w);
+        m_workers.emplace_back(worker);
+    }
+}
+
+RolloutCollector::~RolloutCollector()
+{
+    stop();
+
+    for (std::unique_ptr<Worker>& worker : m_workers)
+    {
+        for (LanderEnv* env : worker->envs) lander_env_destroy(env);
+    }
+}
+
+void RolloutCollector::start()
+{
+    if (m_running.exchange(true)) return;
+
+    for (int w = 0; w < (int)m_workers.size(); w++) m_workers[w]->thread = std::thread(&RolloutCollector::worker_loop, this, w);
+}
+
+void RolloutCollector::stop()
+{
+    m_running.store(false);
+
+    for (std::unique_ptr<Worker>& worker : m_workers)
+    {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+}
+
+// On the worker's thread, once it's pinned, so the pages are first touched on the node it runs on
+void RolloutCollector::create_envs(int worker_index)
+{
+    Worker& worker = *m_workers[worker_index];
+    worker.observations.assign(m_config.envs_per_worker * LANDER_OBSERVATION_SIZE, 0.0f);
+    worker.episodes.assign(m_config.envs_per_worker, 0);
+
+    for (int e = 0; e < m_config.envs_per_worker; e++)
+    {
+        LanderEnv* env = lander_env_create(m_config.platform_count, m_config.layout, m_config.max_steps);
+        unsigned int global_index = worker_index * m_config.envs_per_worker + e;
+
+        lander_env_reset(env, m_config.seed + global_index, &worker.observations[e * LANDER_OBSERVATION_SIZE]);
+        worker.envs.push_back(env);
+    }
+}
+
+void RolloutCollector::worker_loop(int worker_index)
+{
+    Worker& worker = *m_workers[worker_index];
+    if (worker.cpu >= 0 && !pin_current_thread(worker.cpu)) worker.cpu = -1;
+
+    // A restart carries on with the envs it had
+    if (worker.envs.empty()) create_envs(worker_index);
+    const unsigned int env_count = (unsigned int)(m_workers.size() * m_config.envs_per_worker);
+
+    Transition transition;
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        // Counted per pass rather than per step, so the stats cost one atomic add each a pass
+        long long transitions = 0,
+                  episodes    = 0,
+                  full_waits  = 0;
+
+        for (int e = 0; e < (int)worker.envs.size(); e++)
+        {
+            float* observation = &worker.observations[e * LANDER_OBSERVATION_SIZE];
+            unsigned int global_index = worker_index * m_config.envs_per_worker + e;
+
+            // STEP 1: Act, with the env writing the next state straight into the transition
+            std::memcpy(transition.observation, observation, sizeof(transition.observation));
+            transition.env = (int)global_index;
+            transition.action = m_policy(observation, m_user_data);
+            lander_env_step(worker.envs[e], transition.action, transition.next_observation, &transition.reward, &transition.done);
+
+            // STEP 2: Block on a full ring instead of dropping; the learner is the bottleneck then.
+            //         Only stop() gets a worker out of here, and that transition is lost.
+            bool pushed = worker.ring.try_push(transition);
+            if (!pushed) full_waits++;
+
+            while (!pushed && m_running.load(std::memory_order_relaxed))
+            {
+                std::this_thread::yield();
+                pushed = worker.ring.try_push(transition);
+            }
+            if (!pushed) break;
+            transitions++;
+
+            // STEP 3: Carry on from the next state, or from a fresh episode on the env's next seed
+            if (transition.done != LANDER_DONE_NONE)
+            {
+                worker.episodes[e]++;
+                episodes++;
+
+                lander_env_reset(worker.envs[e], m_config.seed + global_index + worker.episodes[e] * env_count, observation);
+            }
+            else std::memcpy(observation, transition.next_observation, sizeof(transition.next_observation));
+        }
+
+        worker.stats.transitions.fetch_add(transitions, std::memory_order_relaxed);
+        worker.stats.episodes.fetch_add(episodes, std::memory_order_relaxed);
+        worker.stats.full_waits.fetch_add(full_waits, std::memory_order_relaxed);
+    }
+}
+
+int RolloutCollector::drain(Transition* out, int max_count)
+{
+    int count = 0;
+    const size_t worker_count = m_workers.size();
+
+    // Round robin from a moving start, so a busy first worker can't crowd out the rest
+    for (size_t i = 0; i < worker_count && count < max_count; i++)
+    {
+        Worker& worker = *m_workers[(m_next_ring + i) % worker_count];
+        count += (int)worker.ring.try_pop(out + count, max_count - count);
+    }
+    m_next_ring = (m_next_ring + 1) % worker_count;
+
+    return count;
+}
+
+int RolloutCollector::drain_to(TrajectoryWriter& writer, std::vector<Transition>& buffer)
+{
+    if (buffer.empty()) buffer.resize(m_config.ring_capacity);
+
+    int count = drain(buffer.data(), (int)buffer.size());
+    writer.append(buffer.data(), count);
+    return count;
+}
+
+long long RolloutCollector::get_total_transitions() const
+{
+    long long total = 0;
+    for (const std::unique_ptr<Worker>& worker : m_workers) total += worker->stats.transitions.load(std::memory_order_relaxed);
+    return total;
+}
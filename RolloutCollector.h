@@ -0,0 +1,100 @@
+#pragma once
+
+// Streams (observation, action, reward, next observation) transitions for off-policy training.
+// Each worker thread owns a subset of the envs and steps them under the policy, publishing every
+// transition into its own SpscRing; the learner thread drains all the rings. Workers share
+// nothing with each other, so collection scales with cores until the learner can't keep up,
+// at which point full rings hold the workers back rather than dropping data.
+//
+// Each worker is pinned to a CPU of its own (CpuTopology.h), alternating between NUMA nodes, and
+// creates its envs and buffers on that thread, so on a multi-socket machine every worker's
+// partition is in its own node's memory rather than wherever the constructing thread was.
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "LanderEnv.h"
+#include "SpscRing.h"
+
+class TrajectoryWriter;
+
+struct Transition
+{
+    float observation[LANDER_OBSERVATION_SIZE];
+    int   action;
+    float reward;
+    int   done;  // LanderDone code
+    float next_observation[LANDER_OBSERVATION_SIZE];
+    int   env;  // the env's global index, worker * envs_per_worker + its own
+};
+
+// Called from the worker threads, so it must be safe to call concurrently; returns LanderAction bits
+typedef int (*RolloutPolicy)(const float* observation, void* user_data);
+
+struct RolloutConfig
+{
+    int          worker_count    = 0;     // 0 for one per hardware thread
+    int          envs_per_worker = 16;
+    int          ring_capacity   = 4096;  // transitions per worker
+    int          platform_count  = 0;     // as lander_env_create takes them
+    int          layout          = LANDER_LAYOUT_CLASSIC;
+    int          max_steps       = 3600;
+    unsigned int seed            = 1;     // env i's episode n is played on seed + i + n * env count
+    bool         pin_workers     = true;  // off leaves the workers, and so their memory, to the scheduler
+};
+
+// Per worker, updated by the worker and safe to read from any thread at any time
+struct RolloutWorkerStats
+{
+    std::atomic<long long> transitions{ 0 },
+                           episodes{ 0 },
+                           full_waits{ 0 };  // times the ring was full and the worker had to back off
+};
+
+class RolloutCollector
+{
+private:
+    struct Worker
+    {
+        std::vector<LanderEnv*>   envs;
+        std::vector<float>        observations;  // one row per env, current state
+        std::vector<unsigned int> episodes;      // per env, for picking the next episode's seed
+        SpscRing<Transition>      ring;  // first written, and so placed, by the worker too
+        RolloutWorkerStats        stats;
+        std::thread               thread;
+        int                       cpu = -1;  // -1 when not pinned
+
+        explicit Worker(int ring_capacity) : ring(ring_capacity) {}
+    };
+
+    RolloutConfig                        m_config;
+    RolloutPolicy                        m_policy = NULL;
+    void*                                m_user_data = NULL;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<bool>                    m_running{ false };
+    size_t                               m_next_ring = 0;  // where drain starts, so no ring starves
+
+    void create_envs(int worker_index);
+    void worker_loop(int worker_index);
+
+public:
+    RolloutCollector(const RolloutConfig& config, RolloutPolicy policy, void* user_data = NULL);
+    ~RolloutCollector();
+
+    RolloutCollector(const RolloutCollector&) = delete;
+    RolloutCollector& operator=(const RolloutCollector&) = delete;
+
+    void start();
+    // Joins the workers; transitions still in the rings can be drained afterwards
+    void stop();
+
+    // Learner thread only. Pops up to max_count transitions, taking from every ring in turn.
+    int  drain(Transition* out, int max_count);
+    // ...and straight into a trajectory file (TrajectoryStore.h), through `buffer`; returns how many
+    int  drain_to(TrajectoryWriter& writer, std::vector<Transition>& buffer);
+
+    int  const get_worker_count() const { return (int)m_workers.size(); };
+    int  const get_worker_cpu(int worker) const { return m_workers[worker]->cpu; };
+    const RolloutWorkerStats& get_worker_stats(int worker) const { return m_workers[worker]->stats; };
+    long long get_total_transitions() const;
+};
@@ -0,0 +1,272 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <cstring>
+#include "SaveStore.h"
+#include "Trace.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+static const char     SAVE_MAGIC[4] = { 'L', 'S', 'A', 'V' };
+static const uint32_t SAVE_VERSION  = 1;
+static const size_t   HEADER_SIZE   = sizeof(SAVE_MAGIC) + sizeof(SAVE_VERSION);
+
+static uint32_t fnv1a(const uint8_t* bytes, size_t size, uint32_t hash = 2166136261u)
+{
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+// `from` takes `to`'s place in one step: readers see the old file or the new one, never neither
+static bool replace_file(const char* from, const char* to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from, to) == 0;
+#endif
+}
+
+// ————— RECORDS ————— //
+size_t SaveStore::get_record_size(size_t key_size, size_t value_size)
+{
+    return sizeof(uint16_t) + sizeof(uint32_t) + key_size + value_size + sizeof(uint32_t);
+}
+
+void SaveStore::encode(std::string_view key, std::string_view value, std::vector<uint8_t>& out)
+{
+    size_t start = out.size();
+    uint16_t key_size   = (uint16_t)key.size();
+    uint32_t value_size = (uint32_t)value.size();
+
+    out.insert(out.end(), (const uint8_t*)&key_size, (const uint8_t*)&key_size + sizeof(key_size));
+    out.insert(out.end(), (const uint8_t*)&value_size, (const uint8_t*)&value_size + sizeof(value_size));
+    out.insert(out.end(), key.begin(), key.end());
+    out.insert(out.end(), value.begin(), value.end());
+
+    uint32_t checksum = fnv1a(out.data() + start, out.size() - start);
+    out.insert(out.end(), (const uint8_t*)&checksum, (const uint8_t*)&checksum + sizeof(checksum));
+}
+
+// ————— GAME THREAD ————— //
+bool SaveStore::open(const char* filepath)
+{
+    close();
+    m_filepath = filepath;
+    m_values.clear();
+    m_live.clear();
+    m_live_bytes = 0;
+    m_log_bytes = 0;
+    m_needs_compaction = false;
+    m_compaction_count = 0;
+    m_write_failed = false;
+
+    // STEP 1: The whole file in one read...
+    std::vector<uint8_t> contents;
+    if (FILE* file = std::fopen(filepath, "rb"))
+    {
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        if (size > 0)
+        {
+            contents.resize((size_t)size);
+            contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+        }
+        std::fclose(file);
+    }
+
+    // STEP 2: ...then its records, up to the first that doesn't check out
+    size_t offset = HEADER_SIZE;
+    bool valid = contents.size() >= HEADER_SIZE && std::memcmp(contents.data(), SAVE_MAGIC, sizeof(SAVE_MAGIC)) == 0;
+    uint32_t version = 0;
+    if (valid) std::memcpy(&version, contents.data() + sizeof(SAVE_MAGIC), sizeof(version));
+    valid = valid && version == SAVE_VERSION;
+
+    while (valid && offset < contents.size())
+    {
+        const uint8_t* record = contents.data() + offset;
+        size_t left = contents.size() - offset;
+        uint16_t key_size;
+        uint32_t value_size, checksum;
+        if (left < get_record_size(0, 0)) break;
+        std::memcpy(&key_size, record, sizeof(key_size));
+        std::memcpy(&value_size, record + sizeof(key_size), sizeof(value_size));
+
+        size_t size = get_record_size(key_size, value_size);
+        if (value_size > left || size > left) break;
+        std::memcpy(&checksum, record + size - sizeof(checksum), sizeof(checksum));
+        if (fnv1a(record, size - sizeof(checksum)) != checksum) break;
+
+        const char* key = (const char*)record + sizeof(key_size) + sizeof(value_size);
+        m_values[std::string(key, key_size)] = std::string(key + key_size, value_size);
+        offset += size;
+    }
+
+    // A missing or foreign file is started afresh, and a bad tail cut off, both by compacting
+    m_needs_compaction = !valid || offset != contents.size();
+    m_log_bytes = valid ? offset : 0;
+    m_live = m_values;
+    for (const auto& entry : m_live) m_live_bytes += get_record_size(entry.first.size(), entry.second.size());
+
+    // STEP 3: The log open for appending, on this thread so a failure is reported straight away
+    if (m_needs_compaction ? !compact() : (m_file = std::fopen(filepath, "ab")) == NULL) return false;
+
+    m_stopping = false;
+    m_writer = std::thread(&SaveStore::writer_loop, this);
+    return true;
+}
+
+void SaveStore::close()
+{
+    if (m_writer.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+
+    if (m_file != NULL)
+    {
+        std::fclose(m_file);
+        m_file = NULL;
+    }
+}
+
+void SaveStore::set(std::string_view key, std::string_view value)
+{
+    if (key.size() > UINT16_MAX) return;
+
+    std::string name(key);
+    auto found = m_values.find(name);
+    if (found != m_values.end() && found->second == value) return;
+    m_values[name].assign(value.data(), value.size());
+
+    if (!m_writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued.push_back({ std::move(name), std::string(value) });
+    }
+    m_wake.notify_one();
+}
+
+const std::string* SaveStore::get(std::string_view key) const
+{
+    auto found = m_values.find(std::string(key));
+    return found != m_values.end() ? &found->second : NULL;
+}
+
+int64_t const SaveStore::get_int(std::string_view key, int64_t fallback) const
+{
+    const std::string* value = get(key);
+    if (value == NULL || value->size() != sizeof(int64_t)) return fallback;
+
+    int64_t result;
+    std::memcpy(&result, value->data(), sizeof(result));
+    return result;
+}
+
+float const SaveStore::get_float(std::string_view key, float fallback) const
+{
+    const std::string* value = get(key);
+    if (value == NULL || value->size() != sizeof(float)) return fallback;
+
+    float result;
+    std::memcpy(&result, value->data(), sizeof(result));
+    return result;
+}
+
+// ————— WRITER ————— //
+void SaveStore::append(const Record& record)
+{
+    auto found = m_live.find(record.key);
+    if (found != m_live.end()) m_live_bytes -= get_record_size(found->first.size(), found->second.size());
+    m_live[record.key] = record.value;
+    m_live_bytes += get_record_size(record.key.size(), record.value.size());
+
+    encode(record.key, record.value, m_buffer);
+}
+
+bool SaveStore::compact()
+{
+    TRACE_ZONE("SaveStore::compact");
+
+    // STEP 1: The live records alone, into a file of their own...
+    m_buffer.clear();
+    m_buffer.insert(m_buffer.end(), (const uint8_t*)SAVE_MAGIC, (const uint8_t*)SAVE_MAGIC + sizeof(SAVE_MAGIC));
+    m_buffer.insert(m_buffer.end(), (const uint8_t*)&SAVE_VERSION, (const uint8_t*)&SAVE_VERSION + sizeof(SAVE_VERSION));
+    for (const auto& entry : m_live) encode(entry.first, entry.second, m_buffer);
+
+    std::string temporary = m_filepath + ".tmp";
+    FILE* file = std::fopen(temporary.c_str(), "wb");
+    bool written = file != NULL && std::fwrite(m_buffer.data(), 1, m_buffer.size(), file) == m_buffer.size();
+    if (file != NULL) written = std::fclose(file) == 0 && written;
+    size_t size = m_buffer.size();
+    m_buffer.clear();
+
+    // STEP 2: ...that then takes the log's place, the log being reopened onto it
+    if (m_file != NULL)
+    {
+        std::fclose(m_file);
+        m_file = NULL;
+    }
+    if (!written || !replace_file(temporary.c_str(), m_filepath.c_str()))
+    {
+        std::remove(temporary.c_str());
+        m_write_failed = true;
+        // The old log carries on, bad tail and all, unless it was the bad tail that needed this
+        m_file = m_needs_compaction ? NULL : std::fopen(m_filepath.c_str(), "ab");
+        return m_file != NULL;
+    }
+
+    m_log_bytes = size;
+    m_needs_compaction = false;
+    m_compaction_count++;
+    m_file = std::fopen(m_filepath.c_str(), "ab");
+    return m_file != NULL;
+}
+
+void SaveStore::writer_loop()
+{
+    std::vector<Record> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wake.wait(lock, [this] { return m_stopping || !m_queued.empty(); });
+        batch.swap(m_queued);
+        bool stopping = m_stopping;
+        lock.unlock();
+
+        // STEP 1: Everything set since the last pass, in one append and one flush
+        if (!batch.empty() && m_file != NULL)
+        {
+            TRACE_ZONE("SaveStore::append");
+            m_buffer.clear();
+            for (const Record& record : batch) append(record);
+            if (std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size() || std::fflush(m_file) != 0) m_write_failed = true;
+            m_log_bytes += m_buffer.size();
+            m_buffer.clear();
+        }
+        batch.clear();
+
+        // STEP 2: Compacted once most of the log is overwritten values
+        if (m_log_bytes > COMPACT_MIN_BYTES && m_log_bytes > COMPACT_RATIO * (m_live_bytes + HEADER_SIZE)) compact();
+
+        if (stopping) return;
+        lock.lock();
+    }
+}
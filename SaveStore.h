@@ -0,0 +1,94 @@
+#pragma once
+
+// Progress and settings kept between runs, saved as they change without the game thread ever
+// writing a file. Everything is a key and a few bytes of value, held in memory; set() with a
+// value that differs queues just that record for the writer thread, which appends it to the
+// save file and flushes. The file is therefore a log in which a key's last record wins.
+//
+// When the log has grown to COMPACT_RATIO times the live records (and past COMPACT_MIN_BYTES),
+// the writer writes the live records alone to a temporary file and swaps it in over the save in
+// one atomic rename, so at every moment the save on disk is either the old log or the new one.
+// open() reads the whole file in one go; a record cut short by a crash, or failing its checksum,
+// ends the log there, and the next write starts with a compaction that leaves it out.
+//
+//     file:   "LSAV", u32 version, then records
+//     record: u16 key length, u32 value length, key, value, u32 FNV-1a of everything before it
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class SaveStore
+{
+private:
+    static const size_t COMPACT_MIN_BYTES = 64 * 1024;
+    static const int    COMPACT_RATIO     = 4;
+
+    struct Record
+    {
+        std::string key, value;
+    };
+
+    std::string m_filepath;
+    std::thread m_writer;
+
+    // ————— GAME THREAD ONLY ————— //
+    std::unordered_map<std::string, std::string> m_values;
+
+    // ————— SHARED WITH THE WRITER ————— //
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Record>     m_queued;
+    bool                    m_stopping = false;
+
+    // ————— WRITER ONLY ————— //
+    std::unordered_map<std::string, std::string> m_live;  // what the log adds up to
+    FILE*                m_file = NULL;                   // the log, appending
+    size_t               m_log_bytes  = 0,
+                         m_live_bytes = 0;                // of m_live's records, encoded
+    bool                 m_needs_compaction = false;      // the log on disk has a bad tail
+    std::vector<uint8_t> m_buffer;
+    long long            m_compaction_count = 0;
+    bool                 m_write_failed = false;
+
+    void writer_loop();
+    void append(const Record& record);
+    bool compact();
+
+    static size_t get_record_size(size_t key_size, size_t value_size);
+    static void   encode(std::string_view key, std::string_view value, std::vector<uint8_t>& out);
+
+public:
+    SaveStore() = default;
+    SaveStore(const SaveStore&) = delete;
+    SaveStore& operator=(const SaveStore&) = delete;
+    ~SaveStore() { close(); }
+
+    // Reads the save, if there is one, and starts the writer. False if it can't be written to;
+    // whatever could be read is still there to get, it just won't be saved.
+    bool open(const char* filepath);
+    // Writes out everything set so far, then joins the writer
+    void close();
+
+    // Game thread. Queues a write only if the value changed.
+    void set(std::string_view key, std::string_view value);
+    void set_int(std::string_view key, int64_t value)  { set(key, std::string_view((const char*)&value, sizeof(value))); };
+    void set_float(std::string_view key, float value)  { set(key, std::string_view((const char*)&value, sizeof(value))); };
+    void set_bool(std::string_view key, bool value)    { set_int(key, value ? 1 : 0); };
+
+    const std::string* get(std::string_view key) const;
+    int64_t const get_int(std::string_view key, int64_t fallback) const;
+    float   const get_float(std::string_view key, float fallback) const;
+    bool    const get_bool(std::string_view key, bool fallback)   const { return get_int(key, fallback ? 1 : 0) != 0; };
+
+    bool      const is_open()                const { return m_writer.joinable(); };
+    size_t    const get_count()              const { return m_values.size(); };
+    // The writer's, so only once close() has returned
+    long long const get_compaction_count()   const { return m_compaction_count; };
+    bool      const has_write_failed()       const { return m_write_failed; };
+};
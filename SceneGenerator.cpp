@@ -0,0 +1,110 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "Rng.h"
+#include "SceneGenerator.h"
+
+static const char* const LAYOUT_NAMES[SCENE_LAYOUT_COUNT] = { "classic", "uniform", "clustered", "terrain" };
+
+const char* get_scene_layout_name(SceneLayout layout)
+{
+    return (layout >= 0 && layout < SCENE_LAYOUT_COUNT) ? LAYOUT_NAMES[layout] : "unknown";
+}
+
+bool parse_scene_layout(const char* name, SceneLayout& layout)
+{
+    for (int i = 0; i < SCENE_LAYOUT_COUNT; i++)
+    {
+        if (std::strcmp(name, LAYOUT_NAMES[i]) == 0)
+        {
+            layout = (SceneLayout)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void generate_scene(Entity* platforms, const SceneConfig& config, unsigned int seed)
+{
+    const int count = config.platform_count;
+    if (count <= 0) return;
+
+    if (config.layout == SCENE_CLASSIC)
+    {
+        generate_platforms(platforms, count, seed);
+        return;
+    }
+
+    Rng rng(seed);
+
+    const float width = count / std::max(config.density, 0.001f);
+    std::vector<glm::vec2> positions(count);
+
+    // STEP 1: Where every platform goes
+    switch (config.layout)
+    {
+    case SCENE_UNIFORM:
+        for (glm::vec2& position : positions)
+        {
+            float x = (rng.next_float() - 0.5f) * width;
+            position = glm::vec2(x, SCENE_MIN_Y + rng.next_float() * (SCENE_MAX_Y - SCENE_MIN_Y));
+        }
+        break;
+
+    case SCENE_CLUSTERED:
+    {
+        // Each cluster sits at its own height, with a little jitter around it
+        int cluster_count = std::max(1, count / std::max(config.cluster_size, 1));
+        std::vector<glm::vec2> centres(cluster_count);
+        for (glm::vec2& centre : centres)
+        {
+            float x = (rng.next_float() - 0.5f) * width;
+            centre = glm::vec2(x, SCENE_MIN_Y + rng.next_float() * (SCENE_MAX_Y - SCENE_MIN_Y));
+        }
+
+        for (glm::vec2& position : positions)
+        {
+            const glm::vec2& centre = centres[rng.next_int(0, cluster_count - 1)];
+            float x = rng.next_normal(centre.x, config.cluster_spread);
+            position = glm::vec2(x, std::min(std::max(rng.next_normal(centre.y, 0.5f), SCENE_MIN_Y), SCENE_MAX_Y));
+        }
+        break;
+    }
+
+    case SCENE_TERRAIN:
+    default:
+    {
+        // Whole-unit steps up or down, held in range, so the strip reads as ground
+        float height = SCENE_MIN_Y;
+
+        for (int i = 0; i < count; i++)
+        {
+            height = std::min(std::max(height + rng.next_int(-1, 1), SCENE_MIN_Y), SCENE_MAX_Y);
+            positions[i] = glm::vec2((float)(i - count / 2), height);
+        }
+        break;
+    }
+    }
+
+    // STEP 2: Left to right, the order the interval index files them in anyway
+    std::sort(positions.begin(), positions.end(), [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+
+    // STEP 3: Types last, so the layout above doesn't shift with win_chance
+    for (int i = 0; i < count; i++)
+    {
+        platforms[i].set_position(glm::vec3(positions[i], 0.0f));
+        platforms[i].set_entity_type(rng.next_float() < config.win_chance ? WIN_PLATFORM : DEATH_PLATFORM);
+        platforms[i].set_body_type(STATIC_BODY);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Seeded platform layouts of any size, for stress-testing past the nine-platform level. The same
+// (config, seed) always gives the same scene, in the game and in the headless driver alike, and
+// on every compiler and platform, since all the draws come from Rng rather than <random>.
+#include "Entity.h"
+#include "Simulation.h"
+
+enum SceneLayout
+{
+    SCENE_CLASSIC,    // generate_platforms: one per unit from x = -4, as the game has always had
+    SCENE_UNIFORM,    // scattered evenly over the scene's width at any height
+    SCENE_CLUSTERED,  // bunched around random centres, with empty stretches between them
+    SCENE_TERRAIN,    // a contiguous strip, one per unit, its height a random walk
+    SCENE_LAYOUT_COUNT
+};
+
+struct SceneConfig
+{
+    SceneLayout layout         = SCENE_CLASSIC;
+    int         platform_count = PLATFORM_COUNT;
+
+    // Uniform and clustered scenes span platform_count / density units, centred on x = 0
+    float density        = 1.0f;
+    int   cluster_size   = 64;    // average platforms per cluster
+    float cluster_spread = 4.0f;  // standard deviation of a cluster along x
+    float win_chance     = 0.5f;  // of any one platform being a WIN_PLATFORM (classic ignores it)
+};
+
+// Bounds every layout keeps its platforms' centres within vertically, the classic level's range
+const float SCENE_MIN_Y = -3.0f,
+            SCENE_MAX_Y = 1.0f;
+
+// Writes config.platform_count static platforms. Apart from the classic layout, they come out
+// sorted by x, which spares PlatformIntervalIndex its re-sort.
+void generate_scene(Entity* platforms, const SceneConfig& config, unsigned int seed);
+
+// "classic", "uniform", "clustered" or "terrain"
+const char* get_scene_layout_name(SceneLayout layout);
+bool        parse_scene_layout(const char* name, SceneLayout& layout);
@@ -0,0 +1,68 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cassert>
+#include "SceneGraph.h"
+
+int SceneGraph::add_node(int parent, const ModelTransform& local)
+{
+    assert(parent == NO_PARENT || (parent >= 0 && parent < get_node_count()));
+
+    int node = get_node_count();
+    m_parents.push_back(parent);
+    m_locals.push_back(local);
+    m_worlds.push_back(local);
+    m_dirty.push_back(1);
+    m_first_dirty = std::min(m_first_dirty, node);
+    return node;
+}
+
+void SceneGraph::clear()
+{
+    m_parents.clear();
+    m_locals.clear();
+    m_worlds.clear();
+    m_dirty.clear();
+    m_first_dirty = 0;
+    m_updated_nodes = 0;
+}
+
+void SceneGraph::set_local(int node, const ModelTransform& local)
+{
+    if (m_locals[node] == local) return;
+
+    m_locals[node] = local;
+    m_dirty[node] = 1;
+    m_first_dirty = std::min(m_first_dirty, node);
+}
+
+void SceneGraph::update()
+{
+    int count = get_node_count();
+    m_updated_nodes = 0;
+    if (m_first_dirty >= count) return;
+
+    // A node is redone if it moved or its parent was just redone; the flag stays set on the redone
+    // ones for their children to see. Parents come first, so one pass is enough.
+    for (int node = m_first_dirty; node < count; node++)
+    {
+        int parent = m_parents[node];
+        if (parent != NO_PARENT && m_dirty[parent]) m_dirty[node] = 1;
+        if (!m_dirty[node]) continue;
+
+        m_worlds[node] = parent != NO_PARENT ? m_worlds[parent] * m_locals[node] : m_locals[node];
+        m_updated_nodes++;
+    }
+
+    // Only the range just walked can hold set flags
+    std::fill(m_dirty.begin() + m_first_dirty, m_dirty.end(), 0);
+    m_first_dirty = count;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Parent/child transforms for things that ride on something else: the lander's nozzle, its legs,
+// cargo hanging under it. The hierarchy is flat: nodes live in parallel arrays by index, and a
+// parent is always added before its children, so every parent's index is below its children's and
+// one pass from low to high visits parents first.
+//
+// Moving a node only marks it dirty and remembers the lowest dirty index. update() starts there and
+// recomputes a node's world transform only if it was marked or its parent's was just recomputed,
+// so a frame where nothing moved costs one comparison, and one where the lander moved costs its own
+// subtree and a flag test for each node after it. Setting a transform equal to the current one
+// marks nothing.
+#include <vector>
+#include "ModelTransform.h"
+
+class SceneGraph
+{
+private:
+    std::vector<int>            m_parents;  // NO_PARENT for roots
+    std::vector<ModelTransform> m_locals,   // relative to the parent
+                                m_worlds;   // as of the last update()
+    std::vector<unsigned char>  m_dirty;
+
+    int m_first_dirty   = 0;  // the node count when nothing is dirty
+    int m_updated_nodes = 0;  // by the last update()
+
+public:
+    static const int NO_PARENT = -1;
+
+    // `parent` is NO_PARENT or a node already added; returns the new node's index. Its world
+    // transform is worked out at the next update().
+    int  add_node(int parent, const ModelTransform& local = ModelTransform());
+    void clear();
+
+    void set_local(int node, const ModelTransform& local);
+
+    // Every node whose world transform could have changed, in one pass from the first dirty node
+    void update();
+
+    ModelTransform const& get_local(int node)  const { return m_locals[node]; };
+    ModelTransform const& get_world(int node)  const { return m_worlds[node]; };
+    int  const get_parent(int node)            const { return m_parents[node]; };
+    int  const get_node_count()                const { return (int)m_parents.size(); };
+    int  const get_updated_nodes()             const { return m_updated_nodes; };
+};
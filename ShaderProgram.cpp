@@ -1,18 +1,194 @@
 #define GL_SILENCE_DEPRECATION
 
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
 #include "ShaderProgram.h"
 
-void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_shader_file) {
+// glUseProgram is global GL state, so the binding is tracked once for all programs
+static GLuint g_bound_program = 0;
 
+namespace
+{
+    struct ProgramBinaryHeader
+    {
+        char               magic[4];
+        GLenum             binary_format;
+        unsigned long long key;
+        unsigned long long length;
+    };
+
+    const char               PROGRAM_BINARY_MAGIC[4] = { 'S', 'P', 'B', 'C' };
+    const unsigned long long MAX_PROGRAM_BINARY_SIZE = 64ULL * 1024 * 1024;  // anything bigger is a corrupt file
+
+    // The shaders are GLSL 1.10, which a core context won't compile. GLSL 3.30 only renamed what
+    // they use, so wherever it's available a #version 330 line and these renames go in front and
+    // the same sources serve both. GLSL_330 lets a shader use what's new, like uniform blocks.
+    const std::string_view GLSL_330_VERTEX_PRELUDE =
+        "#version 330 core\n"
+        "#define GLSL_330 1\n"
+        "#define attribute in\n"
+        "#define varying out\n"
+        "#define texture2D texture\n";
+
+    const std::string_view GLSL_330_FRAGMENT_PRELUDE =
+        "#version 330 core\n"
+        "#define GLSL_330 1\n"
+        "#define varying in\n"
+        "#define texture2D texture\n"
+        "#define gl_FragColor fragColor\n"
+        "out vec4 fragColor;\n";
+
+    // GLSL ES 1.00 is GLSL 1.10 give or take, bar the fragment shader's missing default precision
+    // and fwidth living in an extension (which every board we target has)
+    const std::string_view GLSL_ES_VERTEX_PRELUDE =
+        "#version 100\n"
+        "#define GLSL_ES 1\n";
+
+    const std::string_view GLSL_ES_FRAGMENT_PRELUDE =
+        "#version 100\n"
+        "#extension GL_OES_standard_derivatives : enable\n"
+        "#define GLSL_ES 1\n"
+        "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+        "precision highp float;\n"
+        "#else\n"
+        "precision mediump float;\n"
+        "#endif\n";
+
+    // FNV-1a; only has to tell source and driver versions apart, not resist anyone
+    unsigned long long hash_bytes(unsigned long long hash, const char* data, size_t length)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= (unsigned char)data[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    unsigned long long program_cache_key(std::string_view vertex_source, std::string_view fragment_source, std::string_view defines,
+                                         const std::vector<const char*>& feedback_varyings, std::string_view geometry_source)
+    {
+        unsigned long long hash = 14695981039346656037ULL;
+        const char separator = '\0';
+
+        hash = hash_bytes(hash, defines.data(), defines.size());
+        hash = hash_bytes(hash, &separator, 1);
+        hash = hash_bytes(hash, vertex_source.data(), vertex_source.size());
+        hash = hash_bytes(hash, &separator, 1);
+        hash = hash_bytes(hash, fragment_source.data(), fragment_source.size());
+
+        // Only hashed when there is one, so two-stage programs keep the keys they always had
+        if (!geometry_source.empty())
+        {
+            hash = hash_bytes(hash, &separator, 1);
+            hash = hash_bytes(hash, geometry_source.data(), geometry_source.size());
+        }
+
+        // Some drivers report the same version string for both profiles
+        const char profile = is_core_profile() ? 'c' : 'l';
+        hash = hash_bytes(hash, &separator, 1);
+        hash = hash_bytes(hash, &profile, 1);
+
+        // The captured outputs are part of the link, and so of the binary
+        for (const char* varying : feedback_varyings)
+        {
+            hash = hash_bytes(hash, &separator, 1);
+            hash = hash_bytes(hash, varying, strlen(varying));
+        }
+
+        GLenum driver_strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+        for (GLenum name : driver_strings)
+        {
+            const char* value = (const char*)glGetString(name);
+            if (value == NULL) value = "";
+
+            hash = hash_bytes(hash, &separator, 1);
+            hash = hash_bytes(hash, value, strlen(value));
+        }
+
+        return hash;
+    }
+}
+
+const char ShaderProgram::BINARY_CACHE_DIRECTORY[] = "shader_cache";
+
+static std::string g_source_override;
+
+void ShaderProgram::set_source_override(const char* directory)
+{
+    g_source_override = directory != NULL ? directory : "";
+}
+
+void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_shader_file)
+{
+    link_program(read_shader_file(vertex_shader_file), read_shader_file(fragment_shader_file), std::string_view());
+}
+
+void ShaderProgram::load(const EmbeddedShader& vertex_shader, const EmbeddedShader& fragment_shader, std::string_view defines)
+{
+    if (g_source_override.empty())
+    {
+        link_program(vertex_shader.source, fragment_shader.source, defines,
+                     m_geometry_embedded != NULL ? m_geometry_embedded->source : std::string_view());
+        return;
+    }
+
+    // Same file names as the embedded copies, just under the override directory
+    std::string_view vertex_name   = vertex_shader.path.substr(vertex_shader.path.find_last_of('/') + 1),
+                     fragment_name = fragment_shader.path.substr(fragment_shader.path.find_last_of('/') + 1);
+
+    std::string geometry_source;
+    if (m_geometry_embedded != NULL)
+    {
+        std::string_view geometry_name = m_geometry_embedded->path.substr(m_geometry_embedded->path.find_last_of('/') + 1);
+        geometry_source = read_shader_file(g_source_override + "/" + std::string(geometry_name));
+    }
+
+    link_program(read_shader_file(g_source_override + "/" + std::string(vertex_name)),
+                 read_shader_file(g_source_override + "/" + std::string(fragment_name)), defines, geometry_source);
+}
+
+void ShaderProgram::link_program(std::string_view vertex_source, std::string_view fragment_source, std::string_view defines,
+                                 std::string_view geometry_source)
+{
+    m_vertex_shader = m_fragment_shader = m_geometry_shader = 0;
+
+    // STEP 1: A binary this driver still accepts skips compiling and linking altogether
+    bool use_cache = supports_program_binaries();
+    unsigned long long key = use_cache ? program_cache_key(vertex_source, fragment_source, defines, m_feedback_varyings, geometry_source) : 0;
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "/%016llx.bin", key);
+    std::string cache_path = std::string(BINARY_CACHE_DIRECTORY) + filename;
+
+    if (use_cache && load_program_binary(cache_path, key))
+    {
+        find_locations();
+        return;
+    }
+
+    // STEP 2: Otherwise compile as usual...
     // create the vertex shader
-    m_vertex_shader = load_shader_from_file(vertex_shader_file, GL_VERTEX_SHADER);
+    m_vertex_shader = load_shader_from_string(vertex_source, GL_VERTEX_SHADER, defines);
     // create the fragment shader
-    m_fragment_shader = load_shader_from_file(fragment_shader_file, GL_FRAGMENT_SHADER);
+    m_fragment_shader = load_shader_from_string(fragment_source, GL_FRAGMENT_SHADER, defines);
+    // and the geometry shader, if there is one
+    if (!geometry_source.empty()) m_geometry_shader = load_shader_from_string(geometry_source, GL_GEOMETRY_SHADER, defines);
 
     // Create the final shader program from our vertex and fragment shaders
     m_program_id = glCreateProgram();
     glAttachShader(m_program_id, m_vertex_shader);
     glAttachShader(m_program_id, m_fragment_shader);
+    if (m_geometry_shader != 0) glAttachShader(m_program_id, m_geometry_shader);
+    if (use_cache) glProgramParameteri(m_program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    if (!m_feedback_varyings.empty())
+    {
+        glTransformFeedbackVaryings(m_program_id, (GLsizei)m_feedback_varyings.size(), m_feedback_varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    }
     glLinkProgram(m_program_id);
 
     GLint link_success;
@@ -23,26 +199,117 @@ void ShaderProgram::load(const char* vertex_shader_file, const char* fragment_sh
         printf("Error linking shader program!\n");
     }
 
-    m_model_matrix_uniform = glGetUniformLocation(m_program_id, "modelMatrix");
+    // STEP 3: ...and leave the result for next launch
+    else if (use_cache)
+    {
+        save_program_binary(cache_path, key);
+    }
+
+    find_locations();
+}
+
+bool ShaderProgram::load_program_binary(const std::string& filepath, unsigned long long key)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) return false;
+
+    ProgramBinaryHeader header;
+    if (!file.read((char*)&header, sizeof(header))) return false;
+    if (memcmp(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic)) != 0 || header.key != key ||
+        header.length == 0 || header.length > MAX_PROGRAM_BINARY_SIZE) return false;
+
+    std::vector<char> binary((size_t)header.length);
+    if (!file.read(binary.data(), binary.size())) return false;
+
+    m_program_id = glCreateProgram();
+    glProgramBinary(m_program_id, header.binary_format, binary.data(), (GLsizei)binary.size());
+
+    // Drivers are free to reject a binary for any reason at all, so LINK_STATUS is the only verdict
+    GLint link_success;
+    glGetProgramiv(m_program_id, GL_LINK_STATUS, &link_success);
+    if (link_success == GL_TRUE) return true;
+
+    glDeleteProgram(m_program_id);
+    m_program_id = 0;
+    return false;
+}
+
+void ShaderProgram::save_program_binary(const std::string& filepath, unsigned long long key)
+{
+    GLint length = 0;
+    glGetProgramiv(m_program_id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ProgramBinaryHeader header = {};
+    memcpy(header.magic, PROGRAM_BINARY_MAGIC, sizeof(header.magic));
+    header.key = key;
+
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    glGetProgramBinary(m_program_id, length, &written, &header.binary_format, binary.data());
+    if (written <= 0) return;
+    header.length = (unsigned long long)written;
+
+    // A cache that can't be written is only a slower next launch, never an error
+    std::error_code error;
+    std::filesystem::create_directories(BINARY_CACHE_DIRECTORY, error);
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), written);
+}
+
+void ShaderProgram::find_locations()
+{
+    m_model_transform_uniform = glGetUniformLocation(m_program_id, "modelTransform");
     m_projection_matrix_uniform = glGetUniformLocation(m_program_id, "projectionMatrix");
     m_view_matrix_uniform = glGetUniformLocation(m_program_id, "viewMatrix");
     m_colour_uniform = glGetUniformLocation(m_program_id, "color");
 
     m_position_attribute = glGetAttribLocation(m_program_id, "position");
     m_tex_coord_attribute = glGetAttribLocation(m_program_id, "texCoord");
+    m_layer_attribute = glGetAttribLocation(m_program_id, "layer");
+    m_vertex_colour_attribute = glGetAttribLocation(m_program_id, "vertexColour");
+
+    // Block bindings don't survive a relink or a binary load, so they're set here every time
+    m_has_camera_block = false;
+    if (supports_glsl_330())
+    {
+        GLuint camera_block = glGetUniformBlockIndex(m_program_id, "Camera");
+        m_has_camera_block = camera_block != GL_INVALID_INDEX;
+        if (m_has_camera_block) glUniformBlockBinding(m_program_id, camera_block, CAMERA_BINDING);
+    }
+
+    invalidate_uniforms();
 
     set_colour(1.0f, 1.0f, 1.0f, 1.0f);
 
 }
 
+void ShaderProgram::invalidate_uniforms()
+{
+    m_has_model_transform = m_has_projection_matrix = m_has_view_matrix = m_has_colour = false;
+}
+
+void ShaderProgram::use()
+{
+    if (g_bound_program == m_program_id) return;
+
+    count_gl_call(GL_CALL_BIND);
+    glUseProgram(m_program_id);
+    g_bound_program = m_program_id;
+}
+
 void ShaderProgram::cleanup()
 {
+    if (g_bound_program == m_program_id) g_bound_program = 0;
     glDeleteProgram(m_program_id);
     glDeleteShader(m_vertex_shader);
     glDeleteShader(m_fragment_shader);
+    glDeleteShader(m_geometry_shader);
 }
 
-GLuint ShaderProgram::load_shader_from_file(const std::string& shaderFile, GLenum type)
+std::string ShaderProgram::read_shader_file(const std::string& shaderFile)
 {
     //Open a file stream with the file name
     std::ifstream infile(shaderFile);
@@ -55,21 +322,43 @@ GLuint ShaderProgram::load_shader_from_file(const std::string& shaderFile, GLenu
     std::stringstream buffer;
     buffer << infile.rdbuf();
 
-    // Load the shader from the contents of the file
-    return load_shader_from_string(buffer.str(), type);
+    // Compiling waits until link_program knows whether the binary cache already has it
+    return buffer.str();
 }
 
-GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents, GLenum type)
+GLuint ShaderProgram::load_shader_from_string(std::string_view shaderContents, GLenum type, std::string_view defines)
 {
     // Create a shader of specified type
     GLuint shaderID = glCreateShader(type);
 
-    // Get the pointer to the C string from the STL string
-    const char* shader_string = shaderContents.c_str();
-    GLint shader_string_length = (GLint)shaderContents.size();
+    // #version has to stay the first line, so the defines go between it and the rest. The pieces
+    // are handed over as separate strings with explicit lengths, which copies nothing.
+    std::string_view version, body = shaderContents;
+    if (body.substr(0, 8) == "#version")
+    {
+        size_t line_end = body.find('\n');
+        size_t split = line_end == std::string_view::npos ? body.size() : line_end + 1;
+
+        version = body.substr(0, split);
+        body = body.substr(split);
+    }
+    else if (supports_glsl_330())
+    {
+        version = type == GL_VERTEX_SHADER ? GLSL_330_VERTEX_PRELUDE : GLSL_330_FRAGMENT_PRELUDE;
+    }
+    else if (is_gles())
+    {
+        version = type == GL_VERTEX_SHADER ? GLSL_ES_VERTEX_PRELUDE : GLSL_ES_FRAGMENT_PRELUDE;
+    }
+
+    // An empty view may have no storage at all, and not every driver takes NULL even with length 0
+    auto chars = [](std::string_view piece) { return piece.empty() ? "" : piece.data(); };
+
+    const char* shader_strings[] = { chars(version), chars(defines), chars(body) };
+    GLint shader_string_lengths[] = { (GLint)version.size(), (GLint)defines.size(), (GLint)body.size() };
 
-    // Set the shader source to the string and compile shader
-    glShaderSource(shaderID, 1, &shader_string, &shader_string_length);
+    // Set the shader source to the strings and compile shader
+    glShaderSource(shaderID, 3, shader_strings, shader_string_lengths);
     glCompileShader(shaderID);
 
     // Check if the shader compiled properly
@@ -90,24 +379,50 @@ GLuint ShaderProgram::load_shader_from_string(const std::string& shaderContents,
 
 void ShaderProgram::set_colour(float red, float green, float blue, float alpha)
 {
-    glUseProgram(m_program_id);
+    glm::vec4 colour = glm::vec4(red, green, blue, alpha);
+    if (m_has_colour && colour == m_colour) return;
+
+    use();
+    count_gl_call(GL_CALL_UNIFORM);
     glUniform4f(m_colour_uniform, red, green, blue, alpha);
+
+    m_colour = colour;
+    m_has_colour = true;
 }
 
 void ShaderProgram::set_view_matrix(const glm::mat4& matrix)
 {
-    glUseProgram(m_program_id);
+    if (m_has_view_matrix && matrix == m_view_matrix) return;
+
+    use();
+    count_gl_call(GL_CALL_UNIFORM);
     glUniformMatrix4fv(m_view_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+
+    m_view_matrix = matrix;
+    m_has_view_matrix = true;
 }
 
-void ShaderProgram::set_model_matrix(const glm::mat4& matrix)
+void ShaderProgram::set_model_transform(const ModelTransform& transform)
 {
-    glUseProgram(m_program_id);
-    glUniformMatrix4fv(m_model_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
+    if (m_has_model_transform && transform == m_model_transform) return;
+
+    // The three vec2 columns sit back to back, as the vec2[3] uniform wants them
+    use();
+    count_gl_call(GL_CALL_UNIFORM);
+    glUniform2fv(m_model_transform_uniform, 3, &transform.x_axis.x);
+
+    m_model_transform = transform;
+    m_has_model_transform = true;
 }
 
 void ShaderProgram::set_projection_matrix(const glm::mat4& matrix)
 {
-    glUseProgram(m_program_id);
+    if (m_has_projection_matrix && matrix == m_projection_matrix) return;
+
+    use();
+    count_gl_call(GL_CALL_UNIFORM);
     glUniformMatrix4fv(m_projection_matrix_uniform, 1, GL_FALSE, &matrix[0][0]);
-}
\ No newline at end of file
+
+    m_projection_matrix = matrix;
+    m_has_projection_matrix = true;
+}
@@ -9,34 +9,95 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string_view>
+#include <vector>
 #include "glm/mat4x4.hpp"
+#include "EmbeddedShaders.h"
+#include "ModelTransform.h"
 
 class ShaderProgram
 {
 private:
     void cleanup();
 
-    GLuint load_shader_from_string(const std::string& shader_contents, GLenum shader_type);
-    GLuint load_shader_from_file(const std::string& shader_file, GLenum shader_type);
+    GLuint load_shader_from_string(std::string_view shader_contents, GLenum shader_type, std::string_view defines = std::string_view());
+    std::string read_shader_file(const std::string& shader_file);
+
+    // ————— PROGRAM BINARY CACHE ————— //
+    // Linked programs are kept on disk under a key made of both sources and the driver's vendor,
+    // renderer and version strings, so an edited shader or an updated driver simply misses
+    void link_program(std::string_view vertex_source, std::string_view fragment_source, std::string_view defines,
+                      std::string_view geometry_source = std::string_view());
+    bool load_program_binary(const std::string& filepath, unsigned long long key);
+    void save_program_binary(const std::string& filepath, unsigned long long key);
+    void find_locations();
 
     GLuint m_program_id;
 
     GLuint m_projection_matrix_uniform;
-    GLuint m_model_matrix_uniform;
+    GLuint m_model_transform_uniform;
     GLuint m_view_matrix_uniform;
     GLuint m_colour_uniform;
 
     GLuint m_position_attribute;
     GLuint m_tex_coord_attribute;
+    GLint  m_layer_attribute = -1;  // SHADER_LAYERED and SHADER_GLYPHS variants only
+    GLint  m_vertex_colour_attribute = -1;  // SHADER_VERTEX_COLOUR variants only
+
+    bool m_has_camera_block = false;  // reads the matrices from the buffer at CAMERA_BINDING instead
+
+    std::vector<const char*> m_feedback_varyings;
+    const EmbeddedShader*    m_geometry_embedded = NULL;
+
+    GLuint m_vertex_shader   = 0;  // all stay 0 when the program came from the binary cache
+    GLuint m_fragment_shader = 0;
+    GLuint m_geometry_shader = 0;
+
+    // Last values uploaded to this program, so that setters can skip uploads that change nothing
+    ModelTransform m_model_transform;
+    glm::mat4 m_projection_matrix;
+    glm::mat4 m_view_matrix;
+    glm::vec4 m_colour;
+
+    bool m_has_model_transform   = false,
+         m_has_projection_matrix = false,
+         m_has_view_matrix       = false,
+         m_has_colour            = false;
 
-    GLuint m_vertex_shader;
-    GLuint m_fragment_shader;
+    void invalidate_uniforms();
 
 public:
+    static const char BINARY_CACHE_DIRECTORY[];
+
+    // Where programs with a Camera uniform block (sprite_vertex.glsl under GLSL_330) look for it
+    static const GLuint CAMERA_BINDING = 0;
 
     void load(const char* vertex_shader_file, const char* fragment_shader_file);
 
-    void set_model_matrix(const glm::mat4& matrix);
+    // Compiles straight from the sources built into the executable: no file I/O and no copies.
+    // With a source override set, the same shaders are read from that directory instead.
+    // defines (e.g. "#define TEXTURED 1\n") go in front of both sources, after any #version line;
+    // see ShaderVariants for building them from feature bits
+    void load(const EmbeddedShader& vertex_shader, const EmbeddedShader& fragment_shader, std::string_view defines = std::string_view());
+
+    // Before load(): vertex shader outputs to capture with transform feedback, interleaved in this
+    // order into the buffer at binding 0 (see GpuParticleSystem). The names must outlive the program.
+    void set_feedback_varyings(const char* const* names, int count) { m_feedback_varyings.assign(names, names + count); };
+
+    // Before the embedded load(): a geometry shader linked in between the two. It gets no prelude,
+    // so it starts with its own #version 330 line, and only a GLSL 3.30 context can take it (see
+    // GpuLanderSim).
+    void set_geometry_shader(const EmbeddedShader* shader) { m_geometry_embedded = shader; };
+
+    // Development only: point the embedded loads at a live checkout (e.g. "shaders") so edited
+    // GLSL is picked up without a rebuild. NULL or empty turns it back off.
+    static void set_source_override(const char* directory);
+
+    // Binds the program unless it is already the one bound. Every glUseProgram should go through
+    // here, otherwise the tracked binding goes stale.
+    void use();
+
+    void set_model_transform(const ModelTransform& transform);
     void set_projection_matrix(const glm::mat4& matrix);
     void set_view_matrix(const glm::mat4& matrix);
     void set_colour(float red, float green, float blue, float alpha);
@@ -44,6 +105,9 @@ public:
     GLuint const get_program_id()               const { return m_program_id; };
     GLuint const get_position_attribute()       const { return m_position_attribute; };
     GLuint const get_tex_coordinate_attribute() const { return m_tex_coord_attribute; };
+    GLint  const get_layer_attribute()          const { return m_layer_attribute; };  // -1 when the program has none
+    GLint  const get_vertex_colour_attribute()  const { return m_vertex_colour_attribute; };  // likewise
+    bool   const has_camera_block()             const { return m_has_camera_block; };
 
-    void set_program_id(GLuint program_id) { m_program_id = program_id; };
+    void set_program_id(GLuint program_id) { m_program_id = program_id; invalidate_uniforms(); };
 };
\ No newline at end of file
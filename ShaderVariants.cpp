@@ -0,0 +1,100 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "ShaderVariants.h"
+
+static const char* const FEATURE_NAMES[SHADER_FEATURE_COUNT] = { "TEXTURED", "INSTANCED", "TINTED", "ALPHA_TEST", "SDF", "LAYERED", "GLYPHS", "VERTEX_COLOUR", "MATERIAL" };
+
+std::string ShaderVariants::make_defines(unsigned int features)
+{
+    std::string defines;
+    for (int bit = 0; bit < SHADER_FEATURE_COUNT; bit++)
+    {
+        if (features & (1u << bit)) defines += std::string("#define ") + FEATURE_NAMES[bit] + " 1\n";
+    }
+    return defines;
+}
+
+void ShaderVariants::initialise(const EmbeddedShader& vertex_shader, const EmbeddedShader& fragment_shader)
+{
+    m_vertex_shader = vertex_shader;
+    m_fragment_shader = fragment_shader;
+    m_programs.clear();
+
+    if (m_camera_buffer == 0 && supports_glsl_330())
+    {
+        count_gl_call(GL_CALL_BIND, 2);
+        glGenBuffers(1, &m_camera_buffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_camera_buffer);
+        glBufferData(GL_UNIFORM_BUFFER, 2 * sizeof(glm::mat4), NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, ShaderProgram::CAMERA_BINDING, m_camera_buffer);
+        upload_camera();
+    }
+}
+
+void ShaderVariants::upload_camera()
+{
+    // std140 puts the two matrices back to back, in the block's order
+    const glm::mat4 matrices[2] = { m_view_matrix, m_projection_matrix };
+
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_camera_buffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(matrices), matrices);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+ShaderProgram* ShaderVariants::get(unsigned int features)
+{
+    auto found = m_programs.find(features);
+    if (found != m_programs.end()) return found->second.get();
+
+    // First use of this permutation: compile it (or pull it out of the binary cache) and bring
+    // its matrices up to date with everyone else's, unless it reads them from the camera buffer
+    std::unique_ptr<ShaderProgram> program(new ShaderProgram());
+    program->load(m_vertex_shader, m_fragment_shader, make_defines(features));
+    if (!program->has_camera_block())
+    {
+        program->set_projection_matrix(m_projection_matrix);
+        program->set_view_matrix(m_view_matrix);
+    }
+
+    ShaderProgram* result = program.get();
+    m_programs[features] = std::move(program);
+    return result;
+}
+
+void ShaderVariants::set_projection_matrix(const glm::mat4& matrix)
+{
+    set_camera(matrix, m_view_matrix);
+}
+
+void ShaderVariants::set_view_matrix(const glm::mat4& matrix)
+{
+    set_camera(m_projection_matrix, matrix);
+}
+
+void ShaderVariants::set_camera(const glm::mat4& projection_matrix, const glm::mat4& view_matrix)
+{
+    m_projection_matrix = projection_matrix;
+    m_view_matrix = view_matrix;
+    if (m_camera_buffer != 0) upload_camera();
+
+    for (auto& variant : m_programs)
+    {
+        if (variant.second->has_camera_block()) continue;
+        variant.second->set_projection_matrix(projection_matrix);
+        variant.second->set_view_matrix(view_matrix);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+// Feature bits for the sprite shader; each one turns into a #define in front of both sources
+enum ShaderFeature
+{
+    SHADER_TEXTURED   = 1 << 0,  // sample `diffuse` at texCoord; flat `color` without it
+    SHADER_INSTANCED  = 1 << 1,  // per-instance offset, scale and UV rect instead of modelTransform
+    SHADER_TINTED     = 1 << 2,  // multiply the texel by `color`
+    SHADER_ALPHA_TEST = 1 << 3,  // discard texels below half alpha
+    SHADER_SDF        = 1 << 4,  // the texture holds distance fields, e.g. the SDF font sheet
+    SHADER_LAYERED    = 1 << 5,  // with TEXTURED: sample a texture array at the per-vertex `layer`; GLSL 3.30 only
+    SHADER_GLYPHS     = 1 << 6,  // with TEXTURED: a per-vertex `layer` of 1 reads the texel as SDF, so text batches with sprites
+    SHADER_VERTEX_COLOUR = 1 << 7,  // without TEXTURED: a per-vertex `vertexColour` instead of `color`, so lines of every colour share a draw
+    SHADER_MATERIAL   = 1 << 8,  // with TEXTURED | INSTANCED: the texel is a grey level along the instance's palette ramp, tinted (InstanceMaterials)
+    SHADER_FEATURE_COUNT = 9
+};
+
+// Every permutation of one vertex/fragment pair, compiled the first time something asks for it and
+// kept by feature key from then on. Callers ask for exactly the features a batch uses, so nothing
+// pays for a tint or a discard it doesn't need.
+//
+// The camera is shared by all of them. Under GLSL 3.30 it lives in one uniform buffer that every
+// variant's Camera block reads, so moving it is a single upload however many variants there are;
+// older contexts fall back to setting each variant's own uniforms.
+class ShaderVariants
+{
+private:
+    EmbeddedShader m_vertex_shader,
+                   m_fragment_shader;
+
+    std::unordered_map<unsigned int, std::unique_ptr<ShaderProgram>> m_programs;
+
+    // Applied to every variant, including the ones compiled later
+    glm::mat4 m_projection_matrix = glm::mat4(1.0f),
+              m_view_matrix       = glm::mat4(1.0f);
+
+    GLuint m_camera_buffer = 0;  // bound at ShaderProgram::CAMERA_BINDING; 0 without GLSL 3.30
+
+    void upload_camera();
+
+public:
+    void initialise(const EmbeddedShader& vertex_shader, const EmbeddedShader& fragment_shader);
+
+    ShaderProgram* get(unsigned int features);
+
+    void set_projection_matrix(const glm::mat4& matrix);
+    void set_view_matrix(const glm::mat4& matrix);
+    void set_camera(const glm::mat4& projection_matrix, const glm::mat4& view_matrix);  // one upload for both
+
+    static std::string make_defines(unsigned int features);
+
+    const glm::mat4& get_projection_matrix() const { return m_projection_matrix; };
+    const glm::mat4& get_view_matrix()       const { return m_view_matrix; };
+    int const get_variant_count() const { return (int)m_programs.size(); };
+    bool const has_camera_buffer() const { return m_camera_buffer != 0; };
+};
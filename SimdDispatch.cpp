@@ -0,0 +1,150 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "SimdDispatch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_DISPATCH_X86 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_DISPATCH_NEON 1
+#endif
+
+static const char* const SIMD_ISA_NAMES[SIMD_ISA_COUNT] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+
+static SimdIsa          s_forced = SIMD_ISA_COUNT;  // none
+static std::atomic<bool> s_bound{ false };
+
+bool parse_simd_isa(const char* name, SimdIsa& isa)
+{
+    for (int i = 0; i < SIMD_ISA_COUNT; i++)
+    {
+        if (std::strcmp(name, SIMD_ISA_NAMES[i]) != 0) continue;
+        isa = (SimdIsa)i;
+        return true;
+    }
+    return false;
+}
+
+const char* get_simd_isa_name(SimdIsa isa)
+{
+    return isa >= 0 && isa < SIMD_ISA_COUNT ? SIMD_ISA_NAMES[isa] : "unknown";
+}
+
+// ————— DETECTION ————— //
+#ifdef SIMD_DISPATCH_X86
+static bool detect_avx2()
+{
+#ifdef _MSC_VER
+    // The CPU has to have it, and the OS has to save the YMM registers across context switches
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+static bool detect_avx512()
+{
+#ifdef _MSC_VER
+    // As for AVX2, and the OS saving the opmask and ZMM registers as well
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave || (_xgetbv(0) & 0xe6) != 0xe6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+#endif
+
+bool supports_simd_isa(SimdIsa isa)
+{
+    switch (isa)
+    {
+    case SIMD_SCALAR: return true;
+#ifdef SIMD_DISPATCH_X86
+    case SIMD_SSE2:   return true;
+    case SIMD_AVX2:   return detect_avx2();
+    case SIMD_AVX512: return detect_avx2() && detect_avx512();
+#endif
+#ifdef SIMD_DISPATCH_NEON
+    case SIMD_NEON:   return true;
+#endif
+    default:          return false;
+    }
+}
+
+SimdIsa get_detected_simd_isa()
+{
+    static const SimdIsa detected = []()
+        {
+            for (SimdIsa isa : { SIMD_AVX512, SIMD_AVX2, SIMD_SSE2, SIMD_NEON })
+            {
+                if (supports_simd_isa(isa)) return isa;
+            }
+            return SIMD_SCALAR;
+        }();
+    return detected;
+}
+
+// ————— BINDING ————— //
+bool force_simd_isa(SimdIsa isa)
+{
+    if (s_bound.load(std::memory_order_acquire) || !supports_simd_isa(isa)) return false;
+
+    s_forced = isa;
+    return true;
+}
+
+SimdIsa get_simd_isa()
+{
+    static const SimdIsa bound = []()
+        {
+            // The environment only where nothing was forced in code
+            const char* name = std::getenv("LANDER_SIMD");
+            SimdIsa isa;
+            if (name != NULL && s_forced == SIMD_ISA_COUNT)
+            {
+                if (!parse_simd_isa(name, isa))
+                {
+                    std::cout << "LANDER_SIMD=" << name << " isn't an instruction set; expected scalar, sse2, avx2, avx512 or neon" << std::endl;
+                }
+                else if (!supports_simd_isa(isa))
+                {
+                    std::cout << "LANDER_SIMD=" << name << " isn't supported here; using " << get_simd_isa_name(get_detected_simd_isa()) << std::endl;
+                }
+                else s_forced = isa;
+            }
+
+            s_bound.store(true, std::memory_order_release);
+            return s_forced != SIMD_ISA_COUNT ? s_forced : get_detected_simd_isa();
+        }();
+    return bound;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Which instruction set the SIMD kernels run on, decided once per process for all of them: the
+// overlap test, the policy network, the batched landers, force fields, terrain and the mixer.
+// Each family binds its kernels from get_simd_isa() the first time it runs and keeps them, so
+// one binary uses the widest kernels every machine it lands on can run.
+//
+// Every kernel gives its family's scalar results to the bit (see OverlapKernels.h), so which one
+// runs changes the speed and nothing else; only the mixer's gain ramps round a little apart, far
+// below hearing. That makes the choice safe to force, for comparing them on one machine:
+// force_simd_isa() before anything runs, or LANDER_SIMD=<name> in the environment for any of the
+// binaries. A forced set the CPU can't run leaves the detected one; a family without a kernel
+// that wide runs its widest.
+//
+//   scalar  anywhere
+//   SSE2    every x64 CPU; the batched landers, force fields, terrain and the mixer go no wider
+//   AVX2    picked where the CPU and the OS both support it
+//   AVX512  detected and reported, run with the AVX2 kernels: nothing here has the work for 16 lanes
+//   NEON    every AArch64 CPU
+enum SimdIsa
+{
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512,
+    SIMD_NEON,
+    SIMD_ISA_COUNT
+};
+
+// "scalar", "sse2", "avx2", "avx512" or "neon"; false, leaving `isa` alone, for anything else
+bool parse_simd_isa(const char* name, SimdIsa& isa);
+const char* get_simd_isa_name(SimdIsa isa);
+
+// Whether this build and this CPU can run it
+bool supports_simd_isa(SimdIsa isa);
+// The widest this CPU runs, detected on the first call
+SimdIsa get_detected_simd_isa();
+
+// The one the kernels are bound to: forced, or else detected. Fixed from the first call on.
+SimdIsa get_simd_isa();
+// Before the first get_simd_isa(); false, changing nothing, once the kernels are bound or if the
+// CPU can't run it
+bool force_simd_isa(SimdIsa isa);
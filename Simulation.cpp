@@ -0,0 +1,437 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include "ForceFields.h"
+#include "Rng.h"
+#include "Simulation.h"
+#include "StateHash.h"
+#include "Trace.h"
+
+void setup_player(Entity* player)
+{
+    player->set_entity_type(PLAYER);
+    player->set_speed(2.0f);
+    player->set_height(0.8f);
+    player->set_width(0.8f);
+
+    player->m_boosting_power = 0.1f;
+    player->m_drag = 0.8f;
+}
+
+void retune_lander(Entity& lander)
+{
+    setup_player(&lander);
+
+    glm::vec3 acceleration = lander.get_acceleration();
+    lander.set_acceleration(glm::vec3(acceleration.x, ACC_OF_GRAVITY, acceleration.z));
+}
+
+void reset_lander(Entity& lander, glm::vec3 spawn_position, float gravity)
+{
+    lander.set_position(spawn_position);
+    lander.set_velocity(glm::vec3(0.0f));
+    lander.set_movement(glm::vec3(0.0f));
+    lander.set_acceleration(glm::vec3(0.0f, gravity, 0.0f));
+    lander.set_field_acceleration(glm::vec2(0.0f));
+    lander.m_booster_active = false;
+    lander.m_throttle = 1.0f;
+}
+
+void reset_episode(GameState& state)
+{
+    reset_lander(*state.player, state.spawn_position, state.gravity);
+    for (int i = 0; i < state.lander_count; i++)
+    {
+        reset_lander(state.landers[i], state.spawn_position, state.gravity);
+        state.lander_outcomes[i] = LanderOutcome();
+    }
+
+    state.win = false;
+    state.loss = false;
+    state.tick_accumulator = 0;
+    state.time_accumulator = 0.0f;
+    state.step_hash = hash_step_state(state);
+}
+
+int get_lander_count(const GameState& state)
+{
+    return 1 + state.lander_count;
+}
+
+Entity* get_lander(GameState& state, int index)
+{
+    return index == 0 ? state.player : &state.landers[index - 1];
+}
+
+LanderOutcome get_lander_outcome(const GameState& state, int index)
+{
+    if (index > 0) return state.lander_outcomes[index - 1];
+
+    LanderOutcome outcome;
+    outcome.win = state.win;
+    outcome.loss = state.loss;
+    return outcome;
+}
+
+void set_lander_outcome(GameState& state, int index, const LanderOutcome& outcome)
+{
+    if (index > 0)
+    {
+        state.lander_outcomes[index - 1] = outcome;
+        return;
+    }
+    state.win = outcome.win;
+    state.loss = outcome.loss;
+}
+
+void add_outcome_events(const GameEventBuffer& events, int first, LanderOutcome& outcome)
+{
+    for (int i = first; i < events.get_count(); i++)
+    {
+        outcome.win  |= events.get_event(i).type == EVENT_LANDED;
+        outcome.loss |= events.get_event(i).type == EVENT_CRASHED;
+    }
+}
+
+void generate_platforms(Entity* platforms, int platform_count, unsigned int seed)
+{
+    Rng rng(seed);
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        bool rand_bool = rng.next_bool();
+        float rand_float = (float)rng.next_int(-3, 1);
+        platforms[i].set_position(glm::vec3(i - 4.0f, rand_float, 0.0f));
+        platforms[i].set_entity_type((rand_bool) ? WIN_PLATFORM : DEATH_PLATFORM);
+        platforms[i].set_body_type(STATIC_BODY);
+    }
+}
+
+static void update_landers(GameState& state, float delta_time, double* collision_seconds)
+{
+    // STEP 1: With several landers and no broadphase, one shared scan finds the platforms near
+    //         all of them, rather than each lander scanning the level on its own. A broadphase's
+    //         own queries are already cheaper than sharing them would be.
+    const PlatformBroadphase* broadphase = state.platform_broadphase;
+    if (state.lander_count > 0 && broadphase == NULL)
+    {
+        std::chrono::steady_clock::time_point gather_start;
+        if (collision_seconds != NULL) gather_start = std::chrono::steady_clock::now();
+
+        PlatformQueryBatch& queries = state.lander_queries;
+        queries.begin(state.platforms, state.platform_count, state.platform_colliders);
+        queries.add_lander(*state.player, delta_time);
+        for (int i = 0; i < state.lander_count; i++) queries.add_lander(state.landers[i], delta_time);
+        queries.gather();
+        broadphase = &queries;
+
+        if (collision_seconds != NULL) *collision_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - gather_start).count();
+    }
+
+    // STEP 2: Each lander's share of the force fields, from where it starts the step
+    if (state.force_fields != NULL)
+    {
+        for (int i = 0; i < get_lander_count(state); i++)
+        {
+            Entity* lander = get_lander(state, i);
+            lander->set_field_acceleration(state.force_fields->get_acceleration(glm::vec2(lander->get_position())));
+        }
+    }
+
+    // STEP 3: Every lander collides with the same level, and is scored on its own from the
+    //         events it reports. This thread's buffers, so worlds stepped side by side never share.
+    thread_local GameEventBuffer events, published;
+    events.clear();
+    published.clear();
+
+    for (int i = 0; i < get_lander_count(state); i++)
+    {
+        int first = events.get_count();
+        events.set_lander(i);
+        get_lander(state, i)->update(delta_time, state.platforms, state.platform_count, &events, broadphase, state.platform_colliders,
+                                     collision_seconds, state.terrain, state.distance_field);
+        if (events.get_count() == first) continue;
+
+        LanderOutcome outcome = get_lander_outcome(state, i);
+        bool decided = outcome.win || outcome.loss;
+        add_outcome_events(events, first, outcome);
+        set_lander_outcome(state, i, outcome);
+
+        // STEP 4: What the readers hear: everything but a decided lander's touchdowns, which it
+        //         repeats for as long as it sits on the ground
+        if (state.events == NULL) continue;
+        for (int k = first; k < events.get_count(); k++)
+        {
+            const GameEvent& event = events.get_event(k);
+            if (!decided || (event.type != EVENT_LANDED && event.type != EVENT_CRASHED)) published.push(event);
+        }
+    }
+
+    // STEP 5: Merged once for the whole step
+    if (state.events != NULL)
+    {
+        const GameEventBuffer* buffers[] = { &published };
+        state.events->merge(buffers, 1);
+    }
+}
+
+void sync_movers(GameState& state)
+{
+    if (state.platform_colliders != NULL) state.platform_colliders->sync_movers(state.platforms);
+    if (state.platform_broadphase != NULL) state.platform_broadphase->sync_movers(state.platforms);
+}
+
+void step_simulation(GameState& state, float delta_time)
+{
+    TRACE_ZONE("step_simulation");
+    StepTimings& timings = state.timings;
+    if (!timings.enabled)
+    {
+        sync_movers(state);
+        update_landers(state, delta_time, NULL);
+        if (state.hash_steps) state.step_hash = hash_step_state(state, state.step_hash);
+        return;
+    }
+
+    std::chrono::steady_clock::time_point step_start = std::chrono::steady_clock::now();
+    double collision_seconds = 0.0;
+
+    // Keeping the movers' boxes in sync is collision work too, just done ahead of time
+    sync_movers(state);
+    collision_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - step_start).count();
+
+    update_landers(state, delta_time, &collision_seconds);
+
+    double step_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - step_start).count();
+    timings.collision_seconds += collision_seconds;
+    timings.integration_seconds += std::max(step_seconds - collision_seconds, 0.0);
+    if (state.hash_steps) state.step_hash = hash_step_state(state, state.step_hash);
+}
+
+// ————— INTEGRATORS ————— //
+static const char* const INTEGRATOR_NAMES[] = { "euler", "semi-implicit", "verlet" };
+
+const char* get_integrator_name(Integrator integrator)
+{
+    return (integrator >= EXPLICIT_EULER && integrator <= VELOCITY_VERLET) ? INTEGRATOR_NAMES[integrator] : "unknown";
+}
+
+bool parse_integrator(const char* name, Integrator& integrator)
+{
+    for (int i = EXPLICIT_EULER; i <= VELOCITY_VERLET; i++)
+    {
+        if (std::strcmp(name, INTEGRATOR_NAMES[i]) == 0)
+        {
+            integrator = (Integrator)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+float get_stable_timestep(Integrator integrator, float max_timestep)
+{
+    if (integrator == EXPLICIT_EULER) return FIXED_TIMESTEP;
+
+    // A hair of slack, so 1/30 s counts as two steps despite FIXED_TIMESTEP's rounded last digit
+    int steps = std::max((int)(max_timestep * 1.001f / FIXED_TIMESTEP), 1);
+    return steps * FIXED_TIMESTEP;
+}
+
+void set_integrator(GameState& state, Integrator integrator, float max_timestep)
+{
+    state.fixed_timestep = get_stable_timestep(integrator, max_timestep);
+    for (int i = 0; i < get_lander_count(state); i++) get_lander(state, i)->m_integrator = integrator;
+}
+
+static uint32_t hash_bytes(uint32_t hash, const void* data, size_t size)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t checksum_lander(const Entity& lander, LanderOutcome lander_outcome, uint32_t hash)
+{
+    const PhysicsVec3& position = lander.get_physics_position();
+    const PhysicsVec3& velocity = lander.get_physics_velocity();
+
+    PhysicsScalar values[] = { position.x, position.y, velocity.x, velocity.y };
+    unsigned char outcome[] = { (unsigned char)lander_outcome.win, (unsigned char)lander_outcome.loss };
+
+    hash = hash_bytes(hash, values, sizeof(values));
+    return hash_bytes(hash, outcome, sizeof(outcome));
+}
+
+uint32_t checksum_state(const GameState& state, uint32_t hash)
+{
+    // The player alone hashes exactly as it did before there were other landers
+    hash = checksum_lander(*state.player, get_lander_outcome(state, 0), hash);
+    for (int i = 0; i < state.lander_count; i++) hash = checksum_lander(state.landers[i], state.lander_outcomes[i], hash);
+    return hash;
+}
+
+static uint32_t get_scalar_bits(PhysicsScalar value)
+{
+    static_assert(sizeof(PhysicsScalar) == sizeof(uint32_t), "a lander's scalars hash as 32-bit lanes");
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint64_t hash_step_state(const GameState& state, uint64_t previous)
+{
+    // Two lanes a lander for its position and velocity, and one for its outcome
+    StateHash hash(previous);
+    for (int i = 0; i < get_lander_count(state); i++)
+    {
+        const Entity& lander = i == 0 ? *state.player : state.landers[i - 1];
+        const PhysicsVec3& position = lander.get_physics_position();
+        const PhysicsVec3& velocity = lander.get_physics_velocity();
+        LanderOutcome outcome = get_lander_outcome(state, i);
+
+        hash.add(get_scalar_bits(position.x), get_scalar_bits(position.y));
+        hash.add(get_scalar_bits(velocity.x), get_scalar_bits(velocity.y));
+        hash.add((uint32_t)outcome.win | (uint32_t)outcome.loss << 1, (uint32_t)i);
+    }
+    return hash.finish();
+}
+
+bool save_snapshot(const GameState& state, SimulationSnapshot& snapshot)
+{
+    if (state.lander_count > SimulationSnapshot::MAX_LANDERS) return false;
+    if (!snapshot.platforms.resize(state.platform_count)) return false;
+
+    state.player->save_state(snapshot.player);
+
+    snapshot.lander_count = state.lander_count;
+    for (int i = 0; i < state.lander_count; i++)
+    {
+        state.landers[i].save_state(snapshot.landers[i]);
+        snapshot.lander_outcomes[i] = state.lander_outcomes[i];
+    }
+
+    ColliderBox* boxes = snapshot.platforms.data();
+    for (int i = 0; i < state.platform_count; i++) boxes[i] = make_collider_box(state.platforms[i]);
+
+    snapshot.win = state.win;
+    snapshot.loss = state.loss;
+    snapshot.tick_accumulator = state.tick_accumulator;
+    snapshot.step_hash = state.step_hash;
+    return true;
+}
+
+void restore_snapshot(GameState& state, const SimulationSnapshot& snapshot)
+{
+    state.player->restore_state(snapshot.player);
+
+    for (int i = 0; i < snapshot.lander_count; i++)
+    {
+        state.landers[i].restore_state(snapshot.landers[i]);
+        state.lander_outcomes[i] = snapshot.lander_outcomes[i];
+    }
+
+    const ColliderBox* boxes = snapshot.platforms.data();
+    for (int i = 0; i < snapshot.platforms.get_count(); i++)
+    {
+        const ColliderBox& box = boxes[i];
+        Entity& platform = state.platforms[i];
+
+        PhysicsVec3 position = platform.get_physics_position();
+        position.x = box.x;
+        position.y = box.y;
+
+        platform.set_physics_position(position);
+        platform.set_physics_size(box.width, box.height);
+        platform.set_entity_type((EntityType)box.entity_type);
+        if (box.active) platform.activate();
+        else            platform.deactivate();
+    }
+    sync_movers(state);
+
+    state.win = snapshot.win;
+    state.loss = snapshot.loss;
+    state.tick_accumulator = snapshot.tick_accumulator;
+    state.time_accumulator = (float)((double)snapshot.tick_accumulator / TICKS_PER_SECOND);
+    state.step_hash = snapshot.step_hash;
+}
+
+int64_t seconds_to_ticks(double seconds)
+{
+    return std::llround(seconds * (double)TICKS_PER_SECOND);
+}
+
+int advance_simulation(GameState& state, float delta_time, double frame_time)
+{
+    return advance_simulation_ticks(state, seconds_to_ticks(delta_time), frame_time);
+}
+
+int advance_simulation_ticks(GameState& state, int64_t elapsed_ticks, double frame_time)
+{
+    TRACE_ZONE("advance_simulation");
+
+    // ————— FIXED TIMESTEP ————— //
+    // STEP 1: Keep track of how much time has passed since last step
+    const int64_t step_ticks = seconds_to_ticks(state.fixed_timestep);
+    int64_t ticks = elapsed_ticks + state.tick_accumulator;
+
+    // STEP 2: Accumulate the ammount of time passed while we're under our fixed timestep
+    if (ticks < step_ticks)
+    {
+        state.tick_accumulator = ticks;
+        state.time_accumulator = (float)((double)ticks / TICKS_PER_SECOND);
+        return 0;
+    }
+
+    // STEP 3: More steps than the budget allows would only make the next frame later still, so
+    //         drop the excess and let the game run slow for this frame (time dilation)
+    StepBudget& budget = state.budget;
+    budget.time_scale = 1.0f;
+
+    if (budget.max_steps_per_frame > 0 && ticks >= (budget.max_steps_per_frame + 1) * step_ticks)
+    {
+        int64_t allowed = budget.max_steps_per_frame * step_ticks;
+
+        budget.dropped_seconds += (double)(ticks - allowed) / TICKS_PER_SECOND;
+        budget.over_budget_frames++;
+        budget.time_scale = (float)((double)allowed / (double)ticks);
+        ticks = allowed;
+    }
+
+    // STEP 4: Once we exceed our fixed timestep, apply that elapsed time into the objects' update function invocation
+    int steps = 0;
+    while (ticks >= step_ticks && (budget.max_steps_per_frame <= 0 || steps < budget.max_steps_per_frame))
+    {
+        // The time still to simulate ends at frame_time, so this step starts that long before it
+        if (state.before_step != NULL) state.before_step(state, frame_time - (double)ticks / TICKS_PER_SECOND, state.before_step_data);
+        if (state.step != NULL) state.step(state, state.fixed_timestep);
+        else                    step_simulation(state, state.fixed_timestep);
+        ticks -= step_ticks;
+        steps++;
+    }
+
+    state.tick_accumulator = ticks;
+    state.time_accumulator = (float)((double)ticks / TICKS_PER_SECOND);
+    budget.total_steps += steps;
+    return steps;
+}
+
+float interpolation_alpha(const GameState& state)
+{
+    return std::min(std::max(state.time_accumulator / state.fixed_timestep, 0.0f), 1.0f);
+}
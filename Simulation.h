@@ -0,0 +1,291 @@
+#pragma once
+
+// The lander rules with no SDL or GL attached: the game, the headless driver and anything else
+// that needs to step the physics all go through here.
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+#include "GameEvents.h"
+#include "PlatformBroadphase.h"
+#include "PlatformColliders.h"
+#include "PlatformQueryBatch.h"
+
+class ForceFields;
+class LandingSiteMap;
+
+#define FIXED_TIMESTEP 0.0166666f
+#define ACC_OF_GRAVITY -1.62f
+#define PLATFORM_COUNT 9
+#define MAX_STEPS_PER_FRAME 8
+
+// Platforms a SimulationSnapshot holds in place. 0, the default, sizes it to whatever level it is
+// saved from; embedded builds can define a capacity instead to keep snapshots free of the heap.
+#ifndef LANDER_SNAPSHOT_PLATFORMS
+#define LANDER_SNAPSHOT_PLATFORMS 0
+#endif
+
+// advance_simulation keeps its time in whole nanoseconds rather than float seconds, so however
+// long a session runs, every step is exactly as long as the last and none is ever lost to rounding
+#define TICKS_PER_SECOND 1000000000LL
+
+// Guards advance_simulation against the spiral of death: after a hitch (a window drag, a
+// breakpoint) it runs at most max_steps_per_frame steps and lets the simulation fall behind
+// real time instead of trying to catch up all at once
+struct StepBudget
+{
+    int max_steps_per_frame = MAX_STEPS_PER_FRAME;  // 0 for no limit
+
+    // ————— COUNTERS ————— //
+    double    dropped_seconds    = 0.0;  // real time the simulation never simulated
+    long long over_budget_frames = 0,
+              total_steps        = 0;
+    float     time_scale         = 1.0f; // below 1 when the last advance was over budget
+};
+
+// Where step_simulation's time went. Off by default, since it costs a few clock reads a step.
+struct StepTimings
+{
+    bool   enabled = false;
+    double collision_seconds   = 0.0,
+           integration_seconds = 0.0;  // everything else in the step
+};
+
+// How one lander's episode ended; both stay false until it touches down
+struct GameState;
+
+// Called before each fixed step advance_simulation takes, with the real time the step starts at
+// on the caller's clock, so input that arrived mid-frame can be applied to the step it belongs to
+typedef void (*StepCallback)(GameState& state, double step_time, void* user_data);
+
+// Stands in for step_simulation, e.g. a hot-reloaded gameplay module's (GameplayApi.h)
+typedef void (*StepFunction)(GameState& state, float delta_time);
+
+struct LanderOutcome
+{
+    bool win  = false,
+         loss = false;
+};
+
+struct GameState
+{
+    Entity* player;  // lander 0, scored in win and loss below
+    Entity* platforms;
+    int     platform_count = PLATFORM_COUNT;
+
+    // Optional broadphase over platforms; must be rebuilt whenever static ones move, while
+    // step_simulation keeps its movers in sync
+    PlatformBroadphase* platform_broadphase = NULL;
+
+    // Optional packed copy of the platforms' collision boxes; step_simulation keeps its movers
+    // in sync, but it must be rebuilt if platforms are added, removed or resized
+    PlatformColliders* platform_colliders = NULL;
+
+    // Optional heightfield ground (Terrain.h), collided with alongside the platforms
+    const Terrain* terrain = NULL;
+
+    // Optional level geometry baked into a signed distance field (DistanceField.h), for ground a
+    // heightfield can't describe; collided with alongside the other two
+    const DistanceField* distance_field = NULL;
+
+    // Optional gravity wells, wind and tractor beams (ForceFields.h), on top of the landers' own
+    // gravity; looked up for every lander at the start of each step
+    const ForceFields* force_fields = NULL;
+
+    // Optional scores for the WIN platforms (LandingSiteMap.h), for bots and hints to pick a pad
+    // by; the simulation itself never reads it. Built with the broadphase, and rebuilt with it.
+    const LandingSiteMap* landing_sites = NULL;
+
+    // Optional; every step_simulation merges its landers' events (GameEvents.h) into it, with a
+    // lander's touchdowns left out once it's decided. Only one thread may step into a stream.
+    GameEventStream* events = NULL;
+
+    // Optional landers beyond the player (a second player, ghosts, bots), each with an outcome of
+    // its own; owned by the caller, like the platforms. They collide with the level but not with
+    // each other. Without a platform_broadphase, lander_queries shares one scan among them all.
+    Entity*            landers         = NULL;
+    LanderOutcome*     lander_outcomes = NULL;
+    int                lander_count    = 0;
+    PlatformQueryBatch lander_queries;
+
+    // Where reset_episode puts the player; a level file can move it
+    glm::vec3 spawn_position = glm::vec3(0.0f, 3.0f, 0.0f);
+    // And the pull it gives every lander there; a tuning file (TuningConfig.h) can change it
+    float     gravity = ACC_OF_GRAVITY;
+
+    bool    win  = false,
+            loss = false;
+    int64_t tick_accumulator = 0;     // time not yet simulated, in TICKS_PER_SECOND ticks
+    float   time_accumulator = 0.0f;  // the same in seconds, for interpolation and the counters
+
+    // The step advance_simulation and WorldPool take; 1/30 halves the physics cost on slow
+    // machines, with render interpolation keeping the motion smooth. Under EXPLICIT_EULER the
+    // booster pushes once per step, so changing this also changes how strong it feels; see
+    // set_integrator for the integrators that don't mind.
+    float fixed_timestep = FIXED_TIMESTEP;
+
+    StepBudget  budget;
+    StepTimings timings;
+
+    // Off by default. When on, every step_simulation folds the state it leaves into step_hash
+    // (see hash_step_state), so the hash after step n stands for the whole run up to it: two runs
+    // that agree on it agree on every step before, and the first step where they don't is the
+    // first step that diverged. reset_episode starts the chain from the spawn state.
+    bool     hash_steps = false;
+    uint64_t step_hash  = 0;
+
+    // Optional; see StepCallback
+    StepCallback before_step      = NULL;
+    void*        before_step_data = NULL;
+
+    // Optional; advance_simulation steps through it instead of step_simulation
+    StepFunction step = NULL;
+};
+
+// A snapshot's platforms, contiguous either way so saving and restoring them is one pass over an
+// array. With a CAPACITY they sit inside the snapshot itself, which then stays memcpy-able but
+// can't hold a bigger level; without one they go in a vector that only ever grows, so saving a
+// level into the same snapshot again doesn't allocate.
+template <int CAPACITY>
+class SnapshotPlatforms
+{
+private:
+    ColliderBox m_boxes[CAPACITY];
+    int         m_count = 0;
+
+public:
+    bool resize(int count)
+    {
+        if (count > CAPACITY) return false;
+        m_count = count;
+        return true;
+    };
+
+    ColliderBox*       data()       { return m_boxes; };
+    const ColliderBox* data() const { return m_boxes; };
+    int const get_count() const { return m_count; };
+};
+
+template <>
+class SnapshotPlatforms<0>
+{
+private:
+    std::vector<ColliderBox> m_boxes;
+
+public:
+    bool resize(int count)
+    {
+        m_boxes.resize(count);
+        return true;
+    };
+
+    ColliderBox*       data()       { return m_boxes.data(); };
+    const ColliderBox* data() const { return m_boxes.data(); };
+    int const get_count() const { return (int)m_boxes.size(); };
+};
+
+// All of the simulation state as plain data: copy it with = to branch a world, rewind it, or
+// restart a level. Only the landers' full bodies are kept; platforms keep just what collision and
+// win/loss read, since nothing else about them changes during a level.
+struct SimulationSnapshot
+{
+    static const int MAX_LANDERS = 8;   // besides the player
+
+    BodyState                                    player;
+    SnapshotPlatforms<LANDER_SNAPSHOT_PLATFORMS> platforms;
+
+    BodyState     landers[MAX_LANDERS];
+    LanderOutcome lander_outcomes[MAX_LANDERS];
+    int           lander_count;
+
+    bool     win, loss;
+    int64_t  tick_accumulator;
+    uint64_t step_hash;
+};
+
+static_assert(LANDER_SNAPSHOT_PLATFORMS == 0 || std::is_trivially_copyable<SimulationSnapshot>::value,
+              "fixed-capacity snapshots must stay memcpy-able");
+
+// Physical properties of the lander; textures and animation are left to the caller
+void setup_player(Entity* player);
+
+// setup_player's properties and the gravity reset_lander gives, put back on a lander mid-flight
+// without moving it, e.g. after a new gameplay module changes them
+void retune_lander(Entity& lander);
+
+// Back to the spawn point at rest, with the previous episode's outcome cleared; every lander
+// starts from the same spot
+void reset_episode(GameState& state);
+// Just the one lander, for one joining an episode already under way; outcomes are the caller's
+void reset_lander(Entity& lander, glm::vec3 spawn_position, float gravity = ACC_OF_GRAVITY);
+
+// The player and then state.landers, as one list
+int           get_lander_count(const GameState& state);
+Entity*       get_lander(GameState& state, int index);
+LanderOutcome get_lander_outcome(const GameState& state, int index);
+void          set_lander_outcome(GameState& state, int index, const LanderOutcome& outcome);
+
+// Folds the LANDED and CRASHED events from index `first` on into `outcome`; once set, a flag
+// stays set until whoever owns the outcome clears it
+void add_outcome_events(const GameEventBuffer& events, int first, LanderOutcome& outcome);
+
+// Random WIN/DEATH static platforms along the ground, one per unit from x = -4. Drawn from Rng,
+// so a seed is the same level everywhere
+void generate_platforms(Entity* platforms, int platform_count, unsigned int seed);
+
+// One step of FIXED_TIMESTEP, or of a larger delta_time for fast-forwarding. Steps much longer
+// than FIXED_TIMESTEP should turn on the player's m_continuous_collision to avoid tunnelling.
+void step_simulation(GameState& state, float delta_time = FIXED_TIMESTEP);
+
+// Brings the colliders' and the broadphase's copies of the movers up to where the platforms are,
+// as step_simulation does before it collides anything
+void sync_movers(GameState& state);
+
+// ————— INTEGRATORS ————— //
+// "euler", "semi-implicit" or "verlet"
+const char* get_integrator_name(Integrator integrator);
+bool        parse_integrator(const char* name, Integrator& integrator);
+
+// The longest step, up to max_timestep, that `integrator` can take and still fly the lander as it
+// flies at FIXED_TIMESTEP. EXPLICIT_EULER's booster kicks once a step, so it has to stay at
+// FIXED_TIMESTEP. The other two treat every force as a rate, and this model's forces (constant
+// gravity and thrust, drag that stops at rest) can't make them blow up at any step length, so
+// they get the largest whole number of FIXED_TIMESTEPs that fits: inputs sampled at 60 Hz still
+// land on step boundaries, and VELOCITY_VERLET, exact for such forces, traces the same path.
+float get_stable_timestep(Integrator integrator, float max_timestep);
+
+// Puts every lander onto `integrator` and state.fixed_timestep onto get_stable_timestep. Longer
+// steps can't tunnel: the rate integrators sweep any move over half the lander's size.
+void set_integrator(GameState& state, Integrator integrator, float max_timestep = FIXED_TIMESTEP);
+
+// FNV-1a over the exact bits of every lander's physics state and outcome. Chain episodes or
+// steps by passing the previous result back in as `hash`. Only meaningful across machines in
+// LANDER_FIXED_POINT builds; float builds may legitimately differ.
+uint32_t checksum_state(const GameState& state, uint32_t hash = 2166136261u);
+
+// xxHash64 (StateHash.h) over the same bits, chained onto `previous`: what step_simulation keeps
+// in state.step_hash. Around 10 ns for a lone lander, a quarter of the cheapest step there is.
+uint64_t hash_step_state(const GameState& state, uint64_t previous = 0);
+
+// Returns false, leaving the snapshot alone, for races over MAX_LANDERS extra landers or, in
+// builds with a LANDER_SNAPSHOT_PLATFORMS capacity, levels over it
+bool save_snapshot(const GameState& state, SimulationSnapshot& snapshot);
+
+// Into the same level it was saved from: the platform and lander counts have to match.
+// Broadphases built over the platforms stay valid as long as static ones are restored to where
+// they were filed.
+void restore_snapshot(GameState& state, const SimulationSnapshot& snapshot);
+
+// Rounded to the nearest tick
+int64_t seconds_to_ticks(double seconds);
+
+// Feeds real elapsed time through the accumulator; returns how many fixed steps ran. frame_time
+// is the real time at the end of the elapsed time, which is only used to tell before_step when
+// each step starts. Callers with an integer clock should pass its ticks straight through
+// advance_simulation_ticks, so nothing is rounded away frame after frame.
+int  advance_simulation(GameState& state, float delta_time, double frame_time = 0.0);
+int  advance_simulation_ticks(GameState& state, int64_t elapsed_ticks, double frame_time = 0.0);
+
+// How far the accumulator is into the next step, 0 to 1; pass it to Entity::render
+float interpolation_alpha(const GameState& state);
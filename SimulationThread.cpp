@@ -0,0 +1,100 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "SimulationThread.h"
+#include "Trace.h"
+
+typedef std::chrono::steady_clock Clock;
+
+void SimulationThread::start(GameState* state, InputHandler apply_input, StepHandler on_steps)
+{
+    stop();
+
+    m_state = state;
+    m_apply_input = apply_input;
+    m_on_steps = on_steps;
+    m_total_steps = 0;
+
+    // Nothing else touches the buffer yet, so this is safe to do from here
+    publish(Clock::now());
+    m_snapshots.update();
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop()
+{
+    if (!m_thread.joinable()) return;
+
+    m_running.store(false, std::memory_order_release);
+    m_thread.join();
+}
+
+void SimulationThread::publish(Clock::time_point now)
+{
+    RenderSnapshot& snapshot = m_snapshots.get_back();
+    m_state->player->save_state(snapshot.player);
+    snapshot.win              = m_state->win;
+    snapshot.loss             = m_state->loss;
+    snapshot.total_steps      = m_total_steps;
+    snapshot.time_accumulator = m_state->time_accumulator;
+    snapshot.fixed_timestep   = m_state->fixed_timestep;
+    snapshot.budget           = m_state->budget;
+    snapshot.timings          = m_state->timings;
+    snapshot.stepped_at       = now;
+    m_snapshots.publish();
+}
+
+void SimulationThread::run()
+{
+    Clock::time_point last = Clock::now();
+
+    while (m_running.load(std::memory_order_acquire))
+    {
+        // STEP 1: However many steps the time since the last pass adds up to, under the newest input
+        // In whole nanoseconds, so no step is ever lost to rounding however long the thread runs
+        Clock::time_point now = Clock::now();
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        last = now;
+
+        if (!m_state->win && !m_state->loss)
+        {
+            TRACE_ZONE("simulation thread");
+            int input = m_input.load(std::memory_order_acquire);
+            m_apply_input(*m_state, input);
+
+            int steps = advance_simulation_ticks(*m_state, elapsed, std::chrono::duration<double>(now.time_since_epoch()).count());
+            m_total_steps += steps;
+            if (m_on_steps != NULL) m_on_steps(*m_state, input, steps);
+        }
+
+        // STEP 2: Hand the result over, then wait until the accumulator has another whole step in it
+        publish(now);
+
+        Clock::time_point due = now + std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(
+            std::max(seconds_to_ticks(m_state->fixed_timestep) - m_state->tick_accumulator, (int64_t)0)));
+        Clock::time_point sleep_until = due - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(SPIN_SECONDS));
+
+        if (Clock::now() < sleep_until) std::this_thread::sleep_until(sleep_until);
+        while (Clock::now() < due && m_running.load(std::memory_order_relaxed)) std::this_thread::yield();
+    }
+}
+
+float SimulationThread::get_interpolation_alpha() const
+{
+    const RenderSnapshot& snapshot = get_snapshot();
+    if (snapshot.win || snapshot.loss) return 1.0f;
+
+    float since = std::chrono::duration<float>(Clock::now() - snapshot.stepped_at).count();
+    return std::min(std::max((snapshot.time_accumulator + since) / snapshot.fixed_timestep, 0.0f), 1.0f);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Runs the simulation on a thread of its own at the fixed timestep, so a slow frame or a long
+// swap never holds up physics and a burst of steps never holds up a frame. The game thread
+// hands it input through one atomic and draws from RenderSnapshots it publishes through a
+// TripleBuffer; neither side ever waits on the other.
+//
+// The steps are timed on std::chrono::steady_clock, in seconds since its epoch: that's the
+// frame_time a GameState's before_step sees.
+//
+// While the thread runs it owns the GameState outright. Anything else that changes the state
+// (a new level, a replay) has to stop() it first and start() it again afterwards.
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// What the game thread draws a frame from, copied out after every pass of steps
+struct RenderSnapshot
+{
+    BodyState   player;
+    bool        win  = false,
+                loss = false;
+    long long   total_steps = 0;  // since start(), so a frame can tell how many it covered
+    float       time_accumulator = 0.0f,
+                fixed_timestep   = FIXED_TIMESTEP;
+    StepBudget  budget;
+    StepTimings timings;
+    std::chrono::steady_clock::time_point stepped_at;  // for interpolating on past the last step
+};
+
+class SimulationThread
+{
+public:
+    // On the simulation thread: puts `input` (whatever the game publishes) onto the player
+    // before each pass, and sees each pass's steps afterwards
+    typedef void (*InputHandler)(GameState& state, int input);
+    typedef void (*StepHandler)(const GameState& state, int input, int steps);
+
+private:
+    // The last stretch of each wait is spun, since a sleep can overshoot by a millisecond or more
+    static constexpr double SPIN_SECONDS = 0.001;
+
+    GameState*                 m_state = NULL;
+    InputHandler               m_apply_input = NULL;
+    StepHandler                m_on_steps = NULL;
+    std::thread                m_thread;
+    std::atomic<bool>          m_running{ false };
+    std::atomic<int>           m_input{ 0 };
+    long long                  m_total_steps = 0;
+    TripleBuffer<RenderSnapshot> m_snapshots;
+
+    void run();
+    void publish(std::chrono::steady_clock::time_point now);
+
+public:
+    ~SimulationThread() { stop(); };
+
+    // Publishes the state as it stands before the thread takes it, so get_snapshot() is current
+    // straight away. on_steps may be NULL.
+    void start(GameState* state, InputHandler apply_input, StepHandler on_steps);
+    // Waits for the pass in progress, at most a step's worth of work
+    void stop();
+
+    // Game thread: the newest input, picked up at the start of the next pass
+    void set_input(int input) { m_input.store(input, std::memory_order_release); };
+
+    // Game thread: swaps in the newest snapshot if there is one; returns whether there was
+    bool update_snapshot() { return m_snapshots.update(); };
+    const RenderSnapshot& get_snapshot() const { return m_snapshots.get_front(); };
+
+    // How far past the snapshot's last step it is now, 0 to 1; pass it to Entity::render
+    float get_interpolation_alpha() const;
+
+    bool const is_running() const { return m_thread.joinable(); };
+};
@@ -0,0 +1,133 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cmath>
+#include "Rng.h"
+#include "SoundSynth.h"
+
+const float TWO_PI = 6.2831853f;
+const unsigned int THRUST_SEED = 1,
+                   THUD_SEED   = 2,
+                   CRASH_SEED  = 3;
+
+// One-pole low-pass coefficient for a cutoff in Hz
+static float low_pass_coefficient(float cutoff, int sample_rate)
+{
+    return 1.0f - std::exp(-TWO_PI * cutoff / (float)sample_rate);
+}
+
+// Scaled so the loudest sample sits at `peak`
+static void normalise(std::vector<float>& samples, float peak)
+{
+    float loudest = 0.0f;
+    for (float sample : samples) loudest = std::max(loudest, std::fabs(sample));
+    if (loudest <= 0.0f) return;
+
+    for (float& sample : samples) sample *= peak / loudest;
+}
+
+std::vector<float> synthesize_thrust(int sample_rate)
+{
+    const int length = sample_rate,
+              fade   = sample_rate / 10;
+    const float coefficient = low_pass_coefficient(400.0f, sample_rate);
+
+    // Noise through two low-pass poles: a rumble rather than a hiss
+    Rng rng(THRUST_SEED);
+    std::vector<float> noise(length + fade);
+    float low = 0.0f, lower = 0.0f;
+    for (float& sample : noise)
+    {
+        low   += (rng.next_float() * 2.0f - 1.0f - low) * coefficient;
+        lower += (low - lower) * coefficient;
+        sample = lower;
+    }
+
+    // The extra tail is faded in over the head, so the last sample runs straight on into the first
+    std::vector<float> samples(noise.begin(), noise.begin() + length);
+    for (int i = 0; i < fade; i++)
+    {
+        float t = (float)i / (float)fade;
+        samples[i] = noise[i] * t + noise[length + i] * (1.0f - t);
+    }
+
+    normalise(samples, 0.5f);
+    return samples;
+}
+
+std::vector<float> synthesize_thud(int sample_rate)
+{
+    const int length = sample_rate / 4;
+    const float coefficient = low_pass_coefficient(200.0f, sample_rate);
+
+    // A low sine sagging in pitch, with a little muffled noise for the impact
+    Rng rng(THUD_SEED);
+    std::vector<float> samples(length);
+    float phase = 0.0f, low = 0.0f;
+    for (int i = 0; i < length; i++)
+    {
+        float t = (float)i / (float)sample_rate;
+        phase += TWO_PI * (40.0f + 30.0f * std::exp(-t * 20.0f)) / (float)sample_rate;
+        low += (rng.next_float() * 2.0f - 1.0f - low) * coefficient;
+
+        samples[i] = (std::sin(phase) + low) * std::exp(-t * 18.0f);
+    }
+
+    normalise(samples, 0.8f);
+    return samples;
+}
+
+std::vector<float> synthesize_chime(int sample_rate)
+{
+    const float notes[] = { 523.25f, 659.25f, 783.99f };  // C5, E5, G5
+    const float note_gap = 0.15f,
+                note_length = 0.6f;
+
+    const int length = (int)((note_gap * 2.0f + note_length) * sample_rate);
+    std::vector<float> samples(length, 0.0f);
+
+    for (int note = 0; note < 3; note++)
+    {
+        int start = (int)(note_gap * note * sample_rate);
+        for (int i = start; i < length; i++)
+        {
+            float t = (float)(i - start) / (float)sample_rate;
+            samples[i] += std::sin(TWO_PI * notes[note] * t) * std::exp(-t * 6.0f);
+        }
+    }
+
+    normalise(samples, 0.6f);
+    return samples;
+}
+
+std::vector<float> synthesize_crash(int sample_rate)
+{
+    const int length = sample_rate * 6 / 5;
+    const float bright = low_pass_coefficient(1500.0f, sample_rate),
+                dark   = low_pass_coefficient(150.0f, sample_rate);
+
+    // Debris on top of a rumble, the debris dying away faster
+    Rng rng(CRASH_SEED);
+    std::vector<float> samples(length);
+    float debris = 0.0f, rumble = 0.0f;
+    for (int i = 0; i < length; i++)
+    {
+        float t = (float)i / (float)sample_rate,
+              white = rng.next_float() * 2.0f - 1.0f;
+        debris += (white - debris) * bright;
+        rumble += (white - rumble) * dark;
+
+        samples[i] = debris * std::exp(-t * 5.0f) + 3.0f * rumble * std::exp(-t * 2.5f);
+    }
+
+    normalise(samples, 0.9f);
+    return samples;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+// The game's sounds, built from noise and sine waves at whatever rate the audio device runs at,
+// for when there are no recorded ones in assets/. Noise comes from Rng, so every run sounds the same.
+#include <vector>
+
+// A second of rumble that loops without a seam; its gain follows the booster
+std::vector<float> synthesize_thrust(int sample_rate);
+// A short low knock, for touching down
+std::vector<float> synthesize_thud(int sample_rate);
+// Three rising notes, for a safe landing
+std::vector<float> synthesize_chime(int sample_rate);
+// A long noise burst dying away, for a crash
+std::vector<float> synthesize_crash(int sample_rate);
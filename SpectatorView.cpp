@@ -0,0 +1,148 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "GLCallCounter.h"
+#include "GLCapabilities.h"
+#include "SpectatorView.h"
+
+bool SpectatorView::initialise(SDL_Window* main_window, ShaderVariants* shaders, float zoom)
+{
+    if (!supports_framebuffer_objects()) return false;
+
+    m_main_window = main_window;
+    m_main_context = SDL_GL_GetCurrentContext();
+    m_shaders = shaders;
+    m_zoom = zoom;
+
+    // STEP 1: A whole second display if there is one, so it can face the audience
+    int width = 0, height = 0;
+    SDL_GetWindowSize(main_window, &width, &height);
+    Uint32 flags = SDL_WINDOW_OPENGL;
+    int x = SDL_WINDOWPOS_CENTERED, y = SDL_WINDOWPOS_CENTERED;
+
+    SDL_DisplayMode mode;
+    if (SDL_GetNumVideoDisplays() > 1 && SDL_GetDesktopDisplayMode(1, &mode) == 0)
+    {
+        width = mode.w;
+        height = mode.h;
+        x = y = SDL_WINDOWPOS_CENTERED_DISPLAY(1);
+        flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
+    }
+
+    // STEP 2: The scene's texture belongs to the game's context, which is still current
+    if (!m_target.initialise(width, height, true)) return false;
+
+    m_window = SDL_CreateWindow("Lunar Lander (spectator)", x, y, width, height, flags);
+    if (m_window == NULL)
+    {
+        cleanup();
+        return false;
+    }
+
+    // STEP 3: The same attributes as the game's context, plus sharing with it; creating the
+    //         context makes it current
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
+    m_context = SDL_GL_CreateContext(m_window);
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+    if (m_context == NULL)
+    {
+        SDL_GL_MakeCurrent(m_main_window, m_main_context);
+        cleanup();
+        return false;
+    }
+    SDL_GL_SetSwapInterval(0);
+
+    // STEP 4: Framebuffers aren't shared, so this context reads the texture through its own
+    glGenFramebuffers(1, &m_read_framebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_read_framebuffer);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_target.get_texture_id(), 0);
+    bool complete = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    SDL_GL_MakeCurrent(m_main_window, m_main_context);
+    if (!complete)
+    {
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void SpectatorView::cleanup()
+{
+    if (m_context != NULL)
+    {
+        SDL_GL_MakeCurrent(m_window, m_context);
+        if (m_read_framebuffer != 0) glDeleteFramebuffers(1, &m_read_framebuffer);
+        SDL_GL_MakeCurrent(m_main_window, m_main_context);
+        SDL_GL_DeleteContext(m_context);
+    }
+    if (m_window != NULL) SDL_DestroyWindow(m_window);
+    m_target.cleanup();
+
+    m_window = NULL;
+    m_context = NULL;
+    m_read_framebuffer = 0;
+}
+
+glm::mat4 SpectatorView::get_projection_matrix(const glm::mat4& main_projection) const
+{
+    // Clip space is scaled rather than the ortho rebuilt, so any projection the game uses works
+    int main_width = 0, main_height = 0;
+    SDL_GetWindowSize(m_main_window, &main_width, &main_height);
+    float main_aspect = (float)main_width / (float)main_height,
+          aspect      = (float)m_target.get_width() / (float)m_target.get_height();
+
+    return glm::scale(glm::mat4(1.0f), glm::vec3(main_aspect / aspect / m_zoom, 1.0f / m_zoom, 1.0f)) * main_projection;
+}
+
+void SpectatorView::begin_scene(const glm::mat4& main_projection, const glm::mat4& view_matrix)
+{
+    m_projection_matrix = m_shaders->get_projection_matrix();
+    m_view_matrix = m_shaders->get_view_matrix();
+    glGetIntegerv(GL_VIEWPORT, m_viewport);
+
+    m_target.bind();
+    glViewport(0, 0, m_target.get_width(), m_target.get_height());
+    glClear(GL_COLOR_BUFFER_BIT);
+    m_shaders->set_camera(get_projection_matrix(main_projection), view_matrix);
+}
+
+void SpectatorView::end_scene()
+{
+    m_shaders->set_camera(m_projection_matrix, m_view_matrix);
+    m_target.unbind();
+    glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+}
+
+void SpectatorView::present()
+{
+    if (m_context == NULL) return;
+
+    // STEP 1: The other context only sees the scene once the game's has submitted it
+    glFlush();
+    SDL_GL_MakeCurrent(m_window, m_context);
+
+    // STEP 2: Texture to window, the same size, so nothing is filtered
+    int width = m_target.get_width(), height = m_target.get_height();
+    count_gl_call(GL_CALL_BIND, 3);
+    count_gl_call(GL_CALL_DRAW);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_read_framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    SDL_GL_SwapWindow(m_window);
+    SDL_GL_MakeCurrent(m_main_window, m_main_context);
+    m_presented++;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+// A second window showing the same world from further out, e.g. on the monitor the audience
+// watches at events. Its GL context is created sharing objects with the game's, so textures,
+// buffers and shaders are uploaded once and drawn from both; what a context can't share (vertex
+// arrays and framebuffers) never has to cross over, because the view is drawn in the game's
+// context, into a sampled OffscreenTarget, by flushing the frame's RenderQueue a second time under
+// a zoomed-out camera. After the game's swap the spectator's context only blits that texture into
+// its window, through a framebuffer of its own, and swaps.
+//
+// The spectator never waits for vsync: the game's swap paces the loop, and the blit is the only
+// thing the second context adds to a frame.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "OffscreenTarget.h"
+#include "ShaderVariants.h"
+
+class SpectatorView
+{
+private:
+    SDL_Window*   m_window = NULL;
+    SDL_GLContext m_context = NULL;
+    SDL_Window*   m_main_window = NULL;  // made current again after every visit to m_context
+    SDL_GLContext m_main_context = NULL;
+
+    OffscreenTarget m_target;            // the game's context: drawn into, sampled by the blit
+    GLuint          m_read_framebuffer = 0;  // the spectator's context, around m_target's texture
+    ShaderVariants* m_shaders = NULL;
+    float           m_zoom = 1.0f;
+
+    // Restored by end_scene
+    glm::mat4 m_projection_matrix,
+              m_view_matrix;
+    GLint     m_viewport[4] = {};
+
+    int m_presented = 0;
+
+public:
+    SpectatorView() = default;
+    SpectatorView(const SpectatorView&) = delete;
+    SpectatorView& operator=(const SpectatorView&) = delete;
+    ~SpectatorView() { cleanup(); }
+
+    // With the game's context current, which it is again on return. Fills the second display if
+    // there is one, or opens a window the size of the game's. `zoom` is how many times more of the
+    // world it shows across. False, with nothing open, without framebuffer objects or blits, or if
+    // the driver won't share a context.
+    bool initialise(SDL_Window* main_window, ShaderVariants* shaders, float zoom);
+    void cleanup();
+
+    // The game's camera, scaled out by the zoom and corrected for the spectator's aspect
+    glm::mat4 get_projection_matrix(const glm::mat4& main_projection) const;
+
+    // Around a second flush of the world, after the game's own. The variants' camera, the
+    // viewport and the framebuffer are the game's again after end_scene.
+    void begin_scene(const glm::mat4& main_projection, const glm::mat4& view_matrix);
+    void end_scene();
+
+    // After the game's swap: shows the last scene in the spectator's window
+    void present();
+
+    bool  const is_open()             const { return m_context != NULL; };
+    float const get_zoom()            const { return m_zoom; };
+    int   const get_width()           const { return m_target.get_width(); };
+    int   const get_height()          const { return m_target.get_height(); };
+    int   const get_presented_count() const { return m_presented; };
+};
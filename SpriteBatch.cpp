@@ -0,0 +1,258 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cfloat>
+#include "SpriteBatch.h"
+#include "Trace.h"
+
+void SpriteBatch::initialise(ShaderProgram* program, FrameArena* frame_arena)
+{
+    m_frame_arena = frame_arena;
+    m_backend = get_render_backend();
+
+    m_vertices.initialise(GL_ARRAY_BUFFER, (size_t)INITIAL_CAPACITY * VERTICES_PER_QUAD * FLOATS_PER_VERTEX * sizeof(float));
+    get_pipeline(program, true);
+    reserve(INITIAL_CAPACITY);
+}
+
+void SpriteBatch::cleanup()
+{
+    for (BatchPipeline& entry : m_pipelines) m_backend->delete_pipeline(entry.pipeline);
+    m_pipelines.clear();
+
+    m_vertices.cleanup();
+    if (m_index_buffer != 0) m_backend->delete_buffer(m_index_buffer);
+
+    m_index_buffer = 0;
+    m_capacity = 0;
+}
+
+const Pipeline& SpriteBatch::get_pipeline(ShaderProgram* program, bool packed)
+{
+    for (const BatchPipeline& entry : m_pipelines)
+    {
+        if (entry.program == program && entry.packed == packed) return entry.pipeline;
+    }
+
+    // Position, UV and layer interleaved; programs without a layer attribute skip it
+    bool layered = program->get_layer_attribute() >= 0;
+    VertexLayout layout;
+    if (packed)
+    {
+        layout.stride = layered ? sizeof(PackedLayeredVertex) : sizeof(PackedVertex);
+        layout.add(program->get_position_attribute(), 2, offsetof(PackedVertex, x), GL_SHORT)
+              .add(program->get_tex_coordinate_attribute(), 2, offsetof(PackedVertex, u), GL_UNSIGNED_SHORT, true)
+              .add(program->get_layer_attribute(), 1, offsetof(PackedLayeredVertex, layer), GL_UNSIGNED_SHORT);
+    }
+    else
+    {
+        layout.stride = FLOATS_PER_VERTEX * sizeof(float);
+        layout.add(program->get_position_attribute(), 2, 0)
+              .add(program->get_tex_coordinate_attribute(), 2, 2 * sizeof(float))
+              .add(program->get_layer_attribute(), 1, 4 * sizeof(float));
+    }
+
+    m_pipelines.push_back({ program, packed, Pipeline() });
+    m_backend->create_pipeline(m_pipelines.back().pipeline, program, layout);
+    return m_pipelines.back().pipeline;
+}
+
+// The four corners of every quad, in `order`, as packed vertices in steps of `step` from `centre`
+template <typename Vertex>
+static void write_packed_quads(const std::vector<SpriteQuad>& quads, const FrameVector<int>& order, glm::vec2 centre, glm::vec2 step, Vertex* vertex)
+{
+    auto position = [](float value, float centre, float step)
+        {
+            float steps = std::min(std::max((value - centre) / step, -32767.0f), 32767.0f);
+            return (int16_t)std::floor(steps + 0.5f);
+        };
+    auto coordinate = [](float value) { return (uint16_t)(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f); };
+
+    for (int index : order)
+    {
+        const SpriteQuad& quad = quads[index];
+
+        int16_t left   = position(quad.position.x - quad.size.x / 2.0f, centre.x, step.x),
+                right  = position(quad.position.x + quad.size.x / 2.0f, centre.x, step.x),
+                bottom = position(quad.position.y - quad.size.y / 2.0f, centre.y, step.y),
+                top    = position(quad.position.y + quad.size.y / 2.0f, centre.y, step.y);
+
+        uint16_t u_left   = coordinate(quad.uv_rect.x),
+                 u_right  = coordinate(quad.uv_rect.x + quad.uv_rect.z),
+                 v_top    = coordinate(quad.uv_rect.y),
+                 v_bottom = coordinate(quad.uv_rect.y + quad.uv_rect.w);
+
+        vertex[0] = Vertex{ left,  bottom, u_left,  v_bottom };
+        vertex[1] = Vertex{ right, bottom, u_right, v_bottom };
+        vertex[2] = Vertex{ right, top,    u_right, v_top };
+        vertex[3] = Vertex{ left,  top,    u_left,  v_top };
+        vertex += 4;
+    }
+}
+
+void SpriteBatch::reserve(int quad_count)
+{
+    if (quad_count <= m_capacity) return;
+
+    // Grow geometrically so that a growing scene only reallocates a handful of times
+    m_capacity = std::max(quad_count, std::max(m_capacity * 2, (int)INITIAL_CAPACITY));
+
+    // The index pattern never changes, so it is written once per capacity and stays on the GPU
+    std::vector<GLuint> indices(m_capacity * INDICES_PER_QUAD);
+    for (int i = 0; i < m_capacity; i++)
+    {
+        GLuint first = i * VERTICES_PER_QUAD;
+        GLuint quad_indices[] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+        std::copy(std::begin(quad_indices), std::end(quad_indices), indices.begin() + i * INDICES_PER_QUAD);
+    }
+
+    if (m_index_buffer != 0) m_backend->delete_buffer(m_index_buffer);
+    m_index_buffer = m_backend->create_buffer(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+}
+
+void SpriteBatch::warm_up(PipelineWarmup& warmup, ShaderProgram* program)
+{
+    // One at a time: making the second can move the first
+    warmup.warm_up(get_pipeline(program, false));
+    warmup.warm_up(get_pipeline(program, true));
+}
+
+void SpriteBatch::begin()
+{
+    // Keep the capacity around so steady-state frames don't reallocate
+    m_quads.clear();
+    m_draw_calls = 0;
+}
+
+void SpriteBatch::submit(glm::vec2 position, glm::vec2 size, glm::vec4 uv_rect, GLuint texture_id, float layer)
+{
+    m_quads.push_back({ position, size, uv_rect, texture_id, layer });
+}
+
+void SpriteBatch::submit(const SpriteQuad* quads, int count)
+{
+    m_quads.insert(m_quads.end(), quads, quads + count);
+}
+
+void SpriteBatch::flush(ShaderProgram* program, GLenum texture_target)
+{
+    if (m_quads.empty()) return;
+    TRACE_ZONE("SpriteBatch::flush");
+
+    // STEP 1: Group the quads by texture so that each texture is bound exactly once.
+    //         Ties go by index, which keeps the submission order inside every group.
+    FrameVector<int> order(m_quads.size(), 0, ArenaAllocator<int>(m_frame_arena));
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+
+    std::sort(order.begin(), order.end(), [this](int a, int b)
+        {
+            if (m_quads[a].texture_id != m_quads[b].texture_id) return m_quads[a].texture_id < m_quads[b].texture_id;
+            return a < b;
+        });
+
+    // STEP 2: Find the box the batch covers. Anything narrow enough (i.e. whatever survived the
+    //         queue's culling) goes out packed, in 16-bit steps across that box.
+    glm::vec2 low = glm::vec2(FLT_MAX), high = glm::vec2(-FLT_MAX);
+    for (const SpriteQuad& quad : m_quads)
+    {
+        low  = glm::min(low, quad.position - quad.size / 2.0f);
+        high = glm::max(high, quad.position + quad.size / 2.0f);
+    }
+
+    bool packed = std::max(high.x - low.x, high.y - low.y) <= MAX_PACKED_EXTENT,
+         layered = program->get_layer_attribute() >= 0;
+    glm::vec2 centre = (low + high) / 2.0f,
+              step   = glm::max((high - low) / 2.0f, glm::vec2(FLT_MIN)) / 32767.0f;
+
+    // STEP 3: Expand every quad into four corners, interleaving position, UV and layer, straight
+    //         into the memory the draw reads
+    reserve((int)m_quads.size());
+    size_t vertex_size = packed ? (layered ? sizeof(PackedLayeredVertex) : sizeof(PackedVertex)) : FLOATS_PER_VERTEX * sizeof(float);
+    m_vertex_bytes = m_quads.size() * VERTICES_PER_QUAD * vertex_size;
+    void* vertices = m_vertices.write(m_vertex_bytes);
+
+    if (packed && layered)
+    {
+        write_packed_quads(m_quads, order, centre, step, (PackedLayeredVertex*)vertices);
+
+        // The layers are whole numbers, so they go in as they are
+        PackedLayeredVertex* vertex = (PackedLayeredVertex*)vertices;
+        for (int index : order)
+        {
+            for (int corner = 0; corner < VERTICES_PER_QUAD; corner++) (vertex++)->layer = (uint16_t)m_quads[index].layer;
+        }
+    }
+    else if (packed) write_packed_quads(m_quads, order, centre, step, (PackedVertex*)vertices);
+    else
+    {
+        float* vertex = (float*)vertices;
+        for (int index : order)
+        {
+            const SpriteQuad& quad = m_quads[index];
+
+            float left   = quad.position.x - quad.size.x / 2.0f,
+                  right  = quad.position.x + quad.size.x / 2.0f,
+                  bottom = quad.position.y - quad.size.y / 2.0f,
+                  top    = quad.position.y + quad.size.y / 2.0f;
+
+            float u_left   = quad.uv_rect.x,
+                  u_right  = quad.uv_rect.x + quad.uv_rect.z,
+                  v_top    = quad.uv_rect.y,
+                  v_bottom = quad.uv_rect.y + quad.uv_rect.w;
+
+            float corners[] =
+            {
+                left,  bottom, u_left,  v_bottom, quad.layer,
+                right, bottom, u_right, v_bottom, quad.layer,
+                right, top,    u_right, v_top,    quad.layer,
+                left,  top,    u_left,  v_top,    quad.layer
+            };
+
+            std::copy(std::begin(corners), std::end(corners), vertex);
+            vertex += VERTICES_PER_QUAD * FLOATS_PER_VERTEX;
+        }
+    }
+
+    // STEP 4: Hand the frame's vertices over in one go: nothing to do with a persistent mapping,
+    //         one orphaning upload without, and the draw never waits on last frame's either way
+    size_t offset = m_vertices.commit();
+
+    // STEP 5: One model transform serves the whole batch: the identity for world-space floats, or
+    //         back out of the packed box. begin_draws makes the program current, which the cached
+    //         transform setter relies on.
+    ModelTransform model_transform;
+    if (packed) model_transform = ModelTransform::make(centre, 0.0f, step);
+
+    m_backend->begin_draws(get_pipeline(program, packed), m_vertices.get_buffer(), offset, m_index_buffer);
+    program->set_model_transform(model_transform);
+
+    // STEP 6: One draw call per run of quads that share a texture
+    size_t run_start = 0;
+    while (run_start < m_quads.size())
+    {
+        GLuint texture_id = m_quads[order[run_start]].texture_id;
+        size_t run_end = run_start;
+        while (run_end < order.size() && m_quads[order[run_end]].texture_id == texture_id) run_end++;
+
+        m_backend->bind_texture(texture_target, texture_id);
+        m_backend->draw_indexed_triangles((int)(run_start * INDICES_PER_QUAD), (int)((run_end - run_start) * INDICES_PER_QUAD));
+        m_draw_calls++;
+
+        run_start = run_end;
+    }
+
+    // Leave the attribute state clean for the renderers still drawing with GL directly
+    m_backend->end_draws();
+
+    m_quads.clear();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <cstdint>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ArenaAllocator.h"
+#include "PipelineWarmup.h"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+#include "StreamBuffer.h"
+
+struct SpriteQuad
+{
+    glm::vec2 position;
+    glm::vec2 size;
+    glm::vec4 uv_rect; // u, v, width, height in the UV-plane
+    GLuint    texture_id;
+    float     layer = 0.0f; // for texture arrays (TextureArray.h); ignored by 2D textures
+};
+
+// The layer a SHADER_GLYPHS program reads as "this quad is a distance-field glyph"
+const float GLYPH_QUAD_LAYER = 1.0f;
+
+class SpriteBatch
+{
+private:
+    static const int FLOATS_PER_VERTEX  = 5,  // x, y, u, v, layer
+                     VERTICES_PER_QUAD  = 4,
+                     INDICES_PER_QUAD   = 6,
+                     INITIAL_CAPACITY   = 64; // quads
+
+    // Batches up to this wide go out packed: a 16-bit step across it is under a thousandth of a
+    // unit, far below a pixel at any zoom the game uses. Anything wider stays in floats.
+    static constexpr float MAX_PACKED_EXTENT = 64.0f;
+
+    // Positions in steps across the batch's own box, which the model matrix maps back into the
+    // world, and UVs normalised to 16 bits: 8 bytes a vertex against 20. The layer only goes in
+    // for programs that read one.
+    struct PackedVertex
+    {
+        int16_t  x, y;
+        uint16_t u, v;
+    };
+
+    struct PackedLayeredVertex
+    {
+        int16_t  x, y;
+        uint16_t u, v, layer, padding;
+    };
+
+    struct BatchPipeline
+    {
+        ShaderProgram* program;
+        bool           packed;
+        Pipeline       pipeline;
+    };
+
+    // Reused across batches; the per-flush order and vertices come from the frame arena
+    std::vector<SpriteQuad> m_quads;
+    FrameArena*             m_frame_arena = NULL;
+
+    // ————— GPU BUFFERS ————— //
+    // Created once by initialise() and only ever grown, never re-created per frame. The vertices
+    // are built straight into the stream buffer; the index pattern never changes.
+    RenderBackend* m_backend = NULL;
+    StreamBuffer   m_vertices;
+    GLuint m_index_buffer   = 0;
+    int    m_capacity       = 0;  // quads the index buffer covers
+
+    // One per program and vertex format flushed with so far; the layered program reads an extra attribute
+    std::vector<BatchPipeline> m_pipelines;
+
+    int    m_draw_calls   = 0;
+    size_t m_vertex_bytes = 0;  // written by the last flush
+
+    void reserve(int quad_count);
+    const Pipeline& get_pipeline(ShaderProgram* program, bool packed);
+
+public:
+    void initialise(ShaderProgram* program, FrameArena* frame_arena);
+    void cleanup();
+
+    void begin();
+    void submit(glm::vec2 position, glm::vec2 size, glm::vec4 uv_rect, GLuint texture_id, float layer = 0.0f);
+    void submit(const SpriteQuad* quads, int count);
+    // GL_TEXTURE_2D_ARRAY for a SHADER_LAYERED program, whose texture ids are arrays
+    void flush(ShaderProgram* program, GLenum texture_target = GL_TEXTURE_2D);
+
+    // Makes and draws both of `program`'s pipelines, packed and not, so its first flush is cheap
+    void warm_up(PipelineWarmup& warmup, ShaderProgram* program);
+
+    int    const get_quad_count()   const { return (int)m_quads.size(); };
+    int    const get_draw_calls()   const { return m_draw_calls; };
+    size_t const get_vertex_bytes() const { return m_vertex_bytes; };
+    const StreamBuffer& get_stream() const { return m_vertices; };
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+// Sprite-sheet layouts as compile-time data. Each layout's per-frame UV rects (in the sheet's
+// own 0-1 UV-plane) are worked out by the compiler into a static table, and map_sheet() places
+// them inside an atlas region once at load; from then on drawing a frame is an index lookup.
+#include "glm/mat4x4.hpp"
+
+struct UvRect
+{
+    float u, v,
+          width, height;
+};
+
+template <int COLUMNS, int ROWS>
+struct SheetLayout
+{
+    static constexpr int FRAME_COUNT = COLUMNS * ROWS;
+
+    UvRect frames[FRAME_COUNT];
+
+    // Frames run left to right, then top to bottom, as Entity has always indexed them
+    constexpr SheetLayout() : frames()
+    {
+        for (int index = 0; index < FRAME_COUNT; index++)
+        {
+            frames[index] = { (float)(index % COLUMNS) / (float)COLUMNS, (float)(index / COLUMNS) / (float)ROWS,
+                              1.0f / (float)COLUMNS, 1.0f / (float)ROWS };
+        }
+    }
+};
+
+// ————— SHEETS ————— //
+constexpr SheetLayout<3, 1>   SHIP_SHEET;  // assets/ship.png: idle, low and high booster
+constexpr SheetLayout<16, 16> FONT_SHEET;  // SdfFontGenerator's grid output, one glyph per ASCII code; see FontMetrics.h
+
+static_assert(SHIP_SHEET.frames[2].u == 2.0f / 3.0f, "sheet tables are built at compile time");
+
+// Each frame of `sheet` inside the atlas region `uv_rect` (u, v, width, height), into `frames`
+template <int COLUMNS, int ROWS>
+void map_sheet(const SheetLayout<COLUMNS, ROWS>& sheet, glm::vec4 uv_rect, glm::vec4* frames)
+{
+    for (int index = 0; index < sheet.FRAME_COUNT; index++)
+    {
+        const UvRect& frame = sheet.frames[index];
+        frames[index] = glm::vec4(uv_rect.x + frame.u * uv_rect.z, uv_rect.y + frame.v * uv_rect.w,
+                                  frame.width * uv_rect.z, frame.height * uv_rect.w);
+    }
+}
@@ -0,0 +1,46 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include "RenderQueue.h"
+#include "Systems.h"
+
+void sprite_system(Registry& registry, RenderCommandBuffer* queue, float alpha)
+{
+    for (int i = 0; i < registry.sprites.size(); i++)
+    {
+        EntityId entity = registry.sprites.entity_at(i);
+        const Sprite& sprite = registry.sprites.at(i);
+        const Transform2D& transform = registry.transforms.get(entity);
+
+        glm::vec2 position = glm::mix(transform.previous_position, transform.position, alpha);
+        glm::vec4 uv_rect = sprite.uv_rect;
+
+        // Same frame maths as Entity::draw_sprite_from_texture_atlas
+        if (registry.animators.has(entity))
+        {
+            const SpriteAnimator& animator = registry.animators.get(entity);
+            int index = animator.frames[animator.current];
+
+            float u_coord = (float)(index % animator.columns) / (float)animator.columns;
+            float v_coord = (float)(index / animator.columns) / (float)animator.rows;
+
+            float width  = 1.0f / (float)animator.columns,
+                  height = 1.0f / (float)animator.rows;
+
+            uv_rect = glm::vec4(sprite.uv_rect.x + u_coord * sprite.uv_rect.z, sprite.uv_rect.y + v_coord * sprite.uv_rect.w,
+                                width * sprite.uv_rect.z, height * sprite.uv_rect.w);
+        }
+
+        queue->submit_sprite((RenderLayer)sprite.layer, position, sprite.size, uv_rect, sprite.texture_id, sprite.material);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// Bounded single-producer / single-consumer queue: one thread pushes, one other thread pops,
+// and neither ever takes a lock. Each side owns one index and only reads the other's, so the
+// only synchronisation is an acquire/release pair per operation. Each side also keeps a cached
+// copy of the other's index and only reloads it when the ring looks full (or empty), which
+// keeps the two cores from bouncing the same cache line on every element.
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+template <typename T>
+class SpscRing
+{
+private:
+    static const size_t CACHE_LINE = 64;
+
+    std::unique_ptr<T[]> m_slots;
+    size_t               m_mask = 0;  // capacity - 1; the capacity is a power of two
+
+    // ————— PRODUCER ————— //
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{ 0 };  // next slot to write
+    size_t                                  m_cached_tail = 0;
+
+    // ————— CONSUMER ————— //
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{ 0 };  // next slot to read
+    size_t                                  m_cached_head = 0;
+
+public:
+    // Rounded up to a power of two. Not thread-safe: call before either side starts.
+    explicit SpscRing(size_t capacity = 1024)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity) rounded *= 2;
+
+        m_slots.reset(new T[rounded]);
+        m_mask = rounded - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer only. False when full, which is the consumer's cue to catch up (back-pressure).
+    bool try_push(const T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cached_tail > m_mask)
+        {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cached_tail > m_mask) return false;
+        }
+
+        m_slots[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only. Pops up to max_count elements into out; returns how many it got.
+    size_t try_pop(T* out, size_t max_count)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_cached_head == tail) m_cached_head = m_head.load(std::memory_order_acquire);
+
+        size_t count = m_cached_head - tail;
+        if (count > max_count) count = max_count;
+
+        for (size_t i = 0; i < count; i++) out[i] = m_slots[(tail + i) & m_mask];
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Either side; a snapshot that may be stale by the time it's read
+    size_t get_size() const
+    {
+        // Tail first: the head can only have moved further on by the time it's read
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return m_head.load(std::memory_order_acquire) - tail;
+    };
+    size_t get_capacity() const { return m_mask + 1; };
+};
@@ -0,0 +1,58 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "GLCallCounter.h"
+#include "Starfield.h"
+
+void Starfield::initialise()
+{
+    m_program.load(EmbeddedShaders::STARFIELD_VERTEX, EmbeddedShaders::STARFIELD_FRAGMENT);
+    m_view_min_uniform = glGetUniformLocation(m_program.get_program_id(), "viewMin");
+    m_view_max_uniform = glGetUniformLocation(m_program.get_program_id(), "viewMax");
+
+    // One triangle big enough that the screen is the part of it inside clip space
+    const float vertices[] = { -1.0f, -1.0f,
+                                3.0f, -1.0f,
+                               -1.0f,  3.0f };
+
+    m_backend = get_render_backend();
+    m_vertex_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+    VertexLayout layout;
+    layout.stride = 2 * sizeof(float);
+    m_backend->create_pipeline(m_pipeline, &m_program, layout.add(m_program.get_position_attribute(), 2, 0));
+}
+
+void Starfield::cleanup()
+{
+    if (m_vertex_buffer == 0) return;
+
+    m_backend->delete_pipeline(m_pipeline);
+    m_backend->delete_buffer(m_vertex_buffer);
+    m_vertex_buffer = 0;
+}
+
+void Starfield::draw(glm::vec2 view_min, glm::vec2 view_max)
+{
+    m_draw_calls = 0;
+    if (!is_initialised()) return;
+
+    m_backend->begin_draws(m_pipeline, m_vertex_buffer, 0);
+
+    count_gl_call(GL_CALL_UNIFORM, 2);
+    glUniform2f(m_view_min_uniform, view_min.x, view_min.y);
+    glUniform2f(m_view_max_uniform, view_max.x, view_max.y);
+
+    m_backend->draw_triangles(0, 3);
+    m_draw_calls++;
+    m_backend->end_draws();
+}
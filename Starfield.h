@@ -0,0 +1,41 @@
+#pragma once
+
+// The deep-space background: one full-screen triangle whose fragment shader makes up several
+// layers of parallax stars from the view alone (shaders/starfield_fragment.glsl). No textures,
+// no per-star data and one draw call, so it costs a few bytes of vertex buffer and nothing on
+// the CPU beyond two uniforms a frame.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "PipelineWarmup.h"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+
+class Starfield
+{
+private:
+    ShaderProgram  m_program;
+    RenderBackend* m_backend = NULL;
+    Pipeline       m_pipeline;
+    GLuint         m_vertex_buffer = 0;
+    GLint         m_view_min_uniform = -1,
+                  m_view_max_uniform = -1;
+    int           m_draw_calls = 0;
+
+public:
+    // GL thread, once the context exists
+    void initialise();
+    void cleanup();
+
+    // Over whatever is already in the framebuffer, so call it right after the clear.
+    // [view_min, view_max] is the world rectangle on screen (see get_view_bounds in Camera.h).
+    void draw(glm::vec2 view_min, glm::vec2 view_max);
+
+    void warm_up(PipelineWarmup& warmup) { if (is_initialised()) warmup.warm_up(m_pipeline); };
+
+    bool const is_initialised() const { return m_vertex_buffer != 0; };
+    int  const get_draw_calls() const { return m_draw_calls; };
+};
@@ -0,0 +1,92 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include "StartupProfiler.h"
+
+StartupProfiler::Scope::Scope(StartupProfiler& profiler, const char* name) : m_profiler(&profiler)
+{
+    m_phase = m_profiler->begin_phase(name);
+    m_started = Clock::now();
+}
+
+StartupProfiler::Scope::~Scope()
+{
+    m_profiler->end_phase(m_phase, m_started);
+}
+
+int StartupProfiler::begin_phase(const char* name)
+{
+    m_phases.push_back({ name, (int)m_open.size(), 0.0, 0 });
+    m_open.push_back((int)m_phases.size() - 1);
+    return m_open.back();
+}
+
+void StartupProfiler::end_phase(int phase, Clock::time_point started)
+{
+    m_phases[phase].seconds = std::chrono::duration<double>(Clock::now() - started).count();
+
+    // Scopes close in reverse order, so this is always the innermost one
+    if (!m_open.empty() && m_open.back() == phase) m_open.pop_back();
+}
+
+void StartupProfiler::add_bytes(unsigned long long bytes)
+{
+    if (!m_open.empty()) m_phases[m_open.back()].bytes += bytes;
+}
+
+void StartupProfiler::add_phase(const char* name, double seconds, unsigned long long bytes)
+{
+    m_phases.push_back({ name, (int)m_open.size(), seconds, bytes });
+}
+
+void StartupProfiler::report() const
+{
+    std::cout << "Startup: " << std::fixed << std::setprecision(2) << get_total_seconds() * 1000.0 << " ms to first frame" << std::endl;
+
+    for (const Phase& phase : m_phases)
+    {
+        std::cout << "Startup: " << std::string(2 + 2 * phase.depth, ' ') << std::left << std::setw(28 - 2 * phase.depth) << phase.name
+                  << std::right << std::setw(9) << phase.seconds * 1000.0 << " ms";
+        if (phase.bytes > 0) std::cout << std::setw(12) << phase.bytes << " bytes";
+        std::cout << std::endl;
+    }
+
+    std::cout << std::defaultfloat << std::setprecision(6);
+}
+
+bool StartupProfiler::write_json(const char* filepath) const
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    // Flat list with a depth per phase, in the order the phases started; easy to diff release to release
+    file << "{\n  \"total_ms\": " << get_total_seconds() * 1000.0 << ",\n  \"phases\": [\n";
+
+    for (size_t i = 0; i < m_phases.size(); i++)
+    {
+        const Phase& phase = m_phases[i];
+
+        file << "    { \"name\": \"";
+        for (char character : phase.name)
+        {
+            if (character == '"' || character == '\\') file << '\\';
+            file << character;
+        }
+        file << "\", \"depth\": " << phase.depth << ", \"ms\": " << phase.seconds * 1000.0 << ", \"bytes\": " << phase.bytes << " }"
+             << (i + 1 < m_phases.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n}\n";
+    return (bool)file;
+}
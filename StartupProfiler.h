@@ -0,0 +1,59 @@
+#pragma once
+
+// Wall time and bytes loaded for each phase of startup, so time-to-first-frame regressions show up
+// as a number per phase instead of a vague "it got slower". Phases nest: a phase opened while
+// another is running is reported underneath it, and its time is included in its parent's.
+#include <chrono>
+#include <string>
+#include <vector>
+
+class StartupProfiler
+{
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Phase
+    {
+        std::string        name;
+        int                depth;
+        double             seconds;
+        unsigned long long bytes;  // this phase's own, not counting the phases inside it
+    };
+
+    std::vector<Phase> m_phases;
+    std::vector<int>   m_open;  // indices into m_phases, innermost last
+    Clock::time_point  m_start = Clock::now();
+
+    int  begin_phase(const char* name);
+    void end_phase(int phase, Clock::time_point started);
+
+public:
+    // Times everything between its construction and the end of the enclosing block
+    class Scope
+    {
+    private:
+        StartupProfiler*  m_profiler;
+        int               m_phase;
+        Clock::time_point m_started;
+
+    public:
+        Scope(StartupProfiler& profiler, const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Charged to the innermost open phase; ignored when none is open
+    void add_bytes(unsigned long long bytes);
+
+    // Records a phase that was timed somewhere a Scope can't reach, such as a worker thread,
+    // underneath whichever phase is open right now
+    void add_phase(const char* name, double seconds, unsigned long long bytes);
+
+    // Total is measured from construction of the profiler to the call
+    void report() const;
+    bool write_json(const char* filepath) const;
+
+    double const get_total_seconds() const { return std::chrono::duration<double>(Clock::now() - m_start).count(); };
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+// xxHash64, for checksumming simulation state on every step: a few multiplies per 8 bytes, so
+// hashing a whole batch of landers costs a small fraction of stepping them. Two forms:
+//
+//   hash_xxh64  - the reference algorithm over a block of bytes, e.g. one SoA array at a time;
+//                 chain arrays by passing each result as the next one's seed
+//   StateHash   - 64-bit lanes fed in one at a time through xxHash64's tail rounds, for state
+//                 scattered over objects (Entity fields) that would otherwise need copying out
+//
+// Both only read exact bits, so a value agrees across machines exactly when the state does; in
+// float builds that means same compiler and flags, in LANDER_FIXED_POINT builds anywhere.
+#include <cstdint>
+#include <cstring>
+
+class StateHash
+{
+private:
+    static const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull,
+                          PRIME_2 = 0xC2B2AE3D27D4EB4Full,
+                          PRIME_3 = 0x165667B19E3779F9ull,
+                          PRIME_4 = 0x85EBCA77C2B2AE63ull,
+                          PRIME_5 = 0x27D4EB2F165667C5ull;
+
+    uint64_t m_hash,
+             m_length = 0;
+
+    static uint64_t rotl(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+
+    static uint64_t round(uint64_t accumulator, uint64_t lane)
+    {
+        accumulator += lane * PRIME_2;
+        return rotl(accumulator, 31) * PRIME_1;
+    }
+
+    static uint64_t merge_round(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= round(0, accumulator);
+        return hash * PRIME_1 + PRIME_4;
+    }
+
+    static uint64_t avalanche(uint64_t hash)
+    {
+        hash ^= hash >> 33;
+        hash *= PRIME_2;
+        hash ^= hash >> 29;
+        hash *= PRIME_3;
+        return hash ^ (hash >> 32);
+    }
+
+    static uint64_t read_64(const uint8_t* bytes) { uint64_t value; std::memcpy(&value, bytes, sizeof(value)); return value; }
+    static uint32_t read_32(const uint8_t* bytes) { uint32_t value; std::memcpy(&value, bytes, sizeof(value)); return value; }
+
+public:
+    explicit StateHash(uint64_t seed = 0) : m_hash(seed + PRIME_5) {}
+
+    void add(uint64_t lane)
+    {
+        m_hash ^= round(0, lane);
+        m_hash = rotl(m_hash, 27) * PRIME_1 + PRIME_4;
+        m_length += sizeof(lane);
+    }
+    void add(uint32_t low, uint32_t high) { add((uint64_t)high << 32 | low); }
+
+    uint64_t const finish() const { return avalanche(m_hash + m_length); }
+
+    // XXH64(data, size, seed), bit for bit
+    static uint64_t hash_xxh64(const void* data, size_t size, uint64_t seed = 0)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+        const uint8_t* end   = bytes + size;
+        uint64_t hash;
+
+        // STEP 1: Four independent accumulators over 32-byte stripes, so the multiplies overlap
+        if (size >= 32)
+        {
+            uint64_t accumulators[4] = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+            for (; bytes + 32 <= end; bytes += 32)
+            {
+                for (int i = 0; i < 4; i++) accumulators[i] = round(accumulators[i], read_64(bytes + 8 * i));
+            }
+
+            hash = rotl(accumulators[0], 1) + rotl(accumulators[1], 7) + rotl(accumulators[2], 12) + rotl(accumulators[3], 18);
+            for (int i = 0; i < 4; i++) hash = merge_round(hash, accumulators[i]);
+        }
+        else hash = seed + PRIME_5;
+        hash += size;
+
+        // STEP 2: What's left over, 8, then 4, then 1 byte at a time
+        for (; bytes + 8 <= end; bytes += 8)
+        {
+            hash ^= round(0, read_64(bytes));
+            hash = rotl(hash, 27) * PRIME_1 + PRIME_4;
+        }
+        if (bytes + 4 <= end)
+        {
+            hash ^= read_32(bytes) * PRIME_1;
+            hash = rotl(hash, 23) * PRIME_2 + PRIME_3;
+            bytes += 4;
+        }
+        for (; bytes < end; bytes++)
+        {
+            hash ^= *bytes * PRIME_5;
+            hash = rotl(hash, 11) * PRIME_1;
+        }
+
+        return avalanche(hash);
+    }
+};
@@ -0,0 +1,193 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <numeric>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "StaticPlatformMesh.h"
+
+void StaticPlatformMesh::write_vertices(const Entity& platform, float* vertices)
+{
+    glm::vec2 centre = glm::vec2(platform.get_position()),
+              half   = glm::vec2(platform.get_width(), platform.get_height()) * 0.5f;
+
+    // A destroyed platform keeps its slot but covers no pixels
+    if (!platform.is_active()) half = glm::vec2(0.0f);
+
+    // Same corner and UV layout as InstancedRenderer's unit quad: v grows downwards
+    const glm::vec4& uv = platform.m_uv_rect;
+    float left   = centre.x - half.x, right = centre.x + half.x,
+          bottom = centre.y - half.y, top   = centre.y + half.y;
+    float u0 = uv.x, u1 = uv.x + uv.z,
+          v0 = uv.y, v1 = uv.y + uv.w;
+
+    float quad[FLOATS_PER_PLATFORM] =
+    {
+        left,  bottom, u0, v1,
+        right, bottom, u1, v1,
+        right, top,    u1, v0,
+        left,  bottom, u0, v1,
+        right, top,    u1, v0,
+        left,  top,    u0, v0
+    };
+    std::copy(quad, quad + FLOATS_PER_PLATFORM, vertices);
+}
+
+void StaticPlatformMesh::bake(const Entity* platforms, int platform_count, GLuint texture_id)
+{
+    m_platforms = platforms;
+    m_platform_count = platform_count;
+    m_texture_id = texture_id;
+    m_dirty.clear();
+    m_in_order = true;
+
+    // STEP 1: Buffer order, left to right
+    m_order.resize(platform_count);
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::stable_sort(m_order.begin(), m_order.end(),
+                     [platforms](int a, int b) { return platforms[a].get_position().x < platforms[b].get_position().x; });
+
+    m_position_of.resize(platform_count);
+    m_baked_x.resize(platform_count);
+    m_max_half_width = 0.0f;
+
+    // STEP 2: Every platform's vertices, in world space
+    m_scratch.resize((size_t)platform_count * FLOATS_PER_PLATFORM);
+    for (int position = 0; position < platform_count; position++)
+    {
+        const Entity& platform = platforms[m_order[position]];
+        m_position_of[m_order[position]] = position;
+        m_baked_x[position] = platform.get_position().x;
+        m_max_half_width = std::max(m_max_half_width, platform.get_width() * 0.5f);
+
+        write_vertices(platform, &m_scratch[(size_t)position * FLOATS_PER_PLATFORM]);
+    }
+
+    // STEP 3: One static upload
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    if (m_vertex_buffer == 0) glGenBuffers(1, &m_vertex_buffer);
+    if (m_vertex_array == 0 && supports_vertex_arrays()) glGenVertexArrays(1, &m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, m_scratch.size() * sizeof(float), m_scratch.data(), GL_STATIC_DRAW);
+    track_gpu_buffer(m_vertex_buffer, (long long)(m_scratch.size() * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_first_drawn = 0;
+    m_drawn_count = platform_count;
+
+    // A big level's vertices have no reason to stay around on the CPU
+    std::vector<float>().swap(m_scratch);
+}
+
+void StaticPlatformMesh::cleanup()
+{
+    if (m_vertex_array != 0)  glDeleteVertexArrays(1, &m_vertex_array);
+    if (m_vertex_buffer != 0) untrack_gpu_buffers(1, &m_vertex_buffer);
+    if (m_vertex_buffer != 0) glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_array = m_vertex_buffer = 0;
+    m_platforms = NULL;
+    m_platform_count = 0;
+    m_drawn_count = 0;
+    m_dirty.clear();
+}
+
+void StaticPlatformMesh::invalidate(int platform_index)
+{
+    if (platform_index < 0 || platform_index >= m_platform_count) return;
+    m_dirty.push_back(platform_index);
+}
+
+void StaticPlatformMesh::flush_dirty()
+{
+    if (m_dirty.empty()) return;
+
+    float vertices[FLOATS_PER_PLATFORM];
+
+    count_gl_call(GL_CALL_BIND, 2);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    for (int platform_index : m_dirty)
+    {
+        const Entity& platform = m_platforms[platform_index];
+        int position = m_position_of[platform_index];
+
+        // A platform that moved past a neighbour keeps its slot, but the culling search can no
+        // longer trust the order
+        float x = platform.get_position().x;
+        m_baked_x[position] = x;
+        m_max_half_width = std::max(m_max_half_width, platform.get_width() * 0.5f);
+        if ((position > 0 && m_baked_x[position - 1] > x) || (position + 1 < m_platform_count && m_baked_x[position + 1] < x)) m_in_order = false;
+
+        write_vertices(platform, vertices);
+
+        count_gl_call(GL_CALL_UPLOAD);
+        glBufferSubData(GL_ARRAY_BUFFER, (size_t)position * sizeof(vertices), sizeof(vertices), vertices);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    m_dirty.clear();
+}
+
+void StaticPlatformMesh::cull(glm::vec2 view_min, glm::vec2 view_max)
+{
+    if (!m_in_order)
+    {
+        m_first_drawn = 0;
+        m_drawn_count = m_platform_count;
+        return;
+    }
+
+    auto first = std::lower_bound(m_baked_x.begin(), m_baked_x.end(), view_min.x - m_max_half_width),
+         last  = std::upper_bound(first, m_baked_x.end(), view_max.x + m_max_half_width);
+
+    m_first_drawn = (int)(first - m_baked_x.begin());
+    m_drawn_count = (int)(last - first);
+}
+
+void StaticPlatformMesh::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (!is_baked()) return;
+
+    flush_dirty();
+    if (m_drawn_count == 0) return;
+
+    // Vertices are already in world space
+    program->use();
+    program->set_model_transform(ModelTransform());
+
+    const GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+
+    // A core context won't draw without a vertex array bound. The attributes are pointed again
+    // inside it every draw, since the program is the caller's.
+    count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+    if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (void*)0);
+    glEnableVertexAttribArray(program->get_position_attribute());
+    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride, (void*)(2 * sizeof(float)));
+    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_DRAW);
+    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    glDrawArrays(GL_TRIANGLES, m_first_drawn * VERTICES_PER_PLATFORM, m_drawn_count * VERTICES_PER_PLATFORM);
+    m_draw_calls++;
+
+    count_gl_call(GL_CALL_BIND);
+    glDisableVertexAttribArray(program->get_position_attribute());
+    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0) glBindVertexArray(0);
+}
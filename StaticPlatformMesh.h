@@ -0,0 +1,73 @@
+#pragma once
+
+// Every platform of a level baked into one vertex buffer at load: six world-space vertices each,
+// with their atlas UVs, so the whole set draws in one glDrawArrays under an identity model matrix
+// and needs neither instancing nor a sprite batch rebuilt every frame.
+//
+// Platforms are laid out in the buffer sorted along x, which lets cull() narrow the draw to the
+// run that can reach the view. A platform that changes after baking (moved, retextured, or
+// deactivated like a destroyed rock) is passed to invalidate(), and only its own six vertices are
+// rewritten before the next draw.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "Entity.h"
+#include "ShaderProgram.h"
+
+class StaticPlatformMesh
+{
+private:
+    static const int FLOATS_PER_VERTEX     = 4,  // x, y, u, v
+                     VERTICES_PER_PLATFORM = 6,
+                     FLOATS_PER_PLATFORM   = FLOATS_PER_VERTEX * VERTICES_PER_PLATFORM;
+
+    const Entity* m_platforms     = NULL;
+    int           m_platform_count = 0;
+    GLuint        m_vertex_buffer = 0,
+                  m_vertex_array  = 0,  // 0 where vertex arrays aren't supported
+                  m_texture_id    = 0;
+
+    std::vector<int>   m_order;        // buffer position -> platform index, sorted along x
+    std::vector<int>   m_position_of;  // platform index -> buffer position
+    std::vector<float> m_baked_x;      // centre x at each buffer position, for cull()
+    float              m_max_half_width = 0.0f;
+    bool               m_in_order      = true;  // false once an invalidated platform moved out of order
+
+    std::vector<int>   m_dirty;        // platform indices, rewritten by the next draw()
+    std::vector<float> m_scratch;
+
+    int m_first_drawn = 0,  // in platforms
+        m_drawn_count = 0,
+        m_draw_calls  = 0;
+
+    // Writes FLOATS_PER_PLATFORM floats; an inactive platform collapses to nothing
+    static void write_vertices(const Entity& platform, float* vertices);
+    void flush_dirty();
+
+public:
+    StaticPlatformMesh() = default;
+    StaticPlatformMesh(const StaticPlatformMesh&) = delete;
+    StaticPlatformMesh& operator=(const StaticPlatformMesh&) = delete;
+    ~StaticPlatformMesh() = default;
+
+    // GL thread. The platforms must outlive the mesh or the next bake(); their m_uv_rect must be set.
+    void bake(const Entity* platforms, int platform_count, GLuint texture_id);
+    void cleanup();
+
+    // The hook for a platform that changed since bake()
+    void invalidate(int platform_index);
+
+    // Draw only what can reach [view_min, view_max] along x; platforms are a strip along x, so y
+    // is left to the GPU. Everything is drawn once a moved platform has broken the order.
+    void cull(glm::vec2 view_min, glm::vec2 view_max);
+
+    void draw(ShaderProgram* program);
+
+    bool const is_baked()         const { return m_vertex_buffer != 0 && m_platforms != NULL; };
+    int  const get_draw_calls()   const { return m_draw_calls; };
+    int  const get_drawn_count()  const { return m_drawn_count; };
+};
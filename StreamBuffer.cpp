@@ -0,0 +1,167 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "StreamBuffer.h"
+#include "Trace.h"
+
+const GLbitfield PERSISTENT_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+const GLuint64   FENCE_TIMEOUT_NS = 1000000000;  // a second; only a lost context takes that long
+
+void StreamBuffer::initialise(GLenum target, size_t region_size)
+{
+    m_target = target;
+    m_persistent = supports_buffer_storage();
+    allocate(std::max(region_size, (size_t)ALIGNMENT));
+}
+
+void StreamBuffer::cleanup()
+{
+    release();
+    std::vector<unsigned char>().swap(m_staging);
+    m_region_size = 0;
+}
+
+void StreamBuffer::release()
+{
+    for (GLsync& fence : m_fences)
+    {
+        if (fence != NULL) glDeleteSync(fence);
+        fence = NULL;
+    }
+
+    if (m_buffer != 0)
+    {
+        count_gl_call(GL_CALL_BIND, 2);
+        glBindBuffer(m_target, m_buffer);
+#ifndef __EMSCRIPTEN__
+        if (m_mapped != NULL) glUnmapBuffer(m_target);
+#endif
+        glBindBuffer(m_target, 0);
+        untrack_gpu_buffers(1, &m_buffer);
+        glDeleteBuffers(1, &m_buffer);
+    }
+    m_buffer = 0;
+    m_mapped = NULL;
+}
+
+void StreamBuffer::allocate(size_t region_size)
+{
+    // Draws already issued keep the old store alive until they're done with it
+    release();
+
+    m_region_size = (region_size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    m_region = 0;
+    m_region_used = 0;
+
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(m_target, m_buffer);
+
+    if (m_persistent)
+    {
+        const GLsizeiptr size = (GLsizeiptr)(m_region_size * REGIONS);
+#ifndef __EMSCRIPTEN__
+        glBufferStorage(m_target, size, NULL, PERSISTENT_FLAGS);
+        m_mapped = (unsigned char*)glMapBufferRange(m_target, 0, size, PERSISTENT_FLAGS);
+#endif
+
+        // A driver that advertises the extension but won't map it gets the orphaning path after all
+        if (m_mapped == NULL)
+        {
+            m_persistent = false;
+            glDeleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(m_target, m_buffer);
+        }
+    }
+    if (!m_persistent)
+    {
+        glBufferData(m_target, (GLsizeiptr)m_region_size, NULL, GL_STREAM_DRAW);
+        m_staging.resize(m_region_size);
+    }
+    track_gpu_buffer(m_buffer, (long long)(m_persistent ? m_region_size * REGIONS : m_region_size));
+}
+
+void StreamBuffer::wait_for_region(int region)
+{
+    GLsync& fence = m_fences[region];
+    if (fence == NULL) return;
+
+    // Already signalled is the usual case: three regions back is a frame or two ago
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+        TRACE_ZONE("StreamBuffer stall");
+        m_stalls++;
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+    }
+
+    glDeleteSync(fence);
+    fence = NULL;
+}
+
+void* StreamBuffer::write(size_t bytes)
+{
+    m_writing = true;
+    m_written = bytes;
+
+    // STEP 1: Bigger than a whole region: every region grows, so the next frames fit as well
+    if (bytes > m_region_size)
+    {
+        m_reallocations++;
+        allocate(std::max(bytes, m_region_size * 2));
+    }
+
+    if (!m_persistent)
+    {
+        m_write_offset = 0;
+        return m_staging.data();
+    }
+
+    // STEP 2: Whatever is left of this region, or the next region once the GPU is done with it.
+    //         The fence goes in here, after every draw that read the region being left.
+    size_t offset = (m_region_used + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (offset + bytes > m_region_size)
+    {
+        m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_region = (m_region + 1) % REGIONS;
+        wait_for_region(m_region);
+        offset = 0;
+    }
+
+    m_region_used = offset + bytes;
+    m_write_offset = m_region * m_region_size + offset;
+    return m_mapped + m_write_offset;
+}
+
+size_t StreamBuffer::commit()
+{
+    count_gl_call(GL_CALL_BIND);
+    glBindBuffer(m_target, m_buffer);
+    if (!m_writing) return m_write_offset;
+    m_writing = false;
+
+    // Coherent memory is visible to the next draw as it stands; only the fallback uploads
+    if (!m_persistent)
+    {
+        count_gl_call(GL_CALL_UPLOAD, 2);
+        glBufferData(m_target, (GLsizeiptr)m_region_size, NULL, GL_STREAM_DRAW);
+        glBufferSubData(m_target, 0, (GLsizeiptr)m_written, m_staging.data());
+    }
+    return m_write_offset;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// A GL buffer for data that is written fresh every frame, like the sprite batch's corners and
+// transient text. Where ARB_buffer_storage is available the whole store is mapped once, persistently
+// and coherently, and split into REGIONS regions that are filled in turn. Writes are bump-allocated
+// inside the current region. Moving on to the next region fences the one being left and waits on
+// the one being entered, which with three regions in flight the GPU has long since finished. No
+// glBufferData, no glBufferSubData and no map/unmap per upload: the caller writes its vertices
+// straight into the memory the GPU reads.
+//
+// Drivers without buffer storage get the same interface over a CPU staging block, uploaded by
+// orphaning the store (glBufferData with NULL) and filling it with glBufferSubData, so the draw
+// never waits on the previous one either.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+
+class StreamBuffer
+{
+public:
+    static const int    REGIONS   = 3;
+    static const size_t ALIGNMENT = 16;  // of every write's offset; a whole vertex for the callers' layouts
+
+private:
+    GLenum m_target = GL_ARRAY_BUFFER;
+    GLuint m_buffer = 0;
+    size_t m_region_size = 0;
+
+    // ————— PERSISTENT ————— //
+    bool           m_persistent = false;
+    unsigned char* m_mapped = NULL;          // the whole store, all regions
+    GLsync         m_fences[REGIONS] = {};   // after the last draw reading each region; NULL once waited on
+    int            m_region = 0;
+    size_t         m_region_used = 0;
+
+    // ————— ORPHANING ————— //
+    std::vector<unsigned char> m_staging;
+
+    size_t m_written = 0;       // bytes handed out by the last write()
+    size_t m_write_offset = 0;  // where they land in the buffer
+    bool   m_writing = false;
+
+    long long m_stalls = 0,     // waits on a fence that hadn't signalled yet
+              m_reallocations = 0;
+
+    void allocate(size_t region_size);
+    void release();
+    void wait_for_region(int region);
+
+public:
+    // GL thread, once the context exists. region_size is a frame's worth of data; a write larger
+    // than that grows every region to fit.
+    void initialise(GLenum target, size_t region_size);
+    void cleanup();
+
+    // Somewhere to put `bytes` for the next draw. Everything written must be in place before
+    // commit(); the pointer is no good after it.
+    void*  write(size_t bytes);
+    // Makes the write visible to GL and returns its offset in get_buffer(), for the attribute
+    // pointers or the draw. Leaves the buffer bound to the target.
+    size_t commit();
+
+    GLuint    const get_buffer()        const { return m_buffer; };
+    bool      const is_persistent()     const { return m_persistent; };
+    long long const get_stalls()        const { return m_stalls; };
+    long long const get_reallocations() const { return m_reallocations; };
+};
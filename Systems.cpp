@@ -0,0 +1,193 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Physics-side systems only: no SDL or GL, so this builds into the headless simulator too.
+// The sprite system lives in SpriteSystem.cpp.
+#include <algorithm>
+#include <cmath>
+#include "Rng.h"
+#include "Simulation.h"
+#include "Systems.h"
+
+static bool overlaps(glm::vec2 position, glm::vec2 size, glm::vec2 other_position, glm::vec2 other_size)
+{
+    float x_distance = fabs(position.x - other_position.x) - ((size.x + other_size.x) / 2.0f);
+    float y_distance = fabs(position.y - other_position.y) - ((size.y + other_size.y) / 2.0f);
+
+    return x_distance < 0.0f && y_distance < 0.0f;
+}
+
+static void resolve_y(Registry& registry, Transform2D& transform, Body& body, glm::vec2 size)
+{
+    for (int k = 0; k < registry.boxes.size(); k++)
+    {
+        EntityId other = registry.boxes.entity_at(k);
+        if (registry.bodies.has(other)) continue;
+
+        const AABB& box = registry.boxes.at(k);
+        glm::vec2 other_position = registry.transforms.get(other).position,
+                  other_size     = box.half_size * 2.0f;
+        if (!overlaps(transform.position, size, other_position, other_size)) continue;
+
+        float y_distance = fabs(transform.position.y - other_position.y);
+        float y_overlap = fabs(y_distance - (size.y / 2.0f) - (other_size.y / 2.0f));
+
+        if (body.velocity.y > 0) {
+            transform.position.y -= y_overlap;
+            body.velocity.y = 0;
+            body.collided_top = true;
+        }
+        else if (body.velocity.y < 0) {
+            transform.position.y += y_overlap;
+            body.velocity.y = 0;
+            body.collided_bottom = true;
+
+            if (box.kind == WIN_PLATFORM)        body.win = true;
+            else if (box.kind == DEATH_PLATFORM) body.loss = true;
+        }
+    }
+}
+
+static void resolve_x(Registry& registry, Transform2D& transform, Body& body, glm::vec2 size)
+{
+    for (int k = 0; k < registry.boxes.size(); k++)
+    {
+        EntityId other = registry.boxes.entity_at(k);
+        if (registry.bodies.has(other)) continue;
+
+        glm::vec2 other_position = registry.transforms.get(other).position,
+                  other_size     = registry.boxes.at(k).half_size * 2.0f;
+        if (!overlaps(transform.position, size, other_position, other_size)) continue;
+
+        float x_distance = fabs(transform.position.x - other_position.x);
+        float x_overlap = fabs(x_distance - (size.x / 2.0f) - (other_size.x / 2.0f));
+
+        if (body.velocity.x > 0) {
+            transform.position.x -= x_overlap;
+            body.velocity.x = 0;
+            body.collided_right = true;
+        }
+        else if (body.velocity.x < 0) {
+            transform.position.x += x_overlap;
+            body.velocity.x = 0;
+            body.collided_left = true;
+        }
+    }
+}
+
+void physics_system(Registry& registry, float delta_time)
+{
+    for (int i = 0; i < registry.bodies.size(); i++)
+    {
+        EntityId entity = registry.bodies.entity_at(i);
+        Body& body = registry.bodies.at(i);
+        Transform2D& transform = registry.transforms.get(entity);
+
+        if (body.type == STATIC_BODY) continue;
+
+        transform.previous_position = transform.position;
+
+        if (body.type == KINEMATIC_BODY)
+        {
+            transform.position += body.velocity * delta_time;
+            continue;
+        }
+
+        body.collided_top = body.collided_bottom = false;
+        body.collided_left = body.collided_right = false;
+
+        // STEP 1: Integrate, in the same order as Entity::update
+        body.acceleration.x = body.movement.x * body.speed;
+        if (body.velocity.x > 0)      body.acceleration.x -= body.drag;
+        else if (body.velocity.x < 0) body.acceleration.x += body.drag;
+
+        body.velocity += body.acceleration * delta_time;
+
+        // STEP 2: Move and resolve one axis at a time against every box without a body
+        glm::vec2 size = registry.boxes.has(entity) ? registry.boxes.get(entity).half_size * 2.0f : glm::vec2(0.0f);
+        bool solid = registry.boxes.has(entity);
+
+        transform.position.y += body.velocity.y * delta_time;
+        if (solid) resolve_y(registry, transform, body, size);
+
+        transform.position.x += body.velocity.x * delta_time;
+        if (solid) resolve_x(registry, transform, body, size);
+
+        // STEP 3: Boost last, so it shows up in next step's velocity
+        if (registry.boosters.has(entity))
+        {
+            const Booster& booster = registry.boosters.get(entity);
+            if (booster.active) body.velocity.y += booster.power;
+        }
+    }
+}
+
+void animation_system(Registry& registry)
+{
+    for (int i = 0; i < registry.animators.size(); i++)
+    {
+        EntityId entity = registry.animators.entity_at(i);
+        if (!registry.bodies.has(entity)) continue;
+
+        SpriteAnimator& animator = registry.animators.at(i);
+        float velocity_y = registry.bodies.get(entity).velocity.y;
+
+        // Idle, low and high booster frames, as the lander picks them
+        int frame = (velocity_y > 1) ? 2 : (velocity_y > 0) ? 1 : 0;
+        animator.current = std::min(frame, animator.frame_count - 1);
+    }
+}
+
+EntityId build_level(Registry& registry, int platform_count, unsigned int seed)
+{
+    // STEP 1: The lander, with the same tuning as setup_player and reset_episode
+    EntityId lander = registry.create();
+
+    Transform2D& transform = registry.transforms.add(lander);
+    transform.position = transform.previous_position = glm::vec2(0.0f, 3.0f);
+
+    Body& body = registry.bodies.add(lander);
+    body.acceleration = glm::vec2(0.0f, ACC_OF_GRAVITY);
+    body.speed = 2.0f;
+    body.drag = 0.8f;
+
+    AABB& box = registry.boxes.add(lander);
+    box.half_size = glm::vec2(0.4f);
+    box.kind = PLAYER;
+
+    registry.boosters.add(lander).power = 0.1f;
+
+    SpriteAnimator& animator = registry.animators.add(lander);
+    animator.frame_count = 3;
+    animator.columns = 3;
+    for (int i = 0; i < animator.frame_count; i++) animator.frames[i] = i;
+
+    registry.sprites.add(lander).layer = 2;  // ACTOR_LAYER
+
+    // STEP 2: The platforms, drawing from the rng exactly as generate_platforms does
+    Rng rng(seed);
+
+    for (int i = 0; i < platform_count; i++)
+    {
+        bool rand_bool = rng.next_bool();
+        float rand_float = (float)rng.next_int(-3, 1);
+
+        EntityId platform = registry.create();
+
+        Transform2D& platform_transform = registry.transforms.add(platform);
+        platform_transform.position = platform_transform.previous_position = glm::vec2(i - 4.0f, rand_float);
+
+        registry.boxes.add(platform).kind = (rand_bool) ? WIN_PLATFORM : DEATH_PLATFORM;
+        registry.sprites.add(platform).layer = 1;  // WORLD_LAYER
+    }
+
+    return lander;
+}
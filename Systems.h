@@ -0,0 +1,19 @@
+#pragma once
+
+// The systems that run over a Registry. Each one touches only the component pools it names.
+#include "Registry.h"
+
+class RenderCommandBuffer;
+
+// Transform2D + Body (+ Booster) against every Transform2D + AABB that has no Body of its
+// own. Same integration and resolution order as Entity::update, in float.
+void physics_system(Registry& registry, float delta_time);
+
+// Body + SpriteAnimator: picks the booster frame from the vertical velocity
+void animation_system(Registry& registry);
+
+// Transform2D + Sprite (+ SpriteAnimator): queues one sprite per entity, between the last two steps
+void sprite_system(Registry& registry, RenderCommandBuffer* queue, float alpha = 1.0f);
+
+// A lander plus generate_platforms' level, as components; returns the lander
+EntityId build_level(Registry& registry, int platform_count, unsigned int seed);
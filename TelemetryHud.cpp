@@ -0,0 +1,162 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <charconv>
+#include "TelemetryHud.h"
+
+void TelemetryHud::initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font, float screen_size, float spacing)
+{
+    m_font_texture_id = font_texture_id;
+    m_font = font;
+    m_font.place(font_uv_rect);
+    m_screen_size = screen_size;
+    m_spacing = spacing;
+
+    m_backend = get_render_backend();
+}
+
+void TelemetryHud::cleanup()
+{
+    if (m_vertex_buffer != 0) m_backend->delete_buffer(m_vertex_buffer);
+    if (m_pipeline.program != NULL) m_backend->delete_pipeline(m_pipeline);
+    m_pipeline = Pipeline();
+    m_vertex_buffer = 0;
+    m_buffer_glyphs = 0;
+
+    m_fields.clear();
+    m_glyphs.clear();
+    m_vertices.clear();
+    m_dirty.clear();
+}
+
+void TelemetryHud::write_glyph(int slot, int row, int column, char glyph)
+{
+    m_glyphs[slot] = glyph;
+    m_dirty[slot] = 1;
+
+    // Centred in its cell, then moved down to its row
+    const GlyphMetrics& metrics = m_font.get_glyph((unsigned char)glyph);
+    float cell_left = (m_screen_size + m_spacing) * column - 0.5f * m_screen_size,
+          pen_x     = cell_left + (1.0f - metrics.advance) * 0.5f * m_screen_size;
+
+    float* vertices = &m_vertices[(size_t)slot * FLOATS_PER_GLYPH];
+    build_glyph_vertices(metrics, pen_x, m_screen_size, vertices);
+
+    float y = -m_screen_size * LINE_SPACING * row;
+    for (int i = 1; i < FLOATS_PER_GLYPH; i += TEXT_FLOATS_PER_VERTEX) vertices[i] += y;
+}
+
+int TelemetryHud::add_field(std::string_view label, int width, int decimals)
+{
+    width = std::clamp(width, 1, MAX_VALUE_WIDTH);
+
+    int first = (int)m_glyphs.size(),
+        count = (int)label.size() + width;
+    m_glyphs.resize(first + count);
+    m_vertices.resize((size_t)(first + count) * FLOATS_PER_GLYPH);
+    m_dirty.resize(first + count);
+
+    // The label is written once; the value starts blank
+    for (int column = 0; column < count; column++)
+    {
+        write_glyph(first + column, (int)m_fields.size(), column, column < (int)label.size() ? label[column] : ' ');
+    }
+
+    m_fields.push_back({ first + (int)label.size(), (int)label.size(), width, std::max(decimals, 0) });
+    return (int)m_fields.size() - 1;
+}
+
+void TelemetryHud::set_value(int row, double value)
+{
+    const Field& field = m_fields[row];
+
+    // STEP 1: Formatted on the stack; anything that doesn't fit is overflow. -0 would flicker a
+    //         sign in and out around zero.
+    if (value == 0.0) value = 0.0;
+    char text[MAX_VALUE_WIDTH];
+    auto [end, error] = std::to_chars(text, text + field.width, value, std::chars_format::fixed, field.decimals);
+    int length = (int)(end - text);
+    if (error != std::errc()) length = -1;
+
+    // STEP 2: Right-aligned against what the slots already show; only the differences are rebuilt
+    for (int i = 0; i < field.width; i++)
+    {
+        int  from_end = field.width - i;
+        char glyph = length < 0          ? '#'
+                   : from_end <= length  ? text[length - from_end]
+                   :                       ' ';
+
+        int slot = field.first_value + i;
+        if (m_glyphs[slot] != glyph) write_glyph(slot, row, field.label_length + i, glyph);
+    }
+}
+
+void TelemetryHud::upload_dirty()
+{
+    // Fields added since the buffer was made: a new one, with everything in it
+    int glyph_count = (int)m_glyphs.size();
+    if (m_vertex_buffer == 0 || m_buffer_glyphs != glyph_count)
+    {
+        if (m_vertex_buffer != 0) m_backend->delete_buffer(m_vertex_buffer);
+        m_vertex_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(float), m_vertices.data(), GL_DYNAMIC_DRAW);
+        m_buffer_glyphs = glyph_count;
+        std::fill(m_dirty.begin(), m_dirty.end(), 0);
+        return;
+    }
+
+    // Each run of changed glyphs in one upload
+    const size_t glyph_bytes = FLOATS_PER_GLYPH * sizeof(float);
+    for (int first = 0; first < glyph_count; first++)
+    {
+        if (!m_dirty[first]) continue;
+
+        int last = first;
+        while (last + 1 < glyph_count && m_dirty[last + 1]) last++;
+
+        int count = last - first + 1;
+        m_backend->update_buffer(m_vertex_buffer, GL_ARRAY_BUFFER, first * glyph_bytes, count * glyph_bytes, &m_vertices[(size_t)first * FLOATS_PER_GLYPH]);
+        std::fill(m_dirty.begin() + first, m_dirty.begin() + last + 1, 0);
+        m_uploaded_glyphs += count;
+        m_upload_calls++;
+
+        first = last;
+    }
+}
+
+void TelemetryHud::draw(ShaderProgram* program, glm::vec3 position)
+{
+    if (m_glyphs.empty() || m_backend == NULL) return;
+
+    upload_dirty();
+
+    if (m_pipeline.program != program)
+    {
+        if (m_pipeline.program != NULL) m_backend->delete_pipeline(m_pipeline);
+
+        VertexLayout layout;
+        layout.stride = TEXT_FLOATS_PER_VERTEX * sizeof(float);
+        layout.add(program->get_position_attribute(), 2, 0)
+              .add(program->get_tex_coordinate_attribute(), 2, 2 * sizeof(float));
+
+        m_pipeline = Pipeline();
+        m_backend->create_pipeline(m_pipeline, program, layout);
+    }
+
+    // begin_draws makes the program current, which the cached transform setter relies on
+    m_backend->begin_draws(m_pipeline, m_vertex_buffer, 0);
+    program->set_model_transform(ModelTransform::make(glm::vec2(position)));
+
+    m_backend->bind_texture(GL_TEXTURE_2D, m_font_texture_id);
+    m_backend->draw_triangles(0, (int)m_glyphs.size() * TEXT_VERTICES_PER_GLYPH);
+    m_backend->end_draws();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// Live numbers on the HUD (altitude, speeds, fuel, score) without building any text per frame.
+// Each field is a label and a fixed number of value characters, and every one of those has its
+// own glyph slot in one buffer that lives as long as the HUD. set_value formats into a stack
+// buffer with std::to_chars and compares it against what the slots already show; only the glyphs
+// that differ are rebuilt, and at draw each run of them goes up in one glBufferSubData. A digit
+// ticking over is one glyph's worth of upload, and a value that holds still costs nothing.
+//
+// The whole HUD is one draw. Layout is in the text's own units: fields stack downwards from the
+// position drawn at, one row each, and every character has a cell of its own so a changing digit
+// never moves its neighbours; a proportional font's glyphs are centred in theirs.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string_view>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+#include "FontMetrics.h"
+#include "TextGeometry.h"
+
+class TelemetryHud
+{
+private:
+    static const int FLOATS_PER_GLYPH = TEXT_VERTICES_PER_GLYPH * TEXT_FLOATS_PER_VERTEX,
+                     MAX_VALUE_WIDTH  = 24;
+    static constexpr float LINE_SPACING = 1.5f;  // rows apart, in glyph heights
+
+    struct Field
+    {
+        int first_value;  // glyph slot of the value's first character; the label sits just before
+        int label_length,
+            width,
+            decimals;
+    };
+
+    std::vector<Field>         m_fields;
+    std::vector<char>          m_glyphs;    // what each slot shows
+    std::vector<float>         m_vertices;  // each slot's quad, where the field puts it
+    std::vector<unsigned char> m_dirty;     // per slot: rebuilt since the last upload
+
+    float m_screen_size = 0.25f,
+          m_spacing     = 0.0f;
+
+    FontMetrics m_font;
+    GLuint      m_font_texture_id = 0;
+
+    // ————— GL ————— //
+    RenderBackend* m_backend = NULL;
+    Pipeline       m_pipeline;  // for the last program drawn with
+    GLuint         m_vertex_buffer = 0;
+    int            m_buffer_glyphs = 0;  // slots the buffer was made for
+    long long      m_uploaded_glyphs = 0,
+                   m_upload_calls    = 0;
+
+    void write_glyph(int slot, int row, int column, char glyph);
+    void upload_dirty();
+
+public:
+    // font_uv_rect and `font` as for TextMeshCache
+    void initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font, float screen_size, float spacing);
+    void cleanup();
+
+    // A new row, `label` then `width` characters of value, right-aligned with `decimals` places.
+    // Returns the field's index for set_value. Fields added after the first draw remake the buffer.
+    int add_field(std::string_view label, int width, int decimals);
+
+    // A value too wide for its field shows as a row of '#'
+    void set_value(int field, double value);
+
+    // `position` is the first row's first glyph, in world space. One draw.
+    void draw(ShaderProgram* program, glm::vec3 position);
+
+    int       const get_field_count()     const { return (int)m_fields.size(); };
+    long long const get_uploaded_glyphs() const { return m_uploaded_glyphs; };
+    long long const get_upload_calls()    const { return m_upload_calls; };
+};
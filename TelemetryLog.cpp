@@ -0,0 +1,145 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include "TelemetryLog.h"
+#include "Trace.h"
+
+static const char* const KIND_NAMES[TELEMETRY_KIND_COUNT] = { "frame", "physics", "input" };
+
+// frame_ms is start to start, so it covers the swap and the pacer's sleep as well as the sections
+static const char* const FRAME_FIELDS[]   = { "frame_ms", "input_ms", "update_ms", "render_ms", "steps", "allocations", "gl_draws", "gl_uploads" };
+static const char* const PHYSICS_FIELDS[] = { "x", "y", "velocity_x", "velocity_y", "fuel", "engine", "win", "loss" };
+static const char* const INPUT_FIELDS[]   = { "held_action", "autopilot", "paused", "rewinding" };
+
+static long long now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* TelemetryLog::get_kind_name(TelemetryKind kind)
+{
+    return kind < TELEMETRY_KIND_COUNT ? KIND_NAMES[kind] : "unknown";
+}
+
+const char* const* TelemetryLog::get_field_names(TelemetryKind kind, int& count)
+{
+    switch (kind)
+    {
+    case TELEMETRY_FRAME:   count = (int)(sizeof(FRAME_FIELDS) / sizeof(FRAME_FIELDS[0]));     return FRAME_FIELDS;
+    case TELEMETRY_PHYSICS: count = (int)(sizeof(PHYSICS_FIELDS) / sizeof(PHYSICS_FIELDS[0])); return PHYSICS_FIELDS;
+    case TELEMETRY_INPUT:   count = (int)(sizeof(INPUT_FIELDS) / sizeof(INPUT_FIELDS[0]));     return INPUT_FIELDS;
+    default:                count = 0;                                                          return NULL;
+    }
+}
+
+bool TelemetryLog::open(const char* filepath)
+{
+    close();
+
+    m_file = std::fopen(filepath, "wb");
+    if (m_file == NULL) return false;
+
+    TelemetryFileHeader header;
+    std::memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+    header.version     = TELEMETRY_VERSION;
+    header.record_size = sizeof(TelemetryRecord);
+    std::fwrite(&header, sizeof(header), 1, m_file);
+
+    m_start_ns      = now_ns();
+    m_dropped_count = 0;
+    m_written_count = 0;
+    m_write_failed  = false;
+    m_block.reserve(BLOCK_RECORDS);
+    m_stopping.store(false, std::memory_order_relaxed);
+    m_writer = std::thread(&TelemetryLog::writer_loop, this);
+    return true;
+}
+
+void TelemetryLog::close()
+{
+    if (m_file == NULL) return;
+
+    m_stopping.store(true, std::memory_order_release);
+    m_writer.join();
+
+    std::fclose(m_file);
+    m_file = NULL;
+}
+
+TelemetryRecord TelemetryLog::make_record(TelemetryKind kind, uint32_t frame, double time, const float* values, int value_count)
+{
+    TelemetryRecord record;
+    record.kind        = kind;
+    record.value_count = (uint16_t)std::min(std::max(value_count, 0), TELEMETRY_VALUES);
+    record.frame       = frame;
+    record.time        = time;
+    std::memcpy(record.values, values, record.value_count * sizeof(float));
+    return record;
+}
+
+bool TelemetryLog::log(TelemetryKind kind, uint32_t frame, const float* values, int value_count)
+{
+    if (m_file == NULL) return false;
+    return log(make_record(kind, frame, (double)(now_ns() - m_start_ns) * 1e-9, values, value_count));
+}
+
+bool TelemetryLog::log(const TelemetryRecord& record)
+{
+    if (m_file == NULL) return false;
+
+    if (m_ring.try_push(record)) return true;
+    m_dropped_count++;
+    return false;
+}
+
+// ————— WRITER THREAD ————— //
+void TelemetryLog::write_block()
+{
+    if (m_block.empty()) return;
+    TRACE_ZONE("TelemetryLog::write_block");
+
+    if (std::fwrite(m_block.data(), sizeof(TelemetryRecord), m_block.size(), m_file) != m_block.size()) m_write_failed = true;
+    m_written_count += (long long)m_block.size();
+    m_block.clear();
+}
+
+void TelemetryLog::writer_loop()
+{
+    TelemetryRecord popped[64];
+    while (true)
+    {
+        // Read before draining, so nothing pushed ahead of the stop is left in the ring
+        bool stopping = m_stopping.load(std::memory_order_acquire);
+
+        // STEP 1: Everything in the ring into the block, which goes out whenever it fills
+        size_t total = 0, count;
+        while ((count = m_ring.try_pop(popped, 64)) > 0)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                m_block.push_back(popped[i]);
+                if (m_block.size() == BLOCK_RECORDS) write_block();
+            }
+            total += count;
+        }
+
+        // STEP 2: The last partial block on the way out; otherwise a nap while the ring refills
+        if (stopping)
+        {
+            write_block();
+            std::fflush(m_file);
+            return;
+        }
+        if (total == 0) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+// Per-session telemetry on disk without the game thread ever touching the disk. Each sample is
+// one fixed-size binary record; log() copies it into an SpscRing and returns, and a writer
+// thread drains the ring into a block buffer that goes out in one fwrite whenever it fills. A
+// slow disk only backs the ring up, and once the ring is full log() drops the record and counts
+// it rather than wait.
+//
+// The file is a TelemetryFileHeader followed by records back to back, in the build's own byte
+// order; decode_telemetry turns one into a CSV per record kind.
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "SpscRing.h"
+
+enum TelemetryKind : uint16_t
+{
+    TELEMETRY_FRAME,    // the frame's times and counters
+    TELEMETRY_PHYSICS,  // the player's lander at the end of the frame
+    TELEMETRY_INPUT,    // the keys held as the frame ended
+    TELEMETRY_KIND_COUNT
+};
+
+const int TELEMETRY_VALUES = 8;
+
+struct TelemetryRecord
+{
+    uint16_t kind = TELEMETRY_FRAME,
+             value_count = 0;
+    uint32_t frame = 0;
+    double   time  = 0.0;  // seconds, from whenever the writer's clock starts
+    float    values[TELEMETRY_VALUES] = {};
+};
+
+struct TelemetryFileHeader
+{
+    char     magic[4];  // TELEMETRY_MAGIC
+    uint32_t version,
+             record_size;
+};
+
+const char     TELEMETRY_MAGIC[4] = { 'L', 'T', 'E', 'L' };
+const uint32_t TELEMETRY_VERSION  = 1;
+
+class TelemetryLog
+{
+private:
+    static const size_t RING_RECORDS  = 8192,  // a couple of minutes of a stalled disk at 60 fps
+                        BLOCK_RECORDS = 1024;  // 48 KB a write
+    static const int    IDLE_SLEEP_MS = 20;
+
+    SpscRing<TelemetryRecord> m_ring{ RING_RECORDS };
+    std::thread               m_writer;
+    std::atomic<bool>         m_stopping{ false };
+    FILE*                     m_file = NULL;
+
+    // ————— GAME THREAD ONLY ————— //
+    long long m_start_ns      = 0;
+    long long m_dropped_count = 0;
+
+    // ————— WRITER THREAD ONLY, READ ONCE IT'S JOINED ————— //
+    std::vector<TelemetryRecord> m_block;
+    long long m_written_count = 0;
+    bool      m_write_failed  = false;
+
+    void writer_loop();
+    void write_block();
+
+public:
+    TelemetryLog() = default;
+    TelemetryLog(const TelemetryLog&) = delete;
+    TelemetryLog& operator=(const TelemetryLog&) = delete;
+    ~TelemetryLog() { close(); }
+
+    // Writes the header and starts the writer thread; false, with nothing started, if the file
+    // can't be created
+    bool open(const char* filepath);
+
+    // Drains whatever is still in the ring, then joins the writer and closes the file
+    void close();
+
+    // Game thread only. Never blocks: false, and the record dropped, when the ring is full.
+    // `values` are the kind's fields in get_field_names' order, timed from open().
+    bool log(TelemetryKind kind, uint32_t frame, const float* values, int value_count);
+    // The same for a record already made, timed however its maker chose
+    bool log(const TelemetryRecord& record);
+
+    bool      const is_open()           const { return m_file != NULL; };
+    long long const get_dropped_count() const { return m_dropped_count; };
+    long long const get_written_count() const { return m_written_count; };  // after close()
+    bool      const has_write_failed()  const { return m_write_failed; };   // after close()
+
+    static TelemetryRecord     make_record(TelemetryKind kind, uint32_t frame, double time, const float* values, int value_count);
+    static const char*         get_kind_name(TelemetryKind kind);
+    static const char* const*  get_field_names(TelemetryKind kind, int& count);
+};
@@ -0,0 +1,189 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "Rng.h"
+#include "SimdDispatch.h"
+#include "Terrain.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TERRAIN_SIMD_SSE2 1
+#endif
+
+const float NO_GROUND = -std::numeric_limits<float>::infinity();
+
+// How strongly the walk is pulled back towards the base height each sample, so a long terrain
+// doesn't drift off the screen
+const float MEAN_REVERSION = 0.02f;
+// How far the ground may stray from the base height either way
+const float HEIGHT_RANGE = 1.5f;
+
+void Terrain::generate(const TerrainConfig& config, unsigned int seed)
+{
+    int count = std::max(config.sample_count, 2);
+    Rng rng(seed);
+
+    // STEP 1: A jagged random walk around the base height
+    std::vector<float> heights(count);
+    float height = config.base_height;
+    for (int i = 0; i < count; i++)
+    {
+        heights[i] = height;
+        height += (rng.next_float() * 2.0f - 1.0f) * config.roughness - (height - config.base_height) * MEAN_REVERSION;
+        height = std::min(std::max(height, config.base_height - HEIGHT_RANGE), config.base_height + HEIGHT_RANGE);
+    }
+
+    // STEP 2: Flatten a pad into each of pad_count even stretches, somewhere in its middle half
+    std::vector<unsigned char> pads(count - 1, 0);
+    int pad_samples = std::min(std::max(config.pad_samples, 1), count - 1);
+
+    for (int p = 0; p < config.pad_count; p++)
+    {
+        float stretch = (float)count / config.pad_count;
+        int centre = (int)((p + 0.25f + rng.next_float() * 0.5f) * stretch),
+            start  = std::min(std::max(centre - pad_samples / 2, 0), count - 1 - pad_samples);
+
+        for (int i = start; i <= start + pad_samples; i++) heights[i] = heights[start];
+        std::memset(&pads[start], 1, pad_samples);
+    }
+
+    set_samples(-(count - 1) * config.spacing / 2.0f, config.spacing, heights, pads);
+}
+
+void Terrain::set_samples(float origin_x, float spacing, const std::vector<float>& heights, const std::vector<unsigned char>& pads)
+{
+    m_origin_x = origin_x;
+    m_spacing = spacing;
+    m_inverse_spacing = 1.0f / spacing;
+    m_heights = heights;
+    m_pads = pads;
+    m_pads.resize(std::max((int)m_heights.size() - 1, 0), 0);
+}
+
+bool Terrain::carve_crater(glm::vec2 centre, float radius)
+{
+    int last = (int)m_heights.size() - 1;
+    if (last < 1) return false;
+
+    int first_sample = std::max((int)std::ceil((centre.x - radius - m_origin_x) * m_inverse_spacing), 0),
+        last_sample  = std::min((int)std::floor((centre.x + radius - m_origin_x) * m_inverse_spacing), last);
+
+    bool carved = false;
+    for (int i = first_sample; i <= last_sample; i++)
+    {
+        float dx     = m_origin_x + i * m_spacing - centre.x,
+              bottom = centre.y - std::sqrt(std::max(radius * radius - dx * dx, 0.0f));
+        if (bottom >= m_heights[i]) continue;
+
+        m_heights[i] = bottom;
+        if (i > 0)    m_pads[i - 1] = 0;
+        if (i < last) m_pads[i] = 0;
+        carved = true;
+    }
+    return carved;
+}
+
+float Terrain::get_height(float x) const
+{
+    float sample = (x - m_origin_x) * m_inverse_spacing;
+    int last = (int)m_heights.size() - 1;
+    if (last < 1 || !(sample >= 0.0f && sample <= (float)last)) return NO_GROUND;
+
+    int   segment = std::min((int)sample, last - 1);
+    float t = sample - segment;
+    return m_heights[segment] + (m_heights[segment + 1] - m_heights[segment]) * t;
+}
+
+float Terrain::max_samples_scalar(int first, int last) const
+{
+    float highest = NO_GROUND;
+    for (int i = first; i <= last; i++) highest = std::max(highest, m_heights[i]);
+    return highest;
+}
+
+float Terrain::max_samples(int first, int last) const
+{
+#ifdef TERRAIN_SIMD_SSE2
+    static const bool simd = get_simd_isa() != SIMD_SCALAR;
+    if (!simd) return max_samples_scalar(first, last);
+
+    const float* heights = m_heights.data();
+    __m128 highest = _mm_set1_ps(NO_GROUND);
+
+    int i = first;
+    for (; i + 4 <= last + 1; i += 4) highest = _mm_max_ps(highest, _mm_loadu_ps(heights + i));
+
+    // Fold the four lanes together, then take in the leftovers
+    highest = _mm_max_ps(highest, _mm_shuffle_ps(highest, highest, _MM_SHUFFLE(2, 3, 0, 1)));
+    highest = _mm_max_ps(highest, _mm_shuffle_ps(highest, highest, _MM_SHUFFLE(1, 0, 3, 2)));
+
+    float result = _mm_cvtss_f32(highest);
+    for (; i <= last; i++) result = std::max(result, heights[i]);
+    return result;
+#else
+    return max_samples_scalar(first, last);
+#endif
+}
+
+// Shared by both paths, which differ only in how they take the max over the whole samples
+template <typename MaxSamples>
+static float max_height_over(const std::vector<float>& heights, const std::vector<unsigned char>& pads, float origin_x, float inverse_spacing,
+                             float min_x, float max_x, EntityType& type, MaxSamples max_samples)
+{
+    type = DEATH_PLATFORM;
+
+    // STEP 1: The span in sample coordinates, clipped to the terrain
+    int last_sample = (int)heights.size() - 1;
+    float start = (min_x - origin_x) * inverse_spacing,
+          end   = (max_x - origin_x) * inverse_spacing;
+    if (last_sample < 1 || end < 0.0f || start > (float)last_sample) return NO_GROUND;
+
+    bool clipped = start < 0.0f || end > (float)last_sample;
+    start = std::max(start, 0.0f);
+    end   = std::min(end, (float)last_sample);
+
+    // STEP 2: The ground is straight between samples, so its highest point is at one of the
+    //         span's ends or on a sample inside it
+    auto height_at = [&](float sample)
+        {
+            int   segment = std::min((int)sample, last_sample - 1);
+            float t = sample - segment;
+            return heights[segment] + (heights[segment + 1] - heights[segment]) * t;
+        };
+
+    float highest = std::max(height_at(start), height_at(end));
+    int first_inside = (int)std::floor(start) + 1,
+        last_inside  = (int)std::ceil(end) - 1;
+    if (first_inside <= last_inside) highest = std::max(highest, max_samples(first_inside, last_inside));
+
+    // STEP 3: A WIN only when every segment under the span is pad
+    int first_segment = std::min((int)start, last_sample - 1),
+        last_segment  = std::max(first_segment, std::min((int)std::ceil(end) - 1, last_sample - 1));
+    if (!clipped && std::memchr(&pads[first_segment], 0, last_segment - first_segment + 1) == NULL) type = WIN_PLATFORM;
+
+    return highest;
+}
+
+float Terrain::get_max_height(float min_x, float max_x, EntityType& type) const
+{
+    return max_height_over(m_heights, m_pads, m_origin_x, m_inverse_spacing, min_x, max_x, type,
+                           [this](int first, int last) { return max_samples(first, last); });
+}
+
+float Terrain::get_max_height_scalar(float min_x, float max_x, EntityType& type) const
+{
+    return max_height_over(m_heights, m_pads, m_origin_x, m_inverse_spacing, min_x, max_x, type,
+                           [this](int first, int last) { return max_samples_scalar(first, last); });
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// Jagged lunar ground as a heightfield: heights sampled at a fixed spacing along x and joined by
+// straight segments, with flat landing pads here and there. Everything below the line is solid,
+// so unlike the platform boxes there is nothing to tunnel through at any timestep.
+//
+// Landing is classified the way check_collision_y classifies platforms: touching down with the
+// whole of the lander's width over a pad counts as a WIN_PLATFORM, anything else as a
+// DEATH_PLATFORM.
+#include <vector>
+#include "Entity.h"
+
+struct TerrainConfig
+{
+    int   sample_count = 4096;
+    float spacing      = 0.25f;   // along x, between samples
+    float base_height  = -2.5f;   // the ground wanders around this, the classic level's lowest tops
+    float roughness    = 0.35f;   // largest rise or fall from one sample to the next
+    int   pad_count    = 32,      // spread evenly, with some jitter
+          pad_samples  = 8;       // segments per pad, so 2 units wide at the default spacing
+};
+
+class Terrain
+{
+private:
+    float m_origin_x = 0.0f,   // x of sample 0
+          m_spacing  = 1.0f,
+          m_inverse_spacing = 1.0f;
+
+    std::vector<float>         m_heights;
+    std::vector<unsigned char> m_pads;  // per segment: 1 when it's part of a landing pad
+
+    // Over whole samples first..last inclusive
+    float max_samples_scalar(int first, int last) const;
+    float max_samples(int first, int last) const;
+
+public:
+    // Contact::index for a contact with the terrain rather than a platform
+    static const int CONTACT_INDEX = -1;
+
+    // The same (config, seed) gives the same ground everywhere; it's centred on x = 0
+    void generate(const TerrainConfig& config, unsigned int seed);
+
+    // pads holds heights.size() - 1 segment flags
+    void set_samples(float origin_x, float spacing, const std::vector<float>& heights, const std::vector<unsigned char>& pads);
+
+    // Lowers every sample under the disc to its bottom edge, and turns any pad it digs into back
+    // into ground. False if the disc never reaches below the surface.
+    bool carve_crater(glm::vec2 centre, float radius);
+
+    // The ground's height at x, between its samples; -infinity off either end
+    float get_height(float x) const;
+
+    // The highest the ground reaches anywhere over [min_x, max_x], which is -infinity where the
+    // span misses the terrain entirely. Only the samples under the span are read, and those with
+    // SSE2 where it's available. `type` is WIN_PLATFORM when every segment under the span is pad.
+    float get_max_height(float min_x, float max_x, EntityType& type) const;
+    // The same without SIMD, for checking and benchmarking against
+    float get_max_height_scalar(float min_x, float max_x, EntityType& type) const;
+
+    // ————— GETTERS ————— //
+    int          const get_sample_count() const { return (int)m_heights.size(); };
+    float        const get_origin_x()     const { return m_origin_x; };
+    float        const get_spacing()      const { return m_spacing; };
+    const float*       get_heights()      const { return m_heights.data(); };
+    const unsigned char* get_pads()       const { return m_pads.data(); };  // get_sample_count() - 1 of them
+    bool         const is_pad(int segment) const { return m_pads[segment] != 0; };
+};
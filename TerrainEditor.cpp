@@ -0,0 +1,273 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "TerrainEditor.h"
+#include "Trace.h"
+
+void TerrainEditor::initialise()
+{
+    if (m_worker.joinable()) return;
+
+    m_stopping = false;
+    m_worker = std::thread(&TerrainEditor::worker_loop, this);
+}
+
+void TerrainEditor::cleanup()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_wake.notify_all();
+
+    if (m_worker.joinable()) m_worker.join();
+    m_results.clear();
+    m_dirty_chunks.clear();
+    m_in_flight = 0;
+}
+
+void TerrainEditor::worker_loop()
+{
+    while (true)
+    {
+        ChunkResult result;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) return;
+
+            result.job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        {
+            TRACE_ZONE("rebake terrain chunk");
+            const ChunkJob& job = result.job;
+            DistanceField::bake_window(job.solid, job.columns, job.rows, job.cell_size, result.distances, result.rock_types);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+}
+
+// ————— CHUNKS ————— //
+void TerrainEditor::mark_dirty(glm::vec2 min, glm::vec2 max)
+{
+    if (m_field == NULL) return;
+
+    // Anything within a halo of the change can have a different nearest surface now
+    float cell_size = m_field->get_cell_size();
+    glm::vec2 origin = m_field->get_origin();
+    int first_column = (int)std::floor((min.x - origin.x) / cell_size) - HALO_NODES,
+        last_column  = (int)std::ceil((max.x - origin.x) / cell_size) + HALO_NODES,
+        first_row    = (int)std::floor((min.y - origin.y) / cell_size) - HALO_NODES,
+        last_row     = (int)std::ceil((max.y - origin.y) / cell_size) + HALO_NODES;
+
+    int first_chunk_column = std::max(0, first_column / CHUNK_NODES),
+        last_chunk_column  = std::min(m_chunk_columns - 1, last_column / CHUNK_NODES),
+        first_chunk_row    = std::max(0, first_row / CHUNK_NODES),
+        last_chunk_row     = std::min(m_chunk_rows - 1, last_row / CHUNK_NODES);
+
+    for (int chunk_row = first_chunk_row; chunk_row <= last_chunk_row; chunk_row++)
+    {
+        for (int chunk_column = first_chunk_column; chunk_column <= last_chunk_column; chunk_column++)
+        {
+            // A new serial even if it's already out with the worker, whose answer is now stale
+            int chunk = chunk_row * m_chunk_columns + chunk_column;
+            m_serials[chunk] = ++m_next_serial;
+            if (!m_dirty[chunk])
+            {
+                m_dirty[chunk] = 1;
+                m_dirty_chunks.push_back(chunk);
+            }
+        }
+    }
+}
+
+TerrainEditor::ChunkJob TerrainEditor::make_job(int chunk)
+{
+    ChunkJob job;
+    job.chunk = chunk;
+    job.serial = m_serials[chunk];
+    job.column = (chunk % m_chunk_columns) * CHUNK_NODES - HALO_NODES;
+    job.row = (chunk / m_chunk_columns) * CHUNK_NODES - HALO_NODES;
+    job.columns = job.rows = CHUNK_NODES + 2 * HALO_NODES;
+    job.cell_size = m_field->get_cell_size();
+    m_field->copy_solid(job.column, job.row, job.columns, job.rows, job.solid);
+
+    m_dirty[chunk] = 0;
+    return job;
+}
+
+void TerrainEditor::write_chunk(const ChunkResult& result)
+{
+    // Only the chunk itself goes back; the halo was there to be seen, not written
+    const ChunkJob& job = result.job;
+    int column  = (job.chunk % m_chunk_columns) * CHUNK_NODES,
+        row     = (job.chunk / m_chunk_columns) * CHUNK_NODES,
+        columns = std::min(CHUNK_NODES, m_field->get_columns() - column),
+        rows    = std::min(CHUNK_NODES, m_field->get_rows() - row);
+    int offset  = (row - job.row) * job.columns + (column - job.column);
+
+    m_field->write_region(column, row, columns, rows, result.distances.data() + offset, result.rock_types.data() + offset,
+                          job.columns, HALO_NODES * job.cell_size);
+    m_chunks_rebaked++;
+}
+
+// ————— EDITS ————— //
+void TerrainEditor::attach(Terrain* terrain, DistanceField* field)
+{
+    // STEP 1: Whatever the worker still has is for the last level. Queued jobs go now; anything
+    //         under way comes back with a serial nothing matches any more.
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_in_flight -= (int)m_jobs.size();
+        m_jobs.clear();
+    }
+    m_dirty_chunks.clear();
+
+    m_terrain = terrain;
+    m_field = field != NULL && field->is_editable() ? field : NULL;
+    m_carved_min_x = 0.0f;
+    m_carved_max_x = -1.0f;
+    m_version++;
+
+    // STEP 2: The level as it came in
+    if (m_terrain != NULL)
+    {
+        int count = m_terrain->get_sample_count();
+        m_original_heights.assign(m_terrain->get_heights(), m_terrain->get_heights() + count);
+        m_original_pads.assign(m_terrain->get_pads(), m_terrain->get_pads() + std::max(0, count - 1));
+    }
+
+    // STEP 3: The field's chunks, all clean
+    m_chunk_columns = m_field != NULL ? (m_field->get_columns() + CHUNK_NODES - 1) / CHUNK_NODES : 0;
+    m_chunk_rows = m_field != NULL ? (m_field->get_rows() + CHUNK_NODES - 1) / CHUNK_NODES : 0;
+    m_serials.assign(m_chunk_columns * m_chunk_rows, 0);
+    m_dirty.assign(m_chunk_columns * m_chunk_rows, 0);
+}
+
+bool TerrainEditor::carve_crater(glm::vec2 centre, float radius)
+{
+    if (m_terrain == NULL || !m_terrain->carve_crater(centre, radius)) return false;
+
+    if (m_field != NULL)
+    {
+        // Repainted from the terrain rather than carved as a disc, so the field follows the same
+        // ground, pads and all, that the heightfield now has. A sample either side covers the
+        // segments that lean into the crater.
+        float margin = m_terrain->get_spacing();
+        m_field->repaint_terrain(*m_terrain, centre.x - radius - margin, centre.x + radius + margin);
+        mark_dirty(centre - radius - margin, centre + radius + margin);
+    }
+
+    if (m_carved_max_x < m_carved_min_x)
+    {
+        m_carved_min_x = centre.x - radius;
+        m_carved_max_x = centre.x + radius;
+    }
+    else
+    {
+        m_carved_min_x = std::min(m_carved_min_x, centre.x - radius);
+        m_carved_max_x = std::max(m_carved_max_x, centre.x + radius);
+    }
+    m_version++;
+    return true;
+}
+
+void TerrainEditor::restore()
+{
+    if (m_terrain == NULL || m_carved_max_x < m_carved_min_x) return;
+
+    m_terrain->set_samples(m_terrain->get_origin_x(), m_terrain->get_spacing(), m_original_heights, m_original_pads);
+
+    if (m_field != NULL)
+    {
+        // Every row of the carved columns, since repainting them starts from nothing
+        float margin = m_terrain->get_spacing();
+        m_field->repaint_terrain(*m_terrain, m_carved_min_x - margin, m_carved_max_x + margin);
+        glm::vec2 origin = m_field->get_origin();
+        float height = m_field->get_rows() * m_field->get_cell_size();
+        mark_dirty(glm::vec2(m_carved_min_x - margin, origin.y), glm::vec2(m_carved_max_x + margin, origin.y + height));
+
+        // A replay has to collide with exactly what the first run did from its first step, so
+        // these are baked here and now rather than over the next few frames
+        for (int chunk : m_dirty_chunks)
+        {
+            ChunkResult result;
+            result.job = make_job(chunk);
+            DistanceField::bake_window(result.job.solid, result.job.columns, result.job.rows, result.job.cell_size,
+                                       result.distances, result.rock_types);
+            write_chunk(result);
+        }
+        m_dirty_chunks.clear();
+    }
+
+    m_carved_min_x = 0.0f;
+    m_carved_max_x = -1.0f;
+    m_version++;
+}
+
+void TerrainEditor::update(float budget_seconds)
+{
+    TRACE_ZONE("TerrainEditor::update");
+    auto start = std::chrono::steady_clock::now();
+    bool did_any = false;
+
+    while (true)
+    {
+        // STEP 1: Stop once the budget is spent, but never before the first chunk of the frame
+        float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        if (did_any && elapsed >= budget_seconds) break;
+
+        // STEP 2: Take one finished chunk, holding the lock only for the pop
+        ChunkResult result;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_results.empty()) break;
+
+            result = std::move(m_results.front());
+            m_results.pop_front();
+        }
+        m_in_flight--;
+
+        // STEP 3: Into the field, unless the chunk has been dug into again since it went out
+        const ChunkJob& job = result.job;
+        if (m_field != NULL && job.chunk < (int)m_serials.size() && job.serial == m_serials[job.chunk])
+        {
+            write_chunk(result);
+            did_any = true;
+        }
+    }
+
+    // STEP 4: Hand over what's dirty. Copying a window of the painting is cheap next to baking it,
+    //         so all of it goes in one lock.
+    if (!m_dirty_chunks.empty())
+    {
+        std::vector<ChunkJob> jobs;
+        jobs.reserve(m_dirty_chunks.size());
+        for (int chunk : m_dirty_chunks) jobs.push_back(make_job(chunk));
+        m_dirty_chunks.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (ChunkJob& job : jobs) m_jobs.push_back(std::move(job));
+        }
+        m_in_flight += (int)jobs.size();
+        m_wake.notify_one();
+    }
+
+    m_last_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+// Craters dug into the level while it's played. The heightfield takes a crater at once, since
+// only the samples under it change and nothing is derived from them. The distance field can't be
+// rebaked whole without a spike, so it is split into CHUNK_NODES-square chunks: a crater repaints
+// its columns of the field's kept painting and marks the chunks within HALO_NODES of it dirty,
+// and a worker thread rebakes each one from a window of the painting that much wider. update()
+// hands the worker the dirty chunks and copies finished ones back into the field, within a
+// budget, on the game thread; in the meantime collision uses the chunk as it was.
+//
+// A halo's worth of painting is all a chunk sees, so its distances are exact up to HALO_NODES
+// cells from the surface and only bounds beyond (see DistanceField::write_region). Collision
+// only ever asks near the surface.
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "DistanceField.h"
+#include "Terrain.h"
+
+class TerrainEditor
+{
+public:
+    static const int CHUNK_NODES = 32,
+                     HALO_NODES  = 8;
+
+private:
+    struct ChunkJob
+    {
+        int                        chunk;
+        unsigned int               serial;
+        int                        column, row,     // the window's corner node
+                                   columns, rows;
+        float                      cell_size;
+        std::vector<unsigned char> solid;
+    };
+
+    struct ChunkResult
+    {
+        ChunkJob                   job;
+        std::vector<float>         distances;       // the whole window's
+        std::vector<unsigned char> rock_types;
+    };
+
+    std::thread m_worker;
+
+    // ————— SHARED WITH THE WORKER ————— //
+    std::mutex              m_mutex;
+    std::condition_variable m_wake;
+    std::deque<ChunkJob>    m_jobs;
+    std::deque<ChunkResult> m_results;
+    bool                    m_stopping = false;
+
+    // ————— GAME THREAD ONLY ————— //
+    Terrain*       m_terrain = NULL;
+    DistanceField* m_field   = NULL;  // NULL unless editable
+    int            m_chunk_columns = 0,
+                   m_chunk_rows    = 0;
+    std::vector<unsigned int>  m_serials;  // per chunk, bumped whenever it's dirtied again
+    std::vector<unsigned char> m_dirty;    // per chunk: waiting to be handed to the worker
+    std::vector<int>           m_dirty_chunks;
+    unsigned int               m_next_serial = 0;  // never reused, so nothing from an old level matches
+    int                        m_in_flight = 0;
+
+    // The level as it was loaded, for restore()
+    std::vector<float>         m_original_heights;
+    std::vector<unsigned char> m_original_pads;
+    float m_carved_min_x = 0.0f,
+          m_carved_max_x = -1.0f;  // empty until the first crater
+
+    int       m_version = 0;  // bumped by every crater and restore
+    long long m_chunks_rebaked = 0;
+    float     m_last_ms = 0.0f;
+
+    void worker_loop();
+    void mark_dirty(glm::vec2 min, glm::vec2 max);
+    ChunkJob make_job(int chunk);
+    void write_chunk(const ChunkResult& result);
+
+public:
+    TerrainEditor() = default;
+    TerrainEditor(const TerrainEditor&) = delete;
+    TerrainEditor& operator=(const TerrainEditor&) = delete;
+    ~TerrainEditor() { cleanup(); }
+
+    void initialise();
+    // Joins the worker; chunks still being rebaked are dropped
+    void cleanup();
+
+    // Game thread, whenever a level comes in. `field` is ignored unless it was baked with
+    // keep_solid; work left over from the last level is dropped.
+    void attach(Terrain* terrain, DistanceField* field);
+
+    // Game thread. Digs a crater of `radius` around `centre` out of the terrain and the field;
+    // false, changing nothing, where it misses the ground.
+    bool carve_crater(glm::vec2 centre, float radius);
+
+    // Game thread. Puts every crater back as the level was attached, e.g. to replay it.
+    void restore();
+
+    // Game thread, once a frame: copies in what the worker finished and hands it what's dirty,
+    // stopping after budget_seconds
+    void update(float budget_seconds);
+
+    bool      const is_attached()         const { return m_terrain != NULL; };
+    int       const get_version()         const { return m_version; };
+    int       const get_pending_chunks()  const { return (int)m_dirty_chunks.size() + m_in_flight; };
+    long long const get_chunks_rebaked()  const { return m_chunks_rebaked; };
+    float     const get_last_ms()         const { return m_last_ms; };
+};
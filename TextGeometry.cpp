@@ -0,0 +1,87 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include <algorithm>
+#include "TextGeometry.h"
+#include "Utf8.h"
+
+unsigned char get_font_glyph(char32_t code)
+{
+    return code < 0x80 ? (unsigned char)code : '?';
+}
+
+void build_glyph_vertices(const GlyphMetrics& glyph, float pen_x, float screen_size, float* vertices)
+{
+    const glm::vec4& uv_rect = glyph.uv_rect;
+    float u_coordinate = uv_rect.x,
+          v_coordinate = uv_rect.y,
+          width        = uv_rect.z,
+          height       = uv_rect.w;
+
+    float left   = pen_x + glyph.bearing.x * screen_size,
+          right  = left + glyph.size.x * screen_size,
+          top    = glyph.bearing.y * screen_size,
+          bottom = top - glyph.size.y * screen_size;
+
+    // Two triangles, position and UV interleaved
+    float quad[] =
+    {
+        left,  top,    u_coordinate,         v_coordinate,
+        left,  bottom, u_coordinate,         v_coordinate + height,
+        right, top,    u_coordinate + width, v_coordinate,
+        right, bottom, u_coordinate + width, v_coordinate + height,
+        right, top,    u_coordinate + width, v_coordinate,
+        left,  bottom, u_coordinate,         v_coordinate + height,
+    };
+
+    std::copy(std::begin(quad), std::end(quad), vertices);
+}
+
+int build_text_vertices(const FontMetrics& font, std::string_view text, float screen_size, float spacing, float* vertices)
+{
+    // The pen starts at the left edge of the first glyph's cell
+    float pen_x = -0.5f * screen_size;
+    int count = 0;
+
+    size_t index = 0;
+    while (index < text.size())
+    {
+        // 1. The glyph's metrics, looked up by its code point
+        unsigned char code = get_font_glyph(decode_utf8(text, index));
+        const GlyphMetrics& glyph = font.get_glyph(code);
+
+        // 2. Its quad, from wherever the pen has got to
+        build_glyph_vertices(glyph, pen_x, screen_size, vertices + count * TEXT_VERTICES_PER_GLYPH * TEXT_FLOATS_PER_VERTEX);
+        count++;
+
+        // 3. On by its advance, tightened or loosened against the next glyph
+        float advance = glyph.advance;
+        size_t next = index;
+        if (next < text.size()) advance += font.get_kerning(code, get_font_glyph(decode_utf8(text, next)));
+        pen_x += advance * screen_size + spacing;
+    }
+    return count;
+}
+
+float measure_text(const FontMetrics& font, std::string_view text, float screen_size, float spacing)
+{
+    float width = 0.0f;
+    size_t index = 0;
+    while (index < text.size())
+    {
+        unsigned char code = get_font_glyph(decode_utf8(text, index));
+        width += font.get_glyph(code).advance * screen_size;
+
+        size_t next = index;
+        if (next < text.size()) width += font.get_kerning(code, get_font_glyph(decode_utf8(text, next))) * screen_size + spacing;
+    }
+    return width;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// The CPU half of drawing text: one textured quad per character, laid out along x from the font's
+// metrics. Kept free of GL so the bench can time it on its own; TextMeshCache uploads what this builds.
+// Text is UTF-8; the font only has ASCII, so anything past it is laid out as a '?' here (the
+// render queue's batched text draws it properly, out of GlyphCache).
+#include <string_view>
+#include "glm/mat4x4.hpp"
+#include "FontMetrics.h"
+
+const int TEXT_FLOATS_PER_VERTEX  = 4,  // x, y, u, v
+          TEXT_VERTICES_PER_GLYPH = 6;
+
+// `vertices` must hold text.size() * TEXT_VERTICES_PER_GLYPH * TEXT_FLOATS_PER_VERTEX floats,
+// enough for a glyph a byte. The first glyph's cell is centred on the origin, as the grid sheet
+// always drew. A glyph with nothing to draw still gets its quad, collapsed to a point, so every
+// character keeps its slot. Returns how many glyphs (code points) it built.
+int build_text_vertices(const FontMetrics& font, std::string_view text, float screen_size, float spacing, float* vertices);
+
+// The font's glyph for a code point: its own for ASCII, '?' for the rest
+unsigned char get_font_glyph(char32_t code);
+
+// From the left edge of the first glyph's cell to the right edge of the last's, as laid out above
+float measure_text(const FontMetrics& font, std::string_view text, float screen_size, float spacing);
+
+// One glyph's quad with the pen at `pen_x`, for text laid out some other way (see TelemetryHud)
+void build_glyph_vertices(const GlyphMetrics& glyph, float pen_x, float screen_size, float* vertices);
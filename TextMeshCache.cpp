@@ -0,0 +1,163 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "TextMeshCache.h"
+#include "Utf8.h"
+
+void TextMeshCache::initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font)
+{
+    m_font_texture_id = font_texture_id;
+    m_font_uv_rect = font_uv_rect;
+    m_font = font;
+    m_font.place(font_uv_rect);
+
+    m_backend = get_render_backend();
+    m_transient.initialise(GL_ARRAY_BUFFER, TRANSIENT_BYTES);
+}
+
+void TextMeshCache::cleanup()
+{
+    for (auto& entry : m_meshes) m_backend->delete_buffer(entry.second.vertex_buffer);
+    m_meshes.clear();
+
+    for (Pipeline& pipeline : m_pipelines) m_backend->delete_pipeline(pipeline);
+    m_pipelines.clear();
+
+    m_transient.cleanup();
+}
+
+glm::vec4 TextMeshCache::get_glyph_uv_rect(unsigned char glyph) const
+{
+    return m_font.get_glyph(glyph).uv_rect;
+}
+
+int TextMeshCache::write_glyph_quads(std::string_view text, float screen_size, float spacing, glm::vec3 position, SpriteQuad* quads) const
+{
+    // Laid out as build_text_vertices does, but as centred quads in the world. ASCII is the font's;
+    // anything past it comes out of the glyph cache as a plain sprite.
+    float pen_x = position.x - 0.5f * screen_size;
+    int count = 0;
+
+    size_t index = 0;
+    while (index < text.size())
+    {
+        char32_t code = decode_utf8(text, index);
+
+        if (code >= 0x80 && m_glyph_cache != NULL)
+        {
+            // Left out, though not its space, for a frame or so while the cache catches up
+            const CachedGlyph* glyph = m_glyph_cache->get(code);
+            if (glyph != NULL)
+            {
+                glm::vec2 size     = glyph->size * screen_size,
+                          top_left = glm::vec2(pen_x, position.y) + glyph->bearing * screen_size;
+                quads[count++] = { top_left + glm::vec2(0.5f, -0.5f) * size, size, glyph->uv_rect, glyph->texture_id, 0.0f };
+            }
+            pen_x += m_glyph_cache->get_advance(code) * screen_size + spacing;
+            continue;
+        }
+
+        unsigned char font_glyph = get_font_glyph(code);
+        const GlyphMetrics& glyph = m_font.get_glyph(font_glyph);
+        if (glyph.size.x > 0.0f && glyph.size.y > 0.0f)
+        {
+            glm::vec2 size     = glyph.size * screen_size,
+                      top_left = glm::vec2(pen_x, position.y) + glyph.bearing * screen_size;
+            quads[count++] = { top_left + glm::vec2(0.5f, -0.5f) * size, size, glyph.uv_rect, m_font_texture_id, GLYPH_QUAD_LAYER };
+        }
+
+        float advance = glyph.advance;
+        size_t next = index;
+        if (next < text.size()) advance += m_font.get_kerning(font_glyph, get_font_glyph(decode_utf8(text, next)));
+        pen_x += advance * screen_size + spacing;
+    }
+    return count;
+}
+
+int TextMeshCache::build_vertices(std::string_view text, float screen_size, float spacing, float* vertices) const
+{
+    return build_text_vertices(m_font, text, screen_size, spacing, vertices);
+}
+
+const Pipeline& TextMeshCache::get_pipeline(ShaderProgram* program)
+{
+    for (const Pipeline& pipeline : m_pipelines)
+    {
+        if (pipeline.program == program) return pipeline;
+    }
+
+    VertexLayout layout;
+    layout.stride = FLOATS_PER_VERTEX * sizeof(float);
+    layout.add(program->get_position_attribute(), 2, 0)
+          .add(program->get_tex_coordinate_attribute(), 2, 2 * sizeof(float));
+
+    m_pipelines.emplace_back();
+    m_backend->create_pipeline(m_pipelines.back(), program, layout);
+    return m_pipelines.back();
+}
+
+void TextMeshCache::draw_buffer(ShaderProgram* program, GLuint vertex_buffer, size_t offset, int vertex_count, glm::vec3 position)
+{
+    // begin_draws makes the program current, which the cached transform setter relies on. Each mesh
+    // has its own buffer, so the pipeline is pointed at it afresh.
+    m_backend->begin_draws(get_pipeline(program), vertex_buffer, offset);
+    program->set_model_transform(ModelTransform::make(glm::vec2(position)));
+
+    m_backend->bind_texture(GL_TEXTURE_2D, m_font_texture_id);
+    m_backend->draw_triangles(0, vertex_count);
+    m_backend->end_draws();
+}
+
+void TextMeshCache::draw(ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position)
+{
+    if (text.empty()) return;
+
+    auto found = m_meshes.find(KeyView{ text, screen_size, spacing });
+    if (found != m_meshes.end())
+    {
+        draw_buffer(program, found->second.vertex_buffer, 0, found->second.vertex_count, position);
+        return;
+    }
+
+    // A cache full of one-off strings is better served by the scratch path than by evicting
+    if ((int)m_meshes.size() >= MAX_CACHED_MESHES)
+    {
+        draw_transient(program, text, screen_size, spacing, position);
+        return;
+    }
+
+    // First sighting: build once into a static buffer that every later frame reuses
+    std::vector<float> vertices(text.size() * VERTICES_PER_GLYPH * FLOATS_PER_VERTEX);
+    int vertex_count = build_vertices(text, screen_size, spacing, vertices.data()) * VERTICES_PER_GLYPH;
+    vertices.resize((size_t)vertex_count * FLOATS_PER_VERTEX);
+
+    TextMesh mesh = { 0, vertex_count };
+    mesh.vertex_buffer = m_backend->create_buffer(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+    m_meshes.emplace(Key{ std::string(text), screen_size, spacing }, mesh);
+
+    draw_buffer(program, mesh.vertex_buffer, 0, mesh.vertex_count, position);
+}
+
+void TextMeshCache::draw_transient(ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position)
+{
+    if (text.empty()) return;
+
+    // Never waits on a previous frame's draw, whichever way the stream uploads. Room for a glyph a
+    // byte; multi-byte characters leave some of it unused.
+    float* vertices = (float*)m_transient.write(text.size() * VERTICES_PER_GLYPH * FLOATS_PER_VERTEX * sizeof(float));
+    int vertex_count = build_vertices(text, screen_size, spacing, vertices) * VERTICES_PER_GLYPH;
+    size_t offset = m_transient.commit();
+
+    draw_buffer(program, m_transient.get_buffer(), offset, vertex_count, position);
+}
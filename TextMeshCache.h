@@ -0,0 +1,114 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <map>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "RenderBackend.h"
+#include "ShaderProgram.h"
+#include "FontMetrics.h"
+#include "GlyphCache.h"
+#include "PipelineWarmup.h"
+#include "SpriteBatch.h"
+#include "StreamBuffer.h"
+#include "TextGeometry.h"
+
+class TextMeshCache
+{
+private:
+    static const int FLOATS_PER_VERTEX  = TEXT_FLOATS_PER_VERTEX,
+                     VERTICES_PER_GLYPH = TEXT_VERTICES_PER_GLYPH,
+                     MAX_CACHED_MESHES  = 256;
+    static const size_t  TRANSIENT_BYTES    = 64 * 1024;  // a frame of profiler text, before the stream grows
+
+    struct TextMesh
+    {
+        GLuint vertex_buffer;
+        int    vertex_count;
+    };
+
+    struct Key
+    {
+        std::string text;
+        float       screen_size;
+        float       spacing;
+    };
+
+    struct KeyView
+    {
+        std::string_view text;
+        float            screen_size;
+        float            spacing;
+    };
+
+    // Transparent comparator, so lookups can use a KeyView and never build a std::string
+    struct KeyLess
+    {
+        using is_transparent = void;
+
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const
+        {
+            return std::make_tuple(std::string_view(a.text), a.screen_size, a.spacing) <
+                   std::make_tuple(std::string_view(b.text), b.screen_size, b.spacing);
+        }
+    };
+
+    std::map<Key, TextMesh, KeyLess> m_meshes;
+
+    // Every transient string's vertices, built straight into it
+    StreamBuffer m_transient;
+
+    RenderBackend*        m_backend = NULL;
+    std::vector<Pipeline> m_pipelines;  // one per program drawn with, bitmap and SDF
+
+    GLuint    m_font_texture_id = 0;
+    glm::vec4 m_font_uv_rect    = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+    // The font's metrics, its UVs placed inside m_font_uv_rect
+    FontMetrics m_font;
+
+    GlyphCache* m_glyph_cache = NULL;  // for write_glyph_quads' characters past ASCII
+
+    int  build_vertices(std::string_view text, float screen_size, float spacing, float* vertices) const;
+    const Pipeline& get_pipeline(ShaderProgram* program);
+    void draw_buffer(ShaderProgram* program, GLuint vertex_buffer, size_t offset, int vertex_count, glm::vec3 position);
+
+public:
+    // font_uv_rect is where the font's texture sits inside font_texture_id, e.g. a region of the
+    // atlas, and `font` its metrics: the 16x16 grid, or a packed atlas's. The geometry is the same
+    // for a bitmap or an SDF sheet; only the program drawing it differs.
+    void initialise(GLuint font_texture_id, glm::vec4 font_uv_rect, const FontMetrics& font);
+    void cleanup();
+
+    // Geometry is built into its own buffer the first time a (text, size, spacing) is drawn
+    void draw(ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position);
+
+    // For text that changes every frame: rebuilt each call into a stream buffer, no allocations
+    void draw_transient(ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position);
+
+    // Makes and draws the pipeline for `program` ahead of its first string
+    void warm_up(PipelineWarmup& warmup, ShaderProgram* program) { warmup.warm_up(get_pipeline(program)); };
+
+    // Characters past ASCII in write_glyph_quads come out of `glyph_cache`. Without one, and in the
+    // meshes draw() and draw_transient() build, they're drawn as '?'.
+    void set_glyph_cache(GlyphCache* glyph_cache) { m_glyph_cache = glyph_cache; };
+
+    // The text as sprites for a SHADER_GLYPHS batch: one quad per glyph with anything to draw, the
+    // font's marked as SDF glyphs by their layer and the glyph cache's as plain sprites, into
+    // `quads` (room for text.size()). Returns how many.
+    int write_glyph_quads(std::string_view text, float screen_size, float spacing, glm::vec3 position, SpriteQuad* quads) const;
+
+    // Where one glyph sits in the UV-plane, for borrowing it as a sprite
+    glm::vec4 get_glyph_uv_rect(unsigned char glyph) const;
+
+    GLuint const get_font_texture_id() const { return m_font_texture_id; };
+    int const get_cached_mesh_count() const { return (int)m_meshes.size(); };
+};
@@ -0,0 +1,53 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "TextureArray.h"
+#include "TextureSampling.h"
+
+GLuint create_frame_array(const unsigned char* pixels, int width, int height, int columns, int rows, bool generate_mipmaps)
+{
+    const int frame_width  = columns > 0 ? width / columns : 0,
+              frame_height = rows > 0 ? height / rows : 0;
+    if (!supports_texture_arrays() || frame_width < 1 || frame_height < 1) return 0;
+
+    GLuint texture_id;
+    glGenTextures(1, &texture_id);
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, texture_id);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, frame_width, frame_height, columns * rows, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    track_gpu_texture(texture_id, estimate_texture_bytes(frame_width, frame_height * columns * rows, generate_mipmaps));
+
+    // Each layer is read straight out of the sheet: the row length steps over the frames beside it
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, width);
+    for (int index = 0; index < columns * rows; index++)
+    {
+        glPixelStorei(GL_UNPACK_SKIP_PIXELS, (index % columns) * frame_width);
+        glPixelStorei(GL_UNPACK_SKIP_ROWS, (index / columns) * frame_height);
+
+        count_gl_call(GL_CALL_UPLOAD);
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, index, frame_width, frame_height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+
+    // Clamped, so a frame's edge texels never filter against the opposite edge
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    prepare_mip_chain(texture_id, generate_mipmaps, 1000, GL_TEXTURE_2D_ARRAY);
+    apply_sampler_preset(texture_id, SAMPLER_PIXEL_ART, GL_TEXTURE_2D_ARRAY);
+    return texture_id;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Sprite sheets as GL_TEXTURE_2D_ARRAYs, one frame per layer. A frame is a whole layer, so
+// sampling at a sub-pixel position or from a smaller mip never pulls in its neighbours, and the
+// frames need no padding between them. Drawn through SHADER_LAYERED, with the frame index as the
+// layer (see RenderQueue::submit_layered_sprite), so every frame of every sheet of one size shares
+// a bind and needs no UV maths.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include "SpriteSheet.h"
+
+// `pixels` is RGBA, `columns` x `rows` frames of equal size in the same order as SheetLayout. A sheet
+// that doesn't divide evenly (assets/ship.png is 61 wide) loses the leftover texels on its right and
+// bottom edges. Returns 0 without supports_texture_arrays().
+GLuint create_frame_array(const unsigned char* pixels, int width, int height, int columns, int rows, bool generate_mipmaps);
+
+template <int COLUMNS, int ROWS>
+GLuint create_frame_array(const SheetLayout<COLUMNS, ROWS>&, const unsigned char* pixels, int width, int height, bool generate_mipmaps)
+{
+    return create_frame_array(pixels, width, height, COLUMNS, ROWS, generate_mipmaps);
+}
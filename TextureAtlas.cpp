@@ -0,0 +1,190 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include "stb_image.h"
+#include "RenderBackend.h"
+#include "TextureAtlas.h"
+#include "Trace.h"
+
+static int next_power_of_two(int value)
+{
+    int result = 1;
+    while (result < value) result *= 2;
+    return result;
+}
+
+int TextureAtlas::add_image(const char* filepath)
+{
+    TRACE_ZONE("TextureAtlas::add_image");
+    int width, height, number_of_components;
+    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+
+    if (image == NULL)
+    {
+        std::cout << "Unable to load image " << filepath << ". Make sure the path is correct." << std::endl;
+        assert(false);
+    }
+
+    m_pending.push_back({ filepath, width, height, image, true });
+    m_regions.push_back({ 0, 0, width, height, glm::vec4(0.0f), TRANSLUCENT_MATERIAL });
+
+    return (int)m_regions.size() - 1;
+}
+
+int TextureAtlas::add_pixels(const char* name, int width, int height, const unsigned char* pixels)
+{
+    m_pending.push_back({ name, width, height, pixels, false });
+    m_regions.push_back({ 0, 0, width, height, glm::vec4(0.0f), TRANSLUCENT_MATERIAL });
+
+    return (int)m_regions.size() - 1;
+}
+
+bool TextureAtlas::pack(int page_width, int page_height, int padding, int& used_height)
+{
+    // Shelf packing: tallest images first, left to right, opening a new shelf when a row is full
+    std::vector<int> order(m_pending.size());
+    for (int i = 0; i < (int)order.size(); i++) order[i] = i;
+
+    std::sort(order.begin(), order.end(), [this](int a, int b)
+        {
+            if (m_pending[a].height != m_pending[b].height) return m_pending[a].height > m_pending[b].height;
+            return m_pending[a].width > m_pending[b].width;
+        });
+
+    int shelf_x = 0,
+        shelf_y = 0,
+        shelf_height = 0;
+
+    for (int index : order)
+    {
+        int cell_width  = m_pending[index].width + 2 * padding,
+            cell_height = m_pending[index].height + 2 * padding;
+
+        if (cell_width > page_width) return false;
+
+        if (shelf_x + cell_width > page_width)
+        {
+            shelf_y += shelf_height;
+            shelf_x = 0;
+            shelf_height = 0;
+        }
+
+        if (shelf_y + cell_height > page_height) return false;
+
+        m_regions[index].x = shelf_x + padding;
+        m_regions[index].y = shelf_y + padding;
+
+        shelf_x += cell_width;
+        shelf_height = std::max(shelf_height, cell_height);
+    }
+
+    used_height = shelf_y + shelf_height;
+    return true;
+}
+
+void TextureAtlas::build(int padding, bool generate_mipmaps)
+{
+    TRACE_ZONE("TextureAtlas::build");
+    GLint max_texture_size;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+
+    // STEP 1: Start from the smallest page that could hold the biggest image and grow until everything fits
+    int page_width = 1, page_height = 1;
+    for (const PendingImage& image : m_pending)
+    {
+        page_width  = std::max(page_width,  next_power_of_two(image.width + 2 * padding));
+        page_height = std::max(page_height, next_power_of_two(image.height + 2 * padding));
+    }
+
+    int used_height = 0;
+    while (!pack(page_width, page_height, padding, used_height))
+    {
+        if (page_width <= page_height) page_width *= 2;
+        else                           page_height *= 2;
+
+        if (page_width > max_texture_size || page_height > max_texture_size)
+        {
+            std::cout << "Texture atlas does not fit in a " << max_texture_size << "px page." << std::endl;
+            assert(false);
+        }
+    }
+
+    // The width stays a power of two, but the height is trimmed to what the shelves actually use.
+    // Non-power-of-two pages are fine here because the page is clamped and never wrapped.
+    m_width = page_width;
+    m_height = used_height;
+
+    // STEP 2: Copy every image into the page, extruding its edge texels into the padding so that
+    //         neighbouring sprites never bleed into each other at sub-pixel positions
+    std::vector<unsigned char> page(m_width * m_height * 4, 0);
+
+    for (int i = 0; i < (int)m_pending.size(); i++)
+    {
+        const PendingImage& image = m_pending[i];
+        AtlasRegion& region = m_regions[i];
+
+        for (int y = -padding; y < image.height + padding; y++)
+        {
+            int source_y = std::min(std::max(y, 0), image.height - 1);
+
+            for (int x = -padding; x < image.width + padding; x++)
+            {
+                int source_x = std::min(std::max(x, 0), image.width - 1);
+
+                const unsigned char* source = &image.pixels[(source_y * image.width + source_x) * 4];
+                unsigned char* destination = &page[((region.y + y) * m_width + region.x + x) * 4];
+                std::copy(source, source + 4, destination);
+            }
+        }
+
+        region.uv_rect = glm::vec4((float)region.x / m_width, (float)region.y / m_height,
+                                   (float)region.width / m_width, (float)region.height / m_height);
+        region.material = classify_material(image.pixels, image.width, image.height, image.width * 4);
+
+        if (image.owned) stbi_image_free((void*)image.pixels);
+    }
+
+    m_pending.clear();
+
+    // STEP 3: Upload the page once, with room for as many mip levels as the padding keeps clean.
+    //         The backend clamps to the edge: wrapping would pull in the neighbouring sprites.
+    int max_level = 0;
+    while ((2 << max_level) <= padding) max_level++;
+
+    m_texture_id = get_render_backend()->create_texture(m_width, m_height, generate_mipmaps ? max_level + 1 : 1, page.data());
+
+    m_has_mipmaps = prepare_mip_chain(m_texture_id, generate_mipmaps, max_level);
+    apply_sampler_preset(m_texture_id, m_sampler);
+}
+
+void TextureAtlas::set_sampler_preset(SamplerPreset preset)
+{
+    if (preset == m_sampler) return;
+
+    m_sampler = preset;
+    if (m_texture_id != 0) apply_sampler_preset(m_texture_id, m_sampler);
+}
+
+void TextureAtlas::cleanup()
+{
+    for (const PendingImage& image : m_pending)
+    {
+        if (image.owned) stbi_image_free((void*)image.pixels);
+    }
+    m_pending.clear();
+
+    if (m_texture_id != 0) get_render_backend()->delete_texture(m_texture_id);
+    m_texture_id = 0;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "RenderMaterial.h"
+#include "TextureSampling.h"
+
+struct AtlasRegion
+{
+    int x, y,
+        width, height;    // in texels, excluding padding
+    glm::vec4 uv_rect;    // u, v, width, height in the UV-plane of the page
+    RenderMaterial material;  // from the image's alpha, set by build()
+};
+
+class TextureAtlas
+{
+private:
+    struct PendingImage
+    {
+        std::string    filepath;
+        int            width, height;
+        const unsigned char* pixels;  // RGBA
+        bool                 owned;   // decoded by stb_image here, so build() frees it
+    };
+
+    std::vector<PendingImage> m_pending;
+    std::vector<AtlasRegion>  m_regions;
+
+    GLuint        m_texture_id  = 0;
+    int           m_width       = 0,
+                  m_height      = 0;
+    bool          m_has_mipmaps = false;
+    SamplerPreset m_sampler     = SAMPLER_PIXEL_ART;
+
+    bool pack(int page_width, int page_height, int padding, int& used_height);
+
+public:
+    static const int DEFAULT_PADDING = 2;  // texels of extruded border around every image
+
+    // Decodes the image and queues it for packing; returns the region handle to use after build()
+    int  add_image(const char* filepath);
+
+    // Queues already-decoded RGBA pixels (e.g. straight out of a mapped AssetPack) without copying
+    // them; they must stay valid until build() has run
+    int  add_pixels(const char* name, int width, int height, const unsigned char* pixels);
+
+    // Packs every queued image into the smallest page that fits and uploads it. Mip levels only go
+    // as deep as the padding allows: level n halves it n times, so past log2(padding) neighbouring
+    // sprites would start to bleed into each other.
+    void build(int padding = DEFAULT_PADDING, bool generate_mipmaps = false);
+
+    // No-op unless the preset actually changes
+    void set_sampler_preset(SamplerPreset preset);
+    void cleanup();
+
+    const AtlasRegion& get_region(int region) const { return m_regions[region]; };
+    GLuint const get_texture_id() const { return m_texture_id; };
+    int    const get_width()      const { return m_width; };
+    int    const get_height()     const { return m_height; };
+    bool   const has_mipmaps()    const { return m_has_mipmaps; };
+};
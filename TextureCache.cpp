@@ -0,0 +1,382 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include "stb_image.h"
+#include "CompressedTexture.h"
+#include "GLCapabilities.h"
+#include "TextureSampling.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "TextureCache.h"
+#include "Trace.h"
+
+const int NUMBER_OF_TEXTURES = 1;  // to be generated, that is
+const GLint LEVEL_OF_DETAIL = 0;  // base image level; Level n is the nth mipmap reduction image
+const GLint TEXTURE_BORDER = 0;  // this value MUST be zero
+
+// Into an existing texture, so an evicted one comes back under the same id
+static void upload_texture(GLuint texture_id, const char* filepath, const AssetPack* asset_pack, bool generate_mipmaps, int& width, int& height)
+{
+    const AssetPackEntry* packed = asset_pack != NULL ? asset_pack->find(filepath) : NULL;
+    unsigned char* decoded = NULL;
+    const unsigned char* image;
+
+    if (packed != NULL)
+    {
+        // Uploaded straight from the mapped pages: no inflate, no unfiltering, no intermediate copy
+        width = (int)packed->width;
+        height = (int)packed->height;
+        image = asset_pack->get_pixels(*packed);
+    }
+    else
+    {
+        int number_of_components;
+        decoded = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+        image = decoded;
+
+        if (image == NULL)
+        {
+            std::cout << "Unable to load image " << filepath << ". Make sure the path is correct." << std::endl;
+            assert(false);
+        }
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    track_gpu_texture(texture_id, estimate_texture_bytes(width, height, generate_mipmaps));
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    prepare_mip_chain(texture_id, generate_mipmaps);
+
+    if (decoded != NULL) stbi_image_free(decoded);
+}
+
+// The pack's levels from `level` on as GL's 0 and down, so GL sees a complete chain of whatever is
+// in and nothing has to track a base level. ES has no MAX_LEVEL to cut the chain short, and its
+// textures never sample mips anyway (see prepare_mip_chain), so it only takes the one level.
+// `previous_levels` is how many the texture held before, so the ones past the new chain are emptied.
+static long long upload_pack_levels(GLuint texture_id, const AssetPack& asset_pack, const AssetPackEntry& entry, int level, int previous_levels)
+{
+    int level_count = is_gles() ? 1 : (int)entry.mip_levels - level;
+    long long bytes = 0;
+
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    for (int i = 0; i < level_count; i++)
+    {
+        count_gl_call(GL_CALL_UPLOAD);
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, (GLsizei)AssetPack::get_mip_extent(entry.width, level + i), (GLsizei)AssetPack::get_mip_extent(entry.height, level + i),
+                     TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, asset_pack.get_mip_pixels(entry, level + i));
+        bytes += (long long)AssetPack::get_mip_bytes(entry, level + i);
+    }
+    for (int i = level_count; i < previous_levels; i++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, 0, 0, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    if (!is_gles()) glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, level_count - 1);
+
+    track_gpu_texture(texture_id, bytes);
+    return bytes;
+}
+
+// Looks for a pre-compressed sibling of the PNG, e.g. assets/rock.bc7.ktx2 for assets/rock.png, and
+// takes the first one whose format this GL can sample. Block-compressed files are 4-8x smaller
+// in VRAM and upload without any decode. A texture_id of 0 gets a new texture.
+static bool upload_compressed_variant(const char* filepath, GLuint& texture_id, int& width, int& height)
+{
+    static const char* const VARIANTS[] = { ".bc7.ktx2", ".bc3.ktx2", ".bc1.ktx2", ".etc2.ktx2", ".ktx2" };
+
+    std::string stem = filepath;
+    size_t extension = stem.find_last_of('.');
+    if (extension != std::string::npos && stem.find_first_of("/\\", extension) == std::string::npos) stem.erase(extension);
+
+    CompressedTexture texture;
+    for (const char* variant : VARIANTS)
+    {
+        if (!load_ktx2((stem + variant).c_str(), texture)) continue;
+        if (!supports_compressed_format(texture.internal_format)) continue;
+
+        texture_id = upload_compressed_texture(texture, texture_id);
+        width = texture.width;
+        height = texture.height;
+        return true;
+    }
+
+    return false;
+}
+
+GLuint TextureCache::acquire(const char* filepath)
+{
+    auto found = m_entries.find(filepath);
+    if (found != m_entries.end())
+    {
+        // Hit: no decode and no upload, just another user of the same texture
+        found->second.reference_count++;
+        m_hits++;
+        return found->second.texture_id;
+    }
+
+    TRACE_ZONE("TextureCache::acquire miss");
+    Entry entry = {};
+    bool packed = m_asset_pack != NULL && m_asset_pack->find(filepath) != NULL;
+
+    if (!packed && upload_compressed_variant(filepath, entry.texture_id, entry.width, entry.height))
+    {
+        entry.compressed = true;
+        // Already in its final GPU format, nothing left to decode
+    }
+    else if (m_texture_loader != NULL && !packed)
+    {
+        // Dimensions aren't known until the decode lands; the placeholder is 1x1
+        entry.texture_id = m_texture_loader->request(filepath);
+        entry.width = entry.height = 1;
+    }
+    else
+    {
+        glGenTextures(NUMBER_OF_TEXTURES, &entry.texture_id);
+        upload_texture(entry.texture_id, filepath, m_asset_pack, m_generate_mipmaps, entry.width, entry.height);
+    }
+    entry.reference_count = 1;
+    entry.resident = true;
+    entry.last_used_frame = m_frame;
+
+    // Every path above leaves pixel-art filtering, so only a different preset needs applying
+    if (m_sampler != SAMPLER_PIXEL_ART) apply_sampler_preset(entry.texture_id, m_sampler);
+
+    m_entries[filepath] = entry;
+    m_paths[entry.texture_id] = filepath;
+    m_misses++;
+
+    return entry.texture_id;
+}
+
+GLuint TextureCache::acquire_streamed(const char* filepath)
+{
+    const AssetPackEntry* packed = m_asset_pack != NULL ? m_asset_pack->find(filepath) : NULL;
+    if (packed == NULL || m_entries.count(filepath) > 0) return acquire(filepath);
+
+    Entry entry = {};
+    glGenTextures(NUMBER_OF_TEXTURES, &entry.texture_id);
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindTexture(GL_TEXTURE_2D, entry.texture_id);
+    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, 1, 1, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, AsyncTextureLoader::PLACEHOLDER_TEXEL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    track_gpu_texture(entry.texture_id, estimate_texture_bytes(1, 1));
+    prepare_mip_chain(entry.texture_id, false);
+    apply_sampler_preset(entry.texture_id, m_sampler);
+
+    entry.width = (int)packed->width;
+    entry.height = (int)packed->height;
+    entry.reference_count = 1;
+    entry.resident = true;
+    entry.last_used_frame = m_frame;
+    entry.streamed = packed;
+    entry.streamed_level = (int)packed->mip_levels;
+
+    m_entries[filepath] = entry;
+    m_paths[entry.texture_id] = filepath;
+    m_misses++;
+
+    return entry.texture_id;
+}
+
+long long TextureCache::stream_level(GLuint texture_id, int level)
+{
+    auto path = m_paths.find(texture_id);
+    if (path == m_paths.end()) return 0;
+
+    Entry& entry = m_entries[path->second];
+    if (entry.streamed == NULL || level < 0 || level >= (int)entry.streamed->mip_levels) return 0;
+
+    TRACE_ZONE("TextureCache::stream_level");
+    int previous_levels = entry.resident ? (int)entry.streamed->mip_levels - entry.streamed_level : 1;
+    long long bytes = upload_pack_levels(texture_id, *m_asset_pack, *entry.streamed, level, previous_levels);
+
+    entry.streamed_level = level;
+    entry.resident = true;
+    entry.last_used_frame = m_frame;
+    return bytes;
+}
+
+int TextureCache::get_streamed_level(GLuint texture_id) const
+{
+    auto path = m_paths.find(texture_id);
+    if (path == m_paths.end()) return -1;
+
+    const Entry& entry = m_entries.at(path->second);
+    if (entry.streamed == NULL) return 0;
+    return entry.resident ? entry.streamed_level : (int)entry.streamed->mip_levels;
+}
+
+void TextureCache::release(GLuint texture_id)
+{
+    auto path = m_paths.find(texture_id);
+    if (path == m_paths.end()) return;
+
+    Entry& entry = m_entries[path->second];
+    if (--entry.reference_count > 0) return;
+
+    if (m_texture_loader != NULL) m_texture_loader->cancel(entry.texture_id);
+    untrack_gpu_textures(1, &entry.texture_id);
+    glDeleteTextures(1, &entry.texture_id);
+    m_entries.erase(path->second);
+    m_paths.erase(path);
+}
+
+void TextureCache::release_all()
+{
+    for (auto& entry : m_entries)
+    {
+        if (m_texture_loader != NULL) m_texture_loader->cancel(entry.second.texture_id);
+        untrack_gpu_textures(1, &entry.second.texture_id);
+        glDeleteTextures(1, &entry.second.texture_id);
+    }
+
+    m_entries.clear();
+    m_paths.clear();
+    m_reloads.clear();
+}
+
+void TextureCache::set_texture_loader(AsyncTextureLoader* texture_loader)
+{
+    m_texture_loader = texture_loader;
+    if (m_texture_loader != NULL) m_texture_loader->set_generate_mipmaps(m_generate_mipmaps);
+}
+
+void TextureCache::set_generate_mipmaps(bool generate_mipmaps)
+{
+    m_generate_mipmaps = generate_mipmaps;
+    if (m_texture_loader != NULL) m_texture_loader->set_generate_mipmaps(generate_mipmaps);
+}
+
+void TextureCache::set_sampler_preset(SamplerPreset preset)
+{
+    if (preset == m_sampler) return;
+
+    m_sampler = preset;
+    for (auto& entry : m_entries) apply_sampler_preset(entry.second.texture_id, m_sampler);
+}
+
+void TextureCache::touch(GLuint texture_id)
+{
+    auto path = m_paths.find(texture_id);
+    if (path == m_paths.end()) return;
+
+    Entry& entry = m_entries[path->second];
+    entry.last_used_frame = m_frame;
+    if (entry.resident || entry.reload_queued || entry.streamed != NULL) return;
+
+    entry.reload_queued = true;
+    m_reloads.push_back(texture_id);
+}
+
+void TextureCache::evict(Entry& entry)
+{
+    // The id stays valid for everyone holding it: back to the loader's 1x1 placeholder, with
+    // every mip level the image had emptied so the driver can let go of them
+    count_gl_call(GL_CALL_BIND);
+    count_gl_call(GL_CALL_UPLOAD);
+    glBindTexture(GL_TEXTURE_2D, entry.texture_id);
+    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, 1, 1, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, AsyncTextureLoader::PLACEHOLDER_TEXEL);
+    for (int level = 1; level <= MAX_MIP_LEVELS; level++)
+    {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, 0, 0, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    }
+    track_gpu_texture(entry.texture_id, estimate_texture_bytes(1, 1));
+    prepare_mip_chain(entry.texture_id, false);
+
+    entry.resident = false;
+    if (entry.streamed != NULL) entry.streamed_level = (int)entry.streamed->mip_levels;
+    m_evictions++;
+}
+
+void TextureCache::reupload(const std::string& filepath, Entry& entry)
+{
+    TRACE_ZONE("TextureCache::reupload");
+    bool packed = m_asset_pack != NULL && m_asset_pack->find(filepath.c_str()) != NULL;
+
+    // The same source acquire() took it from, so it comes back as it was
+    if (entry.compressed && upload_compressed_variant(filepath.c_str(), entry.texture_id, entry.width, entry.height))
+    {
+        // The file brings its own mip chain; only the preset needs putting back, below
+    }
+    else if (m_texture_loader != NULL && !packed)
+    {
+        m_texture_loader->reload(entry.texture_id, filepath.c_str());
+    }
+    else
+    {
+        upload_texture(entry.texture_id, filepath.c_str(), m_asset_pack, m_generate_mipmaps, entry.width, entry.height);
+    }
+    apply_sampler_preset(entry.texture_id, m_sampler);
+
+    entry.resident = true;
+    entry.reload_queued = false;
+    m_reloaded++;
+}
+
+void TextureCache::update(float budget_seconds)
+{
+    TRACE_ZONE("TextureCache::update");
+    auto start = std::chrono::steady_clock::now();
+    m_frame++;
+
+    // STEP 1: Bring back what was drawn while evicted, oldest request first, at least one a frame.
+    // Ids released in the meantime are skipped; so are ids GL has since handed to a new texture.
+    size_t reloaded = 0;
+    for (; reloaded < m_reloads.size(); reloaded++)
+    {
+        float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        if (reloaded > 0 && elapsed >= budget_seconds) break;
+
+        auto path = m_paths.find(m_reloads[reloaded]);
+        if (path == m_paths.end()) continue;
+
+        Entry& entry = m_entries[path->second];
+        if (!entry.resident) reupload(path->second, entry);
+    }
+    m_reloads.erase(m_reloads.begin(), m_reloads.begin() + reloaded);
+
+    // STEP 2: What the cache holds now, and what it could give up: resident, idle long enough,
+    // and not still waiting on a decode, which would land on top of the placeholder
+    std::vector<Entry*> idle;
+    m_resident_bytes = 0;
+    for (auto& entry : m_entries)
+    {
+        if (!entry.second.resident) continue;
+        m_resident_bytes += get_gpu_texture_bytes(entry.second.texture_id);
+
+        bool pending = m_texture_loader != NULL && m_texture_loader->is_pending(entry.second.texture_id);
+        if (!pending && m_frame - entry.second.last_used_frame >= MIN_IDLE_FRAMES) idle.push_back(&entry.second);
+    }
+    if (m_vram_budget <= 0 || m_resident_bytes <= m_vram_budget) return;
+
+    // STEP 3: Evict, least recently drawn first, until back under the budget
+    std::sort(idle.begin(), idle.end(), [](const Entry* a, const Entry* b) { return a->last_used_frame < b->last_used_frame; });
+    for (Entry* entry : idle)
+    {
+        if (m_resident_bytes <= m_vram_budget) break;
+
+        m_resident_bytes -= get_gpu_texture_bytes(entry->texture_id);
+        evict(*entry);
+    }
+}
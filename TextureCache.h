@@ -0,0 +1,116 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "AssetPack.h"
+#include "AsyncTextureLoader.h"
+
+class TextureCache
+{
+private:
+    struct Entry
+    {
+        GLuint       texture_id;
+        int          reference_count;
+        int          width, height;
+        bool         compressed;        // came from a .ktx2 sibling, and reloads from it
+        bool         resident;          // false once evicted: the id holds the placeholder
+        bool         reload_queued;
+        unsigned int last_used_frame;
+
+        // Streamed from the pack a mip level at a time (TextureStreamer.h) rather than uploaded
+        // whole: the pack level GL's level 0 holds, mip_levels while only the placeholder is in
+        const AssetPackEntry* streamed;
+        int                   streamed_level;
+    };
+
+    std::unordered_map<std::string, Entry> m_entries;
+    std::unordered_map<GLuint, std::string> m_paths;  // reverse lookup so callers can release by id
+
+    // ————— RESIDENCY ————— //
+    // Textures nobody has drawn for this long can be evicted; anything more recent stays, over
+    // budget or not, so a scene that really needs more than the budget doesn't thrash
+    static constexpr unsigned int MIN_IDLE_FRAMES = 120;
+    static constexpr int          MAX_MIP_LEVELS  = 15;  // a 16384 texture's chain, freed on eviction
+
+    std::vector<GLuint> m_reloads;  // evicted textures drawn again, in the order they were asked for
+    unsigned int        m_frame = 0;
+    long long           m_vram_budget    = 0,
+                        m_resident_bytes = 0;  // as of the last update()
+    int                 m_evictions = 0,
+                        m_reloaded  = 0;
+
+    void evict(Entry& entry);
+    void reupload(const std::string& filepath, Entry& entry);
+
+    const AssetPack*    m_asset_pack     = NULL;
+    AsyncTextureLoader* m_texture_loader = NULL;
+
+    bool          m_generate_mipmaps = false;
+    SamplerPreset m_sampler          = SAMPLER_PIXEL_ART;
+
+    int m_hits   = 0,
+        m_misses = 0;
+
+public:
+    // Paths found in the pack upload its pre-decoded pixels; anything else still goes through stb_image
+    void set_asset_pack(const AssetPack* asset_pack) { m_asset_pack = asset_pack; };
+
+    // With a loader, a miss that the pack can't serve returns a placeholder at once and the PNG is
+    // decoded in the background; the id stays the same when the real image lands
+    void set_texture_loader(AsyncTextureLoader* texture_loader);
+
+    // Applies to textures loaded from now on; pre-compressed files bring their own mip chain
+    void set_generate_mipmaps(bool generate_mipmaps);
+
+    // Re-filters every cached texture, and the ones loaded later; no-op unless the preset changes
+    void set_sampler_preset(SamplerPreset preset);
+
+    // Decodes and uploads on the first request for a path; later requests only bump the count
+    GLuint acquire(const char* filepath);
+
+    // As acquire(), but a packed image starts as the placeholder and is filled in by stream_level().
+    // It is evicted like any other, back to the placeholder, and isn't reloaded by touch(): whoever
+    // streams it asks for its levels again. Anything not in the pack loads whole, as acquire().
+    GLuint acquire_streamed(const char* filepath);
+
+    // Points the texture at the pack's levels from `level` down, uploading all of them, and
+    // returns the bytes that took; 0, changing nothing, for a texture that isn't streamed
+    long long stream_level(GLuint texture_id, int level);
+
+    // The finest pack level the texture holds: 0 for one uploaded whole, the entry's mip_levels
+    // for a streamed one that holds nothing yet, and -1 for an id the cache doesn't own
+    int get_streamed_level(GLuint texture_id) const;
+
+    // Deletes the GL texture once its last user has released it
+    void release(GLuint texture_id);
+
+    // Level teardown: drops every texture regardless of outstanding references
+    void release_all();
+
+    // Textures are evicted, least recently drawn first, while the cache holds more than this in
+    // VRAM; 0 (the default) keeps everything resident
+    void set_vram_budget(long long bytes) { m_vram_budget = bytes; };
+
+    // GL thread, whenever a texture is about to be drawn. An evicted one is queued for update() to
+    // bring back; it draws as the placeholder until then. Ids the cache doesn't own are ignored.
+    void touch(GLuint texture_id);
+
+    // GL thread, once a frame before the draws. Re-uploads evicted textures that were drawn again,
+    // until budget_seconds have gone by: straight from the pack's mapped pages or the .ktx2 file,
+    // or handed to the loader to decode in the background. Then evicts down to the budget.
+    void update(float budget_seconds);
+
+    int       const get_texture_count()  const { return (int)m_entries.size(); };
+    int       const get_hits()           const { return m_hits; };
+    int       const get_misses()         const { return m_misses; };
+    long long const get_resident_bytes() const { return m_resident_bytes; };
+    int       const get_evictions()      const { return m_evictions; };
+    int       const get_reloads()        const { return m_reloaded; };
+};
@@ -0,0 +1,52 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#define GL_SILENCE_DEPRECATION
+
+#include <cmath>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "TextureSampling.h"
+
+bool prepare_mip_chain(GLuint texture_id, bool generate, int max_level, GLenum target)
+{
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(target, texture_id);
+
+    if (!generate || max_level < 1 || !supports_generate_mipmap())
+    {
+        // ES 2.0 has no MAX_LEVEL; apply_sampler_preset keeps its filters off the missing levels instead
+        if (!is_gles()) glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 0);
+        return false;
+    }
+
+    glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, max_level);
+    glGenerateMipmap(target);
+    return true;
+}
+
+void apply_sampler_preset(GLuint texture_id, SamplerPreset preset, GLenum target)
+{
+    // Pixel art stays nearest even between mip levels, so a magnified sprite never goes soft. ES
+    // textures never get mips (see prepare_mip_chain), and would sample black with a mip filter.
+    count_gl_call(GL_CALL_BIND);
+    glBindTexture(target, texture_id);
+    if (is_gles()) glTexParameteri(target, GL_TEXTURE_MIN_FILTER, preset == SAMPLER_PIXEL_ART ? GL_NEAREST : GL_LINEAR);
+    else           glTexParameteri(target, GL_TEXTURE_MIN_FILTER, preset == SAMPLER_PIXEL_ART ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, preset == SAMPLER_PIXEL_ART ? GL_NEAREST : GL_LINEAR);
+}
+
+SamplerPreset select_sampler_preset(const glm::mat4& projection_matrix, int viewport_width, float texels_per_unit)
+{
+    // An orthographic projection maps [left, right] to [-1, 1], so [0][0] is 2 / visible width
+    float pixels_per_unit = std::fabs(projection_matrix[0][0]) * viewport_width / 2.0f;
+    return pixels_per_unit >= texels_per_unit ? SAMPLER_PIXEL_ART : SAMPLER_TRILINEAR;
+}
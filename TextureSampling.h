@@ -0,0 +1,27 @@
+#pragma once
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+
+// How a texture is filtered. Pixel art wants hard texel edges while it is drawn at or above its
+// native size; once the camera zooms out far enough that texels are smaller than pixels, nearest
+// sampling aliases and skips all over the texture, and trilinear over the mip chain is both
+// smoother and lighter on the texture cache.
+enum SamplerPreset { SAMPLER_PIXEL_ART, SAMPLER_TRILINEAR };
+
+// Call right after uploading level 0. With generate set, builds the mip chain up to max_level (an
+// atlas only has padding for so many halvings); otherwise, or where the driver can't, caps the
+// texture at its single level. Either way every texture ends up complete under a mipmap filter,
+// so presets can be switched without knowing which textures have mips. Both also take texture
+// arrays (see TextureArray.h), by target.
+bool prepare_mip_chain(GLuint texture_id, bool generate, int max_level = 1000, GLenum target = GL_TEXTURE_2D);
+
+// Filters only; wrapping is left as the texture set it up
+void apply_sampler_preset(GLuint texture_id, SamplerPreset preset, GLenum target = GL_TEXTURE_2D);
+
+// Pixel art while one texel covers at least a screen pixel, trilinear once it is minified
+SamplerPreset select_sampler_preset(const glm::mat4& projection_matrix, int viewport_width, float texels_per_unit);
@@ -0,0 +1,136 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "TextureStreamer.h"
+#include "Trace.h"
+
+void TextureStreamer::initialise(TextureCache* texture_cache, const AssetPack* asset_pack)
+{
+    m_texture_cache = texture_cache;
+    m_asset_pack = asset_pack;
+}
+
+GLuint TextureStreamer::place(const char* filepath, float x_min, float x_max)
+{
+    GLuint texture_id = m_texture_cache->acquire_streamed(filepath);
+
+    int texture = 0;
+    for (; texture < (int)m_textures.size(); texture++)
+    {
+        if (m_textures[texture].texture_id == texture_id) break;
+    }
+    if (texture < (int)m_textures.size())
+    {
+        // One reference a texture, however many times it's placed
+        m_texture_cache->release(texture_id);
+    }
+    else
+    {
+        const AssetPackEntry* entry = m_asset_pack != NULL ? m_asset_pack->find(filepath) : NULL;
+        m_textures.push_back({ texture_id, entry, INT_MAX });
+    }
+
+    m_placements.push_back({ texture, std::min(x_min, x_max), std::max(x_min, x_max) });
+    return texture_id;
+}
+
+void TextureStreamer::clear()
+{
+    for (const StreamedTexture& texture : m_textures) m_texture_cache->release(texture.texture_id);
+    m_textures.clear();
+    m_placements.clear();
+    m_requests.clear();
+    m_pending = 0;
+}
+
+int TextureStreamer::get_wanted_level(const AssetPackEntry& entry, int distance)
+{
+    if (distance > KEEP_CHUNKS) return (int)entry.mip_levels;
+    return std::min(std::max(distance - FULL_DETAIL_CHUNKS, 0), (int)entry.mip_levels - 1);
+}
+
+int TextureStreamer::get_first_look_level(const AssetPackEntry& entry)
+{
+    int level = 0;
+    while (level + 1 < (int)entry.mip_levels && std::max(AssetPack::get_mip_extent(entry.width, level), AssetPack::get_mip_extent(entry.height, level)) > FIRST_LOOK_EXTENT)
+    {
+        level++;
+    }
+    return level;
+}
+
+void TextureStreamer::update(float camera_x, long long byte_budget)
+{
+    TRACE_ZONE("TextureStreamer::update");
+    m_last_bytes = 0;
+    m_requests.clear();
+
+    // STEP 1: How close each texture comes, by whole chunks, from its nearest placement
+    int camera_chunk = (int)std::floor(camera_x / CHUNK_WIDTH);
+    for (StreamedTexture& texture : m_textures) texture.distance = INT_MAX;
+    for (const Placement& placement : m_placements)
+    {
+        int first = (int)std::floor(placement.x_min / CHUNK_WIDTH),
+            last  = (int)std::floor(placement.x_max / CHUNK_WIDTH);
+        int distance = camera_chunk < first ? first - camera_chunk : camera_chunk > last ? camera_chunk - last : 0;
+
+        int& nearest = m_textures[placement.texture].distance;
+        nearest = std::min(nearest, distance);
+    }
+
+    // STEP 2: The next step for each one short of what it's wanted at. Wanted ones are kept from
+    //         going idle in the cache; the rest are left for it to evict.
+    for (int i = 0; i < (int)m_textures.size(); i++)
+    {
+        const StreamedTexture& texture = m_textures[i];
+        if (texture.entry == NULL || texture.distance > KEEP_CHUNKS) continue;
+        m_texture_cache->touch(texture.texture_id);
+
+        int wanted = get_wanted_level(*texture.entry, texture.distance),
+            held   = m_texture_cache->get_streamed_level(texture.texture_id);
+        if (held <= wanted) continue;
+
+        int level = held >= (int)texture.entry->mip_levels ? std::max(wanted, get_first_look_level(*texture.entry)) : held - 1;
+        m_requests.push_back({ i, level });
+    }
+
+    // STEP 3: Closest first, then coarsest first, so everything near gets a look before anything
+    //         gets sharp
+    std::sort(m_requests.begin(), m_requests.end(), [this](const Request& a, const Request& b)
+        {
+            int distance_a = m_textures[a.texture].distance,
+                distance_b = m_textures[b.texture].distance;
+            if (distance_a != distance_b) return distance_a < distance_b;
+            if (a.level != b.level) return a.level > b.level;
+            return a.texture < b.texture;
+        });
+
+    // STEP 4: Upload in that order while the budget lasts. A request re-uploads the texture's
+    //         whole chain from its level down, which is what it costs.
+    size_t served = 0;
+    for (; served < m_requests.size(); served++)
+    {
+        const Request& request = m_requests[served];
+        const StreamedTexture& texture = m_textures[request.texture];
+
+        long long bytes = (long long)AssetPack::get_chain_bytes(*texture.entry, request.level);
+        if (served > 0 && m_last_bytes + bytes > byte_budget) break;
+
+        m_last_bytes += m_texture_cache->stream_level(texture.texture_id, request.level);
+    }
+
+    m_pending = (int)(m_requests.size() - served);
+    m_total_bytes += m_last_bytes;
+}
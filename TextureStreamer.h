@@ -0,0 +1,88 @@
+#pragma once
+
+// Textures placed over stretches of the level, kept in VRAM only as finely as the camera is close
+// to them. Every frame the streamer works out, from the chunks (LevelStreamer::CHUNK_WIDTH) around
+// the camera's, which textures are wanted and down to which mip level: full detail within
+// FULL_DETAIL_CHUNKS, one level coarser each chunk further, nothing past KEEP_CHUNKS. What isn't
+// in yet is asked for in order, closest first and coarsest level first, and uploaded straight
+// from the pack's mapped pages until the frame's byte budget is spent. A texture with nothing in
+// starts at its first level no larger than FIRST_LOOK_EXTENT, so it shows something at once, and
+// then gets one level finer per request.
+//
+// The streamer never evicts anything itself. The textures belong to the TextureCache, which it
+// keeps touching only while they're wanted; the ones left behind go idle and the cache evicts
+// them, least recently wanted first, once it is over its VRAM budget. Coming back in range asks
+// for them again from the coarse end.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "AssetPack.h"
+#include "LevelStreamer.h"
+#include "TextureCache.h"
+
+class TextureStreamer
+{
+public:
+    static constexpr float CHUNK_WIDTH        = LevelStreamer::CHUNK_WIDTH;
+    static const int       FULL_DETAIL_CHUNKS = 1,
+                           KEEP_CHUNKS        = LevelStreamer::CHUNKS_AROUND + 2;
+    static const uint32_t  FIRST_LOOK_EXTENT  = 32;  // texels along the longer side
+
+private:
+    struct StreamedTexture
+    {
+        GLuint                texture_id;
+        const AssetPackEntry* entry;     // NULL for one the cache loaded whole
+        int                   distance;  // in chunks from the camera's, as of the last update()
+    };
+
+    struct Placement
+    {
+        int   texture;
+        float x_min, x_max;
+    };
+
+    struct Request
+    {
+        int texture;
+        int level;
+    };
+
+    TextureCache*    m_texture_cache = NULL;
+    const AssetPack* m_asset_pack    = NULL;
+
+    std::vector<StreamedTexture> m_textures;
+    std::vector<Placement>       m_placements;
+    std::vector<Request>         m_requests;
+
+    int       m_pending = 0;  // requests the last update() left for later
+    long long m_last_bytes  = 0,
+              m_total_bytes = 0;
+
+    // The finest level wanted `distance` chunks away; the entry's mip_levels for none at all
+    static int get_wanted_level(const AssetPackEntry& entry, int distance);
+    static int get_first_look_level(const AssetPackEntry& entry);
+
+public:
+    void initialise(TextureCache* texture_cache, const AssetPack* asset_pack);
+
+    // The texture over world x from x_min to x_max; the same path placed again is the same
+    // texture, wanted as much as its nearest placement is. The id draws the placeholder until
+    // update() streams something in.
+    GLuint place(const char* filepath, float x_min, float x_max);
+
+    // Gives every texture back to the cache, e.g. when the level is replaced
+    void clear();
+
+    // GL thread, once a frame: picks what the camera at world x `camera_x` wants, and uploads it
+    // in priority order until `byte_budget` is spent, always at least one request
+    void update(float camera_x, long long byte_budget);
+
+    int       const get_texture_count() const { return (int)m_textures.size(); };
+    int       const get_pending_count() const { return m_pending; };
+    long long const get_last_bytes()    const { return m_last_bytes; };
+    long long const get_total_bytes()   const { return m_total_bytes; };
+};
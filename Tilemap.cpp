@@ -0,0 +1,219 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include <cmath>
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "Tilemap.h"
+
+void Tilemap::initialise(int width, int height, float tile_size, glm::vec2 origin, GLuint texture_id)
+{
+    cleanup();
+
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_tile_size = tile_size;
+    m_origin = origin;
+    m_texture_id = texture_id;
+
+    m_chunks_wide = (m_width + CHUNK_TILES - 1) / CHUNK_TILES;
+    m_chunks_high = (m_height + CHUNK_TILES - 1) / CHUNK_TILES;
+
+    m_tiles.assign((size_t)m_width * m_height, TILE_EMPTY);
+    if (supports_vertex_arrays()) glGenVertexArrays(1, &m_vertex_array);
+    m_chunks.assign((size_t)m_chunks_wide * m_chunks_high, Chunk());
+    m_scratch.resize((size_t)CHUNK_TILES * CHUNK_TILES * VERTICES_PER_TILE * FLOATS_PER_VERTEX);
+    m_rebuilds = 0;
+}
+
+void Tilemap::cleanup()
+{
+    for (Chunk& chunk : m_chunks)
+    {
+        if (chunk.vertex_buffer != 0) untrack_gpu_buffers(1, &chunk.vertex_buffer);
+        if (chunk.vertex_buffer != 0) glDeleteBuffers(1, &chunk.vertex_buffer);
+    }
+    m_chunks.clear();
+    m_tiles.clear();
+
+    if (m_vertex_array != 0) glDeleteVertexArrays(1, &m_vertex_array);
+    m_vertex_array = 0;
+}
+
+void Tilemap::set_tile_uv_rect(TileType type, glm::vec4 uv_rect)
+{
+    if ((int)m_tile_uv_rects.size() <= type) m_tile_uv_rects.resize(type + 1, glm::vec4(0.0f));
+    m_tile_uv_rects[type] = uv_rect;
+}
+
+void Tilemap::set_tile(int x, int y, TileType type)
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return;
+
+    TileType& tile = m_tiles[(size_t)y * m_width + x];
+    if (tile == type) return;
+
+    tile = type;
+    m_chunks[(size_t)(y / CHUNK_TILES) * m_chunks_wide + x / CHUNK_TILES].dirty = true;
+}
+
+void Tilemap::set_column_texture(int chunk_x, GLuint texture_id)
+{
+    if (chunk_x < 0 || chunk_x >= m_chunks_wide) return;
+
+    for (int chunk_y = 0; chunk_y < m_chunks_high; chunk_y++)
+    {
+        Chunk& chunk = m_chunks[(size_t)chunk_y * m_chunks_wide + chunk_x];
+        if (chunk.texture_id == texture_id) continue;
+
+        chunk.texture_id = texture_id;
+        chunk.dirty = true;  // its UVs change with it
+    }
+}
+
+TileType Tilemap::get_tile(int x, int y) const
+{
+    if (x < 0 || x >= m_width || y < 0 || y >= m_height) return TILE_EMPTY;
+    return m_tiles[(size_t)y * m_width + x];
+}
+
+int Tilemap::build_chunk_vertices(int chunk_x, int chunk_y, float* vertices) const
+{
+    int first_x = chunk_x * CHUNK_TILES, last_x = std::min(first_x + CHUNK_TILES, m_width),
+        first_y = chunk_y * CHUNK_TILES, last_y = std::min(first_y + CHUNK_TILES, m_height);
+
+    static const glm::vec4 WHOLE_TEXTURE = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+    bool own_texture = m_chunks[(size_t)chunk_y * m_chunks_wide + chunk_x].texture_id != 0;
+
+    int vertex_count = 0;
+    for (int y = first_y; y < last_y; y++)
+    {
+        for (int x = first_x; x < last_x; x++)
+        {
+            TileType type = m_tiles[(size_t)y * m_width + x];
+            if (type == TILE_EMPTY || type >= m_tile_uv_rects.size()) continue;
+
+            // Same corner and UV layout as InstancedRenderer's unit quad: v grows downwards
+            const glm::vec4& uv = own_texture ? WHOLE_TEXTURE : m_tile_uv_rects[type];
+            float left   = m_origin.x + x * m_tile_size, right = left + m_tile_size,
+                  bottom = m_origin.y + y * m_tile_size, top   = bottom + m_tile_size;
+            float u0 = uv.x, u1 = uv.x + uv.z,
+                  v0 = uv.y, v1 = uv.y + uv.w;
+
+            float quad[VERTICES_PER_TILE * FLOATS_PER_VERTEX] =
+            {
+                left,  bottom, u0, v1,
+                right, bottom, u1, v1,
+                right, top,    u1, v0,
+                left,  bottom, u0, v1,
+                right, top,    u1, v0,
+                left,  top,    u0, v0
+            };
+            std::copy(quad, quad + VERTICES_PER_TILE * FLOATS_PER_VERTEX, vertices + vertex_count * FLOATS_PER_VERTEX);
+            vertex_count += VERTICES_PER_TILE;
+        }
+    }
+    return vertex_count;
+}
+
+void Tilemap::rebuild_chunk(int chunk_x, int chunk_y)
+{
+    Chunk& chunk = m_chunks[(size_t)chunk_y * m_chunks_wide + chunk_x];
+    chunk.vertex_count = build_chunk_vertices(chunk_x, chunk_y, m_scratch.data());
+    chunk.dirty = false;
+    m_rebuilds++;
+
+    if (chunk.vertex_count == 0) return;
+
+    // Respecifying the whole store lets the driver hand back fresh memory rather than wait on a
+    // draw still reading the old geometry
+    count_gl_call(GL_CALL_BIND, 2);
+    count_gl_call(GL_CALL_UPLOAD);
+    if (chunk.vertex_buffer == 0) glGenBuffers(1, &chunk.vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, chunk.vertex_count * FLOATS_PER_VERTEX * sizeof(float), m_scratch.data(), GL_STATIC_DRAW);
+    track_gpu_buffer(chunk.vertex_buffer, (long long)(chunk.vertex_count * FLOATS_PER_VERTEX * sizeof(float)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Tilemap::draw(ShaderProgram* program, glm::vec2 view_min, glm::vec2 view_max, glm::vec2 offset)
+{
+    m_draw_calls = 0;
+    if (m_chunks.empty()) return;
+
+    // STEP 1: The chunks under the view, clamped to the map
+    view_min -= offset;
+    view_max -= offset;
+    float chunk_size = CHUNK_TILES * m_tile_size;
+    int first_x = std::max((int)std::floor((view_min.x - m_origin.x) / chunk_size), 0),
+        last_x  = std::min((int)std::floor((view_max.x - m_origin.x) / chunk_size), m_chunks_wide - 1),
+        first_y = std::max((int)std::floor((view_min.y - m_origin.y) / chunk_size), 0),
+        last_y  = std::min((int)std::floor((view_max.y - m_origin.y) / chunk_size), m_chunks_high - 1);
+    if (first_x > last_x || first_y > last_y) return;
+
+    // STEP 2: Vertices are already in the map's space
+    program->use();
+    program->set_model_transform(ModelTransform::make(offset));
+
+    const GLsizei stride = FLOATS_PER_VERTEX * sizeof(float);
+
+    count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+    glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    GLuint bound_texture = m_texture_id;
+    if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);  // a core context draws nothing without one
+
+    // STEP 3: One draw per chunk that has anything in it
+    for (int chunk_y = first_y; chunk_y <= last_y; chunk_y++)
+    {
+        for (int chunk_x = first_x; chunk_x <= last_x; chunk_x++)
+        {
+            if (m_chunks[(size_t)chunk_y * m_chunks_wide + chunk_x].dirty) rebuild_chunk(chunk_x, chunk_y);
+
+            const Chunk& chunk = m_chunks[(size_t)chunk_y * m_chunks_wide + chunk_x];
+            if (chunk.vertex_count == 0) continue;
+
+            GLuint texture_id = chunk.texture_id != 0 ? chunk.texture_id : m_texture_id;
+            if (texture_id != bound_texture)
+            {
+                count_gl_call(GL_CALL_BIND);
+                glBindTexture(GL_TEXTURE_2D, texture_id);
+                bound_texture = texture_id;
+            }
+
+            count_gl_call(GL_CALL_BIND);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer);
+            glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, stride, (void*)0);
+            glEnableVertexAttribArray(program->get_position_attribute());
+            glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, stride, (void*)(2 * sizeof(float)));
+            glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
+
+            count_gl_call(GL_CALL_DRAW);
+            glDrawArrays(GL_TRIANGLES, 0, chunk.vertex_count);
+            m_draw_calls++;
+        }
+    }
+
+    // Whoever draws next may expect the page the map was submitted with to still be bound
+    if (bound_texture != m_texture_id)
+    {
+        count_gl_call(GL_CALL_BIND);
+        glBindTexture(GL_TEXTURE_2D, m_texture_id);
+    }
+
+    count_gl_call(GL_CALL_BIND);
+    glDisableVertexAttribArray(program->get_position_attribute());
+    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0) glBindVertexArray(0);
+}
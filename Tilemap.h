@@ -0,0 +1,83 @@
+#pragma once
+
+// A grid of block tiles (rock, stone, ...) drawn as a few static meshes instead of one sprite per
+// block. The grid is cut into CHUNK_TILES x CHUNK_TILES chunks, and each chunk's geometry is built
+// once into its own GL_STATIC_DRAW buffer; set_tile() only marks its chunk dirty, so any number of
+// edits between two frames costs one rebuild per chunk they touched. Drawing is one glDrawArrays
+// per chunk on screen, so a full screen of tiles is a handful of draw calls.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+typedef unsigned char TileType;
+const TileType TILE_EMPTY = 0;  // every other type is drawn with its uv rect
+
+class Tilemap
+{
+private:
+    static const int FLOATS_PER_VERTEX = 4,  // x, y, u, v
+                     VERTICES_PER_TILE = 6;
+
+    struct Chunk
+    {
+        GLuint vertex_buffer = 0;
+        int    vertex_count  = 0;
+        bool   dirty         = true;
+        GLuint texture_id    = 0;  // 0 for the map's page; otherwise all of it on every tile
+    };
+
+    int       m_width  = 0,  // in tiles
+              m_height = 0,
+              m_chunks_wide = 0,
+              m_chunks_high = 0;
+    float     m_tile_size = 1.0f;
+    glm::vec2 m_origin    = glm::vec2(0.0f);  // lower-left corner of tile (0, 0)
+    GLuint    m_texture_id = 0;
+    GLuint    m_vertex_array = 0;  // shared by every chunk; 0 where vertex arrays aren't supported
+
+    std::vector<TileType>  m_tiles;          // row-major, row 0 at the bottom
+    std::vector<glm::vec4> m_tile_uv_rects;  // indexed by TileType
+    std::vector<Chunk>     m_chunks;
+    std::vector<float>     m_scratch;        // one chunk's vertices; only ever grows
+
+    int m_draw_calls = 0,
+        m_rebuilds   = 0;
+
+    // Writes the chunk's non-empty tiles and returns how many vertices that came to
+    int  build_chunk_vertices(int chunk_x, int chunk_y, float* vertices) const;
+    void rebuild_chunk(int chunk_x, int chunk_y);
+
+public:
+    static const int CHUNK_TILES = 32;
+
+    // Every tile starts out TILE_EMPTY. texture_id is the page the uv rects point into.
+    void initialise(int width, int height, float tile_size, glm::vec2 origin, GLuint texture_id);
+    void cleanup();
+
+    void set_tile_uv_rect(TileType type, glm::vec4 uv_rect);
+    // Draws one column of chunks from a texture of its own, the whole of it on every tile whatever
+    // the tile's type, e.g. one TextureStreamer streams in; 0 goes back to the map's page
+    void set_column_texture(int chunk_x, GLuint texture_id);
+    // Out-of-range tiles are ignored
+    void set_tile(int x, int y, TileType type);
+    TileType get_tile(int x, int y) const;
+
+    // Rebuilds whichever chunks are dirty and overlap [view_min, view_max], then draws those that
+    // hold anything. Chunks off screen keep their dirty flag until they come into view. `offset`
+    // is where the map's space sits in the view's, e.g. against a floating origin.
+    void draw(ShaderProgram* program, glm::vec2 view_min, glm::vec2 view_max, glm::vec2 offset = glm::vec2(0.0f));
+
+    // ————— GETTERS ————— //
+    int   const get_width()       const { return m_width; };
+    int   const get_height()      const { return m_height; };
+    int   const get_chunk_count() const { return (int)m_chunks.size(); };
+    int   const get_chunks_wide() const { return m_chunks_wide; };
+    float const get_chunk_size()  const { return CHUNK_TILES * m_tile_size; };  // in world units
+    int   const get_draw_calls()  const { return m_draw_calls; };  // by the last draw()
+    int   const get_rebuilds()    const { return m_rebuilds; };    // since initialise()
+};
@@ -0,0 +1,209 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include "TimerWheel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static int lowest_set_bit(uint64_t bits)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+static TimerId make_id(int index, uint32_t generation)
+{
+    return ((uint64_t)generation << 32) | (uint64_t)(index + 1);
+}
+
+// ————— LISTS ————— //
+void TimerWheel::link(int timer, int list)
+{
+    Timer& node = m_timers[timer];
+    List&  into = m_lists[list];
+
+    node.list     = list;
+    node.previous = into.tail;
+    node.next     = NO_TIMER;
+    if (into.tail != NO_TIMER) m_timers[into.tail].next = timer;
+    else                       into.head = timer;
+    into.tail = timer;
+
+    if (list < OVERFLOW_LIST) m_occupied[list / SLOT_COUNT] |= 1ull << (list % SLOT_COUNT);
+}
+
+void TimerWheel::unlink(int timer)
+{
+    Timer& node = m_timers[timer];
+    List&  from = m_lists[node.list];
+
+    if (node.previous != NO_TIMER) m_timers[node.previous].next = node.next;
+    else                           from.head = node.next;
+    if (node.next != NO_TIMER) m_timers[node.next].previous = node.previous;
+    else                       from.tail = node.previous;
+
+    if (from.head == NO_TIMER && node.list < OVERFLOW_LIST) m_occupied[node.list / SLOT_COUNT] &= ~(1ull << (node.list % SLOT_COUNT));
+}
+
+void TimerWheel::file(int timer)
+{
+    // The finest level whose window around now still holds the deadline: the deadline and now
+    // agree on every bit above it
+    uint64_t deadline   = m_timers[timer].deadline,
+             difference = deadline ^ m_now;
+    for (int level = 0; level < LEVEL_COUNT; level++)
+    {
+        if ((difference >> (SLOT_BITS * (level + 1))) != 0) continue;
+
+        int slot = (int)((deadline >> (SLOT_BITS * level)) & (SLOT_COUNT - 1));
+        link(timer, level * SLOT_COUNT + slot);
+        return;
+    }
+    link(timer, OVERFLOW_LIST);
+}
+
+void TimerWheel::cascade(int list)
+{
+    // Taken off whole first: refiling can put timers back into a list of the same level
+    int timer = m_lists[list].head;
+    m_lists[list] = List();
+    if (list < OVERFLOW_LIST) m_occupied[list / SLOT_COUNT] &= ~(1ull << (list % SLOT_COUNT));
+
+    while (timer != NO_TIMER)
+    {
+        int next = m_timers[timer].next;
+        file(timer);
+        timer = next;
+    }
+}
+
+// ————— TIMERS ————— //
+TimerId TimerWheel::schedule(uint64_t delay, TimerFunction function, void* user_data)
+{
+    int timer = m_free;
+    if (timer != NO_TIMER) m_free = m_timers[timer].next;
+    else
+    {
+        timer = (int)m_timers.size();
+        m_timers.push_back(Timer());
+        m_timers[timer].generation = 1;
+    }
+
+    Timer& node = m_timers[timer];
+    node.deadline  = m_now + (delay > 0 ? delay : 1);
+    node.function  = function;
+    node.user_data = user_data;
+    file(timer);
+    m_pending++;
+    return make_id(timer, node.generation);
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    if (!is_pending(id)) return false;
+
+    int timer = (int)(id & 0xffffffffu) - 1;
+    unlink(timer);
+
+    Timer& node = m_timers[timer];
+    node.generation++;
+    node.list = FREE_LIST;
+    node.next = m_free;
+    m_free = timer;
+    m_pending--;
+    return true;
+}
+
+void TimerWheel::clear(uint64_t now)
+{
+    m_free = NO_TIMER;
+    for (int timer = (int)m_timers.size() - 1; timer >= 0; timer--)
+    {
+        Timer& node = m_timers[timer];
+        if (node.list != FREE_LIST) node.generation++;
+        node.list = FREE_LIST;
+        node.next = m_free;
+        m_free = timer;
+    }
+    for (List& list : m_lists) list = List();
+    for (uint64_t& occupied : m_occupied) occupied = 0;
+    m_now = now;
+    m_pending = 0;
+}
+
+void TimerWheel::advance(uint64_t ticks)
+{
+    uint64_t target = m_now + ticks;
+    while (m_now < target)
+    {
+        // STEP 1: The next tick with anything to do: a level 0 slot with timers in it, or the
+        //         start of the next window, where the levels above come due
+        uint64_t position = m_now & (SLOT_COUNT - 1);
+        uint64_t ahead    = position + 1 < SLOT_COUNT ? (m_occupied[0] >> (position + 1)) << (position + 1) : 0;
+        uint64_t next     = ahead != 0 ? m_now - position + (uint64_t)lowest_set_bit(ahead) : (m_now | (SLOT_COUNT - 1)) + 1;
+        if (next > target)
+        {
+            m_now = target;
+            return;
+        }
+        m_now = next;
+
+        // STEP 2: At a window's start, whatever falls due in it comes down from the levels
+        //         above, the coarsest first so what it drops is cascaded again on the way
+        if ((m_now & (SLOT_COUNT - 1)) == 0)
+        {
+            if ((m_now & ((1ull << (SLOT_BITS * LEVEL_COUNT)) - 1)) == 0) cascade(OVERFLOW_LIST);
+            for (int level = LEVEL_COUNT - 1; level >= 1; level--)
+            {
+                if ((m_now & ((1ull << (SLOT_BITS * level)) - 1)) != 0) continue;
+                cascade(level * SLOT_COUNT + (int)((m_now >> (SLOT_BITS * level)) & (SLOT_COUNT - 1)));
+            }
+        }
+
+        // STEP 3: This tick's slot, in the order its timers were filed. Each is freed before its
+        //         function runs, which can then schedule into any slot but this one.
+        List& slot = m_lists[m_now & (SLOT_COUNT - 1)];
+        while (slot.head != NO_TIMER)
+        {
+            int timer = slot.head;
+            unlink(timer);
+
+            Timer& node = m_timers[timer];
+            TimerFunction function  = node.function;
+            void*         user_data = node.user_data;
+            node.generation++;
+            node.list = FREE_LIST;
+            node.next = m_free;
+            m_free = timer;
+            m_pending--;
+
+            function(user_data);
+        }
+    }
+}
+
+bool const TimerWheel::is_pending(TimerId id) const
+{
+    int timer = (int)(id & 0xffffffffu) - 1;
+    return timer >= 0 && timer < (int)m_timers.size() && m_timers[timer].list != FREE_LIST && m_timers[timer].generation == (uint32_t)(id >> 32);
+}
+
+uint64_t const TimerWheel::get_remaining(TimerId id) const
+{
+    if (!is_pending(id)) return 0;
+    return m_timers[(int)(id & 0xffffffffu) - 1].deadline - m_now;
+}
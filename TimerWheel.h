@@ -0,0 +1,92 @@
+#pragma once
+
+// Delayed actions on the simulation's clock: "in 90 steps, do this". A hierarchical timer wheel,
+// so scheduling and cancelling are O(1) and a step only looks at the one slot coming due, however
+// many timers are waiting further out.
+//
+// Time is whole ticks (a step each, wherever the owner advances it from), so the same schedule
+// always fires the same way on every machine, in float builds too. Level 0 has a slot per tick
+// for the next SLOT_COUNT ticks; each level above covers SLOT_COUNT times the span of the one
+// below, a slot per span of that. A timer goes into the finest level whose current window its
+// deadline falls in, and moves down a level as the wheel reaches its slot there (a cascade,
+// once every SLOT_COUNT ticks at most), so every timer is handled at most LEVEL_COUNT times
+// between being scheduled and firing. Deadlines beyond the top level's reach wait in an overflow
+// list that is only looked at when the top level wraps around.
+//
+// Timers fire with advance(), in ascending deadline order; those due on the same tick fire in
+// the order they were scheduled. A firing timer's function may schedule and cancel freely, itself
+// included. Everything here is for one thread.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+typedef void (*TimerFunction)(void* user_data);
+
+// 0 is never a live timer; a cancelled or fired timer's id stays dead even once its slot is reused
+typedef uint64_t TimerId;
+
+class TimerWheel
+{
+public:
+    static const int SLOT_BITS   = 6,
+                     SLOT_COUNT  = 1 << SLOT_BITS,  // 64 slots a level
+                     LEVEL_COUNT = 4;                // 2^24 ticks, over three days of 60 Hz steps
+
+private:
+    static const int NO_TIMER      = -1,
+                     OVERFLOW_LIST = LEVEL_COUNT * SLOT_COUNT,
+                     FREE_LIST     = OVERFLOW_LIST + 1,
+                     LIST_COUNT    = OVERFLOW_LIST + 1;
+
+    struct Timer
+    {
+        uint64_t      deadline;
+        TimerFunction function;
+        void*         user_data;
+        int           previous,
+                      next;
+        int           list;        // slot (level * SLOT_COUNT + slot), OVERFLOW_LIST, or FREE_LIST
+        uint32_t      generation;  // bumped every time it's freed, so stale ids miss
+    };
+
+    struct List
+    {
+        int head = NO_TIMER,
+            tail = NO_TIMER;
+    };
+
+    std::vector<Timer> m_timers;      // only ever grows; freed ones are reused
+    int                m_free = NO_TIMER;
+    List               m_lists[LIST_COUNT];
+    uint64_t           m_occupied[LEVEL_COUNT] = {};  // a bit per non-empty slot, to skip the empty ones
+    uint64_t           m_now = 0;
+    int                m_pending = 0;
+
+    void link(int timer, int list);
+    void unlink(int timer);
+    // Into the list its deadline belongs in, seen from m_now
+    void file(int timer);
+    // Everything in a slot the wheel has just reached (or the overflow list), refiled from m_now:
+    // a level or more down, or back where it was if it's still that far out
+    void cascade(int list);
+
+public:
+    TimerWheel() = default;
+
+    // Fires `delay` ticks from now: 1 is on the next advance, and anything less is taken as 1
+    TimerId schedule(uint64_t delay, TimerFunction function, void* user_data = NULL);
+    // False if it had already fired, been cancelled, or never was
+    bool    cancel(TimerId id);
+    // Drops every timer without firing any, and starts the clock over at `now`
+    void    clear(uint64_t now = 0);
+
+    // Moves the clock on by `ticks`, firing every timer that comes due on the way. Ticks with
+    // nothing due, and nothing to cascade, are skipped over rather than visited.
+    void advance(uint64_t ticks = 1);
+
+    bool     const is_pending(TimerId id) const;
+    // Ticks until the timer fires, or 0 if it isn't pending
+    uint64_t const get_remaining(TimerId id) const;
+    uint64_t const get_now()           const { return m_now; };
+    int      const get_pending_count() const { return m_pending; };
+};
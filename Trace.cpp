@@ -0,0 +1,124 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+#include "Trace.h"
+
+#ifdef LANDER_TRACE
+
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    const size_t MAX_EVENTS_PER_THREAD = 1 << 18;  // 6MB a thread; minutes of frames at 60 Hz
+
+    struct TraceEvent
+    {
+        const char* name;
+        long long   start_ns,
+                    duration_ns;  // negative for an instant event, such as a frame boundary
+    };
+
+    // Only its own thread writes to a buffer, so recording takes no lock; the registry's mutex
+    // is only held when a thread records its first event and when the trace is written.
+    // Buffers outlive their threads, so the loading threads still show up in the trace.
+    struct ThreadBuffer
+    {
+        int                     thread_index;
+        std::vector<TraceEvent> events;
+        size_t                  next = 0;  // slot the next event goes into once the ring is full
+    };
+
+    std::mutex                                 g_registry_mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+    const long long                            g_trace_start = TraceZone::now_ns();
+
+    ThreadBuffer& get_thread_buffer()
+    {
+        thread_local ThreadBuffer* buffer = NULL;
+        if (buffer != NULL) return *buffer;
+
+        std::lock_guard<std::mutex> lock(g_registry_mutex);
+        g_buffers.emplace_back(new ThreadBuffer());
+        buffer = g_buffers.back().get();
+        buffer->thread_index = (int)g_buffers.size() - 1;
+        buffer->events.reserve(MAX_EVENTS_PER_THREAD);
+        return *buffer;
+    }
+
+    void record(const TraceEvent& event)
+    {
+        ThreadBuffer& buffer = get_thread_buffer();
+
+        if (buffer.events.size() < MAX_EVENTS_PER_THREAD)
+        {
+            buffer.events.push_back(event);
+            return;
+        }
+
+        buffer.events[buffer.next] = event;
+        buffer.next = (buffer.next + 1) % MAX_EVENTS_PER_THREAD;
+    }
+}
+
+TraceZone::~TraceZone()
+{
+    record({ m_name, m_start, now_ns() - m_start });
+}
+
+void trace_frame()
+{
+    record({ "frame", TraceZone::now_ns(), -1 });
+}
+
+bool trace_write(const char* filepath)
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+
+    // The JSON array form of the trace event format: one complete ("X") event per zone and one
+    // instant ("i") event per frame, in microseconds since the first zone could have started
+    file << std::fixed << std::setprecision(3) << "[\n";
+    bool first = true;
+
+    for (const std::unique_ptr<ThreadBuffer>& buffer : g_buffers)
+    {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_index
+             << ",\"args\":{\"name\":\"thread " << buffer->thread_index << "\"}}";
+        first = false;
+
+        for (const TraceEvent& event : buffer->events)
+        {
+            file << ",\n{\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << buffer->thread_index
+                 << ",\"ts\":" << (event.start_ns - g_trace_start) / 1000.0;
+
+            if (event.duration_ns < 0) file << ",\"ph\":\"i\",\"s\":\"t\"}";
+            else                       file << ",\"ph\":\"X\",\"dur\":" << event.duration_ns / 1000.0 << "}";
+        }
+    }
+
+    file << "\n]\n";
+    return (bool)file;
+}
+
+#else
+
+bool trace_write(const char*)
+{
+    return false;
+}
+
+#endif
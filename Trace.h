@@ -0,0 +1,56 @@
+#pragma once
+
+// Scoped timeline zones for chasing stutters in real sessions. They compile to nothing unless
+// the build defines one of:
+//
+//     LANDER_TRACE  records Chrome trace events in memory; trace_write saves them as JSON for
+//                   chrome://tracing or ui.perfetto.dev
+//     LANDER_TRACY  forwards to a Tracy client, whose headers and TracyClient.cpp must then be
+//                   part of the build
+//
+// Zone names must be string literals: only the pointer is kept until the trace is written.
+
+#if defined(LANDER_TRACY)
+
+#include "tracy/Tracy.hpp"
+#define TRACE_ZONE(name) ZoneScopedN(name)
+#define TRACE_FRAME()    FrameMark
+
+#elif defined(LANDER_TRACE)
+
+#include <chrono>
+
+class TraceZone
+{
+private:
+    const char* m_name;
+    long long   m_start;
+
+public:
+    static long long now_ns() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+
+    explicit TraceZone(const char* name) : m_name(name), m_start(now_ns()) {};
+    ~TraceZone();
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+void trace_frame();
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b)       TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name)         TraceZone TRACE_CONCAT(trace_zone_, __LINE__)(name)
+#define TRACE_FRAME()            trace_frame()
+
+#else
+
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_FRAME()    ((void)0)
+
+#endif
+
+// Every thread keeps only its most recent zones, so a long session stays in bounded memory and
+// the trace ends at the stutter that made someone quit. Call once the other threads have gone
+// quiet; false, and no file, in builds without LANDER_TRACE.
+bool trace_write(const char* filepath);
@@ -0,0 +1,171 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#define GL_SILENCE_DEPRECATION
+
+#include <algorithm>
+#include "DistanceField.h"
+#include "GLCapabilities.h"
+#include "GLCallCounter.h"
+#include "MemoryAccounting.h"
+#include "PlatformBroadphase.h"
+#include "Terrain.h"
+#include "TrajectoryOverlay.h"
+
+void TrajectoryOverlay::initialise()
+{
+    if (m_vertex_buffer == 0) glGenBuffers(1, &m_vertex_buffer);
+    if (m_vertex_array == 0 && supports_vertex_arrays()) glGenVertexArrays(1, &m_vertex_array);
+    m_uploaded = false;
+}
+
+void TrajectoryOverlay::cleanup()
+{
+    if (m_vertex_array != 0)  glDeleteVertexArrays(1, &m_vertex_array);
+    if (m_vertex_buffer != 0) untrack_gpu_buffers(1, &m_vertex_buffer);
+    if (m_vertex_buffer != 0) glDeleteBuffers(1, &m_vertex_buffer);
+    m_vertex_array = m_vertex_buffer = 0;
+    clear();
+}
+
+void TrajectoryOverlay::clear()
+{
+    m_has_path = false;
+    m_point_count = 0;
+    m_uploaded = false;
+}
+
+bool TrajectoryOverlay::hits_level(glm::vec2 position, glm::vec2 half_size, const GameState& state) const
+{
+    glm::vec2 bottom = position - glm::vec2(0.0f, half_size.y);
+
+    if (state.terrain != NULL && bottom.y <= state.terrain->get_height(bottom.x)) return true;
+    if (state.distance_field != NULL && state.distance_field->get_distance(bottom) <= 0.0f) return true;
+
+    for (int index : m_candidates)
+    {
+        const Entity& platform = state.platforms[index];
+        if (!platform.is_active()) continue;
+
+        glm::vec2 gap = glm::abs(position - glm::vec2(platform.get_position())),
+                  reach = half_size + glm::vec2(platform.get_width(), platform.get_height()) * 0.5f;
+        if (gap.x < reach.x && gap.y < reach.y) return true;
+    }
+    return false;
+}
+
+void TrajectoryOverlay::predict(const Entity& lander, const GameState& state)
+{
+    // STEP 1: Hands off the controls from here on
+    m_predictor = FlightPredictor(lander, 0.0f, false);
+    m_predictor.sample_path(HORIZON, m_points, POINT_COUNT);
+    m_elapsed = 0.0f;
+
+    // STEP 2: The platforms anywhere near the whole path, looked up once rather than per point
+    glm::vec2 half_size = glm::vec2(lander.get_width(), lander.get_height()) * 0.5f,
+              path_min  = m_points[0],
+              path_max  = m_points[0];
+    for (int i = 1; i < POINT_COUNT; i++)
+    {
+        path_min = glm::min(path_min, m_points[i]);
+        path_max = glm::max(path_max, m_points[i]);
+    }
+
+    m_candidates.clear();
+    if (state.platform_broadphase != NULL)
+    {
+        state.platform_broadphase->query(path_min - half_size, path_max + half_size, m_candidates, m_broadphase_cursor);
+    }
+    else
+    {
+        for (int i = 0; i < state.platform_count; i++) m_candidates.push_back(i);
+    }
+
+    // STEP 3: Cut the path at the first point that lands in the level
+    m_point_count = POINT_COUNT;
+    m_touches_down = false;
+    for (int i = 1; i < POINT_COUNT; i++)
+    {
+        if (hits_level(m_points[i], half_size, state))
+        {
+            m_point_count = i + 1;
+            m_touches_down = true;
+            break;
+        }
+    }
+
+    m_has_path = true;
+    m_uploaded = false;
+    m_predictions++;
+}
+
+void TrajectoryOverlay::update(const Entity& lander, float seconds, const GameState& state)
+{
+    if (!lander.is_active())
+    {
+        clear();
+        return;
+    }
+
+    // Still on the kept path: nothing to do. Off it, or past its end, it's predicted again.
+    m_elapsed += seconds;
+    if (m_has_path && m_elapsed <= HORIZON)
+    {
+        glm::vec2 position_error = glm::vec2(lander.get_position()) - m_predictor.get_position(m_elapsed),
+                  velocity_error = glm::vec2(lander.get_velocity()) - m_predictor.get_velocity(m_elapsed);
+        if (glm::dot(position_error, position_error) <= TOLERANCE * TOLERANCE &&
+            glm::dot(velocity_error, velocity_error) <= TOLERANCE * TOLERANCE) return;
+    }
+
+    predict(lander, state);
+}
+
+void TrajectoryOverlay::draw(ShaderProgram* program)
+{
+    m_draw_calls = 0;
+    if (!m_has_path || m_vertex_buffer == 0) return;
+
+    // STEP 1: Only what's still ahead of the lander, starting on a dot
+    int first = (int)(m_elapsed / HORIZON * (float)(POINT_COUNT - 1)) & ~1,
+        count = (m_point_count - first) & ~1;
+    if (count < 2) return;
+
+    program->use();
+    program->set_model_transform(ModelTransform());
+    program->set_colour(1.0f, 1.0f, 1.0f, 0.6f);
+
+    count_gl_call(GL_CALL_BIND, m_vertex_array != 0 ? 2 : 1);
+    if (m_vertex_array != 0) glBindVertexArray(m_vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertex_buffer);
+
+    // STEP 2: A new path is uploaded once; frames that keep it upload nothing
+    if (!m_uploaded)
+    {
+        count_gl_call(GL_CALL_UPLOAD);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(m_points), m_points, GL_STATIC_DRAW);
+        track_gpu_buffer(m_vertex_buffer, sizeof(m_points));
+        m_uploaded = true;
+    }
+
+    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, sizeof(glm::vec2), (void*)0);
+    glEnableVertexAttribArray(program->get_position_attribute());
+
+    // STEP 3: Point pairs as separate lines leave every other segment out, which is the dotting
+    count_gl_call(GL_CALL_DRAW);
+    glDrawArrays(GL_LINES, first, count);
+    m_draw_calls++;
+
+    count_gl_call(GL_CALL_BIND);
+    glDisableVertexAttribArray(program->get_position_attribute());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (m_vertex_array != 0) glBindVertexArray(0);
+
+    program->set_colour(1.0f, 1.0f, 1.0f, 1.0f);
+}
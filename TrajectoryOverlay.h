@@ -0,0 +1,65 @@
+#pragma once
+
+// The dotted line from the lander to where it would come down if every key were let go. The path
+// comes from FlightPredictor in closed form and is kept between frames: each frame only checks
+// that the lander is still where the kept path says it should be by now, and draws the rest of
+// it. Only when it isn't (a key was pressed, or something changed its velocity) is the path
+// predicted again and its points uploaded. Drawn as one line batch over a static vertex buffer,
+// every other segment left out for the dots.
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL_opengl.h>
+#include <vector>
+#include "glm/mat4x4.hpp"
+#include "FlightPredictor.h"
+#include "ShaderProgram.h"
+#include "Simulation.h"
+
+class TrajectoryOverlay
+{
+private:
+    static const int       POINT_COUNT = 128;
+    static constexpr float HORIZON     = 4.0f;   // seconds looked ahead
+    static constexpr float TOLERANCE   = 0.02f;  // how far off the path counts as leaving it
+
+    // ————— KEPT PATH ————— //
+    FlightPredictor   m_predictor;
+    bool              m_has_path = false;
+    float             m_elapsed = 0.0f;      // simulated since the path was predicted
+    glm::vec2         m_points[POINT_COUNT];
+    int               m_point_count = 0;     // up to the touchdown, or the horizon without one
+    bool              m_touches_down = false;
+    std::vector<int>  m_candidates;          // broadphase scratch
+    int               m_broadphase_cursor = -1;
+    long long         m_predictions = 0;
+
+    void predict(const Entity& lander, const GameState& state);
+    bool hits_level(glm::vec2 position, glm::vec2 half_size, const GameState& state) const;
+
+    // ————— GL ————— //
+    GLuint m_vertex_buffer = 0,
+           m_vertex_array  = 0;
+    bool   m_uploaded = false;
+    int    m_draw_calls = 0;
+
+public:
+    // GL thread, once the context exists
+    void initialise();
+    void cleanup();
+
+    // Once a frame, after the steps it took: `seconds` is how much simulated time they covered.
+    // The level in `state` is only read for where the path touches down.
+    void update(const Entity& lander, float seconds, const GameState& state);
+    void clear();
+
+    // Through a flat-colour sprite program (no ShaderFeature bits), in world space
+    void draw(ShaderProgram* program);
+
+    bool      const has_path()          const { return m_has_path; };
+    bool      const touches_down()      const { return m_touches_down; };
+    glm::vec2 const get_touchdown()     const { return m_points[m_point_count - 1]; };
+    long long const get_predictions()   const { return m_predictions; };
+    int       const get_draw_calls()    const { return m_draw_calls; };
+};
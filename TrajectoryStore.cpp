@@ -0,0 +1,321 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include <cstring>
+#include "TrajectoryStore.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char TrajectoryFile::MAGIC[4] = { 'L', 'T', 'R', 'J' };
+
+static_assert(sizeof(TrajectoryHeader) == 64, "the header is part of the file format");
+static_assert(sizeof(TrajectoryChunk) == 16 + 8 * TRAJECTORY_COLUMN_COUNT, "chunks are part of the file format");
+static_assert(sizeof(TrajectoryEpisode) == 16 + 4 * LANDER_OBSERVATION_SIZE, "episodes are part of the file format");
+static_assert(sizeof(TrajectoryFooter) == 40, "the footer is part of the file format");
+
+// Bytes per row of each column, in TrajectoryColumn order
+static const size_t COLUMN_SIZES[TRAJECTORY_COLUMN_COUNT] = { 8, 8, 8, 4, 1, 4, 1 };
+
+static uint64_t align_up(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Whether [offset, offset + count * element_size) lies inside the file, without overflowing
+static bool section_fits(uint64_t offset, uint64_t count, uint64_t element_size, size_t file_size)
+{
+    if (offset > file_size || offset % alignof(float) != 0) return false;
+    return count <= (file_size - offset) / element_size;
+}
+
+// ————— WRITER ————— //
+bool TrajectoryWriter::open(const char* filepath, int chunk_rows)
+{
+    close();
+
+    m_output.open(filepath, std::ios::binary | std::ios::trunc);
+    if (!m_output) return false;
+
+    m_offset = 0;
+    m_chunk_rows = std::max(1, chunk_rows);
+    m_column_rows = 0;
+    m_row_count = 0;
+    m_chunks.clear();
+    m_episodes.clear();
+    m_pending.clear();
+    for (int column = 0; column < TRAJECTORY_COLUMN_COUNT; column++)
+    {
+        m_columns[column].element_size = COLUMN_SIZES[column];
+        m_columns[column].bytes.clear();
+        m_columns[column].bytes.reserve((size_t)m_chunk_rows * COLUMN_SIZES[column]);
+    }
+
+    TrajectoryHeader header = {};
+    std::memcpy(header.magic, TrajectoryFile::MAGIC, sizeof(header.magic));
+    header.version = TrajectoryFile::VERSION;
+    header.column_count = TRAJECTORY_COLUMN_COUNT;
+    header.observation_size = LANDER_OBSERVATION_SIZE;
+    write_at(0, &header, sizeof(header));
+    return (bool)m_output;
+}
+
+// Zero-fills up to offset, then writes
+void TrajectoryWriter::write_at(uint64_t offset, const void* data, size_t size)
+{
+    static const char zeros[TrajectoryFile::SECTION_ALIGNMENT] = {};
+    while (m_offset < offset)
+    {
+        size_t gap = (size_t)std::min<uint64_t>(offset - m_offset, sizeof(zeros));
+        m_output.write(zeros, (std::streamsize)gap);
+        m_offset += gap;
+    }
+    if (size > 0) m_output.write((const char*)data, (std::streamsize)size);
+    m_offset += size;
+}
+
+void TrajectoryWriter::append(const Transition* transitions, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const Transition& transition = transitions[i];
+        if (transition.env >= (int)m_pending.size()) m_pending.resize(transition.env + 1);
+
+        std::vector<Transition>& rows = m_pending[transition.env];
+        rows.push_back(transition);
+        if (transition.done == LANDER_DONE_NONE) continue;
+
+        add_episode(transition.env, rows);
+        rows.clear();
+    }
+}
+
+void TrajectoryWriter::add_episode(int env, const std::vector<Transition>& rows)
+{
+    // Episodes stay whole, so a chunk only ends between them
+    if (m_column_rows > 0 && m_column_rows + rows.size() > (size_t)m_chunk_rows) flush_chunk();
+    if (m_column_rows == 0) m_chunk_first_episode = (uint32_t)m_episodes.size();
+
+    TrajectoryEpisode episode = {};
+    episode.chunk = (uint32_t)m_chunks.size();
+    episode.first_row = m_column_rows;
+    episode.length = (uint32_t)rows.size();
+    episode.env = (uint32_t)env;
+    std::memcpy(episode.final_observation, rows.back().next_observation, sizeof(episode.final_observation));
+    m_episodes.push_back(episode);
+
+    // STEP 1: Each field of every row onto the end of its own column
+    for (const Transition& row : rows)
+    {
+        const float* observation = row.observation;
+        uint8_t contacts[4] = { (uint8_t)(observation[LANDER_OBS_CONTACT_TOP] != 0.0f), (uint8_t)(observation[LANDER_OBS_CONTACT_BOTTOM] != 0.0f),
+                                (uint8_t)(observation[LANDER_OBS_CONTACT_LEFT] != 0.0f), (uint8_t)(observation[LANDER_OBS_CONTACT_RIGHT] != 0.0f) };
+        uint8_t action = (uint8_t)row.action,
+                done   = (uint8_t)row.done;
+
+        auto push = [this](int column, const void* data)
+            {
+                std::vector<uint8_t>& bytes = m_columns[column].bytes;
+                bytes.insert(bytes.end(), (const uint8_t*)data, (const uint8_t*)data + m_columns[column].element_size);
+            };
+        push(TRAJECTORY_POSITION,   &observation[LANDER_OBS_POSITION_X]);
+        push(TRAJECTORY_VELOCITY,   &observation[LANDER_OBS_VELOCITY_X]);
+        push(TRAJECTORY_WIN_OFFSET, &observation[LANDER_OBS_WIN_OFFSET_X]);
+        push(TRAJECTORY_CONTACTS,   contacts);
+        push(TRAJECTORY_ACTION,     &action);
+        push(TRAJECTORY_REWARD,     &row.reward);
+        push(TRAJECTORY_DONE,       &done);
+    }
+    m_column_rows += (uint32_t)rows.size();
+
+    // STEP 2: Out to disk once full (or past it, by the one episode that wouldn't split)
+    if (m_column_rows >= (uint32_t)m_chunk_rows) flush_chunk();
+}
+
+void TrajectoryWriter::flush_chunk()
+{
+    if (m_column_rows == 0) return;
+
+    TrajectoryChunk chunk = {};
+    chunk.first_row = m_row_count;
+    chunk.row_count = m_column_rows;
+    chunk.first_episode = m_chunk_first_episode;
+
+    // One write per column, each on its own alignment boundary
+    for (int column = 0; column < TRAJECTORY_COLUMN_COUNT; column++)
+    {
+        std::vector<uint8_t>& bytes = m_columns[column].bytes;
+        chunk.column_offsets[column] = align_up(m_offset, TrajectoryFile::SECTION_ALIGNMENT);
+        write_at(chunk.column_offsets[column], bytes.data(), bytes.size());
+        bytes.clear();
+    }
+
+    m_chunks.push_back(chunk);
+    m_row_count += m_column_rows;
+    m_column_rows = 0;
+}
+
+bool TrajectoryWriter::close()
+{
+    if (!m_output.is_open()) return false;
+
+    flush_chunk();
+
+    TrajectoryFooter footer = {};
+    footer.chunks_offset = align_up(m_offset, TrajectoryFile::SECTION_ALIGNMENT);
+    write_at(footer.chunks_offset, m_chunks.data(), m_chunks.size() * sizeof(TrajectoryChunk));
+    footer.episodes_offset = align_up(m_offset, TrajectoryFile::SECTION_ALIGNMENT);
+    write_at(footer.episodes_offset, m_episodes.data(), m_episodes.size() * sizeof(TrajectoryEpisode));
+
+    footer.row_count = m_row_count;
+    footer.chunk_count = (uint32_t)m_chunks.size();
+    footer.episode_count = (uint32_t)m_episodes.size();
+    footer.version = TrajectoryFile::VERSION;
+    std::memcpy(footer.magic, TrajectoryFile::MAGIC, sizeof(footer.magic));
+    write_at(m_offset, &footer, sizeof(footer));
+
+    bool written = (bool)m_output;
+    m_output.close();
+    m_pending.clear();
+    return written;
+}
+
+// ————— READER ————— //
+bool TrajectoryFile::open(const char* filepath)
+{
+    close();
+
+    // STEP 1: Map the file
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size = (size_t)size.QuadPart;
+#else
+    int file = ::open(filepath, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    m_file = file;
+    m_data = data == MAP_FAILED ? NULL : (const unsigned char*)data;
+    m_size = (size_t)status.st_size;
+#endif
+
+    if (m_data == NULL)
+    {
+        close();
+        return false;
+    }
+
+    // STEP 2: The header, the footer and the index; the columns themselves are left unread
+    const TrajectoryHeader* header = (const TrajectoryHeader*)m_data;
+    const TrajectoryFooter* footer = (const TrajectoryFooter*)(m_data + m_size - sizeof(TrajectoryFooter));
+    bool valid = m_size >= sizeof(TrajectoryHeader) + sizeof(TrajectoryFooter) &&
+                 std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+                 header->column_count == TRAJECTORY_COLUMN_COUNT && header->observation_size == LANDER_OBSERVATION_SIZE &&
+                 std::memcmp(footer->magic, MAGIC, sizeof(MAGIC)) == 0 && footer->version == VERSION;
+
+    valid = valid && section_fits(footer->chunks_offset, footer->chunk_count, sizeof(TrajectoryChunk), m_size) &&
+                     section_fits(footer->episodes_offset, footer->episode_count, sizeof(TrajectoryEpisode), m_size);
+
+    const TrajectoryChunk* chunks = (const TrajectoryChunk*)(m_data + (valid ? footer->chunks_offset : 0));
+    for (uint32_t c = 0; valid && c < footer->chunk_count; c++)
+    {
+        for (int column = 0; valid && column < TRAJECTORY_COLUMN_COUNT; column++)
+        {
+            valid = section_fits(chunks[c].column_offsets[column], chunks[c].row_count, COLUMN_SIZES[column], m_size);
+        }
+    }
+
+    const TrajectoryEpisode* episodes = (const TrajectoryEpisode*)(m_data + (valid ? footer->episodes_offset : 0));
+    for (uint32_t e = 0; valid && e < footer->episode_count; e++)
+    {
+        valid = episodes[e].chunk < footer->chunk_count &&
+                (uint64_t)episodes[e].first_row + episodes[e].length <= chunks[episodes[e].chunk].row_count;
+    }
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    m_footer = footer;
+    m_chunks = chunks;
+    m_episodes = episodes;
+    return true;
+}
+
+void TrajectoryFile::close()
+{
+#ifdef _WIN32
+    if (m_data != NULL) UnmapViewOfFile(m_data);
+    if (m_mapping != NULL) CloseHandle(m_mapping);
+    if (m_file != NULL) CloseHandle(m_file);
+    m_file = m_mapping = NULL;
+#else
+    if (m_data != NULL) munmap((void*)m_data, m_size);
+    if (m_file >= 0) ::close(m_file);
+    m_file = -1;
+#endif
+
+    m_data = NULL;
+    m_size = 0;
+    m_footer = NULL;
+    m_chunks = NULL;
+    m_episodes = NULL;
+}
+
+TrajectorySlice TrajectoryFile::get_episode(int index) const
+{
+    const TrajectoryEpisode& episode = m_episodes[index];
+    auto column = [&](TrajectoryColumn column) { return (const uint8_t*)get_column(episode.chunk, column) + episode.first_row * COLUMN_SIZES[column]; };
+
+    TrajectorySlice slice;
+    slice.positions         = (const glm::vec2*)column(TRAJECTORY_POSITION);
+    slice.velocities        = (const glm::vec2*)column(TRAJECTORY_VELOCITY);
+    slice.win_offsets       = (const glm::vec2*)column(TRAJECTORY_WIN_OFFSET);
+    slice.contacts          = column(TRAJECTORY_CONTACTS);
+    slice.actions           = column(TRAJECTORY_ACTION);
+    slice.rewards           = (const float*)column(TRAJECTORY_REWARD);
+    slice.dones             = column(TRAJECTORY_DONE);
+    slice.final_observation = episode.final_observation;
+    slice.length            = (int)episode.length;
+    slice.env               = (int)episode.env;
+    return slice;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+// .traj: rollout transitions stored a column at a time, for offline training. Rows are grouped
+// into chunks, and within a chunk each field (positions, velocities, actions, rewards, dones...)
+// is one contiguous array, so a trainer maps the file and reads a field for a whole chunk, or
+// for one episode, straight out of the mapping, with nothing to parse.
+//
+//   TrajectoryHeader | chunk 0 | chunk 1 | ... | TrajectoryChunk[chunk_count]
+//                    | TrajectoryEpisode[episode_count] | TrajectoryFooter
+//
+// A chunk is TRAJECTORY_COLUMN_COUNT arrays of row_count elements, in TrajectoryColumn order,
+// each starting SECTION_ALIGNMENT-aligned. An episode's rows are consecutive and never straddle
+// two chunks; the step after its last (the observation it finished on) is kept in the episode's
+// record. The index sits at the end, found from the fixed-size footer, so the writer appends
+// each chunk as it fills and writes the index once on close. All fields are little-endian;
+// offsets count from the start of the file.
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "glm/vec2.hpp"
+#include "LanderEnv.h"
+#include "RolloutCollector.h"
+
+enum TrajectoryColumn
+{
+    TRAJECTORY_POSITION,    // glm::vec2, LANDER_OBS_POSITION_*
+    TRAJECTORY_VELOCITY,    // glm::vec2
+    TRAJECTORY_WIN_OFFSET,  // glm::vec2
+    TRAJECTORY_CONTACTS,    // uint8_t[4], top, bottom, left, right
+    TRAJECTORY_ACTION,      // uint8_t, LanderAction bits
+    TRAJECTORY_REWARD,      // float
+    TRAJECTORY_DONE,        // uint8_t, LanderDone code; only the last row of an episode has one
+    TRAJECTORY_COLUMN_COUNT
+};
+
+struct TrajectoryHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t column_count;
+    uint32_t observation_size;  // LANDER_OBSERVATION_SIZE when written
+    uint8_t  reserved[48];
+};
+
+struct TrajectoryChunk
+{
+    uint64_t first_row;     // of the whole file
+    uint32_t row_count,
+             first_episode;
+    uint64_t column_offsets[TRAJECTORY_COLUMN_COUNT];
+};
+
+struct TrajectoryEpisode
+{
+    uint32_t chunk,
+             first_row,  // within its chunk
+             length,
+             env;        // the collector's global env index
+    float    final_observation[LANDER_OBSERVATION_SIZE];
+};
+
+struct TrajectoryFooter
+{
+    uint64_t chunks_offset,
+             episodes_offset,
+             row_count;
+    uint32_t chunk_count,
+             episode_count;
+    uint32_t version;
+    char     magic[4];
+};
+
+// Appends transitions, sorting them into episodes by env as they arrive in whatever order the
+// collector's rings hand them over. An episode goes into the current chunk once it's done, and a
+// chunk full to chunk_rows is written out in TRAJECTORY_COLUMN_COUNT large sequential writes.
+// Episodes still under way at close() are dropped.
+class TrajectoryWriter
+{
+private:
+    struct Column
+    {
+        std::vector<uint8_t> bytes;
+        size_t               element_size;
+    };
+
+    std::ofstream m_output;
+    uint64_t      m_offset = 0;  // where the next write lands
+    int           m_chunk_rows = 0;
+
+    // ————— CHUNK BEING FILLED ————— //
+    Column   m_columns[TRAJECTORY_COLUMN_COUNT];
+    uint32_t m_column_rows = 0,
+             m_chunk_first_episode = 0;
+    std::vector<std::vector<Transition>> m_pending;  // per env, the episode under way
+
+    // ————— INDEX ————— //
+    std::vector<TrajectoryChunk>   m_chunks;
+    std::vector<TrajectoryEpisode> m_episodes;
+    uint64_t                       m_row_count = 0;
+
+    void write_at(uint64_t offset, const void* data, size_t size);
+    void add_episode(int env, const std::vector<Transition>& rows);
+    void flush_chunk();
+
+public:
+    static const int DEFAULT_CHUNK_ROWS = 1 << 16;
+
+    TrajectoryWriter() = default;
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+    ~TrajectoryWriter() { close(); }
+
+    bool open(const char* filepath, int chunk_rows = DEFAULT_CHUNK_ROWS);
+    void append(const Transition* transitions, int count);
+    // Writes the last chunk and the index; false if anything failed to write
+    bool close();
+
+    bool      const is_open()           const { return m_output.is_open(); };
+    long long const get_row_count()     const { return (long long)m_row_count; };
+    int       const get_episode_count() const { return (int)m_episodes.size(); };
+};
+
+// One episode's columns, pointing into the mapping
+struct TrajectorySlice
+{
+    const glm::vec2* positions;
+    const glm::vec2* velocities;
+    const glm::vec2* win_offsets;
+    const uint8_t*   contacts;  // four per row
+    const uint8_t*   actions;
+    const float*     rewards;
+    const uint8_t*   dones;
+    const float*     final_observation;
+    int              length,
+                     env;
+};
+
+class TrajectoryFile
+{
+private:
+    const unsigned char*     m_data     = NULL;
+    size_t                   m_size     = 0;
+    const TrajectoryFooter*  m_footer   = NULL;
+    const TrajectoryChunk*   m_chunks   = NULL;
+    const TrajectoryEpisode* m_episodes = NULL;
+
+#ifdef _WIN32
+    void* m_file    = NULL,
+        * m_mapping = NULL;
+#else
+    int m_file = -1;
+#endif
+
+public:
+    static const uint32_t VERSION           = 1;
+    static const size_t   SECTION_ALIGNMENT = 64;
+    static const char     MAGIC[4];
+
+    TrajectoryFile() = default;
+    TrajectoryFile(const TrajectoryFile&) = delete;
+    TrajectoryFile& operator=(const TrajectoryFile&) = delete;
+    ~TrajectoryFile() { close(); }
+
+    // Maps the whole file read-only; false if it is missing, truncated, unfinished (no footer)
+    // or from another version. Only the header and the index are checked.
+    bool open(const char* filepath);
+    void close();
+
+    // Everything below points straight into the mapped pages and stays valid until close()
+    const void* get_column(int chunk, TrajectoryColumn column) const { return m_data + m_chunks[chunk].column_offsets[column]; };
+    TrajectorySlice get_episode(int episode) const;
+
+    bool      const is_open()           const { return m_data != NULL; };
+    int       const get_chunk_count()   const { return (int)m_footer->chunk_count; };
+    int       const get_episode_count() const { return (int)m_footer->episode_count; };
+    long long const get_row_count()     const { return (long long)m_footer->row_count; };
+    const TrajectoryChunk&   get_chunk(int chunk)          const { return m_chunks[chunk]; };
+    const TrajectoryEpisode& get_episode_record(int index) const { return m_episodes[index]; };
+};
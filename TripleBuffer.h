@@ -0,0 +1,47 @@
+#pragma once
+
+// Latest-value handoff from one producer thread to one consumer thread, neither of which ever
+// waits for the other. There are three copies of T: the producer writes the back one, the
+// consumer reads the front one, and publishing swaps the back one with the third (the middle)
+// in a single atomic exchange. The consumer swaps the middle one in as its front whenever it's
+// newer. Values the consumer was too slow to see are simply overwritten, never queued.
+#include <atomic>
+
+template <typename T>
+class TripleBuffer
+{
+private:
+    static const unsigned char INDEX_MASK = 3,
+                               FRESH      = 4;  // set on the middle index while the consumer hasn't taken it
+
+    T                          m_slots[3];
+    std::atomic<unsigned char> m_middle{ 1 };
+    unsigned char              m_back  = 2,   // producer only
+                               m_front = 0;   // consumer only
+
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ————— PRODUCER ————— //
+    // Write the next value here, then publish() it
+    T& get_back() { return m_slots[m_back]; };
+
+    void publish()
+    {
+        m_back = m_middle.exchange((unsigned char)(m_back | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // ————— CONSUMER ————— //
+    // Takes the newest published value, if there is one the front doesn't already hold
+    bool update()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T& get_front() const { return m_slots[m_front]; };
+};
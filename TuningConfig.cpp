@@ -0,0 +1,118 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <fstream>
+#include <sstream>
+#include "TuningConfig.h"
+
+// Steps longer than this would skip through a platform in one go
+static const float MAX_TIMESTEP = 0.1f;
+
+// One key's value into its field; false for a key it doesn't know or a value out of range
+static bool read_value(const std::string& key, std::istringstream& fields, Tuning& tuning)
+{
+    LanderTuning& lander = tuning.lander;
+    WorldTuning&  world  = tuning.world;
+
+    // ————— LANDER ————— //
+    if (key == "lander_speed")   return (bool)(fields >> lander.speed) && lander.speed >= 0.0f;
+    if (key == "boosting_power") return (bool)(fields >> lander.boosting_power) && lander.boosting_power >= 0.0f;
+    if (key == "lander_drag")    return (bool)(fields >> lander.drag) && lander.drag >= 0.0f;
+    if (key == "gravity")        return (bool)(fields >> lander.gravity);
+
+    // ————— WORLD ————— //
+    if (key == "fixed_timestep")      return (bool)(fields >> world.fixed_timestep) && world.fixed_timestep > 0.0f && world.fixed_timestep <= MAX_TIMESTEP;
+    if (key == "platform_count")      return (bool)(fields >> world.platform_count) && world.platform_count >= 0;
+    if (key == "max_steps_per_frame") return (bool)(fields >> world.max_steps_per_frame) && world.max_steps_per_frame >= 0;
+    return false;
+}
+
+bool TuningConfig::read(Tuning& tuning)
+{
+    std::ifstream input(m_path);
+    if (!input)
+    {
+        m_error = "unable to open " + m_path;
+        return false;
+    }
+
+    std::string line;
+    for (int line_number = 1; std::getline(input, line); line_number++)
+    {
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string key, extra;
+        if (!(fields >> key)) continue;
+
+        if (!read_value(key, fields, tuning) || fields >> extra)
+        {
+            m_error = m_path + ", line " + std::to_string(line_number) + ": bad " + key;
+            return false;
+        }
+    }
+
+    m_error.clear();
+    return true;
+}
+
+bool TuningConfig::load(const char* filepath)
+{
+    m_path = filepath;
+    m_tuning = Tuning();
+
+    std::error_code error;
+    m_loaded_time = m_seen_time = std::filesystem::last_write_time(m_path, error);
+    m_loaded = true;
+
+    Tuning tuning;
+    if (!read(tuning)) return false;
+
+    m_tuning = tuning;
+    m_version++;
+    return true;
+}
+
+bool TuningConfig::poll()
+{
+    if (!m_loaded) return false;
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < m_next_poll) return false;
+    m_next_poll = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(POLL_SECONDS));
+
+    // STEP 1: Changed since the last read, and the same as at the last check, so an editor
+    //         half way through saving it isn't read
+    std::error_code error;
+    std::filesystem::file_time_type time = std::filesystem::last_write_time(m_path, error);
+    bool settled = time == m_seen_time;
+    m_seen_time = time;
+    if (error || time == m_loaded_time || !settled) return false;
+
+    // STEP 2: Read once per save; a bad one keeps what was there and waits for the next
+    m_loaded_time = time;
+    Tuning tuning;
+    if (read(tuning))
+    {
+        m_tuning = tuning;
+        m_version++;
+    }
+    return true;
+}
+
+void apply_lander_tuning(Entity& lander, const LanderTuning& tuning)
+{
+    lander.set_speed(tuning.speed);
+    lander.m_boosting_power = tuning.boosting_power;
+    lander.m_drag = tuning.drag;
+
+    glm::vec3 acceleration = lander.get_acceleration();
+    lander.set_acceleration(glm::vec3(acceleration.x, tuning.gravity, acceleration.z));
+}
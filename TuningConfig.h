@@ -0,0 +1,80 @@
+#pragma once
+
+// Physics and performance knobs read from a text file rather than compiled in, so the timestep
+// and the size of the world can be set per machine without a rebuild. One `key value` pair a
+// line, # to the end of a line is a comment:
+//
+//     fixed_timestep       0.0333333   # half the physics cost on a slow machine
+//     platform_count       24
+//     lander_drag          0.6
+//
+// A load parses the whole file into plain structs, so nothing on a hot path looks a name up.
+// poll() watches the file the way GameplayModule watches its library, and rereads it once a
+// rewrite has settled; a file that doesn't parse leaves the last good values in place. What a
+// change reaches, and when, is the caller's to decide.
+//
+// Replays, ghosts and network games only carry the scene and the timestep, so anything they are
+// compared against has to be flown with the same lander tuning.
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include "Entity.h"
+#include "Simulation.h"
+
+struct LanderTuning
+{
+    float speed          = 2.0f,  // setup_player's
+          boosting_power = 0.1f,
+          drag           = 0.8f,
+          gravity        = ACC_OF_GRAVITY;
+};
+
+struct WorldTuning
+{
+    float fixed_timestep      = FIXED_TIMESTEP;
+    int   platform_count      = 0;  // 0 leaves the scene's own
+    int   max_steps_per_frame = MAX_STEPS_PER_FRAME;  // StepBudget's; 0 for no limit
+};
+
+struct Tuning
+{
+    LanderTuning lander;
+    WorldTuning  world;
+};
+
+class TuningConfig
+{
+private:
+    static constexpr double POLL_SECONDS = 0.25;
+
+    std::string m_path;
+    Tuning      m_tuning;
+    std::string m_error;  // the last read's, empty when it parsed
+    bool        m_loaded = false;
+
+    std::filesystem::file_time_type m_loaded_time,
+                                    m_seen_time;  // at the last check, to tell when it settles
+    std::chrono::steady_clock::time_point m_next_poll;
+    int m_version = 0;  // bumped by every read that takes
+
+    // The file as it is now, over a copy of the defaults; false, with m_error set, if any line is bad
+    bool read(Tuning& tuning);
+
+public:
+    // False, keeping the defaults, if the file can't be read or doesn't parse; it is still watched,
+    // so fixing it takes effect
+    bool load(const char* filepath);
+
+    // Once a frame, on the main thread; true when the file has just been reread, whether or not it
+    // parsed (see get_error)
+    bool poll();
+
+    const Tuning&      get()         const { return m_tuning; };
+    const std::string& get_error()   const { return m_error; };
+    const std::string& get_path()    const { return m_path; };
+    bool               const is_loaded()   const { return m_loaded; };
+    int                const get_version() const { return m_version; };
+};
+
+// Over whatever setup_player and reset_episode left, with the lander where it is
+void apply_lander_tuning(Entity& lander, const LanderTuning& tuning);
@@ -0,0 +1,35 @@
+#pragma once
+
+// Text is UTF-8 everywhere; these walk it a code point at a time. ASCII comes out of the font
+// sheet as it always has, and anything past it out of GlyphCache.
+#include <string_view>
+
+const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+// The code point starting at text[index], moving index on past it. Anything malformed (a stray
+// continuation byte, a cut-off sequence, an overlong form, a surrogate or anything past U+10FFFF)
+// comes out as one REPLACEMENT_CHARACTER for its first byte, and decoding picks up after it.
+inline char32_t decode_utf8(std::string_view text, size_t& index)
+{
+    unsigned char lead = (unsigned char)text[index++];
+    if (lead < 0x80) return lead;
+
+    int      length;
+    char32_t code,
+             minimum;
+    if      ((lead & 0xE0) == 0xC0) { length = 1; code = lead & 0x1F; minimum = 0x80; }
+    else if ((lead & 0xF0) == 0xE0) { length = 2; code = lead & 0x0F; minimum = 0x800; }
+    else if ((lead & 0xF8) == 0xF0) { length = 3; code = lead & 0x07; minimum = 0x10000; }
+    else return REPLACEMENT_CHARACTER;
+
+    size_t next = index;
+    for (int i = 0; i < length; i++, next++)
+    {
+        if (next >= text.size() || ((unsigned char)text[next] & 0xC0) != 0x80) return REPLACEMENT_CHARACTER;
+        code = code << 6 | ((unsigned char)text[next] & 0x3F);
+    }
+    if (code < minimum || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return REPLACEMENT_CHARACTER;
+
+    index = next;
+    return code;
+}
@@ -0,0 +1,135 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+#include <algorithm>
+#include "WorldPool.h"
+
+World::World(int platform_count) : platforms(new Entity[platform_count])
+{
+    state.player = &player;
+    state.platforms = platforms.get();
+    state.platform_count = platform_count;
+    state.platform_colliders = &colliders;
+}
+
+WorldPool::WorldPool(int thread_count) : m_steal_count(0)
+{
+    if (thread_count <= 0) thread_count = std::max(1, (int)std::thread::hardware_concurrency());
+
+    for (int i = 0; i < thread_count; i++) m_queues.emplace_back(new WorkQueue());
+    for (int i = 0; i < thread_count; i++) m_threads.emplace_back(&WorldPool::worker_loop, this, i);
+}
+
+WorldPool::~WorldPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) thread.join();
+}
+
+void WorldPool::run(GameState* const* worlds, int world_count, int max_steps, WorldController controller, void* user_data)
+{
+    if (world_count <= 0) return;
+
+    // STEP 1: Deal the worlds out in contiguous blocks, so neighbours share a thread to begin with
+    const int thread_count = (int)m_threads.size();
+    for (int i = 0; i < world_count; i++)
+    {
+        WorkQueue& queue = *m_queues[(long long)i * thread_count / world_count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.worlds.push_back(i);
+    }
+
+    // STEP 2: Wake the workers and wait until the last of them runs out of work
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_worlds = worlds;
+    m_max_steps = max_steps;
+    m_controller = controller;
+    m_user_data = user_data;
+    m_active_workers = thread_count;
+    m_generation++;
+
+    m_wake.notify_all();
+    m_finished.wait(lock, [this]() { return m_active_workers == 0; });
+
+    m_worlds = NULL;
+}
+
+bool WorldPool::next_world(int worker, int& world)
+{
+    // Own queue from the back...
+    {
+        WorkQueue& own = *m_queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.worlds.empty())
+        {
+            world = own.worlds.back();
+            own.worlds.pop_back();
+            return true;
+        }
+    }
+
+    // ...then everyone else's from the front, starting with the next worker along
+    const int queue_count = (int)m_queues.size();
+    for (int offset = 1; offset < queue_count; offset++)
+    {
+        WorkQueue& victim = *m_queues[(worker + offset) % queue_count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.worlds.empty())
+        {
+            world = victim.worlds.front();
+            victim.worlds.pop_front();
+            m_steal_count++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorldPool::run_world(GameState& state)
+{
+    int step = 0;
+    while (step < m_max_steps && !state.win && !state.loss)
+    {
+        if (m_controller != NULL) m_controller(state, m_user_data);
+        step_simulation(state, state.fixed_timestep);
+        step++;
+    }
+
+    state.budget.total_steps += step;
+}
+
+void WorldPool::worker_loop(int worker)
+{
+    int seen_generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_stopping || m_generation != seen_generation; });
+            if (m_stopping) return;
+            seen_generation = m_generation;
+        }
+
+        int world;
+        while (next_world(worker, world)) run_world(*m_worlds[world]);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active_workers == 0) m_finished.notify_one();
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// Runs many independent GameStates on every core. Episodes end at very different times, so each
+// thread works through its own queue of worlds and, once that runs dry, steals from the front
+// of the others'.
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PlatformIntervalIndex.h"
+#include "Simulation.h"
+
+// Called before every step of a world, from whichever thread is running it
+typedef void (*WorldController)(GameState& state, void* user_data);
+
+// A GameState together with the entities it points at, for callers that need many worlds
+struct World
+{
+    Entity player;
+    std::unique_ptr<Entity[]> platforms;
+    PlatformColliders colliders;
+    PlatformIntervalIndex broadphase;  // left unbuilt and unattached until a scene needs one
+    GameState state;
+
+    World(int platform_count = PLATFORM_COUNT);
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+};
+
+class WorldPool
+{
+private:
+    struct WorkQueue
+    {
+        std::mutex      mutex;
+        std::deque<int> worlds;
+    };
+
+    std::vector<std::thread>                m_threads;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+    // ————— CURRENT JOB ————— //
+    GameState* const* m_worlds = NULL;
+    int               m_max_steps = 0;
+    WorldController   m_controller = NULL;
+    void*             m_user_data = NULL;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_wake,
+                            m_finished;
+    int  m_generation     = 0,
+         m_active_workers = 0;
+    bool m_stopping       = false;
+
+    std::atomic<long long> m_steal_count;
+
+    void worker_loop(int worker);
+    bool next_world(int worker, int& world);
+    void run_world(GameState& state);
+
+public:
+    // 0 threads means one per hardware thread
+    WorldPool(int thread_count = 0);
+    ~WorldPool();
+
+    WorldPool(const WorldPool&) = delete;
+    WorldPool& operator=(const WorldPool&) = delete;
+
+    // Steps every world, by its own fixed_timestep, until it wins, loses or reaches max_steps, and
+    // returns once all are done
+    void run(GameState* const* worlds, int world_count, int max_steps, WorldController controller, void* user_data = NULL);
+
+    int       const get_thread_count() const { return (int)m_threads.size(); };
+    long long const get_steal_count()  const { return m_steal_count.load(); };
+};
@@ -0,0 +1,893 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Microbenchmarks for the hot paths the performance work keeps touching: collision, a full
+// physics step, and the CPU side of drawing. No window, no GL and no SDL.
+//
+//     LanderBench [--simd <isa>] [filter]
+//
+// Only benchmarks whose name contains `filter` run. Each one finds an iteration count that takes
+// about MIN_BATCH_SECONDS, then reports the median of REPETITIONS batches of it, so a single
+// preempted batch doesn't move the number. --simd runs every SIMD kernel family on scalar, sse2,
+// avx2, avx512 or neon rather than the widest this CPU has (see SimdDispatch.h), for comparing
+// them on one machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AudioMixer.h"
+#include "DistanceField.h"
+#include "Entity.h"
+#include "EnvServer.h"
+#include "InputReplay.h"
+#include "JobSystem.h"
+#include "LevelEditor.h"
+#include "NetSnapshot.h"
+#include "PolicyNetwork.h"
+#include "Simulation.h"
+#include "SimdDispatch.h"
+#include "PlatformIntervalIndex.h"
+#include "PlatformColliders.h"
+#include "RollbackSession.h"
+#include "RolloutCollector.h"
+#include "TrajectoryStore.h"
+#include "Rng.h"
+#include "SoundSynth.h"
+#include "SpriteSheet.h"
+#include "Terrain.h"
+#include "TextGeometry.h"
+#include "TimerWheel.h"
+
+typedef std::chrono::steady_clock Clock;
+
+const double MIN_BATCH_SECONDS = 0.05;
+const int    REPETITIONS       = 7;
+const int    PLATFORM_COUNTS[] = { 10, 1000, 100000 };
+const char   SAMPLE_TEXT[]     = "YOU LANDED SAFELY!";
+
+// Results are folded in here so the compiler can't drop the work that produced them
+volatile unsigned int g_sink = 0;
+
+const char* g_filter = "";
+
+// ————— HARNESS ————— //
+// `batch(iterations)` runs the operation that many times; items_per_op is what one operation
+// processes (platforms tested, glyphs built, ...) for the items/s column
+template <typename Batch>
+void run_benchmark(const std::string& name, long long items_per_op, Batch batch)
+{
+    if (name.find(g_filter) == std::string::npos) return;
+
+    auto time_batch = [&batch](long long iterations)
+        {
+            Clock::time_point start = Clock::now();
+            batch(iterations);
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+    // STEP 1: Double the iteration count until one batch is long enough to time reliably
+    long long iterations = 1;
+    while (time_batch(iterations) < MIN_BATCH_SECONDS && iterations < (1LL << 40)) iterations *= 2;
+
+    // STEP 2: The median of several batches of that size
+    std::vector<double> seconds(REPETITIONS);
+    for (int i = 0; i < REPETITIONS; i++) seconds[i] = time_batch(iterations);
+    std::sort(seconds.begin(), seconds.end());
+    double median = seconds[REPETITIONS / 2];
+
+    double ns_per_op      = median / iterations * 1.0e9,
+           items_per_second = items_per_op * iterations / median;
+
+    std::cout << std::left << std::setw(44) << name << std::right
+              << std::fixed << std::setprecision(1) << std::setw(14) << ns_per_op << " ns/op"
+              << std::scientific << std::setprecision(3) << std::setw(14) << items_per_second << " items/s"
+              << std::defaultfloat << std::endl;
+}
+
+// ————— SCENES ————— //
+// A ground row `count` platforms wide, centred on x = 0, alternating WIN and DEATH
+std::vector<Entity> make_platform_row(int count)
+{
+    std::vector<Entity> platforms(count);
+    for (int i = 0; i < count; i++)
+    {
+        platforms[i].set_position(glm::vec3(i - count / 2, -3.0f, 0.0f));
+        platforms[i].set_entity_type(i % 2 == 0 ? WIN_PLATFORM : DEATH_PLATFORM);
+        platforms[i].set_body_type(STATIC_BODY);
+    }
+    return platforms;
+}
+
+// Sinking 0.05 into the platform under x = 0, so every check has one overlap to resolve
+const glm::vec3 OVERLAPPING_POSITION = glm::vec3(0.0f, -3.0f + 0.5f + 0.4f - 0.05f, 0.0f);
+
+void setup_bench_player(Entity& player)
+{
+    setup_player(&player);
+    player.set_position(OVERLAPPING_POSITION);
+    player.set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY, 0.0f));
+}
+
+// ————— BENCHMARKS ————— //
+void bench_check_collision()
+{
+    Entity player, platform;
+    setup_bench_player(player);
+    platform.set_position(glm::vec3(0.0f, -3.0f, 0.0f));
+
+    run_benchmark("check_collision", 1, [&](long long iterations)
+        {
+            unsigned int hits = 0;
+            for (long long i = 0; i < iterations; i++) hits += player.check_collision(&platform);
+            g_sink += hits;
+        });
+}
+
+void bench_check_collision_axes(int count)
+{
+    std::vector<Entity> platforms = make_platform_row(count);
+    PlatformIntervalIndex index;
+    index.build(platforms.data(), count);
+
+    Entity player;
+    setup_bench_player(player);
+
+    std::string suffix = "/" + std::to_string(count);
+    GameEventBuffer events;
+
+    // Without a broadphase every platform is tested, so items are platforms; with one, a check
+    // is the item, since how many platforms it skips is the point
+    run_benchmark("check_collision_y/all" + suffix, count, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                player.set_position(OVERLAPPING_POSITION);
+                events.clear();
+                player.check_collision_y(platforms.data(), count, &events);
+            }
+            g_sink += (unsigned int)events.get_count();
+        });
+
+    run_benchmark("check_collision_y/interval_index" + suffix, 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                player.set_position(OVERLAPPING_POSITION);
+                events.clear();
+                player.check_collision_y(platforms.data(), count, &events, &index);
+            }
+            g_sink += (unsigned int)events.get_count();
+        });
+
+    run_benchmark("check_collision_x/all" + suffix, count, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                player.set_position(OVERLAPPING_POSITION);
+                player.check_collision_x(platforms.data(), count);
+            }
+            g_sink += (unsigned int)player.m_collided_left;
+        });
+
+    run_benchmark("check_collision_x/interval_index" + suffix, 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                player.set_position(OVERLAPPING_POSITION);
+                player.check_collision_x(platforms.data(), count, &index);
+            }
+            g_sink += (unsigned int)player.m_collided_left;
+        });
+}
+
+void bench_update(int count)
+{
+    std::vector<Entity> platforms = make_platform_row(count);
+    PlatformIntervalIndex index;
+    index.build(platforms.data(), count);
+    PlatformColliders colliders;
+    colliders.build(platforms.data(), count);
+
+    // Falling onto the middle platform, as the game's player would; every step starts over
+    Entity player;
+    setup_bench_player(player);
+    player.set_position(OVERLAPPING_POSITION + glm::vec3(0.0f, 0.02f, 0.0f));
+    player.set_velocity(glm::vec3(0.1f, -1.0f, 0.0f));
+    player.m_booster_active = true;
+
+    BodyState start;
+    player.save_state(start);
+
+    run_benchmark("Entity::update/" + std::to_string(count), 1, [&](long long iterations)
+        {
+            GameEventBuffer events;
+            for (long long i = 0; i < iterations; i++)
+            {
+                player.restore_state(start);
+                events.clear();
+                player.update(FIXED_TIMESTEP, platforms.data(), count, &events, &index, &colliders);
+            }
+            g_sink += (unsigned int)events.get_count();
+        });
+}
+
+// `count` landers a few units apart, as in a race, sliding along the ground for SLIDE_STEPS steps:
+// stepped one GameState each, then all through one GameState, over a row with and without a
+// broadphase. The difference is what sharing their platform queries saves.
+void bench_landers(int count, bool use_broadphase)
+{
+    const int SLIDE_STEPS = 60;
+    const int platform_count = 1000;
+    std::vector<Entity> platforms = make_platform_row(platform_count);
+    PlatformIntervalIndex index;
+    index.build(platforms.data(), platform_count);
+    PlatformColliders colliders;
+    colliders.build(platforms.data(), platform_count);
+
+    std::vector<Entity> landers(count);
+    std::vector<BodyState> starts(count);
+    for (int i = 0; i < count; i++)
+    {
+        setup_bench_player(landers[i]);
+        landers[i].set_position(OVERLAPPING_POSITION + glm::vec3(i * 0.1f, 0.02f, 0.0f));
+        landers[i].set_velocity(glm::vec3(3.0f, -1.0f, 0.0f));
+        landers[i].save_state(starts[i]);
+    }
+
+    std::vector<GameState> separate(count);
+    for (int i = 0; i < count; i++)
+    {
+        separate[i].player = &landers[i];
+        separate[i].platforms = platforms.data();
+        separate[i].platform_count = platform_count;
+        separate[i].platform_colliders = &colliders;
+        if (use_broadphase) separate[i].platform_broadphase = &index;
+    }
+
+    std::vector<LanderOutcome> outcomes(count - 1);
+    GameState shared = separate[0];
+    shared.landers = landers.data() + 1;
+    shared.lander_outcomes = outcomes.data();
+    shared.lander_count = count - 1;
+
+    std::string suffix = std::to_string(count) + (use_broadphase ? "/interval" : "/no_broadphase");
+    run_benchmark("step_simulation/separate/" + suffix, (long long)count * SLIDE_STEPS, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                for (int k = 0; k < count; k++) landers[k].restore_state(starts[k]);
+                for (int step = 0; step < SLIDE_STEPS; step++)
+                {
+                    for (GameState& state : separate) step_simulation(state);
+                }
+            }
+            g_sink += (unsigned int)landers[0].m_collided_bottom;
+        });
+
+    run_benchmark("step_simulation/shared/" + suffix, (long long)count * SLIDE_STEPS, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                for (int k = 0; k < count; k++) landers[k].restore_state(starts[k]);
+                for (int step = 0; step < SLIDE_STEPS; step++) step_simulation(shared);
+            }
+            g_sink += (unsigned int)landers[0].m_collided_bottom;
+        });
+}
+
+// The lander's footprint against ground sampled at `spacing`; the finer the sampling, the more
+// samples sit under the lander and the more the SSE2 path has to work with
+void bench_terrain(float spacing)
+{
+    TerrainConfig config;
+    config.spacing = spacing;
+    config.sample_count = (int)(1000.0f / spacing);
+
+    Terrain terrain;
+    terrain.generate(config, 1);
+    const float width = 0.8f;
+    long long samples = (long long)(width / spacing);
+
+    auto run = [&](const std::string& path, auto query)
+        {
+            run_benchmark("Terrain::get_max_height/" + path + "/" + std::to_string(samples) + " samples", samples, [&](long long iterations)
+                {
+                    EntityType type;
+                    float total = 0.0f;
+                    for (long long i = 0; i < iterations; i++)
+                    {
+                        float x = (float)(i % 800) - 400.0f;
+                        total += query(x, x + width, type);
+                    }
+                    g_sink += (unsigned int)total;
+                });
+        };
+
+    run("scalar", [&](float min_x, float max_x, EntityType& type) { return terrain.get_max_height_scalar(min_x, max_x, type); });
+    run("simd",   [&](float min_x, float max_x, EntityType& type) { return terrain.get_max_height(min_x, max_x, type); });
+}
+
+// A lander settling onto the ground, colliding with the heightfield itself and with the same
+// ground baked into a distance field: the field costs the same few samples whatever its shape
+void bench_distance_field()
+{
+    TerrainConfig config;
+    Terrain terrain;
+    terrain.generate(config, 1);
+
+    float half_width = (config.sample_count - 1) * config.spacing / 2.0f;
+    DistanceField field;
+    field.begin(glm::vec2(-half_width, config.base_height - 2.5f), glm::vec2(half_width, config.base_height + 2.5f), 0.0625f);
+    field.fill_terrain(terrain);
+    field.bake();
+
+    Entity player;
+    setup_bench_player(player);
+    std::vector<BodyState> starts(800);
+    for (int i = 0; i < (int)starts.size(); i++)
+    {
+        float x = (float)i - 400.0f;
+        player.set_position(glm::vec3(x, terrain.get_height(x) + 0.38f, 0.0f));
+        player.set_velocity(glm::vec3(0.1f, -1.0f, 0.0f));
+        player.save_state(starts[i]);
+    }
+
+    auto run = [&](const std::string& path, const Terrain* ground, const DistanceField* baked)
+        {
+            run_benchmark("Entity::update/ground/" + path, 1, [&](long long iterations)
+                {
+                    GameEventBuffer events;
+                    for (long long i = 0; i < iterations; i++)
+                    {
+                        player.restore_state(starts[i % starts.size()]);
+                        events.clear();
+                        player.update(FIXED_TIMESTEP, NULL, 0, &events, NULL, NULL, NULL, ground, baked);
+                    }
+                    g_sink += (unsigned int)events.get_count();
+                });
+        };
+
+    run("terrain", &terrain, NULL);
+    run("distance_field", NULL, &field);
+}
+
+// A frame-shaped graph: `width` independent tasks of `work` iterations each, then one task that
+// waits on them all. With no work, what's left is the job system's own cost per task.
+void bench_job_system(int thread_count, int width, int work)
+{
+    JobSystem jobs(thread_count);
+    TaskGraph graph;
+
+    struct Chunk { int work; unsigned int result; };
+    std::vector<Chunk> chunks(width + 1, Chunk{ work, 0 });
+    JobFunction spin = [](void* user_data)
+        {
+            Chunk& chunk = *(Chunk*)user_data;
+            unsigned int value = 1;
+            for (int i = 0; i < chunk.work; i++) value = value * 1664525u + 1013904223u;
+            chunk.result = value;
+        };
+
+    std::string name = "JobSystem::run/" + std::to_string(jobs.get_thread_count()) + " threads/" + std::to_string(width) + "x" + std::to_string(work);
+    run_benchmark(name, width + 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                graph.clear();
+                int join = graph.add(spin, &chunks[width]);
+                for (int k = 0; k < width; k++) graph.add_dependency(join, graph.add(spin, &chunks[k]));
+                jobs.run(graph);
+            }
+            g_sink += chunks[0].result;
+        });
+}
+
+// One audio callback's worth of mixing, with every voice playing and one ramping its gain: the
+// whole buffer has to be done in far less than the 11 ms it lasts
+void bench_audio_mix(int voice_count)
+{
+    const int sample_rate = 48000,
+              buffer_frames = 512;
+
+    AudioMixer mixer;
+    mixer.set_sample_rate(sample_rate);
+    int bank = mixer.add_bank(synthesize_thrust(sample_rate));
+    for (int voice = 0; voice < voice_count; voice++) mixer.play(voice, bank, 0.5f, true);
+
+    std::vector<float> out(buffer_frames);
+    run_benchmark("AudioMixer::mix/" + std::to_string(voice_count) + " voices", buffer_frames, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                mixer.set_gain(0, (i & 1) ? 0.5f : 0.25f);
+                mixer.mix(out.data(), buffer_frames);
+            }
+            g_sink += (unsigned int)(out[0] * 1000.0f);
+        });
+}
+
+// A server's snapshots of `lander_count` players flying the classic level, each written against
+// the one from SNAPSHOT_LAG snapshots before, about what a client 100 ms away has acknowledged.
+// Besides the time, prints the size against the 2 KB/s a client is budgeted at 30 snapshots/s.
+void bench_snapshot_delta(int lander_count)
+{
+    const int STEPS = 1200,
+              SNAPSHOT_INTERVAL = 2,
+              SNAPSHOT_LAG = 3;
+    const float fixed_timestep = FIXED_TIMESTEP;
+
+    Entity player;
+    std::vector<Entity> platforms(PLATFORM_COUNT), landers(lander_count - 1);
+    std::vector<LanderOutcome> outcomes(lander_count - 1);
+    generate_platforms(platforms.data(), PLATFORM_COUNT, 1);
+    PlatformColliders colliders;
+    colliders.build(platforms.data(), PLATFORM_COUNT);
+
+    GameState state;
+    state.player = &player;
+    state.platforms = platforms.data();
+    state.platform_colliders = &colliders;
+    state.landers = landers.data();
+    state.lander_outcomes = outcomes.data();
+    state.lander_count = lander_count - 1;
+    setup_player(&player);
+    for (Entity& lander : landers) setup_player(&lander);
+    reset_episode(state);
+
+    // STEP 1: The session, stepped the way the server steps it, with everyone steering differently
+    std::vector<NetSnapshot> snapshots;
+    for (int step = 1; step <= STEPS; step++)
+    {
+        for (int i = 0; i < lander_count; i++)
+        {
+            Entity* lander = get_lander(state, i);
+            const int pattern[] = { REPLAY_NONE, REPLAY_BOOST, REPLAY_LEFT | REPLAY_BOOST, REPLAY_RIGHT };
+            int action = pattern[(step / (20 + 7 * i)) % 4];
+            if (lander->get_velocity().y < -1.0f) action |= REPLAY_BOOST;
+
+            quantize_lander(*lander, fixed_timestep);
+            apply_replay_action(lander, action);
+        }
+        step_simulation(state, fixed_timestep);
+
+        if (step % SNAPSHOT_INTERVAL != 0) continue;
+        NetSnapshot snapshot = {};
+        snapshot.tick = (uint32_t)step;
+        snapshot.lander_count = lander_count;
+        for (int i = 0; i < lander_count; i++)
+        {
+            LanderOutcome outcome = get_lander_outcome(state, i);
+            snapshot.landers[i] = capture_lander(*get_lander(state, i), fixed_timestep, true, outcome.win, outcome.loss);
+        }
+        snapshots.push_back(snapshot);
+    }
+
+    // STEP 2: Every snapshot against its baseline
+    uint8_t buffer[512];
+    long long total_bytes = 0;
+    auto encode_all = [&]()
+        {
+            total_bytes = 0;
+            for (size_t i = SNAPSHOT_LAG; i < snapshots.size(); i++)
+            {
+                BitWriter writer(buffer, sizeof(buffer));
+                write_snapshot(writer, snapshots[i], &snapshots[i - SNAPSHOT_LAG]);
+                total_bytes += (long long)writer.get_byte_count();
+            }
+        };
+
+    std::string name = "write_snapshot/" + std::to_string(lander_count) + " landers";
+    long long encoded = (long long)snapshots.size() - SNAPSHOT_LAG;
+    run_benchmark(name, encoded, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++) encode_all();
+            g_sink += (unsigned int)total_bytes;
+        });
+
+    if (name.find(g_filter) == std::string::npos) return;
+    encode_all();
+    double bytes_per_snapshot = (double)total_bytes / encoded;
+    std::cout << "  " << std::fixed << std::setprecision(1) << bytes_per_snapshot << " bytes/snapshot, "
+              << bytes_per_snapshot * 30.0 << " bytes/s at 30/s (" << (bytes_per_snapshot + 28.0) * 30.0 << " with UDP/IP headers)"
+              << std::defaultfloat << std::endl;
+}
+
+// One frame of head-to-head play in which the remote player's input for `depth` frames ago turns
+// out not to be what was predicted: the landers go back to that frame and simulate the `depth`
+// frames since, then the new one. The whole correction has to fit in a frame with plenty to spare.
+void bench_rollback(int depth)
+{
+    Entity player, opponent;
+    LanderOutcome opponent_outcome;
+    std::vector<Entity> platforms(PLATFORM_COUNT);
+    generate_platforms(platforms.data(), PLATFORM_COUNT, 1);
+    PlatformColliders colliders;
+    colliders.build(platforms.data(), PLATFORM_COUNT);
+
+    GameState state;
+    state.player = &player;
+    state.platforms = platforms.data();
+    state.platform_colliders = &colliders;
+    state.landers = &opponent;
+    state.lander_outcomes = &opponent_outcome;
+    state.lander_count = 1;
+    setup_player(&player);
+    setup_player(&opponent);
+    reset_episode(state);
+
+    RollbackSession session;
+    session.begin(state, 2, 0);
+    for (int frame = 0; frame < depth; frame++) session.advance(REPLAY_BOOST);
+
+    // Every confirmation flips the opponent's controls, so every one is a misprediction. The
+    // landers keep falling, but nothing in a frame's cost depends on how high they are.
+    run_benchmark("RollbackSession::advance/" + std::to_string(depth) + " frames back", depth + 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                int frame = session.get_frame();
+                session.add_remote_input(1, frame - depth, (frame & 1) ? REPLAY_LEFT : REPLAY_RIGHT);
+                session.advance((frame & 1) ? REPLAY_BOOST : REPLAY_NONE);
+            }
+            g_sink += (unsigned int)session.get_rollback_count();
+        });
+}
+
+void bench_text_geometry()
+{
+    FontMetrics font;
+    font.make_grid();
+
+    const int glyph_count = (int)std::strlen(SAMPLE_TEXT);
+    std::vector<float> vertices(glyph_count * TEXT_VERTICES_PER_GLYPH * TEXT_FLOATS_PER_VERTEX);
+
+    run_benchmark("build_text_vertices", glyph_count, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                build_text_vertices(font, SAMPLE_TEXT, 0.25f, 0.01f, vertices.data());
+                g_sink += (unsigned int)vertices[i % vertices.size()];
+            }
+        });
+}
+
+void bench_frame_uv_rect()
+{
+    glm::vec4 frames[SHIP_SHEET.FRAME_COUNT];
+    glm::vec4 region = glm::vec4(0.25f, 0.5f, 0.125f, 0.0625f);
+    map_sheet(SHIP_SHEET, region, frames);
+
+    Entity ship;
+    ship.m_animation_cols = 3;
+    ship.m_animation_rows = 1;
+    ship.m_uv_rect = region;
+
+    // draw_sprite_from_texture_atlas's UV work, with and without the precomputed sheet table
+    auto run = [&](const char* name)
+        {
+            run_benchmark(name, 1, [&](long long iterations)
+                {
+                    float total = 0.0f;
+                    for (long long i = 0; i < iterations; i++) total += ship.get_frame_uv_rect((int)(i % SHIP_SHEET.FRAME_COUNT)).x;
+                    g_sink += (unsigned int)total;
+                });
+        };
+
+    run("get_frame_uv_rect/computed");
+    ship.m_frame_uv_rects = frames;
+    run("get_frame_uv_rect/table");
+}
+
+// The headless driver's controller, over an observation rather than the Entity
+int bench_policy(const float* observation, void* /*user_data*/)
+{
+    if (observation[LANDER_OBS_VELOCITY_Y] < -1.0f)    return LANDER_ACTION_BOOST;
+    if (observation[LANDER_OBS_WIN_OFFSET_X] < -0.1f) return LANDER_ACTION_LEFT;
+    if (observation[LANDER_OBS_WIN_OFFSET_X] > 0.1f)  return LANDER_ACTION_RIGHT;
+    return LANDER_ACTION_NONE;
+}
+
+// A whole step's decisions for `lander_count` AI landers: a LanderEnv-sized policy, 10 -> 64 ->
+// 64 -> 3, with random weights, which cost exactly what trained ones do
+void bench_policy_network(int lander_count)
+{
+    std::string name = std::string("PolicyNetwork::evaluate/") + get_policy_kernel_name() + "/" + std::to_string(lander_count) + " landers";
+    if (name.find(g_filter) == std::string::npos) return;
+
+    // STEP 1: The network as the training side would write it
+    const int widths[]      = { LANDER_OBSERVATION_SIZE, 64, 64, 3 };
+    const int activations[] = { POLICY_RELU, POLICY_TANH, POLICY_LINEAR };
+    Rng rng(1);
+
+    std::vector<uint8_t> file(PolicyNetwork::MAGIC, PolicyNetwork::MAGIC + 4);
+    auto write_u32 = [&file](uint32_t value) { file.insert(file.end(), (uint8_t*)&value, (uint8_t*)&value + 4); };
+    auto write_f32 = [&file](float value)    { file.insert(file.end(), (uint8_t*)&value, (uint8_t*)&value + 4); };
+    write_u32(PolicyNetwork::VERSION);
+    write_u32(widths[0]);
+    write_u32(3);
+    for (int layer = 0; layer < 3; layer++)
+    {
+        write_u32(widths[layer + 1]);
+        write_u32(activations[layer]);
+        for (int i = 0; i < (widths[layer] + 1) * widths[layer + 1]; i++) write_f32(rng.next_float() - 0.5f);
+    }
+
+    PolicyNetwork network;
+    if (!network.parse(file.data(), file.size())) return;
+
+    // STEP 2: Observations that put every unit somewhere different
+    std::vector<float> observations((size_t)lander_count * LANDER_OBSERVATION_SIZE),
+                       scores((size_t)lander_count * 3);
+    for (float& value : observations) value = 4.0f * rng.next_float() - 2.0f;
+
+    run_benchmark(name, lander_count, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++) network.evaluate(observations.data(), LANDER_OBSERVATION_SIZE, lander_count, scores.data(), 3);
+            g_sink += (unsigned int)(scores[0] > 0.0f);
+        });
+}
+
+// Transitions the learner side can drain per second; with the learner keeping up, this should
+// grow with the worker count until the workers outnumber the free cores. Unpinned, on a machine
+// with more than one NUMA node, it grows more slowly once the workers spill onto the second.
+void bench_rollout(int worker_count, bool pinned)
+{
+    std::string name = "RolloutCollector::drain/" + std::to_string(worker_count) + " workers" + (pinned ? "" : ", unpinned");
+    if (name.find(g_filter) == std::string::npos) return;
+
+    RolloutConfig config;
+    config.worker_count = worker_count;
+    config.pin_workers  = pinned;
+
+    RolloutCollector collector(config, bench_policy);
+    std::vector<Transition> transitions(config.ring_capacity);
+    collector.start();
+
+    run_benchmark(name, 1, [&](long long iterations)
+        {
+            long long drained = 0;
+            while (drained < iterations)
+            {
+                int count = collector.drain(transitions.data(), (int)std::min<long long>(iterations - drained, (long long)transitions.size()));
+                if (count == 0) std::this_thread::yield();
+                drained += count;
+            }
+            g_sink += (unsigned int)transitions[0].action;
+        });
+
+    collector.stop();
+}
+
+// Transitions from `env_count` envs, interleaved as the collector's rings hand them over, every
+// env's episodes `episode_length` steps long
+std::vector<Transition> make_transitions(int count, int env_count, int episode_length)
+{
+    std::vector<Transition> transitions(count);
+    Rng rng(1);
+    for (int i = 0; i < count; i++)
+    {
+        Transition& transition = transitions[i];
+        for (float& value : transition.observation) value = rng.next_float();
+        for (float& value : transition.next_observation) value = rng.next_float();
+        transition.env    = i % env_count;
+        transition.action = rng.next_int(0, 7);
+        transition.reward = rng.next_float();
+        transition.done   = (i / env_count) % episode_length == episode_length - 1 ? LANDER_DONE_TERMINAL : LANDER_DONE_NONE;
+    }
+    return transitions;
+}
+
+// A whole .traj file of `row_count` rows written, index and all, and then read back a column of
+// an episode at a time out of the mapping
+void bench_trajectory_store(int row_count)
+{
+    const char* filepath = "bench_trajectory.traj";
+    std::vector<Transition> transitions = make_transitions(row_count, 64, 200);
+
+    run_benchmark("TrajectoryWriter::append/" + std::to_string(row_count) + " rows", row_count, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                TrajectoryWriter writer;
+                writer.open(filepath);
+                writer.append(transitions.data(), row_count);
+                g_sink += (unsigned int)writer.close();
+            }
+        });
+
+    TrajectoryFile file;
+    if (!file.open(filepath)) return;
+
+    run_benchmark("TrajectoryFile::get_episode/" + std::to_string(row_count) + " rows", file.get_row_count(), [&](long long iterations)
+        {
+            float sum = 0.0f;
+            for (long long i = 0; i < iterations; i++)
+            {
+                for (int e = 0; e < file.get_episode_count(); e++)
+                {
+                    TrajectorySlice episode = file.get_episode(e);
+                    for (int step = 0; step < episode.length; step++) sum += episode.rewards[step] + episode.positions[step].y;
+                }
+            }
+            g_sink += (unsigned int)sum;
+        });
+
+    file.close();
+    std::remove(filepath);
+}
+
+// One client's request and answer through the shared segment, against a single server thread:
+// the per-step overhead a learner in another process pays on top of the steps themselves
+void bench_env_server(int envs_per_client)
+{
+    std::string name = "EnvClient::step/" + std::to_string(envs_per_client) + " envs";
+    if (name.find(g_filter) == std::string::npos) return;
+
+    EnvServerConfig config;
+    config.client_count = 1;
+    config.envs_per_client = envs_per_client;
+
+    EnvServer server;
+    EnvClient client;
+    if (!server.start("/lander_bench_envs", config) || !client.attach("/lander_bench_envs")) return;
+    client.reset(1);
+
+    run_benchmark(name, envs_per_client, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                for (int e = 0; e < envs_per_client; e++) client.get_actions()[e] = bench_policy(client.get_observations() + e * LANDER_OBSERVATION_SIZE, NULL);
+                client.step();
+            }
+            g_sink += (unsigned int)client.get_dones()[0];
+        });
+
+    client.detach();
+    server.stop();
+}
+
+const uint64_t TIMER_BENCH_SPAN = 60 * 60 * 60;  // an hour of 60 Hz steps
+
+void reschedule_timer(void* wheel)
+{
+    g_sink++;
+    ((TimerWheel*)wheel)->schedule(TIMER_BENCH_SPAN, reschedule_timer, wheel);
+}
+
+// With `pending` timers spread over the next hour of steps, each scheduled another hour out as
+// it fires: scheduling and cancelling one more, and a step, which should cost about the same
+// however many are waiting
+void bench_timer_wheel(int pending)
+{
+    TimerWheel wheel;
+    Rng rng(1);
+    for (int i = 0; i < pending; i++) wheel.schedule(1 + rng.next_u64() % TIMER_BENCH_SPAN, reschedule_timer, &wheel);
+
+    run_benchmark("TimerWheel::schedule+cancel/" + std::to_string(pending) + " pending", 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++) wheel.cancel(wheel.schedule(1 + (uint64_t)(i & 0xffff), reschedule_timer, &wheel));
+        });
+
+    run_benchmark("TimerWheel::advance/" + std::to_string(pending) + " pending", 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++) wheel.advance();
+        });
+}
+
+// One platform dragged a little each frame, through the editor's change set, against building the
+// broadphase and colliders again as a level change would
+void bench_level_editor(int platform_count)
+{
+    std::vector<Entity> platforms = make_platform_row(platform_count);
+    PlatformIntervalIndex index;
+    index.build(platforms.data(), platform_count);
+    PlatformColliders colliders;
+    colliders.build(platforms.data(), platform_count);
+
+    LevelEditor editor;
+    std::vector<PlatformMove> moves;
+    std::vector<int> candidates;
+    const int dragged = platform_count / 2;
+    const glm::vec2 start = glm::vec2(platforms[dragged].get_position());
+
+    std::string suffix = std::to_string(platform_count);
+    run_benchmark("LevelEditor::apply/drag/" + suffix, 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                editor.move(dragged, start + glm::vec2(0.05f * (float)(i % 64), 0.5f));
+                editor.apply(platforms.data(), colliders, &index, moves);
+
+                int cursor = -1;
+                index.query(glm::vec2(moves[0].to_min), glm::vec2(moves[0].to_max), candidates, cursor);
+                g_sink += (unsigned int)candidates.size();
+            }
+        });
+
+    run_benchmark("LevelEditor::rebuild/" + suffix, 1, [&](long long iterations)
+        {
+            for (long long i = 0; i < iterations; i++)
+            {
+                index.build(platforms.data(), platform_count);
+                colliders.build(platforms.data(), platform_count);
+                g_sink += (unsigned int)colliders.get_count();
+            }
+        });
+}
+
+int main(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--simd") != 0)
+        {
+            g_filter = argv[i];
+            continue;
+        }
+
+        SimdIsa isa;
+        if (i + 1 >= argc || !parse_simd_isa(argv[++i], isa) || !force_simd_isa(isa))
+        {
+            std::cout << "--simd takes one of scalar, sse2, avx2, avx512 or neon that this CPU runs" << std::endl;
+            return 1;
+        }
+    }
+    SimdIsa bound = get_simd_isa();
+    std::cout << "SIMD kernels: " << get_simd_isa_name(bound) << " (detected " << get_simd_isa_name(get_detected_simd_isa()) << ")" << std::endl;
+
+    bench_check_collision();
+    for (int count : PLATFORM_COUNTS) bench_check_collision_axes(count);
+    for (int count : PLATFORM_COUNTS) bench_update(count);
+    bench_landers(64, true);
+    bench_landers(64, false);
+    bench_terrain(0.25f);
+    bench_terrain(0.01f);
+    bench_distance_field();
+    bench_audio_mix(1);
+    bench_audio_mix(AudioMixer::MAX_VOICES);
+    bench_snapshot_delta(4);
+    bench_snapshot_delta(NET_MAX_LANDERS);
+    bench_rollback(8);
+    bench_rollback(ROLLBACK_WINDOW - 1);
+    for (int threads : { 1, 0 })
+    {
+        if (threads == 0 && std::thread::hardware_concurrency() <= 1) continue;
+        bench_job_system(threads, 64, 0);
+        bench_job_system(threads, 64, 20000);
+    }
+    bench_text_geometry();
+    bench_frame_uv_rect();
+    bench_policy_network(1);
+    bench_policy_network(1000);
+
+    // The learner thread needs a core of its own too
+    int hardware_threads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int workers = 1; workers < hardware_threads || workers == 1; workers *= 2)
+    {
+        bench_rollout(workers, true);
+        bench_rollout(workers, false);
+    }
+
+    bench_env_server(1);
+    bench_env_server(16);
+    bench_trajectory_store(1 << 20);
+    bench_timer_wheel(16);
+    bench_timer_wheel(100000);
+    bench_level_editor(1000000);
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Offline telemetry decoder: turns a log written with --telemetry-log, or a flight recorder dump,
+// into one CSV per record kind, each with a header row.
+//
+//     TelemetryDecoder <input.ltm> <output prefix>
+//
+// writes <prefix>_frame.csv, <prefix>_physics.csv and <prefix>_input.csv. A log cut short by a
+// crash decodes up to its last whole record.
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "TelemetryLog.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: TelemetryDecoder <input.ltm> <output prefix>" << std::endl;
+        return 1;
+    }
+
+    // STEP 1: The header, checked against this build's records
+    FILE* input = std::fopen(argv[1], "rb");
+    if (input == NULL)
+    {
+        std::cout << "Unable to open " << argv[1] << "." << std::endl;
+        return 1;
+    }
+
+    TelemetryFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, input) != 1 || std::memcmp(header.magic, TELEMETRY_MAGIC, sizeof(header.magic)) != 0)
+    {
+        std::cout << argv[1] << " is not a telemetry log." << std::endl;
+        std::fclose(input);
+        return 1;
+    }
+    if (header.version != TELEMETRY_VERSION || header.record_size != sizeof(TelemetryRecord))
+    {
+        std::cout << argv[1] << " is version " << header.version << " with " << header.record_size << "-byte records; this decoder reads version "
+                  << TELEMETRY_VERSION << " with " << sizeof(TelemetryRecord) << "-byte records." << std::endl;
+        std::fclose(input);
+        return 1;
+    }
+
+    // STEP 2: One CSV per kind, its header row from the kind's field names
+    FILE* outputs[TELEMETRY_KIND_COUNT] = {};
+    for (int kind = 0; kind < TELEMETRY_KIND_COUNT; kind++)
+    {
+        std::string filepath = std::string(argv[2]) + "_" + TelemetryLog::get_kind_name((TelemetryKind)kind) + ".csv";
+        outputs[kind] = std::fopen(filepath.c_str(), "w");
+        if (outputs[kind] == NULL)
+        {
+            std::cout << "Unable to write " << filepath << "." << std::endl;
+            for (int i = 0; i < kind; i++) std::fclose(outputs[i]);
+            std::fclose(input);
+            return 1;
+        }
+
+        int field_count = 0;
+        const char* const* fields = TelemetryLog::get_field_names((TelemetryKind)kind, field_count);
+        std::fputs("frame,time", outputs[kind]);
+        for (int i = 0; i < field_count; i++) std::fprintf(outputs[kind], ",%s", fields[i]);
+        std::fputc('\n', outputs[kind]);
+    }
+
+    // STEP 3: The records, a block at a time
+    static TelemetryRecord records[1024];
+    long long counts[TELEMETRY_KIND_COUNT] = {}, skipped = 0;
+    size_t read;
+    while ((read = std::fread(records, sizeof(TelemetryRecord), 1024, input)) > 0)
+    {
+        for (size_t r = 0; r < read; r++)
+        {
+            const TelemetryRecord& record = records[r];
+            if (record.kind >= TELEMETRY_KIND_COUNT)
+            {
+                skipped++;
+                continue;
+            }
+
+            FILE* output = outputs[record.kind];
+            std::fprintf(output, "%u,%.6f", record.frame, record.time);
+            for (int i = 0; i < record.value_count && i < TELEMETRY_VALUES; i++) std::fprintf(output, ",%.9g", record.values[i]);
+            std::fputc('\n', output);
+            counts[record.kind]++;
+        }
+    }
+
+    std::fclose(input);
+    for (int kind = 0; kind < TELEMETRY_KIND_COUNT; kind++)
+    {
+        std::fclose(outputs[kind]);
+        std::cout << TelemetryLog::get_kind_name((TelemetryKind)kind) << ": " << counts[kind] << " records" << std::endl;
+    }
+    if (skipped > 0) std::cout << skipped << " records of unknown kinds skipped" << std::endl;
+    return 0;
+}
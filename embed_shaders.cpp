@@ -0,0 +1,141 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Build step: turns every shaders/*.glsl into a constexpr EmbeddedShader in one generated header,
+// so the game compiles its shaders straight out of the executable's read-only data.
+//
+//     ShaderEmbedder <shader directory> <output header>
+//
+// The header is only rewritten when its contents change, so an untouched shader never triggers
+// a rebuild of everything that includes it.
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// vertex_textured.glsl -> VERTEX_TEXTURED
+static std::string constant_name(const fs::path& filepath)
+{
+    std::string name = filepath.stem().string();
+    for (char& character : name) character = std::isalnum((unsigned char)character) ? (char)std::toupper((unsigned char)character) : '_';
+    if (name.empty() || std::isdigit((unsigned char)name[0])) name.insert(0, "SHADER_");
+    return name;
+}
+
+// One C string literal per source line, so the generated header still reads like the shader
+static std::string string_literal(const std::string& source)
+{
+    std::string literal;
+    bool line_open = false;
+
+    for (char character : source)
+    {
+        if (character == '\r') continue;
+        if (!line_open)
+        {
+            if (!literal.empty()) literal += "\n";
+            literal += "        \"";
+            line_open = true;
+        }
+
+        switch (character)
+        {
+        case '\\': literal += "\\\\"; break;
+        case '"':  literal += "\\\""; break;
+        case '\t': literal += "\\t";  break;
+        case '\n': literal += "\\n\""; line_open = false; break;
+        default:   literal += character;
+        }
+    }
+
+    if (line_open) literal += "\"";
+    if (literal.empty()) literal = "        \"\"";
+    return literal;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cout << "Usage: " << argv[0] << " <shader directory> <output header>" << std::endl;
+        return 1;
+    }
+
+    // STEP 1: Every .glsl in the directory, in a stable order
+    std::error_code error;
+    std::vector<fs::path> shaders;
+    for (const fs::directory_entry& entry : fs::directory_iterator(argv[1], error))
+    {
+        if (entry.is_regular_file() && entry.path().extension() == ".glsl") shaders.push_back(entry.path());
+    }
+
+    if (error || shaders.empty())
+    {
+        std::cout << "No shaders found in " << argv[1] << "." << std::endl;
+        return 1;
+    }
+    std::sort(shaders.begin(), shaders.end());
+
+    // STEP 2: Generate the header in memory
+    std::ostringstream header;
+    header << "#pragma once\n\n"
+           << "// Generated by ShaderEmbedder (embed_shaders.cpp) from shaders/*.glsl. Do not edit by hand;\n"
+           << "// edit the .glsl and rebuild instead.\n"
+           << "#include <string_view>\n\n"
+           << "struct EmbeddedShader\n"
+           << "{\n"
+           << "    std::string_view path;    // where the source lives in the tree, for the filesystem override\n"
+           << "    std::string_view source;\n"
+           << "};\n\n"
+           << "namespace EmbeddedShaders\n"
+           << "{\n";
+
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        std::ifstream file(shaders[i], std::ios::binary);
+        std::stringstream source;
+        source << file.rdbuf();
+
+        if (i > 0) header << "\n";
+        header << "    constexpr EmbeddedShader " << constant_name(shaders[i]) << " =\n"
+               << "    {\n"
+               << "        \"shaders/" << shaders[i].filename().string() << "\",\n"
+               << string_literal(source.str()) << "\n"
+               << "    };\n";
+    }
+
+    header << "}\n";
+
+    // STEP 3: Leave the file alone if nothing changed
+    std::ifstream existing(argv[2], std::ios::binary);
+    std::stringstream previous;
+    previous << existing.rdbuf();
+    if (existing && previous.str() == header.str()) return 0;
+    existing.close();
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    output << header.str();
+    if (!output)
+    {
+        std::cout << "Unable to write " << argv[2] << "." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Embedded " << shaders.size() << " shaders into " << argv[2] << std::endl;
+    return 0;
+}
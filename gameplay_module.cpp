@@ -0,0 +1,31 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// The gameplay module: the core's simulation and scene generation, built again as a shared
+// library the game loads with --gameplay and reloads whenever it's rebuilt (GameplayModule.h).
+//
+//     cmake --build build --target gameplay     # while the game is running
+//
+// Everything in it binds to its own copies (hidden visibility, and -Bsymbolic where the linker
+// has it), so Entity::update and the rest run the rebuilt code rather than the game's.
+#include "GameplayApi.h"
+
+#ifdef _WIN32
+#define GAMEPLAY_EXPORT extern "C" __declspec(dllexport)
+#else
+#define GAMEPLAY_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+GAMEPLAY_EXPORT const GameplayApi* lander_gameplay_api()
+{
+    static const GameplayApi api = make_gameplay_api();
+    return &api;
+}
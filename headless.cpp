@@ -0,0 +1,378 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+// Headless driver: steps the lander as fast as the CPU allows, with no window, no GL and no SDL.
+//
+//     LanderHeadless [episodes] [max_steps_per_episode] [seed] [threads] [platforms] [layout] [integrator]
+//
+// threads defaults to one per hardware thread. Results and the checksum don't depend on it.
+// platforms and layout (classic, uniform, clustered, terrain) size the scene every episode is
+// played in; they default to the classic nine-platform level. integrator is euler (the default,
+// which the checksum has always been taken with), semi-implicit or verlet; the last two step at
+// up to RATE_INTEGRATOR_TIMESTEP, with max_steps_per_episode still counting 60 Hz steps.
+//
+//     LanderHeadless --replay <file> [seek_step]
+//
+// plays back a replay the game recorded (see InputReplay.h), over and over for a second to time
+// it, then reports its outcome and checksum, and the checksum after seeking to seek_step. A replay
+// carrying step hashes is checked against them on the way, and the first step that plays back
+// differently is reported, with exit code 1.
+//
+//     LanderHeadless --record <file> [seed] [platforms] [layout] [max_steps]
+//
+// flies one episode with the controller below and saves it as a replay the game, --replay and
+// the profile-guided build (pgo_build.py) can all play back, step hashes included.
+//
+//     LanderHeadless --serve <port> [clients] [seed] [platforms] [layout]
+//
+// hosts a networked game (see NetSession.h) for up to `clients` players, four by default, in
+// real time until it's killed, with the bandwidth it sends every few seconds.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "InputReplay.h"
+#include "NetSession.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+#include "WorldPool.h"
+
+const int          DEFAULT_EPISODES  = 10000,
+                   DEFAULT_MAX_STEPS = 3600;  // a minute of game time
+const unsigned int DEFAULT_SEED      = 1;
+const int          WORLDS_PER_BATCH  = 4096;  // worlds are reused batch to batch
+
+// Caps a batch's platforms so a big scene runs fewer worlds at once rather than run out of memory
+const long long    MAX_BATCH_PLATFORMS = 1 << 20;
+
+// How far either side of the lander the controller looks for a WIN platform in a broadphased scene
+const float        CONTROL_RANGE = 8.0f;
+
+// The step the rate integrators run at: 30 Hz, half the steps for the same game time
+const float        RATE_INTEGRATOR_TIMESTEP = 2.0f * FIXED_TIMESTEP;
+// ————— CONTROLLER ————— //
+// Stand-in for the controller under tuning: hold the booster while falling too fast,
+// and drift toward the closest WIN platform
+void control(GameState& state, void* /*user_data*/)
+{
+    Entity* player = state.player;
+
+    player->set_movement(glm::vec3(0.0f));
+    player->m_booster_active = player->get_velocity().y < -1.0f;
+    if (player->m_booster_active) return;
+
+    float target_x = player->get_position().x,
+          best_distance = -1.0f;
+
+    // A full scan is fine for nine platforms, but would swamp the step itself in a big scene
+    thread_local std::vector<int> nearby;
+    int cursor = -1,
+        count  = state.platform_count;
+
+    if (state.platform_broadphase != NULL)
+    {
+        glm::vec2 centre = glm::vec2(player->get_position());
+        state.platform_broadphase->query(centre - glm::vec2(CONTROL_RANGE, 100.0f), centre + glm::vec2(CONTROL_RANGE, 100.0f), nearby, cursor);
+        count = (int)nearby.size();
+    }
+
+    for (int n = 0; n < count; n++)
+    {
+        int i = state.platform_broadphase != NULL ? nearby[n] : n;
+        if (state.platforms[i].get_entity_type() != WIN_PLATFORM) continue;
+
+        float distance = fabs(state.platforms[i].get_position().x - player->get_position().x);
+        if (best_distance < 0.0f || distance < best_distance)
+        {
+            best_distance = distance;
+            target_x = state.platforms[i].get_position().x;
+        }
+    }
+
+    if      (target_x < player->get_position().x - 0.1f) player->move_left();
+    else if (target_x > player->get_position().x + 0.1f) player->move_right();
+}
+
+// ————— REPLAY ————— //
+const double REPLAY_BENCH_SECONDS = 1.0;
+
+int run_replay(const char* filepath, int seek_step)
+{
+    InputReplay replay;
+    if (!replay.load(filepath))
+    {
+        std::cout << "Can't read replay " << filepath << std::endl;
+        return 1;
+    }
+
+    ReplayPlayer player(replay);
+    long long total_steps = 0;
+    int plays = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0.0;
+    while (seconds < REPLAY_BENCH_SECONDS)
+    {
+        player.restart();
+        total_steps += player.advance(replay.get_step_count());
+        plays++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const GameState& state = player.get_state();
+    std::cout << get_scene_layout_name(replay.get_scene().layout) << " scene, seed " << replay.get_seed() << ": "
+              << replay.get_step_count() << " steps in " << replay.get_size() << " bytes, "
+              << (state.win ? "landed" : (state.loss ? "crashed" : "undecided")) << " at step " << player.get_step() << std::endl;
+    std::cout << plays << " plays, " << total_steps / seconds << " steps/s" << std::endl;
+    std::cout << "state checksum " << std::hex << checksum_state(state) << std::dec << std::endl;
+
+    int divergent_step = player.get_divergent_step();
+    if (replay.get_step_hash_count() == 0) std::cout << "no step hashes to check against" << std::endl;
+    else if (divergent_step < 0)           std::cout << "all " << replay.get_step_hash_count() << " step hashes match" << std::endl;
+    else                                   std::cout << "diverges from the recording at step " << divergent_step << std::endl;
+
+    if (seek_step >= 0)
+    {
+        player.seek(seek_step);
+        std::cout << "at step " << player.get_step() << ": state checksum " << std::hex << checksum_state(player.get_state()) << std::dec << std::endl;
+    }
+
+    return divergent_step < 0 ? 0 : 1;
+}
+
+int run_record(int argc, char* argv[])
+{
+    SceneConfig scene;
+    unsigned int seed = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : DEFAULT_SEED;
+    if (argc > 4) scene.platform_count = std::max(1, atoi(argv[4]));
+    if (argc > 5 && !parse_scene_layout(argv[5], scene.layout))
+    {
+        std::cout << "Unknown layout " << argv[5] << "; expected classic, uniform, clustered or terrain" << std::endl;
+        return 1;
+    }
+    int max_steps = argc > 6 ? atoi(argv[6]) : DEFAULT_MAX_STEPS;
+
+    // STEP 1: The level as ReplayPlayer will build it again
+    World world(scene.platform_count);
+    GameState& state = world.state;
+    setup_player(&world.player);
+    generate_scene(state.platforms, scene, seed);
+    state.platform_colliders->build(state.platforms, state.platform_count);
+    world.broadphase.build(state.platforms, state.platform_count);
+    state.platform_broadphase = &world.broadphase;
+    state.hash_steps = true;
+    reset_episode(state);
+
+    // STEP 2: Flown, and recorded as the game records it: the hash before each step, then its keys
+    InputReplay replay;
+    replay.begin(scene, seed, state.fixed_timestep);
+    for (int step = 0; step < max_steps && !state.win && !state.loss; step++)
+    {
+        control(state, NULL);
+        replay.record_step_hash(state.step_hash);
+        replay.record(get_replay_action(*state.player), 1);
+        step_simulation(state, state.fixed_timestep);
+    }
+    replay.record_step_hash(state.step_hash);
+
+    if (!replay.save(argv[2]))
+    {
+        std::cout << "Can't write replay " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << get_scene_layout_name(scene.layout) << " scene, seed " << seed << ": " << replay.get_step_count() << " steps, "
+              << (state.win ? "landed" : (state.loss ? "crashed" : "undecided")) << ", saved to " << argv[2] << std::endl;
+    return 0;
+}
+
+// ————— SERVER ————— //
+const double SERVE_REPORT_SECONDS = 5.0;
+
+int run_server(int argc, char* argv[])
+{
+    NetServerConfig config;
+    config.port = (uint16_t)atoi(argv[2]);
+    if (argc > 3) config.max_clients = atoi(argv[3]);
+    if (argc > 4) config.seed = (unsigned int)strtoul(argv[4], NULL, 10);
+    if (argc > 5) config.scene.platform_count = std::max(1, atoi(argv[5]));
+    if (argc > 6 && !parse_scene_layout(argv[6], config.scene.layout))
+    {
+        std::cout << "Unknown layout " << argv[6] << "; expected classic, uniform, clustered or terrain" << std::endl;
+        return 1;
+    }
+
+    NetServer server;
+    if (!server.start(config))
+    {
+        std::cout << "Can't listen on port " << config.port << std::endl;
+        return 1;
+    }
+    std::cout << "Serving " << get_scene_layout_name(config.scene.layout) << " scene, seed " << config.seed << ", on port " << config.port << std::endl;
+
+    // Steps on whole nanoseconds, like advance_simulation, so the server never drifts off real time
+    const int64_t step_ticks = seconds_to_ticks(config.fixed_timestep);
+    auto start = std::chrono::steady_clock::now();
+    long long steps = 0, reported_bytes = 0, reported_snapshots = 0;
+    double next_report = SERVE_REPORT_SECONDS;
+
+    while (true)
+    {
+        int64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        double  seconds = (double)elapsed / TICKS_PER_SECOND;
+
+        server.receive(seconds);
+        while (steps < elapsed / step_ticks)
+        {
+            server.step();
+            steps++;
+        }
+
+        if (seconds >= next_report)
+        {
+            int clients = server.get_client_count();
+            long long bytes = server.get_bytes_sent() - reported_bytes,
+                      snapshots = server.get_snapshots_sent() - reported_snapshots;
+            std::cout << clients << " clients, " << snapshots / SERVE_REPORT_SECONDS << " snapshots/s, "
+                      << (clients > 0 ? bytes / SERVE_REPORT_SECONDS / clients : 0.0) << " bytes/s per client" << std::endl;
+
+            reported_bytes = server.get_bytes_sent();
+            reported_snapshots = server.get_snapshots_sent();
+            next_report += SERVE_REPORT_SECONDS;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// ————— DRIVER ————— //
+int main(int argc, char* argv[])
+{
+    if (argc > 2 && std::string_view(argv[1]) == "--replay") return run_replay(argv[2], argc > 3 ? atoi(argv[3]) : -1);
+    if (argc > 2 && std::string_view(argv[1]) == "--record") return run_record(argc, argv);
+    if (argc > 2 && std::string_view(argv[1]) == "--serve")  return run_server(argc, argv);
+
+    int          episodes  = argc > 1 ? atoi(argv[1]) : DEFAULT_EPISODES,
+                 max_steps = argc > 2 ? atoi(argv[2]) : DEFAULT_MAX_STEPS;
+    unsigned int seed      = argc > 3 ? (unsigned int)strtoul(argv[3], NULL, 10) : DEFAULT_SEED;
+
+    int          threads   = argc > 4 ? atoi(argv[4]) : 0;
+
+    SceneConfig scene;
+    if (argc > 5) scene.platform_count = std::max(1, atoi(argv[5]));
+    if (argc > 6 && !parse_scene_layout(argv[6], scene.layout))
+    {
+        std::cout << "Unknown layout " << argv[6] << "; expected classic, uniform, clustered or terrain" << std::endl;
+        return 1;
+    }
+
+    Integrator integrator = EXPLICIT_EULER;
+    if (argc > 7 && !parse_integrator(argv[7], integrator))
+    {
+        std::cout << "Unknown integrator " << argv[7] << "; expected euler, semi-implicit or verlet" << std::endl;
+        return 1;
+    }
+
+    // The same game time per episode, in however many steps that takes at the integrator's step
+    float timestep = get_stable_timestep(integrator, RATE_INTEGRATOR_TIMESTEP);
+    max_steps = std::max((int)std::lround(max_steps * FIXED_TIMESTEP / timestep), 1);
+
+    // The classic level is what the checksum has always been taken over, so it keeps the plain scan
+    bool use_broadphase = scene.layout != SCENE_CLASSIC || scene.platform_count > PLATFORM_COUNT;
+
+    WorldPool pool(threads);
+
+    // One set of worlds is built up front and reset for every batch
+    int batch_size = (int)std::min((long long)std::min(episodes, WORLDS_PER_BATCH),
+                                   std::max(1LL, MAX_BATCH_PLATFORMS / scene.platform_count));
+    std::vector<std::unique_ptr<World>> worlds;
+    std::vector<GameState*> states;
+
+    for (int i = 0; i < batch_size; i++)
+    {
+        worlds.emplace_back(new World(scene.platform_count));
+        setup_player(&worlds[i]->player);
+        states.push_back(&worlds[i]->state);
+    }
+
+    long long total_steps = 0;
+    uint32_t checksum = 2166136261u;
+    int wins = 0,
+        losses = 0,
+        timeouts = 0;
+
+    // Building a big scene can cost more than playing it, so that time is kept out of steps/s
+    double scene_seconds = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int first = 0; first < episodes; first += batch_size)
+    {
+        int count = std::min(batch_size, episodes - first);
+        auto scene_start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < count; i++)
+        {
+            GameState& state = *states[i];
+            generate_scene(state.platforms, scene, seed + first + i);
+            state.platform_colliders->build(state.platforms, state.platform_count);
+
+            if (use_broadphase)
+            {
+                worlds[i]->broadphase.build(state.platforms, state.platform_count);
+                state.platform_broadphase = &worlds[i]->broadphase;
+            }
+            reset_episode(state);
+            set_integrator(state, integrator, RATE_INTEGRATOR_TIMESTEP);
+            state.budget.total_steps = 0;
+        }
+
+        scene_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - scene_start).count();
+        pool.run(states.data(), count, max_steps, control);
+
+        // Tallied in episode order, so the checksum is the same for any thread count
+        for (int i = 0; i < count; i++)
+        {
+            GameState& state = *states[i];
+
+            total_steps += state.budget.total_steps;
+            checksum = checksum_state(state, checksum);
+            if      (state.win)  wins++;
+            else if (state.loss) losses++;
+            else                 timeouts++;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - scene_seconds;
+
+    std::cout << scene.platform_count << " platforms (" << get_scene_layout_name(scene.layout) << "), "
+              << get_integrator_name(integrator) << " at " << 1.0f / timestep << " Hz, "
+              << episodes << " episodes: " << wins << " landed, " << losses << " crashed, "
+              << timeouts << " timed out" << std::endl;
+    std::cout << total_steps << " steps in " << seconds << " s ("
+              << (seconds > 0.0 ? total_steps / seconds : 0.0) << " steps/s) on " << pool.get_thread_count()
+              << " threads, " << pool.get_steal_count() << " steals" << std::endl;
+    if (use_broadphase) std::cout << scene_seconds << " s building scenes" << std::endl;
+
+    // Compare across machines to verify a replay; only expected to agree in LANDER_FIXED_POINT builds
+    std::cout << "state checksum " << std::hex << checksum << std::dec
+#ifdef LANDER_FIXED_POINT
+              << " (fixed point)"
+#else
+              << " (float)"
+#endif
+              << std::endl;
+
+    return 0;
+}
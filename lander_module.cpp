@@ -0,0 +1,340 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Python extension over BatchedLanderEnv. Build it with `python setup.py build_ext --inplace`.
+//
+//     import numpy as np, lander
+//     env = lander.VectorEnv(4096, seed=1, max_steps=3600)
+//     observations, rewards, dones = env.observations, env.rewards, env.dones
+//     actions = env.actions                     # int32[N], LanderAction bits
+//     for _ in range(steps):
+//         actions[:] = policy(observations)
+//         env.step()                            # all N envs in C++, without the GIL
+//         env.step(repeat=4)                    # or several fixed steps per decision
+//
+// observations (float32[N, 6]), rewards (float32[N]), dones (int32[N]) and actions are NumPy
+// views straight onto the env's own buffers: step() rewrites them in place and allocates
+// nothing, so they only need fetching once. step() also takes any C-contiguous int32 buffer.
+//
+// Rewards are sparse (+1 landed, -1 crashed) unless touchdown_weight, fuel_weight or
+// distance_weight shape them; see RewardConfig in BatchedLanderSim.h.
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include <cstring>
+#include <memory>
+#include "BatchedLanderEnv.h"
+
+// ————— BUFFER VIEW ————— //
+// Exports one of the env's arrays through the buffer protocol. It shares ownership of the C++
+// env rather than referencing the Python one, so the memory outlives every NumPy array wrapped
+// around it without the VectorEnv ending up in a reference cycle with its own arrays.
+typedef std::shared_ptr<BatchedLanderEnv> EnvHandle;
+
+struct BufferView
+{
+    PyObject_HEAD
+    EnvHandle*  owner;
+    void*      data;
+    const char* format;
+    Py_ssize_t itemsize;
+    int        ndim;
+    Py_ssize_t shape[2],
+               strides[2];
+    bool       readonly;
+};
+
+static int buffer_view_getbuffer(PyObject* object, Py_buffer* view, int flags)
+{
+    BufferView* self = (BufferView*)object;
+    if (self->readonly && (flags & PyBUF_WRITABLE))
+    {
+        PyErr_SetString(PyExc_BufferError, "this array is read-only; it is rewritten by step()");
+        view->obj = NULL;
+        return -1;
+    }
+
+    view->buf = self->data;
+    view->obj = object;
+    Py_INCREF(object);
+    view->len = self->itemsize;
+    for (int i = 0; i < self->ndim; i++) view->len *= self->shape[i];
+    view->readonly = self->readonly ? 1 : 0;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? (char*)self->format : NULL;
+    view->ndim = self->ndim;
+    view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static void buffer_view_dealloc(PyObject* object)
+{
+    delete ((BufferView*)object)->owner;
+    Py_TYPE(object)->tp_free(object);
+}
+
+static PyBufferProcs BUFFER_VIEW_PROCS = { buffer_view_getbuffer, NULL };
+
+static PyTypeObject BufferViewType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+// ————— VECTOR ENV ————— //
+struct VectorEnv
+{
+    PyObject_HEAD
+    EnvHandle* env;
+    PyObject*  observations;  // NumPy arrays over the buffers above, made once
+    PyObject*  rewards;
+    PyObject*  dones;
+    PyObject*  actions;
+};
+
+static PyObject* wrap_buffer(PyObject* numpy, const EnvHandle& owner, void* data, const char* format, Py_ssize_t itemsize,
+                             Py_ssize_t rows, Py_ssize_t columns, bool readonly)
+{
+    BufferView* view = PyObject_New(BufferView, &BufferViewType);
+    if (view == NULL) return NULL;
+
+    view->owner    = new EnvHandle(owner);
+    view->data     = data;
+    view->format   = format;
+    view->itemsize = itemsize;
+    view->ndim     = columns > 0 ? 2 : 1;
+    view->shape[0] = rows;
+    view->shape[1] = columns;
+    view->strides[0] = columns > 0 ? columns * itemsize : itemsize;
+    view->strides[1] = itemsize;
+    view->readonly = readonly;
+
+    PyObject* array = PyObject_CallMethod(numpy, "asarray", "O", (PyObject*)view);
+    Py_DECREF(view);
+    return array;
+}
+
+static void vector_env_release(VectorEnv* self)
+{
+    Py_CLEAR(self->observations);
+    Py_CLEAR(self->rewards);
+    Py_CLEAR(self->dones);
+    Py_CLEAR(self->actions);
+
+    delete self->env;
+    self->env = NULL;
+}
+
+// Methods called on an env whose __init__ never ran (or failed) raise instead of crashing
+static bool check_initialised(VectorEnv* self)
+{
+    if (self->env != NULL && self->observations != NULL) return true;
+
+    PyErr_SetString(PyExc_RuntimeError, "VectorEnv is not initialised");
+    return false;
+}
+
+static int vector_env_init(PyObject* object, PyObject* args, PyObject* kwargs)
+{
+    static const char* KEYWORDS[] = { "num_envs", "seed", "max_steps", "platforms", "layout",
+                                      "touchdown_weight", "fuel_weight", "distance_weight", NULL };
+
+    VectorEnv* self = (VectorEnv*)object;
+    int          env_count;
+    unsigned int seed      = 0;
+    int          max_steps = 3600,
+                 platforms = PLATFORM_COUNT;
+    const char*  layout    = "classic";
+    RewardConfig rewards;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|Iiisfff", (char**)KEYWORDS, &env_count, &seed, &max_steps, &platforms, &layout,
+                                     &rewards.touchdown_speed_weight, &rewards.fuel_weight, &rewards.distance_weight)) return -1;
+
+    SceneConfig scene;
+    scene.platform_count = platforms;
+    if (env_count <= 0 || platforms <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "num_envs and platforms must be positive");
+        return -1;
+    }
+    if (!parse_scene_layout(layout, scene.layout))
+    {
+        PyErr_Format(PyExc_ValueError, "unknown layout '%s'; expected classic, uniform, clustered or terrain", layout);
+        return -1;
+    }
+
+    PyObject* numpy = PyImport_ImportModule("numpy");
+    if (numpy == NULL) return -1;
+
+    // Re-running __init__ leaves arrays fetched before it pointing at the old env, which stays alive for them
+    EnvHandle env = std::make_shared<BatchedLanderEnv>();
+    env->initialise(env_count, scene, max_steps);
+    env->set_reward_config(rewards);
+    env->reset(seed);
+
+    vector_env_release(self);
+    self->env = new EnvHandle(env);
+
+    self->observations = wrap_buffer(numpy, env, env->get_observations(), "f", sizeof(float), env_count, BatchedLanderEnv::OBSERVATION_SIZE, true);
+    self->rewards      = wrap_buffer(numpy, env, env->get_rewards(),      "f", sizeof(float), env_count, 0, true);
+    self->dones        = wrap_buffer(numpy, env, env->get_dones(),        "i", sizeof(int),   env_count, 0, true);
+    self->actions      = wrap_buffer(numpy, env, env->get_actions(),      "i", sizeof(int),   env_count, 0, false);
+    Py_DECREF(numpy);
+
+    if (self->observations == NULL || self->rewards == NULL || self->dones == NULL || self->actions == NULL)
+    {
+        vector_env_release(self);
+        return -1;
+    }
+    return 0;
+}
+
+static void vector_env_dealloc(PyObject* object)
+{
+    vector_env_release((VectorEnv*)object);
+    Py_TYPE(object)->tp_free(object);
+}
+
+static bool is_int32_format(const char* format)
+{
+    if (format == NULL) return false;  // plain unsigned bytes
+    if (*format == '@' || *format == '=' || *format == '<') format++;
+    return (std::strcmp(format, "i") == 0 || (sizeof(long) == 4 && std::strcmp(format, "l") == 0));
+}
+
+static PyObject* vector_env_step(PyObject* object, PyObject* args, PyObject* kwargs)
+{
+    static const char* KEYWORDS[] = { "actions", "repeat", NULL };
+
+    VectorEnv* self = (VectorEnv*)object;
+    PyObject* actions = Py_None;
+    int repeat = 1;
+    if (!check_initialised(self) || !PyArg_ParseTupleAndKeywords(args, kwargs, "|Oi", (char**)KEYWORDS, &actions, &repeat)) return NULL;
+
+    BatchedLanderEnv* env = self->env->get();
+
+    Py_buffer buffer;
+    bool has_buffer = actions != Py_None;
+
+    if (has_buffer)
+    {
+        if (PyObject_GetBuffer(actions, &buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) return NULL;
+
+        if (buffer.itemsize != sizeof(int) || !is_int32_format(buffer.format) || buffer.len != env->get_env_count() * (Py_ssize_t)sizeof(int))
+        {
+            PyBuffer_Release(&buffer);
+            PyErr_Format(PyExc_ValueError, "actions must be a contiguous int32 array of length %d", env->get_env_count());
+            return NULL;
+        }
+    }
+
+    // The buffers only ever change here, and nothing in the step touches a Python object
+    const int* action_data = has_buffer ? (const int*)buffer.buf : NULL;
+    Py_BEGIN_ALLOW_THREADS
+    env->step_batch(action_data, repeat);
+    Py_END_ALLOW_THREADS
+
+    if (has_buffer) PyBuffer_Release(&buffer);
+    return PyTuple_Pack(3, self->observations, self->rewards, self->dones);
+}
+
+static PyObject* vector_env_reset(PyObject* object, PyObject* args)
+{
+    VectorEnv* self = (VectorEnv*)object;
+    unsigned int seed = 0;
+    if (!check_initialised(self) || !PyArg_ParseTuple(args, "|I", &seed)) return NULL;
+
+    (*self->env)->reset(seed);
+    Py_INCREF(self->observations);
+    return self->observations;
+}
+
+static PyObject* get_array(VectorEnv* self, PyObject* array)
+{
+    if (!check_initialised(self)) return NULL;
+
+    Py_INCREF(array);
+    return array;
+}
+
+static PyObject* get_observations(PyObject* object, void*) { return get_array((VectorEnv*)object, ((VectorEnv*)object)->observations); }
+static PyObject* get_rewards(PyObject* object, void*)      { return get_array((VectorEnv*)object, ((VectorEnv*)object)->rewards); }
+static PyObject* get_dones(PyObject* object, void*)        { return get_array((VectorEnv*)object, ((VectorEnv*)object)->dones); }
+static PyObject* get_actions(PyObject* object, void*)      { return get_array((VectorEnv*)object, ((VectorEnv*)object)->actions); }
+
+static PyObject* get_num_envs(PyObject* object, void*)
+{
+    VectorEnv* self = (VectorEnv*)object;
+    if (!check_initialised(self)) return NULL;
+
+    return PyLong_FromLong((*self->env)->get_env_count());
+}
+
+static PyMethodDef VECTOR_ENV_METHODS[] =
+{
+    { "step",  (PyCFunction)(void(*)(void))vector_env_step, METH_VARARGS | METH_KEYWORDS,
+      "step(actions=None, repeat=1) -> (observations, rewards, dones); advances every env by `repeat` fixed steps under the same actions, summing the rewards" },
+    { "reset", vector_env_reset, METH_VARARGS, "reset(seed=0) -> observations; builds the scene for seed and respawns every env" },
+    { NULL, NULL, 0, NULL }
+};
+
+static PyGetSetDef VECTOR_ENV_GETSETS[] =
+{
+    { "observations", get_observations, NULL, "float32[N, 6]: position, velocity and offset to the nearest WIN platform", NULL },
+    { "rewards",      get_rewards,      NULL, "float32[N]: +1 landed, -1 crashed, 0 otherwise", NULL },
+    { "dones",        get_dones,        NULL, "int32[N]: 0 flying, 1 landed or crashed, 2 truncated", NULL },
+    { "actions",      get_actions,      NULL, "int32[N], writable: LEFT | RIGHT | BOOST bits used by step() with no argument", NULL },
+    { "num_envs",     get_num_envs,     NULL, "number of envs", NULL },
+    { NULL, NULL, NULL, NULL, NULL }
+};
+
+static PyTypeObject VectorEnvType = { PyVarObject_HEAD_INIT(NULL, 0) };
+
+// ————— MODULE ————— //
+static PyModuleDef LANDER_MODULE = { PyModuleDef_HEAD_INIT, "lander", "Vectorised lunar lander environments", -1, NULL };
+
+PyMODINIT_FUNC PyInit_lander(void)
+{
+    BufferViewType.tp_name      = "lander._BufferView";
+    BufferViewType.tp_basicsize = sizeof(BufferView);
+    BufferViewType.tp_flags     = Py_TPFLAGS_DEFAULT;
+    BufferViewType.tp_dealloc   = buffer_view_dealloc;
+    BufferViewType.tp_as_buffer = &BUFFER_VIEW_PROCS;
+
+    VectorEnvType.tp_name      = "lander.VectorEnv";
+    VectorEnvType.tp_doc       = "VectorEnv(num_envs, seed=0, max_steps=3600, platforms=9, layout='classic', touchdown_weight=0, fuel_weight=0, distance_weight=0)";
+    VectorEnvType.tp_basicsize = sizeof(VectorEnv);
+    VectorEnvType.tp_flags     = Py_TPFLAGS_DEFAULT;
+    VectorEnvType.tp_new       = PyType_GenericNew;
+    VectorEnvType.tp_init      = vector_env_init;
+    VectorEnvType.tp_dealloc   = vector_env_dealloc;
+    VectorEnvType.tp_methods   = VECTOR_ENV_METHODS;
+    VectorEnvType.tp_getset    = VECTOR_ENV_GETSETS;
+
+    if (PyType_Ready(&BufferViewType) < 0 || PyType_Ready(&VectorEnvType) < 0) return NULL;
+
+    PyObject* module = PyModule_Create(&LANDER_MODULE);
+    if (module == NULL) return NULL;
+
+    Py_INCREF(&VectorEnvType);
+    if (PyModule_AddObject(module, "VectorEnv", (PyObject*)&VectorEnvType) < 0)
+    {
+        Py_DECREF(&VectorEnvType);
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(module, "ACTION_LEFT",  LANDER_ACTION_LEFT);
+    PyModule_AddIntConstant(module, "ACTION_RIGHT", LANDER_ACTION_RIGHT);
+    PyModule_AddIntConstant(module, "ACTION_BOOST", LANDER_ACTION_BOOST);
+    PyModule_AddIntConstant(module, "DONE_NONE",      LANDER_DONE_NONE);
+    PyModule_AddIntConstant(module, "DONE_TERMINAL",  LANDER_DONE_TERMINAL);
+    PyModule_AddIntConstant(module, "DONE_TRUNCATED", LANDER_DONE_TRUNCATED);
+    return module;
+}
@@ -10,34 +10,123 @@
 
 #define LOG(argument) std::cout << argument << '\n'
 #define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_FAILURE_STRINGS  // the failure reason is one unguarded global, and AsyncTextureLoader decodes on several threads
+#define STBI_MALLOC(size)           counted_malloc(size)  // decoded images are charged to a MemoryTag, as new's blocks are
+#define STBI_REALLOC(memory, size)  counted_realloc(memory, size)
+#define STBI_FREE(memory)           counted_free(memory)
 #define GL_SILENCE_DEPRECATION
 #define GL_GLEXT_PROTOTYPES 1
-#define FIXED_TIMESTEP 0.0166666f
-#define ACC_OF_GRAVITY -1.62f
-#define PLATFORM_COUNT 9
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
 #endif
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
 
 #include <SDL.h>
 #include <SDL_opengl.h>
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
+#include "ShaderVariants.h"
+#include "AllocationCounter.h"
 #include "stb_image.h"
 #include "cmath"
+#include <climits>
 #include <ctime>
+#include <future>
 #include <vector>
 #include <random>
+#include "SpriteBatch.h"
+#include "InstancedRenderer.h"
+#include "InstanceMaterials.h"
+#include "TextureAtlas.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+#include "TextMeshCache.h"
+#include "TelemetryHud.h"
+#include "InstancedText.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include "FramePacer.h"
+#include "FrameLatency.h"
+#include "FrameClock.h"
+#include "FlowSequencer.h"
+#include "FrameCapture.h"
+#include "SpectatorView.h"
+#include "AudioMixer.h"
+#include "SoundSynth.h"
 #include "Entity.h"
-
-//  STRUCTS AND ENUMS //
-struct GameState
-{
-    Entity* player;
-    Entity* platforms;
-};
+#include "Simulation.h"
+#include "GameEvents.h"
+#include "SceneGenerator.h"
+#include "DifficultyEstimator.h"
+#include "SceneGraph.h"
+#include "LevelStreamer.h"
+#include "LevelFile.h"
+#include "Camera.h"
+#include "Tilemap.h"
+#include "StaticPlatformMesh.h"
+#include "TrajectoryOverlay.h"
+#include "Starfield.h"
+#include "DistanceField.h"
+#include "SimulationThread.h"
+#include "JobSystem.h"
+#include "InputDevices.h"
+#include "InputTimeline.h"
+#include "Rng.h"
+#include "PlatformIntervalIndex.h"
+#include "LevelArena.h"
+#include "LevelEditor.h"
+#include "ParticleSystem.h"
+#include "GpuParticleSystem.h"
+#include "GpuLanderSim.h"
+#include "BatchedLanderSim.h"
+#include "SpriteSheet.h"
+#include "AnimationLibrary.h"
+#include "AssetManifest.h"
+#include "AssetPack.h"
+#include "AsyncTextureLoader.h"
+#include "GameplayModule.h"
+#include "StartupProfiler.h"
+#include "LoadingSequence.h"
+#include "FrameProfiler.h"
+#include "GpuProfiler.h"
+#include "FrameCounters.h"
+#include "PhysicsCounters.h"
+#include "OffscreenTarget.h"
+#include "Minimap.h"
+#include "PipelineWarmup.h"
+#include "PostProcess.h"
+#include "DynamicResolution.h"
+#include "QualityGovernor.h"
+#include "MemoryAccounting.h"
+#include "ObservationRenderer.h"
+#include "WorldPool.h"
+#include "Autopilot.h"
+#include "InputReplay.h"
+#include "LandingSiteMap.h"
+#include "RewindBuffer.h"
+#include "GhostFleet.h"
+#include "PolicyFleet.h"
+#include "TelemetryLog.h"
+#include "TerrainEditor.h"
+#include "LightingPass.h"
+#include "TuningConfig.h"
+#include "FlightRecorder.h"
+#include "LeaderboardClient.h"
+#include "SaveStore.h"
+#include "NetSession.h"
+#include "RollbackSession.h"
+#include "GLCapabilities.h"
+#include "TextureArray.h"
+#include "Trace.h"
+#include "DebugDraw.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
 
 //  CONSTANTS  //
 const int WINDOW_WIDTH = 640,
@@ -49,336 +138,3775 @@ BG_GREEN = 0.0980f,
 BG_OPACITY = 1.0f;
 
 const int VIEWPORT_X = 0,
-VIEWPORT_Y = 0,
-VIEWPORT_WIDTH = WINDOW_WIDTH,
-VIEWPORT_HEIGHT = WINDOW_HEIGHT;
+VIEWPORT_Y = 0;
 
-const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+const float VIEW_HALF_HEIGHT = 3.75f;  // world units; the width follows the window's shape, 5 either side at 4:3
 
 const float MILLISECONDS_IN_SECOND = 1000.0;
-const char  SPRITESHEET_FILEPATH[] = "assets/ship.png",
-            DEATH_PLATFORM_FILEPATH[] = "assets/rock.png",
-            WIN_PLATFORM_FILEPATH[] = "assets/stone.png",
-            FONT_SPRITE_FILEPATH[] = "assets/font1.png";
 
-GLuint g_text_texture_id;
+const int       TARGET_FPS = 60;  // 0 leaves pacing to vsync alone
+const VsyncMode VSYNC_MODE = VSYNC_ADAPTIVE;  // unless --vsync says otherwise
+const float     SIMULATION_TIMESTEP = FIXED_TIMESTEP;  // 1.0f / 30.0f on low-end machines, or set one with --tuning
+const float     REWIND_SECONDS         = 10.0f;  // how far back --rewind can go
+const int       REWIND_STEPS_PER_FRAME = 2;      // so holding it runs time back at twice the speed
+const float     DEFAULT_HITCH_MS = 100.0f;       // a frame this long has the flight recorder dump
+const int       DEFAULT_AI_LANDERS = 32;         // flown by --policy unless --ai-landers says otherwise
+const float     DEFAULT_MIN_WIN_CHANCE = 0.25f;  // of the reference pilot landing, for a generated level to be kept
+const double    LEVEL_CHECK_SECONDS    = 0.05;   // of re-rolling one level load can spend
+const AssetId SPRITESHEET_ASSET    = ASSET_SHIP,
+              DEATH_PLATFORM_ASSET = ASSET_ROCK,
+              WIN_PLATFORM_ASSET   = ASSET_STONE,
+              PLATFORM_BASE_ASSET  = ASSET_PLATFORM,  // rock.png in grey, for InstanceMaterials
+              FONT_SPRITE_ASSET    = ASSET_FONT_SDF;  // built from font1.png by make_sdf_font.cpp
+const char  FONT_METRICS_FILEPATH[] = "assets/font_sdf.fnt",  // the packed sheet's glyph metrics; without it, the 16x16 grid
+            GLYPH_FONT_FILEPATH[] = "assets/unifont.hex",  // characters past ASCII (GNU Unifont's format); without it, boxes
+            ASSET_PACK_FILEPATH[] = "assets/assets.pak",  // pre-decoded copies of AssetManifest.h's images, see pack_assets.cpp
+            STARTUP_REPORT_FILEPATH[] = "startup_report.json",
+            TRACE_FILEPATH[] = "lander_trace.json",  // only written in LANDER_TRACE builds
+            FRAME_TIMES_FILEPATH[] = "frame_times.json",
+            FRAME_COUNTERS_FILEPATH[] = "frame_counters.json",
+            MEMORY_REPORT_FILEPATH[] = "memory_report.json",
+            CAPTURE_DIRECTORY[] = "captures",  // F12's screenshots and F10's recordings
+            FLIGHT_CRASH_FILEPATH[] = "flight_crash.ltm",  // the flight recorder's dumps, for TelemetryDecoder
+            FLIGHT_HITCH_FILEPATH[] = "flight_hitch.ltm",
+            LEADERBOARD_SPOOL_FILEPATH[] = "leaderboard_spool.bin",  // landings not yet accepted by --leaderboard
+            SAVE_FILEPATH[] = "lander_save.dat",  // settings and progress, see SaveStore.h
+            REPLAY_FILEPATH[] = "last_attempt.lrp",  // every landing or crash, for LanderHeadless --replay
+            THRUST_SOUND_FILEPATH[] = "assets/thrust.wav",  // the sounds are all optional, and synthesized without
+            THUD_SOUND_FILEPATH[] = "assets/thud.wav",
+            CHIME_SOUND_FILEPATH[] = "assets/chime.wav",
+            CRASH_SOUND_FILEPATH[] = "assets/crash.wav";
+
+const size_t FRAME_ARENA_SIZE = 1024 * 1024;  // grows on its own the first time a frame needs more
+const float  TEXTURE_UPLOAD_BUDGET = 0.002f;  // seconds per frame spent uploading finished decodes
+const float  TEXTURE_RELOAD_BUDGET = 0.001f;  // seconds per frame bringing evicted textures back
+const float  STREAM_BUDGET_KB = 256.0f;       // mip levels TextureStreamer uploads per frame
+const int    ATLAS_PADDING = 4;               // room for two mip levels before sprites bleed
+const float  TEXELS_PER_UNIT = 16.0f;         // rock.png and stone.png cover one world unit
+const float  LOADING_STEP_BUDGET = 0.012f;    // seconds of main-thread loading per splash frame
+const int    PREFETCH_UPLOAD_BUDGET = 16384;  // instances of the next level uploaded per frame, 512 KB
+const int    INPUT_AUTOPILOT = 1 << 24;       // above the action record's bits: the autopilot has the controls
+const float  FIELD_CELL_SIZE = 0.0625f;       // --sdf: a sixteenth of a unit, so the ground is within 0.03 of true
+const float  FIELD_MARGIN    = 1.0f;          // --sdf: room around the ground's lowest and highest points
+const float  CRATER_RADIUS   = 1.5f;          // --craters: dug around where the lander came down
+const float  CRATER_REBAKE_BUDGET = 0.0005f;  // --craters: seconds per frame taking in rebaked field chunks
+const double IDLE_REDRAW_SECONDS = 0.5;       // how long an idle frame waits for input before drawing again anyway
+const double RETRY_HINT_DELAY = 1.5;          // seconds the result is on screen before the keys to go again
+const int    FUEL_HINT_STEPS  = 180;          // simulation steps the out-of-fuel warning stays up, if nothing else takes its place
+const double NET_CONNECT_TIMEOUT = 3.0;       // seconds --connect waits for the server before playing alone
+const double VERSUS_CONNECT_TIMEOUT = 30.0;   // seconds --versus waits for the other player to start theirs
+const int    AUDIO_SAMPLE_RATE   = 48000;     // asked for; the device may pick another
+const int    AUDIO_BUFFER_FRAMES = 512;       // about 11 ms a callback at 48 kHz
+const float  THRUST_GAIN = 0.6f;
+const float  SCRAPE_SOUND_SPEED = 0.5f;       // units a second sideways into a wall before it thuds
+
+// What the window is on the display. Both fullscreen modes are at the display's own resolution,
+// so nothing is scaled; exclusive takes the display over, so no compositor sits between the swap
+// and the screen, while borderless leaves that to the window system (most skip compositing a
+// window that covers the display).
+enum DisplayMode
+{
+    DISPLAY_WINDOWED,
+    DISPLAY_BORDERLESS,
+    DISPLAY_EXCLUSIVE
+};
+
+// The mixer's voice slots: one sound at a time in each
+enum AudioVoice
+{
+    THRUST_VOICE,
+    IMPACT_VOICE,
+    RESULT_VOICE
+};
+
+// What the game flow scripts wait on, as FlowSequencer event bits
+enum FlowEvent
+{
+    FLOW_LEVEL_WON  = 1,
+    FLOW_LEVEL_LOST = 2,
+    FLOW_FUEL_EMPTY = 4
+};
+
+// The telemetry HUD's rows, added to it in this order
+enum TelemetryField
+{
+    TELEMETRY_ALTITUDE,
+    TELEMETRY_VERTICAL_SPEED,
+    TELEMETRY_HORIZONTAL_SPEED,
+    TELEMETRY_FUEL,
+    TELEMETRY_SCORE
+};
+
+// A line of text over the level, centred across the screen whatever the font's widths
+struct FlowBanner
+{
+    const char* text;
+    float       size, spacing;
+    float       height;
+};
+
+const FlowBanner WIN_BANNER    = { "YOU LANDED SAFELY!", 0.25f, 0.0f,  2.0f },
+                 LOSS_BANNER   = { "YOU CRASHED!",       0.25f, 0.01f, 2.0f },
+                 RETRY_HINT    = { "ENTER TO RETRY, R FOR A NEW LEVEL", 0.12f, 0.0f, 1.5f },
+                 FUEL_HINT     = { "OUT OF FUEL",        0.12f, 0.0f,  1.5f },
+                 PAUSED_BANNER = { "PAUSED",             0.25f, 0.01f, 2.0f };
+
+const unsigned int RENDER_BENCH_SEED          = 1;  // same level every run, so runs compare
+const int          RENDER_BENCH_WARMUP_FRAMES = 60;  // untimed, so the exhaust is up to full size
+
+// The usual pixel-agent observation: a square view of the level, spawn point included
+const int       OBSERVATION_TILE_SIZE     = 84;
+const glm::vec2 OBSERVATION_VIEW_MIN      = glm::vec2(-5.0f, -4.5f),
+                OBSERVATION_VIEW_MAX      = glm::vec2(5.0f, 5.5f);
+const int       OBSERVATION_BENCH_BATCHES = 300;
+
+// A sweep over spawn point, stick and gravity in the same view, collected every so many steps
+const int GPU_SIM_BENCH_STEPS         = 1200,
+          GPU_SIM_BENCH_COLLECT_STEPS = 60,
+          GPU_SIM_BENCH_MAX_STEPS     = 600,
+          GPU_SIM_BENCH_CHECKED       = 4096;  // also flown on BatchedLanderSim, to compare
+
+// The loading bar is drawn with scissored clears, so it is on screen before any shader exists
+const int   LOADING_BAR_WIDTH  = 320,
+            LOADING_BAR_HEIGHT = 12,
+            LOADING_BAR_BORDER = 2;
+const float LOADING_BAR_RED    = 0.85f,
+            LOADING_BAR_GREEN  = 0.85f,
+            LOADING_BAR_BLUE   = 0.90f;
+
+const float EXHAUST_RATE   = 900.0f,  // particles per second while boosting
+            EXHAUST_SPEED  = 2.5f,
+            EXHAUST_SPREAD = 0.45f;
+const char  EXHAUST_GLYPH  = '*';     // the spark is borrowed from the font sheet
+
+// The booster's flame at full burn flickers back to the low one now and then
+const float BOOSTER_HIGH_SECONDS    = 0.1f,
+            BOOSTER_FLICKER_SECONDS = 0.05f;
+
+// One-off bursts on the GPU pool; the CPU exhaust pool takes CPU_BURST_LIMIT of them without it
+const int   DEBRIS_COUNT    = 60000,  // a crash
+            DUST_COUNT      = 4000,   // a safe landing
+            CPU_BURST_LIMIT = 2000;
+const float DEBRIS_SPREAD   = 3.0f,
+            DUST_SPEED      = 0.4f,
+            DUST_SPREAD     = 1.2f;
+
+// --backdrop: a cave ceiling of rock and stone blocks behind the level, one static mesh per chunk
+const int       BACKDROP_WIDTH     = 1024,   // in tiles, wide enough for a long endless run
+                BACKDROP_HEIGHT    = 4;
+const float     BACKDROP_TILE_SIZE = 0.25f;
+const glm::vec2 BACKDROP_ORIGIN    = glm::vec2(-BACKDROP_WIDTH * BACKDROP_TILE_SIZE / 2.0f, 3.75f - BACKDROP_HEIGHT * BACKDROP_TILE_SIZE);
+const uint64_t  BACKDROP_STREAM    = 0xBAC6;  // kept apart from the platforms' draws under the same seed
+
+//  PROFILER HUD  //
+const int       PROFILER_GRAPH_ROWS    = 2,
+                PROFILER_GRAPH_COLUMNS = 60;   // frames shown, newest on the right
+const float     PROFILER_TEXT_SIZE     = 0.14f,
+                PROFILER_LINE_HEIGHT   = 0.16f;
+const glm::vec3 PROFILER_ORIGIN        = glm::vec3(-4.85f, 3.6f, 0.0f);  // centre of the first glyph
+const glm::vec3 PROFILER_GRAPH_COLOUR  = glm::vec3(0.55f, 0.8f, 1.0f);   // where the glyphs are instanced
+const int       STARFIELD_GPU_PASS     = RENDER_LAYER_COUNT;  // drawn outside the queue, so timed apart from its layers
+const int       POST_GPU_PASS          = RENDER_LAYER_COUNT + 1;  // the whole post-processing chain
+
+//  TELEMETRY HUD  //
+const float     TELEMETRY_TEXT_SIZE    = 0.14f;
+const int       TELEMETRY_VALUE_WIDTH  = 7;
+const glm::vec3 TELEMETRY_ORIGIN       = glm::vec3(3.17f, 3.6f, 0.0f);  // centre of the first glyph, top right
+
+//  MINIMAP  //
+const int       MINIMAP_WIDTH          = 256,  // texels; the same 4:1 as its place on the HUD
+                MINIMAP_HEIGHT         = 64;
+const glm::vec2 MINIMAP_HUD_MIN        = glm::vec2(-2.0f, -3.65f),  // bottom centre, relative to the camera
+                MINIMAP_HUD_MAX        = glm::vec2(2.0f, -2.65f);
+const float     MINIMAP_MARKER_SIZE    = 0.04f;  // half a marker's side, on the HUD
+const glm::vec4 MINIMAP_PLAYER_COLOUR  = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+                MINIMAP_RIVAL_COLOUR   = glm::vec4(0.3f, 0.8f, 1.0f, 1.0f),
+                MINIMAP_PAD_COLOUR     = glm::vec4(0.3f, 0.9f, 0.4f, 1.0f),
+                MINIMAP_MOVER_COLOUR   = glm::vec4(0.8f, 0.35f, 0.3f, 1.0f),
+                MINIMAP_HINT_COLOUR    = glm::vec4(1.0f, 0.85f, 0.2f, 1.0f);
+const float     LANDING_HINT_RANGE     = 8.0f;  // either side of the player, for the suggested pad
+
+// --lighting: a lamp on every lander, and the flame under the player's while it burns
+const float     LANDER_LIGHT_RADIUS    = 6.0f,
+                FLAME_LIGHT_RADIUS     = 3.5f,
+                FLAME_LIGHT_DROP       = 0.75f;  // of the lander's height, below its centre
+const glm::vec3 LANDER_LIGHT_COLOUR    = glm::vec3(0.9f, 0.9f, 1.0f),
+                RIVAL_LIGHT_COLOUR     = glm::vec3(0.4f, 0.8f, 1.0f),
+                FLAME_LIGHT_COLOUR     = glm::vec3(1.2f, 0.6f, 0.2f);
+
+//  DYNAMIC RESOLUTION  //
+const float DYNAMIC_RESOLUTION_BUDGET_MS = 14.0f;  // GPU time per frame, with room to spare under 60 Hz
+
+//  QUALITY GOVERNOR  //
+const float QUALITY_BUDGET_MS = 14.0f;  // the slower of the CPU's and the GPU's work per frame
+
+//  MEMORY  //
+// What each MemoryTag may hold before a warning, in MB, CPU then GPU (0 for no limit): a 512 MB
+// board's share once the OS, the driver and SDL have theirs. --memory-budget overrides any of them.
+const float MEMORY_BUDGETS_MB[MEMORY_TAG_COUNT][2] =
+{
+    {  0.0f,  0.0f },  // untagged
+    { 48.0f,  0.0f },  // entities
+    { 32.0f, 64.0f },  // render
+    {  8.0f,  8.0f },  // text
+    { 16.0f,  0.0f },  // audio
+    { 64.0f, 96.0f },  // assets
+};
+const float BYTES_PER_MB = 1024.0f * 1024.0f;
+const float TEXTURE_RESIDENCY_MB = 48.0f;  // load_texture()'s share of the assets' 96, beside the atlas
+
+//  PARALLEL RECORDING  //
+const int PARALLEL_RECORD_MIN_SPRITES = 2048;  // below this, the jobs cost more to hand out than they save
 
-const int NUMBER_OF_TEXTURES = 1;  // to be generated, that is
-const GLint LEVEL_OF_DETAIL = 0;  // base image level; Level n is the nth mipmap reduction image
-const GLint TEXTURE_BORDER = 0;  // this value MUST be zero
-const int FONTBANK_SIZE = 16;
 
 //  VARIABLES  //
 GameState g_game_state;
+SimulationThread g_simulation_thread;
+bool g_threaded_simulation = true;  // --serial steps the simulation between frames on the main thread instead
+Entity g_drawn_player;  // the simulation thread's lander as of its last snapshot, while it runs
+int g_job_threads = 1;  // --jobs <n>: threads running each frame's task graph, the main thread included
+std::unique_ptr<JobSystem> g_jobs;
+TaskGraph g_frame_graph;  // rebuilt every frame, reusing last frame's memory
+TaskGraph g_record_graph;  // the same for render(), recording the batched platforms with --jobs
+InputTimeline g_input_timeline;  // every change to the held controls, stamped with when it happened
+InputDevices g_input;  // the keyboard and controllers, as of the last event polled
 
 SDL_Window* g_display_window;
-bool g_game_is_running = true,
-     g_win = false,
-     g_loss = false;
-
-ShaderProgram g_shader_program;
+bool g_game_is_running = true;
+
+ShaderVariants g_sprite_shaders;
+ShaderProgram* g_shader_program;            // SHADER_TEXTURED: sprites drawn outside the batch
+ShaderProgram* g_batch_shader_program;      // SHADER_TEXTURED | SHADER_GLYPHS: the batch, sprites and text alike
+ShaderProgram* g_text_shader_program;       // SHADER_TEXTURED | SHADER_SDF: text drawn on its own
+ShaderProgram* g_queued_text_program;       // what queued text draws with: the batch's, or the SDF one under --separate-text
+ShaderProgram* g_instanced_shader_program;  // SHADER_TEXTURED | SHADER_INSTANCED: exhaust and debris
+ShaderProgram* g_platform_shader_program;   // SHADER_TEXTURED | SHADER_INSTANCED | SHADER_MATERIAL: the platform batch
+SpriteBatch g_sprite_batch;
+InstancedRenderer g_platform_renderer;
+StaticPlatformMesh g_baked_platforms;  // the platform path on drivers without instancing
+TextureAtlas g_texture_atlas;
+TextureCache g_texture_cache;
+AssetPack g_asset_pack;
+AsyncTextureLoader g_texture_loader;
+float g_texture_budget_mb = TEXTURE_RESIDENCY_MB;  // --texture-budget, 0 for never evicting
+TextureStreamer g_texture_streamer;  // the level's placed textures, by how near the camera is
+float g_stream_budget_kb = STREAM_BUDGET_KB;  // --stream-budget
+StartupProfiler g_startup_profiler;  // constructed before main, so its total covers the whole launch
+bool g_startup_reported = false;
+LoadingSequence g_loading;  // everything after the GL context, streamed in under the splash
+FrameProfiler g_frame_profiler;
+GpuProfiler g_gpu_profiler;  // only issues queries while the overlay is up, or for g_dynamic_resolution
+DynamicResolution g_dynamic_resolution;
+QualityGovernor g_governor;  // only steers with --governor; at its best level otherwise
+unsigned int g_post_effects = 0;  // --post bloom,vignette,crt: PostEffect bits
+bool g_post_unmerged = false;     // --post-unmerged: a draw per effect, for comparing against the merged chain
+LightingPass g_lighting;
+bool g_lighting_enabled = false;  // --lighting: lights on the landers, shadowed by the platforms
+std::vector<int> g_lit_platforms;  // in reach of this frame's lights, reused
+PostProcess g_post_process;
+FrameCounters g_frame_counters;  // allocations and GL calls per game frame
+PhysicsCounters g_physics_counters;
+bool g_show_profiler = false;
+bool g_show_telemetry = true;  // F4
+TelemetryHud g_telemetry;
+InstancedText g_overlay_text;  // the profiler HUD, one instance a glyph where supported
+int g_score = 0;  // levels landed this session
+bool g_paused = false;
+bool g_audio_enabled = true;  // --no-audio keeps the game silent and the audio device closed
+AudioMixer g_audio;
+SDL_AudioDeviceID g_audio_device = 0;  // 0 while there's no sound
+int g_thrust_bank = -1, g_thud_bank = -1, g_chime_bank = -1, g_crash_bank = -1;
+float g_thrust_gain = 0.0f;  // as last sent to the mixer
+FlowSequencer g_flow;
+GameEventStream g_events;  // what the player's steps reported, collected once a frame for everything below to read
+const FlowBanner* g_banner = NULL;  // set by the flow scripts; NULL for none
+const FlowBanner* g_hint   = NULL;
+bool g_idle_frame_drawn = false;  // the frame on screen already shows the idle state
+int g_render_bench_frames = 0;  // --render-bench: frames per pass, 0 to play normally
+int g_observation_bench_envs = 0;  // --observation-bench: envs rendered per batch
+int g_gpu_sim_bench_landers = 0;  // --gpu-sim-bench: landers stepped on the GPU
+bool g_core_profile = false;  // --core-profile: ask for a 3.3 core context, falling back to the usual one
+bool g_separate_text = false;  // --separate-text: draw queued text from its own meshes rather than in the sprite batch
+bool g_frame_arrays = false;  // --frame-arrays: draw the ship's frames out of a texture array instead of the atlas
+bool g_gles2 = false;         // --gles2: ask for an OpenGL ES 2.0 context, as on the ARM boards
+bool g_dynamic_resolution_enabled = false;  // --dynamic-resolution: drop the world's resolution to keep the GPU in budget
+bool g_governor_enabled = false;  // --governor: shed effects, particles and resolution to hold the frame budget
+FrameCapture g_frame_capture;
+CaptureFormat g_capture_format = CAPTURE_RAW;  // --capture-format
+bool g_record_from_start = false;  // --record
+SpectatorView g_spectator;
+float g_spectator_zoom = 0.0f;  // --spectator: how many times more of the world the second window shows, 0 for none
+bool g_blend_all = false;     // --blend-all: blend every sprite, opaque or not, as before the material passes
+bool g_use_instancing = true;  // off pushes the platforms and exhaust through the sprite batch
+bool g_bake_platforms = true;  // without instancing, draw the platforms from g_baked_platforms rather than the batch
+std::unique_ptr<Autopilot> g_autopilot;  // created the first time P is pressed, so its threads only exist once used
+bool g_autopilot_enabled = false;
+TextMeshCache g_text_meshes;
+GlyphCache g_glyph_cache;  // UTF-8 text past ASCII, rasterised into its own pages as it's drawn
+RenderQueue g_render_queue;
+FramePacer g_frame_pacer;
+FrameLatency g_frame_latency;
+DisplayMode g_display_mode = DISPLAY_WINDOWED;  // --display
+VsyncMode g_vsync_mode = VSYNC_MODE;            // --vsync
+int g_max_queued_frames = 0;                    // --max-queued-frames: 0 leaves it to the driver
+int g_viewport_width = WINDOW_WIDTH,            // the window's drawable size, once it's open
+    g_viewport_height = WINDOW_HEIGHT;
+ParticleSystem g_exhaust;
+GpuParticleSystem g_debris;  // crash debris and touchdown dust, where the GPU can run it
+SceneGraph g_attachments;    // what rides on the lander; only recomputed when the lander moves
+int g_lander_node = -1, g_nozzle_node = -1;
+
+// Everything one level owns on the CPU side. The level being played lives in one slot while the
+// next is prefetched into the other on a worker thread, so a new level is ready the moment it's
+// asked for.
+struct LevelSlot
+{
+    LevelArena                  arena;  // owns the player, the platforms and their animation tables
+    Entity*                     player = NULL;
+    Entity*                     platforms = NULL;
+    int                         platform_count = 0;
+    PlatformIntervalIndex       platform_index;
+    PlatformColliders           platform_colliders;
+    LandingSiteMap              landing_sites;
+    std::vector<SpriteInstance> instances;  // with their atlas frames, sorted along x, ready to upload
+    std::vector<int>            instance_platforms;  // the platform each instance draws...
+    std::vector<int>            platform_instances;  // ...and back, for the editor to patch one in place
+    float                       max_half_width = 0.0f;  // of any platform, for culling the instances
+    int                         visible_cursor = -1;    // the broadphase's, for the on-screen query
+    unsigned int                seed = 0;
+};
+LevelSlot g_level_slots[2];
+int g_level_slot = 0;  // the one being played
+std::future<void> g_prefetch;  // the next level, being prepared into the other slot
+int g_prefetch_uploaded = -1;  // of its instances, into g_next_platform_renderer; -1 before the group exists
+InstancedRenderer g_next_platform_renderer;
+std::vector<int> g_visible_platforms;  // this frame's broadphase query, reused
+std::vector<RenderCommandBuffer> g_record_buffers;  // one per job thread, kept so their storage is too
+FrameArena g_frame_arena;  // everything render() builds and throws away, reset every frame
+SimulationSnapshot g_level_snapshot;  // the current level as loaded, for replaying it
+bool g_level_snapshot_saved = false;  // false for scenes too big for a snapshot
+SceneConfig g_scene;  // --platforms and --layout; the classic level unless asked otherwise
+float g_min_win_chance = DEFAULT_MIN_WIN_CHANCE;  // --min-win-chance: generated levels less winnable are re-rolled; 0 for off
+bool g_endless = false;  // --endless: a course streamed in chunks around the camera instead of g_scene
+LevelStreamer g_level_streamer;
+LevelFile g_level_file;  // --level: platforms, terrain and spawn mapped from a .lvl instead of g_scene
+Terrain g_level_terrain;
+DistanceField g_level_field;
+bool g_use_distance_field = false;  // --sdf: collide with g_level_field, baked from the terrain, instead of the terrain itself
+TerrainEditor g_terrain_editor;
+bool g_craters = false;  // --craters: a crash digs into a level file's terrain, until the level is replayed
+LevelEditor g_level_editor;
+bool g_editor = false;  // --editor: static platforms dragged about with the mouse while the level runs
+std::vector<PlatformMove> g_platform_moves;  // the editor's change set as applied this frame
+Camera g_camera;
+bool g_backdrop = false;
+Tilemap g_backdrop_tiles;
+Starfield g_starfield;
+bool g_late_input = false;  // --late-input draws the keys held at render time ahead of the simulation
+bool g_show_trajectory = false;  // --trajectory dots the path to where the lander comes down hands off
+TrajectoryOverlay g_trajectory;
+bool g_show_minimap = false;  // --minimap, and on by default with --endless; F6
+Minimap g_minimap;
+ShaderProgram* g_flat_shader_program;  // no features: flat colour, for the trajectory
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+bool g_show_collision = false;  // F5: boxes, the broadphase's answer and contacts
+ShaderProgram* g_debug_line_program;  // SHADER_VERTEX_COLOUR, for the DEBUG_DRAW_* lines
+#endif
+const char* g_net_address = NULL;  // --connect: plays on a server's level, against its other players
+NetClient g_net_client;
+Entity g_remote_landers[NET_MAX_LANDERS];  // the other players, as of the latest snapshot
+uint8_t g_net_round = 0;  // the server's round the level flow was started for
+const char* g_versus_address = NULL;  // --versus: head to head with one other player, over rollback
+uint16_t g_versus_port = 0;
+RollbackPeer g_versus_peer;
+RollbackSession g_rollback;
+Entity g_versus_lander;  // the other player
+LanderOutcome g_versus_outcome;
+int64_t g_versus_ticks = 0;  // time not yet stepped, as advance_simulation_ticks keeps it
+bool g_starfield_enabled = true;  // --no-starfield leaves the plain clear colour behind the level
+unsigned int g_level_seed = 0;
+InputReplay g_replay;  // the current attempt, restarted with the level
+bool g_rewind_enabled = false;  // --rewind: practice, with backspace running the level back
+bool g_rewinding = false;       // backspace or the left shoulder is held
+RewindBuffer g_rewind;          // the last REWIND_SECONDS of steps, restarted with the level
+const char* g_ghost_directory = NULL;  // --ghosts: replays to fly alongside
+GhostFleet g_ghosts;
+const char* g_policy_filepath = NULL;  // --policy: a trained network to fly AI landers with
+const char* g_gameplay_filepath = NULL;  // --gameplay: a LanderGameplay library to step with, reloaded on rebuild
+GameplayModule g_gameplay;
+const char* g_tuning_filepath = NULL;  // --tuning: physics and performance knobs, reread when saved
+TuningConfig g_tuning;
+float g_simulation_timestep = SIMULATION_TIMESTEP;  // the tuning file's once it's loaded, from the next level on
+int g_ai_lander_count = DEFAULT_AI_LANDERS;  // --ai-landers
+PolicyFleet g_policy_fleet;
+const char* g_telemetry_log_path = NULL;  // --telemetry-log: where this session's records go
+TelemetryLog g_telemetry_log;
+FlightRecorder g_flight_recorder;  // always on; the last few seconds of frames, for crashes and hitches
+float g_hitch_ms = DEFAULT_HITCH_MS;  // --hitch-ms
+const char* g_leaderboard_url = NULL;  // --leaderboard
+const char* g_player_name = "player";  // --player
+LeaderboardClient g_leaderboard;
+SaveStore g_save;  // appended to as things change, by a thread of its own
+double g_telemetry_frame_start = 0.0,  // on the input clock, as the last frame began
+       g_telemetry_idle_start  = 0.0;  // the pacer's idle seconds then, which aren't the frame's
+int g_ship_region, g_death_region, g_win_region, g_platform_region, g_font_region;
+InstanceMaterials g_platform_materials;  // every platform look, read along g_platform_region's greys
+int g_death_material, g_win_material;
+FontMetrics g_font_metrics;
+glm::vec4 g_ship_frames[SHIP_SHEET.FRAME_COUNT];  // SHIP_SHEET inside the atlas
+GLuint g_ship_frame_array = 0;  // SHIP_SHEET as a texture array under --frame-arrays, where supported
+AnimationLibrary g_animations;  // every clip, built before anything is loaded and only read after
+int g_booster_clip = AnimationLibrary::NO_CLIP;  // IDLE, then LOW and HIGH
+SamplerPreset g_frame_array_sampler = SAMPLER_PIXEL_ART;
 glm::mat4 g_view_matrix, g_projection_matrix;
 
-float g_previous_ticks = 0.0f;
-float g_time_accumulator = 0.0f;
+FrameClock g_frame_clock;  // restarted when loading finishes
 
 //  GENERAL FUNCTIONS  //
-void draw_text(ShaderProgram* program, GLuint font_texture_id, std::string text, float screen_size, float spacing, glm::vec3 position)
-{
-    // Scale the size of the fontbank in the UV-plane
-    // We will use this for spacing and positioning
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
-
-    // Instead of having a single pair of arrays, we'll have a series of pairsone for each character
-    // Don't forget to include <vector>!
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
-
-    // For every character...
-    for (int i = 0; i < text.size(); i++) {
-        // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
-        //    relative to the whole sentence)
-        int spritesheet_index = (int)text[i];  // ascii value of character
-        float offset = (screen_size + spacing) * i;
-
-        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-        float u_coordinate = (float)(spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float)(spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-        // 3. Inset the current pair in both vectors
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            });
-
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            });
-    }
-
-    // 4. And render all of them using the pairs
-    glm::mat4 model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
-
-    program->set_model_matrix(model_matrix);
-    glUseProgram(program->get_program_id());
-
-    glVertexAttribPointer(program->get_position_attribute(), 2, GL_FLOAT, false, 0, vertices.data());
-    glEnableVertexAttribArray(program->get_position_attribute());
-    glVertexAttribPointer(program->get_tex_coordinate_attribute(), 2, GL_FLOAT, false, 0, texture_coordinates.data());
-    glEnableVertexAttribArray(program->get_tex_coordinate_attribute());
-
-    glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int)(text.size() * 6));
-
-    glDisableVertexAttribArray(program->get_position_attribute());
-    glDisableVertexAttribArray(program->get_tex_coordinate_attribute());
+void draw_text(ShaderProgram* program, std::string_view text, float screen_size, float spacing, glm::vec3 position)
+{
+    // Queued on the HUD layer; at flush the geometry for a given (text, size, spacing) comes from
+    // a buffer that is built once and reused from then on. `position` is on screen, so it moves
+    // with the camera.
+    position += glm::vec3(g_camera.get_position(), 0.0f);
+    g_render_queue.submit_text(HUD_LAYER, program, text, screen_size, spacing, position);
 }
 
-GLuint load_texture(const char* filepath)
+void draw_banner(const FlowBanner& banner)
 {
-    int width, height, number_of_components;
-    unsigned char* image = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+    float width = measure_text(g_font_metrics, banner.text, banner.size, banner.spacing);
+    draw_text(g_queued_text_program, banner.text, banner.size, banner.spacing, glm::vec3(0.5f * (banner.size - width), banner.height, 0.0f));
+}
+
+// Last frame, min, avg and p99 for each part of the frame, with a bar graph of its recent history
+// The profiler's lines change every frame: a glyph instance a character where there's instancing,
+// otherwise rebuilt through the queue like any other transient text
+void add_profiler_line(const char* line, glm::vec3 position, glm::vec3 colour = glm::vec3(1.0f))
+{
+    if (g_overlay_text.is_supported()) g_overlay_text.add(line, PROFILER_TEXT_SIZE, 0.0f, glm::vec2(position), colour);
+    else g_render_queue.submit_transient_text(HUD_LAYER, g_queued_text_program, line, PROFILER_TEXT_SIZE, 0.0f, position);
+}
+
+void draw_overlay_text(void* user_data)
+{
+    g_overlay_text.draw();
+}
+
+void draw_profiler_hud()
+{
+    static const char* const SECTION_NAMES[PROFILE_SECTION_COUNT] = { "input ", "update", "render" };
+    static const char* const PASS_NAMES[RENDER_LAYER_COUNT + 2] = { "bg", "world", "actor", "fx", "hud", "stars", "post" };
+    static const char* const MEMORY_HUD_NAMES[MEMORY_TAG_COUNT] = { "etc", "ent", "ren", "txt", "aud", "ast" };
+
+    char line[PROFILER_GRAPH_COLUMNS + 1];
+    glm::vec3 position = PROFILER_ORIGIN + glm::vec3(g_camera.get_position(), 0.0f);
+    g_overlay_text.begin();
+
+    for (int section = 0; section < PROFILE_SECTION_COUNT; section++)
+    {
+        ProfileSection id = (ProfileSection)section;
+        SectionStats stats = g_frame_profiler.get_stats(id);
+
+        int length = std::snprintf(line, sizeof(line), "%s %5.2f ms  min %5.2f avg %5.2f p99 %5.2f",
+                                   SECTION_NAMES[section], g_frame_profiler.get_last_ms(id), stats.min_ms, stats.avg_ms, stats.p99_ms);
+        if (id == PROFILE_UPDATE && length > 0 && length < (int)sizeof(line))
+        {
+            std::snprintf(line + length, sizeof(line) - length, "  %d steps", g_frame_profiler.get_last_step_count());
+        }
+
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+
+        // Scaled to the worst frame in the window, so a hitch stands out against its neighbours
+        float scale_ms = std::max(stats.max_ms, 0.01f);
+        for (int row = 0; row < PROFILER_GRAPH_ROWS; row++)
+        {
+            g_frame_profiler.build_graph_row(id, row, PROFILER_GRAPH_ROWS, scale_ms, line, PROFILER_GRAPH_COLUMNS);
+            add_profiler_line(line, position, PROFILER_GRAPH_COLOUR);
+            position.y -= PROFILER_LINE_HEIGHT;
+        }
+    }
+
+    // GPU time per layer, GpuProfiler::FRAME_LATENCY frames behind the CPU numbers above
+    int length = std::snprintf(line, sizeof(line), "gpu   ");
+    int last_pass = g_post_process.is_active() ? POST_GPU_PASS : STARFIELD_GPU_PASS;
+    for (int pass = 0; pass <= last_pass && length < (int)sizeof(line); pass++)
+    {
+        length += std::snprintf(line + length, sizeof(line) - length, " %s %.2f", PASS_NAMES[pass], g_gpu_profiler.get_pass_ms(pass));
+    }
+    if (!g_gpu_profiler.is_supported()) std::snprintf(line, sizeof(line), "gpu    no timer queries");
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    if (g_dynamic_resolution.is_enabled())
+    {
+        std::snprintf(line, sizeof(line), "res    %3.0f%%  %dx%d  gpu avg %.2f / %.2f ms", g_dynamic_resolution.get_scale() * 100.0f,
+                      g_dynamic_resolution.get_scene_width(), g_dynamic_resolution.get_scene_height(),
+                      g_dynamic_resolution.get_smoothed_ms(), DYNAMIC_RESOLUTION_BUDGET_MS);
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+    }
+
+    if (g_governor.is_enabled())
+    {
+        std::snprintf(line, sizeof(line), "qual   %d %s  p95 %.2f / %.2f ms  %d changes", g_governor.get_level(), g_governor.get_settings().name,
+                      g_governor.get_last_p95_ms(), g_governor.get_budget_ms(), g_governor.get_change_count());
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+    }
+
+    if (g_lighting.is_enabled())
+    {
+        std::snprintf(line, sizeof(line), "light  %d / %d  %d texels around  %d edges  %d draws", g_lighting.get_light_count(), g_lighting.get_max_lights(),
+                      g_lighting.get_shadow_resolution(), g_lighting.get_edge_count(), g_lighting.get_draw_calls());
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+    }
+
+    // Last frame's counts, so this frame's own HUD text is in the next line's numbers
+    std::snprintf(line, sizeof(line), "alloc  %lld (%lld B)  max %lld",
+                  g_frame_counters.get_last(COUNTER_ALLOCATIONS), g_frame_counters.get_last(COUNTER_ALLOCATED_BYTES), g_frame_counters.get_max(COUNTER_ALLOCATIONS));
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    // Live bytes by tag, marked where a budget is exceeded; GPU bytes are estimates
+    for (int side = 0; side < 2; side++)
+    {
+        int length = std::snprintf(line, sizeof(line), side == 0 ? "cpu MB" : "gpu MB");
+        for (int tag = 0; tag < MEMORY_TAG_COUNT && length < (int)sizeof(line); tag++)
+        {
+            MemoryUsage usage = get_memory_usage((MemoryTag)tag);
+            long long bytes  = side == 0 ? usage.cpu_bytes : usage.gpu_bytes,
+                      budget = side == 0 ? get_cpu_budget((MemoryTag)tag) : get_gpu_budget((MemoryTag)tag);
+            length += std::snprintf(line + length, sizeof(line) - length, " %s %.1f%s", MEMORY_HUD_NAMES[tag], bytes / BYTES_PER_MB,
+                                    budget > 0 && bytes > budget ? "!" : "");
+        }
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+    }
 
-    if (image == NULL)
+    if (g_frame_capture.get_captured_count() > 0)
     {
-        LOG("Unable to load image. Make sure the path is correct.");
-        assert(false);
+        std::snprintf(line, sizeof(line), "cap    %s%d  written %d  dropped %d  %.2f ms (max %.2f)", g_frame_capture.is_recording() ? "rec " : "",
+                      g_frame_capture.get_captured_count(), g_frame_capture.get_written_count(), g_frame_capture.get_dropped_count(),
+                      g_frame_capture.get_last_ms(), g_frame_capture.get_max_ms());
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
     }
 
-    GLuint textureID;
-    glGenTextures(NUMBER_OF_TEXTURES, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, LEVEL_OF_DETAIL, GL_RGBA, width, height, TEXTURE_BORDER, GL_RGBA, GL_UNSIGNED_BYTE, image);
+    std::snprintf(line, sizeof(line), "tex    %d  resident %.1f / %.0f MB  evicted %d  reloaded %d", g_texture_cache.get_texture_count(),
+                  g_texture_cache.get_resident_bytes() / BYTES_PER_MB, g_texture_budget_mb, g_texture_cache.get_evictions(), g_texture_cache.get_reloads());
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    if (g_texture_streamer.get_texture_count() > 0)
+    {
+        std::snprintf(line, sizeof(line), "stream %d  pending %d  %.0f KB this frame  %.1f MB in all", g_texture_streamer.get_texture_count(),
+                      g_texture_streamer.get_pending_count(), g_texture_streamer.get_last_bytes() / 1024.0f, g_texture_streamer.get_total_bytes() / BYTES_PER_MB);
+        add_profiler_line(line, position);
+        position.y -= PROFILER_LINE_HEIGHT;
+    }
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    std::snprintf(line, sizeof(line), "gl     bind %lld  uniform %lld  upload %lld  draw %lld",
+                  g_frame_counters.get_last(COUNTER_GL_BINDS), g_frame_counters.get_last(COUNTER_GL_UNIFORMS),
+                  g_frame_counters.get_last(COUNTER_GL_UPLOADS), g_frame_counters.get_last(COUNTER_GL_DRAWS));
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    // Republished once a second; steps/frame against the budget says whether the timestep fits this machine
+    const PhysicsStats& physics = g_physics_counters.get_stats();
+    std::snprintf(line, sizeof(line), "sim    %.0f steps/s  avg %.2f  max %d/%d per frame",
+                  physics.steps_per_second, physics.average_steps_per_frame, physics.max_steps_per_frame, g_game_state.budget.max_steps_per_frame);
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    std::snprintf(line, sizeof(line), "lag    acc %.2f ms  max %.2f  dropped %.1f ms",
+                  physics.accumulator_ms, physics.max_accumulator_ms, physics.dropped_ms);
+    add_profiler_line(line, position);
+    position.y -= PROFILER_LINE_HEIGHT;
+
+    std::snprintf(line, sizeof(line), "step   collide %.3f  integrate %.3f ms/frame",
+                  physics.collision_ms_per_frame, physics.integration_ms_per_frame);
+    add_profiler_line(line, position);
+
+    if (g_autopilot_enabled)
+    {
+        position.y -= PROFILER_LINE_HEIGHT;
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        const AutopilotStats& autopilot = g_autopilot->get_stats();
+        std::snprintf(line, sizeof(line), "auto   %d/%d plans in %.2f ms  best %.1f%s",
+                      autopilot.rollouts, autopilot.plan_count, autopilot.seconds * 1000.0, autopilot.best_score, autopilot.lands ? "  lands" : "");
+        add_profiler_line(line, position);
+    }
 
-    stbi_image_free(image);
+    if (g_overlay_text.is_supported())
+    {
+        g_render_queue.submit_custom(HUD_LAYER, g_overlay_text.get_program(), g_texture_atlas.get_texture_id(), draw_overlay_text, NULL);
+    }
+}
 
-    return textureID;
+void draw_platform_instances(void* user_data)
+{
+    g_platform_materials.upload(g_platform_shader_program);
+    g_platform_renderer.draw(g_platform_shader_program);
 }
 
-void initialise()
+void draw_baked_platforms(void* user_data)
 {
-    SDL_Init(SDL_INIT_VIDEO);
-    g_display_window = SDL_CreateWindow("Lunar Lander",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        WINDOW_WIDTH, WINDOW_HEIGHT,
-        SDL_WINDOW_OPENGL);
+    g_baked_platforms.draw(g_shader_program);
+}
 
-    SDL_GLContext context = SDL_GL_CreateContext(g_display_window);
-    SDL_GL_MakeCurrent(g_display_window, context);
+void draw_trajectory(void* user_data)
+{
+    g_trajectory.draw(g_flat_shader_program);
+}
 
-#ifdef _WINDOWS
-    glewInit();
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+void draw_debug_lines(void* user_data)
+{
+    get_debug_draw().draw(g_debug_line_program);
+}
 #endif
 
-    glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
-
-    g_shader_program.load(V_SHADER_PATH, F_SHADER_PATH);
+void draw_telemetry(void* user_data)
+{
+    g_telemetry.draw(g_text_shader_program, TELEMETRY_ORIGIN + glm::vec3(g_camera.get_position(), 0.0f));
+}
 
-    g_view_matrix = glm::mat4(1.0f);
-    g_projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
+void draw_minimap(void* user_data)
+{
+    g_minimap.draw(MINIMAP_HUD_MIN + g_camera.get_position(), MINIMAP_HUD_MAX + g_camera.get_position());
+}
 
-    g_shader_program.set_projection_matrix(g_projection_matrix);
-    g_shader_program.set_view_matrix(g_view_matrix);
+void draw_exhaust_instances(void* user_data)
+{
+    g_exhaust.draw(g_instanced_shader_program);
+}
 
-    glUseProgram(g_shader_program.get_program_id());
+void draw_ghosts(void* user_data)
+{
+    g_ghosts.draw(*(const float*)user_data);
+}
 
-    glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+void draw_policy_fleet(void* user_data)
+{
+    g_policy_fleet.draw(*(const float*)user_data);
+}
 
-    //  PLAYER  //
-    g_game_state.player = new Entity();
-    g_game_state.player->set_position(glm::vec3(0.0f, 3.0f, 0.0f));
-    g_game_state.player->set_movement(glm::vec3(0.0f));
-    g_game_state.player->set_acceleration(glm::vec3(0.0f, ACC_OF_GRAVITY, 0.0f));
-    g_game_state.player->set_speed(2.0f);
-    g_game_state.player->m_texture_id = load_texture(SPRITESHEET_FILEPATH);
+void draw_debris(void* user_data)
+{
+    g_debris.draw(g_instanced_shader_program);
+}
 
-    // BOOSTER LEVELS
-    g_game_state.player->m_booster[g_game_state.player->IDLE] = new int(0);
-    g_game_state.player->m_booster[g_game_state.player->LOW] = new int(1);
-    g_game_state.player->m_booster[g_game_state.player->HIGH] = new int(2);
+// Where the course's x = 0 is in the local coordinates everything else is in; only an endless
+// course ever moves it (see LevelStreamer::rebase)
+glm::vec2 get_course_origin()
+{
+    return glm::vec2(g_level_streamer.get_origin_x(), 0.0f);
+}
 
-    g_game_state.player->m_animation_indices = g_game_state.player->m_booster[g_game_state.player->IDLE];
-    g_game_state.player->m_animation_index = 0;
-    g_game_state.player->m_animation_time = 0.0f;
-    g_game_state.player->m_animation_cols = 3;
-    g_game_state.player->m_animation_rows = 1;
-    g_game_state.player->set_height(0.8f);
-    g_game_state.player->set_width(0.8f);
+void draw_backdrop_tiles(void* user_data)
+{
+    glm::vec2 view_min, view_max;
+    get_view_bounds(g_sprite_shaders.get_projection_matrix(), g_view_matrix, view_min, view_max);
+    g_backdrop_tiles.draw(g_shader_program, view_min, view_max, -get_course_origin());
+}
 
-    g_game_state.player->m_boosting_power = 0.1f;
-    g_game_state.player->m_drag = 0.8f;
+// Hangs down from the top of the screen, thinning out row by row. Only tiles are written here;
+// the chunks are built the first time they come into view. Each column of chunks is all rock or
+// all stone, in its own texture that TextureStreamer brings in as the camera nears it.
+void build_backdrop(unsigned int seed)
+{
+    const AssetId THEMES[] = { DEATH_PLATFORM_ASSET, WIN_PLATFORM_ASSET };
 
+    const TileType ROCK_TILE = 1, STONE_TILE = 2;
 
-    //  PLATFORM  //
-    std::mt19937 rng(std::random_device{}());
+    g_backdrop_tiles.initialise(BACKDROP_WIDTH, BACKDROP_HEIGHT, BACKDROP_TILE_SIZE, BACKDROP_ORIGIN, g_texture_atlas.get_texture_id());
+    g_backdrop_tiles.set_tile_uv_rect(ROCK_TILE, g_texture_atlas.get_region(g_death_region).uv_rect);
+    g_backdrop_tiles.set_tile_uv_rect(STONE_TILE, g_texture_atlas.get_region(g_win_region).uv_rect);
 
-    g_game_state.platforms = new Entity[PLATFORM_COUNT];
+    Rng rng(seed, BACKDROP_STREAM);
+    for (int y = 0; y < BACKDROP_HEIGHT; y++)
+    {
+        float fill = (float)(y + 1) / BACKDROP_HEIGHT;
+        for (int x = 0; x < BACKDROP_WIDTH; x++)
+        {
+            if (rng.next_float() < fill) g_backdrop_tiles.set_tile(x, y, rng.next_float() < 0.8f ? ROCK_TILE : STONE_TILE);
+        }
+    }
 
-    for (int i = 0; i < PLATFORM_COUNT; i++)
+    float column_width = g_backdrop_tiles.get_chunk_size();
+    for (int column = 0; column < g_backdrop_tiles.get_chunks_wide(); column++)
     {
-        bool rand_bool = std::uniform_int_distribution<>{ 0, 1 }(rng);
-        float rand_float = std::uniform_int_distribution<>{ -3, 1 }(rng);
-        g_game_state.platforms[i].set_position(glm::vec3(i - 4.0f, rand_float, 0.0f));
+        float left = BACKDROP_ORIGIN.x + column * column_width;
+        const char* theme = AssetManifest::ENTRIES[THEMES[rng.next_int(0, 1)]].path;
+        g_backdrop_tiles.set_column_texture(column, g_texture_streamer.place(theme, left, left + column_width));
+    }
+}
 
-        EntityType platformType = (rand_bool) ? WIN_PLATFORM : DEATH_PLATFORM;
-        g_game_state.platforms[i].set_entity_type(platformType);
+// Standalone sheets (anything not packed into g_texture_atlas) go through the cache, so asking for
+// the same path again costs a map lookup instead of another decode and upload
+GLuint load_texture(const char* filepath)
+{
+    return g_texture_cache.acquire(filepath);
+}
 
-        if (platformType == WIN_PLATFORM) g_game_state.platforms[i].m_texture_id = load_texture(WIN_PLATFORM_FILEPATH);
-        if (platformType == DEATH_PLATFORM) g_game_state.platforms[i].m_texture_id = load_texture(DEATH_PLATFORM_FILEPATH);
+// Pre-decoded pixels from the pack when it has the image, otherwise decode the PNG as before.
+// Runs on a loading thread, so what it read is added to bytes_read rather than to the profiler,
+// and it can wait there for a streamed pack's image to arrive.
+int add_atlas_image(AssetId asset, unsigned long long& bytes_read)
+{
+    const char* filepath = AssetManifest::ENTRIES[asset].path;
+    const AssetPackEntry* packed = g_asset_pack.wait_for(asset);
+    if (packed == NULL)
+    {
+        std::error_code error;
+        uintmax_t file_size = std::filesystem::file_size(filepath, error);
+        if (!error) bytes_read += file_size;
 
-        g_game_state.platforms[i].update(0.0f, NULL, 0, g_win, g_loss);
+        return g_texture_atlas.add_image(filepath);
     }
 
-    //  TEXT  //
-    g_text_texture_id = load_texture(FONT_SPRITE_FILEPATH);
+    bytes_read += (unsigned long long)packed->width * packed->height * 4;
+    return g_texture_atlas.add_pixels(filepath, (int)packed->width, (int)packed->height, g_asset_pack.get_pixels(*packed));
+}
 
-    //  GENERAL  //
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+// How sprites from the region are drawn: unblended wherever its alpha allows, unless --blend-all
+RenderMaterial get_atlas_material(int region)
+{
+    return g_blend_all ? TRANSLUCENT_MATERIAL : g_texture_atlas.get_region(region).material;
 }
 
-void process_input()
+// The rock and stone tiles together, as the platform and backdrop draws mix them
+RenderMaterial get_tile_material()
 {
-    // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere
-    g_game_state.player->set_movement(glm::vec3(0.0f));
-    g_game_state.player->m_booster_active = false;
+    return std::max(get_atlas_material(g_death_region), get_atlas_material(g_win_region));
+}
 
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
-    {
-        switch (event.type) {
-            // End game
-        case SDL_QUIT:
-        case SDL_WINDOWEVENT_CLOSE:
-            g_game_is_running = false;
-            break;
+// The instanced platforms' looks, as ramps fitted to rock.png's and stone.png's colours against
+// their own grey levels. A new kind of pad is another palette or tint here, not another image.
+void build_platform_materials()
+{
+    int rock  = g_platform_materials.add_palette(glm::vec3(0.261f, 0.288f, 0.390f), glm::vec3(0.860f, 0.880f, 0.927f)),
+        stone = g_platform_materials.add_palette(glm::vec3(0.453f, 0.231f, 0.277f), glm::vec3(0.973f, 0.664f, 0.412f));
 
-        case SDL_KEYDOWN:
-            switch (event.key.keysym.sym) {
-            case SDLK_q:
-                // Quit the game with a keystroke
-                g_game_is_running = false;
-                break;
+    g_death_material = g_platform_materials.add_material(rock);
+    g_win_material   = g_platform_materials.add_material(stone);
+}
 
-            default:
-                break;
-            }
+// A sheet split into the layers of a texture array, from the pack when it has the image. 0 where
+// the driver has no texture arrays, and the entity stays on its atlas frames.
+template <int COLUMNS, int ROWS>
+GLuint load_frame_array(AssetId asset, const SheetLayout<COLUMNS, ROWS>& sheet)
+{
+    const AssetPackEntry* packed = g_asset_pack.find(asset);
+    if (packed != NULL) return create_frame_array(sheet, g_asset_pack.get_pixels(*packed), (int)packed->width, (int)packed->height, true);
 
-        default:
-            break;
-        }
-    }
+    int width, height, number_of_components;
+    unsigned char* pixels = stbi_load(AssetManifest::ENTRIES[asset].path, &width, &height, &number_of_components, STBI_rgb_alpha);
+    if (pixels == NULL) return 0;
+
+    GLuint array_id = create_frame_array(sheet, pixels, width, height, true);
+    stbi_image_free(pixels);
+    return array_id;
+}
+
+// Has to follow any change to the platforms: a new level, or chunks streamed in
+void build_platform_colliders(LevelSlot& slot)
+{
+    // A single row of platforms, so the sorted strip beats a grid here
+    slot.platform_index.build(slot.platforms, slot.platform_count);
+    slot.platform_colliders.build(slot.platforms, slot.platform_count);
+    slot.landing_sites.build(slot.platforms, slot.platform_count, &slot.platform_index);
+    slot.visible_cursor = -1;
+}
+
+// --sdf: the level file's terrain, as a field from its lowest point to its highest. The bake
+// is a few hundred milliseconds for a long level, so it runs wherever the terrain was loaded.
+void bake_level_field()
+{
+    const float* heights = g_level_terrain.get_heights();
+    int count = g_level_terrain.get_sample_count();
+    if (count < 2) return;
+
+    float lowest  = *std::min_element(heights, heights + count),
+          highest = *std::max_element(heights, heights + count),
+          left    = g_level_terrain.get_origin_x(),
+          right   = left + (count - 1) * g_level_terrain.get_spacing();
+
+    // A crater can take the ground down to a diameter below where it was
+    float depth = g_craters ? 2.0f * CRATER_RADIUS : 0.0f;
+    g_level_field.begin(glm::vec2(left, lowest - FIELD_MARGIN - depth), glm::vec2(right, highest + FIELD_MARGIN), FIELD_CELL_SIZE);
+    g_level_field.fill_terrain(g_level_terrain);
+    g_level_field.bake(g_craters);  // craters repaint it
+}
+
+// The grey frame every platform instance shares, tinted and varied by its material
+SpriteInstance make_platform_instance(const Entity& platform)
+{
+    glm::vec2 position = glm::vec2(platform.get_position()),
+              size     = glm::vec2(platform.get_width(), platform.get_height());
 
-    const Uint8* key_state = SDL_GetKeyboardState(NULL);
+    SpriteInstance instance = { position, size, g_texture_atlas.get_region(g_platform_region).uv_rect };
+    g_platform_materials.apply(platform.get_entity_type() == WIN_PLATFORM ? g_win_material : g_death_material, position, instance);
+    return instance;
+}
 
-    if (key_state[SDL_SCANCODE_UP] || key_state[SDL_SCANCODE_W])
+// Atlas frames and instance data for the slot's platforms as they stand. The entities keep their
+// own rock and stone frames for the baked mesh and the batch; the instances all share the grey
+// frame and differ only by material. Reads the atlas's regions but never GL, so a prefetch can run
+// it once the atlas is built.
+void dress_platforms(LevelSlot& slot)
+{
+    for (int i = 0; i < slot.platform_count; i++)
     {
-        g_game_state.player->m_booster_active = true;
+        EntityType platformType = slot.platforms[i].get_entity_type();
+        int region = platformType == WIN_PLATFORM ? g_win_region : g_death_region;
+
+        slot.platforms[i].m_texture_id = g_texture_atlas.get_texture_id();
+        slot.platforms[i].m_uv_rect = g_texture_atlas.get_region(region).uv_rect;
+        slot.platforms[i].m_material = get_atlas_material(region);
     }
-    else if (key_state[SDL_SCANCODE_LEFT] || key_state[SDL_SCANCODE_A])
+
+    slot.instances.clear();
+    slot.instance_platforms.clear();
+    slot.platform_instances.clear();
+    slot.max_half_width = 0.0f;
+    if (!g_platform_renderer.is_supported()) return;
+
+    // Draw order among platforms doesn't matter, so sort for cull_platform_instances. Generated
+    // scenes are mostly in order already; streamed chunks and level files needn't be. The keys
+    // are sorted rather than the platforms, which are far too big to move about.
+    std::vector<std::pair<float, int>> order(slot.platform_count);
+    for (int i = 0; i < slot.platform_count; i++) order[i] = { slot.platforms[i].get_position().x, i };
+    std::sort(order.begin(), order.end(),
+              [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first < b.first; });
+
+    slot.instances.reserve(slot.platform_count);
+    slot.instance_platforms.resize(slot.platform_count);
+    slot.platform_instances.resize(slot.platform_count);
+    for (int i = 0; i < slot.platform_count; i++)
     {
-        g_game_state.player->move_left();
+        const Entity& platform = slot.platforms[order[i].second];
+        slot.instances.push_back(make_platform_instance(platform));
+        slot.instance_platforms[i] = order[i].second;
+        slot.platform_instances[order[i].second] = i;
+        slot.max_half_width = std::max(slot.max_half_width, platform.get_width() * 0.5f);
     }
-    else if (key_state[SDL_SCANCODE_RIGHT] || key_state[SDL_SCANCODE_D])
+}
+
+// Narrows the instanced draw to the run of the x-sorted instances that can reach into the view.
+// Platforms are a strip along x, so y is left to the GPU.
+void cull_platform_instances(glm::vec2 view_min, glm::vec2 view_max)
+{
+    const LevelSlot& slot = g_level_slots[g_level_slot];
+    auto begin = slot.instances.begin(),
+         end   = slot.instances.end();
+
+    auto first = std::lower_bound(begin, end, view_min.x - slot.max_half_width,
+                                  [](const SpriteInstance& instance, float x) { return instance.offset.x < x; });
+    auto last  = std::upper_bound(first, end, view_max.x + slot.max_half_width,
+                                  [](float x, const SpriteInstance& instance) { return x < instance.offset.x; });
+
+    g_platform_renderer.set_group_range(0, (int)(first - begin), (int)(last - first));
+}
+
+// One job's share of the platforms, written into its slice of the frame's quads and recorded
+// into its own buffer
+struct RecordTaskData
+{
+    RenderCommandBuffer* buffer;
+    const int*           indices;  // into g_game_state.platforms; NULL for the platforms in order
+    int                  first, count;
+    SpriteQuad*          quads;    // this share's `count` of them
+};
+
+std::vector<RecordTaskData> g_record_tasks;
+
+void record_platforms_task(void* user_data)
+{
+    const RecordTaskData& task = *(const RecordTaskData*)user_data;
+
+    RenderMaterial material = Entity::write_sprite_quads(g_game_state.platforms, task.indices, task.first, task.count, 1.0f, task.quads);
+    task.buffer->begin(g_render_queue);
+    task.buffer->submit_sprite_run(WORLD_LAYER, task.quads, task.count, material);
+}
+
+// Queues `count` platforms, picked by `indices` or else the first ones. Their quads are written
+// in one pass into a single array in the frame arena, which the batch reads at flush time, and
+// go in as a single run rather than a command each. With --jobs and enough of them, each thread
+// writes and records an even share, and the buffers are merged back in order, so the queue ends
+// up just as if it had all been done here.
+void record_platforms(const int* indices, int count)
+{
+    if (count == 0) return;
+    SpriteQuad* quads = g_frame_arena.create_array<SpriteQuad>(count);
+
+    int thread_count = g_jobs->get_thread_count();
+    if (thread_count == 1 || count < PARALLEL_RECORD_MIN_SPRITES)
     {
-        g_game_state.player->move_right();
+        RenderMaterial material = Entity::write_sprite_quads(g_game_state.platforms, indices, 0, count, 1.0f, quads);
+        g_render_queue.submit_sprite_run(WORLD_LAYER, quads, count, material);
+        return;
     }
 
-    // This makes sure that the player can't move faster diagonally
-    if (glm::length(g_game_state.player->get_movement()) > 1.0f)
+    g_record_buffers.resize(thread_count);
+    g_record_tasks.resize(thread_count);
+    g_record_graph.clear();
+    for (int i = 0; i < thread_count; i++)
     {
-        g_game_state.player->set_movement(glm::normalize(g_game_state.player->get_movement()));
+        int first = (int)((long long)count * i / thread_count),
+            end   = (int)((long long)count * (i + 1) / thread_count);
+
+        g_record_tasks[i] = { &g_record_buffers[i], indices, first, end - first, quads + first };
+        g_record_graph.add(record_platforms_task, &g_record_tasks[i]);
     }
+    g_jobs->run(g_record_graph);
+
+    for (const RenderCommandBuffer& buffer : g_record_buffers) g_render_queue.merge(buffer);
 }
 
-void game_loop(float delta_time)
+// The batch path: only the platforms the broadphase puts in the view are queued at all
+void submit_visible_platforms(glm::vec2 view_min, glm::vec2 view_max)
 {
-    //  FIXED TIMESTEP  //
-    // STEP 1: Keep track of how much time has passed since last step
-    delta_time += g_time_accumulator;
-
-    // STEP 2: Accumulate the ammount of time passed while we're under our fixed timestep
-    if (delta_time < FIXED_TIMESTEP)
+    LevelSlot& slot = g_level_slots[g_level_slot];
+    if (g_game_state.platform_broadphase == NULL)
     {
-        g_time_accumulator = delta_time;
+        record_platforms(NULL, g_game_state.platform_count);
         return;
     }
 
-    // STEP 3: Once we exceed our fixed timestep, apply that elapsed time into the objects' update function invocation
-    while (delta_time >= FIXED_TIMESTEP)
+    g_visible_platforms.clear();
+    g_game_state.platform_broadphase->query(view_min, view_max, g_visible_platforms, slot.visible_cursor);
+    record_platforms(g_visible_platforms.data(), (int)g_visible_platforms.size());
+}
+
+// Only built where it can be drawn: without instancing, or for the render bench to compare against
+bool needs_baked_platforms()
+{
+    return g_bake_platforms && (!g_platform_renderer.is_supported() || g_render_bench_frames > 0);
+}
+
+// All of the slot's platforms into one static mesh. A platform that changes afterwards (a rock
+// that gets destroyed, say) is handed to g_baked_platforms.invalidate instead of a rebake.
+void bake_platforms()
+{
+    if (!needs_baked_platforms()) return;
+
+    const LevelSlot& slot = g_level_slots[g_level_slot];
+    g_baked_platforms.bake(slot.platforms, slot.platform_count, g_texture_atlas.get_texture_id());
+}
+
+// Platforms never move, so their instance data only goes up when they change. A new level gets a
+// new instance group; streamed chunks rewrite the existing one, which keeps its size. Every look
+// reads the same grey frame, so all of them are a single instance group.
+void upload_platforms(bool new_level)
+{
+    LevelSlot& slot = g_level_slots[g_level_slot];
+    dress_platforms(slot);
+    bake_platforms();
+
+    if (!g_platform_renderer.is_supported()) return;
+    if (new_level)
+    {
+        g_platform_renderer.clear_groups();
+        g_platform_renderer.add_group(g_platform_shader_program, g_texture_atlas.get_texture_id(), slot.instances);
+    }
+    else g_platform_renderer.update_group(0, slot.instances);
+}
+
+//  LEVEL EDITOR  //
+// The moved platform's instance, slid along the x-sorted run to where it goes now so culling still
+// holds. The instances it passed each shift over by one, and only that run is uploaded.
+void move_platform_instance(LevelSlot& slot, int platform)
+{
+    SpriteInstance instance = make_platform_instance(slot.platforms[platform]);
+    auto begin = slot.instances.begin();
+    auto before = [](const SpriteInstance& other, float x) { return other.offset.x < x; };
+
+    int from = slot.platform_instances[platform],
+        first = from,
+        last  = from;
+    bool rightward = instance.offset.x > slot.instances[from].offset.x;
+    if (rightward)
+    {
+        last = (int)(std::lower_bound(begin + from + 1, slot.instances.end(), instance.offset.x, before) - begin) - 1;
+        std::rotate(begin + from, begin + from + 1, begin + last + 1);
+        std::rotate(slot.instance_platforms.begin() + from, slot.instance_platforms.begin() + from + 1, slot.instance_platforms.begin() + last + 1);
+    }
+    else
     {
-        // Notice that we're using FIXED_TIMESTEP as our delta time
-        g_game_state.player->update(FIXED_TIMESTEP, g_game_state.platforms, PLATFORM_COUNT, g_win, g_loss);
-        delta_time -= FIXED_TIMESTEP;
+        first = (int)(std::lower_bound(begin, begin + from, instance.offset.x, before) - begin);
+        std::rotate(begin + first, begin + from, begin + from + 1);
+        std::rotate(slot.instance_platforms.begin() + first, slot.instance_platforms.begin() + from, slot.instance_platforms.begin() + from + 1);
     }
 
-    g_time_accumulator = delta_time;
+    slot.instances[rightward ? last : first] = instance;
+    for (int i = first; i <= last; i++) slot.platform_instances[slot.instance_platforms[i]] = i;
+    g_platform_renderer.upload_group_range(0, first, slot.instances.data() + first, last - first + 1);
 }
 
-void update()
+// --editor, once a frame before the simulation steps: the change set into the level, then into
+// everything drawn or scored from the platforms, a platform at a time
+void apply_level_edits()
 {
-    //  DELTA TIME  //
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND; // get the current number of ticks
-    float delta_time = ticks - g_previous_ticks; // the delta time is the difference from the last frame
-    g_previous_ticks = ticks;
+    LevelSlot& slot = g_level_slots[g_level_slot];
+    g_level_editor.apply(slot.platforms, slot.platform_colliders, &slot.platform_index, g_platform_moves);
 
-    if (!g_win && !g_loss)
+    for (const PlatformMove& move : g_platform_moves)
     {
-        game_loop(delta_time);
+        slot.landing_sites.update_platform(slot.platforms, slot.platform_count, &slot.platform_index, move.platform, move.from_min, move.from_max);
+        if (!slot.platform_instances.empty()) move_platform_instance(slot, move.platform);
+        if (g_baked_platforms.is_baked()) g_baked_platforms.invalidate(move.platform);
+        g_minimap.invalidate_region(move.from_min, move.from_max);
+        g_minimap.invalidate_region(move.to_min, move.to_max);
+
+        // So replaying the level starts it as edited
+        if (g_level_snapshot_saved) g_level_snapshot.platforms.data()[move.platform] = make_collider_box(slot.platforms[move.platform]);
     }
 }
 
-void render()
+// The world point under a spot in the window, through the camera the last frame drew with
+glm::vec2 window_to_world(int x, int y)
 {
-    //  GENERAL  //
-    glClear(GL_COLOR_BUFFER_BIT);
+    int width, height;
+    SDL_GetWindowSize(g_display_window, &width, &height);
+
+    glm::vec4 clip = glm::vec4(2.0f * ((float)x + 0.5f) / (float)width - 1.0f, 1.0f - 2.0f * ((float)y + 0.5f) / (float)height, 0.0f, 1.0f);
+    return glm::vec2(glm::inverse(g_projection_matrix * g_view_matrix) * clip);
+}
+
+// The CPU half of a level: entities and collision structures, all out of the slot's arena.
+// Touches neither GL, the atlas nor g_game_state, so levels can be generated on other threads.
+// A tuning file's lander values over the gameplay module's, with the lander where it is
+void tune_lander(Entity& lander)
+{
+    if (g_tuning.get_version() > 0) apply_lander_tuning(lander, g_tuning.get().lander);
+}
+
+// A tuning file's world values. The step budget and gravity are read as they're used; the timestep
+// and the platform count reach the next level, since a level's replay is taken at the timestep it
+// started with. Ghosts fly their own scene.
+void apply_world_tuning()
+{
+    if (g_tuning.get_version() == 0) return;  // never read, or never parsed
+
+    const Tuning& tuning = g_tuning.get();
+    g_simulation_timestep = tuning.world.fixed_timestep;
+    if (tuning.world.platform_count > 0 && !g_ghosts.has_ghosts()) g_scene.platform_count = tuning.world.platform_count;
+    g_game_state.budget.max_steps_per_frame = tuning.world.max_steps_per_frame;
+    g_game_state.gravity = tuning.lander.gravity;
+}
+
+// Playing with others, who decide between them when a level starts over
+bool is_online()
+{
+    return g_net_client.is_connected() || g_versus_peer.is_connected();
+}
+
+// Timing something in a hidden window and quitting, rather than playing
+bool is_benchmarking()
+{
+    return g_render_bench_frames > 0 || g_observation_bench_envs > 0 || g_gpu_sim_bench_landers > 0;
+}
+
+// A generated scene, re-rolled onto another seed while the reference pilot can hardly land on it.
+// Seeds someone else chose (a server's, a peer's, the ghosts') and the benchmarks' are kept as
+// they are.
+void generate_level(LevelSlot& slot, unsigned int seed)
+{
+    const GameplayApi& api = g_gameplay.get_api();
+    if (g_min_win_chance <= 0.0f || is_online() || g_ghosts.has_ghosts() || is_benchmarking())
+    {
+        api.generate_scene(slot.platforms, g_scene, seed);
+        return;
+    }
 
+    // One per thread, since the prefetch worker generates levels too
+    thread_local DifficultyEstimator estimator;
+    LevelCheck check;
+    check.min_win_probability = g_min_win_chance;
+    check.budget_seconds = LEVEL_CHECK_SECONDS;
+
+    Entity prototype = *slot.player;
+    tune_lander(prototype);
+
+    DifficultyEstimate estimate;
+    slot.seed = generate_winnable_scene(estimator, slot.platforms, g_scene, seed, prototype, g_game_state.spawn_position,
+                                        g_game_state.gravity, check, api.generate_scene, &estimate);
+    if (slot.seed != seed) LOG("Re-rolled level " << seed << " as " << slot.seed << ": " << (int)(100.0f * estimate.get_win_probability()) << "% winnable");
+}
+
+void prepare_level(LevelSlot& slot, unsigned int seed)
+{
     //  PLAYER  //
-    g_game_state.player->render(&g_shader_program);
+    slot.seed = seed;
+    slot.player = slot.arena.create<Entity>();
+    g_gameplay.get_api().setup_player(slot.player);
+
+    // BOOSTER LEVELS
+    // The clips are g_animations'; the player only keeps which one is playing
+    slot.player->m_booster_clip = g_booster_clip;
+    slot.player->m_animator = Animator();
+    slot.player->m_animator.play(g_booster_clip + Entity::IDLE);
+    slot.player->m_animation_cols = 3;
+    slot.player->m_animation_rows = 1;
+    slot.player->m_frame_uv_rects = g_ship_frames;
+
 
     //  PLATFORM  //
-    for (int i = 0; i < PLATFORM_COUNT; i++) g_game_state.platforms[i].render(&g_shader_program);
+    // A level file is read straight out of its mapping; an endless course keeps its own fixed
+    // window of platforms; anything else is one generated scene
+    if (g_level_file.is_open())
+    {
+        slot.platform_count = g_level_file.get_platform_count();
+        slot.platforms = slot.arena.create_array<Entity>(slot.platform_count);
+        load_level_platforms(g_level_file, slot.platforms);
+        load_level_terrain(g_level_file, g_level_terrain);
+        if (g_use_distance_field) bake_level_field();
+    }
+    else if (g_endless)
+    {
+        g_level_streamer.begin(seed, g_game_state.spawn_position.x);
+        slot.platform_count = g_level_streamer.get_platform_count();
+        slot.platforms = g_level_streamer.get_platforms();
+    }
+    else
+    {
+        slot.platform_count = g_scene.platform_count;
+        slot.platforms = slot.arena.create_array<Entity>(slot.platform_count);
+        generate_level(slot, seed);
+    }
+    build_platform_colliders(slot);
+}
 
-    //  TEXT  //
-    if (g_win) draw_text(&g_shader_program, g_text_texture_id, std::string("YOU LANDED SAFELY!"), 0.25f, 0.f, glm::vec3(-1.75f, 2.0f, 0.0f));
-    if (g_loss) draw_text(&g_shader_program, g_text_texture_id, std::string("YOU CRASHED!"), 0.25f, 0.01f, glm::vec3(-1.25f, 2.0f, 0.0f));
+// Makes a prepared slot the level being played: points the simulation at it and puts the player
+// on the spawn point. Main thread.
+void enter_level(int slot_index)
+{
+    g_level_slot = slot_index;
+    LevelSlot& slot = g_level_slots[slot_index];
+
+    if (g_level_file.is_open()) g_game_state.spawn_position = glm::vec3(g_level_file.get_spawn(), 0.0f);
+
+    g_game_state.player = slot.player;
+    g_game_state.platforms = slot.platforms;
+    g_game_state.platform_count = slot.platform_count;
+    g_game_state.platform_broadphase = &slot.platform_index;
+    g_game_state.platform_colliders = &slot.platform_colliders;
+    g_game_state.landing_sites = &slot.landing_sites;
+    g_game_state.events = &g_events;
+    g_minimap.invalidate();  // the other slot's colliders can be on the same version
+    g_level_editor.reset();
+    g_texture_streamer.clear();  // placed by the level being left
+    bool has_terrain = g_level_file.is_open() && g_level_file.has_terrain();
+    g_game_state.terrain = has_terrain && !g_use_distance_field ? &g_level_terrain : NULL;
+    g_game_state.distance_field = has_terrain && g_use_distance_field && g_level_field.is_baked() ? &g_level_field : NULL;
+    if (g_craters) g_terrain_editor.attach(has_terrain ? &g_level_terrain : NULL, g_game_state.distance_field != NULL ? &g_level_field : NULL);
+
+    reset_episode(g_game_state);
+    if (g_gameplay.is_loaded()) g_gameplay.get_api().retune_lander(*g_game_state.player);  // its gravity over reset_episode's
+    tune_lander(*g_game_state.player);
+    g_game_state.fixed_timestep = g_net_client.is_connected() ? g_net_client.get_welcome().fixed_timestep : g_simulation_timestep;
+    g_game_state.timings.enabled = true;  // for the collision / integration split on the overlay
+    if (g_ghosts.has_ghosts()) g_ghosts.restart(g_game_state, g_scene, slot.seed);
+    if (g_policy_fleet.is_loaded()) g_policy_fleet.restart(g_game_state);
+
+    g_camera.snap_to(glm::vec2(g_game_state.spawn_position.x, 0.0f));
+
+    g_level_seed = slot.seed;
+    g_replay.begin(g_scene, slot.seed, g_simulation_timestep);
+    g_rewind.clear();
+}
 
-    //  GENERAL  //
-    SDL_GL_SwapWindow(g_display_window);
+// The GL half: atlas frames for every entity and the platform instances. Needs the atlas built.
+// A prefetched level arrives with its instances already uploaded.
+void finish_level(bool upload = true)
+{
+    g_game_state.player->m_texture_id = g_texture_atlas.get_texture_id();
+    g_game_state.player->m_uv_rect = g_texture_atlas.get_region(g_ship_region).uv_rect;
+    g_game_state.player->m_material = get_atlas_material(g_ship_region);
+    g_game_state.player->m_frame_array_id = g_ship_frame_array;
+
+    if (upload) upload_platforms(true);
+    else        bake_platforms();  // the worker only dressed them
+    if (g_backdrop) build_backdrop(g_level_seed);
+
+    // A snapshot only holds the platforms as they were, which an endless course won't keep
+    g_level_snapshot_saved = !g_endless && save_snapshot(g_game_state, g_level_snapshot);
+}
+
+// Everything built here comes out of the slot's arena, so a restart is an arena reset plus this
+void load_level(unsigned int seed)
+{
+    prepare_level(g_level_slots[g_level_slot], seed);
+    enter_level(g_level_slot);
+    finish_level();
 }
 
-void shutdown() { SDL_Quit(); }
+// Generates the next level into the other slot while this one is played. Only generated scenes
+// change from one level to the next, and the benchmarks want no second thread in their timings.
+void start_prefetch()
+{
+    if (g_endless || g_level_file.is_open() || is_online() || is_benchmarking()) return;
+
+    LevelSlot* next = &g_level_slots[1 - g_level_slot];
+    unsigned int seed = std::random_device{}();
+
+    g_prefetch_uploaded = -1;
+    g_prefetch = std::async(std::launch::async, [next, seed]()
+        {
+            TRACE_ZONE("prefetch level");
+            MemoryScope memory(MEMORY_ENTITIES);
+
+            // Whatever was in the slot was the level before last, which nothing points at any more
+            next->arena.reset();
+            prepare_level(*next, seed);
+            dress_platforms(*next);
+        });
+}
 
-//  DRIVER GAME LOOP  /
-int main(int argc, char* argv[])
+// GL thread, once a frame. Once the worker is done, the next level's instances go up at most
+// max_instances at a time, so even a huge level never lands in a single frame.
+void upload_prefetched_level(int max_instances)
 {
-    initialise();
+    if (!g_prefetch.valid() || !g_next_platform_renderer.is_supported()) return;
+    if (g_prefetch.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+
+    const LevelSlot& next = g_level_slots[1 - g_level_slot];
+    int instance_count = (int)next.instances.size();
 
-    while (g_game_is_running)
+    if (g_prefetch_uploaded < 0)
     {
-        process_input();
-        update();
+        g_next_platform_renderer.clear_groups();
+        g_next_platform_renderer.reserve_group(g_platform_shader_program, g_texture_atlas.get_texture_id(), instance_count);
+        g_prefetch_uploaded = 0;
+    }
+
+    int slice = std::min(max_instances, instance_count - g_prefetch_uploaded);
+    if (slice <= 0) return;
+
+    g_next_platform_renderer.upload_group_range(0, g_prefetch_uploaded, next.instances.data() + g_prefetch_uploaded, slice);
+    g_prefetch_uploaded += slice;
+}
+
+// Same level again: the simulation state is copied back in place, and the GL side (textures, the
+// platform instances, shaders) is untouched since nothing it drew from has changed
+void replay_level()
+{
+    // Platforms never move, so a scene too big to snapshot only needs its player put back. An
+    // endless course has to stream its first chunks back in as well.
+    g_terrain_editor.restore();
+    if (g_level_snapshot_saved) restore_snapshot(g_game_state, g_level_snapshot);
+    else                        reset_episode(g_game_state);
+    if (g_gameplay.is_loaded()) g_gameplay.get_api().retune_lander(*g_game_state.player);  // the snapshot's tuning may be a version old
+    tune_lander(*g_game_state.player);
+
+    if (g_endless)
+    {
+        g_level_streamer.begin(g_level_seed, g_game_state.player->get_position().x);
+        build_platform_colliders(g_level_slots[g_level_slot]);
+        upload_platforms(false);
+    }
+    g_camera.snap_to(glm::vec2(g_game_state.spawn_position.x, 0.0f));
+
+    g_replay.begin(g_scene, g_level_seed, g_simulation_timestep);
+    g_rewind.clear();
+    if (g_ghosts.has_ghosts()) g_ghosts.restart(g_game_state, g_scene, g_level_seed);
+    if (g_policy_fleet.is_loaded()) g_policy_fleet.restart(g_game_state);
+}
+
+void restart_level()
+{
+    // Without a prefetch (endless, a level file) the level is generated here and now
+    if (!g_prefetch.valid())
+    {
+        g_level_slots[g_level_slot].arena.reset();
+        load_level(std::random_device{}());
+        return;
+    }
+
+    // Only blocks when asked for before the worker is done; whatever upload is left goes in one go
+    g_prefetch.get();
+    upload_prefetched_level(INT_MAX);
+
+    std::swap(g_platform_renderer, g_next_platform_renderer);
+    enter_level(1 - g_level_slot);
+    finish_level(false);
+
+    start_prefetch();
+}
+
+//  AUDIO  //
+// On SDL's audio thread
+void SDLCALL mix_audio(void* user_data, Uint8* stream, int length)
+{
+    ((AudioMixer*)user_data)->mix((float*)stream, length / (int)sizeof(float));
+}
+
+// A WAV from disk, converted to the mixer's mono floats at its rate; `synthesize`'s sound if there isn't one
+std::vector<float> load_sound(const char* filepath, int sample_rate, std::vector<float> (*synthesize)(int))
+{
+    SDL_AudioSpec spec;
+    Uint8* buffer;
+    Uint32 length;
+    if (SDL_LoadWAV(filepath, &spec, &buffer, &length) == NULL) return synthesize(sample_rate);
+
+    SDL_AudioCVT cvt;
+    if (SDL_BuildAudioCVT(&cvt, spec.format, spec.channels, spec.freq, AUDIO_F32SYS, 1, sample_rate) < 0)
+    {
+        LOG("Unable to convert " << filepath << ": " << SDL_GetError());
+        SDL_FreeWAV(buffer);
+        return synthesize(sample_rate);
+    }
+
+    std::vector<Uint8> converted(length * cvt.len_mult);
+    std::memcpy(converted.data(), buffer, length);
+    SDL_FreeWAV(buffer);
+
+    cvt.buf = converted.data();
+    cvt.len = (int)length;
+    SDL_ConvertAudio(&cvt);
+
+    std::vector<float> samples(cvt.len_cvt / sizeof(float));
+    std::memcpy(samples.data(), converted.data(), samples.size() * sizeof(float));
+    return samples;
+}
+
+// Sound is optional: without an audio device the game carries on silently
+void open_audio()
+{
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
+    {
+        LOG("No audio: " << SDL_GetError());
+        return;
+    }
+
+    SDL_AudioSpec wanted = {}, obtained;
+    wanted.freq     = AUDIO_SAMPLE_RATE;
+    wanted.format   = AUDIO_F32SYS;
+    wanted.channels = 1;
+    wanted.samples  = AUDIO_BUFFER_FRAMES;
+    wanted.callback = mix_audio;
+    wanted.userdata = &g_audio;
+
+    // SDL converts to whatever the device really takes, except the rate, which the banks are built at
+    SDL_AudioDeviceID device = SDL_OpenAudioDevice(NULL, 0, &wanted, &obtained, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (device == 0)
+    {
+        LOG("No audio device: " << SDL_GetError());
+        return;
+    }
+
+    // Every bank is decoded before the callback can run, so the mixer never waits on one
+    g_audio.set_sample_rate(obtained.freq);
+    g_thrust_bank = g_audio.add_bank(load_sound(THRUST_SOUND_FILEPATH, obtained.freq, synthesize_thrust));
+    g_thud_bank   = g_audio.add_bank(load_sound(THUD_SOUND_FILEPATH, obtained.freq, synthesize_thud));
+    g_chime_bank  = g_audio.add_bank(load_sound(CHIME_SOUND_FILEPATH, obtained.freq, synthesize_chime));
+    g_crash_bank  = g_audio.add_bank(load_sound(CRASH_SOUND_FILEPATH, obtained.freq, synthesize_crash));
+
+    // The thruster loops from the start, silent until the booster turns it up
+    g_audio.play(THRUST_VOICE, g_thrust_bank, 0.0f, true);
+    g_thrust_gain = 0.0f;
+
+    g_audio_device = device;
+    SDL_PauseAudioDevice(g_audio_device, 0);
+}
+
+void play_sound(AudioVoice voice, int bank)
+{
+    if (g_audio_device != 0) g_audio.play(voice, bank);
+}
+
+// Game thread, once a frame: only changes go down the command queue
+void update_thrust_sound(bool boosting)
+{
+    float gain = boosting ? THRUST_GAIN : 0.0f;
+    if (g_audio_device != 0 && gain != g_thrust_gain && g_audio.set_gain(THRUST_VOICE, gain)) g_thrust_gain = gain;
+}
+
+// Only quitting works while loading; there is no player to steer yet, but whatever's held (and
+// any controller plugged in) is kept track of for when there is
+void process_loading_input()
+{
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        g_input.handle_event(event);
+        if (event.type == SDL_QUIT) g_game_is_running = false;
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_q) g_game_is_running = false;
+    }
+}
+
+// The splash: a progress bar out of three scissored clears, so it needs nothing but the context
+void render_loading()
+{
+    int left   = VIEWPORT_X + (g_viewport_width - LOADING_BAR_WIDTH) / 2,
+        bottom = VIEWPORT_Y + (g_viewport_height - LOADING_BAR_HEIGHT) / 2,
+        inset  = 2 * LOADING_BAR_BORDER,
+        filled = (int)((LOADING_BAR_WIDTH - 2 * inset) * g_loading.get_progress());
+
+    glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glEnable(GL_SCISSOR_TEST);
+
+    // Outline, then hollow it out, then the filled part inside a gap of background
+    glClearColor(LOADING_BAR_RED, LOADING_BAR_GREEN, LOADING_BAR_BLUE, BG_OPACITY);
+    glScissor(left, bottom, LOADING_BAR_WIDTH, LOADING_BAR_HEIGHT);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+    glScissor(left + LOADING_BAR_BORDER, bottom + LOADING_BAR_BORDER,
+              LOADING_BAR_WIDTH - 2 * LOADING_BAR_BORDER, LOADING_BAR_HEIGHT - 2 * LOADING_BAR_BORDER);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (filled > 0)
+    {
+        glClearColor(LOADING_BAR_RED, LOADING_BAR_GREEN, LOADING_BAR_BLUE, BG_OPACITY);
+        glScissor(left + inset, bottom + inset, filled, LOADING_BAR_HEIGHT - 2 * inset);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(BG_RED, BG_GREEN, BG_BLUE, BG_OPACITY);
+
+    SDL_GL_SwapWindow(g_display_window);
+}
+
+// The booster's IDLE, LOW and HIGH clips, one after another, on the ship sheet's frames in the
+// same order. Needed before the first level is prepared, which can be on another thread.
+void build_animation_clips()
+{
+    const int   idle[] = { Entity::IDLE },
+                low[]  = { Entity::LOW },
+                high[] = { Entity::HIGH, Entity::LOW };
+    const float high_durations[] = { BOOSTER_HIGH_SECONDS, BOOSTER_FLICKER_SECONDS };
+
+    g_booster_clip = g_animations.add_clip(idle, 1, 0.0f, ANIMATION_LOOP);
+    g_animations.add_clip(low, 1, 0.0f, ANIMATION_LOOP);
+    g_animations.add_clip(high, high_durations, 2, ANIMATION_LOOP);
+}
+
+// Everything after context creation, in dependency order. GL work has to stay on this thread, so
+// shaders and uploads are main-thread steps, spread over the splash frames by their budget; image
+// decoding and generating the first level only need the CPU and run beside each other.
+void queue_loading_steps()
+{
+    g_loading.set_profiler(&g_startup_profiler);
+    build_animation_clips();
+
+    //  SHADERS  //
+    // Every program is a permutation of the one sprite shader, each with only the features it uses
+    g_loading.add_step("sprite shader", 2.0f, []()
+        {
+            MemoryScope memory(MEMORY_RENDER);
+            g_sprite_shaders.initialise(EmbeddedShaders::SPRITE_VERTEX, EmbeddedShaders::SPRITE_FRAGMENT);
+            g_startup_profiler.add_bytes(EmbeddedShaders::SPRITE_VERTEX.source.size() + EmbeddedShaders::SPRITE_FRAGMENT.source.size());
+
+            g_view_matrix = glm::mat4(1.0f);
+            float half_width = VIEW_HALF_HEIGHT * (float)g_viewport_width / (float)g_viewport_height;
+            g_projection_matrix = glm::ortho(-half_width, half_width, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
+
+            g_sprite_shaders.set_camera(g_projection_matrix, g_view_matrix);
+
+            g_shader_program = g_sprite_shaders.get(SHADER_TEXTURED);
+            g_text_shader_program = g_sprite_shaders.get(SHADER_TEXTURED | SHADER_SDF);
+            g_batch_shader_program = g_sprite_shaders.get(SHADER_TEXTURED | SHADER_GLYPHS);
+            g_queued_text_program = g_separate_text ? g_text_shader_program : g_batch_shader_program;
+        });
+
+    g_loading.add_step("instanced shader", 2.0f, []()
+        {
+            MemoryScope memory(MEMORY_RENDER);
+            g_instanced_shader_program = g_sprite_shaders.get(SHADER_TEXTURED | SHADER_INSTANCED);
+            g_platform_shader_program = g_sprite_shaders.get(SHADER_TEXTURED | SHADER_INSTANCED | SHADER_MATERIAL);
+            if (g_show_trajectory) g_flat_shader_program = g_sprite_shaders.get(0);
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+            g_debug_line_program = g_sprite_shaders.get(SHADER_VERTEX_COLOUR);
+#endif
+        });
+
+    g_loading.add_step("starfield shader", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_RENDER);
+            if (g_starfield_enabled) g_starfield.initialise();
+        });
+
+    g_loading.add_step("renderers", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_RENDER);
+            g_shader_program->use();
+
+            g_frame_arena.initialise(FRAME_ARENA_SIZE);
+            g_sprite_batch.initialise(g_batch_shader_program, &g_frame_arena);
+            g_render_queue.initialise(g_batch_shader_program, &g_sprite_batch, &g_text_meshes, &g_frame_arena);
+
+            g_gpu_profiler.initialise();
+            g_render_queue.set_gpu_profiler(&g_gpu_profiler);
+            g_render_queue.set_texture_cache(&g_texture_cache);
+            if (g_show_trajectory) g_trajectory.initialise();
+            if (!g_minimap.initialise(&g_sprite_shaders, MINIMAP_WIDTH, MINIMAP_HEIGHT)) g_show_minimap = false;
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+            get_debug_draw().initialise();
+#endif
+
+            // Steered by the GPU's frame time, so the profiler runs for as long as it does. The
+            // governor caps the resolution through it too, and still can without the timings.
+            bool benching = is_benchmarking(),
+                 governed = g_governor_enabled && !benching;
+            if (governed) g_governor.initialise(QUALITY_BUDGET_MS);
+            if ((g_dynamic_resolution_enabled || governed) && !benching)
+            {
+                if ((g_gpu_profiler.is_supported() || governed) && g_dynamic_resolution.initialise(g_viewport_width, g_viewport_height, DYNAMIC_RESOLUTION_BUDGET_MS))
+                {
+                    g_gpu_profiler.set_enabled(g_gpu_profiler.is_supported());
+                }
+                else LOG("No timer queries or framebuffer objects here, rendering at full resolution");
+            }
+            if (g_post_effects != 0 && !is_benchmarking() &&
+                !g_post_process.initialise(g_viewport_width, g_viewport_height, g_post_effects, !g_post_unmerged))
+            {
+                LOG("No framebuffer objects here, drawing without post-processing");
+            }
+            if (g_lighting_enabled && !is_benchmarking() && !g_lighting.initialise())
+            {
+                LOG("No framebuffer objects or min blending here, drawing without lights");
+            }
+            if (g_frame_arrays && supports_texture_arrays()) g_render_queue.set_layered_program(g_sprite_shaders.get(SHADER_TEXTURED | SHADER_LAYERED));
+
+            // Cutout sprites discard their empty texels rather than blending them away
+            g_render_queue.set_cutout_programs(g_sprite_shaders.get(SHADER_TEXTURED | SHADER_ALPHA_TEST),
+                                               g_frame_arrays && supports_texture_arrays() ? g_sprite_shaders.get(SHADER_TEXTURED | SHADER_LAYERED | SHADER_ALPHA_TEST) : NULL);
+
+            g_platform_renderer.initialise(g_platform_shader_program);
+            g_next_platform_renderer.initialise(g_platform_shader_program);
+
+            g_frame_capture.initialise(g_viewport_width, g_viewport_height, CAPTURE_DIRECTORY, g_capture_format);
+            if (!g_frame_capture.is_asynchronous()) LOG("No fences or pixel buffer objects here: screenshots only, and they stall");
+            if (g_record_from_start && !g_frame_capture.start_recording()) LOG("Unable to record into " << CAPTURE_DIRECTORY);
+        });
+
+    //  TEXTURE ATLAS  //
+    // Every sheet goes into one page so the whole scene, text included, draws under a single texture.
+    // The pack is optional: without it every image is decoded from its PNG.
+    g_loading.add_step("asset pack", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_ASSETS);
+#ifdef __EMSCRIPTEN__
+            // Nothing to map in a browser: the pack downloads over the next frames, and the decode
+            // below waits for each image's bytes rather than the whole file
+            if (!g_asset_pack.fetch(ASSET_PACK_FILEPATH)) LOG("Unable to fetch " << ASSET_PACK_FILEPATH);
+#else
+            if (!g_asset_pack.open(ASSET_PACK_FILEPATH)) LOG("No asset pack at " << ASSET_PACK_FILEPATH << ", decoding PNGs");
+            else g_startup_profiler.add_bytes(g_asset_pack.get_size());
+#endif
+
+            g_texture_cache.set_asset_pack(&g_asset_pack);
+
+            // Standalone sheets from load_texture() decode in the background and show a placeholder until then
+            g_texture_loader.initialise();
+            g_texture_cache.set_texture_loader(&g_texture_loader);
+            g_texture_cache.set_generate_mipmaps(true);
+            g_texture_cache.set_vram_budget((long long)(g_texture_budget_mb * BYTES_PER_MB));
+            g_texture_streamer.initialise(&g_texture_cache, &g_asset_pack);
+        });
+
+    g_loading.add_background_step("decode images", 4.0f, []()
+        {
+            MemoryScope memory(MEMORY_ASSETS);
+            unsigned long long bytes_read = 0;
+            g_ship_region  = add_atlas_image(SPRITESHEET_ASSET, bytes_read);
+            g_death_region = add_atlas_image(DEATH_PLATFORM_ASSET, bytes_read);
+            g_win_region   = add_atlas_image(WIN_PLATFORM_ASSET, bytes_read);
+            g_platform_region = add_atlas_image(PLATFORM_BASE_ASSET, bytes_read);
+            g_font_region  = add_atlas_image(FONT_SPRITE_ASSET, bytes_read);
+
+            // The sheet and its metrics are built together, so a packed sheet always has them
+            if (!g_font_metrics.load(FONT_METRICS_FILEPATH)) g_font_metrics.make_grid();
+            build_platform_materials();
+            return bytes_read;
+        });
+
+    //  LEVEL  //
+    g_loading.add_background_step("level generation", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_ENTITIES);
+            for (LevelSlot& slot : g_level_slots) slot.arena.initialise();
+            unsigned int seed = is_benchmarking() ? RENDER_BENCH_SEED : std::random_device{}();
+            if (g_net_client.is_connected()) seed = g_net_client.get_welcome().seed;
+            if (g_versus_peer.is_connected()) seed = g_versus_peer.get_seed();
+            if (g_ghosts.has_ghosts()) seed = g_ghosts.get_best_seed();
+            prepare_level(g_level_slots[g_level_slot], seed);
+            return 0ull;
+        });
+
+    g_loading.add_step("atlas build and upload", 3.0f, []()
+        {
+            MemoryScope memory(MEMORY_ASSETS);
+            g_texture_atlas.build(ATLAS_PADDING, true);
+            g_startup_profiler.add_bytes((unsigned long long)g_texture_atlas.get_width() * g_texture_atlas.get_height() * 4);
+            map_sheet(SHIP_SHEET, g_texture_atlas.get_region(g_ship_region).uv_rect, g_ship_frames);
+            if (g_ghosts.has_ghosts())
+            {
+                g_ghosts.initialise(g_sprite_shaders.get(SHADER_TEXTURED | SHADER_INSTANCED | SHADER_TINTED), g_texture_atlas.get_texture_id(), g_ship_frames);
+            }
+            if (g_policy_fleet.is_loaded())
+            {
+                g_policy_fleet.initialise(g_sprite_shaders.get(SHADER_TEXTURED | SHADER_INSTANCED | SHADER_TINTED), g_texture_atlas.get_texture_id(), g_ship_frames);
+            }
+
+            if (g_frame_arrays) g_ship_frame_array = load_frame_array(SPRITESHEET_ASSET, SHIP_SHEET);
+            if (g_frame_arrays && g_ship_frame_array == 0) LOG("No texture arrays here, drawing the ship from the atlas");
+        });
+
+    g_loading.add_step("level instances", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_ENTITIES);
+            enter_level(g_level_slot);
+            finish_level();
+            start_prefetch();
+
+            // The other players look just like this one
+            if (g_net_client.is_connected())
+            {
+                for (Entity& lander : g_remote_landers) lander = *g_game_state.player;
+            }
+
+            // Head to head, the other player is a second lander in this simulation, rolled back
+            // along with this one
+            if (g_versus_peer.is_connected())
+            {
+                g_versus_lander = *g_game_state.player;
+                g_game_state.landers = &g_versus_lander;
+                g_game_state.lander_outcomes = &g_versus_outcome;
+                g_game_state.lander_count = 1;
+                reset_episode(g_game_state);
+                g_rollback.begin(g_game_state, 2, 0);
+            }
+        });
+
+    //  TEXT  //
+    g_loading.add_step("text and exhaust", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_TEXT);
+            g_text_meshes.initialise(g_texture_atlas.get_texture_id(), g_texture_atlas.get_region(g_font_region).uv_rect, g_font_metrics);
+
+            // The font is on the atlas page with the sprites, so its glyphs go into the same batch
+            if (!g_separate_text) g_render_queue.set_glyph_batching(g_text_meshes.get_font_texture_id());
+
+            g_glyph_cache.initialise();
+            if (!g_glyph_cache.load_hex_font(GLYPH_FONT_FILEPATH)) LOG("No glyphs at " << GLYPH_FONT_FILEPATH << ", drawing characters past ASCII as boxes");
+            g_text_meshes.set_glyph_cache(&g_glyph_cache);
+
+            g_overlay_text.initialise(g_texture_atlas.get_texture_id(), g_texture_atlas.get_region(g_font_region).uv_rect, g_font_metrics);
+
+            g_telemetry.initialise(g_texture_atlas.get_texture_id(), g_texture_atlas.get_region(g_font_region).uv_rect, g_font_metrics, TELEMETRY_TEXT_SIZE, 0.0f);
+            g_telemetry.add_field("ALT   ", TELEMETRY_VALUE_WIDTH, 1);
+            g_telemetry.add_field("V-SPD ", TELEMETRY_VALUE_WIDTH, 2);
+            g_telemetry.add_field("H-SPD ", TELEMETRY_VALUE_WIDTH, 2);
+            g_telemetry.add_field("FUEL  ", TELEMETRY_VALUE_WIDTH, 1);
+            g_telemetry.add_field("SCORE ", TELEMETRY_VALUE_WIDTH, 0);
+
+            //  EXHAUST  //
+            MemoryScope exhaust_memory(MEMORY_RENDER);
+            g_exhaust.initialise(g_instanced_shader_program, g_texture_atlas.get_texture_id(), g_text_meshes.get_glyph_uv_rect(EXHAUST_GLYPH));
+            g_debris.initialise(g_instanced_shader_program, g_texture_atlas.get_texture_id(), g_text_meshes.get_glyph_uv_rect(EXHAUST_GLYPH));
+            g_lander_node = g_attachments.add_node(SceneGraph::NO_PARENT);
+            g_nozzle_node = g_attachments.add_node(g_lander_node);
+        });
+
+    //  WARM-UP  //
+    // Every pipeline the game can draw with gets its first draw here, behind the splash, rather
+    // than in the frame where it's first needed
+    g_loading.add_step("pipeline warm-up", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_RENDER);
+            PipelineWarmup warmup;
+            warmup.initialise(get_render_backend());
+
+            g_render_queue.warm_up(warmup);
+            g_text_meshes.warm_up(warmup, g_text_shader_program);
+            if (g_queued_text_program != g_text_shader_program) g_text_meshes.warm_up(warmup, g_queued_text_program);
+            g_starfield.warm_up(warmup);
+            g_post_process.warm_up(warmup);
+            g_lighting.warm_up(warmup);
+
+            LOG("Warmed up " << warmup.get_pipeline_count() << " pipelines in " << warmup.get_draw_count() << " draws");
+            warmup.cleanup();
+        });
+
+//  AUDIO  //
+    g_loading.add_step("audio", 1.0f, []()
+        {
+            MemoryScope memory(MEMORY_AUDIO);
+            if (g_audio_enabled) open_audio();
+        });
+}
+
+bool parse_display_mode(std::string_view name, DisplayMode& mode)
+{
+    if      (name == "windowed")   mode = DISPLAY_WINDOWED;
+    else if (name == "borderless") mode = DISPLAY_BORDERLESS;
+    else if (name == "exclusive")  mode = DISPLAY_EXCLUSIVE;
+    else return false;
+    return true;
+}
+
+void initialise()
+{
+    StartupProfiler::Scope initialise_phase(g_startup_profiler, "initialise");
+
+    {
+        StartupProfiler::Scope phase(g_startup_profiler, "SDL_Init");
+        SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER);
+    }
+
+    {
+        StartupProfiler::Scope phase(g_startup_profiler, "window and GL context");
+        // Fullscreen is at the desktop's mode, so exclusive doesn't switch the display's resolution
+        // or refresh rate. Benchmarks stay in their hidden window.
+        SDL_DisplayMode native;
+        bool fullscreen = g_display_mode != DISPLAY_WINDOWED && !is_benchmarking() && SDL_GetDesktopDisplayMode(0, &native) == 0;
+        Uint32 window_flags = SDL_WINDOW_OPENGL | (is_benchmarking() ? SDL_WINDOW_HIDDEN : 0);
+        if (fullscreen) window_flags |= g_display_mode == DISPLAY_EXCLUSIVE ? SDL_WINDOW_FULLSCREEN : SDL_WINDOW_FULLSCREEN_DESKTOP;
+
+        g_display_window = SDL_CreateWindow("Lunar Lander",
+            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+            fullscreen ? native.w : WINDOW_WIDTH, fullscreen ? native.h : WINDOW_HEIGHT,
+            window_flags);
+        if (fullscreen && g_display_mode == DISPLAY_EXCLUSIVE) SDL_SetWindowDisplayMode(g_display_window, &native);
+
+        // A core context has no client-side arrays, no default VAO and only #version 330 shaders;
+        // everything draws from VAOs and buffers there, and ShaderProgram translates the GLSL.
+        // Drivers without one hand back NULL, and the window gets the usual context instead.
+        SDL_GLContext context = NULL;
+#ifdef __EMSCRIPTEN__
+        // The browser only has WebGL: ES 3.0 gets WebGL 2, with instancing and VAOs built in, and
+        // ES 2.0 WebGL 1 where that's all there is. Both take the GLES path through ShaderProgram.
+        g_gles2 = true;
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+        for (int major_version = 3; major_version >= 2 && context == NULL; major_version--)
+        {
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, major_version);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+            context = SDL_GL_CreateContext(g_display_window);
+        }
+#elif !defined(__APPLE__)
+        if (g_gles2)
+        {
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 2);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
+            context = SDL_GL_CreateContext(g_display_window);
+
+            if (context == NULL)
+            {
+                LOG("No OpenGL ES 2.0 (" << SDL_GetError() << "); using the desktop context");
+                SDL_GL_ResetAttributes();
+            }
+        }
+        if (context == NULL && g_core_profile)
+        {
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+            SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+            context = SDL_GL_CreateContext(g_display_window);
+
+            if (context == NULL)
+            {
+                LOG("No OpenGL 3.3 core profile (" << SDL_GetError() << "); using the compatibility one");
+                SDL_GL_ResetAttributes();
+            }
+        }
+#endif
+        if (context == NULL) context = SDL_GL_CreateContext(g_display_window);
+        SDL_GL_MakeCurrent(g_display_window, context);
+
+        // Everything drawn to the window is sized from this, and the view widens to its shape
+        SDL_GL_GetDrawableSize(g_display_window, &g_viewport_width, &g_viewport_height);
+        if (fullscreen) LOG("Fullscreen " << (g_display_mode == DISPLAY_EXCLUSIVE ? "exclusive" : "borderless") << " at "
+                            << g_viewport_width << "x" << g_viewport_height << ", " << native.refresh_rate << " Hz");
+    }
+
+#ifdef _WINDOWS
+    {
+        StartupProfiler::Scope phase(g_startup_profiler, "glewInit");
+        // Without this GLEW goes by the extension string, which core contexts don't have
+        glewExperimental = GL_TRUE;
+        glewInit();
+    }
+#endif
+    if (g_core_profile || g_gles2) LOG("OpenGL " << glGetString(GL_VERSION) << (is_core_profile() ? ", core profile" : "")
+                                       << ", " << get_render_backend()->get_name() << " backend");
+
+    // The swap interval only applies to a current context, so this has to come after MakeCurrent
+    g_frame_pacer.initialise(TARGET_FPS, g_vsync_mode);
+    if (!g_frame_latency.initialise(g_max_queued_frames) && g_max_queued_frames > 0) LOG("No frame latency limit: it needs fence sync");
+
+    // Shares the context above, so it has to come after it; before anything is uploaded, though
+    // sharing covers objects made either side of it
+    if (g_spectator_zoom > 0.0f && !is_benchmarking() &&
+        !g_spectator.initialise(g_display_window, &g_sprite_shaders, g_spectator_zoom))
+    {
+        LOG("No spectator window: it needs framebuffer blits and a context that shares with the game's");
+    }
+
+    glViewport(VIEWPORT_X, VIEWPORT_Y, g_viewport_width, g_viewport_height);
+
+    //  GENERAL  //
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    if (g_craters) g_terrain_editor.initialise();
+
+    // The rest loads over the next frames; the window shows the empty bar in the meantime
+    queue_loading_steps();
+
+    {
+        StartupProfiler::Scope phase(g_startup_profiler, "first splash frame");
+        render_loading();
+    }
+}
+
+//  SIMULATION  //
+// The clock the simulation's steps and the input timeline are both timed on: steady_clock
+// seconds, as SimulationThread steps by
+double get_input_clock()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// What the keys and controllers hold, as an action record. Online, the others only ever hear
+// the bits, so that's all that's flown here too.
+int get_held_action(const InputDevices& input)
+{
+    int action = input.get_action();
+    return is_online() ? get_digital_action(action) : action;
+}
+
+// The held controls, as an action record and INPUT_AUTOPILOT, put onto the player by whichever
+// thread is stepping it
+void apply_player_input(GameState& state, int input)
+{
+    apply_replay_action(state.player, input & ~INPUT_AUTOPILOT);
+
+    // Planned from this pass's state, and held for every step the pass runs
+    if ((input & INPUT_AUTOPILOT) && !state.win && !state.loss)
+    {
+        apply_autopilot_action(state.player, g_autopilot->decide(state));
+    }
+
+    // This makes sure that the player can't move faster diagonally
+    if (glm::length(state.player->get_movement()) > 1.0f)
+    {
+        state.player->set_movement(glm::normalize(state.player->get_movement()));
+    }
+}
+
+// Before every fixed step: the keys as they were when the step began, off the input timeline,
+// unless the autopilot has the controls (it sets them once a pass). Each step is recorded with
+// what it actually saw, so a replay steers exactly as the live game did.
+void apply_step_input(GameState& state, double step_time, void* user_data)
+{
+    // The state the last step left, before this step's keys touch it
+    if (g_rewind_enabled) g_rewind.record(state);
+    g_ghosts.step();
+    g_policy_fleet.step();
+
+    int input = g_input_timeline.get_action(step_time);
+    if (!(input & INPUT_AUTOPILOT)) apply_player_input(state, input);
+
+    g_replay.record_step_hash(state.step_hash);
+    g_replay.record(get_replay_action(*state.player), 1);
+
+    // Online, the step is predicted exactly as the server will take it: from the network grid,
+    // with the same input, which goes up to the server numbered for this step
+    if (g_net_client.is_connected())
+    {
+        quantize_lander(*state.player, state.fixed_timestep);
+        g_net_client.queue_input(get_replay_action(*state.player));
+    }
+}
+
+// The attempt goes to disk once it's decided. ReplayPlayer rebuilds levels from a SceneConfig,
+// so endless courses and level files aren't saved, and nor is practice, whose rewound steps are
+// still in the recording, or a level the editor has changed.
+void record_player_steps(const GameState& state, int input, int steps)
+{
+    bool replayable = !g_endless && !g_level_file.is_open() && !g_rewind_enabled && !g_editor;
+    if ((state.win || state.loss) && g_render_bench_frames == 0 && replayable)
+    {
+        // The state the replay should end on, for playback to check its last step against
+        if (g_replay.get_step_hash_count() > 0) g_replay.record_step_hash(state.step_hash);
+        g_replay.save(REPLAY_FILEPATH);
+    }
+}
+
+// Hands the level to the simulation thread, unless it's stepped between frames here. Anything
+// that rewrites g_game_state has to stop the thread first and call this again after.
+void start_simulation_thread()
+{
+    if (!g_threaded_simulation) return;
+
+    // The copy keeps the player's textures and animation clips; only its BodyState comes from the snapshots
+    g_drawn_player = *g_game_state.player;
+    g_simulation_thread.start(&g_game_state, apply_player_input, record_player_steps);
+    g_drawn_player.restore_state(g_simulation_thread.get_snapshot().player);
+}
+
+// What a frame draws: the simulation thread's last snapshot while it runs, the live state otherwise
+Entity* get_drawn_player() { return g_simulation_thread.is_running() ? &g_drawn_player : g_game_state.player; }
+bool is_level_won()  { return g_simulation_thread.is_running() ? g_simulation_thread.get_snapshot().win  : g_game_state.win; }
+bool is_level_lost() { return g_simulation_thread.is_running() ? g_simulation_thread.get_snapshot().loss : g_game_state.loss; }
+
+// How far the lander's feet are above whatever is straight below: the terrain, or the highest
+// platform top under its width. Infinite over nothing.
+float get_altitude(const Entity& lander)
+{
+    static std::vector<int> candidates;
+    static int cursor = -1;
+
+    glm::vec2 position = glm::vec2(lander.get_position());
+    float half_width = lander.get_width() / 2.0f,
+          feet = position.y - lander.get_height() / 2.0f,
+          ground = g_game_state.terrain != NULL ? g_game_state.terrain->get_height(position.x) : -INFINITY;
+
+    candidates.clear();
+    if (g_game_state.platform_broadphase != NULL)
+    {
+        g_game_state.platform_broadphase->query(glm::vec2(position.x - half_width, -INFINITY), glm::vec2(position.x + half_width, feet), candidates, cursor);
+    }
+    else for (int i = 0; i < g_game_state.platform_count; i++) candidates.push_back(i);
+
+    for (int index : candidates)
+    {
+        const Entity& platform = g_game_state.platforms[index];
+        float top = platform.get_position().y + platform.get_height() / 2.0f;
+        if (platform.is_active() && top <= feet &&
+            std::fabs(platform.get_position().x - position.x) < half_width + platform.get_width() / 2.0f) ground = std::max(ground, top);
+    }
+
+    return feet - ground;
+}
+
+// Only the glyphs whose digits changed since last frame are rebuilt and uploaded
+void submit_telemetry()
+{
+    const Entity& player = *get_drawn_player();
+    glm::vec3 velocity = player.get_velocity();
+
+    g_telemetry.set_value(TELEMETRY_ALTITUDE, get_altitude(player));
+    g_telemetry.set_value(TELEMETRY_VERTICAL_SPEED, velocity.y);
+    g_telemetry.set_value(TELEMETRY_HORIZONTAL_SPEED, velocity.x);
+    g_telemetry.set_value(TELEMETRY_FUEL, (float)player.m_fuel);
+    g_telemetry.set_value(TELEMETRY_SCORE, g_score);
+
+    g_render_queue.submit_custom(HUD_LAYER, g_text_shader_program, g_texture_atlas.get_texture_id(), draw_telemetry, NULL);
+}
+
+// The frame just finished, recorded as the next one begins: the profiler and counters have closed
+// it by then. Its records go to the flight recorder and, with --telemetry-log, into the log's
+// ring; either way the disk is someone else's problem unless the frame was a hitch.
+void record_frame_telemetry()
+{
+    static const double epoch = get_input_clock();
+
+    double now  = get_input_clock(),
+           idle = g_frame_pacer.get_idle_seconds();
+    float frame_ms = g_telemetry_frame_start > 0.0 ? (float)((now - g_telemetry_frame_start - (idle - g_telemetry_idle_start)) * MILLISECONDS_IN_SECOND) : 0.0f;
+    g_telemetry_frame_start = now;
+    g_telemetry_idle_start  = idle;
+
+    uint32_t frame = (uint32_t)g_frame_counters.get_frame_count();
+    double   time  = now - epoch;
+    float frame_values[] =
+    {
+        frame_ms,
+        g_frame_profiler.get_last_ms(PROFILE_INPUT),
+        g_frame_profiler.get_last_ms(PROFILE_UPDATE),
+        g_frame_profiler.get_last_ms(PROFILE_RENDER),
+        (float)g_frame_profiler.get_last_step_count(),
+        (float)g_frame_counters.get_last(COUNTER_ALLOCATIONS),
+        (float)g_frame_counters.get_last(COUNTER_GL_DRAWS),
+        (float)g_frame_counters.get_last(COUNTER_GL_UPLOADS),
+    };
+
+    const Entity& player = *get_drawn_player();
+    glm::vec3 position = player.get_position(),
+              velocity = player.get_velocity();
+    float physics_values[] =
+    {
+        position.x, position.y, velocity.x, velocity.y, (float)player.m_fuel,
+        player.is_engine_firing() ? 1.0f : 0.0f, is_level_won() ? 1.0f : 0.0f, is_level_lost() ? 1.0f : 0.0f,
+    };
+    float input_values[] =
+    {
+        (float)get_digital_action(g_input.get_action()), g_autopilot_enabled ? 1.0f : 0.0f, g_paused ? 1.0f : 0.0f, g_rewinding ? 1.0f : 0.0f,
+    };
+
+    TelemetryRecord records[] =
+    {
+        TelemetryLog::make_record(TELEMETRY_FRAME, frame, time, frame_values, (int)(sizeof(frame_values) / sizeof(frame_values[0]))),
+        TelemetryLog::make_record(TELEMETRY_PHYSICS, frame, time, physics_values, (int)(sizeof(physics_values) / sizeof(physics_values[0]))),
+        TelemetryLog::make_record(TELEMETRY_INPUT, frame, time, input_values, (int)(sizeof(input_values) / sizeof(input_values[0]))),
+    };
+    for (const TelemetryRecord& record : records)
+    {
+        g_flight_recorder.record(record);
+        if (g_telemetry_log.is_open()) g_telemetry_log.log(record);
+    }
+
+    if (g_flight_recorder.check_hitch(frame_ms, now)) LOG("Hitch: a " << frame_ms << " ms frame, the seconds before it in " << FLIGHT_HITCH_FILEPATH);
+}
+
+// The kept map of the level, with only what moves or is aimed for marked on it each frame
+void submit_minimap()
+{
+    for (int i = 0; i < g_game_state.platform_count; i++)
+    {
+        const Entity& platform = g_game_state.platforms[i];
+        if (!platform.is_active()) continue;
+
+        if (platform.get_entity_type() == WIN_PLATFORM)     g_minimap.add_marker(glm::vec2(platform.get_position()), MINIMAP_PAD_COLOUR, MINIMAP_MARKER_SIZE);
+        else if (platform.get_body_type() != STATIC_BODY)  g_minimap.add_marker(glm::vec2(platform.get_position()), MINIMAP_MOVER_COLOUR, MINIMAP_MARKER_SIZE);
+    }
+
+    if (g_net_client.is_connected() && g_net_client.has_snapshot())
+    {
+        const NetSnapshot& snapshot = g_net_client.get_snapshot();
+        for (int i = 0; i < snapshot.lander_count; i++)
+        {
+            bool remote = i != g_net_client.get_welcome().lander && (snapshot.landers[i].flags & NET_LANDER_ACTIVE);
+            if (remote) g_minimap.add_marker(glm::vec2(g_remote_landers[i].get_position()), MINIMAP_RIVAL_COLOUR, MINIMAP_MARKER_SIZE);
+        }
+    }
+    if (g_versus_peer.is_connected()) g_minimap.add_marker(glm::vec2(g_versus_lander.get_position()), MINIMAP_RIVAL_COLOUR, MINIMAP_MARKER_SIZE);
+
+    // The suggested pad: the best the landing-site map has near the player, over its own marker
+    const LandingSiteMap* sites = g_game_state.landing_sites;
+    int hint = sites != NULL ? sites->find_best(get_drawn_player()->get_position().x, LANDING_HINT_RANGE) : -1;
+    if (hint >= 0 && sites->get_site(hint).score > 0.0f) g_minimap.add_marker(glm::vec2(g_game_state.platforms[sites->get_site(hint).platform].get_position()), MINIMAP_HINT_COLOUR, 1.5f * MINIMAP_MARKER_SIZE);
+
+    // Last, so it's on top of anything it's over
+    g_minimap.add_marker(glm::vec2(get_drawn_player()->get_position()), MINIMAP_PLAYER_COLOUR, MINIMAP_MARKER_SIZE);
+
+    g_render_queue.submit_custom(HUD_LAYER, g_minimap.get_program(), g_minimap.get_texture_id(), draw_minimap, NULL);
+}
+
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+// What the lander was tested against: every platform on screen, the ones the broadphase handed
+// back for its last move lit up, and the contacts that move resolved
+void submit_collision_debug(glm::vec2 view_min, glm::vec2 view_max)
+{
+    const glm::vec4 PLATFORM_COLOUR  = glm::vec4(0.3f, 0.6f, 1.0f, 0.5f),
+                    CANDIDATE_COLOUR = glm::vec4(1.0f, 0.9f, 0.2f, 1.0f),
+                    LANDER_COLOUR    = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f),
+                    CONTACT_COLOUR   = glm::vec4(1.0f, 0.2f, 0.2f, 1.0f);
+    const float CONTACT_RADIUS = 0.05f,
+                NORMAL_LENGTH  = 0.3f;
+
+    static std::vector<int> indices;
+    const Entity& lander = *get_drawn_player();
+    glm::vec2 position  = glm::vec2(lander.get_position()),
+              half_size = glm::vec2(lander.get_width(), lander.get_height()) * 0.5f;
+
+    // STEP 1: The platforms on screen
+    indices.clear();
+    int cursor = -1;
+    if (g_game_state.platform_broadphase != NULL) g_game_state.platform_broadphase->query(view_min, view_max, indices, cursor);
+    else for (int i = 0; i < g_game_state.platform_count; i++) indices.push_back(i);
+
+    auto platform_box = [](int index, glm::vec4 colour)
+    {
+        const Entity& platform = g_game_state.platforms[index];
+        if (!platform.is_active()) return;
+        glm::vec2 centre = glm::vec2(platform.get_position()),
+                  extent = glm::vec2(platform.get_width(), platform.get_height()) * 0.5f;
+        DEBUG_DRAW_BOX(centre - extent, centre + extent, colour);
+    };
+    for (int index : indices) platform_box(index, PLATFORM_COLOUR);
+
+    // STEP 2: The lander's box swept over its last move, and what the broadphase found in it
+    glm::vec2 previous = position - glm::vec2(lander.get_movement()),
+              sweep_min = glm::min(position, previous) - half_size,
+              sweep_max = glm::max(position, previous) + half_size;
+    if (g_game_state.platform_broadphase != NULL)
+    {
+        indices.clear();
+        cursor = -1;
+        g_game_state.platform_broadphase->query(sweep_min, sweep_max, indices, cursor);
+        for (int index : indices) platform_box(index, CANDIDATE_COLOUR);
+    }
+    DEBUG_DRAW_BOX(sweep_min, sweep_max, CANDIDATE_COLOUR);
+    DEBUG_DRAW_BOX(position - half_size, position + half_size, LANDER_COLOUR);
+
+    // STEP 3: Where each contact pushed from, and which way
+    for (int i = 0; i < lander.get_contact_count(); i++)
+    {
+        const Contact& contact = lander.get_contact(i);
+        glm::vec2 point = position - contact.normal * half_size;
+        DEBUG_DRAW_CIRCLE(point, CONTACT_RADIUS, CONTACT_COLOUR);
+        DEBUG_DRAW_LINE(point, point + contact.normal * NORMAL_LENGTH, CONTACT_COLOUR);
+    }
+}
+#endif
+
+// Nothing steps while paused: the simulation thread stops, and the clock restarts on the way out
+// so the pause isn't simulated afterwards
+void set_paused(bool paused)
+{
+    g_paused = paused;
+    if (g_paused)
+    {
+        g_simulation_thread.stop();
+    }
+    else
+    {
+        g_frame_clock.reset();
+        start_simulation_thread();
+    }
+}
+
+// Whether the next frame would look the same as the last: paused, or the level decided and the
+// last of the exhaust gone
+bool is_idle()
+{
+    if (g_paused) return true;
+    // The server's next round can start at any moment
+    if (is_online()) return false;
+    return (is_level_won() || is_level_lost()) && g_exhaust.get_count() == 0 && !g_debris.is_active() && !g_flow.has_frame_waiters();
+}
+
+// A one-off effect: one emit command on the GPU pool, or a smaller burst the CPU pays for per particle
+void burst_particles(int count, glm::vec2 position, glm::vec2 velocity, float spread)
+{
+    count = (int)(count * g_governor.get_settings().particle_scale);
+    if (g_debris.is_initialised()) g_debris.burst(count, position, velocity, spread);
+    else                           g_exhaust.burst(std::min(count, CPU_BURST_LIMIT), position, velocity, spread);
+}
+
+// What the governor's new level holds back; particles and the starfield read it as they go
+void apply_quality_level()
+{
+    const QualityLevel& level = g_governor.get_settings();
+    g_post_process.set_effect_mask(level.post_effects);
+    g_lighting.set_limits(level.lights, level.shadow_resolution);
+    if (g_dynamic_resolution.is_enabled()) g_dynamic_resolution.set_max_scale(level.max_resolution);
+    LOG("Quality " << g_governor.get_level() << " (" << level.name << "), p95 " << g_governor.get_last_p95_ms() << " ms");
+}
+
+//  SAVE  //
+// The overlays as the player last left them; only the ones that changed reach the file
+void save_settings()
+{
+    g_save.set_bool("settings.profiler", g_show_profiler);
+    g_save.set_bool("settings.telemetry", g_show_telemetry);
+    g_save.set_bool("settings.minimap", g_show_minimap);
+}
+
+void load_settings()
+{
+    g_show_profiler  = g_save.get_bool("settings.profiler", g_show_profiler);
+    g_show_telemetry = g_save.get_bool("settings.telemetry", g_show_telemetry);
+    g_show_minimap   = g_show_minimap || g_save.get_bool("settings.minimap", false);  // --minimap and --endless have it on regardless
+}
+
+// Landings over every run, and the quickest on each generated level
+void save_landing_progress()
+{
+    g_save.set_int("progress.landings", g_save.get_int("progress.landings", 0) + 1);
+    if (g_level_file.is_open() || g_endless || g_editor) return;
+
+    char key[64];
+    std::snprintf(key, sizeof(key), "progress.best.%d.%d.%u", (int)g_scene.layout, g_scene.platform_count, g_level_seed);
+    float seconds = (float)(g_replay.get_step_count() * g_game_state.fixed_timestep),
+          best    = g_save.get_float(key, 0.0f);
+    if (best <= 0.0f || seconds < best) g_save.set_float(key, seconds);
+}
+
+// A fair landing to the leaderboard's queue; the upload, and any retries, are its worker's business
+void submit_landing()
+{
+    if (!g_leaderboard.is_running() || g_rewind_enabled || g_autopilot_enabled || g_editor) return;
+
+    LeaderboardEntry entry;
+    std::snprintf(entry.player, sizeof(entry.player), "%s", g_player_name);
+    entry.seed            = g_level_seed;
+    entry.layout          = (int32_t)g_scene.layout;
+    entry.platform_count  = g_scene.platform_count;
+    entry.score           = g_score;
+    entry.landing_seconds = (float)(g_replay.get_step_count() * g_game_state.fixed_timestep);
+    g_leaderboard.submit(entry);
+}
+
+//  GAME FLOW  //
+// One level, from the first step to the result and the keys to go again; started over with every level
+FlowTask level_flow()
+{
+    g_banner = NULL;
+    g_hint = NULL;
+
+    int outcome = co_await g_flow.wait_event(FLOW_LEVEL_WON | FLOW_LEVEL_LOST);
+    g_banner = (outcome & FLOW_LEVEL_WON) ? &WIN_BANNER : &LOSS_BANNER;
+    if (g_hint == &FUEL_HINT) g_hint = NULL;
+
+    const Entity* player = get_drawn_player();
+    glm::vec2 position = glm::vec2(player->get_position());
+
+    if (outcome & FLOW_LEVEL_WON)
+    {
+        g_score++;
+        submit_landing();
+        if (!g_rewind_enabled && !g_autopilot_enabled) save_landing_progress();
+        play_sound(IMPACT_VOICE, g_thud_bank);
+        play_sound(RESULT_VOICE, g_chime_bank);
+        burst_particles(DUST_COUNT, position - glm::vec2(0.0f, player->get_height() / 2.0f), glm::vec2(0.0f, DUST_SPEED), DUST_SPREAD);
+    }
+    else
+    {
+        play_sound(IMPACT_VOICE, g_crash_bank);
+        burst_particles(DEBRIS_COUNT, position, glm::vec2(0.0f), DEBRIS_SPREAD);
+        if (g_terrain_editor.is_attached()) g_terrain_editor.carve_crater(position, CRATER_RADIUS);
+    }
+
+    // The result has the screen to itself for a moment first
+    co_await g_flow.wait_seconds(RETRY_HINT_DELAY);
+    if (!is_online()) g_hint = &RETRY_HINT;  // online, the server starts the next round
+}
+
+// The tank running dry in flight gets a warning for a while, or until the level's decided. Timed
+// in steps, so it stays up while paused and through a stall.
+FlowTask fuel_flow()
+{
+    co_await g_flow.wait_event(FLOW_FUEL_EMPTY);
+    if (g_hint != NULL || is_level_won() || is_level_lost()) co_return;
+
+    g_hint = &FUEL_HINT;
+    co_await g_flow.wait_steps(FUEL_HINT_STEPS);
+    if (g_hint == &FUEL_HINT) g_hint = NULL;
+}
+
+void start_level_flow()
+{
+    g_flow.stop_all();
+    g_flow.start(level_flow());
+    g_flow.start(fuel_flow());
+}
+
+// The readers of g_events that don't go through a flow script; only the player's own events,
+// not the ghosts' or the other player's
+void read_events()
+{
+    for (const GameEvent& event : g_events.get_events())
+    {
+        if (event.lander != 0) continue;
+
+        switch (event.type)
+        {
+        case EVENT_LANDED:
+        case EVENT_CRASHED:
+            LOG((event.type == EVENT_LANDED ? "Landed" : "Crashed") << " at " << event.speed << " units/s, step " << event.step);
+            break;
+        case EVENT_SCRAPE:
+            if (event.speed >= SCRAPE_SOUND_SPEED) play_sound(IMPACT_VOICE, g_thud_bank);
+            break;
+        case EVENT_FUEL_EMPTY:
+            g_flow.signal(FLOW_FUEL_EMPTY);
+            break;
+        }
+    }
+}
+
+void process_input()
+{
+    // SDL stamps events in milliseconds since it started; this puts those stamps on the input clock
+    double poll_time = get_input_clock(),
+           ticks_offset = poll_time - (double)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
+
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        // Every press, release and stick move goes on the timeline when it happened, not when it
+        // was polled; unchanged actions are dropped there
+        if (g_input.handle_event(event))
+        {
+            double time = std::min(ticks_offset + (double)event.common.timestamp / MILLISECONDS_IN_SECOND, poll_time);
+            g_input_timeline.push(time, get_held_action(g_input) | (g_autopilot_enabled ? INPUT_AUTOPILOT : 0));
+        }
+
+        switch (event.type) {
+            // End game
+        case SDL_QUIT:
+        case SDL_WINDOWEVENT_CLOSE:
+            g_game_is_running = false;
+            break;
+
+        case SDL_MOUSEBUTTONDOWN:
+            // --editor: picks up the static platform under the pointer, if there is one
+            if (g_editor && event.button.button == SDL_BUTTON_LEFT)
+            {
+                g_level_editor.begin_drag(g_game_state.platforms, g_game_state.platform_count, g_game_state.platform_broadphase,
+                                          window_to_world(event.button.x, event.button.y));
+            }
+            break;
+
+        case SDL_MOUSEMOTION:
+            if (g_level_editor.is_dragging()) g_level_editor.drag_to(window_to_world(event.motion.x, event.motion.y));
+            break;
+
+        case SDL_MOUSEBUTTONUP:
+            if (event.button.button == SDL_BUTTON_LEFT) g_level_editor.end_drag();
+            break;
+
+        case SDL_KEYDOWN:
+            switch (event.key.keysym.sym) {
+            case SDLK_q:
+                // Quit the game with a keystroke
+                g_game_is_running = false;
+                break;
+
+            case SDLK_r:
+                // New level, recycling the last one's memory; nothing may step the old one meanwhile.
+                // Online, the server decides the level and when it starts over.
+                if (is_online()) break;
+                g_simulation_thread.stop();
+                g_paused = false;
+                restart_level();
+                start_simulation_thread();
+                start_level_flow();
+                break;
+
+            case SDLK_RETURN:
+                // Try the same level again
+                if (is_online()) break;
+                g_simulation_thread.stop();
+                g_paused = false;
+                replay_level();
+                start_simulation_thread();
+                start_level_flow();
+                break;
+
+            case SDLK_ESCAPE:
+                // The server doesn't wait for anyone, and neither does the other player
+                if (!is_online()) set_paused(!g_paused);
+                break;
+
+            case SDLK_F3:
+                // Frame profiler overlay
+                g_show_profiler = !g_show_profiler;
+                g_gpu_profiler.set_enabled(g_show_profiler || g_dynamic_resolution.is_enabled());
+                save_settings();
+                break;
+
+            case SDLK_F4:
+                // Telemetry: altitude, speeds, fuel and score
+                g_show_telemetry = !g_show_telemetry;
+                save_settings();
+                break;
+
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+            case SDLK_F5:
+                // Collision: boxes, broadphase candidates and contacts
+                g_show_collision = !g_show_collision;
+                break;
+#endif
+
+            case SDLK_F6:
+                // The level's map, if the driver could make one
+                g_show_minimap = !g_show_minimap && g_minimap.is_ready();
+                save_settings();
+                break;
+
+            case SDLK_F10:
+                // Start or stop recording the game
+                if (g_frame_capture.is_recording()) g_frame_capture.stop_recording();
+                else if (!g_frame_capture.start_recording()) LOG("Recording needs fences and pixel buffer objects, or " << CAPTURE_DIRECTORY << " isn't writable");
+                break;
+
+            case SDLK_F12:
+                // Screenshot of the next frame, HUD and all
+                g_frame_capture.request_screenshot();
+                break;
+
+            case SDLK_p:
+                // Hand the controls to the autopilot, or take them back
+                if (g_autopilot == NULL) g_autopilot.reset(new Autopilot());
+                g_autopilot_enabled = !g_autopilot_enabled;
+                break;
+
+            default:
+                break;
+            }
+
+        default:
+            break;
+        }
+    }
+
+    // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere. Anything let go while
+    // the window was unfocused was let go with the focus, in g_input.
+    int input = get_held_action(g_input);
+    if (g_autopilot_enabled) input |= INPUT_AUTOPILOT;
+    g_rewinding = g_rewind_enabled && g_input.is_rewind_held();
+    g_input_timeline.push(poll_time, input);
+
+    // Per pass, for the autopilot: the simulation thread picks it up on its next one; without
+    // one, it goes straight on
+    if (g_simulation_thread.is_running()) g_simulation_thread.set_input(input);
+    else                                  apply_player_input(g_game_state, input);
+}
+
+//  FRAME TASKS  //
+// The parts of a frame that don't touch GL or the simulation, run as g_frame_graph
+struct FrameTaskData
+{
+    const Entity* player;
+    float         delta_time;
+    bool          finished;  // the level is won or lost
+};
+
+void follow_camera_task(void* user_data)
+{
+    const FrameTaskData& frame = *(const FrameTaskData*)user_data;
+    g_camera.follow(glm::vec2(frame.player->get_position()), frame.delta_time);
+}
+
+// Purely visual, so it runs on frame time rather than in the fixed physics steps
+void update_exhaust_task(void* user_data)
+{
+    const FrameTaskData& frame = *(const FrameTaskData*)user_data;
+    const Entity* player = frame.player;
+
+    if (player->is_engine_firing() && !frame.finished)
+    {
+        glm::vec2 nozzle = g_attachments.get_world(g_nozzle_node).translation;
+        g_exhaust.spawn(frame.delta_time, EXHAUST_RATE * g_governor.get_settings().particle_scale, nozzle, glm::vec2(player->get_velocity()) - glm::vec2(0.0f, EXHAUST_SPEED), EXHAUST_SPREAD);
+    }
+    g_exhaust.update(frame.delta_time);
+}
+
+//  NETWORK  //
+// Whatever the server has sent since the last frame: a new round starts the level over, this
+// player's lander is put right and its unacknowledged steps replayed, and the others move to
+// where the server has them
+void receive_snapshots()
+{
+    if (!g_net_client.receive(get_input_clock())) return;
+
+    const NetSnapshot& snapshot = g_net_client.get_snapshot();
+    if (snapshot.round != g_net_round)
+    {
+        g_net_round = snapshot.round;
+        reset_episode(g_game_state);
+        start_level_flow();
+    }
+    g_net_client.reconcile(g_game_state);
+
+    int own = g_net_client.get_welcome().lander;
+    for (int i = 0; i < snapshot.lander_count; i++)
+    {
+        if (i != own) apply_lander(snapshot.landers[i], g_remote_landers[i], g_game_state.fixed_timestep);
+    }
+}
+
+// Head to head: both landers step on each peer, the other player's input predicted until it
+// arrives, and the frames since put right whenever a prediction was wrong. Returns the steps taken.
+int step_versus(int64_t elapsed_ticks)
+{
+    g_versus_peer.receive(g_rollback);
+
+    // STEP 1: The time to step, with no more than the budget's worth kept over from frames spent
+    //         waiting on the other player
+    const int64_t step_ticks = seconds_to_ticks(g_game_state.fixed_timestep);
+    int64_t max_ticks = (int64_t)(std::max(g_game_state.budget.max_steps_per_frame, 1) + 1) * step_ticks - 1;
+    g_versus_ticks = std::min(g_versus_ticks + elapsed_ticks, max_ticks);
+
+    // STEP 2: Running ahead of the other player makes them roll back on every frame; one step's
+    //         time dropped now and then lets them catch up
+    if (g_versus_peer.get_frames_to_wait(g_rollback) > 0 && g_versus_ticks >= step_ticks) g_versus_ticks -= step_ticks;
+
+    // STEP 3: Each step with the keys as they were when it began, as apply_step_input takes them
+    double now = get_input_clock();
+    int steps = 0;
+    while (g_versus_ticks >= step_ticks && g_rollback.can_advance())
+    {
+        int input = g_input_timeline.get_action(now - (double)g_versus_ticks / TICKS_PER_SECOND);
+        apply_player_input(g_game_state, input);
+        int action = g_game_state.win || g_game_state.loss ? REPLAY_NONE : get_replay_action(*g_game_state.player);
+
+        g_replay.record(action, 1);
+        g_rollback.advance(action);
+        g_versus_ticks -= step_ticks;
+        steps++;
+    }
+    g_game_state.time_accumulator = (float)((double)g_versus_ticks / TICKS_PER_SECOND);
+
+    g_versus_peer.send(g_rollback, now);
+    return steps;
+}
+
+//  FLOATING ORIGIN  //
+// Once the camera is far enough along an endless course, the streamer moves the origin up to it
+// by whole chunks, and everything else that holds a local position moves by the same in one pass.
+// The caller rebuilds the colliders and instances, as after any chunk change. The spawn point
+// stays put: every restart begins the course again from chunk 0. GPU debris still in the air
+// isn't moved, being gone in a second or so.
+bool rebase_course()
+{
+    float shift = g_level_streamer.rebase(g_camera.get_position().x);
+    if (shift == 0.0f) return false;
+
+    glm::vec2 offset = glm::vec2(shift, 0.0f);
+    g_game_state.player->translate(glm::vec3(offset, 0.0f));
+    for (int i = 0; i < g_game_state.lander_count; i++) g_game_state.landers[i].translate(glm::vec3(offset, 0.0f));
+    g_camera.translate(offset);
+    g_exhaust.translate(offset);
+    if (g_policy_fleet.is_loaded()) g_policy_fleet.translate(offset);
+    g_minimap.invalidate();
+    return true;
+}
+
+// Everything a frame advances by, whether the time came from the clock or from a script. The
+// physics takes the exact ticks; cameras and particles are happy with float seconds.
+void update_world(int64_t elapsed_ticks)
+{
+    float delta_time = (float)((double)elapsed_ticks / TICKS_PER_SECOND);
+
+    int steps = 0;
+    if (g_simulation_thread.is_running())
+    {
+        // Whatever the simulation thread has finished since the last frame, drawn from a copy
+        long long previous_steps = g_simulation_thread.get_snapshot().total_steps;
+        g_simulation_thread.update_snapshot();
+
+        const RenderSnapshot& snapshot = g_simulation_thread.get_snapshot();
+        steps = (int)std::max(snapshot.total_steps - previous_steps, 0LL);
+        // The simulation only picks the clip; how far into it is this thread's, so it's kept
+        Animator animator = g_drawn_player.m_animator;
+        g_drawn_player.restore_state(snapshot.player);
+        animator.play(g_drawn_player.m_animator.clip);
+        g_drawn_player.m_animator = animator;
+        g_physics_counters.record_frame(snapshot.timings, snapshot.budget, snapshot.time_accumulator, steps, delta_time);
+    }
+    else
+    {
+        // Online, the server's word comes first, so this frame's steps are predicted on top of it
+        if (g_net_client.is_connected()) receive_snapshots();
+
+        // Head to head, the other player is still flying after this one is down
+        if (g_versus_peer.is_connected()) steps = step_versus(elapsed_ticks);
+        else if (g_rewinding && !g_paused)
+        {
+            // A crash or landing taken back puts the level's script back to waiting for one
+            bool decided = g_game_state.win || g_game_state.loss;
+            if (g_rewind.rewind(g_game_state, REWIND_STEPS_PER_FRAME) > 0 && decided && !g_game_state.win && !g_game_state.loss)
+            {
+                g_terrain_editor.restore();  // and the crater it dug
+                start_level_flow();
+            }
+        }
+        else if (!g_game_state.win && !g_game_state.loss && !g_paused)
+        {
+            steps = advance_simulation_ticks(g_game_state, elapsed_ticks, get_input_clock());
+            record_player_steps(g_game_state, REPLAY_NONE, steps);
+        }
+        g_physics_counters.record_frame(g_game_state, steps, delta_time);
+
+        // ...and the inputs those steps took go up, along with the newest snapshot's ack
+        if (g_net_client.is_connected()) g_net_client.send(get_input_clock());
+    }
+    g_frame_profiler.set_step_count(steps);
+
+    // Kept from frame to frame, and predicted again only once the lander leaves it
+    if (g_show_trajectory) g_trajectory.update(*get_drawn_player(), steps * g_game_state.fixed_timestep, g_game_state);
+
+    //  EVENTS  //
+    // Whatever the steps since the last frame reported, on this thread or the simulation's
+    g_events.collect();
+    read_events();
+
+    //  GAME FLOW  //
+    // Signalled every frame the outcome stands, but only the first finds a script waiting on it
+    if (is_level_won())  g_flow.signal(FLOW_LEVEL_WON);
+    if (is_level_lost()) g_flow.signal(FLOW_LEVEL_LOST);
+    if (!g_paused) g_flow.update(delta_time);
+    g_flow.advance_steps(steps);
+
+    update_thrust_sound(!g_paused && !is_level_won() && !is_level_lost() && get_drawn_player()->is_engine_firing());
+
+    //  CAMERA AND EXHAUST  //
+    // Independent of each other, so with --jobs they run side by side; frozen along with the
+    // simulation while paused
+    if (!g_paused)
+    {
+        // The exhaust reads the nozzle, so the lander's attachments are brought up to date first
+        const Entity* player = get_drawn_player();
+        g_attachments.set_local(g_lander_node, ModelTransform::make(glm::vec2(player->get_position())));
+        g_attachments.set_local(g_nozzle_node, ModelTransform::make(glm::vec2(0.0f, -player->get_height() / 2.0f)));
+        g_attachments.update();
+
+        FrameTaskData frame = { player, delta_time, is_level_won() || is_level_lost() };
+        g_frame_graph.clear();
+        g_frame_graph.add(follow_camera_task, &frame);
+        g_frame_graph.add(update_exhaust_task, &frame);
+        g_jobs->run(g_frame_graph);
+
+        // GL, so on this thread; a few uniforms and one pass, however many particles are up
+        g_debris.update(delta_time);
+
+        // Every lander's clip moved on, leaving the sheet frame each one draws
+        g_animations.advance(&get_drawn_player()->m_animator, 1, delta_time);
+        g_animations.advance(&g_remote_landers[0].m_animator, NET_MAX_LANDERS, delta_time, sizeof(Entity));
+        if (g_versus_peer.is_connected()) g_animations.advance(&g_versus_lander.m_animator, 1, delta_time);
+    }
+
+    // Chunks stream around the camera rather than the player, so whatever is on screen is resident.
+    // Uploads the platforms, so it stays on this thread.
+    if (g_endless)
+    {
+        bool rebased = rebase_course();
+        if (g_level_streamer.update(g_camera.get_position().x) || rebased)
+        {
+            build_platform_colliders(g_level_slots[g_level_slot]);
+            upload_platforms(false);
+        }
+    }
+}
+
+// A rebuilt gameplay module, swapped in between frames: nothing may be stepping through the old
+// one meanwhile, and the lander in flight takes the new tuning where it is. Level generation
+// changes show from the next level.
+void reload_gameplay()
+{
+    if (!g_gameplay.poll()) return;
+
+    bool threaded = g_simulation_thread.is_running();
+    g_simulation_thread.stop();
+    const GameplayApi& api = g_gameplay.get_api();
+    g_game_state.step = api.step_simulation;
+    if (g_game_state.player != NULL)
+    {
+        api.retune_lander(*g_game_state.player);
+        tune_lander(*g_game_state.player);
+    }
+    if (threaded) start_simulation_thread();
+}
+
+// A saved tuning file, swapped in between frames the same way. Only alone, like the gameplay
+// module: everyone else in the game would have to change with it.
+void reload_tuning()
+{
+    if (is_online() || !g_tuning.poll()) return;
+    if (!g_tuning.get_error().empty())
+    {
+        LOG("Tuning: " << g_tuning.get_error() << "; keeping the last values");
+        return;
+    }
+
+    bool threaded = g_simulation_thread.is_running();
+    g_simulation_thread.stop();
+    apply_world_tuning();
+    if (g_game_state.player != NULL) tune_lander(*g_game_state.player);
+    if (threaded) start_simulation_thread();
+    LOG("Tuning: reread " << g_tuning.get_path());
+}
+
+void update()
+{
+    if (g_gameplay.is_loaded()) reload_gameplay();
+    if (g_tuning.is_loaded()) reload_tuning();
+    if (g_editor) apply_level_edits();
+
+    //  DELTA TIME  //
+    // Integer ticks straight off the performance counter, so the step cadence stays exact however
+    // long the game has been up
+    update_world(g_frame_clock.tick());
+}
+
+// --lighting: this frame's lights, most important first since the governor drops from the end,
+// and the platforms in their reach, drawn into their shadow maps
+void gather_lights(float alpha)
+{
+    g_lighting.begin_frame();
+
+    const Entity* player = get_drawn_player();
+    glm::vec2 position = glm::vec2(player->get_interpolated_position(alpha));
+    g_lighting.add_light(position, LANDER_LIGHT_RADIUS, LANDER_LIGHT_COLOUR);
+    if (player->is_engine_firing())
+    {
+        g_lighting.add_light(position - glm::vec2(0.0f, player->get_height() * FLAME_LIGHT_DROP), FLAME_LIGHT_RADIUS, FLAME_LIGHT_COLOUR);
+    }
+    if (g_versus_peer.is_connected()) g_lighting.add_light(glm::vec2(g_versus_lander.get_interpolated_position(alpha)), LANDER_LIGHT_RADIUS, RIVAL_LIGHT_COLOUR);
+    if (g_net_client.is_connected() && g_net_client.has_snapshot())
+    {
+        const NetSnapshot& snapshot = g_net_client.get_snapshot();
+        for (int i = 0; i < snapshot.lander_count; i++)
+        {
+            bool remote = i != g_net_client.get_welcome().lander && (snapshot.landers[i].flags & NET_LANDER_ACTIVE);
+            if (remote) g_lighting.add_light(glm::vec2(g_remote_landers[i].get_position()), LANDER_LIGHT_RADIUS, RIVAL_LIGHT_COLOUR);
+        }
+    }
+
+    glm::vec2 reach_min, reach_max;
+    if (g_game_state.platforms != NULL && g_lighting.get_light_bounds(reach_min, reach_max))
+    {
+        g_lit_platforms.clear();
+        if (g_game_state.platform_broadphase != NULL)
+        {
+            int cursor = -1;
+            g_game_state.platform_broadphase->query(reach_min, reach_max, g_lit_platforms, cursor);
+        }
+        else for (int i = 0; i < g_game_state.platform_count; i++) g_lit_platforms.push_back(i);
+
+        for (int index : g_lit_platforms)
+        {
+            const Entity& platform = g_game_state.platforms[index];
+            if (!platform.is_active()) continue;
+
+            glm::vec2 centre = glm::vec2(platform.get_position()),
+                      half   = glm::vec2(platform.get_width(), platform.get_height()) / 2.0f;
+            g_lighting.add_occluder(centre - half, centre + half);
+        }
+    }
+    g_lighting.render_shadow_maps();
+}
+
+// The world's layers, with the lights multiplied in before the particles, which give off their own
+void flush_world(glm::vec2 view_min, glm::vec2 view_max)
+{
+    if (!g_lighting.is_enabled())
+    {
+        g_render_queue.flush(BACKGROUND_LAYER, HUD_LAYER);
+        return;
+    }
+    g_render_queue.flush(BACKGROUND_LAYER, PARTICLE_LAYER);
+    g_lighting.apply(view_min, view_max);
+    g_render_queue.flush(PARTICLE_LAYER, HUD_LAYER);
+}
+
+void render()
+{
+    //  GENERAL  //
+    // Reads back the GPU timings from a few frames ago, now that they can't stall anything
+    g_gpu_profiler.begin_frame();
+
+    // Every pass timed in a recent frame, HUD and starfield included, picks this frame's resolution
+    float gpu_ms = 0.0f;
+    for (int pass = 0; pass < GpuProfiler::MAX_PASSES; pass++) gpu_ms += g_gpu_profiler.get_pass_ms(pass);
+    g_dynamic_resolution.update(gpu_ms);
+
+    // The governor goes by the slower of the two, neither of which counts the wait for vsync. The
+    // CPU's sections are last frame's, which is as recent as they come.
+    if (g_governor.is_enabled())
+    {
+        float cpu_ms = 0.0f;
+        for (int section = 0; section < PROFILE_SECTION_COUNT; section++) cpu_ms += g_frame_profiler.get_last_ms((ProfileSection)section);
+        if (g_governor.record(std::max(cpu_ms, gpu_ms))) apply_quality_level();
+    }
+
+    // Anything that finished decoding since last frame replaces its placeholder before the draws
+    g_texture_loader.upload(TEXTURE_UPLOAD_BUDGET);
+    g_texture_cache.update(TEXTURE_RELOAD_BUDGET);
+    upload_prefetched_level(PREFETCH_UPLOAD_BUDGET);
+    if (g_terrain_editor.is_attached()) g_terrain_editor.update(CRATER_REBAKE_BUDGET);
+
+    // Hard texel edges while sprites are drawn at native size or larger, trilinear once the camera
+    // is far enough out that texels shrink below a pixel. All of these only touch GL on a change.
+    int scene_width  = g_dynamic_resolution.is_enabled() ? g_dynamic_resolution.get_scene_width()  : g_viewport_width,
+        scene_height = g_dynamic_resolution.is_enabled() ? g_dynamic_resolution.get_scene_height() : g_viewport_height;
+    SamplerPreset sampler = select_sampler_preset(g_projection_matrix, scene_width, TEXELS_PER_UNIT);
+    g_texture_atlas.set_sampler_preset(sampler);
+    g_texture_cache.set_sampler_preset(sampler);
+    if (g_ship_frame_array != 0 && sampler != g_frame_array_sampler)
+    {
+        apply_sampler_preset(g_ship_frame_array, sampler, GL_TEXTURE_2D_ARRAY);
+        g_frame_array_sampler = sampler;
+    }
+
+    // Only redrawn when the level's static geometry changed; before the scene's target is bound
+    if (g_show_minimap)
+    {
+        const Terrain* terrain = g_game_state.terrain != NULL || g_game_state.distance_field != NULL ? &g_level_terrain : NULL;
+        int version = g_game_state.platform_colliders != NULL ? g_game_state.platform_colliders->get_version() : 0;
+        version += g_terrain_editor.get_version();  // a crater redraws the ground
+        g_minimap.update(g_game_state.platforms, g_game_state.platform_count, terrain, version, g_game_state.platform_broadphase);
+    }
+
+    // Everything up to the HUD draws into the scaled-down target, if the GPU has fallen behind. With
+    // post-processing the scene goes into its target instead, whose last pass does the stretching.
+    if (g_post_process.is_active()) g_post_process.begin_scene(scene_width, scene_height);
+    else                             g_dynamic_resolution.begin_scene();
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Only uploads the camera when it has actually moved: one buffer update for every variant
+    // under GLSL 3.30, each variant's uniforms otherwise
+    if (g_camera.get_view_matrix() != g_view_matrix)
+    {
+        g_view_matrix = g_camera.get_view_matrix();
+        g_sprite_shaders.set_view_matrix(g_view_matrix);
+    }
+
+    // What the matrices above actually show, so draw cost follows the screen and not the level
+    glm::vec2 view_min, view_max;
+    get_view_bounds(g_projection_matrix, g_view_matrix, view_min, view_max);
+    if (g_policy_fleet.is_loaded()) g_policy_fleet.set_view(view_min, view_max);  // for the next steps' levels of detail
+    g_texture_streamer.update((view_min.x + view_max.x) / 2.0f + get_course_origin().x, (long long)(g_stream_budget_kb * 1024.0f));
+
+    // The queue is drawn again for the spectator, so what's culled has to be off its wider view too.
+    // The starfield is drawn separately for each, and keeps to the game's.
+    glm::vec2 cull_min = view_min, cull_max = view_max;
+    if (g_spectator.is_open()) get_view_bounds(g_spectator.get_projection_matrix(g_projection_matrix), g_view_matrix, cull_min, cull_max);
+
+    //  STARFIELD  //
+    // Drawn straight over the clear rather than queued, so it is under every layer without needing one
+    if (g_starfield_enabled && g_governor.get_settings().starfield)
+    {
+        g_gpu_profiler.begin_pass(STARFIELD_GPU_PASS);
+        g_starfield.draw(view_min + get_course_origin(), view_max + get_course_origin());  // the sky doesn't move with the origin
+        g_gpu_profiler.end_pass();
+    }
+
+    // Everything below is only queued; flush() sorts by layer, shader and texture and then draws.
+    // The queue and the batch take all of their per-frame memory from the frame arena.
+    g_frame_arena.reset();
+    g_render_queue.begin();
+    g_glyph_cache.begin_frame();
+    g_render_queue.set_cull_bounds(cull_min, cull_max);
+
+    //  BACKDROP  //
+    if (g_backdrop) g_render_queue.submit_custom(BACKGROUND_LAYER, g_shader_program, g_texture_atlas.get_texture_id(), draw_backdrop_tiles, NULL, get_tile_material());
+
+    //  PLAYER  //
+    // Draw between the last two physics steps, by however far the accumulator is into the next one
+    float alpha = g_simulation_thread.is_running() ? g_simulation_thread.get_interpolation_alpha() : interpolation_alpha(g_game_state);
+
+    // With --late-input, the events queued since are run through a copy of the input this late in
+    // the frame, and the lander is drawn where they would have it by now. Only the drawing moves: the simulation gets them through
+    // the input timeline as usual, so it stays deterministic.
+    glm::vec2 predicted = glm::vec2(0.0f);
+    if (g_late_input && !g_autopilot_enabled && !is_level_won() && !is_level_lost())
+    {
+        InputDevices late_input = g_input;
+        late_input.peek_pending();
+        float fixed_timestep = g_game_state.fixed_timestep;
+        predicted = predict_action_offset(*get_drawn_player(), get_held_action(late_input), alpha * fixed_timestep, fixed_timestep);
+    }
+    get_drawn_player()->render(&g_render_queue, alpha, predicted);
+
+    // Behind the lander, all in one instanced draw; the alpha has to outlive this function until the flush
+    static float ghost_alpha;
+    ghost_alpha = alpha;
+    if (g_ghosts.has_ghosts()) g_render_queue.submit_custom(WORLD_LAYER, g_ghosts.get_program(), g_ghosts.get_texture_id(), draw_ghosts, &ghost_alpha);
+    if (g_policy_fleet.is_loaded()) g_render_queue.submit_custom(WORLD_LAYER, g_policy_fleet.get_program(), g_policy_fleet.get_texture_id(), draw_policy_fleet, &ghost_alpha);
+
+    // Under the lander, so the first dot doesn't cover it
+    if (g_show_trajectory && !is_level_won() && !is_level_lost() && g_trajectory.has_path())
+    {
+        g_render_queue.submit_custom(WORLD_LAYER, g_flat_shader_program, 0, draw_trajectory, NULL);
+    }
+
+    //  OTHER PLAYERS  //
+    // Drawn moving from the server's second-newest snapshot to its newest as the next one is due
+    if (g_net_client.is_connected() && g_net_client.has_snapshot())
+    {
+        const NetSnapshot& snapshot = g_net_client.get_snapshot();
+        float remote_alpha = g_net_client.get_snapshot_alpha(get_input_clock());
+        for (int i = 0; i < snapshot.lander_count; i++)
+        {
+            bool remote = i != g_net_client.get_welcome().lander && (snapshot.landers[i].flags & NET_LANDER_ACTIVE);
+            if (remote) g_remote_landers[i].render(&g_render_queue, remote_alpha);
+        }
+    }
+    // ...or stepped right alongside this one
+    if (g_versus_peer.is_connected()) g_versus_lander.render(&g_render_queue, alpha);
+
+    //  PLATFORM  //
+    // One instanced draw for the platforms on screen, or one draw of the baked mesh on drivers
+    // without instancing; the batch is the fallback for both
+    if (g_use_instancing && g_platform_renderer.is_supported())
+    {
+        cull_platform_instances(cull_min, cull_max);
+        g_render_queue.submit_custom(WORLD_LAYER, g_platform_shader_program, g_texture_atlas.get_texture_id(), draw_platform_instances, NULL, get_atlas_material(g_platform_region));
+    }
+    else if (g_bake_platforms && g_baked_platforms.is_baked())
+    {
+        g_baked_platforms.cull(cull_min, cull_max);
+        g_render_queue.submit_custom(WORLD_LAYER, g_shader_program, g_texture_atlas.get_texture_id(), draw_baked_platforms, NULL, get_tile_material());
+    }
+    else submit_visible_platforms(cull_min, cull_max);
+
+    //  LIGHTING  //
+    // The shadow maps go into their own target straight away; the lights wait for the flush
+    if (g_lighting.is_enabled()) gather_lights(alpha);
+
+    //  EXHAUST  //
+    if (g_use_instancing && g_exhaust.is_instanced()) g_render_queue.submit_custom(PARTICLE_LAYER, g_instanced_shader_program, g_exhaust.get_texture_id(), draw_exhaust_instances, NULL);
+    else for (int i = 0; i < g_exhaust.get_instance_count(); i++)
+    {
+        const SpriteInstance& particle = g_exhaust.get_instances()[i];
+        g_render_queue.submit_sprite(PARTICLE_LAYER, particle.offset, particle.scale, particle.uv_rect, g_exhaust.get_texture_id());
+    }
+    if (g_debris.is_active()) g_render_queue.submit_custom(PARTICLE_LAYER, g_instanced_shader_program, g_debris.get_texture_id(), draw_debris, NULL);
+
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+    //  DEBUG LINES  //
+    // Whatever anything added with DEBUG_DRAW_* this frame, over the world, in one draw
+    if (g_show_collision) submit_collision_debug(view_min, view_max);
+    if (!get_debug_draw().is_empty()) g_render_queue.submit_custom(PARTICLE_LAYER, g_debug_line_program, 0, draw_debug_lines, NULL);
+#endif
+
+    //  TEXT  //
+    // Distance-field glyphs, so any screen_size stays sharp from the one small sheet
+    if (g_banner != NULL) draw_banner(*g_banner);
+    if (g_hint != NULL)   draw_banner(*g_hint);
+    if (g_paused && g_banner == NULL) draw_banner(PAUSED_BANNER);
+    {
+        MemoryScope memory(MEMORY_TEXT);
+        if (g_show_profiler) draw_profiler_hud();
+        if (g_show_telemetry) submit_telemetry();
+    }
+    if (g_show_minimap) submit_minimap();
+
+    // The world, stretched over the window, and then the HUD on top at the window's own resolution.
+    // At full resolution there is nothing to do in between, so the HUD can share the world's batch.
+    if (g_post_process.is_active())
+    {
+        flush_world(view_min, view_max);
+        g_gpu_profiler.begin_pass(POST_GPU_PASS);
+        g_post_process.end_scene();
+        g_gpu_profiler.end_pass();
+        g_render_queue.flush(HUD_LAYER);
+    }
+    else if (g_dynamic_resolution.is_enabled() || g_lighting.is_enabled())
+    {
+        flush_world(view_min, view_max);
+        g_dynamic_resolution.end_scene();
+        g_render_queue.flush(HUD_LAYER);
+    }
+    else g_render_queue.flush();
+
+    //  SPECTATOR  //
+    // The queue is still sorted, so the world is drawn a second time from everything already
+    // uploaded, only under the spectator's camera; its layers aren't timed again
+    if (g_spectator.is_open())
+    {
+        g_spectator.begin_scene(g_projection_matrix, g_view_matrix);
+        if (g_starfield_enabled && g_governor.get_settings().starfield) g_starfield.draw(cull_min + get_course_origin(), cull_max + get_course_origin());
+        g_render_queue.set_gpu_profiler(NULL);
+        flush_world(cull_min, cull_max);
+        g_render_queue.set_gpu_profiler(&g_gpu_profiler);
+        g_spectator.end_scene();
+    }
+}
+
+void shutdown()
+{
+    // Quitting mid-load leaves loading threads writing into the globals below
+    g_loading.wait();
+    g_simulation_thread.stop();
+    g_terrain_editor.cleanup();
+    g_net_client.disconnect();
+    if (g_versus_peer.is_connected())
+    {
+        LOG("Rollbacks: " << g_rollback.get_rollback_count() << ", " << g_rollback.get_resimulated_frames()
+            << " frames simulated again, deepest " << g_rollback.get_deepest_rollback());
+    }
+    g_versus_peer.disconnect();
+    g_jobs.reset();
+    if (g_audio_device != 0) SDL_CloseAudioDevice(g_audio_device);
+
+    if (trace_write(TRACE_FILEPATH)) LOG("Trace: " << TRACE_FILEPATH);
+    g_flight_recorder.cleanup();
+    g_save.close();
+    if (g_leaderboard.is_running())
+    {
+        g_leaderboard.stop();
+        LOG("Leaderboard: " << g_leaderboard.get_uploaded_count() << " landings uploaded, " << g_leaderboard.get_spooled_count() << " spooled for next time");
+    }
+    if (g_policy_fleet.is_loaded()) LOG("AI landers: " << g_policy_fleet.get_lander_count() << ", " << g_policy_fleet.get_mean_updates() << " stepped a step, deciding in "
+                                        << g_policy_fleet.get_mean_decide_ms() << " ms on average");
+    if (g_flight_recorder.get_hitch_dump_count() > 0) LOG("Hitches: " << g_flight_recorder.get_hitch_dump_count() << " dumped, the last in " << FLIGHT_HITCH_FILEPATH);
+    if (g_telemetry_log.is_open())
+    {
+        g_telemetry_log.close();
+        LOG("Telemetry: " << g_telemetry_log.get_written_count() << " records in " << g_telemetry_log_path << ", " << g_telemetry_log.get_dropped_count() << " dropped"
+            << (g_telemetry_log.has_write_failed() ? " (writes failed)" : ""));
+    }
+
+    g_frame_pacer.report();
+    g_frame_latency.report();
+    if (g_frame_pacer.get_frame_times().get_frame_count() > 0) g_frame_pacer.get_frame_times().write_report(FRAME_TIMES_FILEPATH);
+    if (g_frame_counters.get_frame_count() > 0) g_frame_counters.write_report(FRAME_COUNTERS_FILEPATH);
+    write_memory_report(MEMORY_REPORT_FILEPATH);
+    LOG("Frame arena: " << g_frame_arena.get_peak() << " bytes at peak in " << g_frame_arena.get_block_count() << " blocks");
+    LOG("Simulation: " << g_game_state.budget.total_steps << " steps, " << g_game_state.budget.over_budget_frames
+        << " frames over budget, " << g_game_state.budget.dropped_seconds << " s of sim time dropped");
+
+    g_autopilot.reset();
+    if (g_prefetch.valid()) g_prefetch.wait();
+    g_gameplay.unload();  // nothing can be running its code now
+    for (LevelSlot& slot : g_level_slots) slot.arena.reset();
+    g_sprite_batch.cleanup();
+    g_platform_renderer.cleanup();
+    g_next_platform_renderer.cleanup();
+    g_baked_platforms.cleanup();
+    g_trajectory.cleanup();
+    g_minimap.cleanup();
+    g_post_process.cleanup();
+    g_lighting.cleanup();
+    g_frame_capture.cleanup();
+    g_spectator.cleanup();
+    g_frame_latency.cleanup();
+#ifdef LANDER_DEBUG_DRAW_ENABLED
+    get_debug_draw().cleanup();
+#endif
+    g_starfield.cleanup();
+    g_exhaust.cleanup();
+    g_ghosts.cleanup();
+    g_policy_fleet.cleanup();
+    g_debris.cleanup();
+    g_backdrop_tiles.cleanup();
+    g_texture_atlas.cleanup();
+    if (g_ship_frame_array != 0) untrack_gpu_textures(1, &g_ship_frame_array);
+    if (g_ship_frame_array != 0) glDeleteTextures(1, &g_ship_frame_array);
+    g_texture_streamer.clear();
+    g_texture_cache.release_all();
+    g_texture_loader.cleanup();
+    g_gpu_profiler.cleanup();
+    g_dynamic_resolution.cleanup();
+    g_asset_pack.close();
+    g_text_meshes.cleanup();
+    g_glyph_cache.cleanup();
+    g_telemetry.cleanup();
+    g_overlay_text.cleanup();
+    destroy_render_backend();
+    g_input.close_all();
+    SDL_Quit();
+}
+
+//  RENDER BENCHMARK  //
+// The same scripted descent drawn into an offscreen target, once through the instanced path and
+// once with everything through the sprite batch. Each frame ends in glFinish, so its time covers
+// the GPU's work and not just the submission. Nothing is presented and the window stays hidden.
+struct RenderBenchResult
+{
+    double average_ms, p99_ms, max_ms;
+    double draw_calls, program_changes, texture_changes;  // per frame
+};
+
+void step_render_bench()
+{
+    // Hover the way the headless controller does, and start over on touchdown so there is
+    // always a lander and its exhaust to draw
+    Entity* player = g_game_state.player;
+    player->set_movement(glm::vec3(0.0f));
+    player->m_booster_active = player->get_velocity().y < -1.0f;
+
+    if (g_game_state.win || g_game_state.loss) replay_level();
+    update_world(seconds_to_ticks(g_simulation_timestep));
+}
+
+RenderBenchResult run_render_bench_pass(int frame_count)
+{
+    replay_level();
+    for (int i = 0; i < RENDER_BENCH_WARMUP_FRAMES; i++)
+    {
+        step_render_bench();
+        render();
+    }
+    glFinish();
+
+    std::vector<double> frame_ms;
+    RenderBenchResult result = {};
+
+    for (int i = 0; i < frame_count; i++)
+    {
+        step_render_bench();
+
+        Uint64 start = SDL_GetPerformanceCounter();
         render();
+        glFinish();
+        frame_ms.push_back(1000.0 * (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency());
+
+        int draw_calls = g_render_queue.get_draw_calls();
+        if (g_use_instancing && g_platform_renderer.is_supported()) draw_calls += g_platform_renderer.get_draw_calls();
+        else if (g_bake_platforms && g_baked_platforms.is_baked())  draw_calls += g_baked_platforms.get_draw_calls();
+        if (g_use_instancing && g_exhaust.is_instanced())          draw_calls += g_exhaust.get_draw_calls();
+        if (g_debris.is_active())                                  draw_calls += g_debris.get_draw_calls();
+        if (g_backdrop)                                            draw_calls += g_backdrop_tiles.get_draw_calls();
+        if (g_starfield_enabled)                                   draw_calls += g_starfield.get_draw_calls();
+        if (g_show_trajectory)                                     draw_calls += g_trajectory.get_draw_calls();
+        if (g_show_profiler)                                       draw_calls += g_overlay_text.get_draw_calls();
+        if (g_show_minimap)                                        draw_calls += g_minimap.get_draw_calls();
+
+        result.draw_calls      += draw_calls;
+        result.program_changes += g_render_queue.get_program_changes();
+        result.texture_changes += g_render_queue.get_texture_changes();
+    }
+
+    std::sort(frame_ms.begin(), frame_ms.end());
+    for (double ms : frame_ms) result.average_ms += ms;
+
+    result.average_ms      /= frame_count;
+    result.p99_ms           = frame_ms[std::min(frame_count - 1, (int)(frame_count * 0.99))];
+    result.max_ms           = frame_ms.back();
+    result.draw_calls      /= frame_count;
+    result.program_changes /= frame_count;
+    result.texture_changes /= frame_count;
+    return result;
+}
+
+int run_render_bench(int frame_count)
+{
+    // No splash to show, so the whole load runs back to back
+    while (!g_loading.run(LOADING_STEP_BUDGET)) {}
+
+    OffscreenTarget target;
+    if (!target.initialise(g_viewport_width, g_viewport_height))
+    {
+        LOG("Render bench: this driver can't render offscreen");
+        return 1;
+    }
+    target.bind();
+
+    LOG("Render bench: " << frame_count << " frames per pass, " << g_game_state.platform_count << " platforms ("
+        << get_scene_layout_name(g_scene.layout) << "), GL " << gl_version() / 10 << "." << gl_version() % 10);
+
+    // The baked pass only differs from the batched one in how the platforms are drawn
+    const char* const PASS_NAMES[] = { "instanced", "baked", "batched" };
+    for (int pass = 0; pass < 3; pass++)
+    {
+        g_use_instancing = pass == 0;
+        g_bake_platforms = pass != 2;
+        if (g_use_instancing && !g_platform_renderer.is_supported())
+        {
+            LOG("Render bench (" << PASS_NAMES[pass] << "): skipped, no instancing on this driver");
+            continue;
+        }
+
+        RenderBenchResult result = run_render_bench_pass(frame_count);
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "Render bench (%s): %.3f ms/frame avg, %.3f p99, %.3f max; %.1f draw calls, %.1f program changes, %.1f texture changes per frame",
+                      PASS_NAMES[pass], result.average_ms, result.p99_ms, result.max_ms, result.draw_calls, result.program_changes, result.texture_changes);
+        LOG(line);
+    }
+
+    g_use_instancing = true;
+    g_bake_platforms = true;
+    target.unbind();
+    target.cleanup();
+    return 0;
+}
+
+//  OBSERVATION BENCHMARK  //
+// Many headless worlds stepped side by side and rendered as 84x84 pixel observations, one
+// tiled batch per step, to see how many observations a second the GPU and readback sustain
+int run_observation_bench(int env_count)
+{
+    while (!g_loading.run(LOADING_STEP_BUDGET)) {}
+
+    ObservationSprites sprites;
+    sprites.texture_id = g_texture_atlas.get_texture_id();
+    for (int level = Entity::IDLE; level <= Entity::HIGH; level++) sprites.ship_frames[level] = g_ship_frames[level];
+    sprites.win_platform = g_texture_atlas.get_region(g_win_region).uv_rect;
+    sprites.death_platform = g_texture_atlas.get_region(g_death_region).uv_rect;
+
+    ObservationRenderer renderer;
+    if (!renderer.initialise(&g_sprite_shaders, sprites, OBSERVATION_TILE_SIZE, OBSERVATION_TILE_SIZE, env_count,
+                             OBSERVATION_VIEW_MIN, OBSERVATION_VIEW_MAX))
+    {
+        LOG("Observation bench: this driver can't render offscreen with instancing");
+        return 1;
+    }
+
+    // STEP 1: One world per env, each on its own seed of the current scene
+    std::vector<std::unique_ptr<World>> worlds;
+    std::vector<const GameState*> states;
+    for (int i = 0; i < env_count; i++)
+    {
+        worlds.emplace_back(new World(g_scene.platform_count));
+        World& world = *worlds.back();
+
+        setup_player(&world.player);
+        generate_scene(world.state.platforms, g_scene, RENDER_BENCH_SEED + i);
+        world.colliders.build(world.state.platforms, world.state.platform_count);
+        reset_episode(world.state);
+        states.push_back(&world.state);
+    }
+
+    std::vector<unsigned char> observations((size_t)env_count * renderer.get_observation_size());
+    long long observation_count = 0;
+
+    // STEP 2: Step, render, and collect the batch before; the final glFinish charges the GPU's share
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int batch = 0; batch < OBSERVATION_BENCH_BATCHES; batch++)
+    {
+        for (std::unique_ptr<World>& world : worlds)
+        {
+            GameState& state = world->state;
+            if (state.win || state.loss) reset_episode(state);
+
+            state.player->m_booster_active = state.player->get_velocity().y < -1.0f;
+            step_simulation(state, g_simulation_timestep);
+        }
+
+        renderer.render_batch(states.data(), env_count);
+        observation_count += renderer.read_observations(observations.data());
+    }
+    glFinish();
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "Observation bench: %d envs at %dx%d, %.3f ms/batch, %.0f observations/s (%s readback)",
+                  env_count, OBSERVATION_TILE_SIZE, OBSERVATION_TILE_SIZE, 1000.0 * seconds / OBSERVATION_BENCH_BATCHES,
+                  observation_count / seconds, renderer.uses_pixel_buffers() ? "PBO" : "synchronous");
+    LOG(line);
+
+    renderer.cleanup();
+    return 0;
+}
+
+// BatchedLanderSim's outcome in GpuLanderSim's terms, or GPU_LANDER_FLYING
+int get_batched_outcome(const BatchedLanderSim& sim, int lander, int steps)
+{
+    if (sim.has_won(lander))           return GPU_LANDER_WON;
+    if (sim.is_out_of_bounds(lander))  return GPU_LANDER_OUT_OF_BOUNDS;
+    if (sim.has_lost(lander))          return GPU_LANDER_CRASHED;
+    if (steps >= GPU_SIM_BENCH_MAX_STEPS) return GPU_LANDER_TIMED_OUT;
+    return GPU_LANDER_FLYING;
+}
+
+// GpuLanderSim's steps against BatchedLanderSim's on the same sweep, and whether they land the
+// same way: only the first few thousand go on the CPU, so its rate is per lander like the GPU's
+int run_gpu_sim_bench(int lander_count)
+{
+    while (!g_loading.run(LOADING_STEP_BUDGET)) {}
+
+    if (!GpuLanderSim::is_supported())
+    {
+        LOG("GPU sim bench: this driver has no GLSL 3.30, so no transform feedback or geometry shaders");
+        return 1;
+    }
+
+    // STEP 1: The bench level, and every lander somewhere along the top of the view with a
+    //         stick and a gravity of its own
+    std::vector<Entity> platforms(g_scene.platform_count);
+    generate_scene(platforms.data(), g_scene, RENDER_BENCH_SEED);
+
+    Entity prototype;
+    setup_player(&prototype);
+
+    Rng rng(RENDER_BENCH_SEED);
+    std::vector<GpuLanderSetup> setups(lander_count);
+    for (GpuLanderSetup& setup : setups)
+    {
+        setup.spawn      = glm::vec2(OBSERVATION_VIEW_MIN.x + rng.next_float() * (OBSERVATION_VIEW_MAX.x - OBSERVATION_VIEW_MIN.x), 3.0f);
+        setup.movement_x = 2.0f * rng.next_float() - 1.0f;
+        setup.gravity    = ACC_OF_GRAVITY * (0.5f + rng.next_float());
+    }
+
+    GpuLanderSim gpu;
+    if (!gpu.initialise(prototype, setups.data(), lander_count, GPU_SIM_BENCH_MAX_STEPS)) return 1;
+    gpu.set_platforms(platforms.data(), g_scene.platform_count);
+    gpu.set_bounds(OBSERVATION_VIEW_MIN, OBSERVATION_VIEW_MAX);
+
+    // STEP 2: The GPU's run, the one glFinish at the end charging the last steps
+    std::vector<GpuLanderResult> results;
+    glFinish();
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (int step = 1; step <= GPU_SIM_BENCH_STEPS; step++)
+    {
+        gpu.step(g_simulation_timestep);
+        if (step % GPU_SIM_BENCH_COLLECT_STEPS == 0) gpu.collect(results);
+    }
+    glFinish();
+    double gpu_seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    // STEP 3: The first few on the CPU, relaunched on the same beat, with each one's first episode kept
+    int checked = std::min(lander_count, GPU_SIM_BENCH_CHECKED);
+    BatchedLanderSim cpu;
+    cpu.initialise(prototype, checked);
+    cpu.set_platforms(platforms.data(), g_scene.platform_count);
+    cpu.set_bounds(OBSERVATION_VIEW_MIN, OBSERVATION_VIEW_MAX);
+    for (int i = 0; i < checked; i++)
+    {
+        cpu.reset(i, glm::vec3(setups[i].spawn, 0.0f), setups[i].gravity);
+        cpu.set_controls(i, setups[i].movement_x, setups[i].booster_active);
+    }
+
+    std::vector<int> steps(checked, 0),
+                     first_outcome(checked, GPU_LANDER_FLYING),
+                     first_steps(checked, 0);
+    std::vector<bool> finished(checked, false);
+    start = SDL_GetPerformanceCounter();
+    for (int step = 1; step <= GPU_SIM_BENCH_STEPS; step++)
+    {
+        cpu.step(g_simulation_timestep);
+        for (int i = 0; i < checked; i++)
+        {
+            if (finished[i]) continue;
+
+            int outcome = get_batched_outcome(cpu, i, ++steps[i]);
+            if (outcome == GPU_LANDER_FLYING) continue;
+            finished[i] = true;
+            if (first_outcome[i] != GPU_LANDER_FLYING) continue;
+            first_outcome[i] = outcome;
+            first_steps[i] = steps[i];
+        }
+        if (step % GPU_SIM_BENCH_COLLECT_STEPS != 0) continue;
+
+        for (int i = 0; i < checked; i++)
+        {
+            if (!finished[i]) continue;
+            cpu.reset(i, glm::vec3(setups[i].spawn, 0.0f), setups[i].gravity);
+            steps[i] = 0;
+            finished[i] = false;
+        }
+    }
+    double cpu_seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+    // STEP 4: Same outcome on the same step, for every first episode the GPU finished
+    int compared = 0, agreed = 0;
+    for (const GpuLanderResult& result : results)
+    {
+        if (result.episode != 0 || result.lander >= checked) continue;
+        compared++;
+        if (result.outcome == first_outcome[result.lander] && result.steps == first_steps[result.lander]) agreed++;
+    }
+
+    char line[320];
+    std::snprintf(line, sizeof(line), "GPU sim bench: %d landers, %.3f ms/step, %.3g lander steps/s against %.3g on BatchedLanderSim; "
+                  "%d episodes read back; %d of %d first episodes agree with the CPU",
+                  lander_count, 1000.0 * gpu_seconds / GPU_SIM_BENCH_STEPS, (double)lander_count * GPU_SIM_BENCH_STEPS / gpu_seconds,
+                  (double)checked * GPU_SIM_BENCH_STEPS / cpu_seconds, (int)results.size(), agreed, compared);
+    LOG(line);
+
+    gpu.cleanup();
+    return 0;
+}
+
+//  DRIVER GAME LOOP  /
+// Once as each tag goes over its budget, rather than every frame it stays there
+void warn_memory_budgets()
+{
+    unsigned int crossed = check_memory_budgets();
+    for (int tag = 0; crossed != 0 && tag < MEMORY_TAG_COUNT; tag++)
+    {
+        if (!(crossed & (1u << tag))) continue;
+
+        MemoryUsage usage = get_memory_usage((MemoryTag)tag);
+        LOG("Memory: " << get_memory_tag_name((MemoryTag)tag) << " over budget, " << usage.cpu_bytes / BYTES_PER_MB << " MB CPU of "
+            << get_cpu_budget((MemoryTag)tag) / BYTES_PER_MB << ", " << usage.gpu_bytes / BYTES_PER_MB << " MB GPU of " << get_gpu_budget((MemoryTag)tag) / BYTES_PER_MB);
+    }
+}
+
+// One pass of the loop: the splash while loading, then input, update, render and the swap. The
+// desktop calls it in a loop; the browser calls it back once a display frame, since blocking its
+// main thread would freeze the page.
+void run_frame()
+{
+    // Once a frame of the idle state is on screen, there's no point drawing it again until
+    // something happens, so the loop sleeps in SDL until then instead of spinning out frames
+    if (g_loading.is_finished() && is_idle())
+    {
+        // The simulation thread has nothing left to step either
+        g_simulation_thread.stop();
+
+        // ...and wakes in time for the next flow timer, which pausing holds back
+        if (g_idle_frame_drawn)
+        {
+            TRACE_ZONE("idle");
+            double timeout = IDLE_REDRAW_SECONDS,
+                   until_timer = g_flow.get_seconds_until_timer();
+            if (!g_paused && until_timer >= 0.0) timeout = std::min(timeout, until_timer);
+#ifdef __EMSCRIPTEN__
+            // The browser calls back every display frame and can't be blocked in, so an idle
+            // callback with nothing new just hands straight back
+            if (!g_frame_pacer.poll_for_event(timeout)) return;
+#else
+            g_frame_pacer.wait_for_event(timeout);
+#endif
+        }
+        g_idle_frame_drawn = true;
+    }
+    else
+    {
+        g_idle_frame_drawn = false;
+    }
+
+    g_frame_pacer.begin_frame();
+    TRACE_FRAME();
+
+    if (!g_loading.is_finished())
+    {
+        TRACE_ZONE("loading");
+        // Splash frames until the last step is in; the game takes over from the next frame, and
+        // its clock starts there so the first step doesn't swallow the whole load
+        process_loading_input();
+        if (g_loading.run(LOADING_STEP_BUDGET))
+        {
+            // Splash frames are slow by design, so frame pacing is judged on the game alone
+            g_frame_clock.reset();
+            g_frame_pacer.clear_frame_times();
+            start_simulation_thread();
+            start_level_flow();
+        }
+        render_loading();
+    }
+    else
+    {
+        // Ahead of reading input, so what's read is as fresh as the queue allows
+        {
+            TRACE_ZONE("latency");
+            g_frame_latency.begin_frame();
+        }
+
+        // The swap is left out of the render time, since with vsync on it mostly measures the wait
+        g_frame_profiler.begin_frame();
+        g_frame_counters.begin_frame();
+        if (g_frame_counters.get_frame_count() > 0) record_frame_telemetry();
+        {
+            FrameProfiler::Scope section(g_frame_profiler, PROFILE_INPUT);
+            TRACE_ZONE("input");
+            process_input();
+        }
+        {
+            FrameProfiler::Scope section(g_frame_profiler, PROFILE_UPDATE);
+            TRACE_ZONE("update");
+            MemoryScope memory(MEMORY_ENTITIES);
+            update();
+        }
+        {
+            FrameProfiler::Scope section(g_frame_profiler, PROFILE_RENDER);
+            TRACE_ZONE("render");
+            MemoryScope memory(MEMORY_RENDER);
+            render();
+            g_frame_capture.end_frame();
+        }
+        {
+            TRACE_ZONE("swap");
+            SDL_GL_SwapWindow(g_display_window);
+            g_frame_latency.end_frame();
+            g_spectator.present();
+        }
+        g_frame_counters.end_frame();
+        warn_memory_budgets();
+
+        // The report closes on the first game frame, so its total is the real time-to-first-frame
+        if (!g_startup_reported)
+        {
+            g_startup_profiler.report();
+            g_startup_profiler.write_json(STARTUP_REPORT_FILEPATH);
+            g_startup_reported = true;
+        }
+    }
+
+    // Sleeps off whatever is left of the frame instead of spinning straight into the next one
+    TRACE_ZONE("pace");
+    g_frame_pacer.end_frame();
+
+#ifdef __EMSCRIPTEN__
+    // There's no process to exit, so quitting stops the callbacks and releases what it can
+    if (!g_game_is_running)
+    {
+        emscripten_cancel_main_loop();
+        shutdown();
+    }
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+    // --shaders <directory> compiles the GLSL from disk instead of the embedded copies, for shader work.
+    // --platforms <count> and --layout <classic|uniform|clustered|terrain> swap the level for a
+    // generated scene, for timing frames against world size.
+    // --min-win-chance <0..1> re-rolls a generated level the reference pilot lands on less often
+    // than that (a quarter of the time by default), within a few hundredths of a second; 0 turns it off.
+    // --level <file.lvl> plays a level packed by LevelPacker.
+    // --endless swaps the level for a course that streams in chunks as the camera follows the player.
+    // --backdrop hangs a tiled cave ceiling behind the level, each stretch of it rock or stone,
+    // streamed in from the asset pack a mip level at a time as the camera comes near.
+    // --sdf collides with a level file's terrain through a baked signed distance field.
+    // --craters has a crash dig a crater into a level file's terrain, there until the level is replayed.
+    // --editor lets the mouse drag static platforms about while the level runs; an edited level is
+    // practice, kept from replays, progress and the leaderboard.
+    // --serial steps the simulation on the main thread between frames, as it was before it had its own.
+    // --jobs <n> runs each frame's independent work on n threads (0 for one per core) instead of just this one.
+    // --no-starfield turns off the procedural stars drawn behind everything.
+    // --no-audio plays no sound and leaves the audio device alone.
+    // --late-input reads the keys and controllers again just before drawing and moves the drawn lander to match.
+    // --trajectory dots the path the lander would take with no keys held, to where it comes down.
+    // --rewind is practice: holding backspace (or a controller's left shoulder) runs the last 10 seconds back, crashes included.
+    // --ghosts <directory> flies the best 100 replays there (by steps taken) alongside the player,
+    // starting on the best one's level.
+    // --policy <file> flies AI landers alongside the player with a trained network (see PolicyNetwork.h),
+    // all of them deciding in one batched evaluation a step; --ai-landers <n> is how many (32 by default).
+    // --gameplay <library> steps the simulation and generates levels through a LanderGameplay module
+    // (gameplay_module.cpp), swapping in each rebuild of it while the game runs, for tuning physics.
+    // --tuning <file> reads the timestep, platform count, step budget and the lander's speed, booster,
+    // drag and gravity from a text file (see TuningConfig.h), and rereads it whenever it's saved.
+    // Thousands make a busy spaceport: only those near the screen step every step (see PolicyFleet.h).
+    // --telemetry-log <file> records each frame's times, counters and the lander's state in a
+    // binary log, written on a thread of its own; TelemetryDecoder turns it into CSV.
+    // --leaderboard <http://host:port/path> posts each landing's time there from a thread of its own,
+    // batched, retried and spooled to disk while the service can't be reached; --player <name> is
+    // the name they go up under. Practice and the autopilot don't count, and neither do --level
+    // files, endless courses or games online.
+    // --hitch-ms <ms> is how long a frame runs before the flight recorder dumps the seconds leading up
+    // to it (100 by default, 0 for never); it dumps them on a crash regardless.
+    // --minimap keeps a small map of the whole level on the HUD; --endless has it on regardless.
+    // --core-profile renders through an OpenGL 3.3 core context where the driver has one.
+    // --frame-arrays draws the ship's animation frames from the layers of a texture array.
+    // --gles2 renders through an OpenGL ES 2.0 context where the platform has one.
+    // --dynamic-resolution lowers the world's resolution while the GPU is over budget; the HUD stays sharp.
+    // --governor steps down through fewer post effects, particles, resolution and stars while
+    // frames run over budget, and back up once there's room again.
+    // --lighting puts a lamp on every lander and a light under the flame, shadowed by the platforms.
+    // --post <bloom,vignette,crt> runs those full-screen effects over the world, merged into as few
+    // passes as they allow; --post-unmerged gives each its own, for comparing.
+    // --blend-all blends every sprite, as before opaque ones were drawn unblended, for comparing fill rate.
+    // --separate-text draws queued text with its own SDF shader rather than in the sprites' batches.
+    // --connect <host:port> joins a game hosted by LanderHeadless --serve, on the server's level.
+    // --versus <port> <host:port> plays head to head against another copy of the game run with
+    // the ports the other way round, e.g. --versus 7778 localhost:7779 and --versus 7779 localhost:7778.
+    // --memory-budget <tag>=<cpu MB>[,<gpu MB>] warns when that part of the game holds more than that
+    // (tags: entities, render, text, audio, assets, untagged); live totals are on the F3 overlay and
+    // the peaks go into memory_report.json at exit.
+    // --record starts recording the game straight away, as F10 does; F12 takes a screenshot. Both
+    // go into captures/, recordings as raw RGBA frames in one file unless --capture-format png
+    // asks for a numbered PNG sequence.
+    // --texture-budget <MB> is how much VRAM load_texture()'s textures may hold before the ones
+    // drawn least recently are evicted, to be reloaded when they're next drawn (0 for never).
+    // --stream-budget <KB> is how much of the textures a level places, mip levels from the asset
+    // pack nearest the camera first, may be uploaded in one frame (256 by default).
+    // --display <windowed|borderless|exclusive> puts the game fullscreen at the display's resolution,
+    // the view widening to its shape; exclusive keeps the compositor out of the way.
+    // --vsync <adaptive|on|off> is how swaps wait for the display (adaptive by default).
+    // --max-queued-frames <1..3> has each frame wait, before reading input, for the GPU to be within
+    // that many frames of it, so input isn't read further ahead of the screen; 1 is the least latency.
+    // Input-to-GPU latency goes in the report at exit either way.
+    // --spectator <zoom> opens a second window, on the second display if there is one, showing the
+    // world from <zoom> times further out (at least 1), for an audience.
+    // --render-bench <frames> times the renderer offscreen in a hidden window, then quits.
+    // --observation-bench <envs> does the same for batched pixel observations of that many envs.
+    // --gpu-sim-bench <landers> steps that many landers on the GPU and compares against the CPU.
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+    {
+        set_memory_budget((MemoryTag)tag, (long long)(MEMORY_BUDGETS_MB[tag][0] * BYTES_PER_MB), (long long)(MEMORY_BUDGETS_MB[tag][1] * BYTES_PER_MB));
+    }
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        std::string_view option = argv[i];
+
+        if (option == "--shaders")   ShaderProgram::set_source_override(argv[i + 1]);
+        if (option == "--jobs")      g_job_threads = std::max(0, atoi(argv[i + 1]));
+        if (option == "--render-bench") g_render_bench_frames = std::max(1, atoi(argv[i + 1]));
+        if (option == "--observation-bench") g_observation_bench_envs = std::max(1, atoi(argv[i + 1]));
+        if (option == "--gpu-sim-bench") g_gpu_sim_bench_landers = std::max(1, atoi(argv[i + 1]));
+        if (option == "--min-win-chance") g_min_win_chance = std::clamp((float)atof(argv[i + 1]), 0.0f, 1.0f);
+        if (option == "--platforms") g_scene.platform_count = std::max(1, atoi(argv[i + 1]));
+        if (option == "--layout" && !parse_scene_layout(argv[i + 1], g_scene.layout)) LOG("Unknown layout " << argv[i + 1] << "; using classic");
+        if (option == "--level" && !g_level_file.open(argv[i + 1])) LOG("Unable to open level " << argv[i + 1] << "; using the generated one");
+        if (option == "--connect")   g_net_address = argv[i + 1];
+        if (option == "--ghosts")    g_ghost_directory = argv[i + 1];
+        if (option == "--policy")    g_policy_filepath = argv[i + 1];
+        if (option == "--gameplay")  g_gameplay_filepath = argv[i + 1];
+        if (option == "--tuning")    g_tuning_filepath = argv[i + 1];
+        if (option == "--ai-landers") g_ai_lander_count = std::max(1, atoi(argv[i + 1]));
+        if (option == "--telemetry-log") g_telemetry_log_path = argv[i + 1];
+        if (option == "--leaderboard") g_leaderboard_url = argv[i + 1];
+        if (option == "--player")    g_player_name = argv[i + 1];
+        if (option == "--hitch-ms")  g_hitch_ms = std::max(0.0f, (float)atof(argv[i + 1]));
+        if (option == "--capture-format") g_capture_format = std::string_view(argv[i + 1]) == "png" ? CAPTURE_PNG : CAPTURE_RAW;
+        if (option == "--texture-budget") g_texture_budget_mb = std::max(0.0f, (float)atof(argv[i + 1]));
+        if (option == "--stream-budget") g_stream_budget_kb = std::max(0.0f, (float)atof(argv[i + 1]));
+        if (option == "--display" && !parse_display_mode(argv[i + 1], g_display_mode)) LOG("Unknown display mode " << argv[i + 1] << "; windowed");
+        if (option == "--vsync" && !parse_vsync_mode(argv[i + 1], g_vsync_mode)) LOG("Unknown vsync mode " << argv[i + 1] << "; adaptive");
+        if (option == "--max-queued-frames") g_max_queued_frames = std::clamp(atoi(argv[i + 1]), 0, FrameLatency::MAX_QUEUED_FRAMES);
+        if (option == "--spectator") g_spectator_zoom = std::max(1.0f, (float)atof(argv[i + 1]));
+        if (option == "--memory-budget" && !parse_memory_budget(argv[i + 1])) LOG("Unknown memory budget " << argv[i + 1] << "; want e.g. assets=64,96");
+        if (option == "--post" && (g_post_effects = PostProcess::parse_effects(argv[i + 1])) == 0) LOG("Unknown effects " << argv[i + 1] << "; drawing without post-processing");
+        if (option == "--versus" && i + 2 < argc)
+        {
+            g_versus_port = (uint16_t)atoi(argv[i + 1]);
+            g_versus_address = argv[i + 2];
+        }
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string_view(argv[i]) == "--endless")  g_endless = true;
+        if (std::string_view(argv[i]) == "--backdrop") g_backdrop = true;
+        if (std::string_view(argv[i]) == "--no-starfield") g_starfield_enabled = false;
+        if (std::string_view(argv[i]) == "--sdf") g_use_distance_field = true;
+        if (std::string_view(argv[i]) == "--craters") g_craters = true;
+        if (std::string_view(argv[i]) == "--editor")  g_editor = true;
+        if (std::string_view(argv[i]) == "--serial") g_threaded_simulation = false;
+        if (std::string_view(argv[i]) == "--late-input") g_late_input = true;
+        if (std::string_view(argv[i]) == "--trajectory") g_show_trajectory = true;
+        if (std::string_view(argv[i]) == "--minimap")    g_show_minimap = true;
+        if (std::string_view(argv[i]) == "--post-unmerged") g_post_unmerged = true;
+        if (std::string_view(argv[i]) == "--lighting") g_lighting_enabled = true;
+        if (std::string_view(argv[i]) == "--core-profile") g_core_profile = true;
+        if (std::string_view(argv[i]) == "--frame-arrays") g_frame_arrays = true;
+        if (std::string_view(argv[i]) == "--separate-text") g_separate_text = true;
+        if (std::string_view(argv[i]) == "--gles2") g_gles2 = true;
+        if (std::string_view(argv[i]) == "--dynamic-resolution") g_dynamic_resolution_enabled = true;
+        if (std::string_view(argv[i]) == "--governor") g_governor_enabled = true;
+        if (std::string_view(argv[i]) == "--record") g_record_from_start = true;
+        if (std::string_view(argv[i]) == "--blend-all") g_blend_all = true;
+        if (std::string_view(argv[i]) == "--no-audio") g_audio_enabled = false;
+        if (std::string_view(argv[i]) == "--rewind") g_rewind_enabled = true;
+    }
+
+    // Online play joins before anything loads, since the server picks the level, and steps on this
+    // thread, where the snapshots arrive
+    if (g_net_address != NULL && !is_benchmarking())
+    {
+        if (g_net_client.connect(g_net_address, NET_CONNECT_TIMEOUT))
+        {
+            g_scene = g_net_client.get_welcome().scene;
+            g_level_file.close();
+            g_endless = false;
+            g_threaded_simulation = false;
+            LOG("Connected to " << g_net_address << " as player " << g_net_client.get_welcome().lander + 1);
+        }
+        else LOG("Unable to join " << g_net_address << "; playing alone");
+    }
+    if (g_versus_address != NULL && g_net_address == NULL && !is_benchmarking())
+    {
+        if (g_versus_peer.connect(g_versus_port, g_versus_address, std::random_device{}(), g_scene, VERSUS_CONNECT_TIMEOUT))
+        {
+            g_scene = g_versus_peer.get_scene();
+            g_level_file.close();
+            g_endless = false;
+            g_threaded_simulation = false;
+            LOG("Playing " << g_versus_address);
+        }
+        else LOG("No answer from " << g_versus_address << "; playing alone");
+    }
+
+    // The benchmarks script the lander from the main thread, an endless course streams its
+    // platforms from there as the camera moves, and craters edit the ground the simulation reads,
+    // so all of those keep the simulation on it too
+    if (g_endless || g_craters || is_benchmarking()) g_threaded_simulation = false;
+    if (g_endless) g_show_minimap = true;  // the level is never all on screen
+
+    // Tuning goes in before the rewind buffer is sized by the timestep, and alone, like --gameplay
+    if (g_tuning_filepath != NULL && !is_online() && !is_benchmarking())
+    {
+        if (!g_tuning.load(g_tuning_filepath)) LOG("Tuning: " << g_tuning.get_error() << "; using the built-in values until it's fixed");
+        else LOG("Tuning from " << g_tuning_filepath << ", reread whenever it's saved");
+        apply_world_tuning();
+    }
+
+    // The editor moves platforms the simulation reads between frames, so it keeps the simulation
+    // on this thread too. Not against anyone else, nor on a course that streams its platforms away.
+    g_editor = g_editor && !is_online() && !g_endless && !is_benchmarking();
+    if (g_editor) g_threaded_simulation = false;
+
+    // Practice rewinds g_game_state between frames, so the simulation stays on this thread. Not
+    // against anyone else, nor on a course that streams away what it would rewind to, nor with the
+    // editor, since a rewind would put edited platforms back behind the broadphase's back.
+    g_rewind_enabled = g_rewind_enabled && !is_online() && !g_endless && !is_benchmarking() && !g_editor;
+    if (g_rewind_enabled)
+    {
+        g_threaded_simulation = false;
+        g_rewind.initialise((int)(REWIND_SECONDS / g_simulation_timestep + 0.5f));
     }
 
+    // Ghosts step alongside the player's steps, on this thread, and the game starts on the best
+    // one's level; the rest only fly when their level comes round
+    if (g_ghost_directory != NULL && !is_online() && !g_endless && !g_level_file.is_open() && !is_benchmarking())
+    {
+        if (g_ghosts.load(g_ghost_directory, g_simulation_timestep) == 0) LOG("No replays in " << g_ghost_directory << "; flying alone");
+        else
+        {
+            g_scene = g_ghosts.get_best_scene();
+            g_threaded_simulation = false;
+            LOG(g_ghosts.get_ghost_count() << " ghosts from " << g_ghost_directory);
+        }
+    }
+
+    // AI landers step alongside the player's steps too, so also on this thread
+    if (g_policy_filepath != NULL && !is_online() && !is_benchmarking())
+    {
+        if (!g_policy_fleet.load(g_policy_filepath, g_ai_lander_count)) LOG("Unable to load a policy from " << g_policy_filepath << "; flying alone");
+        else
+        {
+            g_threaded_simulation = false;
+            const PolicyNetwork& network = g_policy_fleet.get_network();
+            LOG(g_policy_fleet.get_lander_count() << " AI landers on a " << network.get_layer_count() << "-layer policy, "
+                << network.get_weight_count() << " weights, " << get_policy_kernel_name() << " kernels");
+        }
+    }
+    // Only alone: the server and the other player step with the code they were built with
+    if (g_gameplay_filepath != NULL && !is_online() && !is_benchmarking())
+    {
+        if (!g_gameplay.load(g_gameplay_filepath)) LOG("Unable to load gameplay from " << g_gameplay_filepath << "; using the built-in physics");
+        else
+        {
+            g_game_state.step = g_gameplay.get_api().step_simulation;
+            LOG("Gameplay from " << g_gameplay_filepath << ", reloaded whenever it's rebuilt");
+        }
+    }
+    if (is_benchmarking()) g_audio_enabled = false;
+    g_flight_recorder.initialise(FLIGHT_CRASH_FILEPATH, FLIGHT_HITCH_FILEPATH, g_hitch_ms);
+
+    // Benchmarks measure the defaults, and leave the player's save alone
+    if (!is_benchmarking())
+    {
+        if (!g_save.open(SAVE_FILEPATH)) LOG("Unable to write " << SAVE_FILEPATH << "; nothing will be saved");
+        load_settings();
+    }
+    if (g_leaderboard_url != NULL && !is_online() && !g_endless && !g_level_file.is_open() && !is_benchmarking()
+        && !g_leaderboard.start(g_leaderboard_url, LEADERBOARD_SPOOL_FILEPATH))
+    {
+        LOG("Unable to use leaderboard " << g_leaderboard_url << "; it takes an http:// address (https through a local proxy)");
+    }
+    if (g_telemetry_log_path != NULL && !is_benchmarking() && !g_telemetry_log.open(g_telemetry_log_path))
+    {
+        LOG("Unable to write telemetry to " << g_telemetry_log_path);
+    }
+
+    g_jobs.reset(new JobSystem(g_job_threads));
+
+    // The benchmarks steer the lander themselves, once a frame. Otherwise every step is hashed,
+    // for replays to be checked against.
+    if (!is_benchmarking())
+    {
+        g_game_state.before_step = apply_step_input;
+        g_game_state.hash_steps = true;
+    }
+    initialise();
+
+    if (g_render_bench_frames > 0)
+    {
+        int result = run_render_bench(g_render_bench_frames);
+        shutdown();
+        return result;
+    }
+    if (g_observation_bench_envs > 0)
+    {
+        int result = run_observation_bench(g_observation_bench_envs);
+        shutdown();
+        return result;
+    }
+    if (g_gpu_sim_bench_landers > 0)
+    {
+        int result = run_gpu_sim_bench(g_gpu_sim_bench_landers);
+        shutdown();
+        return result;
+    }
+
+#ifdef __EMSCRIPTEN__
+    // Never returns: the browser owns the loop from here, and shutdown comes from run_frame
+    emscripten_set_main_loop(run_frame, 0, 1);
+#else
+    while (g_game_is_running) run_frame();
+#endif
+
     shutdown();
     return 0;
 }
@@ -0,0 +1,135 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Offline level packer: turns a hand-written level description, or a generated scene of any
+// size, into a .lvl that the game maps with --level.
+//
+//     LevelPacker <output.lvl> <level.txt>
+//     LevelPacker <output.lvl> --generate <classic|uniform|clustered|terrain> <platforms> <seed>
+//
+// A description has one item per line; # starts a comment:
+//
+//     spawn    0 3
+//     platform -4 -3 death          # x y win|death [width height]
+//     platform -3 -1 win 2 1
+//     terrain  -20 0.25             # origin x and spacing of the samples that follow
+//     height   -2.5
+//     height   -2.5 pad             # the segment from this sample to the next is a landing pad
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "LevelFile.h"
+#include "SceneGenerator.h"
+
+static bool read_description(const char* filepath, LevelData& level)
+{
+    std::ifstream input(filepath);
+    if (!input)
+    {
+        std::cout << "Unable to open " << filepath << "." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    for (int line_number = 1; std::getline(input, line); line_number++)
+    {
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) continue;
+
+        bool ok = false;
+        if (keyword == "spawn") ok = (bool)(fields >> level.spawn.x >> level.spawn.y);
+        else if (keyword == "platform")
+        {
+            LevelPlatform platform = {};
+            std::string type;
+            platform.width = platform.height = 1.0f;
+
+            ok = (bool)(fields >> platform.x >> platform.y >> type) && (type == "win" || type == "death");
+            if (ok && fields >> platform.width) ok = (bool)(fields >> platform.height);
+            platform.entity_type = type == "win" ? WIN_PLATFORM : DEATH_PLATFORM;
+
+            level.platforms.push_back(platform);
+        }
+        else if (keyword == "terrain") ok = (bool)(fields >> level.terrain_origin_x >> level.terrain_spacing) && level.terrain_spacing > 0.0f;
+        else if (keyword == "height")
+        {
+            float height;
+            std::string pad;
+            ok = (bool)(fields >> height);
+            if (ok && fields >> pad) ok = pad == "pad";
+
+            // A pad flag belongs to the segment starting here, so it only lands once a next sample exists
+            level.terrain_heights.push_back(height);
+            level.terrain_pads.push_back(pad == "pad" ? 1 : 0);
+        }
+
+        if (!ok)
+        {
+            std::cout << filepath << ":" << line_number << ": can't read \"" << line << "\"." << std::endl;
+            return false;
+        }
+    }
+
+    if (!level.terrain_pads.empty()) level.terrain_pads.pop_back();
+    return true;
+}
+
+static bool generate(const char* layout_name, int platform_count, unsigned int seed, LevelData& level)
+{
+    SceneConfig config;
+    if (!parse_scene_layout(layout_name, config.layout))
+    {
+        std::cout << "Unknown layout " << layout_name << "; expected classic, uniform, clustered or terrain." << std::endl;
+        return false;
+    }
+    config.platform_count = platform_count;
+
+    std::vector<Entity> platforms(platform_count);
+    generate_scene(platforms.data(), config, seed);
+
+    level.platforms.reserve(platform_count);
+    for (const Entity& platform : platforms) level.platforms.push_back(make_level_platform(platform));
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    bool generating = argc == 6 && std::string(argv[2]) == "--generate";
+    if (argc != 3 && !generating)
+    {
+        std::cout << "Usage: " << argv[0] << " <output.lvl> <level.txt>" << std::endl
+                  << "       " << argv[0] << " <output.lvl> --generate <layout> <platforms> <seed>" << std::endl;
+        return 1;
+    }
+
+    LevelData level;
+    bool ok = generating ? generate(argv[3], std::max(1, atoi(argv[4])), (unsigned int)strtoul(argv[5], NULL, 10), level)
+                         : read_description(argv[2], level);
+    if (!ok) return 1;
+
+    if (!write_level_file(argv[1], level))
+    {
+        std::cout << "Unable to write " << argv[1] << "." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << argv[1] << ": " << level.platforms.size() << " platforms, "
+              << level.terrain_heights.size() << " terrain samples." << std::endl;
+    return 0;
+}
@@ -0,0 +1,433 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Offline SDF font builder: turns the 16x16 bitmap font sheet into a signed-distance-field sheet
+// with the same grid, which the SDF text shader can draw crisply at any size from one small page.
+//
+//     SdfFontGenerator <font.png> <output.tga> [cell size] [--metrics <output.fnt>]
+//
+// The game draws text from the output, so run it from the directory the game runs in:
+//
+//     SdfFontGenerator assets/font1.png assets/font_sdf.tga 16 --metrics assets/font_sdf.fnt
+//
+// With --metrics the sheet is packed instead: each glyph only gets the rect its ink and the field
+// around it need, blank cells get nothing, and the rects are packed onto shelves in the smallest
+// page that fits. The metrics file says where each one went and how to lay text out with it (see
+// FontMetrics.h): glyphs are as wide as their ink plus a little side bearing, and pairs whose
+// outlines leave a gap between them, like "To" or "AV", are kerned to close part of it. Digits all
+// share the widest one's advance and are never kerned, and a space is as wide as them, so numbers
+// padded out with spaces still line up in columns.
+//
+// The sheet's glyphs are white with a black outline, so each texel carries two fields: alpha is the
+// distance to the glyph's outer edge and RGB the distance to its white fill. Both are 0.5 on their
+// edge, rising inside and falling outside, SPREAD source texels either way until they clamp. Plain
+// textured shaders still get a usable, soft-edged glyph out of that, which the exhaust spark uses.
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+
+static const int   GRID_SIZE         = 16;    // glyphs per row and per column, as in FONT_SHEET
+static const int   DEFAULT_CELL_SIZE = 16;    // output texels per glyph cell
+static const float SPREAD            = 8.0f;  // source texels covered from the edge to either clamp
+static const int   INSIDE_ALPHA      = 128,
+                   INSIDE_FILL       = 128;   // red at or above this is the white fill, below it the outline
+
+// ————— PACKED ————— //
+static const float SIDE_BEARING      = 1.0f / 16.0f;  // ems left clear either side of a glyph's ink
+static const float BLANK_ADVANCE     = 0.4f;          // ems, for a glyph without ink in a font without digits
+static const float KERNING_STRENGTH  = 0.5f,          // how much of the gap between two outlines is closed
+                   MAX_KERNING       = 0.15f;         // ems
+static const int   GUTTER            = 1;             // empty texels between packed glyphs
+static const int   FIRST_PACKED      = ' ',
+                   LAST_PACKED       = '~';           // printable ASCII; the rest of the sheet is never drawn
+static const int   PAGE_WIDTHS[]     = { 64, 128, 256, 512, 1024 };
+
+// One cell of the source sheet
+struct SourceGlyph
+{
+    std::vector<bool> shape, fill;
+    int ink_left = 0, ink_right = -1,  // inclusive source texels; right < left for a blank cell
+        ink_top  = 0, ink_bottom = -1;
+    std::vector<int> row_left, row_right;  // each row's outermost ink, -1 where it has none
+
+    bool const has_ink() const { return ink_right >= ink_left; };
+};
+
+// A glyph's rect of the output: where it was in its cell, and where it went on the page
+struct PackedGlyph
+{
+    int code;
+    int left, top, width, height;  // output texels, from the cell's top-left
+    int x = 0, y = 0;
+};
+
+// Distance from a sample point to the nearest texel on the other side of the mask's edge, positive
+// inside and negative outside, mapped so the edge lands on 0.5. Brute force over the cell is fine
+// for a one-off over 256 small cells.
+static float signed_distance(const std::vector<bool>& mask, int cell_width, int cell_height, float sample_x, float sample_y)
+{
+    // Packed glyphs sample the field a little way past their cell, where everything is outside
+    bool in_cell = sample_x >= 0.0f && sample_y >= 0.0f && sample_x < cell_width && sample_y < cell_height;
+    int nearest_x = std::min((int)sample_x, cell_width - 1),
+        nearest_y = std::min((int)sample_y, cell_height - 1);
+    bool sample_inside = in_cell && mask[nearest_y * cell_width + nearest_x];
+
+    float nearest = SPREAD * SPREAD;
+    for (int y = 0; y < cell_height; y++)
+    {
+        for (int x = 0; x < cell_width; x++)
+        {
+            if (mask[y * cell_width + x] == sample_inside) continue;
+
+            float dx = x + 0.5f - sample_x,
+                  dy = y + 0.5f - sample_y;
+            nearest = std::min(nearest, dx * dx + dy * dy);
+        }
+    }
+
+    // Texel centres sit half a texel off the edge between them
+    float distance = std::max(std::sqrt(nearest) - 0.5f, 0.0f);
+    if (!sample_inside) distance = -distance;
+
+    return std::min(std::max(0.5f + distance / (2.0f * SPREAD), 0.0f), 1.0f);
+}
+
+// Uncompressed 32-bit TGA, top-left origin, which stb_image reads without any extra flags
+static bool write_tga(const char* filepath, int width, int height, const std::vector<unsigned char>& rgba)
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file) return false;
+
+    unsigned char header[18] = {};
+    header[2]  = 2;  // uncompressed true-colour
+    header[12] = (unsigned char)(width & 0xFF);
+    header[13] = (unsigned char)(width >> 8);
+    header[14] = (unsigned char)(height & 0xFF);
+    header[15] = (unsigned char)(height >> 8);
+    header[16] = 32;
+    header[17] = 8 | 0x20;  // 8 alpha bits, rows stored top to bottom
+    file.write((const char*)header, sizeof(header));
+
+    // TGA stores BGRA
+    std::vector<unsigned char> bgra(rgba.size());
+    for (size_t i = 0; i < rgba.size(); i += 4)
+    {
+        bgra[i + 0] = rgba[i + 2];
+        bgra[i + 1] = rgba[i + 1];
+        bgra[i + 2] = rgba[i + 0];
+        bgra[i + 3] = rgba[i + 3];
+    }
+    file.write((const char*)bgra.data(), bgra.size());
+
+    return (bool)file;
+}
+
+// The cell's shape and fill, cut off at the cell so neighbours never leak in, and where its ink is
+static SourceGlyph read_glyph(const unsigned char* source, int width, int cell_x, int cell_y, int cell_width, int cell_height)
+{
+    SourceGlyph glyph;
+    glyph.shape.resize(cell_width * cell_height);
+    glyph.fill.resize(cell_width * cell_height);
+    glyph.row_left.assign(cell_height, -1);
+    glyph.row_right.assign(cell_height, -1);
+    glyph.ink_left = cell_width;
+    glyph.ink_top  = cell_height;
+
+    for (int y = 0; y < cell_height; y++)
+    {
+        for (int x = 0; x < cell_width; x++)
+        {
+            const unsigned char* texel = &source[((cell_y * cell_height + y) * width + cell_x * cell_width + x) * 4];
+            bool inside = texel[3] >= INSIDE_ALPHA;
+            glyph.shape[y * cell_width + x] = inside;
+            glyph.fill[y * cell_width + x]  = inside && texel[0] >= INSIDE_FILL;
+            if (!inside) continue;
+
+            if (glyph.row_left[y] < 0) glyph.row_left[y] = x;
+            glyph.row_right[y] = x;
+            glyph.ink_left   = std::min(glyph.ink_left, x);
+            glyph.ink_right  = std::max(glyph.ink_right, x);
+            glyph.ink_top    = std::min(glyph.ink_top, y);
+            glyph.ink_bottom = std::max(glyph.ink_bottom, y);
+        }
+    }
+    return glyph;
+}
+
+// Both fields for a rect of output texels, measured from the cell's top-left, into `output` at (x, y)
+static void sample_glyph(const SourceGlyph& glyph, int cell_width, int cell_height, float scale_x, float scale_y,
+                         int left, int top, int rect_width, int rect_height,
+                         std::vector<unsigned char>& output, int output_width, int x, int y)
+{
+    for (int row = 0; row < rect_height; row++)
+    {
+        for (int column = 0; column < rect_width; column++)
+        {
+            float sample_x = (left + column + 0.5f) * scale_x,
+                  sample_y = (top + row + 0.5f) * scale_y;
+
+            unsigned char fill_value  = (unsigned char)std::lround(signed_distance(glyph.fill, cell_width, cell_height, sample_x, sample_y) * 255.0f),
+                          shape_value = (unsigned char)std::lround(signed_distance(glyph.shape, cell_width, cell_height, sample_x, sample_y) * 255.0f);
+
+            unsigned char* texel = &output[((size_t)(y + row) * output_width + x + column) * 4];
+            texel[0] = texel[1] = texel[2] = fill_value;
+            texel[3] = shape_value;
+        }
+    }
+}
+
+// Tallest first, left to right along shelves as tall as their first glyph. Returns the height used.
+static int pack_shelves(std::vector<PackedGlyph>& glyphs, int page_width)
+{
+    int x = 0, y = 0, shelf_height = 0;
+    for (PackedGlyph& glyph : glyphs)
+    {
+        if (glyph.width > page_width) return -1;
+        if (x + glyph.width > page_width)
+        {
+            x = 0;
+            y += shelf_height + GUTTER;
+            shelf_height = 0;
+        }
+        glyph.x = x;
+        glyph.y = y;
+        x += glyph.width + GUTTER;
+        shelf_height = std::max(shelf_height, glyph.height);
+    }
+    return y + shelf_height;
+}
+
+static bool is_digit(int code) { return code >= '0' && code <= '9'; }
+
+// How far `second` can move toward `first` in ems: part of the narrowest gap their outlines leave,
+// row by row and against the rows either side, so a diagonal never ends up touching
+static float get_kerning(const SourceGlyph& first, const SourceGlyph& second, int cell_width, int cell_height)
+{
+    int narrowest = -1;
+    for (int row = 0; row < cell_height; row++)
+    {
+        if (first.row_right[row] < 0) continue;
+
+        for (int other = std::max(row - 1, 0); other <= std::min(row + 1, cell_height - 1); other++)
+        {
+            if (second.row_left[other] < 0) continue;
+
+            int gap = (first.ink_right - first.row_right[row]) + (second.row_left[other] - second.ink_left);
+            if (narrowest < 0 || gap < narrowest) narrowest = gap;
+        }
+    }
+    if (narrowest < 0) return 0.0f;  // nowhere side by side, e.g. a quote and a full stop
+
+    float kerning = std::min(narrowest * KERNING_STRENGTH / cell_width, MAX_KERNING);
+    return kerning * cell_width >= 1.5f ? -kerning : 0.0f;  // under a texel and a half isn't worth a pair
+}
+
+int main(int argc, char* argv[])
+{
+    // Positional arguments, with --metrics anywhere after the first two
+    const char* metrics_filepath = NULL;
+    std::vector<const char*> arguments;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--metrics" && i + 1 < argc) metrics_filepath = argv[++i];
+        else arguments.push_back(argv[i]);
+    }
+
+    if (arguments.size() < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <font.png> <output.tga> [cell size] [--metrics <output.fnt>]" << std::endl;
+        return 1;
+    }
+
+    int cell_size = arguments.size() > 2 ? std::atoi(arguments[2]) : DEFAULT_CELL_SIZE;
+    if (cell_size <= 0)
+    {
+        std::cout << "Cell size must be a positive number of texels." << std::endl;
+        return 1;
+    }
+
+    int width, height, number_of_components;
+    unsigned char* source = stbi_load(arguments[0], &width, &height, &number_of_components, STBI_rgb_alpha);
+    if (source == NULL)
+    {
+        std::cout << "Unable to load image " << arguments[0] << ". Make sure the path is correct." << std::endl;
+        return 1;
+    }
+
+    if (width % GRID_SIZE != 0 || height % GRID_SIZE != 0)
+    {
+        std::cout << arguments[0] << " is " << width << "x" << height << ", which does not split into a " << GRID_SIZE << "x" << GRID_SIZE << " grid." << std::endl;
+        stbi_image_free(source);
+        return 1;
+    }
+
+    const int source_cell_width  = width / GRID_SIZE,
+              source_cell_height = height / GRID_SIZE,
+              output_size        = cell_size * GRID_SIZE;
+
+    // Source texels per output texel, so the sample point lands in the same place in both cells
+    const float scale_x = (float)source_cell_width / cell_size,
+                scale_y = (float)source_cell_height / cell_size;
+
+    std::vector<SourceGlyph> glyphs;
+    for (int code = 0; code < GRID_SIZE * GRID_SIZE; code++)
+    {
+        glyphs.push_back(read_glyph(source, width, code % GRID_SIZE, code / GRID_SIZE, source_cell_width, source_cell_height));
+    }
+    stbi_image_free(source);
+
+    // ————— GRID ————— //
+    if (metrics_filepath == NULL)
+    {
+        std::vector<unsigned char> output(output_size * output_size * 4, 0);
+        for (int code = 0; code < GRID_SIZE * GRID_SIZE; code++)
+        {
+            sample_glyph(glyphs[code], source_cell_width, source_cell_height, scale_x, scale_y, 0, 0, cell_size, cell_size,
+                         output, output_size, (code % GRID_SIZE) * cell_size, (code / GRID_SIZE) * cell_size);
+        }
+
+        if (!write_tga(arguments[1], output_size, output_size, output))
+        {
+            std::cout << "Unable to write " << arguments[1] << "." << std::endl;
+            return 1;
+        }
+
+        std::cout << "Wrote " << output_size << "x" << output_size << " SDF font (" << cell_size << " texels per glyph) to " << arguments[1] << std::endl;
+        return 0;
+    }
+
+    // ————— PACKED ————— //
+    // STEP 1: Each inked glyph's rect: its ink, out to where the field clamps on every side, but
+    //         never past its cell, so it draws exactly what its cell of the grid sheet did
+    const int padding_x = (int)std::ceil(SPREAD / scale_x),
+              padding_y = (int)std::ceil(SPREAD / scale_y);
+
+    std::vector<PackedGlyph> packed;
+    for (int code = FIRST_PACKED; code <= LAST_PACKED; code++)
+    {
+        const SourceGlyph& glyph = glyphs[code];
+        if (!glyph.has_ink()) continue;
+
+        int left   = std::max((int)std::floor(glyph.ink_left / scale_x) - padding_x, 0),
+            right  = std::min((int)std::ceil((glyph.ink_right + 1) / scale_x) + padding_x, cell_size),
+            top    = std::max((int)std::floor(glyph.ink_top / scale_y) - padding_y, 0),
+            bottom = std::min((int)std::ceil((glyph.ink_bottom + 1) / scale_y) + padding_y, cell_size);
+        packed.push_back({ code, left, top, right - left, bottom - top });
+    }
+
+    // STEP 2: The page width that wastes the fewest texels
+    std::stable_sort(packed.begin(), packed.end(), [](const PackedGlyph& a, const PackedGlyph& b) { return a.height > b.height; });
+
+    int page_width = 0, page_height = 0;
+    for (int candidate : PAGE_WIDTHS)
+    {
+        int used = pack_shelves(packed, candidate);
+        if (used > 0 && (page_width == 0 || candidate * used < page_width * page_height))
+        {
+            page_width = candidate;
+            page_height = used;
+        }
+    }
+    if (page_width == 0)
+    {
+        std::cout << "The glyphs don't fit on any page up to " << PAGE_WIDTHS[std::size(PAGE_WIDTHS) - 1] << " texels wide." << std::endl;
+        return 1;
+    }
+    pack_shelves(packed, page_width);
+
+    // STEP 3: The fields, straight onto the page
+    std::vector<unsigned char> output((size_t)page_width * page_height * 4, 0);
+    for (const PackedGlyph& glyph : packed)
+    {
+        sample_glyph(glyphs[glyph.code], source_cell_width, source_cell_height, scale_x, scale_y, glyph.left, glyph.top, glyph.width, glyph.height,
+                     output, page_width, glyph.x, glyph.y);
+    }
+
+    if (!write_tga(arguments[1], page_width, page_height, output))
+    {
+        std::cout << "Unable to write " << arguments[1] << "." << std::endl;
+        return 1;
+    }
+
+    // STEP 4: The metrics, in ems of one source cell's height. The pen sits SIDE_BEARING left of the ink.
+    std::ofstream metrics(metrics_filepath);
+    metrics << "# " << arguments[0] << " packed by SdfFontGenerator\n";
+    metrics << "font 1 " << page_width << " " << page_height << " " << cell_size << "\n";
+
+    std::vector<const PackedGlyph*> by_code(GRID_SIZE * GRID_SIZE, NULL);
+    for (const PackedGlyph& glyph : packed) by_code[glyph.code] = &glyph;
+
+    const float em_x = (float)source_cell_width,
+                em_y = (float)source_cell_height;
+
+    int digit_width = 0;
+    for (int code = '0'; code <= '9'; code++)
+    {
+        if (glyphs[code].has_ink()) digit_width = std::max(digit_width, glyphs[code].ink_right + 1 - glyphs[code].ink_left);
+    }
+    float blank_advance = digit_width > 0 ? digit_width / em_x + 2.0f * SIDE_BEARING : BLANK_ADVANCE;
+    for (int code = 0; code < GRID_SIZE * GRID_SIZE; code++)
+    {
+        const SourceGlyph& glyph = glyphs[code];
+        const PackedGlyph* rect = by_code[code];
+        if (rect == NULL)  // blank, or outside the packed range
+        {
+            metrics << "glyph " << code << " 0 0 0 0 0 0 " << blank_advance << "\n";
+            continue;
+        }
+
+        // A digit's ink is centred in the widest digit's
+        int ink_width = glyph.ink_right + 1 - glyph.ink_left,
+            box_width = is_digit(code) ? digit_width : ink_width;
+
+        float bearing_x = rect->left * scale_x / em_x - glyph.ink_left / em_x + SIDE_BEARING + 0.5f * (box_width - ink_width) / em_x,
+              bearing_y = 0.5f - rect->top * scale_y / em_y,
+              advance   = box_width / em_x + 2.0f * SIDE_BEARING;
+        metrics << "glyph " << code << " " << rect->x << " " << rect->y << " " << rect->width << " " << rect->height << " "
+                << bearing_x << " " << bearing_y << " " << advance << "\n";
+    }
+
+    int pair_count = 0;
+    for (int first = FIRST_PACKED; first <= LAST_PACKED; first++)
+    {
+        for (int second = FIRST_PACKED; second <= LAST_PACKED; second++)
+        {
+            if (by_code[first] == NULL || by_code[second] == NULL || is_digit(first) || is_digit(second)) continue;
+
+            float kerning = get_kerning(glyphs[first], glyphs[second], source_cell_width, source_cell_height);
+            if (kerning == 0.0f) continue;
+
+            metrics << "kern " << first << " " << second << " " << kerning << "\n";
+            pair_count++;
+        }
+    }
+
+    if (!metrics)
+    {
+        std::cout << "Unable to write " << metrics_filepath << "." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << page_width << "x" << page_height << " packed SDF font (" << packed.size() << " glyphs, " << cell_size
+              << " texels per em) to " << arguments[1] << ", and its metrics with " << pair_count << " kerning pairs to " << metrics_filepath << std::endl;
+    return 0;
+}
@@ -0,0 +1,244 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Offline asset packer: decodes PNGs once at build time and writes them into a single assets.pak
+// that the game maps at startup instead of running stb_image on every launch, along with the
+// AssetManifest.h the game is built against: an AssetId per image, in pack order, and its id
+// and offset as constants, so the game never looks an image up by its path. Every image is
+// followed by its mip chain, each level a 2x2 box filter of the one before, so nothing has to
+// generate mips at runtime to stream them.
+//
+//     AssetPacker <output.pak> <manifest header> <image> [image...]
+//
+// Entries are named by the path exactly as given, so run it from the directory the game runs in:
+//
+//     AssetPacker assets/assets.pak AssetManifest.h assets/font_sdf.tga assets/platform.png assets/rock.png assets/ship.png assets/stone.png
+//
+// Like ShaderEmbedder, the header is only rewritten when its contents change.
+
+#define STB_IMAGE_IMPLEMENTATION
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "AssetPack.h"
+
+static size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// The next level down: each texel the average of the 2x2 above it, the edge of an odd-sized
+// level counted twice
+static std::vector<unsigned char> downsample(const unsigned char* pixels, int width, int height)
+{
+    int next_width = std::max(width / 2, 1),
+        next_height = std::max(height / 2, 1);
+    std::vector<unsigned char> next((size_t)next_width * next_height * 4);
+
+    for (int y = 0; y < next_height; y++)
+    {
+        int y0 = std::min(y * 2, height - 1),
+            y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < next_width; x++)
+        {
+            int x0 = std::min(x * 2, width - 1),
+                x1 = std::min(x * 2 + 1, width - 1);
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int sum = pixels[((size_t)y0 * width + x0) * 4 + channel] + pixels[((size_t)y0 * width + x1) * 4 + channel] +
+                          pixels[((size_t)y1 * width + x0) * 4 + channel] + pixels[((size_t)y1 * width + x1) * 4 + channel];
+                next[((size_t)y * next_width + x) * 4 + channel] = (unsigned char)((sum + 2) / 4);
+            }
+        }
+    }
+    return next;
+}
+
+// assets/font_sdf.tga -> ASSET_FONT_SDF
+static std::string constant_name(const char* filepath)
+{
+    std::string name = filepath;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) name.erase(0, slash + 1);
+    size_t extension = name.find_last_of('.');
+    if (extension != std::string::npos) name.erase(extension);
+
+    for (char& character : name) character = std::isalnum((unsigned char)character) ? (char)std::toupper((unsigned char)character) : '_';
+    return "ASSET_" + name;
+}
+
+// The manifest for what was packed; false if two images would get the same constant or id
+static bool write_manifest(const char* filepath, const std::vector<AssetPackEntry>& entries)
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        names.push_back(constant_name(entries[i].name));
+        for (size_t j = 0; j < i; j++)
+        {
+            if (names[j] != names[i] && entries[j].id != entries[i].id) continue;
+
+            std::cout << entries[j].name << " and " << entries[i].name << " would share an asset id." << std::endl;
+            return false;
+        }
+    }
+
+    std::ostringstream header;
+    header << "#pragma once\n\n"
+           << "// Generated by AssetPacker (pack_assets.cpp) with assets.pak. Do not edit by hand; repack\n"
+           << "// instead, and rebuild with the new pack.\n"
+           << "#include \"AssetPack.h\"\n\n"
+           << "enum AssetId : uint32_t\n"
+           << "{\n";
+    for (const std::string& name : names) header << "    " << name << ",\n";
+    header << "    ASSET_COUNT\n"
+           << "};\n\n"
+           << "namespace AssetManifest\n"
+           << "{\n"
+           << "    constexpr AssetManifestEntry ENTRIES[ASSET_COUNT] =\n"
+           << "    {\n";
+    for (const AssetPackEntry& entry : entries)
+    {
+        header << "        { \"" << entry.name << "\", hash_asset_path(\"" << entry.name << "\"), " << entry.width << ", "
+               << entry.height << ", " << entry.offset << " },\n";
+    }
+    header << "    };\n"
+           << "}\n";
+
+    std::ifstream existing(filepath, std::ios::binary);
+    std::stringstream previous;
+    previous << existing.rdbuf();
+    if (existing && previous.str() == header.str()) return true;
+    existing.close();
+
+    std::ofstream output(filepath, std::ios::binary | std::ios::trunc);
+    output << header.str();
+    if (!output)
+    {
+        std::cout << "Unable to write " << filepath << "." << std::endl;
+        return false;
+    }
+
+    std::cout << "Wrote the manifest for " << entries.size() << " images to " << filepath << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cout << "Usage: " << argv[0] << " <output.pak> <manifest header> <image> [image...]" << std::endl;
+        return 1;
+    }
+
+    const int image_count = argc - 3;
+
+    AssetPackHeader header = {};
+    std::memcpy(header.magic, AssetPack::MAGIC, sizeof(header.magic));
+    header.version = AssetPack::VERSION;
+    header.entry_count = (uint32_t)image_count;
+
+    std::vector<AssetPackEntry> entries(image_count);
+    std::vector<unsigned char*> images(image_count, NULL);
+    std::vector<std::vector<unsigned char>> chains(image_count);  // levels 1 and down, back to back
+
+    // STEP 1: Decode everything and lay the pixels out after the index
+    size_t offset = align_up(sizeof(AssetPackHeader) + image_count * sizeof(AssetPackEntry), AssetPack::PIXEL_ALIGNMENT);
+    int status = 0;
+
+    for (int i = 0; i < image_count && status == 0; i++)
+    {
+        const char* filepath = argv[i + 3];
+        AssetPackEntry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+
+        if (std::strlen(filepath) >= sizeof(entry.name))
+        {
+            std::cout << "Image path " << filepath << " is longer than " << sizeof(entry.name) - 1 << " characters." << std::endl;
+            status = 1;
+            break;
+        }
+
+        int width, height, number_of_components;
+        images[i] = stbi_load(filepath, &width, &height, &number_of_components, STBI_rgb_alpha);
+        if (images[i] == NULL)
+        {
+            std::cout << "Unable to load image " << filepath << ". Make sure the path is correct." << std::endl;
+            status = 1;
+            break;
+        }
+
+        std::memcpy(entry.name, filepath, std::strlen(filepath));  // the rest stays zeroed
+        entry.id = hash_asset_path(filepath);
+        entry.width = (uint32_t)width;
+        entry.height = (uint32_t)height;
+        entry.offset = offset;
+        entry.mip_levels = AssetPack::count_mip_levels(entry.width, entry.height);
+
+        const unsigned char* level = images[i];
+        for (int j = 1; j < (int)entry.mip_levels; j++)
+        {
+            std::vector<unsigned char> next = downsample(level, (int)AssetPack::get_mip_extent(entry.width, j - 1), (int)AssetPack::get_mip_extent(entry.height, j - 1));
+            size_t start = chains[i].size();
+            chains[i].insert(chains[i].end(), next.begin(), next.end());
+            level = chains[i].data() + start;
+        }
+
+        offset = align_up(offset + (size_t)AssetPack::get_chain_bytes(entry), AssetPack::PIXEL_ALIGNMENT);
+    }
+
+    // STEP 2: The manifest first, so a clash leaves the old pack and manifest as they were
+    if (status == 0 && !write_manifest(argv[2], entries)) status = 1;
+
+    // STEP 3: Header, index, then every image at its offset, zero-padded in between
+    if (status == 0)
+    {
+        std::ofstream file(argv[1], std::ios::binary | std::ios::trunc);
+        std::vector<char> padding(AssetPack::PIXEL_ALIGNMENT, 0);
+
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)entries.data(), entries.size() * sizeof(AssetPackEntry));
+        size_t written = sizeof(header) + entries.size() * sizeof(AssetPackEntry);
+
+        for (int i = 0; i < image_count && file; i++)
+        {
+            size_t gap = (size_t)entries[i].offset - written;
+            size_t byte_count = (size_t)entries[i].width * entries[i].height * 4;
+
+            file.write(padding.data(), gap);
+            file.write((const char*)images[i], byte_count);
+            file.write((const char*)chains[i].data(), chains[i].size());
+            written = (size_t)entries[i].offset + byte_count + chains[i].size();
+        }
+
+        file.close();
+        if (!file)
+        {
+            std::cout << "Unable to write " << argv[1] << "." << std::endl;
+            status = 1;
+        }
+        else
+        {
+            std::cout << "Packed " << image_count << " images into " << argv[1] << " (" << written << " bytes)" << std::endl;
+        }
+    }
+
+    for (unsigned char* image : images) stbi_image_free(image);
+
+    return status;
+}
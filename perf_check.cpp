@@ -0,0 +1,360 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+
+// Performance regression check: plays a fixed set of seeded scenes with a scripted input track,
+// measures them, and compares the numbers with a committed baseline. No window, no GL and no SDL.
+//
+//     LanderPerfCheck [--baseline perf_baseline.json] [--threshold 0.10] [--update]
+//
+// Exits 1, after printing every metric against its baseline, if any of them is worse by more than
+// the threshold or a checksum changed. --update writes the current numbers as the new baseline
+// instead; do that on the machine the check runs on, since the timings are only comparable there.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "FrameHistogram.h"
+#include "PlatformIntervalIndex.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+
+typedef std::chrono::steady_clock Clock;
+
+const char   DEFAULT_BASELINE_FILEPATH[] = "perf_baseline.json";
+const double DEFAULT_THRESHOLD = 0.10;
+const int    REPETITIONS       = 3;  // best of, so one preempted run doesn't fail the check
+const float  FRAME_SECONDS     = 1.0f / 60.0f;
+
+// Many landers share one scene, each at its own point in the input script and spawned over its
+// own stretch of the level, so the checksum depends on the whole scene and not just what's near
+// the origin. A "frame" is the time to advance all of them by FRAME_SECONDS, and is what the
+// percentiles are taken over.
+struct Scenario
+{
+    const char*  name;
+    SceneConfig  scene;
+    unsigned int seed;
+    int          lander_count;
+    int          frame_count;
+};
+
+const Scenario SCENARIOS[] =
+{
+    { "classic",      { SCENE_CLASSIC, PLATFORM_COUNT }, 1, 8192, 300 },
+    { "terrain_10k",  { SCENE_TERRAIN, 10000 },          2, 8192, 300 },
+    { "uniform_100k", { SCENE_UNIFORM, 100000 },         3, 8192, 300 },
+};
+
+// ————— INPUT SCRIPT ————— //
+// Stands in for a recorded session: fall, burn, drift both ways, burn again. It loops, and each
+// world starts at its own offset into it so the worlds don't all move in lockstep.
+struct InputSegment
+{
+    int   frames;
+    float movement_x;
+    bool  boost;
+};
+
+const InputSegment INPUT_SCRIPT[] =
+{
+    { 40,  0.0f, false },
+    {  6,  0.0f, true  },
+    { 25, -1.0f, false },
+    {  4,  0.0f, true  },
+    { 30,  1.0f, false },
+    {  5,  1.0f, true  },
+    { 20,  0.0f, false },
+    {  8,  0.0f, true  },
+};
+
+const InputSegment& get_input(int frame)
+{
+    int script_frames = 0;
+    for (const InputSegment& segment : INPUT_SCRIPT) script_frames += segment.frames;
+
+    frame %= script_frames;
+    for (const InputSegment& segment : INPUT_SCRIPT)
+    {
+        if (frame < segment.frames) return segment;
+        frame -= segment.frames;
+    }
+    return INPUT_SCRIPT[0];
+}
+
+// ————— MEASUREMENT ————— //
+typedef std::map<std::string, double> Metrics;
+
+double get_peak_rss_mb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+    return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes there, kilobytes everywhere else
+#else
+    return usage.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+void run_scenario(const Scenario& scenario, Metrics& metrics)
+{
+    // STEP 1: The scene, built once: its platforms are static, and nothing here steps two
+    //         landers at once, so every GameState can point at the same copy
+    const int platform_count = scenario.scene.platform_count;
+    std::unique_ptr<Entity[]> platforms(new Entity[platform_count]);
+    generate_scene(platforms.get(), scenario.scene, scenario.seed);
+
+    PlatformColliders colliders;
+    colliders.build(platforms.get(), platform_count);
+
+    PlatformIntervalIndex broadphase;
+    if (platform_count > PLATFORM_COUNT) broadphase.build(platforms.get(), platform_count);
+
+    float scene_min_x = platforms[0].get_position().x,
+          scene_max_x = scene_min_x;
+    for (int i = 1; i < platform_count; i++)
+    {
+        scene_min_x = std::min(scene_min_x, platforms[i].get_position().x);
+        scene_max_x = std::max(scene_max_x, platforms[i].get_position().x);
+    }
+
+    std::unique_ptr<Entity[]> players(new Entity[scenario.lander_count]);
+    std::vector<GameState> states(scenario.lander_count);
+
+    for (int i = 0; i < scenario.lander_count; i++)
+    {
+        setup_player(&players[i]);
+
+        GameState& state = states[i];
+        state.player = &players[i];
+        state.platforms = platforms.get();
+        state.platform_count = platform_count;
+        state.platform_colliders = &colliders;
+        if (!broadphase.is_empty()) state.platform_broadphase = &broadphase;
+
+        // Evenly across the level, at the usual height
+        float x = scene_min_x + (scene_max_x - scene_min_x) * (i + 0.5f) / scenario.lander_count;
+        state.spawn_position = glm::vec3(x, state.spawn_position.y, 0.0f);
+    }
+
+    double best_steps_per_second = 0.0,
+           best_p50_ms = 0.0,
+           best_p99_ms = 0.0;
+    uint32_t checksum = 0;
+
+    // STEP 2: The script played REPETITIONS times from the spawn points, keeping the best of each number
+    for (int repetition = 0; repetition < REPETITIONS; repetition++)
+    {
+        for (GameState& state : states) reset_episode(state);
+
+        FrameHistogram frame_times;
+        long long steps = 0;
+        double seconds = 0.0;
+
+        for (int frame = 0; frame < scenario.frame_count; frame++)
+        {
+            Clock::time_point start = Clock::now();
+
+            for (int i = 0; i < scenario.lander_count; i++)
+            {
+                GameState& state = states[i];
+
+                // A finished episode starts over, so the load stays the same for the whole run
+                if (state.win || state.loss) reset_episode(state);
+
+                const InputSegment& input = get_input(frame + i * 7);
+                state.player->set_movement(glm::vec3(input.movement_x, 0.0f, 0.0f));
+                state.player->m_booster_active = input.boost;
+
+                steps += advance_simulation(state, FRAME_SECONDS);
+            }
+
+            double frame_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            frame_times.record(frame_seconds);
+            seconds += frame_seconds;
+        }
+
+        // Same scene and the same script every repetition, so anything else is a determinism bug
+        uint32_t repetition_checksum = 2166136261u;
+        for (const GameState& state : states) repetition_checksum = checksum_state(state, repetition_checksum);
+
+        if (repetition == 0) checksum = repetition_checksum;
+        else if (repetition_checksum != checksum) std::cout << scenario.name << ": checksum differs between repetitions" << std::endl;
+
+        double steps_per_second = seconds > 0.0 ? steps / seconds : 0.0;
+        if (repetition == 0 || steps_per_second > best_steps_per_second) best_steps_per_second = steps_per_second;
+        if (repetition == 0 || frame_times.get_percentile_ms(0.5)  < best_p50_ms) best_p50_ms = frame_times.get_percentile_ms(0.5);
+        if (repetition == 0 || frame_times.get_percentile_ms(0.99) < best_p99_ms) best_p99_ms = frame_times.get_percentile_ms(0.99);
+    }
+
+    std::string prefix = scenario.name;
+    metrics[prefix + ".steps_per_sec"] = best_steps_per_second;
+    metrics[prefix + ".frame_p50_ms"]  = best_p50_ms;
+    metrics[prefix + ".frame_p99_ms"]  = best_p99_ms;
+    metrics[prefix + ".checksum"]      = checksum;
+}
+
+// ————— BASELINE ————— //
+// A flat JSON object of "name": number, which is all this file ever writes
+bool read_baseline(const char* filepath, Metrics& baseline)
+{
+    std::ifstream file(filepath);
+    if (!file) return false;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    size_t position = 0;
+    while ((position = text.find('"', position)) != std::string::npos)
+    {
+        size_t name_end = text.find('"', position + 1);
+        size_t colon = text.find(':', name_end);
+        if (name_end == std::string::npos || colon == std::string::npos) break;
+
+        baseline[text.substr(position + 1, name_end - position - 1)] = std::strtod(text.c_str() + colon + 1, NULL);
+        position = colon + 1;
+    }
+    return true;
+}
+
+bool write_baseline(const char* filepath, const Metrics& metrics)
+{
+    std::ofstream file(filepath, std::ios::trunc);
+    if (!file) return false;
+
+    file << "{\n";
+    size_t i = 0;
+    for (const auto& metric : metrics)
+    {
+        char value[64];
+        std::snprintf(value, sizeof(value), "%.10g", metric.second);
+        file << "  \"" << metric.first << "\": " << value << (++i < metrics.size() ? ",\n" : "\n");
+    }
+    file << "}\n";
+    return (bool)file;
+}
+
+// Positive when `current` is worse than `baseline`, as a fraction of the baseline
+double get_regression(const std::string& name, double baseline, double current)
+{
+    if (baseline == 0.0) return 0.0;
+
+    bool higher_is_better = name.size() >= 8 && name.compare(name.size() - 8, 8, "_per_sec") == 0;
+    return higher_is_better ? (baseline - current) / baseline : (current - baseline) / baseline;
+}
+
+bool is_checksum(const std::string& name)
+{
+    return name.size() >= 9 && name.compare(name.size() - 9, 9, ".checksum") == 0;
+}
+
+// ————— DRIVER ————— //
+int main(int argc, char* argv[])
+{
+    const char* baseline_filepath = DEFAULT_BASELINE_FILEPATH;
+    double threshold = DEFAULT_THRESHOLD;
+    bool update = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc)  baseline_filepath = argv[++i];
+        else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--update") == 0)                    update = true;
+    }
+
+    Metrics metrics;
+    for (const Scenario& scenario : SCENARIOS)
+    {
+        std::cout << "Running " << scenario.name << " (" << scenario.lander_count << " landers, "
+                  << scenario.scene.platform_count << " platforms, " << scenario.frame_count << " frames)" << std::endl;
+        run_scenario(scenario, metrics);
+    }
+    metrics["peak_rss_mb"] = get_peak_rss_mb();
+
+    if (update)
+    {
+        if (!write_baseline(baseline_filepath, metrics))
+        {
+            std::cout << "Unable to write " << baseline_filepath << std::endl;
+            return 1;
+        }
+        std::cout << "Baseline written to " << baseline_filepath << std::endl;
+        return 0;
+    }
+
+    Metrics baseline;
+    if (!read_baseline(baseline_filepath, baseline))
+    {
+        std::cout << "No baseline at " << baseline_filepath << "; run with --update to create one" << std::endl;
+        return 1;
+    }
+
+    // STEP 1: Every metric against its baseline, worst news marked
+    int failures = 0;
+    std::printf("\n%-28s %14s %14s %9s\n", "metric", "baseline", "current", "change");
+
+    for (const auto& metric : metrics)
+    {
+        auto found = baseline.find(metric.first);
+        if (found == baseline.end())
+        {
+            std::printf("%-28s %14s %14.6g %9s  new\n", metric.first.c_str(), "-", metric.second, "");
+            continue;
+        }
+
+        if (is_checksum(metric.first))
+        {
+            bool same = (uint32_t)found->second == (uint32_t)metric.second;
+            std::printf("%-28s %14.10g %14.10g %9s  %s\n", metric.first.c_str(), found->second, metric.second, "", same ? "ok" : "CHANGED");
+            if (!same) failures++;
+            continue;
+        }
+
+        double regression = get_regression(metric.first, found->second, metric.second);
+        bool failed = regression > threshold;
+
+        std::printf("%-28s %14.6g %14.6g %+8.1f%%  %s\n", metric.first.c_str(), found->second, metric.second,
+                    found->second != 0.0 ? 100.0 * (metric.second - found->second) / found->second : 0.0, failed ? "REGRESSED" : "ok");
+        if (failed) failures++;
+    }
+
+    // STEP 2: The verdict
+    if (failures > 0)
+    {
+        std::printf("\n%d metric(s) regressed by more than %.0f%% or changed\n", failures, threshold * 100.0);
+        return 1;
+    }
+
+    std::printf("\nNo regressions beyond %.0f%%\n", threshold * 100.0);
+    return 0;
+}
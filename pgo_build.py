@@ -0,0 +1,162 @@
+# Profile-guided release build (GCC or Clang) through CMakeLists.txt:
+#
+#     python3 pgo_build.py [--build-dir build/pgo] [--replays DIR] [--game] [--compare]
+#
+# 1. Builds everything instrumented (LANDER_PGO=generate).
+# 2. Trains: every replay (*.lrp) in --replays through LanderHeadless --replay, which plays each
+#    back for a second; without --replays, a set recorded with LanderHeadless --record over every
+#    scene layout. Then batches of headless episodes on each layout and integrator, for the
+#    many-landers paths, and the whole of LanderBench, for the collision, text and audio kernels.
+#    With --game, PongClone --render-bench too, which needs a display.
+# 3. Rebuilds in the same directory with the profiles (LANDER_PGO=use), so GCC finds each
+#    object's profile where the instrumented build left it.
+#
+# --compare also builds a plain release into <build-dir>-release and prints LanderBench and the
+# headless steps/s for both, the speedup last.
+import argparse
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+LAYOUTS = ["classic", "uniform", "clustered", "terrain"]
+INTEGRATORS = ["euler", "semi-implicit", "verlet"]
+RECORDED_SEEDS = range(1, 9)
+RECORDED_PLATFORMS = 2000          # for every layout but classic, which is always nine
+TRAINING_EPISODES = 2000
+RENDER_BENCH_FRAMES = 600
+HEADLESS_COMPARE_ARGS = ["20000", "3600", "1", "1"]  # one thread, so the steps/s compare cleanly
+
+
+def run(command, **kwargs):
+    print("+ " + " ".join(command), flush=True)
+    return subprocess.run(command, check=True, **kwargs)
+
+
+def binary(build_dir, name):
+    path = os.path.join(build_dir, name + (".exe" if sys.platform == "win32" else ""))
+    return path if os.path.exists(path) else None
+
+
+def configure_and_build(source_dir, build_dir, pgo, jobs):
+    command = ["cmake", "-S", source_dir, "-B", build_dir, "-DCMAKE_BUILD_TYPE=Release", "-DLANDER_PGO=" + pgo]
+    run(command)
+    run(["cmake", "--build", build_dir, "-j", str(jobs)])
+
+
+# ————— TRAINING ————— //
+def record_replays(headless, replay_dir):
+    os.makedirs(replay_dir, exist_ok=True)
+    for layout in LAYOUTS:
+        platforms = "9" if layout == "classic" else str(RECORDED_PLATFORMS)
+        for seed in RECORDED_SEEDS:
+            path = os.path.join(replay_dir, "%s_%d.lrp" % (layout, seed))
+            run([headless, "--record", path, str(seed), platforms, layout], stdout=subprocess.DEVNULL)
+    return sorted(glob.glob(os.path.join(replay_dir, "*.lrp")))
+
+
+def train(build_dir, replays_dir, game):
+    headless = binary(build_dir, "LanderHeadless")
+    bench = binary(build_dir, "LanderBench")
+
+    # STEP 1: The replays, recorded or given
+    replays = sorted(glob.glob(os.path.join(replays_dir, "*.lrp"))) if replays_dir else []
+    if not replays:
+        replays = record_replays(headless, os.path.join(build_dir, "training_replays"))
+    for replay in replays:
+        # A replay that no longer plays back the same still trains; it just exits with 1
+        subprocess.run([headless, "--replay", replay], stdout=subprocess.DEVNULL)
+    print("trained on %d replays" % len(replays), flush=True)
+
+    # STEP 2: Many landers on every layout, and the rate integrators on the classic level
+    for layout in LAYOUTS:
+        platforms = "9" if layout == "classic" else str(RECORDED_PLATFORMS)
+        run([headless, str(TRAINING_EPISODES), "3600", "1", "0", platforms, layout], stdout=subprocess.DEVNULL)
+    for integrator in INTEGRATORS[1:]:
+        run([headless, str(TRAINING_EPISODES), "3600", "1", "0", "9", "classic", integrator], stdout=subprocess.DEVNULL)
+
+    # STEP 3: The kernels
+    run([bench], stdout=subprocess.DEVNULL)
+
+    game_binary = binary(build_dir, "PongClone")
+    if game and game_binary:
+        run([game_binary, "--render-bench", str(RENDER_BENCH_FRAMES)], stdout=subprocess.DEVNULL)
+
+
+def merge_clang_profiles(pgo_dir):
+    profiles = glob.glob(os.path.join(pgo_dir, "*.profraw"))
+    if profiles:
+        run(["llvm-profdata", "merge", "-o", os.path.join(pgo_dir, "lander.profdata")] + profiles)
+
+
+def read_compiler(build_dir):
+    with open(os.path.join(build_dir, "CMakeCache.txt")) as cache:
+        for line in cache:
+            if line.startswith("CMAKE_CXX_COMPILER_ID:") or line.startswith("CMAKE_CXX_COMPILER:"):
+                if "clang" in line.lower():
+                    return "clang"
+    return "gcc"
+
+
+# ————— COMPARISON ————— //
+def bench_times(build_dir):
+    output = subprocess.run([binary(build_dir, "LanderBench")], check=True, capture_output=True, text=True).stdout
+    times = {}
+    for line in output.splitlines():
+        match = re.match(r"(.+?)\s+([\d.]+) ns/op", line)
+        if match:
+            times[match.group(1).strip()] = float(match.group(2))
+    return times
+
+
+def headless_steps_per_second(build_dir):
+    output = subprocess.run([binary(build_dir, "LanderHeadless")] + HEADLESS_COMPARE_ARGS, check=True, capture_output=True, text=True).stdout
+    return float(re.search(r"\(([\d.e+]+) steps/s\)", output).group(1))
+
+
+def compare(release_dir, pgo_dir):
+    release, pgo = bench_times(release_dir), bench_times(pgo_dir)
+    print("%-44s %14s %14s %8s" % ("benchmark", "release ns/op", "pgo ns/op", "speedup"))
+    for name, release_ns in release.items():
+        if name in pgo and pgo[name] > 0.0:
+            print("%-44s %14.1f %14.1f %7.2fx" % (name, release_ns, pgo[name], release_ns / pgo[name]))
+
+    release_steps, pgo_steps = headless_steps_per_second(release_dir), headless_steps_per_second(pgo_dir)
+    print("%-44s %14.3g %14.3g %7.2fx" % ("LanderHeadless steps/s, 1 thread", release_steps, pgo_steps, pgo_steps / release_steps))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Profile-guided release build, trained on replays")
+    parser.add_argument("--build-dir", default=os.path.join("build", "pgo"))
+    parser.add_argument("--replays", help="a directory of .lrp replays to train on; recorded when not given")
+    parser.add_argument("--game", action="store_true", help="train the game's renderer with --render-bench too")
+    parser.add_argument("--compare", action="store_true", help="build a plain release alongside and time both")
+    parser.add_argument("--jobs", type=int, default=os.cpu_count() or 1)
+    args = parser.parse_args()
+
+    source_dir = os.path.dirname(os.path.abspath(__file__))
+    build_dir = os.path.abspath(args.build_dir)
+    pgo_dir = os.path.join(build_dir, "pgo")
+
+    # STEP 1: Instrumented, from clean profiles
+    shutil.rmtree(pgo_dir, ignore_errors=True)
+    configure_and_build(source_dir, build_dir, "generate", args.jobs)
+
+    # STEP 2: Trained
+    train(build_dir, args.replays, args.game)
+    if read_compiler(build_dir) == "clang":
+        merge_clang_profiles(pgo_dir)
+
+    # STEP 3: Rebuilt with what the training saw
+    configure_and_build(source_dir, build_dir, "use", args.jobs)
+
+    if args.compare:
+        release_dir = build_dir + "-release"
+        configure_and_build(source_dir, release_dir, "", args.jobs)
+        compare(release_dir, build_dir)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,45 @@
+# Builds the `lander` Python extension (lander_module.cpp) over the batched simulation:
+#
+#     python setup.py build_ext --inplace
+#
+# NumPy is only needed at run time, so the build itself has no dependencies beyond a C++17 compiler.
+from setuptools import Extension, setup
+
+SOURCES = [
+    "lander_module.cpp",
+    "BatchedLanderEnv.cpp",
+    "BatchedLanderSim.cpp",
+    "DistanceField.cpp",
+    "DynamicAabbTree.cpp",
+    "Entity.cpp",
+    "GameEvents.cpp",
+    "Terrain.cpp",
+    "Simulation.cpp",
+    "SceneGenerator.cpp",
+    "PlatformGrid.cpp",
+    "PlatformIntervalIndex.cpp",
+    "PlatformQueryBatch.cpp",
+    "PlatformBroadphase.cpp",
+    "PlatformColliders.cpp",
+    "OverlapKernels.cpp",
+    "SimdDispatch.cpp",
+    "ForceFields.cpp",
+    "FlightPredictor.cpp",
+    "Trace.cpp",
+    "TuningConfig.cpp",
+]
+
+setup(
+    name="lander",
+    version="1.0",
+    ext_modules=[
+        Extension(
+            "lander",
+            sources=SOURCES,
+            include_dirs=["."],
+            define_macros=[("LANDER_ENV_STATIC", None)],
+            extra_compile_args=["/std:c++17", "/O2"] if __import__("sys").platform == "win32" else ["-std=c++17", "-O2"],
+            language="c++",
+        )
+    ],
+)
@@ -0,0 +1,15 @@
+// The SDF font sheet, read as sprite_fragment.glsl's SDF variant does, in the glyph's own colour
+uniform sampler2D diffuse;
+
+varying vec2 texCoordVar;
+varying vec3 colourVar;
+
+void main() {
+    vec4 colour = texture2D(diffuse, texCoordVar);
+
+    vec2 distances = vec2(colour.r, colour.a);
+    vec2 ramp = max(fwidth(distances) * 0.5, vec2(0.001));
+    vec2 coverage = smoothstep(vec2(0.5) - ramp, vec2(0.5) + ramp, distances);
+
+    gl_FragColor = vec4(colourVar * coverage.x, coverage.y);
+}
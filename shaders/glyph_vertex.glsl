@@ -0,0 +1,37 @@
+// One glyph per instance (InstancedText): the unit quad is stretched over the glyph's box from its
+// pen position, and its UVs over the glyph's rect, both looked up in the font's table by index.
+// Needs GLSL 3.30 for the uniform blocks.
+attribute vec2 position;  // a corner of the unit quad, 0 to 1 with y down
+
+attribute vec2 instancePen;
+attribute float instanceSize;
+attribute float instanceGlyph;
+attribute vec3 instanceColour;
+
+// InstancedText::GLYPH_TABLE_BINDING; the FontMetrics of every glyph, written once
+layout(std140) uniform GlyphTable
+{
+    vec4 glyphRects[256];  // u, v, width, height
+    vec4 glyphBoxes[256];  // bearing x and y, then width and height, in ems
+};
+
+layout(std140) uniform Camera
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+};
+
+varying vec2 texCoordVar;
+varying vec3 colourVar;
+
+void main()
+{
+    int glyph = int(instanceGlyph);
+    vec4 box = glyphBoxes[glyph] * instanceSize;
+
+    vec2 corner = instancePen + box.xy + vec2(position.x * box.z, -position.y * box.w);
+    texCoordVar = glyphRects[glyph].xy + position * glyphRects[glyph].zw;
+    colourVar = instanceColour;
+
+    gl_Position = projectionMatrix * viewMatrix * vec4(corner, 0.0, 1.0);
+}
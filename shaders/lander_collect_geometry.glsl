@@ -0,0 +1,26 @@
+#version 330 core
+// Emits only the landers that have finished, so what transform feedback captures is a packed
+// list of episodes rather than the whole batch, and that list is all GpuLanderSim reads back.
+layout(points) in;
+layout(points, max_vertices = 1) out;
+
+flat in int collectLander[];
+in vec2 collectPosition[];
+in vec2 collectVelocity[];
+in vec4 collectOutcome[];
+
+flat out int outLander;
+out vec2 outPosition;
+out vec2 outVelocity;
+out vec4 outOutcome;
+
+void main()
+{
+    if (collectOutcome[0].x == 0.0) return;  // still flying
+
+    outLander = collectLander[0];
+    outPosition = collectPosition[0];
+    outVelocity = collectVelocity[0];
+    outOutcome = collectOutcome[0];
+    EmitVertex();
+}
@@ -0,0 +1,18 @@
+// Hands every lander to lander_collect_geometry.glsl with its index, which the geometry shader
+// can't see for itself. Needs GLSL 3.30.
+attribute vec2 landerPosition;
+attribute vec2 landerVelocity;
+attribute vec4 landerOutcome;
+
+flat varying int collectLander;
+varying vec2 collectPosition;
+varying vec2 collectVelocity;
+varying vec4 collectOutcome;
+
+void main()
+{
+    collectLander = gl_VertexID;
+    collectPosition = landerPosition;
+    collectVelocity = landerVelocity;
+    collectOutcome = landerOutcome;
+}
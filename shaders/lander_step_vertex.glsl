@@ -0,0 +1,100 @@
+// One lander per vertex, stepped once and captured by transform feedback into the other buffer
+// (see GpuLanderSim). Nothing is drawn. The arithmetic is BatchedLanderSim::step_lanes_scalar's,
+// operation for operation, against platforms fetched from a buffer texture, and the outcome is
+// decided in the same pass. A lander that has finished stays as it ended until it's collected.
+// Needs GLSL 3.30.
+attribute vec2 landerPosition;
+attribute vec2 landerVelocity;
+attribute vec4 landerOutcome;  // outcome, steps, touchdown speed, episode
+attribute vec4 launch;         // spawn position, launch velocity
+attribute vec4 controls;       // gravity, movement, booster (0 or 1)
+
+const float FLYING = 0.0, WON = 1.0, CRASHED = 2.0, OUT_OF_BOUNDS = 3.0, TIMED_OUT = 4.0;  // GpuLanderOutcome
+
+uniform samplerBuffer platforms;  // two texels each: centre and size, then the win and death flags
+uniform int platformCount;
+uniform float deltaTime;
+uniform vec3 physics;  // speed, drag, boosting power
+uniform vec2 landerSize;
+uniform vec4 bounds;   // min, max; a min past its max turns them off
+uniform int maxSteps;  // 0 for no limit
+uniform int relaunch;  // finished landers start their next episode this step
+
+varying vec2 outPosition;
+varying vec2 outVelocity;
+varying vec4 outOutcome;
+
+void main()
+{
+    vec2 p = landerPosition, v = landerVelocity;
+    vec4 outcome = landerOutcome;
+
+    if (relaunch != 0 && outcome.x != FLYING)
+    {
+        p = launch.xy;
+        v = launch.zw;
+        outcome = vec4(FLYING, 0.0, 0.0, outcome.w + 1.0);
+    }
+
+    if (outcome.x == FLYING)
+    {
+        bool touchedWin = false, touchedDeath = false;
+        float touchdownSpeed = 0.0;
+
+        // ––––– PHYSICS ––––– //
+        float acceleration = controls.y * physics.x;
+        if (v.x > 0.0)      acceleration -= physics.y;
+        else if (v.x < 0.0) acceleration += physics.y;
+
+        v.x += acceleration * deltaTime;
+        v.y += controls.x * deltaTime;
+
+        p.y += v.y * deltaTime;
+        for (int i = 0; i < platformCount; i++)
+        {
+            vec4 box = texelFetch(platforms, 2 * i);
+            vec2 gap = abs(p - box.xy) - (landerSize + box.zw) / 2.0;
+            if (!(gap.x < 0.0 && gap.y < 0.0) || v.y == 0.0) continue;
+
+            float overlap = abs(abs(p.y - box.y) - (landerSize.y / 2.0) - (box.w / 2.0));
+            if (v.y < 0.0)
+            {
+                vec4 kind = texelFetch(platforms, 2 * i + 1);
+                touchdownSpeed = -v.y;
+                touchedWin   = touchedWin   || kind.x != 0.0;
+                touchedDeath = touchedDeath || kind.y != 0.0;
+            }
+            p.y = v.y > 0.0 ? p.y - overlap : p.y + overlap;
+            v.y = 0.0;
+        }
+
+        p.x += v.x * deltaTime;
+        for (int i = 0; i < platformCount; i++)
+        {
+            vec4 box = texelFetch(platforms, 2 * i);
+            vec2 gap = abs(p - box.xy) - (landerSize + box.zw) / 2.0;
+            if (!(gap.x < 0.0 && gap.y < 0.0) || v.x == 0.0) continue;
+
+            float overlap = abs(abs(p.x - box.x) - (landerSize.x / 2.0) - (box.z / 2.0));
+            p.x = v.x > 0.0 ? p.x - overlap : p.x + overlap;
+            v.x = 0.0;
+        }
+
+        // ––––– BOOSTING ––––– //
+        if (controls.z != 0.0) v.y += physics.z;
+
+        // ––––– OUTCOME ––––– //
+        // A touchdown on both kinds at once counts as the landing, as BatchedLanderSim has it
+        bool outside = bounds.x <= bounds.z && (p.x < bounds.x || p.x > bounds.z || p.y < bounds.y || p.y > bounds.w);
+        outcome.y += 1.0;
+        outcome.z = touchdownSpeed;
+        if (touchedWin)                                          outcome.x = WON;
+        else if (touchedDeath)                                   outcome.x = CRASHED;
+        else if (outside)                                        outcome.x = OUT_OF_BOUNDS;
+        else if (maxSteps > 0 && outcome.y >= float(maxSteps))   outcome.x = TIMED_OUT;
+    }
+
+    outPosition = p;
+    outVelocity = v;
+    outOutcome = outcome;
+}
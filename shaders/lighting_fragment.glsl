@@ -0,0 +1,38 @@
+// Every light at once, multiplied into what's already drawn (see LightingPass). Light i reads row
+// i of the shadow map, in the direction this fragment lies from it: anything further away than
+// the distance found there is behind an occluder.
+uniform sampler2D shadowMap;
+uniform vec4  lights[MAX_LIGHTS];        // xy the position, z the radius
+uniform vec3  lightColours[MAX_LIGHTS];
+uniform int   lightCount;
+uniform float shadowScale;  // how much of each row is in use, across
+uniform float ambient;
+
+varying vec2 worldPosition;
+
+const float SHADOW_BIAS     = 0.15;  // world units past an occluder's edge that are still lit, so its lit face shows
+const float SHADOW_SOFTNESS = 0.1;   // world units a shadow's edge fades over
+
+void main()
+{
+    vec3 light = vec3(ambient);
+    for (int i = 0; i < MAX_LIGHTS; i++)
+    {
+        if (i >= lightCount) break;
+
+        vec2  offset = worldPosition - lights[i].xy;
+        float radius = lights[i].z;
+        float reach  = length(offset) / radius;
+        if (reach >= 1.0) continue;
+
+        vec2  uv = vec2((atan(offset.y, offset.x) / 6.28318531 + 0.5) * shadowScale, (float(i) + 0.5) / float(MAX_LIGHTS));
+        float occluder = texture2D(shadowMap, uv).r;
+        float lit = clamp(((occluder - reach) * radius + SHADOW_BIAS) / SHADOW_SOFTNESS, 0.0, 1.0);
+
+        float falloff = 1.0 - reach;
+        light += lightColours[i] * (falloff * falloff * lit);
+    }
+
+    // Blended as source * destination * 2, so 0.5 leaves the scene as it was drawn
+    gl_FragColor = vec4(light * 0.5, 0.5);
+}
@@ -0,0 +1,6 @@
+// Never runs: the transform feedback passes (GpuParticleSystem, GpuLanderSim) draw with the
+// rasterizer off. Only here to make a whole program.
+void main()
+{
+    gl_FragColor = vec4(0.0);
+}
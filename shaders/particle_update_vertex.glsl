@@ -0,0 +1,65 @@
+// One particle per vertex, aged a frame and captured by transform feedback into the other
+// buffer (see GpuParticleSystem). Nothing is drawn. The slots an emit command covers this frame
+// are launched afresh instead, their scatter hashed from the slot and the command's seed, so an
+// emit costs the CPU a few uniforms however many particles it makes. Needs GLSL 3.30.
+attribute vec2 offset;
+attribute vec2 velocity;
+attribute float age;
+
+const int MAX_EMITS = 16;  // GpuParticleSystem::MAX_EMITS
+
+uniform float deltaTime;
+uniform float lifetime;
+uniform float gravity;
+uniform vec2 sizes;  // at birth, at the end of the lifetime
+uniform int capacity;
+uniform int emitCount;
+uniform vec4 emitMotion[MAX_EMITS];  // position, velocity
+uniform vec4 emitSlots[MAX_EMITS];   // first slot, slot count, spread, seed
+
+varying vec2 outOffset;
+varying vec2 outScale;
+varying vec2 outVelocity;
+varying float outAge;
+
+// -1 to 1
+float scatter(uint value)
+{
+    value = value * 747796405u + 2891336453u;
+    value = ((value >> ((value >> 28u) + 4u)) ^ value) * 277803737u;
+    value = (value >> 22u) ^ value;
+    return float(value) / 2147483647.5 - 1.0;
+}
+
+void main()
+{
+    vec2 p = offset, v = velocity;
+    float a = age;
+
+    // Later commands win where they overlap, just as a full pool overwrites its oldest
+    for (int i = 0; i < emitCount; i++)
+    {
+        int k = gl_VertexID - int(emitSlots[i].x);
+        if (k < 0) k += capacity;
+        if (k >= int(emitSlots[i].y)) continue;
+
+        uint key = uint(gl_VertexID) * 2u + uint(emitSlots[i].w) * 0x9E3779B9u;
+        p = emitMotion[i].xy;
+        v = emitMotion[i].zw + vec2(scatter(key), scatter(key + 1u)) * emitSlots[i].z;
+        a = 0.0;
+    }
+
+    // Constant acceleration, so this is exact at any frame rate
+    if (a < lifetime)
+    {
+        p += v * deltaTime + vec2(0.0, 0.5 * gravity * deltaTime * deltaTime);
+        v.y += gravity * deltaTime;
+        a += deltaTime;
+    }
+
+    // A dead particle keeps its slot at no size, so the draw covers no pixels for it
+    outOffset = p;
+    outVelocity = v;
+    outAge = a;
+    outScale = a < lifetime ? vec2(mix(sizes.x, sizes.y, a / lifetime)) : vec2(0.0);
+}
@@ -0,0 +1,73 @@
+// Every post-processing pass, picked by PostProcess's #defines. BRIGHT and BLUR are the bloom's
+// own passes at a fraction of the size; anything else is the per-pixel passes named, run one after
+// another in a single draw: each is a function of the one before it, so no target sits in between.
+uniform sampler2D source;  // the scene, or the last pass's output
+uniform sampler2D bloom;   // BLOOM: the blurred highlights
+uniform vec2 uvScale;      // how much of `source` holds the picture; under 1 when drawn below full size
+uniform vec2 texelSize;    // of `source`
+
+uniform vec2  direction;      // BLUR: one texel along the axis blurred
+uniform float threshold;      // BRIGHT: the brightness bloom starts at
+uniform float bloomStrength;  // BLOOM
+uniform vec2  outputSize;     // CRT: in pixels, for one scanline per pair of them
+
+varying vec2 texCoordVar;
+
+vec3 read_source(vec2 uv)
+{
+    return texture2D(source, uv * uvScale).rgb;
+}
+
+#if defined(BRIGHT)
+void main()
+{
+    // Four bilinear taps average a 4x4 block, so a quarter-size target misses nothing in between
+    vec2 uv = texCoordVar;
+    vec2 step = texelSize / uvScale;
+    vec3 colour = (read_source(uv + vec2(-step.x, -step.y)) + read_source(uv + vec2(step.x, -step.y)) +
+                   read_source(uv + vec2(-step.x,  step.y)) + read_source(uv + vec2(step.x,  step.y))) * 0.25;
+
+    float luma = dot(colour, vec3(0.2126, 0.7152, 0.0722));
+    gl_FragColor = vec4(colour * (max(luma - threshold, 0.0) / max(luma, 0.0001)), 1.0);
+}
+#elif defined(BLUR)
+void main()
+{
+    // A 9-tap Gaussian in five reads: the outer pairs land between texels and let the filtering
+    // weigh them
+    vec3 colour = read_source(texCoordVar) * 0.2270270270;
+    colour += (read_source(texCoordVar + direction * 1.3846153846) + read_source(texCoordVar - direction * 1.3846153846)) * 0.3162162162;
+    colour += (read_source(texCoordVar + direction * 3.2307692308) + read_source(texCoordVar - direction * 3.2307692308)) * 0.0702702703;
+    gl_FragColor = vec4(colour, 1.0);
+}
+#else
+vec3 colour_at(vec2 uv)
+{
+    vec3 colour = read_source(uv);
+#ifdef BLOOM
+    colour += texture2D(bloom, uv).rgb * bloomStrength;
+#endif
+#ifdef VIGNETTE
+    vec2 centred = uv - 0.5;
+    colour *= 1.0 - dot(centred, centred) * 0.9;
+#endif
+    return colour;
+}
+
+void main()
+{
+#ifdef CRT
+    // The beam's colours a little apart towards the edges, dark lines between the scanlines and a
+    // faint shadow mask across them
+    vec2 spread = (texCoordVar - 0.5) * 0.004;
+    vec3 colour = vec3(colour_at(texCoordVar + spread).r, colour_at(texCoordVar).g, colour_at(texCoordVar - spread).b);
+    colour *= 0.75 + 0.25 * sin(texCoordVar.y * outputSize.y * 3.14159265);
+    float column = mod(floor(texCoordVar.x * outputSize.x), 3.0);
+    colour *= 0.9 + 0.1 * vec3(equal(vec3(column), vec3(0.0, 1.0, 2.0)));
+    colour *= 1.15;
+#else
+    vec3 colour = colour_at(texCoordVar);
+#endif
+    gl_FragColor = vec4(colour, 1.0);
+}
+#endif
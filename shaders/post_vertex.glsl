@@ -0,0 +1,11 @@
+// One triangle over the whole target, straight in clip space (see PostProcess). Every pass reads
+// its inputs at texCoordVar, 0-1 over the picture.
+attribute vec4 position;
+
+varying vec2 texCoordVar;
+
+void main()
+{
+    texCoordVar = position.xy * 0.5 + 0.5;
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+}
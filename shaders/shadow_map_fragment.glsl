@@ -0,0 +1,25 @@
+// How far the ray through this texel runs from the light before it meets the edge, as a
+// fraction of the light's radius. Drawn with GL_MIN blending over a clear of 1.0, so each texel
+// ends up holding the nearest edge in its direction, or 1.0 if nothing is in reach.
+uniform float angleScale;  // radians per texel: two pi over the texels in use
+
+varying vec4 edge;
+
+float cross2(vec2 a, vec2 b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+void main()
+{
+    float angle = gl_FragCoord.x * angleScale - 3.14159265;
+    vec2 ray = vec2(cos(angle), sin(angle));
+    vec2 start = edge.xy;
+    vec2 along = edge.zw - edge.xy;
+
+    // Where the ray crosses the edge, held to its ends: the quad reaches half a texel past them,
+    // and a ray that only just misses takes the nearer end
+    float facing = cross2(ray, along);
+    float s = abs(facing) > 0.00001 ? clamp(cross2(start, ray) / facing, 0.0, 1.0) : 0.0;
+    gl_FragColor = vec4(min(length(start + along * s), 1.0));
+}
@@ -0,0 +1,13 @@
+// One quad per occluder edge and light, already in the shadow map's clip space (see
+// LightingPass): across is the angle the edge covers around the light, up is the light's row.
+// The edge itself comes along, so each texel can find where its own ray meets it.
+attribute vec4 position;
+attribute vec4 texCoord;  // the edge's two ends, from the light, in units of its radius
+
+varying vec4 edge;
+
+void main()
+{
+    edge = texCoord;
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+}
@@ -0,0 +1,72 @@
+// Untextured variants draw flat `color`, or each vertex's own under VERTEX_COLOUR; TINTED multiplies the texture by it instead. SDF reads
+// the texel as two distance fields (see make_sdf_font.cpp) instead of as a colour, and GLYPHS does
+// so only for the quads the vertices mark as glyphs. LAYERED samples one layer of a texture array,
+// and only compiles under GLSL 3.30. MATERIAL reads the texel's red as a grey level between the
+// instance's shadow and highlight colours, so one greyscale frame serves every look.
+#ifdef LAYERED
+uniform sampler2DArray diffuse;
+flat varying float layerVar;
+#elif defined(TEXTURED)
+uniform sampler2D diffuse;
+#endif
+
+#ifdef TEXTURED
+varying vec2 texCoordVar;
+#endif
+
+#if defined(GLYPHS) && !defined(LAYERED)
+varying float glyphVar;
+#endif
+
+#if defined(TINTED) || !defined(TEXTURED)
+uniform vec4 color;
+#endif
+
+#ifdef VERTEX_COLOUR
+varying vec4 colourVar;
+#endif
+
+#ifdef MATERIAL
+varying vec4 shadowVar;
+varying vec4 highlightVar;
+#endif
+
+void main() {
+#if defined(LAYERED)
+    vec4 colour = texture(diffuse, vec3(texCoordVar, layerVar));
+#elif defined(TEXTURED)
+    vec4 colour = texture2D(diffuse, texCoordVar);
+#endif
+#ifdef TEXTURED
+#if defined(SDF) || (defined(GLYPHS) && !defined(LAYERED))
+    // Alpha is the distance to the glyph's outer edge and red the distance to its fill, both 0.5 on
+    // the edge. A ramp as wide as one pixel's worth of distance keeps both edges sharp at any size.
+    vec2 distances = vec2(colour.r, colour.a);
+    vec2 ramp = max(fwidth(distances) * 0.5, vec2(0.001));
+    vec2 coverage = smoothstep(vec2(0.5) - ramp, vec2(0.5) + ramp, distances);
+#ifdef SDF
+    colour = vec4(vec3(coverage.x), coverage.y);
+#else
+    // Picked rather than branched on, so the derivatives above stay defined for the whole quad
+    colour = mix(colour, vec4(vec3(coverage.x), coverage.y), glyphVar);
+#endif
+#endif
+#ifdef MATERIAL
+    colour = vec4(mix(shadowVar.rgb, highlightVar.rgb, colour.r), colour.a * shadowVar.a);
+#endif
+#ifdef TINTED
+    colour *= color;
+#endif
+#elif defined(VERTEX_COLOUR)
+    vec4 colour = colourVar;
+#else
+    vec4 colour = color;
+#endif
+
+#ifdef ALPHA_TEST
+    // Cut-out sprites: no blending needed, and the hidden texels never reach the framebuffer
+    if (colour.a < 0.5) discard;
+#endif
+
+    gl_FragColor = colour;
+}
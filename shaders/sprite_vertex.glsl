@@ -0,0 +1,91 @@
+// One source for every sprite shader. ShaderVariants puts a #define in front for each feature
+// bit, so each permutation only carries the attributes and maths it needs.
+attribute vec4 position;
+
+#ifdef TEXTURED
+attribute vec2 texCoord;
+varying vec2 texCoordVar;
+#endif
+
+#ifdef LAYERED
+// Which layer of the texture array the quad samples; the same at every corner
+attribute float layer;
+flat varying float layerVar;
+#elif defined(GLYPHS)
+// The same attribute marks a quad as a distance-field glyph (1) rather than a sprite (0)
+attribute float layer;
+varying float glyphVar;
+#endif
+
+#ifdef VERTEX_COLOUR
+attribute vec4 vertexColour;
+varying vec4 colourVar;
+#endif
+
+#ifdef INSTANCED
+attribute vec2 instanceOffset;
+attribute vec2 instanceScale;
+attribute vec4 instanceUvRect;
+#else
+uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)
+#endif
+
+#ifdef MATERIAL
+// InstanceMaterials: a tint, and which ramp the grey texel is read along and how the frame is
+// mirrored. The ramp is looked up here, since ES 2.0 fragment shaders can't index uniforms freely.
+#define PALETTE_SIZE 8  // InstanceMaterials::MAX_PALETTES
+attribute vec4 instanceTint;
+attribute vec2 instanceMaterial;  // palette, variation
+uniform vec3 palette[PALETTE_SIZE * 2];  // shadow, highlight
+varying vec4 shadowVar;
+varying vec4 highlightVar;
+#endif
+
+#ifdef GLSL_330
+// Shared by every variant, and uploaded once when the camera moves (see ShaderVariants)
+layout(std140) uniform Camera
+{
+    mat4 viewMatrix;
+    mat4 projectionMatrix;
+};
+#else
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+#endif
+
+void main()
+{
+#ifdef INSTANCED
+	vec4 p = viewMatrix * vec4(position.xy * instanceScale + instanceOffset, 0.0, 1.0);
+#else
+	vec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);
+#endif
+
+#if defined(TEXTURED) && defined(INSTANCED) && defined(MATERIAL)
+    // Bit 0 of the variation mirrors the frame across u, bit 1 across v
+    vec2 mirror = vec2(mod(instanceMaterial.y, 2.0), floor(instanceMaterial.y / 2.0));
+    texCoordVar = instanceUvRect.xy + mix(texCoord, vec2(1.0) - texCoord, mirror) * instanceUvRect.zw;
+#elif defined(TEXTURED) && defined(INSTANCED)
+    texCoordVar = instanceUvRect.xy + texCoord * instanceUvRect.zw;
+#elif defined(TEXTURED)
+    texCoordVar = texCoord;
+#endif
+
+#ifdef LAYERED
+    layerVar = layer;
+#elif defined(GLYPHS)
+    glyphVar = layer;
+#endif
+
+#ifdef VERTEX_COLOUR
+    colourVar = vertexColour;
+#endif
+
+#ifdef MATERIAL
+    int ramp = int(instanceMaterial.x) * 2;
+    shadowVar = vec4(palette[ramp] * instanceTint.rgb, instanceTint.a);
+    highlightVar = vec4(palette[ramp + 1] * instanceTint.rgb, instanceTint.a);
+#endif
+
+	gl_Position = projectionMatrix * p;
+}
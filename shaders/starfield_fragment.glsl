@@ -0,0 +1,44 @@
+// Stars made up on the spot, in LAYERS grids of cells that each hold at most one star at a
+// hashed spot. A layer only follows `depth` of the camera's motion, so the far ones (small
+// depth, fine and dim) drift behind the near ones. Blended over the clear colour.
+uniform vec2 viewMin;
+uniform vec2 viewMax;
+
+varying vec2 worldPosition;
+
+const int   LAYERS      = 3;
+const float STAR_CHANCE = 0.25;  // of a cell holding a star
+const vec3  STAR_COLOUR = vec3(0.85, 0.9, 1.0);
+
+float hash(vec2 cell)
+{
+    return fract(sin(dot(cell, vec2(127.1, 311.7))) * 43758.5453);
+}
+
+void main()
+{
+    vec2 camera = (viewMin + viewMax) * 0.5;
+    float brightness = 0.0;
+
+    for (int i = 0; i < LAYERS; i++)
+    {
+        float layer    = float(i);
+        float depth    = 0.1 + 0.25 * layer;
+        float cellSize = 0.5 + 0.35 * layer;
+
+        // The layer's own seed keeps its stars from lining up with the others'
+        vec2 p    = (worldPosition - camera * (1.0 - depth)) / cellSize + layer * 37.0;
+        vec2 cell = floor(p);
+        vec2 spot = vec2(hash(cell + 3.1), hash(cell + 7.7)) * 0.8 + 0.1;
+
+        // Round, and no smaller than a pixel, whatever the zoom
+        float pixel  = fwidth(p.x);
+        float radius = max((0.015 + 0.01 * layer) / cellSize, pixel);
+        float star   = 1.0 - smoothstep(radius - pixel, radius + pixel, length(p - cell - spot));
+
+        float present = step(1.0 - STAR_CHANCE, hash(cell));
+        brightness += star * present * (0.35 + 0.25 * layer) * (0.5 + 0.5 * hash(cell + 11.3));
+    }
+
+    gl_FragColor = vec4(STAR_COLOUR, clamp(brightness, 0.0, 1.0));
+}
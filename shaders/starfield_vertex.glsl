@@ -0,0 +1,14 @@
+// One triangle over the whole screen, straight in clip space. Each fragment gets the world
+// position it covers, from the corners of the view.
+attribute vec4 position;
+
+uniform vec2 viewMin;
+uniform vec2 viewMax;
+
+varying vec2 worldPosition;
+
+void main()
+{
+    worldPosition = mix(viewMin, viewMax, position.xy * 0.5 + 0.5);
+    gl_Position = vec4(position.xy, 0.0, 1.0);
+}
@@ -1,11 +1,11 @@
 attribute vec4 position;
 
-uniform mat4 modelMatrix;
+uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
 void main()
 {
-	vec4 p = viewMatrix * modelMatrix  * position;
+	vec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);
 	gl_Position = projectionMatrix * p;
 }
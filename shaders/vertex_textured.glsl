@@ -1,7 +1,7 @@
 attribute vec4 position;
 attribute vec2 texCoord;
 
-uniform mat4 modelMatrix;
+uniform vec2 modelTransform[3];  // x axis, y axis, translation (ModelTransform)
 uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 
@@ -9,7 +9,7 @@ varying vec2 texCoordVar;
 
 void main()
 {
-	vec4 p = viewMatrix * modelMatrix  * position;
+	vec4 p = viewMatrix * vec4(modelTransform[0] * position.x + modelTransform[1] * position.y + modelTransform[2] * position.w, position.zw);
     texCoordVar = texCoord;
 	gl_Position = projectionMatrix * p;
 }
\ No newline at end of file
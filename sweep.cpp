@@ -0,0 +1,1025 @@
+/**
+* Author: Raymond Lin
+* Assignment: Lunar Lander
+* Date due: 2023-11-08, 11:59pm
+* I pledge that I have completed this assignment without
+* collaborating with anyone else, in conformance with the
+* NYU School of Engineering Policies and Procedures on
+* Academic Misconduct.
+**/
+
+// Parameter sweep for physics tuning: flies a pilot through every combination of lander tuning
+// and platform layout in the ranges given, and reports how often it lands and how hard.
+//
+//     LanderSweep [--gravity -1.2:-0.4] [--drag 0.8] [--boost 0.05:0.2] [--speed 2]
+//                 [--platforms 9] [--layouts classic,uniform] [--grid 5 | --lhs 2000]
+//                 [--pilot scripted | <policy file>] [--episodes 64] [--levels 4]
+//                 [--max-steps 1200] [--threads 0] [--seed 1] [--csv <file>]
+//                 [--coordinate <port>]
+//     LanderSweep --work <host:port> [--threads 0]
+//
+// A range is min:max and a single value holds that parameter fixed. --grid N takes N evenly
+// spaced values of every ranged parameter and tries all their combinations with every layout;
+// --lhs N draws N configs as a Latin hypercube instead, each parameter's range (and the layout
+// list) cut into N strata that each get used exactly once, which covers many parameters with
+// far fewer configs than a grid would.
+//
+// Each config flies `episodes` landers, from around the spawn point, on each of `levels` seeded
+// scenes, all at once in a BatchedLanderSim; configs run one per task across every core (threads
+// 0) in a JobSystem. The pilot is headless.cpp's scripted controller or a PolicyNetwork fed
+// LanderEnv's observations; the batch has no contact sensors, so those inputs stay 0. Prints a
+// table per swept parameter, plus the best configs; --csv writes every config's row.
+//
+// A sweep too big for one machine runs with --coordinate, which evaluates nothing itself: any
+// number of --work processes, on as many nodes, connect to it and pull batches of configs over
+// one TCP connection each. The policy goes to each worker once, on connecting; after that a
+// config is 28 bytes one way and its tallies 40 bytes back, and a batch is enough configs to
+// keep every worker thread busy for a while, with the next batch already sent before the last
+// one's results come back, so the network costs the workers next to nothing. A worker that
+// drops out has its batches handed to the others. Every config flies the same landers wherever
+// it runs, so the tables come out as they would on one machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BatchedLanderSim.h"
+#include "JobSystem.h"
+#include "LanderEnv.h"
+#include "NetSocket.h"
+#include "PolicyNetwork.h"
+#include "Rng.h"
+#include "SceneGenerator.h"
+#include "Simulation.h"
+#include "TuningConfig.h"
+
+const int          DEFAULT_GRID      = 5,
+                   DEFAULT_EPISODES  = 64,
+                   DEFAULT_LEVELS    = 4,
+                   DEFAULT_MAX_STEPS = 1200;  // twenty seconds of game time
+const unsigned int DEFAULT_SEED      = 1;
+
+// Landers start this far either side of the spawn point, so one level isn't one trajectory
+const float SPAWN_SPREAD  = 2.0f;
+// Past the outermost platforms, or below the lowest, a lander is out of bounds
+const float BOUNDS_MARGIN = 10.0f;
+// A Latin hypercube's configs are binned into this many rows per parameter's table at most
+const int   MAX_TABLE_ROWS = 10;
+const int   BEST_CONFIG_COUNT = 5;
+
+// A batch keeps each of a worker's threads busy with this many configs...
+const int BATCH_CONFIGS_PER_THREAD = 32;
+// ...and this many batches are out to a worker at once, so it never waits on a round trip
+const int BATCHES_IN_FLIGHT        = 2;
+const int CONNECT_TIMEOUT_MS       = 5000,
+          ACCEPT_WAIT_MS           = 200,
+          WORKER_TIMEOUT_MS        = 10 * 60 * 1000;  // the longest a batch, or an idle worker, may take
+
+// ————— CONFIGS ————— //
+enum SweepParameter
+{
+    SWEEP_GRAVITY,
+    SWEEP_DRAG,
+    SWEEP_BOOSTING_POWER,
+    SWEEP_SPEED,
+    SWEEP_PLATFORMS,
+    SWEEP_PARAMETER_COUNT
+};
+
+const char* const PARAMETER_NAMES[SWEEP_PARAMETER_COUNT] = { "gravity", "drag", "boosting_power", "speed", "platforms" };
+
+struct SweepRange
+{
+    float min, max;
+    bool  integer;
+
+    bool const is_swept() const { return max > min; };
+};
+
+struct SweepConfig
+{
+    float      values[SWEEP_PARAMETER_COUNT];
+    SceneLayout layout;
+
+    // ————— RESULTS ————— //
+    int    episodes      = 0,
+           wins          = 0,
+           crashes       = 0,
+           out_of_bounds = 0,
+           timeouts      = 0;
+    double landing_speed_sum   = 0.0;
+    float  worst_landing_speed = 0.0f;
+
+    float const get_success_rate() const { return episodes > 0 ? (float)wins / episodes : 0.0f; };
+};
+
+// Everything a task reads; shared by all of them, so nothing in here changes once they start
+struct SweepSettings
+{
+    SweepRange               ranges[SWEEP_PARAMETER_COUNT];
+    std::vector<SceneLayout> layouts;
+    int                      episodes  = DEFAULT_EPISODES,
+                             levels    = DEFAULT_LEVELS,
+                             max_steps = DEFAULT_MAX_STEPS;
+    unsigned int             seed      = DEFAULT_SEED;
+    const PolicyNetwork*     policy    = NULL;  // NULL flies the scripted pilot
+};
+
+float get_value(const SweepRange& range, float t)
+{
+    float value = range.min + t * (range.max - range.min);
+    return range.integer ? std::round(value) : value;
+}
+
+// Every combination of `count` values per swept parameter, with every layout
+std::vector<SweepConfig> expand_grid(const SweepSettings& settings, int count)
+{
+    std::vector<SweepConfig> configs(1);
+    for (int parameter = 0; parameter < SWEEP_PARAMETER_COUNT; parameter++)
+    {
+        const SweepRange& range = settings.ranges[parameter];
+        int steps = range.is_swept() ? count : 1;
+        if (range.integer) steps = std::min(steps, (int)(range.max - range.min) + 1);
+
+        std::vector<SweepConfig> expanded;
+        expanded.reserve(configs.size() * steps);
+        for (const SweepConfig& config : configs)
+        {
+            for (int step = 0; step < steps; step++)
+            {
+                SweepConfig next = config;
+                next.values[parameter] = get_value(range, steps > 1 ? (float)step / (steps - 1) : 0.0f);
+                expanded.push_back(next);
+            }
+        }
+        configs.swap(expanded);
+    }
+
+    std::vector<SweepConfig> expanded;
+    expanded.reserve(configs.size() * settings.layouts.size());
+    for (const SweepConfig& config : configs)
+    {
+        for (SceneLayout layout : settings.layouts)
+        {
+            SweepConfig next = config;
+            next.layout = layout;
+            expanded.push_back(next);
+        }
+    }
+    return expanded;
+}
+
+// `count` configs, each parameter's range cut into `count` strata, one draw from each, shuffled
+// independently per parameter so the strata pair up at random
+std::vector<SweepConfig> expand_latin_hypercube(const SweepSettings& settings, int count)
+{
+    Rng rng(settings.seed, 0x5eed);
+    std::vector<SweepConfig> configs(count);
+    std::vector<int> strata(count);
+
+    auto shuffle = [&]()
+    {
+        for (int i = 0; i < count; i++) strata[i] = i;
+        for (int i = count - 1; i > 0; i--) std::swap(strata[i], strata[rng.next_int(0, i)]);
+    };
+
+    for (int parameter = 0; parameter < SWEEP_PARAMETER_COUNT; parameter++)
+    {
+        shuffle();
+        for (int i = 0; i < count; i++) configs[i].values[parameter] = get_value(settings.ranges[parameter], (strata[i] + rng.next_float()) / count);
+    }
+
+    // The layouts are strata too: an even share of the configs each
+    shuffle();
+    int layout_count = (int)settings.layouts.size();
+    for (int i = 0; i < count; i++) configs[i].layout = settings.layouts[(long long)strata[i] * layout_count / count];
+    return configs;
+}
+
+// ————— PILOTS ————— //
+// headless.cpp's control(), for a whole batch: hold the booster while falling too fast, and
+// otherwise drift toward the nearest WIN platform
+void fly_scripted(BatchedLanderSim& sim, const float* observations)
+{
+    for (int lander = 0; lander < sim.get_lander_count(); lander++)
+    {
+        const float* observation = &observations[lander * LANDER_OBSERVATION_SIZE];
+        bool booster = observation[LANDER_OBS_VELOCITY_Y] < -1.0f;
+
+        float movement_x = 0.0f;
+        if (!booster)
+        {
+            if      (observation[LANDER_OBS_WIN_OFFSET_X] < -0.1f) movement_x = -1.0f;
+            else if (observation[LANDER_OBS_WIN_OFFSET_X] >  0.1f) movement_x = 1.0f;
+        }
+        sim.set_controls(lander, movement_x, booster);
+    }
+}
+
+// PolicyFleet's reading of the scores: left, right and boost each on while positive
+void fly_policy(BatchedLanderSim& sim, PolicyNetwork& network, const float* observations, std::vector<float>& scores)
+{
+    int count = sim.get_lander_count(),
+        output_size = network.get_output_size();
+
+    scores.resize((size_t)count * output_size);
+    network.evaluate(observations, LANDER_OBSERVATION_SIZE, count, scores.data(), output_size);
+
+    for (int lander = 0; lander < count; lander++)
+    {
+        const float* score = &scores[(size_t)lander * output_size];
+        float movement_x = (score[0] > 0.0f ? -1.0f : 0.0f) + (score[1] > 0.0f ? 1.0f : 0.0f);
+        sim.set_controls(lander, movement_x, score[2] > 0.0f);
+    }
+}
+
+// BatchedLanderEnv::observe for every lander; the contacts stay 0
+void observe(const BatchedLanderSim& sim, const std::vector<glm::vec2>& win_platforms, float* observations)
+{
+    for (int lander = 0; lander < sim.get_lander_count(); lander++)
+    {
+        glm::vec3 position = sim.get_position(lander),
+                  velocity = sim.get_velocity(lander);
+
+        glm::vec2 win_offset = glm::vec2(0.0f);
+        if (!win_platforms.empty())
+        {
+            auto after = std::lower_bound(win_platforms.begin(), win_platforms.end(), position.x,
+                                          [](const glm::vec2& platform, float x) { return platform.x < x; });
+
+            glm::vec2 nearest;
+            if      (after == win_platforms.begin()) nearest = *after;
+            else if (after == win_platforms.end())   nearest = *(after - 1);
+            else    nearest = (position.x - (after - 1)->x <= after->x - position.x) ? *(after - 1) : *after;
+
+            win_offset = nearest - glm::vec2(position);
+        }
+
+        float* observation = &observations[lander * LANDER_OBSERVATION_SIZE];
+        observation[LANDER_OBS_POSITION_X]   = position.x;
+        observation[LANDER_OBS_POSITION_Y]   = position.y;
+        observation[LANDER_OBS_VELOCITY_X]   = velocity.x;
+        observation[LANDER_OBS_VELOCITY_Y]   = velocity.y;
+        observation[LANDER_OBS_WIN_OFFSET_X] = win_offset.x;
+        observation[LANDER_OBS_WIN_OFFSET_Y] = win_offset.y;
+    }
+}
+
+// ————— EVALUATION ————— //
+struct SweepTask
+{
+    const SweepSettings* settings;
+    SweepConfig*         config;
+    int                  index;
+};
+
+void evaluate_config(void* user_data)
+{
+    SweepTask& task = *(SweepTask*)user_data;
+    const SweepSettings& settings = *task.settings;
+    SweepConfig& config = *task.config;
+
+    // STEP 1: The prototype lander under this config's tuning
+    LanderTuning tuning;
+    tuning.gravity        = config.values[SWEEP_GRAVITY];
+    tuning.drag           = config.values[SWEEP_DRAG];
+    tuning.boosting_power = config.values[SWEEP_BOOSTING_POWER];
+    tuning.speed          = config.values[SWEEP_SPEED];
+
+    Entity prototype;
+    setup_player(&prototype);
+    apply_lander_tuning(prototype, tuning);
+
+    SceneConfig scene;
+    scene.layout         = config.layout;
+    scene.platform_count = std::max(1, (int)config.values[SWEEP_PLATFORMS]);
+
+    // Per thread rather than per task, since evaluate() writes into the network's own tiles
+    thread_local PolicyNetwork network;
+    if (settings.policy != NULL && !network.is_loaded()) network = *settings.policy;
+
+    thread_local BatchedLanderSim sim;
+    thread_local std::vector<Entity> platforms;
+    thread_local std::vector<glm::vec2> win_platforms;
+    thread_local std::vector<float> observations, scores;
+
+    sim.initialise(prototype, settings.episodes);
+    platforms.assign(scene.platform_count, Entity());
+    observations.assign((size_t)settings.episodes * LANDER_OBSERVATION_SIZE, 0.0f);
+
+    for (int level = 0; level < settings.levels; level++)
+    {
+        // STEP 2: The level, the same for every config so they're compared on equal terms, and
+        //         bounds around it
+        generate_scene(platforms.data(), scene, settings.seed + level);
+        sim.set_platforms(platforms.data(), scene.platform_count);
+
+        glm::vec2 min = glm::vec2(platforms[0].get_position()),
+                  max = min;
+        win_platforms.clear();
+        for (const Entity& platform : platforms)
+        {
+            glm::vec2 position = glm::vec2(platform.get_position());
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+            if (platform.get_entity_type() == WIN_PLATFORM) win_platforms.push_back(position);
+        }
+        std::sort(win_platforms.begin(), win_platforms.end(), [](const glm::vec2& a, const glm::vec2& b) { return a.x < b.x; });
+
+        min = glm::min(min, glm::vec2(-SPAWN_SPREAD, 0.0f)) - glm::vec2(BOUNDS_MARGIN);
+        max = glm::max(max, glm::vec2(SPAWN_SPREAD, 3.0f)) + glm::vec2(BOUNDS_MARGIN);
+        sim.set_bounds(min, max);
+
+        // STEP 3: Every lander off from its own spot near the spawn point...
+        Rng rng(settings.seed, (uint64_t)task.index * settings.levels + level);
+        for (int lander = 0; lander < settings.episodes; lander++)
+        {
+            sim.reset(lander, glm::vec3((rng.next_float() * 2.0f - 1.0f) * SPAWN_SPREAD, 3.0f, 0.0f), tuning.gravity);
+        }
+
+        // STEP 4: ...and flown together until they're all down or the time's up
+        for (int step = 0; step < settings.max_steps && sim.get_done_count() < settings.episodes; step++)
+        {
+            observe(sim, win_platforms, observations.data());
+            if (settings.policy != NULL) fly_policy(sim, network, observations.data(), scores);
+            else                         fly_scripted(sim, observations.data());
+            sim.step(FIXED_TIMESTEP);
+        }
+
+        // STEP 5: Tallied
+        for (int lander = 0; lander < settings.episodes; lander++)
+        {
+            config.episodes++;
+            if (sim.has_won(lander))
+            {
+                float speed = sim.get_touchdown_speed(lander);
+                config.wins++;
+                config.landing_speed_sum += speed;
+                config.worst_landing_speed = std::max(config.worst_landing_speed, speed);
+            }
+            else if (sim.is_out_of_bounds(lander)) config.out_of_bounds++;
+            else if (sim.has_lost(lander))         config.crashes++;
+            else                                   config.timeouts++;
+        }
+    }
+}
+
+// ————— REPORT ————— //
+struct TableRow
+{
+    double value_sum = 0.0;
+    int    configs   = 0;
+    long long episodes = 0, wins = 0, crashes = 0, out_of_bounds = 0, timeouts = 0;
+    double landing_speed_sum   = 0.0;
+    float  worst_landing_speed = 0.0f;
+
+    void add(const SweepConfig& config, float value)
+    {
+        value_sum += value;
+        configs++;
+        episodes            += config.episodes;
+        wins                += config.wins;
+        crashes             += config.crashes;
+        out_of_bounds       += config.out_of_bounds;
+        timeouts            += config.timeouts;
+        landing_speed_sum   += config.landing_speed_sum;
+        worst_landing_speed  = std::max(worst_landing_speed, config.worst_landing_speed);
+    }
+};
+
+void print_table(const char* heading, const std::vector<std::string>& labels, const std::vector<TableRow>& rows)
+{
+    std::printf("\n%-16s %8s %9s %8s %8s %8s %9s %9s\n", heading, "configs", "landed", "crashed", "out", "timeout", "mean v", "worst v");
+    for (size_t row = 0; row < rows.size(); row++)
+    {
+        const TableRow& r = rows[row];
+        if (r.configs == 0) continue;
+
+        double episodes = (double)std::max(r.episodes, 1LL);
+        std::printf("%-16s %8d %8.1f%% %7.1f%% %7.1f%% %7.1f%% %9.3f %9.3f\n", labels[row].c_str(), r.configs,
+                    100.0 * r.wins / episodes, 100.0 * r.crashes / episodes, 100.0 * r.out_of_bounds / episodes, 100.0 * r.timeouts / episodes,
+                    r.wins > 0 ? r.landing_speed_sum / r.wins : 0.0, r.worst_landing_speed);
+    }
+}
+
+// One table per swept parameter, its configs binned by value, then one per layout
+void print_tables(const SweepSettings& settings, const std::vector<SweepConfig>& configs, int bins)
+{
+    for (int parameter = 0; parameter < SWEEP_PARAMETER_COUNT; parameter++)
+    {
+        const SweepRange& range = settings.ranges[parameter];
+        if (!range.is_swept()) continue;
+
+        std::vector<TableRow> rows(bins);
+        for (const SweepConfig& config : configs)
+        {
+            float value = config.values[parameter];
+            int bin = std::clamp((int)((value - range.min) / (range.max - range.min) * bins), 0, bins - 1);
+            rows[bin].add(config, value);
+        }
+
+        std::vector<std::string> labels;
+        for (const TableRow& row : rows)
+        {
+            char label[32];
+            std::snprintf(label, sizeof(label), range.integer ? "%.0f" : "%.4g", row.configs > 0 ? row.value_sum / row.configs : 0.0);
+            labels.push_back(label);
+        }
+        print_table(PARAMETER_NAMES[parameter], labels, rows);
+    }
+
+    if (settings.layouts.size() > 1)
+    {
+        std::vector<TableRow> rows(SCENE_LAYOUT_COUNT);
+        std::vector<std::string> labels;
+        for (const SweepConfig& config : configs) rows[config.layout].add(config, 0.0f);
+        for (int layout = 0; layout < SCENE_LAYOUT_COUNT; layout++) labels.push_back(get_scene_layout_name((SceneLayout)layout));
+        print_table("layout", labels, rows);
+    }
+}
+
+void print_best(const std::vector<SweepConfig>& configs)
+{
+    // Most landings first, and the gentlest landings among equals
+    std::vector<int> order(configs.size());
+    for (size_t i = 0; i < configs.size(); i++) order[i] = (int)i;
+
+    auto mean_speed = [&](int i) { return configs[i].wins > 0 ? configs[i].landing_speed_sum / configs[i].wins : 0.0; };
+    int count = std::min((int)order.size(), BEST_CONFIG_COUNT);
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](int a, int b)
+    {
+        if (configs[a].wins * (long long)configs[b].episodes != configs[b].wins * (long long)configs[a].episodes)
+        {
+            return configs[a].get_success_rate() > configs[b].get_success_rate();
+        }
+        return mean_speed(a) < mean_speed(b);
+    });
+
+    std::printf("\n%-10s %6s %9s %9s %9s %9s %9s %9s\n", "best", "plats", "gravity", "drag", "boost", "speed", "landed", "mean v");
+    for (int n = 0; n < count; n++)
+    {
+        const SweepConfig& config = configs[order[n]];
+        std::printf("%-10s %6.0f %9.4g %9.4g %9.4g %9.4g %8.1f%% %9.3f\n", get_scene_layout_name(config.layout), config.values[SWEEP_PLATFORMS],
+                    config.values[SWEEP_GRAVITY], config.values[SWEEP_DRAG], config.values[SWEEP_BOOSTING_POWER], config.values[SWEEP_SPEED],
+                    100.0f * config.get_success_rate(), mean_speed(order[n]));
+    }
+}
+
+bool write_csv(const char* filepath, const std::vector<SweepConfig>& configs)
+{
+    std::ofstream output(filepath);
+    if (!output) return false;
+
+    output << "layout,platforms,gravity,drag,boosting_power,speed,episodes,landed,crashed,out_of_bounds,timed_out,success_rate,mean_landing_speed,worst_landing_speed\n";
+    for (const SweepConfig& config : configs)
+    {
+        output << get_scene_layout_name(config.layout) << ',' << config.values[SWEEP_PLATFORMS] << ',' << config.values[SWEEP_GRAVITY] << ','
+               << config.values[SWEEP_DRAG] << ',' << config.values[SWEEP_BOOSTING_POWER] << ',' << config.values[SWEEP_SPEED] << ','
+               << config.episodes << ',' << config.wins << ',' << config.crashes << ',' << config.out_of_bounds << ',' << config.timeouts << ','
+               << config.get_success_rate() << ',' << (config.wins > 0 ? config.landing_speed_sum / config.wins : 0.0) << ','
+               << config.worst_landing_speed << '\n';
+    }
+    return (bool)output;
+}
+
+// ————— DISTRIBUTED ————— //
+// Every message is a WireHeader and `size` bytes of payload; all fields are little-endian
+enum WireMessage
+{
+    WIRE_HELLO,     // worker -> coordinator: WireHello
+    WIRE_SETTINGS,  // coordinator -> worker: WireSettings, then the policy file's bytes
+    WIRE_BATCH,     // coordinator -> worker: WireConfig[]
+    WIRE_RESULTS,   // worker -> coordinator: WireResult[], for the oldest batch outstanding
+    WIRE_DONE       // coordinator -> worker: nothing left; the worker exits
+};
+
+const uint32_t WIRE_VERSION          = 1;
+const uint32_t MAX_WIRE_PAYLOAD_SIZE = 64u << 20;
+
+struct WireHeader
+{
+    uint32_t type,
+             size;
+};
+
+struct WireHello
+{
+    uint32_t version,
+             thread_count;
+};
+
+struct WireSettings
+{
+    uint32_t episodes,
+             levels,
+             max_steps,
+             seed,
+             policy_size;  // 0 flies the scripted pilot
+};
+
+struct WireConfig
+{
+    uint32_t index;  // into the coordinator's configs, which also seeds the config's landers
+    float    values[SWEEP_PARAMETER_COUNT];
+    uint32_t layout;
+};
+
+struct WireResult
+{
+    uint32_t index,
+             episodes,
+             wins,
+             crashes,
+             out_of_bounds,
+             timeouts;
+    double   landing_speed_sum;
+    float    worst_landing_speed;
+    uint32_t padding;
+};
+
+static_assert(sizeof(WireConfig) == 28 && sizeof(WireResult) == 40, "The wire structs are sent as they are");
+
+// Header and payload in one send, so a small message is one packet
+bool send_message(TcpStream& stream, uint32_t type, const void* payload, size_t size, long long& bytes_sent)
+{
+    std::vector<uint8_t> message(sizeof(WireHeader) + size);
+    WireHeader header = { type, (uint32_t)size };
+    std::memcpy(message.data(), &header, sizeof(header));
+    if (size > 0) std::memcpy(message.data() + sizeof(header), payload, size);
+
+    bytes_sent += (long long)message.size();
+    return stream.send_all(message.data(), message.size());
+}
+
+bool receive_exactly(TcpStream& stream, void* buffer, size_t size)
+{
+    uint8_t* bytes = (uint8_t*)buffer;
+    while (size > 0)
+    {
+        int received = stream.receive(bytes, size);
+        if (received <= 0) return false;
+        bytes += received;
+        size  -= (size_t)received;
+    }
+    return true;
+}
+
+bool receive_message(TcpStream& stream, WireHeader& header, std::vector<uint8_t>& payload, long long& bytes_received)
+{
+    if (!receive_exactly(stream, &header, sizeof(header)) || header.size > MAX_WIRE_PAYLOAD_SIZE) return false;
+    payload.resize(header.size);
+    bytes_received += (long long)sizeof(header) + header.size;
+    return header.size == 0 || receive_exactly(stream, payload.data(), header.size);
+}
+
+// A run of consecutive configs, first to first + count
+struct ConfigRange
+{
+    int first,
+        count;
+};
+
+struct Coordinator
+{
+    const SweepSettings&     settings;
+    std::vector<SweepConfig>& configs;
+    const std::vector<uint8_t>& policy_bytes;
+
+    std::mutex              mutex;
+    std::condition_variable changed;    // work handed back, or the last results in
+    std::deque<ConfigRange> pending;    // not yet out to any worker
+    int                     remaining;  // configs without results yet
+    long long               bytes_sent     = 0,
+                            bytes_received = 0;
+
+    Coordinator(const SweepSettings& settings, std::vector<SweepConfig>& configs, const std::vector<uint8_t>& policy_bytes)
+        : settings(settings), configs(configs), policy_bytes(policy_bytes), remaining((int)configs.size())
+    {
+        if (!configs.empty()) pending.push_back({ 0, (int)configs.size() });
+    }
+};
+
+// One worker's connection, on its own thread until the sweep's done or the worker's gone
+void serve_worker(Coordinator& coordinator, std::unique_ptr<TcpStream> stream, int worker)
+{
+    long long bytes_sent = 0,
+              bytes_received = 0;
+    int       configs_done = 0;
+    std::deque<ConfigRange> in_flight;
+    std::vector<uint8_t> payload;
+    WireHeader header;
+
+    // STEP 1: Who it is, then everything its tasks read that isn't in a batch
+    WireHello hello = {};
+    bool ok = receive_message(*stream, header, payload, bytes_received) && header.type == WIRE_HELLO && payload.size() == sizeof(hello);
+    if (ok) std::memcpy(&hello, payload.data(), sizeof(hello));
+    ok = ok && hello.version == WIRE_VERSION;
+
+    int batch_size = std::max(1, (int)hello.thread_count) * BATCH_CONFIGS_PER_THREAD;
+    if (ok)
+    {
+        const SweepSettings& settings = coordinator.settings;
+        WireSettings wire = { (uint32_t)settings.episodes, (uint32_t)settings.levels, (uint32_t)settings.max_steps,
+                              settings.seed, (uint32_t)coordinator.policy_bytes.size() };
+
+        std::vector<uint8_t> message(sizeof(wire) + coordinator.policy_bytes.size());
+        std::memcpy(message.data(), &wire, sizeof(wire));
+        if (!coordinator.policy_bytes.empty()) std::memcpy(message.data() + sizeof(wire), coordinator.policy_bytes.data(), coordinator.policy_bytes.size());
+        ok = send_message(*stream, WIRE_SETTINGS, message.data(), message.size(), bytes_sent);
+    }
+    {
+        std::lock_guard<std::mutex> lock(coordinator.mutex);
+        if (ok) std::cout << "Worker " << worker << " joined with " << hello.thread_count << " threads" << std::endl;
+        else    std::cout << "Worker " << worker << " failed its handshake" << std::endl;
+    }
+
+    std::vector<WireConfig> batch;
+    while (ok)
+    {
+        // STEP 2: Keep BATCHES_IN_FLIGHT batches out, or wait for work if there's none left to
+        //         send and none out: some may yet come back from a worker that drops out
+        if ((int)in_flight.size() < BATCHES_IN_FLIGHT)
+        {
+            ConfigRange range = { 0, 0 };
+            {
+                std::unique_lock<std::mutex> lock(coordinator.mutex);
+                if (in_flight.empty())
+                {
+                    coordinator.changed.wait(lock, [&]() { return !coordinator.pending.empty() || coordinator.remaining == 0; });
+                }
+                if (!coordinator.pending.empty())
+                {
+                    ConfigRange& front = coordinator.pending.front();
+                    range = { front.first, std::min(front.count, batch_size) };
+                    front.first += range.count;
+                    front.count -= range.count;
+                    if (front.count == 0) coordinator.pending.pop_front();
+                }
+            }
+
+            if (range.count > 0)
+            {
+                batch.resize(range.count);
+                for (int i = 0; i < range.count; i++)
+                {
+                    const SweepConfig& config = coordinator.configs[range.first + i];
+                    batch[i].index = (uint32_t)(range.first + i);
+                    std::memcpy(batch[i].values, config.values, sizeof(batch[i].values));
+                    batch[i].layout = (uint32_t)config.layout;
+                }
+                in_flight.push_back(range);
+                ok = send_message(*stream, WIRE_BATCH, batch.data(), batch.size() * sizeof(WireConfig), bytes_sent);
+                continue;
+            }
+            if (in_flight.empty())
+            {
+                // Everything's in
+                send_message(*stream, WIRE_DONE, NULL, 0, bytes_sent);
+                break;
+            }
+        }
+
+        // STEP 3: The oldest batch's results
+        ConfigRange range = in_flight.front();
+        ok = receive_message(*stream, header, payload, bytes_received) && header.type == WIRE_RESULTS
+          && payload.size() == (size_t)range.count * sizeof(WireResult);
+        if (!ok) break;
+
+        const WireResult* results = (const WireResult*)payload.data();
+        for (int i = 0; i < range.count && ok; i++) ok = results[i].index == (uint32_t)(range.first + i);
+        if (!ok) break;
+
+        for (int i = 0; i < range.count; i++)
+        {
+            SweepConfig& config = coordinator.configs[range.first + i];
+            config.episodes            = (int)results[i].episodes;
+            config.wins                = (int)results[i].wins;
+            config.crashes             = (int)results[i].crashes;
+            config.out_of_bounds       = (int)results[i].out_of_bounds;
+            config.timeouts            = (int)results[i].timeouts;
+            config.landing_speed_sum   = results[i].landing_speed_sum;
+            config.worst_landing_speed = results[i].worst_landing_speed;
+        }
+        in_flight.pop_front();
+        configs_done += range.count;
+
+        std::lock_guard<std::mutex> lock(coordinator.mutex);
+        coordinator.remaining -= range.count;
+        if (coordinator.remaining == 0) coordinator.changed.notify_all();
+    }
+
+    // STEP 4: Whatever it still had goes back for the others
+    std::lock_guard<std::mutex> lock(coordinator.mutex);
+    for (const ConfigRange& range : in_flight) coordinator.pending.push_back(range);
+    if (!in_flight.empty()) coordinator.changed.notify_all();
+
+    coordinator.bytes_sent     += bytes_sent;
+    coordinator.bytes_received += bytes_received;
+    if (hello.version == WIRE_VERSION)
+    {
+        std::cout << "Worker " << worker << (ok ? " finished" : " dropped out") << " after " << configs_done << " configs";
+        if (!in_flight.empty()) std::cout << ", handing back " << in_flight.size() << " batches";
+        std::cout << std::endl;
+    }
+}
+
+// Hands the configs out to whichever workers connect, until every one has its results
+bool run_coordinator(const SweepSettings& settings, std::vector<SweepConfig>& configs, const std::vector<uint8_t>& policy_bytes, uint16_t port)
+{
+    TcpListener listener;
+    if (!listener.open(port))
+    {
+        std::cout << "Can't listen on port " << port << std::endl;
+        return false;
+    }
+    std::cout << "Waiting for workers on port " << port << std::endl;
+
+    Coordinator coordinator(settings, configs, policy_bytes);
+    std::vector<std::thread> threads;
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(coordinator.mutex);
+            if (coordinator.remaining == 0) break;
+        }
+
+        std::unique_ptr<TcpStream> stream(new TcpStream());
+        if (listener.accept(*stream, ACCEPT_WAIT_MS, WORKER_TIMEOUT_MS))
+        {
+            threads.emplace_back(serve_worker, std::ref(coordinator), std::move(stream), (int)threads.size());
+        }
+    }
+    listener.close();
+    for (std::thread& thread : threads) thread.join();
+
+    std::printf("%d workers, %.1f KB sent, %.1f KB received\n", (int)threads.size(),
+                coordinator.bytes_sent / 1024.0, coordinator.bytes_received / 1024.0);
+    return true;
+}
+
+// Pulls batches from the coordinator and runs them on every thread until it says it's done
+int run_worker(const char* host_port, int thread_count)
+{
+    NetAddress address;
+    TcpStream stream;
+    if (!resolve_address(host_port, address) || !stream.connect(address, CONNECT_TIMEOUT_MS) || !stream.set_timeout(WORKER_TIMEOUT_MS))
+    {
+        std::cout << "Can't reach a coordinator at " << host_port << std::endl;
+        return 1;
+    }
+
+    long long bytes_sent = 0,
+              bytes_received = 0;
+    std::vector<uint8_t> payload;
+    WireHeader header;
+
+    // STEP 1: The handshake, and the settings every config shares
+    JobSystem jobs(thread_count);
+    WireHello hello = { WIRE_VERSION, (uint32_t)jobs.get_thread_count() };
+    WireSettings wire = {};
+    bool ok = send_message(stream, WIRE_HELLO, &hello, sizeof(hello), bytes_sent)
+           && receive_message(stream, header, payload, bytes_received) && header.type == WIRE_SETTINGS && payload.size() >= sizeof(wire);
+    if (ok) std::memcpy(&wire, payload.data(), sizeof(wire));
+    ok = ok && payload.size() == sizeof(wire) + wire.policy_size;
+
+    SweepSettings settings;
+    settings.episodes  = (int)wire.episodes;
+    settings.levels    = (int)wire.levels;
+    settings.max_steps = (int)wire.max_steps;
+    settings.seed      = wire.seed;
+
+    PolicyNetwork policy;
+    if (ok && wire.policy_size > 0)
+    {
+        ok = policy.parse(payload.data() + sizeof(wire), wire.policy_size);
+        settings.policy = &policy;
+    }
+    if (!ok)
+    {
+        std::cout << "The coordinator at " << host_port << " isn't one this worker can talk to" << std::endl;
+        return 1;
+    }
+    std::cout << "Working for " << host_port << " on " << jobs.get_thread_count() << " threads" << std::endl;
+
+    // STEP 2: Batch after batch. From the first batch in to the last results out, the time
+    //         outside jobs.run() is the network's.
+    std::vector<SweepConfig> configs;
+    std::vector<SweepTask> tasks;
+    std::vector<WireResult> results;
+    TaskGraph graph;
+    long long config_count = 0;
+    double compute_seconds = 0.0;
+    auto start = std::chrono::steady_clock::now(),
+         end   = start;
+
+    while (ok)
+    {
+        ok = receive_message(stream, header, payload, bytes_received);
+        if (!ok || header.type == WIRE_DONE) break;
+        ok = header.type == WIRE_BATCH && payload.size() % sizeof(WireConfig) == 0;
+        if (!ok) break;
+
+        if (config_count == 0) start = std::chrono::steady_clock::now();
+        int count = (int)(payload.size() / sizeof(WireConfig));
+        const WireConfig* batch = (const WireConfig*)payload.data();
+        configs.assign(count, SweepConfig());
+        tasks.resize(count);
+        graph.clear();
+        for (int i = 0; i < count; i++)
+        {
+            std::memcpy(configs[i].values, batch[i].values, sizeof(configs[i].values));
+            configs[i].layout = (SceneLayout)std::min(batch[i].layout, (uint32_t)SCENE_LAYOUT_COUNT - 1);
+            tasks[i] = { &settings, &configs[i], (int)batch[i].index };
+            graph.add(evaluate_config, &tasks[i]);
+        }
+
+        auto compute_start = std::chrono::steady_clock::now();
+        jobs.run(graph);
+        compute_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - compute_start).count();
+
+        results.resize(count);
+        for (int i = 0; i < count; i++)
+        {
+            const SweepConfig& config = configs[i];
+            results[i] = { batch[i].index, (uint32_t)config.episodes, (uint32_t)config.wins, (uint32_t)config.crashes,
+                           (uint32_t)config.out_of_bounds, (uint32_t)config.timeouts, config.landing_speed_sum, config.worst_landing_speed, 0 };
+        }
+        ok = send_message(stream, WIRE_RESULTS, results.data(), results.size() * sizeof(WireResult), bytes_sent);
+        config_count += count;
+        end = std::chrono::steady_clock::now();
+    }
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::printf("%lld configs in %.2f s, %.2f%% of it waiting on the network; %.1f KB sent, %.1f KB received\n", config_count, seconds,
+                seconds > 0.0 ? 100.0 * (seconds - compute_seconds) / seconds : 0.0, bytes_sent / 1024.0, bytes_received / 1024.0);
+    if (!ok)
+    {
+        std::cout << "Lost the coordinator" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// ————— DRIVER ————— //
+// "min:max", or one value for both
+bool parse_range(const char* text, SweepRange& range)
+{
+    char* end = NULL;
+    range.min = range.max = std::strtof(text, &end);
+    if (end == text) return false;
+    if (*end == ':') range.max = std::strtof(end + 1, &end);
+    return *end == '\0' && range.max >= range.min;
+}
+
+// A comma-separated list of layout names
+bool parse_layouts(const char* text, std::vector<SceneLayout>& layouts)
+{
+    layouts.clear();
+    std::string list = text;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = std::min(list.find(',', start), list.size());
+        SceneLayout layout;
+        if (!parse_scene_layout(list.substr(start, end - start).c_str(), layout)) return false;
+        layouts.push_back(layout);
+        start = end + 1;
+    }
+    return true;
+}
+
+bool read_file(const char* filepath, std::vector<uint8_t>& contents)
+{
+    std::ifstream input(filepath, std::ios::binary);
+    if (!input) return false;
+    contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // The defaults hold every parameter at what setup_player gives it
+    LanderTuning defaults;
+    SweepSettings settings;
+    settings.ranges[SWEEP_GRAVITY]        = { defaults.gravity, defaults.gravity, false };
+    settings.ranges[SWEEP_DRAG]           = { defaults.drag, defaults.drag, false };
+    settings.ranges[SWEEP_BOOSTING_POWER] = { defaults.boosting_power, defaults.boosting_power, false };
+    settings.ranges[SWEEP_SPEED]          = { defaults.speed, defaults.speed, false };
+    settings.ranges[SWEEP_PLATFORMS]      = { (float)PLATFORM_COUNT, (float)PLATFORM_COUNT, true };
+    settings.layouts.push_back(SCENE_CLASSIC);
+
+    int grid = DEFAULT_GRID,
+        lhs  = 0,
+        thread_count = 0,
+        coordinate_port = 0;
+    const char* pilot = "scripted";
+    const char* csv   = NULL;
+    const char* coordinator = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        const char* value = ok ? argv[i + 1] : "";
+
+        if      (std::strcmp(argv[i], "--gravity") == 0)   ok = ok && parse_range(value, settings.ranges[SWEEP_GRAVITY]);
+        else if (std::strcmp(argv[i], "--drag") == 0)      ok = ok && parse_range(value, settings.ranges[SWEEP_DRAG]);
+        else if (std::strcmp(argv[i], "--boost") == 0)     ok = ok && parse_range(value, settings.ranges[SWEEP_BOOSTING_POWER]);
+        else if (std::strcmp(argv[i], "--speed") == 0)     ok = ok && parse_range(value, settings.ranges[SWEEP_SPEED]);
+        else if (std::strcmp(argv[i], "--platforms") == 0) ok = ok && parse_range(value, settings.ranges[SWEEP_PLATFORMS]) && settings.ranges[SWEEP_PLATFORMS].min >= 1.0f;
+        else if (std::strcmp(argv[i], "--layouts") == 0)   ok = ok && parse_layouts(value, settings.layouts);
+        else if (std::strcmp(argv[i], "--grid") == 0)      ok = ok && (grid = std::atoi(value)) >= 2 && (lhs = 0) == 0;
+        else if (std::strcmp(argv[i], "--lhs") == 0)       ok = ok && (lhs = std::atoi(value)) >= 1;
+        else if (std::strcmp(argv[i], "--pilot") == 0)     pilot = value;
+        else if (std::strcmp(argv[i], "--episodes") == 0)  ok = ok && (settings.episodes = std::atoi(value)) >= 1;
+        else if (std::strcmp(argv[i], "--levels") == 0)    ok = ok && (settings.levels = std::atoi(value)) >= 1;
+        else if (std::strcmp(argv[i], "--max-steps") == 0) ok = ok && (settings.max_steps = std::atoi(value)) >= 1;
+        else if (std::strcmp(argv[i], "--threads") == 0)   ok = ok && (thread_count = std::atoi(value)) >= 0;
+        else if (std::strcmp(argv[i], "--seed") == 0)      settings.seed = (unsigned int)std::strtoul(value, NULL, 10);
+        else if (std::strcmp(argv[i], "--csv") == 0)       csv = value;
+        else if (std::strcmp(argv[i], "--coordinate") == 0) ok = ok && (coordinate_port = std::atoi(value)) >= 1 && coordinate_port <= 65535;
+        else if (std::strcmp(argv[i], "--work") == 0)      coordinator = value;
+        else ok = false;
+
+        if (!ok)
+        {
+            std::cout << "Bad argument " << argv[i] << (i + 1 < argc ? std::string(" ") + argv[i + 1] : std::string()) << std::endl;
+            return 1;
+        }
+        i++;
+    }
+
+    if (coordinator != NULL) return run_worker(coordinator, thread_count);
+
+    // STEP 1: The pilot; its file goes to the workers as it is
+    PolicyNetwork policy;
+    std::vector<uint8_t> policy_bytes;
+    if (std::strcmp(pilot, "scripted") != 0)
+    {
+        if (!read_file(pilot, policy_bytes) || !policy.parse(policy_bytes.data(), policy_bytes.size()) || policy.get_input_size() > LANDER_OBSERVATION_SIZE || policy.get_output_size() < 3)
+        {
+            std::cout << "Can't use policy " << pilot << ": needs at most " << LANDER_OBSERVATION_SIZE << " inputs and 3 outputs" << std::endl;
+            return 1;
+        }
+        settings.policy = &policy;
+    }
+
+    // STEP 2: The configs
+    std::vector<SweepConfig> configs = lhs > 0 ? expand_latin_hypercube(settings, lhs) : expand_grid(settings, grid);
+
+    std::vector<SweepTask> tasks(configs.size());
+    TaskGraph graph;
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        tasks[i] = { &settings, &configs[i], (int)i };
+        graph.add(evaluate_config, &tasks[i]);
+    }
+
+    // STEP 3: All of them, on every thread, or on every worker's
+    std::cout << configs.size() << " configs (" << (lhs > 0 ? "Latin hypercube" : "grid") << "), " << settings.episodes << " landers on "
+              << settings.levels << " levels each, " << (settings.policy != NULL ? pilot : "scripted") << " pilot";
+
+    auto start = std::chrono::steady_clock::now();
+    if (coordinate_port != 0)
+    {
+        std::cout << std::endl;
+        if (!run_coordinator(settings, configs, policy_bytes, (uint16_t)coordinate_port)) return 1;
+    }
+    else
+    {
+        JobSystem jobs(thread_count);
+        std::cout << ", " << jobs.get_thread_count() << " threads" << std::endl;
+        jobs.run(graph);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    long long episodes = 0;
+    for (const SweepConfig& config : configs) episodes += config.episodes;
+    std::printf("%.2f s: %.0f configs/s, %.0f episodes/s\n", seconds, configs.size() / seconds, episodes / seconds);
+
+    // STEP 4: The tables
+    print_tables(settings, configs, lhs > 0 ? std::min(lhs, MAX_TABLE_ROWS) : grid);
+    print_best(configs);
+
+    if (csv != NULL)
+    {
+        if (!write_csv(csv, configs))
+        {
+            std::cout << "Can't write " << csv << std::endl;
+            return 1;
+        }
+        std::cout << "\nEvery config written to " << csv << std::endl;
+    }
+    return 0;
+}